@@ -127,6 +127,91 @@ private:
     std::size_t total_rows_count;
 };
 
+/**
+ * HDR-style histogram of request latencies. Values are counted with nanosecond
+ * resolution into power of two ranges split into linear sub-buckets, so the
+ * relative error of any reported value is less than 1/64 on the whole range.
+ */
+class latency_histogram {
+public:
+    using duration = std::chrono::steady_clock::duration;
+
+    static constexpr std::size_t sub_buckets_bits = 7;
+    static constexpr std::size_t sub_buckets_count = std::size_t(1) << sub_buckets_bits;
+    static constexpr std::size_t half_sub_buckets_count = sub_buckets_count / 2;
+    static constexpr std::size_t buckets_count = (64 - sub_buckets_bits + 1) * half_sub_buckets_count + half_sub_buckets_count;
+
+    void add(duration value) {
+        ++counts[index(value)];
+        ++total;
+    }
+
+    std::uint64_t count() const {
+        return total;
+    }
+
+    /**
+     * Returns the greatest value equivalent to the value at the percentile,
+     * `percentile` is in range [0, 100].
+     */
+    OZO_STD_OPTIONAL<duration> percentile(double percentile) const {
+        if (total == 0) {
+            return {};
+        }
+        const auto rank = std::max<std::uint64_t>(1,
+            static_cast<std::uint64_t>(std::ceil(percentile / 100 * static_cast<double>(total))));
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < counts.size(); ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                return highest_equivalent_value(i);
+            }
+        }
+        return highest_equivalent_value(counts.size() - 1);
+    }
+
+    /**
+     * Calls `f(value, count)` for each non-empty bucket in ascending order of values.
+     */
+    template <typename F>
+    void for_each_bucket(F&& f) const {
+        for (std::size_t i = 0; i < counts.size(); ++i) {
+            if (counts[i]) {
+                f(highest_equivalent_value(i), counts[i]);
+            }
+        }
+    }
+
+private:
+    std::vector<std::uint64_t> counts = std::vector<std::uint64_t>(buckets_count);
+    std::uint64_t total = 0;
+
+    static std::size_t index(duration value) {
+        const auto ns = static_cast<std::uint64_t>(std::max(std::chrono::duration_cast<std::chrono::nanoseconds>(value).count(),
+                                                            std::chrono::nanoseconds::rep(0)));
+        if (ns < sub_buckets_count) {
+            return static_cast<std::size_t>(ns);
+        }
+        std::size_t magnitude = sub_buckets_bits;
+        while (magnitude < 63 && (ns >> (magnitude + 1)) != 0) {
+            ++magnitude;
+        }
+        const auto shift = magnitude - sub_buckets_bits + 1;
+        return shift * half_sub_buckets_count + static_cast<std::size_t>(ns >> shift);
+    }
+
+    static duration highest_equivalent_value(std::size_t index) {
+        if (index < sub_buckets_count) {
+            return std::chrono::duration_cast<duration>(std::chrono::nanoseconds(index));
+        }
+        const auto shift = index / half_sub_buckets_count - 1;
+        const auto sub_bucket = static_cast<std::uint64_t>(index - shift * half_sub_buckets_count);
+        const auto value = std::min<std::uint64_t>(((sub_bucket + 1) << shift) - 1,
+                                                   static_cast<std::uint64_t>(std::chrono::nanoseconds::max().count()));
+        return std::chrono::duration_cast<duration>(std::chrono::nanoseconds(static_cast<std::chrono::nanoseconds::rep>(value)));
+    }
+};
+
 struct step {
     std::chrono::steady_clock::duration duration;
     std::size_t requests_count;
@@ -136,6 +221,7 @@ struct step {
 struct output {
     std::vector<std::chrono::steady_clock::duration> requests;
     std::vector<step> steps;
+    latency_histogram histogram;
 };
 
 struct stats {
@@ -144,6 +230,10 @@ struct stats {
     OZO_STD_OPTIONAL<std::chrono::steady_clock::duration> q90_request_time;
     OZO_STD_OPTIONAL<std::chrono::steady_clock::duration> min_request_time;
     OZO_STD_OPTIONAL<std::chrono::steady_clock::duration> max_request_time;
+    OZO_STD_OPTIONAL<std::chrono::steady_clock::duration> p50_request_time;
+    OZO_STD_OPTIONAL<std::chrono::steady_clock::duration> p90_request_time;
+    OZO_STD_OPTIONAL<std::chrono::steady_clock::duration> p99_request_time;
+    OZO_STD_OPTIONAL<std::chrono::steady_clock::duration> p999_request_time;
     double mean_request_speed;
     OZO_STD_OPTIONAL<double> median_request_speed;
     OZO_STD_OPTIONAL<double> min_request_speed;
@@ -160,6 +250,10 @@ std::ostream& operator <<(std::ostream& stream, const stats& value) {
     stream << "q90 request time: " << value.q90_request_time << '\n';
     stream << "min request time: " << value.min_request_time << '\n';
     stream << "max request time: " << value.max_request_time << '\n';
+    stream << "p50 request time: " << value.p50_request_time << '\n';
+    stream << "p90 request time: " << value.p90_request_time << '\n';
+    stream << "p99 request time: " << value.p99_request_time << '\n';
+    stream << "p99.9 request time: " << value.p999_request_time << '\n';
     stream << "mean requests speed: " << value.mean_request_speed << " req/sec" << '\n';
     stream << "median requests speed: " << value.median_request_speed << " req/sec" << '\n';
     stream << "min requests speed: " << value.min_request_speed << " req/sec" << '\n';
@@ -187,14 +281,16 @@ public:
         if (finished) {
             return false;
         }
-        requests.push_back(std::chrono::steady_clock::now() - request_start[token]);
+        const auto now = std::chrono::steady_clock::now();
+        requests.push_back(now - request_start[token]);
+        histogram.add(now - request_start[token]);
         step_rows_count += rows_count;
         if (++step_count % modulo == 0) {
             if (!step_impl()) {
                 return false;
             }
         }
-        request_start[token] = std::chrono::steady_clock::now();
+        next_request_start(token);
         return true;
     }
 
@@ -203,8 +299,10 @@ public:
             return false;
         }
         {
+            const auto now = std::chrono::steady_clock::now();
             const std::unique_lock<std::mutex> lock(requests_mutex);
-            requests.push_back(std::chrono::steady_clock::now() - request_start[token]);
+            requests.push_back(now - request_start[token]);
+            histogram.add(now - request_start[token]);
         }
         step_rows_count += rows_count;
         if (++step_count % modulo == 0) {
@@ -213,14 +311,40 @@ public:
                 return false;
             }
         }
-        request_start[token] = std::chrono::steady_clock::now();
+        next_request_start(token);
         return true;
     }
 
+    /**
+     * Switches the benchmark into the open-loop mode: each token issues requests
+     * by a fixed schedule, so all together make `rate` requests per second. A request
+     * time is measured from its scheduled start, not from the actual one, so the
+     * time of requests delayed by the previous slow ones is not omitted.
+     */
+    void set_request_rate(double rate) {
+        const auto tokens = request_start.size();
+        request_interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(static_cast<double>(tokens) / rate));
+        for (std::size_t token = 0; token < tokens; ++token) {
+            request_start[token] = start + *request_interval * static_cast<std::int64_t>(token) / static_cast<std::int64_t>(tokens);
+        }
+    }
+
+    /**
+     * Scheduled start of the next request for the token in the open-loop mode.
+     */
+    OZO_STD_OPTIONAL<std::chrono::steady_clock::time_point> get_request_start(std::size_t token = 0) const {
+        if (!request_interval) {
+            return {};
+        }
+        return request_start[token];
+    }
+
     output get_output() const {
         output result;
         result.requests = requests;
         result.steps = steps;
+        result.histogram = histogram;
         return result;
     }
 
@@ -236,6 +360,10 @@ public:
             result.min_request_time = requests.front();
             result.max_request_time = requests.back();
         }
+        result.p50_request_time = histogram.percentile(50);
+        result.p90_request_time = histogram.percentile(90);
+        result.p99_request_time = histogram.percentile(99);
+        result.p999_request_time = histogram.percentile(99.9);
         result.mean_request_speed = total_requests_count / std::chrono::duration_cast<double_s>(finish - start).count();
         if (!steps.empty()) {
             std::vector<double> requests_speeds;
@@ -272,12 +400,22 @@ private:
     std::chrono::steady_clock::time_point finish;
     std::vector<benchmark::step> steps;
     std::vector<std::chrono::steady_clock::duration> requests;
+    latency_histogram histogram;
+    OZO_STD_OPTIONAL<std::chrono::steady_clock::duration> request_interval;
     const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
     std::chrono::steady_clock::time_point next_print = start + std::chrono::seconds(1);
     std::chrono::steady_clock::time_point step_start = start;
     std::vector<std::chrono::steady_clock::time_point> request_start;
     bool print_progress = false;
 
+    void next_request_start(std::size_t token) {
+        if (request_interval) {
+            request_start[token] += *request_interval;
+        } else {
+            request_start[token] = std::chrono::steady_clock::now();
+        }
+    }
+
     bool step_impl() {
         finish = std::chrono::steady_clock::now();
         if (finish >= next_print) {
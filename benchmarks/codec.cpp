@@ -0,0 +1,183 @@
+#include <ozo/ext/std.h>
+#include <ozo/io/binary_query.h>
+#include <ozo/io/composite.h>
+#include <ozo/io/recv.h>
+#include <ozo/io/send.h>
+#include <ozo/io/size_of.h>
+#include <ozo/pg/types.h>
+#include <ozo/query_builder.h>
+#include <ozo/result.h>
+
+#include <benchmark/benchmark.h>
+
+#include <boost/hana/define_struct.hpp>
+
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+
+struct benchmark_composite {
+    BOOST_HANA_DEFINE_STRUCT(benchmark_composite,
+        (std::int64_t, id),
+        (std::string, name),
+        (std::vector<std::int32_t>, values)
+    );
+};
+
+OZO_PG_DEFINE_CUSTOM_TYPE(benchmark_composite, "benchmark_composite")
+
+namespace {
+
+const auto oid_map = ozo::register_types<benchmark_composite>();
+
+/**
+ * In-memory result with the binary encoded values, it is used instead of libpq
+ * PGresult like the ozo::tests::pg_result_mock, but without the mock call overhead.
+ */
+struct synthetic_result {
+    std::vector<ozo::oid_t> types;
+    std::vector<std::vector<std::vector<char>>> rows;
+
+    friend ozo::oid_t pq_field_type(const synthetic_result& r, int column) {
+        return r.types[static_cast<std::size_t>(column)];
+    }
+
+    friend ozo::impl::result_format pq_field_format(const synthetic_result&, int) {
+        return ozo::impl::result_format::binary;
+    }
+
+    friend const char* pq_get_value(const synthetic_result& r, int row, int column) {
+        return r.rows[static_cast<std::size_t>(row)][static_cast<std::size_t>(column)].data();
+    }
+
+    friend std::size_t pq_get_length(const synthetic_result& r, int row, int column) {
+        return r.rows[static_cast<std::size_t>(row)][static_cast<std::size_t>(column)].size();
+    }
+
+    friend bool pq_get_isnull(const synthetic_result&, int, int) {
+        return false;
+    }
+
+    friend int pq_field_number(const synthetic_result&, const char*) {
+        return -1;
+    }
+
+    friend int pq_nfields(const synthetic_result& r) {
+        return static_cast<int>(r.types.size());
+    }
+
+    friend int pq_ntuples(const synthetic_result& r) {
+        return static_cast<int>(r.rows.size());
+    }
+};
+
+template <typename T>
+std::vector<char> encode(const T& v) {
+    std::vector<char> buffer;
+    ozo::ostream os{buffer};
+    ozo::send(os, oid_map, v);
+    return buffer;
+}
+
+template <typename ...Ts>
+synthetic_result make_result(std::size_t rows_count, const Ts& ...vs) {
+    synthetic_result result{{ozo::type_oid(oid_map, vs)...}, {}};
+    result.rows.assign(rows_count, {encode(vs)...});
+    return result;
+}
+
+auto make_ints() {
+    return std::make_tuple(std::int64_t(42), std::int32_t(13), std::int16_t(7));
+}
+
+auto make_text() {
+    return std::make_tuple(std::string(16, 'x'), std::string(256, 'y'));
+}
+
+auto make_array() {
+    return std::make_tuple(std::vector<std::int32_t>(64, 42), std::vector<std::string>(16, std::string(16, 'z')));
+}
+
+auto make_composite() {
+    return std::make_tuple(benchmark_composite{42, std::string(32, 'n'), std::vector<std::int32_t>(16, 13)});
+}
+
+auto make_jsonb() {
+    return std::make_tuple(ozo::pg::jsonb(R"({"id": 42, "name": "benchmark", "values": [1, 2, 3, 4, 5, 6, 7, 8]})"));
+}
+
+template <typename Make>
+void to_binary_query(benchmark::State& state, Make make) {
+    const auto values = make();
+    const auto query = std::apply([] (const auto& ...vs) { return ozo::make_query("SELECT", vs...); }, values);
+    for (auto _ : state) {
+        auto binary_query = ozo::to_binary_query(query, oid_map);
+        benchmark::DoNotOptimize(binary_query);
+    }
+}
+
+template <typename Make>
+void send(benchmark::State& state, Make make) {
+    const auto values = make();
+    std::vector<char> buffer;
+    for (auto _ : state) {
+        buffer.clear();
+        ozo::ostream os{buffer};
+        std::apply([&] (const auto& ...vs) { (ozo::send(os, oid_map, vs), ...); }, values);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+}
+
+template <typename Make>
+void size_of(benchmark::State& state, Make make) {
+    const auto values = make();
+    for (auto _ : state) {
+        const auto size = std::apply([] (const auto& ...vs) { return (ozo::size_type(0) + ... + ozo::size_of(vs)); }, values);
+        benchmark::DoNotOptimize(size);
+    }
+}
+
+template <typename Make>
+void recv_row(benchmark::State& state, Make make) {
+    const auto values = make();
+    const auto result = std::apply([] (const auto& ...vs) { return make_result(1, vs...); }, values);
+    const ozo::basic_result<const synthetic_result*> res{&result};
+    const auto row = *res.begin();
+    for (auto _ : state) {
+        std::decay_t<decltype(values)> out;
+        ozo::recv_row(row, oid_map, out);
+        benchmark::DoNotOptimize(out);
+    }
+}
+
+template <typename Make>
+void recv_result(benchmark::State& state, Make make) {
+    const auto values = make();
+    const auto rows_count = static_cast<std::size_t>(state.range(0));
+    const auto result = std::apply([&] (const auto& ...vs) { return make_result(rows_count, vs...); }, values);
+    const ozo::basic_result<const synthetic_result*> res{&result};
+    for (auto _ : state) {
+        std::vector<std::decay_t<decltype(values)>> out;
+        ozo::recv_result(res, oid_map, std::back_inserter(out));
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * rows_count));
+}
+
+#define OZO_CODEC_BENCHMARK(type) \
+    BENCHMARK_CAPTURE(to_binary_query, type, make_##type); \
+    BENCHMARK_CAPTURE(send, type, make_##type); \
+    BENCHMARK_CAPTURE(size_of, type, make_##type); \
+    BENCHMARK_CAPTURE(recv_row, type, make_##type); \
+    BENCHMARK_CAPTURE(recv_result, type, make_##type)->Arg(1)->Arg(64)->Arg(1024);
+
+OZO_CODEC_BENCHMARK(ints)
+OZO_CODEC_BENCHMARK(text)
+OZO_CODEC_BENCHMARK(array)
+OZO_CODEC_BENCHMARK(composite)
+OZO_CODEC_BENCHMARK(jsonb)
+
+} // namespace
+
+BENCHMARK_MAIN();
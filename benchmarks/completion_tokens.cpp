@@ -0,0 +1,377 @@
+#include <ozo/allocation_counter.h>
+#include <ozo/connection_info.h>
+#include <ozo/execute.h>
+#include <ozo/light_future.h>
+#include <ozo/query_builder.h>
+#include <ozo/request.h>
+#include <ozo/shortcuts.h>
+#include <ozo/transaction.h>
+
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/spawn.hpp>
+#include <boost/asio/use_future.hpp>
+
+#if defined(BOOST_ASIO_HAS_CO_AWAIT)
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+
+namespace {
+
+std::atomic<std::uint64_t> allocations {0};
+
+} // namespace
+
+// Counts the allocations of the whole process, the benchmark runs one token kind at a time.
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (auto ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+// GCC takes free() of the memory from the replaced operator new inlined into a caller for a mismatch
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+namespace {
+
+namespace asio = boost::asio;
+
+using clock_type = std::chrono::steady_clock;
+using connection_type = ozo::connection_info<>::connection_type;
+
+const auto query = ozo::make_query("SELECT 1");
+constexpr auto request_timeout = std::chrono::seconds(1);
+
+std::chrono::nanoseconds cpu_time() {
+    rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+    return std::chrono::seconds(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec)
+        + std::chrono::microseconds(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+}
+
+/**
+ * Measures a series of sequential requests made with the same connection, so the
+ * difference between the completion tokens is not hidden by the connection setup.
+ */
+class measurement {
+public:
+    explicit measurement(std::size_t requests) {
+        latencies_.reserve(requests);
+    }
+
+    void start() {
+        cpu_start_ = cpu_time();
+        allocations_start_ = allocations.load(std::memory_order_relaxed);
+    }
+
+    void request_started() {
+        request_start_ = clock_type::now();
+    }
+
+    void request_finished() {
+        latencies_.push_back(clock_type::now() - request_start_);
+    }
+
+    void finish() {
+        cpu_ = cpu_time() - cpu_start_;
+        allocations_ = allocations.load(std::memory_order_relaxed) - allocations_start_;
+    }
+
+    void print(std::ostream& stream, const std::string& name) {
+        const auto count = latencies_.size();
+        if (count == 0) {
+            stream << name << ": no requests\n";
+            return;
+        }
+        std::sort(latencies_.begin(), latencies_.end());
+        const auto usec = [] (auto value) {
+            return std::chrono::duration<double, std::micro>(value).count();
+        };
+        clock_type::duration total {};
+        for (const auto v : latencies_) {
+            total += v;
+        }
+        stream << name << ":"
+            << " requests " << count
+            << ", latency mean " << usec(total / count) << " us"
+            << ", p50 " << usec(latencies_[count / 2]) << " us"
+            << ", p99 " << usec(latencies_[count * 99 / 100]) << " us"
+            << ", cpu " << usec(cpu_ / count) << " us/request"
+            << ", allocations " << static_cast<double>(allocations_) / count << " /request"
+            << '\n';
+    }
+
+private:
+    std::vector<clock_type::duration> latencies_;
+    clock_type::time_point request_start_;
+    std::chrono::nanoseconds cpu_start_ {};
+    std::chrono::nanoseconds cpu_ {};
+    std::uint64_t allocations_start_ = 0;
+    std::uint64_t allocations_ = 0;
+};
+
+template <typename Connection>
+void check(ozo::error_code ec, const Connection& conn) {
+    if (ec) {
+        std::cerr << ec.message();
+        if (!ozo::is_null_recursive(conn)) {
+            std::cerr << ": " << ozo::error_message(conn) << ' ' << ozo::get_error_context(conn);
+        }
+        std::cerr << std::endl;
+        std::abort();
+    }
+}
+
+connection_type connect(asio::io_context& io, const ozo::connection_info<>& conn_info) {
+    auto future = ozo::get_connection(conn_info[io], request_timeout, asio::use_future);
+    io.restart();
+    io.run();
+    return future.get();
+}
+
+/**
+ * Each request is made from the completion handler of the previous one.
+ */
+struct callback_chain {
+    asio::io_context& io;
+    measurement& m;
+    std::size_t left;
+    ozo::rows_of<std::int32_t>& rows;
+
+    void next(connection_type conn) {
+        if (left-- == 0) {
+            return;
+        }
+        rows.clear();
+        m.request_started();
+        ozo::request(std::move(conn), query, request_timeout, ozo::into(rows),
+            [this] (ozo::error_code ec, connection_type conn) {
+                check(ec, conn);
+                m.request_finished();
+                next(std::move(conn));
+            });
+    }
+};
+
+void run_callback(const ozo::connection_info<>& conn_info, std::size_t requests) {
+    asio::io_context io(1);
+    auto conn = connect(io, conn_info);
+    measurement m(requests);
+    ozo::rows_of<std::int32_t> rows;
+    callback_chain chain {io, m, requests, rows};
+    m.start();
+    chain.next(std::move(conn));
+    io.restart();
+    io.run();
+    m.finish();
+    m.print(std::cout, "callback");
+}
+
+/**
+ * The io_context runs on its own thread and the requests wait for the futures, which is
+ * how `use_future` is used with a blocking caller.
+ */
+void run_future(const ozo::connection_info<>& conn_info, std::size_t requests) {
+    asio::io_context io(1);
+    auto conn = connect(io, conn_info);
+    measurement m(requests);
+    ozo::rows_of<std::int32_t> rows;
+    auto guard = asio::make_work_guard(io);
+    io.restart();
+    std::thread thread([&] { io.run(); });
+    m.start();
+    for (std::size_t i = 0; i < requests; ++i) {
+        rows.clear();
+        m.request_started();
+        conn = ozo::request(std::move(conn), query, request_timeout, ozo::into(rows), asio::use_future).get();
+        m.request_finished();
+    }
+    m.finish();
+    guard.reset();
+    thread.join();
+    m.print(std::cout, "use_future");
+}
+
+/**
+ * The same as `run_future` with `ozo::use_light_future`.
+ */
+void run_light_future(const ozo::connection_info<>& conn_info, std::size_t requests) {
+    asio::io_context io(1);
+    auto conn = connect(io, conn_info);
+    measurement m(requests);
+    ozo::rows_of<std::int32_t> rows;
+    auto guard = asio::make_work_guard(io);
+    io.restart();
+    std::thread thread([&] { io.run(); });
+    m.start();
+    for (std::size_t i = 0; i < requests; ++i) {
+        rows.clear();
+        m.request_started();
+        conn = ozo::request(std::move(conn), query, request_timeout, ozo::into(rows), ozo::use_light_future).get();
+        m.request_finished();
+    }
+    m.finish();
+    guard.reset();
+    thread.join();
+    m.print(std::cout, "use_light_future");
+}
+
+void run_yield_context(const ozo::connection_info<>& conn_info, std::size_t requests) {
+    asio::io_context io(1);
+    auto conn = connect(io, conn_info);
+    measurement m(requests);
+    asio::spawn(io, [&] (asio::yield_context yield) {
+        ozo::rows_of<std::int32_t> rows;
+        m.start();
+        for (std::size_t i = 0; i < requests; ++i) {
+            rows.clear();
+            ozo::error_code ec;
+            m.request_started();
+            conn = ozo::request(std::move(conn), query, request_timeout, ozo::into(rows), yield[ec]);
+            check(ec, conn);
+            m.request_finished();
+        }
+        m.finish();
+    });
+    io.restart();
+    io.run();
+    m.print(std::cout, "yield_context");
+}
+
+/**
+ * Counts the allocations made by the library via the handler associated allocator for
+ * each kind of operation, the global counter includes the allocations of the libpq and
+ * of the coroutine as well.
+ */
+void run_operations(const ozo::connection_info<>& conn_info, std::size_t requests) {
+    asio::io_context io(1);
+    auto conn = connect(io, conn_info);
+    asio::spawn(io, [&] (asio::yield_context yield) {
+        ozo::allocation_counter counter;
+        const auto report = [&] (const std::string& name, auto operation) {
+            counter.reset();
+            const auto total = allocations.load(std::memory_order_relaxed);
+            for (std::size_t i = 0; i < requests; ++i) {
+                operation();
+            }
+            const auto count = static_cast<double>(requests);
+            std::cout << name << ":"
+                << " handler allocations " << counter.allocations() / count << " /operation"
+                << ", " << counter.bytes() / count << " bytes/operation"
+                << ", allocations " << (allocations.load(std::memory_order_relaxed) - total) / count << " /operation"
+                << '\n';
+        };
+        ozo::error_code ec;
+        ozo::rows_of<std::int32_t> rows;
+        report("request", [&] {
+            rows.clear();
+            conn = ozo::request(std::move(conn), query, request_timeout, ozo::into(rows),
+                ozo::bind_allocation_counter(counter, yield[ec]));
+            check(ec, conn);
+        });
+        report("execute", [&] {
+            conn = ozo::execute(std::move(conn), query, request_timeout,
+                ozo::bind_allocation_counter(counter, yield[ec]));
+            check(ec, conn);
+        });
+        auto transaction = ozo::begin(std::move(conn), request_timeout, yield[ec]);
+        check(ec, transaction);
+        conn = ozo::commit(std::move(transaction), request_timeout, yield[ec]);
+        check(ec, conn);
+        report("begin/commit", [&] {
+            auto transaction = ozo::begin(std::move(conn), request_timeout,
+                ozo::bind_allocation_counter(counter, yield[ec]));
+            check(ec, transaction);
+            conn = ozo::commit(std::move(transaction), request_timeout,
+                ozo::bind_allocation_counter(counter, yield[ec]));
+            check(ec, conn);
+        });
+    });
+    io.restart();
+    io.run();
+}
+
+#if defined(BOOST_ASIO_HAS_CO_AWAIT)
+
+asio::awaitable<void> awaitable_requests(connection_type& conn, measurement& m, std::size_t requests) {
+    ozo::rows_of<std::int32_t> rows;
+    m.start();
+    for (std::size_t i = 0; i < requests; ++i) {
+        rows.clear();
+        m.request_started();
+        conn = co_await ozo::request(std::move(conn), query, request_timeout, ozo::into(rows), asio::use_awaitable);
+        m.request_finished();
+    }
+    m.finish();
+}
+
+void run_awaitable(const ozo::connection_info<>& conn_info, std::size_t requests) {
+    asio::io_context io(1);
+    auto conn = connect(io, conn_info);
+    measurement m(requests);
+    asio::co_spawn(io, awaitable_requests(conn, m, requests), asio::detached);
+    io.restart();
+    io.run();
+    m.print(std::cout, "use_awaitable");
+}
+
+#endif
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        std::cout << "Usage: " << argv[0] << " <conninfo> [requests per token]" << std::endl;
+        return 1;
+    }
+
+    const ozo::connection_info<> conn_info(argv[1]);
+    const std::size_t requests = argc > 2 ? std::stoul(argv[2]) : 100000;
+
+    try {
+        run_callback(conn_info, requests);
+        run_future(conn_info, requests);
+        run_light_future(conn_info, requests);
+        run_yield_context(conn_info, requests);
+#if defined(BOOST_ASIO_HAS_CO_AWAIT)
+        run_awaitable(conn_info, requests);
+#endif
+        run_operations(conn_info, requests);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
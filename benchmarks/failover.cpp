@@ -0,0 +1,227 @@
+#include <ozo/allocation_counter.h>
+#include <ozo/connection_info.h>
+#include <ozo/connection_pool.h>
+#include <ozo/query_builder.h>
+#include <ozo/request.h>
+#include <ozo/shortcuts.h>
+#include <ozo/failover/retry.h>
+#include <ozo/failover/role_based.h>
+
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/spawn.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <optional>
+#include <string>
+
+#include <sys/resource.h>
+
+namespace {
+
+std::atomic<std::uint64_t> allocations {0};
+
+} // namespace
+
+// Counts the allocations of the whole process, the benchmark runs one scenario at a time.
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (auto ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+// GCC takes free() of the memory from the replaced operator new inlined into a caller for a mismatch
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+namespace {
+
+namespace asio = boost::asio;
+namespace failover = ozo::failover;
+
+using clock_type = std::chrono::steady_clock;
+using pool_type = decltype(ozo::make_connection_pool(std::declval<ozo::connection_info<>>(), ozo::connection_pool_config {}));
+
+const auto query = ozo::make_query("SELECT 1");
+constexpr auto request_timeout = std::chrono::seconds(1);
+
+std::chrono::nanoseconds cpu_time() {
+    rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+    return std::chrono::seconds(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec)
+        + std::chrono::microseconds(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+}
+
+/**
+ * References the pool, so the role-based source dispatches both roles to the same
+ * pool and the scenarios differ only by the failover strategy.
+ */
+struct pool_source {
+    using connection_type = typename pool_type::connection_type;
+
+    pool_type& pool;
+
+    template <typename TimeConstraint, typename Handler>
+    void operator() (ozo::io_context& io, TimeConstraint t, Handler&& handler) const {
+        pool(io, std::move(t), std::forward<Handler>(handler));
+    }
+};
+
+template <typename Connection>
+void check(ozo::error_code ec, const Connection& conn) {
+    if (ec) {
+        std::cerr << ec.message();
+        if (!ozo::is_null_recursive(conn)) {
+            std::cerr << ": " << ozo::error_message(conn) << ' ' << ozo::get_error_context(conn);
+        }
+        std::cerr << std::endl;
+        std::abort();
+    }
+}
+
+/**
+ * Runs the same number of sequential requests for each scenario and prints the
+ * differences from the first one, which is the plain request, so the cost of the
+ * failover strategy on the happy path is seen without the cost of the request itself.
+ */
+class comparison {
+public:
+    explicit comparison(std::size_t requests) : requests_(requests) {}
+
+    template <typename Operation>
+    void run(const std::string& name, Operation operation) {
+        counter_.reset();
+        const auto allocations_start = allocations.load(std::memory_order_relaxed);
+        const auto cpu_start = cpu_time();
+        const auto start = clock_type::now();
+        for (std::size_t i = 0; i < requests_; ++i) {
+            operation(counter_);
+        }
+        result r;
+        r.latency = (clock_type::now() - start) / static_cast<double>(requests_);
+        r.cpu = (cpu_time() - cpu_start) / static_cast<double>(requests_);
+        r.allocations = static_cast<double>(allocations.load(std::memory_order_relaxed) - allocations_start) / requests_;
+        r.handler_allocations = static_cast<double>(counter_.allocations()) / requests_;
+        r.handler_bytes = static_cast<double>(counter_.bytes()) / requests_;
+        print(name, r);
+        if (!base_) {
+            base_ = r;
+        }
+    }
+
+private:
+    struct result {
+        std::chrono::duration<double, std::micro> latency {};
+        std::chrono::duration<double, std::micro> cpu {};
+        double allocations = 0;
+        double handler_allocations = 0;
+        double handler_bytes = 0;
+    };
+
+    void print(const std::string& name, const result& r) const {
+        std::cout << name << ":"
+            << " latency " << r.latency.count() << " us"
+            << ", cpu " << r.cpu.count() << " us/request"
+            << ", allocations " << r.allocations << " /request"
+            << ", handler allocations " << r.handler_allocations << " /request"
+            << ", " << r.handler_bytes << " bytes/request";
+        if (base_) {
+            std::cout << " (extra cpu " << (r.cpu - base_->cpu).count() << " us"
+                << ", extra allocations " << r.allocations - base_->allocations
+                << ", extra handler allocations " << r.handler_allocations - base_->handler_allocations
+                << ")";
+        }
+        std::cout << '\n';
+    }
+
+    std::size_t requests_;
+    ozo::allocation_counter counter_;
+    std::optional<result> base_;
+};
+
+void run(const ozo::connection_info<>& conn_info, std::size_t requests) {
+    asio::io_context io(1);
+    ozo::connection_pool_config config;
+    config.capacity = 1;
+    config.queue_capacity = 1;
+    auto pool = ozo::make_connection_pool(conn_info, config);
+    const auto roles_source = failover::make_role_based_connection_source(
+        failover::master=pool_source {pool},
+        failover::replica=pool_source {pool}
+    );
+
+    asio::spawn(io, [&] (asio::yield_context yield) {
+        ozo::error_code ec;
+        ozo::rows_of<std::int32_t> rows;
+
+        // Establishes the pooled connection, so none of the scenarios pays for it
+        auto conn = ozo::request(pool[io], query, request_timeout, ozo::into(rows), yield[ec]);
+        check(ec, conn);
+        conn = {};
+
+        comparison c(requests);
+        c.run("request", [&] (ozo::allocation_counter& counter) {
+            rows.clear();
+            auto conn = ozo::request(pool[io], query, request_timeout, ozo::into(rows),
+                ozo::bind_allocation_counter(counter, yield[ec]));
+            check(ec, conn);
+        });
+        c.run("retry", [&] (ozo::allocation_counter& counter) {
+            rows.clear();
+            auto conn = ozo::request[failover::retry(ozo::errc::connection_error) * 3](
+                pool[io], query, request_timeout, ozo::into(rows),
+                ozo::bind_allocation_counter(counter, yield[ec]));
+            check(ec, conn);
+        });
+        c.run("role_based", [&] (ozo::allocation_counter& counter) {
+            rows.clear();
+            auto conn = ozo::request[failover::role_based(failover::master, failover::replica)](
+                roles_source[io], query, request_timeout, ozo::into(rows),
+                ozo::bind_allocation_counter(counter, yield[ec]));
+            check(ec, conn);
+        });
+    });
+    io.run();
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        std::cout << "Usage: " << argv[0] << " <conninfo> [requests per scenario]" << std::endl;
+        return 1;
+    }
+
+    const ozo::connection_info<> conn_info(argv[1]);
+    const std::size_t requests = argc > 2 ? std::stoul(argv[2]) : 100000;
+
+    try {
+        run(conn_info, requests);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
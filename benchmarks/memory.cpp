@@ -0,0 +1,518 @@
+#include <ozo/connection_info.h>
+#include <ozo/connection_pool.h>
+#include <ozo/light_future.h>
+#include <ozo/request.h>
+#include <ozo/shortcuts.h>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/spawn.hpp>
+#include <boost/asio/use_future.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include <malloc.h>
+#include <unistd.h>
+
+namespace {
+
+std::atomic<std::int64_t> live_bytes {0};
+
+} // namespace
+
+// Tracks the bytes allocated via operator new and not freed yet, libpq allocates with malloc.
+void* operator new(std::size_t size) {
+    if (auto ptr = std::malloc(size ? size : 1)) {
+        live_bytes.fetch_add(static_cast<std::int64_t>(malloc_usable_size(ptr)), std::memory_order_relaxed);
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+// GCC takes free() of the memory from the replaced operator new inlined into a caller for a mismatch
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void operator delete(void* ptr) noexcept {
+    if (ptr) {
+        live_bytes.fetch_sub(static_cast<std::int64_t>(malloc_usable_size(ptr)), std::memory_order_relaxed);
+    }
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    ::operator delete(ptr);
+}
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+namespace {
+
+namespace asio = boost::asio;
+
+using pool_type = ozo::connection_pool<ozo::connection_info<>>;
+using provider_type = decltype(std::declval<pool_type&>()[std::declval<asio::io_context&>()]);
+using connection_type = ozo::connection_type<provider_type>;
+using signature_type = ozo::handler_signature<provider_type>;
+
+const auto query = ozo::make_query("SELECT 1");
+constexpr auto request_timeout = std::chrono::seconds(60);
+
+struct memory_snapshot {
+    std::int64_t rss = 0; // resident set size
+    std::int64_t heap = 0; // bytes in use by malloc, including libpq and the coroutine stacks
+    std::int64_t live = 0; // bytes in use via operator new
+};
+
+std::int64_t resident_bytes() {
+    std::ifstream statm("/proc/self/statm");
+    std::int64_t size = 0;
+    std::int64_t resident = 0;
+    statm >> size >> resident;
+    return resident * sysconf(_SC_PAGESIZE);
+}
+
+std::int64_t heap_bytes() {
+#if __GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33)
+    const auto info = mallinfo2();
+#else
+    const auto info = mallinfo();
+#endif
+    return static_cast<std::int64_t>(info.uordblks) + static_cast<std::int64_t>(info.hblkhd);
+}
+
+/**
+ * The freed memory is returned to the system first, so RSS of the previous scenario
+ * does not hide the growth of the next one.
+ */
+memory_snapshot take_snapshot() {
+    malloc_trim(0);
+    return {resident_bytes(), heap_bytes(), live_bytes.load(std::memory_order_relaxed)};
+}
+
+enum class category : std::size_t {
+    operation_context,
+    binary_query,
+    timer,
+    io_wait,
+    other,
+};
+
+constexpr std::size_t categories_count = static_cast<std::size_t>(category::other) + 1;
+
+constexpr std::array<const char*, categories_count> category_names {{
+    "operation context",
+    "binary_query",
+    "timers",
+    "io waits",
+    "other",
+}};
+
+/**
+ * Classifies an allocation by the outermost of the known types in its type name, e.g. the
+ * operation context holds the deadline handler, so the context name is found first.
+ */
+category classify(std::string_view type_name) {
+    constexpr std::pair<std::string_view, category> keywords[] = {
+        {"request_operation_context", category::operation_context},
+        {"binary_query", category::binary_query},
+        {"io_deadline_handler", category::timer},
+        {"wait_handler", category::timer},
+        {"reactive_null_buffers_op", category::io_wait},
+    };
+    auto result = category::other;
+    auto first = std::string_view::npos;
+    for (const auto& [keyword, value] : keywords) {
+        const auto pos = type_name.find(keyword);
+        if (pos < first) {
+            first = pos;
+            result = value;
+        }
+    }
+    return result;
+}
+
+struct allocation_stats {
+    std::array<std::atomic<std::int64_t>, categories_count> live {};
+    std::array<std::atomic<std::int64_t>, categories_count> allocated {};
+
+    void reset() noexcept {
+        for (std::size_t i = 0; i < categories_count; ++i) {
+            live[i].store(0, std::memory_order_relaxed);
+            allocated[i].store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+/**
+ * Allocator associated with the completion handler, so the library and Boost.Asio allocate
+ * the operation state via it. Note that the operation slab of the connection is used with
+ * the default allocator only, so the state is allocated on the heap as with a custom allocator.
+ */
+template <typename T>
+class tracking_allocator {
+public:
+    using value_type = T;
+
+    explicit tracking_allocator(allocation_stats& stats) noexcept : stats_(std::addressof(stats)) {}
+
+    template <typename U>
+    tracking_allocator(const tracking_allocator<U>& other) noexcept : stats_(other.stats()) {}
+
+    T* allocate(std::size_t n) {
+        const auto bytes = static_cast<std::int64_t>(n * sizeof(T));
+        stats_->live[index()].fetch_add(bytes, std::memory_order_relaxed);
+        stats_->allocated[index()].fetch_add(bytes, std::memory_order_relaxed);
+        return std::allocator<T>{}.allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        stats_->live[index()].fetch_sub(static_cast<std::int64_t>(n * sizeof(T)), std::memory_order_relaxed);
+        std::allocator<T>{}.deallocate(p, n);
+    }
+
+    allocation_stats* stats() const noexcept { return stats_;}
+
+    template <typename U>
+    friend bool operator ==(const tracking_allocator& lhs, const tracking_allocator<U>& rhs) noexcept {
+        return lhs.stats() == rhs.stats();
+    }
+
+    template <typename U>
+    friend bool operator !=(const tracking_allocator& lhs, const tracking_allocator<U>& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+private:
+    static std::size_t index() {
+        static const auto result = static_cast<std::size_t>(classify(typeid(T).name()));
+        return result;
+    }
+
+    allocation_stats* stats_;
+};
+
+template <typename Token>
+struct tracking_token {
+    Token token_;
+    allocation_stats* stats_;
+};
+
+template <typename Handler>
+struct tracking_handler {
+    Handler handler_;
+    allocation_stats* stats_;
+
+    template <typename Token>
+    tracking_handler(tracking_token<Token>&& token)
+    : handler_(std::move(token.token_)), stats_(token.stats_) {}
+
+    template <typename Token>
+    tracking_handler(tracking_token<Token>& token)
+    : handler_(token.token_), stats_(token.stats_) {}
+
+    template <typename ...Args>
+    void operator() (Args&& ...args) {
+        handler_(std::forward<Args>(args)...);
+    }
+
+    using executor_type = asio::associated_executor_t<Handler>;
+
+    executor_type get_executor() const noexcept { return asio::get_associated_executor(handler_);}
+
+    using allocator_type = tracking_allocator<char>;
+
+    allocator_type get_allocator() const noexcept { return allocator_type{*stats_};}
+};
+
+template <typename Token>
+auto track(allocation_stats& stats, Token&& token) {
+    return tracking_token<std::decay_t<Token>>{std::forward<Token>(token), std::addressof(stats)};
+}
+
+} // namespace
+
+namespace boost::asio {
+
+template <typename Token, typename Signature>
+class async_result<tracking_token<Token>, Signature> {
+    using target_type = async_result<Token, Signature>;
+
+public:
+    using completion_handler_type = tracking_handler<typename target_type::completion_handler_type>;
+    using return_type = typename target_type::return_type;
+
+    explicit async_result(completion_handler_type& h) : target_(h.handler_) {}
+
+    return_type get() { return target_.get();}
+
+private:
+    target_type target_;
+};
+
+} // namespace boost::asio
+
+namespace {
+
+template <typename Token>
+constexpr std::size_t handler_size = sizeof(typename asio::async_result<Token, signature_type>::completion_handler_type);
+
+template <typename Connection>
+void check(ozo::error_code ec, const Connection& conn) {
+    if (ec) {
+        std::cerr << ec.message();
+        if (!ozo::is_null_recursive(conn)) {
+            std::cerr << ": " << ozo::error_message(conn) << ' ' << ozo::get_error_context(conn);
+        }
+        std::cerr << std::endl;
+        std::abort();
+    }
+}
+
+class latch {
+public:
+    explicit latch(std::size_t count) : count_(count) {}
+
+    void count_down() {
+        const std::lock_guard lock(mutex_);
+        if (--count_ == 0) {
+            done_.notify_all();
+        }
+    }
+
+    void wait() {
+        std::unique_lock lock(mutex_);
+        done_.wait(lock, [&] { return count_ == 0; });
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable done_;
+    std::size_t count_;
+};
+
+void print_per_unit(std::ostream& stream, const memory_snapshot& before, const memory_snapshot& after, std::size_t units) {
+    const auto per_unit = [&] (std::int64_t first, std::int64_t last) {
+        return static_cast<double>(last - first) / static_cast<double>(units);
+    };
+    stream << "rss " << per_unit(before.rss, after.rss) << " bytes"
+        << ", heap " << per_unit(before.heap, after.heap) << " bytes"
+        << ", operator new " << per_unit(before.live, after.live) << " bytes";
+}
+
+/**
+ * Opens the connections concurrently, so the pool holds exactly `connections` idle ones,
+ * and reports the memory taken per idle connection including libpq and the socket state.
+ */
+void run_idle_connections(asio::io_context& io, pool_type& pool, std::size_t connections, const memory_snapshot& before) {
+    std::vector<connection_type> held;
+    held.reserve(connections);
+    latch done(1);
+    asio::post(io, [&] {
+        for (std::size_t i = 0; i < connections; ++i) {
+            ozo::get_connection(pool[io], request_timeout, [&] (ozo::error_code ec, connection_type conn) {
+                check(ec, conn);
+                held.push_back(std::move(conn));
+                if (held.size() == connections) {
+                    held.clear();
+                    done.count_down();
+                }
+            });
+        }
+    });
+    done.wait();
+    const auto after = take_snapshot();
+    std::cout << "idle pooled connection: ";
+    print_per_unit(std::cout, before, after, connections);
+    std::cout << '\n';
+}
+
+/**
+ * Memory of the requests sampled while all of them are in flight: the requests beyond the
+ * pool capacity wait for a connection in the pool queue, the rest wait for the reply of
+ * the server. The breakdown is the state allocated via the handler allocator live at the
+ * sample, and allocated in total per request, so the state which does not outlive a step,
+ * e.g. `binary_query` freed once the query is sent, is visible as well.
+ */
+class in_flight_measurement {
+public:
+    in_flight_measurement(std::string name, std::size_t requests, std::size_t handler_size)
+    : name_(std::move(name)), requests_(requests), handler_size_(handler_size) {}
+
+    allocation_stats& stats() noexcept { return stats_;}
+
+    void start() {
+        stats_.reset();
+        before_ = take_snapshot();
+    }
+
+    void sample() {
+        sample_ = take_snapshot();
+        for (std::size_t i = 0; i < categories_count; ++i) {
+            live_[i] = stats_.live[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    void print(std::ostream& stream) const {
+        const auto per_request = [&] (std::int64_t value) {
+            return static_cast<double>(value) / static_cast<double>(requests_);
+        };
+        stream << name_ << ": in-flight request ";
+        print_per_unit(stream, before_, sample_, requests_);
+        stream << ", handler " << handler_size_ << " bytes\n";
+        for (std::size_t i = 0; i < categories_count; ++i) {
+            stream << "    " << category_names[i] << ": live " << per_request(live_[i]) << " bytes"
+                << ", allocated " << per_request(stats_.allocated[i].load(std::memory_order_relaxed)) << " bytes\n";
+        }
+    }
+
+private:
+    std::string name_;
+    std::size_t requests_;
+    std::size_t handler_size_;
+    allocation_stats stats_;
+    memory_snapshot before_;
+    memory_snapshot sample_;
+    std::array<std::int64_t, categories_count> live_ {};
+};
+
+struct scenario {
+    asio::io_context& io;
+    pool_type& pool;
+    std::size_t requests;
+    std::chrono::milliseconds sample_delay;
+};
+
+template <typename Initiate, typename Wait>
+void measure(const scenario& s, in_flight_measurement& m, Initiate initiate, Wait wait) {
+    m.start();
+    asio::post(s.io, initiate);
+    std::this_thread::sleep_for(s.sample_delay);
+    m.sample();
+    wait();
+    m.print(std::cout);
+}
+
+void run_callback(const scenario& s) {
+    using token_type = std::function<void(ozo::error_code, connection_type)>;
+    in_flight_measurement m("callback", s.requests, handler_size<token_type>);
+    std::vector<ozo::rows_of<std::int32_t>> rows(s.requests);
+    latch done(s.requests);
+    measure(s, m, [&] {
+        for (auto& r : rows) {
+            ozo::request(s.pool[s.io], query, request_timeout, ozo::into(r), track(m.stats(),
+                [&] (ozo::error_code ec, connection_type conn) {
+                    check(ec, conn);
+                    done.count_down();
+                }));
+        }
+    }, [&] { done.wait(); });
+}
+
+template <typename Token>
+void run_future(const scenario& s, const std::string& name, Token token) {
+    in_flight_measurement m(name, s.requests, handler_size<Token>);
+    std::vector<ozo::rows_of<std::int32_t>> rows(s.requests);
+    using future_type = decltype(ozo::request(s.pool[s.io], query, request_timeout, ozo::into(rows.front()),
+        track(m.stats(), token)));
+    std::vector<future_type> futures;
+    futures.reserve(s.requests);
+    latch initiated(1);
+    measure(s, m, [&] {
+        for (auto& r : rows) {
+            futures.push_back(ozo::request(s.pool[s.io], query, request_timeout, ozo::into(r), track(m.stats(), token)));
+        }
+        initiated.count_down();
+    }, [&] {
+        initiated.wait();
+        for (auto& future : futures) {
+            future.get();
+        }
+    });
+}
+
+/**
+ * A coroutine per request, so the handler state includes the coroutine stack which is
+ * allocated via malloc and is visible in the heap and RSS figures only.
+ */
+void run_yield_context(const scenario& s) {
+    in_flight_measurement m("yield_context", s.requests, handler_size<asio::yield_context>);
+    std::vector<ozo::rows_of<std::int32_t>> rows(s.requests);
+    latch done(s.requests);
+    measure(s, m, [&] {
+        for (auto& r : rows) {
+            asio::spawn(s.io, [&] (asio::yield_context yield) {
+                ozo::error_code ec;
+                auto conn = ozo::request(s.pool[s.io], query, request_timeout, ozo::into(r), track(m.stats(), yield[ec]));
+                check(ec, conn);
+                done.count_down();
+            });
+        }
+    }, [&] { done.wait(); });
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        std::cout << "Usage: " << argv[0] << " <conninfo> [connections] [in-flight requests] [sample delay ms]\n"
+            << "The server should delay the replies longer than the sample delay, e.g."
+            << " ozo_benchmark_mock_server --latency=1000" << std::endl;
+        return 1;
+    }
+
+    const ozo::connection_info<> conn_info(argv[1]);
+    const std::size_t connections = argc > 2 ? std::stoul(argv[2]) : 100;
+    const std::size_t requests = argc > 3 ? std::stoul(argv[3]) : 10000;
+    const std::chrono::milliseconds sample_delay(argc > 4 ? std::stoul(argv[4]) : 200);
+
+    try {
+        asio::io_context io(1);
+        auto guard = asio::make_work_guard(io);
+        std::thread thread([&] { io.run(); });
+
+        const auto before = take_snapshot();
+        ozo::connection_pool_config config;
+        config.capacity = connections;
+        config.queue_capacity = requests;
+        config.idle_timeout = std::chrono::hours(1);
+        pool_type pool(conn_info, config);
+
+        run_idle_connections(io, pool, connections, before);
+
+        const scenario s {io, pool, requests, sample_delay};
+        run_callback(s);
+        run_future(s, "use_future", asio::use_future);
+        run_future(s, "use_light_future", ozo::use_light_future);
+        run_yield_context(s);
+
+        guard.reset();
+        thread.join();
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,939 @@
+/**
+ * PostgreSQL mock server for the client-side load tests.
+ *
+ * The server speaks enough of the frontend/backend protocol version 3 to serve the
+ * `ozo_benchmark_performance` and `ozo_benchmark_completion_tokens` queries: the startup
+ * without authentication, the simple and the extended query protocols with the prepared
+ * statements, and COPY FROM STDIN and COPY TO STDOUT. The results are made at start and
+ * written from memory, so the client is measured instead of the server:
+ *
+ *  - `SELECT 1` returns a single int4 value;
+ *  - a query from `pg_type` returns `--rows` rows of the `ozo::benchmark::pg_type` shape
+ *    with `typname` of `--text_size` bytes;
+ *  - `COPY ... TO STDOUT` returns `--copy_rows` rows of (int8, text) in the requested format;
+ *  - `COPY ... FROM STDIN` consumes the data and counts the rows;
+ *  - other queries which return rows fail with `feature_not_supported`, the rest of
+ *    the commands, e.g. `BEGIN` or `SET`, complete without rows.
+ *
+ * The replies of each round trip are delayed by `--latency` to emulate the network.
+ */
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/signal_set.hpp>
+#include <boost/asio/spawn.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+namespace asio = boost::asio;
+using tcp = asio::ip::tcp;
+
+constexpr std::int32_t protocol_version = 196608;
+constexpr std::int32_t cancel_request_code = 80877102;
+constexpr std::int32_t ssl_request_code = 80877103;
+constexpr std::int32_t gssenc_request_code = 80877104;
+
+constexpr std::int32_t bool_oid = 16;
+constexpr std::int32_t char_oid = 18;
+constexpr std::int32_t name_oid = 19;
+constexpr std::int32_t int2_oid = 21;
+constexpr std::int32_t int4_oid = 23;
+constexpr std::int32_t oid_oid = 26;
+
+constexpr std::string_view copy_signature {"PGCOPY\n\377\r\n\0", 11};
+
+struct server_params {
+    std::string host = "127.0.0.1";
+    unsigned short port = 5433;
+    std::size_t threads = 1;
+    std::size_t rows = 100;
+    std::size_t text_size = 16;
+    std::size_t copy_rows = 1000;
+    std::chrono::steady_clock::duration latency {};
+};
+
+void put_int16(std::string& out, std::int16_t v) {
+    const auto u = static_cast<std::uint16_t>(v);
+    out.push_back(static_cast<char>(u >> 8));
+    out.push_back(static_cast<char>(u));
+}
+
+void put_int32(std::string& out, std::int32_t v) {
+    const auto u = static_cast<std::uint32_t>(v);
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        out.push_back(static_cast<char>(u >> shift));
+    }
+}
+
+void put_int64(std::string& out, std::int64_t v) {
+    const auto u = static_cast<std::uint64_t>(v);
+    for (int shift = 56; shift >= 0; shift -= 8) {
+        out.push_back(static_cast<char>(u >> shift));
+    }
+}
+
+void put_cstring(std::string& out, std::string_view v) {
+    out.append(v.data(), v.size());
+    out.push_back('\0');
+}
+
+/**
+ * Writes a backend message, the length is filled in after the body is written.
+ */
+template <typename Body>
+void put_message(std::string& out, char type, Body&& body) {
+    out.push_back(type);
+    const auto length_pos = out.size();
+    out.append(4, '\0');
+    body(out);
+    std::string length;
+    put_int32(length, static_cast<std::int32_t>(out.size() - length_pos));
+    std::copy(length.begin(), length.end(), out.begin() + static_cast<std::ptrdiff_t>(length_pos));
+}
+
+void put_empty_message(std::string& out, char type) {
+    put_message(out, type, [] (std::string&) {});
+}
+
+void put_error(std::string& out, std::string_view code, std::string_view text) {
+    put_message(out, 'E', [&] (std::string& out) {
+        out.push_back('S');
+        put_cstring(out, "ERROR");
+        out.push_back('V');
+        put_cstring(out, "ERROR");
+        out.push_back('C');
+        put_cstring(out, code);
+        out.push_back('M');
+        put_cstring(out, text);
+        out.push_back('\0');
+    });
+}
+
+/**
+ * Reads the fields of a frontend message, a message shorter than its fields is malformed.
+ */
+class message_reader {
+public:
+    message_reader(const char* data, std::size_t size) : data_(data), end_(data + size) {}
+
+    std::int16_t int16() {
+        const auto v = bytes(2);
+        return static_cast<std::int16_t>((std::uint8_t(v[0]) << 8) | std::uint8_t(v[1]));
+    }
+
+    std::int32_t int32() {
+        const auto v = bytes(4);
+        return static_cast<std::int32_t>((std::uint32_t(std::uint8_t(v[0])) << 24) | (std::uint32_t(std::uint8_t(v[1])) << 16)
+            | (std::uint32_t(std::uint8_t(v[2])) << 8) | std::uint32_t(std::uint8_t(v[3])));
+    }
+
+    std::string_view cstring() {
+        const auto end = std::find(data_, end_, '\0');
+        if (end == end_) {
+            throw std::runtime_error("malformed message: string is not terminated");
+        }
+        const std::string_view result(data_, static_cast<std::size_t>(end - data_));
+        data_ = end + 1;
+        return result;
+    }
+
+    std::string_view bytes(std::size_t size) {
+        if (static_cast<std::size_t>(end_ - data_) < size) {
+            throw std::runtime_error("malformed message: unexpected end");
+        }
+        const std::string_view result(data_, size);
+        data_ += size;
+        return result;
+    }
+
+    std::string_view rest() { return bytes(static_cast<std::size_t>(end_ - data_));}
+
+private:
+    const char* data_;
+    const char* end_;
+};
+
+/**
+ * Value of a result field in the text and the binary formats.
+ */
+struct field {
+    std::string text;
+    std::string binary;
+};
+
+field int2_field(std::int16_t v) {
+    field result {std::to_string(v), {}};
+    put_int16(result.binary, v);
+    return result;
+}
+
+field int4_field(std::int32_t v) {
+    field result {std::to_string(v), {}};
+    put_int32(result.binary, v);
+    return result;
+}
+
+field oid_field(std::uint32_t v) {
+    field result {std::to_string(v), {}};
+    put_int32(result.binary, static_cast<std::int32_t>(v));
+    return result;
+}
+
+field bool_field(bool v) {
+    return {v ? "t" : "f", std::string(1, v ? '\1' : '\0')};
+}
+
+field char_field(char v) {
+    return {std::string(1, v), std::string(1, v)};
+}
+
+field text_field(std::string v) {
+    return {v, v};
+}
+
+struct column {
+    std::string name;
+    std::int32_t type;
+    std::int16_t size;
+};
+
+/**
+ * Result encoded into `RowDescription` and `DataRow` messages for both formats,
+ * the index of an array is the format code.
+ */
+struct canned_result {
+    std::array<std::string, 2> description;
+    std::array<std::string, 2> rows;
+    std::string tag;
+
+    canned_result(const std::vector<column>& columns, const std::vector<std::vector<field>>& values) {
+        for (std::int16_t format = 0; format < 2; ++format) {
+            put_message(description[format], 'T', [&] (std::string& out) {
+                put_int16(out, static_cast<std::int16_t>(columns.size()));
+                for (const auto& c : columns) {
+                    put_cstring(out, c.name);
+                    put_int32(out, 0);
+                    put_int16(out, 0);
+                    put_int32(out, c.type);
+                    put_int16(out, c.size);
+                    put_int32(out, -1);
+                    put_int16(out, format);
+                }
+            });
+            for (const auto& row : values) {
+                put_message(rows[format], 'D', [&] (std::string& out) {
+                    put_int16(out, static_cast<std::int16_t>(row.size()));
+                    for (const auto& v : row) {
+                        const auto& data = format ? v.binary : v.text;
+                        put_int32(out, static_cast<std::int32_t>(data.size()));
+                        out.append(data);
+                    }
+                });
+            }
+        }
+        tag = "SELECT " + std::to_string(values.size());
+    }
+};
+
+canned_result make_select_1() {
+    return canned_result({{"?column?", int4_oid, 4}}, {{int4_field(1)}});
+}
+
+canned_result make_pg_type(const server_params& params) {
+    const std::vector<column> columns {
+        {"typname", name_oid, 64},
+        {"typnamespace", oid_oid, 4},
+        {"typowner", oid_oid, 4},
+        {"typlen", int2_oid, 2},
+        {"typbyval", bool_oid, 1},
+        {"typcategory", char_oid, 1},
+        {"typispreferred", bool_oid, 1},
+        {"typisdefined", bool_oid, 1},
+        {"typdelim", char_oid, 1},
+        {"typrelid", oid_oid, 4},
+        {"typelem", oid_oid, 4},
+        {"typarray", oid_oid, 4},
+    };
+    std::vector<std::vector<field>> values;
+    values.reserve(params.rows);
+    for (std::size_t i = 0; i < params.rows; ++i) {
+        auto name = "type_" + std::to_string(i);
+        name.resize(std::max(params.text_size, name.size()), 'x');
+        values.push_back({
+            text_field(std::move(name)), oid_field(11), oid_field(10), int2_field(4), bool_field(true),
+            char_field('N'), bool_field(false), bool_field(true), char_field(','), oid_field(0),
+            oid_field(0), oid_field(static_cast<std::uint32_t>(16384 + i)),
+        });
+    }
+    return canned_result(columns, values);
+}
+
+/**
+ * `CopyData` messages of a COPY TO STDOUT result for both formats, the index of
+ * an array is the format code.
+ */
+struct canned_copy {
+    std::array<std::string, 2> data;
+    std::string tag;
+
+    explicit canned_copy(const server_params& params) {
+        put_message(data[1], 'd', [] (std::string& out) {
+            out.append(copy_signature);
+            put_int32(out, 0);
+            put_int32(out, 0);
+        });
+        for (std::size_t i = 0; i < params.copy_rows; ++i) {
+            auto name = "name_" + std::to_string(i);
+            name.resize(std::max(params.text_size, name.size()), 'x');
+            put_message(data[0], 'd', [&] (std::string& out) {
+                out.append(std::to_string(i));
+                out.push_back('\t');
+                out.append(name);
+                out.push_back('\n');
+            });
+            put_message(data[1], 'd', [&] (std::string& out) {
+                put_int16(out, 2);
+                put_int32(out, 8);
+                put_int64(out, static_cast<std::int64_t>(i));
+                put_int32(out, static_cast<std::int32_t>(name.size()));
+                out.append(name);
+            });
+        }
+        put_message(data[1], 'd', [] (std::string& out) {
+            put_int16(out, -1);
+        });
+        tag = "COPY " + std::to_string(params.copy_rows);
+    }
+};
+
+struct server_data {
+    canned_result select_1;
+    canned_result pg_type;
+    canned_copy copy;
+    std::chrono::steady_clock::duration latency;
+    std::atomic<std::int32_t> next_pid {1};
+};
+
+/**
+ * What the server does for a query.
+ */
+struct query_plan {
+    enum class kind {
+        empty,
+        command,
+        result,
+        copy_in,
+        copy_out,
+        unsupported,
+    };
+
+    kind type = kind::empty;
+    std::string tag;
+    const canned_result* result = nullptr;
+    std::int16_t copy_format = 0;
+};
+
+std::string to_upper(std::string_view v) {
+    std::string result(v);
+    std::transform(result.begin(), result.end(), result.begin(),
+        [] (unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    return result;
+}
+
+query_plan make_plan(std::string_view text, const server_data& data) {
+    const auto is_space = [] (char c) { return std::isspace(static_cast<unsigned char>(c)) != 0; };
+    while (!text.empty() && (is_space(text.back()) || text.back() == ';')) {
+        text.remove_suffix(1);
+    }
+    while (!text.empty() && is_space(text.front())) {
+        text.remove_prefix(1);
+    }
+    if (text.empty()) {
+        return {};
+    }
+
+    const auto upper = to_upper(text);
+    const auto first_word = upper.substr(0, std::min(upper.size(), upper.find_first_of(" \t\r\n(")));
+
+    if (upper == "SELECT 1") {
+        return {query_plan::kind::result, data.select_1.tag, &data.select_1};
+    }
+    if (first_word == "SELECT" && upper.find("FROM PG_TYPE") != std::string::npos) {
+        return {query_plan::kind::result, data.pg_type.tag, &data.pg_type};
+    }
+    if (first_word == "COPY") {
+        const std::int16_t format = upper.find("BINARY") != std::string::npos;
+        if (upper.find("FROM STDIN") != std::string::npos) {
+            return {query_plan::kind::copy_in, {}, nullptr, format};
+        }
+        if (upper.find("TO STDOUT") != std::string::npos) {
+            return {query_plan::kind::copy_out, data.copy.tag, nullptr, format};
+        }
+    }
+    if (first_word == "SELECT" || first_word == "WITH" || first_word == "VALUES" || first_word == "COPY"
+            || upper.find("RETURNING") != std::string::npos) {
+        return {query_plan::kind::unsupported, std::string(text)};
+    }
+    if (first_word == "INSERT") {
+        return {query_plan::kind::command, "INSERT 0 1"};
+    }
+    if (first_word == "UPDATE" || first_word == "DELETE") {
+        return {query_plan::kind::command, first_word + " 1"};
+    }
+    if (first_word == "START") {
+        return {query_plan::kind::command, "START TRANSACTION"};
+    }
+    if (first_word == "DISCARD") {
+        return {query_plan::kind::command, upper};
+    }
+    return {query_plan::kind::command, first_word};
+}
+
+/**
+ * Counts the rows of COPY FROM STDIN data received by chunks.
+ */
+class copy_counter {
+public:
+    explicit copy_counter(std::int16_t format = 0) : format_(format) {}
+
+    void feed(std::string_view chunk) {
+        if (format_ == 0) {
+            rows_ += static_cast<std::size_t>(std::count(chunk.begin(), chunk.end(), '\n'));
+            return;
+        }
+        pending_.append(chunk);
+        std::size_t pos = 0;
+        const auto available = [&] { return pending_.size() - pos; };
+        const auto get_int32 = [&] {
+            message_reader reader(pending_.data() + pos, 4);
+            pos += 4;
+            return reader.int32();
+        };
+        if (!header_done_) {
+            if (available() < copy_signature.size() + 8) {
+                return;
+            }
+            pos += copy_signature.size() + 4;
+            const auto extension = static_cast<std::size_t>(get_int32());
+            if (available() < extension) {
+                pending_.erase(0, pos - copy_signature.size() - 8);
+                return;
+            }
+            pos += extension;
+            header_done_ = true;
+        }
+        while (!trailer_ && available() >= 2) {
+            const auto tuple_start = pos;
+            const auto fields = message_reader(pending_.data() + pos, 2).int16();
+            pos += 2;
+            if (fields < 0) {
+                trailer_ = true;
+                break;
+            }
+            bool complete = true;
+            for (std::int16_t i = 0; i < fields && complete; ++i) {
+                if (available() < 4) {
+                    complete = false;
+                    break;
+                }
+                const auto size = get_int32();
+                if (size > 0) {
+                    if (available() < static_cast<std::size_t>(size)) {
+                        complete = false;
+                        break;
+                    }
+                    pos += static_cast<std::size_t>(size);
+                }
+            }
+            if (!complete) {
+                pos = tuple_start;
+                break;
+            }
+            ++rows_;
+        }
+        pending_.erase(0, pos);
+    }
+
+    std::size_t rows() const noexcept { return rows_;}
+
+private:
+    std::int16_t format_;
+    std::string pending_;
+    bool header_done_ = false;
+    bool trailer_ = false;
+    std::size_t rows_ = 0;
+};
+
+class session {
+public:
+    session(tcp::socket socket, server_data& data)
+    : socket_(std::move(socket)), data_(data), timer_(socket_.get_executor()), in_(64 * 1024) {}
+
+    void run(asio::yield_context yield) {
+        if (!startup(yield)) {
+            return;
+        }
+        for (;;) {
+            const auto [type, reader] = read_message(yield);
+            if (type == 'X') {
+                return;
+            }
+            handle(type, reader, yield);
+        }
+    }
+
+private:
+    struct statement {
+        query_plan plan;
+        std::vector<std::int32_t> param_types;
+    };
+
+    struct portal {
+        query_plan plan;
+        std::int16_t format = 0;
+    };
+
+    bool startup(asio::yield_context yield) {
+        for (;;) {
+            ensure(4, yield);
+            const auto size = static_cast<std::size_t>(message_reader(in_.data() + in_begin_, 4).int32());
+            if (size < 8) {
+                throw std::runtime_error("malformed startup message");
+            }
+            ensure(size, yield);
+            message_reader reader(in_.data() + in_begin_ + 4, size - 4);
+            in_begin_ += size;
+            const auto code = reader.int32();
+            if (code == ssl_request_code || code == gssenc_request_code) {
+                out_.push_back('N');
+                flush(false, yield);
+                continue;
+            }
+            if (code == cancel_request_code) {
+                return false;
+            }
+            if (code != protocol_version) {
+                put_error(out_, "0A000", "unsupported frontend protocol");
+                flush(false, yield);
+                return false;
+            }
+            break;
+        }
+
+        put_message(out_, 'R', [] (std::string& out) { put_int32(out, 0); });
+        const std::pair<std::string_view, std::string_view> parameters[] {
+            {"server_version", "14.0"},
+            {"server_encoding", "UTF8"},
+            {"client_encoding", "UTF8"},
+            {"DateStyle", "ISO, MDY"},
+            {"TimeZone", "UTC"},
+            {"integer_datetimes", "on"},
+            {"standard_conforming_strings", "on"},
+        };
+        for (const auto& [name, value] : parameters) {
+            put_message(out_, 'S', [&, name = name, value = value] (std::string& out) {
+                put_cstring(out, name);
+                put_cstring(out, value);
+            });
+        }
+        put_message(out_, 'K', [&] (std::string& out) {
+            put_int32(out, data_.next_pid.fetch_add(1, std::memory_order_relaxed));
+            put_int32(out, 0);
+        });
+        ready_for_query();
+        flush(true, yield);
+        return true;
+    }
+
+    void handle(char type, message_reader reader, asio::yield_context yield) {
+        if (copy_in_) {
+            return handle_copy(type, reader, yield);
+        }
+        switch (type) {
+            case 'Q':
+                simple_query(reader.cstring());
+                if (!copy_in_) {
+                    ready_for_query();
+                    flush(true, yield);
+                } else {
+                    flush(false, yield);
+                }
+                return;
+            case 'S':
+                failed_ = false;
+                ready_for_query();
+                return flush(true, yield);
+            case 'H':
+                return flush(true, yield);
+        }
+        if (failed_) {
+            return;
+        }
+        switch (type) {
+            case 'P': return parse(reader);
+            case 'B': return bind(reader);
+            case 'D': return describe(reader);
+            case 'E':
+                execute(reader.cstring(), true);
+                if (copy_in_) {
+                    // The frontend waits for CopyInResponse before the data, and Sync is ignored until CopyDone
+                    flush(true, yield);
+                }
+                return;
+            case 'C': return close(reader);
+        }
+        fail("08P01", std::string("unexpected message type '") + type + "'");
+    }
+
+    void handle_copy(char type, message_reader reader, asio::yield_context yield) {
+        switch (type) {
+            case 'd':
+                copy_counter_.feed(reader.rest());
+                return;
+            case 'c':
+                copy_in_ = false;
+                put_message(out_, 'C', [&] (std::string& out) {
+                    put_cstring(out, "COPY " + std::to_string(copy_counter_.rows()));
+                });
+                break;
+            case 'f':
+                copy_in_ = false;
+                fail("57014", "COPY from stdin failed: " + std::string(reader.cstring()));
+                break;
+            case 'S':
+            case 'H':
+                // Ignored in the copy-in mode, the frontend sends Sync after CopyDone
+                return;
+            default:
+                copy_in_ = false;
+                fail("08P01", std::string("unexpected message type '") + type + "' during COPY from stdin");
+                break;
+        }
+        if (!copy_extended_) {
+            failed_ = false;
+            ready_for_query();
+            flush(true, yield);
+        }
+    }
+
+    void simple_query(std::string_view text) {
+        portal p {make_plan(text, data_), 0};
+        if (p.plan.type == query_plan::kind::result) {
+            out_.append(p.plan.result->description[0]);
+        }
+        execute(p, false);
+        if (!copy_in_) {
+            failed_ = false;
+        }
+    }
+
+    void parse(message_reader reader) {
+        const auto name = reader.cstring();
+        const auto text = reader.cstring();
+        statement s {make_plan(text, data_), {}};
+        const auto count = reader.int16();
+        for (std::int16_t i = 0; i < count; ++i) {
+            s.param_types.push_back(reader.int32());
+        }
+        if (!name.empty() && statements_.count(std::string(name))) {
+            return fail("42P05", "prepared statement \"" + std::string(name) + "\" already exists");
+        }
+        statements_[std::string(name)] = std::move(s);
+        put_empty_message(out_, '1');
+    }
+
+    void bind(message_reader reader) {
+        const auto portal_name = reader.cstring();
+        const auto statement_name = reader.cstring();
+        const auto formats = reader.int16();
+        reader.bytes(2 * static_cast<std::size_t>(std::max<std::int16_t>(formats, 0)));
+        const auto params = reader.int16();
+        for (std::int16_t i = 0; i < params; ++i) {
+            const auto size = reader.int32();
+            if (size > 0) {
+                reader.bytes(static_cast<std::size_t>(size));
+            }
+        }
+        const auto result_formats = reader.int16();
+        const std::int16_t format = result_formats > 0 ? reader.int16() : 0;
+
+        const auto s = statements_.find(std::string(statement_name));
+        if (s == statements_.end()) {
+            return fail("26000", "prepared statement \"" + std::string(statement_name) + "\" does not exist");
+        }
+        portals_[std::string(portal_name)] = portal {s->second.plan, format};
+        put_empty_message(out_, '2');
+    }
+
+    void describe(message_reader reader) {
+        const auto type = reader.bytes(1)[0];
+        const std::string name(reader.cstring());
+        if (type == 'S') {
+            const auto s = statements_.find(name);
+            if (s == statements_.end()) {
+                return fail("26000", "prepared statement \"" + name + "\" does not exist");
+            }
+            put_message(out_, 't', [&] (std::string& out) {
+                put_int16(out, static_cast<std::int16_t>(s->second.param_types.size()));
+                for (const auto oid : s->second.param_types) {
+                    put_int32(out, oid);
+                }
+            });
+            return describe(s->second.plan, 0);
+        }
+        const auto p = portals_.find(name);
+        if (p == portals_.end()) {
+            return fail("34000", "portal \"" + name + "\" does not exist");
+        }
+        describe(p->second.plan, p->second.format);
+    }
+
+    void describe(const query_plan& plan, std::int16_t format) {
+        if (plan.type == query_plan::kind::result) {
+            out_.append(plan.result->description[format != 0]);
+        } else {
+            put_empty_message(out_, 'n');
+        }
+    }
+
+    void close(message_reader reader) {
+        const auto type = reader.bytes(1)[0];
+        const std::string name(reader.cstring());
+        if (type == 'S') {
+            statements_.erase(name);
+        } else {
+            portals_.erase(name);
+        }
+        put_empty_message(out_, '3');
+    }
+
+    void execute(std::string_view portal_name, bool extended) {
+        const auto p = portals_.find(std::string(portal_name));
+        if (p == portals_.end()) {
+            return fail("34000", "portal \"" + std::string(portal_name) + "\" does not exist");
+        }
+        execute(p->second, extended);
+    }
+
+    void execute(const portal& p, bool extended) {
+        const auto& plan = p.plan;
+        switch (plan.type) {
+            case query_plan::kind::empty:
+                return put_empty_message(out_, 'I');
+            case query_plan::kind::command:
+                if (plan.tag == "BEGIN" || plan.tag == "START TRANSACTION") {
+                    transaction_ = 'T';
+                } else if (plan.tag == "COMMIT" || plan.tag == "ROLLBACK" || plan.tag == "END" || plan.tag == "ABORT") {
+                    transaction_ = 'I';
+                }
+                return complete(plan.tag);
+            case query_plan::kind::result:
+                out_.append(plan.result->rows[p.format != 0]);
+                return complete(plan.tag);
+            case query_plan::kind::copy_in:
+                copy_in_ = true;
+                copy_extended_ = extended;
+                copy_counter_ = copy_counter(plan.copy_format);
+                return put_message(out_, 'G', [&] (std::string& out) {
+                    out.push_back(static_cast<char>(plan.copy_format));
+                    put_int16(out, 0);
+                });
+            case query_plan::kind::copy_out:
+                put_message(out_, 'H', [&] (std::string& out) {
+                    out.push_back(static_cast<char>(plan.copy_format));
+                    put_int16(out, 2);
+                    put_int16(out, plan.copy_format);
+                    put_int16(out, plan.copy_format);
+                });
+                out_.append(data_.copy.data[plan.copy_format != 0]);
+                put_empty_message(out_, 'c');
+                return complete(plan.tag);
+            case query_plan::kind::unsupported:
+                return fail("0A000", "mock server has no result for query \"" + plan.tag + "\"");
+        }
+    }
+
+    void complete(const std::string& tag) {
+        put_message(out_, 'C', [&] (std::string& out) { put_cstring(out, tag); });
+    }
+
+    void fail(std::string_view code, const std::string& text) {
+        put_error(out_, code, text);
+        failed_ = true;
+        if (transaction_ == 'T') {
+            transaction_ = 'E';
+        }
+    }
+
+    void ready_for_query() {
+        put_message(out_, 'Z', [&] (std::string& out) { out.push_back(transaction_); });
+    }
+
+    /**
+     * Writes the replies, a round trip is delayed by the configured latency.
+     */
+    void flush(bool delay, asio::yield_context yield) {
+        if (out_.empty()) {
+            return;
+        }
+        if (delay && data_.latency != std::chrono::steady_clock::duration::zero()) {
+            timer_.expires_after(data_.latency);
+            timer_.async_wait(yield);
+        }
+        asio::async_write(socket_, asio::buffer(out_), yield);
+        out_.clear();
+    }
+
+    std::pair<char, message_reader> read_message(asio::yield_context yield) {
+        ensure(5, yield);
+        const auto type = in_[in_begin_];
+        const auto size = static_cast<std::size_t>(message_reader(in_.data() + in_begin_ + 1, 4).int32());
+        if (size < 4) {
+            throw std::runtime_error("malformed message length");
+        }
+        ensure(size + 1, yield);
+        const message_reader reader(in_.data() + in_begin_ + 5, size - 4);
+        in_begin_ += size + 1;
+        return {type, reader};
+    }
+
+    /**
+     * Reads until the buffer has `size` bytes unprocessed, the messages of the previous
+     * reads should have been handled since the buffer may be compacted.
+     */
+    void ensure(std::size_t size, asio::yield_context yield) {
+        while (in_end_ - in_begin_ < size) {
+            if (in_.size() - in_begin_ < size || in_end_ == in_.size()) {
+                std::copy(in_.begin() + static_cast<std::ptrdiff_t>(in_begin_),
+                    in_.begin() + static_cast<std::ptrdiff_t>(in_end_), in_.begin());
+                in_end_ -= in_begin_;
+                in_begin_ = 0;
+                if (in_.size() < size) {
+                    in_.resize(size);
+                }
+            }
+            in_end_ += socket_.async_read_some(asio::buffer(in_.data() + in_end_, in_.size() - in_end_), yield);
+        }
+    }
+
+    tcp::socket socket_;
+    server_data& data_;
+    asio::steady_timer timer_;
+    std::vector<char> in_;
+    std::size_t in_begin_ = 0;
+    std::size_t in_end_ = 0;
+    std::string out_;
+    std::unordered_map<std::string, statement> statements_;
+    std::unordered_map<std::string, portal> portals_;
+    char transaction_ = 'I';
+    bool failed_ = false;
+    bool copy_in_ = false;
+    bool copy_extended_ = false;
+    copy_counter copy_counter_;
+};
+
+void accept(tcp::acceptor& acceptor, server_data& data, asio::yield_context yield) {
+    for (;;) {
+        tcp::socket socket(acceptor.get_executor());
+        acceptor.async_accept(socket, yield);
+        socket.set_option(tcp::no_delay(true));
+        auto strand = asio::make_strand(acceptor.get_executor());
+        asio::spawn(strand, [socket = std::move(socket), &data] (asio::yield_context yield) mutable {
+            session s(std::move(socket), data);
+            try {
+                s.run(yield);
+            } catch (const boost::coroutines::detail::forced_unwind&) {
+                throw;
+            } catch (const boost::system::system_error& e) {
+                if (e.code() != asio::error::eof && e.code() != asio::error::connection_reset) {
+                    std::cerr << "session failed: " << e.what() << std::endl;
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "session failed: " << e.what() << std::endl;
+            }
+        });
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    namespace po = boost::program_options;
+
+    try {
+        po::options_description options;
+        options.add_options()
+            ("help,h", "print help message")
+            ("host", po::value<std::string>()->default_value("127.0.0.1"), "address to listen on")
+            ("port", po::value<unsigned short>()->default_value(5433), "port to listen on")
+            ("threads", po::value<std::size_t>()->default_value(1), "number of threads")
+            ("rows", po::value<std::size_t>()->default_value(100), "number of rows of the pg_type query result")
+            ("text_size", po::value<std::size_t>()->default_value(16), "size of the text values in bytes")
+            ("copy_rows", po::value<std::size_t>()->default_value(1000), "number of rows of COPY TO STDOUT")
+            ("latency", po::value<double>()->default_value(0), "delay of the replies of each round trip in milliseconds")
+        ;
+
+        po::variables_map variables;
+        po::store(po::parse_command_line(argc, argv, options), variables);
+        po::notify(variables);
+
+        if (variables.count("help")) {
+            std::cout << options << std::endl;
+            return 0;
+        }
+
+        server_params params;
+        params.host = variables.at("host").as<std::string>();
+        params.port = variables.at("port").as<unsigned short>();
+        params.threads = std::max<std::size_t>(variables.at("threads").as<std::size_t>(), 1);
+        params.rows = variables.at("rows").as<std::size_t>();
+        params.text_size = variables.at("text_size").as<std::size_t>();
+        params.copy_rows = variables.at("copy_rows").as<std::size_t>();
+        params.latency = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double, std::milli>(variables.at("latency").as<double>()));
+
+        server_data data {make_select_1(), make_pg_type(params), canned_copy(params), params.latency};
+
+        asio::io_context io(static_cast<int>(params.threads));
+        tcp::acceptor acceptor(io, tcp::endpoint(asio::ip::make_address(params.host), params.port));
+        asio::spawn(io, [&] (asio::yield_context yield) { accept(acceptor, data, yield); });
+
+        asio::signal_set signals(io, SIGINT, SIGTERM);
+        signals.async_wait([&] (boost::system::error_code, int) { io.stop(); });
+
+        std::cout << "listening on " << params.host << ':' << params.port << std::endl;
+
+        std::vector<std::thread> threads;
+        for (std::size_t i = 1; i < params.threads; ++i) {
+            threads.emplace_back([&] { io.run(); });
+        }
+        io.run();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return -1;
+    }
+}
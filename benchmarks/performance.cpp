@@ -2,6 +2,7 @@
 
 #include <ozo/connection_info.h>
 #include <ozo/connection_pool.h>
+#include <ozo/ext/std.h>
 #include <ozo/request.h>
 #include <ozo/query_builder.h>
 #include <ozo/shortcuts.h>
@@ -10,10 +11,22 @@
 
 #include <boost/asio/io_service.hpp>
 #include <boost/asio/spawn.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/program_options.hpp>
 
+#if defined(BOOST_ASIO_HAS_CO_AWAIT)
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#endif
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <condition_variable>
+#include <fstream>
 #include <thread>
 
 namespace {
@@ -43,6 +56,18 @@ void spawn(asio::io_context& io, std::size_t token, T&& coroutine) {
     });
 }
 
+/**
+ * Waits for the scheduled start of the next request of the token in the open-loop
+ * mode, does nothing in the closed-loop mode or if the schedule is already behind.
+ */
+void wait_request_start(const benchmark_t& benchmark, std::size_t token, asio::steady_timer& timer, asio::yield_context yield) {
+    const auto request_start = benchmark.get_request_start(token);
+    if (request_start && *request_start > std::chrono::steady_clock::now()) {
+        timer.expires_at(*request_start);
+        timer.async_wait(yield);
+    }
+}
+
 enum class query_type {
     simple,
     complex,
@@ -79,8 +104,10 @@ struct benchmark_params {
     std::size_t threads_number = 0;
     std::size_t queue_capacity = 0;
     std::size_t connections = 0;
+    std::size_t shards = 1;
     bool parse_result = false;
     bool verbose = false;
+    double rate = 0;
     ozo::time_traits::duration connect_timeout = std::chrono::seconds(1);
     ozo::time_traits::duration request_timeout = std::chrono::seconds(1);
     ozo::time_traits::duration idle_timeout = std::chrono::seconds(1);
@@ -96,7 +123,12 @@ struct benchmark_report {
     OZO_STD_OPTIONAL<std::size_t> threads_number;
     OZO_STD_OPTIONAL<std::size_t> queue_capacity;
     OZO_STD_OPTIONAL<std::size_t> connections;
+    OZO_STD_OPTIONAL<std::size_t> shards;
     OZO_STD_OPTIONAL<bool> parse_result;
+    OZO_STD_OPTIONAL<double> rate;
+    OZO_STD_OPTIONAL<std::size_t> result_bytes;
+    long max_rss_kb = 0;
+    std::chrono::steady_clock::duration cpu_time{};
 };
 
 std::ostream& operator <<(std::ostream& stream, const benchmark_report& value) {
@@ -114,9 +146,22 @@ std::ostream& operator <<(std::ostream& stream, const benchmark_report& value) {
     if (value.connections) {
         stream << "connections: " << *value.connections << '\n';
     }
+    if (value.shards) {
+        stream << "shards: " << *value.shards << '\n';
+    }
     if (value.parse_result) {
         stream << "parse_result: " << *value.parse_result << '\n';
     }
+    if (value.rate) {
+        stream << "rate: " << *value.rate << " req/sec" << '\n';
+    }
+    if (value.result_bytes) {
+        stream << "result_bytes: " << *value.result_bytes << " B" << '\n';
+        stream << "mean decode speed: " << value.stats.mean_read_rows_speed << " row/sec, "
+               << value.stats.mean_request_speed * static_cast<double>(*value.result_bytes) / 1e6 << " MB/sec" << '\n';
+    }
+    stream << "max_rss: " << value.max_rss_kb << " KB" << '\n';
+    stream << "cpu_time: " << std::chrono::duration<double>(value.cpu_time).count() << " s" << '\n';
     stream << value.stats << '\n';
     return stream;
 }
@@ -134,12 +179,18 @@ benchmark_report reopen_connection(const benchmark_params& params, Query query)
 
     benchmark_t benchmark(1, params.duration);
     benchmark.set_print_progress(params.verbose);
+    if (params.rate > 0) {
+        benchmark.set_request_rate(params.rate);
+        report.rate = params.rate;
+    }
 
     asio::io_context io(1);
     ozo::connection_info connection_info(params.conn_string);
 
     spawn(io, 0, [&] (asio::yield_context yield) {
+        asio::steady_timer timer(io);
         while (true) {
+            wait_request_start(benchmark, 0, timer, yield);
             std::conditional_t<parse_result, std::vector<Row>, ozo::result> result;
             ozo::error_code ec;
             const auto connection = ozo::request(connection_info[io], query, params.request_timeout, ozo::into(result), yield[ec]);
@@ -178,13 +229,19 @@ benchmark_report reuse_connection(const benchmark_params& params, Query query) {
 
     benchmark_t benchmark(1, params.duration);
     benchmark.set_print_progress(params.verbose);
+    if (params.rate > 0) {
+        benchmark.set_request_rate(params.rate);
+        report.rate = params.rate;
+    }
 
     asio::io_context io(1);
     ozo::connection_info connection_info(params.conn_string);
 
     spawn(io, 0, [&] (asio::yield_context yield) {
         auto connection = ozo::get_connection(connection_info[io], params.connect_timeout, yield);
+        asio::steady_timer timer(io);
         while (true) {
+            wait_request_start(benchmark, 0, timer, yield);
             std::conditional_t<parse_result, std::vector<Row>, ozo::result> result;
             ozo::error_code ec;
             connection = ozo::request(std::move(connection), query, params.request_timeout, ozo::into(result), yield[ec]);
@@ -225,6 +282,10 @@ benchmark_report use_connection_pool(const benchmark_params& params, Query query
 
     benchmark_t benchmark(params.coroutines, params.duration);
     benchmark.set_print_progress(params.verbose);
+    if (params.rate > 0) {
+        benchmark.set_request_rate(params.rate);
+        report.rate = params.rate;
+    }
 
     asio::io_context io(1);
     const ozo::connection_info connection_info(params.conn_string);
@@ -235,7 +296,9 @@ benchmark_report use_connection_pool(const benchmark_params& params, Query query
 
     for (std::size_t token = 0; token < params.coroutines; ++token) {
         spawn(io, token, [&, token] (asio::yield_context yield) {
+            asio::steady_timer timer(io);
             while (true) {
+                wait_request_start(benchmark, token, timer, yield);
                 std::conditional_t<parse_result, std::vector<Row>, ozo::result> result;
                 ozo::error_code ec;
                 const auto connection = ozo::request(pool[io], query, params.request_timeout, ozo::into(result), yield[ec]);
@@ -262,6 +325,87 @@ benchmark_report use_connection_pool(const benchmark_params& params, Query query
     return report;
 }
 
+#if defined(BOOST_ASIO_HAS_CO_AWAIT)
+
+/**
+ * Same as `wait_request_start()` for C++20 coroutines.
+ */
+asio::awaitable<void> async_wait_request_start(const benchmark_t& benchmark, std::size_t token, asio::steady_timer& timer) {
+    const auto request_start = benchmark.get_request_start(token);
+    if (request_start && *request_start > std::chrono::steady_clock::now()) {
+        timer.expires_at(*request_start);
+        co_await timer.async_wait(asio::use_awaitable);
+    }
+}
+
+/**
+ * Same as `use_connection_pool()` with C++20 coroutines instead of the stackful ones,
+ * so the memory and the CPU time may be compared for the same number of coroutines.
+ */
+template <typename Row, typename Query>
+benchmark_report use_connection_pool_awaitable(const benchmark_params& params, Query query) {
+    constexpr bool parse_result = !std::is_same_v<Row, void>;
+
+    assert(parse_result == params.parse_result);
+
+    benchmark_report report;
+    report.name = __func__;
+    report.query = ozo::to_const_char(ozo::get_text(query));
+    report.coroutines = params.coroutines;
+    report.queue_capacity = params.queue_capacity;
+    report.parse_result = parse_result;
+
+    benchmark_t benchmark(params.coroutines, params.duration);
+    benchmark.set_print_progress(params.verbose);
+    if (params.rate > 0) {
+        benchmark.set_request_rate(params.rate);
+        report.rate = params.rate;
+    }
+
+    asio::io_context io(1);
+    const ozo::connection_info connection_info(params.conn_string);
+    ozo::connection_pool_config config;
+    config.capacity = params.coroutines + 1;
+    config.queue_capacity = params.queue_capacity;
+    ozo::connection_pool pool(connection_info, config, !ozo::thread_safe);
+
+    const auto coroutine = [&] (std::size_t token) -> asio::awaitable<void> {
+        asio::steady_timer timer(io);
+        while (true) {
+            co_await async_wait_request_start(benchmark, token, timer);
+            std::conditional_t<parse_result, std::vector<Row>, ozo::result> result;
+            co_await ozo::request(pool[io], query, params.request_timeout, ozo::into(result), asio::use_awaitable);
+            if (!benchmark.step(result.size(), token)) {
+                break;
+            }
+        }
+    };
+
+    for (std::size_t token = 0; token < params.coroutines; ++token) {
+        asio::co_spawn(io, coroutine(token), [token] (std::exception_ptr e) {
+            if (!e) {
+                return;
+            }
+            try {
+                std::rethrow_exception(e);
+            } catch (const std::exception& e) {
+                const std::lock_guard lock(cerr_mutex);
+                std::cerr << "coroutine " << token << " failed: " << e.what() << std::endl;
+                std::abort();
+            }
+        });
+    }
+
+    io.run();
+
+    report.output = benchmark.get_output();
+    report.stats = benchmark.get_stats();
+
+    return report;
+}
+
+#endif
+
 struct context {
     asio::io_context io;
     boost::asio::executor_work_guard<boost::asio::io_context::executor_type> guard = boost::asio::make_work_guard(io);
@@ -283,15 +427,21 @@ benchmark_report use_connection_pool_mult_threads(const benchmark_params& params
     report.queue_capacity = params.queue_capacity;
     report.threads_number = params.threads_number;
     report.connections = params.connections;
+    report.shards = params.shards;
     report.parse_result = parse_result;
 
     benchmark_t benchmark(params.coroutines * params.threads_number, params.duration);
     benchmark.set_print_progress(params.verbose);
+    if (params.rate > 0) {
+        benchmark.set_request_rate(params.rate);
+        report.rate = params.rate;
+    }
 
     const ozo::connection_info connection_info(params.conn_string);
     ozo::connection_pool_config config;
     config.capacity = params.connections;
     config.queue_capacity = params.queue_capacity;
+    config.shards = params.shards;
     std::vector<std::unique_ptr<context>> contexts;
     ozo::connection_pool pool(connection_info, config);
     std::atomic_size_t finished_coroutines {0};
@@ -305,7 +455,9 @@ benchmark_report use_connection_pool_mult_threads(const benchmark_params& params
         for (std::size_t j = 0; j < params.coroutines; ++j) {
             const auto token = params.coroutines * i + j;
             spawn(io, token, [&, token] (asio::yield_context yield) {
+                asio::steady_timer timer(io);
                 while (true) {
+                    wait_request_start(benchmark, token, timer, yield);
                     std::conditional_t<parse_result, std::vector<Row>, ozo::result> result;
                     ozo::error_code ec;
                     {
@@ -345,6 +497,86 @@ benchmark_report use_connection_pool_mult_threads(const benchmark_params& params
     return report;
 }
 
+/**
+ * Measures the pool own cost: coroutines of all threads get connections from
+ * the shared pool and return them back without a request, so the connections are
+ * established only once and each step is a pure acquire and release.
+ */
+benchmark_report acquire_pooled_connection_mult_threads(const benchmark_params& params) {
+    benchmark_report report;
+    report.name = __func__;
+    report.coroutines = params.coroutines;
+    report.queue_capacity = params.queue_capacity;
+    report.threads_number = params.threads_number;
+    report.connections = params.connections;
+    report.shards = params.shards;
+
+    benchmark_t benchmark(params.coroutines * params.threads_number, params.duration);
+    benchmark.set_print_progress(params.verbose);
+    if (params.rate > 0) {
+        benchmark.set_request_rate(params.rate);
+        report.rate = params.rate;
+    }
+
+    const ozo::connection_info connection_info(params.conn_string);
+    ozo::connection_pool_config config;
+    config.capacity = params.connections;
+    config.queue_capacity = params.queue_capacity;
+    config.shards = params.shards;
+    std::vector<std::unique_ptr<context>> contexts;
+    ozo::connection_pool pool(connection_info, config);
+    std::atomic_size_t finished_coroutines {0};
+    std::mutex mutex;
+    std::unique_lock<std::mutex> lock(mutex);
+    std::condition_variable coroutine_finished;
+
+    for (std::size_t i = 0; i < params.threads_number; ++i) {
+        contexts.emplace_back(std::make_unique<context>());
+        auto& io = contexts.back()->io;
+        for (std::size_t j = 0; j < params.coroutines; ++j) {
+            const auto token = params.coroutines * i + j;
+            spawn(io, token, [&, token] (asio::yield_context yield) {
+                asio::steady_timer timer(io);
+                while (true) {
+                    wait_request_start(benchmark, token, timer, yield);
+                    ozo::error_code ec;
+                    {
+                        const auto connection = ozo::get_connection(pool[io], params.connect_timeout, yield[ec]);
+                        if (ec) {
+                            const std::lock_guard lock(cerr_mutex);
+                            std::cerr << "coroutine " << token << ": " << ec.message() << '\n';
+                            if (connection) {
+                                std::cerr << "coroutine " << token << ": " << ozo::get_error_context(connection) << '\n';
+                                std::cerr << "coroutine " << token << ": " << ozo::error_message(connection) << '\n';
+                            }
+                            std::abort();
+                        }
+                    }
+                    if (!benchmark.thread_safe_step(0, token)) {
+                        break;
+                    }
+                }
+                ++finished_coroutines;
+                coroutine_finished.notify_all();
+            });
+        }
+    }
+
+    if (params.coroutines * params.threads_number > 0) {
+        coroutine_finished.wait(lock, [&] {
+            return finished_coroutines >= params.coroutines * params.threads_number;
+        });
+    }
+
+    std::for_each(contexts.begin(), contexts.end(), [] (const auto& v) { v->guard.reset(); });
+    std::for_each(contexts.begin(), contexts.end(), [] (const auto& v) { v->thread.join(); });
+
+    report.output = benchmark.get_output();
+    report.stats = benchmark.get_stats();
+
+    return report;
+}
+
 template <typename Row, typename Query>
 benchmark_report run_benchmark(const std::string& name, const benchmark_params& params, Query query) {
     std::map<std::string, std::function<benchmark_report ()>> scenarios {{
@@ -388,6 +620,18 @@ benchmark_report run_benchmark(const std::string& name, const benchmark_params&
                 }
             }
         },
+#if defined(BOOST_ASIO_HAS_CO_AWAIT)
+        {
+            "use_connection_pool_awaitable",
+            [&] {
+                if (params.parse_result) {
+                    return use_connection_pool_awaitable<Row>(params, query);
+                } else {
+                    return use_connection_pool_awaitable<void>(params, query);
+                }
+            }
+        },
+#endif
     }};
 
     const auto scenario = scenarios.find(name);
@@ -399,9 +643,237 @@ benchmark_report run_benchmark(const std::string& name, const benchmark_params&
     return scenario->second();
 }
 
+std::chrono::steady_clock::duration to_duration(const timeval& value) {
+    return std::chrono::seconds(value.tv_sec) + std::chrono::microseconds(value.tv_usec);
+}
+
+/**
+ * Adds the peak memory and the CPU time of the process to the report, so the scenarios
+ * which differ in the coroutines kind only may be compared.
+ */
+benchmark_report& add_resource_usage(benchmark_report& report) {
+    rusage usage {};
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        report.max_rss_kb = usage.ru_maxrss;
+        report.cpu_time = to_duration(usage.ru_utime) + to_duration(usage.ru_stime);
+    }
+    return report;
+}
+
+enum class column_type {
+    int4,
+    text,
+    array,
+    jsonb,
+    composite,
+    mixed,
+};
+
+std::istream& operator >>(std::istream& stream, column_type& value) {
+    std::string token;
+    stream >> token;
+    if (token == "int4") {
+        value = column_type::int4;
+    } else if (token == "text") {
+        value = column_type::text;
+    } else if (token == "array") {
+        value = column_type::array;
+    } else if (token == "jsonb") {
+        value = column_type::jsonb;
+    } else if (token == "composite") {
+        value = column_type::composite;
+    } else if (token == "mixed") {
+        value = column_type::mixed;
+    } else {
+        throw std::invalid_argument("Invalid column type: \"" + token + "\"");
+    }
+    return stream;
+}
+
+/**
+ * Shape of the result of the decode_result_shape benchmark, the result is made by
+ * the server via generate_series(), so no tables are required.
+ */
+struct result_shape {
+    std::size_t rows = 0;
+    std::size_t columns = 0;
+    ::column_type column_type = ::column_type::int4;
+    std::size_t text_size = 0;
+};
+
+struct shape_sweep_params {
+    std::vector<std::size_t> rows;
+    std::vector<std::size_t> columns;
+    std::vector<column_type> column_types;
+    std::vector<std::size_t> text_sizes;
+};
+
+constexpr std::array<column_type, 5> mixed_column_types {{
+    column_type::int4, column_type::text, column_type::array, column_type::jsonb, column_type::composite
+}};
+
+constexpr column_type get_column_type(column_type type, std::size_t column) {
+    return type == column_type::mixed ? mixed_column_types[column % mixed_column_types.size()] : type;
+}
+
+template <column_type Type>
+struct column_value;
+
+template <>
+struct column_value<column_type::int4> { using type = std::int32_t; };
+
+template <>
+struct column_value<column_type::text> { using type = std::string; };
+
+template <>
+struct column_value<column_type::array> { using type = std::vector<std::int32_t>; };
+
+template <>
+struct column_value<column_type::jsonb> { using type = ozo::pg::jsonb; };
+
+// Anonymous composite made by ROW() is received as the record type
+template <>
+struct column_value<column_type::composite> { using type = std::tuple<std::int64_t, std::string, std::vector<std::int32_t>>; };
+
+template <column_type Type, std::size_t ...Columns>
+auto make_shape_row(std::index_sequence<Columns...>)
+    -> std::tuple<typename column_value<get_column_type(Type, Columns)>::type...>;
+
+template <column_type Type, std::size_t Columns>
+using shape_row = decltype(make_shape_row<Type>(std::make_index_sequence<Columns>{}));
+
+std::string make_column_expression(column_type type, std::size_t text_size) {
+    const auto text = "repeat('x', " + std::to_string(text_size) + ")";
+    switch (type) {
+        case column_type::int4:
+            return "i::int4";
+        case column_type::text:
+            return text;
+        case column_type::array:
+            return "array_fill(i::int4, ARRAY[16])";
+        case column_type::jsonb:
+            return "jsonb_build_object('id', i, 'name', " + text + ", 'values', array_fill(i, ARRAY[16]))";
+        case column_type::composite:
+            return "ROW(i::int8, " + text + ", array_fill(i::int4, ARRAY[16]))";
+        case column_type::mixed:
+            break;
+    }
+    throw std::invalid_argument("Invalid column type: \"" + std::to_string(static_cast<int>(type)) + "\"");
+}
+
+auto make_shape_query(const result_shape& shape) {
+    std::string text = "SELECT ";
+    for (std::size_t column = 0; column < shape.columns; ++column) {
+        if (column) {
+            text += ", ";
+        }
+        text += make_column_expression(get_column_type(shape.column_type, column), shape.text_size);
+    }
+    text += " FROM generate_series(1, " + std::to_string(shape.rows) + ") AS i";
+    return ozo::make_query(std::move(text));
+}
+
+/**
+ * Receives the result once without parsing to get its size, it is the same for
+ * every request of the shape, so the decode throughput in bytes is derived from
+ * the requests throughput.
+ */
+template <typename Query>
+std::size_t get_result_bytes(const benchmark_params& params, const Query& query) {
+    asio::io_context io(1);
+    ozo::connection_info connection_info(params.conn_string);
+    ozo::result result;
+    ozo::error_code ec;
+    ozo::request(connection_info[io], query, params.request_timeout, ozo::into(result),
+        [&] (ozo::error_code e, auto) { ec = e; });
+    io.run();
+    if (ec) {
+        throw std::runtime_error("Can't get result of query \"" + std::string(ozo::to_const_char(ozo::get_text(query)))
+            + "\": " + ec.message());
+    }
+    std::size_t bytes = 0;
+    for (const auto& row : result) {
+        for (const auto& value : row) {
+            bytes += value.size();
+        }
+    }
+    return bytes;
+}
+
+template <column_type Type>
+benchmark_report decode_result_shape(const benchmark_params& params, const result_shape& shape) {
+    const auto query = make_shape_query(shape);
+    const auto run = [&] (auto columns) -> benchmark_report {
+        using row_type = shape_row<Type, decltype(columns)::value>;
+        benchmark_report report;
+        if (params.parse_result) {
+            report = reuse_connection<row_type>(params, query);
+        } else {
+            report = reuse_connection<void>(params, query);
+        }
+        report.name = "decode_result_shape";
+        report.result_bytes = get_result_bytes(params, query);
+        return report;
+    };
+    switch (shape.columns) {
+        case 1: return run(std::integral_constant<std::size_t, 1>{});
+        case 2: return run(std::integral_constant<std::size_t, 2>{});
+        case 4: return run(std::integral_constant<std::size_t, 4>{});
+        case 8: return run(std::integral_constant<std::size_t, 8>{});
+        case 16: return run(std::integral_constant<std::size_t, 16>{});
+    }
+    throw std::invalid_argument("Invalid columns number: " + std::to_string(shape.columns) + ", should be 1, 2, 4, 8 or 16");
+}
+
+benchmark_report decode_result_shape(const benchmark_params& params, const result_shape& shape) {
+    switch (shape.column_type) {
+        case column_type::int4: return decode_result_shape<column_type::int4>(params, shape);
+        case column_type::text: return decode_result_shape<column_type::text>(params, shape);
+        case column_type::array: return decode_result_shape<column_type::array>(params, shape);
+        case column_type::jsonb: return decode_result_shape<column_type::jsonb>(params, shape);
+        case column_type::composite: return decode_result_shape<column_type::composite>(params, shape);
+        case column_type::mixed: return decode_result_shape<column_type::mixed>(params, shape);
+    }
+    throw std::invalid_argument("Invalid column type: \"" + std::to_string(static_cast<int>(shape.column_type)) + "\"");
+}
+
+/**
+ * Runs decode_result_shape benchmark for each combination of the shape parameters with
+ * and without parsing of the result, or only with the parsing if it is requested. The text
+ * size is swept only for the shapes which have text columns.
+ */
+std::vector<benchmark_report> sweep_result_shapes(const benchmark_params& params, const shape_sweep_params& sweep) {
+    std::vector<benchmark_report> reports;
+    std::chrono::steady_clock::duration cpu_time {};
+    const auto parse = params.parse_result ? std::vector<bool> {true} : std::vector<bool> {false, true};
+    for (const auto type : sweep.column_types) {
+        const auto text_sizes = type == column_type::int4 || type == column_type::array
+            ? std::vector<std::size_t> {sweep.text_sizes.front()} : sweep.text_sizes;
+        for (const auto text_size : text_sizes) {
+            for (const auto columns : sweep.columns) {
+                for (const auto rows : sweep.rows) {
+                    for (const auto parse_result : parse) {
+                        auto shape_params = params;
+                        shape_params.parse_result = parse_result;
+                        auto report = decode_result_shape(shape_params, result_shape {rows, columns, type, text_size});
+                        add_resource_usage(report);
+                        report.cpu_time -= std::exchange(cpu_time, report.cpu_time);
+                        reports.push_back(std::move(report));
+                    }
+                }
+            }
+        }
+    }
+    return reports;
+}
+
 benchmark_report run_benchmark(const std::string& name, const benchmark_params& params) {
     using namespace ozo::literals;
 
+    if (name == "acquire_pooled_connection_mult_threads") {
+        return acquire_pooled_connection_mult_threads(params);
+    }
+
     const auto simple_query = "SELECT 1"_SQL.build();
     const auto complex_query = (
         "SELECT typname, typnamespace, typowner, typlen, typbyval, typcategory, "_SQL +
@@ -480,6 +952,18 @@ struct adl_serializer<ozo::benchmark::stats> {
         if (value.max_request_time) {
             j["max_request_time"] = *value.max_request_time;
         }
+        if (value.p50_request_time) {
+            j["p50_request_time"] = *value.p50_request_time;
+        }
+        if (value.p90_request_time) {
+            j["p90_request_time"] = *value.p90_request_time;
+        }
+        if (value.p99_request_time) {
+            j["p99_request_time"] = *value.p99_request_time;
+        }
+        if (value.p999_request_time) {
+            j["p999_request_time"] = *value.p999_request_time;
+        }
         j["mean_request_speed"] = value.mean_request_speed;
         if (value.median_request_speed) {
             j["median_request_speed"] = *value.median_request_speed;
@@ -520,11 +1004,26 @@ struct adl_serializer<ozo::benchmark::step> {
     }
 };
 
+template <>
+struct adl_serializer<ozo::benchmark::latency_histogram> {
+    static void to_json(json& j, const ozo::benchmark::latency_histogram& value) {
+        j = json::array();
+        value.for_each_bucket([&] (auto request_time, auto count) {
+            j.push_back({{"request_time", request_time}, {"count", count}});
+        });
+    }
+
+    static void from_json(const json&, ozo::benchmark::latency_histogram&) {
+        throw std::logic_error("ozo::benchmark::latency_histogram serialization is not implemented");
+    }
+};
+
 template <>
 struct adl_serializer<ozo::benchmark::output> {
     static void to_json(json& j, const ozo::benchmark::output& value) {
         j["steps"] = value.steps;
         j["requests"] = value.requests;
+        j["histogram"] = value.histogram;
     }
 
     static void from_json(const json&, ozo::benchmark::output&) {
@@ -543,6 +1042,9 @@ struct adl_serializer<benchmark_report> {
         if (value.connections) {
             j["connections"] = *value.connections;
         }
+        if (value.shards) {
+            j["shards"] = *value.shards;
+        }
         if (value.queue_capacity) {
             j["queue_capacity"] = *value.queue_capacity;
         }
@@ -552,6 +1054,15 @@ struct adl_serializer<benchmark_report> {
         if (value.parse_result) {
             j["parse_result"] = *value.parse_result;
         }
+        if (value.rate) {
+            j["rate"] = *value.rate;
+        }
+        if (value.result_bytes) {
+            j["result_bytes"] = *value.result_bytes;
+            j["mean_decode_speed_mb"] = value.stats.mean_request_speed * static_cast<double>(*value.result_bytes) / 1e6;
+        }
+        j["max_rss_kb"] = value.max_rss_kb;
+        j["cpu_time"] = value.cpu_time;
         j["output"] = value.output;
         j["stats"] = value.stats;
     }
@@ -570,6 +1081,93 @@ ozo::time_traits::duration to_duration(const boost::program_options::variable_va
     return std::chrono::duration_cast<ozo::time_traits::duration>(double_seconds(value.as<double>()));
 }
 
+/**
+ * Reads reports from the file written with the json format, one report per line,
+ * so outputs of several runs may be concatenated into a single baseline file.
+ */
+std::vector<nlohmann::json> load_baseline(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::invalid_argument("Can't open baseline file: \"" + path + "\"");
+    }
+    std::vector<nlohmann::json> result;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty()) {
+            result.push_back(nlohmann::json::parse(line));
+        }
+    }
+    return result;
+}
+
+/**
+ * Finds the baseline report of the same scenario run with the same parameters.
+ */
+const nlohmann::json* find_baseline(const std::vector<nlohmann::json>& baseline, const nlohmann::json& report) {
+    constexpr std::array<const char*, 9> keys {{
+        "name", "query", "coroutines", "threads_number", "queue_capacity",
+        "connections", "shards", "parse_result", "rate"
+    }};
+    const auto same = [&] (const nlohmann::json& v) {
+        return std::all_of(keys.begin(), keys.end(), [&] (const char* key) {
+            const auto lhs = v.find(key);
+            const auto rhs = report.find(key);
+            return (lhs == v.end()) == (rhs == report.end()) && (lhs == v.end() || *lhs == *rhs);
+        });
+    };
+    const auto it = std::find_if(baseline.begin(), baseline.end(), same);
+    return it == baseline.end() ? nullptr : std::addressof(*it);
+}
+
+struct metric_delta {
+    std::string metric;
+    double baseline;
+    double current;
+    double delta; // relative change in percents, positive is better
+    bool regression;
+};
+
+/**
+ * Compares throughput and request time percentiles of the report with the baseline.
+ * A metric is a regression if it became worse by more than `threshold` percents.
+ */
+std::vector<metric_delta> compare_with_baseline(const nlohmann::json& baseline, const nlohmann::json& report, double threshold) {
+    constexpr std::array<std::pair<const char*, bool>, 5> metrics {{
+        {"mean_request_speed", true},
+        {"p50_request_time", false},
+        {"p90_request_time", false},
+        {"p99_request_time", false},
+        {"p999_request_time", false},
+    }};
+    std::vector<metric_delta> result;
+    const auto& baseline_stats = baseline.at("stats");
+    const auto& stats = report.at("stats");
+    for (const auto& [metric, higher_is_better] : metrics) {
+        if (!baseline_stats.contains(metric) || !stats.contains(metric)) {
+            continue;
+        }
+        const auto before = baseline_stats.at(metric).get<double>();
+        const auto after = stats.at(metric).get<double>();
+        if (before == 0) {
+            continue;
+        }
+        const auto delta = (higher_is_better ? after - before : before - after) / before * 100;
+        result.push_back(metric_delta {metric, before, after, delta, delta < -threshold});
+    }
+    return result;
+}
+
+std::ostream& operator <<(std::ostream& stream, const std::vector<metric_delta>& value) {
+    stream << "baseline comparison:" << '\n';
+    for (const auto& v : value) {
+        stream << v.metric << ": " << v.baseline << " -> " << v.current << " ("
+               << std::showpos << std::setprecision(2) << std::fixed << v.delta << std::noshowpos
+               << std::defaultfloat << std::setprecision(6) << "%)"
+               << (v.regression ? " REGRESSION" : "") << '\n';
+    }
+    return stream;
+}
+
 }
 
 int main(int argc, char **argv) {
@@ -589,14 +1187,29 @@ int main(int argc, char **argv) {
             ("queue", po::value<std::size_t>()->default_value(0), "connection pool queue capacity")
             ("threads", po::value<std::size_t>()->default_value(1), "number of threads")
             ("connections", po::value<std::size_t>(), "number of parallel coroutines (default: equal to coroutines + 1)")
+            ("shards", po::value<std::size_t>()->default_value(1), "number of connection pool shards for multithreaded benchmarks")
             ("parse,p", "parse query result")
             ("verbose,v", "use verbose output")
+            ("rate", po::value<double>()->default_value(0), "open-loop mode total requests rate in req/sec (0 for closed-loop mode)")
             ("duration,d", po::value<double>()->default_value(31), "benchmark duration in seconds")
             ("format,f", po::value<format>()->default_value(format::text), "benchmark report format (text, json)")
             ("connect_timeout", po::value<double>()->default_value(1), "connect timeout in seconds")
             ("request_timeout", po::value<double>()->default_value(1), "request timeout in seconds")
             ("idle_timeout", po::value<double>()->default_value(1), "pooled connection idle timeout in seconds")
             ("lifespan", po::value<double>()->default_value(1), "pooled connection lifespan in seconds")
+            ("baseline", po::value<std::string>(), "json report of a previous run to compare the result with")
+            ("threshold", po::value<double>()->default_value(5), "max allowed regression against the baseline in percents")
+            ("rows", po::value<std::vector<std::size_t>>()->multitoken()->default_value({1, 100, 10000}, "1 100 10000"),
+                "numbers of result rows for decode_result_shape benchmark")
+            ("columns", po::value<std::vector<std::size_t>>()->multitoken()->default_value({1, 4, 16}, "1 4 16"),
+                "numbers of result columns for decode_result_shape benchmark (1, 2, 4, 8 or 16)")
+            ("column_type", po::value<std::vector<column_type>>()->multitoken()->default_value(
+                    {column_type::int4, column_type::text, column_type::array, column_type::jsonb, column_type::composite,
+                        column_type::mixed},
+                    "int4 text array jsonb composite mixed"),
+                "result column types for decode_result_shape benchmark (int4, text, array, jsonb, composite, mixed)")
+            ("text_size", po::value<std::vector<std::size_t>>()->multitoken()->default_value({16, 1024}, "16 1024"),
+                "sizes of the text values for decode_result_shape benchmark")
         ;
 
         po::variables_map variables;
@@ -626,23 +1239,67 @@ int main(int argc, char **argv) {
         } else {
             params.connections = params.coroutines;
         }
+        params.shards = variables.at("shards").as<std::size_t>();
         params.parse_result = variables.count("parse") > 0;
         params.verbose = variables.count("verbose") > 0;
+        params.rate = variables.at("rate").as<double>();
         params.duration = to_duration(variables.at("duration"));
         params.connect_timeout = to_duration(variables.at("connect_timeout"));
         params.request_timeout = to_duration(variables.at("request_timeout"));
         params.idle_timeout = to_duration(variables.at("idle_timeout"));
         params.lifespan = to_duration(variables.at("lifespan"));
 
-        const auto report = run_benchmark(name, params);
+        std::vector<benchmark_report> reports;
+        if (name == "decode_result_shape") {
+            shape_sweep_params sweep;
+            sweep.rows = variables.at("rows").as<std::vector<std::size_t>>();
+            sweep.columns = variables.at("columns").as<std::vector<std::size_t>>();
+            sweep.column_types = variables.at("column_type").as<std::vector<column_type>>();
+            sweep.text_sizes = variables.at("text_size").as<std::vector<std::size_t>>();
+            reports = sweep_result_shapes(params, sweep);
+        } else {
+            reports.push_back(run_benchmark(name, params));
+            add_resource_usage(reports.back());
+        }
 
-        switch (variables.at("format").as<format>()) {
-            case format::text:
-                std::cout << report << std::endl;
-                break;
-            case format::json:
-                std::cout << nlohmann::json(report) << std::endl;
-                break;
+        const auto baseline = variables.count("baseline")
+            ? load_baseline(variables.at("baseline").as<std::string>()) : std::vector<nlohmann::json> {};
+        bool regression = false;
+
+        for (const auto& report : reports) {
+            const nlohmann::json report_json(report);
+
+            OZO_STD_OPTIONAL<std::vector<metric_delta>> comparison;
+            if (variables.count("baseline")) {
+                if (const auto baseline_report = find_baseline(baseline, report_json)) {
+                    comparison = compare_with_baseline(*baseline_report, report_json, variables.at("threshold").as<double>());
+                } else {
+                    std::cerr << "no baseline found for benchmark " << report.name << std::endl;
+                }
+            }
+
+            switch (variables.at("format").as<format>()) {
+                case format::text:
+                    std::cout << report << std::endl;
+                    if (comparison) {
+                        std::cout << *comparison << std::endl;
+                    }
+                    break;
+                case format::json:
+                    std::cout << report_json << std::endl;
+                    if (comparison) {
+                        std::cerr << *comparison << std::endl;
+                    }
+                    break;
+            }
+
+            if (comparison && std::any_of(comparison->begin(), comparison->end(), [] (const auto& v) { return v.regression; })) {
+                regression = true;
+            }
+        }
+
+        if (regression) {
+            return 1;
         }
 
         return 0;
@@ -0,0 +1,108 @@
+#include <ozo/query_conf.h>
+
+#include <benchmark/benchmark.h>
+
+#include <boost/hana/string.hpp>
+#include <boost/hana/tuple.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <tuple>
+#include <utility>
+
+namespace {
+
+namespace hana = boost::hana;
+
+constexpr std::size_t declared_queries_count = 128;
+
+template <std::size_t I>
+struct benchmark_query {
+    using name_type = hana::string<'q', char('0' + I / 100 % 10), char('0' + I / 10 % 10), char('0' + I % 10)>;
+    using parameters_type = std::tuple<std::int64_t, std::string>;
+};
+
+template <std::size_t ... I>
+auto make_declared_queries(std::index_sequence<I ...>) {
+    return hana::tuple<benchmark_query<I> ...>();
+}
+
+const auto declared_queries = make_declared_queries(std::make_index_sequence<declared_queries_count>());
+
+/**
+ * Query conf of `count` queries named like `benchmark_query` of about 1.5 KB each,
+ * i.e. 2000 queries make a 3 MB file.
+ */
+std::string make_query_conf(std::size_t count) {
+    std::string result;
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto name = std::to_string(i);
+        result += "-- name: q" + std::string(3 - std::min<std::size_t>(3, name.size()), '0') + name + "\n";
+        for (std::size_t line = 0; line < 20; ++line) {
+            result += "SELECT id, name, value::text FROM benchmark_table WHERE id = :0 AND name = :1\n";
+        }
+    }
+    return result;
+}
+
+struct query_conf_file {
+    std::filesystem::path path;
+
+    explicit query_conf_file(const std::string& content)
+            : path(std::filesystem::temp_directory_path() / "ozo_benchmark_query_conf.sql") {
+        std::ofstream(path, std::ios::binary) << content;
+    }
+
+    ~query_conf_file() {
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+};
+
+void parse_query_conf(benchmark::State& state) {
+    const auto conf = make_query_conf(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        auto parsed = ozo::detail::parse_query_conf(conf);
+        benchmark::DoNotOptimize(parsed.data());
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * conf.size()));
+}
+
+void make_query_repository_from_string(benchmark::State& state) {
+    const auto conf = make_query_conf(declared_queries_count);
+    for (auto _ : state) {
+        auto repository = ozo::make_query_repository(conf, declared_queries);
+        benchmark::DoNotOptimize(repository);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * conf.size()));
+}
+
+void make_query_repository_from_file(benchmark::State& state) {
+    const auto conf = make_query_conf(declared_queries_count);
+    const query_conf_file file(conf);
+    for (auto _ : state) {
+        auto repository = ozo::make_query_repository(file.path, declared_queries);
+        benchmark::DoNotOptimize(repository);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * conf.size()));
+}
+
+void make_query_descriptions(benchmark::State& state) {
+    const auto parsed = ozo::detail::parse_query_conf(make_query_conf(declared_queries_count));
+    for (auto _ : state) {
+        auto descriptions = ozo::detail::make_query_descriptions(declared_queries, parsed);
+        benchmark::DoNotOptimize(descriptions.data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * parsed.size()));
+}
+
+BENCHMARK(parse_query_conf)->Arg(128)->Arg(2000)->Unit(benchmark::kMillisecond);
+BENCHMARK(make_query_repository_from_string)->Unit(benchmark::kMillisecond);
+BENCHMARK(make_query_repository_from_file)->Unit(benchmark::kMillisecond);
+BENCHMARK(make_query_descriptions)->Unit(benchmark::kMicrosecond);
+
+} // namespace
+
+BENCHMARK_MAIN();
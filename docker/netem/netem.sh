@@ -0,0 +1,24 @@
+#!/bin/bash -e
+
+# Shapes the egress traffic of the network namespace the container shares, e.g. the one of
+# the postgres server, so every round trip between the benchmark and the server is delayed
+# by OZO_NETEM_DELAY and the results are limited by OZO_NETEM_RATE.
+
+DEVICE=${OZO_NETEM_DEVICE:-eth0}
+DELAY=${OZO_NETEM_DELAY:-1ms}
+JITTER=${OZO_NETEM_JITTER:-0ms}
+RATE=${OZO_NETEM_RATE:-}
+
+ARGS="delay ${DELAY} ${JITTER}"
+if [[ "${RATE}" ]]; then
+    ARGS="${ARGS} rate ${RATE}"
+fi
+
+tc qdisc del dev ${DEVICE} root 2>/dev/null || true
+tc qdisc add dev ${DEVICE} root netem ${ARGS}
+tc qdisc show dev ${DEVICE}
+
+trap "tc qdisc del dev ${DEVICE} root; exit 0" TERM INT
+
+sleep infinity &
+wait
@@ -36,6 +36,10 @@ int main(int argc, char **argv) {
     connection_pool_config.idle_timeout = std::chrono::seconds(60);
     // Maximum time duration to keep connection open
     connection_pool_config.lifespan = std::chrono::hours(24);
+    // Number of independent sub-pools, use one per io_context run by a separate thread
+    connection_pool_config.shards = 1;
+    // Number of connections to open in advance via connection_pool.warm_up()
+    connection_pool_config.min_idle = 1;
 
     // Creating connection pool from connection_info as the underlying ConnectionSource
     ozo::connection_pool connection_pool(connection_info, connection_pool_config);
@@ -54,6 +58,14 @@ int main(int argc, char **argv) {
         const auto connector = connection_pool[io];
         //! [Creating Connection Provider]
 
+        // Open min_idle connections before taking traffic, so the first requests do not wait
+        // for connection establishing.
+        boost::system::error_code warm_up_ec;
+        connection_pool.warm_up(io, std::chrono::seconds(1), yield[warm_up_ec]);
+        if (warm_up_ec) {
+            std::cout << "Pool warm up failed with error: " << warm_up_ec.message() << std::endl;
+        }
+
         // Request result is always set of rows. Client should take care of output object lifetime.
         ozo::rows_of<int> result;
 
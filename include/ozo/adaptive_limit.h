@@ -0,0 +1,285 @@
+#pragma once
+
+#include <ozo/connector.h>
+#include <ozo/connection.h>
+#include <ozo/error.h>
+#include <ozo/time_traits.h>
+#include <ozo/asio.h>
+#include <ozo/detail/bind.h>
+
+#include <boost/asio/post.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace ozo {
+
+/**
+ * @brief Adaptive concurrency limit configuration
+ * @ingroup group-connection-types
+ *
+ * Settings of the AIMD (additive increase, multiplicative decrease) algorithm of
+ * `ozo::adaptive_limit_connection_source`.
+ */
+struct adaptive_limit_config {
+    std::size_t initial_limit = 20; //!< limit of concurrent requests at start
+    std::size_t min_limit = 1; //!< the limit is never decreased below this value
+    std::size_t max_limit = 200; //!< the limit is never increased above this value
+    time_traits::duration latency_threshold = std::chrono::milliseconds(100); //!< request latency above which the limit is decreased
+    double backoff_ratio = 0.9; //!< multiplier of the limit on the decrease
+};
+
+/**
+ * @brief Adaptive concurrency limit metrics
+ * @ingroup group-connection-types
+ *
+ * Snapshot of the `ozo::adaptive_limit_connection_source` state returned by
+ * `adaptive_limit_connection_source::metrics()`.
+ */
+struct adaptive_limit_metrics {
+    std::size_t limit = 0; //!< current limit of concurrent requests
+    std::size_t in_flight = 0; //!< number of requests holding or waiting for a connection
+    std::uint64_t rejected = 0; //!< number of requests completed with `ozo::error::concurrency_limit_exceeded`
+};
+
+namespace detail {
+
+/**
+ * Limit of concurrent requests adjusted by their latency. A request with the latency
+ * below the threshold increases the limit by `1 / limit`, so the limit grows by one per
+ * limit of such requests, but only while the limit is at least half used. A slower
+ * request decreases the limit by the backoff ratio, at most once per threshold interval,
+ * so the requests started before the decrease do not collapse the limit.
+ */
+class adaptive_limit_state {
+public:
+    explicit adaptive_limit_state(const adaptive_limit_config& config)
+    : config_(config),
+      limit_(static_cast<double>(std::clamp(config.initial_limit, std::max<std::size_t>(config.min_limit, 1),
+        std::max(config.max_limit, std::max<std::size_t>(config.min_limit, 1))))) {
+        config_.min_limit = std::max<std::size_t>(config_.min_limit, 1);
+        config_.max_limit = std::max(config_.max_limit, config_.min_limit);
+    }
+
+    bool try_acquire() {
+        const std::lock_guard lock(mutex_);
+        if (in_flight_ >= current_limit()) {
+            ++rejected_;
+            return false;
+        }
+        ++in_flight_;
+        return true;
+    }
+
+    void release(time_traits::duration latency) {
+        const std::lock_guard lock(mutex_);
+        if (latency > config_.latency_threshold) {
+            const auto now = time_traits::now();
+            if (now >= next_decrease_) {
+                limit_ = std::max(static_cast<double>(config_.min_limit), limit_ * config_.backoff_ratio);
+                next_decrease_ = now + config_.latency_threshold;
+            }
+        } else if (2 * in_flight_ >= current_limit()) {
+            limit_ = std::min(static_cast<double>(config_.max_limit), limit_ + 1 / limit_);
+        }
+        --in_flight_;
+    }
+
+    adaptive_limit_metrics metrics() const {
+        const std::lock_guard lock(mutex_);
+        return {current_limit(), in_flight_, rejected_};
+    }
+
+private:
+    std::size_t current_limit() const noexcept { return static_cast<std::size_t>(limit_);}
+
+    mutable std::mutex mutex_;
+    adaptive_limit_config config_;
+    double limit_;
+    std::size_t in_flight_ = 0;
+    std::uint64_t rejected_ = 0;
+    time_traits::time_point next_decrease_ = {};
+};
+
+/**
+ * Admission of a request, returned to the limit with the request latency on destruction.
+ */
+struct adaptive_limit_token {
+    std::shared_ptr<adaptive_limit_state> state_;
+    time_traits::time_point start_;
+
+    adaptive_limit_token(std::shared_ptr<adaptive_limit_state> state, time_traits::time_point start)
+    : state_(std::move(state)), start_(start) {}
+
+    adaptive_limit_token(adaptive_limit_token&&) = default;
+    adaptive_limit_token& operator= (adaptive_limit_token&&) = delete;
+
+    ~adaptive_limit_token() {
+        if (state_) {
+            state_->release(time_traits::now() - start_);
+        }
+    }
+};
+
+/**
+ * Makes the connection own the admission, so it is returned when the last copy of the
+ * connection is destroyed. The aliasing constructor keeps the connection type intact.
+ */
+template <typename T>
+std::shared_ptr<T> attach_adaptive_limit_token(std::shared_ptr<T> conn, adaptive_limit_token token) {
+    struct holder {
+        adaptive_limit_token token;
+        std::shared_ptr<T> conn;
+    };
+    auto h = std::make_shared<holder>(holder{std::move(token), std::move(conn)});
+    auto ptr = h->conn.get();
+    return std::shared_ptr<T>(std::move(h), ptr);
+}
+
+template <typename Handler>
+struct adaptive_limit_handler {
+    Handler handler_;
+    std::shared_ptr<adaptive_limit_token> token_;
+
+    template <typename Connection>
+    void operator() (error_code ec, Connection&& conn) {
+        if (conn) {
+            auto limited = attach_adaptive_limit_token(std::forward<Connection>(conn), std::move(*token_));
+            return handler_(std::move(ec), std::move(limited));
+        }
+        token_.reset();
+        handler_(std::move(ec), std::forward<Connection>(conn));
+    }
+
+    using executor_type = std::decay_t<decltype(asio::get_associated_executor(handler_))>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(handler_);
+    }
+
+    using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(handler_))>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(handler_);
+    }
+};
+
+template <typename T>
+struct is_shared_ptr : std::false_type {};
+
+template <typename T>
+struct is_shared_ptr<std::shared_ptr<T>> : std::true_type {};
+
+} // namespace detail
+
+/**
+ * @brief Connection source with the adaptive limit of concurrent requests
+ *
+ * A static pool capacity is either too low when the database is fast or too high when
+ * it degrades, so the requests pile up and the latency collapses. The source limits the
+ * number of concurrent requests to the underlying source, e.g. `ozo::connection_pool`,
+ * and adjusts the limit by the requests latency with the AIMD algorithm, see
+ * `ozo::adaptive_limit_config`. A request is counted from the connection request until
+ * the last copy of the connection is destroyed, so the latency includes the queries made.
+ * A request beyond the limit is completed with `ozo::error::concurrency_limit_exceeded`
+ * immediately, so the load is shed instead of being queued.
+ *
+ * The limit is shared by the copies of the source, so the source may be used by many
+ * threads simultaneously.
+ *
+ * @tparam Source --- type of the underlying `ConnectionSource`, its connection type
+ *                    should be `std::shared_ptr`; may be a reference type, e.g. for a pool.
+ * @ingroup group-connection-types
+ * @models{ConnectionSource}
+ */
+template <typename Source>
+class adaptive_limit_connection_source {
+    static_assert(ConnectionSource<Source>, "Source should model ConnectionSource concept");
+
+    Source source_;
+    std::shared_ptr<detail::adaptive_limit_state> state_;
+
+public:
+    /**
+     * `Connection` implementation type according to `ConnectionSource` requirements.
+     */
+    using connection_type = typename connection_source_traits<Source>::connection_type;
+
+    static_assert(detail::is_shared_ptr<connection_type>::value,
+        "connection type of the Source should be std::shared_ptr");
+
+    /**
+     * @brief Construct a new adaptive limit connection source object
+     *
+     * @param source --- underlying connection source.
+     * @param config --- limit configuration.
+     */
+    adaptive_limit_connection_source(Source source, const adaptive_limit_config& config = {})
+    : source_(std::forward<Source>(source)), state_(std::make_shared<detail::adaptive_limit_state>(config)) {}
+
+    /**
+     * @brief Provides a connection from the underlying source if the limit is not reached
+     *
+     * @param io --- `io_context` for the connection IO.
+     * @param t --- #TimeConstraint for the operation.
+     * @param handler --- #Handler.
+     */
+    template <typename TimeConstraint, typename Handler>
+    void operator ()(io_context& io, TimeConstraint t, Handler&& handler) const {
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        if (!state_->try_acquire()) {
+            return asio::post(io.get_executor(), detail::bind(std::forward<Handler>(handler),
+                error_code{error::concurrency_limit_exceeded}, connection_type{}));
+        }
+        source_(io, std::move(t), detail::adaptive_limit_handler<std::decay_t<Handler>>{
+            std::forward<Handler>(handler),
+            std::make_shared<detail::adaptive_limit_token>(state_, time_traits::now())
+        });
+    }
+
+    /**
+     * Get snapshot of the limit state.
+     *
+     * @return adaptive_limit_metrics --- current limit and counters.
+     */
+    adaptive_limit_metrics metrics() const { return state_->metrics();}
+
+    auto operator [](io_context& io) const & {
+        return connection_provider(*this, io);
+    }
+
+    auto operator [](io_context& io) && {
+        return connection_provider(std::move(*this), io);
+    }
+};
+
+/**
+ * @brief Creates connection source with the adaptive limit of concurrent requests
+ *
+ * ###Example
+ *
+@code
+auto pool = ozo::make_connection_pool(ozo::connection_info(conn_str), pool_config);
+ozo::adaptive_limit_config config;
+config.latency_threshold = 50ms;
+auto source = ozo::make_adaptive_limit_connection_source(pool, config);
+ozo::request(source[io], query, 1s, out, yield[ec]);
+if (ec == ozo::error::concurrency_limit_exceeded) {
+    // the request is shed
+}
+@endcode
+ *
+ * @param source --- underlying connection source; an lvalue is referenced, so it should outlive
+ *                 the result, an rvalue is moved into the result.
+ * @param config --- limit configuration.
+ * @return `ozo::adaptive_limit_connection_source` object.
+ * @ingroup group-connection-functions
+ */
+template <typename Source>
+auto make_adaptive_limit_connection_source(Source&& source, const adaptive_limit_config& config = {}) {
+    return adaptive_limit_connection_source<Source>{std::forward<Source>(source), config};
+}
+
+} // namespace ozo
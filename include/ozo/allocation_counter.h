@@ -0,0 +1,250 @@
+#pragma once
+
+#include <ozo/asio.h>
+
+#include <boost/asio/associated_allocator.hpp>
+#include <boost/asio/associated_executor.hpp>
+#include <boost/asio/async_result.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @defgroup group-allocation-counter Allocation counter
+ * @ingroup group-core
+ * @brief Instrumentation which counts the allocations made on a request path.
+ *
+ * The library allocates the operations state via the allocator associated with the
+ * completion handler, see @ref group-arena. The `ozo::bind_allocation_counter()` wraps
+ * that allocator of a completion token into `ozo::counting_allocator`, so the allocations
+ * of the operation are counted by an `ozo::allocation_counter` object. It is meant for
+ * benchmarks and tests which keep the request path allocation-free.
+ *
+ *@code
+#include <ozo/allocation_counter.h>
+ *@endcode
+ */
+
+namespace ozo {
+
+/**
+ * @brief Counters of the allocations made via `ozo::counting_allocator`
+ *
+ * The counters are atomic, so the object may be shared by the operations running
+ * on different threads.
+ *
+ * @ingroup group-allocation-counter
+ */
+class allocation_counter {
+public:
+    allocation_counter() = default;
+    allocation_counter(const allocation_counter&) = delete;
+    allocation_counter& operator =(const allocation_counter&) = delete;
+
+    /**
+     * Number of the allocations.
+     */
+    std::size_t allocations() const noexcept { return allocations_.load(std::memory_order_relaxed);}
+
+    /**
+     * Number of the deallocations.
+     */
+    std::size_t deallocations() const noexcept { return deallocations_.load(std::memory_order_relaxed);}
+
+    /**
+     * Number of bytes allocated.
+     */
+    std::size_t bytes() const noexcept { return bytes_.load(std::memory_order_relaxed);}
+
+    /**
+     * Resets all the counters to zero.
+     */
+    void reset() noexcept {
+        allocations_.store(0, std::memory_order_relaxed);
+        deallocations_.store(0, std::memory_order_relaxed);
+        bytes_.store(0, std::memory_order_relaxed);
+    }
+
+    void on_allocate(std::size_t bytes) noexcept {
+        allocations_.fetch_add(1, std::memory_order_relaxed);
+        bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    void on_deallocate() noexcept {
+        deallocations_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<std::size_t> allocations_ {0};
+    std::atomic<std::size_t> deallocations_ {0};
+    std::atomic<std::size_t> bytes_ {0};
+};
+
+/**
+ * @brief Allocator which counts the allocations of an underlying allocator
+ *
+ * @tparam T --- type of objects to allocate.
+ * @tparam Allocator --- underlying allocator type, e.g. the allocator associated with a handler.
+ * @ingroup group-allocation-counter
+ */
+template <typename T, typename Allocator = std::allocator<T>>
+class counting_allocator {
+    using traits = typename std::allocator_traits<Allocator>::template rebind_traits<T>;
+
+public:
+    using value_type = T;
+    using underlying_allocator_type = typename traits::allocator_type;
+
+    template <typename U>
+    struct rebind {
+        using other = counting_allocator<U, Allocator>;
+    };
+
+    counting_allocator(allocation_counter& counter, const Allocator& allocator = Allocator{}) noexcept
+    : counter_(std::addressof(counter)), allocator_(allocator) {}
+
+    template <typename U, typename OtherAllocator>
+    counting_allocator(const counting_allocator<U, OtherAllocator>& other) noexcept
+    : counter_(other.get_counter()), allocator_(other.get_underlying_allocator()) {}
+
+    T* allocate(std::size_t n) {
+        auto result = traits::allocate(allocator_, n);
+        counter_->on_allocate(n * sizeof(T));
+        return result;
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        counter_->on_deallocate();
+        traits::deallocate(allocator_, p, n);
+    }
+
+    allocation_counter* get_counter() const noexcept { return counter_;}
+
+    const underlying_allocator_type& get_underlying_allocator() const noexcept { return allocator_;}
+
+    template <typename U, typename OtherAllocator>
+    friend bool operator ==(const counting_allocator& lhs, const counting_allocator<U, OtherAllocator>& rhs) noexcept {
+        return lhs.get_counter() == rhs.get_counter()
+            && lhs.get_underlying_allocator() == typename traits::allocator_type(rhs.get_underlying_allocator());
+    }
+
+    template <typename U, typename OtherAllocator>
+    friend bool operator !=(const counting_allocator& lhs, const counting_allocator<U, OtherAllocator>& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+private:
+    allocation_counter* counter_;
+    underlying_allocator_type allocator_;
+};
+
+/**
+ * @brief Completion token with the bound allocation counter
+ *
+ * Use `ozo::bind_allocation_counter()` to make an object of the type.
+ *
+ * @tparam Token --- underlying completion token type.
+ * @ingroup group-allocation-counter
+ */
+template <typename Token>
+struct counting_token {
+    Token token_;
+    allocation_counter* counter_;
+};
+
+/**
+ * @brief Completion handler with the associated counting allocator
+ *
+ * Forwards the calls and the associated executor of the underlying handler and
+ * provides `ozo::counting_allocator` over its associated allocator as the associated
+ * allocator.
+ *
+ * @tparam Handler --- underlying completion handler type.
+ * @ingroup group-allocation-counter
+ */
+template <typename Handler>
+struct counting_handler {
+    Handler handler_;
+    allocation_counter* counter_;
+
+    counting_handler(Handler handler, allocation_counter& counter)
+    : handler_(std::move(handler)), counter_(std::addressof(counter)) {}
+
+    template <typename Token>
+    counting_handler(counting_token<Token>&& token)
+    : handler_(std::move(token.token_)), counter_(token.counter_) {}
+
+    template <typename Token>
+    counting_handler(counting_token<Token>& token)
+    : handler_(token.token_), counter_(token.counter_) {}
+
+    template <typename ...Args>
+    void operator() (Args&& ...args) {
+        handler_(std::forward<Args>(args)...);
+    }
+
+    using executor_type = asio::associated_executor_t<Handler>;
+
+    executor_type get_executor() const noexcept { return asio::get_associated_executor(handler_);}
+
+    using allocator_type = counting_allocator<char, asio::associated_allocator_t<Handler>>;
+
+    allocator_type get_allocator() const noexcept {
+        return allocator_type{*counter_, asio::get_associated_allocator(handler_)};
+    }
+};
+
+/**
+ * @brief Binds allocation counter to a completion token
+ *
+ * All the allocations which the library makes for the operation initiated with
+ * the returned token via the associated allocator are counted by the counter. The
+ * allocations are made with the allocator associated with the token, e.g. it may be
+ * a token with the bound arena, see `ozo::bind_arena()`. Note that the operation slab
+ * of `ozo::connection` is used with the default allocator only, so the counted operations
+ * allocate their state on the heap.
+ *
+ * @param counter --- counter of the allocations, should outlive the operation.
+ * @param token --- completion token, e.g. a callback, `boost::asio::yield_context`
+ *                  or `boost::asio::use_future`.
+ * @return `ozo::counting_token` --- completion token with the bound counter.
+ *
+ * ###Example
+ *
+ * @code
+ozo::allocation_counter counter;
+ozo::rows_of<std::int32_t> rows;
+ozo::request(conn, "SELECT 1"_SQL, ozo::into(rows), ozo::bind_allocation_counter(counter, yield));
+std::cout << counter.allocations() << " allocations, " << counter.bytes() << " bytes" << std::endl;
+ * @endcode
+ * @ingroup group-allocation-counter
+ */
+template <typename Token>
+inline auto bind_allocation_counter(allocation_counter& counter, Token&& token) {
+    return counting_token<std::decay_t<Token>>{std::forward<Token>(token), std::addressof(counter)};
+}
+
+} // namespace ozo
+
+namespace boost::asio {
+
+template <typename Token, typename Signature>
+class async_result<ozo::counting_token<Token>, Signature> {
+    using target_type = async_result<Token, Signature>;
+
+public:
+    using completion_handler_type = ozo::counting_handler<typename target_type::completion_handler_type>;
+    using return_type = typename target_type::return_type;
+
+    explicit async_result(completion_handler_type& h) : target_(h.handler_) {}
+
+    return_type get() { return target_.get();}
+
+private:
+    target_type target_;
+};
+
+} // namespace boost::asio
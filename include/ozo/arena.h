@@ -0,0 +1,299 @@
+#pragma once
+
+#include <ozo/asio.h>
+
+#include <boost/asio/associated_allocator.hpp>
+#include <boost/asio/associated_executor.hpp>
+#include <boost/asio/async_result.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @defgroup group-arena Request arena
+ * @ingroup group-core
+ * @brief Monotonic arena allocator for the allocations made on a request path.
+ *
+ * The library allocates the operations state via the allocator associated with the
+ * completion handler (see `asio::get_associated_allocator()`): request operation contexts,
+ * binary queries, deadline handlers, pooled connection wrappers, failover contexts and
+ * so on. The `ozo::bind_arena()` binds the `ozo::arena_allocator` of an `ozo::arena` object
+ * to a completion token, so all these allocations of the request are made from the arena
+ * and are freed at once with the `ozo::arena::release()` or the arena destruction after the
+ * request is completed.
+ *
+ *@code
+#include <ozo/arena.h>
+ *@endcode
+ */
+
+namespace ozo {
+
+/**
+ * @brief Monotonic memory arena
+ *
+ * The arena allocates memory by bumping a pointer within the current block and never
+ * frees the memory separately, all the memory is freed at once by `release()` or by
+ * the destructor. The first block may be provided by a user, e.g. a stack buffer, the
+ * next ones are allocated on the heap with the doubling size.
+ *
+ * The arena is not thread-safe. It is supposed to be used by a single request which
+ * operations are executed sequentially.
+ *
+ * @ingroup group-arena
+ */
+class arena {
+public:
+    /**
+     * Default size of the first heap block.
+     */
+    static constexpr std::size_t default_block_size = 4096;
+
+    /**
+     * Construct a new arena object without the initial buffer.
+     *
+     * @param block_size --- size of the first heap block.
+     */
+    explicit arena(std::size_t block_size = default_block_size) noexcept
+    : next_block_size_(std::max<std::size_t>(block_size, sizeof(block) * 2)) {}
+
+    /**
+     * Construct a new arena object with the initial buffer.
+     *
+     * @param buffer --- initial buffer, should outlive the arena.
+     * @param size --- size of the initial buffer.
+     * @param block_size --- size of the first heap block.
+     */
+    arena(void* buffer, std::size_t size, std::size_t block_size = default_block_size) noexcept
+    : initial_(static_cast<char*>(buffer)), initial_size_(size),
+      pos_(initial_), end_(initial_ + size),
+      next_block_size_(std::max<std::size_t>(block_size, sizeof(block) * 2)) {}
+
+    arena(const arena&) = delete;
+    arena& operator =(const arena&) = delete;
+
+    ~arena() { free_blocks(); }
+
+    /**
+     * Allocates memory of the given size and alignment.
+     *
+     * @param size --- size of memory in bytes.
+     * @param alignment --- alignment of memory, should be a power of two.
+     * @return pointer to the allocated memory.
+     * @throws std::bad_alloc if the memory can not be allocated.
+     */
+    void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t)) {
+        if (auto result = bump(size, alignment)) {
+            return result;
+        }
+        add_block(size + alignment);
+        return bump(size, alignment);
+    }
+
+    /**
+     * Frees all the memory allocated by the arena. All the objects allocated in
+     * the arena should be destroyed before. The initial buffer is reused by the
+     * next allocations.
+     */
+    void release() noexcept {
+        free_blocks();
+        pos_ = initial_;
+        end_ = initial_ + initial_size_;
+        allocated_ = 0;
+    }
+
+    /**
+     * Number of bytes allocated since the construction or the last `release()`.
+     */
+    std::size_t allocated() const noexcept { return allocated_;}
+
+private:
+    struct block {
+        block* next;
+    };
+
+    void* bump(std::size_t size, std::size_t alignment) noexcept {
+        void* result = pos_;
+        std::size_t space = static_cast<std::size_t>(end_ - pos_);
+        if (!pos_ || !std::align(alignment, size, result, space)) {
+            return nullptr;
+        }
+        pos_ = static_cast<char*>(result) + size;
+        allocated_ += size;
+        return result;
+    }
+
+    void add_block(std::size_t min_size) {
+        const auto size = std::max(next_block_size_, min_size + sizeof(block));
+        auto memory = static_cast<char*>(::operator new(size));
+        blocks_ = new (memory) block{blocks_};
+        pos_ = memory + sizeof(block);
+        end_ = memory + size;
+        next_block_size_ = size > std::numeric_limits<std::size_t>::max() / 2 ? size : size * 2;
+    }
+
+    void free_blocks() noexcept {
+        while (blocks_) {
+            ::operator delete(static_cast<void*>(std::exchange(blocks_, blocks_->next)));
+        }
+    }
+
+    char* initial_ = nullptr;
+    std::size_t initial_size_ = 0;
+    char* pos_ = nullptr;
+    char* end_ = nullptr;
+    block* blocks_ = nullptr;
+    std::size_t next_block_size_ = default_block_size;
+    std::size_t allocated_ = 0;
+};
+
+/**
+ * @brief Allocator which allocates memory from `ozo::arena`
+ *
+ * Deallocation does nothing, the memory is freed with the arena.
+ *
+ * @tparam T --- type of objects to allocate.
+ * @ingroup group-arena
+ */
+template <typename T>
+class arena_allocator {
+public:
+    using value_type = T;
+
+    explicit arena_allocator(arena& a) noexcept : arena_(std::addressof(a)) {}
+
+    template <typename U>
+    arena_allocator(const arena_allocator<U>& other) noexcept : arena_(other.get_arena()) {}
+
+    T* allocate(std::size_t n) {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, std::size_t) noexcept {}
+
+    arena* get_arena() const noexcept { return arena_;}
+
+    template <typename U>
+    friend bool operator ==(const arena_allocator& lhs, const arena_allocator<U>& rhs) noexcept {
+        return lhs.get_arena() == rhs.get_arena();
+    }
+
+    template <typename U>
+    friend bool operator !=(const arena_allocator& lhs, const arena_allocator<U>& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+private:
+    arena* arena_;
+};
+
+/**
+ * @brief Completion token with the bound arena
+ *
+ * Use `ozo::bind_arena()` to make an object of the type.
+ *
+ * @tparam Token --- underlying completion token type.
+ * @ingroup group-arena
+ */
+template <typename Token>
+struct arena_token {
+    Token token_;
+    arena* arena_;
+};
+
+/**
+ * @brief Completion handler with the associated arena allocator
+ *
+ * Forwards the calls and the associated executor of the underlying handler and
+ * provides `ozo::arena_allocator` as the associated allocator.
+ *
+ * @tparam Handler --- underlying completion handler type.
+ * @ingroup group-arena
+ */
+template <typename Handler>
+struct arena_handler {
+    Handler handler_;
+    arena* arena_;
+
+    arena_handler(Handler handler, arena& a)
+    : handler_(std::move(handler)), arena_(std::addressof(a)) {}
+
+    template <typename Token>
+    arena_handler(arena_token<Token>&& token)
+    : handler_(std::move(token.token_)), arena_(token.arena_) {}
+
+    template <typename Token>
+    arena_handler(arena_token<Token>& token)
+    : handler_(token.token_), arena_(token.arena_) {}
+
+    template <typename ...Args>
+    void operator() (Args&& ...args) {
+        handler_(std::forward<Args>(args)...);
+    }
+
+    using executor_type = asio::associated_executor_t<Handler>;
+
+    executor_type get_executor() const noexcept { return asio::get_associated_executor(handler_);}
+
+    using allocator_type = arena_allocator<char>;
+
+    allocator_type get_allocator() const noexcept { return allocator_type{*arena_};}
+};
+
+/**
+ * @brief Binds arena to a completion token
+ *
+ * All the allocations which the library makes for the operation initiated with
+ * the returned token are made from the arena. So the arena should outlive the
+ * operation and every object allocated for it, including the connection object
+ * passed to the completion handler.
+ *
+ * @param a --- arena for the allocations.
+ * @param token --- completion token, e.g. a callback, `boost::asio::yield_context`
+ *                  or `boost::asio::use_future`.
+ * @return `ozo::arena_token` --- completion token with the bound arena.
+ *
+ * ###Example
+ *
+ * @code
+std::array<char, 4096> buffer;
+ozo::arena arena(buffer.data(), buffer.size());
+ozo::rows_of<std::int64_t> rows;
+ozo::request(conn_info[io], "SELECT 1"_SQL, ozo::into(rows), ozo::bind_arena(arena, yield));
+ * @endcode
+ * @ingroup group-arena
+ */
+template <typename Token>
+inline auto bind_arena(arena& a, Token&& token) {
+    return arena_token<std::decay_t<Token>>{std::forward<Token>(token), std::addressof(a)};
+}
+
+} // namespace ozo
+
+namespace boost::asio {
+
+template <typename Token, typename Signature>
+class async_result<ozo::arena_token<Token>, Signature> {
+    using target_type = async_result<Token, Signature>;
+
+public:
+    using completion_handler_type = ozo::arena_handler<typename target_type::completion_handler_type>;
+    using return_type = typename target_type::return_type;
+
+    explicit async_result(completion_handler_type& h) : target_(h.handler_) {}
+
+    return_type get() { return target_.get();}
+
+private:
+    target_type target_;
+};
+
+} // namespace boost::asio
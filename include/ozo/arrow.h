@@ -0,0 +1,393 @@
+#pragma once
+
+#include <ozo/error.h>
+#include <ozo/result.h>
+#include <ozo/detail/endian.h>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @defgroup group-arrow Apache Arrow export
+ * @ingroup group-core
+ * @brief Conversion of the results into Apache Arrow record batches.
+ *
+ * The results are exported via the Arrow C data interface, so the module depends neither
+ * on the Arrow library nor on its version. A batch is imported by the consumer, e.g. with
+ * `arrow::ImportRecordBatch(&array, &schema)` in C++ or `pyarrow.RecordBatch._import_from_c()`.
+ * Each chunk of `ozo::stream_request()` is a separate result, so a streamed result is exported
+ * chunk by chunk into a batch each.
+ *
+ *@code
+#include <ozo/arrow.h>
+ *@endcode
+ */
+
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+    const char* format;
+    const char* name;
+    const char* metadata;
+    int64_t flags;
+    int64_t n_children;
+    struct ArrowSchema** children;
+    struct ArrowSchema* dictionary;
+    void (*release)(struct ArrowSchema*);
+    void* private_data;
+};
+
+struct ArrowArray {
+    int64_t length;
+    int64_t null_count;
+    int64_t offset;
+    int64_t n_buffers;
+    int64_t n_children;
+    const void** buffers;
+    struct ArrowArray** children;
+    struct ArrowArray* dictionary;
+    void (*release)(struct ArrowArray*);
+    void* private_data;
+};
+
+#endif // ARROW_C_DATA_INTERFACE
+
+namespace ozo::arrow {
+
+namespace detail {
+
+// Offsets of the PostgreSQL epoch 2000-01-01 from the Unix epoch
+constexpr std::int64_t pg_epoch_days = 10957;
+constexpr std::int64_t pg_epoch_microseconds = pg_epoch_days * 86400 * 1000000;
+
+enum class column_kind {
+    boolean,
+    fixed,
+    timestamp,
+    date,
+    variable,
+};
+
+struct column_type {
+    const char* format;
+    column_kind kind;
+    std::size_t width;
+};
+
+/**
+ * Arrow type of a column by its oid, the values of an unknown type are exported
+ * as the binary data of their PostgreSQL binary representation.
+ */
+inline column_type get_column_type(oid_t oid) noexcept {
+    switch (oid) {
+        case 16: return {"b", column_kind::boolean, 1};
+        case 21: return {"s", column_kind::fixed, 2};
+        case 23: return {"i", column_kind::fixed, 4};
+        case 20: return {"l", column_kind::fixed, 8};
+        case 26: return {"I", column_kind::fixed, 4};
+        case 700: return {"f", column_kind::fixed, 4};
+        case 701: return {"g", column_kind::fixed, 8};
+        case 1114: return {"tsu:", column_kind::timestamp, 8};
+        case 1184: return {"tsu:UTC", column_kind::timestamp, 8};
+        case 1082: return {"tdD", column_kind::date, 4};
+        case 2950: return {"w:16", column_kind::fixed, 16};
+        case 18:
+        case 19:
+        case 25:
+        case 114:
+        case 1042:
+        case 1043: return {"u", column_kind::variable, 0};
+        default: break;
+    }
+    return {"z", column_kind::variable, 0};
+}
+
+/**
+ * Converts the big endian values of a contiguous buffer into the native byte order
+ * in place. The loop over the contiguous buffer is vectorized by the compiler.
+ */
+template <typename T>
+inline void convert_from_big_endian(char* data, std::size_t count) noexcept {
+    for (std::size_t i = 0; i < count; ++i) {
+        T v;
+        std::memcpy(&v, data + i * sizeof(T), sizeof(T));
+        v = ozo::detail::convert_from_big_endian(v);
+        std::memcpy(data + i * sizeof(T), &v, sizeof(T));
+    }
+}
+
+struct column_buffers {
+    std::vector<std::uint8_t> validity;
+    std::vector<std::int32_t> offsets;
+    std::vector<char> values;
+    const void* buffers[3] = {nullptr, nullptr, nullptr};
+};
+
+struct column_schema {
+    std::string format;
+    std::string name;
+};
+
+struct batch_schema {
+    std::vector<ArrowSchema> children;
+    std::vector<ArrowSchema*> pointers;
+};
+
+struct batch_buffers {
+    std::vector<ArrowArray> children;
+    std::vector<ArrowArray*> pointers;
+    const void* buffers[1] = {nullptr};
+};
+
+inline void release_column_schema(ArrowSchema* schema) noexcept {
+    delete static_cast<column_schema*>(schema->private_data);
+    schema->release = nullptr;
+}
+
+inline void release_column_array(ArrowArray* array) noexcept {
+    delete static_cast<column_buffers*>(array->private_data);
+    array->release = nullptr;
+}
+
+inline void release_batch_schema(ArrowSchema* schema) noexcept {
+    const auto data = static_cast<batch_schema*>(schema->private_data);
+    for (auto& child : data->children) {
+        if (child.release) {
+            child.release(&child);
+        }
+    }
+    delete data;
+    schema->release = nullptr;
+}
+
+inline void release_batch_array(ArrowArray* array) noexcept {
+    const auto data = static_cast<batch_buffers*>(array->private_data);
+    for (auto& child : data->children) {
+        if (child.release) {
+            child.release(&child);
+        }
+    }
+    delete data;
+    array->release = nullptr;
+}
+
+template <typename T>
+inline std::int64_t export_column(const basic_result<T>& res, int column, const column_type& type,
+        column_buffers& out) {
+    const auto rows = static_cast<int>(res.size());
+    out.validity.assign((static_cast<std::size_t>(rows) + 7) / 8, 0);
+    std::int64_t null_count = 0;
+    const bool binary = impl::field_format(*res.native_handle(), column) == impl::result_format::binary;
+
+    if (type.kind == column_kind::variable) {
+        out.offsets.resize(static_cast<std::size_t>(rows) + 1);
+        out.offsets[0] = 0;
+    } else if (!binary) {
+        throw system_error(error::bad_result_process, "column " + std::to_string(column)
+            + " of the fixed width type should be in the binary format to be exported to Arrow");
+    } else if (type.kind == column_kind::boolean) {
+        out.values.assign((static_cast<std::size_t>(rows) + 7) / 8, 0);
+    } else {
+        out.values.assign(static_cast<std::size_t>(rows) * type.width, 0);
+    }
+
+    for (int row = 0; row < rows; ++row) {
+        const auto v = res[row][column];
+        const auto i = static_cast<std::size_t>(row);
+        if (v.is_null()) {
+            ++null_count;
+            if (type.kind == column_kind::variable) {
+                out.offsets[i + 1] = out.offsets[i];
+            }
+            continue;
+        }
+        out.validity[i / 8] |= std::uint8_t(1u << (i % 8));
+        const auto size = static_cast<std::size_t>(v.size());
+        if (type.kind == column_kind::variable) {
+            out.values.insert(out.values.end(), v.data(), v.data() + size);
+            out.offsets[i + 1] = static_cast<std::int32_t>(out.values.size());
+            continue;
+        }
+        if (size != type.width) {
+            throw system_error(error::bad_object_size, "data size " + std::to_string(size)
+                + " of column " + std::to_string(column) + " does not match type size " + std::to_string(type.width));
+        }
+        if (type.kind == column_kind::boolean) {
+            if (*v.data()) {
+                out.values[i / 8] |= std::uint8_t(1u << (i % 8));
+            }
+        } else {
+            std::memcpy(out.values.data() + i * type.width, v.data(), type.width);
+        }
+    }
+
+    const auto count = static_cast<std::size_t>(rows);
+    switch (type.kind) {
+        case column_kind::fixed:
+            if (type.width == 2) {
+                convert_from_big_endian<std::int16_t>(out.values.data(), count);
+            } else if (type.width == 4) {
+                convert_from_big_endian<std::int32_t>(out.values.data(), count);
+            } else if (type.width == 8) {
+                convert_from_big_endian<std::int64_t>(out.values.data(), count);
+            }
+            break;
+        case column_kind::timestamp:
+            convert_from_big_endian<std::int64_t>(out.values.data(), count);
+            for (std::size_t i = 0; i < count; ++i) {
+                std::int64_t v;
+                std::memcpy(&v, out.values.data() + i * 8, 8);
+                v += pg_epoch_microseconds;
+                std::memcpy(out.values.data() + i * 8, &v, 8);
+            }
+            break;
+        case column_kind::date:
+            convert_from_big_endian<std::int32_t>(out.values.data(), count);
+            for (std::size_t i = 0; i < count; ++i) {
+                std::int32_t v;
+                std::memcpy(&v, out.values.data() + i * 4, 4);
+                v += static_cast<std::int32_t>(pg_epoch_days);
+                std::memcpy(out.values.data() + i * 4, &v, 4);
+            }
+            break;
+        case column_kind::boolean:
+        case column_kind::variable:
+            break;
+    }
+
+    out.buffers[0] = null_count ? out.validity.data() : nullptr;
+    if (type.kind == column_kind::variable) {
+        out.buffers[1] = out.offsets.data();
+        out.buffers[2] = out.values.data();
+    } else {
+        out.buffers[1] = out.values.data();
+    }
+    return null_count;
+}
+
+} // namespace detail
+
+/**
+ * @brief Export a result as an Arrow record batch via the C data interface
+ *
+ * The batch is a struct array with a child array for each column of the result named by the
+ * column. The Arrow types are mapped from the columns oids:
+ *
+ * | PostgreSQL | Arrow |
+ * |---|---|
+ * | `bool` | boolean |
+ * | `int2`, `int4`, `int8`, `oid` | int16, int32, int64, uint32 |
+ * | `float4`, `float8` | float32, float64 |
+ * | `timestamp`, `timestamptz` | timestamp in microseconds, without and with UTC zone |
+ * | `date` | date32 |
+ * | `uuid` | fixed size binary of 16 bytes |
+ * | `text`, `varchar`, `bpchar`, `name`, `char`, `json` | utf8 |
+ * | other types | binary of the PostgreSQL binary representation |
+ *
+ * The fixed width values are copied into the contiguous Arrow buffer as they are and the
+ * byte order of the whole buffer is converted in a single vectorizable pass. The values of
+ * a libpq result are not contiguous, so the variable length values are copied into the
+ * values buffer once; no intermediate row objects are created. The fixed width columns
+ * should be received in the binary format, which is the format of the library requests.
+ *
+ * The exported structures own their memory and are released by their `release` callbacks,
+ * normally by the consumer which has imported them. The result may be destroyed right after the call.
+ *
+ * @param res --- result to export.
+ * @param schema --- uninitialized schema to export the batch type into.
+ * @param array --- uninitialized array to export the batch data into.
+ * @throws ozo::system_error with `ozo::error::bad_result_process` if a fixed width column is in the text format,
+ *         with `ozo::error::bad_object_size` if a fixed width value has unexpected size.
+ * @ingroup group-arrow
+ *
+ * ###Example
+ *
+ * @code
+ozo::result res;
+ozo::request(conn_info[io], "SELECT id, name, created FROM users"_SQL, ozo::into(res), yield);
+ArrowSchema schema;
+ArrowArray array;
+ozo::arrow::export_result(res, &schema, &array);
+auto batch = arrow::ImportRecordBatch(&array, &schema).ValueOrDie();
+ * @endcode
+ */
+template <typename T>
+inline void export_result(const basic_result<T>& res, ArrowSchema* schema, ArrowArray* array) {
+    const auto columns = static_cast<std::size_t>(impl::nfields(*res.native_handle()));
+    auto schema_data = std::make_unique<detail::batch_schema>();
+    auto array_data = std::make_unique<detail::batch_buffers>();
+    schema_data->children.resize(columns, ArrowSchema{});
+    array_data->children.resize(columns, ArrowArray{});
+
+    try {
+        for (std::size_t i = 0; i < columns; ++i) {
+            const auto column = static_cast<int>(i);
+            const auto type = detail::get_column_type(impl::field_type(*res.native_handle(), column));
+
+            const char* name = impl::field_name(*res.native_handle(), column);
+            auto column_schema = new detail::column_schema{type.format, name ? name : ""};
+            auto& s = schema_data->children[i];
+            s.format = column_schema->format.c_str();
+            s.name = column_schema->name.c_str();
+            s.flags = ARROW_FLAG_NULLABLE;
+            s.release = &detail::release_column_schema;
+            s.private_data = column_schema;
+
+            auto buffers = new detail::column_buffers;
+            auto& a = array_data->children[i];
+            a.release = &detail::release_column_array;
+            a.private_data = buffers;
+            a.length = static_cast<std::int64_t>(res.size());
+            a.n_buffers = type.kind == detail::column_kind::variable ? 3 : 2;
+            a.null_count = detail::export_column(res, column, type, *buffers);
+            a.buffers = buffers->buffers;
+        }
+    } catch (...) {
+        for (auto& s : schema_data->children) {
+            if (s.release) {
+                s.release(&s);
+            }
+        }
+        for (auto& a : array_data->children) {
+            if (a.release) {
+                a.release(&a);
+            }
+        }
+        throw;
+    }
+
+    for (auto& s : schema_data->children) {
+        schema_data->pointers.push_back(&s);
+    }
+    for (auto& a : array_data->children) {
+        array_data->pointers.push_back(&a);
+    }
+
+    *schema = ArrowSchema{};
+    schema->format = "+s";
+    schema->name = "";
+    schema->n_children = static_cast<std::int64_t>(columns);
+    schema->children = schema_data->pointers.data();
+    schema->release = &detail::release_batch_schema;
+    schema->private_data = schema_data.release();
+
+    *array = ArrowArray{};
+    array->length = static_cast<std::int64_t>(res.size());
+    array->n_buffers = 1;
+    array->n_children = static_cast<std::int64_t>(columns);
+    array->buffers = array_data->buffers;
+    array->children = array_data->pointers.data();
+    array->release = &detail::release_batch_array;
+    array->private_data = array_data.release();
+}
+
+} // namespace ozo::arrow
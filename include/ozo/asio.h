@@ -6,6 +6,8 @@
 #include <boost/asio/steady_timer.hpp>
 #include <boost/asio/posix/stream_descriptor.hpp>
 
+#include <ozo/detail/timer_wheel.h>
+
 namespace ozo {
 
 namespace asio = boost::asio;
@@ -56,35 +58,32 @@ struct operation_timer {
         "No operation_timer<> specialization found for specified type");
 };
 
-#if BOOST_VERSION < 107000
 template <>
 struct operation_timer<asio::io_context::executor_type> {
-    using type = asio::steady_timer;
+    using type = io_operation_timer;
 
     template <typename TimeConstraint>
     static type get(const asio::io_context::executor_type& ex, TimeConstraint t) {
-        return type{ex.context(), t};
+        if (auto wheel = find_timer_wheel(ex.context())) {
+            return type{wheel_timer{*wheel, ozo::deadline(t)}};
+        }
+        return type{make_steady_timer(ex, t)};
     }
 
     static type get(const asio::io_context::executor_type& ex) {
-        return type{ex.context()};
-    }
-};
-#else
-template <>
-struct operation_timer<asio::io_context::executor_type> {
-    using type = asio::steady_timer;
-
-    template <typename TimeConstraint>
-    static type get(const asio::io_context::executor_type& ex, TimeConstraint t) {
-        return type{ex, t};
+        return type{make_steady_timer(ex)};
     }
 
-    static type get(const asio::io_context::executor_type& ex) {
-        return type{ex};
+private:
+    template <typename ...Ts>
+    static asio::steady_timer make_steady_timer(const asio::io_context::executor_type& ex, Ts ...vs) {
+#if BOOST_VERSION < 107000
+        return asio::steady_timer{ex.context(), vs...};
+#else
+        return asio::steady_timer{ex, vs...};
+#endif
     }
 };
-#endif
 
 template <typename Executior, typename TimeConstraint>
 inline auto get_operation_timer(const Executior& ex, TimeConstraint t) {
@@ -97,6 +96,14 @@ inline auto get_operation_timer(const Executor& ex) {
 }
 
 
+/**
+* Customization point for the stream which waits for the connection socket readiness,
+* the waits are made with `async_read_some()` and `async_write_some()` of `asio::null_buffers`.
+* `ozo::connection` and `ozo::pooled_connection` both make their streams via it. For
+* `io_context` the stream is `asio::posix::stream_descriptor`, its waits are made by the
+* `io_context` backend, so with `BOOST_ASIO_HAS_IO_URING_AS_DEFAULT` (Boost 1.78 or newer
+* built with liburing) they are io_uring poll operations instead of epoll registrations.
+*/
 template <typename ExecutionContext>
 struct connection_stream {
     static_assert(std::is_same_v<ExecutionContext, connection_stream>,
@@ -0,0 +1,272 @@
+#pragma once
+
+#include <ozo/request.h>
+#include <ozo/query.h>
+#include <ozo/shortcuts.h>
+#include <ozo/detail/bind.h>
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace ozo {
+
+/**
+ * @brief Batch loader configuration
+ * @ingroup group-requests-types
+ */
+struct batch_loader_config {
+    std::size_t max_keys = 1000; //!< number of distinct keys which are loaded at once
+    time_traits::duration max_delay = time_traits::duration::zero(); //!< time a key waits for the rest of keys of its batch at most, zero means until the next turn of the event loop
+    time_traits::duration timeout = std::chrono::seconds(10); //!< time constraint of a batch query including getting the connection
+};
+
+namespace detail {
+
+template <typename Row>
+struct batch_loader_waiter {
+    virtual void complete(error_code ec, std::optional<Row> row) = 0;
+    virtual ~batch_loader_waiter() = default;
+};
+
+template <typename Row, typename Handler, typename Executor>
+struct batch_loader_waiter_impl : batch_loader_waiter<Row> {
+    Handler handler_;
+    Executor executor_;
+
+    batch_loader_waiter_impl(Handler handler, const Executor& ex)
+    : handler_(std::move(handler)), executor_(ex) {}
+
+    void complete(error_code ec, std::optional<Row> row) override {
+        auto ex = asio::get_associated_executor(handler_, executor_);
+        asio::post(ex, detail::bind(std::move(handler_), std::move(ec), std::move(row)));
+    }
+};
+
+/**
+* Distinct keys of a batch in the order of their first load and the waiters of each key.
+* The rows are demultiplexed by the first column, which is the key.
+*/
+template <typename Key, typename Row>
+struct batch_loader_batch {
+    using waiter_ptr = std::unique_ptr<batch_loader_waiter<Row>>;
+
+    std::vector<Key> keys;
+    std::unordered_map<Key, std::vector<waiter_ptr>> waiters;
+
+    std::size_t size() const noexcept { return keys.size();}
+
+    void append(Key key, waiter_ptr waiter) {
+        auto [it, inserted] = waiters.try_emplace(key);
+        it->second.push_back(std::move(waiter));
+        if (inserted) {
+            keys.push_back(std::move(key));
+        }
+    }
+
+    void complete(error_code ec) {
+        for (auto& [key, key_waiters] : waiters) {
+            for (auto& waiter : key_waiters) {
+                waiter->complete(ec, std::nullopt);
+            }
+        }
+        waiters.clear();
+    }
+
+    void complete(std::vector<Row>& rows) {
+        for (auto& row : rows) {
+            const auto it = waiters.find(std::get<0>(row));
+            if (it == waiters.end()) {
+                continue;
+            }
+            auto key_waiters = std::move(it->second);
+            waiters.erase(it);
+            for (std::size_t i = 0; i + 1 < key_waiters.size(); ++i) {
+                key_waiters[i]->complete(error_code{}, row);
+            }
+            key_waiters.back()->complete(error_code{}, std::move(row));
+        }
+        complete(error_code{});
+    }
+};
+
+/**
+* Shared state of `ozo::batch_loader`. The batch which is filled is loaded when it
+* reaches the maximum number of keys or when the delay of its first key expires.
+* The delay of a batch is not cancelled, it is ignored if the batch has been loaded
+* already.
+*/
+template <typename Source, typename Key, typename Row>
+class batch_loader_state : public std::enable_shared_from_this<batch_loader_state<Source, Key, Row>> {
+public:
+    using batch_type = batch_loader_batch<Key, Row>;
+    using waiter_ptr = typename batch_type::waiter_ptr;
+
+    batch_loader_state(Source source, io_context& io, std::string text, const batch_loader_config& config)
+    : source_(std::forward<Source>(source)), io_(io), text_(std::move(text)), config_(config) {}
+
+    io_context& get_io_context() const noexcept { return io_;}
+
+    void load(Key key, waiter_ptr waiter) {
+        std::unique_lock lock(mutex_);
+        current_.append(std::move(key), std::move(waiter));
+        if (current_.size() >= config_.max_keys) {
+            auto batch = take();
+            lock.unlock();
+            return flush(std::move(batch));
+        }
+        if (!scheduled_) {
+            scheduled_ = true;
+            const auto generation = generation_;
+            lock.unlock();
+            schedule(generation);
+        }
+    }
+
+private:
+    batch_type take() {
+        ++generation_;
+        scheduled_ = false;
+        return std::exchange(current_, batch_type{});
+    }
+
+    void schedule(std::uint64_t generation) {
+        auto self = this->shared_from_this();
+        if (config_.max_delay == time_traits::duration::zero()) {
+            return asio::post(io_, [self, generation] { self->on_delay(generation);});
+        }
+        auto timer = std::make_shared<asio::steady_timer>(io_, config_.max_delay);
+        timer->async_wait([self, timer, generation] (error_code ec) {
+            if (!ec) {
+                self->on_delay(generation);
+            }
+        });
+    }
+
+    void on_delay(std::uint64_t generation) {
+        std::unique_lock lock(mutex_);
+        if (generation != generation_ || current_.size() == 0) {
+            return;
+        }
+        auto batch = take();
+        lock.unlock();
+        flush(std::move(batch));
+    }
+
+    void flush(batch_type batch) {
+        auto loaded = std::make_shared<batch_type>(std::move(batch));
+        auto rows = std::make_shared<std::vector<Row>>();
+        rows->reserve(loaded->size());
+        ozo::request(connection_provider(source_, io_), make_query(text_, std::move(loaded->keys)),
+            config_.timeout, std::back_inserter(*rows),
+            [loaded, rows] (error_code ec, auto) {
+                if (ec) {
+                    return loaded->complete(ec);
+                }
+                loaded->complete(*rows);
+            });
+    }
+
+    std::mutex mutex_;
+    Source source_;
+    io_context& io_;
+    std::string text_;
+    batch_loader_config config_;
+    batch_type current_;
+    std::uint64_t generation_ = 0;
+    bool scheduled_ = false;
+};
+
+} // namespace detail
+
+/**
+ * @brief Batches point lookups by key into one query
+ *
+ * Many callers which load one row by key each, e.g. resolvers of a GraphQL request, make a
+ * round trip per key. The loader collects the keys loaded during one turn of the event loop,
+ * or during the maximum delay if it is set, and loads them with one query which takes all the
+ * distinct keys of the batch as a single array parameter:
+ *
+ * @code
+SELECT id, name FROM users WHERE id = ANY($1)
+ * @endcode
+ *
+ * The text of the query does not depend on the number of the keys, so all the batches share
+ * a single prepared statement and its plan. The first column of the rows should be the key;
+ * the rows are demultiplexed by it, so each load completes with the row of its key, or with
+ * no row if there is no one. All the loads of a batch complete with the error of its query.
+ *
+ * The object may be used from many threads simultaneously.
+ *
+ * ###Example
+ *
+ * @code
+ozo::batch_loader<decltype(pool)&, std::int64_t, std::string> users(pool, io,
+    "SELECT id, name FROM users WHERE id = ANY($1)");
+
+const auto user = users.load(id, yield[ec]);
+if (user) {
+    std::cout << std::get<1>(*user) << '\n';
+}
+ * @endcode
+ *
+ * @tparam Source --- type of the `ConnectionSource`; may be a reference type, e.g. for a pool.
+ * @tparam Key --- type of the key, should be hashable with `std::hash`.
+ * @tparam Columns --- types of the row columns after the key.
+ * @ingroup group-requests-types
+ */
+template <typename Source, typename Key, typename ...Columns>
+class batch_loader {
+    static_assert(ConnectionSource<Source>, "Source should model ConnectionSource concept");
+
+public:
+    using key_type = Key;
+    using row_type = std::tuple<Key, Columns...>;
+
+private:
+    using state_type = detail::batch_loader_state<Source, Key, row_type>;
+
+public:
+    /**
+     * @brief Construct a new batch loader object
+     *
+     * @param source --- connection source to load the rows with.
+     * @param io --- `io_context` for the connections IO and the batch delays.
+     * @param text --- query text with the array of the keys as the `$1` parameter.
+     * @param config --- loader configuration.
+     */
+    batch_loader(Source source, io_context& io, std::string text, const batch_loader_config& config = {})
+    : state_(std::make_shared<state_type>(std::forward<Source>(source), io, std::move(text), config)) {}
+
+    /**
+     * @brief Loads the row of the key with the next batch
+     *
+     * @param key --- key of the row.
+     * @param token --- operation #CompletionToken with `void(ozo::error_code, std::optional<row_type>)` signature.
+     * @return deduced from #CompletionToken.
+     */
+    template <typename CompletionToken>
+    decltype(auto) load(key_type key, CompletionToken&& token) {
+        return async_initiate<CompletionToken, void(error_code, std::optional<row_type>)>(
+            [state = state_] (auto&& handler, key_type key) {
+                using handler_type = std::decay_t<decltype(handler)>;
+                using waiter_type = detail::batch_loader_waiter_impl<row_type, handler_type, io_context::executor_type>;
+                state->load(std::move(key), std::make_unique<waiter_type>(
+                    std::forward<decltype(handler)>(handler), state->get_io_context().get_executor()));
+            },
+            token, std::move(key));
+    }
+
+private:
+    std::shared_ptr<state_type> state_;
+};
+
+} // namespace ozo
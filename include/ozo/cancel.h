@@ -3,6 +3,8 @@
 #include <ozo/connection.h>
 #include <ozo/time_traits.h>
 
+#include <ozo/pg/handle.h>
+
 #include <libpq-fe.h>
 #include <memory>
 
@@ -27,14 +29,18 @@ public:
 
     native_handle_type native_handle() const { return std::get<0>(v_).get();} //!< Cancel operation native libpq handle
 
-    cancel_handle(native_handle_type handle, Executor ex) : v_(handle, std::move(ex)) {}
+    int backend_pid() const noexcept { return backend_pid_;} //!< Process id of the backend to cancel the query of, 0 if unknown
 
-private:
-    struct deleter {
-        void operator()(native_handle_type h) const { PQfreeCancel(h); }
-    };
+    cancel_handle(native_handle_type handle, Executor ex, int backend_pid = 0)
+    : v_(pg::make_safe(handle), std::move(ex)), backend_pid_(backend_pid) {}
 
-    std::tuple<std::unique_ptr<PGcancel, deleter>, executor_type> v_;
+    //! Shares the native handle cached by a connection
+    cancel_handle(pg::shared_cancel handle, Executor ex, int backend_pid = 0)
+    : v_(std::move(handle), std::move(ex)), backend_pid_(backend_pid) {}
+
+private:
+    std::tuple<pg::shared_cancel, executor_type> v_;
+    int backend_pid_ = 0;
 };
 
 /**
@@ -51,11 +57,63 @@ private:
  * That's why it needs a dedicated Executor. User should specify an executor to implement a proper execution
  * strategy, e.g. the operations' queue which would be handled in a dedicated thread and so on.
  *
+ * The native handle is cached by `ozo::connection` until the connection is closed
+ * or reassigned, so only the first call for the connection allocates it.
+ *
+ * With libpq 17 or newer `ozo::get_async_cancel_handle()` may be used instead to perform
+ * the cancel operation without blocking a thread.
+ *
  * @ingroup group-requests-functions
  */
 template <typename Connection, typename Executor = boost::asio::system_executor>
 inline cancel_handle<Executor> get_cancel_handle(const Connection& connection, Executor&& executor = Executor{});
 
+#ifdef LIBPQ_HAS_ASYNC_CANCEL
+
+/**
+ * @brief Non-blocking cancel operation handle
+ *
+ * The handle owns the libpq cancel connection object which is used to send
+ * the cancel request to a database backend without blocking a thread. The
+ * cancel connection is performed on the `io_context` given to `ozo::cancel()`.
+ *
+ * @note Available with libpq 17 or newer.
+ * @ingroup group-requests-types
+ */
+class async_cancel_handle {
+public:
+    using native_handle_type = PGcancelConn*; //!< Cancel connection native libpq handle type
+
+    native_handle_type native_handle() const noexcept { return v_.get();} //!< Cancel connection native libpq handle
+
+    explicit async_cancel_handle(native_handle_type handle) noexcept : v_(handle) {}
+
+private:
+    struct deleter {
+        void operator()(native_handle_type h) const { PQcancelFinish(h); }
+    };
+
+    std::unique_ptr<PGcancelConn, deleter> v_;
+};
+
+/**
+ * @brief Get non-blocking cancel handle for the cancel operation
+ *
+ * Unlike `ozo::get_cancel_handle()` the handle needs no dedicated executor since
+ * the cancel request is sent via the non-blocking libpq cancel API.
+ *
+ * @param connection --- `Connection` with active operation to cancel.
+ * @return null-state object if the cancel connection object could not be created.
+ * @return initialized object otherwise.
+ *
+ * @note Available with libpq 17 or newer.
+ * @ingroup group-requests-functions
+ */
+template <typename Connection>
+inline async_cancel_handle get_async_cancel_handle(const Connection& connection);
+
+#endif
+
 #ifdef OZO_DOCUMENTATION
 
 
@@ -158,6 +216,42 @@ auto cancel(cancel_handle<Executor>&& handle, io_context& io, TimeConstraint tim
  */
 template <typename Executor, typename CancelCompletionToken>
 auto cancel(cancel_handle<Executor>&& handle, CancelCompletionToken&& token);
+
+/**
+ * @brief Cancel execution of current request on a database backend without blocking a thread.
+ *
+ * The cancel request is sent via the cancel connection which socket is served by
+ * the given `io_context` like the connection establishment, so no dedicated
+ * executor is needed. The operation is completed with `boost::asio::error::timed_out`
+ * on the time constraint expiration.
+ *
+ * @param handle --- handle for the cancel operation, should be obtained via `ozo::get_async_cancel_handle`.
+ * @param io --- `io_context` for the cancel connection IO.
+ * @param time_constraint --- #TimeConstraint for the cancel operation.
+ * @param token --- valid `CancelCompletionToken`.
+ * @return deduced from `CancelCompletionToken`.
+ *
+ * @note Available with libpq 17 or newer.
+ * @ingroup group-requests-functions
+ */
+template <typename TimeConstraint, typename CancelCompletionToken>
+auto cancel(async_cancel_handle&& handle, io_context& io, TimeConstraint time_constraint, CancelCompletionToken&& token);
+
+/**
+ * @brief Cancel execution of current request on a database backend without blocking a thread.
+ *
+ * This version executes the non-blocking cancel operation without a time constraint.
+ *
+ * @param handle --- handle for the cancel operation, should be obtained via `ozo::get_async_cancel_handle`.
+ * @param io --- `io_context` for the cancel connection IO.
+ * @param token --- valid `CancelCompletionToken`.
+ * @return deduced from `CancelCompletionToken`.
+ *
+ * @note Available with libpq 17 or newer.
+ * @ingroup group-requests-functions
+ */
+template <typename CancelCompletionToken>
+auto cancel(async_cancel_handle&& handle, io_context& io, CancelCompletionToken&& token);
 #else
 struct cancel_op {
     template <typename Executor, typename TimeConstraint, typename CancelCompletionToken>
@@ -166,6 +260,15 @@ struct cancel_op {
 
     template <typename Executor, typename CancelCompletionToken>
     auto operator() (cancel_handle<Executor>&& handle, CancelCompletionToken&& token) const;
+
+#ifdef LIBPQ_HAS_ASYNC_CANCEL
+    template <typename TimeConstraint, typename CancelCompletionToken>
+    auto operator() (async_cancel_handle&& handle, io_context& io,
+        TimeConstraint time_constraint, CancelCompletionToken&& token) const;
+
+    template <typename CancelCompletionToken>
+    auto operator() (async_cancel_handle&& handle, io_context& io, CancelCompletionToken&& token) const;
+#endif
 };
 
 constexpr cancel_op cancel;
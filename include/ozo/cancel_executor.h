@@ -0,0 +1,288 @@
+#pragma once
+
+#include <ozo/cancel.h>
+#include <ozo/error.h>
+#include <ozo/detail/make_copyable.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace ozo {
+
+/**
+ * @brief Cancel executor metrics
+ *
+ * Snapshot of the `ozo::cancel_executor` counters returned by `cancel_executor::metrics()`.
+ *
+ * @ingroup group-requests-types
+ */
+struct cancel_executor_metrics {
+    std::size_t queued = 0; //!< number of cancel requests waiting for a thread
+    std::size_t in_flight = 0; //!< number of cancel requests being sent by the threads
+    std::size_t coalesced = 0; //!< number of cancel requests joined to a queued request for the same backend
+    std::size_t rejected = 0; //!< number of cancel requests completed with `ozo::error::cancel_queue_full`
+};
+
+/**
+ * @brief Bounded executor for the blocking cancel operation
+ *
+ * `ozo::cancel()` sends the cancel request via the blocking `PQcancel()` on the executor
+ * of the cancel handle. The default `boost::asio::system_executor` creates threads on demand,
+ * so a mass cancellation may create a thread per request. This execution context runs the
+ * cancel requests on a fixed number of threads and limits the number of queued requests,
+ * a request beyond the limit is completed with `ozo::error::cancel_queue_full` immediately.
+ * A cancel request for the backend which has a queued request already is joined to it,
+ * so the backend receives one request and all of them are completed with its result.
+ *
+ * The executor is passed to `ozo::get_cancel_handle()`. Functions posted via the executor
+ * directly are queued without the limit. The queued requests are completed before the
+ * destruction of the object.
+ *
+ * ### Example
+ * @code
+ozo::cancel_executor cancel_executor(2, 64);
+auto handle = ozo::get_cancel_handle(conn, cancel_executor.get_executor());
+ozo::cancel(std::move(handle), io, 5s, yield[ec]);
+ * @endcode
+ * @ingroup group-requests-types
+ */
+class cancel_executor : public asio::execution_context {
+public:
+    class executor_type;
+
+    /**
+     * @brief Construct a new cancel executor object and start its threads
+     *
+     * @param threads --- number of threads to send the cancel requests.
+     * @param queue_limit --- maximum number of queued cancel requests.
+     */
+    explicit cancel_executor(std::size_t threads = 1, std::size_t queue_limit = 128)
+    : queue_limit_(queue_limit) {
+        threads_.reserve(threads);
+        for (std::size_t i = 0; i < std::max<std::size_t>(threads, 1); ++i) {
+            threads_.emplace_back([this] { run(); });
+        }
+    }
+
+    cancel_executor(const cancel_executor&) = delete;
+    cancel_executor& operator= (const cancel_executor&) = delete;
+
+    ~cancel_executor() {
+        {
+            std::lock_guard lock(mutex_);
+            stopped_ = true;
+        }
+        ready_.notify_all();
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+        shutdown();
+        destroy();
+    }
+
+    /**
+     * Get the executor to be used for the cancel handles.
+     *
+     * @return executor_type --- executor object.
+     */
+    executor_type get_executor() noexcept;
+
+    /**
+     * Get the snapshot of the counters.
+     *
+     * @return cancel_executor_metrics --- counters values.
+     */
+    cancel_executor_metrics metrics() const noexcept {
+        cancel_executor_metrics retval;
+        retval.queued = queued_.load(std::memory_order_relaxed);
+        retval.in_flight = in_flight_.load(std::memory_order_relaxed);
+        retval.coalesced = coalesced_.load(std::memory_order_relaxed);
+        retval.rejected = rejected_.load(std::memory_order_relaxed);
+        return retval;
+    }
+
+private:
+    using completion_type = std::function<void (error_code, std::string)>;
+
+    struct cancel_request {
+        std::function<std::tuple<error_code, std::string> ()> send;
+        std::vector<completion_type> completions;
+    };
+
+    struct task {
+        int backend_pid = 0;
+        std::function<void ()> function;
+        std::shared_ptr<cancel_request> request;
+    };
+
+    void post(std::function<void ()> function) {
+        {
+            std::lock_guard lock(mutex_);
+            tasks_.push_back(task{0, std::move(function), nullptr});
+        }
+        ready_.notify_one();
+    }
+
+    void submit(int backend_pid, std::function<std::tuple<error_code, std::string> ()> send,
+            completion_type completion) {
+        std::unique_lock lock(mutex_);
+        if (stopped_) {
+            lock.unlock();
+            return completion(asio::error::operation_aborted, "cancel executor is stopped");
+        }
+        if (backend_pid) {
+            if (const auto it = queued_requests_.find(backend_pid); it != queued_requests_.end()) {
+                it->second->completions.push_back(std::move(completion));
+                coalesced_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+        if (queued_.load(std::memory_order_relaxed) >= queue_limit_) {
+            lock.unlock();
+            rejected_.fetch_add(1, std::memory_order_relaxed);
+            return completion(error::cancel_queue_full, "cancel executor queue is full");
+        }
+        auto request = std::make_shared<cancel_request>();
+        request->send = std::move(send);
+        request->completions.push_back(std::move(completion));
+        if (backend_pid) {
+            queued_requests_.emplace(backend_pid, request);
+        }
+        tasks_.push_back(task{backend_pid, nullptr, std::move(request)});
+        queued_.fetch_add(1, std::memory_order_relaxed);
+        lock.unlock();
+        ready_.notify_one();
+    }
+
+    void run() {
+        running_in_this_thread_ = this;
+        for (;;) {
+            std::unique_lock lock(mutex_);
+            ready_.wait(lock, [&] { return stopped_ || !tasks_.empty();});
+            if (tasks_.empty()) {
+                return;
+            }
+            auto t = std::move(tasks_.front());
+            tasks_.pop_front();
+            if (t.request) {
+                if (t.backend_pid) {
+                    queued_requests_.erase(t.backend_pid);
+                }
+                queued_.fetch_sub(1, std::memory_order_relaxed);
+                in_flight_.fetch_add(1, std::memory_order_relaxed);
+            }
+            lock.unlock();
+
+            if (t.request) {
+                auto [ec, msg] = t.request->send();
+                in_flight_.fetch_sub(1, std::memory_order_relaxed);
+                for (auto& completion : t.request->completions) {
+                    completion(ec, msg);
+                }
+            } else {
+                t.function();
+            }
+        }
+    }
+
+    bool running_in_this_thread() const noexcept { return running_in_this_thread_ == this;}
+
+    static inline thread_local const cancel_executor* running_in_this_thread_ = nullptr;
+
+    const std::size_t queue_limit_;
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    std::deque<task> tasks_;
+    std::unordered_map<int, std::shared_ptr<cancel_request>> queued_requests_;
+    bool stopped_ = false;
+    std::atomic<std::size_t> queued_ {0};
+    std::atomic<std::size_t> in_flight_ {0};
+    std::atomic<std::size_t> coalesced_ {0};
+    std::atomic<std::size_t> rejected_ {0};
+    std::vector<std::thread> threads_;
+
+    friend class executor_type;
+};
+
+/**
+ * @brief Executor of the `ozo::cancel_executor`
+ *
+ * Models the Networking TS executor, the cancel operations posted by `ozo::cancel()`
+ * are queued with the limit and coalesced by the backend process id of the cancel handle.
+ */
+class cancel_executor::executor_type {
+public:
+    using cancel_queue_tag = void;
+
+    cancel_executor& context() const noexcept { return *ctx_;}
+
+    void on_work_started() const noexcept {}
+
+    void on_work_finished() const noexcept {}
+
+    template <typename Function, typename Allocator>
+    void dispatch(Function&& f, const Allocator& a) const {
+        if (ctx_->running_in_this_thread()) {
+            std::decay_t<Function> tmp(std::forward<Function>(f));
+            return tmp();
+        }
+        post(std::forward<Function>(f), a);
+    }
+
+    template <typename Function, typename Allocator>
+    void post(Function&& f, const Allocator&) const {
+        using function_type = std::decay_t<Function>;
+        ctx_->post(detail::make_copyable_t<function_type>{function_type(std::forward<Function>(f))});
+    }
+
+    template <typename Function, typename Allocator>
+    void defer(Function&& f, const Allocator& a) const {
+        post(std::forward<Function>(f), a);
+    }
+
+    /**
+     * Queues the cancel operation. The operation should provide the `send()` member function
+     * which sends the cancel request and returns `std::tuple<error_code, std::string>`
+     * and the `complete(error_code, std::string)` member function which completes the operation.
+     *
+     * @param backend_pid --- process id of the backend to cancel the query of, 0 disables the coalescing.
+     * @param op --- cancel operation.
+     */
+    template <typename Operation>
+    void submit_cancel(int backend_pid, Operation&& op) const {
+        auto shared_op = std::make_shared<std::decay_t<Operation>>(std::forward<Operation>(op));
+        ctx_->submit(backend_pid,
+            [shared_op] { return shared_op->send();},
+            [shared_op] (error_code ec, std::string msg) { shared_op->complete(std::move(ec), std::move(msg));});
+    }
+
+    friend bool operator== (const executor_type& lhs, const executor_type& rhs) noexcept {
+        return lhs.ctx_ == rhs.ctx_;
+    }
+
+    friend bool operator!= (const executor_type& lhs, const executor_type& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+private:
+    explicit executor_type(cancel_executor& ctx) noexcept : ctx_(std::addressof(ctx)) {}
+
+    cancel_executor* ctx_;
+
+    friend class cancel_executor;
+};
+
+inline cancel_executor::executor_type cancel_executor::get_executor() noexcept {
+    return executor_type{*this};
+}
+
+} // namespace ozo
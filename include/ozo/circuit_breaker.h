@@ -0,0 +1,280 @@
+#pragma once
+
+#include <ozo/connector.h>
+#include <ozo/connection.h>
+#include <ozo/error.h>
+#include <ozo/time_traits.h>
+#include <ozo/asio.h>
+#include <ozo/detail/bind.h>
+
+#include <boost/asio/post.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+namespace ozo {
+
+/**
+ * @brief Circuit breaker configuration
+ * @ingroup group-connection-types
+ *
+ * Settings of `ozo::circuit_breaker_connection_source`.
+ */
+struct circuit_breaker_config {
+    std::size_t failure_threshold = 5; //!< number of consecutive failed connection requests which opens the circuit
+    time_traits::duration cooldown = std::chrono::seconds(5); //!< time the circuit stays open before the probe connection requests are allowed
+    std::size_t probes = 1; //!< number of concurrent probe connection requests of the half-open circuit
+};
+
+/**
+ * @brief Circuit breaker state
+ * @ingroup group-connection-types
+ */
+enum class circuit_breaker_state {
+    closed, //!< connection requests are passed to the underlying source
+    open, //!< connection requests are rejected with `ozo::error::circuit_breaker_open`
+    half_open, //!< only the probe connection requests are passed to the underlying source
+};
+
+/**
+ * @brief Circuit breaker metrics
+ * @ingroup group-connection-types
+ *
+ * Snapshot of the `ozo::circuit_breaker_connection_source` state returned by
+ * `circuit_breaker_connection_source::metrics()`.
+ */
+struct circuit_breaker_metrics {
+    circuit_breaker_state state = circuit_breaker_state::closed; //!< current state of the circuit
+    std::size_t failures = 0; //!< number of consecutive failed connection requests
+    std::uint64_t rejected = 0; //!< number of requests completed with `ozo::error::circuit_breaker_open`
+};
+
+namespace detail {
+
+/**
+ * Circuit of a host. It is opened by the threshold of consecutive failed connection
+ * requests and rejects the requests during the cooldown. After the cooldown it lets
+ * the limited number of probe requests pass. A successful probe closes the circuit,
+ * a failed one opens it for the next cooldown.
+ */
+class circuit_breaker {
+public:
+    explicit circuit_breaker(const circuit_breaker_config& config)
+    : config_(config) {
+        config_.failure_threshold = std::max<std::size_t>(config_.failure_threshold, 1);
+        config_.probes = std::max<std::size_t>(config_.probes, 1);
+    }
+
+    /**
+     * Admits a connection request. Returns `std::nullopt` if the request is rejected,
+     * otherwise whether the request is a probe.
+     */
+    std::optional<bool> try_acquire(time_traits::time_point now) {
+        const std::lock_guard lock(mutex_);
+        if (state_ == circuit_breaker_state::open && now >= open_until_) {
+            state_ = circuit_breaker_state::half_open;
+        }
+        switch (state_) {
+            case circuit_breaker_state::closed:
+                return false;
+            case circuit_breaker_state::half_open:
+                if (probes_ < config_.probes) {
+                    ++probes_;
+                    return true;
+                }
+                break;
+            case circuit_breaker_state::open:
+                break;
+        }
+        ++rejected_;
+        return std::nullopt;
+    }
+
+    /**
+     * Completes an admitted connection request. A request completed with an error
+     * which is not a failure of the host, see `is_failure()`, does not change the state.
+     */
+    void release(bool probe, const error_code& ec, time_traits::time_point now) {
+        const std::lock_guard lock(mutex_);
+        if (probe) {
+            --probes_;
+        }
+        if (!ec) {
+            failures_ = 0;
+            state_ = circuit_breaker_state::closed;
+            return;
+        }
+        if (!is_failure(ec)) {
+            return;
+        }
+        ++failures_;
+        if (probe || (state_ == circuit_breaker_state::closed && failures_ >= config_.failure_threshold)) {
+            state_ = circuit_breaker_state::open;
+            open_until_ = now + config_.cooldown;
+        }
+    }
+
+    /**
+     * A connection request is failed if the host has not been reached. A cancelled
+     * request says nothing about the host.
+     */
+    static bool is_failure(const error_code& ec) {
+        return ec == errc::connection_error && ec != asio::error::operation_aborted;
+    }
+
+    circuit_breaker_metrics metrics() const {
+        const std::lock_guard lock(mutex_);
+        return {state_, failures_, rejected_};
+    }
+
+private:
+    mutable std::mutex mutex_;
+    circuit_breaker_config config_;
+    circuit_breaker_state state_ = circuit_breaker_state::closed;
+    std::size_t failures_ = 0;
+    std::size_t probes_ = 0;
+    std::uint64_t rejected_ = 0;
+    time_traits::time_point open_until_ = {};
+};
+
+template <typename Handler>
+struct circuit_breaker_handler {
+    Handler handler_;
+    std::shared_ptr<circuit_breaker> circuit_;
+    bool probe_;
+
+    template <typename Connection>
+    void operator() (error_code ec, Connection&& conn) {
+        circuit_->release(probe_, ec, time_traits::now());
+        handler_(std::move(ec), std::forward<Connection>(conn));
+    }
+
+    using executor_type = std::decay_t<decltype(asio::get_associated_executor(handler_))>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(handler_);
+    }
+
+    using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(handler_))>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(handler_);
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief Connection source with the circuit breaker of a host
+ *
+ * When a host is down each connection request to it waits for the connect timeout before
+ * the failover comes into play. The source tracks the consecutive failed connection requests
+ * to the underlying source of a host, e.g. `ozo::connection_pool`, and opens the circuit when
+ * their number reaches the threshold. A request to the open circuit is completed with
+ * `ozo::error::circuit_breaker_open` immediately. The error is the `ozo::errc::connection_error`
+ * condition, so `ozo::failover::role_based()` falls back to the next role without a delay.
+ * After the cooldown the circuit is half-open: the limited number of probe requests is passed
+ * to the underlying source, and the first successful one closes the circuit while a failed
+ * one opens it again, see `ozo::circuit_breaker_config`.
+ *
+ * A connection request is failed if it is completed with the `ozo::errc::connection_error`
+ * error condition except `boost::asio::error::operation_aborted`. The errors of the queries
+ * are not tracked.
+ *
+ * The circuit is shared by the copies of the source, so the source may be used by many
+ * threads simultaneously. Use a source per host.
+ *
+ * @tparam Source --- type of the underlying `ConnectionSource`; may be a reference type, e.g. for a pool.
+ * @ingroup group-connection-types
+ * @models{ConnectionSource}
+ */
+template <typename Source>
+class circuit_breaker_connection_source {
+    static_assert(ConnectionSource<Source>, "Source should model ConnectionSource concept");
+
+    Source source_;
+    std::shared_ptr<detail::circuit_breaker> circuit_;
+
+public:
+    /**
+     * `Connection` implementation type according to `ConnectionSource` requirements.
+     */
+    using connection_type = typename connection_source_traits<Source>::connection_type;
+
+    /**
+     * @brief Construct a new circuit breaker connection source object
+     *
+     * @param source --- underlying connection source.
+     * @param config --- circuit breaker configuration.
+     */
+    circuit_breaker_connection_source(Source source, const circuit_breaker_config& config = {})
+    : source_(std::forward<Source>(source)), circuit_(std::make_shared<detail::circuit_breaker>(config)) {}
+
+    /**
+     * @brief Provides a connection from the underlying source if the circuit is not open
+     *
+     * @param io --- `io_context` for the connection IO.
+     * @param t --- #TimeConstraint for the operation.
+     * @param handler --- #Handler.
+     */
+    template <typename TimeConstraint, typename Handler>
+    void operator ()(io_context& io, TimeConstraint t, Handler&& handler) const {
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        const auto probe = circuit_->try_acquire(time_traits::now());
+        if (!probe) {
+            return asio::post(io.get_executor(), detail::bind(std::forward<Handler>(handler),
+                error_code{error::circuit_breaker_open}, connection_type{}));
+        }
+        source_(io, std::move(t), detail::circuit_breaker_handler<std::decay_t<Handler>>{
+            std::forward<Handler>(handler), circuit_, *probe
+        });
+    }
+
+    /**
+     * Get snapshot of the circuit state.
+     *
+     * @return circuit_breaker_metrics --- current state and counters.
+     */
+    circuit_breaker_metrics metrics() const { return circuit_->metrics();}
+
+    auto operator [](io_context& io) const & {
+        return connection_provider(*this, io);
+    }
+
+    auto operator [](io_context& io) && {
+        return connection_provider(std::move(*this), io);
+    }
+};
+
+/**
+ * @brief Creates connection source with the circuit breaker of a host
+ *
+ * ###Example
+ *
+@code
+ozo::circuit_breaker_config config;
+config.failure_threshold = 3;
+config.cooldown = 2s;
+auto master = ozo::make_circuit_breaker_connection_source(master_pool, config);
+auto replica = ozo::make_circuit_breaker_connection_source(replica_pool, config);
+auto source = ozo::failover::make_role_based_connection_source(
+    ozo::failover::master=std::move(master),
+    ozo::failover::replica=std::move(replica)
+);
+@endcode
+ *
+ * @param source --- underlying connection source; an lvalue is referenced, so it should outlive
+ *                 the result, an rvalue is moved into the result.
+ * @param config --- circuit breaker configuration.
+ * @return `ozo::circuit_breaker_connection_source` object.
+ * @ingroup group-connection-functions
+ */
+template <typename Source>
+auto make_circuit_breaker_connection_source(Source&& source, const circuit_breaker_config& config = {}) {
+    return circuit_breaker_connection_source<Source>{std::forward<Source>(source), config};
+}
+
+} // namespace ozo
@@ -1,20 +1,32 @@
 #pragma once
 
 #include <ozo/error.h>
+#include <ozo/error_context.h>
 #include <ozo/type_traits.h>
 #include <ozo/asio.h>
+#include <ozo/connection_statistics.h>
 #include <ozo/core/concept.h>
 #include <ozo/core/recursive.h>
 #include <ozo/core/none.h>
+#include <ozo/core/thread_safety.h>
 #include <ozo/deadline.h>
 #include <ozo/pg/handle.h>
+#include <ozo/socket_options.h>
 
 #include <ozo/detail/bind.h>
 #include <ozo/detail/functional.h>
+#include <ozo/detail/hot_statements.h>
+#include <ozo/detail/operation_slab.h>
+#include <ozo/detail/session_settings.h>
+#include <ozo/detail/statement_cache.h>
 
 #include <boost/asio/dispatch.hpp>
 #include <boost/asio/posix/stream_descriptor.hpp>
 
+#include <memory>
+#include <string>
+#include <vector>
+
 namespace ozo {
 
 /**
@@ -83,7 +95,7 @@ inline constexpr decltype(auto) unwrap_connection(T&& conn) noexcept {
  * The class object is non-copyable.
  *
  * @tparam OidMap --- oid map of types are used with connection
- * @tparam Statistics --- statistics of the connection (not supported yet)
+ * @tparam Statistics --- statistics of the connection, e.g. `ozo::connection_statistics` or `ozo::no_statistics`
  *
  * @thread_safety{Safe,Unsafe}
  * @ingroup group-connection-types
@@ -94,14 +106,14 @@ class connection {
 public:
     using native_handle_type = ozo::pg::conn::pointer; //!< Native connection handle type
     using oid_map_type = OidMap; //!< Oid map of types that are used with the connection
-    using error_context_type = std::string; //!< Additional error context which could provide context depended information for errors
+    using error_context_type = ozo::error_context; //!< Additional error context which could provide context depended information for errors
     using executor_type = io_context::executor_type; //!< The type of the executor associated with the object.
 
     /**
      * Construct a new connection object.
      *
      * @param io --- execution context for IO operations associated with the object.
-     * @param statistics --- initial statistics (not supported yet)
+     * @param statistics --- initial statistics
      */
     connection(io_context& io, Statistics statistics);
 
@@ -132,10 +144,25 @@ public:
      */
     const oid_map_type& oid_map() const noexcept { return oid_map_;}
 
-    template <typename Key, typename Value>
-    void update_statistics(const Key&, const Value&) noexcept {
-        static_assert(std::is_void_v<Key>, "update_statistics is not supperted");
+    /**
+     * Update the connection statistics with a value of the given key, e.g.
+     * `ozo::request_statistics` of a completed request. It is available if
+     * the Statistics model supports the key, e.g. `ozo::connection_statistics`.
+     *
+     * @param key --- statistics key.
+     * @param v --- statistics value.
+     */
+    template <typename Key, typename Value, typename S = Statistics>
+    auto update_statistics(const Key& key, const Value& v) noexcept
+            -> decltype(std::declval<S&>().update(key, v)) {
+        return statistics_.update(key, v);
     }
+
+    /**
+     * Get the connection statistics.
+     *
+     * @return const Statistics& --- statistics collected for the connection.
+     */
     const Statistics& statistics() const noexcept { return statistics_;}
 
     /**
@@ -152,6 +179,32 @@ public:
      */
     void set_error_context(error_context_type v = error_context_type{}) { error_context_ = std::move(v); }
 
+    /**
+     * Get the cache of statements prepared on the connection. The cache is used by
+     * `ozo::prepared()` queries and is cleared when the connection is closed.
+     *
+     * @return detail::statement_cache& --- reference on the cache of prepared statements.
+     */
+    detail::statement_cache& statement_cache() noexcept { return statement_cache_;}
+
+    /**
+     * Get the native handle for the cancel operation. The handle is allocated by the first
+     * call and cached until the connection is closed or another native handle is assigned,
+     * see `ozo::get_cancel_handle()`.
+     *
+     * @return pg::shared_cancel --- cancel handle, null if the connection is closed.
+     */
+    pg::shared_cancel native_cancel_handle() const;
+
+    /**
+     * Get the slab the state of operations executed on the connection is allocated from,
+     * unless the operation handler has its own associated allocator. The blocks of a completed
+     * operation are reused by the next one, so a steady-state request allocates no state.
+     *
+     * @return const std::shared_ptr<detail::operation_slab>& --- slab of the connection.
+     */
+    const std::shared_ptr<detail::operation_slab>& operation_slab() const noexcept { return operation_slab_;}
+
     /**
      * Get the executor associated with the object.
      *
@@ -260,9 +313,161 @@ public:
      */
     bool is_open() const noexcept { return native_handle() != nullptr;}
 
+    /**
+     * Get the grace period of an operation after its time constraint expiration. If it is
+     * non-zero the cancel request is sent to the server on the expiration and the operation
+     * is given the period to receive the error of the cancelled query, so the connection is
+     * left in a usable state instead of the cancelled IO. IO is cancelled if the period expires.
+     *
+     * @return time_traits::duration --- grace period, zero if the server cancel is disabled.
+     */
+    time_traits::duration cancel_on_timeout() const noexcept { return cancel_on_timeout_;}
+
+    /**
+     * Set the grace period of an operation after its time constraint expiration,
+     * see `cancel_on_timeout()`.
+     *
+     * @param grace --- grace period, zero disables the server cancel.
+     */
+    void set_cancel_on_timeout(time_traits::duration grace) noexcept { cancel_on_timeout_ = grace;}
+
+    /**
+     * Determine whether the time left to the deadline of a request is sent to the server
+     * as the `statement_timeout` of the query, so the server stops the query which result
+     * would not be awaited anyway. The timeout is not set for a query within a transaction.
+     *
+     * @return true --- the deadline is propagated to the server.
+     * @return false --- the deadline is handled by the client only.
+     */
+    bool propagate_deadline() const noexcept { return propagate_deadline_;}
+
+    /**
+     * Enable or disable the propagation of request deadlines, see `propagate_deadline()`.
+     *
+     * @param enable --- true to propagate the deadlines.
+     */
+    void set_propagate_deadline(bool enable) noexcept { propagate_deadline_ = enable;}
+
+    /**
+     * Determine whether the oids of the custom types are resolved on their first use by
+     * a request instead of the whole #OidMap on connect. A request resolves the types of
+     * its parameters and output rows which are not resolved yet with a single query
+     * before the request itself.
+     *
+     * @return true --- the oids are resolved on the first use.
+     * @return false --- the oids are resolved on connect.
+     */
+    bool lazy_oid_map() const noexcept { return lazy_oid_map_;}
+
+    /**
+     * Enable or disable the resolution of the custom types oids on their first use,
+     * see `lazy_oid_map()`.
+     *
+     * @param enable --- true to resolve the oids on the first use.
+     */
+    void set_lazy_oid_map(bool enable) noexcept { lazy_oid_map_ = enable;}
+
+    /**
+     * Get the session setup statements which are executed on connect, e.g. `SET search_path TO app`.
+     * The statements are sent in one pipeline with the oid map request, see
+     * `ozo::connection_info::session_setup()`.
+     *
+     * @return const pointer to the statements or null if there are no statements.
+     */
+    const std::shared_ptr<const std::vector<std::string>>& session_setup() const noexcept { return session_setup_;}
+
+    /**
+     * Set the session setup statements which are executed on connect, see `session_setup()`.
+     *
+     * @param statements --- statements to execute or null.
+     */
+    void set_session_setup(std::shared_ptr<const std::vector<std::string>> statements) noexcept {
+        session_setup_ = std::move(statements);
+    }
+
+    /**
+     * Get the most frequently used prepared statements of the connections made by the same
+     * `ozo::connection_info`, the connection prepares them on connect in one pipeline with
+     * the oid map request, see `ozo::connection_info::warm_statements()`.
+     *
+     * @return pointer to the statements or null if the statements are not warmed up.
+     */
+    const std::shared_ptr<detail::hot_statements>& hot_statements() const noexcept { return hot_statements_;}
+
+    /**
+     * Set the most frequently used prepared statements, see `hot_statements()`.
+     *
+     * @param statements --- statements or null.
+     */
+    void set_hot_statements(std::shared_ptr<detail::hot_statements> statements) noexcept {
+        hot_statements_ = std::move(statements);
+    }
+
+    /**
+     * Get the session parameters set by `ozo::ensure_settings()` on the connection. Call
+     * `clear()` of the object after the parameters are reset by other statements.
+     *
+     * @return detail::session_settings& --- the parameters set.
+     */
+    detail::session_settings& session_settings() noexcept { return session_settings_;}
+
+    const detail::session_settings& session_settings() const noexcept { return session_settings_;}
+
+    /**
+     * Get the limit of the data read from the server for the result of a request. A request
+     * which result exceeds the limit is cancelled on the server and completes with the
+     * `ozo::error::result_too_large` error before the rest of the result is received.
+     *
+     * @return std::size_t --- limit in bytes, zero if the result size is not limited.
+     */
+    std::size_t max_result_size() const noexcept { return max_result_size_;}
+
+    /**
+     * Set the limit of the data read from the server for the result of a request,
+     * see `max_result_size()`.
+     *
+     * @param bytes --- limit in bytes, zero disables the limit.
+     */
+    void set_max_result_size(std::size_t bytes) noexcept { max_result_size_ = bytes;}
+
+    /**
+     * Get the time to spin waiting for the data of a request result before waiting
+     * for the socket readiness via the `io_context`, see `connection_info::busy_poll()`.
+     *
+     * @return time_traits::duration --- spin time, zero if the busy polling is disabled.
+     */
+    time_traits::duration busy_poll() const noexcept { return busy_poll_;}
+
+    /**
+     * Set the time to spin waiting for the data of a request result, see `busy_poll()`.
+     * The socket busy polling is applied to the socket assigned next.
+     *
+     * @param time --- spin time, zero disables the busy polling.
+     * @param socket_busy_poll --- set `SO_BUSY_POLL` socket option to the spin time as well.
+     */
+    void set_busy_poll(time_traits::duration time, bool socket_busy_poll = false) noexcept {
+        busy_poll_ = time;
+        socket_busy_poll_ = socket_busy_poll;
+    }
+
+    /**
+     * Get the options which are set on the socket of the connection when it is assigned.
+     *
+     * @return const socket_options& --- socket options.
+     */
+    const socket_options& get_socket_options() const noexcept { return socket_options_;}
+
+    /**
+     * Set the options which are set on the socket of the connection when it is assigned,
+     * see `connection_info::socket_options()`.
+     *
+     * @param options --- socket options.
+     */
+    void set_socket_options(const socket_options& options) noexcept { socket_options_ = options;}
+
     ~connection();
 private:
-    using stream_type = asio::posix::stream_descriptor;
+    using stream_type = typename detail::connection_stream<io_context::executor_type>::type;
 
     ozo::pg::conn handle_;
     io_context* io_ = nullptr;
@@ -270,6 +475,19 @@ private:
     oid_map_type oid_map_;
     Statistics statistics_;
     error_context_type error_context_;
+    detail::statement_cache statement_cache_;
+    mutable pg::shared_cancel cancel_handle_;
+    std::shared_ptr<detail::operation_slab> operation_slab_ = std::make_shared<detail::operation_slab>();
+    time_traits::duration cancel_on_timeout_ = time_traits::duration::zero();
+    bool propagate_deadline_ = false;
+    bool lazy_oid_map_ = false;
+    std::shared_ptr<const std::vector<std::string>> session_setup_;
+    std::shared_ptr<detail::hot_statements> hot_statements_;
+    detail::session_settings session_settings_;
+    std::size_t max_result_size_ = 0;
+    time_traits::duration busy_poll_ = time_traits::duration::zero();
+    bool socket_busy_poll_ = false;
+    socket_options socket_options_;
 };
 
 /**
@@ -285,6 +503,29 @@ struct is_connection : std::false_type {};
 template <typename ...Ts>
 struct is_connection<connection<Ts...>> : std::true_type {};
 
+/**
+ * @ingroup group-connection-types
+ * @brief Thread safety of operations on a connection
+ *
+ * Defines whether the library should serialize the handlers of an operation on a connection
+ * with a strand. It is `ozo::thread_safety<true>` by default, so a connection may be used with
+ * an `io_context` run by several threads. A connection type defines the `thread_safety_type`
+ * member type as `ozo::thread_safety<false>` to skip the strand if its `io_context` is run by
+ * a single thread, e.g. `ozo::pooled_connection` of `ozo::connection_pool` created with
+ * `!ozo::thread_safe`.
+ *
+ * @tparam T --- unwrapped connection type.
+ */
+template <typename T, typename = std::void_t<>>
+struct get_connection_thread_safety {
+    using type = thread_safety<true>;
+};
+
+template <typename T>
+struct get_connection_thread_safety<T, std::void_t<typename T::thread_safety_type>> {
+    using type = typename T::thread_safety_type;
+};
+
 /**
 * @ingroup group-connection-concepts
 * @brief Database connection concept
@@ -415,6 +656,18 @@ inline std::string_view error_message(const Connection& conn);
 template <typename Connection>
 inline const auto& get_error_context(const Connection& conn);
 
+/**
+ * @brief Get the cache of prepared statements
+ *
+ * Alias to `unwrap_connection(conn).statement_cache()`. The function is required
+ * for the connection only to execute `ozo::prepared()` queries.
+ *
+ * @param conn --- `Connection` object which is not in null recursive state
+ * @return reference on the cache of prepared statements
+ */
+template <typename Connection>
+inline auto& get_statement_cache(Connection& conn) noexcept;
+
 /**
  * @brief Get the database name of the active connection
  *
@@ -645,7 +898,8 @@ struct connection_source_traits {
  *
  * @par Concrete models
  *
- * `ozo::connection_info`, `ozo::connection_pool`, `ozo::failover::role_based_connection_source`.
+ * `ozo::connection_info`, `ozo::connection_pool`, `ozo::failover::role_based_connection_source`,
+ * `ozo::failover::least_loaded_connection_source`.
  *
  * @par Definition
  *
@@ -903,3 +1157,9 @@ inline auto defer_close_connection(Connection* conn) {
 } // namespace ozo
 
 #include <ozo/impl/connection.h>
+
+#ifdef OZO_EXTERN_TEMPLATES
+namespace ozo {
+extern template class connection<empty_oid_map, no_statistics>;
+} // namespace ozo
+#endif
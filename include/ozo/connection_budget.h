@@ -0,0 +1,210 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+namespace ozo {
+
+namespace detail {
+
+/**
+ * Accounting of a budget. The connections of a member up to its guarantee are taken from
+ * the reserved part, the ones beyond it are borrowed from the part not reserved by the
+ * guarantees of the members.
+ */
+struct connection_budget_state {
+    mutable std::mutex mutex;
+    const std::size_t limit;
+    std::size_t guaranteed = 0;
+    std::size_t used = 0;
+    std::size_t borrowed = 0;
+    std::uint64_t rejected = 0;
+
+    explicit connection_budget_state(std::size_t limit) : limit(limit) {}
+};
+
+/**
+ * Share of a budget of a connection pool. The guarantee is returned to the budget when
+ * the pool and all its connections are destroyed.
+ */
+class connection_budget_member : public std::enable_shared_from_this<connection_budget_member> {
+public:
+    connection_budget_member(std::shared_ptr<connection_budget_state> state, std::size_t guarantee)
+    : state_(std::move(state)), guarantee_(guarantee) {}
+
+    connection_budget_member(const connection_budget_member&) = delete;
+    connection_budget_member& operator =(const connection_budget_member&) = delete;
+
+    ~connection_budget_member() {
+        const std::lock_guard lock(state_->mutex);
+        state_->guaranteed -= guarantee_;
+    }
+
+    /**
+     * Takes a connection from the budget. The connection is returned when the
+     * result is destroyed, the result is empty if the budget is exhausted.
+     */
+    std::shared_ptr<void> try_acquire() {
+        {
+            const std::lock_guard lock(state_->mutex);
+            if (state_->used >= state_->limit) {
+                ++state_->rejected;
+                return {};
+            }
+            if (used_ >= guarantee_) {
+                if (state_->guaranteed + state_->borrowed >= state_->limit) {
+                    ++state_->rejected;
+                    return {};
+                }
+                ++state_->borrowed;
+            }
+            ++used_;
+            ++state_->used;
+        }
+        auto self = shared_from_this();
+        return std::shared_ptr<void>(self.get(), [self] (void*) { self->release(); });
+    }
+
+    std::size_t guarantee() const noexcept { return guarantee_;}
+
+    std::size_t used() const {
+        const std::lock_guard lock(state_->mutex);
+        return used_;
+    }
+
+private:
+    void release() noexcept {
+        const std::lock_guard lock(state_->mutex);
+        if (used_-- > guarantee_) {
+            --state_->borrowed;
+        }
+        --state_->used;
+    }
+
+    std::shared_ptr<connection_budget_state> state_;
+    const std::size_t guarantee_;
+    std::size_t used_ = 0;
+};
+
+} // namespace detail
+
+/**
+ * @brief Connection budget shared by connection pools
+ *
+ * Limits the total number of connections of several `ozo::connection_pool` objects, e.g. the pools
+ * of different databases and roles of a process, to the number of backends the server can handle.
+ * Each pool joins the budget with a guarantee via `connection_pool_config::budget` and
+ * `connection_pool_config::budget_guarantee`. A pool always may open its guaranteed number of connections,
+ * and opens more while the part of the budget not reserved by the guarantees is not exhausted, so a busy
+ * pool borrows the unused budget and a quiet pool still is not starved.
+ *
+ * A connection takes its share of the budget when it is being established and returns it when it is closed,
+ * e.g. by the idle timeout of its pool. A request which needs a new connection when there is no budget left
+ * completes with `ozo::error::connection_budget_exhausted` at once, so set the idle timeouts of the pools to
+ * return the borrowed budget of idle connections in time.
+ *
+ * The budget is shared by its copies and may be used by pools from many threads simultaneously.
+ *
+ * ###Example
+ *
+ * @code
+ozo::connection_budget budget(200);
+
+ozo::connection_pool_config orders_config;
+orders_config.capacity = 100;
+orders_config.budget = budget;
+orders_config.budget_guarantee = 20;
+
+ozo::connection_pool_config reports_config;
+reports_config.capacity = 50;
+reports_config.budget = budget;
+reports_config.budget_guarantee = 5;
+ * @endcode
+ * @ingroup group-connection-types
+ */
+class connection_budget {
+public:
+    /**
+     * Construct an empty object which does not limit the connections.
+     */
+    connection_budget() = default;
+
+    /**
+     * @brief Construct a new connection budget object
+     *
+     * @param limit --- maximum total number of connections of the pools, should be positive.
+     */
+    explicit connection_budget(std::size_t limit) {
+        if (limit == 0) {
+            throw std::invalid_argument("connection_budget: limit should be positive");
+        }
+        state_ = std::make_shared<detail::connection_budget_state>(limit);
+    }
+
+    /**
+     * `true` if the object limits the connections.
+     */
+    explicit operator bool() const noexcept { return static_cast<bool>(state_);}
+
+    /**
+     * Maximum total number of connections.
+     */
+    std::size_t limit() const noexcept { return state_ ? state_->limit : 0;}
+
+    /**
+     * Number of connections guaranteed to the pools.
+     */
+    std::size_t guaranteed() const { return get(&detail::connection_budget_state::guaranteed);}
+
+    /**
+     * Number of connections of the pools.
+     */
+    std::size_t used() const { return get(&detail::connection_budget_state::used);}
+
+    /**
+     * Number of connections of the pools beyond their guarantees.
+     */
+    std::size_t borrowed() const { return get(&detail::connection_budget_state::borrowed);}
+
+    /**
+     * Number of connection attempts rejected since there was no budget left.
+     */
+    std::uint64_t rejected() const { return get(&detail::connection_budget_state::rejected);}
+
+    /**
+     * Join the budget with the guaranteed number of connections, it is called by `ozo::connection_pool`.
+     *
+     * @param guarantee --- number of connections guaranteed to the member.
+     * @return share of the budget of the member.
+     * @throws std::invalid_argument if the guarantees exceed the limit.
+     */
+    std::shared_ptr<detail::connection_budget_member> join(std::size_t guarantee) const {
+        if (!state_) {
+            return {};
+        }
+        {
+            const std::lock_guard lock(state_->mutex);
+            if (state_->guaranteed + guarantee > state_->limit) {
+                throw std::invalid_argument("connection_budget: guarantees of the pools exceed the limit");
+            }
+            state_->guaranteed += guarantee;
+        }
+        return std::make_shared<detail::connection_budget_member>(state_, guarantee);
+    }
+
+private:
+    template <typename T>
+    T get(T detail::connection_budget_state::* field) const {
+        if (!state_) {
+            return 0;
+        }
+        const std::lock_guard lock(state_->mutex);
+        return (*state_).*field;
+    }
+
+    std::shared_ptr<detail::connection_budget_state> state_;
+};
+
+} // namespace ozo
@@ -3,9 +3,18 @@
 #include <ozo/connector.h>
 #include <ozo/connection.h>
 #include <ozo/impl/async_connect.h>
+#include <ozo/impl/connect_race.h>
+#include <ozo/impl/async_resolve_connect.h>
+#include <ozo/detail/oid_map_cache.h>
+#include <ozo/detail/state_handoff.h>
 #include <ozo/ext/std/shared_ptr.h>
+#include <ozo/ssl_options.h>
 
 #include <chrono>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
 
 namespace ozo {
 
@@ -15,7 +24,15 @@ namespace ozo {
  * This connection source establishes a connection to a single host using (or via) the specified
  * [connection string](https://www.postgresql.org/docs/9.4/static/libpq-connect.html#LIBPQ-CONNSTRING).
  *
- * @warning Multi-host connection is not supported.
+ * A multi-host connection string is handled by libpq which tries the hosts one by one
+ * within a single connect attempt, so an unreachable host delays the connection until
+ * its TCP timeout. Use `race_hosts()` to connect to the hosts concurrently instead.
+ *
+ * Oids of the custom types of a non-empty #OidMap are requested once per server the
+ * connections are established to, new connections to the same server, e.g. after a
+ * failover, reuse the resolved oid map. The cache is shared by the copies of the object,
+ * e.g. by a connection pool made of it, and may be reset with `invalidate_oid_map()`.
+ * The oids may be resolved on their first use instead, see `lazy_oid_map()`.
  *
  * @tparam OidMap --- oid map type with custom types that should be used within a connection.
  * @tparam Statistics --- statistics type which defines statistics is collected for this connection.
@@ -27,7 +44,21 @@ template <
     typename Statistics = no_statistics>
 class connection_info {
     std::string conn_str;
+    std::shared_ptr<const impl::connection_params> conn_params;
     Statistics statistics;
+    std::shared_ptr<detail::oid_map_cache<OidMap>> oid_maps = std::make_shared<detail::oid_map_cache<OidMap>>();
+    std::shared_ptr<const std::vector<std::string>> hosts_conn_strs;
+    time_traits::duration hosts_stagger{};
+    std::shared_ptr<detail::dns_cache> resolved_hosts;
+    time_traits::duration cancel_grace{};
+    bool propagate_deadlines = false;
+    bool lazy_oids = false;
+    std::size_t result_size_limit = 0;
+    time_traits::duration busy_poll_time{};
+    bool socket_busy_poll = false;
+    ozo::socket_options socket_opts;
+    std::shared_ptr<const std::vector<std::string>> session_statements;
+    std::shared_ptr<detail::hot_statements> hot_statements;
 
 public:
     using connection_type = std::shared_ptr<ozo::connection<OidMap, Statistics>>; //!< Type of connection which is produced by the source.
@@ -42,6 +73,9 @@ public:
      */
     connection_info(std::string conn_str, const OidMap& = OidMap{}, Statistics statistics = Statistics{})
             : conn_str(std::move(conn_str)), statistics(std::move(statistics)) {
+        if (auto params = impl::parse_connection_params(this->conn_str)) {
+            conn_params = std::make_shared<const impl::connection_params>(std::move(*params));
+        }
     }
 
     /**
@@ -60,8 +94,378 @@ public:
     void operator ()(io_context& io, TimeConstraint t, Handler&& handler) const {
         static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
         auto allocator = asio::get_associated_allocator(handler);
-        impl::async_connect(conn_str, t, std::allocate_shared<ozo::connection<OidMap, Statistics>>(allocator, io, statistics),
-            std::forward<Handler>(handler));
+        if (hosts_conn_strs) {
+            return impl::async_connect_race(hosts_conn_strs, hosts_stagger, t,
+                [&io, allocator, statistics = statistics, grace = cancel_grace, propagate = propagate_deadlines,
+                        lazy_oids = lazy_oids, limit = result_size_limit, poll = busy_poll_time, socket_poll = socket_busy_poll,
+                        socket_opts = socket_opts, statements = session_statements, hot = hot_statements] {
+                    auto conn = std::allocate_shared<ozo::connection<OidMap, Statistics>>(allocator, io, statistics);
+                    conn->set_cancel_on_timeout(grace);
+                    conn->set_propagate_deadline(propagate);
+                    conn->set_lazy_oid_map(lazy_oids);
+                    conn->set_max_result_size(limit);
+                    conn->set_busy_poll(poll, socket_poll);
+                    conn->set_socket_options(socket_opts);
+                    conn->set_session_setup(statements);
+                    conn->set_hot_statements(hot);
+                    return conn;
+                },
+                std::forward<Handler>(handler), oid_maps);
+        }
+        auto conn = std::allocate_shared<ozo::connection<OidMap, Statistics>>(allocator, io, statistics);
+        conn->set_cancel_on_timeout(cancel_grace);
+        conn->set_propagate_deadline(propagate_deadlines);
+        conn->set_lazy_oid_map(lazy_oids);
+        conn->set_max_result_size(result_size_limit);
+        conn->set_busy_poll(busy_poll_time, socket_busy_poll);
+        conn->set_socket_options(socket_opts);
+        conn->set_session_setup(session_statements);
+        conn->set_hot_statements(hot_statements);
+        if (!conn_params) {
+            return impl::async_connect(conn_str, t, std::move(conn), std::forward<Handler>(handler), oid_maps);
+        }
+        if (resolved_hosts) {
+            return impl::async_resolve_connect(*conn_params, resolved_hosts, t, std::move(conn),
+                std::forward<Handler>(handler), oid_maps);
+        }
+        impl::async_connect(*conn_params, t, std::move(conn), std::forward<Handler>(handler), oid_maps);
+    }
+
+    /**
+     * @brief Race connect attempts to the hosts of a multi-host connection string
+     *
+     * Instead of a single libpq attempt which tries the hosts one by one, an attempt per
+     * host is made. The attempts are started one after another with the `stagger` delay,
+     * or as soon as the previous attempt fails, and run concurrently. The first established
+     * connection is used and the rest of attempts are cancelled. The operation fails with
+     * the error of the last attempt if all of them fail. The `host`, `hostaddr` and `port`
+     * parameters are split by commas, a single value is used for all the hosts. Has no
+     * effect for a connection string with a single host.
+     *
+     * @param stagger --- delay between the starts of the attempts.
+     * @return connection_info& --- the object itself.
+     */
+    connection_info& race_hosts(time_traits::duration stagger = std::chrono::milliseconds(250)) {
+        auto conn_strs = impl::split_hosts(conn_str);
+        if (conn_strs.empty()) {
+            hosts_conn_strs.reset();
+        } else {
+            hosts_conn_strs = std::make_shared<const std::vector<std::string>>(std::move(conn_strs));
+        }
+        hosts_stagger = stagger;
+        return *this;
+    }
+
+    /**
+     * @brief Resolve the host name asynchronously before connect
+     *
+     * libpq resolves the host name synchronously within the connect call which blocks
+     * the io thread. With this option the host is resolved by `asio::ip::tcp::resolver`
+     * and the addresses are passed to libpq via the `hostaddr` parameter. The addresses
+     * are cached for the `ttl` by the copies of the object, so a reconnect does not
+     * resolve the host again. The time constraint of a connect includes the resolve.
+     * Has no effect if `hostaddr` is specified, for a Unix-domain socket or a multi-host
+     * connection string.
+     *
+     * @param ttl --- time to keep the resolved addresses.
+     * @return connection_info& --- the object itself.
+     */
+    connection_info& resolve_hosts(time_traits::duration ttl = std::chrono::seconds(60)) {
+        resolved_hosts = std::make_shared<detail::dns_cache>(ttl);
+        return *this;
+    }
+
+    /**
+     * @brief Cancel the query on the server when an operation time constraint expires
+     *
+     * By default the IO of an operation is cancelled on its time constraint expiration,
+     * so the connection is left in the middle of the query and can only be closed while
+     * the server keeps executing the query. With this option the cancel request is sent
+     * to the server and the operation is given the `grace` period to receive the error
+     * of the cancelled query. The operation completes with `boost::asio::error::timed_out`
+     * anyway, but the connection is usable then. IO is cancelled if the period expires.
+     *
+     * @param grace --- grace period, zero disables the server cancel.
+     * @return connection_info& --- the object itself.
+     */
+    connection_info& cancel_on_timeout(time_traits::duration grace = std::chrono::milliseconds(500)) {
+        cancel_grace = grace;
+        return *this;
+    }
+
+    /**
+     * @brief Send the time left to a request deadline as the query `statement_timeout`
+     *
+     * The server keeps executing a query after its client gives up on the time constraint
+     * expiration. With this option the remaining time of the request time constraint is set
+     * as the `statement_timeout` in the same pipeline right before the query, so the server
+     * stops the query on its own. The setting is local to the implicit transaction of the
+     * pipeline. Has no effect for queries within a transaction, prepared queries, requests
+     * without a time constraint or if libpq does not support pipeline mode.
+     *
+     * @param enable --- true to propagate the deadlines.
+     * @return connection_info& --- the object itself.
+     */
+    connection_info& propagate_deadline(bool enable = true) {
+        propagate_deadlines = enable;
+        return *this;
+    }
+
+    /**
+     * @brief Resolve the oids of the custom types on their first use
+     *
+     * By default the oids of all the custom types of the #OidMap are requested on connect,
+     * so each connection to a new server pays for the types most of its requests never
+     * use. With this option the connect does not request the oids and the request which
+     * parameters or output rows use custom types with unresolved oids resolves them with
+     * a single `to_regtype` query first, which is a part of the request and is limited by
+     * its time constraint. The array element types and the members of composites are
+     * resolved with their types. The oids are kept by the connection, the oid map cache
+     * of the object is not used.
+     *
+     * @param enable --- true to resolve the oids on the first use.
+     * @return connection_info& --- the object itself.
+     */
+    connection_info& lazy_oid_map(bool enable = true) {
+        lazy_oids = enable;
+        return *this;
+    }
+
+    /**
+     * @brief Limit the size of a request result
+     *
+     * A runaway query may return a result which takes gigabytes of memory, first in the
+     * libpq result and then in the output. With this option the data read from the server
+     * for the result of a request is counted while it is being received, and once it
+     * exceeds the limit the query is cancelled on the server and the request completes
+     * with the `ozo::error::result_too_large` error. The connection is left in the middle
+     * of the query then, see `connection_pool_config::recovery_timeout` to reuse it.
+     * Applies to the requests and executions, not to the streaming requests which keep
+     * a chunk of the result in memory only.
+     *
+     * @param bytes --- limit in bytes, zero disables the limit.
+     * @return connection_info& --- the object itself.
+     */
+    connection_info& max_result_size(std::size_t bytes) {
+        result_size_limit = bytes;
+        return *this;
+    }
+
+    /**
+     * @brief Spin waiting for the data of a request result
+     *
+     * A request waits for the data of its result via the `io_context`, which arms the
+     * socket readiness notification each time the result is not complete yet. For a query
+     * served in a few tens of microseconds, e.g. over a local socket, that costs more than
+     * the query itself. With this option the request checks the socket for the data in
+     * a loop for the given time first and waits via the `io_context` only if the data
+     * has not arrived by then. The thread is busy for the spin time, so use it with
+     * dedicated threads and cores only.
+     *
+     * On Linux `SO_BUSY_POLL` socket option may be set to the spin time as well, so the
+     * kernel polls the network device for the socket data instead of waiting for
+     * the interrupt. Values above `net.core.busy_read` require `CAP_NET_ADMIN`, without
+     * it the option is not set.
+     *
+     * @param time --- spin time, zero disables the busy polling.
+     * @param socket_busy_poll --- set `SO_BUSY_POLL` socket option.
+     * @return connection_info& --- the object itself.
+     */
+    connection_info& busy_poll(time_traits::duration time, bool socket_busy_poll = false) {
+        busy_poll_time = time;
+        this->socket_busy_poll = socket_busy_poll;
+        return *this;
+    }
+
+    /**
+     * @brief Set options on the sockets of the connections
+     *
+     * The options are set on the socket right after the connection is made by libpq,
+     * e.g. larger receive buffers improve throughput of bulk reads across datacenters:
+     *
+     * @code
+ozo::socket_options options;
+options.receive_buffer_size = 4 * 1024 * 1024;
+auto conn_info = ozo::connection_info(conn_str).socket_options(options);
+     * @endcode
+     *
+     * @param options --- socket options, see `ozo::socket_options`.
+     * @return connection_info& --- the object itself.
+     */
+    connection_info& socket_options(const ozo::socket_options& options) {
+        socket_opts = options;
+        return *this;
+    }
+
+    /**
+     * @brief Set SSL options of the connections
+     *
+     * The options are set as the parameters of the connection string, e.g. direct SSL
+     * negotiation saves the SSLRequest round trip on each connect, which matters for the
+     * reconnects to a distant server after a failover:
+     *
+     * @code
+ozo::ssl_options options;
+options.mode = ozo::ssl_mode::verify_full;
+options.negotiation = ozo::ssl_negotiation::direct;
+auto conn_info = ozo::connection_info(conn_str).ssl_options(options);
+     * @endcode
+     *
+     * Applies to the hosts of `race_hosts()` as well. Has no effect for a connection string
+     * which can not be parsed, its connect fails anyway.
+     *
+     * @param options --- SSL options, see `ozo::ssl_options`.
+     * @return connection_info& --- the object itself.
+     * @throws std::invalid_argument --- direct negotiation is requested with a mode weaker than `ozo::ssl_mode::require`.
+     */
+    connection_info& ssl_options(const ozo::ssl_options& options) {
+        detail::check_ssl_options(options);
+        if (!conn_params) {
+            return *this;
+        }
+        auto params = *conn_params;
+        for (auto& [keyword, value] : detail::get_ssl_parameters(options)) {
+            params.set(keyword, std::move(value));
+        }
+        conn_str = impl::make_conninfo(params);
+        conn_params = std::make_shared<const impl::connection_params>(std::move(params));
+        if (hosts_conn_strs) {
+            race_hosts(hosts_stagger);
+        }
+        return *this;
+    }
+
+#ifdef LIBPQ_HAS_PIPELINING
+    /**
+     * @brief Execute session setup statements on connect
+     *
+     * Session settings like `search_path`, `TimeZone`, `application_name` or `work_mem`
+     * are usually set by the statements a user runs right after the connection is made,
+     * which costs a round trip per statement on top of the connect and the oid map
+     * request. With this option the statements are sent on connect in one pipeline with
+     * the oid map request, so a new connection is ready after a single round trip:
+     *
+     * @code
+auto conn_info = ozo::connection_info(conn_str, oid_map).session_setup({
+    "SET search_path TO app, public",
+    "SET application_name TO 'billing'",
+});
+     * @endcode
+     *
+     * The statements are executed without parameters in the order given within
+     * the implicit transaction of the pipeline, so use `SET` rather than `SET LOCAL`.
+     * An error of a statement fails the connect. Requires libpq 14 pipeline mode.
+     *
+     * @param statements --- statements to execute, an empty list disables the option.
+     * @return connection_info& --- the object itself.
+     */
+    connection_info& session_setup(std::vector<std::string> statements) {
+        session_statements.reset();
+        if (!statements.empty()) {
+            session_statements = std::make_shared<const std::vector<std::string>>(std::move(statements));
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Prepare the most frequently used statements on connect
+     *
+     * With the prepared statements (see `ozo::prepared()`) a newly opened connection still
+     * pays a Parse for each statement on the first request which uses it, and after a failover
+     * or a connection pool growth all these requests land on the fresh connections. With this
+     * option the connections made by the object and its copies, e.g. by a connection pool, count
+     * the executions of their prepared statements, and a new connection prepares the `count` most
+     * frequently used ones on connect in one pipeline with the session setup and the oid map request,
+     * so it is handed out with the statements cached:
+     *
+     * @code
+auto conn_info = ozo::connection_info(conn_str, oid_map).warm_statements(16);
+     * @endcode
+     *
+     * A statement which can not be prepared any more, e.g. its table has been dropped, does not
+     * fail the connect, it and the statements after it are just left to be prepared on use.
+     * Requires libpq 14 pipeline mode.
+     *
+     * @param count --- number of the statements to prepare, zero disables the option.
+     * @return connection_info& --- the object itself.
+     */
+    connection_info& warm_statements(std::size_t count) {
+        hot_statements.reset();
+        if (count != 0) {
+            hot_statements = std::make_shared<detail::hot_statements>(count);
+        }
+        return *this;
+    }
+#endif
+
+    /**
+     * @brief Forget the oid maps resolved for the servers
+     *
+     * The oids of the custom types will be requested again by the next connections,
+     * e.g. after the `ozo::error::oid_type_mismatch` error caused by the custom types
+     * which have been recreated on a server.
+     */
+    void invalidate_oid_map() const {
+        oid_maps->clear();
+    }
+
+    /**
+     * @brief Export the state of the connections to hand it off to the next process
+     *
+     * A restart, e.g. a deploy, replaces all the connections of a process, and the first requests
+     * of the next process wait for the connects, the oid map requests and the prepares of their
+     * statements. The connections themselves can not be handed off: libpq has no means to adopt
+     * an established connection, and the TLS session can not leave the process. So the previous
+     * process exports the state the connections are made of: the oid maps resolved for the servers
+     * and the hot statements (see `warm_statements()`). The next process imports it, opens the
+     * connections in advance with `ozo::connection_pool::warm_up()` with no oid map requests and
+     * with the hot statements prepared, and only then takes the traffic over, e.g. via a listening
+     * socket passed along or `SO_REUSEPORT`. The state is a byte string to be sent over a Unix socket
+     * or a pipe:
+     *
+     * @code
+// The previous process, on the request of the next one
+asio::local::stream_protocol::socket socket(io);
+acceptor.accept(socket);
+const auto state = conn_info.export_state();
+const std::uint64_t size = state.size();
+asio::write(socket, std::array{asio::buffer(&size, sizeof(size)), asio::buffer(state)});
+
+// The next process
+asio::local::stream_protocol::socket socket(io);
+socket.connect(handoff_path);
+std::uint64_t size = 0;
+asio::read(socket, asio::buffer(&size, sizeof(size)));
+std::string state(size, '\0');
+asio::read(socket, asio::buffer(state));
+conn_info.import_state(state);
+ozo::connection_pool pool(conn_info, config);
+pool.warm_up(io, 5s, yield);
+     * @endcode
+     *
+     * The state is shared by the copies of the object, e.g. by the source of a connection pool.
+     *
+     * @return std::string --- the state, see `import_state()`.
+     */
+    std::string export_state() const {
+        return detail::export_state(*oid_maps, hot_statements.get());
+    }
+
+    /**
+     * @brief Import the state of the connections exported by the previous process
+     *
+     * The oid maps are used by the next connections to the same servers, an oid map is skipped
+     * if the previous process has not resolved any of the types of the #OidMap. The hot statements
+     * are imported with their usage if the statements are warmed up, see `warm_statements()`.
+     * See `export_state()` for the details.
+     *
+     * @param state --- state made by `export_state()`.
+     * @return connection_info& --- the object itself.
+     * @throws std::invalid_argument if the state is malformed, the records before the malformed one are imported.
+     */
+    connection_info& import_state(std::string_view state) {
+        detail::import_state(state, *oid_maps, hot_statements.get());
+        return *this;
     }
 
     auto operator [](io_context& io) const & {
@@ -122,6 +526,10 @@ inline auto make_connection_info(std::string conn_str, const OidMap& oid_map = O
     return connection_info{std::move(conn_str), oid_map, statistics};
 }
 
+#ifdef OZO_EXTERN_TEMPLATES
+extern template class connection_info<empty_oid_map, no_statistics>;
+#endif
+
 static_assert(ConnectionProvider<decltype(std::declval<connection_info<>>()[std::declval<io_context&>()])>, "is not a ConnectionProvider");
 
 } // namespace ozo
@@ -2,13 +2,30 @@
 
 #include <ozo/connection_info.h>
 #include <ozo/transaction_status.h>
+#include <ozo/error_context.h>
 #include <ozo/asio.h>
 #include <ozo/connector.h>
+#include <ozo/core/histogram.h>
 #include <ozo/core/thread_safety.h>
+#include <ozo/ext/boost/intrusive_ptr.h>
 #include <ozo/detail/connection_pool.h>
+#include <ozo/connection_budget.h>
+#include <ozo/detail/connect_throttle.h>
+#include <ozo/detail/deadline_queue.h>
 
 namespace ozo {
 
+/**
+ * @brief Connection pool request priority class
+ * @ingroup group-connection-types
+ *
+ * Settings of a class of requests with the same priority, see `connection_pool_config::priority_classes`.
+ */
+struct connection_pool_priority_class {
+    std::size_t queue_capacity = 128; //!< maximum number of queued requests of the class
+    std::size_t reserved = 0; //!< number of connections which only requests of the class may take
+};
+
 /**
  * @brief Connection pool configuration
  * @ingroup group-connection-types
@@ -22,6 +39,57 @@ struct connection_pool_config {
     std::size_t queue_capacity = 128; //!< maximum number of queued requests to get available connection
     time_traits::duration idle_timeout = std::chrono::seconds(60); //!< time interval to close connection after last usage
     time_traits::duration lifespan = std::chrono::hours(24); //!< time interval to keep connection open
+    std::size_t shards = 1; //!< number of sub-pools each serving its own `io_context`, e.g. one per IO thread; capacity and queue capacity are split between them
+    std::size_t min_idle = 0; //!< number of connections to be opened in advance and kept open by `connection_pool::warm_up()`
+    std::size_t max_connecting = 0; //!< maximum number of concurrent connection attempts, requests beyond it wait for a running attempt to complete; 0 means unlimited
+    time_traits::duration busy_poll = time_traits::duration::zero(); //!< time to spin waiting for the data of a request result, see `pooled_connection::busy_poll()`; zero disables the busy polling
+    time_traits::duration connect_backoff = time_traits::duration::zero(); //!< delay of connection attempts after a failed one, doubles with each consecutive failure; zero disables the backoff
+    time_traits::duration max_connect_backoff = std::chrono::seconds(10); //!< maximum delay of connection attempts after consecutive failures
+    time_traits::duration lifespan_jitter = time_traits::duration::zero(); //!< maximum random reduction of `lifespan` of each connection, so connections opened together do not expire together
+    time_traits::duration refresh_ahead = time_traits::duration::zero(); //!< interval before the connection expiration when `connection_pool::refresh()` replaces the idle connection; zero disables the refresh
+    time_traits::duration recovery_timeout = time_traits::duration::zero(); //!< time to recover a connection released in the middle of a request or a transaction, see `pooled_connection`; zero disables the recovery, so such connections are closed
+    time_traits::duration cancel_on_timeout = time_traits::duration::zero(); //!< grace period for an operation to complete after the server cancel request sent on its time constraint expiration, see `pooled_connection::cancel_on_timeout()`; zero disables the server cancel
+    bool propagate_deadline = false; //!< send the time left to the request deadline as the query `statement_timeout`, see `pooled_connection::propagate_deadline()`
+    std::size_t max_result_size = 0; //!< limit of the data read for the result of a request, see `pooled_connection::max_result_size()`; 0 means unlimited
+    bool order_by_deadline = false; //!< serve the waiting requests in the order of their deadlines instead of the arrival order and complete a waiting request as soon as its deadline expires, see `connection_pool`
+    std::vector<connection_pool_priority_class> priority_classes; //!< request priority classes, the first one has the highest priority, see `connection_pool::operator()`; `queue_capacity` is not used with the classes; empty disables the priorities
+    bool check_idle = false; //!< verify idle connections in `connection_pool::refresh()` by consuming the data pending on their sockets and replace the dead ones
+    std::size_t max_capacity = 0; //!< maximum capacity set at runtime, see `connection_pool::set_capacity()`; the underlying pool is created with it; 0 means the capacity is fixed
+    std::size_t min_capacity = 1; //!< minimum capacity set at runtime, see `max_capacity`
+    time_traits::duration target_wait_time = std::chrono::milliseconds(5); //!< 90th percentile of the time to get a connection from the pool above which `connection_pool::adapt_capacity()` grows the capacity
+    bool io_affinity = false; //!< keep the socket of an idle connection registered with the `io_context` which has used it last, so it is not registered anew when the context takes the connection again; the pool must be destroyed before the `io_context` objects, see `connection_pool`
+    bool lifo = false; //!< reuse the most recently used idle connection first, so the surplus idle connections reach `idle_timeout` and are closed, see `connection_pool`
+    bool direct_handoff = false; //!< hand a released connection directly to a request waiting for it instead of returning it to the underlying pool, see `connection_pool`; requires `lifo`
+    std::size_t max_requests_per_connection = 0; //!< number of requests after which a connection is recycled, see `connection_pool`; 0 means unlimited
+    std::size_t max_backend_memory = 0; //!< backend memory in bytes above which a connection is recycled, checked by `connection_pool::refresh()` via `pg_backend_memory_contexts` (PostgreSQL 14+); 0 disables the check
+    time_traits::duration backend_memory_check_interval = std::chrono::minutes(5); //!< minimum interval between the backend memory checks of a connection
+    connection_budget budget; //!< budget of connections shared with other pools, see `ozo::connection_budget`; empty does not limit the connections
+    std::size_t budget_guarantee = 0; //!< number of connections of the budget guaranteed to the pool
+};
+
+/**
+ * @brief Connection pool metrics
+ * @ingroup group-connection-types
+ *
+ * Snapshot of counters of the `ozo::connection_pool` events since the pool creation,
+ * returned by `connection_pool::metrics()`. The counters are collected without locks
+ * and may be read from any thread; the values of different counters are not
+ * synchronized with each other.
+ */
+struct connection_pool_metrics {
+    std::uint64_t acquisitions = 0; //!< number of requests for a connection
+    std::uint64_t reused = 0; //!< number of requests served by an idle connection of the pool
+    std::uint64_t created = 0; //!< number of connections established for requests
+    std::uint64_t connect_errors = 0; //!< number of failed attempts to establish a connection
+    std::uint64_t closed_bad = 0; //!< number of idle connections found bad and replaced with new ones
+    std::uint64_t expired = 0; //!< number of idle connections found expired and replaced with new ones
+    std::uint64_t refreshed = 0; //!< number of idle connections replaced by `connection_pool::refresh()` before their expiration
+    std::uint64_t recycled = 0; //!< number of connections replaced after `connection_pool_config::max_requests_per_connection` requests or due to the backend memory
+    std::uint64_t queue_overflows = 0; //!< number of requests rejected since the wait queue was full
+    std::uint64_t queue_timeouts = 0; //!< number of requests timed out in the wait queue
+    std::uint64_t budget_rejections = 0; //!< number of requests rejected since there was no `connection_pool_config::budget` left for a new connection
+    std::uint64_t waiting = 0; //!< number of requests currently waiting for a connection from the pool
+    latency_histogram wait_time; //!< distribution of time to get a connection from the pool, without time to establish a new one
 };
 
 /**
@@ -56,7 +124,7 @@ public:
     using oid_map_type = OidMap;
     using native_handle_type = typename ozo::pg::conn::pointer;
     using statistics_type = Statistics;
-    using error_context_type = std::string;
+    using error_context_type = ozo::error_context;
 
     const ozo::pg::conn& safe_native_handle() const & {return safe_handle_;}
     ozo::pg::conn& safe_native_handle() & {return safe_handle_;}
@@ -78,6 +146,43 @@ public:
         error_context_ = std::move(v);
     }
 
+    detail::statement_cache& statement_cache() & noexcept { return statement_cache_;}
+
+    const std::shared_ptr<detail::hot_statements>& hot_statements() const & noexcept { return hot_statements_;}
+    void set_hot_statements(std::shared_ptr<detail::hot_statements> v) noexcept { hot_statements_ = std::move(v);}
+
+    detail::session_settings& session_settings() & noexcept { return session_settings_;}
+    const detail::session_settings& session_settings() const & noexcept { return session_settings_;}
+
+    pg::shared_cancel native_cancel_handle() const {
+        if (!safe_handle_) {
+            cancel_handle_.reset();
+        } else if (!cancel_handle_) {
+            cancel_handle_ = pg::make_safe(PQgetCancel(safe_handle_.get()));
+        }
+        return cancel_handle_;
+    }
+
+    time_traits::time_point expires_at() const noexcept { return expires_at_;}
+    void set_expires_at(time_traits::time_point v) noexcept { expires_at_ = v;}
+
+    std::size_t requests() const noexcept { return requests_;}
+    void count_request() noexcept { ++requests_;}
+
+    bool recycle_requested() const noexcept { return recycle_requested_;}
+    void request_recycle() noexcept { recycle_requested_ = true;}
+
+    time_traits::time_point memory_checked_at() const noexcept { return memory_checked_at_;}
+    void set_memory_checked_at(time_traits::time_point v) noexcept { memory_checked_at_ = v;}
+
+    detail::registered_stream& registered_stream() & noexcept { return registered_stream_;}
+
+    /**
+     * Share of `ozo::connection_budget` held until the connection is closed.
+     */
+    void hold_budget(std::shared_ptr<void> v) noexcept { budget_ = std::move(v);}
+    std::shared_ptr<void> release_budget() noexcept { return std::move(budget_);}
+
     connection_rep(
         ozo::pg::conn&& safe_handle,
         OidMap oid_map = OidMap{},
@@ -88,12 +193,41 @@ public:
       error_context_(std::move(error_context)),
       statistics_(std::move(statistics)) {}
 private:
+    std::shared_ptr<void> budget_; // released after the connection is closed
     ozo::pg::conn safe_handle_;
     oid_map_type oid_map_;
     error_context_type error_context_;
     statistics_type statistics_;
+    detail::statement_cache statement_cache_;
+    std::shared_ptr<detail::hot_statements> hot_statements_;
+    detail::session_settings session_settings_;
+    mutable pg::shared_cancel cancel_handle_;
+    time_traits::time_point expires_at_ = time_traits::time_point::max();
+    std::size_t requests_ = 0;
+    bool recycle_requested_ = false;
+    time_traits::time_point memory_checked_at_ = time_traits::now();
+    detail::registered_stream registered_stream_; // released before the connection is closed
 };
 
+namespace detail {
+
+template <typename Rep, typename Stream, typename = std::void_t<>>
+struct has_registered_stream_impl : std::false_type {};
+
+template <typename Rep, typename Stream>
+struct has_registered_stream_impl<Rep, Stream,
+        std::void_t<decltype(ozo::unwrap(std::declval<Rep&>()).registered_stream())>>
+    : std::is_same<Stream, registered_stream::stream_type> {};
+
+/**
+ * Whether the connection representation keeps the registered socket of an idle connection,
+ * see `connection_pool_config::io_affinity`.
+ */
+template <typename Rep, typename Stream>
+constexpr bool has_registered_stream = has_registered_stream_impl<Rep, Stream>::value;
+
+} // namespace detail
+
 /**
  * @brief Pool bound model for `Connection` concept
  *
@@ -102,18 +236,26 @@ private:
  * underlying handle that contains a connection will be returned to the handle-associated
  * connection pool. If the connection is in a bad state either its current transaction
  * status is different than `ozo::transaction_status::idle` then it will not return to
- * the pool and be closed. The class object is non-copyable.
+ * the pool and be closed. With non-zero recovery timeout a good connection in the middle
+ * of a request or a transaction is recovered asynchronously instead: the running query is
+ * cancelled, its results are drained and the transaction is rolled back, then the connection
+ * returns to the pool. It is closed only if the recovery fails or exceeds the timeout.
+ * The class object is non-copyable.
  *
  * @tparam Rep      --- underlying connection pool representation for the real connection.
  * @tparam Executor --- the type of the executor is used to perform IO; currently only
  *                      `boost::asio::io_context::executor_type` is supported.
+ * @tparam ThreadSafety --- thread safety of the pool the connection is obtained from; operations on
+ *                      the connection are not serialized with a strand and it is counted by a non-atomic
+ *                      intrusive counter if it is `ozo::thread_safety<false>`.
  *
  * @thread_safety{Safe,Unsafe}
  * @ingroup group-connection-types
  * @models{Connection}
  */
-template <typename Rep, typename Executor = asio::io_context::executor_type>
-class pooled_connection {
+template <typename Rep, typename Executor = asio::io_context::executor_type,
+          typename ThreadSafety = std::decay_t<decltype(thread_safe)>>
+class pooled_connection : public detail::pooled_connection_ref_counter<pooled_connection<Rep, Executor, ThreadSafety>, ThreadSafety> {
 public:
     using rep_type = Rep; //!< Connection representation type
     using native_handle_type = typename connection_traits<rep_type>::native_handle_type; //!< Native connection handle type
@@ -121,8 +263,11 @@ public:
     using error_context_type = typename connection_traits<rep_type>::error_context_type; //!< Additional error context which could provide context depended information for errors
     using statistics_type = typename connection_traits<rep_type>::statistics_type; //!< Connection statistics to be collected
     using executor_type = Executor; //!< The type of the executor associated with the object.
+    using thread_safety_type = ThreadSafety; //!< Thread safety of the pool, see `ozo::get_connection_thread_safety`
+    using idle_stack_type = detail::idle_stack_t<Rep, ThreadSafety>; //!< Idle connections of the pool kept in the most recently used order
 
-    pooled_connection(const Executor& ex, Rep&& rep);
+    pooled_connection(const Executor& ex, Rep&& rep, const detail::pooled_connection_options& options = {},
+        std::shared_ptr<void> slot = {}, std::shared_ptr<idle_stack_type> idle = {});
 
     /**
      * Get native connection handle object.
@@ -143,7 +288,7 @@ public:
 
     template <typename Key, typename Value>
     void update_statistics(const Key& key, Value&& v) noexcept {
-        ozo::unwrap(rep_).update_statistics(key, std::forward<Value(v)>);
+        ozo::unwrap(rep_).update_statistics(key, std::forward<Value>(v));
     }
     const statistics_type& statistics() const noexcept { return ozo::unwrap(rep_).statistics();}
 
@@ -166,6 +311,51 @@ public:
         ozo::unwrap(rep_).set_error_context(std::move(v));
     }
 
+    /**
+     * Get the cache of statements prepared on the connection. The cache is kept
+     * with the connection in the pool and is cleared when the connection is closed.
+     *
+     * @return detail::statement_cache& --- reference on the cache of prepared statements.
+     */
+    detail::statement_cache& statement_cache() noexcept {
+        return ozo::unwrap(rep_).statement_cache();
+    }
+
+    /**
+     * Get the most frequently used prepared statements of the connections of the pool, see
+     * `ozo::connection_info::warm_statements()`.
+     *
+     * @return pointer to the statements or null if the statements are not warmed up.
+     */
+    const std::shared_ptr<detail::hot_statements>& hot_statements() const noexcept {
+        return ozo::unwrap(rep_).hot_statements();
+    }
+
+    /**
+     * Get the session parameters set by `ozo::ensure_settings()` on the connection. The
+     * parameters are kept with the connection in the pool and are cleared when the
+     * connection is closed.
+     *
+     * @return detail::session_settings& --- reference on the parameters set.
+     */
+    detail::session_settings& session_settings() noexcept {
+        return ozo::unwrap(rep_).session_settings();
+    }
+
+    const detail::session_settings& session_settings() const noexcept {
+        return ozo::unwrap(rep_).session_settings();
+    }
+
+    /**
+     * Get the native handle for the cancel operation. The handle is cached by the
+     * connection kept in the pool, see `ozo::connection::native_cancel_handle()`.
+     *
+     * @return pg::shared_cancel --- cancel handle, null if the connection is closed.
+     */
+    pg::shared_cancel native_cancel_handle() const {
+        return ozo::unwrap(rep_).native_cancel_handle();
+    }
+
     /**
      * Get the executor associated with the object.
      *
@@ -247,13 +437,61 @@ public:
      */
     bool is_open() const noexcept { return native_handle() != nullptr;}
 
+    /**
+     * Get the grace period of an operation after its time constraint expiration. If it is
+     * non-zero the cancel request is sent to the server on the expiration and the operation
+     * is given the period to receive the error of the cancelled query, so the connection is
+     * left in a usable state instead of the cancelled IO. IO is cancelled if the period expires.
+     *
+     * @return time_traits::duration --- grace period, zero if the server cancel is disabled.
+     */
+    time_traits::duration cancel_on_timeout() const noexcept { return options_.cancel_on_timeout;}
+
+    /**
+     * Determine whether the time left to the deadline of a request is sent to the server
+     * as the `statement_timeout` of the query. The timeout is not set for a query within
+     * a transaction.
+     *
+     * @return true --- the deadline is propagated to the server.
+     * @return false --- the deadline is handled by the client only.
+     */
+    bool propagate_deadline() const noexcept { return options_.propagate_deadline;}
+
+    /**
+     * Get the limit of the data read from the server for the result of a request. A request
+     * which result exceeds the limit is cancelled on the server and completes with the
+     * `ozo::error::result_too_large` error, then the connection is recovered if the recovery
+     * is enabled.
+     *
+     * @return std::size_t --- limit in bytes, zero if the result size is not limited.
+     */
+    std::size_t max_result_size() const noexcept { return options_.max_result_size;}
+
+    /**
+     * Get the time to spin waiting for the data of a request result before waiting
+     * for the socket readiness via the `io_context`, see `connection_info::busy_poll()`.
+     *
+     * @return time_traits::duration --- spin time, zero if the busy polling is disabled.
+     */
+    time_traits::duration busy_poll() const noexcept { return options_.busy_poll;}
+
     ~pooled_connection();
 private:
     using stream_type = typename detail::connection_stream<executor_type>::type;
 
+    template <typename NativeHandle>
+    bool take_registered_stream(NativeHandle fd);
+
+    bool keeps_registered_stream() const noexcept;
+
+    void put_registered_stream();
+
+    std::shared_ptr<void> slot_; // admission of the pool deadline queue, released after the connection is returned
+    std::shared_ptr<idle_stack_type> idle_; // the connection is returned here instead of the pool, see connection_pool_config::lifo
     rep_type rep_;
     executor_type ex_;
     stream_type stream_;
+    detail::pooled_connection_options options_;
 };
 
 template <typename ...Ts>
@@ -279,11 +517,69 @@ struct connection_traits<yamail::resource_pool::handle<T>> :
  *
  * The request may be limited by time via optional `connection_pool_timeouts` argument of the `connection_pool::operator()`.
  *
+ * When the database restarts every waiting request creates a new connection at once, which overloads the
+ * server. `connection_pool_config::max_connecting` limits the number of concurrent connection attempts, the
+ * requests beyond it wait for a running attempt to complete within their time constraint, and
+ * `connection_pool_config::connect_backoff` delays the attempts after failures.
+ *
+ * Several pools of a process may share `connection_pool_config::budget`, so their total number of connections
+ * is bounded, each pool has `connection_pool_config::budget_guarantee` connections guaranteed and borrows the rest
+ * of the budget while it is free. A request which needs a new connection when there is no budget left completes
+ * with `ozo::error::connection_budget_exhausted`, see `ozo::connection_budget`.
+ *
+ * With `connection_pool_config::shards` greater than one the pool consists of independent sub-pools,
+ * each of which serves requests from its own `io_context`. A connection is provided from the sub-pool of
+ * the requesting `io_context`, or from another sub-pool with a free connection if there is no free connection
+ * and no room to create a new one in the own sub-pool. So IO threads do not contend with each other for the pool.
+ *
+ * The requests wait in the queue in the arrival order. With `connection_pool_config::order_by_deadline` the
+ * requests are admitted to the pool in the order of their deadlines, so a request with a short deadline does
+ * not wait behind the ones which may wait longer, and a request is completed with the timeout as soon as its
+ * deadline expires in the queue. In any case a request which deadline has expired by the time a connection
+ * is available for it is completed with the timeout and the connection stays in the pool.
+ *
+ * The idle connections are reused in the order of the underlying pool, which keeps all of them in use under
+ * a steady load, so none of them reaches `connection_pool_config::idle_timeout`. With `connection_pool_config::lifo`
+ * the released connections are kept in a stack of the sub-pool and a request takes the most recently used one,
+ * which has the warm caches, so the rest are left idle and closed after the idle timeout. A released connection
+ * is returned to the underlying pool instead if there are requests waiting there. `refresh()` returns the
+ * connections of the stack to the underlying pool before it checks them.
+ *
+ * With `connection_pool_config::direct_handoff` in addition to `connection_pool_config::lifo` a request which
+ * finds the sub-pool exhausted waits in the stack, and the releasing thread hands its connection to the waiting
+ * request with the earliest deadline under the lock of the stack, so the connection does not pass through
+ * the queue of the underlying pool. The requests waiting in the stack are limited by the queue capacity of
+ * the sub-pool, the rest wait in the underlying pool.
+ *
+ * A long-lived backend grows its memory with cached plans and catalog caches. With
+ * `connection_pool_config::max_requests_per_connection` a connection is recycled after the number of requests;
+ * `refresh()` replaces an idle connection in the background once it has served nine tenths of them, and a request
+ * which gets an exhausted connection anyway replaces it in place. With `connection_pool_config::max_backend_memory`
+ * `refresh()` samples the memory of the backend of an idle connection via `pg_backend_memory_contexts` once in
+ * `connection_pool_config::backend_memory_check_interval`, and a connection above the threshold is replaced by the
+ * next refresh. The check requires PostgreSQL 14 or later, a failed check is ignored.
+ *
+ * The socket of a connection is registered with the reactor of the requesting `io_context` on each checkout
+ * and deregistered when the connection returns to the pool. With `connection_pool_config::io_affinity` the socket
+ * of an idle connection stays registered, so a request from the same `io_context`, e.g. the one served by its own
+ * sub-pool with `connection_pool_config::shards`, takes the connection with no system calls. A request from another
+ * `io_context` migrates the socket to its reactor. Since the idle sockets refer to the reactors, the pool must be
+ * destroyed before the `io_context` objects which use it.
+ *
+ * With `connection_pool_config::max_capacity` set the capacity may be changed at runtime between
+ * `connection_pool_config::min_capacity` and `connection_pool_config::max_capacity` by `set_capacity()`, or adapted
+ * to the load by `adapt_capacity()`, which `start_maintenance()` calls each round. The requests are admitted
+ * to the pool up to the current capacity and wait in the queue beyond it; no connection is dropped when the
+ * capacity shrinks, the surplus ones are closed after `connection_pool_config::idle_timeout`, so use it with
+ * `connection_pool_config::lifo`.
+ *
  * `connection_pool` models `ConnectionSource` concept itself using underlying `ConnectionSource`.
  *
  * @tparam Source --- underlying `ConnectionSource` which is being used to create connection to a database.
  * @tparam ThreadSafety --- admissibility to use in multithreaded environment without additional synchronization.
- * Thread safe by default.
+ * Thread safe by default. The operations on the connections of a pool which is not thread safe are executed
+ * without a strand, so the pool and its `io_context` objects should be used by a single thread. Its connections
+ * are `boost::intrusive_ptr` with a non-atomic reference counter instead of `std::shared_ptr`.
  *
  * ###Example
  *
@@ -315,13 +611,48 @@ public:
      * Thread safe by default (`ozo::thread_safety<true>`).
      */
     connection_pool(Source source, const connection_pool_config& config, const ThreadSafety& /*thread_safety*/ = ThreadSafety{})
-    : impl_(config.capacity, config.queue_capacity, config.idle_timeout, config.lifespan),
-      source_(std::move(source)) {}
+    : impl_(config.shards, std::max(config.capacity, config.max_capacity), config.queue_capacity,
+          config.idle_timeout, config.lifespan),
+      counters_(std::make_unique<detail::connection_pool_counters[]>(impl_.size())),
+      throttle_(std::make_unique<throttle_type>(config.max_connecting, config.connect_backoff, config.max_connect_backoff)),
+      lifespan_{config.lifespan, config.lifespan_jitter, config.refresh_ahead, config.max_requests_per_connection,
+          config.max_backend_memory, config.backend_memory_check_interval},
+      connection_options_{config.recovery_timeout, config.cancel_on_timeout, config.propagate_deadline,
+          config.max_result_size, config.busy_poll, config.io_affinity},
+      source_(std::move(source)),
+      min_idle_(std::min(config.min_idle, config.capacity)),
+      check_idle_(config.check_idle),
+      direct_handoff_(config.lifo && config.direct_handoff),
+      capacity_(std::make_unique<detail::pool_capacity>(make_capacity_adapter(config), config.capacity)),
+      budget_(config.budget.join(config.budget_guarantee)) {
+        if (config.order_by_deadline || !config.priority_classes.empty() || capacity_->adjustable()) {
+            deadline_queues_.reserve(impl_.size());
+            for (std::size_t i = 0; i < impl_.size(); ++i) {
+                std::vector<detail::deadline_queue_class> classes;
+                for (const auto& c : config.priority_classes) {
+                    classes.push_back({impl_.share(c.queue_capacity, i), impl_.share(c.reserved, i)});
+                }
+                if (classes.empty()) {
+                    classes.push_back({impl_.share(config.queue_capacity, i), 0});
+                }
+                deadline_queues_.push_back(std::make_shared<deadline_queue_type>(
+                    shard_capacity(config.capacity, i), classes, config.order_by_deadline));
+            }
+        }
+        if (config.lifo) {
+            idle_stacks_.reserve(impl_.size());
+            for (std::size_t i = 0; i < impl_.size(); ++i) {
+                idle_stacks_.push_back(std::make_shared<idle_stack_type>(impl_[i], config.idle_timeout,
+                    config.direct_handoff ? impl_.share(config.queue_capacity, i) : 0));
+            }
+        }
+    }
 
     /**
      * Type of connection depends on connection type of Source. The definition is used to model `ConnectionSource`
      */
-    using connection_type = std::shared_ptr<pooled_connection<yamail::resource_pool::handle<connection_rep_type>>>;
+    using connection_type = detail::get_pooled_connection_ptr_t<pooled_connection<yamail::resource_pool::handle<connection_rep_type>,
+        asio::io_context::executor_type, ThreadSafety>, ThreadSafety>;
 
     /**
      * Get connection is bound to the given `io_context` object.
@@ -336,30 +667,252 @@ public:
     template <typename TimeConstraint, typename Handler>
     void operator ()(io_context& io, TimeConstraint t, Handler&& handler);
 
+    /**
+     * Get connection is bound to the given `io_context` object for a request of the given
+     * priority class, see `connection_pool_config::priority_classes`. The requests of a class
+     * wait in its own queue and are served before the waiting requests of the classes with
+     * lower priority. The priority is ignored if there are no classes configured; the priority
+     * beyond the number of classes means the last class. Requests without the priority belong
+     * to the first class.
+     *
+     * @param io --- `io_context` for the connection IO.
+     * @param t --- operation time constraint.
+     * @param handler --- #Handler.
+     * @param priority --- index of the priority class.
+     */
+    template <typename TimeConstraint, typename Handler>
+    void operator ()(io_context& io, TimeConstraint t, Handler&& handler, std::size_t priority);
+
+    /**
+     * Open `connection_pool_config::min_idle` connections in parallel and put them
+     * into the pool, so the first requests do not wait for connection establishing.
+     * Idle connections of the pool are reused and this renews their idle time, so
+     * calling the operation periodically with an interval less than
+     * `connection_pool_config::idle_timeout` keeps the pool from closing them.
+     * With several shards the connections are spread between them.
+     *
+     * The operation completes with the first error occurred when all the connection
+     * attempts are complete.
+     *
+     * @param io --- `io_context` for the connections IO.
+     * @param t --- time constraint for each connection attempt.
+     * @param token --- operation #CompletionToken with `void(ozo::error_code)` signature.
+     * @return deduced from #CompletionToken.
+     */
+    template <typename TimeConstraint, typename CompletionToken>
+    decltype(auto) warm_up(io_context& io, TimeConstraint t, CompletionToken&& token);
+
+    /**
+     * Time constrain free shortcut to `warm_up(io, ozo::none, token)`.
+     */
+    template <typename CompletionToken>
+    decltype(auto) warm_up(io_context& io, CompletionToken&& token) {
+        return warm_up(io, none, std::forward<CompletionToken>(token));
+    }
+
+    /**
+     * Replace the idle connections of the pool which are due for the refresh, i.e. will
+     * expire within `connection_pool_config::refresh_ahead`, or are bad, with new ones.
+     * The idle connections are taken from the pool for the time of the operation, so
+     * requests do not get a connection which is being replaced, and then returned back.
+     * With `connection_pool_config::lifo` the operation returns the connections of the stack
+     * to the underlying pool first, so they are checked too.
+     * Call the operation periodically, e.g. by a timer, with an interval less than
+     * `connection_pool_config::refresh_ahead`, so the connections are replaced in the
+     * background before requests pick up the expired ones.
+     *
+     * The operation completes with the first error occurred when all the connections
+     * are processed.
+     *
+     * @param io --- `io_context` for the connections IO.
+     * @param t --- time constraint for each connection attempt.
+     * @param token --- operation #CompletionToken with `void(ozo::error_code)` signature.
+     * @return deduced from #CompletionToken.
+     */
+    template <typename TimeConstraint, typename CompletionToken>
+    decltype(auto) refresh(io_context& io, TimeConstraint t, CompletionToken&& token);
+
+    /**
+     * Time constrain free shortcut to `refresh(io, ozo::none, token)`.
+     */
+    template <typename CompletionToken>
+    decltype(auto) refresh(io_context& io, CompletionToken&& token) {
+        return refresh(io, none, std::forward<CompletionToken>(token));
+    }
+
+    /**
+     * Get the current capacity of the pool.
+     *
+     * @return std::size_t --- maximum number of connections the requests may use simultaneously.
+     */
+    std::size_t capacity() const noexcept { return capacity_->current.load(std::memory_order_relaxed);}
+
+    /**
+     * Change the capacity of the pool at runtime. The value is limited by `connection_pool_config::min_capacity`
+     * and `connection_pool_config::max_capacity`. The waiting requests are admitted at once if the capacity
+     * grows. No connection is dropped if it shrinks: the requests which use the connections beyond the new
+     * capacity complete as usual, and the connections left idle are closed after the idle timeout.
+     *
+     * @param capacity --- new capacity.
+     * @return std::size_t --- capacity set; the configured one if `connection_pool_config::max_capacity` is not set.
+     */
+    std::size_t set_capacity(std::size_t capacity);
+
+    /**
+     * Adapt the capacity to the load observed since the previous call. The capacity grows by a quarter
+     * if the requests have waited for a connection, i.e. some of them are waiting in the queue or the
+     * 90th percentile of the time to get a connection exceeds `connection_pool_config::target_wait_time`,
+     * and shrinks by one if less than a half of it has been in use at the peak. Call it periodically,
+     * e.g. via `start_maintenance()`.
+     *
+     * @return std::size_t --- new capacity.
+     */
+    std::size_t adapt_capacity();
+
+    /**
+     * Start the background task which calls `refresh()` with the given interval, so the
+     * idle connections are verified (if `connection_pool_config::check_idle` is set) and
+     * refreshed before requests get them. The task adapts the capacity with `adapt_capacity()`
+     * after each refresh if `connection_pool_config::max_capacity` is set. A running task is stopped first. The task runs
+     * until `stop_maintenance()` is called or the pool is destroyed; the pool must not be
+     * moved while the task runs.
+     *
+     * @param io --- `io_context` for the task timer and the connections IO.
+     * @param interval --- interval between the end of a refresh and the start of the next one.
+     * @param t --- time constraint for each connection attempt.
+     */
+    template <typename TimeConstraint = none_t>
+    void start_maintenance(io_context& io, time_traits::duration interval, TimeConstraint t = TimeConstraint{});
+
+    /**
+     * Stop the background task started by `start_maintenance()`. A refresh which is in
+     * progress is completed, but the next one is not started.
+     */
+    void stop_maintenance();
+
+    connection_pool(connection_pool&&) = default;
+    connection_pool& operator =(connection_pool&&) = default;
+
+    ~connection_pool() {
+        stop_maintenance();
+        for (auto& queue : deadline_queues_) {
+            queue->shutdown();
+        }
+        for (auto& stack : idle_stacks_) {
+            stack->shutdown();
+        }
+    }
+
     auto stats() const {
         return impl_.stats();
     }
 
+    /**
+     * Get snapshot of the pool metrics. Unlike `stats()` it does not lock the pool,
+     * so it may be called frequently from any thread.
+     *
+     * @return connection_pool_metrics --- metrics snapshot.
+     */
+    connection_pool_metrics metrics() const noexcept;
+
     auto operator [](io_context& io) {
         return connection_provider(*this, io);
     }
 
+    /**
+     * Bind the `io_context` to the given shard, see `connection_pool_config::shards`, so its requests
+     * are served by the shard instead of the one picked by the context address. If its shard is exhausted,
+     * the nearest shards are tried first, so with the contexts bound in the order of CPU cores a request
+     * falls back to a neighbouring core. Bind the contexts before the requests.
+     *
+     * @param io --- `io_context` to bind.
+     * @param shard --- index of the shard, less than the number of shards.
+     * @return `false` if the shard does not exist or is bound to another `io_context`.
+     */
+    bool bind_shard(io_context& io, std::size_t shard) noexcept {
+        return shard < impl_.size() && impl_.bind(io, shard);
+    }
+
+    /**
+     * Get the number of shards; it is `connection_pool_config::shards` limited by the capacity.
+     *
+     * @return std::size_t --- number of shards.
+     */
+    std::size_t shards() const noexcept { return impl_.size();}
+
+    /**
+     * Get `ConnectionProvider` which requests connections of the given priority class.
+     *
+     * @param io --- `io_context` for the connection IO.
+     * @param priority --- index of the priority class, see `connection_pool_config::priority_classes`.
+     * @return `ConnectionProvider` model.
+     */
+    auto with_priority(io_context& io, std::size_t priority) {
+        return connection_provider(detail::prioritized_source<connection_pool>{this, priority}, io);
+    }
+
 private:
 
-    auto queue_timeout(time_traits::time_point at) const {
+    template <typename TimeConstraint, typename Handler>
+    void get_connection(std::size_t shard, io_context& io, TimeConstraint t, Handler&& handler, std::size_t priority = 0);
+
+    template <typename TimeConstraint>
+    void schedule_maintenance(std::shared_ptr<detail::pool_maintenance> m, io_context& io,
+        time_traits::duration interval, TimeConstraint t);
+
+    static auto queue_timeout(time_traits::time_point at) {
         return time_left(at);
     }
 
-    auto queue_timeout(time_traits::duration t) const {
+    static auto queue_timeout(time_traits::duration t) {
         return t;
     }
 
-    auto queue_timeout(none_t) const {
+    static auto queue_timeout(none_t) {
         return time_traits::duration(0);
     }
 
-    impl_type impl_;
+    template <typename Wrapper>
+    void get_handle(std::size_t shard, io_context& io, Wrapper&& wrapper, time_traits::duration queue_timeout);
+
+    void apply_capacity(std::size_t capacity);
+
+    /**
+     * Part of the capacity of the shard; a shard has room for one connection at least.
+     */
+    std::size_t shard_capacity(std::size_t capacity, std::size_t shard) const noexcept {
+        return std::max<std::size_t>(impl_.share(capacity, shard), 1);
+    }
+
+    static detail::capacity_adapter make_capacity_adapter(const connection_pool_config& config) {
+        if (config.max_capacity == 0) {
+            return {config.capacity, config.capacity, config.target_wait_time};
+        }
+        return {
+            std::clamp<std::size_t>(config.min_capacity, 1, std::max<std::size_t>(config.capacity, 1)),
+            std::max(config.capacity, config.max_capacity),
+            config.target_wait_time
+        };
+    }
+
+    using throttle_type = detail::connect_throttle_t<ThreadSafety>;
+    using deadline_queue_type = detail::deadline_queue_t<ThreadSafety>;
+    using idle_stack_type = detail::idle_stack_t<yamail::resource_pool::handle<connection_rep_type>, ThreadSafety>;
+
+    detail::connection_pool_shards<impl_type> impl_;
+    std::unique_ptr<detail::connection_pool_counters[]> counters_;
+    std::unique_ptr<throttle_type> throttle_;
+    detail::connection_lifespan lifespan_;
+    detail::pooled_connection_options connection_options_;
     Source source_;
+    std::size_t min_idle_;
+    bool check_idle_;
+    bool direct_handoff_;
+    std::unique_ptr<detail::pool_capacity> capacity_;
+    std::shared_ptr<detail::connection_budget_member> budget_;
+    std::shared_ptr<detail::pool_maintenance> maintenance_;
+    std::vector<std::shared_ptr<deadline_queue_type>> deadline_queues_;
+    std::vector<std::shared_ptr<idle_stack_type>> idle_stacks_;
 };
 
 //[[DEPRECATED]] for backward compatibility only
@@ -410,3 +963,16 @@ auto make_connection_pool(ConnectionSource&& source, const connection_pool_confi
 } // namespace ozo
 
 #include <ozo/impl/connection_pool.h>
+
+#ifdef OZO_EXTERN_TEMPLATES
+#include <ozo/transaction.h>
+
+namespace ozo {
+extern template class connection_rep<empty_oid_map>;
+extern template class pooled_connection<yamail::resource_pool::handle<connection_rep<empty_oid_map>>,
+    io_context::executor_type, thread_safety<true>>;
+extern template class connection_pool<connection_info<empty_oid_map, no_statistics>, thread_safety<true>>;
+extern template class transaction<connection_pool<connection_info<empty_oid_map, no_statistics>>::connection_type,
+    decltype(make_options())>;
+} // namespace ozo
+#endif
@@ -0,0 +1,676 @@
+#pragma once
+
+#include <ozo/core/histogram.h>
+#include <ozo/core/none.h>
+#include <ozo/time_traits.h>
+
+#include <libpq-fe.h>
+
+#include <time.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace ozo {
+
+/**
+ * @brief Key of a completed request statistics update
+ * @ingroup group-connection-types
+ *
+ * The key is passed to the `update_statistics()` member function of a `Connection`
+ * with `ozo::request_statistics` value by the library operations.
+ */
+struct request_statistics_key_t {};
+constexpr request_statistics_key_t request_statistics_key;
+
+/**
+ * @brief Statistics of a completed request
+ * @ingroup group-connection-types
+ */
+struct request_statistics {
+    std::size_t bytes_sent = 0; //!< size of the query text and parameters data
+    std::size_t bytes_received = 0; //!< size of the results data
+    time_traits::duration latency {}; //!< time from sending the query to the completion
+    bool failed = false; //!< `true` if the request completed with an error
+    std::size_t round_trips = 0; //!< number of times the request waited for data from the server
+    std::size_t result_memory = 0; //!< largest `PQresultMemorySize` of the request results
+};
+
+/**
+ * @brief Key of a completed request phases timeline update
+ * @ingroup group-connection-types
+ *
+ * The key is passed to the `update_statistics()` member function of a `Connection`
+ * with `ozo::request_timeline` value by the library operations.
+ */
+struct request_timeline_key_t {};
+constexpr request_timeline_key_t request_timeline_key;
+
+/**
+ * @brief Timestamps of a completed request phases
+ * @ingroup group-connection-types
+ *
+ * The timeline allows to break down a request latency into the connection
+ * acquisition (`acquired - requested`), sending of the query (`sent - acquired`),
+ * waiting for the server (`received - sent`) and results processing
+ * (`finished - received`) phases. Timestamps of phases which have not been
+ * reached, e.g. due to an error, are left default constructed.
+ * COPY operations report the `requested`, `acquired` and `finished` timestamps only.
+ *
+ * The timeline is supplied only to a Statistics model which has the
+ * `update(ozo::request_timeline_key_t, const ozo::request_timeline&)` member
+ * function, so there is no overhead for the other models.
+ *
+ * ###Example
+ *
+ * @code
+struct phases_observer {
+    void update(ozo::request_timeline_key_t, const ozo::request_timeline& v) noexcept {
+        wait_histogram.add(v.received - v.sent);
+    }
+};
+
+const auto conn_info = ozo::connection_info(conn_str, ozo::empty_oid_map{}, phases_observer{});
+ * @endcode
+ */
+struct request_timeline {
+    time_traits::time_point requested {}; //!< operation has been initiated
+    time_traits::time_point acquired {}; //!< connection has been acquired
+    time_traits::time_point sent {}; //!< query has been sent to the server entirely
+    time_traits::time_point received {}; //!< result has been received entirely
+    time_traits::time_point finished {}; //!< result has been processed and the operation completed
+    bool failed = false; //!< `true` if the request completed with an error
+    std::size_t rows = 0; //!< number of rows received
+    std::string_view host {}; //!< host of the connection, valid during the update call only
+    std::size_t params = 0; //!< number of the query parameters
+    std::size_t params_bytes = 0; //!< size of the query parameters data
+    std::size_t result_memory = 0; //!< largest `PQresultMemorySize` of the request results
+};
+
+/**
+ * @brief Key of a completed request CPU time update
+ * @ingroup group-connection-types
+ *
+ * The key is passed to the `update_statistics()` member function of a `Connection`
+ * with `ozo::request_cpu_time` value by the library operations.
+ */
+struct request_cpu_time_key_t {};
+constexpr request_cpu_time_key_t request_cpu_time_key;
+
+/**
+ * @brief CPU time of a completed request
+ * @ingroup group-connection-types
+ *
+ * The time the thread running the request spends on the CPU for the serialization of the query
+ * parameters and for the results processing, e.g. decoding of the rows by `ozo::into()`, measured
+ * by the thread CPU clock. Unlike the wall-clock phases of `ozo::request_timeline` it is not
+ * affected by the network and the scheduling, so it tells a slow network from heavy client processing.
+ * The results processed by an asynchronous processor, e.g. `ozo::parallel_into()`, are not accounted.
+ *
+ * Reading the thread CPU clock is a system call, so the time is measured only for a Statistics model
+ * which has the `update(ozo::request_cpu_time_key_t, const ozo::request_cpu_time&)` member function
+ * and for the requests bound to `ozo::query_stats` via `ozo::bind_query_stats()`.
+ *
+ * ###Example
+ *
+ * @code
+struct cpu_observer {
+    void update(ozo::request_cpu_time_key_t, const ozo::request_cpu_time& v) noexcept {
+        decoding_histogram.add(v.decoding);
+    }
+};
+
+const auto conn_info = ozo::connection_info(conn_str, ozo::empty_oid_map{}, cpu_observer{});
+ * @endcode
+ */
+struct request_cpu_time {
+    time_traits::duration serialization {}; //!< CPU time of the query serialization
+    time_traits::duration decoding {}; //!< CPU time of the results processing
+    bool failed = false; //!< `true` if the request completed with an error
+};
+
+/**
+ * @brief Receiver of the CPU time of a request bound to its completion handler
+ * @ingroup group-connection-types
+ *
+ * A completion handler supplies the receiver via the `request_cpu_time_observer()` member
+ * function, e.g. `ozo::query_stats_handler` to account the time by the query name.
+ * The `update` is called with the `target` once the request is completed.
+ */
+struct request_cpu_time_observer {
+    void* target = nullptr;
+    void (*update)(void* target, const request_cpu_time& value) noexcept = nullptr;
+
+    explicit operator bool() const noexcept { return update != nullptr;}
+};
+
+/**
+ * @brief Key of a completed connection establishment timeline update
+ * @ingroup group-connection-types
+ *
+ * The key is passed to the `update_statistics()` member function of a `Connection`
+ * with `ozo::connect_timeline` value by the connect operation.
+ */
+struct connect_timeline_key_t {};
+constexpr connect_timeline_key_t connect_timeline_key;
+
+/**
+ * @brief Phase of a connection establishment
+ * @ingroup group-connection-types
+ *
+ * The phases follow the `PQconnectPoll` states of the connection, see `ozo::connect_timeline::phases`.
+ */
+enum class connect_phase {
+    start, //!< `PQconnectStart` call, including the host name resolution by libpq
+    tcp, //!< waiting for the TCP connection to be made
+    ssl, //!< SSL or GSSAPI encryption negotiation
+    auth, //!< sending the startup packet and the authentication exchange
+    startup, //!< receiving the server parameters and checking the session properties
+    oid_map, //!< session setup statements and the oid map request
+};
+
+constexpr std::size_t connect_phases_count = static_cast<std::size_t>(connect_phase::oid_map) + 1;
+
+/**
+ * @brief Timestamps of a connection establishment
+ * @ingroup group-connection-types
+ *
+ * The timeline covers the connection start, polling until the connection is established,
+ * the session setup and the oid map request. Like the `ozo::request_timeline` it is supplied only
+ * to a Statistics model which has the `update(ozo::connect_timeline_key_t, const ozo::connect_timeline&)`
+ * member function.
+ */
+struct connect_timeline {
+    time_traits::time_point started {}; //!< connection has been started
+    time_traits::time_point finished {}; //!< connection has been established or failed
+    bool failed = false; //!< `true` if the connection failed
+    std::string_view host {}; //!< host of the connection, valid during the update call only
+    bool ssl = false; //!< `true` if the connection is encrypted with SSL
+    bool direct_ssl = false; //!< `true` if SSL is negotiated without SSLRequest, see `ozo::ssl_negotiation`
+    std::array<time_traits::duration, connect_phases_count> phases {}; //!< time spent in each phase, indexed by `ozo::connect_phase`
+
+    /**
+     * Time spent in the phase.
+     */
+    time_traits::duration phase(connect_phase v) const noexcept {
+        return phases[static_cast<std::size_t>(v)];
+    }
+};
+
+/**
+ * @brief Statistics model which collects requests statistics of a connection
+ * @ingroup group-connection-types
+ *
+ * Counts requests, failed requests, bytes sent and received, round trips to the
+ * server and collects the requests latency histogram. The memory held by the request
+ * results, as reported by `PQresultMemorySize`, is collected into a histogram with
+ * the peak value, so the requests which drive the client memory may be found and
+ * moved to streaming or cursors. The statistics is updated by the connection owner
+ * thread without locks and may be read from any thread.
+ *
+ * ###Example
+ *
+ * @code
+const auto conn_info = ozo::connection_info(conn_str, ozo::empty_oid_map{}, ozo::connection_statistics{});
+const auto conn = ozo::request(conn_info[io], query, ozo::into(res), yield);
+std::cout << conn->statistics().requests() << " requests, p99 "
+    << conn->statistics().latency().quantile(0.99).count() << std::endl;
+ * @endcode
+ */
+class connection_statistics {
+public:
+    connection_statistics() = default;
+
+    /**
+     * Copy the statistics collected so far, e.g. initial statistics of a connection.
+     */
+    connection_statistics(const connection_statistics& other) noexcept {
+        *this = other;
+    }
+
+    connection_statistics& operator =(const connection_statistics& other) noexcept {
+        copy(requests_, other.requests_);
+        copy(errors_, other.errors_);
+        copy(bytes_sent_, other.bytes_sent_);
+        copy(bytes_received_, other.bytes_received_);
+        copy(round_trips_, other.round_trips_);
+        latency_.assign(other.latency_.snapshot());
+        result_memory_.assign(other.result_memory_.snapshot());
+        copy(peak_result_memory_, other.peak_result_memory_);
+        return *this;
+    }
+
+    /**
+     * Account a completed request.
+     */
+    void update(request_statistics_key_t, const request_statistics& v) noexcept {
+        add(requests_, 1);
+        add(errors_, v.failed ? 1 : 0);
+        add(bytes_sent_, v.bytes_sent);
+        add(bytes_received_, v.bytes_received);
+        add(round_trips_, v.round_trips);
+        latency_.add(v.latency);
+        result_memory_.add(v.result_memory);
+        if (v.result_memory > load(peak_result_memory_)) {
+            peak_result_memory_.store(v.result_memory, std::memory_order_relaxed);
+        }
+    }
+
+    std::uint64_t requests() const noexcept { return load(requests_);} //!< number of completed requests
+    std::uint64_t errors() const noexcept { return load(errors_);} //!< number of requests completed with an error
+    std::uint64_t bytes_sent() const noexcept { return load(bytes_sent_);} //!< total size of queries sent
+    std::uint64_t bytes_received() const noexcept { return load(bytes_received_);} //!< total size of results received
+    std::uint64_t round_trips() const noexcept { return load(round_trips_);} //!< total number of waits for data from the server
+    latency_histogram latency() const noexcept { return latency_.snapshot();} //!< requests latency distribution
+    size_histogram result_memory() const noexcept { return result_memory_.snapshot();} //!< requests result memory distribution
+    std::uint64_t peak_result_memory() const noexcept { return load(peak_result_memory_);} //!< largest result memory of a request
+
+private:
+    using counter = std::atomic<std::uint64_t>;
+
+    // The counters have the only writer, so there is no need for read-modify-write operations.
+    static void add(counter& c, std::uint64_t v) noexcept {
+        c.store(c.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+    }
+
+    static std::uint64_t load(const counter& c) noexcept {
+        return c.load(std::memory_order_relaxed);
+    }
+
+    static void copy(counter& c, const counter& other) noexcept {
+        c.store(load(other), std::memory_order_relaxed);
+    }
+
+    counter requests_ {0};
+    counter errors_ {0};
+    counter bytes_sent_ {0};
+    counter bytes_received_ {0};
+    counter round_trips_ {0};
+    detail::atomic_latency_histogram latency_;
+    detail::atomic_size_histogram result_memory_;
+    counter peak_result_memory_ {0};
+};
+
+namespace detail {
+
+template <typename T, typename Key, typename Value, typename = std::void_t<>>
+struct accepts_statistics : std::false_type {};
+
+template <typename T, typename Key, typename Value>
+struct accepts_statistics<T, Key, Value, std::void_t<decltype(
+    std::declval<T&>().update_statistics(std::declval<const Key&>(), std::declval<const Value&>())
+)>> : std::bool_constant<
+    !std::is_same_v<std::decay_t<decltype(std::declval<const T&>().statistics())>, none_t>
+> {};
+
+template <typename T>
+using collects_request_statistics = accepts_statistics<T, request_statistics_key_t, request_statistics>;
+
+template <typename T>
+using observes_request_timeline = accepts_statistics<T, request_timeline_key_t, request_timeline>;
+
+template <typename T>
+using observes_connect_timeline = accepts_statistics<T, connect_timeline_key_t, connect_timeline>;
+
+template <typename T>
+using observes_request_cpu_time = accepts_statistics<T, request_cpu_time_key_t, request_cpu_time>;
+
+template <typename Handler, typename = std::void_t<>>
+struct has_request_cpu_time_observer : std::false_type {};
+
+template <typename Handler>
+struct has_request_cpu_time_observer<Handler, std::void_t<decltype(
+    std::declval<const Handler&>().request_cpu_time_observer()
+)>> : std::true_type {};
+
+template <typename Handler>
+inline request_cpu_time_observer get_request_cpu_time_observer([[maybe_unused]] const Handler& handler) noexcept {
+    if constexpr (has_request_cpu_time_observer<Handler>::value) {
+        return handler.request_cpu_time_observer();
+    } else {
+        return {};
+    }
+}
+
+/**
+ * CPU time consumed by the calling thread.
+ */
+inline time_traits::duration thread_cpu_time() noexcept {
+    timespec ts {};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return std::chrono::duration_cast<time_traits::duration>(
+        std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec));
+}
+
+template <typename T, typename = std::void_t<>>
+struct has_native_pg_handle : std::false_type {};
+
+template <typename T>
+struct has_native_pg_handle<T, std::void_t<decltype(PQhost(std::declval<const T&>().native_handle()))>> : std::true_type {};
+
+template <typename Connection>
+std::string_view get_host_or_empty(const Connection& conn) noexcept {
+    if constexpr (has_native_pg_handle<Connection>::value) {
+        if (const char* host = PQhost(conn.native_handle())) {
+            return host;
+        }
+    }
+    return {};
+}
+
+/**
+ * Start time of an operation captured before a connection is acquired. It is
+ * empty for a connection which does not accept `ozo::request_timeline`.
+ */
+template <typename Connection, bool = observes_request_timeline<Connection>::value>
+struct request_start_point {};
+
+template <typename Connection>
+struct request_start_point<Connection, true> {
+    time_traits::time_point value = time_traits::now();
+};
+
+template <typename Connection, bool = collects_request_statistics<Connection>::value>
+struct request_bytes_sample {
+    void sent(const char*, const int*, std::size_t) noexcept {}
+
+    template <typename Result>
+    void received(const Result&) noexcept {}
+
+    void waited() noexcept {}
+
+    void commit(Connection&, bool) noexcept {}
+};
+
+template <typename Connection>
+struct request_bytes_sample<Connection, true> {
+    time_traits::time_point start = time_traits::now();
+    std::size_t bytes_sent = 0;
+    std::size_t bytes_received = 0;
+    std::size_t round_trips = 0;
+    std::size_t result_memory = 0;
+
+    void sent(const char* text, const int* lengths, std::size_t count) noexcept {
+        bytes_sent += std::strlen(text);
+        for (std::size_t i = 0; i < count; ++i) {
+            bytes_sent += static_cast<std::size_t>(lengths[i]);
+        }
+    }
+
+    template <typename Result>
+    void received(const Result& result) noexcept {
+        if constexpr (std::is_pointer_v<Result>) {
+            const int rows = PQntuples(result);
+            const int columns = PQnfields(result);
+            for (int row = 0; row < rows; ++row) {
+                for (int column = 0; column < columns; ++column) {
+                    bytes_received += static_cast<std::size_t>(PQgetlength(result, row, column));
+                }
+            }
+            result_memory = std::max(result_memory, PQresultMemorySize(result));
+        } else {
+            received(result.get());
+        }
+    }
+
+    void waited() noexcept {
+        ++round_trips;
+    }
+
+    void commit(Connection& conn, bool failed) noexcept {
+        conn.update_statistics(request_statistics_key,
+            request_statistics{bytes_sent, bytes_received, time_traits::now() - start, failed, round_trips,
+                result_memory});
+    }
+};
+
+template <typename Connection, bool = observes_request_timeline<Connection>::value>
+struct request_timeline_sample {
+    template <typename Start>
+    void requested(const Start&) noexcept {}
+
+    void sent(const char*, const int*, std::size_t) noexcept {}
+
+    void flushed() noexcept {}
+
+    template <typename Result>
+    void received(const Result&) noexcept {}
+
+    void result_received() noexcept {}
+
+    void commit(Connection&, bool) noexcept {}
+};
+
+template <typename Connection>
+struct request_timeline_sample<Connection, true> {
+    request_timeline timeline {time_traits::time_point{}, time_traits::now()};
+
+    template <typename Start>
+    void requested(const Start& start) noexcept {
+        if constexpr (!std::is_empty_v<Start>) {
+            timeline.requested = start.value;
+        }
+    }
+
+    void sent(const char*, const int* lengths, std::size_t count) noexcept {
+        timeline.params += count;
+        for (std::size_t i = 0; i < count; ++i) {
+            timeline.params_bytes += static_cast<std::size_t>(std::max(lengths[i], 0));
+        }
+    }
+
+    void flushed() noexcept {
+        timeline.sent = time_traits::now();
+    }
+
+    template <typename Result>
+    void received(const Result& result) noexcept {
+        if constexpr (std::is_pointer_v<Result>) {
+            timeline.rows += static_cast<std::size_t>(PQntuples(result));
+            timeline.result_memory = std::max(timeline.result_memory, PQresultMemorySize(result));
+        } else {
+            received(result.get());
+        }
+    }
+
+    void result_received() noexcept {
+        timeline.received = time_traits::now();
+    }
+
+    void commit(Connection& conn, bool failed) noexcept {
+        if (timeline.requested == time_traits::time_point{}) {
+            timeline.requested = timeline.acquired;
+        }
+        timeline.finished = time_traits::now();
+        timeline.failed = failed;
+        timeline.host = get_host_or_empty(conn);
+        conn.update_statistics(request_timeline_key, timeline);
+    }
+};
+
+/**
+ * CPU time of a request, measured if the connection with `Connection` type accepts
+ * `ozo::request_cpu_time` or the completion handler has supplied an observer. Unlike
+ * the `request_statistics_sample` it is not empty for any connection, since the observer
+ * is known at run time.
+ */
+template <typename Connection>
+struct request_cpu_time_sample {
+    request_cpu_time cpu_time;
+    request_cpu_time_observer cpu_time_observer;
+
+    bool cpu_time_measured() const noexcept {
+        return observes_request_cpu_time<Connection>::value || cpu_time_observer;
+    }
+
+    /**
+     * Adds the CPU time of the thread from the construction to the destruction to a phase.
+     */
+    class cpu_time_scope {
+    public:
+        cpu_time_scope(time_traits::duration* phase) noexcept
+        : phase_(phase), start_(phase ? thread_cpu_time() : time_traits::duration{}) {}
+
+        cpu_time_scope(const cpu_time_scope&) = delete;
+        cpu_time_scope& operator =(const cpu_time_scope&) = delete;
+
+        ~cpu_time_scope() {
+            if (phase_) {
+                *phase_ += thread_cpu_time() - start_;
+            }
+        }
+
+    private:
+        time_traits::duration* phase_;
+        time_traits::duration start_;
+    };
+
+    cpu_time_scope measure_serialization() noexcept {
+        return cpu_time_measured() ? std::addressof(cpu_time.serialization) : nullptr;
+    }
+
+    cpu_time_scope measure_decoding() noexcept {
+        return cpu_time_measured() ? std::addressof(cpu_time.decoding) : nullptr;
+    }
+
+    void set_cpu_time_observer(request_cpu_time_observer observer) noexcept {
+        cpu_time_observer = observer;
+    }
+
+    void commit(Connection& conn, bool failed) noexcept {
+        if (!cpu_time_measured()) {
+            return;
+        }
+        cpu_time.failed = failed;
+        if constexpr (observes_request_cpu_time<Connection>::value) {
+            conn.update_statistics(request_cpu_time_key, cpu_time);
+        }
+        if (cpu_time_observer) {
+            cpu_time_observer.update(cpu_time_observer.target, cpu_time);
+        }
+    }
+};
+
+/**
+ * Request statistics collected by a request operation for the connection
+ * with `Connection` type. Nothing is collected for a connection which accepts
+ * neither `ozo::request_statistics` nor `ozo::request_timeline`, e.g. with
+ * `ozo::no_statistics`.
+ */
+template <typename Connection>
+struct request_statistics_sample : request_bytes_sample<Connection>, request_timeline_sample<Connection> {
+    using bytes_sample = request_bytes_sample<Connection>;
+    using timeline_sample = request_timeline_sample<Connection>;
+
+    void sent(const char* text, const int* lengths, std::size_t count) noexcept {
+        bytes_sample::sent(text, lengths, count);
+        timeline_sample::sent(text, lengths, count);
+    }
+
+    template <typename Result>
+    void received(const Result& result) noexcept {
+        bytes_sample::received(result);
+        timeline_sample::received(result);
+    }
+
+    void commit(Connection& conn, bool failed) noexcept {
+        bytes_sample::commit(conn, failed);
+        timeline_sample::commit(conn, failed);
+    }
+};
+
+/**
+ * Connection establishment timeline collected by the connect operation for
+ * the connection with `Connection` type. It is empty for a connection which does not
+ * accept `ozo::connect_timeline`.
+ */
+template <typename Connection, bool = observes_connect_timeline<Connection>::value>
+struct connect_timeline_sample {
+    void mark(connect_phase) noexcept {}
+
+    void poll_started(const Connection&) noexcept {}
+
+    void poll_finished() noexcept {}
+
+    void commit(Connection&, bool) noexcept {}
+};
+
+/**
+ * Phase of the connection establishment the connection in the `status` state waits for.
+ */
+constexpr connect_phase get_connect_phase(ConnStatusType status) noexcept {
+    switch (status) {
+        case CONNECTION_STARTED:
+            return connect_phase::tcp;
+        case CONNECTION_SSL_STARTUP:
+        case CONNECTION_GSS_STARTUP:
+            return connect_phase::ssl;
+        case CONNECTION_MADE:
+        case CONNECTION_AWAITING_RESPONSE:
+            return connect_phase::auth;
+        default:
+            break;
+    }
+    return connect_phase::startup;
+}
+
+/**
+ * The connection parameters are requested only for an SSL connection, the `sslnegotiation`
+ * parameter is unknown to libpq older than 17.
+ */
+inline bool is_direct_ssl_negotiation(PGconn* handle) noexcept {
+    std::unique_ptr<PQconninfoOption, decltype(&PQconninfoFree)> options(PQconninfo(handle), &PQconninfoFree);
+    if (!options) {
+        return false;
+    }
+    for (auto option = options.get(); option->keyword; ++option) {
+        if (std::string_view(option->keyword) == "sslnegotiation") {
+            return option->val && std::string_view(option->val) == "direct";
+        }
+    }
+    return false;
+}
+
+template <typename Connection>
+struct connect_timeline_sample<Connection, true> {
+    connect_timeline timeline {time_traits::now()};
+    time_traits::time_point last = timeline.started;
+    connect_phase polled = connect_phase::tcp;
+
+    void mark(connect_phase phase) noexcept {
+        const auto now = time_traits::now();
+        timeline.phases[static_cast<std::size_t>(phase)] += now - last;
+        last = now;
+    }
+
+    void poll_started(const Connection& conn) noexcept {
+        if constexpr (has_native_pg_handle<Connection>::value) {
+            polled = get_connect_phase(PQstatus(conn.native_handle()));
+        }
+    }
+
+    void poll_finished() noexcept {
+        mark(polled);
+    }
+
+    void commit(Connection& conn, bool failed) noexcept {
+        timeline.finished = time_traits::now();
+        timeline.failed = failed;
+        timeline.host = get_host_or_empty(conn);
+        if constexpr (has_native_pg_handle<Connection>::value) {
+            timeline.ssl = !failed && PQsslInUse(conn.native_handle());
+            timeline.direct_ssl = timeline.ssl && is_direct_ssl_negotiation(conn.native_handle());
+        }
+        conn.update_statistics(connect_timeline_key, timeline);
+    }
+};
+
+} // namespace detail
+} // namespace ozo
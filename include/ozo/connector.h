@@ -105,6 +105,12 @@ public:
         std::move(source_)(io_, std::move(t), std::forward<Handler>(h));
     }
 
+    /**
+     * Executor of the `io_context` the provider is bound to, e.g. for a timer
+     * which should be waited before getting a connection.
+     */
+    auto get_executor() const { return io_.get_executor();}
+
 private:
     ConnectionSource source_;
     io_context& io_;
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <ozo/impl/async_copy.h>
+
+namespace ozo {
+
+/**
+ * @brief Per row output for `ozo::copy_out()`
+ *
+ * Creates an output for `ozo::copy_out()` which decodes each received row into
+ * a `Row` object and passes it to the callback, so rows are not collected in memory.
+ *
+ * @tparam Row --- #Composite type of a row or a type of the single column.
+ * @param callback --- callable with `void(Row)` signature.
+ * @return output object
+ * @ingroup group-requests-functions
+ */
+template <typename Row, typename Callback>
+constexpr auto copy_rows(Callback callback) {
+    return impl::copy_out_rows_handler<Row, Callback> {std::move(callback)};
+}
+
+#ifdef OZO_DOCUMENTATION
+/**
+ * @brief Loads rows into a database table via COPY FROM STDIN
+ *
+ * Executes the `COPY ... FROM STDIN (FORMAT binary)` query and transfers the rows in
+ * the COPY binary format. Each row is a #Composite object (e.g. `std::tuple` or
+ * an adapted structure) and each its field is serialized in the same way as a query
+ * parameter via `ozo::send()`, so the fields types should match the table columns
+ * listed in the query. The rows are serialized and passed to the database by chunks
+ * as soon as the connection is able to send them, so only one chunk of the serialized
+ * data is kept in memory at a time. This is significantly faster than inserting
+ * rows with `INSERT` statements.
+ *
+ * The rows range is stored by the operation until the operation is complete. Use
+ * `std::cref()` to pass a range without copying it; in such case the range must be
+ * alive until the operation is complete.
+ *
+ * @param provider --- connection provider object
+ * @param query --- `COPY FROM STDIN` query object with binary format specified.
+ * @param time_constraint --- request #TimeConstraint; this time constrain <b>includes</b> time for getting connection from provider.
+ * @param rows --- range of #Composite rows to load.
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ *
+ * ###Example
+ *
+ * @code
+const std::vector<std::tuple<std::int64_t, std::string>> rows {{1, "foo"}, {2, "bar"}};
+ozo::copy_in(conn_info[io], "COPY users (id, name) FROM STDIN (FORMAT binary)"_SQL,
+    1min, std::cref(rows), yield);
+ * @endcode
+ */
+template <typename ConnectionProvider, typename BinaryQueryConvertible, typename TimeConstraint, typename Rows, typename CompletionToken>
+decltype(auto) copy_in(ConnectionProvider&& provider, BinaryQueryConvertible&& query, TimeConstraint time_constraint, Rows&& rows, CompletionToken&& token);
+
+/**
+ * @brief Loads rows into a database table via COPY FROM STDIN
+ *
+ * This function is time constrain free shortcut to `ozo::copy_in()` function.
+ * Its call is equal to `ozo::copy_in(provider, query, ozo::none, rows, token)` call.
+ *
+ * @param provider --- connection provider object
+ * @param query --- `COPY FROM STDIN` query object with binary format specified.
+ * @param rows --- range of #Composite rows to load.
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ */
+template <typename ConnectionProvider, typename BinaryQueryConvertible, typename Rows, typename CompletionToken>
+decltype(auto) copy_in(ConnectionProvider&& provider, BinaryQueryConvertible&& query, Rows&& rows, CompletionToken&& token);
+
+/**
+ * @brief Exports rows from a database via COPY TO STDOUT
+ *
+ * Executes the `COPY ... TO STDOUT (FORMAT binary)` query and receives the data in
+ * the COPY binary format row by row as it arrives. Each row is decoded via `ozo::recv()`
+ * into a #Composite object (e.g. `std::tuple` or an adapted structure) or into
+ * an object of the column type for a single column. Since COPY data does not contain
+ * types oids, the row type should match the columns of the query. Unlike `ozo::request()`
+ * the whole result is never kept in memory.
+ *
+ * @note In case of a row processing error the operation completes immediately and
+ * the rest of the data is not consumed, so the connection can not be reused.
+ *
+ * @param provider --- connection provider object
+ * @param query --- `COPY TO STDOUT` query object with binary format specified.
+ * @param time_constraint --- request #TimeConstraint; this time constrain <b>includes</b> time for getting connection from provider.
+ * @param out --- output iterator for rows (the same as for `ozo::request()`) or an output made by `ozo::copy_rows()`.
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ *
+ * ###Example
+ *
+ * @code
+std::size_t total = 0;
+ozo::copy_out(conn_info[io], "COPY users (id, name) TO STDOUT (FORMAT binary)"_SQL, 1min,
+    ozo::copy_rows<std::tuple<std::int64_t, std::string>>([&] (auto row) { total += std::get<0>(row); }),
+    yield);
+ * @endcode
+ */
+template <typename ConnectionProvider, typename BinaryQueryConvertible, typename TimeConstraint, typename Out, typename CompletionToken>
+decltype(auto) copy_out(ConnectionProvider&& provider, BinaryQueryConvertible&& query, TimeConstraint time_constraint, Out&& out, CompletionToken&& token);
+
+/**
+ * @brief Exports rows from a database via COPY TO STDOUT
+ *
+ * This function is time constrain free shortcut to `ozo::copy_out()` function.
+ * Its call is equal to `ozo::copy_out(provider, query, ozo::none, out, token)` call.
+ *
+ * @param provider --- connection provider object
+ * @param query --- `COPY TO STDOUT` query object with binary format specified.
+ * @param out --- output iterator for rows or an output made by `ozo::copy_rows()`.
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ */
+template <typename ConnectionProvider, typename BinaryQueryConvertible, typename Out, typename CompletionToken>
+decltype(auto) copy_out(ConnectionProvider&& provider, BinaryQueryConvertible&& query, Out&& out, CompletionToken&& token);
+#else
+
+template <typename Initiator>
+struct copy_in_op : base_async_operation <copy_in_op<Initiator>, Initiator> {
+    using base = typename copy_in_op::base;
+    using base::base;
+
+    template <typename P, typename Q, typename TimeConstraint, typename Rows, typename CompletionToken>
+    decltype(auto) operator() (P&& provider, Q&& query, TimeConstraint t, Rows&& rows,
+            CompletionToken&& token) const {
+        static_assert(ConnectionProvider<P>, "provider should be a ConnectionProvider");
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        return async_initiate<CompletionToken, handler_signature<P>>(
+            get_operation_initiator(*this), token, std::forward<P>(provider), t,
+            std::forward<Q>(query), std::forward<Rows>(rows));
+    }
+
+    template <typename P, typename Q, typename Rows, typename CompletionToken>
+    decltype(auto) operator()(P&& provider, Q&& query, Rows&& rows, CompletionToken&& token) const {
+        return (*this)(std::forward<P>(provider), std::forward<Q>(query), none, std::forward<Rows>(rows),
+            std::forward<CompletionToken>(token));
+    }
+
+    template <typename OtherInitiator>
+    constexpr static auto rebind_initiator(const OtherInitiator& other) {
+        return copy_in_op<OtherInitiator>{other};
+    }
+};
+
+namespace detail {
+struct initiate_async_copy_in {
+    template <typename Handler, typename P, typename TimeConstraint, typename Q, typename Rows>
+    constexpr void operator()(Handler&& h, P&& p, TimeConstraint t, Q&& q, Rows&& rows) const {
+        impl::async_copy_in(std::forward<P>(p), std::forward<Q>(q), t, std::forward<Rows>(rows),
+            std::forward<Handler>(h));
+    }
+};
+} // namespace detail
+
+constexpr copy_in_op<detail::initiate_async_copy_in> copy_in;
+
+template <typename Initiator>
+struct copy_out_op : base_async_operation <copy_out_op<Initiator>, Initiator> {
+    using base = typename copy_out_op::base;
+    using base::base;
+
+    template <typename P, typename Q, typename TimeConstraint, typename Out, typename CompletionToken>
+    decltype(auto) operator() (P&& provider, Q&& query, TimeConstraint t, Out&& out,
+            CompletionToken&& token) const {
+        static_assert(ConnectionProvider<P>, "provider should be a ConnectionProvider");
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        return async_initiate<CompletionToken, handler_signature<P>>(
+            get_operation_initiator(*this), token, std::forward<P>(provider), t,
+            std::forward<Q>(query), std::forward<Out>(out));
+    }
+
+    template <typename P, typename Q, typename Out, typename CompletionToken>
+    decltype(auto) operator()(P&& provider, Q&& query, Out&& out, CompletionToken&& token) const {
+        return (*this)(std::forward<P>(provider), std::forward<Q>(query), none, std::forward<Out>(out),
+            std::forward<CompletionToken>(token));
+    }
+
+    template <typename OtherInitiator>
+    constexpr static auto rebind_initiator(const OtherInitiator& other) {
+        return copy_out_op<OtherInitiator>{other};
+    }
+};
+
+namespace detail {
+struct initiate_async_copy_out {
+    template <typename Handler, typename P, typename TimeConstraint, typename Q, typename Out>
+    constexpr void operator()(Handler&& h, P&& p, TimeConstraint t, Q&& q, Out&& out) const {
+        impl::async_copy_out(std::forward<P>(p), std::forward<Q>(q), t, std::forward<Out>(out),
+            std::forward<Handler>(h));
+    }
+};
+} // namespace detail
+
+constexpr copy_out_op<detail::initiate_async_copy_out> copy_out;
+
+#endif
+
+} // namespace ozo
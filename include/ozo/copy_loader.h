@@ -0,0 +1,266 @@
+#pragma once
+
+#include <ozo/copy.h>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ozo {
+namespace detail {
+
+struct copy_loader_waiter {
+    virtual void complete(error_code ec, std::vector<error_code> statuses) = 0;
+    virtual ~copy_loader_waiter() = default;
+};
+
+template <typename Handler, typename Executor>
+struct copy_loader_waiter_impl : copy_loader_waiter {
+    Handler handler_;
+    Executor executor_;
+
+    copy_loader_waiter_impl(Handler handler, const Executor& ex)
+    : handler_(std::move(handler)), executor_(ex) {}
+
+    void complete(error_code ec, std::vector<error_code> statuses) override {
+        auto ex = asio::get_associated_executor(handler_, executor_);
+        asio::post(ex, detail::bind(std::move(handler_), std::move(ec), std::move(statuses)));
+    }
+};
+
+/**
+* Shared state of `ozo::copy_loader`: a channel and the status of the COPY operation
+* per partition. The finish waiter is completed once all the operations are complete.
+*/
+class copy_loader_state {
+public:
+    using channel_type = impl::copy_in_channel;
+    using waiter_ptr = std::unique_ptr<copy_loader_waiter>;
+
+    copy_loader_state(io_context& io, std::size_t partitions, std::size_t buffer_size)
+    : io_(io), statuses_(partitions), remaining_(partitions) {
+        channels_.reserve(partitions);
+        for (std::size_t i = 0; i != partitions; ++i) {
+            channels_.push_back(std::make_shared<channel_type>(buffer_size));
+        }
+    }
+
+    io_context& get_io_context() const noexcept { return io_;}
+
+    std::size_t size() const noexcept { return channels_.size();}
+
+    const std::shared_ptr<channel_type>& channel(std::size_t partition) const noexcept {
+        return channels_[partition];
+    }
+
+    /**
+    * The COPY operation of the partition is complete, the producer of a failed
+    * partition is completed with its error.
+    */
+    void complete(std::size_t partition, error_code ec) {
+        if (ec) {
+            channels_[partition]->fail(ec);
+        }
+        std::unique_lock lock(mutex_);
+        statuses_[partition] = std::move(ec);
+        if (--remaining_ != 0 || !waiter_) {
+            return;
+        }
+        auto waiter = std::move(waiter_);
+        auto statuses = statuses_;
+        lock.unlock();
+        const auto result = loader_error(statuses);
+        waiter->complete(result, std::move(statuses));
+    }
+
+    void finish(waiter_ptr waiter) {
+        for (auto& channel : channels_) {
+            channel->close();
+        }
+        std::unique_lock lock(mutex_);
+        if (remaining_ != 0) {
+            waiter_ = std::move(waiter);
+            return;
+        }
+        auto statuses = statuses_;
+        lock.unlock();
+        const auto result = loader_error(statuses);
+        waiter->complete(result, std::move(statuses));
+    }
+
+    /**
+     * No error if all the partitions succeeded, `ozo::error::partial_result` if some of them
+     * succeeded, the error of the first partition if none of them did.
+     */
+    static error_code loader_error(const std::vector<error_code>& statuses) {
+        const auto failed = std::find_if(statuses.begin(), statuses.end(),
+            [] (const auto& ec) { return static_cast<bool>(ec); });
+        if (failed == statuses.end()) {
+            return {};
+        }
+        const auto succeeded = std::any_of(statuses.begin(), statuses.end(),
+            [] (const auto& ec) { return !ec; });
+        return succeeded ? error_code{error::partial_result} : *failed;
+    }
+
+private:
+    std::mutex mutex_;
+    io_context& io_;
+    std::vector<std::shared_ptr<channel_type>> channels_;
+    std::vector<error_code> statuses_;
+    std::size_t remaining_;
+    waiter_ptr waiter_;
+};
+
+} // namespace detail
+
+/**
+ * @brief Bulk loader which streams rows via parallel COPY FROM STDIN operations
+ *
+ * `ozo::copy_in()` loads a range of rows which is known in advance via a single connection.
+ * The loader runs a `COPY ... FROM STDIN (FORMAT binary)` operation per partition, each with
+ * its own connection, e.g. from a pool, and rows are written into the partitions while they are
+ * produced: by the partition number, e.g. a hash bucket of the row key, or round-robin.
+ *
+ * A row is serialized at once into the pending buffer of its partition. Once the pending buffer
+ * reaches the buffer size the write completes only after the operation has taken the buffer to
+ * send it, so a producer is never faster than the connection of a partition and about two
+ * buffers per partition are kept in memory. Each of concurrent writes adds a row over the limit.
+ *
+ * `finish()` sends the rest of the rows and completes once all the operations are complete with
+ * the status of each partition: no error if all of them succeeded, `ozo::error::partial_result`
+ * if some of them did, or the error of the first partition otherwise. A write into a failed
+ * partition completes with its error. Each partition is a separate transaction, so a caller which
+ * needs all-or-nothing semantics should load into a staging table.
+ *
+ * The time constraint of `start()` is applied to each operation, it <b>does not</b> cancel
+ * an operation which is waiting for the rows, so `finish()` should be called anyway.
+ *
+ * The object may be used from many threads simultaneously.
+ *
+ *@code
+#include <ozo/copy_loader.h>
+ *@endcode
+ *
+ * ###Example
+ *
+ * @code
+ozo::copy_loader<std::tuple<std::int64_t, std::string>> loader(io, 4);
+loader.start(pool[io], "COPY users (id, name) FROM STDIN (FORMAT binary)"_SQL, 10min);
+for (auto& user : users) {
+    loader.write(loader.partition_of(user.id), std::make_tuple(user.id, user.name), yield[ec]);
+}
+const auto statuses = loader.finish(yield[ec]);
+ * @endcode
+ *
+ * @tparam Row --- #Composite type of a row.
+ * @tparam OidMap --- `OidMap` to resolve the types of the row fields.
+ * @ingroup group-requests-types
+ */
+template <typename Row, typename OidMap = empty_oid_map>
+class copy_loader {
+    static_assert(ozo::OidMap<OidMap>, "OidMap should model ozo::OidMap");
+
+    using state_type = detail::copy_loader_state;
+
+public:
+    using row_type = Row;
+
+    /**
+     * @brief Construct a new copy loader object
+     *
+     * @param io --- `io_context` to complete the writes with.
+     * @param partitions --- number of the partitions, i.e. the parallel COPY operations.
+     * @param buffer_size --- size of the pending buffer of a partition which a write waits for to be sent.
+     * @param oid_map --- `OidMap` to resolve the types of the row fields.
+     */
+    copy_loader(io_context& io, std::size_t partitions,
+            std::size_t buffer_size = impl::copy_buffer_size, const OidMap& oid_map = OidMap{})
+    : state_(std::make_shared<state_type>(io, partitions, buffer_size)), oid_map_(oid_map) {}
+
+    std::size_t partitions() const noexcept { return state_->size();}
+
+    /**
+     * Partition of a key, e.g. of a hash bucket of the row key.
+     */
+    template <typename Key, typename Hash = std::hash<Key>>
+    std::size_t partition_of(const Key& key, Hash hash = Hash{}) const {
+        return hash(key) % partitions();
+    }
+
+    /**
+     * @brief Starts the COPY operations of all the partitions
+     *
+     * @param provider --- connection provider object, it is copied per partition.
+     * @param query --- `COPY FROM STDIN` query object with binary format specified.
+     * @param time_constraint --- #TimeConstraint of each operation; it <b>includes</b> time for getting connection from provider.
+     */
+    template <typename ConnectionProvider, typename BinaryQueryConvertible, typename TimeConstraint = none_t>
+    void start(const ConnectionProvider& provider, const BinaryQueryConvertible& query,
+            TimeConstraint time_constraint = none) {
+        for (std::size_t i = 0; i != partitions(); ++i) {
+            impl::async_copy_in(ConnectionProvider(provider), BinaryQueryConvertible(query), time_constraint,
+                state_->channel(i), [state = state_, i] (error_code ec, auto&&) {
+                    state->complete(i, std::move(ec));
+                });
+        }
+    }
+
+    /**
+     * @brief Writes the row into the partition
+     *
+     * @param partition --- partition number, less than `partitions()`.
+     * @param row --- row to write.
+     * @param token --- operation #CompletionToken with `void(ozo::error_code)` signature.
+     * @return deduced from #CompletionToken.
+     */
+    template <typename CompletionToken>
+    decltype(auto) write(std::size_t partition, const row_type& row, CompletionToken&& token) {
+        return async_initiate<CompletionToken, void(error_code)>(
+            [this, partition, &row] (auto&& handler) {
+                state_->channel(partition)->write(oid_map_, row, impl::make_copy_in_waiter(
+                    std::forward<decltype(handler)>(handler), state_->get_io_context().get_executor()));
+            },
+            token);
+    }
+
+    /**
+     * @brief Writes the row into the next partition round-robin
+     *
+     * @param row --- row to write.
+     * @param token --- operation #CompletionToken with `void(ozo::error_code)` signature.
+     * @return deduced from #CompletionToken.
+     */
+    template <typename CompletionToken>
+    decltype(auto) write(const row_type& row, CompletionToken&& token) {
+        return write(next_++ % partitions(), row, std::forward<CompletionToken>(token));
+    }
+
+    /**
+     * @brief Sends the rest of the rows and waits for the operations to complete
+     *
+     * @param token --- operation #CompletionToken with `void(ozo::error_code, std::vector<ozo::error_code>)` signature.
+     * @return deduced from #CompletionToken.
+     */
+    template <typename CompletionToken>
+    decltype(auto) finish(CompletionToken&& token) {
+        return async_initiate<CompletionToken, void(error_code, std::vector<error_code>)>(
+            [state = state_] (auto&& handler) {
+                using handler_type = std::decay_t<decltype(handler)>;
+                using waiter_type = detail::copy_loader_waiter_impl<handler_type, io_context::executor_type>;
+                state->finish(std::make_unique<waiter_type>(
+                    std::forward<decltype(handler)>(handler), state->get_io_context().get_executor()));
+            },
+            token);
+    }
+
+private:
+    std::shared_ptr<state_type> state_;
+    OidMap oid_map_;
+    std::atomic<std::size_t> next_ {0};
+};
+
+} // namespace ozo
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <ozo/time_traits.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+
+namespace ozo {
+
+/**
+ * @brief Distribution of time intervals
+ * @ingroup group-core-types
+ *
+ * Snapshot of a histogram with buckets of exponentially growing width. The
+ * bucket `0` counts intervals less than one microsecond, the bucket `i` counts
+ * intervals from `2^(i-1)` up to `2^i` microseconds, and the last bucket counts
+ * all the greater intervals.
+ */
+struct latency_histogram {
+    static constexpr std::size_t buckets_count = 32; //!< number of buckets
+
+    std::array<std::uint64_t, buckets_count> buckets {}; //!< counters of intervals of each bucket
+
+    /**
+     * Get index of the bucket which counts the interval.
+     *
+     * @param v --- time interval.
+     * @return std::size_t --- bucket index.
+     */
+    static constexpr std::size_t bucket(time_traits::duration v) noexcept {
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(v).count();
+        std::size_t i = 0;
+        for (; us > 0 && i + 1 < buckets_count; us >>= 1) {
+            ++i;
+        }
+        return i;
+    }
+
+    /**
+     * Get the exclusive upper bound of intervals counted by the bucket. The bound of the
+     * last bucket is `time_traits::duration::max()`.
+     *
+     * @param i --- bucket index.
+     * @return time_traits::duration --- upper bound of the bucket.
+     */
+    static constexpr time_traits::duration upper_bound(std::size_t i) noexcept {
+        if (i + 1 >= buckets_count) {
+            return time_traits::duration::max();
+        }
+        return std::chrono::microseconds(std::int64_t(1) << i);
+    }
+
+    /**
+     * Get total number of counted intervals.
+     */
+    std::uint64_t count() const noexcept {
+        return std::accumulate(buckets.begin(), buckets.end(), std::uint64_t(0));
+    }
+
+    /**
+     * Get an estimation of the quantile as the upper bound of the bucket it falls into.
+     *
+     * @param q --- quantile in range [0, 1], e.g. `0.99`.
+     * @return time_traits::duration --- upper bound of the quantile, zero for the empty histogram.
+     */
+    time_traits::duration quantile(double q) const noexcept {
+        const auto total = count();
+        if (total == 0) {
+            return time_traits::duration(0);
+        }
+        const auto rank = static_cast<std::uint64_t>(q * static_cast<double>(total - 1)) + 1;
+        std::uint64_t seen = 0;
+        std::size_t i = 0;
+        for (; i + 1 < buckets_count; ++i) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                break;
+            }
+        }
+        return upper_bound(i);
+    }
+
+    latency_histogram& operator +=(const latency_histogram& other) noexcept {
+        for (std::size_t i = 0; i < buckets_count; ++i) {
+            buckets[i] += other.buckets[i];
+        }
+        return *this;
+    }
+
+    /**
+     * Subtract an earlier snapshot of the same histogram to get the distribution
+     * of the intervals counted since then.
+     */
+    latency_histogram& operator -=(const latency_histogram& other) noexcept {
+        for (std::size_t i = 0; i < buckets_count; ++i) {
+            buckets[i] -= other.buckets[i];
+        }
+        return *this;
+    }
+};
+
+/**
+ * @brief Distribution of memory sizes
+ * @ingroup group-core-types
+ *
+ * Snapshot of a histogram with buckets of exponentially growing width like
+ * `ozo::latency_histogram`. The bucket `0` counts zero sizes, the bucket `i` counts
+ * sizes from `2^(i-1)` up to `2^i` bytes, and the last bucket counts all the greater sizes.
+ */
+struct size_histogram {
+    static constexpr std::size_t buckets_count = 40; //!< number of buckets
+
+    std::array<std::uint64_t, buckets_count> buckets {}; //!< counters of sizes of each bucket
+
+    /**
+     * Get index of the bucket which counts the size.
+     *
+     * @param v --- size in bytes.
+     * @return std::size_t --- bucket index.
+     */
+    static constexpr std::size_t bucket(std::size_t v) noexcept {
+        std::size_t i = 0;
+        for (; v > 0 && i + 1 < buckets_count; v >>= 1) {
+            ++i;
+        }
+        return i;
+    }
+
+    /**
+     * Get the exclusive upper bound of sizes counted by the bucket. The bound of the
+     * last bucket is `std::numeric_limits<std::size_t>::max()`.
+     *
+     * @param i --- bucket index.
+     * @return std::size_t --- upper bound of the bucket in bytes.
+     */
+    static constexpr std::size_t upper_bound(std::size_t i) noexcept {
+        if (i + 1 >= buckets_count) {
+            return std::numeric_limits<std::size_t>::max();
+        }
+        return std::size_t(1) << i;
+    }
+
+    /**
+     * Get total number of counted sizes.
+     */
+    std::uint64_t count() const noexcept {
+        return std::accumulate(buckets.begin(), buckets.end(), std::uint64_t(0));
+    }
+
+    /**
+     * Get an estimation of the quantile as the upper bound of the bucket it falls into.
+     *
+     * @param q --- quantile in range [0, 1], e.g. `0.99`.
+     * @return std::size_t --- upper bound of the quantile in bytes, zero for the empty histogram.
+     */
+    std::size_t quantile(double q) const noexcept {
+        const auto total = count();
+        if (total == 0) {
+            return 0;
+        }
+        const auto rank = static_cast<std::uint64_t>(q * static_cast<double>(total - 1)) + 1;
+        std::uint64_t seen = 0;
+        std::size_t i = 0;
+        for (; i + 1 < buckets_count; ++i) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                break;
+            }
+        }
+        return upper_bound(i);
+    }
+
+    size_histogram& operator +=(const size_histogram& other) noexcept {
+        for (std::size_t i = 0; i < buckets_count; ++i) {
+            buckets[i] += other.buckets[i];
+        }
+        return *this;
+    }
+
+    /**
+     * Subtract an earlier snapshot of the same histogram to get the distribution
+     * of the sizes counted since then.
+     */
+    size_histogram& operator -=(const size_histogram& other) noexcept {
+        for (std::size_t i = 0; i < buckets_count; ++i) {
+            buckets[i] -= other.buckets[i];
+        }
+        return *this;
+    }
+};
+
+namespace detail {
+
+/**
+ * Histogram of time intervals which may be updated and read concurrently without locks.
+ */
+class atomic_latency_histogram {
+public:
+    void add(time_traits::duration v) noexcept {
+        buckets_[latency_histogram::bucket(v)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void assign(const latency_histogram& v) noexcept {
+        for (std::size_t i = 0; i < latency_histogram::buckets_count; ++i) {
+            buckets_[i].store(v.buckets[i], std::memory_order_relaxed);
+        }
+    }
+
+    latency_histogram snapshot() const noexcept {
+        latency_histogram result;
+        for (std::size_t i = 0; i < latency_histogram::buckets_count; ++i) {
+            result.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+private:
+    std::array<std::atomic<std::uint64_t>, latency_histogram::buckets_count> buckets_ {};
+};
+
+/**
+ * Histogram of memory sizes which may be updated and read concurrently without locks.
+ */
+class atomic_size_histogram {
+public:
+    void add(std::size_t v) noexcept {
+        buckets_[size_histogram::bucket(v)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void assign(const size_histogram& v) noexcept {
+        for (std::size_t i = 0; i < size_histogram::buckets_count; ++i) {
+            buckets_[i].store(v.buckets[i], std::memory_order_relaxed);
+        }
+    }
+
+    size_histogram snapshot() const noexcept {
+        size_histogram result;
+        for (std::size_t i = 0; i < size_histogram::buckets_count; ++i) {
+            result.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+private:
+    std::array<std::atomic<std::uint64_t>, size_histogram::buckets_count> buckets_ {};
+};
+
+} // namespace detail
+} // namespace ozo
@@ -7,6 +7,22 @@
 
 namespace ozo {
 
+namespace detail {
+
+template <typename T, typename Alloc, typename = std::void_t<>>
+struct uses_allocator_value : std::false_type {};
+
+template <typename T, typename Alloc>
+struct uses_allocator_value<T, Alloc, std::void_t<typename T::value_type>> : std::bool_constant<
+    std::uses_allocator_v<typename T::value_type, Alloc>
+    && std::is_constructible_v<typename T::value_type, const Alloc&>
+> {};
+
+template <typename T, typename Alloc>
+inline constexpr auto UsesAllocator = uses_allocator_value<std::decay_t<T>, Alloc>::value;
+
+} // namespace detail
+
 template <typename T, typename Enable = void>
 struct is_nullable : std::false_type {};
 
@@ -86,12 +102,21 @@ constexpr decltype(auto) is_null(const T& v) noexcept(noexcept(is_null_impl<T>::
     return is_null_impl<T>::apply(v);
 }
 
+/**
+ * The default implementation constructs the value via `emplace()`. If the value
+ * type uses the allocator, e.g. `std::optional<std::pmr::string>` with
+ * `std::pmr::polymorphic_allocator`, the value is constructed with it.
+ */
 template <typename T, typename = std::void_t<>>
 struct allocate_nullable_impl {
     static_assert(Emplaceable<T>, "default implementation uses emplace() method");
     template <typename Alloc>
-    static void apply(T& out, const Alloc&) {
-        out.emplace();
+    static void apply(T& out, const Alloc& a) {
+        if constexpr (detail::UsesAllocator<T, Alloc>) {
+            out.emplace(a);
+        } else {
+            out.emplace();
+        }
     }
 };
 
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <ozo/impl/async_cursor.h>
+
+namespace ozo {
+
+#ifdef OZO_DOCUMENTATION
+/**
+ * @brief Pages through the query result with a server side cursor
+ *
+ * The function declares a cursor for the query within the transaction and fetches its rows
+ * by pages of the given number of rows until the cursor is exhausted, then closes the cursor.
+ * Each page is received as a regular result and passed to the callback as `ozo::result`,
+ * so its rows may be received with `ozo::recv_result()` or read in place.
+ *
+ * The next page is prefetched: the FETCH of the next page (or CLOSE after the last page) is
+ * sent before the callback is called with the current page, so the database produces and
+ * transfers the next page while the current one is being processed. The next page is handled
+ * once both the callback and the FETCH have completed, so at most two pages are kept in memory
+ * whatever the size of the result is.
+ *
+ * The callback is called via the connection executor and should not use the connection.
+ * The time constraint is applied to each of the statements: DECLARE, each FETCH and CLOSE.
+ * If a statement fails, the operation completes with its error after the page being processed,
+ * the cursor is not closed then, but it is closed with the transaction.
+ *
+ * The cursor is declared with `ozo_cursor` name, so a transaction should not have another
+ * cursor open with it.
+ *
+ * @note The function does not participate in ADL since could be implemented via functional object.
+ *
+ * @param transaction --- transaction made by `ozo::begin()`; cursors exist within transactions only.
+ * @param query --- `Query` object to declare the cursor for.
+ * @param page_rows --- number of rows to fetch at once.
+ * @param time_constraint --- #TimeConstraint of each of the statements.
+ * @param on_page --- callable with `void(ozo::result)` signature.
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ *
+ * ###Example
+ *
+ * @code
+auto transaction = ozo::begin(pool[io], 1s, yield);
+ozo::rows_of<std::int64_t, std::string> rows;
+transaction = ozo::cursor(std::move(transaction), "SELECT id, name FROM users"_SQL, 10000, 1s,
+    [&] (ozo::result page) {
+        rows.clear();
+        ozo::recv_result(page, ozo::empty_oid_map{}, std::back_inserter(rows));
+        export_users(rows);
+    },
+    yield);
+auto conn = ozo::commit(std::move(transaction), 1s, yield);
+ * @endcode
+ */
+template <typename Transaction, typename Query, typename TimeConstraint, typename OnPage, typename CompletionToken>
+decltype(auto) cursor(Transaction&& transaction, Query&& query, std::size_t page_rows, TimeConstraint time_constraint,
+        OnPage on_page, CompletionToken&& token);
+
+/**
+ * @brief Pages through the query result with a server side cursor
+ *
+ * This function is time constrain free shortcut to `ozo::cursor()` function.
+ * Its call is equal to `ozo::cursor(transaction, query, page_rows, ozo::none, on_page, token)` call.
+ *
+ * @note The function does not participate in ADL since could be implemented via functional object.
+ *
+ * @param transaction --- transaction made by `ozo::begin()`.
+ * @param query --- `Query` object to declare the cursor for.
+ * @param page_rows --- number of rows to fetch at once.
+ * @param on_page --- callable with `void(ozo::result)` signature.
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ */
+template <typename Transaction, typename Query, typename OnPage, typename CompletionToken>
+decltype(auto) cursor(Transaction&& transaction, Query&& query, std::size_t page_rows, OnPage on_page,
+        CompletionToken&& token);
+#else
+
+template <typename Initiator>
+struct cursor_op : base_async_operation <cursor_op<Initiator>, Initiator> {
+    using base = typename cursor_op::base;
+    using base::base;
+
+    template <typename T, typename Q, typename TimeConstraint, typename OnPage, typename CompletionToken>
+    decltype(auto) operator() (T&& transaction, Q&& query, std::size_t page_rows, TimeConstraint t,
+            OnPage on_page, CompletionToken&& token) const {
+        static_assert(Connection<T>, "transaction should model Connection concept");
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        return async_initiate<CompletionToken, handler_signature<T>>(
+            get_operation_initiator(*this), token, std::forward<T>(transaction), t, std::forward<Q>(query),
+            page_rows, std::move(on_page));
+    }
+
+    template <typename T, typename Q, typename OnPage, typename CompletionToken>
+    decltype(auto) operator() (T&& transaction, Q&& query, std::size_t page_rows, OnPage on_page,
+            CompletionToken&& token) const {
+        return (*this)(std::forward<T>(transaction), std::forward<Q>(query), page_rows, none, std::move(on_page),
+            std::forward<CompletionToken>(token));
+    }
+
+    template <typename OtherInitiator>
+    constexpr static auto rebind_initiator(const OtherInitiator& other) {
+        return cursor_op<OtherInitiator>{other};
+    }
+};
+
+namespace detail {
+struct initiate_async_cursor {
+    template <typename Handler, typename T, typename TimeConstraint, typename Q, typename OnPage>
+    constexpr void operator()(Handler&& h, T&& transaction, TimeConstraint t, Q&& q, std::size_t page_rows,
+            OnPage on_page) const {
+        impl::async_cursor(std::forward<T>(transaction), std::forward<Q>(q), page_rows, t, std::move(on_page),
+            std::forward<Handler>(h));
+    }
+};
+} // namespace detail
+
+constexpr cursor_op<detail::initiate_async_cursor> cursor;
+
+#endif
+
+} // namespace ozo
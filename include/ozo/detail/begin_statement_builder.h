@@ -13,6 +13,7 @@
 #include <ozo/query_builder.h>
 #include <ozo/transaction_options.h>
 #include <type_traits>
+#include <utility>
 
 namespace ozo::detail {
 
@@ -73,6 +74,17 @@ struct begin_statement_builder {
             return query_prefix + (s + ... + hana::string_c<>);
         }));
     }
+
+    /**
+    * The statement type for the options type. Each supported option value is a type, so
+    * the text of the statement is a `hana::string` and the statement itself is an empty
+    * object which is not built for each transaction.
+    */
+    template <typename Options>
+    using statement_type = decltype(build(std::declval<const Options&>()));
+
+    template <typename Options>
+    constexpr static statement_type<Options> statement(const Options&) noexcept { return {};}
 };
 
 } // ozo::detail
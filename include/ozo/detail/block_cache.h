@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace ozo::detail {
+
+/**
+* Thread-local cache of free memory blocks of the same size. A block freed is kept in
+* the cache of the freeing thread up to the limit, so a steady flow of short-lived objects,
+* e.g. future states, is served without the heap. The blocks are freed on the thread exit.
+*/
+template <std::size_t Size, std::size_t Alignment = alignof(std::max_align_t)>
+class block_cache {
+    static_assert(Alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "over-aligned blocks are not supported");
+
+    struct node {
+        node* next;
+    };
+
+    static constexpr std::size_t block_size = Size < sizeof(node) ? sizeof(node) : Size;
+
+    struct free_list {
+        node* head = nullptr;
+        std::size_t size = 0;
+
+        ~free_list() {
+            while (head) {
+                ::operator delete(static_cast<void*>(std::exchange(head, head->next)));
+            }
+        }
+    };
+
+    static free_list& local() noexcept {
+        thread_local free_list list;
+        return list;
+    }
+
+public:
+    static constexpr std::size_t max_cached = 64;
+
+    static void* allocate() {
+        auto& list = local();
+        if (list.head) {
+            --list.size;
+            return std::exchange(list.head, list.head->next);
+        }
+        return ::operator new(block_size);
+    }
+
+    static void deallocate(void* p) noexcept {
+        auto& list = local();
+        if (list.size == max_cached) {
+            return ::operator delete(p);
+        }
+        list.head = new (p) node{list.head};
+        ++list.size;
+    }
+};
+
+} // namespace ozo::detail
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace ozo::detail {
+
+/**
+* Lock-free bounded queue by Dmitry Vyukov. Each cell has a sequence number which tells
+* the producers and the consumers whether the cell is free or filled for the current lap,
+* so a push or a pop costs one compare-and-swap of the position without any lock. The queue
+* is safe for any number of producers and consumers, so a producer may pop the oldest item
+* to make room for a new one. The capacity is rounded up to a power of two.
+*/
+template <typename T>
+class bounded_queue {
+public:
+    explicit bounded_queue(std::size_t capacity)
+    : mask_(round_up(capacity) - 1), cells_(std::make_unique<cell[]>(mask_ + 1)) {
+        for (std::size_t i = 0; i <= mask_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bounded_queue(const bounded_queue&) = delete;
+    bounded_queue& operator =(const bounded_queue&) = delete;
+
+    std::size_t capacity() const noexcept { return mask_ + 1;}
+
+    /**
+    * Checks if there are no items pushed or being pushed, may be stale under concurrent use.
+    */
+    bool empty() const noexcept {
+        return head_.load(std::memory_order_seq_cst) == tail_.load(std::memory_order_seq_cst);
+    }
+
+    /**
+    * Pushes the item into the queue.
+    *
+    * @return `false` if the queue is full, the item is left intact then.
+    */
+    bool try_push(T& item) {
+        auto pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            auto& c = cells_[pos & mask_];
+            const auto sequence = c.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    c.value.emplace(std::move(item));
+                    c.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+    * Pops the oldest item of the queue.
+    *
+    * @return the item or `std::nullopt` if the queue is empty.
+    */
+    std::optional<T> try_pop() {
+        auto pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            auto& c = cells_[pos & mask_];
+            const auto sequence = c.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    std::optional<T> result = std::move(c.value);
+                    c.value.reset();
+                    c.sequence.store(pos + mask_ + 1, std::memory_order_release);
+                    return result;
+                }
+            } else if (diff < 0) {
+                return std::nullopt;
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    struct cell {
+        std::atomic<std::size_t> sequence;
+        std::optional<T> value;
+    };
+
+    static std::size_t round_up(std::size_t v) noexcept {
+        std::size_t result = 2;
+        while (result < v) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    std::size_t mask_;
+    std::unique_ptr<cell[]> cells_;
+    alignas(64) std::atomic<std::size_t> tail_ {0};
+    alignas(64) std::atomic<std::size_t> head_ {0};
+};
+
+} // namespace ozo::detail
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <ozo/type_traits.h>
+#include <ozo/detail/endian.h>
+#include <ozo/detail/float.h>
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace ozo::detail {
+
+/**
+ * Fixed size binary representation of a type, which allows to send and receive
+ * a contiguous block of values, e.g. array elements or a result column, by a single
+ * pass with no stream and no per value dispatching. A specialization provides
+ * the `size` of the representation in bytes, `load()` and `store()` functions.
+ * The functions should have no branches where it is possible, so the compiler
+ * is able to vectorize the loop over the values.
+ */
+template <typename T, typename = std::void_t<>>
+struct bulk_item {};
+
+template <typename Raw>
+inline Raw load_big_endian(const char* in) noexcept {
+    Raw raw;
+    std::memcpy(&raw, in, sizeof(raw));
+    return static_cast<Raw>(convert_from_big_endian(raw));
+}
+
+template <typename Raw>
+inline void store_big_endian(Raw raw, char* out) noexcept {
+    const auto v = convert_to_big_endian(raw);
+    std::memcpy(out, &v, sizeof(v));
+}
+
+template <typename T, typename = std::void_t<>>
+struct bulk_arithmetic_raw { using type = std::make_unsigned_t<T>; };
+
+template <typename T>
+struct bulk_arithmetic_raw<T, Require<FloatingPoint<T>>> {
+    using type = std::make_unsigned_t<floating_point_integral_t<T>>;
+};
+
+/**
+ * Arithmetic types need the byte order conversion only.
+ */
+template <typename T>
+struct bulk_item<T, Require<(Integral<T> || FloatingPoint<T>)
+        && !std::is_same_v<T, bool> && (sizeof(T) > 1) && (sizeof(T) <= sizeof(std::uint64_t))>> {
+    using raw_type = typename bulk_arithmetic_raw<T>::type;
+
+    static constexpr std::size_t size = sizeof(T);
+
+    static T load(const char* in) noexcept {
+        const auto raw = load_big_endian<raw_type>(in);
+        T out;
+        std::memcpy(&out, &raw, sizeof(out));
+        return out;
+    }
+
+    static void store(const T& in, char* out) noexcept {
+        raw_type raw;
+        std::memcpy(&raw, &in, sizeof(raw));
+        store_big_endian(raw, out);
+    }
+};
+
+template <typename T, typename = std::void_t<>>
+struct is_bulk_item : std::false_type {};
+
+template <typename T>
+struct is_bulk_item<T, std::void_t<decltype(bulk_item<T>::size)>> : std::true_type {};
+
+template <typename T>
+inline constexpr auto BulkItem = is_bulk_item<std::decay_t<T>>::value;
+
+} // namespace ozo::detail
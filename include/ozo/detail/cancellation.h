@@ -0,0 +1,90 @@
+#pragma once
+
+#include <ozo/asio.h>
+
+#include <boost/version.hpp>
+
+#if BOOST_VERSION >= 107700
+#define OZO_HAS_CANCELLATION_SLOT 1
+#include <boost/asio/associated_cancellation_slot.hpp>
+#include <boost/asio/bind_cancellation_slot.hpp>
+#include <boost/asio/cancellation_type.hpp>
+#endif
+
+#include <type_traits>
+
+namespace ozo::detail {
+
+#ifdef OZO_HAS_CANCELLATION_SLOT
+
+/**
+ * Cancels IO on the stream when the cancellation slot associated with the handler is
+ * emitted, so the operation completes with `asio::error::operation_aborted`. The slot
+ * is consumed by the handler, i.e. it is not associated with the wrapper, and is cleared
+ * before the handler is called, so it may be reused by the next operation.
+ */
+template <typename Stream, typename Handler>
+class io_cancellation_handler {
+public:
+    io_cancellation_handler(Stream& stream, Handler handler)
+    : handler_(std::move(handler)), slot_(asio::get_associated_cancellation_slot(handler_)) {
+        if (slot_.is_connected()) {
+            slot_.assign([&stream] (asio::cancellation_type) { stream.cancel(); });
+        }
+    }
+
+    template <typename ...Args>
+    void operator() (Args&& ...args) {
+        slot_.clear();
+        handler_(std::forward<Args>(args)...);
+    }
+
+    using executor_type = asio::associated_executor_t<Handler>;
+
+    executor_type get_executor() const noexcept { return asio::get_associated_executor(handler_);}
+
+    using allocator_type = asio::associated_allocator_t<Handler>;
+
+    allocator_type get_allocator() const noexcept { return asio::get_associated_allocator(handler_);}
+
+private:
+    Handler handler_;
+    asio::cancellation_slot slot_;
+};
+
+#endif
+
+/**
+ * Binds cancellation of IO on the stream to the cancellation slot of the handler if
+ * Asio supports per-operation cancellation (Boost 1.77 or newer) and the slot is
+ * connected. Otherwise the handler is returned as is.
+ */
+template <typename Stream, typename Handler>
+inline auto bind_io_cancellation([[maybe_unused]] Stream& stream, Handler&& handler) {
+#ifdef OZO_HAS_CANCELLATION_SLOT
+    using handler_type = std::decay_t<Handler>;
+    if constexpr (!std::is_same_v<asio::associated_cancellation_slot_t<handler_type>, asio::cancellation_slot>) {
+        return std::forward<Handler>(handler);
+    } else {
+        return io_cancellation_handler<Stream, handler_type>{stream, std::forward<Handler>(handler)};
+    }
+#else
+    return std::forward<Handler>(handler);
+#endif
+}
+
+} // namespace ozo::detail
+
+#ifdef OZO_HAS_CANCELLATION_SLOT
+/**
+ * Forwards the cancellation slot of the wrapped handler, ozo handler wrappers declare
+ * it via the `cancellation_slot_type` and `get_cancellation_slot()` members.
+ */
+#define OZO_FORWARD_CANCELLATION_SLOT(handler) \
+    using cancellation_slot_type = boost::asio::associated_cancellation_slot_t<std::decay_t<decltype(handler)>>; \
+    cancellation_slot_type get_cancellation_slot() const noexcept { \
+        return boost::asio::get_associated_cancellation_slot(handler); \
+    }
+#else
+#define OZO_FORWARD_CANCELLATION_SLOT(handler)
+#endif
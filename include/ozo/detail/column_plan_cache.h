@@ -0,0 +1,62 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace ozo::detail {
+
+/**
+* Column plans of a prepared statement for the row types its results are received
+* into. All the results of a statement have the same columns, so the plan of a row
+* type is made once per statement and connection from the statement description
+* and the columns are not searched by names and their oids are not checked for
+* each result.
+*/
+class column_plan_cache {
+public:
+    /**
+    * Copies the plan of the row type into `plan`.
+    *
+    * @return `false` if there is no plan for the row type.
+    */
+    template <typename Row, std::size_t Size>
+    bool find(std::array<int, Size>& plan) const noexcept {
+        const auto i = std::find_if(plans_.begin(), plans_.end(),
+            [k = key<Row>()] (const entry& v) { return v.key == k; });
+        if (i == plans_.end() || i->plan.size() != Size) {
+            return false;
+        }
+        std::copy(i->plan.begin(), i->plan.end(), plan.begin());
+        return true;
+    }
+
+    template <typename Row, std::size_t Size>
+    void emplace(const std::array<int, Size>& plan) {
+        std::array<int, Size> found;
+        if (!find<Row>(found)) {
+            plans_.push_back(entry {key<Row>(), std::vector<int>(plan.begin(), plan.end())});
+        }
+    }
+
+    std::size_t size() const noexcept { return plans_.size();}
+
+    bool empty() const noexcept { return plans_.empty();}
+
+private:
+    // Unique address per row type
+    template <typename Row>
+    static const void* key() noexcept {
+        static const char tag = 0;
+        return &tag;
+    }
+
+    struct entry {
+        const void* key;
+        std::vector<int> plan;
+    };
+
+    std::vector<entry> plans_;
+};
+
+} // namespace ozo::detail
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <ozo/asio.h>
+#include <ozo/error.h>
+#include <ozo/time_traits.h>
+#include <ozo/core/none.h>
+#include <ozo/core/thread_safety.h>
+#include <ozo/detail/stub_mutex.h>
+
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/post.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace ozo::detail {
+
+/**
+ * Limits the number of concurrent connection attempts of a connection pool and
+ * delays the attempts after failures, so a database restart does not cause a storm
+ * of connects. Requests beyond the limit wait in the FIFO queue until an attempt
+ * completes or their deadline expires. After a failed attempt the next attempts
+ * start not earlier than the backoff delay which doubles with each consecutive
+ * failure up to the maximum and is reset by a successful attempt.
+ *
+ * The throttle is disabled with zero limit and zero backoff.
+ */
+template <typename Mutex>
+class connect_throttle {
+public:
+    connect_throttle(std::size_t limit, time_traits::duration backoff, time_traits::duration max_backoff)
+    : limit_(limit), backoff_(backoff), max_backoff_(std::max(backoff, max_backoff)) {}
+
+    bool enabled() const noexcept {
+        return limit_ != 0 || backoff_ != time_traits::duration::zero();
+    }
+
+    /**
+     * Waits for a permission to start a connection attempt. The handler is called with
+     * `void(error_code)` signature, with `boost::asio::error::timed_out` if the deadline
+     * has expired while waiting. After a successful wait `release()` must be called
+     * when the attempt is complete.
+     */
+    template <typename Executor, typename Deadline, typename Handler>
+    void async_acquire(const Executor& ex, Deadline deadline, Handler&& handler) {
+        using waiter_type = waiter<Executor, std::decay_t<Handler>>;
+        auto allocator = asio::get_associated_allocator(handler);
+        auto w = std::allocate_shared<waiter_type>(allocator, *this, ex, std::forward<Handler>(handler));
+
+        std::unique_lock<Mutex> lock(mutex_);
+        if (queue_.empty() && has_room()) {
+            ++active_;
+            const auto start = next_start_;
+            lock.unlock();
+            return w->grant(start);
+        }
+        queue_.push_back(w);
+        lock.unlock();
+        w->wait(deadline);
+    }
+
+    /**
+     * Completes a connection attempt and lets the next waiting request start its one.
+     */
+    void release(bool succeeded) {
+        std::vector<std::shared_ptr<waiter_base>> granted;
+        std::unique_lock<Mutex> lock(mutex_);
+        --active_;
+        if (succeeded) {
+            failures_ = 0;
+        } else {
+            ++failures_;
+            next_start_ = std::max(next_start_, time_traits::now() + backoff());
+        }
+        while (!queue_.empty() && has_room()) {
+            ++active_;
+            granted.push_back(std::move(queue_.front()));
+            queue_.pop_front();
+        }
+        const auto start = next_start_;
+        lock.unlock();
+        for (auto& w : granted) {
+            w->grant(start);
+        }
+    }
+
+    std::size_t active() const {
+        const std::lock_guard<Mutex> lock(mutex_);
+        return active_;
+    }
+
+    std::size_t waiting() const {
+        const std::lock_guard<Mutex> lock(mutex_);
+        return queue_.size();
+    }
+
+private:
+    struct waiter_base {
+        virtual void grant(time_traits::time_point start) = 0;
+        virtual ~waiter_base() = default;
+    };
+
+    /**
+     * Waiting request. All its handlers are executed by a strand, since the deadline
+     * timer and the grant may complete on different threads.
+     */
+    template <typename Executor, typename Handler>
+    struct waiter : waiter_base, std::enable_shared_from_this<waiter<Executor, Handler>> {
+        using timer_type = typename operation_timer<Executor>::type;
+
+        connect_throttle& throttle_;
+        Executor executor_;
+        strand<Executor> strand_;
+        std::optional<timer_type> deadline_timer_;
+        std::optional<timer_type> start_timer_;
+        Handler handler_;
+        bool granted_ = false;
+
+        waiter(connect_throttle& throttle, const Executor& ex, Handler handler)
+        : throttle_(throttle), executor_(ex), strand_(make_strand_executor(ex)), handler_(std::move(handler)) {}
+
+        template <typename Deadline>
+        void wait([[maybe_unused]] Deadline deadline) {
+            if constexpr (!std::is_same_v<Deadline, none_t>) {
+                asio::post(strand_, [self = this->shared_from_this(), deadline] {
+                    if (self->granted_) {
+                        return;
+                    }
+                    self->deadline_timer_.emplace(get_operation_timer(self->executor_, deadline));
+                    self->deadline_timer_->async_wait(asio::bind_executor(self->strand_,
+                        [self] (error_code ec) { self->on_deadline(ec); }));
+                });
+            }
+        }
+
+        void on_deadline(error_code ec) {
+            if (ec || granted_ || !throttle_.cancel(this)) {
+                return;
+            }
+            granted_ = true;
+            handler_(error_code{asio::error::timed_out});
+        }
+
+        void grant(time_traits::time_point start) override {
+            asio::post(strand_, [self = this->shared_from_this(), start] {
+                self->granted_ = true;
+                if (self->deadline_timer_) {
+                    self->deadline_timer_->cancel();
+                }
+                if (start <= time_traits::now()) {
+                    return self->handler_(error_code{});
+                }
+                self->start_timer_.emplace(get_operation_timer(self->executor_, start));
+                self->start_timer_->async_wait(asio::bind_executor(self->strand_,
+                    [self] (error_code) { self->handler_(error_code{}); }));
+            });
+        }
+    };
+
+    bool has_room() const noexcept {
+        return limit_ == 0 || active_ < limit_;
+    }
+
+    time_traits::duration backoff() const noexcept {
+        auto result = backoff_;
+        for (std::size_t i = 1; i < failures_ && result < max_backoff_; ++i) {
+            result *= 2;
+        }
+        return std::min(result, max_backoff_);
+    }
+
+    /**
+     * Removes the waiter from the queue. Returns `false` if it has been granted already.
+     */
+    bool cancel(const waiter_base* w) {
+        const std::lock_guard<Mutex> lock(mutex_);
+        const auto i = std::find_if(queue_.begin(), queue_.end(), [&] (const auto& v) { return v.get() == w; });
+        if (i == queue_.end()) {
+            return false;
+        }
+        queue_.erase(i);
+        return true;
+    }
+
+    mutable Mutex mutex_;
+    std::size_t limit_;
+    time_traits::duration backoff_;
+    time_traits::duration max_backoff_;
+    std::size_t active_ = 0;
+    std::size_t failures_ = 0;
+    time_traits::time_point next_start_ = {};
+    std::deque<std::shared_ptr<waiter_base>> queue_;
+};
+
+template <typename ThreadSafety>
+using connect_throttle_t = connect_throttle<std::conditional_t<ThreadSafety::value, std::mutex, stub_mutex>>;
+
+} // namespace ozo::detail
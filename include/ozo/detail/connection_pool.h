@@ -1,11 +1,29 @@
 #pragma once
 
+#include <ozo/asio.h>
+#include <ozo/core/histogram.h>
 #include <ozo/core/thread_safety.h>
 #include <ozo/detail/stub_mutex.h>
+#include <ozo/time_traits.h>
 
 #include <yamail/resource_pool/async/pool.hpp>
 
+#include <boost/asio/posix/stream_descriptor.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/intrusive_ptr.hpp>
+#include <boost/smart_ptr/intrusive_ref_counter.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <mutex>
+#include <optional>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace ozo::detail {
 
@@ -25,4 +43,608 @@ struct get_connection_pool_impl<ConnectionRepType, thread_safety<false>> {
 template <typename ConnectionRepType, typename ThreadSafety>
 using get_connection_pool_impl_t = typename get_connection_pool_impl<ConnectionRepType, std::decay_t<ThreadSafety>>::type;
 
+/**
+ * Pointer to a connection of the pool. A connection of the pool used by a single thread
+ * is counted intrusively with a plain integer, so the copies of the pointer along the
+ * handler chain cost no atomic operations. A connection of the thread safe pool is
+ * shared as before.
+ */
+template <typename Connection, typename ThreadSafety>
+struct get_pooled_connection_ptr {
+    using type = std::shared_ptr<Connection>;
+};
+
+template <typename Connection>
+struct get_pooled_connection_ptr<Connection, thread_safety<false>> {
+    using type = boost::intrusive_ptr<Connection>;
+};
+
+template <typename Connection, typename ThreadSafety>
+using get_pooled_connection_ptr_t = typename get_pooled_connection_ptr<Connection, std::decay_t<ThreadSafety>>::type;
+
+/**
+ * Reference counter of a connection which is pointed by `get_pooled_connection_ptr_t`.
+ */
+template <typename Connection, typename ThreadSafety>
+struct pooled_connection_ref_counter {};
+
+template <typename Connection>
+struct pooled_connection_ref_counter<Connection, thread_safety<false>>
+    : boost::intrusive_ref_counter<Connection, boost::thread_unsafe_counter> {};
+
+/**
+ * Counters of connection pool events. Each shard of the pool has its own counters
+ * placed in a separate cache line, so they are updated without contention between
+ * threads serving different shards.
+ */
+struct alignas(64) connection_pool_counters {
+    std::atomic<std::uint64_t> acquisitions {0};
+    std::atomic<std::uint64_t> reused {0};
+    std::atomic<std::uint64_t> created {0};
+    std::atomic<std::uint64_t> connect_errors {0};
+    std::atomic<std::uint64_t> closed_bad {0};
+    std::atomic<std::uint64_t> expired {0};
+    std::atomic<std::uint64_t> refreshed {0};
+    std::atomic<std::uint64_t> recycled {0};
+    std::atomic<std::uint64_t> queue_overflows {0};
+    std::atomic<std::uint64_t> queue_timeouts {0};
+    std::atomic<std::uint64_t> budget_rejections {0};
+    std::atomic<std::uint64_t> waiting {0};
+    atomic_latency_histogram wait_time;
+
+    static void increment(std::atomic<std::uint64_t>& counter) noexcept {
+        counter.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static void decrement(std::atomic<std::uint64_t>& counter) noexcept {
+        counter.fetch_sub(1, std::memory_order_relaxed);
+    }
+};
+
+inline std::uint64_t lifespan_random() {
+    static thread_local std::mt19937_64 engine(
+        static_cast<std::uint64_t>(time_traits::now().time_since_epoch().count())
+        ^ std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    return engine();
+}
+
+/**
+ * Lifespan of pooled connections. Each connection expires after the lifespan reduced
+ * by a random part of the jitter, so connections opened together do not expire together.
+ * A connection is due for the refresh within the `refresh_ahead` interval before its
+ * expiration.
+ *
+ * A connection is recycled after `max_requests` requests or once its backend has been
+ * found to use more than `max_backend_memory` bytes. The refresh replaces a connection
+ * which has served nine tenths of `max_requests` already, so with the refresh running
+ * the connections are recycled in the background before a request finds one exhausted.
+ */
+struct connection_lifespan {
+    time_traits::duration lifespan = time_traits::duration::max();
+    time_traits::duration jitter = time_traits::duration::zero();
+    time_traits::duration refresh_ahead = time_traits::duration::zero();
+    std::size_t max_requests = 0;
+    std::size_t max_backend_memory = 0;
+    time_traits::duration memory_check_interval = time_traits::duration::max();
+
+    time_traits::time_point expires_at(time_traits::time_point now) const {
+        auto result = lifespan;
+        if (const auto range = std::min(jitter, lifespan).count(); range > 0) {
+            result -= time_traits::duration(static_cast<time_traits::duration::rep>(
+                lifespan_random() % (static_cast<std::uint64_t>(range) + 1)));
+        }
+        if (result >= time_traits::time_point::max() - now) {
+            return time_traits::time_point::max();
+        }
+        return now + result;
+    }
+
+    bool expired(time_traits::time_point expires_at, time_traits::time_point now) const noexcept {
+        return now >= expires_at;
+    }
+
+    bool refresh_due(time_traits::time_point expires_at, time_traits::time_point now) const noexcept {
+        return refresh_ahead > time_traits::duration::zero()
+            && expires_at != time_traits::time_point::max()
+            && now >= expires_at - refresh_ahead;
+    }
+
+    template <typename Rep>
+    bool recycle_due(const Rep& rep) const noexcept {
+        return rep.recycle_requested() || (max_requests != 0 && rep.requests() >= max_requests);
+    }
+
+    template <typename Rep>
+    bool recycle_ahead_due(const Rep& rep) const noexcept {
+        return rep.recycle_requested() || (max_requests != 0 && rep.requests() >= max_requests - max_requests / 10);
+    }
+
+    bool memory_check_due(time_traits::time_point checked_at, time_traits::time_point now) const noexcept {
+        return max_backend_memory != 0 && now - checked_at >= memory_check_interval;
+    }
+};
+
+/**
+ * Settings of the connections provided by a pool, see `connection_pool_config`.
+ */
+struct pooled_connection_options {
+    time_traits::duration recovery_timeout = time_traits::duration::zero();
+    time_traits::duration cancel_on_timeout = time_traits::duration::zero();
+    bool propagate_deadline = false;
+    std::size_t max_result_size = 0;
+    time_traits::duration busy_poll = time_traits::duration::zero();
+    bool io_affinity = false;
+};
+
+/**
+ * Socket of an idle pooled connection which stays registered with the reactor of the
+ * `io_context` which has used the connection last, see `connection_pool_config::io_affinity`.
+ * The descriptor belongs to the `libpq` connection, so it is released, not closed, when
+ * the stream is dropped.
+ */
+class registered_stream {
+public:
+    using stream_type = asio::posix::stream_descriptor;
+
+    registered_stream() = default;
+    registered_stream(registered_stream&& other) noexcept { stream_.swap(other.stream_);}
+    registered_stream& operator =(registered_stream&& other) noexcept {
+        reset();
+        stream_.swap(other.stream_);
+        return *this;
+    }
+    ~registered_stream() { reset();}
+
+    void put(stream_type&& stream) {
+        reset();
+        stream_.emplace(std::move(stream));
+    }
+
+    /**
+     * Takes the stream of the descriptor if it is registered with the given context,
+     * otherwise releases it, so the descriptor may be registered with the context anew.
+     */
+    std::optional<stream_type> take(asio::io_context& io, stream_type::native_handle_type fd) {
+        std::optional<stream_type> result;
+        if (stream_ && std::addressof(stream_->get_executor().context()) == std::addressof(io)
+                && stream_->native_handle() == fd) {
+            result.swap(stream_);
+        }
+        reset();
+        return result;
+    }
+
+    bool empty() const noexcept { return !stream_;}
+
+    void reset() noexcept {
+        if (stream_) {
+            stream_->release();
+            stream_.reset();
+        }
+    }
+
+private:
+    std::optional<stream_type> stream_;
+};
+
+/**
+ * Rule of `connection_pool::adapt_capacity()`. The capacity grows by a quarter if
+ * the requests have waited for connections, i.e. there are waiting requests or the
+ * 90th percentile of the wait time exceeds the target, and shrinks by one if less than
+ * a half of it has been in use at the peak. So the pool follows a load rise quickly
+ * and releases the surplus connections gradually.
+ */
+struct capacity_adapter {
+    std::size_t min_capacity = 1;
+    std::size_t max_capacity = 1;
+    time_traits::duration target_wait_time = time_traits::duration::zero();
+
+    std::size_t next(std::size_t capacity, time_traits::duration wait_time, std::size_t waiting,
+            std::size_t peak) const noexcept {
+        if (waiting != 0 || wait_time > target_wait_time) {
+            capacity += std::max<std::size_t>(capacity / 4, 1);
+        } else if (peak * 2 < capacity) {
+            capacity -= 1;
+        }
+        return std::clamp(capacity, min_capacity, max_capacity);
+    }
+};
+
+/**
+ * Runtime capacity of a pool, see `connection_pool::set_capacity()`. The underlying
+ * pools are created with the maximum capacity and the current one limits the admissions
+ * of the deadline queues.
+ */
+struct pool_capacity {
+    capacity_adapter adapter;
+    std::atomic<std::size_t> current;
+    std::mutex mutex; // serializes the adaptations
+    latency_histogram wait_time; // at the previous adaptation
+
+    pool_capacity(const capacity_adapter& adapter, std::size_t current)
+    : adapter(adapter), current(current) {}
+
+    bool adjustable() const noexcept { return adapter.min_capacity != adapter.max_capacity;}
+};
+
+/**
+ * Idle connections of a pool shard kept in the most recently used order for
+ * `connection_pool_config::lifo`. The underlying pool reuses its idle connections
+ * in its own order, so a released connection is kept here instead and the next request
+ * takes the most recently released one. The connections at the bottom of the stack
+ * which have been idle for the idle timeout are closed, so the surplus connections
+ * expire when the load drops.
+ *
+ * A connection in the stack counts as used by the underlying pool, so a released connection
+ * is returned to the pool instead if there are requests waiting there. A request for
+ * a connection is passed to the pool under the lock of the stack only if the stack is
+ * empty, so no request starts waiting in the pool while the stack holds a connection.
+ *
+ * With `connection_pool_config::direct_handoff` a request which finds neither a connection
+ * in the stack nor an idle one or room for a new one in the pool waits in the stack, and a
+ * released connection is handed to the waiting request with the earliest deadline under
+ * the same lock, instead of being returned to the pool and dequeued from it there. Once
+ * a connection leaves the stack other way, e.g. it is closed or returned to the pool, or
+ * a new one fails to be established, the waiting requests are passed to the pool, so none
+ * of them waits for a connection which is not going to be released.
+ */
+template <typename Handle>
+struct handoff_waiter {
+    time_traits::time_point deadline;
+
+    explicit handoff_waiter(time_traits::time_point deadline) : deadline(deadline) {}
+
+    virtual void wait() = 0; //!< the request starts waiting in the stack, called under its lock
+    virtual void complete(Handle&& handle) = 0; //!< the released connection is handed to the request
+    virtual void request() = 0; //!< the request should get a connection from the pool
+    virtual ~handoff_waiter() = default;
+};
+
+template <typename Handle, typename Mutex>
+class idle_stack {
+public:
+    using waiter_ptr = std::shared_ptr<handoff_waiter<Handle>>;
+
+    template <typename Pool>
+    idle_stack(const Pool& pool, time_traits::duration idle_timeout, std::size_t max_waiters = 0)
+    : pool_(std::addressof(pool)),
+      has_waiters_([] (const void* p) { return static_cast<const Pool*>(p)->stats().wait_queue_size != 0;}),
+      exhausted_([] (const void* p) {
+          const auto pool = static_cast<const Pool*>(p);
+          return pool->available() == 0 && pool->size() >= pool->capacity();
+      }),
+      idle_timeout_(idle_timeout),
+      max_waiters_(max_waiters) {}
+
+    /**
+     * Takes the most recently released connection. If there is none, calls `request`
+     * to request a connection from the underlying pool and returns an empty handle.
+     */
+    template <typename Request>
+    Handle pop_or(time_traits::time_point now, Request&& request) {
+        const std::lock_guard lock(mutex_);
+        expire(now);
+        if (items_.empty()) {
+            request();
+            return Handle{};
+        }
+        auto result = std::move(items_.back().handle);
+        items_.pop_back();
+        return result;
+    }
+
+    /**
+     * Takes the most recently released connection. If there is none and the underlying
+     * pool has neither an idle connection nor room for a new one, the waiter waits for
+     * a released connection in the stack; otherwise it requests the pool. Returns an empty
+     * handle if there is no connection in the stack.
+     *
+     * @return `true` in the second member if the waiter waits in the stack.
+     */
+    std::pair<Handle, bool> pop_or_wait(time_traits::time_point now, const waiter_ptr& waiter) {
+        std::unique_lock lock(mutex_);
+        expire(now);
+        if (!items_.empty()) {
+            auto result = std::move(items_.back().handle);
+            items_.pop_back();
+            return {std::move(result), false};
+        }
+        if (pool_ != nullptr && waiters_.size() < max_waiters_ && exhausted_(pool_)) {
+            waiters_.push_back(waiter);
+            waiter->wait();
+            return {Handle{}, true};
+        }
+        waiter->request();
+        return {Handle{}, false};
+    }
+
+    /**
+     * Removes the waiter which deadline has expired.
+     *
+     * @return `false` if the waiter does not wait in the stack anymore.
+     */
+    bool cancel(const handoff_waiter<Handle>* waiter) {
+        const std::lock_guard lock(mutex_);
+        const auto it = std::find_if(waiters_.begin(), waiters_.end(),
+            [&] (const waiter_ptr& v) { return v.get() == waiter;});
+        if (it == waiters_.end()) {
+            return false;
+        }
+        waiters_.erase(it);
+        return true;
+    }
+
+    /**
+     * Keeps the released connection or hands it to the waiting request with the earliest
+     * deadline, the oldest one of the same deadline. Returns false and leaves the handle
+     * as is if there are requests waiting in the underlying pool or the stack is shut down.
+     */
+    bool push(Handle& handle, time_traits::time_point now) {
+        std::unique_lock lock(mutex_);
+        if (pool_ == nullptr) {
+            return false;
+        }
+        if (!waiters_.empty()) {
+            const auto it = std::min_element(waiters_.begin(), waiters_.end(),
+                [] (const waiter_ptr& lhs, const waiter_ptr& rhs) { return lhs->deadline < rhs->deadline;});
+            auto waiter = std::move(*it);
+            waiters_.erase(it);
+            lock.unlock();
+            waiter->complete(std::move(handle));
+            return true;
+        }
+        if (has_waiters_(pool_)) {
+            return false;
+        }
+        items_.push_back(item {std::move(handle), now});
+        expire(now);
+        return true;
+    }
+
+    /**
+     * Passes the waiting requests to the underlying pool, e.g. when a connection is
+     * closed instead of being released to the stack, so the pool has room for a new one.
+     */
+    void wake() {
+        std::vector<waiter_ptr> waiters;
+        {
+            const std::lock_guard lock(mutex_);
+            waiters.swap(waiters_);
+        }
+        for (auto& waiter : waiters) {
+            waiter->request();
+        }
+    }
+
+    /**
+     * Returns all the connections to the underlying pool.
+     */
+    void flush() {
+        std::vector<item> items;
+        {
+            const std::lock_guard lock(mutex_);
+            items.swap(items_);
+        }
+        items.clear();
+        wake();
+    }
+
+    /**
+     * Returns all the connections to the underlying pool and stops keeping the
+     * released ones, so the stack does not refer to the pool anymore.
+     */
+    void shutdown() {
+        {
+            const std::lock_guard lock(mutex_);
+            pool_ = nullptr;
+        }
+        flush();
+    }
+
+    std::size_t size() const {
+        const std::lock_guard lock(mutex_);
+        return items_.size();
+    }
+
+    std::size_t waiting() const {
+        const std::lock_guard lock(mutex_);
+        return waiters_.size();
+    }
+
+private:
+    struct item {
+        Handle handle;
+        time_traits::time_point released_at;
+    };
+
+    void expire(time_traits::time_point now) {
+        const auto end = std::find_if(items_.begin(), items_.end(),
+            [&] (const item& v) { return now - v.released_at < idle_timeout_;});
+        std::for_each(items_.begin(), end, [] (item& v) { v.handle.waste();});
+        items_.erase(items_.begin(), end);
+    }
+
+    mutable Mutex mutex_;
+    const void* pool_;
+    bool (*has_waiters_)(const void*);
+    bool (*exhausted_)(const void*);
+    time_traits::duration idle_timeout_;
+    std::size_t max_waiters_;
+    std::vector<item> items_;
+    std::vector<waiter_ptr> waiters_;
+};
+
+template <typename Handle, typename ThreadSafety>
+using idle_stack_t = idle_stack<Handle, std::conditional_t<ThreadSafety::value, std::mutex, stub_mutex>>;
+
+/**
+ * `ConnectionSource` which requests connections of the given priority class from a pool.
+ */
+template <typename Pool>
+struct prioritized_source {
+    using connection_type = typename Pool::connection_type;
+
+    Pool* pool_;
+    std::size_t priority_;
+
+    template <typename TimeConstraint, typename Handler>
+    void operator ()(io_context& io, TimeConstraint t, Handler&& handler) const {
+        (*pool_)(io, t, std::forward<Handler>(handler), priority_);
+    }
+};
+
+/**
+ * State of the background task of `connection_pool::start_maintenance()`. The timer
+ * is used only via the strand. The task holds the state, so the pool just sets the
+ * flag and cancels the timer to stop it, the task never touches the pool afterwards.
+ */
+struct pool_maintenance : std::enable_shared_from_this<pool_maintenance> {
+    asio::strand<io_context::executor_type> strand;
+    asio::steady_timer timer;
+    std::atomic<bool> stopped {false};
+
+    explicit pool_maintenance(io_context& io)
+    : strand(asio::make_strand(io)), timer(io) {}
+
+    void stop() {
+        stopped.store(true);
+        asio::post(strand, [self = shared_from_this()] { self->timer.cancel(); });
+    }
+};
+
+/**
+ * Set of independent pools (shards) each of which serves requests from its own
+ * `io_context`, so threads running different contexts do not contend on the same
+ * pool mutex. The first `io_context` objects which request a connection take
+ * free shards, the rest of them share the shard chosen by the context address.
+ * A request is passed to another shard which has an available connection if the
+ * own shard has no available connections and no room to create a new one.
+ *
+ * The total capacity and queue capacity are spread across the shards.
+ */
+template <typename Pool>
+class connection_pool_shards {
+public:
+    using pool_type = Pool;
+
+    template <typename ...Args>
+    connection_pool_shards(std::size_t count, std::size_t capacity, std::size_t queue_capacity, Args&& ...args)
+    : owners_(std::max(std::min(count, capacity), std::size_t(1))) {
+        const auto n = owners_.size();
+        pools_.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            pools_.emplace_back(std::make_unique<pool_type>(
+                share(capacity, i, n), share(queue_capacity, i, n), args...));
+        }
+    }
+
+    std::size_t size() const noexcept { return pools_.size();}
+
+    /**
+     * Get part of the total count which belongs to the `i`-th shard, the same way
+     * as the capacity is spread.
+     */
+    std::size_t share(std::size_t total, std::size_t i) const noexcept {
+        return share(total, i, pools_.size());
+    }
+
+    pool_type& operator [](std::size_t i) noexcept { return *pools_[i];}
+    const pool_type& operator [](std::size_t i) const noexcept { return *pools_[i];}
+
+    /**
+     * Get index of the shard which serves requests from the given context.
+     */
+    template <typename IoContext>
+    std::size_t index(const IoContext& io) noexcept {
+        const auto n = pools_.size();
+        if (n == 1) {
+            return 0;
+        }
+        const void* const key = std::addressof(io);
+        const auto first = static_cast<std::size_t>(
+            reinterpret_cast<std::uintptr_t>(key) / alignof(IoContext)) % n;
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto slot = (first + i) % n;
+            const void* owner = owners_[slot].load(std::memory_order_acquire);
+            if (owner == nullptr && owners_[slot].compare_exchange_strong(owner, key, std::memory_order_acq_rel)) {
+                return slot;
+            }
+            if (owner == key) {
+                return slot;
+            }
+        }
+        return first;
+    }
+
+    /**
+     * Bind the context to the given shard, so `index()` returns it for the context.
+     *
+     * @return `false` if the shard is bound to another context.
+     */
+    template <typename IoContext>
+    bool bind(const IoContext& io, std::size_t slot) noexcept {
+        const void* const key = std::addressof(io);
+        const void* owner = nullptr;
+        return owners_[slot].compare_exchange_strong(owner, key, std::memory_order_acq_rel) || owner == key;
+    }
+
+    /**
+     * Get index of the shard to take a connection from for the given context: its own
+     * shard or the nearest one with an available connection if the own shard is exhausted,
+     * so with the shards bound to the contexts in the order of CPU cores the neighbouring
+     * cores are tried first.
+     */
+    template <typename IoContext>
+    std::size_t select(const IoContext& io) noexcept {
+        const auto own = index(io);
+        if (!exhausted(*pools_[own])) {
+            return own;
+        }
+        const auto n = pools_.size();
+        for (std::size_t distance = 1; distance <= n / 2; ++distance) {
+            const auto next = (own + distance) % n;
+            if (pools_[next]->available() > 0) {
+                return next;
+            }
+            const auto prev = (own + n - distance) % n;
+            if (prev != next && pools_[prev]->available() > 0) {
+                return prev;
+            }
+        }
+        return own;
+    }
+
+    /**
+     * Get the shard to take a connection from for the given context.
+     */
+    template <typename IoContext>
+    pool_type& get(const IoContext& io) noexcept {
+        return *pools_[select(io)];
+    }
+
+    auto stats() const {
+        auto result = pools_.front()->stats();
+        std::for_each(std::next(pools_.begin()), pools_.end(), [&] (const auto& pool) {
+            const auto v = pool->stats();
+            result.size += v.size;
+            result.available += v.available;
+            result.used += v.used;
+            result.wait_queue_size += v.wait_queue_size;
+        });
+        return result;
+    }
+
+private:
+    static std::size_t share(std::size_t total, std::size_t i, std::size_t n) noexcept {
+        return total / n + (i < total % n ? 1 : 0);
+    }
+
+    static bool exhausted(const pool_type& pool) noexcept {
+        return pool.available() == 0 && pool.size() >= pool.capacity();
+    }
+
+    std::vector<std::unique_ptr<pool_type>> pools_;
+    std::vector<std::atomic<const void*>> owners_;
+};
+
 } // namespace ozo::detail
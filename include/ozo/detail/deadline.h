@@ -4,26 +4,42 @@
 #include <ozo/error.h>
 #include <ozo/deadline.h>
 #include <ozo/detail/bind.h>
+#include <ozo/detail/operation_slab.h>
 
 #include <boost/asio/dispatch.hpp>
 
+#include <optional>
+
 namespace ozo::detail {
 
-template <typename Stream, typename Handler, typename Result>
+/**
+* Completes the operation with `asio::error::timed_out` on the deadline expiration by
+* cancelling IO on the stream. With a `ServerCancel` functor and non-zero grace period the
+* functor is called first with `bool(Stream&)` signature to send a cancel request to the
+* server. Then the operation is given the grace period to complete, e.g. to receive the
+* error of the cancelled query, so the stream is left in a usable state. IO is cancelled
+* if the grace period expires or the functor returns `false`.
+*/
+template <typename Stream, typename Handler, typename Result, typename ServerCancel = none_t>
 class io_deadline_handler {
 public:
     template <typename TimeConstraint>
-    io_deadline_handler (Stream& stream, const TimeConstraint& t, Handler handler)
+    io_deadline_handler (Stream& stream, const TimeConstraint& t, Handler handler,
+            ServerCancel server_cancel = ServerCancel{}, time_traits::duration grace = time_traits::duration::zero())
     : timer_(ozo::detail::get_operation_timer(stream.get_executor(), t)) {
-        auto allocator = asio::get_associated_allocator(handler);
-        ctx_ = std::allocate_shared<context>(allocator, stream, std::move(handler));
+        auto allocator = detail::get_operation_allocator(stream, handler);
+        ctx_ = std::allocate_shared<context>(allocator, stream, std::move(handler), std::move(server_cancel), grace);
         timer_.async_wait(timer_handler{ctx_});
     }
 
     void operator() (error_code ec, Result result) {
         if (--ctx_->first_call) {
             timer_.cancel();
-            ctx_->ec = std::move(ec);
+            if (ctx_->grace_timer) {
+                ctx_->grace_timer->cancel();
+            } else {
+                ctx_->ec = std::move(ec);
+            }
             ctx_->result = std::move(result);
             ctx_.reset();
         } else {
@@ -51,9 +67,12 @@ private:
         Result result;
         error_code ec;
         std::atomic<long int> first_call{2};
+        ServerCancel server_cancel;
+        time_traits::duration grace;
+        std::optional<timer_type> grace_timer;
 
-        context(Stream& stream, Handler&& handler)
-        : stream(stream), handler(std::move(handler)) {
+        context(Stream& stream, Handler&& handler, ServerCancel&& server_cancel, time_traits::duration grace)
+        : stream(stream), handler(std::move(handler)), server_cancel(std::move(server_cancel)), grace(grace) {
         }
     };
 
@@ -70,6 +89,15 @@ private:
         allocator_type get_allocator() const noexcept { return asio::get_associated_allocator(ctx_->handler);}
 
         void operator() (error_code) {
+            if constexpr (!IsNone<ServerCancel>) {
+                if (ctx_->first_call == 2 && !ctx_->grace_timer && ctx_->grace > time_traits::duration::zero()
+                        && ctx_->server_cancel(ctx_->stream)) {
+                    ctx_->ec = asio::error::timed_out;
+                    ctx_->grace_timer.emplace(ozo::detail::get_operation_timer(ctx_->stream.get_executor(), ctx_->grace));
+                    ctx_->grace_timer->async_wait(timer_handler{ctx_});
+                    return;
+                }
+            }
             if (--ctx_->first_call) {
                 ctx_->stream.cancel();
                 ctx_->ec = asio::error::timed_out;
@@ -0,0 +1,371 @@
+#pragma once
+
+#include <ozo/asio.h>
+#include <ozo/error.h>
+#include <ozo/time_traits.h>
+#include <ozo/core/none.h>
+#include <ozo/core/thread_safety.h>
+#include <ozo/detail/cancellation.h>
+#include <ozo/detail/stub_mutex.h>
+
+#include <yamail/resource_pool/async/pool.hpp>
+
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/post.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace ozo::detail {
+
+/**
+ * Settings of a priority class of `deadline_queue`.
+ */
+struct deadline_queue_class {
+    std::size_t queue_capacity = 0; //!< maximum number of waiting requests of the class
+    std::size_t reserved = 0; //!< number of admissions available to the class only
+};
+
+/**
+ * Admits requests of a connection pool shard up to its capacity and keeps the rest
+ * waiting in the order of their deadlines, the earliest first; requests without a
+ * deadline follow them in the FIFO order. A waiting request is completed with
+ * `yamail::resource_pool::error::get_resource_timeout` as soon as its deadline
+ * expires, and a request with the expired deadline is not admitted at all, so
+ * a connection is never spent on a request which cannot use it. A request beyond
+ * the queue capacity is completed with `yamail::resource_pool::error::request_queue_overflow`.
+ *
+ * Requests may belong to priority classes, the first class has the highest priority.
+ * Each class has its own queue capacity and a number of reserved admissions which
+ * requests of other classes can not take; the rest of admissions are shared. The waiting
+ * requests of a class are admitted before the ones of the classes with lower priority.
+ *
+ * An admitted request gets a slot which returns the admission to the queue on its
+ * destruction. The queue must be owned by `std::shared_ptr`, the slots share it.
+ */
+template <typename Mutex>
+class deadline_queue : public std::enable_shared_from_this<deadline_queue<Mutex>> {
+public:
+    using slot_type = std::shared_ptr<void>;
+
+    deadline_queue(std::size_t limit, std::size_t capacity)
+    : deadline_queue(limit, {deadline_queue_class{capacity, 0}}) {}
+
+    /**
+     * @param limit --- maximum number of admitted requests, 0 means unlimited.
+     * @param classes --- priority classes, the first one has the highest priority;
+     *                    reservations beyond the limit are cut.
+     * @param order_by_deadline --- order waiting requests of a class by deadline, otherwise by arrival.
+     */
+    deadline_queue(std::size_t limit, const std::vector<deadline_queue_class>& classes, bool order_by_deadline = true)
+    : limit_(limit), order_by_deadline_(order_by_deadline) {
+        std::size_t reserved = 0;
+        classes_.reserve(std::max<std::size_t>(classes.size(), 1));
+        for (const auto& v : classes) {
+            auto& c = classes_.emplace_back();
+            c.queue_capacity = v.queue_capacity;
+            c.reserved = limit_ == 0 ? 0 : std::min(v.reserved, limit_ - reserved);
+            reserved += c.reserved;
+        }
+        if (classes_.empty()) {
+            classes_.emplace_back();
+        }
+    }
+
+    /**
+     * Waits for the admission. The handler is called with `void(error_code, slot_type)`
+     * signature, the slot is empty on error. The priority beyond the number of classes
+     * means the last class.
+     */
+    template <typename Executor, typename Deadline, typename Handler>
+    void async_acquire(const Executor& ex, Deadline deadline, Handler&& handler, std::size_t priority = 0) {
+        using waiter_type = waiter<Executor, std::decay_t<Handler>>;
+        auto allocator = asio::get_associated_allocator(handler);
+        auto w = std::allocate_shared<waiter_type>(allocator, this->shared_from_this(), ex,
+            std::forward<Handler>(handler));
+
+        const auto at = expiration(deadline);
+        if (at <= time_traits::now()) {
+            return w->complete(yamail::resource_pool::error::get_resource_timeout, slot_type{});
+        }
+
+        priority = std::min(priority, classes_.size() - 1);
+        std::unique_lock<Mutex> lock(mutex_);
+        auto& c = classes_[priority];
+        if (c.queue.empty() && has_room(c)) {
+            ++c.active;
+            count_admission();
+            lock.unlock();
+            return w->complete(error_code{}, make_slot(priority));
+        }
+        if (c.queue.size() >= c.queue_capacity) {
+            lock.unlock();
+            return w->complete(yamail::resource_pool::error::request_queue_overflow, slot_type{});
+        }
+        w->priority_ = priority;
+        w->key_ = key_type{order_by_deadline_ ? at : time_traits::time_point::max(), next_++};
+        w->bind_cancellation();
+        c.queue.emplace(w->key_, w);
+        lock.unlock();
+        w->wait(deadline);
+    }
+
+    /**
+     * Completes the waiting requests with `boost::asio::error::operation_aborted`,
+     * called on the pool destruction.
+     */
+    void shutdown() {
+        std::vector<std::shared_ptr<waiter_base>> aborted;
+        std::unique_lock<Mutex> lock(mutex_);
+        for (auto& c : classes_) {
+            for (auto& v : c.queue) {
+                aborted.push_back(std::move(v.second));
+            }
+            c.queue.clear();
+        }
+        lock.unlock();
+        for (auto& w : aborted) {
+            w->complete(asio::error::operation_aborted, slot_type{});
+        }
+    }
+
+    /**
+     * Changes the maximum number of admitted requests; the waiting requests are admitted
+     * if it grows. The requests admitted beyond the new limit keep their admissions.
+     */
+    void set_limit(std::size_t limit) {
+        std::vector<std::pair<std::shared_ptr<waiter_base>, std::size_t>> admitted;
+        std::unique_lock<Mutex> lock(mutex_);
+        limit_ = limit;
+        admit_waiting(admitted);
+        lock.unlock();
+        for (auto& [w, i] : admitted) {
+            w->complete(error_code{}, make_slot(i));
+        }
+    }
+
+    std::size_t limit() const {
+        const std::lock_guard<Mutex> lock(mutex_);
+        return limit_;
+    }
+
+    /**
+     * Returns the maximum number of simultaneously admitted requests since the previous
+     * call and starts the next period with the current number.
+     */
+    std::size_t take_peak() {
+        const std::lock_guard<Mutex> lock(mutex_);
+        return std::exchange(peak_, active_);
+    }
+
+    std::size_t active() const {
+        const std::lock_guard<Mutex> lock(mutex_);
+        return active_;
+    }
+
+    std::size_t waiting() const {
+        const std::lock_guard<Mutex> lock(mutex_);
+        return std::accumulate(classes_.begin(), classes_.end(), std::size_t(0),
+            [] (std::size_t n, const auto& c) { return n + c.queue.size(); });
+    }
+
+    std::size_t active(std::size_t priority) const {
+        const std::lock_guard<Mutex> lock(mutex_);
+        return classes_.at(priority).active;
+    }
+
+    std::size_t waiting(std::size_t priority) const {
+        const std::lock_guard<Mutex> lock(mutex_);
+        return classes_.at(priority).queue.size();
+    }
+
+private:
+    using key_type = std::tuple<time_traits::time_point, std::uint64_t>;
+
+    struct waiter_base {
+        std::size_t priority_ = 0;
+        key_type key_;
+
+        virtual void complete(error_code ec, slot_type slot) = 0;
+        virtual ~waiter_base() = default;
+    };
+
+    /**
+     * Waiting request. All its handlers are executed by a strand, since the deadline
+     * timer and the admission may complete on different threads.
+     */
+    template <typename Executor, typename Handler>
+    struct waiter : waiter_base, std::enable_shared_from_this<waiter<Executor, Handler>> {
+        using timer_type = typename operation_timer<Executor>::type;
+
+        std::shared_ptr<deadline_queue> queue_;
+        Executor executor_;
+        strand<Executor> strand_;
+        std::optional<timer_type> deadline_timer_;
+        Handler handler_;
+        bool completed_ = false;
+
+        waiter(std::shared_ptr<deadline_queue> queue, const Executor& ex, Handler handler)
+        : queue_(std::move(queue)), executor_(ex), strand_(make_strand_executor(ex)), handler_(std::move(handler)) {}
+
+        template <typename Deadline>
+        void wait([[maybe_unused]] Deadline deadline) {
+            if constexpr (!std::is_same_v<Deadline, none_t>) {
+                asio::post(strand_, [self = this->shared_from_this(), deadline] {
+                    if (self->completed_) {
+                        return;
+                    }
+                    self->deadline_timer_.emplace(get_operation_timer(self->executor_, deadline));
+                    self->deadline_timer_->async_wait(asio::bind_executor(self->strand_,
+                        [self] (error_code ec) { self->on_deadline(ec); }));
+                });
+            }
+        }
+
+        void on_deadline(error_code ec) {
+            if (ec || completed_ || !queue_->cancel(this->priority_, this->key_)) {
+                return;
+            }
+            completed_ = true;
+            clear_cancellation();
+            handler_(error_code{yamail::resource_pool::error::get_resource_timeout}, slot_type{});
+        }
+
+        void complete(error_code ec, slot_type slot) override {
+            asio::post(strand_, [self = this->shared_from_this(), ec, slot = std::move(slot)] () mutable {
+                self->completed_ = true;
+                if (self->deadline_timer_) {
+                    self->deadline_timer_->cancel();
+                }
+                self->clear_cancellation();
+                self->handler_(std::move(ec), std::move(slot));
+            });
+        }
+
+#ifdef OZO_HAS_CANCELLATION_SLOT
+        asio::cancellation_slot cancellation_slot_;
+
+        /**
+         * Removes the request from the queue when the cancellation slot associated with
+         * the handler is emitted, the request is completed with `asio::error::operation_aborted`.
+         */
+        void bind_cancellation() {
+            cancellation_slot_ = asio::get_associated_cancellation_slot(handler_);
+            if (cancellation_slot_.is_connected()) {
+                cancellation_slot_.assign([weak = std::weak_ptr<waiter>(this->shared_from_this())] (asio::cancellation_type) {
+                    if (auto self = weak.lock()) {
+                        asio::post(self->strand_, [self] { self->on_cancel(); });
+                    }
+                });
+            }
+        }
+
+        void on_cancel() {
+            if (completed_ || !queue_->cancel(this->priority_, this->key_)) {
+                return;
+            }
+            completed_ = true;
+            if (deadline_timer_) {
+                deadline_timer_->cancel();
+            }
+            clear_cancellation();
+            handler_(error_code{asio::error::operation_aborted}, slot_type{});
+        }
+
+        void clear_cancellation() { cancellation_slot_.clear();}
+#else
+        void bind_cancellation() {}
+
+        void clear_cancellation() {}
+#endif
+    };
+
+    struct priority_class {
+        std::size_t queue_capacity = 0;
+        std::size_t reserved = 0;
+        std::size_t active = 0;
+        std::map<key_type, std::shared_ptr<waiter_base>> queue;
+    };
+
+    static time_traits::time_point expiration(time_traits::time_point deadline) noexcept { return deadline;}
+
+    static time_traits::time_point expiration(none_t) noexcept { return time_traits::time_point::max();}
+
+    /**
+     * A class takes its reserved admissions first, then the shared ones which are
+     * not covered by the reservations of the other classes.
+     */
+    bool has_room(const priority_class& c) const noexcept {
+        if (limit_ == 0 || c.active < c.reserved) {
+            return true;
+        }
+        const auto used = std::accumulate(classes_.begin(), classes_.end(), std::size_t(0),
+            [] (std::size_t n, const auto& v) { return n + std::max(v.active, v.reserved); });
+        return used < limit_;
+    }
+
+    slot_type make_slot(std::size_t priority) {
+        return slot_type(nullptr, [self = this->shared_from_this(), priority] (auto) { self->release(priority); });
+    }
+
+    /**
+     * Returns the admission and passes the free admissions to the waiting requests
+     * in the order of priority.
+     */
+    void release(std::size_t priority) {
+        std::vector<std::pair<std::shared_ptr<waiter_base>, std::size_t>> admitted;
+        std::unique_lock<Mutex> lock(mutex_);
+        --classes_[priority].active;
+        --active_;
+        admit_waiting(admitted);
+        lock.unlock();
+        for (auto& [w, i] : admitted) {
+            w->complete(error_code{}, make_slot(i));
+        }
+    }
+
+    void admit_waiting(std::vector<std::pair<std::shared_ptr<waiter_base>, std::size_t>>& admitted) {
+        for (std::size_t i = 0; i < classes_.size(); ++i) {
+            auto& c = classes_[i];
+            while (!c.queue.empty() && has_room(c)) {
+                ++c.active;
+                count_admission();
+                admitted.emplace_back(std::move(c.queue.begin()->second), i);
+                c.queue.erase(c.queue.begin());
+            }
+        }
+    }
+
+    void count_admission() noexcept {
+        peak_ = std::max(peak_, ++active_);
+    }
+
+    /**
+     * Removes the waiter from the queue. Returns `false` if it has been admitted already.
+     */
+    bool cancel(std::size_t priority, const key_type& key) {
+        const std::lock_guard<Mutex> lock(mutex_);
+        return classes_[priority].queue.erase(key) != 0;
+    }
+
+    mutable Mutex mutex_;
+    std::size_t limit_;
+    bool order_by_deadline_;
+    std::uint64_t next_ = 0;
+    std::size_t active_ = 0;
+    std::size_t peak_ = 0;
+    std::vector<priority_class> classes_;
+};
+
+template <typename ThreadSafety>
+using deadline_queue_t = deadline_queue<std::conditional_t<ThreadSafety::value, std::mutex, stub_mutex>>;
+
+} // namespace ozo::detail
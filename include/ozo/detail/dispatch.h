@@ -0,0 +1,51 @@
+#pragma once
+
+#include <ozo/asio.h>
+
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/post.hpp>
+
+#include <cstddef>
+
+namespace ozo::detail {
+
+/**
+ * Maximum number of completion handlers which may be invoked inline one from another
+ * on a thread, see `ozo::detail::dispatch_completion()`.
+ */
+inline constexpr std::size_t max_completion_depth = 16;
+
+inline std::size_t& completion_depth() noexcept {
+    thread_local std::size_t v = 0;
+    return v;
+}
+
+struct completion_depth_guard {
+    std::size_t& depth;
+
+    completion_depth_guard() noexcept : depth(completion_depth()) { ++depth;}
+    ~completion_depth_guard() { --depth;}
+
+    completion_depth_guard(const completion_depth_guard&) = delete;
+    completion_depth_guard& operator =(const completion_depth_guard&) = delete;
+};
+
+/**
+ * Invokes a completion handler via its associated executor. The handler runs inline
+ * if the calling thread already runs in the executor, e.g. a single thread `io_context`
+ * without a strand, so a stage of an operation does not take a scheduler round trip.
+ * Otherwise it is posted as `asio::dispatch()` does. A chain of operations which complete
+ * one from another inline, e.g. a loop of requests failing at once, may grow the stack
+ * without a bound, so once `max_completion_depth` handlers are nested on the thread the
+ * handler is posted instead, which unwinds the stack.
+ */
+template <typename Handler>
+inline void dispatch_completion(Handler&& handler) {
+    if (completion_depth() >= max_completion_depth) {
+        return asio::post(std::forward<Handler>(handler));
+    }
+    completion_depth_guard guard;
+    asio::dispatch(std::forward<Handler>(handler));
+}
+
+} // namespace ozo::detail
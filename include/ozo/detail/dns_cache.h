@@ -0,0 +1,62 @@
+#pragma once
+
+#include <ozo/time_traits.h>
+
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace ozo::detail {
+
+/**
+* Addresses resolved for the host names of a connection source. The cache is
+* shared by the connections of the source so a reconnect does not resolve the
+* host again until the addresses expire.
+*/
+class dns_cache {
+public:
+    explicit dns_cache(time_traits::duration ttl) : ttl_(ttl) {}
+
+    std::optional<std::vector<std::string>> find(std::string_view host, time_traits::time_point now) const {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        const auto i = entries_.find(std::string(host));
+        if (i == entries_.end() || i->second.expires <= now) {
+            return std::nullopt;
+        }
+        return i->second.addresses;
+    }
+
+    void insert(std::string host, std::vector<std::string> addresses, time_traits::time_point now) {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        entries_.insert_or_assign(std::move(host), entry {std::move(addresses), now + ttl_});
+    }
+
+    /**
+    * Removes all the resolved addresses, e.g. when the database has been moved
+    * to other hosts and the connections should not wait for the expiration.
+    */
+    void clear() {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        entries_.clear();
+    }
+
+    std::size_t size() const {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        return entries_.size();
+    }
+
+private:
+    struct entry {
+        std::vector<std::string> addresses;
+        time_traits::time_point expires;
+    };
+
+    time_traits::duration ttl_;
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, entry> entries_;
+};
+
+} // namespace ozo::detail
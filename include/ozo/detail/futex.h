@@ -0,0 +1,54 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#ifdef __linux__
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace ozo::detail {
+
+/**
+* Blocks the thread while the word is equal to the expected value, until a wake up or
+* the timeout. May return spuriously, so the caller checks the word in a loop. Where
+* the futex is not available the thread sleeps for a short time instead.
+*/
+inline void futex_wait(std::atomic<std::uint32_t>& word, std::uint32_t expected,
+        std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max()) noexcept {
+    static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t));
+#ifdef __linux__
+    timespec ts {};
+    const timespec* ts_ptr = nullptr;
+    if (timeout != std::chrono::nanoseconds::max()) {
+        ts.tv_sec = static_cast<std::time_t>(timeout.count() / 1000000000);
+        ts.tv_nsec = static_cast<long>(timeout.count() % 1000000000);
+        ts_ptr = &ts;
+    }
+    ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, ts_ptr, nullptr, 0);
+#else
+    if (word.load(std::memory_order_acquire) == expected) {
+        std::this_thread::sleep_for(std::min<std::chrono::nanoseconds>(timeout, std::chrono::microseconds(50)));
+    }
+#endif
+}
+
+/**
+* Wakes up all the threads blocked in `futex_wait()` on the word.
+*/
+inline void futex_wake_all(std::atomic<std::uint32_t>& word) noexcept {
+#ifdef __linux__
+    ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#else
+    (void)word;
+#endif
+}
+
+} // namespace ozo::detail
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <ozo/detail/statement_cache.h>
+#include <ozo/detail/statement_key.h>
+
+#include <libpq-fe.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace ozo::detail {
+
+/**
+* Statement to be prepared by a newly opened connection.
+*/
+struct warm_statement {
+    std::string text;
+    std::vector<::Oid> types;
+    std::optional<std::uint64_t> id; // of the statement_key, the name is made of it
+    std::shared_ptr<statement_usage> usage;
+};
+
+/**
+* Most frequently executed prepared statements of the connections made by the same
+* `ozo::connection_info`, so a newly opened connection prepares them during the session
+* setup and the first requests do not pay for the Parse. The statements are registered
+* when they are prepared and are counted by the statements caches of the connections on
+* each execution.
+*
+* The number of candidates is bounded: a new statement replaces the least used one and
+* inherits its usage, like in the Space-Saving algorithm, so a frequent statement is not
+* displaced by the rare ones.
+*/
+class hot_statements {
+public:
+    /**
+    * @param count --- number of statements to prepare on a new connection.
+    * @param candidates --- number of statements tracked, 4 times the `count` by default.
+    */
+    explicit hot_statements(std::size_t count, std::size_t candidates = 0)
+    : count_(count), candidates_(std::max(candidates ? candidates : count * 4, count)) {}
+
+    hot_statements(const hot_statements&) = delete;
+    hot_statements& operator =(const hot_statements&) = delete;
+
+    std::size_t count() const noexcept { return count_;}
+
+    /**
+    * Registers a statement being prepared on a connection.
+    *
+    * @return usage counter of the statement to be kept in the statements cache.
+    */
+    std::shared_ptr<statement_usage> prepared(std::string_view text, const ::Oid* types, int params_count,
+            const statement_key* key) {
+        const std::lock_guard lock(mutex_);
+        if (const auto i = index_.find(text); i != index_.end()) {
+            i->second->usage->fetch_add(1, std::memory_order_relaxed);
+            return i->second->usage;
+        }
+        return insert(text, std::vector<::Oid>(types, types + std::max(params_count, 0)),
+            key ? std::optional<std::uint64_t>(key->id) : std::nullopt, 1);
+    }
+
+    /**
+    * Registers a statement with its usage, e.g. received from the previous process
+    * (see `ozo::connection_info::import_state()`). The usage of a known statement is
+    * not changed.
+    */
+    void restore(std::string_view text, std::vector<::Oid> types, std::optional<std::uint64_t> id,
+            std::uint64_t usage) {
+        const std::lock_guard lock(mutex_);
+        if (!index_.count(text)) {
+            insert(text, std::move(types), id, usage);
+        }
+    }
+
+    /**
+    * All the tracked statements in no particular order.
+    */
+    std::vector<std::shared_ptr<const warm_statement>> candidates() const {
+        const std::lock_guard lock(mutex_);
+        std::vector<std::shared_ptr<const warm_statement>> result;
+        result.reserve(index_.size());
+        for (const auto& [text, statement] : index_) {
+            result.push_back(statement);
+        }
+        return result;
+    }
+
+    /**
+    * The `count()` most used statements in order of descending usage.
+    */
+    std::vector<std::shared_ptr<const warm_statement>> top() const {
+        std::vector<std::pair<std::uint64_t, std::shared_ptr<const warm_statement>>> candidates;
+        {
+            const std::lock_guard lock(mutex_);
+            candidates.reserve(index_.size());
+            for (const auto& [text, statement] : index_) {
+                candidates.emplace_back(load(*statement), statement);
+            }
+        }
+        const auto n = std::min(count_, candidates.size());
+        std::partial_sort(candidates.begin(), candidates.begin() + std::ptrdiff_t(n), candidates.end(),
+            [] (const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+        std::vector<std::shared_ptr<const warm_statement>> result;
+        result.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            result.push_back(std::move(candidates[i].second));
+        }
+        return result;
+    }
+
+private:
+    std::shared_ptr<statement_usage> insert(std::string_view text, std::vector<::Oid> types,
+            std::optional<std::uint64_t> id, std::uint64_t usage) {
+        if (index_.size() >= candidates_) {
+            const auto least = std::min_element(index_.begin(), index_.end(), [] (const auto& lhs, const auto& rhs) {
+                return load(*lhs.second) < load(*rhs.second);
+            });
+            usage += load(*least->second);
+            index_.erase(least);
+        }
+        auto statement = std::make_shared<warm_statement>(warm_statement {
+            std::string(text), std::move(types), id, std::make_shared<statement_usage>(usage)
+        });
+        index_.emplace(statement->text, statement);
+        return statement->usage;
+    }
+
+    static std::uint64_t load(const warm_statement& v) noexcept {
+        return v.usage->load(std::memory_order_relaxed);
+    }
+
+    const std::size_t count_;
+    const std::size_t candidates_;
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string_view, std::shared_ptr<warm_statement>> index_;
+};
+
+} // namespace ozo::detail
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <filesystem>
+#include <string_view>
+
+namespace ozo::detail {
+
+/**
+ * Read-only memory mapping of a whole file, so a large file, e.g. a query conf,
+ * is parsed in place without reading it into a string first. An empty file is
+ * not mapped since an empty region can not be.
+ */
+class mapped_file {
+public:
+    explicit mapped_file(const std::filesystem::path& path) {
+        namespace bip = boost::interprocess;
+        if (std::filesystem::file_size(path) != 0) {
+            const bip::file_mapping file(path.c_str(), bip::read_only);
+            region_ = bip::mapped_region(file, bip::read_only);
+            region_.advise(bip::mapped_region::advice_sequential);
+        }
+    }
+
+    std::string_view data() const noexcept {
+        return std::string_view(static_cast<const char*>(region_.get_address()), region_.get_size());
+    }
+
+private:
+    boost::interprocess::mapped_region region_;
+};
+
+} // namespace ozo::detail
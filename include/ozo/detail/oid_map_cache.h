@@ -0,0 +1,64 @@
+#pragma once
+
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace ozo::detail {
+
+/**
+* Oid maps resolved for the servers connections have been established to. The
+* cache is shared by the connections of a connection source so a new connection
+* to a known server does not request the oids of the custom types again.
+* A server is identified by the host, port and database of the connection.
+*/
+template <typename OidMap>
+class oid_map_cache {
+public:
+    std::optional<OidMap> find(std::string_view server) const {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        const auto i = maps_.find(std::string(server));
+        if (i == maps_.end()) {
+            return std::nullopt;
+        }
+        return i->second;
+    }
+
+    void insert(std::string server, const OidMap& oid_map) {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        maps_.insert_or_assign(std::move(server), oid_map);
+    }
+
+    /**
+    * Removes all the resolved oid maps, e.g. when the custom types have been
+    * recreated on a server and the oids do not match anymore.
+    */
+    void clear() {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        maps_.clear();
+    }
+
+    /**
+    * Calls `f(server, oid_map)` for each of the resolved oid maps under the lock.
+    */
+    template <typename F>
+    void for_each(F&& f) const {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& [server, oid_map] : maps_) {
+            f(std::string_view(server), oid_map);
+        }
+    }
+
+    std::size_t size() const {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        return maps_.size();
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, OidMap> maps_;
+};
+
+} // namespace ozo::detail
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <boost/asio/associated_allocator.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace ozo::detail {
+
+/**
+* Cache of memory blocks for the operations state of a connection. A connection runs
+* one operation at a time, so a block freed by the previous request is reused for the
+* same object of the next one. The blocks are kept by size classes, a block per class.
+* Blocks of a size exceeding the largest class are not cached.
+*/
+class operation_slab {
+public:
+    static constexpr std::size_t granularity = 64;
+    static constexpr std::size_t classes_count = 32;
+
+    operation_slab() = default;
+    operation_slab(const operation_slab&) = delete;
+    operation_slab& operator =(const operation_slab&) = delete;
+
+    ~operation_slab() {
+        for (auto& block : blocks_) {
+            ::operator delete(block.exchange(nullptr));
+        }
+    }
+
+    void* allocate(std::size_t size) {
+        const auto index = size_class(size);
+        if (index < classes_count) {
+            if (auto block = blocks_[index].exchange(nullptr)) {
+                return block;
+            }
+        }
+        return ::operator new(index * granularity + granularity);
+    }
+
+    void deallocate(void* block, std::size_t size) noexcept {
+        const auto index = size_class(size);
+        void* expected = nullptr;
+        if (index >= classes_count || !blocks_[index].compare_exchange_strong(expected, block)) {
+            ::operator delete(block);
+        }
+    }
+
+private:
+    static constexpr std::size_t size_class(std::size_t size) noexcept {
+        return size ? (size - 1) / granularity : 0;
+    }
+
+    std::array<std::atomic<void*>, classes_count> blocks_{};
+};
+
+/**
+* Allocator which allocates memory from `operation_slab`. It shares the slab ownership,
+* since the operation state may outlive the connection it was allocated for.
+*/
+template <typename T>
+class slab_allocator {
+public:
+    using value_type = T;
+
+    explicit slab_allocator(std::shared_ptr<operation_slab> slab) noexcept
+    : slab_(std::move(slab)) {}
+
+    template <typename U>
+    slab_allocator(const slab_allocator<U>& other) noexcept : slab_(other.slab()) {}
+
+    T* allocate(std::size_t n) {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        if constexpr (alignof(T) > alignof(std::max_align_t)) {
+            return std::allocator<T>{}.allocate(n);
+        } else {
+            return static_cast<T*>(slab_->allocate(n * sizeof(T)));
+        }
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        if constexpr (alignof(T) > alignof(std::max_align_t)) {
+            std::allocator<T>{}.deallocate(p, n);
+        } else {
+            slab_->deallocate(p, n * sizeof(T));
+        }
+    }
+
+    const std::shared_ptr<operation_slab>& slab() const noexcept { return slab_;}
+
+    template <typename U>
+    friend bool operator ==(const slab_allocator& lhs, const slab_allocator<U>& rhs) noexcept {
+        return lhs.slab() == rhs.slab();
+    }
+
+    template <typename U>
+    friend bool operator !=(const slab_allocator& lhs, const slab_allocator<U>& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+private:
+    std::shared_ptr<operation_slab> slab_;
+};
+
+template <typename T, typename = std::void_t<>>
+struct has_operation_slab : std::false_type {};
+
+template <typename T>
+struct has_operation_slab<T, std::void_t<decltype(std::declval<T&>().operation_slab())>> : std::true_type {};
+
+template <typename T>
+struct is_std_allocator : std::false_type {};
+
+template <typename T>
+struct is_std_allocator<std::allocator<T>> : std::true_type {};
+
+/**
+* Returns allocator for the operation state. The allocator associated with the handler
+* is used if it is provided by a user, otherwise the memory is allocated from the slab
+* of the connection if there is one.
+*
+* @param conn --- unwrapped connection object the operation is executed on.
+* @param handler --- operation completion handler.
+*/
+template <typename Connection, typename Handler>
+inline auto get_operation_allocator([[maybe_unused]] Connection& conn, const Handler& handler) {
+    using allocator_type = boost::asio::associated_allocator_t<Handler>;
+    if constexpr (is_std_allocator<allocator_type>::value && has_operation_slab<Connection>::value) {
+        return slab_allocator<char>{conn.operation_slab()};
+    } else {
+        return boost::asio::get_associated_allocator(handler);
+    }
+}
+
+} // namespace ozo::detail
@@ -0,0 +1,35 @@
+#pragma once
+
+/**
+ * USDT (SystemTap/DTrace compatible) static probes of the `ozo` provider.
+ *
+ * The probes are compiled in if `OZO_USDT_PROBES` is defined, e.g. by the `OZO_USDT_PROBES`
+ * CMake option, which requires `<sys/sdt.h>` (the `systemtap-sdt-dev` package). An inactive
+ * probe is a single `nop` instruction, and the arguments are evaluated only to be passed into
+ * registers. Without the macro the probes and their arguments are compiled out.
+ *
+ * | Probe                 | Arguments                                          |
+ * |-----------------------|----------------------------------------------------|
+ * | `connect__start`      | `PGconn*`                                          |
+ * | `connect__done`       | `PGconn*`, error code value                        |
+ * | `pool__acquire__start`| shard index                                        |
+ * | `pool__acquire__done` | error code value of waiting for a pooled handle    |
+ * | `pool__release`       | `PGconn*` or null for a connection without a handle|
+ * | `request__start`      | `PGconn*`                                          |
+ * | `request__done`       | `PGconn*`, error code value                        |
+ * | `result__received`    | `PGconn*`, number of rows, result memory size      |
+ * | `cancel`              | `PGcancel*`, `1` if the cancel request has been sent|
+ *
+ * ###Example
+ *
+ * @code
+bpftrace -e 'usdt:./app:ozo:request__start { @s[arg0] = nsecs; }
+    usdt:./app:ozo:request__done /@s[arg0]/ { @us = hist((nsecs - @s[arg0]) / 1000); delete(@s[arg0]); }'
+ * @endcode
+ */
+#ifdef OZO_USDT_PROBES
+#include <sys/sdt.h>
+#define OZO_PROBE(name, ...) STAP_PROBEV(ozo, name, ##__VA_ARGS__)
+#else
+#define OZO_PROBE(name, ...) static_cast<void>(0)
+#endif
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <ozo/io/binary_query.h>
+
+#include <memory>
+#include <string>
+
+namespace ozo::detail {
+
+/**
+* Serializes the query text and the parameters with their types and formats, so
+* the queries with equal keys are equal as the database sees them.
+*/
+inline std::string make_query_key(const binary_query& query) {
+    const auto count = static_cast<std::size_t>(query.params_count());
+    std::string key(query.text());
+    key.push_back('\0');
+    const auto append = [&] (const auto& v) {
+        key.append(reinterpret_cast<const char*>(std::addressof(v)), sizeof(v));
+    };
+    for (std::size_t i = 0; i < count; ++i) {
+        append(query.types()[i]);
+        append(query.formats()[i]);
+        const int length = query.values()[i] ? query.lengths()[i] : -1;
+        append(length);
+        if (length > 0) {
+            key.append(query.values()[i], static_cast<std::size_t>(length));
+        }
+    }
+    return key;
+}
+
+} // namespace ozo::detail
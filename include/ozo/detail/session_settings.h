@@ -0,0 +1,56 @@
+#pragma once
+
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ozo::detail {
+
+/**
+* Session parameters a connection has set with `ozo::ensure_settings()`. A value is kept
+* with the status of the parameter the server has reported after it was set, if the
+* parameter is reported, so a change of such parameter by other statements is noticed.
+* The names are compared as is, the operation lowers them before.
+*/
+class session_settings {
+public:
+    struct entry {
+        std::string name;
+        std::string value;
+        std::optional<std::string> reported;
+    };
+
+    const entry* find(std::string_view name) const noexcept {
+        const auto i = std::find_if(entries_.begin(), entries_.end(),
+            [&] (const entry& v) { return v.name == name; });
+        return i == entries_.end() ? nullptr : std::addressof(*i);
+    }
+
+    void set(std::string name, std::string value, std::optional<std::string> reported) {
+        const auto i = std::find_if(entries_.begin(), entries_.end(),
+            [&] (const entry& v) { return v.name == name; });
+        if (i == entries_.end()) {
+            entries_.push_back(entry {std::move(name), std::move(value), std::move(reported)});
+        } else {
+            i->value = std::move(value);
+            i->reported = std::move(reported);
+        }
+    }
+
+    /**
+    * Forget the parameters set, e.g. after `RESET ALL` or `DISCARD ALL` statement,
+    * so the next `ozo::ensure_settings()` sets them again.
+    */
+    void clear() noexcept { entries_.clear();}
+
+    std::size_t size() const noexcept { return entries_.size();}
+
+    bool empty() const noexcept { return entries_.empty();}
+
+private:
+    std::vector<entry> entries_;
+};
+
+} // namespace ozo::detail
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <ozo/io/binary_query.h>
+#include <ozo/prepared_query.h>
+
+#include <boost/hana/equal.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ozo::detail {
+
+template <typename OidMap>
+inline constexpr char oid_map_type_key = 0;
+
+/**
+* A query shared by the tries of a failover operation. The query is converted
+* to the binary representation once for each type of oid map, and the result
+* is reused by the next tries and roles. The query is converted again only if
+* the oid map differs from the one of the previous conversion, e.g. since a lazy
+* oid map has been resolved for a connection. The conversions are guarded by a
+* mutex since the tries of a hedged operation may be performed concurrently.
+*/
+template <typename Query>
+class shared_binary_query {
+    struct conversion {
+        const void* oid_map_type;
+        std::shared_ptr<const void> oid_map;
+        binary_query query;
+    };
+
+    struct state {
+        Query query;
+        std::mutex mutex;
+        std::vector<conversion> conversions;
+
+        explicit state(Query query) : query(std::move(query)) {}
+    };
+
+public:
+    template <typename Allocator>
+    shared_binary_query(Query query, const Allocator& allocator)
+    : state_(std::allocate_shared<state>(allocator, std::move(query))) {}
+
+    const Query& query() const noexcept { return state_->query;}
+
+    template <typename OidMap, typename Allocator>
+    binary_query get(const OidMap& oid_map, const Allocator& allocator) const {
+        const std::lock_guard<std::mutex> lock(state_->mutex);
+        auto& conversions = state_->conversions;
+        const auto i = std::find_if(conversions.begin(), conversions.end(), [] (const conversion& v) {
+            return v.oid_map_type == std::addressof(oid_map_type_key<OidMap>);
+        });
+        if (i == conversions.end()) {
+            return conversions.emplace_back(conversion {
+                std::addressof(oid_map_type_key<OidMap>),
+                std::make_shared<OidMap>(oid_map),
+                to_binary_query(state_->query, oid_map, allocator)
+            }).query;
+        }
+        if (!hana::equal(static_cast<const OidMap*>(i->oid_map.get())->impl, oid_map.impl)) {
+            i->oid_map = std::make_shared<OidMap>(oid_map);
+            i->query = to_binary_query(state_->query, oid_map, allocator);
+        }
+        return i->query;
+    }
+
+private:
+    std::shared_ptr<state> state_;
+};
+
+/**
+* Wraps a query argument of a failover operation into `shared_binary_query`,
+* other arguments are forwarded as is. A prepared query is not wrapped since it
+* is sent by the name of the statement.
+*/
+template <typename Allocator, typename T>
+inline decltype(auto) share_binary_query(const Allocator& allocator, T&& arg) {
+    if constexpr (Query<T> && !PreparedQuery<T>) {
+        return shared_binary_query<std::decay_t<T>>(std::forward<T>(arg), allocator);
+    } else {
+        return std::forward<T>(arg);
+    }
+}
+
+} // namespace ozo::detail
+
+namespace ozo {
+
+template <typename Query>
+struct get_query_text_impl<detail::shared_binary_query<Query>> {
+    static decltype(auto) apply(const detail::shared_binary_query<Query>& q) {
+        return get_query_text(q.query());
+    }
+};
+
+template <typename Query>
+struct get_query_params_impl<detail::shared_binary_query<Query>> {
+    static decltype(auto) apply(const detail::shared_binary_query<Query>& q) {
+        return get_query_params(q.query());
+    }
+};
+
+template <typename Query>
+struct to_binary_query_impl<detail::shared_binary_query<Query>,
+        hana::when<ozo::Query<detail::shared_binary_query<Query>>>> {
+    template <typename OidMap, typename Alloc>
+    static binary_query apply(const detail::shared_binary_query<Query>& query,
+            const OidMap& oid_map, const Alloc& allocator) {
+        return query.get(oid_map, allocator);
+    }
+};
+
+} // namespace ozo
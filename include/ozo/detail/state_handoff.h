@@ -0,0 +1,198 @@
+#pragma once
+
+#include <ozo/detail/hot_statements.h>
+#include <ozo/detail/oid_map_cache.h>
+#include <ozo/type_traits.h>
+
+#include <boost/hana/for_each.hpp>
+#include <boost/hana/keys.hpp>
+
+#include <charconv>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace ozo::detail {
+
+/**
+* State of a connection source handed off to the next process, see
+* `ozo::connection_info::export_state()`. The state is a sequence of records,
+* each field is written as `<size>:<bytes>`, so the query texts are kept as is.
+*
+*     ozo-state-1
+*     oids <server> <count> (<type name> <oid>)...
+*     statement <text> <usage> <identifier or empty> <count> (<type oid>)...
+*/
+inline constexpr std::string_view state_handoff_format = "ozo-state-1";
+
+class state_writer {
+public:
+    void field(std::string_view v) {
+        out_ += std::to_string(v.size());
+        out_ += ':';
+        out_.append(v);
+    }
+
+    void number(std::uint64_t v) {
+        const auto text = std::to_string(v);
+        field(text);
+    }
+
+    std::string release() noexcept { return std::move(out_);}
+
+private:
+    std::string out_;
+};
+
+class state_reader {
+public:
+    explicit state_reader(std::string_view in) noexcept : in_(in) {}
+
+    bool empty() const noexcept { return in_.empty();}
+
+    std::string_view field() {
+        const auto colon = in_.find(':');
+        if (colon == std::string_view::npos) {
+            throw std::invalid_argument("connection state: field size expected");
+        }
+        const auto size = parse(in_.substr(0, colon));
+        if (size > in_.size() - colon - 1) {
+            throw std::invalid_argument("connection state: unexpected end of the state");
+        }
+        const auto result = in_.substr(colon + 1, size);
+        in_.remove_prefix(colon + 1 + size);
+        return result;
+    }
+
+    std::uint64_t number() { return parse(field());}
+
+    std::optional<std::uint64_t> optional_number() {
+        const auto v = field();
+        return v.empty() ? std::nullopt : std::optional<std::uint64_t>(parse(v));
+    }
+
+private:
+    static std::uint64_t parse(std::string_view v) {
+        std::uint64_t result = 0;
+        const auto [end, ec] = std::from_chars(v.data(), v.data() + v.size(), result);
+        if (v.empty() || ec != std::errc{} || end != v.data() + v.size()) {
+            throw std::invalid_argument("connection state: bad number " + std::string(v));
+        }
+        return result;
+    }
+
+    std::string_view in_;
+};
+
+/**
+* The types of an oid map are written by their names, so the next process
+* may register the types in another order or register other types.
+*/
+template <typename ...Ts>
+inline void write_oid_map(state_writer& out, std::string_view server, const oid_map_t<Ts...>& oid_map) {
+    out.field("oids");
+    out.field(server);
+    out.number(sizeof...(Ts));
+    hana::for_each(hana::keys(oid_map.impl), [&] (const auto& key) {
+        using type = typename std::decay_t<decltype(key)>::type;
+        out.field(type_name<type>());
+        out.number(type_oid<type>(oid_map));
+    });
+}
+
+/**
+* @return the oid map or `std::nullopt` if the oid of any of its types is unknown.
+*/
+template <typename ...Ts>
+inline std::optional<oid_map_t<Ts...>> read_oid_map(state_reader& in) {
+    std::unordered_map<std::string_view, oid_t> oids;
+    for (auto count = in.number(); count != 0; --count) {
+        const auto name = in.field();
+        oids.insert_or_assign(name, static_cast<oid_t>(in.number()));
+    }
+    oid_map_t<Ts...> result;
+    bool complete = true;
+    hana::for_each(hana::keys(result.impl), [&] (const auto& key) {
+        using type = typename std::decay_t<decltype(key)>::type;
+        const auto i = oids.find(type_name<type>());
+        if (i == oids.end() || i->second == null_oid) {
+            complete = false;
+        } else {
+            set_type_oid<type>(result, i->second);
+        }
+    });
+    return complete ? std::optional<oid_map_t<Ts...>>(std::move(result)) : std::nullopt;
+}
+
+inline void write_statement(state_writer& out, const warm_statement& statement) {
+    out.field("statement");
+    out.field(statement.text);
+    out.number(statement.usage->load(std::memory_order_relaxed));
+    if (statement.id) {
+        out.number(*statement.id);
+    } else {
+        out.field({});
+    }
+    out.number(statement.types.size());
+    for (const auto type : statement.types) {
+        out.number(type);
+    }
+}
+
+inline void read_statement(state_reader& in, hot_statements* statements) {
+    const auto text = in.field();
+    const auto usage = in.number();
+    const auto id = in.optional_number();
+    std::vector<::Oid> types;
+    for (auto count = in.number(); count != 0; --count) {
+        types.push_back(static_cast<::Oid>(in.number()));
+    }
+    if (statements) {
+        statements->restore(text, std::move(types), id, usage);
+    }
+}
+
+template <typename OidMap>
+inline std::string export_state(const oid_map_cache<OidMap>& oid_maps, const hot_statements* statements) {
+    state_writer out;
+    out.field(state_handoff_format);
+    if constexpr (!std::is_same_v<OidMap, empty_oid_map>) {
+        oid_maps.for_each([&] (std::string_view server, const OidMap& oid_map) {
+            write_oid_map(out, server, oid_map);
+        });
+    }
+    if (statements) {
+        for (const auto& statement : statements->candidates()) {
+            write_statement(out, *statement);
+        }
+    }
+    return out.release();
+}
+
+template <typename ...Ts>
+inline void import_state(std::string_view state, oid_map_cache<oid_map_t<Ts...>>& oid_maps,
+        hot_statements* statements) {
+    state_reader in(state);
+    if (in.field() != state_handoff_format) {
+        throw std::invalid_argument("connection state: unsupported format");
+    }
+    while (!in.empty()) {
+        const auto record = in.field();
+        if (record == "oids") {
+            std::string server(in.field());
+            if (auto oid_map = read_oid_map<Ts...>(in)) {
+                oid_maps.insert(std::move(server), *oid_map);
+            }
+        } else if (record == "statement") {
+            read_statement(in, statements);
+        } else {
+            throw std::invalid_argument("connection state: unknown record " + std::string(record));
+        }
+    }
+}
+
+} // namespace ozo::detail
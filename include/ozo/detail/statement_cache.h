@@ -0,0 +1,228 @@
+#pragma once
+
+#include <ozo/detail/column_plan_cache.h>
+
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ozo::detail {
+
+/**
+* Number of executions of a prepared statement on all the connections, see
+* `ozo::detail::hot_statements`. It is shared by the statements caches of the connections.
+*/
+using statement_usage = std::atomic<std::uint64_t>;
+
+/**
+* LRU cache of server side prepared statements of a connection. Maps query text to
+* the name of the statement prepared for it. Statements evicted from the cache are
+* collected to be deallocated on the server with the next prepare.
+*
+* Statements with the identifiers known at compile time, see `ozo::detail::statement_key`,
+* are found by the identifier with no hashing of the query text. A statement is shared by
+* the identifier and by its text, so the same text is prepared once per connection.
+*
+* A statement may have the usage counter, it is incremented each time the statement is found.
+*/
+class statement_cache {
+public:
+    static constexpr std::size_t default_capacity = 128;
+
+    explicit statement_cache(std::size_t capacity = default_capacity)
+    : capacity_(capacity) {}
+
+    statement_cache(statement_cache&&) = default;
+    statement_cache& operator =(statement_cache&&) = default;
+
+    std::size_t capacity() const noexcept { return capacity_;}
+
+    std::size_t size() const noexcept { return entries_.size();}
+
+    bool empty() const noexcept { return entries_.empty();}
+
+    /**
+    * Finds a statement prepared for the query text and marks it as most recently used.
+    *
+    * @return name of the statement or `nullptr` if there is no statement for the text.
+    */
+    const std::string* find(std::string_view text) {
+        const auto i = index_.find(text);
+        if (i == index_.end()) {
+            return nullptr;
+        }
+        entries_.splice(entries_.begin(), entries_, i->second);
+        count_usage(*i->second);
+        return std::addressof(i->second->name);
+    }
+
+    /**
+    * Finds a statement by its identifier and marks it as most recently used. If the
+    * statement is found but it is prepared for another text, e.g. the text of a named
+    * query has been reloaded, the statement is evicted.
+    *
+    * @return name of the statement or `nullptr` if there is no statement for the identifier and text.
+    */
+    const std::string* find(std::uint64_t id, std::string_view text) {
+        const auto i = ids_.find(id);
+        if (i == ids_.end()) {
+            return nullptr;
+        }
+        if (i->second->text != text) {
+            evicted_.push_back(std::move(i->second->name));
+            erase(i->second);
+            return nullptr;
+        }
+        entries_.splice(entries_.begin(), entries_, i->second);
+        count_usage(*i->second);
+        return std::addressof(i->second->name);
+    }
+
+    /**
+    * Column plans of the statement prepared for the query text.
+    *
+    * @return plans of the statement or `nullptr` if there is no statement for the text.
+    */
+    column_plan_cache* plans(std::string_view text) noexcept {
+        const auto i = index_.find(text);
+        return i == index_.end() ? nullptr : std::addressof(i->second->plans);
+    }
+
+    /**
+    * Column plans of the statement with the identifier.
+    *
+    * @return plans of the statement or `nullptr` if there is no statement for the identifier.
+    */
+    column_plan_cache* plans(std::uint64_t id) noexcept {
+        const auto i = ids_.find(id);
+        return i == ids_.end() ? nullptr : std::addressof(i->second->plans);
+    }
+
+    /**
+    * Makes a new unique name for a statement to be prepared.
+    */
+    std::string make_name() {
+        return "ozo_" + std::to_string(++last_id_);
+    }
+
+    /**
+    * Adds the prepared statement into the cache. The least recently used statement
+    * is evicted if the cache is full.
+    */
+    void emplace(std::string_view text, std::string name, std::shared_ptr<statement_usage> usage = {}) {
+        if (capacity_ == 0 || index_.count(text)) {
+            evicted_.push_back(std::move(name));
+            return;
+        }
+        evict_least_recently_used();
+        entries_.push_front(entry {std::string(text), std::move(name), {}, std::nullopt, std::move(usage)});
+        index_.emplace(entries_.front().text, entries_.begin());
+    }
+
+    /**
+    * Adds the prepared statement with the identifier into the cache. If the statement
+    * for the text is cached already, the identifier is attached to it.
+    */
+    void emplace(std::uint64_t id, std::string_view text, std::string name, std::shared_ptr<statement_usage> usage = {}) {
+        if (capacity_ == 0 || ids_.count(id)) {
+            evicted_.push_back(std::move(name));
+            return;
+        }
+        if (const auto i = index_.find(text); i != index_.end()) {
+            evicted_.push_back(std::move(name));
+            if (!i->second->id) {
+                i->second->id = id;
+                ids_.emplace(id, i->second);
+            }
+            return;
+        }
+        evict_least_recently_used();
+        entries_.push_front(entry {std::string(text), std::move(name), {}, id, std::move(usage)});
+        index_.emplace(entries_.front().text, entries_.begin());
+        ids_.emplace(id, entries_.begin());
+    }
+
+    /**
+    * Removes the statement from the cache, e.g. if it is unknown to the server.
+    */
+    void erase(std::string_view text) {
+        if (const auto i = index_.find(text); i != index_.end()) {
+            erase(i->second);
+        }
+    }
+
+    /**
+    * Takes names of evicted statements those should be deallocated on the server.
+    */
+    std::vector<std::string> take_evicted() {
+        return std::exchange(evicted_, {});
+    }
+
+    /**
+    * Returns names taken by `take_evicted()` which have not been deallocated, e.g. since
+    * the request has failed to send them, so they are deallocated by the next request.
+    */
+    void return_evicted(std::vector<std::string> names) {
+        evicted_.insert(evicted_.end(), std::make_move_iterator(names.begin()), std::make_move_iterator(names.end()));
+    }
+
+    /**
+    * Forgets all the statements, should be used then statements are not valid anymore,
+    * e.g. the underlying connection has been closed.
+    */
+    void clear() noexcept {
+        index_.clear();
+        ids_.clear();
+        entries_.clear();
+        evicted_.clear();
+    }
+
+private:
+    struct entry {
+        std::string text;
+        std::string name;
+        column_plan_cache plans;
+        std::optional<std::uint64_t> id;
+        std::shared_ptr<statement_usage> usage;
+    };
+
+    static void count_usage(const entry& v) noexcept {
+        if (v.usage) {
+            v.usage->fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    using entries = std::list<entry>;
+
+    void erase(entries::iterator i) {
+        if (i->id) {
+            ids_.erase(*i->id);
+        }
+        index_.erase(i->text);
+        entries_.erase(i);
+    }
+
+    void evict_least_recently_used() {
+        if (entries_.size() >= capacity_) {
+            evicted_.push_back(std::move(entries_.back().name));
+            erase(std::prev(entries_.end()));
+        }
+    }
+
+    std::size_t capacity_;
+    std::size_t last_id_ = 0;
+    entries entries_;
+    std::unordered_map<std::string_view, entries::iterator> index_;
+    std::unordered_map<std::uint64_t, entries::iterator> ids_;
+    std::vector<std::string> evicted_;
+};
+
+} // namespace ozo::detail
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace ozo::detail {
+
+/**
+* Identifier of a prepared statement known at compile time, e.g. of a query with
+* `boost::hana::string` text. The statement cache finds the statement by the identifier,
+* and the statement is prepared with the name made of the identifier at compile time.
+*/
+struct statement_key {
+    std::uint64_t id;
+    const char* name;
+};
+
+/**
+* FNV-1a hash of the statement source, the seed separates the identifiers made of
+* the query texts from the ones made of the query names.
+*/
+constexpr std::uint64_t statement_hash(std::string_view v, std::uint64_t seed) noexcept {
+    std::uint64_t h = 14695981039346656037ull ^ seed;
+    for (const char c : v) {
+        h = (h ^ static_cast<std::uint8_t>(c)) * 1099511628211ull;
+    }
+    return h;
+}
+
+constexpr std::uint64_t statement_text_seed = 0;
+constexpr std::uint64_t statement_name_seed = 1;
+
+// "ozo_s" prefix, 16 hex digits of the identifier and the null terminator
+using statement_name = std::array<char, 22>;
+
+constexpr statement_name make_statement_name(std::uint64_t id) noexcept {
+    statement_name result {'o', 'z', 'o', '_', 's'};
+    for (std::size_t i = 0; i < 16; ++i) {
+        const auto digit = static_cast<char>((id >> (60 - 4 * i)) & 0xf);
+        result[5 + i] = static_cast<char>(digit < 10 ? '0' + digit : 'a' + digit - 10);
+    }
+    return result;
+}
+
+template <std::uint64_t Id>
+struct static_statement_key {
+    static constexpr statement_name name = make_statement_name(Id);
+    static constexpr statement_key value {Id, name.data()};
+};
+
+} // namespace ozo::detail
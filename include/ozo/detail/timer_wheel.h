@@ -0,0 +1,402 @@
+#pragma once
+
+#include <ozo/deadline.h>
+
+#include <boost/asio/associated_allocator.hpp>
+#include <boost/asio/associated_executor.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace ozo::detail {
+
+/**
+ * Hashed timer wheel of an `io_context` for the operations deadlines. The wheel
+ * is driven by a single `steady_timer` ticking with the millisecond resolution while
+ * there are scheduled waits, so scheduling and cancellation of a wait are O(1) and
+ * do not touch the timer queue of the `io_context`. A wait is completed not earlier
+ * than its expiry time and not later than a tick after it.
+ */
+class timer_wheel_service : public boost::asio::execution_context::service {
+public:
+    using clock = std::chrono::steady_clock;
+    using duration = clock::duration;
+    using time_point = clock::time_point;
+
+    static constexpr std::size_t default_slots_count = 1024;
+    static constexpr std::chrono::milliseconds resolution{1};
+
+    inline static boost::asio::execution_context::id id;
+
+    /**
+     * Type-erased completion of a scheduled wait.
+     */
+    struct operation {
+        virtual void complete(const boost::system::error_code& ec) = 0;
+        virtual void destroy() noexcept = 0;
+    protected:
+        ~operation() = default;
+    };
+
+    /**
+     * Handle of a scheduled wait, stays valid after the wait is completed.
+     */
+    struct handle {
+        std::uint32_t index;
+        std::uint32_t generation;
+    };
+
+    /**
+     * @param ctx --- `io_context` of the service.
+     * @param slots_count --- number of the wheel slots, should be a power of two.
+     */
+    explicit timer_wheel_service(boost::asio::execution_context& ctx, std::size_t slots_count = default_slots_count)
+    : boost::asio::execution_context::service(ctx),
+      io_(static_cast<boost::asio::io_context&>(ctx)),
+      tick_timer_(io_),
+      origin_(clock::now()),
+      slots_(slots_count, npos) {
+        if (slots_count == 0 || (slots_count & (slots_count - 1)) != 0) {
+            throw std::invalid_argument("timer wheel slots count should be a power of two");
+        }
+    }
+
+    /**
+     * Schedules the operation to be completed at the expiry time.
+     */
+    handle schedule(time_point expiry, operation* op) {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        const auto index = acquire_node();
+        auto& n = nodes_[index];
+        n.tick = std::max(to_tick(expiry), current_tick_ + 1);
+        n.op = op;
+        link(index);
+        ++size_;
+        start_ticking();
+        return {index, n.generation};
+    }
+
+    /**
+     * Removes the scheduled wait from the wheel.
+     *
+     * @return operation of the wait or `nullptr` if it is completed already.
+     */
+    operation* cancel(handle h) noexcept {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        if (h.index >= nodes_.size() || nodes_[h.index].generation != h.generation || !nodes_[h.index].op) {
+            return nullptr;
+        }
+        auto op = nodes_[h.index].op;
+        unlink(h.index);
+        release_node(h.index);
+        --size_;
+        return op;
+    }
+
+    /**
+     * Number of the scheduled waits.
+     */
+    std::size_t size() const {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        return size_;
+    }
+
+    boost::asio::io_context& get_io_context() const noexcept { return io_;}
+
+private:
+    static constexpr std::uint32_t npos = std::numeric_limits<std::uint32_t>::max();
+
+    struct node {
+        std::uint64_t tick = 0;
+        operation* op = nullptr;
+        std::uint32_t prev = npos;
+        std::uint32_t next = npos;
+        std::uint32_t generation = 0;
+    };
+
+    void shutdown() override {
+        std::vector<operation*> ops;
+        {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            for (auto& n : nodes_) {
+                if (n.op) {
+                    ops.push_back(std::exchange(n.op, nullptr));
+                }
+            }
+            size_ = 0;
+        }
+        for (auto op : ops) {
+            op->destroy();
+        }
+    }
+
+    std::uint64_t to_tick(time_point t) const noexcept {
+        if (t <= origin_) {
+            return 0;
+        }
+        const auto elapsed = t - origin_;
+        return static_cast<std::uint64_t>(elapsed / resolution) + (elapsed % resolution != duration(0));
+    }
+
+    std::uint64_t elapsed_ticks(time_point t) const noexcept {
+        return t <= origin_ ? 0 : static_cast<std::uint64_t>((t - origin_) / resolution);
+    }
+
+    std::size_t slot(std::uint64_t tick) const noexcept {
+        return static_cast<std::size_t>(tick & (slots_.size() - 1));
+    }
+
+    std::uint32_t acquire_node() {
+        if (free_ != npos) {
+            return std::exchange(free_, nodes_[free_].next);
+        }
+        nodes_.emplace_back();
+        return static_cast<std::uint32_t>(nodes_.size() - 1);
+    }
+
+    void release_node(std::uint32_t index) noexcept {
+        auto& n = nodes_[index];
+        n.op = nullptr;
+        ++n.generation;
+        n.prev = npos;
+        n.next = std::exchange(free_, index);
+    }
+
+    void link(std::uint32_t index) noexcept {
+        auto& head = slots_[slot(nodes_[index].tick)];
+        nodes_[index].prev = npos;
+        nodes_[index].next = head;
+        if (head != npos) {
+            nodes_[head].prev = index;
+        }
+        head = index;
+    }
+
+    void unlink(std::uint32_t index) noexcept {
+        auto& n = nodes_[index];
+        if (n.prev != npos) {
+            nodes_[n.prev].next = n.next;
+        } else {
+            slots_[slot(n.tick)] = n.next;
+        }
+        if (n.next != npos) {
+            nodes_[n.next].prev = n.prev;
+        }
+    }
+
+    void start_ticking() {
+        if (ticking_) {
+            return;
+        }
+        ticking_ = true;
+        tick_timer_.expires_at(origin_ + resolution * static_cast<std::int64_t>(current_tick_ + 1));
+        tick_timer_.async_wait([this] (const boost::system::error_code& ec) { on_tick(ec); });
+    }
+
+    void on_tick(const boost::system::error_code& ec) {
+        if (ec == boost::asio::error::operation_aborted) {
+            return;
+        }
+        std::vector<operation*> expired;
+        {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            ticking_ = false;
+            const auto now_tick = elapsed_ticks(clock::now());
+            const auto steps = std::min<std::uint64_t>(now_tick - std::min(now_tick, current_tick_), slots_.size());
+            for (std::uint64_t i = 1; i <= steps; ++i) {
+                for (auto index = slots_[slot(current_tick_ + i)]; index != npos;) {
+                    const auto next = nodes_[index].next;
+                    if (nodes_[index].tick <= now_tick) {
+                        expired.push_back(nodes_[index].op);
+                        unlink(index);
+                        release_node(index);
+                        --size_;
+                    }
+                    index = next;
+                }
+            }
+            current_tick_ = std::max(current_tick_, now_tick);
+            if (size_) {
+                start_ticking();
+            }
+        }
+        for (auto op : expired) {
+            op->complete(boost::system::error_code{});
+        }
+    }
+
+    boost::asio::io_context& io_;
+    boost::asio::steady_timer tick_timer_;
+    const time_point origin_;
+    mutable std::mutex mutex_;
+    std::vector<std::uint32_t> slots_;
+    std::vector<node> nodes_;
+    std::uint32_t free_ = npos;
+    std::uint64_t current_tick_ = 0;
+    std::size_t size_ = 0;
+    bool ticking_ = false;
+};
+
+/**
+ * Timer which waits in `timer_wheel_service`. Supports a single wait at a time,
+ * a pending wait is cancelled on the timer destruction.
+ */
+class wheel_timer {
+public:
+    using time_point = timer_wheel_service::time_point;
+
+    wheel_timer(timer_wheel_service& service, time_point expiry) noexcept
+    : service_(std::addressof(service)), expiry_(expiry) {}
+
+    wheel_timer(wheel_timer&& other) noexcept
+    : service_(other.service_), expiry_(other.expiry_), handle_(other.handle_),
+      pending_(std::exchange(other.pending_, false)) {}
+
+    wheel_timer& operator =(wheel_timer&& other) noexcept {
+        if (this != std::addressof(other)) {
+            cancel();
+            service_ = other.service_;
+            expiry_ = other.expiry_;
+            handle_ = other.handle_;
+            pending_ = std::exchange(other.pending_, false);
+        }
+        return *this;
+    }
+
+    ~wheel_timer() { cancel();}
+
+    time_point expiry() const noexcept { return expiry_;}
+
+    template <typename Handler>
+    void async_wait(Handler&& handler) {
+        using op_type = wait_operation<std::decay_t<Handler>>;
+        auto op = op_type::create(service_->get_io_context().get_executor(), std::forward<Handler>(handler));
+        handle_ = service_->schedule(expiry_, op);
+        pending_ = true;
+    }
+
+    std::size_t cancel() noexcept {
+        if (!std::exchange(pending_, false)) {
+            return 0;
+        }
+        auto op = service_->cancel(handle_);
+        if (!op) {
+            return 0;
+        }
+        op->complete(boost::asio::error::operation_aborted);
+        return 1;
+    }
+
+private:
+    template <typename Handler>
+    struct wait_binder {
+        Handler handler;
+        boost::system::error_code ec;
+
+        void operator() () { std::move(handler)(ec);}
+
+        using executor_type = boost::asio::associated_executor_t<Handler>;
+
+        executor_type get_executor() const noexcept { return boost::asio::get_associated_executor(handler);}
+
+        using allocator_type = boost::asio::associated_allocator_t<Handler>;
+
+        allocator_type get_allocator() const noexcept { return boost::asio::get_associated_allocator(handler);}
+    };
+
+    template <typename Handler>
+    class wait_operation final : public timer_wheel_service::operation {
+    public:
+        using executor_type = boost::asio::io_context::executor_type;
+        using allocator_type = typename std::allocator_traits<
+            boost::asio::associated_allocator_t<Handler>>::template rebind_alloc<wait_operation>;
+
+        template <typename H>
+        static wait_operation* create(const executor_type& ex, H&& handler) {
+            allocator_type allocator(boost::asio::get_associated_allocator(handler));
+            auto p = std::allocator_traits<allocator_type>::allocate(allocator, 1);
+            try {
+                return new (p) wait_operation(ex, std::forward<H>(handler));
+            } catch (...) {
+                std::allocator_traits<allocator_type>::deallocate(allocator, p, 1);
+                throw;
+            }
+        }
+
+        void complete(const boost::system::error_code& ec) override {
+            auto ex = ex_;
+            wait_binder<Handler> binder{std::move(handler_), ec};
+            destroy();
+            boost::asio::post(ex, std::move(binder));
+        }
+
+        void destroy() noexcept override {
+            allocator_type allocator(boost::asio::get_associated_allocator(handler_));
+            this->~wait_operation();
+            std::allocator_traits<allocator_type>::deallocate(allocator, this, 1);
+        }
+
+    private:
+        template <typename H>
+        wait_operation(const executor_type& ex, H&& handler)
+        : ex_(ex), handler_(std::forward<H>(handler)) {}
+
+        executor_type ex_;
+        Handler handler_;
+    };
+
+    timer_wheel_service* service_;
+    time_point expiry_;
+    timer_wheel_service::handle handle_ {};
+    bool pending_ = false;
+};
+
+/**
+ * Timer of operation deadlines for `io_context`. Waits in the timer wheel if it is
+ * enabled for the `io_context` with `ozo::use_timer_wheel()`, otherwise is `steady_timer`.
+ */
+class io_operation_timer {
+public:
+    explicit io_operation_timer(boost::asio::steady_timer timer)
+    : impl_(std::move(timer)) {}
+
+    explicit io_operation_timer(wheel_timer timer)
+    : impl_(std::move(timer)) {}
+
+    template <typename Handler>
+    void async_wait(Handler&& handler) {
+        std::visit([&] (auto& timer) { timer.async_wait(std::forward<Handler>(handler)); }, impl_);
+    }
+
+    std::size_t cancel() {
+        return std::visit([] (auto& timer) { return timer.cancel(); }, impl_);
+    }
+
+private:
+    std::variant<boost::asio::steady_timer, wheel_timer> impl_;
+};
+
+/**
+ * Returns the timer wheel of the `io_context` or `nullptr` if it is not enabled.
+ */
+inline timer_wheel_service* find_timer_wheel(boost::asio::io_context& io) {
+    if (!boost::asio::has_service<timer_wheel_service>(io)) {
+        return nullptr;
+    }
+    return std::addressof(boost::asio::use_service<timer_wheel_service>(io));
+}
+
+} // namespace ozo::detail
@@ -1,15 +1,16 @@
 #pragma once
 
 #include <ozo/asio.h>
-
-#include <boost/asio/dispatch.hpp>
+#include <ozo/detail/bind.h>
+#include <ozo/detail/cancellation.h>
+#include <ozo/detail/dispatch.h>
 
 namespace ozo::detail {
 /**
  * @brief Safely wraps handler with a given Executor
  *
  * Comparing to asio::bind_executor this object dispatches handler to its
- * associated executor.
+ * associated executor, see `ozo::detail::dispatch_completion()`.
  */
 template <typename Executor, typename Handler>
 struct wrap_executor {
@@ -21,7 +22,7 @@ struct wrap_executor {
 
     template <typename ...Args>
     void operator() (Args&& ...args) {
-        asio::dispatch(detail::bind(std::move(handler), std::forward<Args>(args)...));
+        detail::dispatch_completion(detail::bind(std::move(handler), std::forward<Args>(args)...));
     }
 
     using executor_type = Executor;
@@ -31,6 +32,8 @@ struct wrap_executor {
     using allocator_type = asio::associated_allocator_t<Handler>;
 
     allocator_type get_allocator() const noexcept { return asio::get_associated_allocator(handler);}
+
+    OZO_FORWARD_CANCELLATION_SLOT(handler)
 };
 
 template <typename Executor, typename Handler>
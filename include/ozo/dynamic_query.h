@@ -0,0 +1,210 @@
+#pragma once
+
+#include <ozo/io/binary_query.h>
+
+#include <charconv>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ozo {
+
+/**
+ * @brief Query built at runtime in reusable buffers
+ *
+ * `ozo::query_builder` composes a query at compile time, so a query which shape depends on
+ * runtime conditions, e.g. optional filters or a chosen ORDER BY, has to be concatenated by hand.
+ * The `dynamic_query` appends the text and the parameters at runtime: the text goes to a single
+ * string, each parameter is serialized into a single buffer at once and its `$n` placeholder is
+ * numbered automatically. `clear()` keeps the memory, so a query being rebuilt in a loop does not
+ * allocate memory in the steady state.
+ *
+ * The parameters types are resolved against the `OidMap` given on construction, so it should be
+ * the same as the one of the connection for the custom types.
+ *
+ * The query is `BinaryQueryConvertible` and may be passed to the request functions as is,
+ * its data is copied into the `ozo::binary_query` once per request. An `ozo::binary_query`
+ * may be taken from a query which is not needed anymore via `std::move(query).release()`
+ * without the copy.
+ *
+ *@code
+#include <ozo/dynamic_query.h>
+ *@endcode
+ *
+ * ###Example
+ *
+ * @code
+ozo::dynamic_query<> query;
+query.append("SELECT id, name FROM users WHERE age >= ").param(min_age);
+if (name) {
+    query.append(" AND name = ").param(*name);
+}
+query.append(by_name ? " ORDER BY name" : " ORDER BY id");
+ozo::request(conn_info[io], query, ozo::into(res), yield);
+ * @endcode
+ *
+ * @tparam OidMap --- `OidMap` to resolve the parameters types.
+ * @tparam Allocator --- allocator of the buffers.
+ * @ingroup group-query-types
+ * @models{BinaryQueryConvertible}
+ */
+template <typename OidMap = empty_oid_map, typename Allocator = std::allocator<char>>
+class dynamic_query {
+    static_assert(ozo::OidMap<OidMap>, "OidMap should model ozo::OidMap");
+
+    template <typename T>
+    using rebind_alloc = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+
+public:
+    using allocator_type = Allocator;
+    using oid_map_type = OidMap;
+    using text_type = std::basic_string<char, std::char_traits<char>, Allocator>;
+    using buffer_type = std::vector<char, Allocator>;
+
+    explicit dynamic_query(const OidMap& oid_map = OidMap{}, const Allocator& allocator = Allocator{})
+    : oid_map_(oid_map), text_(allocator), buffer_(allocator), types_(allocator),
+      formats_(allocator), lengths_(allocator), values_(allocator) {}
+
+    dynamic_query(const dynamic_query& other)
+    : oid_map_(other.oid_map_), text_(other.text_), buffer_(other.buffer_), types_(other.types_),
+      formats_(other.formats_), lengths_(other.lengths_), values_(other.values_) {
+        update_values();
+    }
+
+    dynamic_query(dynamic_query&& other) = default;
+
+    dynamic_query& operator =(const dynamic_query& other) {
+        if (this != std::addressof(other)) {
+            oid_map_ = other.oid_map_;
+            text_ = other.text_;
+            buffer_ = other.buffer_;
+            types_ = other.types_;
+            formats_ = other.formats_;
+            lengths_ = other.lengths_;
+            values_ = other.values_;
+            update_values();
+        }
+        return *this;
+    }
+
+    // The buffer may be copied element-wise if the allocators do not propagate
+    dynamic_query& operator =(dynamic_query&& other) {
+        if (this != std::addressof(other)) {
+            oid_map_ = std::move(other.oid_map_);
+            text_ = std::move(other.text_);
+            buffer_ = std::move(other.buffer_);
+            types_ = std::move(other.types_);
+            formats_ = std::move(other.formats_);
+            lengths_ = std::move(other.lengths_);
+            values_ = std::move(other.values_);
+            update_values();
+        }
+        return *this;
+    }
+
+    /**
+     * Append a part of the query text as is.
+     */
+    dynamic_query& append(std::string_view text) {
+        text_.append(text.data(), text.size());
+        return *this;
+    }
+
+    /**
+     * Append a parameter: the `$n` placeholder is appended to the text and the binary
+     * representation of the value is appended to the parameters buffer.
+     *
+     * @param value --- parameter value of any type supported by `ozo::send()`.
+     */
+    template <typename T>
+    dynamic_query& param(const T& value) {
+        const char* const data = std::data(buffer_);
+        const auto pos = buffer_.size();
+        ozo::ostream os(buffer_);
+        send(os, oid_map_, value);
+
+        types_.push_back(type_oid(oid_map_, value));
+        formats_.push_back(binary_format);
+        lengths_.push_back(static_cast<int>(buffer_.size() - pos));
+        values_.push_back(lengths_.back() ? std::data(buffer_) + pos : nullptr);
+
+        if (data != std::data(buffer_)) {
+            update_values();
+        }
+
+        char placeholder[16] = {'$'};
+        const auto r = std::to_chars(placeholder + 1, std::end(placeholder), lengths_.size());
+        text_.append(placeholder, r.ptr);
+        return *this;
+    }
+
+    /**
+     * Clear the text and the parameters keeping the allocated memory.
+     */
+    void clear() noexcept {
+        text_.clear();
+        buffer_.clear();
+        types_.clear();
+        formats_.clear();
+        lengths_.clear();
+        values_.clear();
+    }
+
+    bool empty() const noexcept { return text_.empty() && lengths_.empty();}
+
+    /**
+     * Take the query as `ozo::binary_query` without a copy of the data.
+     */
+    binary_query release() && {
+        const auto allocator = buffer_.get_allocator();
+        return binary_query(std::in_place, std::move(*this), allocator);
+    }
+
+    const text_type& str() const noexcept { return text_;}
+
+    const char* text() const noexcept { return text_.c_str();}
+
+    const oid_t* types() const noexcept { return std::data(types_);}
+
+    const int* formats() const noexcept { return std::data(formats_);}
+
+    const int* lengths() const noexcept { return std::data(lengths_);}
+
+    const char* const* values() const noexcept { return std::data(values_);}
+
+    std::ptrdiff_t params_count() const noexcept { return std::ptrdiff_t(lengths_.size());}
+
+    allocator_type get_allocator() const { return buffer_.get_allocator();}
+
+private:
+    static constexpr int binary_format = 1;
+
+    // The values point to the buffer, so they are rebased once it has been reallocated or copied
+    void update_values() noexcept {
+        const char* data = std::data(buffer_);
+        for (std::size_t i = 0; i < lengths_.size(); ++i) {
+            values_[i] = lengths_[i] ? data : nullptr;
+            data += lengths_[i];
+        }
+    }
+
+    OidMap oid_map_;
+    text_type text_;
+    buffer_type buffer_;
+    std::vector<oid_t, rebind_alloc<oid_t>> types_;
+    std::vector<int, rebind_alloc<int>> formats_;
+    std::vector<int, rebind_alloc<int>> lengths_;
+    std::vector<const char*, rebind_alloc<const char*>> values_;
+};
+
+template <typename OidMapT, typename AllocatorT>
+struct to_binary_query_impl<dynamic_query<OidMapT, AllocatorT>> {
+    template <typename OidMap, typename Alloc>
+    static binary_query apply(const dynamic_query<OidMapT, AllocatorT>& query, const OidMap&, const Alloc& allocator) {
+        return binary_query(std::in_place, query, allocator);
+    }
+};
+
+} // namespace ozo
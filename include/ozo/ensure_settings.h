@@ -0,0 +1,104 @@
+#pragma once
+
+#include <ozo/impl/async_ensure_settings.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ozo {
+
+/**
+ * @brief Session parameters names and values
+ *
+ * Parameters for `ozo::ensure_settings()`, e.g. `{{"search_path", "app"}, {"work_mem", "64MB"}}`.
+ *
+ * @ingroup group-requests-types
+ */
+using session_parameters = std::vector<std::pair<std::string, std::string>>;
+
+#ifdef OZO_DOCUMENTATION
+/**
+ * @brief Sets the session parameters of a connection which differ from the given values
+ *
+ * Code which needs certain session parameters, e.g. `search_path` or `work_mem`, has to
+ * set them before its requests since a pooled connection may have been used with other
+ * settings. The function gets a connection from the provider and sets only the parameters
+ * which differ from the given values with a single request, so a connection which has
+ * the settings already costs nothing.
+ *
+ * The current values are known for the parameters set by the function on the same
+ * connection before and for the parameters reported by the server, see
+ * [PQparameterStatus](https://www.postgresql.org/docs/current/libpq-status.html). The
+ * values are compared as strings, so use the form the server reports, e.g. `UTC` rather
+ * than `utc` for `TimeZone`, or the parameter is set each time. A parameter which is
+ * changed by other statements is noticed if it is reported by the server only, so call
+ * `session_settings().clear()` of the connection after `RESET` statements.
+ *
+ * The parameters are set for the session, the values set within a transaction block
+ * are not tracked since the rollback of the transaction reverts them.
+ *
+ * @param provider --- connection provider object
+ * @param params --- `ozo::session_parameters` or another range of name and value pairs
+ * @param time_constraint --- request #TimeConstraint; this time constrain <b>includes</b> time for getting connection from provider.
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ */
+template <typename ConnectionProvider, typename SessionParameters, typename TimeConstraint, typename CompletionToken>
+decltype(auto) ensure_settings(ConnectionProvider&& provider, SessionParameters&& params, TimeConstraint time_constraint, CompletionToken&& token);
+
+/**
+ * @brief Sets the session parameters of a connection which differ from the given values
+ *
+ * This function is time constrain free shortcut to `ozo::ensure_settings()` function.
+ * Its call is equal to `ozo::ensure_settings(provider, params, ozo::none, token)` call.
+ *
+ * @param provider --- connection provider object
+ * @param params --- `ozo::session_parameters` or another range of name and value pairs
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ */
+template <typename ConnectionProvider, typename SessionParameters, typename CompletionToken>
+decltype(auto) ensure_settings(ConnectionProvider&& provider, SessionParameters&& params, CompletionToken&& token);
+#else
+
+template <typename Initiator>
+struct ensure_settings_op : base_async_operation <ensure_settings_op<Initiator>, Initiator> {
+    using base = typename ensure_settings_op::base;
+    using base::base;
+
+    template <typename P, typename Params, typename TimeConstraint, typename CompletionToken>
+    decltype(auto) operator() (P&& provider, Params&& params, TimeConstraint t, CompletionToken&& token) const {
+        static_assert(ConnectionProvider<P>, "provider should be a ConnectionProvider");
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        return async_initiate<CompletionToken, handler_signature<P>>(
+            get_operation_initiator(*this), token, std::forward<P>(provider), t, std::forward<Params>(params));
+    }
+
+    template <typename P, typename Params, typename CompletionToken>
+    decltype(auto) operator() (P&& provider, Params&& params, CompletionToken&& token) const {
+        return (*this)(std::forward<P>(provider), std::forward<Params>(params), none,
+            std::forward<CompletionToken>(token));
+    }
+
+    template <typename OtherInitiator>
+    constexpr static auto rebind_initiator(const OtherInitiator& other) {
+        return ensure_settings_op<OtherInitiator>{other};
+    }
+};
+
+namespace detail {
+struct initiate_async_ensure_settings {
+    template <typename Handler, typename P, typename Params, typename TimeConstraint>
+    constexpr void operator()(Handler&& h, P&& provider, TimeConstraint t, Params&& params) const {
+        impl::async_ensure_settings(std::forward<P>(provider), std::forward<Params>(params), t,
+            std::forward<Handler>(h));
+    }
+};
+} // namespace detail
+
+constexpr ensure_settings_op<detail::initiate_async_ensure_settings> ensure_settings;
+#endif
+} // namespace ozo
@@ -96,6 +96,31 @@ enum code {
     bad_composite_size, //!< a composite's fields number received does not equal to the expected or not supported by the type
     pq_cancel_failed, //!< libpq PQcancel function call failed, see `get_error_context()` for more information
     pq_get_cancel_failed, //!< libpq PQgetCancel function call failed, see `get_error_context()` for more information
+    pg_enter_pipeline_mode_failed, //!< libpq PQenterPipelineMode function failed
+    pg_exit_pipeline_mode_failed, //!< libpq PQexitPipelineMode function failed
+    pg_pipeline_sync_failed, //!< libpq PQpipelineSync function failed
+    pg_send_prepare_failed, //!< libpq PQsendPrepare function failed
+    pg_send_query_prepared_failed, //!< libpq PQsendQueryPrepared function failed
+    pg_set_single_row_mode_failed, //!< libpq PQsetSingleRowMode function failed
+    pg_set_chunked_rows_mode_failed, //!< libpq PQsetChunkedRowsMode function failed
+    pg_put_copy_data_failed, //!< libpq PQputCopyData function failed
+    pg_put_copy_end_failed, //!< libpq PQputCopyEnd function failed
+    pg_get_copy_data_failed, //!< libpq PQgetCopyData function failed
+    bad_copy_format, //!< COPY data received does not match the binary COPY format
+    pipeline_aborted, //!< the statement has not been executed since a previous statement of the pipeline failed
+    pg_send_query_failed, //!< libpq PQsendQuery function failed
+    cancel_queue_full, //!< the cancel request is rejected since the queue of `ozo::cancel_executor` is full
+    concurrency_limit_exceeded, //!< the connection request is rejected since the limit of `ozo::adaptive_limit_connection_source` is reached
+    partial_result, //!< some of the shards of `ozo::scatter()` or the partitions of `ozo::copy_loader` failed, the result contains the rest of them
+    result_too_large, //!< the result exceeds the size limit of the connection, see `connection::max_result_size()`
+    unexpected_null, //!< a null value received for a type which is not #Nullable
+    bad_row_size, //!< a row columns received do not match the columns of the type to receive the row into
+    pg_send_describe_prepared_failed, //!< libpq PQsendDescribePrepared function failed
+    circuit_breaker_open, //!< the connection request is rejected since the circuit breaker of `ozo::circuit_breaker_connection_source` is open
+    replication_lag_exceeded, //!< the connection request is rejected since all the replicas of `ozo::failover::lag_aware_connection_source` lag behind
+    bad_text_value, //!< a text format value received can not be parsed into the type
+    too_many_rows, //!< a result has more rows than the output can hold, e.g. `ozo::static_rows` or `std::optional` row
+    connection_budget_exhausted, //!< the connection request is rejected since there is no `ozo::connection_budget` left for a new connection
 };
 
 /**
@@ -401,6 +426,7 @@ enum code {
     introspection_error, //!< errors related to objects serialization/deserialization
     type_mismatch, //!< result type mismatch, indicates types mismatch between result of query and expected result
     protocol_error, //!< specific protocol-related errors
+    serialization_conflict, //!< transaction aborted due to a serialization failure or a deadlock, it may succeed if retried
 };
 
 /**
@@ -493,6 +519,56 @@ public:
                 return "libpq PQcancel function call failed";
             case pq_get_cancel_failed:
                 return "libpq PQgetCancel function call failed";
+            case pg_enter_pipeline_mode_failed:
+                return "pg_enter_pipeline_mode_failed - PQenterPipelineMode function failed";
+            case pg_exit_pipeline_mode_failed:
+                return "pg_exit_pipeline_mode_failed - PQexitPipelineMode function failed";
+            case pg_pipeline_sync_failed:
+                return "pg_pipeline_sync_failed - PQpipelineSync function failed";
+            case pg_send_prepare_failed:
+                return "pg_send_prepare_failed - PQsendPrepare function failed";
+            case pg_send_query_prepared_failed:
+                return "pg_send_query_prepared_failed - PQsendQueryPrepared function failed";
+            case pg_set_single_row_mode_failed:
+                return "pg_set_single_row_mode_failed - PQsetSingleRowMode function failed";
+            case pg_set_chunked_rows_mode_failed:
+                return "pg_set_chunked_rows_mode_failed - PQsetChunkedRowsMode function failed";
+            case pg_put_copy_data_failed:
+                return "pg_put_copy_data_failed - PQputCopyData function failed";
+            case pg_put_copy_end_failed:
+                return "pg_put_copy_end_failed - PQputCopyEnd function failed";
+            case pg_get_copy_data_failed:
+                return "pg_get_copy_data_failed - PQgetCopyData function failed";
+            case bad_copy_format:
+                return "bad_copy_format - COPY data received does not match the binary COPY format";
+            case pipeline_aborted:
+                return "pipeline_aborted - the statement has not been executed since a previous statement of the pipeline failed";
+            case pg_send_query_failed:
+                return "pg_send_query_failed - PQsendQuery function failed";
+            case cancel_queue_full:
+                return "cancel_queue_full - the cancel request is rejected since the cancel executor queue is full";
+            case concurrency_limit_exceeded:
+                return "concurrency_limit_exceeded - the connection request is rejected since the concurrency limit is reached";
+            case partial_result:
+                return "partial_result - some of the shards failed, the result is partial";
+            case result_too_large:
+                return "result_too_large - the result exceeds the size limit of the connection";
+            case unexpected_null:
+                return "unexpected null value for a type which is not nullable";
+            case bad_row_size:
+                return "row columns do not match the columns of the type";
+            case pg_send_describe_prepared_failed:
+                return "pg_send_describe_prepared_failed - PQsendDescribePrepared function failed";
+            case circuit_breaker_open:
+                return "circuit_breaker_open - the connection request is rejected since the circuit breaker is open";
+            case replication_lag_exceeded:
+                return "replication_lag_exceeded - the connection request is rejected since all the replicas lag behind";
+            case bad_text_value:
+                return "bad_text_value - a text format value can not be parsed into the type";
+            case too_many_rows:
+                return "too_many_rows - the result has more rows than the output can hold";
+            case connection_budget_exhausted:
+                return "connection_budget_exhausted - the connection request is rejected since there is no connection budget left";
         }
         return "no message for value: " + std::to_string(value);
     }
@@ -883,9 +959,19 @@ struct codes_for_condition<connection_error> {
         ozo::error::pq_connection_status_bad,
         ozo::error::pq_connect_poll_failed,
         ozo::error::pg_send_query_params_failed,
+        ozo::error::pg_send_prepare_failed,
+        ozo::error::pg_send_query_prepared_failed,
+        ozo::error::pg_send_describe_prepared_failed,
         ozo::error::pg_consume_input_failed,
         ozo::error::pg_set_nonblocking_failed,
-        ozo::error::pg_flush_failed
+        ozo::error::pg_flush_failed,
+        ozo::error::pg_pipeline_sync_failed,
+        ozo::error::pg_put_copy_data_failed,
+        ozo::error::pg_put_copy_end_failed,
+        ozo::error::pg_get_copy_data_failed,
+        ozo::error::pg_send_query_failed,
+        ozo::error::circuit_breaker_open,
+        ozo::error::replication_lag_exceeded
     );
 };
 
@@ -902,13 +988,20 @@ struct codes_for_condition<introspection_error> {
         ozo::error::bad_array_size,
         ozo::error::bad_array_dimension,
         ozo::error::bad_composite_size,
-        ozo::error::unexpected_eof
+        ozo::error::unexpected_eof,
+        ozo::error::bad_copy_format,
+        ozo::error::bad_text_value
     );
 };
 
 template <>
 struct codes_for_condition<type_mismatch> {
-    constexpr static auto value = hana::make_tuple(ozo::error::oid_type_mismatch);
+    constexpr static auto value = hana::make_tuple(
+        ozo::error::oid_type_mismatch,
+        ozo::error::unexpected_null,
+        ozo::error::bad_row_size,
+        ozo::error::too_many_rows
+    );
 };
 
 template <>
@@ -922,6 +1015,14 @@ struct codes_for_condition<protocol_error> {
     );
 };
 
+template <>
+struct codes_for_condition<serialization_conflict> {
+    constexpr static auto value = hana::make_tuple(
+        ozo::sqlstate::serialization_failure,
+        ozo::sqlstate::deadlock_detected
+    );
+};
+
 template<code Code>
 constexpr bool match_code(const error_code& ec) {
     return ozo::errc::match_code(codes_for_condition<Code>::value, ec);
@@ -945,6 +1046,8 @@ public:
                 return "expected type mismatch received type";
             case protocol_error:
                 return "protocol-related error";
+            case serialization_conflict:
+                return "transaction serialization conflict";
         };
         return "no message for value: " + std::to_string(value);
     }
@@ -958,6 +1061,7 @@ public:
             OZO_ERRC_CONDITION_MATCH(introspection_error);
             OZO_ERRC_CONDITION_MATCH(type_mismatch);
             OZO_ERRC_CONDITION_MATCH(protocol_error);
+            OZO_ERRC_CONDITION_MATCH(serialization_conflict);
         }
 #undef OZO_ERRC_CONDITION_MATCH
         return error_category::equivalent(code, condition);
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace ozo {
+
+/**
+ * @brief Additional error context of a connection
+ *
+ * Text which provides context depended information for an error of the last operation
+ * on a connection. The context is set on the error paths of every failed operation, so
+ * it avoids allocations: a text with the static storage duration made via `static_text()`
+ * is referenced, a text up to `inline_capacity` characters is copied into the inline
+ * buffer, e.g. the contexts of the library and the most of `std::exception::what()`
+ * messages, and only a longer one is copied into a `std::string`. A `std::string`
+ * given is moved since it is allocated already.
+ *
+ * The context is convertible to `std::string_view`, so it may be compared with and
+ * printed like a string.
+ *
+ * @ingroup group-connection-types
+ */
+class error_context {
+public:
+    static constexpr std::size_t inline_capacity = 111; //!< Maximum size of a text copied inline
+
+    /**
+     * Construct an empty context.
+     */
+    error_context() noexcept = default;
+
+    /**
+     * Construct the context with a copy of the text.
+     *
+     * @param v --- text of the context.
+     */
+    error_context(std::string_view v) { assign(v); }
+
+    /**
+     * Construct the context with a copy of the null-terminated text.
+     *
+     * @param v --- text of the context.
+     */
+    error_context(const char* v) : error_context(std::string_view(v)) {}
+
+    /**
+     * Construct the context with the string given.
+     *
+     * @param v --- text of the context.
+     */
+    error_context(std::string&& v) noexcept : kind_(kind::heap), heap_(std::move(v)) {}
+
+    /**
+     * Construct the context with a copy of the string given.
+     *
+     * @param v --- text of the context.
+     */
+    error_context(const std::string& v) : error_context(std::string_view(v)) {}
+
+    /**
+     * Make the context which references the text with the static storage duration,
+     * e.g. a string literal, without a copy.
+     *
+     * @param v --- text of the context which outlives the context.
+     * @return error_context --- context referencing the text.
+     */
+    static error_context static_text(std::string_view v) noexcept {
+        error_context result;
+        result.kind_ = kind::external;
+        result.external_ = v;
+        return result;
+    }
+
+    error_context(const error_context& other) { *this = other; }
+
+    error_context(error_context&& other) noexcept { *this = std::move(other); }
+
+    error_context& operator =(const error_context& other) {
+        if (this != &other) {
+            if (other.kind_ == kind::external) {
+                reset(other);
+            } else {
+                assign(other.view());
+            }
+        }
+        return *this;
+    }
+
+    error_context& operator =(error_context&& other) noexcept {
+        if (this != &other) {
+            if (other.kind_ == kind::heap) {
+                kind_ = kind::heap;
+                heap_ = std::move(other.heap_);
+            } else {
+                reset(other);
+            }
+        }
+        return *this;
+    }
+
+    /**
+     * @return std::string_view --- text of the context.
+     */
+    std::string_view view() const noexcept {
+        switch (kind_) {
+            case kind::external: return external_;
+            case kind::small: return {small_, small_size_};
+            case kind::heap: return heap_;
+        }
+        return {};
+    }
+
+    operator std::string_view() const noexcept { return view(); }
+
+    const char* data() const noexcept { return view().data(); }
+    std::size_t size() const noexcept { return view().size(); }
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+    friend bool operator ==(const error_context& lhs, std::string_view rhs) noexcept { return lhs.view() == rhs; }
+    friend bool operator ==(std::string_view lhs, const error_context& rhs) noexcept { return lhs == rhs.view(); }
+    friend bool operator !=(const error_context& lhs, std::string_view rhs) noexcept { return !(lhs == rhs); }
+    friend bool operator !=(std::string_view lhs, const error_context& rhs) noexcept { return !(lhs == rhs); }
+
+    friend std::ostream& operator <<(std::ostream& out, const error_context& v) { return out << v.view(); }
+
+private:
+    enum class kind : std::uint8_t { external, small, heap };
+
+    void assign(std::string_view v) {
+        if (v.size() <= inline_capacity) {
+            std::copy(v.begin(), v.end(), small_);
+            small_size_ = static_cast<std::uint8_t>(v.size());
+            kind_ = kind::small;
+        } else {
+            heap_.assign(v.data(), v.size());
+            kind_ = kind::heap;
+        }
+    }
+
+    void reset(const error_context& other) noexcept {
+        kind_ = other.kind_;
+        external_ = other.external_;
+        small_size_ = other.small_size_;
+        std::copy(other.small_, other.small_ + other.small_size_, small_);
+    }
+
+    kind kind_ = kind::external;
+    std::uint8_t small_size_ = 0;
+    char small_[inline_capacity] {};
+    std::string_view external_;
+    std::string heap_;
+};
+
+} // namespace ozo
@@ -0,0 +1,236 @@
+#pragma once
+
+#include <ozo/asio.h>
+#include <ozo/error.h>
+#include <ozo/core/histogram.h>
+#include <ozo/time_traits.h>
+
+#include <boost/asio/associated_allocator.hpp>
+#include <boost/asio/associated_executor.hpp>
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace ozo {
+
+/**
+ * @brief Event loop monitor configuration
+ * @ingroup group-connection-types
+ */
+struct event_loop_monitor_config {
+    time_traits::duration interval = std::chrono::milliseconds(100); //!< interval between the probes of an `io_context`
+    time_traits::duration slow_threshold = std::chrono::milliseconds(10); //!< lag of a probe or duration of a handler which is flagged as slow
+    std::function<void (time_traits::duration)> on_slow_handler {}; //!< called with the duration of each slow handler wrapped by `event_loop_monitor::wrap()`, optional
+};
+
+/**
+ * @brief Event loop monitor statistics
+ *
+ * Snapshot returned by `event_loop_monitor::statistics()`.
+ *
+ * @ingroup group-connection-types
+ */
+struct event_loop_statistics {
+    latency_histogram lag; //!< distribution of the probes scheduling lag
+    std::uint64_t stalls = 0; //!< number of the probes with the lag not less than the threshold
+    std::uint64_t slow_handlers = 0; //!< number of the wrapped handlers which ran not less than the threshold
+};
+
+namespace detail {
+
+struct event_loop_monitor_state {
+    event_loop_monitor_config config;
+    atomic_latency_histogram lag;
+    std::atomic<std::uint64_t> stalls {0};
+    std::atomic<std::uint64_t> slow_handlers {0};
+
+    explicit event_loop_monitor_state(event_loop_monitor_config config)
+    : config(std::move(config)) {}
+
+    void probed(time_traits::duration v) noexcept {
+        lag.add(v);
+        if (v >= config.slow_threshold) {
+            stalls.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void handled(time_traits::duration v) {
+        if (v >= config.slow_threshold) {
+            slow_handlers.fetch_add(1, std::memory_order_relaxed);
+            if (config.on_slow_handler) {
+                config.on_slow_handler(v);
+            }
+        }
+    }
+};
+
+/**
+ * Periodic probe of an `io_context`. The lag is the time between the expiry of the
+ * probe timer and the invocation of its handler, i.e. the time the handler has waited
+ * for the event loop busy with other handlers.
+ */
+struct event_loop_probe : std::enable_shared_from_this<event_loop_probe> {
+    std::shared_ptr<event_loop_monitor_state> state;
+    asio::strand<io_context::executor_type> strand;
+    asio::steady_timer timer;
+    std::atomic<bool> stopped {false};
+
+    event_loop_probe(io_context& io, std::shared_ptr<event_loop_monitor_state> state)
+    : state(std::move(state)), strand(asio::make_strand(io)), timer(io) {}
+
+    void schedule() {
+        if (stopped) {
+            return;
+        }
+        timer.expires_after(state->config.interval);
+        timer.async_wait(asio::bind_executor(strand, [self = shared_from_this()] (error_code ec) {
+            if (ec || self->stopped) {
+                return;
+            }
+            self->state->probed(asio::steady_timer::clock_type::now() - self->timer.expiry());
+            self->schedule();
+        }));
+    }
+
+    void stop() {
+        stopped.store(true);
+        asio::post(strand, [self = shared_from_this()] { self->timer.cancel(); });
+    }
+};
+
+/**
+ * Completion handler which accounts its own invocation time in the event loop monitor.
+ */
+template <typename Handler>
+struct event_loop_monitored_handler {
+    Handler handler_;
+    std::shared_ptr<event_loop_monitor_state> state_;
+
+    template <typename ...Args>
+    void operator() (Args&& ...args) {
+        const auto start = time_traits::now();
+        handler_(std::forward<Args>(args)...);
+        state_->handled(time_traits::now() - start);
+    }
+
+    using executor_type = asio::associated_executor_t<Handler>;
+
+    executor_type get_executor() const noexcept { return asio::get_associated_executor(handler_);}
+
+    using allocator_type = asio::associated_allocator_t<Handler>;
+
+    allocator_type get_allocator() const noexcept { return asio::get_associated_allocator(handler_);}
+};
+
+} // namespace detail
+
+/**
+ * @brief Monitor of the event loop scheduling lag
+ *
+ * Long synchronous work in a handler, e.g. decoding of a large result, stalls all the other
+ * connections of the `io_context`. The monitor arms a timer on each watched `io_context`
+ * with the configured interval and collects the histogram of the lag between the timer
+ * expiry and its handler invocation, which is close to zero for a responsive event loop.
+ * A probe costs a timer wait per interval.
+ *
+ * Results of a request are decoded by the operation before its completion handler is
+ * called, so a slow decode shows up as a stall of the event loop and as a long
+ * `ozo::trace_span_kind::decode` span of `ozo::tracing_statistics`. The application
+ * handlers may be wrapped with `wrap()` to find the slow ones.
+ *
+ * The probes run until `stop()` is called or the monitor is destroyed, and keep
+ * `io_context::run()` from returning until then. The monitor should be destroyed before
+ * the watched `io_context` objects.
+ *
+ * ###Example
+ *
+ * @code
+ozo::io_context io;
+ozo::event_loop_monitor monitor({std::chrono::milliseconds(50), std::chrono::milliseconds(5),
+    [] (auto d) { log << "slow handler " << d.count(); }});
+monitor.watch(io);
+ozo::request(conn_info[io], query, ozo::into(rows), monitor.wrap([&] (ozo::error_code ec, auto conn) {
+    ...
+}));
+...
+std::cout << "p99 lag " << monitor.statistics().lag.quantile(0.99).count() << std::endl;
+ * @endcode
+ * @ingroup group-connection-types
+ */
+class event_loop_monitor {
+public:
+    explicit event_loop_monitor(event_loop_monitor_config config = {})
+    : state_(std::make_shared<detail::event_loop_monitor_state>(std::move(config))) {}
+
+    event_loop_monitor(const event_loop_monitor&) = delete;
+    event_loop_monitor& operator =(const event_loop_monitor&) = delete;
+
+    event_loop_monitor(event_loop_monitor&&) = default;
+    event_loop_monitor& operator =(event_loop_monitor&&) = default;
+
+    ~event_loop_monitor() {
+        stop();
+    }
+
+    /**
+     * Start probing the `io_context`. The monitor must not be used from several threads while
+     * the function is called.
+     *
+     * @param io --- `io_context` used by the connections.
+     */
+    void watch(io_context& io) {
+        auto probe = std::make_shared<detail::event_loop_probe>(io, state_);
+        asio::post(probe->strand, [probe] { probe->schedule(); });
+        probes_.push_back(std::move(probe));
+    }
+
+    /**
+     * Stop all the probes. A probe which is waiting is cancelled.
+     */
+    void stop() {
+        for (auto& probe : probes_) {
+            probe->stop();
+        }
+        probes_.clear();
+    }
+
+    /**
+     * Wrap a completion handler so its invocation time is accounted, a handler which runs
+     * not less than `event_loop_monitor_config::slow_threshold` is counted and passed to
+     * `event_loop_monitor_config::on_slow_handler`. The associated executor and allocator of
+     * the handler are preserved.
+     *
+     * @param handler --- completion handler.
+     * @return wrapped completion handler.
+     */
+    template <typename Handler>
+    auto wrap(Handler&& handler) const {
+        return detail::event_loop_monitored_handler<std::decay_t<Handler>>{std::forward<Handler>(handler), state_};
+    }
+
+    /**
+     * Get the snapshot of the statistics, may be called from any thread.
+     */
+    event_loop_statistics statistics() const noexcept {
+        event_loop_statistics retval;
+        retval.lag = state_->lag.snapshot();
+        retval.stalls = state_->stalls.load(std::memory_order_relaxed);
+        retval.slow_handlers = state_->slow_handlers.load(std::memory_order_relaxed);
+        return retval;
+    }
+
+private:
+    std::shared_ptr<detail::event_loop_monitor_state> state_;
+    std::vector<std::shared_ptr<detail::event_loop_probe>> probes_;
+};
+
+} // namespace ozo
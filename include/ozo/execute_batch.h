@@ -0,0 +1,111 @@
+#pragma once
+
+#include <ozo/impl/async_execute_batch.h>
+
+#ifdef LIBPQ_HAS_PIPELINING
+
+namespace ozo {
+
+#ifdef OZO_DOCUMENTATION
+/**
+ * @brief Executes independent queries in one round trip
+ *
+ * The function gets a connection from the provider, switches it into the pipeline mode and sends
+ * all the queries back to back. Unlike `ozo::pipeline()` each query is followed by its own
+ * synchronization point, so every query is executed in its own implicit transaction and a failed
+ * query does not affect the rest of the batch. Results of the queries are not received, instead
+ * an `ozo::batch_statement_result` with the error and the number of affected rows is written into
+ * the output for each query in the order they were sent. The operation completes with the first
+ * query error after all the queries have been executed.
+ *
+ * Requires libpq 14 or later.
+ *
+ * @note The function does not particitate in ADL since could be implemented via functional object.
+ *
+ * @param provider --- connection provider object
+ * @param queries --- `boost::hana::tuple` of #BinaryQueryConvertible queries or a range of
+ * #BinaryQueryConvertible queries, e.g. `std::vector<ozo::binary_query>`
+ * @param out --- output iterator for `ozo::batch_statement_result` objects.
+ * @param time_constraint --- request #TimeConstraint; this time constrain <b>includes</b> time for getting connection from provider.
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ *
+ * ###Example
+ *
+ * @code
+std::vector<ozo::binary_query> queries;
+for (const auto& event : events) {
+    queries.push_back(ozo::to_binary_query("INSERT INTO audit_log VALUES ("_SQL + event.id + ")"_SQL,
+        ozo::empty_oid_map{}));
+}
+
+std::vector<ozo::batch_statement_result> results;
+ozo::execute_batch(conn_info[io], queries, std::back_inserter(results), 500ms, yield);
+ * @endcode
+ */
+template <typename ConnectionProvider, typename Queries, typename OutputIterator, typename TimeConstraint, typename CompletionToken>
+decltype(auto) execute_batch(ConnectionProvider&& provider, Queries&& queries, OutputIterator out,
+        TimeConstraint time_constraint, CompletionToken&& token);
+
+/**
+ * @brief Executes independent queries in one round trip
+ *
+ * This function is time constrain free shortcut to `ozo::execute_batch()` function.
+ * Its call is equal to `ozo::execute_batch(provider, queries, out, ozo::none, token)` call.
+ *
+ * @note The function does not particitate in ADL since could be implemented via functional object.
+ *
+ * @param provider --- connection provider object
+ * @param queries --- `boost::hana::tuple` or a range of #BinaryQueryConvertible queries
+ * @param out --- output iterator for `ozo::batch_statement_result` objects.
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ */
+template <typename ConnectionProvider, typename Queries, typename OutputIterator, typename CompletionToken>
+decltype(auto) execute_batch(ConnectionProvider&& provider, Queries&& queries, OutputIterator out, CompletionToken&& token);
+#else
+
+template <typename Initiator>
+struct execute_batch_op : base_async_operation <execute_batch_op<Initiator>, Initiator> {
+    using base = typename execute_batch_op::base;
+    using base::base;
+
+    template <typename P, typename Queries, typename Out, typename TimeConstraint, typename CompletionToken>
+    decltype(auto) operator() (P&& provider, Queries&& queries, Out out, TimeConstraint t, CompletionToken&& token) const {
+        static_assert(ConnectionProvider<P>, "provider should be a ConnectionProvider");
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        return async_initiate<CompletionToken, handler_signature<P>>(
+            get_operation_initiator(*this), token, std::forward<P>(provider), t,
+            std::forward<Queries>(queries), std::move(out));
+    }
+
+    template <typename P, typename Queries, typename Out, typename CompletionToken>
+    decltype(auto) operator() (P&& provider, Queries&& queries, Out out, CompletionToken&& token) const {
+        return (*this)(std::forward<P>(provider), std::forward<Queries>(queries), std::move(out), none,
+            std::forward<CompletionToken>(token));
+    }
+
+    template <typename OtherInitiator>
+    constexpr static auto rebind_initiator(const OtherInitiator& other) {
+        return execute_batch_op<OtherInitiator>{other};
+    }
+};
+
+namespace detail {
+struct initiate_async_execute_batch {
+    template <typename Handler, typename P, typename TimeConstraint, typename Queries, typename Out>
+    constexpr void operator()(Handler&& h, P&& provider, TimeConstraint t, Queries&& queries, Out out) const {
+        impl::async_execute_batch(std::forward<P>(provider), std::forward<Queries>(queries), std::move(out), t,
+            std::forward<Handler>(h));
+    }
+};
+} // namespace detail
+
+constexpr execute_batch_op<detail::initiate_async_execute_batch> execute_batch;
+#endif
+
+} // namespace ozo
+
+#endif
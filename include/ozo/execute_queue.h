@@ -0,0 +1,339 @@
+#pragma once
+
+#include <ozo/connector.h>
+#include <ozo/execute_batch.h>
+#include <ozo/detail/bind.h>
+#include <ozo/detail/bounded_queue.h>
+
+#include <boost/asio/post.hpp>
+#include <boost/iterator/function_output_iterator.hpp>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifdef LIBPQ_HAS_PIPELINING
+
+namespace ozo {
+
+/**
+ * @brief Policy of `ozo::execute_queue` for a query enqueued into the full queue
+ * @ingroup group-requests-types
+ */
+enum class execute_queue_overflow {
+    drop_newest, //!< the query enqueued is dropped
+    drop_oldest, //!< the oldest query of the queue is dropped to make room for the query enqueued
+};
+
+/**
+ * @brief Execute queue configuration
+ * @ingroup group-requests-types
+ */
+struct execute_queue_config {
+    std::size_t capacity = 4096; //!< maximum number of queries waiting in the queue, rounded up to a power of two
+    std::size_t connections = 2; //!< number of connections which drain the queue concurrently
+    std::size_t max_batch = 256; //!< maximum number of queries sent in one pipeline
+    execute_queue_overflow overflow = execute_queue_overflow::drop_newest; //!< policy for the full queue
+    time_traits::duration timeout = std::chrono::seconds(10); //!< time constraint of a batch including getting the connection
+};
+
+namespace detail {
+
+struct execute_queue_waiter {
+    virtual void complete(error_code ec) = 0;
+    virtual ~execute_queue_waiter() = default;
+};
+
+template <typename Handler, typename Executor>
+struct execute_queue_waiter_impl : execute_queue_waiter {
+    Handler handler_;
+    Executor executor_;
+
+    execute_queue_waiter_impl(Handler handler, const Executor& ex)
+    : handler_(std::move(handler)), executor_(ex) {}
+
+    void complete(error_code ec) override {
+        auto ex = asio::get_associated_executor(handler_, executor_);
+        asio::post(ex, detail::bind(std::move(handler_), std::move(ec)));
+    }
+};
+
+/**
+* Shared state of `ozo::execute_queue`. Producers push the queries into the lock-free queue
+* and start a drainer if fewer than the configured number of them are active. A drainer pops
+* up to a batch of queries and executes them via `ozo::execute_batch()`, then it starts over
+* until the queue is empty. The number of the queries enqueued but not executed yet is counted,
+* so the flush waiters are completed once it drops to zero.
+*/
+template <typename Source>
+class execute_queue_state : public std::enable_shared_from_this<execute_queue_state<Source>> {
+public:
+    execute_queue_state(Source source, io_context& io, const execute_queue_config& config)
+    : source_(std::forward<Source>(source)), io_(io), queue_(config.capacity),
+      connections_(std::max<std::size_t>(config.connections, 1)),
+      max_batch_(std::max<std::size_t>(config.max_batch, 1)),
+      overflow_(config.overflow), timeout_(config.timeout) {}
+
+    io_context& get_io_context() const noexcept { return io_;}
+
+    bool push(binary_query query) {
+        if (closed_.load(std::memory_order_acquire)) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        while (!queue_.try_push(query)) {
+            if (overflow_ == execute_queue_overflow::drop_newest) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                release(1);
+                return false;
+            }
+            if (queue_.try_pop()) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                release(1);
+            }
+        }
+        wake();
+        return true;
+    }
+
+    void close() noexcept { closed_.store(true, std::memory_order_release);}
+
+    bool closed() const noexcept { return closed_.load(std::memory_order_acquire);}
+
+    void flush(std::unique_ptr<execute_queue_waiter> waiter) {
+        std::unique_lock lock(mutex_);
+        if (pending_.load(std::memory_order_acquire) == 0) {
+            lock.unlock();
+            return waiter->complete(error_code{});
+        }
+        waiters_.push_back(std::move(waiter));
+    }
+
+    std::size_t size() const noexcept { return pending_.load(std::memory_order_relaxed);}
+    std::size_t capacity() const noexcept { return queue_.capacity();}
+    std::size_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed);}
+    std::size_t failed() const noexcept { return failed_.load(std::memory_order_relaxed);}
+
+private:
+    struct batch_outcome {
+        std::size_t received = 0;
+        std::size_t failed = 0;
+    };
+
+    void wake() {
+        // Pairs with the fence of an idle drainer, so either the drainer sees the query
+        // pushed or the producer sees the drainer inactive
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto active = active_.load(std::memory_order_relaxed);
+        while (active < connections_) {
+            if (active_.compare_exchange_weak(active, active + 1, std::memory_order_relaxed)) {
+                asio::post(io_, [self = this->shared_from_this()] { self->drain(); });
+                return;
+            }
+        }
+    }
+
+    void drain() {
+        std::vector<binary_query> batch;
+        while (batch.size() < max_batch_) {
+            auto query = queue_.try_pop();
+            if (!query) {
+                break;
+            }
+            batch.push_back(std::move(*query));
+        }
+
+        if (batch.empty()) {
+            active_.fetch_sub(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!queue_.empty()) {
+                wake();
+            }
+            return;
+        }
+
+        const auto size = batch.size();
+        auto outcome = std::make_shared<batch_outcome>();
+        auto out = boost::make_function_output_iterator([outcome] (const batch_statement_result& result) {
+            ++outcome->received;
+            if (result.ec) {
+                ++outcome->failed;
+            }
+        });
+        ozo::execute_batch(connection_provider(source_, io_), std::move(batch), out, timeout_,
+            [self = this->shared_from_this(), outcome, size] (error_code, auto&&) {
+                // Queries those results have not been received are failed with the batch
+                self->failed_.fetch_add(outcome->failed + size - outcome->received, std::memory_order_relaxed);
+                self->release(size);
+                self->drain();
+            });
+    }
+
+    void release(std::size_t count) {
+        if (pending_.fetch_sub(count, std::memory_order_acq_rel) != count) {
+            return;
+        }
+        std::unique_lock lock(mutex_);
+        if (pending_.load(std::memory_order_acquire) != 0) {
+            return;
+        }
+        auto waiters = std::exchange(waiters_, {});
+        lock.unlock();
+        for (auto& waiter : waiters) {
+            waiter->complete(error_code{});
+        }
+    }
+
+    Source source_;
+    io_context& io_;
+    bounded_queue<binary_query> queue_;
+    std::size_t connections_;
+    std::size_t max_batch_;
+    execute_queue_overflow overflow_;
+    time_traits::duration timeout_;
+    std::atomic<std::size_t> active_ {0};
+    std::atomic<std::size_t> pending_ {0};
+    std::atomic<std::size_t> dropped_ {0};
+    std::atomic<std::size_t> failed_ {0};
+    std::atomic<bool> closed_ {false};
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<execute_queue_waiter>> waiters_;
+};
+
+} // namespace detail
+
+/**
+ * @brief Executes queries in background without completion per query
+ *
+ * Writes like metrics or audit records do not need a completion of each query, but each
+ * `ozo::execute()` call still holds a handler, a coroutine and a slot of the pool queue.
+ * The execute queue accepts a query with no handler: the query is pushed into a bounded
+ * lock-free queue and the call returns at once. A fixed number of drainers pop the queries
+ * by batches and execute each batch via `ozo::execute_batch()` in pipeline mode over a
+ * connection from the source, so each query is executed in its own implicit transaction
+ * and a failed query does not affect the others.
+ *
+ * If the queue is full the query enqueued or the oldest one is dropped depending on the
+ * `ozo::execute_queue_overflow` policy. The numbers of the dropped and the failed queries
+ * are counted. On shutdown close the queue, so no more queries are accepted, and flush it to
+ * wait for the queries enqueued before to be executed while the `io_context` is still run.
+ *
+ * The queue may be used from many threads simultaneously. A referenced source should
+ * outlive the queries in flight.
+ *
+ * Requires libpq 14 or later.
+ *
+ * ### Example
+ *
+ * @code
+auto pool = ozo::make_connection_pool(ozo::connection_info(conn_str), pool_config);
+ozo::execute_queue audit(pool, io);
+
+audit.execute(ozo::to_binary_query("INSERT INTO audit_log VALUES ("_SQL + event_id + ")"_SQL,
+    ozo::empty_oid_map{}));
+...
+audit.close();
+audit.flush(yield);
+ * @endcode
+ *
+ * @tparam Source --- type of the `ConnectionSource`; may be a reference type, e.g. for a pool.
+ * @ingroup group-requests-types
+ */
+template <typename Source>
+class execute_queue {
+    static_assert(ConnectionSource<Source>, "Source should model ConnectionSource concept");
+
+    using state_type = detail::execute_queue_state<Source>;
+
+public:
+    /**
+     * @brief Construct a new execute queue object
+     *
+     * @param source --- connection source to execute the queries with.
+     * @param io --- `io_context` for the connections IO.
+     * @param config --- queue configuration.
+     */
+    execute_queue(Source source, io_context& io, const execute_queue_config& config = {})
+    : state_(std::make_shared<state_type>(std::forward<Source>(source), io, config)) {}
+
+    /**
+     * @brief Enqueues the query to be executed
+     *
+     * The query is converted into `ozo::binary_query` by the caller, so the queries with
+     * custom types should be converted with the `OidMap` of the connections.
+     *
+     * @param query --- query to execute.
+     * @return `false` if the query has been dropped since the queue is full or closed.
+     */
+    bool execute(binary_query query) {
+        return state_->push(std::move(query));
+    }
+
+    /**
+     * @brief Stops accepting the queries
+     *
+     * The queries enqueued before are still executed.
+     */
+    void close() noexcept { state_->close();}
+
+    /**
+     * @return `true` if the queue has been closed.
+     */
+    bool closed() const noexcept { return state_->closed();}
+
+    /**
+     * @brief Waits for the queries enqueued to be executed
+     *
+     * Completes once all the queries enqueued have been executed or failed, including
+     * the ones enqueued while waiting, so close the queue before the final flush.
+     *
+     * @param token --- operation #CompletionToken with `void(ozo::error_code)` signature.
+     * @return deduced from #CompletionToken.
+     */
+    template <typename CompletionToken>
+    decltype(auto) flush(CompletionToken&& token) {
+        return async_initiate<CompletionToken, void(error_code)>(
+            [state = state_] (auto&& handler) {
+                using handler_type = std::decay_t<decltype(handler)>;
+                using waiter_type = detail::execute_queue_waiter_impl<handler_type, io_context::executor_type>;
+                state->flush(std::make_unique<waiter_type>(
+                    std::forward<decltype(handler)>(handler), state->get_io_context().get_executor()));
+            },
+            token);
+    }
+
+    /**
+     * Number of the queries enqueued but not executed yet.
+     */
+    std::size_t size() const noexcept { return state_->size();}
+
+    /**
+     * Maximum number of the queries waiting in the queue.
+     */
+    std::size_t capacity() const noexcept { return state_->capacity();}
+
+    /**
+     * Number of the queries dropped since the queue was full or closed.
+     */
+    std::size_t dropped() const noexcept { return state_->dropped();}
+
+    /**
+     * Number of the queries failed to execute.
+     */
+    std::size_t failed() const noexcept { return state_->failed();}
+
+private:
+    std::shared_ptr<state_type> state_;
+};
+
+template <typename Source>
+execute_queue(Source&& source, io_context& io) -> execute_queue<Source>;
+
+template <typename Source>
+execute_queue(Source&& source, io_context& io, const execute_queue_config&) -> execute_queue<Source>;
+
+} // namespace ozo
+
+#endif
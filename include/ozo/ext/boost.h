@@ -8,9 +8,11 @@
  * Contains extentions are related to Boost library types.
  */
 
+#include <ozo/ext/boost/intrusive_ptr.h>
 #include <ozo/ext/boost/optional.h>
 #include <ozo/ext/boost/scoped_ptr.h>
 #include <ozo/ext/boost/shared_ptr.h>
 #include <ozo/ext/boost/tuple.h>
 #include <ozo/ext/boost/weak_ptr.h>
 #include <ozo/ext/boost/uuid.h>
+#include <ozo/ext/boost/iterator_range.h>
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <ozo/type_traits.h>
+#include <boost/intrusive_ptr.hpp>
+
+namespace ozo {
+/**
+ * @defgroup group-ext-boost-intrusive_ptr boost::intrusive_ptr
+ * @ingroup group-ext-boost
+ * @brief [boost::intrusive_ptr](https://www.boost.org/doc/libs/1_69_0/libs/smart_ptr/doc/html/smart_ptr.html#intrusive_ptr) support
+ *
+ *@code
+#include <ozo/ext/boost/intrusive_ptr.h>
+ *@endcode
+ *
+ * `boost::intrusive_ptr<T>` is defined as #Nullable and uses the default implementation of `ozo::is_null()`.
+ *
+ * Function `ozo::allocate_nullable()` implementation is specialized via direct call of `operator new`, so the allocator
+ * argument is ignored.
+ *
+ * The `ozo::unwrap()` function is implemented via the dereference operator.
+ */
+///@{
+template <typename T>
+struct is_nullable<boost::intrusive_ptr<T>> : std::true_type {};
+
+template <typename T>
+struct allocate_nullable_impl<boost::intrusive_ptr<T>> {
+    template <typename Alloc>
+    static void apply(boost::intrusive_ptr<T>& out, const Alloc&) {
+        out.reset(new T{});
+    }
+};
+
+template <typename T>
+struct unwrap_impl<boost::intrusive_ptr<T>> : detail::functional::dereference {};
+///@}
+} // namespace ozo
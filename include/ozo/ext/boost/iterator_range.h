@@ -0,0 +1,56 @@
+#pragma once
+
+#include <ozo/io/array.h>
+
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
+#include <boost/range/iterator_range_core.hpp>
+
+namespace ozo {
+/**
+ * @defgroup group-ext-boost-iterator_range boost::iterator_range
+ * @ingroup group-ext-boost
+ * @brief [boost::iterator_range](https://www.boost.org/doc/libs/1_74_0/libs/range/doc/html/range/reference/utilities/iterator_range.html) support
+ *
+ *@code
+#include <ozo/ext/boost/iterator_range.h>
+ *@endcode
+ *
+ * `boost::iterator_range<Iterator>` is declared as an one dimensional array representation type
+ * to be sent as a query parameter. The elements are serialized right from the range, so
+ * an array may be sent from a columnar buffer or a transformed view without an intermediate
+ * container. The range over pointers is sent by a single pass like a vector of arithmetic type.
+ * The range is traversed twice, to calculate the size and to serialize the elements, so a
+ * transforming function should be cheap and have no side effects.
+ *
+ * The range of any other type, e.g. an adapted one, may be sent via `ozo::as_array()`.
+ *
+ * @models{Array}
+ */
+///@{
+template <typename Iterator>
+struct is_array<boost::iterator_range<Iterator>> : std::true_type {};
+
+/**
+ * @brief Range as an array query parameter
+ *
+ * @param range --- forward range of the elements, it must outlive the request.
+ * @return `boost::iterator_range` of the range.
+ *
+ * ###Example
+ *
+ * @code
+const std::int64_t* ids = column.data();
+ozo::request(conn_info[io], "SELECT * FROM users WHERE id = ANY("_SQL
+    + ozo::as_array(boost::make_iterator_range(ids, ids + column.size())) + ")"_SQL, ...);
+
+ozo::request(conn_info[io], "SELECT * FROM users WHERE id = ANY("_SQL
+    + ozo::as_array(users | boost::adaptors::transformed([] (const auto& v) { return v.id; })) + ")"_SQL, ...);
+ * @endcode
+ */
+template <typename Range>
+inline auto as_array(const Range& range) {
+    return boost::make_iterator_range(boost::begin(range), boost::end(range));
+}
+///@}
+} // namespace ozo
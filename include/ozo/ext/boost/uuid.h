@@ -36,6 +36,41 @@ struct recv_impl<boost::uuids::uuid> {
     }
 };
 
+/**
+ * Parses the canonical text representation, e.g. `a0eebc99-9c0b-4ef8-bb6d-6bb9bd380a11`.
+ */
+template <>
+struct recv_text_impl<boost::uuids::uuid> {
+    static void apply(std::string_view in, boost::uuids::uuid& out) {
+        const auto hex = [] (char c) {
+            if (c >= '0' && c <= '9') {
+                return c - '0';
+            } else if (c >= 'a' && c <= 'f') {
+                return c - 'a' + 10;
+            } else if (c >= 'A' && c <= 'F') {
+                return c - 'A' + 10;
+            }
+            return -1;
+        };
+        if (in.size() != 36 || in[8] != '-' || in[13] != '-' || in[18] != '-' || in[23] != '-') {
+            detail::throw_bad_text_value(in, typeid(boost::uuids::uuid));
+        }
+        std::size_t pos = 0;
+        for (auto& byte : out.data) {
+            if (in[pos] == '-') {
+                ++pos;
+            }
+            const int high = hex(in[pos]);
+            const int low = hex(in[pos + 1]);
+            if (high < 0 || low < 0) {
+                detail::throw_bad_text_value(in, typeid(boost::uuids::uuid));
+            }
+            byte = static_cast<std::uint8_t>(high << 4 | low);
+            pos += 2;
+        }
+    }
+};
+
 }
 
 OZO_PG_BIND_TYPE(boost::uuids::uuid, "uuid")
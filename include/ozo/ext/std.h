@@ -22,3 +22,4 @@
 #include <ozo/ext/std/array.h>
 #include <ozo/ext/std/time_point.h>
 #include <ozo/ext/std/duration.h>
+#include <ozo/ext/std/span.h>
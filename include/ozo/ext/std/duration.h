@@ -3,6 +3,7 @@
 #include <ozo/io/send.h>
 #include <ozo/io/recv.h>
 #include <ozo/type_traits.h>
+#include <ozo/detail/bulk.h>
 
 #include <boost/hana/adapt_struct.hpp>
 
@@ -76,6 +77,30 @@ inline std::chrono::microseconds to_chrono_duration(const pg_interval& interval)
     return days_total + usecs_surplus;
 }
 
+/**
+ * Arrays and result columns of intervals are received and sent by a single pass,
+ * see `ozo::detail::bulk_item`.
+ */
+template <>
+struct bulk_item<std::chrono::microseconds> {
+    static constexpr std::size_t size = sizeof(std::int64_t) + 2 * sizeof(std::int32_t);
+
+    static std::chrono::microseconds load(const char* in) noexcept {
+        return to_chrono_duration(pg_interval{
+            static_cast<std::int64_t>(load_big_endian<std::uint64_t>(in)),
+            static_cast<std::int32_t>(load_big_endian<std::uint32_t>(in + sizeof(std::int64_t))),
+            static_cast<std::int32_t>(load_big_endian<std::uint32_t>(in + sizeof(std::int64_t) + sizeof(std::int32_t)))
+        });
+    }
+
+    static void store(const std::chrono::microseconds& in, char* out) noexcept {
+        const auto v = from_chrono_duration(in);
+        store_big_endian(static_cast<std::uint64_t>(v.microseconds), out);
+        store_big_endian(static_cast<std::uint32_t>(v.days), out + sizeof(std::int64_t));
+        store_big_endian(static_cast<std::uint32_t>(v.months), out + sizeof(std::int64_t) + sizeof(std::int32_t));
+    }
+};
+
 } // namespace ozo::detail
 
 namespace ozo {
@@ -93,11 +118,18 @@ struct send_impl<std::chrono::microseconds> {
 template <>
 struct recv_impl<std::chrono::microseconds> {
     template <typename OidMap>
-    static istream& apply(istream& in, size_type, const OidMap&, std::chrono::microseconds& out) {
+    static istream& apply(istream& in, size_type size, const OidMap&, std::chrono::microseconds& out) {
         static_assert(ozo::OidMap<OidMap>, "OidMap should model ozo::OidMap");
 
+        constexpr size_type interval_size = sizeof(std::int64_t) + 2 * sizeof(std::int32_t);
+        if (size != interval_size) {
+            throw ozo::system_error(error::bad_object_size,
+                "data size " + std::to_string(size) + " does not match interval size " + std::to_string(interval_size));
+        }
+
         detail::pg_interval interval;
-        read(in, interval);
+        auto data = in.unchecked(interval_size);
+        read(data, interval);
 
         out = detail::to_chrono_duration(interval);
 
@@ -112,4 +144,7 @@ namespace ozo::definitions {
 template <>
 struct type<std::chrono::microseconds> : pg::type_definition<decltype("interval"_s)>{};
 
+template <>
+struct array<std::chrono::microseconds> : pg::array_definition<decltype("interval"_s)>{};
+
 } // namespace ozo::definitions
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <ozo/io/array.h>
+
+#if __has_include(<span>)
+#include <span>
+#endif
+
+namespace ozo {
+/**
+ * @defgroup group-ext-std-span std::span
+ * @ingroup group-ext-std
+ * @brief [std::span](https://en.cppreference.com/w/cpp/container/span) support
+ *
+ *@code
+#include <ozo/ext/std/span.h>
+ *@endcode
+ *
+ * `std::span<T, Extent>` is declared as an one dimensional array representation type
+ * to be sent as a query parameter, if the standard library provides it. The elements are
+ * serialized right from the viewed memory without an intermediate container.
+ *
+ * @models{Array}
+ */
+///@{
+#ifdef __cpp_lib_span
+template <typename T, std::size_t Extent>
+struct is_array<std::span<T, Extent>> : std::true_type {};
+#endif
+///@}
+} // namespace ozo
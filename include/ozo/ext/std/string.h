@@ -12,11 +12,22 @@
 #include <ozo/ext/std/string.h>
  *@endcode
  *
- * `std::string` is mapped as `text` PostgreSQL type.
+ * `std::string` is mapped as `text` PostgreSQL type. So are the strings with
+ * other allocators, e.g. `std::pmr::string`; being received as an element of
+ * a container with a scoped allocator, e.g. `std::pmr::vector<std::pmr::string>`,
+ * a string takes the memory resource of the container.
  */
 
 OZO_PG_BIND_TYPE(std::string, "text")
 
+namespace ozo::definitions {
+template <typename Allocator>
+struct type<std::basic_string<char, std::char_traits<char>, Allocator>> : type<std::string> {};
+
+template <typename Allocator>
+struct array<std::basic_string<char, std::char_traits<char>, Allocator>> : array<std::string> {};
+} // namespace ozo::definitions
+
 /**
  * @defgroup group-ext-std-string_view std::string_view
  * @ingroup group-ext-std
@@ -26,8 +37,10 @@ OZO_PG_BIND_TYPE(std::string, "text")
 #include <ozo/ext/std/string.h>
  *@endcode
  *
- * `std::string_view` is mapped as `text` PostgreSQL type.
- * @note It can be used as a query parameter only!
+ * `std::string_view` is mapped as `text` PostgreSQL type. It is a borrowed
+ * parameter, so the query refers to the viewed memory without copying it
+ * (see `ozo::is_borrowed_parameter`). Being received it points into the result
+ * memory without copying, so the result should outlive it (see `ozo::borrowed_rows`).
  */
 
 OZO_PG_BIND_TYPE(std::string_view, "text")
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ozo/pg/definitions.h>
+#include <ozo/detail/bulk.h>
 #include <ozo/detail/epoch.h>
 #include <ozo/io/send.h>
 #include <ozo/io/recv.h>
@@ -24,12 +25,40 @@ namespace ozo {
  * `std::chrono::system_clock::time_point` is defined as a point in time.
  */
 
+namespace detail {
+
+inline std::int64_t to_pg_timestamp(const std::chrono::system_clock::time_point& in) noexcept {
+    return std::chrono::duration_cast<std::chrono::microseconds>(in - epoch).count();
+}
+
+inline std::chrono::system_clock::time_point from_pg_timestamp(std::int64_t in) noexcept {
+    return epoch + std::chrono::microseconds{ in };
+}
+
+/**
+ * Arrays and result columns of timestamps are converted from and to the epoch
+ * microseconds by a single pass, see `ozo::detail::bulk_item`.
+ */
+template <>
+struct bulk_item<std::chrono::system_clock::time_point> {
+    static constexpr std::size_t size = sizeof(std::int64_t);
+
+    static std::chrono::system_clock::time_point load(const char* in) noexcept {
+        return from_pg_timestamp(static_cast<std::int64_t>(load_big_endian<std::uint64_t>(in)));
+    }
+
+    static void store(const std::chrono::system_clock::time_point& in, char* out) noexcept {
+        store_big_endian(static_cast<std::uint64_t>(to_pg_timestamp(in)), out);
+    }
+};
+
+} // namespace detail
+
 template <>
 struct send_impl<std::chrono::system_clock::time_point> {
     template <typename OidMap>
     static ostream& apply(ostream& out, const OidMap&, const std::chrono::system_clock::time_point& in) {
-        int64_t value = std::chrono::duration_cast<std::chrono::microseconds>(in - detail::epoch).count();
-        return write(out, value);
+        return write(out, detail::to_pg_timestamp(in));
     }
 };
 
@@ -39,11 +68,107 @@ struct recv_impl<std::chrono::system_clock::time_point> {
     static istream& apply(istream& in, size_type, const OidMap&, std::chrono::system_clock::time_point& out) {
         int64_t value;
         read(in, value);
-        out = detail::epoch + std::chrono::microseconds{ value };
+        out = detail::from_pg_timestamp(value);
         return in;
     }
 };
 
+namespace detail {
+
+// Days since the unix epoch of the proleptic Gregorian calendar date
+constexpr std::int64_t days_from_civil(std::int64_t y, unsigned m, unsigned d) noexcept {
+    y -= m <= 2;
+    const std::int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const auto yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+}
+
+/**
+ * Reads the fixed count of digits, the negative count reads all the digits.
+ */
+template <typename T>
+inline bool parse_text_digits(const char*& first, const char* last, int count, T& out) noexcept {
+    const auto end = count < 0 || last - first < count ? last : first + count;
+    const auto [ptr, ec] = std::from_chars(first, end, out);
+    if (ec != std::errc{} || (count >= 0 && ptr != first + count)) {
+        return false;
+    }
+    first = ptr;
+    return true;
+}
+
+inline bool parse_text_char(const char*& first, const char* last, char c) noexcept {
+    if (first == last || *first != c) {
+        return false;
+    }
+    ++first;
+    return true;
+}
+
+} // namespace detail
+
+/**
+ * Parses the ISO text representation of `timestamp` and `timestamptz`, e.g.
+ * `2024-02-29 13:45:00.25+03`. The time zone offset is applied if present, the
+ * timestamp without it is considered to be UTC like the binary one. `infinity`
+ * and the BC dates can not be received.
+ */
+template <>
+struct recv_text_impl<std::chrono::system_clock::time_point> {
+    static void apply(std::string_view in, std::chrono::system_clock::time_point& out) {
+        const char* first = in.data();
+        const char* const last = in.data() + in.size();
+        std::int64_t year = 0;
+        unsigned month = 0, day = 0, hours = 0, minutes = 0, seconds = 0;
+        bool ok = detail::parse_text_digits(first, last, -1, year)
+            && detail::parse_text_char(first, last, '-')
+            && detail::parse_text_digits(first, last, 2, month)
+            && detail::parse_text_char(first, last, '-')
+            && detail::parse_text_digits(first, last, 2, day)
+            && detail::parse_text_char(first, last, ' ')
+            && detail::parse_text_digits(first, last, 2, hours)
+            && detail::parse_text_char(first, last, ':')
+            && detail::parse_text_digits(first, last, 2, minutes)
+            && detail::parse_text_char(first, last, ':')
+            && detail::parse_text_digits(first, last, 2, seconds);
+        std::int64_t microseconds = 0;
+        if (ok && first != last && *first == '.') {
+            ++first;
+            int digits = 0;
+            for (; first != last && *first >= '0' && *first <= '9'; ++first, ++digits) {
+                if (digits < 6) {
+                    microseconds = microseconds * 10 + (*first - '0');
+                }
+            }
+            ok = digits > 0;
+            for (; digits < 6; ++digits) {
+                microseconds *= 10;
+            }
+        }
+        std::int64_t offset = 0;
+        if (ok && first != last && (*first == '+' || *first == '-')) {
+            const int sign = *first++ == '-' ? -1 : 1;
+            unsigned offset_hours = 0, offset_minutes = 0, offset_seconds = 0;
+            ok = detail::parse_text_digits(first, last, 2, offset_hours)
+                && (!detail::parse_text_char(first, last, ':')
+                    || (detail::parse_text_digits(first, last, 2, offset_minutes)
+                        && (!detail::parse_text_char(first, last, ':')
+                            || detail::parse_text_digits(first, last, 2, offset_seconds))));
+            offset = sign * static_cast<std::int64_t>(offset_hours * 3600 + offset_minutes * 60 + offset_seconds);
+        }
+        if (!ok || first != last || month < 1 || month > 12 || day < 1 || day > 31
+                || hours > 24 || minutes > 59 || seconds > 60) {
+            detail::throw_bad_text_value(in, typeid(std::chrono::system_clock::time_point));
+        }
+        const auto unix_seconds = detail::days_from_civil(year, month, day) * 86400
+            + hours * 3600 + minutes * 60 + seconds - offset;
+        out = std::chrono::system_clock::time_point{} + std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::microseconds(unix_seconds * 1000000 + microseconds));
+    }
+};
+
 }
 
 OZO_PG_BIND_TYPE(std::chrono::system_clock::time_point, "timestamp")
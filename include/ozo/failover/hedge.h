@@ -0,0 +1,679 @@
+#pragma once
+
+#include <ozo/failover/strategy.h>
+#include <ozo/core/options.h>
+#include <ozo/core/histogram.h>
+#include <ozo/request.h>
+#include <ozo/execute.h>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+/**
+ * @defgroup group-failover-hedge Hedge
+ * @ingroup group-failover
+ * @brief Failover by hedged tries of an operation
+ */
+
+namespace ozo::failover {
+
+/**
+ * @brief Options for hedge
+ *
+ * These options can be used with `ozo::failover::hedge_strategy`.
+ * @ingroup group-failover-hedge
+ */
+struct hedge_options {
+    class strategy_tag;
+    class delay_tag;
+    class quantile_tag;
+    class latencies_tag;
+
+    constexpr static option<strategy_tag> strategy{}; //!< Failover strategy which provides the tries, e.g. `ozo::failover::role_based()`.
+    constexpr static option<delay_tag> delay{}; //!< Set delay of the hedged try, see `ozo::failover::hedge_strategy::delay()`.
+    constexpr static option<quantile_tag> quantile{}; //!< Set quantile of the tries latency to use as the delay, see `ozo::failover::hedge_strategy::quantile()`.
+    constexpr static option<latencies_tag> latencies{}; //!< Histogram of the successful tries latency shared by the copies of the strategy.
+};
+
+namespace detail {
+
+/**
+* Type-erased `cancel()` of the connection a hedged try is performed on. The IO objects
+* of the connection are not thread-safe, so the cancellation is posted to the executor
+* of the connection, which is kept alive until then.
+*/
+struct io_canceller {
+    std::shared_ptr<void> conn;
+    void (*cancel)(std::shared_ptr<void>) = nullptr;
+
+    void operator() () const {
+        if (conn) {
+            cancel(conn);
+        }
+    }
+};
+
+template <typename Connection>
+inline io_canceller make_io_canceller(const Connection& conn) {
+    return {std::make_shared<Connection>(conn), [] (std::shared_ptr<void> p) {
+        const auto ex = unwrap_connection(*static_cast<Connection*>(p.get())).get_executor();
+        asio::post(ex, [p = std::move(p)] {
+            unwrap_connection(*static_cast<Connection*>(p.get())).cancel();
+        });
+    }};
+}
+
+/**
+* Arguments of a hedged try except the connection provider and the time constraint.
+* Since a hedged operation has more than one try in progress, the output of the
+* operation should be given to one of them only. Specializations define how the
+* output of a supported operation is guarded.
+*/
+template <typename Operation>
+struct hedged_arguments {
+    static_assert(std::is_void_v<Operation>, "operation is not supported by the hedge strategy");
+};
+
+/**
+* Output of a hedged `ozo::request()` try. The first try received a result claims
+* the output and cancels the other tries, so the result of a request is written only
+* once. The other tries are completed with `boost::asio::error::operation_aborted`.
+*/
+template <typename Out, typename Context>
+struct hedged_request_output {
+    using async_result_processor_tag = void;
+
+    Out out_;
+    std::shared_ptr<Context> ctx_;
+    std::size_t id_;
+
+    template <typename Result, typename Connection, typename Continuation>
+    void async_process(Result&& res, Connection& conn, Continuation c) {
+        if (!ctx_->claim(id_)) {
+            return c(asio::error::operation_aborted, "result has been received by another hedged try");
+        }
+        auto process = impl::make_request_out_handler(std::move(out_));
+        if constexpr (impl::is_async_result_processor<decltype(process)>::value) {
+            process.async_process(std::forward<Result>(res), conn, std::move(c));
+        } else {
+            try {
+                if (process(std::forward<Result>(res), conn)) {
+                    return c(error::bad_result_process, std::string(ozo::get_error_context(conn)));
+                }
+            } catch (const std::exception& e) {
+                return c(error::bad_result_process, e.what());
+            }
+            c(error_code{}, std::string{});
+        }
+    }
+};
+
+template <typename Out, typename Context>
+hedged_request_output(Out, std::shared_ptr<Context>, std::size_t) -> hedged_request_output<Out, Context>;
+
+template <typename Initiator>
+struct hedged_arguments<base_async_operation<request_op<Initiator>, Initiator>> {
+    template <typename Context, typename Query, typename Out>
+    static auto apply(const std::shared_ptr<Context>& ctx, std::size_t id, Query&& query, Out&& out) {
+        return hana::make_tuple(std::forward<Query>(query),
+            hedged_request_output{std::forward<Out>(out), ctx, id});
+    }
+};
+
+template <typename Initiator>
+struct hedged_arguments<base_async_operation<execute_op<Initiator>, Initiator>> {
+    template <typename Context, typename Query>
+    static auto apply(const std::shared_ptr<Context>&, std::size_t, Query&& query) {
+        return hana::make_tuple(std::forward<Query>(query));
+    }
+};
+
+template <typename Handler, typename Context>
+struct hedged_connection_handler {
+    Handler handler_;
+    std::shared_ptr<Context> ctx_;
+    std::size_t id_;
+
+    template <typename Connection>
+    void operator() (error_code ec, Connection&& conn) {
+        if (!ec && !ctx_->connected(id_, conn)) {
+            ec = asio::error::operation_aborted;
+        }
+        handler_(std::move(ec), std::forward<Connection>(conn));
+    }
+
+    using executor_type = std::decay_t<decltype(asio::get_associated_executor(handler_))>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(handler_);
+    }
+
+    using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(handler_))>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(handler_);
+    }
+};
+
+template <typename Handler, typename Context>
+hedged_connection_handler(Handler, std::shared_ptr<Context>, std::size_t) -> hedged_connection_handler<Handler, Context>;
+
+/**
+* Connection provider of a hedged try which reports the connection the try
+* is performed on to the hedge context, so the try may be cancelled.
+*/
+template <typename Provider, typename Context>
+struct hedged_connection_provider {
+    Provider provider_;
+    std::shared_ptr<Context> ctx_;
+    std::size_t id_;
+
+    using connection_type = ozo::connection_type<Provider>;
+
+    template <typename TimeConstraint, typename Handler>
+    void async_get_connection(TimeConstraint t, Handler&& h) const & {
+        ozo::async_get_connection(provider_, t, hedged_connection_handler{std::forward<Handler>(h), ctx_, id_});
+    }
+
+    template <typename TimeConstraint, typename Handler>
+    void async_get_connection(TimeConstraint t, Handler&& h) && {
+        ozo::async_get_connection(std::move(provider_), t,
+            hedged_connection_handler{std::forward<Handler>(h), std::move(ctx_), id_});
+    }
+};
+
+template <typename Provider, typename Context>
+hedged_connection_provider(Provider, std::shared_ptr<Context>, std::size_t) -> hedged_connection_provider<Provider, Context>;
+
+template <typename Context>
+struct hedged_try_handler {
+    std::shared_ptr<Context> ctx_;
+    std::size_t id_;
+
+    template <typename Connection>
+    void operator() (error_code ec, Connection&& conn) {
+        ctx_->complete(id_, std::move(ec), std::forward<Connection>(conn));
+    }
+
+    using executor_type = typename Context::executor_type;
+
+    executor_type get_executor() const noexcept { return ctx_->get_executor();}
+
+    using allocator_type = typename Context::allocator_type;
+
+    allocator_type get_allocator() const noexcept { return ctx_->get_allocator();}
+};
+
+template <typename Context>
+hedged_try_handler(std::shared_ptr<Context>, std::size_t) -> hedged_try_handler<Context>;
+
+/**
+* State of a hedged operation. The tries of the operation are provided by the
+* underlying failover strategy. The next try is initiated either on an error of
+* the latest try as usual or once the hedge delay has expired while the only try
+* is in progress. In the last case the next try is requested with the
+* `boost::asio::error::timed_out` error. The first successful try completes the
+* operation, the other tries are cancelled.
+*/
+template <typename Operation, typename Handler, typename Connection>
+class hedge_context : public std::enable_shared_from_this<hedge_context<Operation, Handler, Connection>> {
+public:
+    using executor_type = std::decay_t<decltype(asio::get_associated_executor(std::declval<Handler&>()))>;
+    using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(std::declval<Handler&>()))>;
+    using stream_type = std::decay_t<decltype(unwrap_connection(std::declval<Connection&>()))>;
+    using timer_type = typename ozo::detail::operation_timer<typename stream_type::executor_type>::type;
+    using latencies_type = std::shared_ptr<ozo::detail::atomic_latency_histogram>;
+
+    hedge_context(const Operation& op, Handler handler, std::optional<time_traits::duration> delay,
+            latencies_type latencies)
+    : op_(op),
+      executor_(asio::get_associated_executor(handler)),
+      allocator_(asio::get_associated_allocator(handler)),
+      handler_(std::move(handler)),
+      delay_(delay),
+      latencies_(std::move(latencies)) {}
+
+    executor_type get_executor() const noexcept { return executor_;}
+
+    allocator_type get_allocator() const noexcept { return allocator_;}
+
+    template <typename Try>
+    void initiate(Try&& a_try) {
+        auto context = get_try_context(a_try);
+        std::size_t id = 0;
+        {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            id = ++initiated_;
+            running_.push_back(running_try{id, time_traits::now(), io_canceller{}});
+            pending_ = std::make_unique<pending_try_impl<std::decay_t<Try>>>(std::forward<Try>(a_try));
+        }
+        auto self = this->shared_from_this();
+        hana::unpack(std::move(context), [&] (auto&& provider, auto t, auto&& ...args) {
+            hana::unpack(hedged_arguments<Operation>::apply(self, id, std::forward<decltype(args)>(args)...),
+                [&] (auto&& ...hedged_args) {
+                    get_operation_initiator(op_)(
+                        hedged_try_handler{self, id},
+                        hedged_connection_provider{std::forward<decltype(provider)>(provider), self, id},
+                        t,
+                        std::forward<decltype(hedged_args)>(hedged_args)...
+                    );
+                });
+        });
+    }
+
+    /**
+    * Starts the hedge timer on the executor of the connection provider when the
+    * operation is initiated, so the next try is started after the delay even if
+    * the first one is still getting a connection. Otherwise the timer is started
+    * once the first try has got a connection.
+    */
+    template <typename Executor>
+    void start_timer(const Executor& ex) {
+        if constexpr (std::is_same_v<Executor, typename stream_type::executor_type>) {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            if (delay_ && !timer_) {
+                timer_.emplace(ozo::detail::get_operation_timer(ex, start_ + *delay_));
+                timer_->async_wait(timer_handler{this->shared_from_this()});
+            }
+        }
+    }
+
+    /**
+    * Registers the connection of the try. Returns false if the operation needs no
+    * the try anymore.
+    */
+    template <typename Conn>
+    bool connected(std::size_t id, const Conn& conn) {
+        using stream = std::decay_t<decltype(unwrap_connection(conn))>;
+        const std::lock_guard<std::mutex> lock(mutex_);
+        if (finished_ || (claimed_ && claimed_ != id)) {
+            return false;
+        }
+        if (auto i = find(id); i != running_.end()) {
+            i->cancel_io = make_io_canceller(conn);
+        }
+        if constexpr (std::is_same_v<stream, stream_type>) {
+            if (delay_ && !timer_) {
+                timer_.emplace(ozo::detail::get_operation_timer(unwrap_connection(conn).get_executor(), start_ + *delay_));
+                timer_->async_wait(timer_handler{this->shared_from_this()});
+            }
+        }
+        return true;
+    }
+
+    /**
+    * Claims the output of the operation for the try. Returns false if it has been
+    * claimed by another try.
+    */
+    bool claim(std::size_t id) {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        if (finished_ || (claimed_ && claimed_ != id)) {
+            return false;
+        }
+        if (!claimed_) {
+            claimed_ = id;
+            stop(id);
+        }
+        return true;
+    }
+
+    void complete(std::size_t id, error_code ec, Connection conn) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        time_traits::time_point start = start_;
+        if (auto i = find(id); i != running_.end()) {
+            start = i->start;
+            running_.erase(i);
+        }
+
+        if (finished_ || (ec && claimed_ && claimed_ != id)) {
+            lock.unlock();
+            return discard(ec, conn);
+        }
+
+        if (ec && !claimed_) {
+            if (id == initiated_ && pending_) {
+                auto pending = std::move(pending_);
+                lock.unlock();
+                if (pending->initiate_next(*this, ec, conn)) {
+                    return;
+                }
+                lock.lock();
+                if (finished_ || claimed_ || !running_.empty()) {
+                    return;
+                }
+            } else if (!running_.empty()) {
+                lock.unlock();
+                return discard(ec, conn);
+            }
+        }
+
+        finish(std::move(lock), start, std::move(ec), std::move(conn));
+    }
+
+private:
+    struct pending_try {
+        virtual ~pending_try() = default;
+        virtual bool initiate_next(hedge_context& ctx, const error_code& ec, Connection& conn) = 0;
+    };
+
+    template <typename Try>
+    struct pending_try_impl : pending_try {
+        Try try_;
+
+        explicit pending_try_impl(Try a_try) : try_(std::move(a_try)) {}
+
+        bool initiate_next(hedge_context& ctx, const error_code& ec, Connection& conn) override {
+            bool initiated = false;
+            initiate_next_try(try_, ec, conn, [&] (auto next_try) {
+                ctx.initiate(std::move(next_try));
+                initiated = true;
+            });
+            return initiated;
+        }
+    };
+
+    struct running_try {
+        std::size_t id;
+        time_traits::time_point start;
+        io_canceller cancel_io;
+    };
+
+    struct timer_handler {
+        std::shared_ptr<hedge_context> ctx_;
+
+        void operator() (error_code ec) {
+            if (ec != asio::error::operation_aborted) {
+                ctx_->hedge();
+            }
+        }
+
+        using executor_type = typename hedge_context::executor_type;
+
+        executor_type get_executor() const noexcept { return ctx_->get_executor();}
+
+        using allocator_type = typename hedge_context::allocator_type;
+
+        allocator_type get_allocator() const noexcept { return ctx_->get_allocator();}
+    };
+
+    void hedge() {
+        std::unique_ptr<pending_try> pending;
+        {
+            const std::lock_guard<std::mutex> lock(mutex_);
+            if (finished_ || claimed_ || running_.size() != 1 || !pending_) {
+                return;
+            }
+            pending = std::move(pending_);
+        }
+        Connection conn{};
+        pending->initiate_next(*this, asio::error::timed_out, conn);
+    }
+
+    auto find(std::size_t id) {
+        return std::find_if(running_.begin(), running_.end(), [&] (const auto& v) { return v.id == id;});
+    }
+
+    // Should be called under the lock. The cancellations of the other tries are
+    // posted to the executors of their connections.
+    void stop(std::size_t winner) {
+        if (timer_) {
+            timer_->cancel();
+        }
+        for (const auto& v : running_) {
+            if (v.id != winner) {
+                v.cancel_io();
+            }
+        }
+    }
+
+    void finish(std::unique_lock<std::mutex> lock, time_traits::time_point start, error_code ec, Connection conn) {
+        finished_ = true;
+        pending_.reset();
+        if (!claimed_) {
+            stop(0);
+        }
+        auto handler = std::move(*handler_);
+        handler_.reset();
+        lock.unlock();
+
+        if (!ec) {
+            latencies_->add(time_traits::now() - start);
+        }
+        handler(std::move(ec), std::move(conn));
+    }
+
+    static void discard(const error_code& ec, Connection& conn) {
+        if (ec && !is_null_recursive(conn)) {
+            close_connection(conn);
+        }
+    }
+
+    Operation op_;
+    executor_type executor_;
+    allocator_type allocator_;
+    std::optional<Handler> handler_;
+    std::optional<time_traits::duration> delay_;
+    latencies_type latencies_;
+    time_traits::time_point start_ = time_traits::now();
+
+    std::mutex mutex_;
+    std::size_t initiated_ = 0;
+    std::size_t claimed_ = 0;
+    bool finished_ = false;
+    std::vector<running_try> running_;
+    std::unique_ptr<pending_try> pending_;
+    std::optional<timer_type> timer_;
+};
+
+template <typename T, typename = std::void_t<>>
+struct has_executor : std::false_type {};
+
+template <typename T>
+struct has_executor<T, std::void_t<decltype(std::declval<const T&>().get_executor())>> : std::true_type {};
+
+template <typename Strategy, typename Operation>
+struct hedge_operation_initiator {
+    Strategy strategy_;
+    Operation op_;
+
+    constexpr hedge_operation_initiator(Strategy strategy, const Operation& op)
+    : strategy_(std::move(strategy)), op_(op) {}
+
+    template <typename Handler, typename Provider, typename ...Args>
+    void operator() (Handler&& handler, Provider&& provider, Args&& ...args) const {
+        using context_type = hedge_context<Operation, std::decay_t<Handler>, ozo::connection_type<Provider>>;
+        const auto allocator = asio::get_associated_allocator(handler);
+        auto ctx = std::allocate_shared<context_type>(allocator, op_, std::forward<Handler>(handler),
+            strategy_.get_delay(), strategy_.get(hedge_options::latencies));
+        if constexpr (has_executor<std::decay_t<Provider>>::value) {
+            ctx->start_timer(provider.get_executor());
+        }
+        auto first_try = get_first_try(op_, strategy_.get_strategy(), allocator,
+            std::forward<Provider>(provider), std::forward<Args>(args)...);
+        ctx->initiate(std::move(first_try));
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief Hedge strategy
+ *
+ * Hedge strategy performs an operation with tries provided by an other failover strategy,
+ * e.g. `ozo::failover::role_based()` or `ozo::failover::retry()`. In addition to the usual
+ * failover on an error, if the first try has not been completed within the hedge delay, the
+ * next try is started while the first one is still in progress. The first successful try
+ * completes the operation, the other one is cancelled. This cuts the tail latency caused by
+ * a slow host at the cost of extra load for the slowest requests.
+ *
+ * With `ozo::failover::role_based()` the strategy races the roles: a read-only query which may
+ * be performed on any of the roles is started on the next role once the delay has expired, and
+ * the first result wins. If the connection provider exposes its executor via `get_executor()`,
+ * as `ozo::failover::role_based_connection_provider` does, the delay is counted from the start
+ * of the operation, so the tail latency is bounded by the delay even if a host does not accept
+ * connections. Otherwise it is counted since the first try has got a connection.
+ *
+ * @code
+const auto racing = ozo::failover::hedge(ozo::failover::role_based(ozo::failover::master, ozo::failover::replica))
+    .delay(20ms);
+ozo::request[racing](conn_provider, query, 500ms, ozo::into(result), yield);
+ * @endcode
+ *
+ * The next try is requested from the underlying strategy with `boost::asio::error::timed_out`
+ * error, which is the `ozo::errc::connection_error` error condition, so the strategy should be able
+ * to recover it. No more than two tries are in progress at the same time. The result of
+ * `ozo::request()` is written into the output only by the first try that has received it.
+ *
+ * @warning Use the strategy for idempotent queries only since the query may be executed more
+ * than once. Only `ozo::request()` and `ozo::execute()` operations are supported.
+ *
+ * This class is an options' factory (see `ozo::options_factory_base`).
+ *
+ * @sa `ozo::failover::hedge()`
+ * @ingroup group-failover-hedge
+ */
+template <typename Options>
+class hedge_strategy : public ozo::options_factory_base<hedge_strategy<Options>, Options> {
+    using op = hedge_options;
+
+    friend class ozo::options_factory_base<hedge_strategy<Options>, Options>;
+    using base = ozo::options_factory_base<hedge_strategy<Options>, Options>;
+
+    template <typename OtherOptions>
+    constexpr static auto rebind_options(OtherOptions&& options) {
+        return hedge_strategy<std::decay_t<OtherOptions>>(std::forward<OtherOptions>(options));
+    }
+
+public:
+    /**
+     * @brief Construct a new hedge strategy object
+     *
+     * @param options --- `boost::hana::map` of `ozo::failover::hedge_options` and values.
+     */
+    constexpr hedge_strategy(Options options) : base(std::move(options)) {
+        static_assert(decltype(hana::is_a<hana::map_tag>(options))::value, "Options should be boost::hana::map");
+        static_assert(decltype(this->has(op::strategy))::value, "failover strategy should be specified");
+        static_assert(decltype(this->has(op::latencies))::value, "latencies histogram should be specified");
+    }
+
+    /**
+     * @brief Underlying failover strategy which provides the tries
+     */
+    constexpr decltype(auto) get_strategy() const { return this->get(op::strategy);}
+
+    /**
+     * @brief Specify the hedge delay
+     *
+     * The next try is started if the first try has not been completed within the delay.
+     * If `ozo::failover::hedge_strategy::quantile()` is specified, the delay is used
+     * until there are enough latency samples to estimate the quantile.
+     *
+     * @param d --- delay since the operation start.
+     * @return `hedge_strategy` specialization object
+     */
+    constexpr decltype(auto) delay(time_traits::duration d) const & { return this->set(op::delay, d);}
+    constexpr decltype(auto) delay(time_traits::duration d) && { return std::move(*this).set(op::delay, d);}
+
+    /**
+     * @brief Specify the hedge delay as a quantile of the tries latency
+     *
+     * The delay is estimated as the quantile of the latency of the successful tries performed with
+     * this strategy object and its copies. The estimation is the upper bound of the histogram bucket
+     * the quantile falls into (see `ozo::latency_histogram`). It is used once there are at least
+     * `1 / (1 - q)` samples, e.g. 100 for 0.99 quantile, before that the fixed delay is used if
+     * specified, otherwise operations are not hedged.
+     *
+     * @param q --- quantile in range (0, 1), e.g. `0.95`.
+     * @return `hedge_strategy` specialization object
+     */
+    constexpr decltype(auto) quantile(double q) const & { return this->set(op::quantile, q);}
+    constexpr decltype(auto) quantile(double q) && { return std::move(*this).set(op::quantile, q);}
+
+    /**
+     * @brief Histogram of the successful tries latency
+     *
+     * @return `ozo::latency_histogram` --- snapshot of the histogram.
+     */
+    latency_histogram latencies() const { return this->get(op::latencies)->snapshot();}
+
+    /**
+     * @brief Hedge delay for a new operation
+     *
+     * @return `std::optional<time_traits::duration>` --- the delay, `std::nullopt` if the operation
+     * should not be hedged.
+     */
+    std::optional<time_traits::duration> get_delay() const {
+        static_assert(decltype(this->has(op::delay))::value || decltype(this->has(op::quantile))::value,
+            "hedge delay or quantile should be specified");
+        if constexpr (decltype(this->has(op::quantile))::value) {
+            const double q = this->get(op::quantile);
+            const auto histogram = latencies();
+            // the epsilon compensates the rounding of `1 - q`, e.g. for `q = 0.9`
+            if (q < 1.0 && static_cast<double>(histogram.count()) * (1.0 - q) + 1e-9 >= 1.0) {
+                return histogram.quantile(q);
+            }
+        }
+        if constexpr (decltype(this->has(op::delay))::value) {
+            return this->get(op::delay);
+        } else {
+            return std::nullopt;
+        }
+    }
+};
+
+template <typename Options>
+hedge_strategy(Options) -> hedge_strategy<Options>;
+
+/**
+ * Hedge tries of an operation provided by a failover strategy.
+ *
+ * @param strategy --- failover strategy which provides the tries.
+ * @return `ozo::failover::hedge_strategy` specialization.
+ *
+ * ###Example
+ *
+ * Perform the request on a replica and, if it has not been completed within 0.95 quantile of
+ * the requests latency (or 50ms until it is estimated), on another replica or master.
+ *
+ * @code
+auto conn_info = ozo::failover::make_role_based_connection_source(
+    ozo::failover::master=ozo::connection_info(cfg.master_connstr),
+    ozo::failover::replica=ozo::failover::make_least_loaded_connection_source(
+        ozo::connection_info(cfg.replica1_connstr),
+        ozo::connection_info(cfg.replica2_connstr)
+    )
+);
+
+const auto hedged = failover::hedge(failover::role_based(failover::replica, failover::replica, failover::master))
+    .delay(50ms).quantile(0.95);
+
+ozo::request[hedged](conn_info[io], query, .5s, out, yield);
+ * @endcode
+ *
+ * @sa `ozo::failover::hedge_strategy`
+ * @ingroup group-failover-hedge
+ */
+template <typename Strategy>
+inline auto hedge(Strategy strategy) {
+    return hedge_strategy{hana::make_map(
+        hedge_options::strategy=std::move(strategy),
+        hedge_options::latencies=std::make_shared<ozo::detail::atomic_latency_histogram>()
+    )};
+}
+
+} // namespace ozo::failover
+
+namespace ozo {
+
+template <typename ...Ts, typename Op>
+struct construct_initiator_impl<failover::hedge_strategy<Ts...>, Op> {
+    template <typename Strategy>
+    constexpr static auto apply(Strategy&& strategy, const Op& op) {
+        return failover::detail::hedge_operation_initiator{std::forward<Strategy>(strategy), op};
+    }
+};
+
+} // namespace ozo
@@ -0,0 +1,471 @@
+#pragma once
+
+#include <ozo/connector.h>
+#include <ozo/connection.h>
+#include <ozo/error.h>
+#include <ozo/time_traits.h>
+#include <ozo/asio.h>
+#include <ozo/request.h>
+#include <ozo/shortcuts.h>
+#include <ozo/detail/bind.h>
+
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/strand.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @defgroup group-failover-lag_aware Replication lag aware host selection
+ * @ingroup group-failover
+ * @brief Connection source which excludes the replicas lagging behind the master
+ */
+
+namespace ozo::failover {
+
+/**
+ * @brief Position in the write-ahead log
+ *
+ * The `pg_lsn` value as the byte offset from `'0/0'`. It is used as the session token
+ * of the read-your-writes routing, see `lag_aware_connection_source::caught_up_with()`.
+ * @ingroup group-failover-lag_aware
+ */
+using wal_lsn = std::int64_t;
+
+/**
+ * @brief Query of the current write-ahead log position of the master
+ *
+ * The query returns a single `ozo::failover::wal_lsn` value. Make it with the connection
+ * to the master after a transaction is committed to get the session token which the
+ * replicas should replay before they serve the reads of the session.
+ *
+ * @return query object.
+ * @ingroup group-failover-lag_aware
+ */
+inline auto make_current_wal_lsn_query() {
+    return ozo::make_query("SELECT (pg_current_wal_lsn() - '0/0'::pg_lsn)::int8");
+}
+
+/**
+ * @brief Replication lag monitoring configuration
+ *
+ * Settings of `ozo::failover::lag_aware_connection_source`.
+ * @ingroup group-failover-lag_aware
+ */
+struct replication_lag_config {
+    time_traits::duration max_lag = std::chrono::seconds(1); //!< replicas with the replication lag above are excluded from routing
+    time_traits::duration interval = std::chrono::seconds(1); //!< interval between the end of a measurement and the start of the next one
+    time_traits::duration timeout = std::chrono::seconds(1); //!< time constraint of the measurement request to a replica
+};
+
+namespace detail {
+
+/**
+* Replication lag of a replica in microseconds and its replayed WAL position. A replica
+* which has replayed all the received WAL does not lag even if the master has had no
+* transactions since the last replayed one. A master does not lag by definition, and
+* its position is the current one.
+*/
+inline auto make_replication_lag_query() {
+    return ozo::make_query(
+        "SELECT CASE WHEN NOT pg_is_in_recovery() OR pg_last_wal_receive_lsn() = pg_last_wal_replay_lsn() THEN 0 "
+        "ELSE (EXTRACT(EPOCH FROM now() - pg_last_xact_replay_timestamp()) * 1000000)::int8 END, "
+        "(CASE WHEN pg_is_in_recovery() THEN pg_last_wal_replay_lsn() ELSE pg_current_wal_lsn() END - '0/0'::pg_lsn)::int8");
+}
+
+using replication_lag_rows = ozo::rows_of<std::optional<std::int64_t>, std::optional<std::int64_t>>;
+
+template <typename Source>
+struct lag_aware_state;
+
+/**
+* Background task which measures the replication lag of all the replicas each
+* round. The next round starts the interval after all the measurements of the
+* previous one are completed. The task does not own the sources, so it stops
+* once the last copy of the connection source is destroyed.
+*/
+template <typename Source>
+struct replication_lag_monitor : std::enable_shared_from_this<replication_lag_monitor<Source>> {
+    io_context& io;
+    asio::strand<io_context::executor_type> strand;
+    asio::steady_timer timer;
+    std::weak_ptr<lag_aware_state<Source>> state;
+    time_traits::duration interval;
+    time_traits::duration timeout;
+    std::atomic<bool> stopped {false};
+
+    replication_lag_monitor(io_context& io, std::weak_ptr<lag_aware_state<Source>> state,
+            time_traits::duration interval, time_traits::duration timeout)
+    : io(io), strand(asio::make_strand(io)), timer(io), state(std::move(state)),
+      interval(interval), timeout(timeout) {}
+
+    void start() {
+        asio::dispatch(strand, [self = this->shared_from_this()] { self->measure(); });
+    }
+
+    void stop() {
+        stopped.store(true);
+        asio::post(strand, [self = this->shared_from_this()] { self->timer.cancel(); });
+    }
+
+    void measure() {
+        auto s = state.lock();
+        if (stopped || !s) {
+            return;
+        }
+        auto pending = std::make_shared<std::size_t>(s->sources.size());
+        for (std::size_t i = 0; i != s->sources.size(); ++i) {
+            auto rows = std::make_shared<replication_lag_rows>();
+            ozo::request(connection_provider(s->sources[i], io), make_replication_lag_query(), timeout, ozo::into(*rows),
+                asio::bind_executor(strand, [self = this->shared_from_this(), s, i, rows, pending] (error_code ec, auto&&) {
+                    s->update(i, ec ? std::nullopt : to_replication_lag(*rows));
+                    if (!ec) {
+                        s->update_replay_lsn(i, to_replay_lsn(*rows));
+                    }
+                    if (--*pending == 0) {
+                        self->schedule();
+                    }
+                }));
+        }
+    }
+
+    void schedule() {
+        if (stopped) {
+            return;
+        }
+        timer.expires_after(interval);
+        timer.async_wait(asio::bind_executor(strand, [self = this->shared_from_this()] (error_code ec) {
+            if (!ec) {
+                self->measure();
+            }
+        }));
+    }
+
+    static std::optional<time_traits::duration> to_replication_lag(const replication_lag_rows& rows) {
+        if (rows.size() != 1 || !std::get<0>(rows.front())) {
+            return std::nullopt;
+        }
+        return std::chrono::duration_cast<time_traits::duration>(
+            std::chrono::microseconds(std::max<std::int64_t>(0, *std::get<0>(rows.front()))));
+    }
+
+    static std::optional<wal_lsn> to_replay_lsn(const replication_lag_rows& rows) {
+        if (rows.size() != 1) {
+            return std::nullopt;
+        }
+        return std::get<1>(rows.front());
+    }
+};
+
+template <typename Source>
+struct lag_aware_state {
+    static constexpr std::int64_t unknown_lag = std::numeric_limits<std::int64_t>::max();
+
+    std::vector<Source> sources;
+    std::vector<std::atomic<std::int64_t>> lags;
+    std::vector<std::atomic<wal_lsn>> replay_lsns;
+    std::int64_t max_lag;
+    std::atomic<std::size_t> next {0};
+    std::shared_ptr<replication_lag_monitor<Source>> monitor;
+
+    lag_aware_state(std::vector<Source> sources, time_traits::duration max_lag)
+    : sources(std::move(sources)), lags(this->sources.size()),
+      replay_lsns(this->sources.size()),
+      max_lag(std::chrono::duration_cast<std::chrono::microseconds>(max_lag).count()) {}
+
+    ~lag_aware_state() {
+        if (monitor) {
+            monitor->stop();
+        }
+    }
+
+    /**
+    * Stores the measured lag of the replica. A replica which has failed to report
+    * the lag is treated as lagging behind until the next measurement.
+    */
+    void update(std::size_t replica, std::optional<time_traits::duration> lag) noexcept {
+        lags[replica].store(lag ? std::chrono::duration_cast<std::chrono::microseconds>(*lag).count() : unknown_lag,
+            std::memory_order_relaxed);
+    }
+
+    /**
+    * Stores the replayed WAL position of the replica. An unknown position keeps the
+    * previous one since the replayed position only grows.
+    */
+    void update_replay_lsn(std::size_t replica, std::optional<wal_lsn> lsn) noexcept {
+        if (lsn) {
+            replay_lsns[replica].store(*lsn, std::memory_order_relaxed);
+        }
+    }
+
+    bool is_fresh(std::size_t replica) const noexcept {
+        return lags[replica].load(std::memory_order_relaxed) <= max_lag;
+    }
+
+    bool has_replayed(std::size_t replica, wal_lsn lsn) const noexcept {
+        return replay_lsns[replica].load(std::memory_order_relaxed) >= lsn;
+    }
+
+    /**
+    * Chooses the replicas with the lag within the limit which have replayed the WAL
+    * up to the given position in the round-robin order.
+    */
+    std::optional<std::size_t> choose(wal_lsn min_lsn = 0) noexcept {
+        const auto size = sources.size();
+        const auto start = next.fetch_add(1, std::memory_order_relaxed);
+        for (std::size_t i = 0; i != size; ++i) {
+            const auto replica = (start + i) % size;
+            if (is_fresh(replica) && has_replayed(replica, min_lsn)) {
+                return replica;
+            }
+        }
+        return std::nullopt;
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief Connection source which excludes the replicas lagging behind the master
+ *
+ * The source holds the connection sources of the replicas of a database, e.g.
+ * `ozo::connection_info` or `ozo::connection_pool` objects. The background task started
+ * with `start_monitoring()` periodically measures the replication lag of each replica with
+ * `pg_last_xact_replay_timestamp()`. The connection requests are dispatched in the round-robin
+ * order to the replicas with the lag not above `replication_lag_config::max_lag`. A replica
+ * which has failed to report its lag is treated as lagging behind until the next measurement.
+ * A replica is treated as fresh until its first measurement.
+ *
+ * If all the replicas lag behind, a connection request is completed with
+ * `ozo::error::replication_lag_exceeded` immediately. The error is the `ozo::errc::connection_error`
+ * condition, so `ozo::failover::role_based()` falls back to the next role, e.g. the master.
+ *
+ * The measurement also polls the replayed WAL position of each replica. The source returned
+ * by `caught_up_with()` chooses only the replicas which have replayed the WAL up to the given
+ * position, e.g. the one of the last commit of a session, so the session reads its own writes
+ * from the replicas instead of the master.
+ *
+ * The state is shared by the copies of the source and is updated with no locks, so the
+ * source may be used by many threads simultaneously.
+ *
+ * @tparam Source --- type of the underlying `ConnectionSource` for each replica.
+ * @sa `ozo::failover::make_lag_aware_connection_source()`
+ * @ingroup group-failover-lag_aware
+ * @models{ConnectionSource}
+ */
+template <typename Source>
+class lag_aware_connection_source {
+    static_assert(ConnectionSource<Source>, "Source should model ConnectionSource concept");
+
+    std::shared_ptr<detail::lag_aware_state<Source>> state_;
+    replication_lag_config config_;
+    wal_lsn min_lsn_ = 0;
+
+public:
+    /**
+     * `Connection` implementation type according to `ConnectionSource` requirements.
+     * Specifies the `Connection` implementation type which can be obtained from this source.
+     */
+    using connection_type = typename connection_source_traits<Source>::connection_type;
+
+    /**
+     * @brief Construct a new lag aware connection source object
+     *
+     * @param sources --- non empty sequence of connection sources of the replicas.
+     * @param config --- replication lag monitoring configuration.
+     */
+    explicit lag_aware_connection_source(std::vector<Source> sources, const replication_lag_config& config = {})
+    : state_(std::make_shared<detail::lag_aware_state<Source>>(std::move(sources), config.max_lag)),
+      config_(config) {
+        if (state_->sources.empty()) {
+            throw std::invalid_argument("lag_aware_connection_source: sources should not be empty");
+        }
+    }
+
+    /**
+     * @brief Provides a connection from a replica with the lag within the limit
+     *
+     * @param io --- `io_context` for the connection IO.
+     * @param t --- #TimeConstraint for the operation.
+     * @param handler --- #Handler.
+     */
+    template <typename TimeConstraint, typename Handler>
+    void operator ()(io_context& io, TimeConstraint t, Handler&& handler) const {
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        const auto replica = state_->choose(min_lsn_);
+        if (!replica) {
+            return asio::post(io.get_executor(), ozo::detail::bind(std::forward<Handler>(handler),
+                error_code{error::replication_lag_exceeded}, connection_type{}));
+        }
+        state_->sources[*replica](io, std::move(t), std::forward<Handler>(handler));
+    }
+
+    /**
+     * Start the background task which measures the replication lag of the replicas.
+     * A running task is stopped first. The task runs until `stop_monitoring()` is called
+     * or the last copy of the source is destroyed.
+     *
+     * @param io --- `io_context` for the task timer and the measurement requests.
+     */
+    void start_monitoring(io_context& io) const {
+        stop_monitoring();
+        state_->monitor = std::make_shared<detail::replication_lag_monitor<Source>>(
+            io, state_, config_.interval, config_.timeout);
+        state_->monitor->start();
+    }
+
+    /**
+     * Stop the background task started by `start_monitoring()`. The measurements
+     * which are in progress are completed, but the next ones are not started.
+     */
+    void stop_monitoring() const {
+        if (state_->monitor) {
+            state_->monitor->stop();
+            state_->monitor.reset();
+        }
+    }
+
+    /**
+     * Number of the replicas.
+     */
+    std::size_t size() const noexcept { return state_->sources.size();}
+
+    /**
+     * Whether the replica has the lag within the limit, so it gets the requests.
+     *
+     * @param replica --- index of the replica in the sequence given to the constructor.
+     */
+    bool is_fresh(std::size_t replica) const noexcept { return state_->is_fresh(replica);}
+
+    /**
+     * Set the replication lag of the replica measured by other means, e.g. by a monitoring
+     * system. The value is replaced by the next measurement of the background task if it runs.
+     *
+     * @param replica --- index of the replica in the sequence given to the constructor.
+     * @param lag --- replication lag, `std::nullopt` if it is unknown so the replica is treated as lagging behind.
+     */
+    void set_lag(std::size_t replica, std::optional<time_traits::duration> lag) const noexcept {
+        state_->update(replica, lag);
+    }
+
+    /**
+     * Last known replayed WAL position of the replica, zero until the first measurement.
+     *
+     * @param replica --- index of the replica in the sequence given to the constructor.
+     */
+    wal_lsn replay_lsn(std::size_t replica) const noexcept {
+        return state_->replay_lsns[replica].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Set the replayed WAL position of the replica known by other means. The value is replaced
+     * by the next measurement of the background task if it runs.
+     *
+     * @param replica --- index of the replica in the sequence given to the constructor.
+     * @param lsn --- replayed WAL position.
+     */
+    void set_replay_lsn(std::size_t replica, wal_lsn lsn) const noexcept {
+        state_->update_replay_lsn(replica, lsn);
+    }
+
+    /**
+     * @brief Source for the reads which should see the writes up to the WAL position
+     *
+     * The result shares the replicas and their state with this source but chooses only
+     * the replicas which are known to have replayed the WAL up to the position. Since
+     * the positions are known from the periodic measurements, the reads right after a commit
+     * are completed with `ozo::error::replication_lag_exceeded` until the next measurement,
+     * so `ozo::failover::role_based()` sends them to the master.
+     *
+     * ###Example
+     *
+@code
+ozo::rows_of<ozo::failover::wal_lsn> lsn;
+auto conn = ozo::commit(std::move(transaction), 1s, yield);
+ozo::request(std::move(conn), ozo::failover::make_current_wal_lsn_query(), 1s, ozo::into(lsn), yield);
+session.lsn = std::get<0>(lsn.front());
+
+//...
+
+auto conn_info = ozo::failover::make_role_based_connection_source(
+    ozo::failover::replica=replicas.caught_up_with(session.lsn),
+    ozo::failover::master=master
+);
+ozo::request[ozo::failover::role_based(ozo::failover::replica, ozo::failover::master)](
+    conn_info[io], query, 1s, ozo::into(result), yield);
+@endcode
+     *
+     * @param lsn --- WAL position, e.g. the result of `ozo::failover::make_current_wal_lsn_query()`.
+     * @return `ozo::failover::lag_aware_connection_source` object.
+     */
+    lag_aware_connection_source caught_up_with(wal_lsn lsn) const {
+        auto result = *this;
+        result.min_lsn_ = lsn;
+        return result;
+    }
+
+    auto operator [](io_context& io) const & {
+        return connection_provider(*this, io);
+    }
+
+    auto operator [](io_context& io) && {
+        return connection_provider(std::move(*this), io);
+    }
+};
+
+/**
+ * @brief Creates connection source which excludes the replicas lagging behind the master
+ *
+ * ###Example
+ *
+ * Route the replica requests of the role-based failover to the replicas which do not lag
+ * behind for more than 500 milliseconds, and to the master if all of them do.
+ *
+@code
+#include <ozo/failover/role_based.h>
+#include <ozo/failover/lag_aware.h>
+
+//...
+
+ozo::failover::replication_lag_config config;
+config.max_lag = 500ms;
+auto replicas = ozo::failover::make_lag_aware_connection_source(config,
+    ozo::connection_info(cfg.replica1_connstr),
+    ozo::connection_info(cfg.replica2_connstr)
+);
+replicas.start_monitoring(io);
+
+auto conn_info = ozo::failover::make_role_based_connection_source(
+    ozo::failover::replica=replicas,
+    ozo::failover::master=ozo::connection_info(cfg.master_connstr)
+);
+
+ozo::request[ozo::failover::role_based(ozo::failover::replica, ozo::failover::master)](
+    conn_info[io], query, 1s, ozo::into(result), yield);
+@endcode
+ *
+ * @param config --- replication lag monitoring configuration.
+ * @param source --- connection source of the first replica.
+ * @param sources --- connection sources of the other replicas of the same type.
+ * @return `ozo::failover::lag_aware_connection_source` object.
+ * @ingroup group-failover-lag_aware
+ */
+template <typename Source, typename ...Sources>
+auto make_lag_aware_connection_source(const replication_lag_config& config, Source&& source, Sources&& ...sources) {
+    using source_type = std::decay_t<Source>;
+    static_assert((std::is_same_v<source_type, std::decay_t<Sources>> && ...),
+        "all the sources should be of the same type");
+    std::vector<source_type> v;
+    v.reserve(1 + sizeof...(Sources));
+    v.emplace_back(std::forward<Source>(source));
+    (v.emplace_back(std::forward<Sources>(sources)), ...);
+    return lag_aware_connection_source<source_type>{std::move(v), config};
+}
+
+} // namespace ozo::failover
@@ -0,0 +1,275 @@
+#pragma once
+
+#include <ozo/connector.h>
+#include <ozo/connection.h>
+#include <ozo/time_traits.h>
+#include <ozo/asio.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @defgroup group-failover-least_loaded Least loaded host selection
+ * @ingroup group-failover
+ * @brief Connection source which chooses the least loaded of equivalent hosts
+ */
+
+namespace ozo::failover {
+
+namespace detail {
+
+/**
+* Load of a host as it is seen by the client: the number of outstanding
+* connection requests and the exponentially weighted moving average of their
+* latency. All the members are lock-free so the load may be updated from
+* the different threads.
+*/
+class host_load {
+public:
+    static constexpr std::int64_t smoothing_factor_denominator = 5;
+
+    void started() noexcept {
+        outstanding_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void finished(time_traits::duration latency) noexcept {
+        const auto sample = std::max<std::int64_t>(1,
+            std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count());
+        auto current = latency_.load(std::memory_order_relaxed);
+        while (!latency_.compare_exchange_weak(current, average(current, sample), std::memory_order_relaxed)) {}
+        outstanding_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    std::size_t outstanding() const noexcept {
+        return outstanding_.load(std::memory_order_relaxed);
+    }
+
+    time_traits::duration latency() const noexcept {
+        return std::chrono::duration_cast<time_traits::duration>(
+            std::chrono::nanoseconds(latency_.load(std::memory_order_relaxed)));
+    }
+
+    /**
+    * Expected cost of one more request to the host. A host without latency
+    * samples yet is treated as the fastest one so it gets its first requests.
+    */
+    std::uint64_t score() const noexcept {
+        return (static_cast<std::uint64_t>(latency_.load(std::memory_order_relaxed)) + 1) * (outstanding() + 1);
+    }
+
+private:
+    static constexpr std::int64_t average(std::int64_t current, std::int64_t sample) noexcept {
+        return current == 0 ? sample : current + (sample - current) / smoothing_factor_denominator;
+    }
+
+    std::atomic<std::size_t> outstanding_ {0};
+    std::atomic<std::int64_t> latency_ {0};
+};
+
+template <typename Source>
+struct least_loaded_state {
+    std::vector<Source> sources;
+    std::vector<host_load> loads;
+    std::atomic<std::uint64_t> seed;
+
+    least_loaded_state(std::vector<Source> sources, std::uint64_t seed)
+    : sources(std::move(sources)), loads(this->sources.size()), seed(seed) {}
+
+    // splitmix64, enough to pick two random hosts with no locking
+    std::uint64_t random() noexcept {
+        auto z = seed.fetch_add(0x9e3779b97f4a7c15ull, std::memory_order_relaxed) + 0x9e3779b97f4a7c15ull;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    /**
+    * Power of two choices: picks two different hosts at random and returns
+    * the less loaded one. Unlike picking the least loaded host of all it does
+    * not make all the clients rush to the same host at once.
+    */
+    std::size_t choose() noexcept {
+        const auto size = sources.size();
+        if (size == 1) {
+            return 0;
+        }
+        const auto value = random();
+        const auto first = static_cast<std::size_t>(value % size);
+        auto second = static_cast<std::size_t>((value / size) % (size - 1));
+        if (second >= first) {
+            ++second;
+        }
+        return loads[second].score() < loads[first].score() ? second : first;
+    }
+};
+
+template <typename Handler>
+struct least_loaded_handler {
+    Handler handler_;
+    host_load* load_;
+    time_traits::time_point start_;
+
+    template <typename Connection>
+    void operator() (error_code ec, Connection&& conn) {
+        load_->finished(time_traits::now() - start_);
+        handler_(std::move(ec), std::forward<Connection>(conn));
+    }
+
+    using executor_type = std::decay_t<decltype(asio::get_associated_executor(handler_))>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(handler_);
+    }
+
+    using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(handler_))>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(handler_);
+    }
+};
+
+template <typename Handler>
+least_loaded_handler(Handler, host_load*, time_traits::time_point) -> least_loaded_handler<Handler>;
+
+} // namespace detail
+
+/**
+ * @brief Connection source which dispatches requests to the least loaded host
+ *
+ * The source holds a number of equivalent connection sources, e.g. `ozo::connection_info`
+ * or `ozo::connection_pool` objects for the replicas of a database. For each host it tracks
+ * the number of outstanding connection requests and the exponentially weighted moving average
+ * of their latency. A connection is requested from the less loaded of two randomly chosen hosts
+ * ("power of two choices"), so a host which becomes slow, e.g. due to vacuum, gets less
+ * requests until it recovers.
+ *
+ * The load is measured over getting a connection from the underlying source. For a connection
+ * pool this includes waiting for a connection to be returned to the pool, so a host with slow
+ * requests gets a longer queue and a higher latency.
+ *
+ * The statistics are shared by the copies of the source and are updated with no locks, so the
+ * source may be used by many threads simultaneously.
+ *
+ * @tparam Source --- type of the underlying `ConnectionSource` for each host.
+ * @sa `ozo::failover::make_least_loaded_connection_source()`
+ * @ingroup group-failover-least_loaded
+ * @models{ConnectionSource}
+ */
+template <typename Source>
+class least_loaded_connection_source {
+    static_assert(ConnectionSource<Source>, "Source should model ConnectionSource concept");
+
+    std::shared_ptr<detail::least_loaded_state<Source>> state_;
+
+public:
+    /**
+     * `Connection` implementation type according to `ConnectionSource` requirements.
+     * Specifies the `Connection` implementation type which can be obtained from this source.
+     */
+    using connection_type = typename connection_source_traits<Source>::connection_type;
+
+    /**
+     * @brief Construct a new least loaded connection source object
+     *
+     * @param sources --- non empty sequence of connection sources of the hosts.
+     * @param seed --- seed for the random choice of the hosts.
+     */
+    explicit least_loaded_connection_source(std::vector<Source> sources,
+            std::uint64_t seed = static_cast<std::uint64_t>(time_traits::now().time_since_epoch().count()))
+    : state_(std::make_shared<detail::least_loaded_state<Source>>(std::move(sources), seed)) {
+        if (state_->sources.empty()) {
+            throw std::invalid_argument("least_loaded_connection_source: sources should not be empty");
+        }
+    }
+
+    /**
+     * @brief Provides a connection from the less loaded of two hosts
+     *
+     * @param io --- `io_context` for the connection IO.
+     * @param t --- #TimeConstraint for the operation.
+     * @param handler --- #Handler.
+     */
+    template <typename TimeConstraint, typename Handler>
+    void operator ()(io_context& io, TimeConstraint t, Handler&& handler) const {
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        const auto index = state_->choose();
+        auto& load = state_->loads[index];
+        load.started();
+        state_->sources[index](io, std::move(t),
+            detail::least_loaded_handler{std::forward<Handler>(handler), std::addressof(load), time_traits::now()});
+    }
+
+    /**
+     * Number of the hosts.
+     */
+    std::size_t size() const noexcept { return state_->sources.size();}
+
+    /**
+     * Number of the connection requests to the host which are not completed yet.
+     *
+     * @param host --- index of the host in the sequence given to the constructor.
+     */
+    std::size_t outstanding(std::size_t host) const noexcept { return state_->loads[host].outstanding();}
+
+    /**
+     * Moving average of the connection requests latency of the host, zero if there
+     * were no requests completed.
+     *
+     * @param host --- index of the host in the sequence given to the constructor.
+     */
+    time_traits::duration latency(std::size_t host) const noexcept { return state_->loads[host].latency();}
+
+    auto operator [](io_context& io) const & {
+        return connection_provider(*this, io);
+    }
+
+    auto operator [](io_context& io) && {
+        return connection_provider(std::move(*this), io);
+    }
+};
+
+/**
+ * @brief Creates connection source which dispatches requests to the least loaded host
+ *
+ * ###Example
+ *
+ * Route the replica requests of the role-based failover to the least loaded replica.
+ *
+@code
+#include <ozo/failover/role_based.h>
+#include <ozo/failover/least_loaded.h>
+
+//...
+
+auto conn_info = ozo::failover::make_role_based_connection_source(
+    ozo::failover::master=ozo::connection_info(cfg.master_connstr),
+    ozo::failover::replica=ozo::failover::make_least_loaded_connection_source(
+        ozo::connection_info(cfg.replica1_connstr),
+        ozo::connection_info(cfg.replica2_connstr),
+        ozo::connection_info(cfg.replica3_connstr)
+    )
+);
+@endcode
+ *
+ * @param source --- connection source of the first host.
+ * @param sources --- connection sources of the other hosts of the same type.
+ * @return `ozo::failover::least_loaded_connection_source` object.
+ * @ingroup group-failover-least_loaded
+ */
+template <typename Source, typename ...Sources>
+auto make_least_loaded_connection_source(Source&& source, Sources&& ...sources) {
+    using source_type = std::decay_t<Source>;
+    static_assert((std::is_same_v<source_type, std::decay_t<Sources>> && ...),
+        "all the sources should be of the same type");
+    std::vector<source_type> v;
+    v.reserve(1 + sizeof...(Sources));
+    v.emplace_back(std::forward<Source>(source));
+    (v.emplace_back(std::forward<Sources>(sources)), ...);
+    return least_loaded_connection_source<source_type>{std::move(v)};
+}
+
+} // namespace ozo::failover
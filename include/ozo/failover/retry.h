@@ -3,6 +3,14 @@
 #include <ozo/failover/strategy.h>
 #include <ozo/core/options.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
 /**
  * @defgroup group-failover-retry Retry
  * @ingroup group-failover
@@ -29,8 +37,216 @@ constexpr auto make_errcs_tuple(ErrorConditions ...errcs) {
     return hana::make_tuple(errcs...);
 }
 
+inline std::uint64_t backoff_random() {
+    static thread_local std::mt19937_64 engine(
+        static_cast<std::uint64_t>(time_traits::now().time_since_epoch().count())
+        ^ std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    return engine();
+}
+
+template <typename Provider>
+inline auto get_provider_executor(const Provider& provider) {
+    if constexpr (Connection<Provider>) {
+        return ozo::get_executor(provider);
+    } else {
+        return provider.get_executor();
+    }
+}
+
+template <typename Provider, typename TimeConstraint, typename Handler, typename Timer>
+struct backoff_handler {
+    Provider provider_;
+    TimeConstraint t_;
+    Handler handler_;
+    std::shared_ptr<Timer> timer_;
+
+    void operator() (error_code) {
+        ozo::async_get_connection(std::move(provider_), t_, std::move(handler_));
+    }
+
+    using executor_type = std::decay_t<decltype(asio::get_associated_executor(handler_))>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(handler_);
+    }
+
+    using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(handler_))>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(handler_);
+    }
+};
+
+template <typename Provider, typename TimeConstraint, typename Handler, typename Timer>
+backoff_handler(Provider, TimeConstraint, Handler, std::shared_ptr<Timer>)
+    -> backoff_handler<Provider, TimeConstraint, Handler, Timer>;
+
+/**
+* Gets a connection from the provider once the delay has expired. The delay is
+* counted in the time constraint of the operation.
+*/
+template <typename Provider, typename TimeConstraint, typename Handler>
+inline void async_get_connection_after(Provider&& provider, time_traits::duration delay,
+        TimeConstraint t, Handler&& handler) {
+    if (delay <= time_traits::duration::zero()) {
+        return ozo::async_get_connection(std::forward<Provider>(provider), t, std::forward<Handler>(handler));
+    }
+    const auto ex = get_provider_executor(provider);
+    using timer_type = typename ozo::detail::operation_timer<std::decay_t<decltype(ex)>>::type;
+    auto timer = std::allocate_shared<timer_type>(asio::get_associated_allocator(handler),
+        ozo::detail::get_operation_timer(ex, delay));
+    auto& timer_ref = *timer;
+    timer_ref.async_wait(backoff_handler{std::forward<Provider>(provider), ozo::deadline(t),
+        std::forward<Handler>(handler), std::move(timer)});
+}
+
+/**
+* Connection provider of a retry which waits for the backoff delay before
+* getting a connection.
+*/
+template <typename Provider>
+struct backoff_connection_provider {
+    Provider provider_;
+    time_traits::duration delay_;
+
+    template <typename TimeConstraint, typename Handler>
+    void async_get_connection(TimeConstraint t, Handler&& h) const & {
+        async_get_connection_after(provider_, delay_, t, std::forward<Handler>(h));
+    }
+
+    template <typename TimeConstraint, typename Handler>
+    void async_get_connection(TimeConstraint t, Handler&& h) && {
+        async_get_connection_after(std::move(provider_), delay_, t, std::forward<Handler>(h));
+    }
+};
+
+template <typename Provider>
+backoff_connection_provider(Provider, time_traits::duration) -> backoff_connection_provider<Provider>;
+
 } // namespace detail
 
+/**
+ * @brief Retry budget
+ *
+ * Token bucket which limits the number of retries to a fraction of the operations performed.
+ * Each operation deposits `ratio` tokens, each retry takes one token and is not performed if
+ * there is no token left. The bucket holds no more than `reserve` tokens and is full initially,
+ * so a client with a low rate of operations is still able to retry occasional errors.
+ *
+ * When a database host goes down, all the operations fail and would be retried with no
+ * budget. This multiplies load on the remaining hosts exactly when they are weakest. With the
+ * budget the retries are limited to `ratio` of the operations once the reserve is exhausted.
+ *
+ * The budget is shared by its copies and is updated with no locks, so one budget may be
+ * used by many strategies and threads simultaneously.
+ *
+ * @sa `ozo::failover::retry_strategy::budget()`
+ * @ingroup group-failover-retry
+ */
+class retry_budget {
+    static constexpr std::int64_t scale = 1000;
+
+    struct state {
+        const std::int64_t deposit;
+        const std::int64_t capacity;
+        std::atomic<std::int64_t> tokens;
+
+        state(std::int64_t deposit, std::int64_t capacity)
+        : deposit(deposit), capacity(capacity), tokens(capacity) {}
+    };
+
+    std::shared_ptr<state> state_;
+
+public:
+    /**
+     * @brief Construct a new retry budget object
+     *
+     * @param ratio --- number of retries allowed per operation, in range [0, 1], e.g. `0.1` for 10% of operations.
+     * @param reserve --- maximum number of tokens, should be positive.
+     */
+    explicit retry_budget(double ratio = 0.1, int reserve = 10) {
+        if (!(ratio >= 0.0 && ratio <= 1.0)) {
+            throw std::invalid_argument("retry_budget: ratio should be in range [0, 1]");
+        }
+        if (reserve < 1) {
+            throw std::invalid_argument("retry_budget: reserve should be positive");
+        }
+        state_ = std::make_shared<state>(static_cast<std::int64_t>(ratio * scale), std::int64_t(reserve) * scale);
+    }
+
+    /**
+     * Deposits tokens for an operation.
+     */
+    void deposit() const noexcept {
+        auto current = state_->tokens.load(std::memory_order_relaxed);
+        while (current < state_->capacity && !state_->tokens.compare_exchange_weak(current,
+                std::min(state_->capacity, current + state_->deposit), std::memory_order_relaxed)) {}
+    }
+
+    /**
+     * Takes a token for a retry.
+     *
+     * @return `true` --- the retry is allowed.
+     * @return `false` --- there is no token left, the retry should not be performed.
+     */
+    bool withdraw() const noexcept {
+        auto current = state_->tokens.load(std::memory_order_relaxed);
+        while (current >= scale) {
+            if (state_->tokens.compare_exchange_weak(current, current - scale, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Number of tokens left, may be fractional.
+     */
+    double tokens() const noexcept {
+        return static_cast<double>(state_->tokens.load(std::memory_order_relaxed)) / scale;
+    }
+};
+
+/**
+ * @brief Exponential backoff with full jitter
+ *
+ * The delay before the retry number `n` (starting from 0) is a random duration in range
+ * [0, min(`max`, `base` * 2<small>n</small>)]. The randomization spreads retries of the
+ * operations failed at the same moment, so they do not hit a host all at once.
+ *
+ * @sa `ozo::failover::retry_strategy::backoff()`
+ * @ingroup group-failover-retry
+ */
+struct exponential_backoff {
+    time_traits::duration base; //!< delay cap of the first retry
+    time_traits::duration max; //!< maximum delay cap
+
+    /**
+     * Upper bound of the delay before the retry.
+     *
+     * @param n --- number of the retry starting from 0.
+     */
+    constexpr time_traits::duration cap(int n) const noexcept {
+        auto v = base;
+        for (int i = 0; i < n && v < max; ++i) {
+            v *= 2;
+        }
+        return std::min(v, max);
+    }
+
+    /**
+     * Delay before the retry.
+     *
+     * @param n --- number of the retry starting from 0.
+     * @param random --- uniformly distributed random number.
+     */
+    constexpr time_traits::duration delay(int n, std::uint64_t random) const noexcept {
+        const auto bound = cap(n).count();
+        return time_traits::duration(bound > 0 ? static_cast<time_traits::duration::rep>(
+            random % (static_cast<std::uint64_t>(bound) + 1)) : 0);
+    }
+};
+
 /**
  * @brief Options for retry
  *
@@ -42,11 +258,15 @@ struct retry_options {
     class close_connection_tag;
     class tries_tag;
     class conditions_tag;
+    class budget_tag;
+    class backoff_tag;
 
     constexpr static option<on_retry_tag> on_retry{}; //!< Set handler for retry event, may be useful for logging.
     constexpr static option<close_connection_tag> close_connection{}; //!< Set close connection policy on retry, possible values `true`(default), `false`.
     constexpr static option<tries_tag> tries{}; //!< Set number of tries, see `ozo::retry_strategy::tries()` for more information.
     constexpr static option<conditions_tag> conditions{}; //!< Set error conditions to retry
+    constexpr static option<budget_tag> budget{}; //!< Set `ozo::failover::retry_budget` to limit retries, see `ozo::retry_strategy::budget()`.
+    constexpr static option<backoff_tag> backoff{}; //!< Set `ozo::failover::exponential_backoff` delay between tries, see `ozo::retry_strategy::backoff()`.
 };
 
 /**
@@ -92,7 +312,7 @@ public:
      */
     auto get_context() const {
         return hana::concat(
-            hana::make_tuple(ozo::unwrap(ctx_).provider, time_constraint()),
+            hana::make_tuple(provider(), time_constraint()),
             ozo::unwrap(ctx_).args
         );
     }
@@ -117,7 +337,10 @@ public:
         adjust_tries_remain();
         if (can_retry(ec)) {
             get_option(options(), op::on_retry, [](auto&&...){})(ec, conn);
+            const auto delay = next_delay();
             retval.emplace(basic_try{std::move(options_), std::move(ctx_)});
+            retval->retries_ = retries_ + 1;
+            retval->delay_ = delay;
         }
 
         return retval;
@@ -144,7 +367,42 @@ public:
         return detail::get_try_time_constraint(ozo::unwrap(ctx_).time_constraint, tries_remain());
     }
 
+    /**
+     * @brief Delay before the try
+     *
+     * @return time_traits::duration --- backoff delay the try waits before getting a connection,
+     *                                   zero for the first try or if no backoff is specified.
+     */
+    constexpr time_traits::duration delay() const { return delay_;}
+
 private:
+    template <typename Option>
+    constexpr static bool has_option(Option o) {
+        return decltype(hana::contains(std::declval<const Options&>(), o))::value;
+    }
+
+    auto provider() const {
+        if constexpr (has_option(op::backoff)) {
+            return detail::backoff_connection_provider{ozo::unwrap(ctx_).provider, delay_};
+        } else {
+            return ozo::unwrap(ctx_).provider;
+        }
+    }
+
+    // Should be called after the tries remain are adjusted. The delay takes no more than
+    // a half of the next try time, so the backoff does not eat the operation time constraint.
+    time_traits::duration next_delay() const {
+        if constexpr (has_option(op::backoff)) {
+            auto result = options()[op::backoff].delay(retries_, detail::backoff_random());
+            if constexpr (!std::is_same_v<decltype(time_constraint()), none_t>) {
+                result = std::min(result, time_constraint() / 2);
+            }
+            return result;
+        } else {
+            return time_traits::duration::zero();
+        }
+    }
+
     void adjust_tries_remain() {
         options_[op::tries] = std::max(0, tries_remain() - 1);
     }
@@ -154,13 +412,22 @@ private:
             return false;
         }
 
-        if constexpr (decltype(hana::is_empty(get_conditions()))::value) {
-            return true;
+        if constexpr (!decltype(hana::is_empty(get_conditions()))::value) {
+            if (!errc::match_code(get_conditions(), ec)) {
+                return false;
+            }
+        }
+
+        if constexpr (has_option(op::budget)) {
+            return options()[op::budget].withdraw();
         } else {
-            return errc::match_code(get_conditions(), ec);
+            return true;
         }
     }
     constexpr static const auto no_conditions_ = hana::make_tuple();
+
+    int retries_ = 0;
+    time_traits::duration delay_ {0};
 };
 
 
@@ -200,23 +467,30 @@ public:
      * Default implementation for `ozo::fallback::get_first_try()` failover
      * strategy interface function.
      *
+     * A `Query` argument is converted to `ozo::binary_query` once and the conversion
+     * is shared by all the tries of the operation.
+     *
      * @param alloc --- allocator which should be used for try context.
      * @param args --- operation arguments.
      * @return basic_try --- first try object.
      */
     template <typename Operation, typename Allocator, typename ConnectionProvider,
             typename TimeConstraint, typename ...Args>
-    auto get_first_try(const Operation&, const Allocator&,
+    auto get_first_try(const Operation&, const Allocator& alloc,
             ConnectionProvider&& provider, TimeConstraint t, Args&& ...args) const {
 
         static_assert(decltype(this->has(op::tries))::value, "number of tries should be specified");
 
+        if constexpr (decltype(this->has(op::budget))::value) {
+            this->get(op::budget).deposit();
+        }
+
         return basic_try {
             this->options(),
             basic_context{
                 std::forward<ConnectionProvider>(provider),
                 ozo::deadline(t),
-                std::forward<Args>(args)...
+                ozo::detail::share_binary_query(alloc, std::forward<Args>(args))...
             }
         };
     }
@@ -255,6 +529,60 @@ public:
     constexpr decltype(auto) tries(int n) const & { return this->set(op::tries, n);}
     constexpr decltype(auto) tries(int n) && { return std::move(*this).set(op::tries, n);}
 
+    /**
+     * @brief Specify retry budget
+     *
+     * Limit retries of the operations performed with the strategy by the budget, see
+     * `ozo::failover::retry_budget`. The budget is shared by the copies of the strategy,
+     * so the same strategy object or budget should be used for the operations which
+     * retries should be limited together, e.g. the operations on the same cluster.
+     *
+     * @param b --- retry budget.
+     * @return `retry_strategy` specialization object
+     *
+     * ###Example
+     *
+     * Retry no more than 10% of the operations once 20 reserve tokens are exhausted.
+     *
+     * @code
+    const auto retry = failover::retry(errc::connection_error).budget(failover::retry_budget{0.1, 20})*3;
+    ozo::request[retry](pool[io], query, .5s, out, yield);
+     * @endcode
+     */
+    decltype(auto) budget(retry_budget b) const & { return this->set(op::budget, std::move(b));}
+    decltype(auto) budget(retry_budget b) && { return std::move(*this).set(op::budget, std::move(b));}
+
+    /**
+     * @brief Specify exponential backoff between tries
+     *
+     * The next try waits for a random delay before getting a connection, see
+     * `ozo::failover::exponential_backoff`. The delay is counted in the operation
+     * #TimeConstraint and takes no more than a half of the next try time.
+     *
+     * @note The connection provider should have `get_executor()` member function
+     * which returns the executor for the delay timer, like `ozo::connection_provider`,
+     * or be a `Connection`.
+     *
+     * @param base --- delay cap of the first retry.
+     * @param max --- maximum delay cap.
+     * @return `retry_strategy` specialization object
+     *
+     * ###Example
+     *
+     * Retry with the delay up to 10ms, 20ms, 40ms and so on up to 200ms.
+     *
+     * @code
+    const auto retry = failover::retry(errc::connection_error).backoff(10ms, 200ms)*5;
+    ozo::request[retry](pool[io], query, 2s, out, yield);
+     * @endcode
+     */
+    constexpr decltype(auto) backoff(time_traits::duration base, time_traits::duration max) const & {
+        return this->set(op::backoff, exponential_backoff{base, max});
+    }
+    constexpr decltype(auto) backoff(time_traits::duration base, time_traits::duration max) && {
+        return std::move(*this).set(op::backoff, exponential_backoff{base, max});
+    }
+
     /**
      * @brief Number of maximum tries count are setted with `ozo::retry_strategy::tries()`
      *
@@ -317,6 +645,10 @@ constexpr auto retry(ErrorConditions ...ec) {
 
 namespace ozo {
 
+template <typename Provider>
+struct get_connection_type<failover::detail::backoff_connection_provider<Provider>>
+: get_connection_type<Provider> {};
+
 template <typename ...Ts, typename Op>
 struct construct_initiator_impl<failover::retry_strategy<Ts...>, Op>
 : failover::construct_initiator_impl {};
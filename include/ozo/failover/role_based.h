@@ -317,6 +317,11 @@ public:
         static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
         ozo::unwrap(std::forward<Source>(source_))(io_, std::move(t), std::forward<Handler>(h));
     }
+
+    /**
+     * Executor of the `io_context` the provider is bound to.
+     */
+    auto get_executor() const { return io_.get_executor();}
 };
 
 template <typename T>
@@ -577,7 +582,7 @@ public:
 
     template <typename Operation, typename Allocator, typename Source,
             typename TimeConstraint, typename ...Args>
-    auto get_first_try(const Operation&, const Allocator&,
+    auto get_first_try(const Operation&, const Allocator& alloc,
             role_based_connection_provider<Source> provider, TimeConstraint t, Args&& ...args) const {
 
         static_assert(decltype(this->has(opt::roles))::value, "roles should be specified");
@@ -585,7 +590,8 @@ public:
 
         return role_based_try {
             this->options(),
-            basic_context{std::move(provider), ozo::deadline(t), std::forward<Args>(args)...}
+            basic_context{std::move(provider), ozo::deadline(t),
+                ozo::detail::share_binary_query(alloc, std::forward<Args>(args))...}
         };
     }
 };
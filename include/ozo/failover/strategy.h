@@ -4,6 +4,7 @@
 #include <ozo/asio.h>
 #include <ozo/deadline.h>
 #include <ozo/connection.h>
+#include <ozo/detail/shared_binary_query.h>
 
 #include <tuple>
 
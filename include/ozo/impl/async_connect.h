@@ -3,8 +3,11 @@
 #include <ozo/detail/wrap_executor.h>
 #include <ozo/detail/timeout_handler.h>
 #include <ozo/detail/deadline.h>
+#include <ozo/detail/probes.h>
+#include <ozo/detail/oid_map_cache.h>
 #include <ozo/impl/io.h>
 #include <ozo/impl/request_oid_map.h>
+#include <ozo/impl/async_session_setup.h>
 #include <ozo/time_traits.h>
 #include <ozo/connection.h>
 
@@ -16,11 +19,24 @@
 namespace ozo {
 namespace impl {
 
+template <typename Handler, typename Cache>
+struct request_oid_map_handler;
+
+template <typename Handler>
+struct is_request_oid_map_handler : std::false_type {};
+
+template <typename Handler, typename Cache>
+struct is_request_oid_map_handler<request_oid_map_handler<Handler, Cache>> : std::true_type {};
+
 /**
 * Asynchronous connection operation
 */
 template <typename Connection, typename Handler>
-struct async_connect_op {
+struct async_connect_op : detail::connect_timeline_sample<
+        std::decay_t<decltype(unwrap_connection(std::declval<Connection&>()))>> {
+    using timeline_type = detail::connect_timeline_sample<
+        std::decay_t<decltype(unwrap_connection(std::declval<Connection&>()))>>;
+
     Connection connection_;
     Handler handler_;
 
@@ -28,12 +44,18 @@ struct async_connect_op {
         return unwrap_connection(connection_);
     }
 
+    timeline_type& timeline() noexcept {
+        return *this;
+    }
+
     async_connect_op(Connection conn, Handler handler)
     : connection_(std::move(conn)), handler_(std::move(handler)) {
     }
 
-    void perform(const std::string& conninfo) {
+    template <typename ConnInfo>
+    void perform(const ConnInfo& conninfo) {
         auto handle = start_connection(connection(), conninfo);
+        timeline().mark(connect_phase::start);
         if (!handle) {
             return done(error::pq_connection_start_failed);
         }
@@ -47,6 +69,8 @@ struct async_connect_op {
             return done(ec);
         }
 
+        OZO_PROBE(connect__start, get_native_handle(connection()));
+
         return connection().async_wait_write(std::move(*this));
     }
 
@@ -58,7 +82,11 @@ struct async_connect_op {
             return done(ec);
         }
 
-        switch (connect_poll(connection())) {
+        timeline().poll_started(connection());
+        const auto status = connect_poll(connection());
+        timeline().poll_finished();
+
+        switch (status) {
             case PGRES_POLLING_OK:
                 return done();
 
@@ -77,7 +105,13 @@ struct async_connect_op {
     }
 
     void done(error_code ec = error_code {}) {
-        handler_(std::move(ec), std::move(connection_));
+        OZO_PROBE(connect__done, get_native_handle(connection()), ec.value());
+        if constexpr (is_request_oid_map_handler<Handler>::value && !std::is_empty_v<timeline_type>) {
+            handler_(std::move(ec), std::move(connection_), std::move(timeline()));
+        } else {
+            timeline().commit(connection(), bool(ec));
+            handler_(std::move(ec), std::move(connection_));
+        }
     }
 
     using executor_type = asio::associated_executor_t<Handler>;
@@ -98,22 +132,169 @@ async_connect_op(Connection, Handler) -> async_connect_op<Connection, Handler>;
 
 template <typename Connection, typename Handler>
 inline void request_oid_map(Connection&& conn, Handler&& handler) {
-    ozo::impl::request_oid_map_op op{std::forward<Handler>(handler)};
+    ozo::impl::request_oid_map_op op{ozo::unwrap_connection(conn), std::forward<Handler>(handler)};
     op.perform(std::forward<Connection>(conn));
 }
 
-template <typename Handler>
+/**
+* Executes the session setup statements of an established connection, if any, and
+* the oid map request if `request_oids` is true and the prepares of the hot
+* statements, if any, in the same pipeline, then calls the handler with the
+* connection.
+*/
+template <typename Connection, typename Handler>
+inline void request_session_setup(Connection&& conn, [[maybe_unused]] bool request_oids, Handler&& handler) {
+#ifdef LIBPQ_HAS_PIPELINING
+    using stream_type = std::decay_t<decltype(ozo::unwrap_connection(conn))>;
+    if constexpr (has_session_setup<stream_type>::value || has_hot_statements<stream_type>::value) {
+        if (get_session_setup(ozo::unwrap_connection(conn)) || get_hot_statements(conn)) {
+            return async_session_setup(std::forward<Connection>(conn), request_oids, std::forward<Handler>(handler));
+        }
+    }
+#endif
+    if constexpr (!OidMapEmpty<Connection>) {
+        if (request_oids) {
+            return request_oid_map(std::forward<Connection>(conn), std::forward<Handler>(handler));
+        }
+    }
+    handler(error_code{}, std::forward<Connection>(conn));
+}
+
+template <typename Connection>
+inline std::string get_server_identity(const Connection& conn) {
+    std::string result(get_host(conn));
+    result += ':';
+    result += get_port(conn);
+    result += '/';
+    result += get_database(conn);
+    return result;
+}
+
+/**
+* Stores the requested oid map of the connection into the cache.
+*/
+template <typename Handler, typename Cache>
+struct cache_oid_map_handler {
+    Handler handler_;
+    Cache cache_;
+    std::string server_;
+
+    template <typename Connection>
+    void operator() (error_code ec, Connection&& conn) {
+        if (!ec) {
+            cache_->insert(std::move(server_), ozo::unwrap_connection(conn).oid_map());
+        }
+        handler_(std::move(ec), std::forward<Connection>(conn));
+    }
+
+    using executor_type = asio::associated_executor_t<Handler>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(handler_);
+    }
+
+    using allocator_type = asio::associated_allocator_t<Handler>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(handler_);
+    }
+};
+
+template <typename Handler, typename Cache>
+cache_oid_map_handler(Handler, Cache, std::string) -> cache_oid_map_handler<Handler, Cache>;
+
+/**
+* Accounts the session setup and the oid map request in the connection
+* establishment timeline and commits it.
+*/
+template <typename Handler, typename Timeline>
+struct connect_timeline_handler {
+    Handler handler_;
+    Timeline timeline_;
+
+    template <typename Connection>
+    void operator() (error_code ec, Connection&& conn) {
+        timeline_.mark(connect_phase::oid_map);
+        timeline_.commit(ozo::unwrap_connection(conn), bool(ec));
+        handler_(std::move(ec), std::forward<Connection>(conn));
+    }
+
+    using executor_type = asio::associated_executor_t<Handler>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(handler_);
+    }
+
+    using allocator_type = asio::associated_allocator_t<Handler>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(handler_);
+    }
+};
+
+template <typename Handler, typename Timeline>
+connect_timeline_handler(Handler, Timeline) -> connect_timeline_handler<Handler, Timeline>;
+
+/**
+* Requests the oid map of an established connection. If the oid map cache is
+* given the oid map resolved for the same server is used instead and the oid
+* map requested is stored into the cache. Nothing is requested for a connection
+* which resolves the oids on their first use. The session setup statements of
+* the connection are sent in one pipeline with the oid map request.
+*/
+template <typename Handler, typename Cache = none_t>
 struct request_oid_map_handler {
     Handler handler_;
+    Cache cache_;
 
-    request_oid_map_handler(Handler handler) : handler_(std::move(handler)) {}
+    request_oid_map_handler(Handler handler, Cache cache = Cache{})
+    : handler_(std::move(handler)), cache_(std::move(cache)) {}
 
     template <typename Connection>
     void operator() (error_code ec, Connection&& conn) {
         if (ec) {
-            handler_(std::move(ec), std::forward<Connection>(conn));
+            return handler_(std::move(ec), std::forward<Connection>(conn));
+        }
+        setup(std::forward<Connection>(conn), std::move(handler_));
+    }
+
+    /**
+    * Continues the connection establishment timeline collected by the connect
+    * operation, so it includes the session setup and the oid map request.
+    */
+    template <typename Connection, typename Timeline>
+    void operator() (error_code ec, Connection&& conn, Timeline&& timeline) {
+        if (ec) {
+            timeline.commit(ozo::unwrap_connection(conn), true);
+            return handler_(std::move(ec), std::forward<Connection>(conn));
+        }
+        setup(std::forward<Connection>(conn),
+            connect_timeline_handler{std::move(handler_), std::forward<Timeline>(timeline)});
+    }
+
+    template <typename Connection, typename NextHandler>
+    void setup(Connection&& conn, NextHandler&& handler) {
+        if constexpr (OidMapEmpty<Connection>) {
+            return request_session_setup(std::forward<Connection>(conn), false, std::forward<NextHandler>(handler));
         } else {
-            request_oid_map(std::forward<Connection>(conn), std::move(handler_));
+            using stream_type = std::decay_t<decltype(ozo::unwrap_connection(conn))>;
+            if constexpr (has_lazy_oid_map<stream_type>::value) {
+                if (ozo::unwrap_connection(conn).lazy_oid_map()) {
+                    return request_session_setup(std::forward<Connection>(conn), false, std::forward<NextHandler>(handler));
+                }
+            }
+
+            if constexpr (IsNone<Cache>) {
+                request_session_setup(std::forward<Connection>(conn), true, std::forward<NextHandler>(handler));
+            } else {
+                auto server = get_server_identity(conn);
+                if (auto oid_map = cache_->find(server)) {
+                    ozo::unwrap_connection(conn).oid_map() = std::move(*oid_map);
+                    return request_session_setup(std::forward<Connection>(conn), false, std::forward<NextHandler>(handler));
+                }
+                request_session_setup(std::forward<Connection>(conn), true,
+                    cache_oid_map_handler{std::forward<NextHandler>(handler), std::move(cache_), std::move(server)});
+            }
         }
     }
 
@@ -130,16 +311,14 @@ struct request_oid_map_handler {
     }
 };
 
-template <typename Connection>
-constexpr bool OidMapEmpty = std::is_same_v<
-    typename std::decay_t<decltype(ozo::unwrap_connection(std::declval<Connection>()))>::oid_map_type,
-    ozo::empty_oid_map
->;
-
-template <typename Conn, typename Handler>
-constexpr auto apply_oid_map_request(Handler&& handler) {
-    if constexpr (!OidMapEmpty<Conn>) {
-        return request_oid_map_handler{std::forward<Handler>(handler)};
+template <typename Handler, typename Cache>
+request_oid_map_handler(Handler, Cache) -> request_oid_map_handler<Handler, Cache>;
+
+template <typename Conn, typename Handler, typename Cache = none_t>
+constexpr auto apply_oid_map_request(Handler&& handler, [[maybe_unused]] Cache cache = Cache{}) {
+    using stream_type = std::decay_t<decltype(ozo::unwrap_connection(std::declval<Conn>()))>;
+    if constexpr (!OidMapEmpty<Conn> || has_session_setup<stream_type>::value) {
+        return request_oid_map_handler{std::forward<Handler>(handler), std::move(cache)};
     } else {
         return std::forward<Handler>(handler);
     }
@@ -151,7 +330,7 @@ inline auto apply_time_constaint(const TimeConstraint& t, [[maybe_unused]] Conne
         return detail::wrap_executor {get_executor(conn), std::forward<Handler>(handler)};
     } else {
         auto h = detail::wrap_executor {
-            ozo::detail::make_strand_executor(get_executor(conn)), std::forward<Handler>(handler)
+            ozo::detail::make_connection_executor(conn), std::forward<Handler>(handler)
         };
         return detail::io_deadline_handler<std::decay_t<decltype(unwrap_connection(conn))>, std::decay_t<decltype(h)>, Connection> {
             unwrap_connection(conn), t, std::move(h)
@@ -159,13 +338,14 @@ inline auto apply_time_constaint(const TimeConstraint& t, [[maybe_unused]] Conne
     }
 }
 
-template <typename Connection, typename TimeConstraint, typename Handler>
-inline void async_connect(std::string conninfo, const TimeConstraint& t,
-        Connection&& conn, Handler&& handler) {
+template <typename ConnInfo, typename Connection, typename TimeConstraint, typename Handler, typename OidMapCache = none_t>
+inline void async_connect(const ConnInfo& conninfo, const TimeConstraint& t,
+        Connection&& conn, Handler&& handler, OidMapCache cache = OidMapCache{}) {
     static_assert(ozo::Connection<Connection>, "conn should model Connection concept");
 
     auto wrapped_handler = apply_oid_map_request<Connection>(
-        apply_time_constaint(t, conn, std::forward<Handler>(handler))
+        apply_time_constaint(t, conn, std::forward<Handler>(handler)),
+        std::move(cache)
     );
     auto op = async_connect_op {std::forward<Connection>(conn), std::move(wrapped_handler)};
     op.perform(conninfo);
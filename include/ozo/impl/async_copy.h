@@ -0,0 +1,884 @@
+#pragma once
+
+#include <ozo/impl/async_request.h>
+#include <ozo/io/copy.h>
+#include <ozo/detail/bind.h>
+
+#include <boost/asio/post.hpp>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace ozo::impl {
+
+/**
+* Default size of the COPY data buffer. Rows are serialized into the buffer
+* until its size exceeds this value, then the buffer is passed to libpq.
+*/
+constexpr std::size_t copy_buffer_size = 64 * 1024;
+
+/**
+* State of COPY FROM STDIN data transfer. Contains rows to send, position of
+* the next row to serialize and the buffer of the serialized data which is
+* being sent. The state is shared between the operation object copies since
+* the buffer and the position must survive the operation object movements.
+*/
+template <typename Rows>
+struct copy_in_data {
+    using rows_type = std::decay_t<decltype(ozo::unwrap(std::declval<const Rows&>()))>;
+    using iterator = decltype(std::begin(std::declval<const rows_type&>()));
+
+    Rows rows;
+    iterator pos;
+    std::vector<char> buffer;
+    bool header_sent = false;
+    bool trailer_sent = false;
+
+    copy_in_data(Rows rows) : rows(std::move(rows)), pos(std::begin(ozo::unwrap(this->rows))) {}
+
+    /**
+    * Serializes next rows into the buffer. Returns `false` if all the data
+    * including the trailer has been serialized already.
+    */
+    template <typename OidMap>
+    bool fill_buffer(const OidMap& oid_map) {
+        if (trailer_sent) {
+            return false;
+        }
+
+        buffer.clear();
+        ostream out(buffer);
+
+        if (!header_sent) {
+            send_copy_header(out);
+            header_sent = true;
+        }
+
+        const auto end = std::end(ozo::unwrap(rows));
+        while (pos != end && buffer.size() < copy_buffer_size) {
+            send_copy_row(out, oid_map, *pos++);
+        }
+
+        if (pos == end) {
+            send_copy_trailer(out);
+            trailer_sent = true;
+        }
+
+        return true;
+    }
+};
+
+struct copy_in_waiter {
+    virtual void complete(error_code ec) = 0;
+    virtual ~copy_in_waiter() = default;
+};
+
+template <typename Handler, typename Executor>
+struct copy_in_waiter_impl : copy_in_waiter {
+    Handler handler_;
+    Executor executor_;
+
+    copy_in_waiter_impl(Handler handler, const Executor& ex)
+    : handler_(std::move(handler)), executor_(ex) {}
+
+    void complete(error_code ec) override {
+        auto ex = asio::get_associated_executor(handler_, executor_);
+        asio::post(ex, detail::bind(std::move(handler_), std::move(ec)));
+    }
+};
+
+template <typename Handler, typename Executor>
+inline std::unique_ptr<copy_in_waiter> make_copy_in_waiter(Handler&& handler, const Executor& ex) {
+    return std::make_unique<copy_in_waiter_impl<std::decay_t<Handler>, Executor>>(std::forward<Handler>(handler), ex);
+}
+
+/**
+* Rows passed by a producer to a COPY FROM STDIN operation while it is running. The producer
+* serializes rows into the pending buffer and waits once the buffer reaches the limit until
+* the operation takes it, the operation waits for the pending buffer to reach the limit or
+* for the channel to be closed. So the producers are not faster than the connection and about
+* two buffers of the limit size are kept in memory. The producers and the operation may run
+* in different threads.
+*/
+class copy_in_channel {
+public:
+    using waiter_ptr = std::unique_ptr<copy_in_waiter>;
+
+    std::vector<char> buffer; // is being sent by the operation
+
+    explicit copy_in_channel(std::size_t limit) : limit_(limit) {
+        ostream out(pending_);
+        send_copy_header(out);
+    }
+
+    /**
+    * Serializes the row, the producer is completed once there is room for the next row.
+    * The producer is completed with the error of the operation if it has failed.
+    */
+    template <typename OidMap, typename Row>
+    void write(const OidMap& oid_map, const Row& row, waiter_ptr producer) {
+        std::unique_lock lock(mutex_);
+        if (error_ || closed_) {
+            const auto ec = error_ ? error_ : error_code{asio::error::operation_aborted};
+            lock.unlock();
+            return producer->complete(ec);
+        }
+        ostream out(pending_);
+        send_copy_row(out, oid_map, row);
+        waiter_ptr consumer;
+        if (pending_.size() >= limit_) {
+            producers_.push_back(std::move(producer));
+            consumer = std::move(consumer_);
+        }
+        lock.unlock();
+        if (consumer) {
+            consumer->complete(error_code{});
+        }
+        if (producer) {
+            producer->complete(error_code{});
+        }
+    }
+
+    /**
+    * No more rows, the rest of the data and the trailer are sent.
+    */
+    void close() {
+        std::unique_lock lock(mutex_);
+        closed_ = true;
+        auto consumer = std::move(consumer_);
+        lock.unlock();
+        if (consumer) {
+            consumer->complete(error_code{});
+        }
+    }
+
+    /**
+    * The operation has failed, so the producer does not wait for it anymore.
+    */
+    void fail(error_code ec) {
+        std::unique_lock lock(mutex_);
+        error_ = std::move(ec);
+        pending_ = {};
+        auto producers = std::move(producers_);
+        lock.unlock();
+        for (auto& producer : producers) {
+            producer->complete(error_);
+        }
+    }
+
+    /**
+    * Takes the pending data into the buffer. Returns `false` if there is not enough
+    * data to send yet or all the data including the trailer has been taken already.
+    */
+    template <typename OidMap>
+    bool fill_buffer(const OidMap&) {
+        std::unique_lock lock(mutex_);
+        if (trailer_sent_ || !ready()) {
+            return false;
+        }
+        buffer.clear();
+        buffer.swap(pending_);
+        if (closed_) {
+            ostream out(buffer);
+            send_copy_trailer(out);
+            trailer_sent_ = true;
+        }
+        auto producers = std::move(producers_);
+        lock.unlock();
+        for (auto& producer : producers) {
+            producer->complete(error_code{});
+        }
+        return true;
+    }
+
+    bool drained() const {
+        const std::lock_guard lock(mutex_);
+        return trailer_sent_;
+    }
+
+    /**
+    * Resumes the operation once there is data to send.
+    */
+    template <typename Operation>
+    void async_wait(Operation&& op) {
+        const auto ex = asio::get_associated_executor(op);
+        std::unique_lock lock(mutex_);
+        if (ready()) {
+            lock.unlock();
+            return asio::post(ex, detail::bind(std::forward<Operation>(op), error_code{}));
+        }
+        consumer_ = make_copy_in_waiter(std::forward<Operation>(op), ex);
+    }
+
+private:
+    bool ready() const noexcept { return closed_ || pending_.size() >= limit_;}
+
+    mutable std::mutex mutex_;
+    std::size_t limit_;
+    std::vector<char> pending_;
+    std::vector<waiter_ptr> producers_;
+    waiter_ptr consumer_;
+    error_code error_;
+    bool closed_ = false;
+    bool trailer_sent_ = false;
+};
+
+template <typename Data>
+constexpr bool copy_data_drained(const Data&) noexcept { return true;}
+
+inline bool copy_data_drained(const copy_in_channel& data) { return data.drained();}
+
+template <typename Data, typename Operation>
+inline void async_wait_copy_data(Data&, Operation&&) {}
+
+template <typename Operation>
+inline void async_wait_copy_data(copy_in_channel& data, Operation&& op) {
+    data.async_wait(std::forward<Operation>(op));
+}
+
+#include <boost/asio/yield.hpp>
+
+/**
+* Transfers rows in the COPY binary format after the COPY FROM STDIN query
+* has been sent. Waits for the `PGRES_COPY_IN` result, then passes the
+* serialized rows to libpq chunk by chunk. If libpq can not queue a chunk
+* because of full buffers the operation waits for the connection to be
+* write-ready, so memory usage is bounded by the buffer size regardless of
+* the number of rows. If the rows are written by a producer while the operation
+* is running, see `copy_in_channel`, the operation waits for them once there is
+* no data to send. After the COPY end is sent the final result of the query is
+* received and checked for errors.
+*/
+template <typename Context, typename Data>
+struct async_copy_in_op : boost::asio::coroutine {
+    Context ctx_;
+    std::shared_ptr<Data> data_;
+    using result_type = std::decay_t<decltype(get_result(get_connection(ctx_)))>;
+    result_type result_;
+    query_state send_state_ = query_state::send_in_progress;
+    error_code error_;
+
+    async_copy_in_op(Context ctx, std::shared_ptr<Data> data)
+    : ctx_(std::move(ctx)), data_(std::move(data)) {}
+
+    void perform() {
+        (*this)();
+    }
+
+    void done() {
+        return impl::done(ctx_);
+    }
+
+    void done(error_code ec) {
+        if (std::empty(get_error_context(get_connection(ctx_)))) {
+            get_connection(ctx_).set_error_context("error while copy data into a database");
+        }
+        return impl::done(ctx_, ec);
+    }
+
+    void operator() (error_code ec = error_code{}, std::size_t = 0) {
+        if (get_query_state(ctx_) == query_state::error) {
+            return;
+        }
+
+        if (ec) {
+            if (ec == asio::error::bad_descriptor) {
+                ec = asio::error::operation_aborted;
+            }
+            return done(ec);
+        }
+
+        reenter(*this) {
+            while (is_busy(get_connection(ctx_))) {
+                yield get_connection(ctx_).async_wait_read(std::move(*this));
+                if (auto err = consume_input(get_connection(ctx_))) {
+                    return done(err);
+                }
+            }
+
+            result_ = get_result(get_connection(ctx_));
+
+            if (!result_) {
+                get_connection(ctx_).set_error_context("no COPY IN result received");
+                return done(error::result_status_unexpected);
+            }
+
+            if (result_status(*result_) == PGRES_COPY_IN) {
+                for (;;) {
+                    if (!fill_buffer()) {
+                        if (error_) {
+                            return done(error_);
+                        }
+                        if (copy_data_drained(*data_)) {
+                            break;
+                        }
+                        yield async_wait_copy_data(*data_, std::move(*this));
+                        continue;
+                    }
+                    while ((send_state_ = put_copy_data(get_connection(ctx_),
+                            data_->buffer.data(), data_->buffer.size())) == query_state::send_in_progress) {
+                        yield get_connection(ctx_).async_wait_write(std::move(*this));
+                    }
+                    if (send_state_ == query_state::error) {
+                        return done(error::pg_put_copy_data_failed);
+                    }
+                }
+
+                while ((send_state_ = put_copy_end(get_connection(ctx_))) == query_state::send_in_progress) {
+                    yield get_connection(ctx_).async_wait_write(std::move(*this));
+                }
+                if (send_state_ == query_state::error) {
+                    return done(error::pg_put_copy_end_failed);
+                }
+
+                while ((send_state_ = flush_output(get_connection(ctx_))) == query_state::send_in_progress) {
+                    yield get_connection(ctx_).async_wait_write(std::move(*this));
+                }
+                if (send_state_ == query_state::error) {
+                    return done(error::pg_flush_failed);
+                }
+            } else if (result_status(*result_) == PGRES_COMMAND_OK) {
+                // The query is not a COPY FROM STDIN one so there is no way to send the rows.
+                unexpected_result();
+                return;
+            } else if (!handle_result()) {
+                return;
+            }
+
+            for (;;) {
+                while (is_busy(get_connection(ctx_))) {
+                    yield get_connection(ctx_).async_wait_read(std::move(*this));
+                    if (auto err = consume_input(get_connection(ctx_))) {
+                        return done(err);
+                    }
+                }
+
+                result_ = get_result(get_connection(ctx_));
+
+                if (!result_) {
+                    break;
+                }
+
+                if (!handle_result()) {
+                    return;
+                }
+            }
+
+            if (error_) {
+                return done(error_);
+            }
+
+            done();
+        }
+    }
+
+    /**
+    * Serializes the next rows, a serialization error, e.g. of a user defined
+    * type, fails the operation with `error::bad_result_process`.
+    */
+    bool fill_buffer() {
+        try {
+            return data_->fill_buffer(get_connection(ctx_).oid_map());
+        } catch (const std::exception& e) {
+            get_connection(ctx_).set_error_context(e.what());
+            set_error(error::bad_result_process);
+            return false;
+        }
+    }
+
+    /**
+    * Handles a result of the query. Errors are collected until all results
+    * are received to keep the connection usable.
+    */
+    bool handle_result() {
+        const auto status = result_status(*result_);
+        switch (status) {
+            case PGRES_COMMAND_OK:
+                return true;
+            case PGRES_BAD_RESPONSE:
+                set_error(error::result_status_bad_response);
+                return true;
+            case PGRES_EMPTY_QUERY:
+                set_error(error::result_status_empty_query);
+                return true;
+            case PGRES_FATAL_ERROR:
+                set_error(result_error(*result_));
+                return true;
+            case PGRES_SINGLE_TUPLE:
+#ifdef LIBPQ_HAS_CHUNK_MODE
+            case PGRES_TUPLES_CHUNK:
+#endif
+            case PGRES_TUPLES_OK:
+            case PGRES_COPY_OUT:
+            case PGRES_COPY_IN:
+            case PGRES_COPY_BOTH:
+            case PGRES_NONFATAL_ERROR:
+#ifdef LIBPQ_HAS_PIPELINING
+            case PGRES_PIPELINE_SYNC:
+            case PGRES_PIPELINE_ABORTED:
+#endif
+                break;
+        }
+
+        return unexpected_result();
+    }
+
+    bool unexpected_result() {
+        get_connection(ctx_).set_error_context(get_result_status_name(result_status(*result_)));
+        done(error::result_status_unexpected);
+        return false;
+    }
+
+    void set_error(error_code ec) {
+        if (!error_) {
+            error_ = std::move(ec);
+        }
+    }
+
+    using executor_type = std::decay_t<decltype(asio::get_associated_executor(get_handler(ctx_)))>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(get_handler(ctx_));
+    }
+
+    using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(get_handler(ctx_)))>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(get_handler(ctx_));
+    }
+};
+
+template <typename Context, typename Data>
+async_copy_in_op(Context, std::shared_ptr<Data>) -> async_copy_in_op<Context, Data>;
+
+#include <boost/asio/unyield.hpp>
+
+template <typename Context, typename Rows>
+inline void async_copy_in_data(Context&& ctx, Rows&& rows) {
+    auto data = std::allocate_shared<copy_in_data<std::decay_t<Rows>>>(
+        asio::get_associated_allocator(get_handler(ctx)), std::forward<Rows>(rows));
+    async_copy_in_op op{std::forward<Context>(ctx), std::move(data)};
+    op.perform();
+}
+
+template <typename Context>
+inline void async_copy_in_data(Context&& ctx, std::shared_ptr<copy_in_channel> channel) {
+    async_copy_in_op op{std::forward<Context>(ctx), std::move(channel)};
+    op.perform();
+}
+
+template <typename Query, typename Rows, typename TimeConstraint, typename Handler>
+struct async_copy_in_op_initiator {
+    Query query_;
+    Rows rows_;
+    TimeConstraint time_constraint_;
+    Handler handler_;
+
+    async_copy_in_op_initiator(Query query, Rows rows, TimeConstraint time_constraint, Handler handler)
+    : query_(std::move(query)), rows_(std::move(rows)), time_constraint_(time_constraint),
+      handler_(std::move(handler)) {}
+
+    template <typename Connection>
+    void operator() (error_code ec, Connection conn) {
+        if (ec) {
+            return handler_(ec, std::move(conn));
+        }
+
+        auto handler = apply_io_deadline(conn, time_constraint_, detail::wrap_executor {
+            detail::make_connection_executor(conn),
+            std::move(handler_)
+        });
+
+        auto ctx = make_request_operation_context(std::move(conn), std::move(handler));
+
+        async_send_query_params(ctx, std::move(query_));
+        async_copy_in_data(std::move(ctx), std::move(rows_));
+    }
+
+    using executor_type = std::decay_t<decltype(asio::get_associated_executor(handler_))>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(handler_);
+    }
+
+    using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(handler_))>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(handler_);
+    }
+};
+
+template <typename Query, typename Rows, typename TimeConstraint, typename Handler>
+async_copy_in_op_initiator(Query, Rows, TimeConstraint, Handler) ->
+    async_copy_in_op_initiator<Query, Rows, TimeConstraint, Handler>;
+
+template <typename P, typename Q, typename TimeConstraint, typename Rows, typename Handler>
+inline void async_copy_in(P&& provider, Q&& query, TimeConstraint t, Rows&& rows, Handler&& handler) {
+    static_assert(ConnectionProvider<P>, "is not a ConnectionProvider");
+    static_assert(BinaryQueryConvertible<Q>, "query should be convertible to the binary_query");
+    static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+    async_get_connection(std::forward<P>(provider), deadline(t),
+        async_copy_in_op_initiator {
+            std::forward<Q>(query),
+            std::forward<Rows>(rows),
+            deadline(t),
+            std::forward<Handler>(handler)
+        }
+    );
+}
+
+#include <boost/asio/yield.hpp>
+
+/**
+* Receives rows in the COPY binary format after the COPY TO STDOUT query has
+* been sent. Waits for the `PGRES_COPY_OUT` result, then receives the data
+* row by row as it arrives and passes each decoded tuple to the row handler,
+* so the result is never materialized as a whole. After all the data is
+* received the final result of the query is received and checked for errors.
+* In case of a row processing error the operation completes immediately.
+*/
+template <typename Context, typename RowHandler>
+struct async_copy_out_op : boost::asio::coroutine {
+    enum class copy_state {
+        error,
+        finish,
+        receive_in_progress
+    };
+
+    Context ctx_;
+    RowHandler process_;
+    using result_type = std::decay_t<decltype(get_result(get_connection(ctx_)))>;
+    result_type result_;
+    copy_state copy_state_ = copy_state::receive_in_progress;
+    bool header_received_ = false;
+    bool trailer_received_ = false;
+    error_code error_;
+
+    async_copy_out_op(Context ctx, RowHandler process)
+    : ctx_(std::move(ctx)), process_(std::move(process)) {}
+
+    void perform() {
+        (*this)();
+    }
+
+    void done() {
+        return impl::done(ctx_);
+    }
+
+    void done(error_code ec) {
+        if (std::empty(get_error_context(get_connection(ctx_)))) {
+            get_connection(ctx_).set_error_context("error while copy data from a database");
+        }
+        return impl::done(ctx_, ec);
+    }
+
+    void operator() (error_code ec = error_code{}, std::size_t = 0) {
+        if (get_query_state(ctx_) == query_state::error) {
+            return;
+        }
+
+        if (ec) {
+            if (ec == asio::error::bad_descriptor) {
+                ec = asio::error::operation_aborted;
+            }
+            return done(ec);
+        }
+
+        reenter(*this) {
+            while (is_busy(get_connection(ctx_))) {
+                yield get_connection(ctx_).async_wait_read(std::move(*this));
+                if (auto err = consume_input(get_connection(ctx_))) {
+                    return done(err);
+                }
+            }
+
+            result_ = get_result(get_connection(ctx_));
+
+            if (!result_) {
+                get_connection(ctx_).set_error_context("no COPY OUT result received");
+                return done(error::result_status_unexpected);
+            }
+
+            if (result_status(*result_) == PGRES_COPY_OUT) {
+                while ((copy_state_ = receive_copy_data()) == copy_state::receive_in_progress) {
+                    yield get_connection(ctx_).async_wait_read(std::move(*this));
+                    if (auto err = consume_input(get_connection(ctx_))) {
+                        return done(err);
+                    }
+                }
+                if (copy_state_ == copy_state::error) {
+                    return;
+                }
+            } else if (result_status(*result_) == PGRES_COMMAND_OK
+                    || result_status(*result_) == PGRES_TUPLES_OK) {
+                // The query is not a COPY TO STDOUT one so there is no COPY data to receive.
+                unexpected_result();
+                return;
+            } else if (!handle_result()) {
+                return;
+            }
+
+            for (;;) {
+                while (is_busy(get_connection(ctx_))) {
+                    yield get_connection(ctx_).async_wait_read(std::move(*this));
+                    if (auto err = consume_input(get_connection(ctx_))) {
+                        return done(err);
+                    }
+                }
+
+                result_ = get_result(get_connection(ctx_));
+
+                if (!result_) {
+                    break;
+                }
+
+                if (!handle_result()) {
+                    return;
+                }
+            }
+
+            if (error_) {
+                return done(error_);
+            }
+
+            done();
+        }
+    }
+
+    /**
+    * Receives and processes all the rows which are available without waiting.
+    */
+    copy_state receive_copy_data() {
+        for (;;) {
+            pg::copy_data data;
+            const auto size = get_copy_data(get_connection(ctx_), data);
+            if (size == 0) {
+                return copy_state::receive_in_progress;
+            }
+            if (size == -1) {
+                return copy_state::finish;
+            }
+            if (size < 0) {
+                done(error::pg_get_copy_data_failed);
+                return copy_state::error;
+            }
+            if (!process(data.get(), static_cast<std::size_t>(size))) {
+                return copy_state::error;
+            }
+        }
+    }
+
+    bool process(const char* data, std::size_t size) noexcept {
+        try {
+            istream in(data, size);
+            if (!header_received_) {
+                size -= recv_copy_header(in);
+                header_received_ = true;
+            }
+            if (size != 0 && !trailer_received_) {
+                std::int16_t fields_count = 0;
+                read(in, fields_count);
+                if (fields_count == detail::pg_copy_trailer) {
+                    trailer_received_ = true;
+                } else {
+                    process_(in, fields_count, get_connection(ctx_).oid_map());
+                }
+            }
+        } catch (const std::exception& e) {
+            get_connection(ctx_).set_error_context(e.what());
+            done(error::bad_result_process);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+    * Handles a result of the query. Errors are collected until all results
+    * are received to keep the connection usable.
+    */
+    bool handle_result() {
+        const auto status = result_status(*result_);
+        switch (status) {
+            case PGRES_COMMAND_OK:
+                return true;
+            case PGRES_BAD_RESPONSE:
+                set_error(error::result_status_bad_response);
+                return true;
+            case PGRES_EMPTY_QUERY:
+                set_error(error::result_status_empty_query);
+                return true;
+            case PGRES_FATAL_ERROR:
+                set_error(result_error(*result_));
+                return true;
+            case PGRES_SINGLE_TUPLE:
+#ifdef LIBPQ_HAS_CHUNK_MODE
+            case PGRES_TUPLES_CHUNK:
+#endif
+            case PGRES_TUPLES_OK:
+            case PGRES_COPY_OUT:
+            case PGRES_COPY_IN:
+            case PGRES_COPY_BOTH:
+            case PGRES_NONFATAL_ERROR:
+#ifdef LIBPQ_HAS_PIPELINING
+            case PGRES_PIPELINE_SYNC:
+            case PGRES_PIPELINE_ABORTED:
+#endif
+                break;
+        }
+
+        return unexpected_result();
+    }
+
+    bool unexpected_result() {
+        get_connection(ctx_).set_error_context(get_result_status_name(result_status(*result_)));
+        done(error::result_status_unexpected);
+        return false;
+    }
+
+    void set_error(error_code ec) {
+        if (!error_) {
+            error_ = std::move(ec);
+        }
+    }
+
+    using executor_type = std::decay_t<decltype(asio::get_associated_executor(get_handler(ctx_)))>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(get_handler(ctx_));
+    }
+
+    using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(get_handler(ctx_)))>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(get_handler(ctx_));
+    }
+};
+
+template <typename Context, typename RowHandler>
+async_copy_out_op(Context, RowHandler) -> async_copy_out_op<Context, RowHandler>;
+
+#include <boost/asio/unyield.hpp>
+
+template <typename Context, typename RowHandler>
+inline void async_copy_out_data(Context&& ctx, RowHandler&& h) {
+    async_copy_out_op op{std::forward<Context>(ctx), std::forward<RowHandler>(h)};
+    op.perform();
+}
+
+/**
+* Row handler which decodes COPY tuples into the output iterator.
+*/
+template <typename OutIterator>
+struct copy_out_into_handler {
+    OutIterator out;
+
+    template <typename OidMap>
+    void operator() (istream& in, std::int16_t fields_count, const OidMap& oid_map) {
+        if constexpr (InsertIterator<OutIterator>) {
+            typename OutIterator::container_type::value_type v{};
+            recv_copy_row(in, fields_count, oid_map, v);
+            *out++ = std::move(v);
+        } else {
+            recv_copy_row(in, fields_count, oid_map, *out++);
+        }
+    }
+};
+
+template <typename OutIterator>
+copy_out_into_handler(OutIterator) -> copy_out_into_handler<OutIterator>;
+
+/**
+* Row handler which decodes each COPY tuple into the `Row` object and passes
+* it to the user's callback.
+*/
+template <typename Row, typename Callback>
+struct copy_out_rows_handler {
+    Callback callback;
+
+    template <typename OidMap>
+    void operator() (istream& in, std::int16_t fields_count, const OidMap& oid_map) {
+        Row v{};
+        recv_copy_row(in, fields_count, oid_map, v);
+        callback(std::move(v));
+    }
+};
+
+template <typename T>
+struct is_copy_out_rows_handler : std::false_type {};
+
+template <typename Row, typename Callback>
+struct is_copy_out_rows_handler<copy_out_rows_handler<Row, Callback>> : std::true_type {};
+
+template <typename Out>
+inline auto make_copy_out_handler(Out&& out) {
+    if constexpr (is_copy_out_rows_handler<std::decay_t<Out>>::value) {
+        return std::forward<Out>(out);
+    } else {
+        static_assert(InsertIterator<Out> || ForwardIterator<Out>,
+            "out should be an insert iterator, a forward iterator or made by ozo::copy_rows()");
+        return copy_out_into_handler {std::forward<Out>(out)};
+    }
+}
+
+template <typename Query, typename RowHandler, typename TimeConstraint, typename Handler>
+struct async_copy_out_op_initiator {
+    Query query_;
+    RowHandler row_handler_;
+    TimeConstraint time_constraint_;
+    Handler handler_;
+
+    async_copy_out_op_initiator(Query query, RowHandler row_handler, TimeConstraint time_constraint, Handler handler)
+    : query_(std::move(query)), row_handler_(std::move(row_handler)), time_constraint_(time_constraint),
+      handler_(std::move(handler)) {}
+
+    template <typename Connection>
+    void operator() (error_code ec, Connection conn) {
+        if (ec) {
+            return handler_(ec, std::move(conn));
+        }
+
+        auto handler = apply_io_deadline(conn, time_constraint_, detail::wrap_executor {
+            detail::make_connection_executor(conn),
+            std::move(handler_)
+        });
+
+        auto ctx = make_request_operation_context(std::move(conn), std::move(handler));
+
+        async_send_query_params(ctx, std::move(query_));
+        async_copy_out_data(std::move(ctx), std::move(row_handler_));
+    }
+
+    using executor_type = std::decay_t<decltype(asio::get_associated_executor(handler_))>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(handler_);
+    }
+
+    using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(handler_))>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(handler_);
+    }
+};
+
+template <typename Query, typename RowHandler, typename TimeConstraint, typename Handler>
+async_copy_out_op_initiator(Query, RowHandler, TimeConstraint, Handler) ->
+    async_copy_out_op_initiator<Query, RowHandler, TimeConstraint, Handler>;
+
+template <typename P, typename Q, typename TimeConstraint, typename Out, typename Handler>
+inline void async_copy_out(P&& provider, Q&& query, TimeConstraint t, Out&& out, Handler&& handler) {
+    static_assert(ConnectionProvider<P>, "is not a ConnectionProvider");
+    static_assert(BinaryQueryConvertible<Q>, "query should be convertible to the binary_query");
+    static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+    async_get_connection(std::forward<P>(provider), deadline(t),
+        async_copy_out_op_initiator {
+            std::forward<Q>(query),
+            make_copy_out_handler(std::forward<Out>(out)),
+            deadline(t),
+            std::forward<Handler>(handler)
+        }
+    );
+}
+
+} // namespace ozo::impl
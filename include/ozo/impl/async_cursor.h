@@ -0,0 +1,154 @@
+#pragma once
+
+#include <ozo/impl/async_execute.h>
+#include <ozo/result.h>
+#include <ozo/detail/bind.h>
+
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/hana/unpack.hpp>
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace ozo::impl {
+
+constexpr const char* cursor_name = "ozo_cursor";
+
+/**
+* Prepends the cursor declaration to the query text, the parameters are kept as is.
+*/
+template <typename Query>
+inline auto make_cursor_declare(const Query& query) {
+    std::string text = "DECLARE ";
+    text += cursor_name;
+    text += " NO SCROLL CURSOR FOR ";
+    text += to_const_char(get_query_text(query));
+    return hana::unpack(get_query_params(query), [&] (const auto& ...params) {
+        return make_query(std::move(text), params...);
+    });
+}
+
+inline auto make_cursor_fetch(std::size_t page_rows) {
+    return make_query("FETCH FORWARD " + std::to_string(page_rows) + " FROM " + cursor_name);
+}
+
+inline auto make_cursor_close() {
+    return make_query(std::string("CLOSE ") + cursor_name);
+}
+
+/**
+* Shared state of `ozo::cursor()`. Each round runs two parties concurrently: the statement
+* which follows the page received, FETCH of the next page or CLOSE after the last one, and
+* the processing of the page. The next round starts once both parties complete, so only the
+* page being processed and the page being fetched are kept in memory.
+*/
+template <typename Connection, typename TimeConstraint, typename OnPage, typename Handler>
+class cursor_state : public std::enable_shared_from_this<cursor_state<Connection, TimeConstraint, OnPage, Handler>> {
+public:
+    cursor_state(std::size_t page_rows, TimeConstraint t, OnPage on_page, Handler handler)
+    : page_rows_(page_rows), t_(t), on_page_(std::move(on_page)), handler_(std::move(handler)) {}
+
+    template <typename Query>
+    void start(Connection conn, Query&& declare) {
+        async_execute(std::move(conn), std::forward<Query>(declare), t_,
+            [self = this->shared_from_this()] (error_code ec, Connection conn) {
+                if (ec) {
+                    return self->finish(std::move(ec), std::move(conn));
+                }
+                self->fetch(std::move(conn), [self] (error_code ec, Connection conn) {
+                    if (ec) {
+                        return self->finish(std::move(ec), std::move(conn));
+                    }
+                    self->round(std::exchange(self->next_, result{}), std::move(conn));
+                });
+            });
+    }
+
+private:
+    template <typename StatementHandler>
+    void fetch(Connection&& conn, StatementHandler&& handler) {
+        async_request(std::move(conn), make_cursor_fetch(page_rows_), t_, std::ref(next_),
+            std::forward<StatementHandler>(handler));
+    }
+
+    void round(result page, Connection&& conn) {
+        const auto executor = unwrap_connection(conn).get_executor();
+        last_ = std::size(page) < page_rows_;
+        pending_ = std::empty(page) ? 1 : 2;
+
+        auto statement_handler = [self = this->shared_from_this()] (error_code ec, Connection conn) {
+            self->statement_done(std::move(ec), std::move(conn));
+        };
+        if (last_) {
+            async_execute(std::move(conn), make_cursor_close(), t_, std::move(statement_handler));
+        } else {
+            fetch(std::move(conn), std::move(statement_handler));
+        }
+
+        if (!std::empty(page)) {
+            asio::post(executor, [self = this->shared_from_this(), page = std::move(page)] () mutable {
+                self->on_page_(std::move(page));
+                self->party_done();
+            });
+        }
+    }
+
+    void statement_done(error_code ec, Connection&& conn) {
+        {
+            const std::lock_guard lock(mutex_);
+            conn_.emplace(std::move(conn));
+            error_ = std::move(ec);
+        }
+        party_done();
+    }
+
+    void party_done() {
+        {
+            const std::lock_guard lock(mutex_);
+            if (--pending_) {
+                return;
+            }
+        }
+        auto conn = std::move(*conn_);
+        conn_.reset();
+        if (error_ || last_) {
+            return finish(std::move(error_), std::move(conn));
+        }
+        round(std::exchange(next_, result{}), std::move(conn));
+    }
+
+    void finish(error_code ec, Connection&& conn) {
+        auto ex = asio::get_associated_executor(handler_, unwrap_connection(conn).get_executor());
+        asio::dispatch(ex, detail::bind(std::move(handler_), std::move(ec), std::move(conn)));
+    }
+
+    std::size_t page_rows_;
+    TimeConstraint t_;
+    OnPage on_page_;
+    Handler handler_;
+    std::mutex mutex_;
+    std::size_t pending_ = 0;
+    bool last_ = false;
+    error_code error_;
+    std::optional<Connection> conn_;
+    result next_;
+};
+
+template <typename Connection, typename Q, typename TimeConstraint, typename OnPage, typename Handler>
+inline void async_cursor(Connection&& conn, Q&& query, std::size_t page_rows, TimeConstraint t,
+        OnPage on_page, Handler&& handler) {
+    static_assert(ozo::Connection<Connection>, "should model Connection concept");
+    static_assert(ozo::Query<Q>, "query should model Query concept");
+    static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+
+    using state_type = cursor_state<std::decay_t<Connection>, TimeConstraint, OnPage, std::decay_t<Handler>>;
+    const auto allocator = asio::get_associated_allocator(handler);
+    auto state = std::allocate_shared<state_type>(allocator, std::max<std::size_t>(page_rows, 1), t,
+        std::move(on_page), std::forward<Handler>(handler));
+    state->start(std::forward<Connection>(conn), make_cursor_declare(query));
+}
+
+} // namespace ozo::impl
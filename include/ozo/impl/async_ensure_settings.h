@@ -0,0 +1,177 @@
+#pragma once
+
+#include <ozo/impl/async_execute.h>
+#include <ozo/impl/transaction_status.h>
+#include <ozo/query_builder.h>
+#include <ozo/ext/std/vector.h>
+
+#include <algorithm>
+#include <cctype>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace ozo::impl {
+
+/**
+* Connection which tracks the session parameters set by `ozo::ensure_settings()` should
+* provide the `session_settings()` member function which returns `detail::session_settings`.
+*/
+template <typename T, typename = std::void_t<>>
+struct has_session_settings : std::false_type {};
+
+template <typename T>
+struct has_session_settings<T, std::void_t<decltype(std::declval<T&>().session_settings())>> : std::true_type {};
+
+template <typename Connection>
+inline std::optional<std::string> get_parameter_status(const Connection& conn, const std::string& name) {
+    if (const char* v = PQparameterStatus(get_native_handle(conn), name.c_str())) {
+        return std::string(v);
+    }
+    return std::nullopt;
+}
+
+/**
+* Names and values of the session parameters to set.
+*/
+struct settings_changes {
+    std::vector<std::string> names;
+    std::vector<std::string> values;
+};
+
+/**
+* Returns the parameters which values differ from the requested ones. A parameter set
+* by the connection before is compared with the value set while the server reports
+* the same status of it as after it was set. Other parameters are compared with
+* the status reported by the server, a parameter which is not reported is changed.
+*/
+template <typename Connection, typename Params>
+inline settings_changes get_settings_changes(const Connection& conn, const Params& params) {
+    settings_changes result;
+    for (const auto& [param_name, value] : params) {
+        std::string name(param_name);
+        std::transform(name.begin(), name.end(), name.begin(),
+            [] (unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        const auto status = get_parameter_status(conn, name);
+        if (const auto applied = conn.session_settings().find(name)) {
+            if (applied->value == value && applied->reported == status) {
+                continue;
+            }
+        } else if (status && *status == value) {
+            continue;
+        }
+        result.names.push_back(std::move(name));
+        result.values.emplace_back(value);
+    }
+    return result;
+}
+
+/**
+* Sets the changed session parameters of a connection with a single request and
+* stores them into the connection session settings. The parameters set within
+* a transaction block are not stored since they are reverted with its rollback.
+*/
+template <typename Handler>
+struct apply_settings_op {
+    struct context {
+        Handler handler_;
+        settings_changes changes_;
+        context(Handler&& handler, settings_changes&& changes)
+        : handler_(std::move(handler)), changes_(std::move(changes)) {}
+    };
+
+    std::shared_ptr<context> ctx_;
+
+    template <typename Connection>
+    apply_settings_op(Connection& conn, settings_changes changes, Handler handler) {
+        auto allocator = detail::get_operation_allocator(conn, handler);
+        ctx_ = std::allocate_shared<context>(allocator, std::move(handler), std::move(changes));
+    }
+
+    template <typename Connection, typename TimeConstraint>
+    void perform(Connection&& conn, TimeConstraint t) {
+        using namespace literals;
+        async_execute(std::forward<Connection>(conn),
+            "SELECT set_config(s.name, s.value, false) FROM UNNEST("_SQL + ctx_->changes_.names
+                + "::text[], "_SQL + ctx_->changes_.values + "::text[]) AS s(name, value)"_SQL,
+            t, std::move(*this));
+    }
+
+    template <typename Connection>
+    void operator() (error_code ec, Connection&& conn) {
+        if (!ec && get_transaction_status(conn) == transaction_status::idle) {
+            auto& connection = ozo::unwrap_connection(conn);
+            auto& changes = ctx_->changes_;
+            for (std::size_t i = 0; i < changes.names.size(); ++i) {
+                auto status = get_parameter_status(connection, changes.names[i]);
+                connection.session_settings().set(std::move(changes.names[i]), std::move(changes.values[i]),
+                    std::move(status));
+            }
+        }
+        ctx_->handler_(ec, std::forward<Connection>(conn));
+    }
+
+    using executor_type = asio::associated_executor_t<Handler>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(ctx_->handler_);
+    }
+
+    using allocator_type = asio::associated_allocator_t<Handler>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(ctx_->handler_);
+    }
+};
+
+template <typename Params, typename TimeConstraint, typename Handler>
+struct async_ensure_settings_op {
+    Params params_;
+    TimeConstraint time_constraint_;
+    Handler handler_;
+
+    template <typename Connection>
+    void operator() (error_code ec, Connection conn) {
+        if (ec) {
+            return handler_(ec, std::move(conn));
+        }
+
+        auto changes = get_settings_changes(unwrap_connection(conn), params_);
+        if (changes.names.empty()) {
+            return handler_(ec, std::move(conn));
+        }
+
+        apply_settings_op<Handler> op{unwrap_connection(conn), std::move(changes), std::move(handler_)};
+        op.perform(std::move(conn), time_constraint_);
+    }
+
+    using executor_type = asio::associated_executor_t<Handler>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(handler_);
+    }
+
+    using allocator_type = asio::associated_allocator_t<Handler>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(handler_);
+    }
+};
+
+template <typename P, typename Params, typename TimeConstraint, typename Handler>
+inline void async_ensure_settings(P&& provider, Params&& params, TimeConstraint t, Handler&& handler) {
+    static_assert(ConnectionProvider<P>, "is not a ConnectionProvider");
+    static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+    using connection = std::decay_t<decltype(unwrap_connection(std::declval<connection_type<P>&>()))>;
+    static_assert(has_session_settings<connection>::value, "connection should track session settings");
+    async_get_connection(std::forward<P>(provider), deadline(t),
+        async_ensure_settings_op<std::decay_t<Params>, decltype(deadline(t)), std::decay_t<Handler>> {
+            std::forward<Params>(params),
+            deadline(t),
+            std::forward<Handler>(handler)
+        }
+    );
+}
+
+} // namespace ozo::impl
@@ -15,7 +15,8 @@ inline void async_execute(P&& provider, Q&& query, TimeConstraint t, Handler&& h
             std::forward<Q>(query),
             deadline(t),
             none,
-            std::forward<Handler>(handler)
+            std::forward<Handler>(handler),
+            make_request_start_point<P>()
         }
     );
 }
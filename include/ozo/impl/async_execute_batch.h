@@ -0,0 +1,313 @@
+#pragma once
+
+#include <ozo/impl/async_request.h>
+
+#include <boost/hana/for_each.hpp>
+#include <boost/hana/size.hpp>
+#include <boost/hana/concept/foldable.hpp>
+
+#ifdef LIBPQ_HAS_PIPELINING
+
+namespace ozo {
+
+/**
+ * @brief Result of a statement executed via `ozo::execute_batch()`
+ * @ingroup group-requests-types
+ */
+struct batch_statement_result {
+    error_code ec; //!< error of the statement, empty if the statement succeeded
+    std::size_t rows = 0; //!< number of rows affected or returned by the statement
+    std::string error_message; //!< database error message of the failed statement
+};
+
+} // namespace ozo
+
+namespace ozo::impl {
+
+template <typename Queries>
+inline std::size_t batch_size(const Queries& queries) noexcept {
+    if constexpr (hana::Foldable<Queries>::value) {
+        return decltype(hana::size(queries))::value;
+    } else {
+        return static_cast<std::size_t>(std::size(queries));
+    }
+}
+
+template <typename Queries, typename F>
+inline void for_each_batch_query(const Queries& queries, F&& f) {
+    if constexpr (hana::Foldable<Queries>::value) {
+        hana::for_each(queries, std::forward<F>(f));
+    } else {
+        for (const auto& query : queries) {
+            f(query);
+        }
+    }
+}
+
+/**
+* Sends the queries of the batch in pipeline mode each followed by its own
+* synchronization point, so every query is executed in its own implicit
+* transaction and a failed query does not abort the rest of the batch.
+*/
+template <typename Context, typename Queries>
+inline void async_send_batch(const Context& ctx, const Queries& queries) {
+    decltype(auto) conn = get_connection(ctx);
+    if (auto ec = set_nonblocking(conn)) {
+        return done(ctx, ec);
+    }
+
+    if (auto ec = enter_pipeline_mode(conn)) {
+        return done(ctx, ec);
+    }
+
+    const auto allocator = asio::get_associated_allocator(get_handler(ctx));
+    error_code ec;
+    for_each_batch_query(queries, [&](const auto& query) {
+        if (ec) {
+            return;
+        }
+        if (!send_query_params(conn, to_binary_query(query, conn.oid_map(), allocator))) {
+            ec = error::pg_send_query_params_failed;
+        } else {
+            ec = pipeline_sync(conn);
+        }
+    });
+
+    if (ec) {
+        return done(ctx, ec);
+    }
+
+    async_flush_output_op{ctx}();
+}
+
+#include <boost/asio/yield.hpp>
+
+/**
+* Receives results of the batch queries separated by the synchronization points.
+* A result of each query is written into the output as `ozo::batch_statement_result`.
+* The operation completes with the first query error after all the results have
+* been received.
+*/
+template <typename Context, typename Out>
+struct async_get_batch_results_op : boost::asio::coroutine {
+    Context ctx_;
+    Out out_;
+    std::size_t size_;
+    using result_type = std::decay_t<decltype(get_result(get_connection(ctx_)))>;
+    result_type result_;
+    std::size_t index_ = 0;
+    batch_statement_result current_;
+    error_code error_;
+
+    async_get_batch_results_op(Context ctx, Out out, std::size_t size)
+    : ctx_(std::move(ctx)), out_(std::move(out)), size_(size) {}
+
+    void perform() {
+        (*this)();
+    }
+
+    void done() {
+        return impl::done(ctx_);
+    }
+
+    void done(error_code ec) {
+        if (std::empty(get_error_context(get_connection(ctx_)))) {
+            get_connection(ctx_).set_error_context("error while get batch results");
+        }
+        return impl::done(ctx_, ec);
+    }
+
+    void operator() (error_code ec = error_code{}, std::size_t = 0) {
+        if (get_query_state(ctx_) == query_state::error) {
+            return;
+        }
+
+        if (ec) {
+            if (ec == asio::error::bad_descriptor) {
+                ec = asio::error::operation_aborted;
+            }
+            return done(ec);
+        }
+
+        reenter(*this) {
+            while (index_ < size_) {
+                while (is_busy(get_connection(ctx_))) {
+                    get_request_statistics(ctx_).waited();
+                    yield get_connection(ctx_).async_wait_read(std::move(*this));
+                    if (auto err = consume_input(get_connection(ctx_))) {
+                        return done(err);
+                    }
+                }
+
+                result_ = get_result(get_connection(ctx_));
+
+                if (!result_) {
+                    continue;
+                }
+
+                if (result_status(*result_) == PGRES_PIPELINE_SYNC) {
+                    *out_++ = std::move(current_);
+                    current_ = batch_statement_result{};
+                    ++index_;
+                    continue;
+                }
+
+                if (!handle_result()) {
+                    return;
+                }
+            }
+
+            get_request_statistics(ctx_).result_received();
+
+            if (auto err = exit_pipeline_mode(get_connection(ctx_))) {
+                return done(err);
+            }
+
+            if (error_) {
+                return done(error_);
+            }
+
+            done();
+        }
+    }
+
+    bool handle_result() {
+        const auto status = result_status(*result_);
+        switch (status) {
+            case PGRES_SINGLE_TUPLE:
+#ifdef LIBPQ_HAS_CHUNK_MODE
+            case PGRES_TUPLES_CHUNK:
+#endif
+            case PGRES_TUPLES_OK:
+            case PGRES_COMMAND_OK:
+                current_.rows = result_affected_rows(*result_);
+                return true;
+            case PGRES_BAD_RESPONSE:
+                set_error(error::result_status_bad_response);
+                return true;
+            case PGRES_EMPTY_QUERY:
+                set_error(error::result_status_empty_query);
+                return true;
+            case PGRES_FATAL_ERROR:
+                set_error(result_error(*result_));
+                return true;
+            case PGRES_COPY_OUT:
+            case PGRES_COPY_IN:
+            case PGRES_COPY_BOTH:
+            case PGRES_NONFATAL_ERROR:
+            case PGRES_PIPELINE_SYNC:
+            case PGRES_PIPELINE_ABORTED:
+                break;
+        }
+
+        get_connection(ctx_).set_error_context(get_result_status_name(status));
+        done(error::result_status_unexpected);
+        return false;
+    }
+
+    void set_error(error_code ec) {
+        current_.ec = ec;
+        current_.error_message = std::string(result_error_message(*result_));
+        if (!error_) {
+            error_ = std::move(ec);
+            get_connection(ctx_).set_error_context("batch statement #" + std::to_string(index_) + " failed: "
+                + current_.error_message);
+        }
+    }
+
+    using executor_type = std::decay_t<decltype(asio::get_associated_executor(get_handler(ctx_)))>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(get_handler(ctx_));
+    }
+
+    using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(get_handler(ctx_)))>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(get_handler(ctx_));
+    }
+};
+
+template <typename Context, typename Out>
+async_get_batch_results_op(Context, Out, std::size_t) -> async_get_batch_results_op<Context, Out>;
+
+#include <boost/asio/unyield.hpp>
+
+template <typename Context, typename Out>
+inline void async_get_batch_results(Context&& ctx, Out&& out, std::size_t size) {
+    async_get_batch_results_op op{std::forward<Context>(ctx), std::forward<Out>(out), size};
+    op.perform();
+}
+
+template <typename Queries, typename Out, typename TimeConstraint, typename Handler, typename Start = none_t>
+struct async_execute_batch_op {
+    Queries queries_;
+    Out out_;
+    TimeConstraint time_constraint_;
+    Handler handler_;
+    Start start_;
+
+    async_execute_batch_op(Queries queries, Out out, TimeConstraint time_constraint, Handler handler, Start start = Start{})
+    : queries_(std::move(queries)), out_(std::move(out)), time_constraint_(time_constraint),
+      handler_(std::move(handler)), start_(start) {}
+
+    template <typename Connection>
+    void operator() (error_code ec, Connection conn) {
+        if (ec) {
+            return handler_(ec, std::move(conn));
+        }
+
+        auto handler = apply_io_deadline(conn, time_constraint_, detail::wrap_executor {
+            detail::make_connection_executor(conn),
+            std::move(handler_)
+        });
+
+        auto ctx = make_request_operation_context(std::move(conn), std::move(handler));
+        get_request_statistics(ctx).requested(start_);
+
+        const auto size = batch_size(queries_);
+        if (size == 0) {
+            return impl::done(ctx);
+        }
+
+        async_send_batch(ctx, queries_);
+        async_get_batch_results(std::move(ctx), std::move(out_), size);
+    }
+
+    using executor_type = std::decay_t<decltype(asio::get_associated_executor(handler_))>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(handler_);
+    }
+
+    using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(handler_))>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(handler_);
+    }
+};
+
+template <typename Queries, typename Out, typename TimeConstraint, typename Handler>
+async_execute_batch_op(Queries, Out, TimeConstraint, Handler) -> async_execute_batch_op<Queries, Out, TimeConstraint, Handler>;
+
+template <typename Queries, typename Out, typename TimeConstraint, typename Handler, typename Start>
+async_execute_batch_op(Queries, Out, TimeConstraint, Handler, Start) -> async_execute_batch_op<Queries, Out, TimeConstraint, Handler, Start>;
+
+template <typename P, typename Queries, typename Out, typename TimeConstraint, typename Handler>
+inline void async_execute_batch(P&& provider, Queries&& queries, Out&& out, TimeConstraint t, Handler&& handler) {
+    static_assert(ConnectionProvider<P>, "is not a ConnectionProvider");
+    static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+    async_get_connection(std::forward<P>(provider), deadline(t),
+        async_execute_batch_op {
+            std::forward<Queries>(queries),
+            std::forward<Out>(out),
+            deadline(t),
+            std::forward<Handler>(handler),
+            make_request_start_point<P>()
+        }
+    );
+}
+
+} // namespace ozo::impl
+
+#endif
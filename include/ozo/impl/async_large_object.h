@@ -0,0 +1,261 @@
+#pragma once
+
+#include <ozo/impl/async_execute.h>
+#include <ozo/pg/types/bytea.h>
+#include <ozo/pg/types/oid.h>
+#include <ozo/result.h>
+#include <ozo/detail/bind.h>
+
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/post.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace ozo::impl {
+
+inline auto make_lo_get(pg::oid object, std::int64_t offset, std::size_t chunk_size) {
+    return make_query("SELECT lo_get($1, $2, $3)", object, offset, static_cast<std::int32_t>(chunk_size));
+}
+
+inline auto make_lo_put(pg::oid object, std::int64_t offset, std::string_view chunk) {
+    return make_query("SELECT lo_put($1, $2, $3)", object, offset, pg::bytea_view(chunk));
+}
+
+inline std::size_t large_object_chunk_size(std::size_t chunk_size) {
+    return std::clamp<std::size_t>(chunk_size, 1, std::numeric_limits<std::int32_t>::max());
+}
+
+inline std::string_view get_large_object_chunk(const result& chunk) {
+    if (std::empty(chunk) || chunk[0][0].is_null()) {
+        return {};
+    }
+    return {chunk[0][0].data(), chunk[0][0].size()};
+}
+
+/**
+* Shared state of `ozo::read_large_object()`. Each round runs two parties concurrently:
+* `lo_get` of the next chunk and the processing of the chunk received, like `cursor_state`
+* does for pages. A chunk shorter than the requested size is the last one.
+*/
+template <typename Connection, typename TimeConstraint, typename OnChunk, typename Handler>
+class large_object_reader_state
+        : public std::enable_shared_from_this<large_object_reader_state<Connection, TimeConstraint, OnChunk, Handler>> {
+public:
+    large_object_reader_state(pg::oid object, std::size_t chunk_size, TimeConstraint t, OnChunk on_chunk,
+            Handler handler)
+    : object_(object), chunk_size_(chunk_size), t_(t), on_chunk_(std::move(on_chunk)), handler_(std::move(handler)) {}
+
+    void start(Connection conn) {
+        fetch(std::move(conn), [self = this->shared_from_this()] (error_code ec, Connection conn) {
+            if (ec) {
+                return self->finish(std::move(ec), std::move(conn));
+            }
+            self->round(std::exchange(self->next_, result{}), std::move(conn));
+        });
+    }
+
+private:
+    template <typename StatementHandler>
+    void fetch(Connection&& conn, StatementHandler&& handler) {
+        async_request(std::move(conn), make_lo_get(object_, offset_, chunk_size_), t_, std::ref(next_),
+            std::forward<StatementHandler>(handler));
+    }
+
+    void round(result chunk, Connection&& conn) {
+        const auto executor = unwrap_connection(conn).get_executor();
+        const auto size = get_large_object_chunk(chunk).size();
+        if (size == 0) {
+            return finish(error_code{}, std::move(conn));
+        }
+        offset_ += static_cast<std::int64_t>(size);
+        last_ = size < chunk_size_;
+
+        if (last_) {
+            pending_ = 1;
+            conn_.emplace(std::move(conn));
+        } else {
+            pending_ = 2;
+            fetch(std::move(conn), [self = this->shared_from_this()] (error_code ec, Connection conn) {
+                self->statement_done(std::move(ec), std::move(conn));
+            });
+        }
+
+        asio::post(executor, [self = this->shared_from_this(), chunk = std::move(chunk)] {
+            self->on_chunk_(get_large_object_chunk(chunk));
+            self->party_done();
+        });
+    }
+
+    void statement_done(error_code ec, Connection&& conn) {
+        {
+            const std::lock_guard lock(mutex_);
+            conn_.emplace(std::move(conn));
+            error_ = std::move(ec);
+        }
+        party_done();
+    }
+
+    void party_done() {
+        {
+            const std::lock_guard lock(mutex_);
+            if (--pending_) {
+                return;
+            }
+        }
+        auto conn = std::move(*conn_);
+        conn_.reset();
+        if (error_ || last_) {
+            return finish(std::move(error_), std::move(conn));
+        }
+        round(std::exchange(next_, result{}), std::move(conn));
+    }
+
+    void finish(error_code ec, Connection&& conn) {
+        auto ex = asio::get_associated_executor(handler_, unwrap_connection(conn).get_executor());
+        asio::dispatch(ex, detail::bind(std::move(handler_), std::move(ec), std::move(conn)));
+    }
+
+    pg::oid object_;
+    std::size_t chunk_size_;
+    TimeConstraint t_;
+    OnChunk on_chunk_;
+    Handler handler_;
+    std::mutex mutex_;
+    std::size_t pending_ = 0;
+    std::int64_t offset_ = 0;
+    bool last_ = false;
+    error_code error_;
+    std::optional<Connection> conn_;
+    result next_;
+};
+
+/**
+* Shared state of `ozo::write_large_object()`. Two buffers of the chunk size are allocated
+* once: while `lo_put` of one of them is in flight the other one is filled by the producer.
+* The next round starts once both parties complete, zero bytes produced end the object.
+*/
+template <typename Connection, typename TimeConstraint, typename OnChunk, typename Handler>
+class large_object_writer_state
+        : public std::enable_shared_from_this<large_object_writer_state<Connection, TimeConstraint, OnChunk, Handler>> {
+public:
+    large_object_writer_state(pg::oid object, std::size_t chunk_size, TimeConstraint t, OnChunk on_chunk,
+            Handler handler)
+    : object_(object), t_(t), on_chunk_(std::move(on_chunk)), handler_(std::move(handler)) {
+        for (auto& buffer : buffers_) {
+            buffer.resize(chunk_size);
+        }
+    }
+
+    void start(Connection conn) {
+        const auto executor = unwrap_connection(conn).get_executor();
+        asio::post(executor, [self = this->shared_from_this(), conn = std::move(conn)] () mutable {
+            self->round(self->produce(self->buffers_[self->current_]), std::move(conn));
+        });
+    }
+
+private:
+    std::size_t produce(std::vector<char>& buffer) {
+        return std::min(on_chunk_(buffer.data(), buffer.size()), buffer.size());
+    }
+
+    void round(std::size_t size, Connection&& conn) {
+        if (size == 0) {
+            return finish(error_code{}, std::move(conn));
+        }
+        const auto executor = unwrap_connection(conn).get_executor();
+        const std::string_view chunk(buffers_[current_].data(), size);
+        pending_ = 2;
+
+        async_execute(std::move(conn), make_lo_put(object_, offset_, chunk), t_,
+            [self = this->shared_from_this()] (error_code ec, Connection conn) {
+                self->statement_done(std::move(ec), std::move(conn));
+            });
+        offset_ += static_cast<std::int64_t>(size);
+
+        asio::post(executor, [self = this->shared_from_this()] {
+            self->next_size_ = self->produce(self->buffers_[self->current_ ^ 1]);
+            self->party_done();
+        });
+    }
+
+    void statement_done(error_code ec, Connection&& conn) {
+        {
+            const std::lock_guard lock(mutex_);
+            conn_.emplace(std::move(conn));
+            error_ = std::move(ec);
+        }
+        party_done();
+    }
+
+    void party_done() {
+        {
+            const std::lock_guard lock(mutex_);
+            if (--pending_) {
+                return;
+            }
+        }
+        auto conn = std::move(*conn_);
+        conn_.reset();
+        if (error_) {
+            return finish(std::move(error_), std::move(conn));
+        }
+        current_ ^= 1;
+        round(next_size_, std::move(conn));
+    }
+
+    void finish(error_code ec, Connection&& conn) {
+        auto ex = asio::get_associated_executor(handler_, unwrap_connection(conn).get_executor());
+        asio::dispatch(ex, detail::bind(std::move(handler_), std::move(ec), std::move(conn)));
+    }
+
+    pg::oid object_;
+    TimeConstraint t_;
+    OnChunk on_chunk_;
+    Handler handler_;
+    std::array<std::vector<char>, 2> buffers_;
+    std::size_t current_ = 0;
+    std::size_t next_size_ = 0;
+    std::mutex mutex_;
+    std::size_t pending_ = 0;
+    std::int64_t offset_ = 0;
+    error_code error_;
+    std::optional<Connection> conn_;
+};
+
+template <typename Connection, typename TimeConstraint, typename OnChunk, typename Handler>
+inline void async_read_large_object(Connection&& conn, pg::oid object, std::size_t chunk_size, TimeConstraint t,
+        OnChunk on_chunk, Handler&& handler) {
+    static_assert(ozo::Connection<Connection>, "should model Connection concept");
+    static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+
+    using state_type = large_object_reader_state<std::decay_t<Connection>, TimeConstraint, OnChunk,
+        std::decay_t<Handler>>;
+    const auto allocator = asio::get_associated_allocator(handler);
+    auto state = std::allocate_shared<state_type>(allocator, object, large_object_chunk_size(chunk_size), t,
+        std::move(on_chunk), std::forward<Handler>(handler));
+    state->start(std::forward<Connection>(conn));
+}
+
+template <typename Connection, typename TimeConstraint, typename OnChunk, typename Handler>
+inline void async_write_large_object(Connection&& conn, pg::oid object, std::size_t chunk_size, TimeConstraint t,
+        OnChunk on_chunk, Handler&& handler) {
+    static_assert(ozo::Connection<Connection>, "should model Connection concept");
+    static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+
+    using state_type = large_object_writer_state<std::decay_t<Connection>, TimeConstraint, OnChunk,
+        std::decay_t<Handler>>;
+    const auto allocator = asio::get_associated_allocator(handler);
+    auto state = std::allocate_shared<state_type>(allocator, object, large_object_chunk_size(chunk_size), t,
+        std::move(on_chunk), std::forward<Handler>(handler));
+    state->start(std::forward<Connection>(conn));
+}
+
+} // namespace ozo::impl
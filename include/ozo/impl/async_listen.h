@@ -0,0 +1,301 @@
+#pragma once
+
+#include <ozo/impl/async_request.h>
+#include <ozo/notification.h>
+
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace ozo::impl {
+
+/**
+* Appends the identifier to the query text as a quoted one, so a channel
+* name is not changed by case folding and can not break the query.
+*/
+inline void append_quoted_identifier(std::string& text, std::string_view identifier) {
+    text += '"';
+    for (const char c : identifier) {
+        if (c == '"') {
+            text += '"';
+        }
+        text += c;
+    }
+    text += '"';
+}
+
+/**
+* Makes the text of `LISTEN` statements for each channel of the range.
+*/
+template <typename Channels>
+inline std::string make_listen_query(const Channels& channels) {
+    std::string text;
+    for (const auto& channel : channels) {
+        text += "LISTEN ";
+        append_quoted_identifier(text, channel);
+        text += ';';
+    }
+    return text;
+}
+
+template <typename Context>
+inline void async_send_listen_query(const Context& ctx, const std::string& text) {
+    decltype(auto) conn = get_connection(ctx);
+    if (auto ec = set_nonblocking(conn)) {
+        return done(ctx, ec);
+    }
+
+    if (!send_query(conn, text.c_str())) {
+        return done(ctx, error::pg_send_query_failed);
+    }
+
+    get_request_statistics(ctx).sent(text.c_str(), nullptr, 0);
+
+    async_flush_output_op{ctx}();
+}
+
+#include <boost/asio/yield.hpp>
+
+/**
+* Receives results of the `LISTEN` statements and then waits for notifications.
+* Each time new input is consumed all the received notifications are passed to the
+* notification handler as a batch, including ones which have been received by the
+* connection before the operation. The operation completes when the handler returns
+* `false` if it returns a value convertible to `bool`; otherwise it lasts until an
+* error, the time constraint expiration or the connection cancellation.
+*/
+template <typename Context, typename NotificationHandler>
+struct async_listen_notifications_op : boost::asio::coroutine {
+    Context ctx_;
+    NotificationHandler handler_;
+    using result_type = std::decay_t<decltype(get_result(get_connection(ctx_)))>;
+    result_type result_;
+    error_code error_;
+
+    async_listen_notifications_op(Context ctx, NotificationHandler handler)
+    : ctx_(std::move(ctx)), handler_(std::move(handler)) {}
+
+    void perform() {
+        (*this)();
+    }
+
+    void done() {
+        return impl::done(ctx_);
+    }
+
+    void done(error_code ec) {
+        if (std::empty(get_error_context(get_connection(ctx_)))) {
+            get_connection(ctx_).set_error_context("error while listen for notifications");
+        }
+        return impl::done(ctx_, ec);
+    }
+
+    void operator() (error_code ec = error_code{}, std::size_t = 0) {
+        if (get_query_state(ctx_) == query_state::error) {
+            return;
+        }
+
+        if (ec) {
+            if (ec == asio::error::bad_descriptor) {
+                ec = asio::error::operation_aborted;
+            }
+            return done(ec);
+        }
+
+        reenter(*this) {
+            for (;;) {
+                while (is_busy(get_connection(ctx_))) {
+                    get_request_statistics(ctx_).waited();
+                    yield get_connection(ctx_).async_wait_read(std::move(*this));
+                    if (auto err = consume_input(get_connection(ctx_))) {
+                        return done(err);
+                    }
+                }
+
+                result_ = get_result(get_connection(ctx_));
+
+                if (!result_) {
+                    break;
+                }
+
+                if (!handle_result()) {
+                    return;
+                }
+            }
+
+            get_request_statistics(ctx_).result_received();
+
+            if (error_) {
+                return done(error_);
+            }
+
+            for (;;) {
+                if (!deliver()) {
+                    return;
+                }
+                yield get_connection(ctx_).async_wait_read(std::move(*this));
+                if (auto err = consume_input(get_connection(ctx_))) {
+                    return done(err);
+                }
+            }
+        }
+    }
+
+    bool handle_result() {
+        const auto status = result_status(*result_);
+        switch (status) {
+            case PGRES_COMMAND_OK:
+                return true;
+            case PGRES_BAD_RESPONSE:
+                set_error(error::result_status_bad_response);
+                return true;
+            case PGRES_EMPTY_QUERY:
+                set_error(error::result_status_empty_query);
+                return true;
+            case PGRES_FATAL_ERROR:
+                set_error(result_error(*result_));
+                return true;
+            case PGRES_SINGLE_TUPLE:
+#ifdef LIBPQ_HAS_CHUNK_MODE
+            case PGRES_TUPLES_CHUNK:
+#endif
+            case PGRES_TUPLES_OK:
+            case PGRES_COPY_OUT:
+            case PGRES_COPY_IN:
+            case PGRES_COPY_BOTH:
+            case PGRES_NONFATAL_ERROR:
+#ifdef LIBPQ_HAS_PIPELINING
+            case PGRES_PIPELINE_SYNC:
+            case PGRES_PIPELINE_ABORTED:
+#endif
+                break;
+        }
+
+        get_connection(ctx_).set_error_context(get_result_status_name(status));
+        done(error::result_status_unexpected);
+        return false;
+    }
+
+    void set_error(error_code ec) {
+        if (!error_) {
+            error_ = std::move(ec);
+        }
+    }
+
+    /**
+    * Passes the received notifications to the handler. Returns `false` if the
+    * operation is completed.
+    */
+    bool deliver() noexcept {
+        try {
+            auto batch = get_notifications(get_connection(ctx_));
+            if (batch.empty()) {
+                return true;
+            }
+            if constexpr (std::is_void_v<decltype(handler_(std::move(batch)))>) {
+                handler_(std::move(batch));
+            } else if (!handler_(std::move(batch))) {
+                done();
+                return false;
+            }
+        } catch (const std::exception& e) {
+            get_connection(ctx_).set_error_context(e.what());
+            done(error::bad_result_process);
+            return false;
+        }
+        return true;
+    }
+
+    using executor_type = std::decay_t<decltype(asio::get_associated_executor(get_handler(ctx_)))>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(get_handler(ctx_));
+    }
+
+    using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(get_handler(ctx_)))>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(get_handler(ctx_));
+    }
+};
+
+template <typename Context, typename NotificationHandler>
+async_listen_notifications_op(Context, NotificationHandler) -> async_listen_notifications_op<Context, NotificationHandler>;
+
+#include <boost/asio/unyield.hpp>
+
+template <typename Context, typename NotificationHandler>
+inline void async_listen_notifications(Context&& ctx, NotificationHandler&& h) {
+    async_listen_notifications_op op{std::forward<Context>(ctx), std::forward<NotificationHandler>(h)};
+    op.perform();
+}
+
+template <typename NotificationHandler, typename TimeConstraint, typename Handler>
+struct async_listen_op {
+    std::string query_;
+    TimeConstraint time_constraint_;
+    NotificationHandler notification_handler_;
+    Handler handler_;
+
+    async_listen_op(std::string query, TimeConstraint time_constraint,
+            NotificationHandler notification_handler, Handler handler)
+    : query_(std::move(query)), time_constraint_(time_constraint),
+      notification_handler_(std::move(notification_handler)), handler_(std::move(handler)) {}
+
+    template <typename Connection>
+    void operator() (error_code ec, Connection conn) {
+        if (ec) {
+            return handler_(ec, std::move(conn));
+        }
+
+        auto handler = apply_io_deadline(conn, time_constraint_, detail::wrap_executor {
+            detail::make_connection_executor(conn),
+            std::move(handler_)
+        });
+
+        auto ctx = make_request_operation_context(std::move(conn), std::move(handler));
+
+        if (query_.empty()) {
+            set_query_state(ctx, query_state::send_finish);
+        } else {
+            async_send_listen_query(ctx, query_);
+        }
+        async_listen_notifications(std::move(ctx), std::move(notification_handler_));
+    }
+
+    using executor_type = std::decay_t<decltype(asio::get_associated_executor(handler_))>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(handler_);
+    }
+
+    using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(handler_))>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(handler_);
+    }
+};
+
+template <typename NotificationHandler, typename TimeConstraint, typename Handler>
+async_listen_op(std::string, TimeConstraint, NotificationHandler, Handler) ->
+    async_listen_op<NotificationHandler, TimeConstraint, Handler>;
+
+/**
+* Starts listening, the query is the `LISTEN` statements text made by `make_listen_query()`.
+*/
+template <typename P, typename TimeConstraint, typename NotificationHandler, typename Handler>
+inline void async_listen(P&& provider, std::string query, TimeConstraint t,
+        NotificationHandler&& notification_handler, Handler&& handler) {
+    static_assert(ConnectionProvider<P>, "is not a ConnectionProvider");
+    static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+    async_get_connection(std::forward<P>(provider), deadline(t),
+        async_listen_op {
+            std::move(query),
+            deadline(t),
+            std::decay_t<NotificationHandler>(std::forward<NotificationHandler>(notification_handler)),
+            std::forward<Handler>(handler)
+        }
+    );
+}
+
+} // namespace ozo::impl
@@ -0,0 +1,298 @@
+#pragma once
+
+#include <ozo/impl/async_request.h>
+
+#include <boost/hana/for_each.hpp>
+#include <boost/hana/size.hpp>
+
+namespace ozo::impl {
+
+template <typename T>
+struct is_text_result_output : std::false_type {};
+
+template <>
+struct is_text_result_output<none_t> : std::true_type {};
+
+template <typename T>
+struct is_text_result_output<std::reference_wrapper<basic_result<T>>> : std::true_type {};
+
+/**
+* Outputs for the results of a multi-statement query. The results of the simple query
+* protocol are in the text format, so an output is a reference to a result object, or
+* `ozo::none` to check the result for errors and drop it. The results of the statements
+* beyond the outputs are dropped too.
+*/
+template <typename Outs>
+struct multi_request_results {
+    Outs outs;
+
+    template <typename Result, typename Connection>
+    void operator() (std::size_t index, Result&& res, Connection& conn) {
+        std::size_t i = 0;
+        hana::for_each(outs, [&](auto& out) {
+            if (i++ == index) {
+                process(out, std::forward<Result>(res), conn);
+            }
+        });
+    }
+
+    template <typename Out, typename Result, typename Connection>
+    static void process(Out& out, Result&& res, Connection& conn) {
+        static_assert(is_text_result_output<Out>::value,
+            "output should be std::reference_wrapper of ozo::basic_result or ozo::none");
+        if constexpr (!IsNone<Out>) {
+            auto result = ozo::make_result(std::forward<Result>(res));
+            ozo::recv_result(result, unwrap_connection(conn).oid_map(), out);
+        }
+    }
+};
+
+template <typename Outs>
+multi_request_results(Outs) -> multi_request_results<Outs>;
+
+template <typename Context, typename Text>
+inline void async_send_query(const Context& ctx, const Text& text) {
+    decltype(auto) conn = get_connection(ctx);
+    if (auto ec = set_nonblocking(conn)) {
+        return done(ctx, ec);
+    }
+
+    const char* const text_ptr = to_const_char(text);
+    if (!send_query(conn, text_ptr)) {
+        return done(ctx, error::pg_send_query_failed);
+    }
+
+    get_request_statistics(ctx).sent(text_ptr, nullptr, 0);
+
+    async_flush_output_op{ctx}();
+}
+
+#include <boost/asio/yield.hpp>
+
+/**
+* Receives results of the statements of a query sent via the simple query protocol
+* in the order of the statements. libpq finishes the results with a null one. In case
+* of a statement error the server skips the rest of them, the operation reads results
+* up to the null one anyway to keep the connection usable and completes with the error.
+*
+* The results processor should provide a call operator with the
+* `void(std::size_t index, Result&& result, Connection& conn)` signature which is
+* called for each successful statement result.
+*/
+template <typename Context, typename Processor>
+struct async_get_results_op : boost::asio::coroutine {
+    Context ctx_;
+    Processor process_;
+    using result_type = std::decay_t<decltype(get_result(get_connection(ctx_)))>;
+    result_type result_;
+    std::size_t index_ = 0;
+    error_code error_;
+
+    async_get_results_op(Context ctx, Processor process)
+    : ctx_(std::move(ctx)), process_(std::move(process)) {}
+
+    void perform() {
+        (*this)();
+    }
+
+    void done() {
+        return impl::done(ctx_);
+    }
+
+    void done(error_code ec) {
+        if (std::empty(get_error_context(get_connection(ctx_)))) {
+            get_connection(ctx_).set_error_context("error while get request results");
+        }
+        return impl::done(ctx_, ec);
+    }
+
+    void operator() (error_code ec = error_code{}, std::size_t = 0) {
+        if (get_query_state(ctx_) == query_state::error) {
+            return;
+        }
+
+        if (ec) {
+            if (ec == asio::error::bad_descriptor) {
+                ec = asio::error::operation_aborted;
+            }
+            return done(ec);
+        }
+
+        reenter(*this) {
+            for (;;) {
+                while (is_busy(get_connection(ctx_))) {
+                    get_request_statistics(ctx_).waited();
+                    yield get_connection(ctx_).async_wait_read(std::move(*this));
+                    if (auto err = consume_input(get_connection(ctx_))) {
+                        return done(err);
+                    }
+                }
+
+                result_ = get_result(get_connection(ctx_));
+
+                if (!result_) {
+                    break;
+                }
+
+                get_request_statistics(ctx_).received(result_);
+
+                if (!handle_result()) {
+                    return;
+                }
+            }
+
+            get_request_statistics(ctx_).result_received();
+
+            if (error_) {
+                return done(error_);
+            }
+
+            done();
+        }
+    }
+
+    bool handle_result() {
+        const auto status = result_status(*result_);
+        switch (status) {
+            case PGRES_TUPLES_OK:
+            case PGRES_COMMAND_OK:
+                process();
+                return true;
+            case PGRES_BAD_RESPONSE:
+                set_error(error::result_status_bad_response);
+                return true;
+            case PGRES_EMPTY_QUERY:
+                set_error(error::result_status_empty_query);
+                return true;
+            case PGRES_FATAL_ERROR:
+                set_error(result_error(*result_));
+                return true;
+            case PGRES_SINGLE_TUPLE:
+#ifdef LIBPQ_HAS_CHUNK_MODE
+            case PGRES_TUPLES_CHUNK:
+#endif
+            case PGRES_COPY_OUT:
+            case PGRES_COPY_IN:
+            case PGRES_COPY_BOTH:
+            case PGRES_NONFATAL_ERROR:
+#ifdef LIBPQ_HAS_PIPELINING
+            case PGRES_PIPELINE_SYNC:
+            case PGRES_PIPELINE_ABORTED:
+#endif
+                break;
+        }
+
+        get_connection(ctx_).set_error_context(get_result_status_name(status));
+        done(error::result_status_unexpected);
+        return false;
+    }
+
+    void set_error(error_code ec) {
+        if (!error_) {
+            error_ = std::move(ec);
+        }
+    }
+
+    void process() noexcept {
+        const auto index = index_++;
+        if (error_) {
+            return;
+        }
+        try {
+            process_(index, std::move(result_), get_connection(ctx_));
+        } catch (const std::exception& e) {
+            get_connection(ctx_).set_error_context(e.what());
+            set_error(error::bad_result_process);
+        }
+    }
+
+    using executor_type = std::decay_t<decltype(asio::get_associated_executor(get_handler(ctx_)))>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(get_handler(ctx_));
+    }
+
+    using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(get_handler(ctx_)))>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(get_handler(ctx_));
+    }
+};
+
+template <typename Context, typename Processor>
+async_get_results_op(Context, Processor) -> async_get_results_op<Context, Processor>;
+
+#include <boost/asio/unyield.hpp>
+
+template <typename Context, typename Processor>
+inline void async_get_results(Context&& ctx, Processor&& p) {
+    async_get_results_op op{std::forward<Context>(ctx), std::forward<Processor>(p)};
+    op.perform();
+}
+
+template <typename Text, typename Outs, typename TimeConstraint, typename Handler, typename Start = none_t>
+struct async_multi_request_op {
+    Text text_;
+    Outs outs_;
+    TimeConstraint time_constraint_;
+    Handler handler_;
+    Start start_;
+
+    async_multi_request_op(Text text, Outs outs, TimeConstraint time_constraint, Handler handler, Start start = Start{})
+    : text_(std::move(text)), outs_(std::move(outs)), time_constraint_(time_constraint),
+      handler_(std::move(handler)), start_(start) {}
+
+    template <typename Connection>
+    void operator() (error_code ec, Connection conn) {
+        if (ec) {
+            return handler_(ec, std::move(conn));
+        }
+
+        auto handler = apply_io_deadline(conn, time_constraint_, detail::wrap_executor {
+            detail::make_connection_executor(conn),
+            std::move(handler_)
+        });
+
+        auto ctx = make_request_operation_context(std::move(conn), std::move(handler));
+        get_request_statistics(ctx).requested(start_);
+
+        async_send_query(ctx, text_);
+        async_get_results(std::move(ctx), multi_request_results{std::move(outs_)});
+    }
+
+    using executor_type = std::decay_t<decltype(asio::get_associated_executor(handler_))>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(handler_);
+    }
+
+    using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(handler_))>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(handler_);
+    }
+};
+
+template <typename Text, typename Outs, typename TimeConstraint, typename Handler>
+async_multi_request_op(Text, Outs, TimeConstraint, Handler) -> async_multi_request_op<Text, Outs, TimeConstraint, Handler>;
+
+template <typename Text, typename Outs, typename TimeConstraint, typename Handler, typename Start>
+async_multi_request_op(Text, Outs, TimeConstraint, Handler, Start) -> async_multi_request_op<Text, Outs, TimeConstraint, Handler, Start>;
+
+template <typename P, typename Text, typename Outs, typename TimeConstraint, typename Handler>
+inline void async_multi_request(P&& provider, Text&& text, Outs&& outs, TimeConstraint t, Handler&& handler) {
+    static_assert(ConnectionProvider<P>, "is not a ConnectionProvider");
+    static_assert(QueryText<Text>, "query should be a text without parameters");
+    static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+    async_get_connection(std::forward<P>(provider), deadline(t),
+        async_multi_request_op {
+            std::forward<Text>(text),
+            std::forward<Outs>(outs),
+            deadline(t),
+            std::forward<Handler>(handler),
+            make_request_start_point<P>()
+        }
+    );
+}
+
+} // namespace ozo::impl
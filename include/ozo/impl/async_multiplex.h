@@ -0,0 +1,392 @@
+#pragma once
+
+#include <ozo/impl/async_request.h>
+#include <ozo/detail/bind.h>
+
+#include <boost/asio/post.hpp>
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifdef LIBPQ_HAS_PIPELINING
+
+namespace ozo::impl {
+
+/**
+* Request queued into the multiplexer. The query, the output and the handler types
+* are erased, so requests of different types share the same pipeline.
+*/
+template <typename Connection>
+struct multiplexed_request {
+    using result_type = std::decay_t<decltype(get_result(std::declval<Connection&>()))>;
+
+    virtual bool send(Connection& conn) = 0;
+    virtual void process(result_type&& res, Connection& conn) = 0;
+    virtual void complete(error_code ec) = 0;
+    virtual ~multiplexed_request() = default;
+};
+
+template <typename Connection, typename Query, typename Out, typename Handler, typename Executor>
+struct multiplexed_request_impl : multiplexed_request<Connection> {
+    Query query_;
+    Out out_;
+    Handler handler_;
+    Executor executor_;
+
+    multiplexed_request_impl(Query query, Out out, Handler handler, const Executor& ex)
+    : query_(std::move(query)), out_(std::move(out)), handler_(std::move(handler)), executor_(ex) {}
+
+    bool send(Connection& conn) override {
+        auto& target = unwrap_connection(conn);
+        const auto allocator = asio::get_associated_allocator(handler_);
+        return send_query_params(target, to_binary_query(query_, target.oid_map(), allocator));
+    }
+
+    using result_type = typename multiplexed_request<Connection>::result_type;
+
+    void process([[maybe_unused]] result_type&& res, [[maybe_unused]] Connection& conn) override {
+        if constexpr (!IsNone<Out>) {
+            auto result = ozo::make_result(std::move(res));
+            ozo::recv_result(result, unwrap_connection(conn).oid_map(), out_);
+        }
+    }
+
+    void complete(error_code ec) override {
+        auto ex = asio::get_associated_executor(handler_, executor_);
+        asio::post(ex, detail::bind(std::move(handler_), std::move(ec)));
+    }
+};
+
+/**
+* Requests sent in one pipeline. `completed` is the number of requests which
+* have been completed by the results operation, the rest are completed with the
+* error of the batch.
+*/
+template <typename Connection>
+struct multiplexed_batch {
+    std::vector<std::shared_ptr<multiplexed_request<Connection>>> requests;
+    std::size_t completed = 0;
+
+    void complete(std::size_t index, error_code ec) {
+        requests[index]->complete(std::move(ec));
+        completed = index + 1;
+    }
+
+    void complete_rest(error_code ec) {
+        for (auto i = completed; i < requests.size(); ++i) {
+            requests[i]->complete(ec);
+        }
+        completed = requests.size();
+    }
+};
+
+/**
+* Sends the requests of the batch each followed by its own synchronization point,
+* so every request is executed in its own implicit transaction and a failed request
+* does not abort the rest of the batch.
+*/
+template <typename Context, typename Batch>
+inline void async_send_multiplexed(const Context& ctx, const Batch& batch) {
+    decltype(auto) conn = get_connection(ctx);
+    if (auto ec = set_nonblocking(conn)) {
+        return done(ctx, ec);
+    }
+
+    if (auto ec = enter_pipeline_mode(conn)) {
+        return done(ctx, ec);
+    }
+
+    for (const auto& request : batch->requests) {
+        if (!request->send(ctx->conn)) {
+            return done(ctx, error::pg_send_query_params_failed);
+        }
+        if (auto ec = pipeline_sync(conn)) {
+            return done(ctx, ec);
+        }
+    }
+
+    async_flush_output_op{ctx}();
+}
+
+#include <boost/asio/yield.hpp>
+
+/**
+* Receives results of the multiplexed requests separated by the synchronization points
+* and completes each request as soon as its synchronization point is received, so the
+* requests are completed in the order they have been sent. The operation itself fails
+* only on the connection errors, the requests which are not completed by then are
+* completed with the error.
+*/
+template <typename Context, typename Batch>
+struct async_get_multiplexed_results_op : boost::asio::coroutine {
+    Context ctx_;
+    Batch batch_;
+    using result_type = std::decay_t<decltype(get_result(get_connection(ctx_)))>;
+    result_type result_;
+    std::size_t index_ = 0;
+    error_code error_;
+
+    async_get_multiplexed_results_op(Context ctx, Batch batch)
+    : ctx_(std::move(ctx)), batch_(std::move(batch)) {}
+
+    void perform() {
+        (*this)();
+    }
+
+    void done() {
+        return impl::done(ctx_);
+    }
+
+    void done(error_code ec) {
+        if (std::empty(get_error_context(get_connection(ctx_)))) {
+            get_connection(ctx_).set_error_context("error while get multiplexed results");
+        }
+        return impl::done(ctx_, ec);
+    }
+
+    void operator() (error_code ec = error_code{}, std::size_t = 0) {
+        if (get_query_state(ctx_) == query_state::error) {
+            return;
+        }
+
+        if (ec) {
+            if (ec == asio::error::bad_descriptor) {
+                ec = asio::error::operation_aborted;
+            }
+            return done(ec);
+        }
+
+        reenter(*this) {
+            while (index_ < batch_->requests.size()) {
+                while (is_busy(get_connection(ctx_))) {
+                    get_request_statistics(ctx_).waited();
+                    yield get_connection(ctx_).async_wait_read(std::move(*this));
+                    if (auto err = consume_input(get_connection(ctx_))) {
+                        return done(err);
+                    }
+                }
+
+                result_ = get_result(get_connection(ctx_));
+
+                if (!result_) {
+                    continue;
+                }
+
+                if (result_status(*result_) == PGRES_PIPELINE_SYNC) {
+                    batch_->complete(index_++, std::exchange(error_, error_code{}));
+                    continue;
+                }
+
+                if (!handle_result()) {
+                    return;
+                }
+            }
+
+            get_request_statistics(ctx_).result_received();
+
+            if (auto err = exit_pipeline_mode(get_connection(ctx_))) {
+                return done(err);
+            }
+
+            done();
+        }
+    }
+
+    bool handle_result() {
+        const auto status = result_status(*result_);
+        switch (status) {
+            case PGRES_SINGLE_TUPLE:
+#ifdef LIBPQ_HAS_CHUNK_MODE
+            case PGRES_TUPLES_CHUNK:
+#endif
+            case PGRES_TUPLES_OK:
+            case PGRES_COMMAND_OK:
+                process();
+                return true;
+            case PGRES_BAD_RESPONSE:
+                set_error(error::result_status_bad_response);
+                return true;
+            case PGRES_EMPTY_QUERY:
+                set_error(error::result_status_empty_query);
+                return true;
+            case PGRES_FATAL_ERROR:
+                set_error(result_error(*result_));
+                return true;
+            case PGRES_COPY_OUT:
+            case PGRES_COPY_IN:
+            case PGRES_COPY_BOTH:
+            case PGRES_NONFATAL_ERROR:
+            case PGRES_PIPELINE_SYNC:
+            case PGRES_PIPELINE_ABORTED:
+                break;
+        }
+
+        get_connection(ctx_).set_error_context(get_result_status_name(status));
+        done(error::result_status_unexpected);
+        return false;
+    }
+
+    void set_error(error_code ec) {
+        if (!error_) {
+            error_ = std::move(ec);
+        }
+    }
+
+    void process() noexcept {
+        if (error_) {
+            return;
+        }
+        try {
+            batch_->requests[index_]->process(std::move(result_), ctx_->conn);
+        } catch (const std::exception&) {
+            set_error(error::bad_result_process);
+        }
+    }
+
+    using executor_type = std::decay_t<decltype(asio::get_associated_executor(get_handler(ctx_)))>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(get_handler(ctx_));
+    }
+
+    using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(get_handler(ctx_)))>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(get_handler(ctx_));
+    }
+};
+
+template <typename Context, typename Batch>
+async_get_multiplexed_results_op(Context, Batch) -> async_get_multiplexed_results_op<Context, Batch>;
+
+#include <boost/asio/unyield.hpp>
+
+/**
+* Shared state of `ozo::multiplexer`. Each lane runs one batch at a time on its own
+* connection, the requests which arrive meanwhile wait in the lane queue and are sent
+* by the next batch.
+*/
+template <typename Source>
+class multiplexer_state : public std::enable_shared_from_this<multiplexer_state<Source>> {
+public:
+    using connection_type = typename connection_source_traits<Source>::connection_type;
+    using request_ptr = std::shared_ptr<multiplexed_request<connection_type>>;
+    using batch_type = multiplexed_batch<connection_type>;
+
+    multiplexer_state(Source source, io_context& io, std::size_t lanes, std::size_t max_batch,
+            time_traits::duration timeout)
+    : source_(std::forward<Source>(source)), io_(io), lanes_(std::max<std::size_t>(lanes, 1)),
+      max_batch_(std::max<std::size_t>(max_batch, 1)), timeout_(timeout) {}
+
+    io_context& get_io_context() const noexcept { return io_;}
+
+    /**
+     * Queues the request to the lane with the fewest requests in flight.
+     */
+    void submit(request_ptr request) {
+        std::unique_lock lock(mutex_);
+        const auto lane = std::min_element(lanes_.begin(), lanes_.end(),
+            [] (const auto& lhs, const auto& rhs) { return lhs.in_flight < rhs.in_flight; });
+        lane->queue.push_back(std::move(request));
+        ++lane->in_flight;
+        if (lane->running) {
+            return;
+        }
+        lane->running = true;
+        const auto index = static_cast<std::size_t>(lane - lanes_.begin());
+        lock.unlock();
+        start(index);
+    }
+
+    std::size_t in_flight(std::size_t lane) const {
+        const std::lock_guard lock(mutex_);
+        return lanes_.at(lane).in_flight;
+    }
+
+    std::size_t size() const noexcept { return lanes_.size();}
+
+private:
+    struct lane_type {
+        std::deque<request_ptr> queue;
+        std::size_t in_flight = 0;
+        bool running = false;
+    };
+
+    void start(std::size_t index) {
+        auto batch = std::make_shared<batch_type>();
+        {
+            const std::lock_guard lock(mutex_);
+            auto& lane = lanes_[index];
+            if (lane.queue.empty()) {
+                lane.running = false;
+                return;
+            }
+            const auto n = std::min(lane.queue.size(), max_batch_);
+            batch->requests.assign(std::make_move_iterator(lane.queue.begin()),
+                std::make_move_iterator(lane.queue.begin() + static_cast<std::ptrdiff_t>(n)));
+            lane.queue.erase(lane.queue.begin(), lane.queue.begin() + static_cast<std::ptrdiff_t>(n));
+        }
+        const auto t = ozo::deadline(timeout_);
+        source_(io_, t, batch_handler{this->shared_from_this(), index, std::move(batch), t});
+    }
+
+    void finish(std::size_t index, std::size_t count) {
+        {
+            const std::lock_guard lock(mutex_);
+            lanes_[index].in_flight -= count;
+        }
+        start(index);
+    }
+
+    /**
+     * Completes the requests of the batch which are not completed by the results
+     * operation and starts the next batch of the lane.
+     */
+    struct finish_handler {
+        std::shared_ptr<multiplexer_state> state_;
+        std::size_t index_;
+        std::shared_ptr<batch_type> batch_;
+
+        void operator() (error_code ec, connection_type conn) {
+            batch_->complete_rest(ec ? ec : error_code{error::result_status_unexpected});
+            conn = connection_type{};
+            state_->finish(index_, batch_->requests.size());
+        }
+    };
+
+    struct batch_handler {
+        std::shared_ptr<multiplexer_state> state_;
+        std::size_t index_;
+        std::shared_ptr<batch_type> batch_;
+        time_traits::time_point deadline_;
+
+        void operator() (error_code ec, connection_type conn) {
+            if (ec) {
+                finish_handler{std::move(state_), index_, std::move(batch_)}(std::move(ec), std::move(conn));
+                return;
+            }
+
+            auto handler = apply_io_deadline(conn, deadline_, detail::wrap_executor {
+                detail::make_connection_executor(conn),
+                finish_handler{state_, index_, batch_}
+            });
+
+            auto ctx = make_request_operation_context(std::move(conn), std::move(handler));
+            async_send_multiplexed(ctx, batch_);
+            async_get_multiplexed_results_op{std::move(ctx), std::move(batch_)}.perform();
+        }
+    };
+
+    mutable std::mutex mutex_;
+    Source source_;
+    io_context& io_;
+    std::vector<lane_type> lanes_;
+    std::size_t max_batch_;
+    time_traits::duration timeout_;
+};
+
+} // namespace ozo::impl
+
+#endif
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <ozo/transaction.h>
+#include <ozo/request.h>
+#include <ozo/execute.h>
+#include <ozo/query.h>
+#include <ozo/shortcuts.h>
+#include <ozo/detail/bind.h>
+
+#include <boost/asio/post.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ozo::impl {
+
+/**
+* Snapshot identifier returned by `pg_export_snapshot()` is substituted into the text of
+* `SET TRANSACTION SNAPSHOT` since the statement takes no parameters, so only the characters
+* of the identifier format, e.g. `00000003-0000001B-1`, are accepted.
+*/
+inline bool is_valid_snapshot_id(const std::string& id) noexcept {
+    return !id.empty() && std::all_of(id.begin(), id.end(), [] (char c) {
+        return (c >= '0' && c <= '9') || (c >= 'A' && c <= 'F') || (c >= 'a' && c <= 'f') || c == '-';
+    });
+}
+
+/**
+* Shared state of the operation. The coordinator transaction exports its snapshot, then
+* the workers begin their transactions concurrently and import the snapshot as the first
+* statement. The coordinator is rolled back once all the workers have imported the snapshot
+* or have failed, since a snapshot may be imported only while the exporting transaction is open.
+*/
+template <typename Provider, typename Options, typename TimeConstraint, typename Handler>
+class parallel_snapshot_state : public std::enable_shared_from_this<parallel_snapshot_state<
+        Provider, Options, TimeConstraint, Handler>> {
+public:
+    using transaction_type = transaction<connection_type<Provider>, Options>;
+
+    parallel_snapshot_state(Provider provider, Options options, TimeConstraint t, std::size_t workers, Handler handler)
+    : provider_(std::move(provider)), options_(std::move(options)), time_constraint_(t),
+      workers_(workers), remaining_(workers), handler_(std::move(handler)) {}
+
+    void perform() {
+        auto self = this->shared_from_this();
+        ozo::begin.with_transaction_options(options_)(provider_, time_constraint_,
+            [self] (error_code ec, transaction_type coordinator) {
+                if (ec) {
+                    return self->complete(std::move(ec));
+                }
+                self->export_snapshot(std::move(coordinator));
+            });
+    }
+
+private:
+    void export_snapshot(transaction_type coordinator) {
+        using namespace ozo::literals;
+        auto self = this->shared_from_this();
+        auto rows = std::make_shared<std::vector<std::tuple<std::string>>>();
+        ozo::request(std::move(coordinator), "SELECT pg_export_snapshot()"_SQL, time_constraint_,
+            std::back_inserter(*rows), [self, rows] (error_code ec, transaction_type coordinator) {
+                if (ec) {
+                    return self->complete(std::move(ec));
+                }
+                if (rows->size() != 1 || !is_valid_snapshot_id(std::get<0>(rows->front()))) {
+                    return self->complete(error::bad_result_process);
+                }
+                self->begin_workers(std::move(coordinator), std::get<0>(rows->front()));
+            });
+    }
+
+    void begin_workers(transaction_type coordinator, const std::string& snapshot) {
+        coordinator_ = std::move(coordinator);
+        if (workers_.empty()) {
+            return end_coordinator();
+        }
+        const auto text = "SET TRANSACTION SNAPSHOT '" + snapshot + "'";
+        for (std::size_t i = 0; i != workers_.size(); ++i) {
+            auto self = this->shared_from_this();
+            ozo::begin.with_transaction_options(options_)(provider_, time_constraint_,
+                [self, i, text] (error_code ec, transaction_type worker) {
+                    if (ec) {
+                        return self->worker_done(i, std::move(ec), std::move(worker));
+                    }
+                    ozo::execute(std::move(worker), make_query(text), self->time_constraint_,
+                        [self, i] (error_code ec, transaction_type worker) {
+                            self->worker_done(i, std::move(ec), std::move(worker));
+                        });
+                });
+        }
+    }
+
+    void worker_done(std::size_t i, error_code ec, transaction_type worker) {
+        std::unique_lock lock(mutex_);
+        workers_[i] = std::move(worker);
+        if (ec && !error_) {
+            error_ = std::move(ec);
+        }
+        if (--remaining_ != 0) {
+            return;
+        }
+        lock.unlock();
+        end_coordinator();
+    }
+
+    // An error of the rollback does not affect the workers which have imported the snapshot already
+    void end_coordinator() {
+        auto self = this->shared_from_this();
+        ozo::rollback(std::move(coordinator_), time_constraint_, [self] (error_code, auto&&) {
+            self->complete(std::move(self->error_));
+        });
+    }
+
+    void complete(error_code ec) {
+        if (ec) {
+            workers_.clear();
+        }
+        auto ex = asio::get_associated_executor(handler_);
+        asio::post(ex, detail::bind(std::move(handler_), std::move(ec), std::move(workers_)));
+    }
+
+    std::mutex mutex_;
+    Provider provider_;
+    Options options_;
+    TimeConstraint time_constraint_;
+    transaction_type coordinator_;
+    std::vector<transaction_type> workers_;
+    std::size_t remaining_;
+    error_code error_;
+    Handler handler_;
+};
+
+template <typename P, typename Options, typename TimeConstraint, typename Handler>
+inline void async_begin_parallel_snapshot(P&& provider, std::size_t workers, Options&& options,
+        TimeConstraint t, Handler&& handler) {
+    static_assert(ConnectionProvider<P>, "is not a ConnectionProvider");
+    static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+    using state_type = parallel_snapshot_state<std::decay_t<P>, std::decay_t<Options>,
+        decltype(deadline(t)), std::decay_t<Handler>>;
+    std::make_shared<state_type>(std::forward<P>(provider), std::forward<Options>(options), deadline(t),
+        workers, std::forward<Handler>(handler))->perform();
+}
+
+} // namespace ozo::impl
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <ozo/impl/async_request.h>
+
+#include <boost/hana/for_each.hpp>
+#include <boost/hana/size.hpp>
+
+#ifdef LIBPQ_HAS_PIPELINING
+
+namespace ozo::impl {
+
+/**
+* Pipeline step. Contains a query to be sent to a database and
+* an output for the query result. For the `ozo::none` output
+* the result is checked for errors and dropped.
+*/
+template <typename Query, typename Out>
+struct pipeline_step {
+    Query query;
+    Out out;
+};
+
+template <typename Steps>
+constexpr std::size_t pipeline_size = decltype(hana::size(std::declval<const Steps&>()))::value;
+
+template <typename Context, typename Steps>
+inline void async_send_pipeline(const Context& ctx, const Steps& steps) {
+    decltype(auto) conn = get_connection(ctx);
+    if (auto ec = set_nonblocking(conn)) {
+        return done(ctx, ec);
+    }
+
+    if (auto ec = enter_pipeline_mode(conn)) {
+        return done(ctx, ec);
+    }
+
+    const auto allocator = asio::get_associated_allocator(get_handler(ctx));
+    bool sent = true;
+    hana::for_each(steps, [&](const auto& step) {
+        sent = sent && send_query_params(conn, to_binary_query(step.query, conn.oid_map(), allocator));
+    });
+
+    if (!sent) {
+        return done(ctx, error::pg_send_query_params_failed);
+    }
+
+    if (auto ec = pipeline_sync(conn)) {
+        return done(ctx, ec);
+    }
+
+    async_flush_output_op{ctx}();
+}
+
+template <typename Steps>
+struct pipeline_steps_results {
+    Steps steps;
+
+    constexpr std::size_t size() const noexcept { return pipeline_size<Steps>;}
+
+    template <typename Result, typename Connection>
+    void operator() (std::size_t index, Result&& res, Connection& conn) {
+        std::size_t i = 0;
+        hana::for_each(steps, [&](auto& step) {
+            if (i++ == index) {
+                process(step.out, std::forward<Result>(res), conn);
+            }
+        });
+    }
+
+    template <typename Out, typename Result, typename Connection>
+    static void process(Out& out, Result&& res, Connection& conn) {
+        if constexpr (!IsNone<Out>) {
+            auto result = ozo::make_result(std::forward<Result>(res));
+            ozo::recv_result(result, unwrap_connection(conn).oid_map(), out);
+        }
+    }
+};
+
+template <typename Steps>
+pipeline_steps_results(Steps) -> pipeline_steps_results<Steps>;
+
+template <typename Steps, typename TimeConstraint, typename Handler, typename Start = none_t>
+struct async_pipeline_op {
+    Steps steps_;
+    TimeConstraint time_constraint_;
+    Handler handler_;
+    Start start_;
+
+    async_pipeline_op(Steps steps, TimeConstraint time_constraint, Handler handler, Start start = Start{})
+    : steps_(std::move(steps)), time_constraint_(time_constraint), handler_(std::move(handler)), start_(start) {}
+
+    template <typename Connection>
+    void operator() (error_code ec, Connection conn) {
+        if (ec) {
+            return handler_(ec, std::move(conn));
+        }
+
+        auto handler = apply_io_deadline(conn, time_constraint_, detail::wrap_executor {
+            detail::make_connection_executor(conn),
+            std::move(handler_)
+        });
+
+        auto ctx = make_request_operation_context(std::move(conn), std::move(handler));
+        get_request_statistics(ctx).requested(start_);
+
+        async_send_pipeline(ctx, steps_);
+        async_get_pipeline_results(std::move(ctx), pipeline_steps_results{std::move(steps_)});
+    }
+
+    using executor_type = std::decay_t<decltype(asio::get_associated_executor(handler_))>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(handler_);
+    }
+
+    using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(handler_))>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(handler_);
+    }
+};
+
+template <typename Steps, typename TimeConstraint, typename Handler>
+async_pipeline_op(Steps, TimeConstraint, Handler) -> async_pipeline_op<Steps, TimeConstraint, Handler>;
+
+template <typename Steps, typename TimeConstraint, typename Handler, typename Start>
+async_pipeline_op(Steps, TimeConstraint, Handler, Start) -> async_pipeline_op<Steps, TimeConstraint, Handler, Start>;
+
+template <typename P, typename Steps, typename TimeConstraint, typename Handler>
+inline void async_pipeline(P&& provider, Steps&& steps, TimeConstraint t, Handler&& handler) {
+    static_assert(ConnectionProvider<P>, "is not a ConnectionProvider");
+    static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+    async_get_connection(std::forward<P>(provider), deadline(t),
+        async_pipeline_op {
+            std::forward<Steps>(steps),
+            deadline(t),
+            std::forward<Handler>(handler),
+            make_request_start_point<P>()
+        }
+    );
+}
+
+} // namespace ozo::impl
+
+#endif
@@ -0,0 +1,599 @@
+#pragma once
+
+#include <ozo/impl/async_request.h>
+#include <ozo/impl/async_listen.h>
+#include <ozo/io/istream.h>
+#include <ozo/io/ostream.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ozo {
+
+/**
+ * @brief Position in the write-ahead log, the `pg_lsn` value as the byte offset from `'0/0'`
+ * @ingroup group-requests-types
+ */
+using replication_lsn = std::uint64_t;
+
+/**
+ * @brief XLogData message of a replication stream
+ *
+ * The data is the message of the output plugin as is, e.g. a pgoutput message. It refers
+ * to the buffer received by libpq, so it is valid only while the message handler runs.
+ *
+ * @ingroup group-requests-types
+ */
+struct xlog_data {
+    replication_lsn wal_start = 0; //!< position of the data in the log
+    replication_lsn wal_end = 0; //!< current end of the log on the server
+    std::int64_t send_time = 0; //!< server clock at the time of transmission, microseconds since 2000-01-01
+    std::string_view data; //!< output plugin message
+};
+
+/**
+ * @brief Position of the replication stream processed by the consumer
+ *
+ * The position reported to the server as flushed, so the server may remove the log before it
+ * and the stream restarts from it after a reconnection. The consumer which applies the messages
+ * asynchronously confirms the position once the messages before it are durably processed.
+ * The object may be used from many threads simultaneously.
+ *
+ * @ingroup group-requests-types
+ */
+class replication_progress {
+public:
+    explicit replication_progress(replication_lsn lsn = 0) noexcept : lsn_(lsn) {}
+
+    void confirm(replication_lsn lsn) noexcept {
+        auto current = lsn_.load(std::memory_order_relaxed);
+        while (current < lsn && !lsn_.compare_exchange_weak(current, lsn, std::memory_order_relaxed));
+    }
+
+    replication_lsn get() const noexcept { return lsn_.load(std::memory_order_relaxed);}
+
+private:
+    std::atomic<replication_lsn> lsn_;
+};
+
+/**
+ * @brief Logical replication stream configuration
+ * @ingroup group-requests-types
+ */
+struct replication_config {
+    std::string slot; //!< name of the logical replication slot
+    replication_lsn start_lsn = 0; //!< position to start streaming from, 0 means the confirmed position of the slot
+    std::vector<std::pair<std::string, std::string>> options; //!< output plugin options, e.g. `{"proto_version", "1"}, {"publication_names", "pub"}` for pgoutput
+    time_traits::duration status_interval = std::chrono::seconds(10); //!< interval between standby status updates at most while the stream is active
+    std::size_t max_batch_size = 1024; //!< maximum number of messages passed to the handler at once
+    std::shared_ptr<replication_progress> progress; //!< flushed position confirmed by the consumer; if null the messages are confirmed once the handler returns
+};
+
+} // namespace ozo
+
+namespace ozo::impl {
+
+inline void append_quoted_literal(std::string& text, std::string_view literal) {
+    text += '\'';
+    for (const char c : literal) {
+        if (c == '\'') {
+            text += '\'';
+        }
+        text += c;
+    }
+    text += '\'';
+}
+
+inline void append_lsn(std::string& text, replication_lsn lsn) {
+    constexpr const char digits[] = "0123456789ABCDEF";
+    const auto append_hex = [&] (std::uint32_t v) {
+        char buf[8];
+        int n = 0;
+        do {
+            buf[n++] = digits[v & 0xF];
+            v >>= 4;
+        } while (v);
+        while (n) {
+            text += buf[--n];
+        }
+    };
+    append_hex(static_cast<std::uint32_t>(lsn >> 32));
+    text += '/';
+    append_hex(static_cast<std::uint32_t>(lsn));
+}
+
+/**
+* Makes the text of the `START_REPLICATION` command of the replication protocol for a logical slot.
+*/
+inline std::string make_start_replication_query(const replication_config& config) {
+    std::string text = "START_REPLICATION SLOT ";
+    append_quoted_identifier(text, config.slot);
+    text += " LOGICAL ";
+    append_lsn(text, config.start_lsn);
+    if (!config.options.empty()) {
+        text += " (";
+        for (std::size_t i = 0; i != config.options.size(); ++i) {
+            if (i) {
+                text += ", ";
+            }
+            append_quoted_identifier(text, config.options[i].first);
+            text += ' ';
+            append_quoted_literal(text, config.options[i].second);
+        }
+        text += ')';
+    }
+    return text;
+}
+
+constexpr std::int64_t pg_epoch_offset = 946684800; // seconds between 1970-01-01 and 2000-01-01
+
+inline std::int64_t replication_clock() noexcept {
+    using namespace std::chrono;
+    return duration_cast<microseconds>(system_clock::now().time_since_epoch()).count()
+        - pg_epoch_offset * 1000000;
+}
+
+/**
+* Makes the standby status update message with the write position and the flushed and
+* applied one.
+*/
+inline void make_standby_status_update(std::vector<char>& buffer, replication_lsn written,
+        replication_lsn flushed, bool reply) {
+    buffer.clear();
+    ostream out(buffer);
+    write(out, 'r');
+    write(out, std::int64_t(written));
+    write(out, std::int64_t(flushed));
+    write(out, std::int64_t(flushed));
+    write(out, replication_clock());
+    write(out, std::int8_t(reply));
+}
+
+enum class replication_message_type : char {
+    xlog_data = 'w',
+    keepalive = 'k',
+};
+
+/**
+* Decodes the XLogData message, the data refers to the message buffer.
+*/
+inline xlog_data decode_xlog_data(const char* data, std::size_t size) {
+    istream in(data + 1, size - 1);
+    std::int64_t wal_start = 0, wal_end = 0, send_time = 0;
+    read(in, wal_start);
+    read(in, wal_end);
+    read(in, send_time);
+    constexpr std::size_t header_size = 1 + 3 * sizeof(std::int64_t);
+    return {replication_lsn(wal_start), replication_lsn(wal_end), send_time,
+        std::string_view(data + header_size, size - header_size)};
+}
+
+struct replication_keepalive {
+    replication_lsn wal_end = 0;
+    bool reply_requested = false;
+};
+
+inline replication_keepalive decode_keepalive(const char* data, std::size_t size) {
+    istream in(data + 1, size - 1);
+    std::int64_t wal_end = 0, send_time = 0;
+    std::int8_t reply = 0;
+    read(in, wal_end);
+    read(in, send_time);
+    read(in, reply);
+    return {replication_lsn(wal_end), reply != 0};
+}
+
+enum class replication_state {
+    receive_in_progress,
+    stop,
+    finish,
+    error,
+};
+
+#include <boost/asio/yield.hpp>
+
+/**
+* Receives the result of the `START_REPLICATION` command and then the COPY BOTH stream.
+* Each time new input is consumed all the available XLogData messages are passed to the
+* message handler by batches which refer to the buffers received by libpq. The standby
+* status update is sent on the server request and when the status interval has passed
+* since the previous one at a wake-up. An idle stream is woken by the server keepalives,
+* which request a reply before `wal_sender_timeout` expires.
+*
+* The stream is stopped with CopyDone when the handler returns `false` if it returns a value
+* convertible to `bool`; the rest of the stream is discarded then. Otherwise the operation
+* lasts until the server ends the stream, an error, the time constraint expiration or the
+* connection cancellation.
+*/
+template <typename Context, typename MessageHandler>
+struct async_replication_op : boost::asio::coroutine {
+    Context ctx_;
+    MessageHandler handler_;
+    using result_type = std::decay_t<decltype(get_result(get_connection(ctx_)))>;
+    result_type result_;
+    std::shared_ptr<replication_progress> progress_;
+    time_traits::duration status_interval_;
+    std::size_t max_batch_size_;
+    replication_lsn received_ = 0;
+    replication_lsn flushed_ = 0;
+    time_traits::time_point last_status_;
+    std::vector<xlog_data> batch_;
+    std::vector<char> status_;
+    replication_state state_ = replication_state::receive_in_progress;
+    query_state send_state_ = query_state::send_in_progress;
+    bool reply_ = false;
+    error_code error_;
+
+    async_replication_op(Context ctx, MessageHandler handler, const replication_config& config)
+    : ctx_(std::move(ctx)), handler_(std::move(handler)), progress_(config.progress),
+      status_interval_(config.status_interval), max_batch_size_(std::max<std::size_t>(config.max_batch_size, 1)),
+      received_(config.start_lsn), flushed_(config.start_lsn), last_status_(time_traits::now()) {}
+
+    void perform() {
+        (*this)();
+    }
+
+    void done() {
+        return impl::done(ctx_);
+    }
+
+    void done(error_code ec) {
+        if (std::empty(get_error_context(get_connection(ctx_)))) {
+            get_connection(ctx_).set_error_context("error while receive replication stream");
+        }
+        return impl::done(ctx_, ec);
+    }
+
+    void operator() (error_code ec = error_code{}, std::size_t = 0) {
+        if (get_query_state(ctx_) == query_state::error) {
+            return;
+        }
+
+        if (ec) {
+            if (ec == asio::error::bad_descriptor) {
+                ec = asio::error::operation_aborted;
+            }
+            return done(ec);
+        }
+
+        reenter(*this) {
+            while (is_busy(get_connection(ctx_))) {
+                yield get_connection(ctx_).async_wait_read(std::move(*this));
+                if (auto err = consume_input(get_connection(ctx_))) {
+                    return done(err);
+                }
+            }
+
+            result_ = get_result(get_connection(ctx_));
+
+            if (!result_) {
+                get_connection(ctx_).set_error_context("no COPY BOTH result received");
+                return done(error::result_status_unexpected);
+            }
+
+            if (result_status(*result_) == PGRES_COPY_BOTH) {
+                for (;;) {
+                    state_ = receive();
+                    if (state_ != replication_state::receive_in_progress) {
+                        break;
+                    }
+                    if (reply_ || time_traits::now() - last_status_ >= status_interval_) {
+                        make_standby_status_update(status_, received_, flushed(), reply_);
+                        reply_ = false;
+                        last_status_ = time_traits::now();
+                        while ((send_state_ = put_copy_data(get_connection(ctx_),
+                                status_.data(), status_.size())) == query_state::send_in_progress) {
+                            yield get_connection(ctx_).async_wait_write(std::move(*this));
+                        }
+                        if (send_state_ == query_state::error) {
+                            return done(error::pg_put_copy_data_failed);
+                        }
+                        while ((send_state_ = flush_output(get_connection(ctx_))) == query_state::send_in_progress) {
+                            yield get_connection(ctx_).async_wait_write(std::move(*this));
+                        }
+                        if (send_state_ == query_state::error) {
+                            return done(error::pg_flush_failed);
+                        }
+                    }
+                    yield get_connection(ctx_).async_wait_read(std::move(*this));
+                    if (auto err = consume_input(get_connection(ctx_))) {
+                        return done(err);
+                    }
+                }
+
+                if (state_ == replication_state::error) {
+                    return;
+                }
+
+                if (state_ == replication_state::stop) {
+                    while ((send_state_ = put_copy_end(get_connection(ctx_))) == query_state::send_in_progress) {
+                        yield get_connection(ctx_).async_wait_write(std::move(*this));
+                    }
+                    if (send_state_ == query_state::error) {
+                        return done(error::pg_put_copy_end_failed);
+                    }
+                    while ((send_state_ = flush_output(get_connection(ctx_))) == query_state::send_in_progress) {
+                        yield get_connection(ctx_).async_wait_write(std::move(*this));
+                    }
+                    if (send_state_ == query_state::error) {
+                        return done(error::pg_flush_failed);
+                    }
+                    // The messages sent by the server before it received CopyDone are discarded
+                    while ((state_ = discard()) == replication_state::receive_in_progress) {
+                        yield get_connection(ctx_).async_wait_read(std::move(*this));
+                        if (auto err = consume_input(get_connection(ctx_))) {
+                            return done(err);
+                        }
+                    }
+                    if (state_ == replication_state::error) {
+                        return;
+                    }
+                }
+            } else if (!handle_result()) {
+                return;
+            }
+
+            for (;;) {
+                while (is_busy(get_connection(ctx_))) {
+                    yield get_connection(ctx_).async_wait_read(std::move(*this));
+                    if (auto err = consume_input(get_connection(ctx_))) {
+                        return done(err);
+                    }
+                }
+
+                result_ = get_result(get_connection(ctx_));
+
+                if (!result_) {
+                    break;
+                }
+
+                if (!handle_result()) {
+                    return;
+                }
+            }
+
+            if (error_) {
+                return done(error_);
+            }
+
+            done();
+        }
+    }
+
+    replication_lsn flushed() const noexcept {
+        return progress_ ? progress_->get() : flushed_;
+    }
+
+    /**
+    * Receives all the messages which are available without waiting and passes
+    * the XLogData ones to the handler by batches. The buffers of the messages live
+    * until the batch is delivered, so the operation object stays copyable.
+    */
+    replication_state receive() noexcept {
+        std::vector<pg::copy_data> buffers;
+        try {
+            for (;;) {
+                pg::copy_data data;
+                const auto size = get_copy_data(get_connection(ctx_), data);
+                if (size < -1) {
+                    batch_.clear();
+                    done(error::pg_get_copy_data_failed);
+                    return replication_state::error;
+                }
+                if (size <= 0) {
+                    if (!deliver()) {
+                        return replication_state::stop;
+                    }
+                    return size == 0 ? replication_state::receive_in_progress : replication_state::finish;
+                }
+                if (!process(std::move(data), static_cast<std::size_t>(size), buffers)) {
+                    batch_.clear();
+                    return replication_state::error;
+                }
+                if (batch_.size() >= max_batch_size_) {
+                    if (!deliver()) {
+                        return replication_state::stop;
+                    }
+                    buffers.clear();
+                }
+            }
+        } catch (const std::exception& e) {
+            batch_.clear();
+            get_connection(ctx_).set_error_context(e.what());
+            done(error::bad_result_process);
+            return replication_state::error;
+        }
+    }
+
+    bool process(pg::copy_data data, std::size_t size, std::vector<pg::copy_data>& buffers) {
+        switch (static_cast<replication_message_type>(data.get()[0])) {
+            case replication_message_type::xlog_data: {
+                const auto message = decode_xlog_data(data.get(), size);
+                received_ = std::max(received_, message.wal_start);
+                batch_.push_back(message);
+                buffers.push_back(std::move(data));
+                return true;
+            }
+            case replication_message_type::keepalive: {
+                const auto keepalive = decode_keepalive(data.get(), size);
+                reply_ = reply_ || keepalive.reply_requested;
+                // Nothing is pending before the end of the log, so it may be confirmed
+                if (batch_.empty()) {
+                    received_ = std::max(received_, keepalive.wal_end);
+                    flushed_ = std::max(flushed_, keepalive.wal_end);
+                }
+                return true;
+            }
+        }
+        get_connection(ctx_).set_error_context("unexpected replication message type");
+        done(error::bad_result_process);
+        return false;
+    }
+
+    /**
+    * Passes the batch to the handler, returns `false` if the stream should be stopped.
+    */
+    bool deliver() {
+        if (batch_.empty()) {
+            return true;
+        }
+        const auto end = received_;
+        bool result = true;
+        if constexpr (std::is_void_v<decltype(handler_(std::as_const(batch_)))>) {
+            handler_(std::as_const(batch_));
+        } else {
+            result = static_cast<bool>(handler_(std::as_const(batch_)));
+        }
+        batch_.clear();
+        flushed_ = std::max(flushed_, end);
+        return result;
+    }
+
+    replication_state discard() noexcept {
+        for (;;) {
+            pg::copy_data data;
+            const auto size = get_copy_data(get_connection(ctx_), data);
+            if (size == 0) {
+                return replication_state::receive_in_progress;
+            }
+            if (size == -1) {
+                return replication_state::finish;
+            }
+            if (size < 0) {
+                done(error::pg_get_copy_data_failed);
+                return replication_state::error;
+            }
+        }
+    }
+
+    bool handle_result() {
+        const auto status = result_status(*result_);
+        switch (status) {
+            case PGRES_COMMAND_OK:
+            case PGRES_TUPLES_OK:
+                return true;
+            case PGRES_BAD_RESPONSE:
+                set_error(error::result_status_bad_response);
+                return true;
+            case PGRES_EMPTY_QUERY:
+                set_error(error::result_status_empty_query);
+                return true;
+            case PGRES_FATAL_ERROR:
+                set_error(result_error(*result_));
+                return true;
+            case PGRES_SINGLE_TUPLE:
+#ifdef LIBPQ_HAS_CHUNK_MODE
+            case PGRES_TUPLES_CHUNK:
+#endif
+            case PGRES_COPY_OUT:
+            case PGRES_COPY_IN:
+            case PGRES_COPY_BOTH:
+            case PGRES_NONFATAL_ERROR:
+#ifdef LIBPQ_HAS_PIPELINING
+            case PGRES_PIPELINE_SYNC:
+            case PGRES_PIPELINE_ABORTED:
+#endif
+                break;
+        }
+
+        get_connection(ctx_).set_error_context(get_result_status_name(status));
+        done(error::result_status_unexpected);
+        return false;
+    }
+
+    void set_error(error_code ec) {
+        if (!error_) {
+            error_ = std::move(ec);
+        }
+    }
+
+    using executor_type = std::decay_t<decltype(asio::get_associated_executor(get_handler(ctx_)))>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(get_handler(ctx_));
+    }
+
+    using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(get_handler(ctx_)))>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(get_handler(ctx_));
+    }
+};
+
+template <typename Context, typename MessageHandler>
+async_replication_op(Context, MessageHandler, const replication_config&) -> async_replication_op<Context, MessageHandler>;
+
+#include <boost/asio/unyield.hpp>
+
+template <typename Context, typename MessageHandler>
+inline void async_replication_stream(Context&& ctx, MessageHandler&& h, const replication_config& config) {
+    async_replication_op op{std::forward<Context>(ctx), std::forward<MessageHandler>(h), config};
+    op.perform();
+}
+
+template <typename MessageHandler, typename TimeConstraint, typename Handler>
+struct async_start_replication_op {
+    replication_config config_;
+    TimeConstraint time_constraint_;
+    MessageHandler message_handler_;
+    Handler handler_;
+
+    async_start_replication_op(replication_config config, TimeConstraint time_constraint,
+            MessageHandler message_handler, Handler handler)
+    : config_(std::move(config)), time_constraint_(time_constraint),
+      message_handler_(std::move(message_handler)), handler_(std::move(handler)) {}
+
+    template <typename Connection>
+    void operator() (error_code ec, Connection conn) {
+        if (ec) {
+            return handler_(ec, std::move(conn));
+        }
+
+        auto handler = apply_io_deadline(conn, time_constraint_, detail::wrap_executor {
+            detail::make_connection_executor(conn),
+            std::move(handler_)
+        });
+
+        auto ctx = make_request_operation_context(std::move(conn), std::move(handler));
+
+        // The replication protocol supports the simple query protocol only, as LISTEN does
+        async_send_listen_query(ctx, make_start_replication_query(config_));
+        async_replication_stream(std::move(ctx), std::move(message_handler_), config_);
+    }
+
+    using executor_type = std::decay_t<decltype(asio::get_associated_executor(handler_))>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(handler_);
+    }
+
+    using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(handler_))>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(handler_);
+    }
+};
+
+template <typename P, typename TimeConstraint, typename MessageHandler, typename Handler>
+inline void async_start_replication(P&& provider, replication_config config, TimeConstraint t,
+        MessageHandler&& message_handler, Handler&& handler) {
+    static_assert(ConnectionProvider<P>, "is not a ConnectionProvider");
+    static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+    async_get_connection(std::forward<P>(provider), deadline(t),
+        async_start_replication_op {
+            std::move(config),
+            deadline(t),
+            std::decay_t<MessageHandler>(std::forward<MessageHandler>(message_handler)),
+            std::forward<Handler>(handler)
+        }
+    );
+}
+
+} // namespace ozo::impl
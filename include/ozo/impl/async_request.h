@@ -1,25 +1,42 @@
 #pragma once
 
+#include <ozo/detail/cancellation.h>
 #include <ozo/detail/deadline.h>
+#include <ozo/detail/probes.h>
 #include <ozo/detail/timeout_handler.h>
 #include <ozo/detail/wrap_executor.h>
 #include <ozo/impl/io.h>
+#include <ozo/impl/lazy_oid_map.h>
 #include <ozo/io/binary_query.h>
+#include <ozo/cancel.h>
 #include <ozo/connection.h>
+#include <ozo/prepared_query.h>
 #include <ozo/query_builder.h>
 #include <ozo/deadline.h>
+#include <ozo/transaction_status.h>
+#include <ozo/impl/transaction_status.h>
 
 #include <boost/asio/bind_executor.hpp>
 #include <boost/asio/coroutine.hpp>
+#include <boost/asio/post.hpp>
+
+#include <optional>
+#include <string>
 
 namespace ozo {
 namespace impl {
 
 template <typename Connection, typename Handler>
 struct request_operation_context {
+    using stream_type = std::decay_t<decltype(unwrap_connection(std::declval<std::decay_t<Connection>&>()))>;
+    using statistics_type = detail::request_statistics_sample<stream_type>;
+    using cpu_time_type = detail::request_cpu_time_sample<stream_type>;
+
     std::decay_t<Connection> conn;
     std::decay_t<Handler> handler;
     query_state state = query_state::send_in_progress;
+    statistics_type statistics;
+    cpu_time_type cpu_time;
 
     request_operation_context(Connection conn, Handler handler)
       : conn(std::forward<Connection>(conn)),
@@ -28,7 +45,7 @@ struct request_operation_context {
 
 template <typename Connection, typename Handler>
 inline decltype(auto) make_request_operation_context(Connection&& conn, Handler&& h) {
-    auto allocator = asio::get_associated_allocator(h);
+    auto allocator = detail::get_operation_allocator(unwrap_connection(conn), h);
     return std::allocate_shared<request_operation_context<Connection, Handler>>(
         allocator, std::forward<Connection>(conn), std::forward<Handler>(h)
     );
@@ -58,38 +75,37 @@ auto& get_handler(const request_operation_context_ptr<Ts ...>& context) noexcept
     return context->handler;
 }
 
+template <typename ...Ts>
+inline auto& get_request_statistics(const request_operation_context_ptr<Ts...>& ctx) noexcept {
+    return ctx->statistics;
+}
+
+template <typename ...Ts>
+inline auto& get_request_cpu_time(const request_operation_context_ptr<Ts...>& ctx) noexcept {
+    return ctx->cpu_time;
+}
+
 template <typename ...Ts>
 inline void done(const request_operation_context_ptr<Ts...>& ctx, error_code ec) {
     set_query_state(ctx, query_state::error);
     get_connection(ctx).cancel();
+    get_request_statistics(ctx).commit(get_connection(ctx), true);
+    get_request_cpu_time(ctx).commit(get_connection(ctx), true);
+    OZO_PROBE(request__done, get_native_handle(get_connection(ctx)), ec.value());
     std::move(get_handler(ctx))(std::move(ec), ctx->conn);
 }
 
 template <typename ...Ts>
 inline void done(const request_operation_context_ptr<Ts...>& ctx) {
+    get_request_statistics(ctx).commit(get_connection(ctx), false);
+    get_request_cpu_time(ctx).commit(get_connection(ctx), false);
+    OZO_PROBE(request__done, get_native_handle(get_connection(ctx)), 0);
     std::move(get_handler(ctx))(error_code {}, ctx->conn);
 }
 
 template <typename Context>
-struct async_send_query_params_op {
+struct async_flush_output_op {
     Context ctx_;
-    binary_query query_;
-
-    async_send_query_params_op(Context ctx, binary_query query)
-    : ctx_(std::move(ctx)), query_(std::move(query)) {}
-
-    void perform() {
-        decltype(auto) conn = get_connection(ctx_);
-        if (auto ec = set_nonblocking(conn)) {
-            return done(ctx_, ec);
-        }
-
-        if (!send_query_params(conn, query_)) {
-            return done(ctx_, error::pg_send_query_params_failed);
-        }
-
-        (*this)();
-    }
 
     void operator () (error_code ec = error_code{}, std::size_t = 0) {
         // if data has been flushed or error has been set by
@@ -116,6 +132,7 @@ struct async_send_query_params_op {
                 break;
             case query_state::send_finish:
                 set_query_state(ctx_, query_state::send_finish);
+                get_request_statistics(ctx_).flushed();
                 break;
         }
     }
@@ -134,18 +151,112 @@ struct async_send_query_params_op {
 };
 
 template <typename Context>
-async_send_query_params_op(Context, binary_query) -> async_send_query_params_op<Context>;
+async_flush_output_op(Context) -> async_flush_output_op<Context>;
+
+template <typename Context, typename BinaryQuery = binary_query>
+struct async_send_query_params_op {
+    Context ctx_;
+    BinaryQuery query_;
+
+    async_send_query_params_op(Context ctx, BinaryQuery query)
+    : ctx_(std::move(ctx)), query_(std::move(query)) {}
+
+    void perform() {
+        decltype(auto) conn = get_connection(ctx_);
+        if (auto ec = set_nonblocking(conn)) {
+            return done(ctx_, ec);
+        }
+
+        if (!send_query_params(conn, query_)) {
+            return done(ctx_, error::pg_send_query_params_failed);
+        }
+
+        get_request_statistics(ctx_).sent(query_.text(), query_.lengths(),
+            static_cast<std::size_t>(query_.params_count()));
+
+        (*this)();
+    }
+
+    void operator () (error_code ec = error_code{}, std::size_t = 0) {
+        async_flush_output_op{ctx_}(ec);
+    }
+};
+
+template <typename Context, typename BinaryQuery>
+async_send_query_params_op(Context, BinaryQuery) -> async_send_query_params_op<Context, BinaryQuery>;
 
 template <typename Context, typename Query>
 void async_send_query_params(std::shared_ptr<Context> ctx, Query&& query) {
-    auto q = to_binary_query(std::forward<Query>(query),
-                        get_connection(ctx).oid_map(),
-                        asio::get_associated_allocator(get_handler(ctx)));
-
-    async_send_query_params_op op{std::move(ctx), std::move(q)};
-    op.perform();
+    if constexpr (TypedBinaryQuery<Query>) {
+        async_send_query_params_op op{std::move(ctx), std::decay_t<Query>(std::forward<Query>(query))};
+        op.perform();
+    } else {
+        auto q = [&] {
+            const auto cpu_time = get_request_cpu_time(ctx).measure_serialization();
+            return to_binary_query(std::forward<Query>(query),
+                                get_connection(ctx).oid_map(),
+                                asio::get_associated_allocator(get_handler(ctx)));
+        }();
+
+        async_send_query_params_op op{std::move(ctx), std::move(q)};
+        op.perform();
+    }
 }
 
+/**
+* Result processor which processes a result asynchronously should define
+* the `async_result_processor_tag` member type and provide the `async_process()`
+* member function with `void(Result&& result, Connection& conn, Continuation c)`
+* signature. The continuation should be called once the result has been processed
+* with `void(error_code ec, std::string error_context)` signature from any thread.
+*/
+template <typename T, typename = std::void_t<>>
+struct is_async_result_processor : std::false_type {};
+
+template <typename T>
+struct is_async_result_processor<T, std::void_t<typename T::async_result_processor_tag>> : std::true_type {};
+
+template <typename Context>
+struct async_process_continuation {
+    Context ctx_;
+
+    void operator() (error_code ec, std::string error_context) {
+        auto ex = asio::get_associated_executor(get_handler(ctx_));
+        asio::post(ex, [ctx = std::move(ctx_), ec, error_context = std::move(error_context)] () mutable {
+            if (!ec) {
+                return done(ctx);
+            }
+            get_connection(ctx).set_error_context(std::move(error_context));
+            done(ctx, ec);
+        });
+    }
+};
+
+template <typename Context>
+async_process_continuation(Context) -> async_process_continuation<Context>;
+
+/**
+* Connection which limits the size of a request result should provide the
+* `max_result_size()` member function which returns the limit in bytes, zero
+* if the size is not limited.
+*/
+template <typename T, typename = std::void_t<>>
+struct has_max_result_size : std::false_type {};
+
+template <typename T>
+struct has_max_result_size<T, std::void_t<decltype(std::declval<const T&>().max_result_size())>> : std::true_type {};
+
+/**
+* Connection which spins waiting for the data of a request result should provide
+* the `busy_poll()` member function which returns the spin time, zero if the busy
+* polling is disabled.
+*/
+template <typename T, typename = std::void_t<>>
+struct has_busy_poll : std::false_type {};
+
+template <typename T>
+struct has_busy_poll<T, std::void_t<decltype(std::declval<const T&>().busy_poll())>> : std::true_type {};
+
 #include <boost/asio/yield.hpp>
 
 template <typename Context, typename ResultProcessor>
@@ -154,6 +265,8 @@ struct async_get_result_op : boost::asio::coroutine {
     ResultProcessor process_;
     using result_type = std::decay_t<decltype(get_result(get_connection(ctx_)))>;
     result_type result_;
+    std::size_t result_bytes_ = 0;
+    bool consumed_ = false;
 
     async_get_result_op(Context ctx, ResultProcessor process)
     : ctx_(ctx), process_(process) {}
@@ -191,10 +304,17 @@ struct async_get_result_op : boost::asio::coroutine {
 
         reenter(*this) {
             while (is_busy(get_connection(ctx_))) {
-                yield get_connection(ctx_).async_wait_read(std::move(*this));
+                if (!input_ready()) {
+                    get_request_statistics(ctx_).waited();
+                    yield get_connection(ctx_).async_wait_read(std::move(*this));
+                }
+                if (result_size_exceeded()) {
+                    return done(error::result_too_large);
+                }
                 if (auto err = consume_input(get_connection(ctx_))) {
                     return done(err);
                 }
+                consumed_ = true;
             }
 
             result_ = get_result(get_connection(ctx_));
@@ -203,13 +323,24 @@ struct async_get_result_op : boost::asio::coroutine {
                 return done();
             }
 
+            get_request_statistics(ctx_).received(result_);
+            OZO_PROBE(result__received, get_native_handle(get_connection(ctx_)),
+                PQntuples(result_.get()), PQresultMemorySize(result_.get()));
+
             if (result_status(*result_) != PGRES_SINGLE_TUPLE) {
                 do {
                     while (is_busy(get_connection(ctx_))) {
-                        yield get_connection(ctx_).async_wait_read(std::move(*this));
+                        if (!input_ready()) {
+                            get_request_statistics(ctx_).waited();
+                            yield get_connection(ctx_).async_wait_read(std::move(*this));
+                        }
+                        if (result_size_exceeded()) {
+                            return done(error::result_too_large);
+                        }
                         if (consume_input(get_connection(ctx_))) {
                             return handle_result();
                         }
+                        consumed_ = true;
                     }
                 } while (get_result(get_connection(ctx_)));
             }
@@ -218,10 +349,74 @@ struct async_get_result_op : boost::asio::coroutine {
         }
     }
 
+    /**
+    * A large result arrives in many segments, and more of them are usually received
+    * while the previous ones are being consumed. So once the data has been consumed,
+    * the socket is checked for more data before the wait is armed again, and the data
+    * received is consumed at once without the round trip via the `io_context`.
+    */
+    bool input_ready() {
+        if (consumed_ && bytes_available(get_connection(ctx_))) {
+            return true;
+        }
+        return busy_polled();
+    }
+
+    /**
+    * Spins for the busy poll time of the connection until the data arrives on the socket,
+    * so a short query avoids the round trip via the `io_context`. Returns false if
+    * the data has not arrived, then the data should be waited for via the `io_context`.
+    */
+    bool busy_polled() {
+        using stream_type = std::decay_t<decltype(unwrap_connection(get_connection(ctx_)))>;
+        if constexpr (has_busy_poll<stream_type>::value) {
+            auto& conn = get_connection(ctx_);
+            const auto time = unwrap_connection(conn).busy_poll();
+            if (time <= time_traits::duration::zero()) {
+                return false;
+            }
+            const auto until = time_traits::now() + time;
+            do {
+                if (bytes_available(conn)) {
+                    return true;
+                }
+            } while (time_traits::now() < until);
+        }
+        return false;
+    }
+
+    /**
+    * Counts the data which is about to be read for the result against the limit
+    * of the connection. Once the limit is exceeded the query is cancelled on the
+    * server, so it stops producing the rest of the result.
+    */
+    bool result_size_exceeded() {
+        using stream_type = std::decay_t<decltype(unwrap_connection(get_connection(ctx_)))>;
+        if constexpr (has_max_result_size<stream_type>::value) {
+            auto& conn = get_connection(ctx_);
+            const auto limit = unwrap_connection(conn).max_result_size();
+            if (limit == 0) {
+                return false;
+            }
+            result_bytes_ += bytes_available(conn);
+            if (result_bytes_ <= limit) {
+                return false;
+            }
+            post_server_cancel{}(conn);
+            conn.set_error_context("result exceeds " + std::to_string(limit) + " bytes limit");
+            return true;
+        }
+        return false;
+    }
+
     void handle_result() {
+        get_request_statistics(ctx_).result_received();
         const auto status = result_status(*result_);
         switch (status) {
             case PGRES_SINGLE_TUPLE:
+#ifdef LIBPQ_HAS_CHUNK_MODE
+            case PGRES_TUPLES_CHUNK:
+#endif
             case PGRES_TUPLES_OK:
             case PGRES_COMMAND_OK:
                 process_and_done(std::move(result_));
@@ -239,6 +434,10 @@ struct async_get_result_op : boost::asio::coroutine {
             case PGRES_COPY_IN:
             case PGRES_COPY_BOTH:
             case PGRES_NONFATAL_ERROR:
+#ifdef LIBPQ_HAS_PIPELINING
+            case PGRES_PIPELINE_SYNC:
+            case PGRES_PIPELINE_ABORTED:
+#endif
                 break;
         }
 
@@ -249,7 +448,22 @@ struct async_get_result_op : boost::asio::coroutine {
     template <typename Result>
     void process_and_done(Result&& res) noexcept {
         try {
-            process_(std::forward<Result>(res), get_connection(ctx_));
+            if constexpr (is_async_result_processor<ResultProcessor>::value) {
+                return process_.async_process(std::forward<Result>(res), get_connection(ctx_),
+                    async_process_continuation{ctx_});
+            } else if constexpr (std::is_same_v<decltype(process_(std::forward<Result>(res), get_connection(ctx_))), error_code>) {
+                // The processor has set the error context already
+                const bool failed = [&] {
+                    const auto cpu_time = get_request_cpu_time(ctx_).measure_decoding();
+                    return bool(process_(std::forward<Result>(res), get_connection(ctx_)));
+                }();
+                if (failed) {
+                    return done(error::bad_result_process);
+                }
+            } else {
+                const auto cpu_time = get_request_cpu_time(ctx_).measure_decoding();
+                process_(std::forward<Result>(res), get_connection(ctx_));
+            }
         } catch (const std::exception& e) {
             get_connection(ctx_).set_error_context(e.what());
             return done(error::bad_result_process);
@@ -281,26 +495,643 @@ inline void async_get_result(Context&& ctx, ResultProcessor&& p) {
     op.perform();
 }
 
-template <typename OutHandler, typename Query, typename TimeConstraint, typename Handler>
+#ifdef LIBPQ_HAS_PIPELINING
+
+#include <boost/asio/yield.hpp>
+
+/**
+* Receives results of the pipelined queries in the order they have been sent.
+* libpq separates results of pipelined queries with a null result and finishes
+* the pipeline with the `PGRES_PIPELINE_SYNC` one. In case of a query error
+* the rest of queries is aborted by the server, the operation reads results
+* up to the synchronization point anyway to keep the connection usable and
+* completes with the first error occurred.
+*
+* The results processor should provide the `size()` member function which returns
+* the number of pipelined queries and a call operator with the
+* `void(std::size_t index, Result&& result, Connection& conn)` signature which is
+* called for each successful query result. The processor may provide the
+* `bool optional(std::size_t index)` member function, an error of an optional
+* query does not fail the operation unless a query which is not optional is
+* aborted by the server because of it.
+*/
+template <typename T, typename = std::void_t<>>
+struct has_optional_results : std::false_type {};
+
+template <typename T>
+struct has_optional_results<T, std::void_t<decltype(std::declval<const T&>().optional(std::size_t{}))>> : std::true_type {};
+
+template <typename Context, typename Processor>
+struct async_get_pipeline_results_op : boost::asio::coroutine {
+    Context ctx_;
+    Processor process_;
+    using result_type = std::decay_t<decltype(get_result(get_connection(ctx_)))>;
+    result_type result_;
+    std::size_t index_ = 0;
+    error_code error_;
+    error_code optional_error_;
+
+    async_get_pipeline_results_op(Context ctx, Processor process)
+    : ctx_(std::move(ctx)), process_(std::move(process)) {}
+
+    void perform() {
+        (*this)();
+    }
+
+    void done() {
+        return impl::done(ctx_);
+    }
+
+    void done(error_code ec) {
+        if (std::empty(get_error_context(get_connection(ctx_)))) {
+            get_connection(ctx_).set_error_context("error while get pipeline results");
+        }
+        return impl::done(ctx_, ec);
+    }
+
+    void operator() (error_code ec = error_code{}, std::size_t = 0) {
+        if (get_query_state(ctx_) == query_state::error) {
+            return;
+        }
+
+        if (ec) {
+            if (ec == asio::error::bad_descriptor) {
+                ec = asio::error::operation_aborted;
+            }
+            return done(ec);
+        }
+
+        reenter(*this) {
+            for (;;) {
+                while (is_busy(get_connection(ctx_))) {
+                    get_request_statistics(ctx_).waited();
+                    yield get_connection(ctx_).async_wait_read(std::move(*this));
+                    if (auto err = consume_input(get_connection(ctx_))) {
+                        return done(err);
+                    }
+                }
+
+                result_ = get_result(get_connection(ctx_));
+
+                if (!result_) {
+                    if (++index_ > process_.size()) {
+                        get_connection(ctx_).set_error_context("no pipeline synchronization result received");
+                        return done(error::result_status_unexpected);
+                    }
+                    continue;
+                }
+
+                if (result_status(*result_) == PGRES_PIPELINE_SYNC) {
+                    get_request_statistics(ctx_).result_received();
+                    break;
+                }
+
+                if (!handle_result()) {
+                    return;
+                }
+            }
+
+            if (auto err = exit_pipeline_mode(get_connection(ctx_))) {
+                return done(err);
+            }
+
+            if (error_) {
+                return done(error_);
+            }
+
+            done();
+        }
+    }
+
+    bool handle_result() {
+        const auto status = result_status(*result_);
+        switch (status) {
+            case PGRES_SINGLE_TUPLE:
+#ifdef LIBPQ_HAS_CHUNK_MODE
+            case PGRES_TUPLES_CHUNK:
+#endif
+            case PGRES_TUPLES_OK:
+            case PGRES_COMMAND_OK:
+                process();
+                return true;
+            case PGRES_PIPELINE_ABORTED:
+                if (!is_optional()) {
+                    set_error(optional_error_);
+                }
+                return true;
+            case PGRES_BAD_RESPONSE:
+                set_error(error::result_status_bad_response);
+                return true;
+            case PGRES_EMPTY_QUERY:
+                set_error(error::result_status_empty_query);
+                return true;
+            case PGRES_FATAL_ERROR:
+                if (!is_optional()) {
+                    set_error(result_error(*result_));
+                } else if (!optional_error_) {
+                    optional_error_ = result_error(*result_);
+                }
+                return true;
+            case PGRES_COPY_OUT:
+            case PGRES_COPY_IN:
+            case PGRES_COPY_BOTH:
+            case PGRES_NONFATAL_ERROR:
+            case PGRES_PIPELINE_SYNC:
+                break;
+        }
+
+        get_connection(ctx_).set_error_context(get_result_status_name(status));
+        done(error::result_status_unexpected);
+        return false;
+    }
+
+    bool is_optional() const noexcept {
+        if constexpr (has_optional_results<Processor>::value) {
+            return process_.optional(index_);
+        } else {
+            return false;
+        }
+    }
+
+    void set_error(error_code ec) {
+        if (!error_) {
+            error_ = std::move(ec);
+        }
+    }
+
+    void process() noexcept {
+        if (error_) {
+            return;
+        }
+        try {
+            if constexpr (std::is_same_v<decltype(process_(index_, std::move(result_), get_connection(ctx_))), error_code>) {
+                // The processor has set the error context already
+                if (process_(index_, std::move(result_), get_connection(ctx_))) {
+                    set_error(error::bad_result_process);
+                }
+            } else {
+                process_(index_, std::move(result_), get_connection(ctx_));
+            }
+        } catch (const std::exception& e) {
+            get_connection(ctx_).set_error_context(e.what());
+            set_error(error::bad_result_process);
+        }
+    }
+
+    using executor_type = std::decay_t<decltype(asio::get_associated_executor(get_handler(ctx_)))>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(get_handler(ctx_));
+    }
+
+    using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(get_handler(ctx_)))>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(get_handler(ctx_));
+    }
+};
+
+template <typename Context, typename Processor>
+async_get_pipeline_results_op(Context, Processor) -> async_get_pipeline_results_op<Context, Processor>;
+
+#include <boost/asio/unyield.hpp>
+
+template <typename Context, typename Processor>
+inline void async_get_pipeline_results(Context&& ctx, Processor&& p) {
+    async_get_pipeline_results_op op{std::forward<Context>(ctx), std::forward<Processor>(p)};
+    op.perform();
+}
+
+/**
+* Calls the result processor of a request, the errors of the processors which
+* report them via `error_code` are returned.
+*/
+template <typename OutHandler, typename Result, typename Connection>
+inline error_code call_out_handler(OutHandler& out, Result&& res, Connection& conn) {
+    if constexpr (std::is_same_v<decltype(out(std::forward<Result>(res), conn)), error_code>) {
+        return out(std::forward<Result>(res), conn);
+    } else {
+        out(std::forward<Result>(res), conn);
+        return {};
+    }
+}
+
+/**
+* Result processor which receives results via the column plans of a prepared
+* statement, see `ozo::detail::column_plan_cache`, should define the `column_plans_tag`
+* member type and provide the `describe()` member function with
+* `void(Result&& description, Connection& conn, column_plan_cache& plans)` signature
+* and the call operator with `error_code(Result&& result, Connection& conn, const column_plan_cache* plans)`
+* signature.
+*/
+template <typename T, typename = std::void_t<>>
+struct uses_column_plans : std::false_type {};
+
+template <typename T>
+struct uses_column_plans<T, std::void_t<typename T::column_plans_tag>> : std::true_type {};
+
+/**
+* Result processor of a statement from the cache of the connection.
+*/
+template <typename OutHandler>
+struct planned_out_handler {
+    OutHandler out;
+    const detail::column_plan_cache* plans;
+
+    template <typename Result, typename Connection>
+    error_code operator() (Result&& res, Connection& conn) {
+        return out(std::forward<Result>(res), conn, plans);
+    }
+};
+
+template <typename OutHandler>
+planned_out_handler(OutHandler, const detail::column_plan_cache*) -> planned_out_handler<OutHandler>;
+
+/**
+* Connection which counts the usage of its prepared statements should provide the
+* `hot_statements()` member function which returns a pointer to the counter, see
+* `ozo::connection_info::warm_statements()`.
+*/
+template <typename T, typename = std::void_t<>>
+struct has_hot_statements : std::false_type {};
+
+template <typename T>
+struct has_hot_statements<T, std::void_t<decltype(std::declval<const T&>().hot_statements())>> : std::true_type {};
+
+template <typename Connection>
+inline detail::hot_statements* get_hot_statements([[maybe_unused]] const Connection& conn) noexcept {
+    using stream_type = std::decay_t<decltype(unwrap_connection(conn))>;
+    if constexpr (has_hot_statements<stream_type>::value) {
+        return unwrap_connection(conn).hot_statements().get();
+    } else {
+        return nullptr;
+    }
+}
+
+/**
+* Results processor for a query which is executed via a statement prepared in
+* the same pipeline. Results of the prepare are checked for errors only, and
+* the deallocations of evicted statements are optional, so a failed one does
+* not prevent the prepared statement from being recorded. The statement is added
+* into the connection statements cache as soon as it has been prepared successfully.
+* The statement is described in the same pipeline for the processors which use
+* column plans, so the plans are made once per statement and connection.
+*/
+template <typename OutHandler>
+struct prepare_and_execute_results {
+    std::size_t deallocations;
+    std::string text;
+    std::string name;
+    const detail::statement_key* key;
+    std::shared_ptr<detail::statement_usage> usage;
+    OutHandler out;
+
+    static constexpr bool describe = uses_column_plans<OutHandler>::value;
+
+    std::size_t size() const noexcept { return deallocations + (describe ? 3 : 2);}
+
+    bool optional(std::size_t index) const noexcept { return index < deallocations;}
+
+    template <typename Result, typename Connection>
+    error_code operator() (std::size_t index, Result&& res, Connection& conn) {
+        if (index == deallocations) {
+            if (key) {
+                get_statement_cache(conn).emplace(key->id, text, std::move(name), std::move(usage));
+            } else {
+                get_statement_cache(conn).emplace(text, std::move(name), std::move(usage));
+            }
+        } else if (index > deallocations) {
+            if constexpr (describe) {
+                const auto plans = key ? get_statement_cache(conn).plans(key->id) : get_statement_cache(conn).plans(text);
+                if (index == deallocations + 1) {
+                    if (plans) {
+                        out.describe(std::forward<Result>(res), conn, *plans);
+                    }
+                    return {};
+                }
+                return out(std::forward<Result>(res), conn, plans);
+            } else {
+                return call_out_handler(out, std::forward<Result>(res), conn);
+            }
+        }
+        return {};
+    }
+};
+
+template <typename OutHandler>
+prepare_and_execute_results(std::size_t, std::string, std::string, const detail::statement_key*,
+        std::shared_ptr<detail::statement_usage>, OutHandler)
+    -> prepare_and_execute_results<OutHandler>;
+
+/**
+* Executes the query via the prepared statement of the connection, the statement is
+* prepared in the same pipeline if it is not cached. A statement with the key known
+* at compile time is found by the identifier and prepared with the name of the key.
+*/
+template <typename Context, typename OutHandler>
+inline void async_request_prepared(Context ctx, const binary_query& query, const detail::statement_key* key,
+        OutHandler&& out) {
+    decltype(auto) conn = get_connection(ctx);
+    if (auto ec = set_nonblocking(conn)) {
+        return done(ctx, ec);
+    }
+
+    auto& cache = get_statement_cache(conn);
+    if (const auto name = key ? cache.find(key->id, query.text()) : cache.find(query.text())) {
+        if (!send_query_prepared(conn, name->c_str(), query)) {
+            return done(ctx, error::pg_send_query_prepared_failed);
+        }
+        async_flush_output_op{ctx}();
+        if constexpr (uses_column_plans<std::decay_t<OutHandler>>::value) {
+            const auto plans = key ? cache.plans(key->id) : cache.plans(query.text());
+            return async_get_result(std::move(ctx), planned_out_handler{std::forward<OutHandler>(out), plans});
+        } else {
+            return async_get_result(std::move(ctx), std::forward<OutHandler>(out));
+        }
+    }
+
+    if (auto ec = enter_pipeline_mode(conn)) {
+        return done(ctx, ec);
+    }
+
+    auto evicted = cache.take_evicted();
+    // The names which have not been deallocated are deallocated by the next request
+    const auto fail = [&] (error_code ec) {
+        cache.return_evicted(std::move(evicted));
+        return done(ctx, ec);
+    };
+
+    for (const auto& name : evicted) {
+        if (!send_deallocate(conn, name)) {
+            return fail(error::pg_send_query_params_failed);
+        }
+    }
+
+    auto name = key ? std::string(key->name) : cache.make_name();
+    if (!send_prepare(conn, name.c_str(), query)) {
+        return fail(error::pg_send_prepare_failed);
+    }
+
+    std::shared_ptr<detail::statement_usage> usage;
+    if (const auto hot = get_hot_statements(conn)) {
+        usage = hot->prepared(query.text(), query.types(), query.params_count(), key);
+    }
+
+    if constexpr (uses_column_plans<std::decay_t<OutHandler>>::value) {
+        if (!send_describe_prepared(conn, name.c_str())) {
+            return fail(error::pg_send_describe_prepared_failed);
+        }
+    }
+
+    if (!send_query_prepared(conn, name.c_str(), query)) {
+        return fail(error::pg_send_query_prepared_failed);
+    }
+
+    if (auto ec = pipeline_sync(conn)) {
+        return fail(ec);
+    }
+
+    async_flush_output_op{ctx}();
+    async_get_pipeline_results(std::move(ctx), prepare_and_execute_results {
+        evicted.size(), std::string(query.text()), std::move(name), key, std::move(usage), std::forward<OutHandler>(out)
+    });
+}
+
+/**
+* Results processor for a query which is sent in the same pipeline right after
+* an auxiliary statement, e.g. the pending BEGIN statement of a transaction.
+* The result of the auxiliary statement is checked for errors only.
+*/
+template <typename OutHandler>
+struct begin_and_execute_results {
+    OutHandler out;
+
+    constexpr std::size_t size() const noexcept { return 2;}
+
+    template <typename Result, typename Connection>
+    error_code operator() (std::size_t index, Result&& res, Connection& conn) {
+        if (index > 0) {
+            return call_out_handler(out, std::forward<Result>(res), conn);
+        }
+        return {};
+    }
+};
+
+template <typename OutHandler>
+begin_and_execute_results(OutHandler) -> begin_and_execute_results<OutHandler>;
+
+/**
+* Sends the pending BEGIN statement of the transaction and the query in one
+* pipeline and receives the result of the query.
+*/
+template <typename Context, typename Begin, typename Query, typename OutHandler>
+inline void async_request_query_with_begin(Context ctx, const Begin& begin, const Query& query, OutHandler&& out) {
+    decltype(auto) conn = get_connection(ctx);
+    if (auto ec = set_nonblocking(conn)) {
+        return done(ctx, ec);
+    }
+
+    if (auto ec = enter_pipeline_mode(conn)) {
+        return done(ctx, ec);
+    }
+
+    const auto allocator = asio::get_associated_allocator(get_handler(ctx));
+    if (!send_query_params(conn, to_binary_query(begin, conn.oid_map(), allocator))) {
+        return done(ctx, error::pg_send_query_params_failed);
+    }
+
+    const auto q = [&] {
+        const auto cpu_time = get_request_cpu_time(ctx).measure_serialization();
+        return to_binary_query(query, conn.oid_map(), allocator);
+    }();
+    if (!send_query_params(conn, q)) {
+        return done(ctx, error::pg_send_query_params_failed);
+    }
+
+    get_request_statistics(ctx).sent(q.text(), q.lengths(), static_cast<std::size_t>(q.params_count()));
+
+    if (auto ec = pipeline_sync(conn)) {
+        return done(ctx, ec);
+    }
+
+    async_flush_output_op{ctx}();
+    async_get_pipeline_results(std::move(ctx), begin_and_execute_results{std::forward<OutHandler>(out)});
+}
+
+/**
+* Sends the statement which limits the execution time of the query on the server
+* and the query in one pipeline and receives the result of the query. The pipeline
+* is an implicit transaction, so the local setting is reset once it is completed.
+*/
+template <typename Context, typename Query, typename OutHandler>
+inline void async_request_query_with_timeout(Context ctx, std::chrono::milliseconds timeout,
+        const Query& query, OutHandler&& out) {
+    decltype(auto) conn = get_connection(ctx);
+    if (auto ec = set_nonblocking(conn)) {
+        return done(ctx, ec);
+    }
+
+    if (auto ec = enter_pipeline_mode(conn)) {
+        return done(ctx, ec);
+    }
+
+    const auto allocator = asio::get_associated_allocator(get_handler(ctx));
+    const auto set_timeout = make_query("SELECT set_config('statement_timeout', $1, true)",
+        std::to_string(timeout.count()));
+    if (!send_query_params(conn, to_binary_query(set_timeout, conn.oid_map(), allocator))) {
+        return done(ctx, error::pg_send_query_params_failed);
+    }
+
+    const auto q = [&] {
+        const auto cpu_time = get_request_cpu_time(ctx).measure_serialization();
+        return to_binary_query(query, conn.oid_map(), allocator);
+    }();
+    if (!send_query_params(conn, q)) {
+        return done(ctx, error::pg_send_query_params_failed);
+    }
+
+    get_request_statistics(ctx).sent(q.text(), q.lengths(), static_cast<std::size_t>(q.params_count()));
+
+    if (auto ec = pipeline_sync(conn)) {
+        return done(ctx, ec);
+    }
+
+    async_flush_output_op{ctx}();
+    async_get_pipeline_results(std::move(ctx), begin_and_execute_results{std::forward<OutHandler>(out)});
+}
+
+#endif
+
+template <typename T, typename = std::void_t<>>
+struct has_pending_begin : std::false_type {};
+
+template <typename T>
+struct has_pending_begin<T, std::void_t<decltype(std::declval<const T&>().is_begin_pending())>> : std::true_type {};
+
+/**
+* Operation which sends the pending BEGIN statement of a transaction by itself
+* should define the `pending_begin_tag` member type, otherwise the statement is
+* sent by `ozo::async_get_connection()` before the transaction is provided for
+* the operation.
+*/
+template <typename T, typename = std::void_t<>>
+struct sends_pending_begin : std::false_type {};
+
+template <typename T>
+struct sends_pending_begin<T, std::void_t<typename T::pending_begin_tag>> : std::true_type {};
+
+/**
+* Connection which may send the cancel request to the server on the time constraint
+* expiration should provide the `cancel_on_timeout()` member function which returns
+* the grace period for the operation to complete after the request.
+*/
+template <typename T, typename = std::void_t<>>
+struct has_cancel_on_timeout : std::false_type {};
+
+template <typename T>
+struct has_cancel_on_timeout<T, std::void_t<decltype(std::declval<const T&>().cancel_on_timeout())>> : std::true_type {};
+
+/**
+* Connection which may propagate the time constraint of a request to the server
+* should provide the `propagate_deadline()` member function which returns true
+* if the remaining time should be sent as the `statement_timeout` of the query.
+*/
+template <typename T, typename = std::void_t<>>
+struct has_propagate_deadline : std::false_type {};
+
+template <typename T>
+struct has_propagate_deadline<T, std::void_t<decltype(std::declval<const T&>().propagate_deadline())>> : std::true_type {};
+
+/**
+* Returns the remaining time of the deadline to be used as the `statement_timeout`
+* of a query if the connection propagates deadlines. The timeout is not set for
+* a connection within a transaction since the setting would outlive the query.
+*/
+template <typename Connection>
+inline std::optional<std::chrono::milliseconds> get_deadline_statement_timeout(
+        [[maybe_unused]] const Connection& conn, [[maybe_unused]] time_traits::time_point deadline) {
+    using stream_type = std::decay_t<decltype(unwrap_connection(conn))>;
+    if constexpr (has_propagate_deadline<stream_type>::value) {
+        if (unwrap_connection(conn).propagate_deadline()
+                && get_transaction_status(conn) == transaction_status::idle) {
+            const auto left = time_left(deadline);
+            if (left > time_traits::duration::zero()) {
+                return std::chrono::ceil<std::chrono::milliseconds>(left);
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+/**
+* Applies the deadline of the operation to IO on the connection. IO is also cancelled
+* by the cancellation slot associated with the handler, e.g. by `asio::experimental::parallel_group`,
+* if Asio supports per-operation cancellation.
+*/
+template <typename Connection, typename TimeConstraint, typename Handler>
+inline auto apply_io_deadline([[maybe_unused]] Connection& conn, [[maybe_unused]] TimeConstraint t, Handler&& handler) {
+    using stream_type = std::decay_t<decltype(unwrap_connection(conn))>;
+    auto cancellable = detail::bind_io_cancellation(unwrap_connection(conn), std::forward<Handler>(handler));
+    using handler_type = decltype(cancellable);
+    if constexpr (IsNone<TimeConstraint>) {
+        return cancellable;
+    } else if constexpr (has_cancel_on_timeout<stream_type>::value) {
+        return detail::io_deadline_handler<stream_type, handler_type, Connection, post_server_cancel> {
+            unwrap_connection(conn), t, std::move(cancellable),
+            post_server_cancel{}, unwrap_connection(conn).cancel_on_timeout()
+        };
+    } else {
+        return detail::io_deadline_handler<stream_type, handler_type, Connection> {
+            unwrap_connection(conn), t, std::move(cancellable)
+        };
+    }
+}
+
+/**
+* Sends the query and receives its result. Queries marked with `ozo::prepared()`
+* are executed via the prepared statements of the connection if libpq supports
+* pipeline mode, and as usual queries otherwise.
+*/
+template <typename Context, typename Query, typename OutHandler>
+inline void async_request_query(Context ctx, Query&& query, OutHandler&& out) {
+#ifdef LIBPQ_HAS_PIPELINING
+    if constexpr (PreparedQuery<Query>) {
+        const auto q = [&] {
+            const auto cpu_time = get_request_cpu_time(ctx).measure_serialization();
+            return to_binary_query(query, get_connection(ctx).oid_map(),
+                    asio::get_associated_allocator(get_handler(ctx)));
+        }();
+        async_request_prepared(std::move(ctx), q, query.statement, std::forward<OutHandler>(out));
+    } else
+#endif
+    {
+        async_send_query_params(ctx, std::forward<Query>(query));
+        async_get_result(std::move(ctx), std::forward<OutHandler>(out));
+    }
+}
+
+template <typename OutHandler, typename Query, typename TimeConstraint, typename Handler, typename Start>
+struct reprepare_statement_handler;
+
+template <typename T>
+struct is_reprepare_statement_handler : std::false_type {};
+
+template <typename OutHandler, typename Query, typename TimeConstraint, typename Handler, typename Start>
+struct is_reprepare_statement_handler<reprepare_statement_handler<OutHandler, Query, TimeConstraint, Handler, Start>>
+    : std::true_type {};
+
+template <typename OutHandler, typename Query, typename TimeConstraint, typename Handler, typename Start = none_t>
 struct async_request_op {
     OutHandler out_;
     Query query_;
     TimeConstraint time_constraint_;
     Handler handler_;
+    Start start_;
+    bool reprepare_ = true;
 
-    async_request_op(Query query, TimeConstraint time_constrain, OutHandler out, Handler handler)
-    : out_(std::move(out)), query_(std::move(query)), time_constraint_(time_constrain), handler_(std::move(handler)) {}
-
-    template <typename Connection, typename SourceHandler>
-    auto apply_time_constaint_or_strand (Connection& conn, SourceHandler&& handler) const {
-        if constexpr (IsNone<TimeConstraint>) {
-            return std::forward<SourceHandler>(handler);
-        } else {
-            return detail::io_deadline_handler<std::decay_t<decltype(unwrap_connection(conn))>, std::decay_t<SourceHandler>, Connection> {
-                unwrap_connection(conn), time_constraint_, std::forward<SourceHandler>(handler)
-            };
-        }
-    }
+    async_request_op(Query query, TimeConstraint time_constrain, OutHandler out, Handler handler, Start start = Start{})
+    : out_(std::move(out)), query_(std::move(query)), time_constraint_(time_constrain), handler_(std::move(handler)),
+      start_(start) {}
 
     template <typename Connection>
     void operator() (error_code ec, Connection conn) {
@@ -308,17 +1139,68 @@ struct async_request_op {
             return handler_(ec, std::move(conn));
         }
 
-        auto handler = apply_time_constaint_or_strand(conn, detail::wrap_executor {
-            detail::make_strand_executor(ozo::get_executor(conn)),
+        using stream_type = std::decay_t<decltype(unwrap_connection(conn))>;
+        using oid_map_type = std::decay_t<decltype(unwrap_connection(conn).oid_map())>;
+        // The request of the oids uses built-in types only
+        if constexpr (has_lazy_oid_map<stream_type>::value && has_custom_types<oid_map_type>::value
+                && !is_resolve_pending_types_op<Handler>::value) {
+            if (unwrap_connection(conn).lazy_oid_map()) {
+                auto names = get_pending_types(unwrap_connection(conn).oid_map(), query_, out_);
+                if (!names.empty()) {
+                    return resolve_pending_types(std::move(conn), std::move(names), time_constraint_, std::move(*this));
+                }
+            }
+        }
+
+#ifdef LIBPQ_HAS_PIPELINING
+        if constexpr (PreparedQuery<Query> && std::is_copy_constructible_v<OutHandler>
+                && !is_reprepare_statement_handler<Handler>::value) {
+            if (reprepare_) {
+                const auto t = ozo::deadline(time_constraint_);
+                reprepare_statement_handler<OutHandler, Query, std::decay_t<decltype(t)>, Handler, Start> handler {
+                    out_, query_, t, std::move(handler_), start_
+                };
+                async_request_op<OutHandler, Query, std::decay_t<decltype(t)>, decltype(handler), Start> op {
+                    std::move(query_), t, std::move(out_), std::move(handler), start_
+                };
+                return op(std::move(ec), std::move(conn));
+            }
+        }
+#endif
+
+        const auto cpu_time_observer = detail::get_request_cpu_time_observer(handler_);
+        auto handler = apply_io_deadline(conn, time_constraint_, detail::wrap_executor {
+            detail::make_connection_executor(conn),
             std::move(handler_)
         });
 
         auto ctx = make_request_operation_context(std::move(conn), std::move(handler));
-
-        async_send_query_params(ctx, std::move(query_));
-        async_get_result(std::move(ctx), std::move(out_));
+        get_request_statistics(ctx).requested(start_);
+        get_request_cpu_time(ctx).set_cpu_time_observer(cpu_time_observer);
+        OZO_PROBE(request__start, get_native_handle(get_connection(ctx)));
+
+#ifdef LIBPQ_HAS_PIPELINING
+        if constexpr (has_pending_begin<Connection>::value) {
+            if (ctx->conn.is_begin_elidable()) {
+                ctx->conn.elide_begin();
+            } else if (ctx->conn.is_begin_pending()) {
+                const auto begin = ctx->conn.begin_statement();
+                return async_request_query_with_begin(std::move(ctx), begin, query_, std::move(out_));
+            }
+        }
+        // The results of the pipeline are processed synchronously, so an asynchronous result
+        // processor gets the client side deadline only
+        if constexpr (!IsNone<TimeConstraint> && !PreparedQuery<Query> && !is_async_result_processor<OutHandler>::value) {
+            if (const auto timeout = get_deadline_statement_timeout(ctx->conn, ozo::deadline(time_constraint_))) {
+                return async_request_query_with_timeout(std::move(ctx), *timeout, query_, std::move(out_));
+            }
+        }
+#endif
+        async_request_query(std::move(ctx), std::move(query_), std::move(out_));
     }
 
+    using pending_begin_tag = void;
+
     using executor_type = std::decay_t<decltype(asio::get_associated_executor(handler_))>;
 
     executor_type get_executor() const noexcept {
@@ -330,27 +1212,131 @@ struct async_request_op {
     allocator_type get_allocator() const noexcept {
         return asio::get_associated_allocator(handler_);
     }
+
+    OZO_FORWARD_CANCELLATION_SLOT(handler_)
 };
 
 template <typename OutHandler, typename Query, typename TimeConstraint, typename Handler>
 async_request_op(Query, TimeConstraint, OutHandler, Handler) -> async_request_op<OutHandler, Query, TimeConstraint, Handler>;
 
+template <typename OutHandler, typename Query, typename TimeConstraint, typename Handler, typename Start>
+async_request_op(Query, TimeConstraint, OutHandler, Handler, Start) -> async_request_op<OutHandler, Query, TimeConstraint, Handler, Start>;
+
+/**
+* Checks if the request has failed because the server does not know the prepared statement
+* of the connection statements cache, e.g. a connection pooler in the transaction pooling mode,
+* like PgBouncer, has switched the session to another server connection. The statement is
+* reported as unknown before the query is executed, so the request may be repeated if the
+* connection is not within a transaction.
+*/
+template <typename Connection>
+inline bool is_prepared_statement_lost(const error_code& ec, const Connection& conn) {
+    return ec == sqlstate::invalid_sql_statement_name && !connection_bad(conn)
+        && get_transaction_status(conn) == transaction_status::idle;
+}
+
+/**
+* Handler of a request of a prepared query which repeats the request once if the prepared
+* statement has been lost on the server. The statements cache of the connection is cleared
+* since the other statements are most likely lost too, so the statement is prepared again
+* in the same pipeline with the query. The repeated request keeps the deadline of the first one.
+*/
+template <typename OutHandler, typename Query, typename TimeConstraint, typename Handler, typename Start>
+struct reprepare_statement_handler {
+    OutHandler out_;
+    Query query_;
+    TimeConstraint time_constraint_;
+    Handler handler_;
+    Start start_;
+
+    template <typename Connection>
+    void operator() (error_code ec, Connection&& conn) {
+        if (!is_prepared_statement_lost(ec, conn)) {
+            return handler_(std::move(ec), std::forward<Connection>(conn));
+        }
+        get_statement_cache(conn).clear();
+        async_request_op<OutHandler, Query, TimeConstraint, Handler, Start> op {
+            std::move(query_), time_constraint_, std::move(out_), std::move(handler_), start_
+        };
+        op.reprepare_ = false;
+        op(error_code{}, std::forward<Connection>(conn));
+    }
+
+    ozo::request_cpu_time_observer request_cpu_time_observer() const noexcept {
+        return detail::get_request_cpu_time_observer(handler_);
+    }
+
+    using executor_type = std::decay_t<decltype(asio::get_associated_executor(handler_))>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(handler_);
+    }
+
+    using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(handler_))>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(handler_);
+    }
+};
+
+/**
+* Captures the operation start time for the connection of the provider if the
+* connection observes the requests timeline.
+*/
+template <typename P>
+inline auto make_request_start_point() noexcept {
+    using connection = std::decay_t<decltype(unwrap_connection(std::declval<connection_type<P>&>()))>;
+    return detail::request_start_point<connection>{};
+}
+
+/**
+* Receives a result into the output. Malformed data is reported via the returned
+* error code and the connection error context instead of an exception, see
+* `ozo::try_recv_result()`.
+*/
 template <typename T>
 struct async_request_out_handler {
+    using column_plans_tag = void;
+    using out_type = T;
+
     T out;
 
     async_request_out_handler(T out) : out(std::move(out)) {}
 
     template <typename Handle, typename Conn>
-    void operator() (Handle&& h, Conn& conn) {
+    error_code operator() (Handle&& h, Conn& conn, const detail::column_plan_cache* plans = nullptr) {
         auto res = ozo::make_result(std::forward<Handle>(h));
-        ozo::recv_result(res, ozo::unwrap_connection(conn).oid_map(), out);
+        std::string context;
+        const auto ec = detail::try_recv_result_code(res, ozo::unwrap_connection(conn).oid_map(), out, context, plans);
+        if (ec) {
+            ozo::unwrap_connection(conn).set_error_context(std::move(context));
+        }
+        return ec;
+    }
+
+    template <typename Handle, typename Conn>
+    void describe(Handle&& h, Conn& conn, detail::column_plan_cache& plans) {
+        const auto res = ozo::make_result(std::forward<Handle>(h));
+        detail::describe_result(res, ozo::unwrap_connection(conn).oid_map(), out, plans);
     }
 };
 
 template <typename T>
 async_request_out_handler(T) -> async_request_out_handler<T>;
 
+/**
+* Makes the request result processor for an output. Outputs which are result
+* processors already, e.g. the asynchronous ones, are used as is.
+*/
+template <typename Out>
+inline auto make_request_out_handler(Out&& out) {
+    if constexpr (is_async_result_processor<std::decay_t<Out>>::value) {
+        return std::forward<Out>(out);
+    } else {
+        return async_request_out_handler{std::forward<Out>(out)};
+    }
+}
+
 template <typename P, typename Q, typename TimeConstraint, typename Out, typename Handler>
 inline void async_request(P&& provider, Q&& query, TimeConstraint t, Out&& out, Handler&& handler) {
     static_assert(ConnectionProvider<P>, "is not a ConnectionProvider");
@@ -360,8 +1346,9 @@ inline void async_request(P&& provider, Q&& query, TimeConstraint t, Out&& out,
         async_request_op{
             std::forward<Q>(query),
             deadline(t),
-            async_request_out_handler{std::forward<Out>(out)},
-            std::forward<Handler>(handler)
+            make_request_out_handler(std::forward<Out>(out)),
+            std::forward<Handler>(handler),
+            make_request_start_point<P>()
         }
     );
 }
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <ozo/impl/async_connect.h>
+#include <ozo/impl/connection_params.h>
+#include <ozo/detail/dns_cache.h>
+
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace ozo::impl {
+
+/**
+* Returns the host name which should be resolved before the connect. There is
+* nothing to resolve if `hostaddr` is specified, if the host is a Unix-domain socket
+* directory or if there are multiple hosts which libpq tries one by one.
+*/
+inline std::optional<std::string> get_resolvable_host(const connection_params& params) {
+    const auto host = params.find("host");
+    if (!host || host->empty() || host->front() == '/' || host->front() == '@'
+            || host->find(',') != std::string::npos) {
+        return std::nullopt;
+    }
+    if (const auto hostaddr = params.find("hostaddr"); hostaddr && !hostaddr->empty()) {
+        return std::nullopt;
+    }
+    return *host;
+}
+
+/**
+* Sets `hostaddr` to the resolved addresses, so libpq does not resolve the host
+* itself and tries the addresses one by one. The host name is kept for each address
+* since it is used for the authentication and the SSL certificate verification.
+*/
+inline void apply_resolved_addresses(connection_params& params, const std::vector<std::string>& addresses) {
+    const std::string host = *params.find("host");
+    std::string hosts;
+    std::string hostaddrs;
+    for (const auto& address : addresses) {
+        if (!hosts.empty()) {
+            hosts += ',';
+            hostaddrs += ',';
+        }
+        hosts += host;
+        hostaddrs += address;
+    }
+    params.set("host", std::move(hosts));
+    params.set("hostaddr", std::move(hostaddrs));
+}
+
+/**
+* Resolves the host asynchronously with `asio::ip::tcp::resolver`, stores the addresses
+* into the cache and connects with them. The time constraint includes the resolve time,
+* the resolve is cancelled on its expiration.
+*/
+template <typename Connection, typename Deadline, typename Handler, typename OidMapCache>
+class resolve_connect : public std::enable_shared_from_this<resolve_connect<Connection, Deadline, Handler, OidMapCache>> {
+public:
+    resolve_connect(connection_params params, std::string host, std::shared_ptr<detail::dns_cache> dns,
+            Deadline deadline, Connection conn, Handler handler, OidMapCache cache)
+    : params_(std::move(params)), host_(std::move(host)), dns_(std::move(dns)), deadline_(deadline),
+      conn_(std::move(conn)), handler_(std::move(handler)), cache_(std::move(cache)),
+      executor_(detail::make_connection_executor(conn_)),
+      resolver_(get_executor(conn_)), timer_(get_executor(conn_)) {}
+
+    void start() {
+        asio::dispatch(executor_, [self = this->shared_from_this()] {
+            if constexpr (!IsNone<Deadline>) {
+                self->timer_.expires_at(self->deadline_);
+                self->timer_.async_wait(asio::bind_executor(self->executor_,
+                    [self] (error_code ec) { self->on_deadline(ec); }));
+            }
+            self->resolver_.async_resolve(self->host_, "", asio::bind_executor(self->executor_,
+                [self] (error_code ec, asio::ip::tcp::resolver::results_type results) {
+                    self->on_resolve(std::move(ec), std::move(results));
+                }));
+        });
+    }
+
+private:
+    void on_deadline(error_code ec) {
+        if (ec || resolved_) {
+            return;
+        }
+        timed_out_ = true;
+        resolver_.cancel();
+    }
+
+    void on_resolve(error_code ec, const asio::ip::tcp::resolver::results_type& results) {
+        resolved_ = true;
+        timer_.cancel();
+
+        if (timed_out_) {
+            ec = asio::error::timed_out;
+        } else if (!ec && results.empty()) {
+            ec = asio::error::host_not_found;
+        }
+
+        if (ec) {
+            unwrap_connection(conn_).set_error_context("error while resolving host " + host_);
+            auto handler = apply_oid_map_request<Connection>(
+                apply_time_constaint(deadline_, conn_, std::move(handler_)),
+                std::move(cache_)
+            );
+            return handler(std::move(ec), std::move(conn_));
+        }
+
+        std::vector<std::string> addresses;
+        for (const auto& entry : results) {
+            auto address = entry.endpoint().address().to_string();
+            if (std::find(addresses.begin(), addresses.end(), address) == addresses.end()) {
+                addresses.push_back(std::move(address));
+            }
+        }
+
+        apply_resolved_addresses(params_, addresses);
+        dns_->insert(std::move(host_), std::move(addresses), time_traits::now());
+
+        async_connect(params_, deadline_, std::move(conn_), std::move(handler_), std::move(cache_));
+    }
+
+    using executor_type = decltype(detail::make_connection_executor(std::declval<Connection&>()));
+
+    connection_params params_;
+    std::string host_;
+    std::shared_ptr<detail::dns_cache> dns_;
+    Deadline deadline_;
+    Connection conn_;
+    Handler handler_;
+    OidMapCache cache_;
+    executor_type executor_;
+    asio::ip::tcp::resolver resolver_;
+    asio::steady_timer timer_;
+    bool resolved_ = false;
+    bool timed_out_ = false;
+};
+
+/**
+* Connects with the pre-parsed connection parameters. The host is resolved
+* asynchronously unless its addresses are in the cache already, so the io thread
+* never blocks on DNS inside libpq.
+*/
+template <typename Connection, typename TimeConstraint, typename Handler, typename OidMapCache = none_t>
+inline void async_resolve_connect(const connection_params& params, std::shared_ptr<detail::dns_cache> dns,
+        const TimeConstraint& t, Connection&& conn, Handler&& handler, OidMapCache cache = OidMapCache{}) {
+    static_assert(ozo::Connection<Connection>, "conn should model Connection concept");
+
+    auto host = get_resolvable_host(params);
+    if (!host) {
+        return async_connect(params, t, std::forward<Connection>(conn), std::forward<Handler>(handler), std::move(cache));
+    }
+
+    if (auto addresses = dns->find(*host, time_traits::now())) {
+        auto resolved = params;
+        apply_resolved_addresses(resolved, *addresses);
+        return async_connect(resolved, t, std::forward<Connection>(conn), std::forward<Handler>(handler), std::move(cache));
+    }
+
+    using connection_type = std::decay_t<Connection>;
+    using deadline_type = std::decay_t<decltype(ozo::deadline(t))>;
+    using operation_type = resolve_connect<connection_type, deadline_type, std::decay_t<Handler>, OidMapCache>;
+
+    auto allocator = asio::get_associated_allocator(handler);
+    std::allocate_shared<operation_type>(allocator, params, std::move(*host), std::move(dns), ozo::deadline(t),
+        std::forward<Connection>(conn), std::forward<Handler>(handler), std::move(cache))->start();
+}
+
+} // namespace ozo::impl
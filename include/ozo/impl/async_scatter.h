@@ -0,0 +1,209 @@
+#pragma once
+
+#include <ozo/impl/async_request.h>
+#include <ozo/detail/bind.h>
+
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/post.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <vector>
+
+namespace ozo::impl {
+
+/**
+* Scatter output which appends the shard results into the container in the order
+* of the shards.
+*/
+template <typename Container>
+struct scatter_gather_out {
+    using container_type = Container;
+
+    std::reference_wrapper<Container> rows;
+
+    void gather(std::vector<Container>& parts) const {
+        auto& out = rows.get();
+        for (auto& part : parts) {
+            out.insert(std::end(out), std::make_move_iterator(std::begin(part)),
+                std::make_move_iterator(std::end(part)));
+        }
+    }
+};
+
+/**
+* Scatter output which merges the shard results ordered by the comparator into the
+* container, so the container is ordered as well. Each step takes the least head
+* of the shard results, so the merge takes O(n log k) for k shards.
+*/
+template <typename Container, typename Compare>
+struct scatter_merge_out {
+    using container_type = Container;
+
+    std::reference_wrapper<Container> rows;
+    Compare compare;
+
+    void gather(std::vector<Container>& parts) const {
+        using iterator = decltype(std::begin(parts.front()));
+        struct head {
+            iterator first;
+            iterator last;
+        };
+        const auto greater = [&] (const head& lhs, const head& rhs) {
+            return compare(*rhs.first, *lhs.first);
+        };
+        std::priority_queue<head, std::vector<head>, decltype(greater)> heads(greater);
+        for (auto& part : parts) {
+            if (std::begin(part) != std::end(part)) {
+                heads.push(head{std::begin(part), std::end(part)});
+            }
+        }
+        auto& out = rows.get();
+        while (!heads.empty()) {
+            auto h = heads.top();
+            heads.pop();
+            out.insert(std::end(out), std::move(*h.first));
+            if (++h.first != h.last) {
+                heads.push(h);
+            }
+        }
+    }
+};
+
+/**
+* Shared state of a scatter request. Each shard receives its result into its own
+* part, so the shards do not synchronize while receiving; the parts are gathered
+* into the output once the last shard completes.
+*/
+template <typename Out, typename Handler>
+class scatter_state {
+public:
+    using container_type = typename Out::container_type;
+
+    scatter_state(Out out, std::size_t shards, Handler handler)
+    : out_(std::move(out)), parts_(shards), statuses_(shards), remaining_(shards),
+      handler_(std::move(handler)) {}
+
+    container_type& part(std::size_t shard) { return parts_[shard];}
+
+    /**
+     * Records the shard status, the last shard completes the request.
+     */
+    void complete(std::size_t shard, error_code ec) {
+        {
+            const std::lock_guard lock(mutex_);
+            statuses_[shard] = std::move(ec);
+            if (--remaining_) {
+                return;
+            }
+        }
+        finish(false);
+    }
+
+    /**
+     * Completes the request without shards, the handler is not called in place.
+     */
+    void complete_empty() {
+        finish(true);
+    }
+
+private:
+    void finish(bool deferred) {
+        error_code ec;
+        try {
+            out_.gather(parts_);
+        } catch (const std::exception&) {
+            ec = error::bad_result_process;
+        }
+        if (!ec) {
+            ec = scatter_error(statuses_);
+        }
+        auto ex = asio::get_associated_executor(handler_);
+        auto h = detail::bind(std::move(handler_), std::move(ec), std::move(statuses_));
+        if (deferred) {
+            asio::post(ex, std::move(h));
+        } else {
+            asio::dispatch(ex, std::move(h));
+        }
+    }
+
+    /**
+     * No error if all the shards succeeded, `ozo::error::partial_result` if some of them
+     * succeeded, the error of the first shard if none of them did.
+     */
+    static error_code scatter_error(const std::vector<error_code>& statuses) {
+        const auto failed = std::find_if(statuses.begin(), statuses.end(),
+            [] (const auto& ec) { return static_cast<bool>(ec); });
+        if (failed == statuses.end()) {
+            return {};
+        }
+        const auto succeeded = std::any_of(statuses.begin(), statuses.end(),
+            [] (const auto& ec) { return !ec; });
+        return succeeded ? error_code{error::partial_result} : *failed;
+    }
+
+    std::mutex mutex_;
+    Out out_;
+    std::vector<container_type> parts_;
+    std::vector<error_code> statuses_;
+    std::size_t remaining_;
+    Handler handler_;
+};
+
+template <typename State>
+struct scatter_shard_handler {
+    std::shared_ptr<State> state_;
+    std::size_t shard_;
+
+    template <typename Connection>
+    void operator() (error_code ec, Connection&&) {
+        state_->complete(shard_, std::move(ec));
+    }
+};
+
+/**
+* Converts the query into `ozo::binary_query` once for all the shards if the connections
+* use no custom types, otherwise the type OIDs may differ between the shards, so each
+* shard converts the query with the OID map of its connection.
+*/
+template <typename P, typename Query, typename Allocator>
+inline auto make_scatter_query(Query&& query, const Allocator& allocator) {
+    using connection = std::decay_t<decltype(unwrap_connection(std::declval<connection_type<P>&>()))>;
+    using oid_map_type = std::decay_t<decltype(std::declval<const connection&>().oid_map())>;
+    if constexpr (std::is_same_v<oid_map_type, empty_oid_map>) {
+        return to_binary_query(query, empty_oid_map{}, allocator);
+    } else {
+        return std::decay_t<Query>(std::forward<Query>(query));
+    }
+}
+
+template <typename Providers, typename Q, typename TimeConstraint, typename Out, typename Handler>
+inline void async_scatter(Providers&& providers, Q&& query, TimeConstraint t, Out out, Handler&& handler) {
+    using provider_type = std::decay_t<decltype(*std::begin(providers))>;
+    static_assert(ConnectionProvider<provider_type>, "providers should be a range of ConnectionProvider");
+    static_assert(BinaryQueryConvertible<Q>, "query should be convertible to the binary_query");
+    static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+
+    using state_type = scatter_state<Out, std::decay_t<Handler>>;
+    const auto allocator = asio::get_associated_allocator(handler);
+    const auto shards = static_cast<std::size_t>(std::distance(std::begin(providers), std::end(providers)));
+    auto state = std::allocate_shared<state_type>(allocator, std::move(out), shards, std::forward<Handler>(handler));
+
+    if (shards == 0) {
+        return state->complete_empty();
+    }
+
+    const auto binary_query = make_scatter_query<provider_type>(std::forward<Q>(query), allocator);
+    std::size_t shard = 0;
+    for (auto&& provider : providers) {
+        async_request(provider, binary_query, t, std::back_inserter(state->part(shard)),
+            scatter_shard_handler<state_type>{state, shard});
+        ++shard;
+    }
+}
+
+} // namespace ozo::impl
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <ozo/impl/request_oid_map.h>
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ozo::impl {
+
+/**
+* Connection which executes the session setup statements on connect should provide
+* the `session_setup()` member function which returns a pointer to the statements.
+*/
+template <typename T, typename = std::void_t<>>
+struct has_session_setup : std::false_type {};
+
+template <typename T>
+struct has_session_setup<T, std::void_t<decltype(std::declval<const T&>().session_setup())>> : std::true_type {};
+
+/**
+* Returns the session setup statements of the connection, if any.
+*/
+template <typename Connection>
+inline const std::vector<std::string>* get_session_setup([[maybe_unused]] const Connection& conn) noexcept {
+    if constexpr (has_session_setup<Connection>::value) {
+        return conn.session_setup().get();
+    } else {
+        return nullptr;
+    }
+}
+
+/**
+* Returns the statements to be prepared by the established connection, see
+* `ozo::connection_info::warm_statements()`.
+*/
+template <typename Connection>
+inline std::vector<std::shared_ptr<const detail::warm_statement>> get_warm_statements(const Connection& conn) {
+    if (const auto hot = get_hot_statements(conn)) {
+        return hot->top();
+    }
+    return {};
+}
+
+#ifdef LIBPQ_HAS_PIPELINING
+
+/**
+* Statement prepared by the session setup pipeline with its name.
+*/
+struct warm_statement_prepare {
+    std::shared_ptr<const detail::warm_statement> statement;
+    std::string name;
+};
+
+/**
+* Results processor of the session setup pipeline. The results of the setup
+* statements are checked for errors only, the result of the oids query which
+* follows them, if requested, is received into the oids. The warm statements
+* prepared last are added into the connection statements cache, their errors are
+* tolerated since a statement may be not valid anymore, e.g. its table is dropped.
+*/
+struct session_setup_results {
+    std::size_t statements_count;
+    oids_result* oids;
+    std::vector<warm_statement_prepare>* warm;
+
+    std::size_t warm_begin() const noexcept { return statements_count + (oids != nullptr);}
+
+    std::size_t size() const noexcept { return warm_begin() + warm->size();}
+
+    bool optional(std::size_t index) const noexcept { return index >= warm_begin();}
+
+    template <typename Result, typename Connection>
+    void operator() (std::size_t index, Result&& res, Connection& conn) {
+        if (oids && index == statements_count) {
+            auto result = ozo::make_result(std::forward<Result>(res));
+            ozo::recv_result(result, unwrap_connection(conn).oid_map(), std::back_inserter(*oids));
+        } else if (index >= warm_begin()) {
+            auto& [statement, name] = (*warm)[index - warm_begin()];
+            if (statement->id) {
+                get_statement_cache(conn).emplace(*statement->id, statement->text, std::move(name), statement->usage);
+            } else {
+                get_statement_cache(conn).emplace(statement->text, std::move(name), statement->usage);
+            }
+        }
+    }
+};
+
+/**
+* Sends the session setup statements of an established connection, the oids
+* query, if requested, and the warm statements prepares in one pipeline, then
+* sets the oid map from the result.
+*/
+template <typename Handler>
+struct async_session_setup_op {
+    struct context {
+        Handler handler_;
+        bool request_oids_;
+        oids_result res_;
+        std::vector<warm_statement_prepare> warm_;
+        context(Handler&& handler, bool request_oids)
+        : handler_(std::move(handler)), request_oids_(request_oids) {}
+    };
+
+    std::shared_ptr<context> ctx_;
+
+    template <typename Connection>
+    async_session_setup_op(Connection& conn, bool request_oids, Handler handler) {
+        auto allocator = detail::get_operation_allocator(conn, handler);
+        ctx_ = std::allocate_shared<context>(allocator, std::move(handler), request_oids);
+    }
+
+    template <typename Connection>
+    void perform(Connection&& conn) {
+        const auto statements = get_session_setup(ozo::unwrap_connection(conn));
+        const auto self = ctx_;
+        for (auto& statement : get_warm_statements(conn)) {
+            self->warm_.push_back({std::move(statement), std::string()});
+        }
+        auto ctx = make_request_operation_context(std::forward<Connection>(conn), detail::wrap_executor {
+            detail::make_connection_executor(conn), std::move(*this)
+        });
+
+        decltype(auto) connection = get_connection(ctx);
+        if (auto ec = set_nonblocking(connection)) {
+            return done(ctx, ec);
+        }
+
+        if (auto ec = enter_pipeline_mode(connection)) {
+            return done(ctx, ec);
+        }
+
+        const auto allocator = asio::get_associated_allocator(get_handler(ctx));
+        if (statements) {
+            for (const auto& statement : *statements) {
+                const auto query = make_query(std::string_view(statement));
+                if (!send_query_params(connection, to_binary_query(query, connection.oid_map(), allocator))) {
+                    return done(ctx, error::pg_send_query_params_failed);
+                }
+            }
+        }
+
+        if constexpr (!OidMapEmpty<Connection>) {
+            if (self->request_oids_) {
+                const auto query = make_oids_query(connection.oid_map());
+                self->res_.reserve(hana::length(connection.oid_map().impl));
+                if (!send_query_params(connection, to_binary_query(query, connection.oid_map(), allocator))) {
+                    return done(ctx, error::pg_send_query_params_failed);
+                }
+            }
+        }
+
+        auto& cache = get_statement_cache(connection);
+        for (auto& [statement, name] : self->warm_) {
+            name = statement->id ? std::string(detail::make_statement_name(*statement->id).data()) : cache.make_name();
+            if (!send_prepare(connection, name.c_str(), statement->text.c_str(), statement->types)) {
+                return done(ctx, error::pg_send_prepare_failed);
+            }
+        }
+
+        if (auto ec = pipeline_sync(connection)) {
+            return done(ctx, ec);
+        }
+
+        async_flush_output_op{ctx}();
+        async_get_pipeline_results(std::move(ctx), session_setup_results {
+            statements ? statements->size() : 0, self->request_oids_ ? std::addressof(self->res_) : nullptr,
+            std::addressof(self->warm_)
+        });
+    }
+
+    template <typename Connection>
+    void operator() (error_code ec, Connection&& conn) {
+        if constexpr (!OidMapEmpty<Connection>) {
+            if (!ec && ctx_->request_oids_) try {
+                set_oid_map(ozo::unwrap_connection(conn).oid_map(), ctx_->res_);
+            } catch (const std::exception& e) {
+                unwrap_connection(conn).set_error_context(e.what());
+                ec = error::oid_request_failed;
+            }
+        }
+        ctx_->handler_(ec, std::forward<Connection>(conn));
+    }
+
+    using executor_type = asio::associated_executor_t<Handler>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(ctx_->handler_);
+    }
+
+    using allocator_type = asio::associated_allocator_t<Handler>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(ctx_->handler_);
+    }
+};
+
+template <typename Connection, typename Handler>
+inline void async_session_setup(Connection&& conn, bool request_oids, Handler&& handler) {
+    async_session_setup_op<std::decay_t<Handler>> op{ozo::unwrap_connection(conn), request_oids,
+        std::forward<Handler>(handler)};
+    op.perform(std::forward<Connection>(conn));
+}
+
+#endif
+
+} // namespace ozo::impl
@@ -0,0 +1,307 @@
+#pragma once
+
+#include <ozo/impl/async_request.h>
+
+namespace ozo::impl {
+
+/**
+* Switches the connection into the single row mode or, if libpq supports it,
+* into the chunked rows mode for the last sent query.
+*/
+template <typename Connection>
+inline error_code set_rows_mode(Connection& conn, [[maybe_unused]] std::size_t rows_per_chunk) {
+#ifdef LIBPQ_HAS_CHUNK_MODE
+    if (rows_per_chunk > 1) {
+        return set_chunked_rows_mode(conn, static_cast<int>(rows_per_chunk));
+    }
+#endif
+    return set_single_row_mode(conn);
+}
+
+template <typename Context>
+inline void async_send_query_params_in_rows_mode(const Context& ctx, const binary_query& query,
+        std::size_t rows_per_chunk) {
+    decltype(auto) conn = get_connection(ctx);
+    if (auto ec = set_nonblocking(conn)) {
+        return done(ctx, ec);
+    }
+
+    if (!send_query_params(conn, query)) {
+        return done(ctx, error::pg_send_query_params_failed);
+    }
+
+    if (auto ec = set_rows_mode(conn, rows_per_chunk)) {
+        return done(ctx, ec);
+    }
+
+    async_flush_output_op{ctx}();
+}
+
+#include <boost/asio/yield.hpp>
+
+/**
+* Receives the query result chunk by chunk. Each `PGRES_SINGLE_TUPLE` or
+* `PGRES_TUPLES_CHUNK` result is passed to the chunk processor as soon as it
+* has been received, so only one chunk of the result is kept in memory. The final
+* `PGRES_TUPLES_OK` result contains no rows and is dropped. In case of a database
+* error the rest of results is consumed up to the end to keep the connection
+* usable. In case of a chunk processing error the operation completes immediately.
+*/
+template <typename Context, typename ChunkProcessor>
+struct async_get_result_chunks_op : boost::asio::coroutine {
+    Context ctx_;
+    ChunkProcessor process_;
+    using result_type = std::decay_t<decltype(get_result(get_connection(ctx_)))>;
+    result_type result_;
+    error_code error_;
+
+    async_get_result_chunks_op(Context ctx, ChunkProcessor process)
+    : ctx_(std::move(ctx)), process_(std::move(process)) {}
+
+    void perform() {
+        (*this)();
+    }
+
+    void done() {
+        return impl::done(ctx_);
+    }
+
+    void done(error_code ec) {
+        if (std::empty(get_error_context(get_connection(ctx_)))) {
+            get_connection(ctx_).set_error_context("error while get request result chunks");
+        }
+        return impl::done(ctx_, ec);
+    }
+
+    void operator() (error_code ec = error_code{}, std::size_t = 0) {
+        if (get_query_state(ctx_) == query_state::error) {
+            return;
+        }
+
+        if (ec) {
+            if (ec == asio::error::bad_descriptor) {
+                ec = asio::error::operation_aborted;
+            }
+            return done(ec);
+        }
+
+        reenter(*this) {
+            for (;;) {
+                while (is_busy(get_connection(ctx_))) {
+                    get_request_statistics(ctx_).waited();
+                    yield get_connection(ctx_).async_wait_read(std::move(*this));
+                    if (auto err = consume_input(get_connection(ctx_))) {
+                        return done(err);
+                    }
+                }
+
+                result_ = get_result(get_connection(ctx_));
+
+                if (!result_) {
+                    break;
+                }
+
+                if (!handle_result()) {
+                    return;
+                }
+            }
+
+            get_request_statistics(ctx_).result_received();
+
+            if (error_) {
+                return done(error_);
+            }
+
+            done();
+        }
+    }
+
+    bool handle_result() {
+        const auto status = result_status(*result_);
+        switch (status) {
+            case PGRES_SINGLE_TUPLE:
+#ifdef LIBPQ_HAS_CHUNK_MODE
+            case PGRES_TUPLES_CHUNK:
+#endif
+                return error_ || process();
+            case PGRES_TUPLES_OK:
+            case PGRES_COMMAND_OK:
+                return true;
+            case PGRES_BAD_RESPONSE:
+                set_error(error::result_status_bad_response);
+                return true;
+            case PGRES_EMPTY_QUERY:
+                set_error(error::result_status_empty_query);
+                return true;
+            case PGRES_FATAL_ERROR:
+                set_error(result_error(*result_));
+                return true;
+            case PGRES_COPY_OUT:
+            case PGRES_COPY_IN:
+            case PGRES_COPY_BOTH:
+            case PGRES_NONFATAL_ERROR:
+#ifdef LIBPQ_HAS_PIPELINING
+            case PGRES_PIPELINE_SYNC:
+            case PGRES_PIPELINE_ABORTED:
+#endif
+                break;
+        }
+
+        get_connection(ctx_).set_error_context(get_result_status_name(status));
+        done(error::result_status_unexpected);
+        return false;
+    }
+
+    void set_error(error_code ec) {
+        if (!error_) {
+            error_ = std::move(ec);
+        }
+    }
+
+    bool process() noexcept {
+        try {
+            process_(std::move(result_), get_connection(ctx_));
+        } catch (const std::exception& e) {
+            get_connection(ctx_).set_error_context(e.what());
+            done(error::bad_result_process);
+            return false;
+        }
+        return true;
+    }
+
+    using executor_type = std::decay_t<decltype(asio::get_associated_executor(get_handler(ctx_)))>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(get_handler(ctx_));
+    }
+
+    using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(get_handler(ctx_)))>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(get_handler(ctx_));
+    }
+};
+
+template <typename Context, typename ChunkProcessor>
+async_get_result_chunks_op(Context, ChunkProcessor) -> async_get_result_chunks_op<Context, ChunkProcessor>;
+
+#include <boost/asio/unyield.hpp>
+
+template <typename Context, typename ChunkProcessor>
+inline void async_get_result_chunks(Context&& ctx, ChunkProcessor&& p) {
+    async_get_result_chunks_op op{std::forward<Context>(ctx), std::forward<ChunkProcessor>(p)};
+    op.perform();
+}
+
+template <typename ChunkHandler, typename Query, typename TimeConstraint, typename Handler>
+struct async_stream_request_op {
+    ChunkHandler chunk_handler_;
+    Query query_;
+    TimeConstraint time_constraint_;
+    std::size_t rows_per_chunk_;
+    Handler handler_;
+
+    async_stream_request_op(Query query, TimeConstraint time_constraint, std::size_t rows_per_chunk,
+            ChunkHandler chunk_handler, Handler handler)
+    : chunk_handler_(std::move(chunk_handler)), query_(std::move(query)), time_constraint_(time_constraint),
+      rows_per_chunk_(rows_per_chunk), handler_(std::move(handler)) {}
+
+    template <typename Connection>
+    void operator() (error_code ec, Connection conn) {
+        if (ec) {
+            return handler_(ec, std::move(conn));
+        }
+
+        auto handler = apply_io_deadline(conn, time_constraint_, detail::wrap_executor {
+            detail::make_connection_executor(conn),
+            std::move(handler_)
+        });
+
+        auto ctx = make_request_operation_context(std::move(conn), std::move(handler));
+
+        const auto query = to_binary_query(query_, get_connection(ctx).oid_map(),
+                asio::get_associated_allocator(get_handler(ctx)));
+        async_send_query_params_in_rows_mode(ctx, query, rows_per_chunk_);
+        async_get_result_chunks(std::move(ctx), std::move(chunk_handler_));
+    }
+
+    using executor_type = std::decay_t<decltype(asio::get_associated_executor(handler_))>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(handler_);
+    }
+
+    using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(handler_))>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(handler_);
+    }
+};
+
+template <typename ChunkHandler, typename Query, typename TimeConstraint, typename Handler>
+async_stream_request_op(Query, TimeConstraint, std::size_t, ChunkHandler, Handler) ->
+    async_stream_request_op<ChunkHandler, Query, TimeConstraint, Handler>;
+
+/**
+* Chunk handler which decodes rows of each chunk into the output iterator.
+*/
+template <typename OutIterator>
+struct stream_into_handler {
+    OutIterator out;
+
+    template <typename Handle, typename Conn>
+    void operator() (Handle&& h, Conn& conn) {
+        auto res = ozo::make_result(std::forward<Handle>(h));
+        out = ozo::recv_result(res, ozo::unwrap_connection(conn).oid_map(), out);
+    }
+};
+
+template <typename OutIterator>
+stream_into_handler(OutIterator) -> stream_into_handler<OutIterator>;
+
+/**
+* Chunk handler which passes each chunk as `ozo::basic_result` to the user's callback.
+*/
+template <typename Callback>
+struct stream_chunk_handler {
+    Callback callback;
+
+    template <typename Handle, typename Conn>
+    void operator() (Handle&& h, Conn&) {
+        callback(ozo::make_result(std::forward<Handle>(h)));
+    }
+};
+
+template <typename Callback>
+stream_chunk_handler(Callback) -> stream_chunk_handler<Callback>;
+
+/**
+* Output of the streaming request: the chunk handler and the number of rows per chunk.
+*/
+template <typename ChunkHandler>
+struct stream_output {
+    ChunkHandler handler;
+    std::size_t rows_per_chunk;
+};
+
+template <typename ChunkHandler>
+stream_output(ChunkHandler, std::size_t) -> stream_output<ChunkHandler>;
+
+template <typename P, typename Q, typename TimeConstraint, typename ChunkHandler, typename Handler>
+inline void async_stream_request(P&& provider, Q&& query, TimeConstraint t,
+        stream_output<ChunkHandler> out, Handler&& handler) {
+    static_assert(ConnectionProvider<P>, "is not a ConnectionProvider");
+    static_assert(BinaryQueryConvertible<Q>, "query should be convertible to the binary_query");
+    static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+    async_get_connection(std::forward<P>(provider), deadline(t),
+        async_stream_request_op {
+            std::forward<Q>(query),
+            deadline(t),
+            out.rows_per_chunk,
+            std::move(out.handler),
+            std::forward<Handler>(handler)
+        }
+    );
+}
+
+} // namespace ozo::impl
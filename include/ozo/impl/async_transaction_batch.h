@@ -0,0 +1,375 @@
+#pragma once
+
+#include <ozo/impl/async_execute_batch.h>
+#include <ozo/impl/async_execute.h>
+#include <ozo/detail/begin_statement_builder.h>
+#include <ozo/transaction_status.h>
+
+#ifdef LIBPQ_HAS_PIPELINING
+
+namespace ozo::impl {
+
+/**
+* Sends BEGIN, the queries of the batch and COMMIT in pipeline mode followed
+* by the only synchronization point, so a failed statement aborts the rest of
+* the transaction including COMMIT.
+*/
+template <typename Context, typename Begin, typename Queries>
+inline void async_send_transaction_batch(const Context& ctx, const Begin& begin, const Queries& queries) {
+    decltype(auto) conn = get_connection(ctx);
+    if (auto ec = set_nonblocking(conn)) {
+        return done(ctx, ec);
+    }
+
+    if (auto ec = enter_pipeline_mode(conn)) {
+        return done(ctx, ec);
+    }
+
+    using namespace ozo::literals;
+    const auto allocator = asio::get_associated_allocator(get_handler(ctx));
+    if (!send_query_params(conn, to_binary_query(begin, conn.oid_map(), allocator))) {
+        return done(ctx, error::pg_send_query_params_failed);
+    }
+
+    bool failed = false;
+    for_each_batch_query(queries, [&](const auto& query) {
+        if (!failed) {
+            const auto q = to_binary_query(query, conn.oid_map(), allocator);
+            failed = !send_query_params(conn, q);
+            get_request_statistics(ctx).sent(q.text(), q.lengths(), static_cast<std::size_t>(q.params_count()));
+        }
+    });
+
+    if (failed || !send_query_params(conn, to_binary_query("COMMIT"_SQL, conn.oid_map(), allocator))) {
+        return done(ctx, error::pg_send_query_params_failed);
+    }
+
+    if (auto ec = pipeline_sync(conn)) {
+        return done(ctx, ec);
+    }
+
+    async_flush_output_op{ctx}();
+}
+
+#include <boost/asio/yield.hpp>
+
+/**
+* Receives results of the transaction batch. Results of BEGIN and COMMIT are
+* checked for errors only, a result of each query is written into the output
+* as `ozo::batch_statement_result`. Queries aborted due to a previous error
+* get the `ozo::error::pipeline_aborted` error. The operation completes with
+* the first error after the synchronization point has been received.
+*/
+template <typename Context, typename Out>
+struct async_get_transaction_batch_results_op : boost::asio::coroutine {
+    Context ctx_;
+    Out out_;
+    std::size_t size_;
+    using result_type = std::decay_t<decltype(get_result(get_connection(ctx_)))>;
+    result_type result_;
+    std::size_t index_ = 0;
+    batch_statement_result current_;
+    error_code error_;
+
+    async_get_transaction_batch_results_op(Context ctx, Out out, std::size_t size)
+    : ctx_(std::move(ctx)), out_(std::move(out)), size_(size) {}
+
+    void perform() {
+        (*this)();
+    }
+
+    void done() {
+        return impl::done(ctx_);
+    }
+
+    void done(error_code ec) {
+        if (std::empty(get_error_context(get_connection(ctx_)))) {
+            get_connection(ctx_).set_error_context("error while get transaction batch results");
+        }
+        return impl::done(ctx_, ec);
+    }
+
+    bool is_statement() const noexcept { return index_ > 0 && index_ <= size_;}
+
+    void operator() (error_code ec = error_code{}, std::size_t = 0) {
+        if (get_query_state(ctx_) == query_state::error) {
+            return;
+        }
+
+        if (ec) {
+            if (ec == asio::error::bad_descriptor) {
+                ec = asio::error::operation_aborted;
+            }
+            return done(ec);
+        }
+
+        reenter(*this) {
+            for (;;) {
+                while (is_busy(get_connection(ctx_))) {
+                    get_request_statistics(ctx_).waited();
+                    yield get_connection(ctx_).async_wait_read(std::move(*this));
+                    if (auto err = consume_input(get_connection(ctx_))) {
+                        return done(err);
+                    }
+                }
+
+                result_ = get_result(get_connection(ctx_));
+
+                if (!result_) {
+                    if (is_statement()) {
+                        *out_++ = std::move(current_);
+                        current_ = batch_statement_result{};
+                    }
+                    if (++index_ > size_ + 2) {
+                        get_connection(ctx_).set_error_context("no pipeline synchronization result received");
+                        return done(error::result_status_unexpected);
+                    }
+                    continue;
+                }
+
+                if (result_status(*result_) == PGRES_PIPELINE_SYNC) {
+                    get_request_statistics(ctx_).result_received();
+                    break;
+                }
+
+                if (!handle_result()) {
+                    return;
+                }
+            }
+
+            if (auto err = exit_pipeline_mode(get_connection(ctx_))) {
+                return done(err);
+            }
+
+            if (error_) {
+                return done(error_);
+            }
+
+            done();
+        }
+    }
+
+    bool handle_result() {
+        const auto status = result_status(*result_);
+        switch (status) {
+            case PGRES_SINGLE_TUPLE:
+#ifdef LIBPQ_HAS_CHUNK_MODE
+            case PGRES_TUPLES_CHUNK:
+#endif
+            case PGRES_TUPLES_OK:
+            case PGRES_COMMAND_OK:
+                if (is_statement()) {
+                    current_.rows = result_affected_rows(*result_);
+                    get_request_statistics(ctx_).received(result_);
+                }
+                return true;
+            case PGRES_PIPELINE_ABORTED:
+                current_.ec = error::pipeline_aborted;
+                return true;
+            case PGRES_BAD_RESPONSE:
+                set_error(error::result_status_bad_response);
+                return true;
+            case PGRES_EMPTY_QUERY:
+                set_error(error::result_status_empty_query);
+                return true;
+            case PGRES_FATAL_ERROR:
+                set_error(result_error(*result_));
+                return true;
+            case PGRES_COPY_OUT:
+            case PGRES_COPY_IN:
+            case PGRES_COPY_BOTH:
+            case PGRES_NONFATAL_ERROR:
+            case PGRES_PIPELINE_SYNC:
+                break;
+        }
+
+        get_connection(ctx_).set_error_context(get_result_status_name(status));
+        done(error::result_status_unexpected);
+        return false;
+    }
+
+    void set_error(error_code ec) {
+        current_.ec = ec;
+        current_.error_message = std::string(result_error_message(*result_));
+        if (!error_) {
+            error_ = std::move(ec);
+            get_connection(ctx_).set_error_context(statement_name() + " failed: " + current_.error_message);
+        }
+    }
+
+    std::string statement_name() const {
+        if (index_ == 0) {
+            return "BEGIN";
+        }
+        if (index_ > size_) {
+            return "COMMIT";
+        }
+        return "transaction batch statement #" + std::to_string(index_ - 1);
+    }
+
+    using executor_type = std::decay_t<decltype(asio::get_associated_executor(get_handler(ctx_)))>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(get_handler(ctx_));
+    }
+
+    using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(get_handler(ctx_)))>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(get_handler(ctx_));
+    }
+};
+
+template <typename Context, typename Out>
+async_get_transaction_batch_results_op(Context, Out, std::size_t) -> async_get_transaction_batch_results_op<Context, Out>;
+
+#include <boost/asio/unyield.hpp>
+
+template <typename Context, typename Out>
+inline void async_get_transaction_batch_results(Context&& ctx, Out&& out, std::size_t size) {
+    async_get_transaction_batch_results_op op{std::forward<Context>(ctx), std::forward<Out>(out), size};
+    op.perform();
+}
+
+/**
+* Completion handler of a transaction batch which rolls back the transaction
+* left open or failed on the server before the handler is called with the
+* original error.
+*/
+template <typename Handler, typename TimeConstraint>
+struct rollback_on_error_handler {
+    Handler handler_;
+    TimeConstraint time_constraint_;
+
+    template <typename Connection>
+    void operator() (error_code ec, Connection&& conn) {
+        if (!ec || !needs_rollback(conn)) {
+            return handler_(std::move(ec), std::forward<Connection>(conn));
+        }
+
+        using namespace ozo::literals;
+        async_execute(std::forward<Connection>(conn), "ROLLBACK"_SQL, time_constraint_,
+            rollback_completion<Handler>{std::move(handler_), std::move(ec)});
+    }
+
+    template <typename Connection>
+    static bool needs_rollback(const Connection& conn) {
+        if (ozo::is_null(conn) || ozo::connection_bad(conn)) {
+            return false;
+        }
+        const auto status = get_transaction_status(conn);
+        return status == transaction_status::transaction || status == transaction_status::error;
+    }
+
+    template <typename H>
+    struct rollback_completion {
+        H handler_;
+        error_code error_;
+
+        template <typename Connection>
+        void operator() (error_code, Connection&& conn) {
+            handler_(std::move(error_), std::forward<Connection>(conn));
+        }
+
+        using executor_type = std::decay_t<decltype(asio::get_associated_executor(handler_))>;
+
+        executor_type get_executor() const noexcept {
+            return asio::get_associated_executor(handler_);
+        }
+
+        using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(handler_))>;
+
+        allocator_type get_allocator() const noexcept {
+            return asio::get_associated_allocator(handler_);
+        }
+    };
+
+    using executor_type = std::decay_t<decltype(asio::get_associated_executor(handler_))>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(handler_);
+    }
+
+    using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(handler_))>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(handler_);
+    }
+};
+
+template <typename Handler, typename TimeConstraint>
+rollback_on_error_handler(Handler, TimeConstraint) -> rollback_on_error_handler<Handler, TimeConstraint>;
+
+template <typename Queries, typename Options, typename Out, typename TimeConstraint, typename Handler, typename Start = none_t>
+struct async_transaction_batch_op {
+    Queries queries_;
+    Options options_;
+    Out out_;
+    TimeConstraint time_constraint_;
+    Handler handler_;
+    Start start_;
+
+    async_transaction_batch_op(Queries queries, Options options, Out out, TimeConstraint time_constraint,
+            Handler handler, Start start = Start{})
+    : queries_(std::move(queries)), options_(std::move(options)), out_(std::move(out)),
+      time_constraint_(time_constraint), handler_(std::move(handler)), start_(start) {}
+
+    template <typename Connection>
+    void operator() (error_code ec, Connection conn) {
+        if (ec) {
+            return handler_(ec, std::move(conn));
+        }
+
+        auto handler = apply_io_deadline(conn, time_constraint_, detail::wrap_executor {
+            detail::make_connection_executor(conn),
+            rollback_on_error_handler{std::move(handler_), time_constraint_}
+        });
+
+        auto ctx = make_request_operation_context(std::move(conn), std::move(handler));
+        get_request_statistics(ctx).requested(start_);
+
+        async_send_transaction_batch(ctx, detail::begin_statement_builder::statement(options_), queries_);
+        async_get_transaction_batch_results(std::move(ctx), std::move(out_), batch_size(queries_));
+    }
+
+    using executor_type = std::decay_t<decltype(asio::get_associated_executor(handler_))>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(handler_);
+    }
+
+    using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(handler_))>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(handler_);
+    }
+};
+
+template <typename Queries, typename Options, typename Out, typename TimeConstraint, typename Handler>
+async_transaction_batch_op(Queries, Options, Out, TimeConstraint, Handler)
+    -> async_transaction_batch_op<Queries, Options, Out, TimeConstraint, Handler>;
+
+template <typename Queries, typename Options, typename Out, typename TimeConstraint, typename Handler, typename Start>
+async_transaction_batch_op(Queries, Options, Out, TimeConstraint, Handler, Start)
+    -> async_transaction_batch_op<Queries, Options, Out, TimeConstraint, Handler, Start>;
+
+template <typename P, typename Options, typename Queries, typename Out, typename TimeConstraint, typename Handler>
+inline void async_transaction_batch(P&& provider, Options&& options, Queries&& queries, Out&& out,
+        TimeConstraint t, Handler&& handler) {
+    static_assert(ConnectionProvider<P>, "is not a ConnectionProvider");
+    static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+    async_get_connection(std::forward<P>(provider), deadline(t),
+        async_transaction_batch_op {
+            std::forward<Queries>(queries),
+            std::forward<Options>(options),
+            std::forward<Out>(out),
+            deadline(t),
+            std::forward<Handler>(handler),
+            make_request_start_point<P>()
+        }
+    );
+}
+
+} // namespace ozo::impl
+
+#endif
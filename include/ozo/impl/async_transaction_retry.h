@@ -0,0 +1,176 @@
+#pragma once
+
+#include <ozo/transaction.h>
+#include <ozo/transaction_status.h>
+#include <ozo/failover/retry.h>
+
+namespace ozo {
+
+/**
+ * @brief Retry policy of `ozo::retry_transaction`
+ *
+ * @ingroup group-transaction-types
+ */
+struct transaction_retry_policy {
+    int tries = 3; //!< maximum number of the transaction body runs including the first one
+    failover::exponential_backoff backoff {std::chrono::milliseconds(5), std::chrono::milliseconds(100)}; //!< jittered delay before a retry
+};
+
+namespace impl {
+
+template <typename Op, typename Step>
+struct async_transaction_retry_step {
+    Op op_;
+
+    template <typename T>
+    void operator() (error_code ec, T&& v) {
+        op_.on(Step{}, std::move(ec), std::forward<T>(v));
+    }
+
+    using executor_type = typename Op::executor_type;
+
+    executor_type get_executor() const noexcept { return op_.get_executor();}
+
+    using allocator_type = typename Op::allocator_type;
+
+    allocator_type get_allocator() const noexcept { return op_.get_allocator();}
+};
+
+/**
+* Runs the body in a transaction and commits it. If the body or COMMIT fails with
+* `errc::serialization_conflict`, the transaction is rolled back and the body runs
+* again in a new one after a jittered delay, while the tries and the time constraint
+* allow it. The connection is reused for the retry if it is still healthy after the
+* rollback, otherwise a new one is taken from the provider.
+*/
+template <typename Provider, typename Body, typename Options, typename TimeConstraint, typename Handler>
+struct async_transaction_retry_op {
+    struct connected {};
+    struct begun {};
+    struct body_done {};
+    struct ended {};
+
+    Provider provider_;
+    Body body_;
+    Options options_;
+    TimeConstraint time_constraint_;
+    transaction_retry_policy policy_;
+    Handler handler_;
+    int retries_ = 0;
+    error_code error_ {};
+
+    template <typename Step>
+    auto step() && {
+        return async_transaction_retry_step<async_transaction_retry_op, Step>{std::move(*this)};
+    }
+
+    void perform() {
+        ozo::async_get_connection(provider_, time_constraint_, std::move(*this).template step<connected>());
+    }
+
+    template <typename Connection>
+    void on(connected, error_code ec, Connection&& conn) {
+        if (ec) {
+            return handler_(std::move(ec), std::forward<Connection>(conn));
+        }
+        auto begin = ozo::begin.with_transaction_options(options_);
+        begin(std::forward<Connection>(conn), time_constraint_, std::move(*this).template step<begun>());
+    }
+
+    template <typename Transaction>
+    void on(begun, error_code ec, Transaction&& transaction) {
+        if (ec) {
+            return handler_(std::move(ec), release_connection(std::forward<Transaction>(transaction)));
+        }
+        auto body = body_;
+        body(std::forward<Transaction>(transaction), time_constraint_, std::move(*this).template step<body_done>());
+    }
+
+    template <typename Transaction>
+    void on(body_done, error_code ec, Transaction&& transaction) {
+        if (!ec) {
+            return ozo::commit(std::forward<Transaction>(transaction), time_constraint_, std::move(*this).template step<ended>());
+        }
+        error_ = std::move(ec);
+        if (ozo::is_null(transaction) || ozo::connection_bad(transaction)) {
+            return on(ended{}, error_code{}, release_connection(std::forward<Transaction>(transaction)));
+        }
+        ozo::rollback(std::forward<Transaction>(transaction), time_constraint_, std::move(*this).template step<ended>());
+    }
+
+    template <typename Connection>
+    void on(ended, error_code ec, Connection&& conn) {
+        if (!error_) {
+            error_ = std::move(ec);
+        }
+        if (!error_ || !can_retry()) {
+            return handler_(std::move(error_), std::forward<Connection>(conn));
+        }
+        const auto delay = next_delay();
+        ++retries_;
+        error_ = error_code{};
+        if (healthy(conn)) {
+            return failover::detail::async_get_connection_after(std::forward<Connection>(conn), delay,
+                time_constraint_, std::move(*this).template step<connected>());
+        }
+        failover::detail::async_get_connection_after(provider_, delay,
+            time_constraint_, std::move(*this).template step<connected>());
+    }
+
+    bool can_retry() const {
+        if (retries_ + 1 >= policy_.tries || error_ != errc::serialization_conflict) {
+            return false;
+        }
+        if constexpr (std::is_same_v<TimeConstraint, time_traits::time_point>) {
+            return time_left(time_constraint_) > time_traits::duration::zero();
+        }
+        return true;
+    }
+
+    // The delay takes no more than a half of the time left, so a retry has time to run.
+    time_traits::duration next_delay() const {
+        auto result = policy_.backoff.delay(retries_, failover::detail::backoff_random());
+        if constexpr (std::is_same_v<TimeConstraint, time_traits::time_point>) {
+            result = std::min(result, time_left(time_constraint_) / 2);
+        }
+        return result;
+    }
+
+    template <typename Connection>
+    static bool healthy(const Connection& conn) {
+        return !ozo::is_null(conn) && !ozo::connection_bad(conn)
+            && get_transaction_status(conn) == transaction_status::idle;
+    }
+
+    using executor_type = std::decay_t<decltype(asio::get_associated_executor(handler_))>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(handler_);
+    }
+
+    using allocator_type = std::decay_t<decltype(asio::get_associated_allocator(handler_))>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(handler_);
+    }
+};
+
+template <typename P, typename Body, typename Options, typename TimeConstraint, typename Handler>
+inline void async_transaction_retry(P&& provider, Body&& body, Options&& options, TimeConstraint t,
+        const transaction_retry_policy& policy, Handler&& handler) {
+    static_assert(ConnectionProvider<P>, "is not a ConnectionProvider");
+    static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+    static_assert(std::is_copy_constructible_v<std::decay_t<Body>>, "transaction body should be copy constructible");
+    async_transaction_retry_op<std::decay_t<P>, std::decay_t<Body>, std::decay_t<Options>,
+            decltype(deadline(t)), std::decay_t<Handler>> {
+        std::forward<P>(provider),
+        std::forward<Body>(body),
+        std::forward<Options>(options),
+        deadline(t),
+        policy,
+        std::forward<Handler>(handler)
+    }.perform();
+}
+
+} // namespace impl
+} // namespace ozo
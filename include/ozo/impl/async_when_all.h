@@ -0,0 +1,95 @@
+#pragma once
+
+#include <ozo/impl/async_execute.h>
+#include <ozo/detail/bind.h>
+
+#include <boost/asio/dispatch.hpp>
+#include <boost/hana/for_each.hpp>
+#include <boost/hana/size.hpp>
+
+#include <memory>
+#include <mutex>
+
+namespace ozo::impl {
+
+/**
+* Step of `ozo::when_all()`. Contains a query and an output for its result,
+* for the `ozo::none` output the result is checked for errors only.
+*/
+template <typename Query, typename Out>
+struct when_all_step {
+    Query query;
+    Out out;
+};
+
+template <typename Steps>
+constexpr std::size_t when_all_size = decltype(hana::size(std::declval<const Steps&>()))::value;
+
+/**
+* Shared state of the steps. The handler is called once all the steps complete,
+* since the outputs may be written until then, with the error of the step which
+* has failed first.
+*/
+template <typename Handler>
+class when_all_state {
+public:
+    when_all_state(std::size_t steps, Handler handler)
+    : remaining_(steps), handler_(std::move(handler)) {}
+
+    void complete(error_code ec) {
+        {
+            const std::lock_guard lock(mutex_);
+            if (ec && !error_) {
+                error_ = std::move(ec);
+            }
+            if (--remaining_) {
+                return;
+            }
+        }
+        auto ex = asio::get_associated_executor(handler_);
+        asio::dispatch(ex, detail::bind(std::move(handler_), std::move(error_)));
+    }
+
+private:
+    std::mutex mutex_;
+    std::size_t remaining_;
+    error_code error_;
+    Handler handler_;
+};
+
+template <typename State>
+struct when_all_step_handler {
+    std::shared_ptr<State> state_;
+
+    template <typename Connection>
+    void operator() (error_code ec, Connection&&) {
+        state_->complete(std::move(ec));
+    }
+};
+
+template <typename P, typename Step, typename TimeConstraint, typename Handler>
+inline void async_when_all_step(P& provider, Step&& step, TimeConstraint t, Handler&& handler) {
+    if constexpr (IsNone<decltype(step.out)>) {
+        async_execute(provider, std::move(step.query), t, std::forward<Handler>(handler));
+    } else {
+        async_request(provider, std::move(step.query), t, std::move(step.out), std::forward<Handler>(handler));
+    }
+}
+
+template <typename P, typename Steps, typename TimeConstraint, typename Handler>
+inline void async_when_all(P&& provider, Steps&& steps, TimeConstraint t, Handler&& handler) {
+    static_assert(ConnectionProvider<P>, "is not a ConnectionProvider");
+    static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+    static_assert(when_all_size<std::decay_t<Steps>> > 0, "steps should not be empty");
+
+    using state_type = when_all_state<std::decay_t<Handler>>;
+    const auto allocator = asio::get_associated_allocator(handler);
+    auto state = std::allocate_shared<state_type>(allocator, when_all_size<std::decay_t<Steps>>,
+        std::forward<Handler>(handler));
+
+    hana::for_each(steps, [&] (auto& step) {
+        async_when_all_step(provider, std::move(step), t, when_all_step_handler<state_type>{state});
+    });
+}
+
+} // namespace ozo::impl
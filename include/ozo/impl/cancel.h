@@ -5,18 +5,33 @@
 #include <ozo/type_traits.h>
 #include <ozo/time_traits.h>
 #include <ozo/detail/deadline.h>
+#include <ozo/detail/probes.h>
 #include <ozo/detail/wrap_executor.h>
 
 #include <boost/asio/bind_executor.hpp>
+#include <boost/asio/posix/stream_descriptor.hpp>
+#include <functional>
 #include <future>
 
 namespace ozo {
 
 namespace impl {
 
+/**
+* Connection which caches the native cancel handle should provide the `native_cancel_handle()`
+* member function which returns the `pg::shared_cancel` handle.
+*/
+template <typename T, typename = std::void_t<>>
+struct has_native_cancel_handle : std::false_type {};
+
+template <typename T>
+struct has_native_cancel_handle<T, std::void_t<decltype(std::declval<const T&>().native_cancel_handle())>> : std::true_type {};
+
 template <typename T>
 inline bool pq_cancel(cancel_handle<T> h, std::string& err) {
-    return PQcancel(h.native_handle(), std::data(err), std::size(err));
+    const bool sent = PQcancel(h.native_handle(), std::data(err), std::size(err));
+    OZO_PROBE(cancel, h.native_handle(), int(sent));
+    return sent;
 }
 
 template <typename Handle>
@@ -37,6 +52,25 @@ inline auto dispatch_cancel(Handle&& h) {
     return res;
 }
 
+/**
+* Sends the cancel request for the query running on the connection without waiting
+* for the result. The request is sent by the blocking `PQcancel()` on the system
+* executor. Returns `false` if the cancel handle can not be obtained.
+*/
+struct post_server_cancel {
+    template <typename Connection>
+    bool operator() (const Connection& conn) const {
+        auto handle = get_cancel_handle(conn);
+        if (!handle.native_handle()) {
+            return false;
+        }
+        asio::post(handle.get_executor(), [handle = std::move(handle)] () mutable {
+            dispatch_cancel(std::move(handle));
+        });
+        return true;
+    }
+};
+
 template <typename Executor, typename Continuation>
 class deadline_cancel_handler {
 public:
@@ -123,40 +157,256 @@ struct cancel_op {
     allocator_type get_allocator() const noexcept { return asio::get_associated_allocator(handler_);}
 
     void operator () () {
-        auto [ec, msg] = dispatch_cancel(std::move(cancel_handle_));
+        auto [ec, msg] = send();
+        complete(std::move(ec), std::move(msg));
+    }
+
+    auto send() {
+        return dispatch_cancel(std::move(cancel_handle_));
+    }
+
+    void complete(error_code ec, std::string msg) {
         asio::dispatch(detail::bind(std::move(handler_), std::move(ec), std::move(msg)));
     }
 };
 
+/**
+* Executor which queues the cancel operations by itself, e.g. `ozo::cancel_executor::executor_type`,
+* should define the `cancel_queue_tag` member type and provide the `submit_cancel(int backend_pid, Operation&& op)`
+* member function.
+*/
+template <typename T, typename = std::void_t<>>
+struct is_cancel_queue_executor : std::false_type {};
+
+template <typename T>
+struct is_cancel_queue_executor<T, std::void_t<typename T::cancel_queue_tag>> : std::true_type {};
+
+template <typename Handle, typename CancelHandler>
+inline void post_cancel_op(Handle&& cancel_handle, CancelHandler&& handler) {
+    using executor_type = typename std::decay_t<Handle>::executor_type;
+    if constexpr (is_cancel_queue_executor<executor_type>::value) {
+        const auto ex = cancel_handle.get_executor();
+        const int pid = cancel_handle.backend_pid();
+        ex.submit_cancel(pid, cancel_op{std::forward<Handle>(cancel_handle), std::forward<CancelHandler>(handler)});
+    } else {
+        asio::post(cancel_op{std::forward<Handle>(cancel_handle), std::forward<CancelHandler>(handler)});
+    }
+}
+
 struct initiate_async_cancel {
     template <typename CompletionHandler, typename Handle, typename IoContext>
     inline auto operator () (CompletionHandler&& h, Handle&& cancel_handle, IoContext& io, time_traits::time_point t) const {
-        asio::post(cancel_op{
-            std::forward<Handle>(cancel_handle),
+        post_cancel_op(std::forward<Handle>(cancel_handle),
             deadline_cancel_handler {io.get_executor(), t,
                 detail::wrap_executor {
                     ozo::detail::make_strand_executor(io.get_executor()),
                     std::forward<CompletionHandler>(h)
                 }
             }
-        });
+        );
+    }
+
+    // The io context is passed wrapped, since completion tokens like asio::use_awaitable
+    // store the initiation arguments by value.
+    template <typename CompletionHandler, typename Handle, typename IoContext>
+    inline auto operator () (CompletionHandler&& h, Handle&& cancel_handle, std::reference_wrapper<IoContext> io,
+            time_traits::time_point t) const {
+        return (*this)(std::forward<CompletionHandler>(h), std::forward<Handle>(cancel_handle), io.get(), t);
     }
 
     template <typename CompletionHandler, typename Handle>
     inline auto operator () (CompletionHandler&& h, Handle&& cancel_handle) const {
-        asio::post(cancel_op{
-            std::forward<Handle>(cancel_handle),
-            std::forward<CompletionHandler>(h)
+        post_cancel_op(std::forward<Handle>(cancel_handle), std::forward<CompletionHandler>(h));
+    }
+};
+
+#ifdef LIBPQ_HAS_ASYNC_CANCEL
+
+/**
+* Cancel connection of the non-blocking cancel operation. The socket is reassigned
+* each time libpq switches the cancel connection to another socket, e.g. to the
+* next host of a multi-host connection string.
+*/
+class async_cancel_connection {
+public:
+    using executor_type = io_context::executor_type;
+
+    async_cancel_connection(io_context& io, async_cancel_handle handle)
+    : io_(std::addressof(io)), handle_(std::move(handle)), socket_(io) {}
+
+    ~async_cancel_connection() {
+        // The socket is owned by the libpq cancel connection
+        socket_.release();
+    }
+
+    executor_type get_executor() const noexcept { return io_->get_executor();}
+
+    PGcancelConn* native_handle() const noexcept { return handle_.native_handle();}
+
+    error_code update_socket() {
+        const int fd = PQcancelSocket(native_handle());
+        if (fd == -1) {
+            return error::pq_socket_failed;
+        }
+        if (!socket_.is_open() || socket_.native_handle() != fd) {
+            error_code ec;
+            socket_.release();
+            socket_.assign(fd, ec);
+            return ec;
+        }
+        return {};
+    }
+
+    template <typename WaitHandler>
+    void async_wait_write(WaitHandler&& h) {
+        socket_.async_write_some(asio::null_buffers(), std::forward<WaitHandler>(h));
+    }
+
+    template <typename WaitHandler>
+    void async_wait_read(WaitHandler&& h) {
+        socket_.async_read_some(asio::null_buffers(), std::forward<WaitHandler>(h));
+    }
+
+    void cancel() noexcept {
+        error_code _;
+        socket_.cancel(_);
+    }
+
+    std::string error_message() const {
+        std::string result(detail::make_string_view(PQcancelErrorMessage(native_handle())));
+        const auto pos = result.find_last_not_of('\n');
+        result.resize(pos == result.npos ? 0 : pos + 1);
+        return result;
+    }
+
+private:
+    io_context* io_;
+    async_cancel_handle handle_;
+    asio::posix::stream_descriptor socket_;
+};
+
+/**
+* Non-blocking cancel operation which polls the cancel connection on the
+* `io_context` in the same way as `async_connect_op` does for a connection.
+*/
+template <typename Handler>
+struct async_cancel_connect_op {
+    std::shared_ptr<async_cancel_connection> conn_;
+    Handler handler_;
+
+    void perform() {
+        if (!conn_->native_handle()) {
+            return post_done(error::pq_cancel_failed, "cancel connection object is not created");
+        }
+        if (!PQcancelStart(conn_->native_handle())) {
+            return post_done(error::pq_cancel_failed, conn_->error_message());
+        }
+        if (auto ec = conn_->update_socket()) {
+            return post_done(ec, conn_->error_message());
+        }
+        conn_->async_wait_write(std::move(*this));
+    }
+
+    void operator () (error_code ec, std::size_t = 0) {
+        if (ec) {
+            return done(ec);
+        }
+
+        switch (PQcancelPoll(conn_->native_handle())) {
+            case PGRES_POLLING_OK:
+                return done();
+
+            case PGRES_POLLING_WRITING:
+                return wait_write();
+
+            case PGRES_POLLING_READING:
+                return wait_read();
+
+            case PGRES_POLLING_FAILED:
+            case PGRES_POLLING_ACTIVE:
+                break;
+        }
+
+        done(error::pq_cancel_failed);
+    }
+
+    void wait_write() {
+        if (auto ec = conn_->update_socket()) {
+            return done(ec);
+        }
+        conn_->async_wait_write(std::move(*this));
+    }
+
+    void wait_read() {
+        if (auto ec = conn_->update_socket()) {
+            return done(ec);
+        }
+        conn_->async_wait_read(std::move(*this));
+    }
+
+    void done(error_code ec = error_code {}) {
+        auto msg = ec ? conn_->error_message() : std::string{};
+        auto conn = std::move(conn_);
+        handler_(std::move(ec), std::move(msg));
+    }
+
+    // Completes the operation which has failed to start without invoking the
+    // handler from within the initiating function.
+    void post_done(error_code ec, std::string msg) {
+        auto ex = get_executor();
+        asio::post(ex, [handler = std::move(handler_), conn = std::move(conn_), ec, msg = std::move(msg)] () mutable {
+            handler(std::move(ec), std::move(msg));
         });
     }
+
+    using executor_type = asio::associated_executor_t<Handler>;
+
+    executor_type get_executor() const noexcept { return asio::get_associated_executor(handler_);}
+
+    using allocator_type = asio::associated_allocator_t<Handler>;
+
+    allocator_type get_allocator() const noexcept { return asio::get_associated_allocator(handler_);}
+};
+
+template <typename Handler>
+async_cancel_connect_op(std::shared_ptr<async_cancel_connection>, Handler) -> async_cancel_connect_op<Handler>;
+
+struct initiate_async_cancel_connect {
+    template <typename CompletionHandler, typename TimeConstraint>
+    inline void operator () (CompletionHandler&& h, async_cancel_handle&& handle, io_context& io, TimeConstraint t) const {
+        auto allocator = asio::get_associated_allocator(h);
+        auto conn = std::allocate_shared<async_cancel_connection>(allocator, io, std::move(handle));
+        auto handler = detail::wrap_executor {
+            ozo::detail::make_strand_executor(io.get_executor()),
+            std::forward<CompletionHandler>(h)
+        };
+        if constexpr (IsNone<TimeConstraint>) {
+            async_cancel_connect_op{std::move(conn), std::move(handler)}.perform();
+        } else {
+            using deadline_handler = detail::io_deadline_handler<async_cancel_connection, decltype(handler), std::string>;
+            auto& stream = *conn;
+            async_cancel_connect_op{std::move(conn), deadline_handler{stream, t, std::move(handler)}}.perform();
+        }
+    }
 };
 
+#endif
+
 } // namespace impl
 
 template <typename Connection, typename Executor>
 inline cancel_handle<Executor> get_cancel_handle(const Connection& connection, Executor&& executor) {
     static_assert(ozo::Connection<Connection>, "First argument should model a Connection");
-    return {PQgetCancel(get_native_handle(connection)), std::forward<Executor>(executor)};
+    using stream_type = std::decay_t<decltype(unwrap_connection(connection))>;
+    if constexpr (impl::has_native_cancel_handle<stream_type>::value) {
+        auto handle = unwrap_connection(connection).native_cancel_handle();
+        const int pid = handle ? PQbackendPID(get_native_handle(connection)) : 0;
+        return {std::move(handle), std::forward<Executor>(executor), pid};
+    } else {
+        const auto handle = PQgetCancel(get_native_handle(connection));
+        const int pid = handle ? PQbackendPID(get_native_handle(connection)) : 0;
+        return {handle, std::forward<Executor>(executor), pid};
+    }
 }
 
 using cancel_handler_signature_t = void (error_code, std::string);
@@ -166,7 +416,7 @@ auto cancel_op::operator() (cancel_handle<Executor>&& handle, io_context& io,
         TimeConstraint time_constraint, CompletionToken&& token) const {
     static_assert(ozo::TimeConstraint<TimeConstraint>, "time_constraint should model TimeConstrain");
     return async_initiate<CompletionToken, cancel_handler_signature_t>(
-        impl::initiate_async_cancel{}, token, std::move(handle), io, deadline(time_constraint)
+        impl::initiate_async_cancel{}, token, std::move(handle), std::ref(io), deadline(time_constraint)
     );
 }
 
@@ -177,4 +427,30 @@ auto cancel_op::operator() (cancel_handle<Executor>&& handle, CompletionToken&&
     );
 }
 
+#ifdef LIBPQ_HAS_ASYNC_CANCEL
+
+template <typename Connection>
+inline async_cancel_handle get_async_cancel_handle(const Connection& connection) {
+    static_assert(ozo::Connection<Connection>, "First argument should model a Connection");
+    return async_cancel_handle{PQcancelCreate(get_native_handle(connection))};
+}
+
+template <typename TimeConstraint, typename CompletionToken>
+auto cancel_op::operator() (async_cancel_handle&& handle, io_context& io,
+        TimeConstraint time_constraint, CompletionToken&& token) const {
+    static_assert(ozo::TimeConstraint<TimeConstraint>, "time_constraint should model TimeConstrain");
+    return async_initiate<CompletionToken, cancel_handler_signature_t>(
+        impl::initiate_async_cancel_connect{}, token, std::move(handle), std::ref(io), deadline(time_constraint)
+    );
+}
+
+template <typename CompletionToken>
+auto cancel_op::operator() (async_cancel_handle&& handle, io_context& io, CompletionToken&& token) const {
+    return async_initiate<CompletionToken, cancel_handler_signature_t>(
+        impl::initiate_async_cancel_connect{}, token, std::move(handle), std::ref(io), none
+    );
+}
+
+#endif
+
 } // namespace ozo
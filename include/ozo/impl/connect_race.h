@@ -0,0 +1,242 @@
+#pragma once
+
+#include <ozo/impl/async_connect.h>
+#include <ozo/impl/connection_params.h>
+
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <libpq-fe.h>
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ozo::impl {
+
+/**
+* Splits a comma separated list of a multi-host connection string parameter.
+*/
+inline std::vector<std::string> split_hosts_list(std::string_view value) {
+    std::vector<std::string> result;
+    for (;;) {
+        const auto pos = value.find(',');
+        result.emplace_back(value.substr(0, pos));
+        if (pos == std::string_view::npos) {
+            break;
+        }
+        value.remove_prefix(pos + 1);
+    }
+    return result;
+}
+
+/**
+* Splits a multi-host connection string into connection strings of each host with
+* the rest of parameters kept as is. Returns an empty vector if the connection string
+* can not be parsed or contains a single host, so there is nothing to race.
+*/
+inline std::vector<std::string> split_hosts(const std::string& conninfo) {
+    std::unique_ptr<PQconninfoOption, decltype(&PQconninfoFree)> options(
+        PQconninfoParse(conninfo.c_str(), nullptr), &PQconninfoFree);
+    if (!options) {
+        return {};
+    }
+
+    const auto is_multi_host = [] (std::string_view keyword) {
+        return keyword == "host" || keyword == "hostaddr" || keyword == "port";
+    };
+
+    std::size_t count = 0;
+    for (auto option = options.get(); option->keyword; ++option) {
+        if (option->val && is_multi_host(option->keyword)) {
+            count = std::max(count, split_hosts_list(option->val).size());
+        }
+    }
+
+    if (count < 2) {
+        return {};
+    }
+
+    std::vector<std::string> result(count);
+    for (auto option = options.get(); option->keyword; ++option) {
+        if (!option->val) {
+            continue;
+        }
+        if (!is_multi_host(option->keyword)) {
+            for (auto& v : result) {
+                append_conninfo_parameter(v, option->keyword, option->val);
+            }
+            continue;
+        }
+        const auto values = split_hosts_list(option->val);
+        if (values.size() != 1 && values.size() != count) {
+            return {};
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            append_conninfo_parameter(result[i], option->keyword, values[values.size() == 1 ? 0 : i]);
+        }
+    }
+
+    return result;
+}
+
+/**
+* Races connect attempts to the hosts of a multi-host connection string. The attempts
+* are started one by one with the stagger delay or as soon as the previous attempt fails.
+* The first established connection wins, the rest of attempts are cancelled and their
+* connections are closed. The oid map is requested for the winner only. All the attempts
+* are performed on a single strand, so the state needs no synchronization.
+*/
+template <typename Connection, typename MakeConnection, typename Deadline, typename Handler, typename OidMapCache>
+class connect_race : public std::enable_shared_from_this<connect_race<Connection, MakeConnection, Deadline, Handler, OidMapCache>> {
+public:
+    using executor_type = decltype(detail::make_connection_executor(std::declval<Connection&>()));
+    using allocator_type = asio::associated_allocator_t<Handler>;
+
+    connect_race(std::shared_ptr<const std::vector<std::string>> conninfos, time_traits::duration stagger,
+            Deadline deadline, MakeConnection make_connection, Handler handler, OidMapCache cache)
+    : conninfos_(std::move(conninfos)), stagger_(stagger), deadline_(deadline),
+      make_connection_(std::move(make_connection)), handler_(std::move(handler)), cache_(std::move(cache)),
+      first_(make_connection_()), executor_(detail::make_connection_executor(first_)),
+      stagger_timer_(get_executor(first_)), deadline_timer_(get_executor(first_)),
+      attempts_(conninfos_->size()) {}
+
+    void start() {
+        asio::dispatch(executor_, [self = this->shared_from_this()] {
+            if constexpr (!IsNone<Deadline>) {
+                self->deadline_timer_.expires_at(self->deadline_);
+                self->deadline_timer_.async_wait(asio::bind_executor(self->executor_,
+                    [self] (error_code ec) { self->on_deadline(ec); }));
+            }
+            self->start_attempt();
+        });
+    }
+
+private:
+    struct attempt_handler {
+        std::shared_ptr<connect_race> race_;
+        std::size_t index_;
+
+        void operator() (error_code ec, Connection conn) {
+            race_->on_attempt(index_, std::move(ec), std::move(conn));
+        }
+
+        using executor_type = typename connect_race::executor_type;
+
+        executor_type get_executor() const noexcept { return race_->executor_;}
+
+        using allocator_type = typename connect_race::allocator_type;
+
+        allocator_type get_allocator() const noexcept { return asio::get_associated_allocator(race_->handler_);}
+    };
+
+    void start_attempt() {
+        const auto index = next_++;
+        auto conn = index == 0 ? std::move(first_) : make_connection_();
+        attempts_[index] = conn;
+        ++pending_;
+        if (next_ < attempts_.size()) {
+            stagger_timer_.expires_after(stagger_);
+            stagger_timer_.async_wait(asio::bind_executor(executor_,
+                [self = this->shared_from_this()] (error_code ec) { self->on_stagger(ec); }));
+        }
+        async_connect_op op{std::move(conn), attempt_handler{this->shared_from_this(), index}};
+        op.perform((*conninfos_)[index]);
+    }
+
+    void on_stagger(error_code ec) {
+        if (ec || finished_ || next_ >= attempts_.size()) {
+            return;
+        }
+        start_attempt();
+    }
+
+    void on_deadline(error_code ec) {
+        if (ec || finished_) {
+            return;
+        }
+        timed_out_ = true;
+        stagger_timer_.cancel();
+        cancel_attempts();
+    }
+
+    void on_attempt(std::size_t index, error_code ec, Connection conn) {
+        --pending_;
+        attempts_[index] = Connection{};
+
+        if (finished_) {
+            return;
+        }
+
+        if (!ec) {
+            return finish(std::move(ec), std::move(conn));
+        }
+
+        if (!timed_out_ && next_ < attempts_.size()) {
+            stagger_timer_.cancel();
+            return start_attempt();
+        }
+
+        if (pending_ == 0) {
+            return finish(timed_out_ ? error_code{asio::error::timed_out} : std::move(ec), std::move(conn));
+        }
+    }
+
+    void cancel_attempts() {
+        for (auto& conn : attempts_) {
+            if (conn) {
+                unwrap_connection(conn).cancel();
+            }
+        }
+    }
+
+    void finish(error_code ec, Connection conn) {
+        finished_ = true;
+        stagger_timer_.cancel();
+        deadline_timer_.cancel();
+        cancel_attempts();
+        auto handler = apply_oid_map_request<Connection>(
+            apply_time_constaint(deadline_, conn, std::move(handler_)),
+            std::move(cache_)
+        );
+        handler(std::move(ec), std::move(conn));
+    }
+
+    std::shared_ptr<const std::vector<std::string>> conninfos_;
+    time_traits::duration stagger_;
+    Deadline deadline_;
+    MakeConnection make_connection_;
+    Handler handler_;
+    OidMapCache cache_;
+    Connection first_;
+    executor_type executor_;
+    asio::steady_timer stagger_timer_;
+    asio::steady_timer deadline_timer_;
+    std::vector<Connection> attempts_;
+    std::size_t next_ = 0;
+    std::size_t pending_ = 0;
+    bool finished_ = false;
+    bool timed_out_ = false;
+};
+
+/**
+* Connects to one of the hosts of the multi-host connection string racing the attempts,
+* see `connect_race`. The `make_connection` creates a new connection object for an attempt.
+*/
+template <typename TimeConstraint, typename MakeConnection, typename Handler, typename OidMapCache = none_t>
+inline void async_connect_race(std::shared_ptr<const std::vector<std::string>> conninfos,
+        time_traits::duration stagger, const TimeConstraint& t, MakeConnection make_connection,
+        Handler&& handler, OidMapCache cache = OidMapCache{}) {
+    using connection_type = decltype(make_connection());
+    static_assert(ozo::Connection<connection_type>, "make_connection should return Connection");
+    using deadline_type = std::decay_t<decltype(ozo::deadline(t))>;
+    using race_type = connect_race<connection_type, MakeConnection, deadline_type, std::decay_t<Handler>, OidMapCache>;
+
+    auto allocator = asio::get_associated_allocator(handler);
+    std::allocate_shared<race_type>(allocator, std::move(conninfos), stagger, ozo::deadline(t),
+        std::move(make_connection), std::forward<Handler>(handler), std::move(cache))->start();
+}
+
+} // namespace ozo::impl
@@ -8,6 +8,8 @@
 #include <string>
 #include <sstream>
 
+#include <sys/socket.h>
+
 namespace ozo {
 
 namespace detail {
@@ -22,6 +24,17 @@ inline bool connection_status_ok(NativeHandle handle) noexcept {
     return handle && PQstatus(handle) == CONNECTION_OK;
 }
 
+/**
+* Cheap check of an idle connection without a round trip to the server. The data
+* pending on the socket is consumed, so a connection which has been closed by the
+* server, e.g. terminated by an administrator or on the server restart, turns bad.
+* libpq sockets are non-blocking, so the check never waits for the data.
+*/
+template <typename NativeHandle>
+inline bool connection_alive(NativeHandle handle) noexcept {
+    return connection_status_ok(handle) && PQconsumeInput(handle) && PQstatus(handle) == CONNECTION_OK;
+}
+
 template <typename NativeHandleType>
 inline auto connection_error_message(NativeHandleType handle) {
     std::string_view v(PQerrorMessage(handle));
@@ -38,7 +51,7 @@ inline auto connection_error_message(NativeHandleType handle) {
 
 template <typename OidMap, typename Statistics>
 connection<OidMap, Statistics>::connection(io_context& io, Statistics statistics)
-: io_(std::addressof(io)), socket_(*io_), statistics_(std::move(statistics)) {}
+: io_(std::addressof(io)), socket_(detail::get_connection_stream(io.get_executor())), statistics_(std::move(statistics)) {}
 
 template <typename OidMap, typename Statistics>
 error_code connection<OidMap, Statistics>::assign(ozo::pg::conn&& handle) {
@@ -47,23 +60,46 @@ error_code connection<OidMap, Statistics>::assign(ozo::pg::conn&& handle) {
         return error::pq_socket_failed;
     }
 
-    stream_type new_socket(*io_, fd);
+    stream_type new_socket = detail::get_connection_stream(io_->get_executor(), fd);
     socket_.release();
+    detail::apply_socket_options(fd, socket_options_);
+#ifdef SO_BUSY_POLL
+    if (socket_busy_poll_ && busy_poll_ > time_traits::duration::zero()) {
+        // Raising the value above net.core.busy_read requires CAP_NET_ADMIN, the
+        // option is an optimization, so the socket is used without it on a failure.
+        const int usec = static_cast<int>(std::chrono::duration_cast<std::chrono::microseconds>(busy_poll_).count());
+        setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &usec, sizeof(usec));
+    }
+#endif
 
     socket_ = std::move(new_socket);
     handle_ = std::move(handle);
+    statement_cache_.clear();
+    session_settings_.clear();
+    cancel_handle_.reset();
     return {};
 }
 
 template <typename OidMap, typename Statistics>
 ozo::pg::conn connection<OidMap, Statistics>::release() {
     socket_.release();
+    statement_cache_.clear();
+    session_settings_.clear();
+    cancel_handle_.reset();
     ozo::pg::conn retval;
     using std::swap;
     swap(retval, handle_);
     return retval;
 }
 
+template <typename OidMap, typename Statistics>
+pg::shared_cancel connection<OidMap, Statistics>::native_cancel_handle() const {
+    if (!cancel_handle_ && handle_) {
+        cancel_handle_ = pg::make_safe(PQgetCancel(handle_.get()));
+    }
+    return cancel_handle_;
+}
+
 template <typename OidMap, typename Statistics>
 template <typename WaitHandler>
 void connection<OidMap, Statistics>::async_wait_write(WaitHandler&& h) {
@@ -131,12 +167,34 @@ inline const auto& get_error_context(const Connection& conn) {
     return unwrap_connection(conn).get_error_context();
 }
 
+template <typename Connection>
+inline auto& get_statement_cache(Connection& conn) noexcept {
+    static_assert(ozo::Connection<Connection>, "conn should model Connection");
+    return unwrap_connection(conn).statement_cache();
+}
+
 template <typename Connection>
 inline auto get_executor(const Connection& conn) noexcept {
     static_assert(ozo::Connection<Connection>, "conn should model Connection");
     return unwrap_connection(conn).get_executor();
 }
 
+namespace detail {
+/**
+* Returns the executor for the handlers of an operation on the connection. It is a strand of
+* the connection executor unless the connection is not thread-safe.
+*/
+template <typename Connection>
+inline auto make_connection_executor(const Connection& conn) {
+    using connection_type = std::decay_t<decltype(unwrap_connection(conn))>;
+    if constexpr (get_connection_thread_safety<connection_type>::type::value) {
+        return make_strand_executor(get_executor(conn));
+    } else {
+        return get_executor(conn);
+    }
+}
+} // namespace detail
+
 namespace detail {
 inline constexpr std::string_view make_string_view(const char* src) {
     return src == nullptr ? std::string_view{} : std::string_view{src};
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <libpq-fe.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ozo::impl {
+
+/**
+* Connection parameters parsed from a connection string once, so libpq does not
+* parse the string on each connect. Only the explicitly specified parameters are
+* kept, libpq applies the defaults and the environment variables for the rest of
+* them as it does for a connection string.
+*/
+class connection_params {
+public:
+    /**
+    * Returns the value of the parameter or `nullptr` if it is not specified.
+    */
+    const std::string* find(std::string_view keyword) const noexcept {
+        for (const auto& [k, v] : values_) {
+            if (k == keyword) {
+                return std::addressof(v);
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+    * Sets the value of the parameter, adds the parameter if it is not specified.
+    */
+    void set(std::string_view keyword, std::string value) {
+        for (auto& [k, v] : values_) {
+            if (k == keyword) {
+                v = std::move(value);
+                return;
+            }
+        }
+        values_.emplace_back(std::string(keyword), std::move(value));
+    }
+
+    const std::vector<std::pair<std::string, std::string>>& values() const noexcept {
+        return values_;
+    }
+
+private:
+    std::vector<std::pair<std::string, std::string>> values_;
+};
+
+/**
+* Appends the `keyword = 'value'` pair to the connection string with the value quoted
+* as libpq requires.
+*/
+inline void append_conninfo_parameter(std::string& conninfo, const char* keyword, std::string_view value) {
+    if (!conninfo.empty()) {
+        conninfo += ' ';
+    }
+    conninfo += keyword;
+    conninfo += "='";
+    for (const char c : value) {
+        if (c == '\'' || c == '\\') {
+            conninfo += '\\';
+        }
+        conninfo += c;
+    }
+    conninfo += '\'';
+}
+
+/**
+* Makes the connection string of the parameters.
+*/
+inline std::string make_conninfo(const connection_params& params) {
+    std::string result;
+    for (const auto& [k, v] : params.values()) {
+        append_conninfo_parameter(result, k.c_str(), v);
+    }
+    return result;
+}
+
+/**
+* Parses the connection string or URI. Returns `std::nullopt` if the string is
+* invalid, the libpq error message is reported by a connect attempt then.
+*/
+inline std::optional<connection_params> parse_connection_params(const std::string& conninfo) {
+    std::unique_ptr<PQconninfoOption, decltype(&PQconninfoFree)> options(
+        PQconninfoParse(conninfo.c_str(), nullptr), &PQconninfoFree);
+    if (!options) {
+        return std::nullopt;
+    }
+    connection_params result;
+    for (auto option = options.get(); option->keyword; ++option) {
+        if (option->val) {
+            result.set(option->keyword, option->val);
+        }
+    }
+    return result;
+}
+
+/**
+* Starts a connection with the parameters via `PQconnectStartParams`.
+*/
+inline PGconn* connect_start_params(const connection_params& params) {
+    std::vector<const char*> keywords;
+    std::vector<const char*> values;
+    keywords.reserve(params.values().size() + 1);
+    values.reserve(params.values().size() + 1);
+    for (const auto& [k, v] : params.values()) {
+        keywords.push_back(k.c_str());
+        values.push_back(v.c_str());
+    }
+    keywords.push_back(nullptr);
+    values.push_back(nullptr);
+    return PQconnectStartParams(keywords.data(), values.data(), 0);
+}
+
+} // namespace ozo::impl
@@ -5,44 +5,119 @@
 #include <ozo/asio.h>
 #include <ozo/ext/std/shared_ptr.h>
 #include <ozo/detail/make_copyable.h>
+#include <ozo/detail/bind.h>
+#include <ozo/detail/cancellation.h>
+#include <ozo/detail/connect_throttle.h>
+#include <ozo/detail/probes.h>
+#include <ozo/impl/connection_recovery.h>
+#include <ozo/request.h>
+#include <ozo/shortcuts.h>
+
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/post.hpp>
+
+#include <algorithm>
+#include <mutex>
+#include <utility>
+#include <vector>
 
 
 namespace ozo::detail {
 
-template <typename Allocator, typename Executor, typename Rep>
-auto create_pooled_connection(const Allocator& alloc, const Executor& ex, Rep&& rep) {
-    return std::allocate_shared<pooled_connection<std::decay_t<Rep>, Executor>>(alloc, ex, std::forward<Rep>(rep));
+template <typename ThreadSafety = thread_safety<true>, typename Allocator, typename Executor, typename Rep>
+auto create_pooled_connection(const Allocator& alloc, const Executor& ex, Rep&& rep,
+        const pooled_connection_options& options = {}, std::shared_ptr<void> slot = {},
+        std::shared_ptr<idle_stack_t<std::decay_t<Rep>, ThreadSafety>> idle = {}) {
+    using connection = pooled_connection<std::decay_t<Rep>, Executor, ThreadSafety>;
+    if constexpr (ThreadSafety::value) {
+        return std::allocate_shared<connection>(alloc, ex, std::forward<Rep>(rep), options, std::move(slot), std::move(idle));
+    } else {
+        return get_pooled_connection_ptr_t<connection, ThreadSafety>(
+            new connection(ex, std::forward<Rep>(rep), options, std::move(slot), std::move(idle)));
+    }
 }
 
-template <typename Source, typename Handler, typename TimeConstraint>
+template <typename Source, typename Handler, typename TimeConstraint, typename ThreadSafety = thread_safety<true>>
 struct pooled_connection_wrapper {
-    using connection_ptr = typename connection_pool<Source>::connection_type;
+    using connection_ptr = typename connection_pool<Source, ThreadSafety>::connection_type;
     using connection = typename connection_ptr::element_type;
     using handle_type = typename connection::rep_type;
+    using throttle_type = connect_throttle_t<ThreadSafety>;
+    using idle_stack_type = idle_stack_t<handle_type, ThreadSafety>;
 
     typename connection::executor_type io_executor_;
     Source source_;
     detail::make_copyable_t<Handler> handler_;
     TimeConstraint time_constrain_;
+    connection_pool_counters* counters_ = nullptr;
+    time_traits::time_point start_ = {};
+    throttle_type* throttle_ = nullptr;
+    const connection_lifespan* lifespan_ = nullptr;
+    pooled_connection_options options_ = {};
+    std::shared_ptr<void> slot_ = {};
+    std::shared_ptr<idle_stack_type> idle_ = {};
+    connection_budget_member* budget_ = nullptr;
+
+    static void count(connection_pool_counters* counters, std::atomic<std::uint64_t> connection_pool_counters::* counter) noexcept {
+        if (counters) {
+            connection_pool_counters::increment(counters->*counter);
+        }
+    }
+
+    /**
+     * Frees the slot of a connection which is not going to be established, so the requests
+     * waiting in the idle stack for a released connection request the pool for a new one.
+     */
+    static void release_handle(handle_type&& handle, const std::shared_ptr<idle_stack_type>& idle) {
+        {
+            [[maybe_unused]] auto released = std::move(handle);
+        }
+        if (idle) {
+            idle->wake();
+        }
+    }
 
     struct wrapper {
         Handler handler_;
         handle_type handle_;
+        connection_pool_counters* counters_;
+        throttle_type* throttle_ = nullptr;
+        const connection_lifespan* lifespan_ = nullptr;
+        pooled_connection_options options_ = {};
+        std::shared_ptr<void> slot_ = {};
+        std::shared_ptr<idle_stack_type> idle_ = {};
+        std::shared_ptr<void> budget_ = {};
 
         template <typename Conn>
         void operator () (error_code ec, Conn&& conn) {
             static_assert(std::is_same_v<connection_type<Source>, std::decay_t<Conn>>,
                 "Conn should be connection type of Source");
+            count(counters_, ec ? &connection_pool_counters::connect_errors : &connection_pool_counters::created);
+            if (throttle_) {
+                throttle_->release(!ec);
+            }
             if (!is_null(conn)) {
                 auto& target = ozo::unwrap_connection(conn);
 
                 handle_.reset({target.release(), target.oid_map(), target.get_error_context()});
-                auto res = create_pooled_connection(
-                    get_allocator(), target.get_executor(), std::move(handle_)
+                handle_->hold_budget(std::move(budget_));
+                if constexpr (impl::has_hot_statements<std::decay_t<decltype(target)>>::value) {
+                    // The hot statements are prepared by the session setup into the cache of the source connection
+                    handle_->statement_cache() = std::move(target.statement_cache());
+                    handle_->set_hot_statements(target.hot_statements());
+                }
+                if (lifespan_) {
+                    handle_->set_expires_at(lifespan_->expires_at(time_traits::now()));
+                }
+                handle_->count_request();
+                auto res = create_pooled_connection<ThreadSafety>(
+                    get_allocator(), target.get_executor(), std::move(handle_), options_, std::move(slot_), std::move(idle_)
                 );
 
                 handler_(std::move(ec), std::move(res));
             } else {
+                release_handle(std::move(handle_), idle_);
                 handler_(std::move(ec), connection_ptr{});
             }
         }
@@ -60,17 +135,114 @@ struct pooled_connection_wrapper {
         }
     };
 
+    /**
+     * Establishes a new connection for the handle when the throttle permits.
+     * The time of waiting for the permission is included into the time constraint.
+     */
+    template <typename Deadline>
+    struct throttled_connect {
+        typename connection::executor_type io_executor_;
+        Source source_;
+        Deadline deadline_;
+        wrapper wrapper_;
+
+        void operator ()(error_code ec) {
+            if (ec) {
+                release_handle(std::move(wrapper_.handle_), wrapper_.idle_);
+                return wrapper_.handler_(std::move(ec), connection_ptr{});
+            }
+            source_(io_executor_.context(), deadline_, std::move(wrapper_));
+        }
+
+        using executor_type = decltype(asio::get_associated_executor(wrapper_));
+
+        executor_type get_executor() const noexcept {
+            return asio::get_associated_executor(wrapper_);
+        }
+
+        using allocator_type = decltype(asio::get_associated_allocator(wrapper_));
+
+        allocator_type get_allocator() const noexcept {
+            return asio::get_associated_allocator(wrapper_);
+        }
+    };
+
     void operator ()(error_code ec, handle_type&& handle) {
+        OZO_PROBE(pool__acquire__done, ec.value());
+        if (counters_) {
+            connection_pool_counters::decrement(counters_->waiting);
+            counters_->wait_time.add(time_traits::now() - start_);
+        }
+
         if (ec) {
+            if (ec == yamail::resource_pool::error::request_queue_overflow) {
+                count(counters_, &connection_pool_counters::queue_overflows);
+            } else if (ec == yamail::resource_pool::error::get_resource_timeout) {
+                count(counters_, &connection_pool_counters::queue_timeouts);
+            }
             return handler_(std::move(ec), connection_ptr{});
         }
 
-        if (!handle.empty() && !connection_status_bad(handle->safe_native_handle().get())) {
-            auto conn = create_pooled_connection(get_allocator(), io_executor_, std::move(handle));
-            return handler_(std::move(ec), std::move(conn));
+        if (deadline_expired()) {
+            count(counters_, &connection_pool_counters::queue_timeouts);
+            release_handle(std::move(handle), idle_);
+            return handler_(error_code{yamail::resource_pool::error::get_resource_timeout}, connection_ptr{});
         }
 
-        source_(io_executor_.context(), time_constrain_, wrapper{std::move(handler_), std::move(handle)});
+        if (!handle.empty()) {
+            if (connection_status_bad(handle->safe_native_handle().get())) {
+                count(counters_, &connection_pool_counters::closed_bad);
+            } else if (lifespan_ && lifespan_->expired(handle->expires_at(), time_traits::now())) {
+                count(counters_, &connection_pool_counters::expired);
+            } else if (lifespan_ && lifespan_->recycle_due(*handle)) {
+                count(counters_, &connection_pool_counters::recycled);
+            } else {
+                count(counters_, &connection_pool_counters::reused);
+                handle->count_request();
+                auto conn = create_pooled_connection<ThreadSafety>(get_allocator(), io_executor_, std::move(handle),
+                    options_, std::move(slot_), std::move(idle_));
+                return handler_(std::move(ec), std::move(conn));
+            }
+        }
+
+        std::shared_ptr<void> budget;
+        if (!handle.empty()) {
+            // The replacement of a dropped connection takes its share of the budget over
+            budget = handle->release_budget();
+        }
+        if (budget_ && !budget) {
+            budget = budget_->try_acquire();
+            if (!budget) {
+                count(counters_, &connection_pool_counters::budget_rejections);
+                release_handle(std::move(handle), idle_);
+                return handler_(error_code{error::connection_budget_exhausted}, connection_ptr{});
+            }
+        }
+
+        if (throttle_ && throttle_->enabled()) {
+            const auto t = ozo::deadline(time_constrain_);
+            return throttle_->async_acquire(io_executor_, t, throttled_connect<std::decay_t<decltype(t)>> {
+                io_executor_, source_, t,
+                wrapper{std::move(handler_), std::move(handle), counters_, throttle_, lifespan_, options_, std::move(slot_),
+                    std::move(idle_), std::move(budget)}
+            });
+        }
+
+        source_(io_executor_.context(), time_constrain_,
+            wrapper{std::move(handler_), std::move(handle), counters_, nullptr, lifespan_, options_, std::move(slot_),
+                std::move(idle_), std::move(budget)});
+    }
+
+    /**
+     * A request which deadline has expired while it was waiting in the queue can not
+     * use a connection, so it is completed with the timeout instead of being served.
+     */
+    bool deadline_expired() const {
+        if constexpr (std::is_same_v<TimeConstraint, time_traits::time_point>) {
+            return time_constrain_ <= time_traits::now();
+        } else {
+            return false;
+        }
     }
 
     using executor_type = decltype(asio::get_associated_executor(handler_));
@@ -84,17 +256,250 @@ struct pooled_connection_wrapper {
     allocator_type get_allocator() const noexcept {
         return asio::get_associated_allocator(handler_);
     }
+
+    OZO_FORWARD_CANCELLATION_SLOT(handler_)
 };
 
-template <typename Source, typename Executor, typename TimeConstraint, typename Handler>
-auto wrap_pooled_connection_handler(const Executor& ex, Source&& source, TimeConstraint t, Handler&& handler) {
+template <typename ThreadSafety = thread_safety<true>, typename Source, typename Executor, typename TimeConstraint, typename Handler>
+auto wrap_pooled_connection_handler(const Executor& ex, Source&& source, TimeConstraint t, Handler&& handler,
+        connection_pool_counters* counters = nullptr, connect_throttle_t<ThreadSafety>* throttle = nullptr,
+        const connection_lifespan* lifespan = nullptr,
+        const pooled_connection_options& options = {},
+        std::shared_ptr<idle_stack_t<typename pooled_connection_wrapper<std::decay_t<Source>, std::decay_t<Handler>,
+            TimeConstraint, ThreadSafety>::handle_type, ThreadSafety>> idle = {}) {
     static_assert(ConnectionSource<Source>, "is not a ConnectionSource");
 
-    return pooled_connection_wrapper<std::decay_t<Source>, std::decay_t<Handler>, TimeConstraint> {
-        ex, std::forward<Source>(source), std::forward<Handler>(handler), t
+    if (counters) {
+        connection_pool_counters::increment(counters->acquisitions);
+        connection_pool_counters::increment(counters->waiting);
+    }
+
+    return pooled_connection_wrapper<std::decay_t<Source>, std::decay_t<Handler>, TimeConstraint, ThreadSafety> {
+        ex, std::forward<Source>(source), std::forward<Handler>(handler), t, counters,
+        counters ? time_traits::now() : time_traits::time_point{}, throttle, lifespan, options, {}, std::move(idle)
     };
 }
 
+/**
+ * Shared state of parallel connection attempts of `connection_pool::warm_up()`
+ * and `connection_pool::refresh()`. Connections are held until all the attempts
+ * are complete, so each attempt takes a distinct connection from the pool, then
+ * they are returned to the pool before the handler is called.
+ */
+template <typename Connection, typename Handler>
+struct pool_warm_up_state {
+    std::mutex mutex;
+    std::vector<Connection> connections;
+    std::size_t remaining;
+    error_code ec;
+    Handler handler;
+
+    pool_warm_up_state(std::size_t count, Handler handler)
+    : remaining(count), handler(std::move(handler)) {
+        connections.reserve(count);
+    }
+
+    void complete(error_code ec, Connection conn) {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (ec && !this->ec) {
+            this->ec = std::move(ec);
+        }
+        connections.push_back(std::move(conn));
+        if (--remaining != 0) {
+            return;
+        }
+        auto held = std::move(connections);
+        lock.unlock();
+        held.clear();
+        asio::dispatch(detail::bind(std::move(handler), this->ec));
+    }
+};
+
+template <typename Connection, typename Handler>
+struct pool_warm_up_op {
+    using state_type = pool_warm_up_state<Connection, Handler>;
+    using executor_type = asio::associated_executor_t<Handler>;
+
+    std::shared_ptr<state_type> state_;
+    executor_type executor_;
+
+    pool_warm_up_op(std::size_t count, Handler handler)
+    : executor_(asio::get_associated_executor(handler)) {
+        auto allocator = asio::get_associated_allocator(handler);
+        state_ = std::allocate_shared<state_type>(allocator, count, std::move(handler));
+    }
+
+    void operator ()(error_code ec, Connection conn) const {
+        state_->complete(std::move(ec), std::move(conn));
+    }
+
+    executor_type get_executor() const noexcept { return executor_;}
+};
+
+/**
+ * Handles an idle connection taken from the pool by `connection_pool::refresh()`.
+ * A bad connection, a dead one (if idle connections are checked) or one which is
+ * due for the refresh or the recycling is replaced with a new one in place, so the
+ * pool does not lose the slot and requests do not wait for the connect. The memory
+ * of the backend of a connection which is kept is checked if it is due, and the
+ * connection is marked for the recycling if the memory exceeds the threshold.
+ * Nothing is done for an empty handle, i.e. when there is no idle connection.
+ */
+template <typename Source, typename Handle, typename TimeConstraint, typename Op>
+struct pool_refresh_handler {
+    asio::io_context::executor_type io_executor_;
+    Source source_;
+    TimeConstraint time_constrain_;
+    const connection_lifespan* lifespan_;
+    connection_pool_counters* counters_;
+    bool check_idle_;
+    Op op_;
+
+    using counter_type = std::atomic<std::uint64_t> connection_pool_counters::*;
+
+    struct replace {
+        Handle handle_;
+        const connection_lifespan* lifespan_;
+        connection_pool_counters* counters_;
+        counter_type counter_;
+        Op op_;
+
+        template <typename Conn>
+        void operator () (error_code ec, Conn&& conn) {
+            if (ec || is_null(conn)) {
+                if (counters_) {
+                    connection_pool_counters::increment(counters_->connect_errors);
+                }
+                handle_.waste();
+                return op_(std::move(ec), Handle{});
+            }
+            auto& target = ozo::unwrap_connection(conn);
+            auto budget = handle_->release_budget();
+            handle_.reset({target.release(), target.oid_map(), target.get_error_context()});
+            handle_->hold_budget(std::move(budget));
+            handle_->set_expires_at(lifespan_->expires_at(time_traits::now()));
+            if (counters_) {
+                connection_pool_counters::increment(counters_->*counter_);
+            }
+            op_(std::move(ec), std::move(handle_));
+        }
+
+        using executor_type = asio::associated_executor_t<Op>;
+
+        executor_type get_executor() const noexcept { return asio::get_associated_executor(op_);}
+    };
+
+    void operator ()(error_code ec, Handle&& handle) {
+        if (ec || handle.empty()) {
+            return op_(error_code{}, Handle{});
+        }
+        const auto native_handle = handle->safe_native_handle().get();
+        const auto now = time_traits::now();
+        counter_type counter = &connection_pool_counters::refreshed;
+        if (connection_status_bad(native_handle) || (check_idle_ && !connection_alive(native_handle))) {
+            counter = &connection_pool_counters::closed_bad;
+        } else if (lifespan_->recycle_ahead_due(*handle)) {
+            counter = &connection_pool_counters::recycled;
+        } else if (!lifespan_->expired(handle->expires_at(), now)
+                && !lifespan_->refresh_due(handle->expires_at(), now)) {
+            if (lifespan_->memory_check_due(handle->memory_checked_at(), now)) {
+                handle->set_memory_checked_at(now);
+                return check_memory(std::move(handle));
+            }
+            return op_(error_code{}, std::move(handle));
+        }
+        source_(io_executor_.context(), time_constrain_, replace{std::move(handle), lifespan_, counters_, counter, op_});
+    }
+
+    struct memory_checked {
+        typename Handle::value_type* rep_;
+        std::size_t threshold_;
+        std::unique_ptr<std::vector<std::tuple<std::int64_t>>> rows_;
+        Op op_;
+
+        template <typename Conn>
+        void operator () (error_code ec, Conn&& conn) {
+            if (!ec && !rows_->empty() && std::get<0>(rows_->front()) > static_cast<std::int64_t>(threshold_)) {
+                rep_->request_recycle();
+            }
+            {
+                auto released = std::move(conn); // returns the connection to the pool
+            }
+            op_(error_code{}, Handle{});
+        }
+
+        using executor_type = asio::associated_executor_t<Op>;
+
+        executor_type get_executor() const noexcept { return asio::get_associated_executor(op_);}
+    };
+
+    void check_memory(Handle&& handle) {
+        using namespace ozo::literals;
+        auto rep = std::addressof(*handle);
+        auto rows = std::make_unique<std::vector<std::tuple<std::int64_t>>>();
+        auto out = ozo::into(*rows);
+        auto conn = create_pooled_connection(std::allocator<char>{}, io_executor_, std::move(handle));
+        ozo::request(std::move(conn), "SELECT sum(total_bytes)::int8 FROM pg_backend_memory_contexts"_SQL,
+            time_constrain_, out, memory_checked{rep, lifespan_->max_backend_memory, std::move(rows), op_});
+    }
+
+    using executor_type = asio::associated_executor_t<Op>;
+
+    executor_type get_executor() const noexcept { return asio::get_associated_executor(op_);}
+};
+
+/**
+ * Request waiting in the idle stack for a released connection, see `idle_stack`. The timer
+ * is armed under the lock of the stack and cancelled once the request has left the stack,
+ * so the timer is not used concurrently. The request is completed with the timeout if no
+ * connection has been handed to it by the deadline.
+ */
+template <typename Handle, typename Pool, typename Stack, typename Wrapper>
+struct pool_handoff_waiter : handoff_waiter<Handle>,
+        std::enable_shared_from_this<pool_handoff_waiter<Handle, Pool, Stack, Wrapper>> {
+    io_context& io_;
+    Pool& pool_;
+    std::weak_ptr<Stack> stack_;
+    Wrapper wrapper_;
+    asio::steady_timer timer_;
+
+    pool_handoff_waiter(io_context& io, Pool& pool, std::weak_ptr<Stack> stack, Wrapper wrapper,
+            time_traits::time_point deadline)
+    : handoff_waiter<Handle>(deadline), io_(io), pool_(pool), stack_(std::move(stack)),
+      wrapper_(std::move(wrapper)), timer_(io) {}
+
+    void wait() override {
+        timer_.expires_at(this->deadline);
+        timer_.async_wait([self = this->shared_from_this()] (error_code ec) {
+            if (ec) {
+                return;
+            }
+            if (auto stack = self->stack_.lock(); stack && stack->cancel(self.get())) {
+                self->timeout();
+            }
+        });
+    }
+
+    void complete(Handle&& handle) override {
+        timer_.cancel();
+        asio::post(io_.get_executor(), detail::bind(std::move(wrapper_), error_code{}, std::move(handle)));
+    }
+
+    void request() override {
+        timer_.cancel();
+        const auto left = time_left(this->deadline);
+        if (left <= time_traits::duration::zero()) {
+            return timeout();
+        }
+        pool_.get_auto_recycle(io_, std::move(wrapper_), left);
+    }
+
+    void timeout() {
+        asio::post(io_.get_executor(), detail::bind(std::move(wrapper_),
+            error_code{yamail::resource_pool::error::get_resource_timeout}, Handle{}));
+    }
+};
+
 } // namespace ozo::detail
 
 namespace ozo {
@@ -111,70 +516,380 @@ template <typename Source, typename ThreadSafety>
 template <typename TimeConstraint, typename Handler>
 void connection_pool<Source, ThreadSafety>::operator ()(io_context& io, TimeConstraint t, Handler&& handler) {
     static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
-    impl_.get_auto_recycle(
-        io,
-        detail::wrap_pooled_connection_handler(
-            io.get_executor(),
-            source_,
-            t,
-            std::forward<Handler>(handler)
-        ),
-        queue_timeout(t)
+    get_connection(impl_.select(io), io, t, std::forward<Handler>(handler));
+}
+
+template <typename Source, typename ThreadSafety>
+template <typename TimeConstraint, typename Handler>
+void connection_pool<Source, ThreadSafety>::operator ()(io_context& io, TimeConstraint t, Handler&& handler,
+        std::size_t priority) {
+    static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+    get_connection(impl_.select(io), io, t, std::forward<Handler>(handler), priority);
+}
+
+template <typename Source, typename ThreadSafety>
+template <typename TimeConstraint, typename CompletionToken>
+decltype(auto) connection_pool<Source, ThreadSafety>::warm_up(io_context& io, TimeConstraint t, CompletionToken&& token) {
+    static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+    return async_initiate<CompletionToken, void(error_code)>(
+        [this, &io, t] (auto&& handler) {
+            using handler_type = std::decay_t<decltype(handler)>;
+            if (min_idle_ == 0) {
+                asio::post(io.get_executor(), detail::bind(std::move(handler), error_code{}));
+                return;
+            }
+            const detail::pool_warm_up_op<connection_type, handler_type> op{min_idle_, std::move(handler)};
+            for (std::size_t i = 0; i < impl_.size(); ++i) {
+                for (auto n = impl_.share(min_idle_, i); n != 0; --n) {
+                    get_connection(i, io, t, op);
+                }
+            }
+        },
+        token
+    );
+}
+
+template <typename Source, typename ThreadSafety>
+template <typename TimeConstraint, typename CompletionToken>
+decltype(auto) connection_pool<Source, ThreadSafety>::refresh(io_context& io, TimeConstraint t, CompletionToken&& token) {
+    static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+    return async_initiate<CompletionToken, void(error_code)>(
+        [this, &io, t] (auto&& handler) {
+            using handler_type = std::decay_t<decltype(handler)>;
+            using handle_type = yamail::resource_pool::handle<connection_rep_type>;
+            for (auto& stack : idle_stacks_) {
+                stack->flush();
+            }
+            std::vector<std::size_t> idle(impl_.size());
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < impl_.size(); ++i) {
+                idle[i] = impl_[i].available();
+                count += idle[i];
+            }
+            if (count == 0) {
+                asio::post(io.get_executor(), detail::bind(std::move(handler), error_code{}));
+                return;
+            }
+            const detail::pool_warm_up_op<handle_type, handler_type> op{count, std::move(handler)};
+            for (std::size_t i = 0; i < impl_.size(); ++i) {
+                for (auto n = idle[i]; n != 0; --n) {
+                    impl_[i].get_auto_recycle(
+                        io,
+                        detail::pool_refresh_handler<Source, handle_type, TimeConstraint, std::decay_t<decltype(op)>> {
+                            io.get_executor(), source_, t, std::addressof(lifespan_), std::addressof(counters_[i]),
+                            check_idle_, op
+                        },
+                        time_traits::duration(0)
+                    );
+                }
+            }
+        },
+        token
+    );
+}
+
+template <typename Source, typename ThreadSafety>
+template <typename TimeConstraint>
+void connection_pool<Source, ThreadSafety>::start_maintenance(io_context& io, time_traits::duration interval, TimeConstraint t) {
+    static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+    stop_maintenance();
+    maintenance_ = std::make_shared<detail::pool_maintenance>(io);
+    schedule_maintenance(maintenance_, io, interval, t);
+}
+
+template <typename Source, typename ThreadSafety>
+void connection_pool<Source, ThreadSafety>::stop_maintenance() {
+    if (maintenance_) {
+        maintenance_->stop();
+        maintenance_.reset();
+    }
+}
+
+template <typename Source, typename ThreadSafety>
+template <typename TimeConstraint>
+void connection_pool<Source, ThreadSafety>::schedule_maintenance(std::shared_ptr<detail::pool_maintenance> m,
+        io_context& io, time_traits::duration interval, TimeConstraint t) {
+    asio::dispatch(m->strand, [this, m, &io, interval, t] {
+        if (m->stopped) {
+            return;
+        }
+        m->timer.expires_after(interval);
+        m->timer.async_wait(asio::bind_executor(m->strand, [this, m, &io, interval, t] (error_code ec) {
+            if (ec || m->stopped) {
+                return;
+            }
+            refresh(io, t, asio::bind_executor(m->strand, [this, m, &io, interval, t] (error_code) {
+                if (m->stopped) {
+                    return;
+                }
+                if (capacity_->adjustable()) {
+                    adapt_capacity();
+                }
+                schedule_maintenance(std::move(m), io, interval, t);
+            }));
+        }));
+    });
+}
+
+template <typename Source, typename ThreadSafety>
+template <typename TimeConstraint, typename Handler>
+void connection_pool<Source, ThreadSafety>::get_connection(std::size_t shard, io_context& io, TimeConstraint t, Handler&& handler,
+        std::size_t priority) {
+    OZO_PROBE(pool__acquire__start, shard);
+    auto wrapper = detail::wrap_pooled_connection_handler<ThreadSafety>(
+        io.get_executor(),
+        source_,
+        t,
+        std::forward<Handler>(handler),
+        std::addressof(counters_[shard]),
+        throttle_.get(),
+        std::addressof(lifespan_),
+        connection_options_,
+        idle_stacks_.empty() ? nullptr : idle_stacks_[shard]
+    );
+    wrapper.budget_ = budget_.get();
+
+    // The queue of the resource pool does not support cancellation via the slot of the handler
+    if (deadline_queues_.empty()) {
+        return get_handle(shard, io, std::move(wrapper), queue_timeout(t));
+    }
+
+    using handle_type = yamail::resource_pool::handle<connection_rep_type>;
+    const auto deadline = ozo::deadline(t);
+    const auto ex = asio::get_associated_executor(wrapper);
+#ifdef OZO_HAS_CANCELLATION_SLOT
+    const auto cancellation_slot = asio::get_associated_cancellation_slot(wrapper);
+#endif
+    auto on_admission = asio::bind_executor(ex,
+        [this, shard, &io, deadline, wrapper = std::move(wrapper)] (error_code ec, std::shared_ptr<void> slot) mutable {
+            if (ec) {
+                return wrapper(std::move(ec), handle_type{});
+            }
+            wrapper.slot_ = std::move(slot);
+            get_handle(shard, io, std::move(wrapper), queue_timeout(deadline));
+        }
     );
+#ifdef OZO_HAS_CANCELLATION_SLOT
+    // The waiting request is removed from the queue by the cancellation slot of the handler
+    if (cancellation_slot.is_connected()) {
+        return deadline_queues_[shard]->async_acquire(io.get_executor(), deadline,
+            asio::bind_cancellation_slot(cancellation_slot, std::move(on_admission)), priority);
+    }
+#endif
+    deadline_queues_[shard]->async_acquire(io.get_executor(), deadline, std::move(on_admission), priority);
+}
+
+template <typename Source, typename ThreadSafety>
+template <typename Wrapper>
+void connection_pool<Source, ThreadSafety>::get_handle(std::size_t shard, io_context& io, Wrapper&& wrapper,
+        time_traits::duration queue_timeout) {
+    auto& pool = impl_[shard];
+    if (idle_stacks_.empty()) {
+        return pool.get_auto_recycle(io, std::forward<Wrapper>(wrapper), queue_timeout);
+    }
+    auto& stack = idle_stacks_[shard];
+    const auto now = time_traits::now();
+    if (direct_handoff_ && queue_timeout > time_traits::duration::zero()) {
+        using handle_type = yamail::resource_pool::handle<connection_rep_type>;
+        using waiter_type = detail::pool_handoff_waiter<handle_type, std::decay_t<decltype(pool)>, idle_stack_type,
+            std::decay_t<Wrapper>>;
+        auto waiter = std::make_shared<waiter_type>(io, pool, stack, std::forward<Wrapper>(wrapper), now + queue_timeout);
+        auto [handle, waiting] = stack->pop_or_wait(now, waiter);
+        if (!handle.empty()) {
+            asio::post(io.get_executor(), detail::bind(std::move(waiter->wrapper_), error_code{}, std::move(handle)));
+        }
+        return;
+    }
+    auto handle = stack->pop_or(now, [&] {
+        pool.get_auto_recycle(io, std::move(wrapper), queue_timeout);
+    });
+    if (!handle.empty()) {
+        asio::post(io.get_executor(), detail::bind(std::move(wrapper), error_code{}, std::move(handle)));
+    }
+}
+
+template <typename Source, typename ThreadSafety>
+std::size_t connection_pool<Source, ThreadSafety>::set_capacity(std::size_t capacity) {
+    const auto& adapter = capacity_->adapter;
+    capacity = std::clamp(capacity, adapter.min_capacity, adapter.max_capacity);
+    if (capacity_->adjustable()) {
+        const std::lock_guard lock(capacity_->mutex);
+        apply_capacity(capacity);
+    }
+    return capacity;
+}
+
+template <typename Source, typename ThreadSafety>
+std::size_t connection_pool<Source, ThreadSafety>::adapt_capacity() {
+    if (!capacity_->adjustable()) {
+        return capacity();
+    }
+    const std::lock_guard lock(capacity_->mutex);
+    latency_histogram wait_time;
+    std::size_t waiting = 0;
+    std::size_t peak = 0;
+    for (std::size_t i = 0; i < impl_.size(); ++i) {
+        wait_time += counters_[i].wait_time.snapshot();
+        waiting += deadline_queues_[i]->waiting();
+        peak += deadline_queues_[i]->take_peak();
+    }
+    auto recent = wait_time;
+    recent -= std::exchange(capacity_->wait_time, wait_time);
+    const auto result = capacity_->adapter.next(capacity(), recent.quantile(0.9), waiting, peak);
+    apply_capacity(result);
+    return result;
+}
+
+template <typename Source, typename ThreadSafety>
+void connection_pool<Source, ThreadSafety>::apply_capacity(std::size_t capacity) {
+    capacity_->current.store(capacity, std::memory_order_relaxed);
+    for (std::size_t i = 0; i < deadline_queues_.size(); ++i) {
+        deadline_queues_[i]->set_limit(shard_capacity(capacity, i));
+    }
+}
+
+template <typename Source, typename ThreadSafety>
+connection_pool_metrics connection_pool<Source, ThreadSafety>::metrics() const noexcept {
+    connection_pool_metrics result;
+    for (std::size_t i = 0; i < impl_.size(); ++i) {
+        const auto& v = counters_[i];
+        result.acquisitions += v.acquisitions.load(std::memory_order_relaxed);
+        result.reused += v.reused.load(std::memory_order_relaxed);
+        result.created += v.created.load(std::memory_order_relaxed);
+        result.connect_errors += v.connect_errors.load(std::memory_order_relaxed);
+        result.closed_bad += v.closed_bad.load(std::memory_order_relaxed);
+        result.expired += v.expired.load(std::memory_order_relaxed);
+        result.refreshed += v.refreshed.load(std::memory_order_relaxed);
+        result.recycled += v.recycled.load(std::memory_order_relaxed);
+        result.queue_overflows += v.queue_overflows.load(std::memory_order_relaxed);
+        result.queue_timeouts += v.queue_timeouts.load(std::memory_order_relaxed);
+        result.budget_rejections += v.budget_rejections.load(std::memory_order_relaxed);
+        result.waiting += v.waiting.load(std::memory_order_relaxed);
+        result.wait_time += v.wait_time.snapshot();
+    }
+    return result;
 }
 
-template <typename Rep, typename Executor>
-pooled_connection<Rep, Executor>::pooled_connection(const Executor& ex, Rep&& rep)
-: rep_(std::move(rep)), ex_(ex), stream_(get_executor().context()) {
+template <typename Rep, typename Executor, typename ThreadSafety>
+pooled_connection<Rep, Executor, ThreadSafety>::pooled_connection(const Executor& ex, Rep&& rep,
+        const detail::pooled_connection_options& options, std::shared_ptr<void> slot, std::shared_ptr<idle_stack_type> idle)
+: slot_(std::move(slot)), idle_(std::move(idle)), rep_(std::move(rep)), ex_(ex), stream_(get_executor().context()), options_(options) {
     if (auto fd = PQsocket(native_handle()); fd != -1) {
-        stream_.assign(fd);
+        if (!take_registered_stream(fd)) {
+            stream_.assign(fd);
+        }
+    }
+}
+
+template <typename Rep, typename Executor, typename ThreadSafety>
+template <typename NativeHandle>
+bool pooled_connection<Rep, Executor, ThreadSafety>::take_registered_stream([[maybe_unused]] NativeHandle fd) {
+    if constexpr (detail::has_registered_stream<Rep, stream_type>) {
+        if (options_.io_affinity) {
+            if (auto stream = ozo::unwrap(rep_).registered_stream().take(get_executor().context(), fd)) {
+                stream_ = std::move(*stream);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+template <typename Rep, typename Executor, typename ThreadSafety>
+bool pooled_connection<Rep, Executor, ThreadSafety>::keeps_registered_stream() const noexcept {
+    if constexpr (detail::has_registered_stream<Rep, stream_type>) {
+        return options_.io_affinity && !rep_.empty();
+    } else {
+        return false;
+    }
+}
+
+template <typename Rep, typename Executor, typename ThreadSafety>
+void pooled_connection<Rep, Executor, ThreadSafety>::put_registered_stream() {
+    if constexpr (detail::has_registered_stream<Rep, stream_type>) {
+        ozo::unwrap(rep_).registered_stream().put(std::move(stream_));
     }
 }
 
-template <typename Rep, typename Executor>
-typename pooled_connection<Rep, Executor>::native_handle_type
-pooled_connection<Rep, Executor>::native_handle() const noexcept {
+template <typename Rep, typename Executor, typename ThreadSafety>
+typename pooled_connection<Rep, Executor, ThreadSafety>::native_handle_type
+pooled_connection<Rep, Executor, ThreadSafety>::native_handle() const noexcept {
     if (rep_.empty()) {
         return {};
     }
     return ozo::unwrap(rep_).safe_native_handle().get();
 }
 
-template <typename Rep, typename Executor>
+template <typename Rep, typename Executor, typename ThreadSafety>
 template <typename WaitHandler>
-void pooled_connection<Rep, Executor>::async_wait_write(WaitHandler&& h) {
+void pooled_connection<Rep, Executor, ThreadSafety>::async_wait_write(WaitHandler&& h) {
     stream_.async_write_some(asio::null_buffers(), std::forward<WaitHandler>(h));
 }
 
-template <typename Rep, typename Executor>
+template <typename Rep, typename Executor, typename ThreadSafety>
 template <typename WaitHandler>
-void pooled_connection<Rep, Executor>::async_wait_read(WaitHandler&& h) {
+void pooled_connection<Rep, Executor, ThreadSafety>::async_wait_read(WaitHandler&& h) {
     stream_.async_read_some(asio::null_buffers(), std::forward<WaitHandler>(h));
 }
 
-template <typename Rep, typename Executor>
-error_code pooled_connection<Rep, Executor>::close() noexcept {
+template <typename Rep, typename Executor, typename ThreadSafety>
+error_code pooled_connection<Rep, Executor, ThreadSafety>::close() noexcept {
     stream_.release();
+    ozo::unwrap(rep_).statement_cache().clear();
+    ozo::unwrap(rep_).session_settings().clear();
     ozo::unwrap(rep_).safe_native_handle().reset();
     return error_code{};
 }
 
-template <typename Rep, typename Executor>
-void pooled_connection<Rep, Executor>::cancel() noexcept {
+template <typename Rep, typename Executor, typename ThreadSafety>
+void pooled_connection<Rep, Executor, ThreadSafety>::cancel() noexcept {
     error_code _;
     stream_.cancel(_);
 }
 
-template <typename Rep, typename Executor>
-bool pooled_connection<Rep, Executor>::is_bad() const noexcept {
+template <typename Rep, typename Executor, typename ThreadSafety>
+bool pooled_connection<Rep, Executor, ThreadSafety>::is_bad() const noexcept {
     return !detail::connection_status_ok(native_handle());
 }
 
-template <typename Rep, typename Executor>
-pooled_connection<Rep, Executor>::~pooled_connection() {
-    stream_.release();
+template <typename Rep, typename Executor, typename ThreadSafety>
+pooled_connection<Rep, Executor, ThreadSafety>::~pooled_connection() {
+    OZO_PROBE(pool__release, rep_.empty() ? nullptr : native_handle());
+    const bool keep_stream = keeps_registered_stream();
+    if (!keep_stream) {
+        stream_.release();
+    }
     if (!rep_.empty() && (is_bad() || get_transaction_status(*this) != transaction_status::idle)) {
-        rep_.waste();
+        if (keep_stream) {
+            stream_.release();
+        }
+        if (options_.recovery_timeout != time_traits::duration::zero() && !is_bad()) {
+            try {
+                impl::async_recover_connection(
+                    detail::create_pooled_connection<ThreadSafety>(std::allocator<char>{}, ex_, std::move(rep_),
+                        detail::pooled_connection_options{}, std::move(slot_)),
+                    options_.recovery_timeout
+                );
+                if (idle_) {
+                    idle_->wake();
+                }
+                return;
+            } catch (const std::exception&) {
+            }
+        }
+        if (!rep_.empty()) {
+            rep_.waste();
+        }
+        if (idle_) {
+            idle_->wake();
+        }
+        return;
+    }
+    if (keep_stream) {
+        put_registered_stream();
+    }
+    if (idle_ && !rep_.empty()) {
+        idle_->push(rep_, time_traits::now());
     }
 }
 
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <ozo/cancel.h>
+#include <ozo/connection.h>
+#include <ozo/deadline.h>
+#include <ozo/transaction_status.h>
+#include <ozo/impl/io.h>
+#include <ozo/impl/transaction_status.h>
+#include <ozo/detail/deadline.h>
+
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/post.hpp>
+
+#include <memory>
+#include <optional>
+
+namespace ozo::impl {
+
+/**
+* Returns a connection which has been released in the middle of a request or
+* a transaction to the reusable state: cancels the running query, drains its
+* results and rolls the transaction back. The connection is closed if the recovery
+* fails or does not complete before the deadline. Then the connection is released,
+* so it is returned to the pool or wasted by the `pooled_connection` destructor
+* depending on its state.
+*
+* A connection in a COPY state is not recovered since ending the COPY may commit
+* the partially transferred data.
+*/
+template <typename Connection>
+class connection_recovery : public std::enable_shared_from_this<connection_recovery<Connection>> {
+public:
+    explicit connection_recovery(Connection conn)
+    : conn_(std::move(conn)), executor_(detail::make_connection_executor(conn_)) {}
+
+    template <typename Deadline>
+    void start(Deadline deadline) {
+        timer_.emplace(detail::get_operation_timer(get_executor(conn_), deadline));
+        timer_->async_wait(asio::bind_executor(executor_,
+            [self = this->shared_from_this()] (error_code ec) { self->on_deadline(ec); }));
+
+        if (get_transaction_status(conn_) == transaction_status::active) {
+            post_server_cancel{}(conn_);
+        }
+        drain();
+    }
+
+private:
+    using timer_type = typename detail::operation_timer<std::decay_t<decltype(get_executor(std::declval<Connection&>()))>>::type;
+    using executor_type = decltype(detail::make_connection_executor(std::declval<Connection&>()));
+
+    void on_deadline(error_code ec) {
+        if (!ec) {
+            fail();
+        }
+    }
+
+    void drain() {
+        if (done_) {
+            return;
+        }
+        if (consume_input(conn_)) {
+            return fail();
+        }
+        while (!is_busy(conn_)) {
+            const auto result = get_result(conn_);
+            if (!result) {
+                return on_drained();
+            }
+            switch (result_status(*result)) {
+                case PGRES_COPY_IN:
+                case PGRES_COPY_OUT:
+                case PGRES_COPY_BOTH:
+                    return fail();
+                default:
+                    break;
+            }
+        }
+        unwrap_connection(conn_).async_wait_read(asio::bind_executor(executor_,
+            [self = this->shared_from_this()] (error_code ec, auto&& ...) {
+                if (ec) {
+                    return self->fail();
+                }
+                self->drain();
+            }));
+    }
+
+    void on_drained() {
+        switch (get_transaction_status(conn_)) {
+            case transaction_status::idle:
+                return complete();
+            case transaction_status::transaction:
+            case transaction_status::error:
+                if (rollback_sent_ || !send_query(conn_, "ROLLBACK")) {
+                    return fail();
+                }
+                rollback_sent_ = true;
+                return flush();
+            default:
+                return fail();
+        }
+    }
+
+    void flush() {
+        if (done_) {
+            return;
+        }
+        switch (flush_output(conn_)) {
+            case query_state::error:
+                return fail();
+            case query_state::send_in_progress:
+                return unwrap_connection(conn_).async_wait_write(asio::bind_executor(executor_,
+                    [self = this->shared_from_this()] (error_code ec, auto&& ...) {
+                        if (ec) {
+                            return self->fail();
+                        }
+                        self->flush();
+                    }));
+            case query_state::send_finish:
+                return drain();
+        }
+    }
+
+    void complete() {
+        done_ = true;
+        timer_->cancel();
+        conn_ = Connection{};
+    }
+
+    void fail() {
+        if (done_) {
+            return;
+        }
+        done_ = true;
+        timer_->cancel();
+        unwrap_connection(conn_).cancel();
+        close_connection(conn_);
+        conn_ = Connection{};
+    }
+
+    Connection conn_;
+    executor_type executor_;
+    std::optional<timer_type> timer_;
+    bool rollback_sent_ = false;
+    bool done_ = false;
+};
+
+/**
+* Starts the recovery of the connection, the connection is released once the
+* recovery is complete.
+*/
+template <typename Connection, typename TimeConstraint>
+inline void async_recover_connection(Connection&& conn, TimeConstraint t) {
+    static_assert(ozo::Connection<Connection>, "conn should model Connection concept");
+    using operation_type = connection_recovery<std::decay_t<Connection>>;
+    std::make_shared<operation_type>(std::forward<Connection>(conn))->start(ozo::deadline(t));
+}
+
+} // namespace ozo::impl
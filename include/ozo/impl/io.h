@@ -7,11 +7,14 @@
 #include <ozo/detail/bind.h>
 #include <ozo/impl/result_status.h>
 #include <ozo/impl/result.h>
+#include <ozo/impl/connection_params.h>
 
 #include <boost/asio/post.hpp>
 
 #include <libpq-fe.h>
 
+#include <sys/ioctl.h>
+
 namespace ozo::impl {
 
 /**
@@ -33,10 +36,16 @@ inline auto pq_start_connection(const T&, const std::string& conninfo) {
     return ozo::pg::make_safe(PQconnectStart(conninfo.c_str()));
 }
 
+template <typename T>
+inline auto pq_start_connection(const T&, const connection_params& params) {
+    static_assert(Connection<T>, "T must be a Connection");
+    return ozo::pg::make_safe(connect_start_params(params));
+}
+
 } // namespace pq
 
-template <typename T>
-inline auto start_connection(T& conn, const std::string& conninfo) {
+template <typename T, typename ConnInfo>
+inline auto start_connection(T& conn, const ConnInfo& conninfo) {
     static_assert(Connection<T>, "T must be a Connection");
     using pq::pq_start_connection;
     return pq_start_connection(unwrap_connection(conn), conninfo);
@@ -48,8 +57,8 @@ inline int connect_poll(T& conn) {
     return PQconnectPoll(get_native_handle(conn));
 }
 
-template <typename T>
-inline int send_query_params(T& conn, const binary_query& q) noexcept {
+template <typename T, typename BinaryQuery>
+inline int send_query_params(T& conn, const BinaryQuery& q) noexcept {
     static_assert(Connection<T>, "T must be a Connection");
     return PQsendQueryParams(get_native_handle(conn),
                 q.text(),
@@ -62,6 +71,78 @@ inline int send_query_params(T& conn, const binary_query& q) noexcept {
             );
 }
 
+/**
+* Sends the query text via the simple query protocol, so the text may
+* contain several statements. Used for statements which can not have
+* parameters, e.g. `LISTEN`.
+*/
+template <typename T>
+inline int send_query(T& conn, const char* text) noexcept {
+    static_assert(Connection<T>, "T must be a Connection");
+    return PQsendQuery(get_native_handle(conn), text);
+}
+
+template <typename T>
+inline int send_prepare(T& conn, const char* name, const binary_query& q) noexcept {
+    static_assert(Connection<T>, "T must be a Connection");
+    return PQsendPrepare(get_native_handle(conn),
+                name,
+                q.text(),
+                q.params_count(),
+                q.types()
+            );
+}
+
+template <typename T>
+inline int send_prepare(T& conn, const char* name, const char* text, const std::vector<::Oid>& types) noexcept {
+    static_assert(Connection<T>, "T must be a Connection");
+    return PQsendPrepare(get_native_handle(conn),
+                name,
+                text,
+                static_cast<int>(types.size()),
+                types.data()
+            );
+}
+
+template <typename T>
+inline int send_query_prepared(T& conn, const char* name, const binary_query& q) noexcept {
+    static_assert(Connection<T>, "T must be a Connection");
+    return PQsendQueryPrepared(get_native_handle(conn),
+                name,
+                q.params_count(),
+                q.values(),
+                q.lengths(),
+                q.formats(),
+                int(result_format::binary)
+            );
+}
+
+template <typename T>
+inline int send_describe_prepared(T& conn, const char* name) noexcept {
+    static_assert(Connection<T>, "T must be a Connection");
+    return PQsendDescribePrepared(get_native_handle(conn), name);
+}
+
+/**
+* Deallocates the prepared statement on the server. The protocol level Close message
+* is used if libpq supports it: unlike SQL `DEALLOCATE` it is tracked by the connection
+* poolers which manage prepared statements, e.g. PgBouncer in the transaction pooling
+* mode, and it does not fail if the statement does not exist.
+*/
+template <typename T>
+inline int send_deallocate(T& conn, const std::string& name) {
+    static_assert(Connection<T>, "T must be a Connection");
+#ifdef LIBPQ_HAS_CLOSE_PREPARED
+    return PQsendClosePrepared(get_native_handle(conn), name.c_str());
+#else
+    const auto text = "DEALLOCATE " + name;
+    return PQsendQueryParams(get_native_handle(conn),
+                text.c_str(), 0, nullptr, nullptr, nullptr, nullptr,
+                int(result_format::binary)
+            );
+#endif
+}
+
 template <typename T>
 inline error_code set_nonblocking(T& conn) noexcept {
     static_assert(Connection<T>, "T must be a Connection");
@@ -71,6 +152,26 @@ inline error_code set_nonblocking(T& conn) noexcept {
     return {};
 }
 
+template <typename T>
+inline error_code set_single_row_mode(T& conn) noexcept {
+    static_assert(Connection<T>, "T must be a Connection");
+    if (!PQsetSingleRowMode(get_native_handle(conn))) {
+        return error::pg_set_single_row_mode_failed;
+    }
+    return {};
+}
+
+#ifdef LIBPQ_HAS_CHUNK_MODE
+template <typename T>
+inline error_code set_chunked_rows_mode(T& conn, int chunk_size) noexcept {
+    static_assert(Connection<T>, "T must be a Connection");
+    if (!PQsetChunkedRowsMode(get_native_handle(conn), chunk_size)) {
+        return error::pg_set_chunked_rows_mode_failed;
+    }
+    return {};
+}
+#endif
+
 template <typename T>
 inline error_code consume_input(T& conn) noexcept {
     static_assert(Connection<T>, "T must be a Connection");
@@ -80,6 +181,20 @@ inline error_code consume_input(T& conn) noexcept {
     return {};
 }
 
+/**
+* Number of bytes received on the connection socket which have not been read yet,
+* i.e. the bytes which the next `consume_input()` call reads at most.
+*/
+template <typename T>
+inline std::size_t bytes_available(T& conn) noexcept {
+    static_assert(Connection<T>, "T must be a Connection");
+    int bytes = 0;
+    if (ioctl(PQsocket(get_native_handle(conn)), FIONREAD, &bytes) != 0 || bytes < 0) {
+        return 0;
+    }
+    return static_cast<std::size_t>(bytes);
+}
+
 template <typename T>
 inline bool is_busy(T& conn) noexcept {
     static_assert(Connection<T>, "T must be a Connection");
@@ -92,12 +207,96 @@ inline query_state flush_output(T& conn) noexcept {
     return static_cast<query_state>(PQflush(get_native_handle(conn)));
 }
 
+/**
+* Queues COPY data to be sent. The result is similar to `flush_output()`:
+* `query_state::send_in_progress` means the data has not been queued
+* because of full buffers and should be sent again as soon as the connection
+* is write-ready.
+*/
+template <typename T>
+inline query_state put_copy_data(T& conn, const char* data, std::size_t size) noexcept {
+    static_assert(Connection<T>, "T must be a Connection");
+    switch (PQputCopyData(get_native_handle(conn), data, static_cast<int>(size))) {
+        case 1: return query_state::send_finish;
+        case 0: return query_state::send_in_progress;
+    }
+    return query_state::error;
+}
+
+/**
+* Queues the end of COPY data. The result has the same meaning as for `put_copy_data()`.
+*/
+template <typename T>
+inline query_state put_copy_end(T& conn) noexcept {
+    static_assert(Connection<T>, "T must be a Connection");
+    switch (PQputCopyEnd(get_native_handle(conn), nullptr)) {
+        case 1: return query_state::send_finish;
+        case 0: return query_state::send_in_progress;
+    }
+    return query_state::error;
+}
+
+/**
+* Receives a row of COPY data into the buffer. Returns the size of the row,
+* 0 if no row is available yet, -1 if the COPY is done or -2 in case of error.
+*/
+template <typename T>
+inline int get_copy_data(T& conn, pg::copy_data& buffer) noexcept {
+    static_assert(Connection<T>, "T must be a Connection");
+    char* data = nullptr;
+    const auto size = PQgetCopyData(get_native_handle(conn), &data, 1);
+    buffer.reset(data);
+    return size;
+}
+
+/**
+* Takes the next notification received by libpq, returns null handle if
+* there are no more of them. Notifications are received with other input,
+* so `consume_input()` should be called to get new ones.
+*/
+template <typename T>
+inline decltype(auto) get_notification(T& conn) noexcept {
+    static_assert(Connection<T>, "T must be a Connection");
+    return ozo::pg::make_safe(PQnotifies(get_native_handle(conn)));
+}
+
 template <typename T>
 inline decltype(auto) get_result(T& conn) noexcept {
     static_assert(Connection<T>, "T must be a Connection");
     return ozo::pg::make_safe(PQgetResult(get_native_handle(conn)));
 }
 
+#ifdef LIBPQ_HAS_PIPELINING
+
+template <typename T>
+inline error_code enter_pipeline_mode(T& conn) noexcept {
+    static_assert(Connection<T>, "T must be a Connection");
+    if (!PQenterPipelineMode(get_native_handle(conn))) {
+        return error::pg_enter_pipeline_mode_failed;
+    }
+    return {};
+}
+
+template <typename T>
+inline error_code exit_pipeline_mode(T& conn) noexcept {
+    static_assert(Connection<T>, "T must be a Connection");
+    if (!PQexitPipelineMode(get_native_handle(conn))) {
+        return error::pg_exit_pipeline_mode_failed;
+    }
+    return {};
+}
+
+template <typename T>
+inline error_code pipeline_sync(T& conn) noexcept {
+    static_assert(Connection<T>, "T must be a Connection");
+    if (!PQpipelineSync(get_native_handle(conn))) {
+        return error::pg_pipeline_sync_failed;
+    }
+    return {};
+}
+
+#endif
+
 template <typename T>
 inline ExecStatusType result_status(const T& res) noexcept {
     return PQresultStatus(std::addressof(res));
@@ -111,4 +310,16 @@ inline error_code result_error(const T& res) noexcept {
     return error::no_sql_state_found;
 }
 
+template <typename T>
+inline std::size_t result_affected_rows(T& res) noexcept {
+    const char* s = PQcmdTuples(std::addressof(res));
+    return s == nullptr ? 0 : static_cast<std::size_t>(std::strtoull(s, nullptr, 10));
+}
+
+template <typename T>
+inline std::string_view result_error_message(const T& res) noexcept {
+    const char* s = PQresultErrorMessage(std::addressof(res));
+    return s == nullptr ? std::string_view{} : std::string_view{s};
+}
+
 } // namespace ozo::impl
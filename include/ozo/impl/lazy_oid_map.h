@@ -0,0 +1,207 @@
+#pragma once
+
+#include <ozo/io/recv.h>
+#include <ozo/prepared_query.h>
+#include <ozo/query_builder.h>
+#include <ozo/type_traits.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ozo::impl {
+
+template <typename P, typename Q, typename TimeConstraint, typename Out, typename Handler>
+inline void async_request(P&& provider, Q&& query, TimeConstraint t, Out&& out, Handler&& handler);
+
+template <typename T>
+inline T unwrap_type_c(hana::basic_type<T>);
+
+/**
+* Connection which resolves the oids of the custom types on their first use instead of
+* the whole oid map on connect should provide the `lazy_oid_map()` member function
+* which returns true then.
+*/
+template <typename T, typename = std::void_t<>>
+struct has_lazy_oid_map : std::false_type {};
+
+template <typename T>
+struct has_lazy_oid_map<T, std::void_t<decltype(std::declval<const T&>().lazy_oid_map())>> : std::true_type {};
+
+template <typename T>
+struct has_custom_types : std::false_type {};
+
+template <typename ...Ts>
+struct has_custom_types<oid_map_t<Ts...>> : std::bool_constant<(sizeof...(Ts) != 0)> {};
+
+using pending_types = std::vector<std::string_view>;
+
+/**
+* Adds the names of the custom types a value of `T` needs and which oids are not
+* resolved yet: the type itself, the array element type and the composite members.
+*/
+template <typename T, typename ...Ts>
+inline void collect_pending_types(const oid_map_t<Ts...>& oid_map, pending_types& names) {
+    using type = unwrap_type<std::decay_t<T>>;
+    constexpr auto key = hana::type_c<type>;
+    if constexpr (decltype(hana::contains(oid_map.impl, key))::value) {
+        const std::string_view name = type_name<type>();
+        if (oid_map.impl[key] == null_oid && std::find(names.begin(), names.end(), name) == names.end()) {
+            names.push_back(name);
+        }
+        if constexpr (HanaStruct<type> || FusionAdaptedStruct<type>) {
+            detail::for_each_column_type<type>([&] (auto, auto, auto member) {
+                collect_pending_types<typename decltype(member)::type>(oid_map, names);
+            });
+        }
+    }
+    if constexpr (Array<type>) {
+        collect_pending_types<typename type::value_type>(oid_map, names);
+    }
+}
+
+template <typename Query, typename ...Ts>
+inline void collect_query_pending_types(const Query& query, const oid_map_t<Ts...>& oid_map, pending_types& names) {
+    if constexpr (PreparedQuery<Query>) {
+        collect_query_pending_types(query.query, oid_map, names);
+    } else if constexpr (ozo::Query<Query>) {
+        hana::for_each(get_params(query), [&] (const auto& param) {
+            collect_pending_types<decltype(param)>(oid_map, names);
+        });
+    }
+}
+
+/**
+* Row type of the output of a request out handler which defines the `out_type` member type.
+*/
+template <typename T, typename = std::void_t<>>
+struct out_handler_row_type {};
+
+template <typename T>
+struct out_handler_row_type<T, std::void_t<typename detail::result_row_type<typename T::out_type>::type>> {
+    using type = typename detail::result_row_type<typename T::out_type>::type;
+};
+
+template <typename T, typename = std::void_t<>>
+struct has_out_handler_row_type : std::false_type {};
+
+template <typename T>
+struct has_out_handler_row_type<T, std::void_t<typename out_handler_row_type<T>::type>> : std::true_type {};
+
+/**
+* Returns the names of the custom types which are used by the query parameters and
+* the output rows of a request and which oids are not resolved yet.
+*/
+template <typename Query, typename OutHandler, typename ...Ts>
+inline pending_types get_pending_types(const oid_map_t<Ts...>& oid_map, const Query& query, const OutHandler&) {
+    pending_types names;
+    if constexpr (has_custom_types<oid_map_t<Ts...>>::value) {
+        collect_query_pending_types(query, oid_map, names);
+        if constexpr (has_out_handler_row_type<OutHandler>::value) {
+            detail::for_each_column_type<typename out_handler_row_type<OutHandler>::type>([&] (auto, auto, auto column) {
+                collect_pending_types<typename decltype(column)::type>(oid_map, names);
+            });
+        }
+    }
+    return names;
+}
+
+template <typename ...Ts>
+inline void set_type_oids(oid_map_t<Ts...>& oid_map, const pending_types& names, const std::vector<oid_t>& oids) {
+    if (names.size() != oids.size()) {
+        throw std::length_error(std::string("result size ")
+            + std::to_string(oids.size())
+            + " does not match to pending types count "
+            + std::to_string(names.size()));
+    }
+
+    hana::for_each(hana::keys(oid_map.impl), [&] (const auto& key) {
+        const std::string_view name = type_name<decltype(unwrap_type_c(key))>();
+        const auto i = std::find(names.begin(), names.end(), name);
+        if (i == names.end()) {
+            return;
+        }
+        const auto oid = oids[static_cast<std::size_t>(i - names.begin())];
+        if (oid == null_oid) {
+            throw std::invalid_argument(
+                std::string("null oid for type ")
+                + boost::core::demangle(typeid(key).name())
+                + " which is mapped as "
+                + std::string(name));
+        }
+        oid_map.impl[key] = oid;
+    });
+}
+
+/**
+* Resolves the oids of the pending custom types of a connection with a single
+* request and then calls the handler with the connection, so the operation which
+* needs the types continues with the resolved ones.
+*/
+template <typename Handler>
+struct resolve_pending_types_op {
+    struct context {
+        Handler handler_;
+        pending_types names_;
+        std::vector<oid_t> oids_;
+        context(Handler&& handler, pending_types&& names)
+        : handler_(std::move(handler)), names_(std::move(names)) {}
+    };
+
+    std::shared_ptr<context> ctx_;
+
+    template <typename Connection>
+    resolve_pending_types_op(Connection& conn, pending_types names, Handler handler) {
+        auto allocator = detail::get_operation_allocator(conn, handler);
+        ctx_ = std::allocate_shared<context>(allocator, std::move(handler), std::move(names));
+    }
+
+    template <typename Connection, typename TimeConstraint>
+    void perform(Connection&& conn, TimeConstraint t) {
+        using namespace literals;
+        ctx_->oids_.reserve(ctx_->names_.size());
+        async_request(std::forward<Connection>(conn),
+            "SELECT COALESCE(to_regtype(f)::oid, 0) AS oid FROM UNNEST("_SQL + ctx_->names_ + ") AS f"_SQL,
+            t, std::back_inserter(ctx_->oids_), std::move(*this));
+    }
+
+    template <typename Connection>
+    void operator() (error_code ec, Connection&& conn) {
+        if (!ec) try {
+            set_type_oids(ozo::unwrap_connection(conn).oid_map(), ctx_->names_, ctx_->oids_);
+        } catch (const std::exception& e) {
+            unwrap_connection(conn).set_error_context(e.what());
+            ec = error::oid_request_failed;
+        }
+        ctx_->handler_(ec, std::forward<Connection>(conn));
+    }
+
+    using executor_type = asio::associated_executor_t<Handler>;
+
+    executor_type get_executor() const noexcept {
+        return asio::get_associated_executor(ctx_->handler_);
+    }
+
+    using allocator_type = asio::associated_allocator_t<Handler>;
+
+    allocator_type get_allocator() const noexcept {
+        return asio::get_associated_allocator(ctx_->handler_);
+    }
+};
+
+template <typename T>
+struct is_resolve_pending_types_op : std::false_type {};
+
+template <typename Handler>
+struct is_resolve_pending_types_op<resolve_pending_types_op<Handler>> : std::true_type {};
+
+template <typename Connection, typename TimeConstraint, typename Handler>
+inline void resolve_pending_types(Connection&& conn, pending_types names, TimeConstraint t, Handler&& handler) {
+    resolve_pending_types_op<std::decay_t<Handler>> op{ozo::unwrap_connection(conn), std::move(names),
+        std::forward<Handler>(handler)};
+    op.perform(std::forward<Connection>(conn), t);
+}
+
+} // namespace ozo::impl
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <ozo/connection.h>
+#include <ozo/error.h>
+#include <ozo/io/recv.h>
+
+#include <boost/asio/post.hpp>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace ozo::impl {
+
+/**
+* Shared state of a result which rows are received by partitions concurrently.
+* The continuation is called by the last finished partition with the first error
+* occurred.
+*/
+template <typename Result, typename OidMap, typename Continuation>
+struct parallel_recv_state {
+    Result result;
+    OidMap oid_map;
+    Continuation continuation;
+    std::atomic<std::size_t> partitions;
+    std::mutex mutex;
+    std::string error_context;
+    bool failed = false;
+
+    parallel_recv_state(Result result, const OidMap& oid_map, Continuation continuation, std::size_t partitions)
+    : result(std::move(result)), oid_map(oid_map), continuation(std::move(continuation)), partitions(partitions) {}
+
+    template <typename Out>
+    void process(std::size_t first, std::size_t last, Out out) noexcept {
+        try {
+            ozo::detail::recv_rows(result, first, last, oid_map, out);
+        } catch (const std::exception& e) {
+            const std::lock_guard<std::mutex> lock(mutex);
+            if (!failed) {
+                failed = true;
+                error_context = e.what();
+            }
+        }
+
+        if (partitions.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            continuation(failed ? error_code{error::bad_result_process} : error_code{},
+                std::move(error_context));
+        }
+    }
+};
+
+/**
+* Asynchronous result processor which receives rows of a result into a random
+* access container by partitions of rows on the given executor. Results which
+* do not exceed one partition are received in place.
+*/
+template <typename Container, typename Executor>
+struct parallel_out_handler {
+    using async_result_processor_tag = void;
+
+    std::reference_wrapper<Container> rows;
+    Executor executor;
+    std::size_t partition_size;
+
+    template <typename Handle, typename Conn>
+    void operator() (Handle&& h, Conn& conn) {
+        auto res = ozo::make_result(std::forward<Handle>(h));
+        ozo::recv_result(res, ozo::unwrap_connection(conn).oid_map(), std::back_inserter(rows.get()));
+    }
+
+    template <typename Handle, typename Conn, typename Continuation>
+    void async_process(Handle&& h, Conn& conn, Continuation&& c) {
+        auto res = ozo::make_result(std::forward<Handle>(h));
+        const auto size = std::size(res);
+        if (size <= partition_size) {
+            ozo::recv_result(res, ozo::unwrap_connection(conn).oid_map(), std::back_inserter(rows.get()));
+            return c(error_code{}, std::string{});
+        }
+
+        auto& out = rows.get();
+        const auto offset = std::size(out);
+        out.resize(offset + size);
+
+        const auto partitions = (size + partition_size - 1) / partition_size;
+        using state_type = parallel_recv_state<
+            decltype(res),
+            std::decay_t<decltype(ozo::unwrap_connection(conn).oid_map())>,
+            std::decay_t<Continuation>
+        >;
+        auto allocator = asio::get_associated_allocator(c);
+        auto state = std::allocate_shared<state_type>(allocator, std::move(res), ozo::unwrap_connection(conn).oid_map(),
+            std::forward<Continuation>(c), partitions);
+
+        for (std::size_t first = 0; first < size; first += partition_size) {
+            const auto last = std::min(first + partition_size, size);
+            asio::post(executor, [state, first, last, i = std::begin(out) + offset + first] {
+                state->process(first, last, i);
+            });
+        }
+    }
+};
+
+} // namespace ozo::impl
@@ -5,9 +5,6 @@
 
 namespace ozo::impl {
 
-template <typename T>
-inline T unwrap_type_c(hana::basic_type<T>);
-
 template <typename ...Ts>
 inline auto get_types_names(const oid_map_t<Ts...>& oid_map) {
     return hana::unpack(hana::keys(oid_map.impl), [](auto const& ...x) {
@@ -26,6 +23,12 @@ inline auto make_oids_query(const oid_map_t<Ts...>& oid_map) {
 
 using oids_result = std::vector<oid_t>;
 
+template <typename Connection>
+constexpr bool OidMapEmpty = std::is_same_v<
+    typename std::decay_t<decltype(ozo::unwrap_connection(std::declval<Connection>()))>::oid_map_type,
+    ozo::empty_oid_map
+>;
+
 template <typename ...Ts>
 inline void set_oid_map(oid_map_t<Ts...>& oid_map, const oids_result& res) {
     if (hana::length(oid_map.impl).value != res.size()) {
@@ -66,6 +69,12 @@ struct request_oid_map_op {
         ctx_ = std::allocate_shared<context>(allocator, std::move(handler));
     }
 
+    template <typename Connection>
+    request_oid_map_op(Connection& conn, Handler handler) {
+        auto allocator = detail::get_operation_allocator(conn, handler);
+        ctx_ = std::allocate_shared<context>(allocator, std::move(handler));
+    }
+
     template <typename Connection>
     void perform(Connection&& conn) {
         const auto oid_map = ozo::unwrap_connection(conn).oid_map();
@@ -33,6 +33,10 @@ inline bool pq_get_isnull(const PGresult& res, int row, int column) noexcept {
     return PQgetisnull(std::addressof(res), row, column);
 }
 
+inline const char* pq_field_name(const PGresult& res, int column) noexcept {
+    return PQfname(std::addressof(res), column);
+}
+
 inline int pq_field_number(const PGresult& res, const char* name) noexcept {
     return PQfnumber(std::addressof(res), name);
 }
@@ -77,6 +81,12 @@ inline bool get_isnull(T&& res, int row, int column) noexcept {
     return pq_get_isnull(std::forward<T>(res), row, column);
 }
 
+template <typename T>
+inline const char* field_name(T&& res, int column) noexcept {
+    using pq::pq_field_name;
+    return pq_field_name(std::forward<T>(res), column);
+}
+
 template <typename T>
 inline int field_number(T&& res, const char* name) noexcept {
     using pq::pq_field_number;
@@ -35,6 +35,26 @@ static_assert(std::is_same_v<
     decltype(std::declval<ozo::transaction<ozo::connection<ozo::empty_oid_map, ozo::no_statistics>, decltype(ozo::make_options())>>().lowest_layer())>,
     "ozo::unwrap_connection() should return underlying connection");
 
+/**
+ * A transaction with the deferred BEGIN statement pending sends the statement
+ * before it is provided for an operation which does not send it by itself. The
+ * statement is not elided for such operation since it may execute several ones.
+ */
+template <typename Connection, typename Options, typename TimeConstraint>
+struct async_get_connection_impl<transaction<Connection, Options>, TimeConstraint> {
+    template <typename T, typename Handler>
+    static void apply(T&& transaction, TimeConstraint t, Handler&& h) {
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        if constexpr (!impl::sends_pending_begin<std::decay_t<Handler>>::value) {
+            if (transaction.is_begin_pending() || transaction.is_begin_elidable()) {
+                const auto query = transaction.begin_statement();
+                return impl::async_execute(std::forward<T>(transaction), query, t, std::forward<Handler>(h));
+            }
+        }
+        detail::forward_connection::apply(std::forward<T>(transaction), t, std::forward<Handler>(h));
+    }
+};
+
 namespace detail {
 
 template <typename Handler, typename Options>
@@ -46,8 +66,12 @@ struct async_start_transaction_op {
     void perform(T&& provider, Query&& query, TimeConstraint t) {
         static_assert(ConnectionProvider<T>, "T is not a ConnectionProvider");
         static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
-        async_execute(std::forward<T>(provider), std::forward<Query>(query),
-            t, std::move(*this));
+        if constexpr (begin_deferred) {
+            async_get_connection(std::forward<T>(provider), deadline(t), std::move(*this));
+        } else {
+            async_execute(std::forward<T>(provider), std::forward<Query>(query),
+                t, std::move(*this));
+        }
     }
 
     template <typename Connection>
@@ -60,6 +84,8 @@ struct async_start_transaction_op {
             )
         );
     }
+
+    static constexpr bool begin_deferred = is_begin_deferred<Options>::value;
 };
 
 template <typename Handler, typename Options>
@@ -87,6 +113,10 @@ struct async_end_transaction_op {
     void perform(T&& provider, Query&& query, TimeConstraint t) {
         static_assert(Connection<T>, "T is not a Connection");
         static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        if (provider.is_begin_pending() || provider.is_begin_elidable()) {
+            // Nothing has been sent within the transaction, so there is nothing to end.
+            return (*this)(error_code{}, std::decay_t<T>(std::forward<T>(provider)));
+        }
         using ozo::impl::async_execute;
         async_execute(std::forward<T>(provider), std::forward<Query>(query), t, std::move(*this));
     }
@@ -3,12 +3,19 @@
 #include <ozo/type_traits.h>
 #include <ozo/io/send.h>
 #include <ozo/io/recv.h>
+#include <ozo/io/composite.h>
+#include <ozo/detail/bulk.h>
+#include <ozo/detail/endian.h>
+#include <ozo/detail/float.h>
 #include <boost/hana/adapt_struct.hpp>
 #include <boost/hana/size.hpp>
 #include <boost/hana/fold.hpp>
 #include <boost/fusion/adapted/struct/adapt_struct.hpp>
 #include <boost/range/numeric.hpp>
 #include <boost/range/algorithm/for_each.hpp>
+#include <boost/range/iterator_range_core.hpp>
+
+#include <cstring>
 
 namespace ozo {
 
@@ -84,12 +91,136 @@ struct pg_array_dimension {
 
 namespace ozo::detail {
 
+/**
+ * Array elements with fixed size binary representation, see `ozo::detail::bulk_item`,
+ * e.g. arithmetic types and timestamps, are sent and received by a single pass over
+ * a contiguous block of frames. The loop has no branches so the compiler is able
+ * to vectorize it.
+ */
+template <typename T, typename = std::void_t<>>
+struct is_bulk_array : std::false_type {};
+
+template <typename T>
+struct is_bulk_array<T, std::void_t<decltype(std::data(std::declval<T&>()))>> : std::bool_constant<
+    BulkItem<typename T::value_type>
+    && std::is_same_v<decltype(std::data(std::declval<T&>())), typename T::value_type*>
+> {};
+
+template <typename T>
+inline constexpr auto BulkArray = is_bulk_array<std::decay_t<T>>::value;
+
+/**
+ * Count of elements of an array to send, a range without `size()`, e.g. a transformed
+ * range over a list, is counted by a pass over it.
+ */
+template <typename T>
+inline auto send_array_size(const T& v) noexcept -> decltype(std::size(v)) {
+    return std::size(v);
+}
+
+template <typename T, typename ...Ts>
+inline std::size_t send_array_size(const T& v, const Ts& ...) noexcept {
+    return static_cast<std::size_t>(std::distance(std::begin(v), std::end(v)));
+}
+
+/**
+ * Pointer to the contiguous elements of an array to send, the range over pointers
+ * is contiguous as well as a container or a span.
+ */
+template <typename T>
+inline auto send_array_data(const T& v) noexcept -> decltype(std::data(v)) {
+    return std::data(v);
+}
+
+template <typename T>
+inline const T* send_array_data(const boost::iterator_range<T*>& v) noexcept {
+    return v.begin();
+}
+
+template <typename T, typename = std::void_t<>>
+struct is_bulk_send_array : std::false_type {};
+
+template <typename T>
+struct is_bulk_send_array<T, std::void_t<decltype(send_array_data(std::declval<const T&>()))>> : std::bool_constant<
+    BulkItem<typename T::value_type>
+    && std::is_same_v<
+        std::remove_cv_t<std::remove_pointer_t<decltype(send_array_data(std::declval<const T&>()))>>,
+        typename T::value_type
+    >
+> {};
+
+template <typename T>
+inline constexpr auto BulkSendArray = is_bulk_send_array<std::decay_t<T>>::value;
+
+template <typename T>
+constexpr std::streamsize bulk_array_frame_size = sizeof(size_type) + bulk_item<T>::size;
+
+template <typename T>
+constexpr std::uint32_t bulk_array_frame_header() noexcept {
+    return static_cast<std::uint32_t>(convert_to_big_endian(static_cast<size_type>(bulk_item<T>::size)));
+}
+
+template <typename T>
+inline void send_bulk_array_items(const T* in, size_type count, char* out) noexcept {
+    constexpr auto header = bulk_array_frame_header<T>();
+    for (size_type i = 0; i < count; ++i, out += bulk_array_frame_size<T>) {
+        std::memcpy(out, &header, sizeof(header));
+        bulk_item<T>::store(in[i], out + sizeof(header));
+    }
+}
+
+template <typename T>
+inline bool recv_bulk_array_items(const char* in, size_type count, T* out) noexcept {
+    constexpr auto header = bulk_array_frame_header<T>();
+    bool valid = true;
+    for (size_type i = 0; i < count; ++i, in += bulk_array_frame_size<T>) {
+        std::uint32_t size;
+        std::memcpy(&size, in, sizeof(size));
+        valid &= (size == header);
+        out[i] = bulk_item<T>::load(in + sizeof(size));
+    }
+    return valid;
+}
+
+template <typename T>
+inline void send_bulk_array(ostream& out, const T& in) {
+    using item_type = typename T::value_type;
+    const auto count = static_cast<size_type>(send_array_size(in));
+    send_bulk_array_items(send_array_data(in), count,
+        out.extend(std::streamsize(count) * bulk_array_frame_size<item_type>));
+}
+
+/**
+ * Receives all the elements by a single pass if all the frames have the size of
+ * the element type, i.e. there are no nulls and malformed frames. Returns `false`
+ * without extracting data from the stream otherwise, so the caller could receive
+ * the elements one by one to report an error accurately.
+ */
+template <typename T>
+inline bool recv_bulk_array(istream& in, size_type count, T& out) {
+    using item_type = typename T::value_type;
+    if (std::size(out) != static_cast<std::size_t>(count)) {
+        return false;
+    }
+    const auto size = std::streamsize(count) * bulk_array_frame_size<item_type>;
+    const auto data = in.peek(size);
+    if (!data || !recv_bulk_array_items(data, count, std::data(out))) {
+        return false;
+    }
+    in.skip(size);
+    return true;
+}
+
+} // namespace ozo::detail
+
+namespace ozo::detail {
+
 template <typename T>
 struct size_of_array_impl {
     constexpr static size_type data_size(const T& v) {
         using ozo::size_of;
         if constexpr (StaticSize<typename T::value_type>) {
-            return std::empty(v) ? 0 : data_frame_size(*std::begin(v)) * std::size(v);
+            return std::begin(v) == std::end(v) ? 0 : data_frame_size(*std::begin(v)) * size_type(send_array_size(v));
         }
         return boost::accumulate(v, size_type(0),
             [&] (auto r, const auto& item) { return r + data_frame_size(item);});
@@ -117,8 +248,15 @@ struct send_array_impl {
     static ostream& apply(ostream& out, const OidMap& oid_map, const T& in) {
         using value_type = typename T::value_type;
         write(out, pg_array {1, 0, type_oid<value_type>(oid_map)});
-        write(out, pg_array_dimension {std::int32_t(std::size(in)), 0});
-        boost::for_each(in, [&] (const auto& v) { send_data_frame(out, oid_map, v);});
+        write(out, pg_array_dimension {std::int32_t(send_array_size(in)), 0});
+        if constexpr (BulkSendArray<T>) {
+            send_bulk_array(out, in);
+        } else if constexpr (Composite<value_type>) {
+            const auto header = make_composite_send_header<value_type>(oid_map);
+            boost::for_each(in, [&] (const auto& v) { send_composite_data_frame(out, oid_map, v, header);});
+        } else {
+            boost::for_each(in, [&] (const auto& v) { send_data_frame(out, oid_map, v);});
+        }
         return out;
     }
 };
@@ -126,6 +264,15 @@ struct send_array_impl {
 template <typename T>
 struct send_impl_dispatcher<T, Require<Array<T>>> { using type = send_array_impl<std::decay_t<T>>; };
 
+template <typename T, typename = std::void_t<>>
+struct is_clearable : std::false_type {};
+
+template <typename T>
+struct is_clearable<T, std::void_t<decltype(std::declval<T&>().clear())>> : std::true_type {};
+
+template <typename T>
+inline constexpr auto Clearable = is_clearable<T>::value;
+
 template <typename T>
 struct recv_array_impl {
     using out_type = T;
@@ -152,22 +299,59 @@ struct recv_array_impl {
         }
 
         if (array_header.dimensions_count < 1) {
+            clear_array(out);
             return in;
         }
 
         read(in, dim_header);
 
         if (dim_header.size == 0) {
+            clear_array(out);
             return in;
         }
 
         fit_array_size(out, dim_header.size);
 
-        for (auto& item : out) {
-            recv_data_frame(in, oids, item);
+        if constexpr (BulkArray<out_type>) {
+            if (recv_bulk_array(in, dim_header.size, out)) {
+                return in;
+            }
+        }
+
+        if constexpr (Composite<typename out_type::value_type>) {
+            composite_layout<typename out_type::value_type> layout;
+            for (auto& item : out) {
+                recv_composite_data_frame(in, oids, item, layout);
+            }
+        } else {
+            for (auto& item : out) {
+                allocate_array_item(out, item);
+                recv_data_frame(in, oids, item);
+            }
         }
         return in;
     }
+
+    // An empty array clears the container received into, e.g. an element of a row
+    // which is received over an existing one, see `ozo::overwrite_rows`.
+    static void clear_array([[maybe_unused]] out_type& out) {
+        if constexpr (Clearable<out_type>) {
+            out.clear();
+        }
+    }
+
+    // A nullable element is allocated by the allocator of the container, so its value
+    // takes the memory resource of the container, e.g. `std::pmr::vector<std::optional<std::pmr::string>>`.
+    template <typename Item>
+    static void allocate_array_item([[maybe_unused]] const out_type& out, [[maybe_unused]] Item& item) {
+        if constexpr (AllocatorAwareContainer<out_type> && Nullable<Item>) {
+            if constexpr (std::uses_allocator_v<unwrap_type<Item>, typename out_type::allocator_type>) {
+                if (ozo::is_null(item)) {
+                    allocate_nullable(item, out.get_allocator());
+                }
+            }
+        }
+    }
 };
 
 template <typename T>
@@ -11,6 +11,7 @@
 #include <ozo/optional.h>
 #include <ozo/pg/types.h>
 
+#include <boost/hana/all_of.hpp>
 #include <boost/hana/for_each.hpp>
 #include <boost/hana/tuple.hpp>
 #include <boost/hana/ext/std/array.hpp>
@@ -20,11 +21,420 @@
 #include <array>
 #include <iterator>
 #include <memory>
+#include <stdexcept>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 namespace ozo {
 
+namespace detail {
+constexpr std::size_t binary_query_small_buffer_size = 128;
+
+template <std::size_t N>
+constexpr std::array<int, N> make_binary_formats() noexcept {
+    std::array<int, N> result {};
+    for (auto& v : result) {
+        v = 1;
+    }
+    return result;
+}
+
+// Formats of the parameters are the same for all the queries with the same
+// parameters count, so the queries share them.
+template <std::size_t N>
+inline constexpr std::array<int, N> binary_formats = make_binary_formats<N>();
+
+struct is_built_in_param {
+    template <typename T>
+    constexpr auto operator ()(const T&) const noexcept {
+        return hana::bool_c<BuiltIn<T>>;
+    }
+};
+
+// Types of the parameters of built-in types are known at compile time, so the
+// queries with such parameters only share them instead of storing their own.
+template <typename Params>
+inline constexpr bool BuiltInParams = decltype(hana::all_of(std::declval<const Params&>(), is_built_in_param {}))::value;
+
+template <typename ...Ts>
+inline constexpr std::array<oid_t, sizeof...(Ts)> built_in_type_oids {oid_t(typename type_traits<Ts>::oid())...};
+
+} // namespace detail
+
+/**
+ * @brief Condition indicates if a query parameter is passed to libpq without copying
+ *
+ * A borrowed parameter is not serialized into the buffer of the query, instead the
+ * query parameter value points straight to the memory of the parameter object. This
+ * eliminates copying of large contiguous parameters, e.g. blobs. So the memory the
+ * parameter refers to should outlive the request operation.
+ *
+ * By default, view types are borrowed: `std::string_view` and `ozo::pg::bytea_view`.
+ * Nullable wrappers and strong typedefs of borrowed types are borrowed too.
+ *
+ * ### Customization point
+ *
+ * A type may be made borrowed via specialization of the template. Its binary
+ * representation should be the contiguous sequence of `std::size(v)` bytes
+ * starting from `std::data(v)`.
+ *
+ * @tparam T --- unwrapped parameter type.
+ * @ingroup group-io-types
+ */
+template <typename T, typename = std::void_t<>>
+struct is_borrowed_parameter : std::false_type {};
+
+template <>
+struct is_borrowed_parameter<std::string_view> : std::true_type {};
+
+template <typename T, typename Tag>
+struct is_borrowed_parameter<strong_typedef_wrapper<T, Tag>> : is_borrowed_parameter<T> {};
+
+//! @cond
+template <typename T>
+inline constexpr auto BorrowedParameter = is_borrowed_parameter<std::decay_t<unwrap_type<std::decay_t<T>>>>::value;
+//! @endcond
+
+namespace detail {
+
+template <typename T>
+inline const char* borrowed_data(const T& v) noexcept {
+    if constexpr (StrongTypedef<T>) {
+        return borrowed_data(v.get());
+    } else {
+        return std::data(v);
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Binary protocol query representation with statically known parameters types.
+ *
+ * The `typed_binary_query` holds the same data as `ozo::binary_query` but without
+ * type erasure: parameters types, formats, lengths and values pointers are stored in
+ * inline `std::array` objects, and parameters binary representations which fit
+ * `small_buffer_size` bytes are stored inline too. So there is no virtual call,
+ * reference counting and no memory allocation for small queries. It may be passed
+ * to the request functions directly to avoid the conversion to the `ozo::binary_query`.
+ * Unlike `ozo::binary_query` copy of a `typed_binary_query` copies its data.
+ *
+ * Parameters which model `ozo::BorrowedParameter`, e.g. `std::string_view` or `ozo::pg::bytea_view`,
+ * are not copied at all, the query refers to their memory, so it should outlive the query.
+ *
+ * @tparam Text      --- query text type, should model `QueryText` concept.
+ * @tparam Params    --- query parameters type, should model `HanaSequence` concept.
+ * @tparam OidMap    --- `OidMap` type which is used within connection.
+ * @tparam Allocator --- allocator type which is used to allocate data for parameters
+ *                       which do not fit the small buffer, default is `std::allocator<char>`.
+ *
+ * @models{BinaryQueryConvertible}
+ *
+ * @ingroup group-query-types
+ */
+template <class Text, class Params, class OidMap, class Allocator = std::allocator<char>>
+class typed_binary_query {
+    static_assert(ozo::HanaSequence<Params>, "Params should be Hana.Sequence");
+    static_assert(ozo::OidMap<OidMap>, "OidMap should model ozo::OidMap");
+    static_assert(ozo::QueryText<Text>, "Text should model ozo::QueryText concept");
+
+public:
+    /**
+     * Size of the inline buffer for parameters binary representation.
+     */
+    static constexpr std::size_t small_buffer_size = detail::binary_query_small_buffer_size;
+
+    using allocator_type = std::conditional_t<
+                            std::is_same_v<typename Allocator::value_type, char>,
+                                Allocator,
+                                typename std::allocator_traits<Allocator>::template rebind_alloc<char>>;
+    using buffer_type = std::vector<char, allocator_type>;
+    using oid_map_type = OidMap;
+    using text_type = std::decay_t<Text>;
+    using params_type = Params;
+
+    /**
+     * Construct a new typed binary query object.
+     *
+     * @param text      --- query text object, should model `QueryText` concept.
+     * @param params    --- query parameters object, should model `HanaSequence` concept.
+     * @param oid_map   --- `OidMap` which is used within connection.
+     * @param allocator --- allocator object which should be used to allocate parameters data,
+     *                      default is `std::allocator<char>`.
+     */
+    typed_binary_query(Text text, const Params& params, const OidMap& oid_map, const Allocator& allocator = Allocator{})
+    : text_(std::move(text)), buffer_(allocator) {
+        assign_params(params, oid_map);
+    }
+
+    typed_binary_query(const typed_binary_query& other)
+    : text_(other.text_), small_buffer_(other.small_buffer_), buffer_(other.buffer_),
+      types_(other.types_), lengths_(other.lengths_), values_(other.values_) {
+        update_values();
+    }
+
+    typed_binary_query(typed_binary_query&& other)
+    : text_(std::move(other.text_)), small_buffer_(other.small_buffer_), buffer_(std::move(other.buffer_)),
+      types_(other.types_), lengths_(other.lengths_), values_(other.values_) {
+        update_values();
+    }
+
+    typed_binary_query& operator =(const typed_binary_query& other) {
+        if (this != std::addressof(other)) {
+            text_ = other.text_;
+            small_buffer_ = other.small_buffer_;
+            buffer_ = other.buffer_;
+            types_ = other.types_;
+            lengths_ = other.lengths_;
+            values_ = other.values_;
+            update_values();
+        }
+        return *this;
+    }
+
+    typed_binary_query& operator =(typed_binary_query&& other) {
+        if (this != std::addressof(other)) {
+            text_ = std::move(other.text_);
+            small_buffer_ = other.small_buffer_;
+            buffer_ = std::move(other.buffer_);
+            types_ = other.types_;
+            lengths_ = other.lengths_;
+            values_ = other.values_;
+            update_values();
+        }
+        return *this;
+    }
+
+    /**
+     * Rebuild the query with new text and parameters in place. Memory allocated for
+     * the previous parameters is reused.
+     *
+     * @param text      --- query text object.
+     * @param params    --- query parameters object.
+     * @param oid_map   --- `OidMap` which is used within connection.
+     */
+    void assign(Text text, const Params& params, const OidMap& oid_map) {
+        text_ = std::move(text);
+        assign_params(params, oid_map);
+    }
+
+    /**
+     * Rebind the query to new parameters values. The text and the parameters types
+     * resolved against the `OidMap` on construction are kept as is, only the lengths
+     * and the binary representations of the parameters are rebuilt. The previously
+     * used buffer is reused if the new parameters fit it, so a query being rebound
+     * in a loop does not allocate memory in the steady state.
+     *
+     * @param params    --- new query parameters object.
+     * @param oid_map   --- `OidMap` which is used within connection.
+     *
+     * ###Example
+     *
+     * @code
+auto query = ozo::to_typed_binary_query(repository.make_query<queries::get_user>(std::int64_t(0)), oid_map);
+for (std::int64_t id : ids) {
+    query.rebind(hana::make_tuple(id), oid_map);
+    ozo::request(conn_info[io], query, ozo::into(res), yield);
+}
+     * @endcode
+     */
+    void rebind(const Params& params, const OidMap& oid_map) {
+        assign_values(params, oid_map);
+    }
+
+    /**
+     * Get allocator which is used for the parameters data.
+     *
+     * @return `allocator_type` --- the allocator object.
+     */
+    allocator_type get_allocator() const {
+        return buffer_.get_allocator();
+    }
+
+    /**
+     * Get raw query text buffer.
+     *
+     * @return `const char*` --- pointer to the buffer.
+     */
+    const char* text() const noexcept {
+        return to_const_char(text_);
+    }
+
+    /**
+     * Get query parameter types array.
+     *
+     * @return `const oid_t*` --- the query parameter types array.
+     */
+    const oid_t* types() const noexcept {
+        if constexpr (built_in_types_) {
+            return hana::unpack(indices(), [] (auto ...i) {
+                return std::data(detail::built_in_type_oids<param_type<decltype(i)>...>);
+            });
+        } else {
+            return std::data(types_);
+        }
+    }
+
+    /**
+     * Get query parameter formats array. All the formats are `binary_format`.
+     *
+     * @return `const int*` --- the query parameter formats array.
+     */
+    const int* formats() const noexcept {
+        return std::data(detail::binary_formats<params_count_>);
+    }
+
+    /**
+     * Get query parameter lengths array.
+     *
+     * @return `const int*` --- the query parameter lengths array.
+     */
+    const int* lengths() const noexcept {
+        return std::data(lengths_);
+    }
+
+    /**
+     * Get query parameter binary representations array.
+     *
+     * @return `const char* const*` --- an array with pointers to the binary representations.
+     */
+    const char* const* values() const noexcept {
+        return std::data(values_);
+    }
+
+    /**
+     * Get query parameters count.
+     *
+     * @return `std::ptrdiff_t` --- the query parameters count.
+     */
+    static constexpr std::ptrdiff_t params_count() noexcept {
+        return params_count_;
+    }
+
+private:
+    static constexpr auto params_count_ = decltype(hana::length(std::declval<params_type>()))::value;
+
+    static constexpr auto indices() {
+        return hana::to_tuple(hana::make_range(hana::size_c<0>, hana::size_c<params_count_>));
+    }
+
+    template <typename I>
+    using param_type = std::decay_t<decltype(std::declval<const params_type&>()[I{}])>;
+
+    // The OidMap is consulted for the custom types only
+    static constexpr bool built_in_types_ = detail::BuiltInParams<params_type>;
+
+    template <typename I>
+    static constexpr bool borrowed() noexcept {
+        return BorrowedParameter<decltype(std::declval<const params_type&>()[I{}])>;
+    }
+
+    // Arrays and composites are serialized in a single pass into the buffer
+    // without preliminary calculation of their size, see `ozo::send_data_frame()`.
+    static constexpr bool single_pass() noexcept {
+        return hana::unpack(indices(), [](auto ...i) {
+            return ((!borrowed<decltype(i)>()
+                && detail::BackPatchedFrame<decltype(std::declval<const params_type&>()[i])>) || ... || false);
+        });
+    }
+
+    std::size_t data_size() const noexcept {
+        std::size_t result = 0;
+        hana::for_each(indices(), [&] (auto i) {
+            if constexpr (!borrowed<decltype(i)>()) {
+                result += lengths_[i];
+            }
+        });
+        return result;
+    }
+
+    char* data() noexcept {
+        if constexpr (single_pass()) {
+            return std::data(buffer_);
+        } else {
+            return data_size() > small_buffer_.size() ? std::data(buffer_) : std::data(small_buffer_);
+        }
+    }
+
+    void assign_params(const Params& params, const OidMap& oid_map) {
+        if constexpr (!built_in_types_) {
+            hana::for_each(indices(), [&] (auto i) {
+                types_[i] = type_oid(oid_map, params[i]);
+            });
+        }
+        assign_values(params, oid_map);
+    }
+
+    void assign_values(const Params& params, const OidMap& oid_map) {
+        if constexpr (single_pass()) {
+            buffer_.clear();
+            ozo::ostream os(buffer_);
+            hana::for_each(indices(), [&] (auto i) {
+                if constexpr (borrowed<decltype(i)>()) {
+                    lengths_[i] = std::max(0, size_of(params[i]));
+                    values_[i] = lengths_[i] ? detail::borrowed_data(ozo::unwrap(params[i])) : nullptr;
+                } else {
+                    const auto pos = os.tellp();
+                    send(os, oid_map, params[i]);
+                    lengths_[i] = static_cast<int>(os.tellp() - pos);
+                }
+            });
+        } else {
+            hana::for_each(indices(), [&] (auto i) {
+                lengths_[i] = std::max(0, size_of(params[i]));
+            });
+
+            const auto size = data_size();
+            if (size > small_buffer_.size()) {
+                buffer_.resize(size);
+            }
+
+            ozo::ostream os(data(), size, ozo::unchecked);
+
+            hana::for_each(indices(), [&] (auto i) {
+                if constexpr (borrowed<decltype(i)>()) {
+                    values_[i] = lengths_[i] ? detail::borrowed_data(ozo::unwrap(params[i])) : nullptr;
+                } else {
+                    send(os, oid_map, params[i]);
+                }
+            });
+        }
+
+        update_values();
+    }
+
+    // Borrowed parameters point to the caller memory and are kept as is
+    void update_values() noexcept {
+        char* const data = this->data();
+        std::size_t offset = 0;
+        hana::for_each(indices(), [&] (auto i) {
+            if constexpr (!borrowed<decltype(i)>()) {
+                values_[i] = lengths_[i] ? data + offset : nullptr;
+                offset += lengths_[i];
+            }
+        });
+    }
+
+    text_type text_;
+    std::array<char, small_buffer_size> small_buffer_;
+    buffer_type buffer_;
+    std::array<oid_t, built_in_types_ ? 0 : params_count_> types_;
+    std::array<int, params_count_> lengths_;
+    std::array<const char*, params_count_> values_;
+};
+
+template <typename T>
+struct is_typed_binary_query : std::false_type {};
+
+template <class Text, class Params, class OidMap, class Allocator>
+struct is_typed_binary_query<typed_binary_query<Text, Params, OidMap, Allocator>> : std::true_type {};
+
+//! @cond
+template <typename T>
+inline constexpr auto TypedBinaryQuery = is_typed_binary_query<std::decay_t<T>>::value;
+//! @endcond
+
 /**
  * @brief Binary protocol query representation.
  *
@@ -36,6 +446,13 @@ namespace ozo {
  */
 class binary_query {
 public:
+    /**
+     * Size of the buffer for parameters binary representation which is stored
+     * inline within the single allocation of the query data. Parameters which
+     * do not fit the buffer are stored in a separately allocated one.
+     */
+    static constexpr std::size_t small_buffer_size = detail::binary_query_small_buffer_size;
+
     /**
      * Construct a new binary query object.
      *
@@ -51,6 +468,102 @@ public:
         allocator, std::move(text), params, oid_map, allocator
     )} {}
 
+    /**
+     * Construct a new binary query object from the `ozo::typed_binary_query`.
+     *
+     * @param query     --- typed binary query object to store.
+     * @param allocator --- allocator object which should be used to allocate internal data,
+     *                      default is `std::allocator<char>`.
+     */
+    template <class Text, class Params, class OidMap, class QueryAllocator, class Allocator = std::allocator<char>>
+    explicit binary_query(typed_binary_query<Text, Params, OidMap, QueryAllocator> query,
+            const Allocator& allocator = Allocator{})
+    : impl{std::allocate_shared<impl_type<Text, Params, OidMap, QueryAllocator>>(
+        allocator, std::move(query)
+    )} {}
+
+    /**
+     * Construct a new binary query object which owns a query object with the `ozo::binary_query`
+     * accessors, e.g. `ozo::dynamic_query`. The pointers returned by the accessors should stay
+     * valid while the object is not modified.
+     *
+     * @param query     --- query object to store.
+     * @param allocator --- allocator object which should be used to allocate internal data,
+     *                      default is `std::allocator<char>`.
+     */
+    template <class Query, class Allocator = std::allocator<char>>
+    binary_query(std::in_place_t, Query query, const Allocator& allocator = Allocator{})
+    : impl{std::allocate_shared<erased_type<Query>>(allocator, std::move(query))} {}
+
+    /**
+     * Rebuild the binary query with new text and parameters.
+     *
+     * If the query is not shared with other `binary_query` objects and it was built
+     * from the same types of text, parameters, `OidMap` and allocator, then the data
+     * is rebuilt in place and the previously allocated memory is reused. Otherwise,
+     * new data is allocated as it is done by the constructor. So a `binary_query` object
+     * being rebuilt with queries of the same type does not allocate memory in the
+     * steady state.
+     *
+     * @param text      --- query text object, should model `QueryText` concept.
+     * @param params    --- query parameters object, should model `HanaSequence` concept.
+     * @param oid_map   --- `OidMap` which is used within connection.
+     * @param allocator --- allocator object which should be used to allocate internal data,
+     *                      default is `std::allocator<char>`.
+     */
+    template <class Text, class Params, class OidMap, class Allocator = std::allocator<char>>
+    void assign(Text text, const Params& params, const OidMap& oid_map, const Allocator& allocator = Allocator{}) {
+        using impl_t = impl_type<Text, Params, OidMap, Allocator>;
+        if (impl.use_count() == 1) {
+            if (auto p = dynamic_cast<impl_t*>(impl.get())) {
+                p->assign(std::move(text), params, oid_map);
+                return;
+            }
+        }
+        *this = binary_query(std::move(text), params, oid_map, allocator);
+    }
+
+    /**
+     * Rebind the binary query to new parameters values.
+     *
+     * The query text and the parameters types resolved on construction are kept,
+     * only the parameters binary representations are rebuilt. If the query is not
+     * shared with other `binary_query` objects the data is rebuilt in place and the
+     * previously allocated buffer is reused if the new parameters fit it. Otherwise,
+     * the data is copied first, so the other objects are not affected.
+     *
+     * This allows to convert a query of `ozo::query_builder` or `ozo::query_repository`
+     * once and then execute it with different arguments without the full conversion.
+     *
+     * @param params    --- new query parameters object, should be of the same type as
+     *                      the parameters the query was built from.
+     * @param oid_map   --- `OidMap` which is used within connection, should be of the same
+     *                      type as the one the query was built with.
+     * @throws std::invalid_argument --- the query was built from parameters or `OidMap` of another type.
+     *
+     * ###Example
+     *
+     * @code
+auto query = ozo::to_binary_query("SELECT name FROM users WHERE id = "_SQL + std::int64_t(0), oid_map);
+for (std::int64_t id : ids) {
+    query.rebind(hana::make_tuple(id), oid_map);
+    ozo::request(conn_info[io], query, ozo::into(res), yield);
+}
+     * @endcode
+     */
+    template <class Params, class OidMap>
+    void rebind(const Params& params, const OidMap& oid_map) {
+        auto p = dynamic_cast<rebindable<Params, OidMap>*>(impl.get());
+        if (!p) {
+            throw std::invalid_argument("binary_query: rebind parameters should be of the same type as the query ones");
+        }
+        if (impl.use_count() == 1) {
+            p->rebind(params, oid_map);
+        } else {
+            impl = p->rebound(params, oid_map);
+        }
+    }
+
     /**
      * Get raw query text buffer.
      *
@@ -107,8 +620,6 @@ public:
     }
 
 private:
-    static constexpr auto binary_format = 1;
-
     struct interface {
         virtual const char* text() const noexcept = 0;
         virtual const oid_t* types() const noexcept = 0;
@@ -119,84 +630,85 @@ private:
         virtual ~interface() = default;
     };
 
+    template <class Params, class OidMap>
+    struct rebindable {
+        virtual void rebind(const Params& params, const OidMap& oid_map) = 0;
+        virtual std::shared_ptr<interface> rebound(const Params& params, const OidMap& oid_map) const = 0;
+        virtual ~rebindable() = default;
+    };
+
     template <class Text, class Params, class OidMap, class Allocator = std::allocator<char>>
-    struct impl_type final : interface {
-        static_assert(ozo::HanaSequence<Params>, "Params should be Hana.Sequence");
-        static_assert(ozo::OidMap<OidMap>, "OidMap should model ozo::OidMap");
-        static_assert(ozo::QueryText<Text>, "Text should model ozo::QueryText concept");
-
-        using allocator_type = std::conditional_t<
-                                std::is_same_v<typename Allocator::value_type, char>,
-                                    Allocator,
-                                    typename std::allocator_traits<Allocator>::template rebind_alloc<char>>;
-        using buffer_type = std::vector<char, allocator_type>;
-        using oid_map_type = OidMap;
-        using text_type = std::decay_t<Text>;
-        using params_type = Params;
-
-        static constexpr auto params_count_ = decltype(hana::length(std::declval<params_type>()))::value;
-
-        text_type text_;
-        buffer_type buffer_;
-        std::array<oid_t, params_count_> types_;
-        std::array<int, params_count_> formats_;
-        std::array<int, params_count_> lengths_;
-        std::array<const char*, params_count_> values_;
+    struct impl_type final : interface, rebindable<Params, OidMap> {
+        using query_type = typed_binary_query<Text, Params, OidMap, Allocator>;
+
+        query_type query_;
 
         impl_type(Text text, const Params& params,
             const OidMap& oid_map, const Allocator& allocator)
-        : text_(std::move(text)), buffer_(allocator) {
-            formats_.fill(binary_format);
+        : query_(std::move(text), params, oid_map, allocator) {}
 
-            const auto range = hana::to_tuple(hana::make_range(hana::size_c<0>, hana::size_c<params_count_>));
+        impl_type(query_type query) : query_(std::move(query)) {}
 
-            hana::for_each(range, [&] (auto i) {
-                lengths_[i] = std::max(0, size_of(params[i]));
-                types_[i] = type_oid(oid_map, params[i]);
-            });
-
-            buffer_.reserve(hana::unpack(lengths_, [](auto ...x) {return (x + ... + 0);}));
-
-            ozo::ostream os(buffer_);
+        impl_type(const impl_type&) = delete;
+        impl_type(impl_type&&) = delete;
 
-            hana::for_each(params, [&] (auto& param) { send(os, oid_map, param);});
+        void assign(Text text, const Params& params, const OidMap& oid_map) {
+            query_.assign(std::move(text), params, oid_map);
+        }
 
-            std::size_t offset = 0;
-            hana::for_each(range, [&] (auto i) {
-                values_[i] = lengths_[i] ? std::data(buffer_) + offset : nullptr;
-                offset += lengths_[i];
-            });
+        void rebind(const Params& params, const OidMap& oid_map) override {
+            query_.rebind(params, oid_map);
         }
 
-        impl_type(const impl_type&) = delete;
-        impl_type(impl_type&&) = delete;
+        std::shared_ptr<interface> rebound(const Params& params, const OidMap& oid_map) const override {
+            auto copy = query_;
+            copy.rebind(params, oid_map);
+            return std::allocate_shared<impl_type>(copy.get_allocator(), std::move(copy));
+        }
 
         const char* text() const noexcept override {
-            return to_const_char(text_);
+            return query_.text();
         }
 
         const oid_t* types() const noexcept override {
-            return std::data(types_);
+            return query_.types();
         }
 
         const int* formats() const noexcept override {
-            return std::data(formats_);
+            return query_.formats();
         }
 
         const int* lengths() const noexcept override {
-            return std::data(lengths_);
+            return query_.lengths();
         }
 
         const char* const* values() const noexcept override {
-            return std::data(values_);
+            return query_.values();
         }
 
         std::ptrdiff_t params_count() const noexcept override {
-            return params_count_;
+            return query_.params_count();
         }
     };
 
-    std::shared_ptr<const interface> impl;
+    template <class Query>
+    struct erased_type final : interface {
+        Query query_;
+
+        erased_type(Query query) : query_(std::move(query)) {}
+
+        erased_type(const erased_type&) = delete;
+        erased_type(erased_type&&) = delete;
+
+        const char* text() const noexcept override { return query_.text();}
+        const oid_t* types() const noexcept override { return query_.types();}
+        const int* formats() const noexcept override { return query_.formats();}
+        const int* lengths() const noexcept override { return query_.lengths();}
+        const char* const* values() const noexcept override { return query_.values();}
+        std::ptrdiff_t params_count() const noexcept override { return query_.params_count();}
+    };
+
+    std::shared_ptr<interface> impl;
 };
 
 namespace detail {
@@ -285,6 +797,15 @@ struct to_binary_query_impl<T, hana::when<Query<T>>> {
     }
 };
 
+template <class Text, class Params, class OidMap, class QueryAllocator>
+struct to_binary_query_impl<typed_binary_query<Text, Params, OidMap, QueryAllocator>> {
+    template <typename OidMapT, typename Alloc>
+    static binary_query apply(const typed_binary_query<Text, Params, OidMap, QueryAllocator>& query,
+            const OidMapT&, const Alloc& allocator) {
+        return binary_query(query, allocator);
+    }
+};
+
 template <>
 struct to_binary_query_impl<binary_query> {
     template <typename OidMap, typename Alloc>
@@ -299,8 +820,9 @@ struct to_binary_query_impl<binary_query> {
  * This function provides an ability to convert a query object to the protocol compatible
  * binary representation to send it to the PostgreSQL database. A user may call this
  * function to reuse the `binary_query` and eliminate unnecessarily conversion of the
- * query object to its binary representation each operation. E.g., this may be useful
- * with the `failover` micro-framework.
+ * query object to its binary representation each operation. The `failover` micro-framework
+ * strategies `ozo::failover::retry()` and `ozo::failover::role_based()` convert a query
+ * once for all the tries of an operation, so there is no need to do it for them.
  *
  * @param query     --- a query object to convert to the binary representation.
  * @param oid_map   --- `OidMap` to type OIDs for the binary representation.
@@ -316,4 +838,64 @@ inline binary_query to_binary_query(const BinaryQueryConvertible& query,
     return to_binary_query_impl<BinaryQueryConvertible>::apply(query, oid_map, allocator);
 }
 
+/**
+ * @brief Convert a query object to the binary representation without type erasure.
+ *
+ * This function does the same as `ozo::to_binary_query()` but returns `ozo::typed_binary_query`,
+ * which may be passed to the request functions directly without additional conversions and
+ * memory allocations.
+ *
+ * @param query     --- a #Query object to convert to the binary representation.
+ * @param oid_map   --- `OidMap` to type OIDs for the binary representation.
+ * @param allocator --- allocator to use for the parameters data which do not fit the small buffer.
+ *
+ * @return `ozo::typed_binary_query` --- the binary representation.
+ *
+ * @ingroup group-query-functions
+ */
+template <typename Query, typename OidMap, typename Allocator = std::allocator<char>>
+inline auto to_typed_binary_query(const Query& query, const OidMap& oid_map, const Allocator& allocator = Allocator{}) {
+    static_assert(ozo::Query<Query>, "query should model Query concept");
+    using text_type = std::decay_t<decltype(get_query_text(query))>;
+    using params_type = std::decay_t<decltype(get_query_params(query))>;
+    return typed_binary_query<text_type, params_type, OidMap, Allocator>(
+        get_query_text(query), get_query_params(query), oid_map, allocator);
+}
+
+/**
+ * @brief Rebuild the binary representation of a query object in place.
+ *
+ * This function does the same as `ozo::to_binary_query()` but stores the result into
+ * the existing `ozo::binary_query` object. For a #Query object it uses `ozo::binary_query::assign()`,
+ * so the memory of the previous binary representation is reused if possible. This
+ * allows to eliminate memory allocations in a hot path where queries of the same type
+ * are sent many times.
+ *
+ * @param out       --- `ozo::binary_query` object to store the binary representation into.
+ * @param query     --- a query object to convert to the binary representation.
+ * @param oid_map   --- `OidMap` to type OIDs for the binary representation.
+ * @param allocator --- allocator to use for the data of `ozo::binary_query`.
+ *
+ * ###Example
+ *
+ * @code
+ozo::binary_query query = ozo::to_binary_query("SELECT $1"_SQL + 0, oid_map);
+for (std::int32_t i = 1; i < 10; ++i) {
+    ozo::rebuild_binary_query(query, "SELECT $1"_SQL + i, oid_map);
+    ozo::request(conn_info[io], query, ozo::into(res), yield);
+}
+ * @endcode
+ *
+ * @ingroup group-query-functions
+ */
+template <typename BinaryQueryConvertible, typename OidMap, typename Allocator = std::allocator<char>>
+inline void rebuild_binary_query(binary_query& out, const BinaryQueryConvertible& query,
+        const OidMap& oid_map, const Allocator& allocator = Allocator{}) {
+    if constexpr (Query<BinaryQueryConvertible>) {
+        out.assign(get_query_text(query), get_query_params(query), oid_map, allocator);
+    } else {
+        out = to_binary_query(query, oid_map, allocator);
+    }
+}
+
 } // namespace ozo
@@ -11,6 +11,9 @@
 #include <boost/fusion/adapted/struct/adapt_struct.hpp>
 #include <boost/fusion/include/fold.hpp>
 
+#include <array>
+#include <cstring>
+
 namespace ozo::detail {
 
 struct pg_composite {
@@ -73,15 +76,59 @@ constexpr auto for_each_member(T&& v, Func&& f)  -> Require<HanaStruct<T>>{
 template <typename T>
 struct size_of_impl_dispatcher<T, Require<Composite<T>>> { using type = size_of_composite<std::decay_t<T>>; };
 
+/**
+ * Header of a composite being sent, i.e. the fields count and oids of the fields in
+ * the network byte order. The oids depend on the type and the oid map only, so the
+ * header is made once, e.g. per array of composites, and copied into each value with
+ * the fields data being the only part serialized per value.
+ */
+template <typename T>
+struct composite_send_header {
+    std::uint32_t count = 0;
+    std::array<std::uint32_t, columns_count<T>()> oids {};
+};
+
+template <typename T, typename OidMap>
+inline composite_send_header<T> make_composite_send_header(const OidMap& oid_map) noexcept {
+    composite_send_header<T> result;
+    result.count = static_cast<std::uint32_t>(convert_to_big_endian(static_cast<size_type>(columns_count<T>())));
+    for_each_column_type<T>([&] (std::size_t i, const char*, auto type) {
+        using field_type = typename decltype(type)::type;
+        result.oids[i] = static_cast<std::uint32_t>(convert_to_big_endian(type_oid<field_type>(oid_map)));
+    });
+    return result;
+}
+
+template <typename T, typename OidMap>
+inline ostream& send_composite(ostream& out, const OidMap& oid_map, const T& in,
+        const composite_send_header<T>& header) {
+    std::memcpy(out.extend(sizeof(header.count)), &header.count, sizeof(header.count));
+    std::size_t i = 0;
+    for_each_member(in, [&] (const auto& v) {
+        std::memcpy(out.extend(sizeof(header.oids[i])), &header.oids[i], sizeof(header.oids[i]));
+        ++i;
+        send_data_frame(out, oid_map, v);
+    });
+    return out;
+}
+
+/**
+ * Sends composites of an array with the header made once per array.
+ */
+template <typename T, typename OidMap>
+inline ostream& send_composite_data_frame(ostream& out, const OidMap& oid_map, const T& in,
+        const composite_send_header<T>& header) {
+    const auto pos = out.tellp();
+    write(out, size_type(0));
+    send_composite(out, oid_map, in, header);
+    return out.patch(pos, static_cast<size_type>(out.tellp() - pos - sizeof(size_type)));
+}
+
 template <typename T>
 struct send_composite_impl {
     template <typename OidMap>
     static ostream& apply(ostream& out, const OidMap& oid_map, const T& in) {
-        write(out, pg_composite{fields_number(in)});
-        for_each_member(in, [&] (const auto& v) {
-            send_frame(out, oid_map, v);
-        });
-        return out;
+        return send_composite(out, oid_map, in, make_composite_send_header<T>(oid_map));
     }
 };
 
@@ -100,15 +147,65 @@ inline Require<Composite<T>> read_and_verify_header(istream& in, const T& v) {
     }
 }
 
+/**
+ * Layout of a composite type, i.e. oids of the fields. It is validated once against
+ * the first received value via `ozo::accepts_oid()`, so the following values, e.g.
+ * elements of an array, are received with a plain comparison of the incoming oids
+ * with the layout and with no per field type checks.
+ */
+template <typename T>
+struct composite_layout {
+    std::array<oid_t, columns_count<T>()> oids {};
+    bool validated = false;
+};
+
+template <typename T, typename Func>
+inline void for_each_member_ref(T& v, Func&& f) {
+    if constexpr (FusionSequence<T>) {
+        fusion::for_each(v, std::forward<Func>(f));
+    } else {
+        hana::for_each(hana::keys(v), [&] (auto key) { f(hana::at_key(v, key)); });
+    }
+}
+
+template <typename T, typename OidMap>
+inline istream& recv_composite(istream& in, const OidMap& oid_map, T& out, composite_layout<T>& layout) {
+    read_and_verify_header(in, out);
+    std::size_t i = 0;
+    for_each_member_ref(out, [&] (auto& v) {
+        oid_t oid = null_oid;
+        read(in, oid);
+        if (!layout.validated || oid != layout.oids[i]) {
+            check_oid<std::decay_t<decltype(v)>>(oid_map, oid);
+            layout.oids[i] = oid;
+        }
+        ++i;
+        recv_data_frame(in, null_oid, oid_map, v);
+    });
+    layout.validated = true;
+    return in;
+}
+
+/**
+ * Receives composites of an array with the layout validated once per array.
+ */
+template <typename T, typename OidMap>
+inline istream& recv_composite_data_frame(istream& in, const OidMap& oid_map, T& out, composite_layout<T>& layout) {
+    size_type size = 0;
+    read(in, size);
+    if (size == null_state_size) {
+        throw std::invalid_argument("unexpected null for type "
+            + boost::core::demangle(typeid(out).name()));
+    }
+    return recv_composite(in, oid_map, out, layout);
+}
+
 template <typename T>
 struct recv_fusion_adapted_composite_impl {
     template <typename OidMap>
     static istream& apply(istream& in, size_type, const OidMap& oid_map, T& out) {
-        read_and_verify_header(in, out);
-        fusion::for_each(out, [&] (auto& v) {
-            recv_frame(in, oid_map, v);
-        });
-        return in;
+        composite_layout<T> layout;
+        return recv_composite(in, oid_map, out, layout);
     }
 };
 
@@ -116,11 +213,8 @@ template <typename T>
 struct recv_hana_adapted_composite_impl {
     template <typename OidMap>
     static istream& apply(istream& in, size_type, const OidMap& oid_map, T& out) {
-        read_and_verify_header(in, out);
-        hana::for_each(hana::keys(out), [&in, &out, &oid_map](auto key) {
-            recv_frame(in, oid_map, hana::at_key(out, key));
-        });
-        return in;
+        composite_layout<T> layout;
+        return recv_composite(in, oid_map, out, layout);
     }
 };
 
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <ozo/io/composite.h>
+#include <ozo/io/send.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+/**
+ * @defgroup group-io-copy COPY binary format
+ * @ingroup group-io
+ * @brief PostgreSQL COPY binary format serialization
+ *
+ * Functions to write and read rows in the [COPY binary format](https://www.postgresql.org/docs/current/sql-copy.html#id-1.9.3.55.9.4).
+ * A row is a #Composite object, each field of which is serialized via `ozo::send()` and
+ * deserialized via `ozo::recv()`. A single column row may be represented by an object
+ * of the column type.
+ */
+namespace ozo {
+
+namespace detail {
+
+struct pg_copy_header {
+    BOOST_HANA_DEFINE_STRUCT(pg_copy_header,
+        (std::int32_t, flags),
+        (std::int32_t, extension_size)
+    );
+};
+
+constexpr const char pg_copy_signature[] = {'P', 'G', 'C', 'O', 'P', 'Y', '\n', '\377', '\r', '\n', '\0'};
+
+constexpr std::int16_t pg_copy_trailer = -1;
+
+template <typename OidMap, typename Out>
+inline Require<FusionSequence<Out>&&!HanaStruct<Out>> recv_copy_fields(istream& in, const OidMap& oid_map, Out& out) {
+    fusion::for_each(out, [&] (auto& v) {
+        recv_data_frame(in, oid_map, v);
+    });
+}
+
+template <typename OidMap, typename Out>
+inline Require<HanaStruct<Out>> recv_copy_fields(istream& in, const OidMap& oid_map, Out& out) {
+    hana::for_each(hana::keys(out), [&] (auto key) {
+        recv_data_frame(in, oid_map, hana::at_key(out, key));
+    });
+}
+
+template <typename Out>
+constexpr size_type copy_fields_number(const Out& out) {
+    if constexpr (Composite<Out>) {
+        return fields_number(out);
+    } else {
+        return 1;
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Send COPY binary format header to an output stream.
+ * @ingroup group-io-copy
+ *
+ * The header contains the signature, flags field and header extension area length.
+ *
+ * @param out --- output stream
+ * @return ostream& --- reference to the output stream
+ */
+inline ostream& send_copy_header(ostream& out) {
+    write(out, detail::pg_copy_signature);
+    return write(out, detail::pg_copy_header{0, 0});
+}
+
+/**
+ * @brief Send a row as a COPY binary format tuple to an output stream.
+ * @ingroup group-io-copy
+ *
+ * The tuple contains the number of fields and a data frame of each field of the row.
+ * Fields in null state are sent as frames with `ozo::null_state_size` size.
+ *
+ * @param out --- output stream
+ * @param oid_map --- #OidMap to determine objects' oids
+ * @param row --- #Composite object to send
+ * @return ostream& --- reference to the output stream
+ */
+template <typename OidMap, typename Row>
+inline ostream& send_copy_row(ostream& out, const OidMap& oid_map, const Row& row) {
+    static_assert(Composite<Row>, "row should be a Composite");
+    write(out, static_cast<std::int16_t>(detail::fields_number(row)));
+    detail::for_each_member(row, [&] (const auto& v) {
+        send_data_frame(out, oid_map, v);
+    });
+    return out;
+}
+
+/**
+ * @brief Send COPY binary format trailer to an output stream.
+ * @ingroup group-io-copy
+ *
+ * @param out --- output stream
+ * @return ostream& --- reference to the output stream
+ */
+inline ostream& send_copy_trailer(ostream& out) {
+    return write(out, detail::pg_copy_trailer);
+}
+
+/**
+ * @brief Receive COPY binary format header from an input stream.
+ * @ingroup group-io-copy
+ *
+ * Verifies the signature and skips the header extension area.
+ *
+ * @param in --- input stream
+ * @return std::size_t --- size of the header in bytes
+ * @throws ozo::system_error with `ozo::error::bad_copy_format` if the header is malformed.
+ */
+inline std::size_t recv_copy_header(istream& in) {
+    char signature[sizeof(detail::pg_copy_signature)];
+    detail::pg_copy_header header;
+    read(in, signature);
+    read(in, header);
+    if (!in || !std::equal(std::begin(signature), std::end(signature), std::begin(detail::pg_copy_signature))) {
+        throw system_error(error::bad_copy_format, "COPY binary format signature not found");
+    }
+    if (header.extension_size < 0) {
+        throw system_error(error::bad_copy_format, "negative COPY header extension area length "
+            + std::to_string(header.extension_size));
+    }
+    std::string extension(static_cast<std::size_t>(header.extension_size), '\0');
+    if (!read(in, extension)) {
+        throw system_error(error::bad_copy_format, "COPY header extension area is truncated");
+    }
+    return sizeof(signature) + sizeof(header.flags) + sizeof(header.extension_size) + extension.size();
+}
+
+/**
+ * @brief Receive a COPY binary format tuple fields from an input stream into a row.
+ * @ingroup group-io-copy
+ *
+ * The number of fields of the tuple should be read in advance since the trailer
+ * of COPY data is indicated by `-1` as the number of fields.
+ *
+ * @note Fields oids are not transferred in COPY data so the function can not check
+ * the types of incoming fields, the row type should match the columns of the COPY query.
+ *
+ * @param in --- input stream
+ * @param fields_count --- number of fields of the tuple
+ * @param oid_map --- #OidMap to determine nested objects' oids
+ * @param out --- #Composite object to receive or an object for a single column tuple
+ * @return istream& --- reference to the input stream
+ * @throws ozo::system_error with `ozo::error::bad_composite_size` if the number of fields
+ * does not match the row type and with `ozo::error::unexpected_eof` if the data is truncated.
+ */
+template <typename OidMap, typename Out>
+inline istream& recv_copy_row(istream& in, std::int16_t fields_count, const OidMap& oid_map, Out& out) {
+    if (fields_count != detail::copy_fields_number(out)) {
+        throw system_error(error::bad_composite_size,
+            "incoming COPY tuple fields count " + std::to_string(fields_count)
+            + " does not match fields count " + std::to_string(detail::copy_fields_number(out))
+            + " of type " + boost::core::demangle(typeid(out).name()));
+    }
+
+    if constexpr (Composite<Out>) {
+        detail::recv_copy_fields(in, oid_map, out);
+    } else {
+        recv_data_frame(in, oid_map, out);
+    }
+
+    if (!in) {
+        throw system_error(error::unexpected_eof, "COPY tuple is truncated");
+    }
+    return in;
+}
+
+} // namespace ozo
@@ -0,0 +1,299 @@
+#pragma once
+
+#include <ozo/type_traits.h>
+#include <ozo/io/send.h>
+#include <ozo/io/recv.h>
+#include <ozo/io/size_of.h>
+
+#include <boost/preprocessor/punctuation/comma_if.hpp>
+#include <boost/preprocessor/seq/for_each_i.hpp>
+#include <boost/preprocessor/seq/size.hpp>
+#include <boost/preprocessor/stringize.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+namespace ozo {
+
+/**
+ * @brief Label of a PostgreSQL enum value
+ * @ingroup group-type_system-types
+ */
+template <typename Enum>
+struct enum_label {
+    Enum value; //!< C++ enumerator
+    std::string_view label; //!< label of the PostgreSQL enum type
+};
+
+/**
+ * @brief Labels of a C++ enum mapped to a PostgreSQL enum type
+ * @ingroup group-type_system-types
+ *
+ * The specialization should have the static constexpr member `value` --- `std::array` of
+ * `ozo::enum_label`. It is defined by #OZO_PG_DEFINE_ENUM, and may be specialized directly
+ * for the labels which differ from the enumerator names.
+ *
+ * @code
+namespace ozo {
+template <>
+struct enum_labels<mood> {
+    static constexpr std::array<enum_label<mood>, 2> value {{
+        {mood::sad, "so-so"},
+        {mood::happy, "happy"},
+    }};
+};
+} // namespace ozo
+OZO_PG_DEFINE_CUSTOM_TYPE(mood, "mood")
+ * @endcode
+ */
+template <typename Enum, typename = std::void_t<>>
+struct enum_labels {};
+
+namespace detail {
+
+template <typename T, typename = std::void_t<>>
+struct is_pg_enum : std::false_type {};
+
+template <typename T>
+struct is_pg_enum<T, std::void_t<decltype(enum_labels<T>::value)>> : std::is_enum<T> {};
+
+template <typename T>
+inline constexpr auto PgEnum = is_pg_enum<std::decay_t<T>>::value;
+
+constexpr std::uint32_t enum_label_hash(std::string_view v, std::uint32_t seed) noexcept {
+    std::uint32_t h = 2166136261u ^ seed;
+    for (const char c : v) {
+        h = (h ^ static_cast<std::uint8_t>(c)) * 16777619u;
+    }
+    return h ^ (h >> 15);
+}
+
+constexpr std::size_t enum_hash_table_size(std::size_t labels) noexcept {
+    std::size_t result = 1;
+    while (result < 2 * labels) {
+        result <<= 1;
+    }
+    return result;
+}
+
+/**
+ * Perfect hash of the labels built at compile time: the seed of the hash function
+ * is chosen so that the labels occupy distinct slots of the table. A lookup costs
+ * a hash of the label and a single comparison.
+ */
+template <typename Enum>
+struct enum_hash_table {
+    static constexpr const auto& labels = enum_labels<Enum>::value;
+    static constexpr std::size_t size = enum_hash_table_size(std::size(labels));
+    static constexpr std::uint8_t empty = std::numeric_limits<std::uint8_t>::max();
+
+    static_assert(std::size(labels) > 0, "enum should have at least one label");
+    static_assert(std::size(labels) < empty, "enum has too many labels");
+
+    std::uint32_t seed = 0;
+    std::array<std::uint8_t, size> slots {};
+
+    static constexpr enum_hash_table make() {
+        for (std::uint32_t seed = 0; seed < 100000; ++seed) {
+            enum_hash_table table;
+            table.seed = seed;
+            for (auto& slot : table.slots) {
+                slot = empty;
+            }
+            bool found = true;
+            for (std::size_t i = 0; i < std::size(labels) && found; ++i) {
+                auto& slot = table.slots[enum_label_hash(labels[i].label, seed) & (size - 1)];
+                found = slot == empty;
+                slot = static_cast<std::uint8_t>(i);
+            }
+            if (found) {
+                return table;
+            }
+        }
+        throw std::logic_error("perfect hash seed of enum labels is not found");
+    }
+
+    static constexpr const enum_label<Enum>* find(std::string_view label) noexcept {
+        constexpr enum_hash_table table = make();
+        const auto slot = table.slots[enum_label_hash(label, table.seed) & (size - 1)];
+        if (slot == empty || labels[slot].label != label) {
+            return nullptr;
+        }
+        return std::addressof(labels[slot]);
+    }
+};
+
+/**
+ * Labels indexed by the enumerator values if the values are dense, e.g. the enumerators
+ * without the initializers, by a scan of the labels otherwise.
+ */
+template <typename Enum>
+struct enum_label_table {
+    using underlying = std::underlying_type_t<Enum>;
+    static constexpr const auto& labels = enum_labels<Enum>::value;
+
+    static constexpr underlying min() noexcept {
+        underlying result = static_cast<underlying>(labels[0].value);
+        for (const auto& v : labels) {
+            result = std::min(result, static_cast<underlying>(v.value));
+        }
+        return result;
+    }
+
+    static constexpr underlying max() noexcept {
+        underlying result = static_cast<underlying>(labels[0].value);
+        for (const auto& v : labels) {
+            result = std::max(result, static_cast<underlying>(v.value));
+        }
+        return result;
+    }
+
+    static constexpr bool dense = static_cast<std::uint64_t>(max()) - static_cast<std::uint64_t>(min())
+        < 2 * std::size(labels);
+    static constexpr std::size_t size = dense ? static_cast<std::size_t>(max() - min()) + 1 : 1;
+
+    static constexpr std::array<std::string_view, size> make() noexcept {
+        std::array<std::string_view, size> result {};
+        if constexpr (dense) {
+            for (const auto& v : labels) {
+                result[static_cast<std::size_t>(static_cast<underlying>(v.value) - min())] = v.label;
+            }
+        }
+        return result;
+    }
+
+    static constexpr std::string_view find(Enum v) noexcept {
+        if constexpr (dense) {
+            constexpr auto table = make();
+            const auto i = static_cast<underlying>(v);
+            return i < min() || i > max() ? std::string_view{} : table[static_cast<std::size_t>(i - min())];
+        } else {
+            for (const auto& label : labels) {
+                if (label.value == v) {
+                    return label.label;
+                }
+            }
+            return {};
+        }
+    }
+};
+
+template <typename Enum>
+inline std::string_view get_enum_label(Enum v) {
+    const auto result = enum_label_table<Enum>::find(v);
+    if (result.data() == nullptr) {
+        throw std::invalid_argument("value " + std::to_string(static_cast<std::underlying_type_t<Enum>>(v))
+            + " is not a label of enum " + boost::core::demangle(typeid(Enum).name()));
+    }
+    return result;
+}
+
+template <typename Enum>
+inline Enum get_enum_value(std::string_view label) {
+    const auto result = enum_hash_table<Enum>::find(label);
+    if (!result) {
+        throw system_error(error::bad_text_value, "unknown label \"" + std::string(label)
+            + "\" of enum " + boost::core::demangle(typeid(Enum).name()));
+    }
+    return result->value;
+}
+
+template <typename T>
+struct size_of_enum_impl {
+    static size_type apply(const T& v) {
+        return static_cast<size_type>(get_enum_label(v).size());
+    }
+};
+
+template <typename T>
+struct size_of_impl_dispatcher<T, Require<PgEnum<T>>> { using type = size_of_enum_impl<std::decay_t<T>>; };
+
+template <typename T>
+struct send_enum_impl {
+    template <typename OidMap>
+    static ostream& apply(ostream& out, const OidMap&, const T& in) {
+        const auto label = get_enum_label(in);
+        out.write(label.data(), static_cast<std::streamsize>(label.size()));
+        return out;
+    }
+};
+
+template <typename T>
+struct send_impl_dispatcher<T, Require<PgEnum<T>>> { using type = send_enum_impl<std::decay_t<T>>; };
+
+template <typename T>
+struct recv_enum_impl {
+    template <typename OidMap>
+    static istream& apply(istream& in, size_type size, const OidMap&, T& out) {
+        const auto data = recv_view(in, size);
+        out = get_enum_value<T>({data, static_cast<std::size_t>(size)});
+        return in;
+    }
+};
+
+template <typename T>
+struct recv_impl_dispatcher<T, Require<PgEnum<T>>> { using type = recv_enum_impl<std::decay_t<T>>; };
+
+} // namespace detail
+
+template <typename T>
+struct recv_text_impl<T, Require<detail::PgEnum<T>>> {
+    static void apply(std::string_view in, T& out) {
+        out = detail::get_enum_value<T>(in);
+    }
+};
+
+} // namespace ozo
+
+/**
+ * @brief Helper macro to define C++ enum mapping to PostgreSQL enum type
+ * @ingroup group-type_system-mapping
+ *
+ * Defines the enum as the custom type with `ozo::enum_labels`, the labels are the
+ * names of the enumerators. The values are sent and received as their labels, which
+ * is the binary and the text representation of a PostgreSQL enum. A label received
+ * is looked up by a perfect hash built at compile time, so a value is received without
+ * allocations and with a single label comparison. An unknown label is reported with
+ * `ozo::error::bad_text_value`, an enumerator without a label can not be sent.
+ *
+ * The oid of the type should be obtained via `ozo::register_types()` like for any custom type.
+ *
+ * @note The macro should be called in the global namespace only.
+ *
+ * @param Type --- C++ enum type.
+ * @param Name --- string with name of the database type.
+ * @param Enumerators --- Boost.Preprocessor sequence of the enumerators, e.g. `(sad)(ok)(happy)`.
+ *
+ * ### Example
+ *
+ * @code
+// CREATE TYPE mood AS ENUM ('sad', 'ok', 'happy');
+enum class mood { sad, ok, happy };
+
+OZO_PG_DEFINE_ENUM(mood, "mood", (sad)(ok)(happy))
+
+auto oid_map = ozo::register_types<mood>();
+ * @endcode
+ */
+#ifdef OZO_DOCUMENTATION
+#define OZO_PG_DEFINE_ENUM(Type, Name, Enumerators)
+#else
+#define OZO_PG_DEFINE_ENUM_LABEL_(r, Type, i, Enumerator) \
+    BOOST_PP_COMMA_IF(i) ozo::enum_label<Type>{Type::Enumerator, BOOST_PP_STRINGIZE(Enumerator)}
+
+#define OZO_PG_DEFINE_ENUM(Type, Name, Enumerators) \
+    namespace ozo {\
+    template <>\
+    struct enum_labels<Type> {\
+        static constexpr std::array<enum_label<Type>, BOOST_PP_SEQ_SIZE(Enumerators)> value {{\
+            BOOST_PP_SEQ_FOR_EACH_I(OZO_PG_DEFINE_ENUM_LABEL_, Type, Enumerators)\
+        }};\
+    };\
+    }\
+    OZO_PG_DEFINE_CUSTOM_TYPE(Type, Name, dynamic_size)
+#endif
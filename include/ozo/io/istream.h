@@ -1,16 +1,85 @@
 #pragma once
 
 #include <ozo/core/concept.h>
+#include <ozo/error.h>
 #include <ozo/detail/endian.h>
 #include <ozo/detail/float.h>
 #include <ozo/detail/typed_buffer.h>
 
 #include <boost/hana/for_each.hpp>
 
+#include <cstring>
 #include <istream>
 
 namespace ozo {
 
+/**
+ * @brief Reader of the data which size has been checked up front
+ * @ingroup group-io-types
+ *
+ * The reader is obtained via `istream::unchecked()` for a region of the stream which size
+ * is validated once, e.g. for a fixed size value or for the items of an array of a known
+ * count. The values are read with plain copies of their bytes and the byte order conversion,
+ * there are no per value bounds checks. Reading beyond the region is undefined behaviour.
+ */
+class unchecked_istream {
+public:
+    using char_type = std::istream::char_type;
+
+    explicit constexpr unchecked_istream(const char_type* data) noexcept : i_(data) {}
+
+    unchecked_istream& read(char_type* buf, std::streamsize len) noexcept {
+        std::memcpy(buf, i_, static_cast<std::size_t>(len));
+        i_ += len;
+        return *this;
+    }
+
+    template <typename T>
+    Require<RawDataWritable<T>, unchecked_istream&> read(T& out) noexcept {
+        using std::data;
+        using std::size;
+        return read(reinterpret_cast<char_type*>(data(out)), static_cast<std::streamsize>(size(out)));
+    }
+
+    template <typename T>
+    Require<Integral<T>, unchecked_istream&> read(T& out) noexcept {
+        detail::typed_buffer<T> buf;
+        std::memcpy(buf.raw, i_, sizeof(T));
+        i_ += sizeof(T);
+        out = detail::convert_from_big_endian(buf.typed);
+        return *this;
+    }
+
+    template <typename T>
+    Require<FloatingPoint<T>, unchecked_istream&> read(T& out) noexcept {
+        detail::floating_point_integral_t<T> tmp;
+        read(tmp);
+        out = detail::to_floating_point(tmp);
+        return *this;
+    }
+
+    unchecked_istream& read(bool& out) noexcept {
+        out = (*i_++ != 0);
+        return *this;
+    }
+
+    template <typename T>
+    Require<HanaStruct<T>, unchecked_istream&> read(T& out) noexcept {
+        hana::for_each(hana::keys(out), [&](auto key) {
+            read(hana::at_key(out, key));
+        });
+        return *this;
+    }
+
+private:
+    const char_type* i_;
+};
+
+template <typename ...Ts>
+inline unchecked_istream& read(unchecked_istream& in, Ts&& ...vs) noexcept {
+    return in.read(std::forward<Ts>(vs)...);
+}
+
 class istream {
     class istreambuf {
         const char* i_;
@@ -27,6 +96,14 @@ class istream {
             i_ = last;
             return n;
         }
+
+        const char* peek(std::streamsize n) const noexcept {
+            return last_ - i_ < n ? nullptr : i_;
+        }
+
+        void skip(std::streamsize n) noexcept {
+            i_ += std::min(n, std::streamsize(last_ - i_));
+        }
     };
 public:
     using traits_type = std::istream::traits_type;
@@ -43,6 +120,37 @@ public:
         return *this;
     }
 
+    /**
+     * Returns pointer to the next `len` bytes of the stream without extracting
+     * them or `nullptr` if the stream contains less bytes. It allows to decode
+     * a contiguous block of data in place, e.g. an array of fixed size elements.
+     */
+    const char_type* peek(std::streamsize len) const noexcept {
+        return buf_.peek(len);
+    }
+
+    /**
+     * Extracts `len` bytes and returns the reader of them with no per value bounds checks.
+     *
+     * @throws ozo::system_error with `ozo::error::unexpected_eof` if the stream contains less bytes.
+     */
+    unchecked_istream unchecked(std::streamsize len) {
+        const auto data = peek(len);
+        if (!data) {
+            throw system_error(error::unexpected_eof);
+        }
+        skip(len);
+        return unchecked_istream(data);
+    }
+
+    /**
+     * Extracts and discards `len` bytes previously examined via `peek()`.
+     */
+    istream& skip(std::streamsize len) noexcept {
+        buf_.skip(len);
+        return *this;
+    }
+
     traits_type::int_type get() noexcept {
         char retval;
         if (!read(&retval, 1)) {
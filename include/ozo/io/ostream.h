@@ -10,25 +10,101 @@
 #include <boost/hana/members.hpp>
 #include <boost/hana/tuple.hpp>
 
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 #include <ostream>
 
 namespace ozo {
 
+/**
+ * @brief Tag of the unchecked `ozo::ostream` over a fixed size memory region
+ * @ingroup group-io-types
+ */
+struct unchecked_t {};
+constexpr unchecked_t unchecked;
+
 class ostream {
 public:
     using traits_type = std::ostream::traits_type;
     using char_type = std::ostream::char_type;
 
-    ostream(std::vector<char_type>& buf) : buf_(buf) {}
+    /**
+     * Construct the stream appending data to the contiguous resizable buffer, e.g.
+     * `std::vector<char>` with any allocator.
+     */
+    template <typename Buffer, typename = decltype(std::declval<Buffer&>().resize(std::size_t()))>
+    ostream(Buffer& buf) noexcept
+    : buf_(std::addressof(buf)), grow_(&grow<Buffer>) {}
+
+    /**
+     * Construct the stream over the fixed size memory region. The region size
+     * should be enough for all the data to be written, e.g. calculated via
+     * `ozo::size_of()`, otherwise `std::length_error` is thrown.
+     */
+    ostream(char_type* data, std::size_t size) noexcept : pos_(data), begin_(data), end_(data + size) {}
+
+    /**
+     * Construct the stream over the fixed size memory region with no bounds checks, so
+     * a value is written with a plain copy of its bytes. The region size should be
+     * calculated via `ozo::size_of()` for the exact data to be written, writing beyond
+     * the region is undefined behaviour.
+     */
+    ostream(char_type* data, std::size_t size, unchecked_t) noexcept
+    : pos_(data), begin_(data), end_(data + size), checked_(false) {}
 
     ostream& write(const char_type* s, std::streamsize n) {
-        buf_.insert(buf_.end(), s, s + n);
+        std::copy(s, s + n, extend(n));
         return *this;
     }
 
     ostream& put(char_type ch) {
-        buf_.push_back(ch);
+        *extend(1) = ch;
+        return *this;
+    }
+
+    /**
+     * Extends the stream by `n` bytes and returns pointer to them, so a contiguous
+     * block of data, e.g. an array of fixed size elements, may be encoded in place.
+     * The pointer is valid until the next write to the stream.
+     */
+    char_type* extend(std::streamsize n) {
+        if (buf_) {
+            const auto result = grow_(buf_, static_cast<std::size_t>(n));
+            begin_ = result - written_;
+            written_ += static_cast<std::size_t>(n);
+            return result;
+        }
+        if (checked_) {
+            reserve(n);
+        }
+        written_ += static_cast<std::size_t>(n);
+        return std::exchange(pos_, pos_ + n);
+    }
+
+    /**
+     * Returns the current position of the stream, i.e. the number of bytes
+     * written via the stream.
+     */
+    std::size_t tellp() const noexcept { return written_;}
+
+    /**
+     * Overwrites an integral value written before at the `pos` position of the
+     * stream. It allows to write a placeholder for a value which is known after
+     * the following data is written, e.g. a size of the data, and back-patch it
+     * with no extra pass over the data.
+     */
+    template <typename T>
+    Require<Integral<T>, ostream&> patch(std::size_t pos, T in) {
+        if (pos + sizeof(T) > written_) {
+            throw std::out_of_range("ozo::ostream patch position is out of the written data");
+        }
+        detail::typed_buffer<T> buf;
+        buf.typed = detail::convert_to_big_endian(in);
+        std::copy(std::begin(buf.raw), std::end(buf.raw), begin_ + pos);
         return *this;
     }
 
@@ -73,7 +149,28 @@ public:
     }
 
 private:
-    std::vector<char_type>& buf_;
+    void reserve(std::streamsize n) const {
+        if (n > end_ - pos_) {
+            throw std::length_error("ozo::ostream fixed size buffer overflow");
+        }
+    }
+
+    template <typename Buffer>
+    static char_type* grow(void* buf, std::size_t n) {
+        auto& out = *static_cast<Buffer*>(buf);
+        const auto offset = std::size(out);
+        out.resize(offset + n);
+        return std::data(out) + offset;
+    }
+
+    void* buf_ = nullptr;
+    char_type* (*grow_)(void*, std::size_t) = nullptr;
+    std::size_t written_ = 0;
+    char_type* pos_ = nullptr;
+    // position of the first byte written via the stream
+    char_type* begin_ = nullptr;
+    char_type* end_ = nullptr;
+    bool checked_ = true;
 };
 
 template <typename ...Ts>
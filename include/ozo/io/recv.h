@@ -5,15 +5,28 @@
 #include <ozo/type_traits.h>
 #include <ozo/io/size_of.h>
 #include <ozo/core/concept.h>
+#include <ozo/detail/bulk.h>
+#include <ozo/detail/column_plan_cache.h>
 #include <ozo/detail/endian.h>
 #include <ozo/detail/float.h>
 #include <ozo/io/istream.h>
 #include <ozo/io/type_traits.h>
 #include <boost/core/demangle.hpp>
+#include <boost/hana/accessors.hpp>
 #include <boost/hana/for_each.hpp>
 #include <boost/hana/members.hpp>
 #include <boost/hana/size.hpp>
 
+#include <algorithm>
+#include <charconv>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
 namespace ozo {
 template <int... I>
 constexpr std::tuple<boost::mpl::int_<I>...>
@@ -124,12 +137,188 @@ struct recv_impl {
 
 namespace detail {
 
+/**
+ * Extracts `size` bytes from the stream without copying and returns pointer
+ * to them. The pointer refers to the memory the stream reads from.
+ */
+inline const char* recv_view(istream& in, size_type size) {
+    if (size == 0) {
+        return nullptr;
+    }
+    const auto data = in.peek(size);
+    if (!data) {
+        throw system_error(error::unexpected_eof);
+    }
+    in.skip(size);
+    return data;
+}
+
+} // namespace detail
+
+/**
+ * Receives `std::string_view` pointing into the memory of the result the value belongs
+ * to, no data is copied. The result should outlive the view, see `ozo::borrowed_rows`.
+ */
+template <>
+struct recv_impl<std::string_view> {
+    template <typename OidMap>
+    static istream& apply(istream& in, size_type size, const OidMap&, std::string_view& out) {
+        const auto data = detail::recv_view(in, size);
+        out = std::string_view(data, static_cast<std::size_t>(size));
+        return in;
+    }
+};
+
+/**
+ * @brief Text format deserialization implementation
+ * @ingroup group-io-functions
+ *
+ * Some results have text format columns, e.g. the results of the queries made via
+ * some proxies or the columns of the extension types which have no binary output
+ * functions. A value of the text format column is parsed by the implementation for the
+ * type of the object to receive into, if it is defined. The values of the other types are
+ * received by `ozo::recv_impl`, which is fine for the types with the same text and binary
+ * representations like strings.
+ *
+ * The implementations are defined for integers, floating point types, `bool`,
+ * `std::chrono::system_clock::time_point`, `boost::uuids::uuid` and `ozo::pg::basic_numeric`.
+ * The parsing uses `std::from_chars` and does not allocate. The text format arrays and
+ * composites are not supported.
+ *
+ * ### Customization point
+ *
+ * The template may be specialized for a user defined type with the static member function
+ * `void apply(std::string_view in, Out& out)` which throws `ozo::system_error` with
+ * `ozo::error::bad_text_value` if the text can not be parsed.
+ */
+template <typename Out, typename = std::void_t<>>
+struct recv_text_impl {};
+
+namespace detail {
+
+[[noreturn]] inline void throw_bad_text_value(std::string_view in, const std::type_info& type) {
+    throw system_error(error::bad_text_value, "text value \"" + std::string(in)
+        + "\" can not be parsed as " + boost::core::demangle(type.name()));
+}
+
+template <typename T>
+inline T parse_text_number(std::string_view in) {
+    T out {};
+    const auto last = in.data() + in.size();
+    const auto [ptr, ec] = std::from_chars(in.data(), last, out);
+    if (ec != std::errc{} || ptr != last) {
+        throw_bad_text_value(in, typeid(T));
+    }
+    return out;
+}
+
+} // namespace detail
+
+template <typename Out>
+struct recv_text_impl<Out, Require<(Integral<Out> && sizeof(Out) > 1) || FloatingPoint<Out>>> {
+    static void apply(std::string_view in, Out& out) {
+        out = detail::parse_text_number<Out>(in);
+    }
+};
+
+template <>
+struct recv_text_impl<bool> {
+    static void apply(std::string_view in, bool& out) {
+        if (in == "t") {
+            out = true;
+        } else if (in == "f") {
+            out = false;
+        } else {
+            detail::throw_bad_text_value(in, typeid(bool));
+        }
+    }
+};
+
+namespace detail {
+
 template <typename T, typename = std::void_t<>>
 struct recv_impl_dispatcher { using type = recv_impl<std::decay_t<T>>; };
 
+template <typename T, typename = std::void_t<>>
+struct has_recv_text_impl : std::false_type {};
+
+template <typename T>
+struct has_recv_text_impl<T, std::void_t<decltype(
+    recv_text_impl<T>::apply(std::string_view{}, std::declval<T&>())
+)>> : std::true_type {};
+
+template <typename T>
+inline constexpr auto TextReceivable = has_recv_text_impl<std::decay_t<unwrap_type<T>>>::value;
+
+/**
+ * Receives a text format value, the oid should be checked by the caller.
+ */
+template <typename Out>
+inline void recv_text(std::string_view in, bool is_null, Out& out) {
+    if constexpr (Nullable<Out>) {
+        if (is_null) {
+            reset_nullable(out);
+            return;
+        }
+        init_nullable(out);
+    } else if (is_null) {
+        throw std::invalid_argument("unexpected null for type "
+            + boost::core::demangle(typeid(out).name()));
+    }
+    recv_text_impl<std::decay_t<unwrap_type<Out>>>::apply(in, ozo::unwrap(out));
+}
+
 template <typename T>
 using get_recv_impl = typename recv_impl_dispatcher<unwrap_type<T>>::type;
 
+/**
+ * Error of the receive functions which do not throw: the code and the description
+ * which the throwing functions put into the exception.
+ */
+struct recv_error {
+    error_code code;
+    std::string context;
+
+    void set(error_code c, std::string ctx) {
+        code = c;
+        context = std::move(ctx);
+    }
+
+    explicit operator bool() const noexcept { return static_cast<bool>(code);}
+};
+
+/**
+ * Throws the exception the receive functions are documented to throw for the error.
+ */
+[[noreturn]] inline void throw_recv_error(const recv_error& err) {
+    if (err.code == error::unexpected_null) {
+        throw std::invalid_argument(err.context);
+    }
+    if (err.code == error::bad_row_size) {
+        throw std::range_error(err.context);
+    }
+    throw system_error(err.code, err.context);
+}
+
+template <typename Out, typename OidMap>
+inline bool check_oid(const OidMap& oids, oid_t oid, recv_error& err) {
+    if (accepts_oid<std::decay_t<Out>>(oids, oid)) {
+        return true;
+    }
+    err.set(error::oid_type_mismatch, "unexpected oid "
+        + std::to_string(oid) + " for type "
+        + boost::core::demangle(typeid(unwrap_type<Out>).name()));
+    return false;
+}
+
+template <typename Out, typename OidMap>
+inline void check_oid(const OidMap& oids, oid_t oid) {
+    recv_error err;
+    if (!check_oid<Out>(oids, oid, err)) {
+        throw_recv_error(err);
+    }
+}
+
 template <typename OidMap, typename Oid, typename Out>
 inline istream& recv(istream& in, [[maybe_unused]] Oid oid, size_type size, const OidMap& oids, Out& out) {
     static_assert(std::is_same_v<Oid, oid_t>||std::is_same_v<Oid, null_oid_t>,
@@ -143,11 +332,7 @@ inline istream& recv(istream& in, [[maybe_unused]] Oid oid, size_type size, cons
     }
 
     if constexpr (!std::is_same_v<Oid, null_oid_t>) {
-        if (!accepts_oid(oids, out, oid)) {
-            throw system_error(error::oid_type_mismatch, "unexpected oid "
-                + std::to_string(oid) + " for type "
-                + boost::core::demangle(typeid(unwrap_type<Out>).name()));
-        }
+        check_oid<Out>(oids, oid);
     }
 
     if constexpr (Nullable<Out>) {
@@ -247,113 +432,930 @@ inline istream& recv_frame(istream& in, const OidMap& oids, Out& out) {
 
 template <typename T, typename OidMap, typename Out>
 void recv(const value<T>& in, const OidMap& oids, Out& out) {
+    if constexpr (detail::TextReceivable<Out>) {
+        if (in.is_text()) {
+            detail::check_oid<Out>(oids, in.oid());
+            return detail::recv_text({in.data(), in.size()}, in.is_null(), out);
+        }
+    }
     istream s(in.data(), in.size());
     recv(s, in.oid(), (in.is_null() ? null_state_size : in.size()), oids, out);
 }
 
-template <typename T, typename OidMap, typename Out>
-Require<!FusionSequence<Out> && !FusionAdaptedStruct<Out> && !HanaStruct<Out>>
-recv_row(const row<T>& in, const OidMap& oid_map, Out& out) {
-    if (std::size(in) != 1) {
-        throw std::range_error("row size " + std::to_string(std::size(in))
-            + " does not equal 1 for single column result");
+namespace detail {
+
+/**
+ * Plan of columns for a row type. It maps index of a row member to index of
+ * the respective column of a result. Columns of structures are found by names,
+ * columns of other types are taken in order. Since all rows of a result have the
+ * same columns the plan is calculated once per result, so columns are not searched
+ * by names and their oids are not checked for each row.
+ */
+template <std::size_t Size>
+using column_plan = std::array<int, Size>;
+
+template <typename Out>
+constexpr std::size_t columns_count() {
+    if constexpr (HanaStruct<Out>) {
+        return hana::value(hana::size(hana::accessors<Out>()));
+    } else if constexpr (FusionSequence<Out> || FusionAdaptedStruct<Out>) {
+        return fusion::result_of::size<Out>::type::value;
+    } else {
+        return 1;
     }
+}
 
-    recv(*(in.begin()), oid_map, out);
+/**
+ * Calls `f(index, name, type)` for each column of a row type, where `name` is
+ * a member name for structures and `nullptr` for other types.
+ */
+template <typename Out, typename F>
+inline void for_each_column_type(F&& f) {
+    if constexpr (HanaStruct<Out>) {
+        std::size_t idx = 0;
+        hana::for_each(hana::accessors<Out>(), [&](auto accessor) {
+            using type = std::decay_t<decltype(hana::second(accessor)(std::declval<Out&>()))>;
+            f(idx++, hana::to<const char*>(hana::first(accessor)), hana::type_c<type>);
+        });
+    } else if constexpr (FusionSequence<Out> || FusionAdaptedStruct<Out>) {
+        using size = typename fusion::result_of::size<Out>::type;
+        hana::for_each(hana::make_range(hana::size_c<0>, hana::size_c<size::value>), [&](auto idx) {
+            using type = std::decay_t<typename fusion::result_of::value_at_c<Out, idx>::type>;
+            if constexpr (FusionAdaptedStruct<Out>) {
+                f(std::size_t(idx), fusion::extension::struct_member_name<Out, idx>::call(), hana::type_c<type>);
+            } else {
+                f(std::size_t(idx), static_cast<const char*>(nullptr), hana::type_c<type>);
+            }
+        });
+    } else {
+        f(std::size_t(0), static_cast<const char*>(nullptr), hana::type_c<Out>);
+    }
 }
 
-template <typename T, typename OidMap, typename Out>
-Require<FusionSequence<Out> && !FusionAdaptedStruct<Out> && !HanaStruct<Out>>
-recv_row(const row<T>& in, const OidMap& oid_map, Out& out) {
+template <typename Out, typename T>
+inline bool check_row_size(const row<T>& in, recv_error& err) {
+    constexpr auto size = columns_count<Out>();
+    if (size == std::size(in)) {
+        return true;
+    }
+    if constexpr (HanaStruct<Out> || FusionAdaptedStruct<Out>) {
+        err.set(error::bad_row_size, "row size " + std::to_string(std::size(in))
+            + " does not match structure " + boost::core::demangle(typeid(Out).name())
+            + " size " + std::to_string(size));
+    } else if constexpr (FusionSequence<Out>) {
+        err.set(error::bad_row_size, "row size " + std::to_string(std::size(in))
+            + " does not match sequence " + boost::core::demangle(typeid(Out).name())
+            + " size " + std::to_string(size));
+    } else {
+        err.set(error::bad_row_size, "row size " + std::to_string(std::size(in))
+            + " does not equal 1 for single column result");
+    }
+    return false;
+}
 
-    if (static_cast<std::size_t>(fusion::size(out)) != std::size(in)) {
-        throw std::range_error("row size " + std::to_string(std::size(in))
-            + " does not match sequence " + boost::core::demangle(typeid(out).name())
-            + " size " + std::to_string(fusion::size(out)));
+template <typename Out, typename T>
+inline int find_column(const row<T>& in, const char* name, recv_error& err) {
+    const auto i = in.find(name);
+    if (i == in.end()) {
+        err.set(error::bad_row_size, std::string("row does not contain \"")
+            + name + "\" column for "
+            + boost::core::demangle(typeid(Out).name()));
+        return -1;
     }
+    return static_cast<int>(i - in.begin());
+}
 
-    auto i = in.begin();
-    fusion::for_each(out, [&](auto& item) {
-        recv(*i, oid_map, item);
-        ++i;
+template <typename Out, typename T, typename OidMap>
+inline bool make_column_plan(const row<T>& in, const OidMap& oids,
+        column_plan<columns_count<Out>()>& plan, recv_error& err) {
+    if (!check_row_size<Out>(in, err)) {
+        return false;
+    }
+    bool ok = true;
+    for_each_column_type<Out>([&](std::size_t idx, const char* name, auto type) {
+        if (ok) {
+            plan[idx] = name ? find_column<Out>(in, name, err) : static_cast<int>(idx);
+            ok = plan[idx] >= 0 && check_oid<typename decltype(type)::type>(oids, in[plan[idx]].oid(), err);
+        }
     });
+    return ok;
 }
 
-template <typename T, typename OidMap, typename Out>
-Require<FusionAdaptedStruct<Out> && !HanaStruct<Out>>
-recv_row(const row<T>& in, const OidMap& oid_map, Out& out) {
+template <typename Out, typename T, typename OidMap>
+inline bool make_column_plan(const basic_result<T>& in, const OidMap& oids,
+        column_plan<columns_count<Out>()>& plan, recv_error& err) {
+    plan = {};
+    return std::empty(in) || make_column_plan<Out>(*in.begin(), oids, plan, err);
+}
 
-    if (static_cast<std::size_t>(fusion::size(out)) != std::size(in)) {
-        throw std::range_error("row size " + std::to_string(std::size(in))
-            + " does not match structure " + boost::core::demangle(typeid(out).name())
-            + " size " + std::to_string(fusion::size(out)));
+template <typename Out, typename Input, typename OidMap>
+inline column_plan<columns_count<Out>()> make_column_plan(const Input& in, const OidMap& oids) {
+    column_plan<columns_count<Out>()> plan;
+    recv_error err;
+    if (!make_column_plan<Out>(in, oids, plan, err)) {
+        throw_recv_error(err);
     }
+    return plan;
+}
 
-    fusion::for_each(make_index_sequence(fusion::size(out)), [&](auto idx) {
-        auto i = in.find(member_name(out, idx));
-        if (i == in.end()) {
-            throw std::range_error(std::string("row does not contain \"")
-                + member_name(out, idx) + "\" column for "
-                + boost::core::demangle(typeid(out).name()));
-        } else {
-            recv(*i, oid_map, member_value(out, idx));
+/**
+ * Receives a value which oid has been checked already by the column plan.
+ */
+template <typename T, typename OidMap, typename Out>
+inline void recv_checked(const value<T>& in, const OidMap& oids, Out& out) {
+    if constexpr (TextReceivable<Out>) {
+        if (in.is_text()) {
+            return recv_text({in.data(), in.size()}, in.is_null(), out);
         }
-    });
+    }
+    istream s(in.data(), in.size());
+    recv(s, null_oid, (in.is_null() ? null_state_size : in.size()), oids, out);
 }
 
+/**
+ * Same as above, but the unexpected null and the wrong size of an arithmetic value
+ * are reported via the error instead of an exception.
+ */
 template <typename T, typename OidMap, typename Out>
-Require<HanaStruct<Out>>
-recv_row(const row<T>& in, const OidMap& oid_map, Out& out) {
-
-    const auto keys = hana::keys(out);
-    const auto size = size_type(hana::value(hana::size(keys)));
-    if (size != std::size(in)) {
-        throw std::range_error("row size " + std::to_string(std::size(in))
-            + " does not match structure " + boost::core::demangle(typeid(out).name())
-            + " size " + std::to_string(size));
+inline bool recv_checked(const value<T>& in, const OidMap& oids, Out& out, recv_error& err) {
+    using type = std::decay_t<unwrap_type<Out>>;
+    if constexpr (!Nullable<Out>) {
+        if (in.is_null()) {
+            err.set(error::unexpected_null, "unexpected null for type "
+                + boost::core::demangle(typeid(out).name()));
+            return false;
+        }
+    }
+    if constexpr (Integral<type> || FloatingPoint<type>) {
+        if (!in.is_null() && in.is_binary() && in.size() != static_cast<int>(sizeof(type))) {
+            err.set(error::bad_object_size, "data size " + std::to_string(in.size())
+                + " does not match type size " + std::to_string(sizeof(type)));
+            return false;
+        }
     }
+    recv_checked(in, oids, out);
+    return true;
+}
 
-    hana::for_each(keys, [&](auto key) {
-        auto i = in.find(hana::to<const char*>(key));
-        if (i == in.end()) {
-            throw std::range_error(std::string("row does not contain \"")
-                + hana::to<const char*>(key) + "\" column for "
-                + boost::core::demangle(typeid(out).name()));
-        } else {
-            recv(*i, oid_map, hana::at_key(out, key));
+template <typename T, typename OidMap, typename Out, std::size_t Size>
+inline bool recv_row(const row<T>& in, const OidMap& oid_map, Out& out, const column_plan<Size>& plan, recv_error& err) {
+    bool ok = true;
+    if constexpr (HanaStruct<Out>) {
+        std::size_t idx = 0;
+        hana::for_each(hana::keys(out), [&](auto key) {
+            ok = ok && recv_checked(in[plan[idx++]], oid_map, hana::at_key(out, key), err);
+        });
+    } else if constexpr (FusionAdaptedStruct<Out>) {
+        fusion::for_each(make_index_sequence(fusion::size(out)), [&](auto idx) {
+            ok = ok && recv_checked(in[plan[idx]], oid_map, member_value(out, idx), err);
+        });
+    } else if constexpr (FusionSequence<Out>) {
+        std::size_t idx = 0;
+        fusion::for_each(out, [&](auto& item) {
+            ok = ok && recv_checked(in[plan[idx++]], oid_map, item, err);
+        });
+    } else {
+        ok = recv_checked(in[plan[0]], oid_map, out, err);
+    }
+    return ok;
+}
+
+template <typename T, typename OidMap, typename Out, std::size_t Size>
+inline void recv_row(const row<T>& in, const OidMap& oid_map, Out& out, const column_plan<Size>& plan) {
+    recv_error err;
+    if (!recv_row(in, oid_map, out, plan, err)) {
+        throw_recv_error(err);
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Receive a row of a result into an object.
+ * @ingroup group-io-functions
+ *
+ * The row may be received into a #Composite object or into an object of the
+ * column type for a single column row. Members of structures are matched with
+ * the columns by names, items of other sequences are matched in order. The oids
+ * of the columns are checked via `ozo::accepts_oid()` before any value is received.
+ *
+ * @param in --- row to receive
+ * @param oid_map --- #OidMap to get oid for custom types from
+ * @param out --- object to receive into
+ * @throws std::range_error if the row does not match the object type.
+ * @throws ozo::system_error with `ozo::error::oid_type_mismatch` if a column can not be received into the respective member.
+ */
+template <typename T, typename OidMap, typename Out>
+void recv_row(const row<T>& in, const OidMap& oid_map, Out& out) {
+    detail::recv_row(in, oid_map, out, detail::make_column_plan<Out>(in, oid_map));
+}
+
+namespace detail {
+
+/**
+ * Receives rows of the `[first, last)` range of a result into an output iterator.
+ * Ranges of the same result may be received concurrently into different outputs.
+ */
+template <typename T, typename OidMap, typename Out>
+inline Out recv_rows(const basic_result<T>& in, std::size_t first, std::size_t last, const OidMap& oid_map,
+        Out out, recv_error& err, const column_plan_cache* plans = nullptr) {
+    if (first == last) {
+        return out;
+    }
+    using row_type = std::decay_t<decltype(*out)>;
+    column_plan<columns_count<row_type>()> plan;
+    if (!(plans && plans->find<row_type>(plan))
+            && !make_column_plan<row_type>(in[static_cast<int>(first)], oid_map, plan, err)) {
+        return out;
+    }
+    const auto end = in.begin() + static_cast<int>(last);
+    for (auto i = in.begin() + static_cast<int>(first); i != end; ++i) {
+        if (!recv_row(*i, oid_map, *out++, plan, err)) {
+            break;
         }
-    });
+    }
+    return out;
+}
+
+template <typename T, typename OidMap, typename Out>
+inline Out recv_rows(const basic_result<T>& in, std::size_t first, std::size_t last, const OidMap& oid_map, Out out) {
+    recv_error err;
+    out = recv_rows(in, first, last, oid_map, std::move(out), err);
+    if (err) {
+        throw_recv_error(err);
+    }
+    return out;
 }
 
+template <typename T, typename OidMap, typename Out>
+Require<ForwardIterator<Out>, Out>
+recv_result(const basic_result<T>& in, const OidMap& oid_map, Out out, recv_error& err,
+        const column_plan_cache* plans = nullptr) {
+    return recv_rows(in, 0, std::size(in), oid_map, std::move(out), err, plans);
+}
+
+} // namespace detail
+
 template <typename T, typename OidMap, typename Out>
 Require<ForwardIterator<Out>, Out>
 recv_result(const basic_result<T>& in, const OidMap& oid_map, Out out) {
+    return detail::recv_rows(in, 0, std::size(in), oid_map, std::move(out));
+}
+
+/**
+ * @brief Defines how to reserve space for rows in an output container.
+ * @ingroup group-io-types
+ *
+ * It is used by `ozo::recv_result()` for `std::back_insert_iterator` output to
+ * reserve space for all the rows of a result before receiving them. The default
+ * implementation calls `reserve()` for containers which have `reserve()` and
+ * `capacity()` methods, e.g. `std::vector`, so the capacity grows at least twice
+ * like it does on insertion and results received into the same container in a row,
+ * e.g. by the stream requests, do not make it reallocate on each result. For the
+ * other containers it does nothing.
+ *
+ * ### Customization point
+ *
+ * This template is a customization point for user defined containers.
+ *
+ * @tparam Container --- type of the container.
+ */
+template <typename Container, typename = std::void_t<>>
+struct reserve_impl {
+    static constexpr void apply(Container&, std::size_t) noexcept {}
+};
+
+template <typename Container>
+struct reserve_impl<Container, std::void_t<
+    decltype(std::declval<Container&>().reserve(std::size_t())),
+    decltype(std::declval<const Container&>().capacity())
+>> {
+    static void apply(Container& out, std::size_t n) {
+        const auto required = std::size(out) + n;
+        if (out.capacity() < required) {
+            out.reserve(std::max<std::size_t>(required, 2 * out.capacity()));
+        }
+    }
+};
+
+namespace detail {
+
+template <typename T>
+struct is_back_insert_iterator : std::false_type {};
+
+template <typename Container>
+struct is_back_insert_iterator<std::back_insert_iterator<Container>> : std::true_type {};
+
+template <typename Container>
+struct back_insert_iterator_container : std::back_insert_iterator<Container> {
+    static Container& get(std::back_insert_iterator<Container>& out) noexcept {
+        return *(out.*&back_insert_iterator_container::container);
+    }
+};
+
+template <typename Container, typename = std::void_t<>>
+struct is_emplace_back_container : std::false_type {};
+
+template <typename Container>
+struct is_emplace_back_container<Container, std::void_t<
+    decltype(std::declval<Container&>().pop_back())
+>> : std::is_same<decltype(std::declval<Container&>().emplace_back()), typename Container::value_type&> {};
+
+/**
+ * Receives rows into a container in place: each row is constructed at the end of the
+ * container and then received, so no temporary object is moved. The row is removed if
+ * it can not be received.
+ */
+template <typename T, typename OidMap, typename Container, std::size_t Size>
+inline bool emplace_rows(const basic_result<T>& in, const OidMap& oid_map, Container& out,
+        const column_plan<Size>& plan, recv_error& err) {
     for (auto row : in) {
-        recv_row(row, oid_map, *out++);
+        auto& v = out.emplace_back();
+        bool ok = false;
+        try {
+            ok = recv_row(row, oid_map, v, plan, err);
+        } catch (...) {
+            out.pop_back();
+            throw;
+        }
+        if (!ok) {
+            out.pop_back();
+            return false;
+        }
     }
-    return out;
+    return true;
+}
+
+/**
+ * Capacity of a container which can not grow beyond it, e.g. `boost::container::static_vector`
+ * or `ozo::static_rows`, as declared by their `static_capacity` member. Zero for the others.
+ */
+template <typename Container, typename = std::void_t<>>
+struct static_capacity : std::integral_constant<std::size_t, 0> {};
+
+template <typename Container>
+struct static_capacity<Container, std::void_t<decltype(Container::static_capacity)>>
+    : std::integral_constant<std::size_t, static_cast<std::size_t>(Container::static_capacity)> {};
+
+template <typename Container>
+inline constexpr auto FixedCapacity = static_capacity<std::decay_t<Container>>::value != 0;
+
+inline bool check_rows_capacity(std::size_t size, std::size_t rows, std::size_t capacity, recv_error& err) {
+    if (size + rows <= capacity) {
+        return true;
+    }
+    err.set(error::too_many_rows, "result rows count " + std::to_string(rows)
+        + " exceeds the free capacity " + std::to_string(capacity - std::min(size, capacity)) + " of the output");
+    return false;
 }
 
 template <typename T, typename OidMap, typename Out>
 Require<InsertIterator<Out>, Out>
-recv_result(const basic_result<T>& in, const OidMap& oid_map, Out out) {
+recv_result(const basic_result<T>& in, const OidMap& oid_map, Out out, recv_error& err,
+        const column_plan_cache* plans = nullptr) {
+    using container_type = typename Out::container_type;
+    using row_type = typename container_type::value_type;
+    column_plan<columns_count<row_type>()> plan;
+    if (!(plans && plans->find<row_type>(plan)) && !make_column_plan<row_type>(in, oid_map, plan, err)) {
+        return out;
+    }
+    if constexpr (is_back_insert_iterator<Out>::value) {
+        auto& container = back_insert_iterator_container<container_type>::get(out);
+        if constexpr (FixedCapacity<container_type>) {
+            // The container can not grow, so the result is rejected before any row is received
+            if (!check_rows_capacity(std::size(container), std::size(in), static_capacity<container_type>::value, err)) {
+                return out;
+            }
+        } else {
+            reserve_impl<container_type>::apply(container, std::size(in));
+        }
+        if constexpr (is_emplace_back_container<container_type>::value) {
+            emplace_rows(in, oid_map, container, plan, err);
+            return out;
+        }
+    }
     for (auto row : in) {
-        typename Out::container_type::value_type v{};
-        recv_row(row, oid_map, v);
+        typename container_type::value_type v{};
+        if (!recv_row(row, oid_map, v, plan, err)) {
+            break;
+        }
         *out++ = std::move(v);
     }
     return out;
 }
 
+} // namespace detail
+
+template <typename T, typename OidMap, typename Out>
+Require<InsertIterator<Out>, Out>
+recv_result(const basic_result<T>& in, const OidMap& oid_map, Out out) {
+    detail::recv_error err;
+    out = detail::recv_result(in, oid_map, std::move(out), err);
+    if (err) {
+        detail::throw_recv_error(err);
+    }
+    return out;
+}
+
+/**
+ * @brief Output which receives rows over the existing rows of a container
+ * @ingroup group-io-types
+ *
+ * The rows of a result are received into the rows the container already has, so the
+ * strings and the containers of the rows keep their storage and reuse its capacity.
+ * The container is resized once to the rows count of the result: new rows are appended
+ * if the result has more rows, the tail is removed if it has fewer. A polling loop which
+ * receives results of a similar size into the same container allocates almost nothing.
+ *
+ * The container should have `size()`, `resize()` and random access iterators, e.g. `std::vector`.
+ * If a row can not be received the rows from it to the end are removed.
+ *
+ * @sa ozo::overwrite()
+ */
+template <typename Container>
+struct overwrite_rows {
+    std::reference_wrapper<Container> rows;
+};
+
+/**
+ * @brief Receive rows over the existing rows of a container
+ * @ingroup group-io-functions
+ *
+ * ### Example
+ *
+ * @code
+ozo::rows_of<std::int64_t, std::string> rows;
+for (;;) {
+    ozo::request(conn_info[io], query, ozo::overwrite(rows), yield);
+    process(rows);
+}
+ * @endcode
+ *
+ * @param rows --- container to receive rows into
+ * @return `ozo::overwrite_rows` output
+ */
+template <typename Container>
+constexpr overwrite_rows<Container> overwrite(Container& rows) noexcept { return {std::ref(rows)};}
+
+namespace detail {
+
+template <typename T, typename OidMap, typename Container>
+overwrite_rows<Container>& recv_result(const basic_result<T>& in, const OidMap& oid_map, overwrite_rows<Container>& out,
+        recv_error& err, const column_plan_cache* plans = nullptr) {
+    using row_type = typename Container::value_type;
+    auto& rows = out.rows.get();
+    const auto count = static_cast<std::size_t>(std::size(in));
+    if (count == 0) {
+        rows.resize(0);
+        return out;
+    }
+    column_plan<columns_count<row_type>()> plan;
+    if (!(plans && plans->find<row_type>(plan)) && !make_column_plan<row_type>(in, oid_map, plan, err)) {
+        return out;
+    }
+    rows.resize(count);
+    std::size_t i = 0;
+    try {
+        for (auto row : in) {
+            if (!recv_row(row, oid_map, rows[i], plan, err)) {
+                break;
+            }
+            ++i;
+        }
+    } catch (...) {
+        rows.resize(i);
+        throw;
+    }
+    rows.resize(i);
+    return out;
+}
+
+} // namespace detail
+
+/**
+ * @brief Receive a result over the existing rows of a container, see `ozo::overwrite_rows`.
+ * @ingroup group-io-functions
+ *
+ * @param in --- result to receive
+ * @param oid_map --- #OidMap to get oid for custom types from
+ * @param out --- output to receive into
+ * @return the output
+ */
+template <typename T, typename OidMap, typename Container>
+overwrite_rows<Container>& recv_result(const basic_result<T>& in, const OidMap& oid_map, overwrite_rows<Container>& out) {
+    detail::recv_error err;
+    detail::recv_result(in, oid_map, out, err);
+    if (err) {
+        detail::throw_recv_error(err);
+    }
+    return out;
+}
+
+namespace detail {
+
+/**
+ * The row is received into the optional in place. The optional is reset if the
+ * result has no rows or the row can not be received.
+ */
+template <typename T, typename OidMap, typename Row>
+std::optional<Row>& recv_result(const basic_result<T>& in, const OidMap& oid_map, std::optional<Row>& out,
+        recv_error& err, const column_plan_cache* plans = nullptr) {
+    out.reset();
+    if (std::empty(in) || !check_rows_capacity(0, std::size(in), 1, err)) {
+        return out;
+    }
+    column_plan<columns_count<Row>()> plan;
+    if (!(plans && plans->find<Row>(plan)) && !make_column_plan<Row>(in, oid_map, plan, err)) {
+        return out;
+    }
+    try {
+        if (!recv_row(*in.begin(), oid_map, out.emplace(), plan, err)) {
+            out.reset();
+        }
+    } catch (...) {
+        out.reset();
+        throw;
+    }
+    return out;
+}
+
+} // namespace detail
+
+/**
+ * @brief Receive a result of at most one row into an optional row.
+ * @ingroup group-io-functions
+ *
+ * The optional is empty if the result has no rows, so a lookup by a key
+ * needs no container.
+ *
+ * @param in --- result to receive
+ * @param oid_map --- #OidMap to get oid for custom types from
+ * @param out --- optional row to receive into
+ * @return the optional row
+ * @throws ozo::system_error with `ozo::error::too_many_rows` if the result has more than one row.
+ */
+template <typename T, typename OidMap, typename Row>
+std::optional<Row>& recv_result(const basic_result<T>& in, const OidMap& oid_map, std::optional<Row>& out) {
+    detail::recv_error err;
+    detail::recv_result(in, oid_map, out, err);
+    if (err) {
+        detail::throw_recv_error(err);
+    }
+    return out;
+}
+
+namespace detail {
+
+template <typename Column, typename = std::void_t<>>
+struct is_fixed_size_column : std::false_type {};
+
+template <typename Column>
+struct is_fixed_size_column<Column, std::void_t<
+    decltype(std::data(std::declval<Column&>())),
+    decltype(std::declval<Column&>().resize(std::size_t()))
+>> : std::bool_constant<
+    std::is_same_v<decltype(std::data(std::declval<Column&>())), typename Column::value_type*>
+    && BulkItem<typename Column::value_type>
+> {};
+
+/**
+ * Receives values of a fixed size binary representation type column, see
+ * `ozo::detail::bulk_item`, into a contiguous container without intermediate
+ * objects and checks except null state and size.
+ */
+template <typename T, typename Column>
+inline bool recv_fixed_size_column(const basic_result<T>& in, int column, Column& out, recv_error& err) {
+    using value_type = typename Column::value_type;
+    using item = bulk_item<value_type>;
+    const auto offset = std::size(out);
+    out.resize(offset + std::size(in));
+    auto dst = std::data(out) + offset;
+    for (const auto& row : in) {
+        const auto v = row[column];
+        if (v.is_null()) {
+            err.set(error::unexpected_null, "unexpected null for type "
+                + boost::core::demangle(typeid(value_type).name()));
+        } else if (v.size() != item::size) {
+            err.set(error::bad_object_size, "data size " + std::to_string(v.size())
+                + " does not match type size " + std::to_string(item::size));
+        }
+        if (err) {
+            out.resize(static_cast<std::size_t>(dst - std::data(out)));
+            return false;
+        }
+        *dst++ = item::load(v.data());
+    }
+    return true;
+}
+
+template <typename Container, typename = std::void_t<>>
+struct is_allocator_aware_container : std::false_type {};
+
+template <typename Container>
+struct is_allocator_aware_container<Container, std::void_t<
+    typename Container::allocator_type,
+    decltype(std::declval<const Container&>().get_allocator())
+>> : std::true_type {};
+
+template <typename Container>
+inline constexpr auto AllocatorAwareContainer = is_allocator_aware_container<std::decay_t<Container>>::value;
+
+/**
+ * Makes an element for a container before it is received. The element is constructed
+ * with the allocator of the container if it uses one, e.g. `std::pmr::string` for
+ * `std::pmr::vector<std::pmr::string>`, so the received data is allocated by the memory
+ * resource of the container and the element is moved into it without a copy. The value
+ * of a `#Nullable` element is allocated with the allocator the same way.
+ */
+template <typename Container>
+inline typename Container::value_type make_container_item([[maybe_unused]] const Container& out) {
+    using value_type = typename Container::value_type;
+    if constexpr (AllocatorAwareContainer<Container>) {
+        using allocator_type = typename Container::allocator_type;
+        if constexpr (std::uses_allocator_v<value_type, allocator_type>) {
+            if constexpr (std::is_constructible_v<value_type, std::allocator_arg_t, const allocator_type&>) {
+                return value_type(std::allocator_arg, out.get_allocator());
+            } else {
+                return value_type(out.get_allocator());
+            }
+        } else if constexpr (Nullable<value_type> && std::uses_allocator_v<unwrap_type<value_type>, allocator_type>) {
+            value_type v{};
+            allocate_nullable(v, out.get_allocator());
+            return v;
+        } else {
+            return value_type{};
+        }
+    } else {
+        return value_type{};
+    }
+}
+
+template <typename T, typename OidMap, typename Column>
+inline bool recv_column(const basic_result<T>& in, int column, const OidMap& oid_map, Column& out, recv_error& err) {
+    if constexpr (is_fixed_size_column<Column>::value) {
+        if (impl::field_format(*in.native_handle(), column) == impl::result_format::binary) {
+            return recv_fixed_size_column(in, column, out, err);
+        }
+    }
+    for (const auto& row : in) {
+        auto v = make_container_item(out);
+        if (!recv_checked(row[column], oid_map, v, err)) {
+            return false;
+        }
+        out.insert(std::end(out), std::move(v));
+    }
+    return true;
+}
+
+template <typename T, typename OidMap, typename ...Columns>
+std::tuple<Columns...>& recv_result(const basic_result<T>& in, const OidMap& oid_map,
+        std::tuple<Columns...>& out, recv_error& err) {
+    if (std::empty(in)) {
+        return out;
+    }
+
+    const auto row = *in.begin();
+    if (sizeof...(Columns) != std::size(row)) {
+        err.set(error::bad_row_size, "result columns count " + std::to_string(std::size(row))
+            + " does not match columns containers count " + std::to_string(sizeof...(Columns)));
+        return out;
+    }
+
+    bool ok = true;
+    hana::for_each(hana::make_range(hana::int_c<0>, hana::int_c<sizeof...(Columns)>), [&](auto i) {
+        auto& column = std::get<i>(out);
+        ok = ok && check_oid<typename std::decay_t<decltype(column)>::value_type>(oid_map, row[i].oid(), err)
+            && recv_column(in, i, oid_map, column, err);
+    });
+    return out;
+}
+
+template <typename T, typename OidMap>
+basic_result<T>& recv_result(basic_result<T>& in, const OidMap&, basic_result<T>& out, recv_error&) {
+    out = std::move(in);
+    return out;
+}
+
+/**
+ * Rows are received first, then the result is moved into the container, so the
+ * view members of the rows stay valid. The container is not changed on error.
+ */
+template <typename T, typename OidMap, typename Row>
+borrowed_rows<Row, T>& recv_result(basic_result<T>& in, const OidMap& oid_map,
+        borrowed_rows<Row, T>& out, recv_error& err, const column_plan_cache* plans = nullptr) {
+    typename borrowed_rows<Row, T>::container_type rows;
+    rows.reserve(std::size(in));
+    recv_result(std::as_const(in), oid_map, std::back_inserter(rows), err, plans);
+    if (!err) {
+        out.assign(std::move(in), std::move(rows));
+    }
+    return out;
+}
+
+} // namespace detail
+
+/**
+ * @brief Receive a result into per column containers.
+ * @ingroup group-io-functions
+ *
+ * Receives each column of the result into the respective container of the tuple,
+ * e.g. `std::tuple<std::vector<std::int64_t>, std::vector<double>>`, column by column.
+ * Received values are appended to the containers. The oid of each column is checked
+ * once. Columns of fixed size arithmetic types stored in contiguous containers are
+ * received by a tight loop without intermediate objects.
+ *
+ * @param in --- result to receive
+ * @param oid_map --- #OidMap to get oid for custom types from
+ * @param out --- tuple of containers to receive columns into
+ * @return tuple of containers
+ * @throws std::range_error if the result columns count does not match the tuple size.
+ * @throws ozo::system_error with `ozo::error::oid_type_mismatch` if a column can not be received into the respective container.
+ */
+template <typename T, typename OidMap, typename ...Columns>
+std::tuple<Columns...>& recv_result(const basic_result<T>& in, const OidMap& oid_map, std::tuple<Columns...>& out) {
+    detail::recv_error err;
+    detail::recv_result(in, oid_map, out, err);
+    if (err) {
+        detail::throw_recv_error(err);
+    }
+    return out;
+}
+
 template <typename T, typename OidMap>
 basic_result<T>& recv_result(basic_result<T>& in, const OidMap&, basic_result<T>& out) {
     out = std::move(in);
     return out;
 }
 
+/**
+ * @brief Receive a result into rows which borrow data from it.
+ * @ingroup group-io-functions
+ *
+ * Rows are received first, then the result is moved into the container, so the
+ * view members of the rows stay valid. The content of the container is replaced.
+ *
+ * @param in --- result to receive, it is moved into the container
+ * @param oid_map --- #OidMap to get oid for custom types from
+ * @param out --- container to receive into
+ * @return the container
+ */
+template <typename T, typename OidMap, typename Row>
+borrowed_rows<Row, T>& recv_result(basic_result<T>& in, const OidMap& oid_map, borrowed_rows<Row, T>& out) {
+    detail::recv_error err;
+    detail::recv_result(in, oid_map, out, err);
+    if (err) {
+        detail::throw_recv_error(err);
+    }
+    return out;
+}
+
 template <typename T, typename OidMap, typename Out>
-basic_result<T>& recv_result(basic_result<T>& in, const OidMap& oid_map, std::reference_wrapper<Out> out) {
+decltype(auto) recv_result(basic_result<T>& in, const OidMap& oid_map, std::reference_wrapper<Out> out) {
     return recv_result(in, oid_map, out.get());
 }
 
+namespace detail {
+
+template <typename Result, typename OidMap, typename Out, typename = std::void_t<>>
+struct has_recv_result_with_error : std::false_type {};
+
+template <typename Result, typename OidMap, typename Out>
+struct has_recv_result_with_error<Result, OidMap, Out, std::void_t<decltype(recv_result(
+    std::declval<Result&>(), std::declval<const OidMap&>(), std::declval<Out&>(), std::declval<recv_error&>()
+))>> : std::true_type {};
+
+template <typename Result, typename OidMap, typename Out, typename = std::void_t<>>
+struct has_recv_result_with_plans : std::false_type {};
+
+template <typename Result, typename OidMap, typename Out>
+struct has_recv_result_with_plans<Result, OidMap, Out, std::void_t<decltype(recv_result(
+    std::declval<Result&>(), std::declval<const OidMap&>(), std::declval<Out&>(), std::declval<recv_error&>(),
+    std::declval<const column_plan_cache*>()
+))>> : std::true_type {};
+
+template <typename T>
+struct is_reference_wrapper : std::false_type {};
+
+template <typename T>
+struct is_reference_wrapper<std::reference_wrapper<T>> : std::true_type {};
+
+/**
+ * Receives the result via the receive functions which report errors, the outputs
+ * which do not have them, e.g. user defined ones, are received by `ozo::recv_result()`.
+ */
+template <typename T, typename OidMap, typename Out>
+inline void try_recv_result(basic_result<T>& in, const OidMap& oid_map, Out& out, recv_error& err,
+        const column_plan_cache* plans = nullptr) {
+    if constexpr (is_reference_wrapper<Out>::value) {
+        try_recv_result(in, oid_map, out.get(), err, plans);
+    } else if constexpr (has_recv_result_with_plans<basic_result<T>, OidMap, Out>::value) {
+        recv_result(in, oid_map, out, err, plans);
+    } else if constexpr (has_recv_result_with_error<basic_result<T>, OidMap, Out>::value) {
+        recv_result(in, oid_map, out, err);
+    } else {
+        // Unqualified to find the overloads of the outputs declared later via ADL
+        recv_result(in, oid_map, out);
+    }
+}
+
+} // namespace detail
+
+namespace detail {
+
+template <typename Out, typename = std::void_t<>>
+struct result_row_type {};
+
+template <typename Out>
+struct result_row_type<Out, Require<ForwardIterator<Out> && !InsertIterator<Out>>> {
+    using type = std::decay_t<decltype(*std::declval<Out&>())>;
+};
+
+template <typename Out>
+struct result_row_type<Out, Require<InsertIterator<Out>>> {
+    using type = typename Out::container_type::value_type;
+};
+
+template <typename Row, typename T>
+struct result_row_type<borrowed_rows<Row, T>> {
+    using type = Row;
+};
+
+template <typename Row>
+struct result_row_type<std::optional<Row>> {
+    using type = Row;
+};
+
+template <typename Container>
+struct result_row_type<overwrite_rows<Container>> {
+    using type = typename Container::value_type;
+};
+
+template <typename Out>
+struct result_row_type<std::reference_wrapper<Out>> : result_row_type<std::decay_t<Out>> {};
+
+template <typename Out, typename = std::void_t<>>
+struct has_result_row_type : std::false_type {};
+
+template <typename Out>
+struct has_result_row_type<Out, std::void_t<typename result_row_type<Out>::type>> : std::true_type {};
+
+/**
+ * Makes the column plan of the rows of an output from the description of a prepared
+ * statement, i.e. a result with the columns and without rows. The plan is not added
+ * if the columns do not match the row type, so the results report the mismatch.
+ */
+template <typename T, typename OidMap, typename Out>
+inline void describe_result(const basic_result<T>& description, const OidMap& oid_map, const Out&,
+        column_plan_cache& plans) {
+    if constexpr (has_result_row_type<Out>::value) {
+        using row_type = typename result_row_type<Out>::type;
+        column_plan<columns_count<row_type>()> plan;
+        recv_error err;
+        if (make_column_plan<row_type>(*description.begin(), oid_map, plan, err)) {
+            plans.emplace<row_type>(plan);
+        }
+    }
+}
+
+template <typename T, typename OidMap, typename Out>
+inline error_code try_recv_result_code(basic_result<T>& in, const OidMap& oid_map, Out& out, std::string& context,
+        const column_plan_cache* plans) {
+    recv_error err;
+    try {
+        try_recv_result(in, oid_map, out, err, plans);
+    } catch (const std::exception& e) {
+        err.set(error::bad_result_process, e.what());
+    }
+    if (err) {
+        context = std::move(err.context);
+    }
+    return err.code;
+}
+
+} // namespace detail
+
+/**
+ * @brief Receive a result into an output and report errors via error code.
+ * @ingroup group-io-functions
+ *
+ * Same as `ozo::recv_result()`, but the mismatches of the result and the output ---
+ * row size, missing column, column oid, unexpected null and size of an arithmetic value ---
+ * are detected without exceptions, so malformed data does not cost a stack unwinding.
+ * `ozo::request()` receives results this way. Exceptions of the nested types, e.g.
+ * arrays or composites, and of the user defined `ozo::recv_impl` specializations and
+ * outputs are caught and reported as `ozo::error::bad_result_process`.
+ *
+ * @param in --- result to receive
+ * @param oid_map --- #OidMap to get oid for custom types from
+ * @param out --- output to receive into, same as for `ozo::recv_result()`
+ * @param context --- receives the description of the error, it is not changed on success
+ * @return `ozo::error_code` --- `ozo::error::bad_row_size`, `ozo::error::oid_type_mismatch`,
+ *         `ozo::error::unexpected_null`, `ozo::error::bad_object_size` or `ozo::error::bad_result_process`
+ *         on error. The output may contain the rows received before the error.
+ */
+template <typename T, typename OidMap, typename Out>
+error_code try_recv_result(basic_result<T>& in, const OidMap& oid_map, Out& out, std::string& context) {
+    return detail::try_recv_result_code(in, oid_map, out, context, nullptr);
+}
+
 } // namespace ozo
@@ -107,10 +107,33 @@ inline ostream& send(ostream& out, const OidMap& oid_map, const In& in) {
  * @param in --- object to send
  * @return ostream& --- reference to the output stream
  */
+namespace detail {
+
+/**
+ * Size of arrays and composites is calculated via recursion through the whole
+ * structure, so their data frames are written in a single pass: a placeholder
+ * is written for the size and then it is back-patched with the size of the
+ * data written.
+ */
+template <typename T>
+inline constexpr auto BackPatchedFrame = Array<unwrap_type<T>> || Composite<unwrap_type<T>>;
+
+} // namespace detail
+
 template <class OidMap, class In>
 inline ostream& send_data_frame(ostream& out, const OidMap& oid_map, const In& in) {
-    write(out, size_of(in));
-    return send(out, oid_map, in);
+    if constexpr (detail::BackPatchedFrame<In>) {
+        if (ozo::is_null(in)) {
+            return write(out, static_cast<size_type>(null_state_size));
+        }
+        const auto pos = out.tellp();
+        write(out, size_type(0));
+        send(out, oid_map, in);
+        return out.patch(pos, static_cast<size_type>(out.tellp() - pos - sizeof(size_type)));
+    } else {
+        write(out, size_of(in));
+        return send(out, oid_map, in);
+    }
 }
 
 /**
@@ -0,0 +1,570 @@
+#pragma once
+
+#include <ozo/error.h>
+#include <ozo/result.h>
+#include <ozo/detail/endian.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @defgroup group-json JSON serialization
+ * @ingroup group-core
+ * @brief Serialization of the results into JSON.
+ *
+ * The results are written into JSON text straight from their binary representation,
+ * with no intermediate row objects. Each chunk of `ozo::stream_request()` is a separate
+ * result, so a streamed result is serialized chunk by chunk via the same `ozo::json::writer`.
+ *
+ *@code
+#include <ozo/json.h>
+ *@endcode
+ */
+
+namespace ozo::json {
+
+/**
+ * @brief JSON representation of a row
+ * @ingroup group-json
+ */
+enum class row_format {
+    object, //!< object keyed by the column names, e.g. `{"id":1,"name":"a"}`
+    array, //!< array of the values in the columns order, e.g. `[1,"a"]`
+};
+
+namespace detail {
+
+// Offsets of the PostgreSQL epoch 2000-01-01 from the Unix epoch
+constexpr std::int64_t pg_epoch_days = 10957;
+constexpr std::int64_t microseconds_per_day = std::int64_t(86400) * 1000000;
+
+constexpr std::uint64_t swar_ones = 0x0101010101010101ull;
+constexpr std::uint64_t swar_highs = 0x8080808080808080ull;
+
+/**
+ * `true` if any byte of the word is a control character, a quote or a backslash,
+ * i.e. the word should be escaped. The bytes are tested all at once without branches.
+ */
+constexpr bool needs_escape(std::uint64_t w) noexcept {
+    const auto control = (w - swar_ones * 0x20) & ~w;
+    const auto quote = (w ^ (swar_ones * '"'));
+    const auto backslash = (w ^ (swar_ones * '\\'));
+    return ((control | ((quote - swar_ones) & ~quote) | ((backslash - swar_ones) & ~backslash)) & swar_highs) != 0;
+}
+
+inline void escape_char(char c, std::string& out) {
+    switch (c) {
+        case '"': out.append("\\\"", 2); return;
+        case '\\': out.append("\\\\", 2); return;
+        case '\b': out.append("\\b", 2); return;
+        case '\f': out.append("\\f", 2); return;
+        case '\n': out.append("\\n", 2); return;
+        case '\r': out.append("\\r", 2); return;
+        case '\t': out.append("\\t", 2); return;
+        default: break;
+    }
+    if (static_cast<unsigned char>(c) < 0x20) {
+        constexpr const char digits[] = "0123456789abcdef";
+        const char escaped[] = {'\\', 'u', '0', '0', digits[(c >> 4) & 0xF], digits[c & 0xF]};
+        out.append(escaped, sizeof(escaped));
+    } else {
+        out.push_back(c);
+    }
+}
+
+/**
+ * Writes a quoted and escaped string. Eight bytes are checked at a time, the runs
+ * of the bytes which need no escaping, i.e. almost all the text, are appended at once.
+ */
+inline void write_string(const char* data, std::size_t size, std::string& out) {
+    out.push_back('"');
+    std::size_t run = 0;
+    std::size_t i = 0;
+    for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t)) {
+        std::uint64_t w;
+        std::memcpy(&w, data + i, sizeof(w));
+        if (!needs_escape(w)) {
+            continue;
+        }
+        out.append(data + run, i - run);
+        for (std::size_t j = i; j < i + sizeof(std::uint64_t); ++j) {
+            escape_char(data[j], out);
+        }
+        run = i + sizeof(std::uint64_t);
+    }
+    out.append(data + run, i - run);
+    for (; i < size; ++i) {
+        escape_char(data[i], out);
+    }
+    out.push_back('"');
+}
+
+template <typename T>
+inline void write_integer(T v, std::string& out) {
+    char buffer[24];
+    const auto r = std::to_chars(std::begin(buffer), std::end(buffer), v);
+    out.append(buffer, r.ptr);
+}
+
+template <typename T>
+inline void write_float(T v, std::string& out) {
+    if (std::isnan(v)) {
+        out.append("\"NaN\"");
+    } else if (std::isinf(v)) {
+        out.append(v > 0 ? "\"Infinity\"" : "\"-Infinity\"");
+    } else {
+        char buffer[32];
+        const auto r = std::to_chars(std::begin(buffer), std::end(buffer), v);
+        out.append(buffer, r.ptr);
+    }
+}
+
+template <typename T>
+inline T load(const char* data) noexcept {
+    T v;
+    std::memcpy(&v, data, sizeof(v));
+    return ozo::detail::convert_from_big_endian(v);
+}
+
+inline void write_digits(unsigned v, int width, std::string& out) {
+    char buffer[8];
+    for (int i = width - 1; i >= 0; --i, v /= 10) {
+        buffer[i] = char('0' + v % 10);
+    }
+    out.append(buffer, static_cast<std::size_t>(width));
+}
+
+inline void write_date(std::int64_t days, std::string& out) {
+    // Civil date from days since the Unix epoch by Howard Hinnant's algorithm
+    days += pg_epoch_days + 719468;
+    const auto era = (days >= 0 ? days : days - 146096) / 146097;
+    const auto doe = static_cast<unsigned>(days - era * 146097);
+    const auto yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const auto doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const auto mp = (5 * doy + 2) / 153;
+    const auto day = doy - (153 * mp + 2) / 5 + 1;
+    const auto month = mp < 10 ? mp + 3 : mp - 9;
+    const auto year = static_cast<std::int64_t>(yoe) + era * 400 + (month <= 2);
+    if (year < 0) {
+        out.push_back('-');
+    }
+    const auto abs_year = static_cast<unsigned>(year < 0 ? -year : year);
+    if (abs_year > 9999) {
+        write_integer(abs_year, out);
+    } else {
+        write_digits(abs_year, 4, out);
+    }
+    out.push_back('-');
+    write_digits(month, 2, out);
+    out.push_back('-');
+    write_digits(day, 2, out);
+}
+
+inline void write_time(std::int64_t microseconds, std::string& out) {
+    const auto seconds = static_cast<unsigned>(microseconds / 1000000);
+    write_digits(seconds / 3600, 2, out);
+    out.push_back(':');
+    write_digits(seconds / 60 % 60, 2, out);
+    out.push_back(':');
+    write_digits(seconds % 60, 2, out);
+    auto fraction = static_cast<unsigned>(microseconds % 1000000);
+    if (fraction) {
+        int width = 6;
+        for (; fraction % 10 == 0; fraction /= 10) {
+            --width;
+        }
+        out.push_back('.');
+        write_digits(fraction, width, out);
+    }
+}
+
+/**
+ * Writer of a non null value of a column. The value has the expected size for the fixed
+ * width types since the size is checked by the caller.
+ */
+using encoder = void (*)(const char* data, std::size_t size, std::string& out);
+
+inline void encode_bool(const char* data, std::size_t, std::string& out) {
+    out.append(*data ? "true" : "false");
+}
+
+template <typename T>
+inline void encode_integer(const char* data, std::size_t, std::string& out) {
+    write_integer(load<T>(data), out);
+}
+
+template <typename T, typename Bits>
+inline void encode_float(const char* data, std::size_t, std::string& out) {
+    const auto bits = load<Bits>(data);
+    T v;
+    std::memcpy(&v, &bits, sizeof(v));
+    write_float(v, out);
+}
+
+/**
+ * The base-10000 digits of `numeric` are written as a JSON number, like `to_json()` does.
+ */
+inline void encode_numeric(const char* data, std::size_t size, std::string& out) {
+    if (size < 8) {
+        throw system_error(error::bad_object_size, "numeric data size " + std::to_string(size)
+            + " is less than the header size");
+    }
+    const auto ndigits = load<std::int16_t>(data);
+    const auto weight = load<std::int16_t>(data + 2);
+    const auto sign = load<std::uint16_t>(data + 4);
+    const auto dscale = load<std::int16_t>(data + 6);
+    if (sign == 0xC000) {
+        out.append("\"NaN\"");
+        return;
+    }
+    if (sign == 0xD000) {
+        out.append("\"Infinity\"");
+        return;
+    }
+    if (sign == 0xF000) {
+        out.append("\"-Infinity\"");
+        return;
+    }
+    if (ndigits < 0 || size < 8 + 2 * static_cast<std::size_t>(ndigits)) {
+        throw system_error(error::bad_object_size, "numeric data size " + std::to_string(size)
+            + " does not match the number of digits " + std::to_string(ndigits));
+    }
+    const auto digit = [&] (int i) -> unsigned {
+        return i >= 0 && i < ndigits ? static_cast<unsigned>(load<std::int16_t>(data + 8 + 2 * i)) : 0;
+    };
+    if (sign == 0x4000) {
+        out.push_back('-');
+    }
+    if (weight < 0) {
+        out.push_back('0');
+    } else {
+        write_integer(digit(0), out);
+        for (int i = 1; i <= weight; ++i) {
+            write_digits(digit(i), 4, out);
+        }
+    }
+    if (dscale > 0) {
+        out.push_back('.');
+        for (int i = weight + 1, written = 0; written < dscale; ++i, written += 4) {
+            char buffer[4];
+            auto v = digit(i);
+            for (int j = 3; j >= 0; --j, v /= 10) {
+                buffer[j] = char('0' + v % 10);
+            }
+            out.append(buffer, static_cast<std::size_t>(std::min(4, dscale - written)));
+        }
+    }
+}
+
+inline void encode_date(const char* data, std::size_t, std::string& out) {
+    const auto days = load<std::int32_t>(data);
+    if (days == std::numeric_limits<std::int32_t>::max()) {
+        out.append("\"infinity\"");
+        return;
+    }
+    if (days == std::numeric_limits<std::int32_t>::min()) {
+        out.append("\"-infinity\"");
+        return;
+    }
+    out.push_back('"');
+    write_date(days, out);
+    out.push_back('"');
+}
+
+template <bool WithZone>
+inline void encode_timestamp(const char* data, std::size_t, std::string& out) {
+    const auto v = load<std::int64_t>(data);
+    if (v == std::numeric_limits<std::int64_t>::max()) {
+        out.append("\"infinity\"");
+        return;
+    }
+    if (v == std::numeric_limits<std::int64_t>::min()) {
+        out.append("\"-infinity\"");
+        return;
+    }
+    auto days = v / microseconds_per_day;
+    auto time = v % microseconds_per_day;
+    if (time < 0) {
+        time += microseconds_per_day;
+        --days;
+    }
+    out.push_back('"');
+    write_date(days, out);
+    out.push_back('T');
+    write_time(time, out);
+    if constexpr (WithZone) {
+        out.append("+00:00");
+    }
+    out.push_back('"');
+}
+
+inline void encode_uuid(const char* data, std::size_t, std::string& out) {
+    constexpr const char digits[] = "0123456789abcdef";
+    char buffer[38];
+    std::size_t n = 0;
+    buffer[n++] = '"';
+    for (std::size_t i = 0; i < 16; ++i) {
+        if (i == 4 || i == 6 || i == 8 || i == 10) {
+            buffer[n++] = '-';
+        }
+        buffer[n++] = digits[(static_cast<unsigned char>(data[i]) >> 4) & 0xF];
+        buffer[n++] = digits[static_cast<unsigned char>(data[i]) & 0xF];
+    }
+    buffer[n++] = '"';
+    out.append(buffer, n);
+}
+
+inline void encode_string(const char* data, std::size_t size, std::string& out) {
+    write_string(data, size, out);
+}
+
+inline void encode_json(const char* data, std::size_t size, std::string& out) {
+    out.append(data, size);
+}
+
+// The binary jsonb is its text prefixed with the format version byte
+inline void encode_jsonb(const char* data, std::size_t size, std::string& out) {
+    if (size == 0 || *data != 1) {
+        throw system_error(error::bad_result_process, "unsupported jsonb format version");
+    }
+    out.append(data + 1, size - 1);
+}
+
+// Binary data and values of unknown types are written as `bytea` hex strings, e.g. `"\\x01ff"`
+inline void encode_bytes(const char* data, std::size_t size, std::string& out) {
+    constexpr const char digits[] = "0123456789abcdef";
+    const auto pos = out.size();
+    out.resize(pos + 5 + 2 * size);
+    char* p = out.data() + pos;
+    std::memcpy(p, "\"\\\\x", 4);
+    p += 4;
+    for (std::size_t i = 0; i < size; ++i) {
+        *p++ = digits[(static_cast<unsigned char>(data[i]) >> 4) & 0xF];
+        *p++ = digits[static_cast<unsigned char>(data[i]) & 0xF];
+    }
+    *p = '"';
+}
+
+inline void encode_text_bool(const char* data, std::size_t, std::string& out) {
+    out.append(*data == 't' ? "true" : "false");
+}
+
+// A text number is valid JSON but `NaN` and infinities
+inline void encode_text_number(const char* data, std::size_t size, std::string& out) {
+    const auto c = size ? data[size - 1] : 'N';
+    if (c >= '0' && c <= '9') {
+        out.append(data, size);
+    } else {
+        write_string(data, size, out);
+    }
+}
+
+struct column_encoder {
+    encoder encode;
+    std::size_t width; //!< size of the fixed width type value, zero for variable length types
+    std::string key; //!< escaped column name with a colon for the object rows
+};
+
+/**
+ * Encoder of a column by its oid and format, the values of an unknown type in the binary
+ * format are written as the hex strings of their PostgreSQL binary representation.
+ */
+inline column_encoder get_column_encoder(oid_t oid, bool binary) noexcept {
+    if (!binary) {
+        switch (oid) {
+            case 16: return {encode_text_bool, 0, {}};
+            case 20:
+            case 21:
+            case 23:
+            case 26:
+            case 700:
+            case 701:
+            case 1700: return {encode_text_number, 0, {}};
+            case 114:
+            case 3802: return {encode_json, 0, {}};
+            default: break;
+        }
+        return {encode_string, 0, {}};
+    }
+    switch (oid) {
+        case 16: return {encode_bool, 1, {}};
+        case 21: return {encode_integer<std::int16_t>, 2, {}};
+        case 23: return {encode_integer<std::int32_t>, 4, {}};
+        case 20: return {encode_integer<std::int64_t>, 8, {}};
+        case 26: return {encode_integer<std::uint32_t>, 4, {}};
+        case 700: return {encode_float<float, std::uint32_t>, 4, {}};
+        case 701: return {encode_float<double, std::uint64_t>, 8, {}};
+        case 1700: return {encode_numeric, 0, {}};
+        case 1082: return {encode_date, 4, {}};
+        case 1114: return {encode_timestamp<false>, 8, {}};
+        case 1184: return {encode_timestamp<true>, 8, {}};
+        case 2950: return {encode_uuid, 16, {}};
+        case 114: return {encode_json, 0, {}};
+        case 3802: return {encode_jsonb, 0, {}};
+        case 18:
+        case 19:
+        case 25:
+        case 1042:
+        case 1043: return {encode_string, 0, {}};
+        default: break;
+    }
+    return {encode_bytes, 0, {}};
+}
+
+} // namespace detail
+
+/**
+ * @brief Writer of results into a JSON array of rows
+ *
+ * Rows of one or several results, e.g. the chunks of `ozo::stream_request()`, are appended
+ * into the output string as elements of a single JSON array. The encoders of the columns
+ * are chosen once per result by the columns oids and formats, so there are no per value
+ * type dispatch and no intermediate C++ objects:
+ *
+ * | PostgreSQL | JSON |
+ * |---|---|
+ * | `bool` | `true` or `false` |
+ * | `int2`, `int4`, `int8`, `oid`, `float4`, `float8`, `numeric` | number, `"NaN"`, `"Infinity"` or `"-Infinity"` |
+ * | `date`, `timestamp`, `timestamptz` | ISO 8601 string, e.g. `"2024-01-02T03:04:05.5+00:00"` for `timestamptz` in UTC |
+ * | `uuid` | string |
+ * | `text`, `varchar`, `bpchar`, `name`, `char` | string |
+ * | `json`, `jsonb` | the JSON value itself |
+ * | other types | `bytea` hex string of the PostgreSQL binary representation, or the text of a value in the text format |
+ *
+ * The text is expected to be valid UTF-8, i.e. the client encoding should be `UTF8`. Strings are
+ * escaped eight bytes at a time, the bytes which need no escaping are copied at once. The writer does
+ * not own the output, so the written text may be sent and cleared between the results to stream it.
+ *
+ * ###Example
+ *
+ * @code
+std::string body;
+ozo::json::writer json(body);
+ozo::stream_request(conn_info[io], "SELECT id, name FROM users"_SQL, 1000,
+    [&] (auto&& chunk) { json.write(chunk); send_chunk(body); body.clear(); }, yield);
+json.finish();
+send_chunk(body);
+ * @endcode
+ * @ingroup group-json
+ */
+class writer {
+public:
+    /**
+     * @param out --- string to append the JSON text to.
+     * @param format --- representation of a row.
+     */
+    explicit writer(std::string& out, row_format format = row_format::object)
+    : out_(out), format_(format) {}
+
+    /**
+     * Append the rows of the result. The opening bracket of the array is written before the first rows.
+     *
+     * @param res --- result to write.
+     * @throws ozo::system_error with `ozo::error::bad_object_size` if a fixed width value has unexpected size,
+     *         with `ozo::error::bad_result_process` if a `jsonb` value has unsupported format version.
+     */
+    template <typename T>
+    void write(const basic_result<T>& res) {
+        if (!started_) {
+            out_.push_back('[');
+            started_ = true;
+        }
+        const auto columns = impl::nfields(*res.native_handle());
+        encoders_.clear();
+        for (int column = 0; column < columns; ++column) {
+            auto encoder = detail::get_column_encoder(impl::field_type(*res.native_handle(), column),
+                impl::field_format(*res.native_handle(), column) == impl::result_format::binary);
+            if (format_ == row_format::object) {
+                const char* name = impl::field_name(*res.native_handle(), column);
+                detail::write_string(name, name ? std::strlen(name) : 0, encoder.key);
+                encoder.key.push_back(':');
+            }
+            encoders_.push_back(std::move(encoder));
+        }
+        const auto rows = static_cast<int>(res.size());
+        for (int row = 0; row < rows; ++row) {
+            if (rows_++) {
+                out_.push_back(',');
+            }
+            out_.push_back(format_ == row_format::object ? '{' : '[');
+            for (int column = 0; column < columns; ++column) {
+                const auto& encoder = encoders_[static_cast<std::size_t>(column)];
+                if (column) {
+                    out_.push_back(',');
+                }
+                out_.append(encoder.key);
+                const auto v = res[row][column];
+                if (v.is_null()) {
+                    out_.append("null");
+                    continue;
+                }
+                const auto size = static_cast<std::size_t>(v.size());
+                if (encoder.width && size != encoder.width) {
+                    throw system_error(error::bad_object_size, "data size " + std::to_string(size)
+                        + " of column " + std::to_string(column) + " does not match type size "
+                        + std::to_string(encoder.width));
+                }
+                encoder.encode(v.data(), size, out_);
+            }
+            out_.push_back(format_ == row_format::object ? '}' : ']');
+        }
+    }
+
+    /**
+     * Write the closing bracket of the array, the empty array if no results were written.
+     */
+    void finish() {
+        if (!started_) {
+            out_.push_back('[');
+            started_ = true;
+        }
+        out_.push_back(']');
+    }
+
+    /**
+     * Number of rows written so far.
+     */
+    std::size_t rows() const noexcept { return rows_;}
+
+private:
+    std::string& out_;
+    row_format format_;
+    std::vector<detail::column_encoder> encoders_;
+    std::size_t rows_ = 0;
+    bool started_ = false;
+};
+
+/**
+ * @brief Write a result as a JSON array of rows
+ *
+ * A shortcut to `ozo::json::writer` for a single result.
+ *
+ * @param res --- result to write.
+ * @param out --- string to append the JSON text to.
+ * @param format --- representation of a row.
+ * @ingroup group-json
+ *
+ * ###Example
+ *
+ * @code
+ozo::result res;
+ozo::request(conn_info[io], "SELECT id, name FROM users"_SQL, ozo::into(res), yield);
+std::string body;
+ozo::json::write_result(res, body);
+ * @endcode
+ */
+template <typename T>
+inline void write_result(const basic_result<T>& res, std::string& out, row_format format = row_format::object) {
+    writer w(out, format);
+    w.write(res);
+    w.finish();
+}
+
+} // namespace ozo::json
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <ozo/impl/async_large_object.h>
+
+namespace ozo {
+
+#ifdef OZO_DOCUMENTATION
+/**
+ * @brief Streams the content of a large object by chunks
+ *
+ * The function reads the large object with `lo_get` server function by chunks of the given
+ * size from the beginning to the end and passes each chunk to the callback, so an object of
+ * any size is read without being materialised in memory.
+ *
+ * The next chunk is prefetched: `lo_get` of the next chunk is sent before the callback is
+ * called with the current one, so at most two chunks are kept in memory. A chunk shorter than
+ * the chunk size is the last one. The callback is called via the connection executor and should
+ * not use the connection, the chunk is valid within the call only.
+ *
+ * The time constraint is applied to each of the `lo_get` calls. The object should not be modified
+ * while it is being read, so the reading is recommended within a transaction made by `ozo::begin()`.
+ *
+ * @note The function does not participate in ADL since could be implemented via functional object.
+ *
+ * @param connection --- #Connection or transaction to read the object with.
+ * @param object --- oid of the large object.
+ * @param chunk_size --- number of bytes to read at once.
+ * @param time_constraint --- #TimeConstraint of each of the `lo_get` calls.
+ * @param on_chunk --- callable with `void(std::string_view)` signature.
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ *
+ * ###Example
+ *
+ * @code
+std::ofstream file("dump.bin", std::ios::binary);
+auto transaction = ozo::begin(pool[io], 1s, yield);
+transaction = ozo::read_large_object(std::move(transaction), object, 1 << 20, 1s,
+    [&] (std::string_view chunk) { file.write(chunk.data(), chunk.size()); },
+    yield);
+auto conn = ozo::commit(std::move(transaction), 1s, yield);
+ * @endcode
+ */
+template <typename Connection, typename TimeConstraint, typename OnChunk, typename CompletionToken>
+decltype(auto) read_large_object(Connection&& connection, pg::oid object, std::size_t chunk_size,
+        TimeConstraint time_constraint, OnChunk on_chunk, CompletionToken&& token);
+
+/**
+ * @brief Streams the content of a large object by chunks
+ *
+ * This function is time constrain free shortcut to `ozo::read_large_object()` function.
+ *
+ * @note The function does not participate in ADL since could be implemented via functional object.
+ *
+ * @param connection --- #Connection or transaction to read the object with.
+ * @param object --- oid of the large object.
+ * @param chunk_size --- number of bytes to read at once.
+ * @param on_chunk --- callable with `void(std::string_view)` signature.
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ */
+template <typename Connection, typename OnChunk, typename CompletionToken>
+decltype(auto) read_large_object(Connection&& connection, pg::oid object, std::size_t chunk_size,
+        OnChunk on_chunk, CompletionToken&& token);
+
+/**
+ * @brief Streams content into a large object by chunks
+ *
+ * The function writes the content produced by the callback into the large object with
+ * `lo_put` server function from the beginning. The callback fills the buffer it is given
+ * with up to the chunk size bytes and returns the number of bytes written, zero ends
+ * the content. The object should exist, e.g. be created with `SELECT lo_create(0)`.
+ *
+ * Only two buffers of the chunk size are allocated: the callback fills one of them while
+ * `lo_put` of the other one is in flight. The callback is called via the connection executor
+ * and should not use the connection.
+ *
+ * The time constraint is applied to each of the `lo_put` calls. If a call fails the operation
+ * completes with its error and the chunks written before are kept, so the writing is recommended
+ * within a transaction made by `ozo::begin()`.
+ *
+ * @note The function does not participate in ADL since could be implemented via functional object.
+ *
+ * @param connection --- #Connection or transaction to write the object with.
+ * @param object --- oid of the large object.
+ * @param chunk_size --- size of the buffers and maximum number of bytes to write at once.
+ * @param time_constraint --- #TimeConstraint of each of the `lo_put` calls.
+ * @param on_chunk --- callable with `std::size_t(char* buffer, std::size_t size)` signature.
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ *
+ * ###Example
+ *
+ * @code
+std::ifstream file("dump.bin", std::ios::binary);
+auto transaction = ozo::begin(pool[io], 1s, yield);
+transaction = ozo::write_large_object(std::move(transaction), object, 1 << 20, 1s,
+    [&] (char* buffer, std::size_t size) {
+        file.read(buffer, size);
+        return static_cast<std::size_t>(file.gcount());
+    },
+    yield);
+auto conn = ozo::commit(std::move(transaction), 1s, yield);
+ * @endcode
+ */
+template <typename Connection, typename TimeConstraint, typename OnChunk, typename CompletionToken>
+decltype(auto) write_large_object(Connection&& connection, pg::oid object, std::size_t chunk_size,
+        TimeConstraint time_constraint, OnChunk on_chunk, CompletionToken&& token);
+
+/**
+ * @brief Streams content into a large object by chunks
+ *
+ * This function is time constrain free shortcut to `ozo::write_large_object()` function.
+ *
+ * @note The function does not participate in ADL since could be implemented via functional object.
+ *
+ * @param connection --- #Connection or transaction to write the object with.
+ * @param object --- oid of the large object.
+ * @param chunk_size --- size of the buffers and maximum number of bytes to write at once.
+ * @param on_chunk --- callable with `std::size_t(char* buffer, std::size_t size)` signature.
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ */
+template <typename Connection, typename OnChunk, typename CompletionToken>
+decltype(auto) write_large_object(Connection&& connection, pg::oid object, std::size_t chunk_size,
+        OnChunk on_chunk, CompletionToken&& token);
+#else
+
+template <typename Initiator>
+struct read_large_object_op : base_async_operation <read_large_object_op<Initiator>, Initiator> {
+    using base = typename read_large_object_op::base;
+    using base::base;
+
+    template <typename T, typename TimeConstraint, typename OnChunk, typename CompletionToken>
+    decltype(auto) operator() (T&& connection, pg::oid object, std::size_t chunk_size, TimeConstraint t,
+            OnChunk on_chunk, CompletionToken&& token) const {
+        static_assert(Connection<T>, "connection should model Connection concept");
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        return async_initiate<CompletionToken, handler_signature<T>>(
+            get_operation_initiator(*this), token, std::forward<T>(connection), t, object, chunk_size,
+            std::move(on_chunk));
+    }
+
+    template <typename T, typename OnChunk, typename CompletionToken>
+    decltype(auto) operator() (T&& connection, pg::oid object, std::size_t chunk_size, OnChunk on_chunk,
+            CompletionToken&& token) const {
+        return (*this)(std::forward<T>(connection), object, chunk_size, none, std::move(on_chunk),
+            std::forward<CompletionToken>(token));
+    }
+
+    template <typename OtherInitiator>
+    constexpr static auto rebind_initiator(const OtherInitiator& other) {
+        return read_large_object_op<OtherInitiator>{other};
+    }
+};
+
+template <typename Initiator>
+struct write_large_object_op : base_async_operation <write_large_object_op<Initiator>, Initiator> {
+    using base = typename write_large_object_op::base;
+    using base::base;
+
+    template <typename T, typename TimeConstraint, typename OnChunk, typename CompletionToken>
+    decltype(auto) operator() (T&& connection, pg::oid object, std::size_t chunk_size, TimeConstraint t,
+            OnChunk on_chunk, CompletionToken&& token) const {
+        static_assert(Connection<T>, "connection should model Connection concept");
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        return async_initiate<CompletionToken, handler_signature<T>>(
+            get_operation_initiator(*this), token, std::forward<T>(connection), t, object, chunk_size,
+            std::move(on_chunk));
+    }
+
+    template <typename T, typename OnChunk, typename CompletionToken>
+    decltype(auto) operator() (T&& connection, pg::oid object, std::size_t chunk_size, OnChunk on_chunk,
+            CompletionToken&& token) const {
+        return (*this)(std::forward<T>(connection), object, chunk_size, none, std::move(on_chunk),
+            std::forward<CompletionToken>(token));
+    }
+
+    template <typename OtherInitiator>
+    constexpr static auto rebind_initiator(const OtherInitiator& other) {
+        return write_large_object_op<OtherInitiator>{other};
+    }
+};
+
+namespace detail {
+struct initiate_async_read_large_object {
+    template <typename Handler, typename T, typename TimeConstraint, typename OnChunk>
+    constexpr void operator()(Handler&& h, T&& connection, TimeConstraint t, pg::oid object, std::size_t chunk_size,
+            OnChunk on_chunk) const {
+        impl::async_read_large_object(std::forward<T>(connection), object, chunk_size, t, std::move(on_chunk),
+            std::forward<Handler>(h));
+    }
+};
+
+struct initiate_async_write_large_object {
+    template <typename Handler, typename T, typename TimeConstraint, typename OnChunk>
+    constexpr void operator()(Handler&& h, T&& connection, TimeConstraint t, pg::oid object, std::size_t chunk_size,
+            OnChunk on_chunk) const {
+        impl::async_write_large_object(std::forward<T>(connection), object, chunk_size, t, std::move(on_chunk),
+            std::forward<Handler>(h));
+    }
+};
+} // namespace detail
+
+constexpr read_large_object_op<detail::initiate_async_read_large_object> read_large_object;
+constexpr write_large_object_op<detail::initiate_async_write_large_object> write_large_object;
+
+#endif
+
+} // namespace ozo
@@ -0,0 +1,548 @@
+#pragma once
+
+#include <ozo/asio.h>
+#include <ozo/error.h>
+#include <ozo/detail/block_cache.h>
+#include <ozo/detail/futex.h>
+
+#include <boost/asio/async_result.hpp>
+#include <boost/system/system_error.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+/**
+ * @defgroup group-light-future Light future
+ * @ingroup group-core
+ * @brief Completion token which returns a future without the `std::promise` machinery.
+ *
+ * `boost::asio::use_future` completes an operation via `std::promise`, so each request costs
+ * a shared state allocation, a mutex and a condition variable. The `ozo::use_light_future`
+ * token returns `ozo::light_future` instead. Its state lives in a single block taken from
+ * a thread-local cache of the blocks, the completion sets an atomic flag and a waiting thread
+ * sleeps on a futex of the flag. The `ozo::light_future::then()` chains a continuation which
+ * is called on completion without blocking a thread.
+ *
+ *@code
+#include <ozo/light_future.h>
+ *@endcode
+ */
+
+namespace ozo {
+
+/**
+ * @brief Completion token type of `ozo::light_future`
+ * @ingroup group-light-future
+ */
+struct use_light_future_t {};
+
+/**
+ * @brief Completion token which makes an operation return `ozo::light_future`
+ *
+ * The token is for operations with `void(ozo::error_code, Args...)` signature. The value
+ * type of the future is `void` for no `Args`, the decayed type of the single argument, or
+ * `std::tuple` of the decayed arguments types.
+ *
+ * ###Example
+ *
+ * @code
+ozo::rows_of<std::int64_t> rows;
+auto conn = ozo::request(conn_info[io], "SELECT 1"_SQL, 1s, ozo::into(rows), ozo::use_light_future).get();
+ * @endcode
+ * @ingroup group-light-future
+ */
+constexpr use_light_future_t use_light_future;
+
+template <typename T>
+class light_future;
+
+namespace detail {
+
+template <typename T>
+class light_future_state;
+
+template <typename T>
+struct light_future_continuation {
+    // Runs the continuation with the ready source state and frees the continuation
+    virtual void run(light_future_state<T>* source) noexcept = 0;
+
+protected:
+    ~light_future_continuation() = default;
+};
+
+/**
+* Shared state of `ozo::light_future` and of the completion handler. The status word
+* holds the ready flag and tells the completion whether the future owner is sleeping
+* on the futex of the word or has set a continuation. The state is reference counted
+* and is freed into `block_cache` by the last owner.
+*/
+template <typename T>
+class light_future_state {
+public:
+    using value_type = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+    static light_future_state* create() {
+        return new (allocate()) light_future_state;
+    }
+
+    void add_ref() noexcept { refs_.fetch_add(1, std::memory_order_relaxed);}
+
+    void release() noexcept {
+        if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            this->~light_future_state();
+            deallocate(this);
+        }
+    }
+
+    template <typename ...Args>
+    void set_value(error_code ec, Args&& ...args) noexcept {
+        ec_ = std::move(ec);
+        try {
+            value_.emplace(std::forward<Args>(args)...);
+        } catch (...) {
+            exception_ = std::current_exception();
+        }
+        publish();
+    }
+
+    void set_error(error_code ec) noexcept {
+        ec_ = std::move(ec);
+        publish();
+    }
+
+    void set_exception(std::exception_ptr e) noexcept {
+        exception_ = std::move(e);
+        publish();
+    }
+
+    void set_from(light_future_state& other) noexcept {
+        ec_ = std::move(other.ec_);
+        value_ = std::move(other.value_);
+        exception_ = std::move(other.exception_);
+        publish();
+    }
+
+    bool ready() const noexcept {
+        return status_.load(std::memory_order_acquire) & ready_flag;
+    }
+
+    void wait() noexcept {
+        while (!wait_once(std::chrono::nanoseconds::max())) {}
+    }
+
+    bool wait_for(std::chrono::nanoseconds timeout) noexcept {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        for (;;) {
+            if (wait_once(timeout)) {
+                return true;
+            }
+            timeout = deadline - std::chrono::steady_clock::now();
+            if (timeout <= timeout.zero()) {
+                return ready();
+            }
+        }
+    }
+
+    // The continuation runs here if the state is ready already, otherwise on completion
+    void set_continuation(light_future_continuation<T>* continuation) noexcept {
+        continuation_ = continuation;
+        std::uint32_t expected = 0;
+        if (!status_.compare_exchange_strong(expected, continuation_flag, std::memory_order_acq_rel)) {
+            continuation->run(this);
+        }
+    }
+
+    error_code& error() noexcept { return ec_;}
+    std::optional<value_type>& value() noexcept { return value_;}
+    std::exception_ptr& exception() noexcept { return exception_;}
+
+private:
+    static constexpr std::uint32_t ready_flag = 1;
+    static constexpr std::uint32_t waiting_flag = 2;
+    static constexpr std::uint32_t continuation_flag = 4;
+    static constexpr int spin_count = 64;
+
+    // The class is complete in the member function bodies only
+    static void* allocate() { return block_cache<sizeof(light_future_state), alignof(light_future_state)>::allocate();}
+    static void deallocate(void* p) noexcept { block_cache<sizeof(light_future_state), alignof(light_future_state)>::deallocate(p);}
+
+    light_future_state() = default;
+
+    void publish() noexcept {
+        const auto status = status_.exchange(ready_flag, std::memory_order_acq_rel);
+        if (status & waiting_flag) {
+            futex_wake_all(status_);
+        }
+        if (status & continuation_flag) {
+            continuation_->run(this);
+        }
+    }
+
+    // Spins for a while since the request may be completing right now, then sleeps
+    bool wait_once(std::chrono::nanoseconds timeout) noexcept {
+        for (int i = 0; i < spin_count; ++i) {
+            if (ready()) {
+                return true;
+            }
+        }
+        auto status = status_.load(std::memory_order_acquire);
+        if (status & ready_flag) {
+            return true;
+        }
+        if (!(status & waiting_flag)
+                && !status_.compare_exchange_strong(status, status | waiting_flag, std::memory_order_acq_rel)) {
+            return status & ready_flag;
+        }
+        futex_wait(status_, status | waiting_flag, timeout);
+        return ready();
+    }
+
+    std::atomic<std::uint32_t> status_ {0};
+    std::atomic<std::uint32_t> refs_ {1};
+    error_code ec_;
+    std::optional<value_type> value_;
+    std::exception_ptr exception_;
+    light_future_continuation<T>* continuation_ = nullptr;
+};
+
+struct light_future_access {
+    template <typename T>
+    static light_future<T> make(light_future_state<T>* state) noexcept { return light_future<T>(state);}
+
+    template <typename T>
+    static light_future_state<T>* release(light_future<T>& future) noexcept {
+        return std::exchange(future.state_, nullptr);
+    }
+};
+
+template <typename T, typename F>
+class light_future_continuation_impl final : public light_future_continuation<T> {
+public:
+    static light_future_continuation_impl* create(F f) {
+        void* p = allocate();
+        try {
+            return new (p) light_future_continuation_impl(std::move(f));
+        } catch (...) {
+            deallocate(p);
+            throw;
+        }
+    }
+
+    void run(light_future_state<T>* source) noexcept override {
+        auto f = std::move(f_);
+        this->~light_future_continuation_impl();
+        deallocate(this);
+        f(light_future_access::make(source));
+    }
+
+private:
+    explicit light_future_continuation_impl(F f) : f_(std::move(f)) {}
+
+    static void* allocate() {
+        return block_cache<sizeof(light_future_continuation_impl), alignof(light_future_continuation_impl)>::allocate();
+    }
+
+    static void deallocate(void* p) noexcept {
+        block_cache<sizeof(light_future_continuation_impl), alignof(light_future_continuation_impl)>::deallocate(p);
+    }
+
+    F f_;
+};
+
+template <typename T, typename F>
+void set_light_future_continuation(light_future<T>& future, F f) {
+    auto continuation = light_future_continuation_impl<T, F>::create(std::move(f));
+    light_future_access::release(future)->set_continuation(continuation);
+}
+
+template <typename T>
+struct is_light_future : std::false_type {};
+
+template <typename T>
+struct is_light_future<light_future<T>> : std::true_type {};
+
+template <typename T>
+struct light_future_result { using type = T; };
+
+template <typename T>
+struct light_future_result<light_future<T>> { using type = T; };
+
+template <typename T>
+using light_future_result_t = typename light_future_result<T>::type;
+
+/**
+* Calls the continuation with the ready future and completes the target state with the
+* result. A future returned by the continuation is unwrapped, so the target completes with
+* the result of the future, e.g. of the next request.
+*/
+template <typename U, typename F, typename T>
+void complete_light_future(light_future_state<U>* target, F& f, light_future<T>&& ready) noexcept {
+    using result_type = std::invoke_result_t<F&, light_future<T>>;
+    try {
+        if constexpr (is_light_future<result_type>::value) {
+            auto next = std::invoke(f, std::move(ready));
+            if (!next.valid()) {
+                throw std::future_error(std::future_errc::no_state);
+            }
+            return set_light_future_continuation(next, [target] (light_future<U> result) {
+                const auto source = light_future_access::release(result);
+                target->set_from(*source);
+                source->release();
+                target->release();
+            });
+        } else if constexpr (std::is_void_v<result_type>) {
+            std::invoke(f, std::move(ready));
+            target->set_value(error_code {});
+        } else {
+            target->set_value(error_code {}, std::invoke(f, std::move(ready)));
+        }
+    } catch (...) {
+        target->set_exception(std::current_exception());
+    }
+    target->release();
+}
+
+template <typename ...Args>
+struct light_future_value { using type = std::tuple<std::decay_t<Args>...>; };
+
+template <>
+struct light_future_value<> { using type = void; };
+
+template <typename Arg>
+struct light_future_value<Arg> { using type = std::decay_t<Arg>; };
+
+template <typename ...Args>
+using light_future_value_t = typename light_future_value<Args...>::type;
+
+/**
+* Completion handler of `ozo::use_light_future`. A handler destroyed without being called,
+* e.g. with the `io_context`, completes the future with `operation_aborted`.
+*/
+template <typename T>
+class light_future_handler {
+public:
+    explicit light_future_handler(use_light_future_t) : state_(light_future_state<T>::create()) {}
+
+    light_future_handler(light_future_handler&& other) noexcept
+    : state_(std::exchange(other.state_, nullptr)) {}
+
+    light_future_handler& operator =(light_future_handler&& other) noexcept {
+        std::swap(state_, other.state_);
+        return *this;
+    }
+
+    ~light_future_handler() {
+        if (state_) {
+            state_->set_error(asio::error::operation_aborted);
+            state_->release();
+        }
+    }
+
+    template <typename ...Args>
+    void operator() (error_code ec, Args&& ...args) {
+        auto state = std::exchange(state_, nullptr);
+        state->set_value(std::move(ec), std::forward<Args>(args)...);
+        state->release();
+    }
+
+    light_future<T> get_future() noexcept {
+        state_->add_ref();
+        return light_future_access::make(state_);
+    }
+
+private:
+    light_future_state<T>* state_;
+};
+
+} // namespace detail
+
+/**
+ * @brief Future of an operation initiated with `ozo::use_light_future`
+ *
+ * The future is move-only and is for a single consumer: either the value is got via
+ * `get()` which waits for the completion, or a continuation is chained via `then()`.
+ * The future becomes invalid after that.
+ *
+ * @tparam T --- value type, may be `void`.
+ * @ingroup group-light-future
+ */
+template <typename T>
+class light_future {
+public:
+    using value_type = T;
+
+    /**
+     * Construct an invalid future.
+     */
+    light_future() noexcept = default;
+
+    light_future(light_future&& other) noexcept : state_(std::exchange(other.state_, nullptr)) {}
+
+    light_future& operator =(light_future&& other) noexcept {
+        std::swap(state_, other.state_);
+        return *this;
+    }
+
+    ~light_future() {
+        if (state_) {
+            state_->release();
+        }
+    }
+
+    /**
+     * @return `true` if the future has a state, i.e. neither `get()` nor `then()` has been called.
+     */
+    bool valid() const noexcept { return state_ != nullptr;}
+
+    /**
+     * @return `true` if the operation has completed, so `get()` does not block.
+     */
+    bool is_ready() const noexcept { return state_->ready();}
+
+    /**
+     * Blocks until the operation completes.
+     */
+    void wait() const noexcept { state_->wait();}
+
+    /**
+     * Blocks until the operation completes or the timeout expires.
+     *
+     * @param timeout --- maximum time to wait.
+     * @return `true` if the operation has completed.
+     */
+    template <typename Rep, typename Period>
+    bool wait_for(const std::chrono::duration<Rep, Period>& timeout) const noexcept {
+        return state_->wait_for(std::chrono::duration_cast<std::chrono::nanoseconds>(timeout));
+    }
+
+    /**
+     * Waits for the operation and returns its value.
+     *
+     * @return value of the operation.
+     * @throws boost::system::system_error if the operation has completed with an error,
+     *         or the exception thrown by the continuation of `then()`.
+     */
+    T get() {
+        auto state = take();
+        if (state->exception()) {
+            std::rethrow_exception(state->exception());
+        }
+        if (state->error()) {
+            throw boost::system::system_error(state->error());
+        }
+        if constexpr (!std::is_void_v<T>) {
+            return std::move(*state->value());
+        }
+    }
+
+    /**
+     * Waits for the operation and returns its value with the error code, so the value
+     * which an operation passes with an error, e.g. a connection with the error message,
+     * is not lost.
+     *
+     * @param ec --- error code of the operation.
+     * @return value of the operation, default-constructed if there is none.
+     * @throws the exception thrown by the continuation of `then()`.
+     */
+    T get(error_code& ec) {
+        auto state = take();
+        if (state->exception()) {
+            std::rethrow_exception(state->exception());
+        }
+        ec = state->error();
+        if constexpr (!std::is_void_v<T>) {
+            return state->value() ? std::move(*state->value()) : T{};
+        }
+    }
+
+    /**
+     * @brief Chains a continuation
+     *
+     * The continuation is called with the ready future once the operation completes,
+     * on the thread which completes it, e.g. an `io_context` thread, or right in this
+     * call if the operation has completed already. So no thread is blocked. If the
+     * continuation returns `ozo::light_future` the result is unwrapped, so the requests
+     * may be chained.
+     *
+     * @param f --- continuation with `R(ozo::light_future<T>)` signature.
+     * @return `ozo::light_future` of the continuation result.
+     *
+     * ###Example
+     *
+     * @code
+ozo::request(conn_info[io], "SELECT 1"_SQL, 1s, ozo::into(rows), ozo::use_light_future)
+    .then([&] (auto future) {
+        return ozo::execute(future.get(), "UPDATE counters SET value = value + 1"_SQL, 1s, ozo::use_light_future);
+    })
+    .then([] (auto future) { future.get(); });
+     * @endcode
+     */
+    template <typename F>
+    auto then(F&& f) {
+        using result_type = std::invoke_result_t<std::decay_t<F>&, light_future>;
+        using next_type = detail::light_future_result_t<result_type>;
+        auto target = detail::light_future_state<next_type>::create();
+        target->add_ref();
+        auto next = detail::light_future_access::make(target);
+        try {
+            detail::set_light_future_continuation(*this,
+                [target, f = std::forward<F>(f)] (light_future ready) mutable {
+                    detail::complete_light_future(target, f, std::move(ready));
+                });
+        } catch (...) {
+            target->release();
+            throw;
+        }
+        return next;
+    }
+
+private:
+    friend struct detail::light_future_access;
+
+    explicit light_future(detail::light_future_state<T>* state) noexcept : state_(state) {}
+
+    struct state_deleter {
+        void operator() (detail::light_future_state<T>* state) const noexcept { state->release();}
+    };
+
+    std::unique_ptr<detail::light_future_state<T>, state_deleter> take() {
+        if (!state_) {
+            throw std::future_error(std::future_errc::no_state);
+        }
+        state_->wait();
+        return std::unique_ptr<detail::light_future_state<T>, state_deleter>(std::exchange(state_, nullptr));
+    }
+
+    detail::light_future_state<T>* state_ = nullptr;
+};
+
+} // namespace ozo
+
+namespace boost::asio {
+
+template <typename ...Args>
+class async_result<ozo::use_light_future_t, void(ozo::error_code, Args...)> {
+public:
+    using value_type = ozo::detail::light_future_value_t<Args...>;
+    using completion_handler_type = ozo::detail::light_future_handler<value_type>;
+    using return_type = ozo::light_future<value_type>;
+
+    explicit async_result(completion_handler_type& h) : future_(h.get_future()) {}
+
+    return_type get() { return std::move(future_);}
+
+private:
+    return_type future_;
+};
+
+} // namespace boost::asio
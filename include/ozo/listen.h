@@ -0,0 +1,110 @@
+#pragma once
+
+#include <ozo/impl/async_listen.h>
+
+namespace ozo {
+
+#ifdef OZO_DOCUMENTATION
+/**
+ * @brief Listens for asynchronous notifications
+ *
+ * Executes `LISTEN` for each of the channels and then waits for notifications sent to
+ * them with `NOTIFY`. Each time new data is received from the database all the received
+ * notifications are passed to the notification handler as a batch. The notifications
+ * which have been received by the connection before, e.g. while it was used for other
+ * requests, are delivered as the first batch.
+ *
+ * The notification handler is called with `std::vector<ozo::notification>` argument. If it
+ * returns a value convertible to `bool`, the operation completes successfully as soon as
+ * the handler returns `false`. Otherwise the operation lasts until the time constraint
+ * expires, the connection is closed or an error occurs, so a dedicated connection should
+ * be used for listening.
+ *
+ * Channel names are quoted, so they are case sensitive. With an empty channels range the
+ * operation only waits for notifications of the channels the connection listens already.
+ *
+ * @param provider --- connection provider object
+ * @param channels --- range of channel names convertible to `std::string_view`.
+ * @param time_constraint --- operation #TimeConstraint; this time constrain <b>includes</b> time for getting connection from provider.
+ * @param notification_handler --- callable with `void(std::vector<ozo::notification>)` or `bool(std::vector<ozo::notification>)` signature.
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ *
+ * ###Example
+ *
+ * @code
+const std::vector<std::string> channels {"cache_invalidation"};
+ozo::listen(conn_info[io], channels,
+    [&] (std::vector<ozo::notification> batch) {
+        for (const auto& v : batch) {
+            cache.invalidate(v.payload);
+        }
+    },
+    yield);
+ * @endcode
+ */
+template <typename ConnectionProvider, typename Channels, typename TimeConstraint, typename NotificationHandler, typename CompletionToken>
+decltype(auto) listen(ConnectionProvider&& provider, const Channels& channels, TimeConstraint time_constraint, NotificationHandler&& notification_handler, CompletionToken&& token);
+
+/**
+ * @brief Listens for asynchronous notifications
+ *
+ * This function is time constrain free shortcut to `ozo::listen()` function.
+ * Its call is equal to `ozo::listen(provider, channels, ozo::none, notification_handler, token)` call.
+ *
+ * @param provider --- connection provider object
+ * @param channels --- range of channel names convertible to `std::string_view`.
+ * @param notification_handler --- callable with `void(std::vector<ozo::notification>)` or `bool(std::vector<ozo::notification>)` signature.
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ */
+template <typename ConnectionProvider, typename Channels, typename NotificationHandler, typename CompletionToken>
+decltype(auto) listen(ConnectionProvider&& provider, const Channels& channels, NotificationHandler&& notification_handler, CompletionToken&& token);
+#else
+
+template <typename Initiator>
+struct listen_op : base_async_operation <listen_op<Initiator>, Initiator> {
+    using base = typename listen_op::base;
+    using base::base;
+
+    template <typename P, typename Channels, typename TimeConstraint, typename NotificationHandler, typename CompletionToken>
+    decltype(auto) operator() (P&& provider, const Channels& channels, TimeConstraint t,
+            NotificationHandler&& notification_handler, CompletionToken&& token) const {
+        static_assert(ConnectionProvider<P>, "provider should be a ConnectionProvider");
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        return async_initiate<CompletionToken, handler_signature<P>>(
+            get_operation_initiator(*this), token, std::forward<P>(provider), t,
+            impl::make_listen_query(channels), std::forward<NotificationHandler>(notification_handler));
+    }
+
+    template <typename P, typename Channels, typename NotificationHandler, typename CompletionToken>
+    decltype(auto) operator()(P&& provider, const Channels& channels, NotificationHandler&& notification_handler,
+            CompletionToken&& token) const {
+        return (*this)(std::forward<P>(provider), channels, none,
+            std::forward<NotificationHandler>(notification_handler), std::forward<CompletionToken>(token));
+    }
+
+    template <typename OtherInitiator>
+    constexpr static auto rebind_initiator(const OtherInitiator& other) {
+        return listen_op<OtherInitiator>{other};
+    }
+};
+
+namespace detail {
+struct initiate_async_listen {
+    template <typename Handler, typename P, typename TimeConstraint, typename NotificationHandler>
+    constexpr void operator()(Handler&& h, P&& p, TimeConstraint t, std::string query,
+            NotificationHandler&& notification_handler) const {
+        impl::async_listen(std::forward<P>(p), std::move(query), t,
+            std::forward<NotificationHandler>(notification_handler), std::forward<Handler>(h));
+    }
+};
+} // namespace detail
+
+constexpr listen_op<detail::initiate_async_listen> listen;
+
+#endif
+
+} // namespace ozo
@@ -0,0 +1,258 @@
+#pragma once
+
+#include <ozo/io/array.h>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+namespace ozo {
+
+/**
+ * @brief Multi-dimensional array with contiguous storage
+ *
+ * Representation of a PostgreSQL array of any number of dimensions as a single contiguous block
+ * of the elements in the row-major order plus the extents of the dimensions, like `std::mdspan`
+ * layout_right. A matrix is received with a single allocation instead of a vector per row
+ * and may be passed to numeric code as is. The type is intended for elements with a fixed size
+ * binary representation, e.g. arithmetic types and timestamps, which are received by a single
+ * pass over the data, see `ozo::detail::BulkItem`.
+ *
+ * The array is an `Array` model, so it may be received from a result and sent as a query parameter.
+ * An empty PostgreSQL array is received as an array of rank 0 with no elements. The lower
+ * bounds of the dimensions are not kept.
+ *
+ *@code
+#include <ozo/md_array.h>
+ *@endcode
+ *
+ * ###Example
+ *
+ * @code
+ozo::rows_of<ozo::md_array<double>> rows;
+ozo::request(conn_info[io], "SELECT '{{1,2,3},{4,5,6}}'::float8[]"_SQL, ozo::into(rows), yield);
+const auto& m = std::get<0>(rows.front());
+// m.rank() == 2, m.extent(0) == 2, m.extent(1) == 3, m(1, 2) == 6.0
+ * @endcode
+ *
+ * @tparam T --- element type.
+ * @tparam Allocator --- allocator of the elements storage.
+ * @ingroup group-io-types
+ * @models{Array}
+ */
+template <typename T, typename Allocator = std::allocator<T>>
+class md_array {
+    static_assert(!Composite<T>, "composite elements are not supported, use nested containers instead");
+
+public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using storage_type = std::vector<T, Allocator>;
+    using size_type = std::size_t;
+    using iterator = typename storage_type::iterator;
+    using const_iterator = typename storage_type::const_iterator;
+
+    static constexpr size_type max_rank = 6; //!< maximum number of dimensions of PostgreSQL array, `MAXDIM`
+
+    md_array() = default;
+
+    explicit md_array(const Allocator& allocator) : data_(allocator) {}
+
+    /**
+     * Construct an array of the given extents with value-initialized elements.
+     *
+     * @param extents --- extents of the dimensions, no more than `max_rank`.
+     */
+    md_array(std::initializer_list<size_type> extents, const Allocator& allocator = Allocator{})
+    : data_(allocator) {
+        reshape(extents.begin(), extents.end());
+    }
+
+    size_type rank() const noexcept { return rank_;}
+
+    /**
+     * Extent of the dimension `i`, `i` should be less than `rank()`.
+     */
+    size_type extent(size_type i) const noexcept { return extents_[i];}
+
+    /**
+     * Number of the elements, the product of the extents; 0 for the array of rank 0.
+     */
+    size_type size() const noexcept { return data_.size();}
+    bool empty() const noexcept { return data_.empty();}
+
+    T* data() noexcept { return data_.data();}
+    const T* data() const noexcept { return data_.data();}
+
+    iterator begin() noexcept { return data_.begin();}
+    iterator end() noexcept { return data_.end();}
+    const_iterator begin() const noexcept { return data_.begin();}
+    const_iterator end() const noexcept { return data_.end();}
+
+    /**
+     * Element at the given indexes, one per dimension, in the row-major order.
+     */
+    template <typename ...Indexes>
+    T& operator ()(Indexes ...indexes) noexcept { return data_[offset(indexes...)];}
+
+    template <typename ...Indexes>
+    const T& operator ()(Indexes ...indexes) const noexcept { return data_[offset(indexes...)];}
+
+    /**
+     * Change the extents of the array and resize the storage to their product. The elements
+     * are kept in the storage order, the new ones are value-initialized.
+     *
+     * @throw ozo::system_error with `ozo::error::bad_array_dimension` if there are more than `max_rank` extents.
+     */
+    template <typename Iterator>
+    void reshape(Iterator first, Iterator last) {
+        const auto rank = static_cast<size_type>(std::distance(first, last));
+        if (rank > max_rank) {
+            throw system_error(error::bad_array_dimension,
+                "too many dimensions for md_array: " + std::to_string(rank));
+        }
+        std::copy(first, last, extents_.begin());
+        std::fill(extents_.begin() + rank, extents_.end(), size_type(0));
+        rank_ = rank;
+        data_.resize(rank ? std::accumulate(first, last, size_type(1), std::multiplies<>{}) : 0);
+    }
+
+    void reshape(std::initializer_list<size_type> extents) {
+        reshape(extents.begin(), extents.end());
+    }
+
+    const storage_type& storage() const & noexcept { return data_;}
+    storage_type&& storage() && noexcept { return std::move(data_);}
+
+    friend bool operator ==(const md_array& lhs, const md_array& rhs) {
+        return lhs.rank_ == rhs.rank_ && lhs.extents_ == rhs.extents_ && lhs.data_ == rhs.data_;
+    }
+
+    friend bool operator !=(const md_array& lhs, const md_array& rhs) { return !(lhs == rhs);}
+
+private:
+    template <typename ...Indexes>
+    size_type offset(Indexes ...indexes) const noexcept {
+        size_type result = 0;
+        size_type i = 0;
+        ((result = result * extents_[i++] + static_cast<size_type>(indexes)), ...);
+        return result;
+    }
+
+    storage_type data_;
+    std::array<size_type, max_rank> extents_ {};
+    size_type rank_ = 0;
+};
+
+template <typename T, typename Allocator>
+struct is_array<md_array<T, Allocator>> : std::true_type {};
+
+} // namespace ozo
+
+namespace ozo::detail {
+
+template <typename T, typename Allocator>
+struct size_of_array_impl<md_array<T, Allocator>> {
+    static constexpr auto apply(const md_array<T, Allocator>& v) {
+        constexpr const auto header_size = hana::unpack(
+            hana::members(pg_array{}),
+            [] (const auto& ...x) { return (sizeof(x) + ... + 0); });
+
+        constexpr const auto dimension_header_size = hana::unpack(
+            hana::members(pg_array_dimension{}),
+            [] (const auto& ...x) { return (sizeof(x) + ... + 0); });
+
+        size_type data_size = 0;
+        for (const auto& item : v) {
+            data_size += data_frame_size(item);
+        }
+
+        return static_cast<size_type>(header_size + dimension_header_size * v.rank()) + data_size;
+    }
+};
+
+template <typename T, typename Allocator>
+struct send_array_impl<md_array<T, Allocator>> {
+    template <typename OidMap>
+    static ostream& apply(ostream& out, const OidMap& oid_map, const md_array<T, Allocator>& in) {
+        write(out, pg_array {std::int32_t(in.rank()), 0, type_oid<T>(oid_map)});
+        for (std::size_t i = 0; i < in.rank(); ++i) {
+            write(out, pg_array_dimension {size_type(in.extent(i)), 0});
+        }
+        if constexpr (BulkItem<T>) {
+            send_bulk_array_items(in.data(), size_type(in.size()),
+                out.extend(std::streamsize(in.size()) * bulk_array_frame_size<T>));
+        } else {
+            for (const auto& v : in) {
+                send_data_frame(out, oid_map, v);
+            }
+        }
+        return out;
+    }
+};
+
+/**
+ * Receives all the dimensions of an array into the contiguous storage: the extents are
+ * read from the dimension headers first, then the storage is allocated once and the
+ * elements are received by a single pass if they have fixed size binary representation.
+ */
+template <typename T, typename Allocator>
+struct recv_array_impl<md_array<T, Allocator>> {
+    using out_type = md_array<T, Allocator>;
+
+    template <typename OidMap>
+    static istream& apply(istream& in, size_type, const OidMap& oids, out_type& out) {
+        pg_array array_header;
+
+        read(in, array_header);
+
+        using item_type = unwrap_type<T>;
+
+        if (!accepts_oid<item_type>(oids, array_header.elemtype)) {
+            throw system_error(error::oid_type_mismatch,
+                "unexpected oid " + std::to_string(array_header.elemtype)
+                + " for element type of " + boost::core::demangle(typeid(item_type).name()));
+        }
+
+        if (array_header.dimensions_count < 0 || std::size_t(array_header.dimensions_count) > out_type::max_rank) {
+            throw system_error(error::bad_array_dimension,
+                "unexpected dimension count: " + std::to_string(array_header.dimensions_count));
+        }
+
+        std::array<std::size_t, out_type::max_rank> extents {};
+        const auto rank = std::size_t(array_header.dimensions_count);
+        for (std::size_t i = 0; i < rank; ++i) {
+            pg_array_dimension dim_header;
+            read(in, dim_header);
+            if (dim_header.size < 0) {
+                throw system_error(error::bad_array_size,
+                    "negative dimension size: " + std::to_string(dim_header.size));
+            }
+            extents[i] = std::size_t(dim_header.size);
+        }
+
+        out.reshape(extents.begin(), extents.begin() + rank);
+
+        if (out.empty()) {
+            return in;
+        }
+
+        if constexpr (BulkItem<T>) {
+            if (recv_bulk_array(in, size_type(out.size()), out)) {
+                return in;
+            }
+        }
+
+        for (auto& item : out) {
+            recv_data_frame(in, oids, item);
+        }
+        return in;
+    }
+};
+
+} // namespace ozo::detail
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <ozo/impl/async_multi_request.h>
+
+namespace ozo {
+
+#ifdef OZO_DOCUMENTATION
+/**
+ * @brief Executes a text of several statements and receives a result for each of them
+ *
+ * The function gets a connection from the provider and sends the query text via the simple
+ * query protocol, so the text may contain several statements separated by semicolons which
+ * are executed in a single round trip without the pipeline mode. The server executes the
+ * statements as a single implicit transaction unless the text contains transaction control
+ * statements. The result of each statement is delivered into the output with the same index.
+ * The results of the statements beyond the outputs are dropped. In case of an error the server
+ * skips the rest of the statements and the operation completes with the error.
+ *
+ * The simple query protocol supports neither parameters nor the binary format of results,
+ * so the query is a text which models `QueryText` concept, and an output is a reference to
+ * an `ozo::result` object made with `std::ref()`, or `ozo::none` to check the result for
+ * errors only. The values of the results are in the text format. Use `ozo::pipeline()` for
+ * queries with parameters or typed outputs.
+ *
+ * @note The function does not particitate in ADL since could be implemented via functional object.
+ *
+ * @param provider --- connection provider object
+ * @param query --- query text, see `QueryText` concept
+ * @param outs --- `boost::hana::tuple` of outputs
+ * @param time_constraint --- request #TimeConstraint; this time constrain <b>includes</b> time for getting connection from provider.
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ *
+ * ###Example
+ *
+ * @code
+ozo::result users;
+ozo::result groups;
+
+ozo::multi_request(conn_info[io],
+    std::string_view("SELECT id, name FROM users; SELECT name FROM groups; UPDATE counters SET value = value + 1"),
+    hana::make_tuple(std::ref(users), std::ref(groups), ozo::none),
+    500ms,
+    yield);
+ * @endcode
+ */
+template <typename ConnectionProvider, typename QueryText, typename Outs, typename TimeConstraint, typename CompletionToken>
+decltype(auto) multi_request(ConnectionProvider&& provider, QueryText&& query, Outs&& outs, TimeConstraint time_constraint, CompletionToken&& token);
+
+/**
+ * @brief Executes a text of several statements and receives a result for each of them
+ *
+ * This function is time constrain free shortcut to `ozo::multi_request()` function.
+ * Its call is equal to `ozo::multi_request(provider, query, outs, ozo::none, token)` call.
+ *
+ * @note The function does not particitate in ADL since could be implemented via functional object.
+ *
+ * @param provider --- connection provider object
+ * @param query --- query text, see `QueryText` concept
+ * @param outs --- `boost::hana::tuple` of outputs
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ */
+template <typename ConnectionProvider, typename QueryText, typename Outs, typename CompletionToken>
+decltype(auto) multi_request(ConnectionProvider&& provider, QueryText&& query, Outs&& outs, CompletionToken&& token);
+#else
+
+template <typename Initiator>
+struct multi_request_op : base_async_operation <multi_request_op<Initiator>, Initiator> {
+    using base = typename multi_request_op::base;
+    using base::base;
+
+    template <typename P, typename Q, typename Outs, typename TimeConstraint, typename CompletionToken>
+    decltype(auto) operator() (P&& provider, Q&& query, Outs&& outs, TimeConstraint t, CompletionToken&& token) const {
+        static_assert(ConnectionProvider<P>, "provider should be a ConnectionProvider");
+        static_assert(QueryText<Q>, "query should be a text without parameters");
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        return async_initiate<CompletionToken, handler_signature<P>>(
+            get_operation_initiator(*this), token, std::forward<P>(provider), t,
+            std::forward<Q>(query), std::forward<Outs>(outs));
+    }
+
+    template <typename P, typename Q, typename Outs, typename CompletionToken>
+    decltype(auto) operator() (P&& provider, Q&& query, Outs&& outs, CompletionToken&& token) const {
+        return (*this)(std::forward<P>(provider), std::forward<Q>(query), std::forward<Outs>(outs), none,
+            std::forward<CompletionToken>(token));
+    }
+
+    template <typename OtherInitiator>
+    constexpr static auto rebind_initiator(const OtherInitiator& other) {
+        return multi_request_op<OtherInitiator>{other};
+    }
+};
+
+namespace detail {
+struct initiate_async_multi_request {
+    template <typename Handler, typename P, typename Q, typename Outs, typename TimeConstraint>
+    constexpr void operator()(Handler&& h, P&& provider, TimeConstraint t, Q&& query, Outs&& outs) const {
+        impl::async_multi_request(std::forward<P>(provider), std::forward<Q>(query), std::forward<Outs>(outs),
+            t, std::forward<Handler>(h));
+    }
+};
+} // namespace detail
+
+constexpr multi_request_op<detail::initiate_async_multi_request> multi_request;
+#endif
+
+} // namespace ozo
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <ozo/impl/async_multiplex.h>
+
+#ifdef LIBPQ_HAS_PIPELINING
+
+namespace ozo {
+
+/**
+ * @brief Multiplexer configuration
+ * @ingroup group-requests-types
+ */
+struct multiplexer_config {
+    std::size_t connections = 4; //!< number of connections the requests are spread across
+    std::size_t max_batch = 64; //!< maximum number of requests sent in one pipeline
+    time_traits::duration timeout = std::chrono::seconds(10); //!< time constraint of a batch including getting the connection
+};
+
+/**
+ * @brief Executes independent requests over a few connections in pipeline mode
+ *
+ * The multiplexer spreads the requests across a fixed number of connections, each of which
+ * executes the requests in batches in libpq pipeline mode: a request is queued to the connection
+ * with the fewest requests in flight, and all the requests queued while the connection executes
+ * a batch are sent by the next batch in one round trip. So many concurrent requests need only
+ * a few connections, e.g. to a connection pooler, without losing throughput.
+ *
+ * Each request is followed by its own synchronization point, so it is executed in its own
+ * implicit transaction and a failed request does not affect the others. Requests of a
+ * connection are completed in the order they have been sent. Since the connection is shared,
+ * the request completes with `void(ozo::error_code)` signature, the connection is not provided
+ * to the handler, and the multiplexer is not suitable for transactions or session settings.
+ * A connection is obtained from the source for each batch, so with a connection pool the
+ * connections are reused between the batches.
+ *
+ * The multiplexer may be used from many threads simultaneously. A referenced source should
+ * outlive the requests in flight.
+ *
+ * Requires libpq 14 or later.
+ *
+ * ### Example
+ *
+ * @code
+auto pool = ozo::make_connection_pool(ozo::connection_info(conn_str), pool_config);
+ozo::multiplexer mux(pool, io);
+
+ozo::rows_of<std::int64_t> ids;
+mux.request("SELECT id FROM users"_SQL, ozo::into(ids), yield[ec]);
+ * @endcode
+ *
+ * @tparam Source --- type of the underlying `ConnectionSource`; may be a reference type, e.g. for a pool.
+ * @ingroup group-requests-types
+ */
+template <typename Source>
+class multiplexer {
+    static_assert(ConnectionSource<Source>, "Source should model ConnectionSource concept");
+
+    using state_type = impl::multiplexer_state<Source>;
+    using connection_type = typename state_type::connection_type;
+
+public:
+    /**
+     * @brief Construct a new multiplexer object
+     *
+     * @param source --- connection source to get the connections from.
+     * @param io --- `io_context` for the connections IO.
+     * @param config --- multiplexer configuration.
+     */
+    multiplexer(Source source, io_context& io, const multiplexer_config& config = {})
+    : state_(std::make_shared<state_type>(std::forward<Source>(source), io,
+        config.connections, config.max_batch, config.timeout)) {}
+
+    /**
+     * @brief Executes the query and writes its result into the output
+     *
+     * @param query --- query object to execute.
+     * @param out --- output object like Iterator, Container, etc. with the same semantics
+     *                as for `ozo::request()`, `ozo::none` to check the result for errors only.
+     * @param token --- operation #CompletionToken with `void(ozo::error_code)` signature.
+     * @return deduced from #CompletionToken.
+     */
+    template <typename BinaryQueryConvertible, typename Out, typename CompletionToken>
+    decltype(auto) request(BinaryQueryConvertible&& query, Out out, CompletionToken&& token) {
+        static_assert(ozo::BinaryQueryConvertible<BinaryQueryConvertible>,
+            "query should be convertible to the binary_query");
+        return async_initiate<CompletionToken, void(error_code)>(
+            [state = state_] (auto&& handler, auto&& query, Out out) {
+                using handler_type = std::decay_t<decltype(handler)>;
+                using query_type = std::decay_t<decltype(query)>;
+                using executor_type = io_context::executor_type;
+                using request_type = impl::multiplexed_request_impl<connection_type, query_type, Out,
+                    handler_type, executor_type>;
+                auto allocator = asio::get_associated_allocator(handler);
+                state->submit(std::allocate_shared<request_type>(allocator,
+                    std::forward<decltype(query)>(query), std::move(out),
+                    std::forward<decltype(handler)>(handler), state->get_io_context().get_executor()));
+            },
+            token, std::forward<BinaryQueryConvertible>(query), std::move(out));
+    }
+
+    /**
+     * @brief Executes the query and checks its result for errors only
+     *
+     * Shortcut to `request(query, ozo::none, token)`.
+     */
+    template <typename BinaryQueryConvertible, typename CompletionToken>
+    decltype(auto) execute(BinaryQueryConvertible&& query, CompletionToken&& token) {
+        return request(std::forward<BinaryQueryConvertible>(query), none, std::forward<CompletionToken>(token));
+    }
+
+    /**
+     * Number of the connections the requests are spread across.
+     */
+    std::size_t size() const noexcept { return state_->size();}
+
+    /**
+     * Number of the requests queued to or being executed by the connection.
+     *
+     * @param connection --- index of the connection.
+     */
+    std::size_t in_flight(std::size_t connection) const { return state_->in_flight(connection);}
+
+private:
+    std::shared_ptr<state_type> state_;
+};
+
+template <typename Source>
+multiplexer(Source&& source, io_context& io) -> multiplexer<Source>;
+
+template <typename Source>
+multiplexer(Source&& source, io_context& io, const multiplexer_config&) -> multiplexer<Source>;
+
+} // namespace ozo
+
+#endif
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <ozo/impl/io.h>
+
+#include <string>
+#include <vector>
+
+namespace ozo {
+
+/**
+ * @brief Asynchronous notification
+ * @ingroup group-connection-types
+ *
+ * Notification delivered by the `NOTIFY` command to the connections which listen
+ * to its channel, reflects libpq
+ * <a href="https://www.postgresql.org/docs/current/libpq-notify.html">PGnotify</a>.
+ */
+struct notification {
+    std::string channel; //!< name of the channel
+    std::string payload; //!< payload string, empty if it was not specified
+    int backend_pid = 0; //!< process id of the notifying server process
+};
+
+/**
+ * @brief Takes notifications received by a `Connection`
+ *
+ * libpq receives notifications together with results of requests, so the notifications
+ * of channels listened by the connection are collected while it is used for other
+ * requests. This function takes them out of the connection. Use `ozo::listen()` to wait
+ * for new notifications.
+ *
+ * @param conn --- `Connection` object.
+ * @return std::vector<notification> --- notifications in order of their receipt.
+ * @ingroup group-connection-functions
+ */
+template <typename T>
+inline std::vector<notification> get_notifications(T& conn) {
+    static_assert(Connection<T>, "T must be a Connection");
+    std::vector<notification> result;
+    while (auto n = impl::get_notification(conn)) {
+        result.push_back(notification {n->relname, n->extra ? n->extra : "", n->be_pid});
+    }
+    return result;
+}
+
+} // namespace ozo
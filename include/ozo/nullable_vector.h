@@ -0,0 +1,326 @@
+#pragma once
+
+#include <ozo/io/array.h>
+#include <ozo/core/nullable.h>
+#include <ozo/core/unwrap.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace ozo {
+
+/**
+ * @brief Vector of nullable values with a separate null bitmap
+ *
+ * Keeps the values densely in a contiguous storage and the null state of each of them in a bitmap,
+ * one bit per value, instead of a `#Nullable` per value like `std::optional<T>` or `std::unique_ptr<T>`.
+ * So a nullable column or an array with NULLs takes the size of the values plus a bit per value and may be
+ * processed by a vectorized loop over `data()`. A null value is stored as a value-initialized `T` with
+ * the respective bit set.
+ *
+ * The vector is an `Array` model, so an array with NULLs may be received into it and it may be sent as
+ * a query parameter. It may also be used as a column container of `ozo::columns_of`, then values of fixed
+ * size binary representation types are received by a single pass over the column.
+ *
+ * Values of `#Nullable` types may be appended via `push_back()`, the null state is taken via `ozo::is_null()`.
+ *
+ *@code
+#include <ozo/nullable_vector.h>
+ *@endcode
+ *
+ * ###Example
+ *
+ * @code
+ozo::columns_of<ozo::nullable_vector<std::int64_t>, std::vector<std::string>> columns;
+ozo::request(conn_info[io], "SELECT parent_id, name FROM nodes"_SQL, ozo::into(columns), yield);
+const auto& parents = std::get<0>(columns);
+for (std::size_t i = 0; i < parents.size(); ++i) {
+    if (!parents.is_null(i)) {
+        visit(parents[i]);
+    }
+}
+ * @endcode
+ *
+ * @tparam T --- value type.
+ * @tparam Allocator --- allocator of the values storage, it is rebound for the bitmap.
+ * @ingroup group-io-types
+ * @models{Array}
+ */
+template <typename T, typename Allocator = std::allocator<T>>
+class nullable_vector {
+public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using word_type = std::uint64_t;
+    using storage_type = std::vector<T, Allocator>;
+    using bitmap_type = std::vector<word_type,
+        typename std::allocator_traits<Allocator>::template rebind_alloc<word_type>>;
+    using size_type = std::size_t;
+    using iterator = typename storage_type::iterator;
+    using const_iterator = typename storage_type::const_iterator;
+
+    static constexpr size_type word_bits = sizeof(word_type) * 8;
+
+    nullable_vector() = default;
+
+    explicit nullable_vector(const Allocator& allocator)
+    : values_(allocator), nulls_(typename bitmap_type::allocator_type(allocator)) {}
+
+    size_type size() const noexcept { return values_.size();}
+    bool empty() const noexcept { return values_.empty();}
+
+    /**
+     * Values storage, null values are value-initialized.
+     */
+    T* data() noexcept { return values_.data();}
+    const T* data() const noexcept { return values_.data();}
+
+    iterator begin() noexcept { return values_.begin();}
+    iterator end() noexcept { return values_.end();}
+    const_iterator begin() const noexcept { return values_.begin();}
+    const_iterator end() const noexcept { return values_.end();}
+
+    T& operator [](size_type i) noexcept { return values_[i];}
+    const T& operator [](size_type i) const noexcept { return values_[i];}
+
+    bool is_null(size_type i) const noexcept {
+        return (nulls_[i / word_bits] >> (i % word_bits)) & 1u;
+    }
+
+    void set_null(size_type i, bool null = true) noexcept {
+        const auto mask = word_type(1) << (i % word_bits);
+        auto& word = nulls_[i / word_bits];
+        word = null ? (word | mask) : (word & ~mask);
+    }
+
+    /**
+     * Number of null values.
+     */
+    size_type null_count() const noexcept {
+        size_type result = 0;
+        for (auto word : nulls_) {
+            result += static_cast<size_type>(__builtin_popcountll(word));
+        }
+        return result;
+    }
+
+    /**
+     * Null bitmap, the bit `i % 64` of the word `i / 64` is set if the value `i` is null.
+     */
+    const bitmap_type& bitmap() const noexcept { return nulls_;}
+
+    void reserve(size_type n) {
+        values_.reserve(n);
+        nulls_.reserve(words(n));
+    }
+
+    /**
+     * Resize the vector, the new values are value-initialized and not null.
+     */
+    void resize(size_type n) {
+        if (n < size() && n % word_bits) {
+            nulls_[n / word_bits] &= (word_type(1) << (n % word_bits)) - 1;
+        }
+        values_.resize(n);
+        nulls_.resize(words(n));
+    }
+
+    void clear() noexcept {
+        values_.clear();
+        nulls_.clear();
+    }
+
+    void push_back(T v) {
+        resize(size() + 1);
+        values_.back() = std::move(v);
+    }
+
+    /**
+     * Append a value of a `#Nullable` type, e.g. `std::optional<T>`.
+     */
+    template <typename N, typename = Require<Nullable<N>>>
+    void push_back(const N& v) {
+        if (ozo::is_null(v)) {
+            push_null();
+        } else {
+            push_back(T(ozo::unwrap(v)));
+        }
+    }
+
+    void push_null() {
+        resize(size() + 1);
+        set_null(size() - 1);
+    }
+
+    friend bool operator ==(const nullable_vector& lhs, const nullable_vector& rhs) {
+        return lhs.values_ == rhs.values_ && lhs.nulls_ == rhs.nulls_;
+    }
+
+    friend bool operator !=(const nullable_vector& lhs, const nullable_vector& rhs) { return !(lhs == rhs);}
+
+private:
+    static constexpr size_type words(size_type n) noexcept {
+        return (n + word_bits - 1) / word_bits;
+    }
+
+    storage_type values_;
+    bitmap_type nulls_;
+};
+
+template <typename T, typename Allocator>
+struct is_array<nullable_vector<T, Allocator>> : std::true_type {};
+
+} // namespace ozo
+
+namespace ozo::detail {
+
+template <typename T, typename Allocator>
+struct size_of_array_impl<nullable_vector<T, Allocator>> {
+    static constexpr auto apply(const nullable_vector<T, Allocator>& v) {
+        constexpr const auto header_size = hana::unpack(
+            hana::members(pg_array{}),
+            [] (const auto& ...x) { return (sizeof(x) + ... + 0); });
+
+        constexpr const auto dimension_header_size = hana::unpack(
+            hana::members(pg_array_dimension{}),
+            [] (const auto& ...x) { return (sizeof(x) + ... + 0); });
+
+        size_type data_size = 0;
+        for (std::size_t i = 0; i < v.size(); ++i) {
+            data_size += v.is_null(i) ? size_type(sizeof(size_type)) : data_frame_size(v[i]);
+        }
+
+        return static_cast<size_type>(header_size + dimension_header_size) + data_size;
+    }
+};
+
+template <typename T, typename Allocator>
+struct send_array_impl<nullable_vector<T, Allocator>> {
+    template <typename OidMap>
+    static ostream& apply(ostream& out, const OidMap& oid_map, const nullable_vector<T, Allocator>& in) {
+        write(out, pg_array {1, 0, type_oid<T>(oid_map)});
+        write(out, pg_array_dimension {size_type(in.size()), 0});
+        if constexpr (BulkItem<T>) {
+            if (in.null_count() == 0) {
+                send_bulk_array_items(in.data(), size_type(in.size()),
+                    out.extend(std::streamsize(in.size()) * bulk_array_frame_size<T>));
+                return out;
+            }
+        }
+        for (std::size_t i = 0; i < in.size(); ++i) {
+            if (in.is_null(i)) {
+                write(out, static_cast<size_type>(null_state_size));
+            } else {
+                send_data_frame(out, oid_map, in[i]);
+            }
+        }
+        return out;
+    }
+};
+
+/**
+ * Arrays without NULLs of fixed size binary representation types are received
+ * by a single pass, otherwise NULL frames set the respective bits of the bitmap.
+ */
+template <typename T, typename Allocator>
+struct recv_array_impl<nullable_vector<T, Allocator>> {
+    using out_type = nullable_vector<T, Allocator>;
+
+    template <typename OidMap>
+    static istream& apply(istream& in, size_type, const OidMap& oids, out_type& out) {
+        pg_array array_header;
+        pg_array_dimension dim_header;
+
+        read(in, array_header);
+
+        if (array_header.dimensions_count > 1) {
+            throw system_error(error::bad_array_dimension,
+                "multiply dimension count is not supported: "
+                 + std::to_string(array_header.dimensions_count));
+        }
+
+        using item_type = unwrap_type<T>;
+
+        if (!accepts_oid<item_type>(oids, array_header.elemtype)) {
+            throw system_error(error::oid_type_mismatch,
+                "unexpected oid " + std::to_string(array_header.elemtype)
+                + " for element type of " + boost::core::demangle(typeid(item_type).name()));
+        }
+
+        out.clear();
+
+        if (array_header.dimensions_count < 1) {
+            return in;
+        }
+
+        read(in, dim_header);
+
+        if (dim_header.size <= 0) {
+            return in;
+        }
+
+        out.resize(std::size_t(dim_header.size));
+
+        if constexpr (BulkItem<T>) {
+            if (recv_bulk_array(in, dim_header.size, out)) {
+                return in;
+            }
+        }
+
+        for (std::size_t i = 0; i < out.size(); ++i) {
+            size_type size = 0;
+            read(in, size);
+            if (size == null_state_size) {
+                out.set_null(i);
+            } else {
+                recv(in, null_oid, size, oids, out[i]);
+            }
+        }
+        return in;
+    }
+};
+
+/**
+ * Receives a nullable column into the dense values and the null bitmap. Values of
+ * fixed size binary representation types are loaded directly, see `ozo::detail::bulk_item`.
+ */
+template <typename T, typename OidMap, typename V, typename Allocator>
+inline bool recv_column(const basic_result<T>& in, int column, const OidMap& oid_map,
+        nullable_vector<V, Allocator>& out, recv_error& err) {
+    const auto offset = out.size();
+    out.resize(offset + std::size(in));
+    auto i = offset;
+    if constexpr (BulkItem<V>) {
+        if (impl::field_format(*in.native_handle(), column) == impl::result_format::binary) {
+            using item = bulk_item<V>;
+            for (const auto& row : in) {
+                const auto v = row[column];
+                if (v.is_null()) {
+                    out.set_null(i++);
+                    continue;
+                }
+                if (v.size() != item::size) {
+                    err.set(error::bad_object_size, "data size " + std::to_string(v.size())
+                        + " does not match type size " + std::to_string(item::size));
+                    out.resize(i);
+                    return false;
+                }
+                out[i++] = item::load(v.data());
+            }
+            return true;
+        }
+    }
+    for (const auto& row : in) {
+        const auto v = row[column];
+        if (v.is_null()) {
+            out.set_null(i++);
+        } else if (!recv_checked(v, oid_map, out[i++], err)) {
+            out.resize(i - 1);
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace ozo::detail
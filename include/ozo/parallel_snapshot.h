@@ -0,0 +1,145 @@
+#pragma once
+
+#include <ozo/impl/async_parallel_snapshot.h>
+
+namespace ozo {
+
+#ifdef OZO_DOCUMENTATION
+/**
+ * @brief Begins transactions which read the same consistent snapshot in parallel
+ *
+ * A large table export via a single connection is limited by the speed of one backend.
+ * The function begins a coordinator transaction, exports its snapshot with `pg_export_snapshot()`
+ * and begins the `workers` transactions via the provider concurrently, each of them imports the
+ * snapshot with `SET TRANSACTION SNAPSHOT` as its first statement. Then the coordinator is rolled
+ * back and the operation completes with the worker transactions, so all of them see the same data
+ * and may read disjoint key ranges of a table in parallel, e.g. via `ozo::copy_out()` or cursors.
+ * The worker transactions should be ended by the caller.
+ *
+ * A snapshot may be imported by a transaction with the `ozo::isolation_level::repeatable_read` or
+ * `ozo::isolation_level::serializable` isolation level only. The default options are
+ * `ozo::isolation_level::repeatable_read` and `ozo::transaction_mode::read_only`.
+ *
+ * If the coordinator or any of the workers fails the operation completes with the first error and
+ * no transactions, the connections of the workers which have begun are released in the transaction
+ * state, so a pool does not reuse them.
+ *
+ * The handler is called with `void(ozo::error_code, std::vector<Transaction>)` signature via its
+ * associated executor.
+ *
+ * @note The function does not particitate in ADL since could be implemented via functional object.
+ *
+ * @param provider --- `ConnectionProvider` to get the connections from, e.g. a connection pool.
+ * @param workers --- number of the worker transactions.
+ * @param time_constraint --- `TimeConstraint` of each step of the operation; it <b>includes</b> time for getting connection from provider.
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ *
+ * @par Transaction options
+ *
+ * The options of the coordinator and the workers may be specified the same way as with `ozo::begin()`:
+ *
+ * @code
+ozo::begin_parallel_snapshot.with_transaction_options(ozo::make_options(Options...));
+ * @endcode
+ *
+ * ###Example
+ *
+ * @code
+auto workers = ozo::begin_parallel_snapshot(pool[io], 4, 1min, yield);
+for (std::size_t i = 0; i < workers.size(); ++i) {
+    boost::asio::spawn(io, [&, i, worker = std::move(workers[i])] (auto yield) mutable {
+        const auto query = ozo::make_query("COPY (SELECT * FROM events WHERE id % 4 = $1) TO STDOUT (FORMAT binary)",
+            std::int64_t(i));
+        worker = ozo::copy_out(std::move(worker), query, ozo::copy_rows<event>(write_event), yield);
+        ozo::commit(std::move(worker), yield);
+    });
+}
+ * @endcode
+ * @ingroup group-transaction-functions
+ */
+template <typename ConnectionProvider, typename TimeConstraint, typename CompletionToken>
+decltype(auto) begin_parallel_snapshot(ConnectionProvider&& provider, std::size_t workers, TimeConstraint time_constraint, CompletionToken&& token);
+
+/**
+ * @brief Begins transactions which read the same consistent snapshot in parallel
+ *
+ * This function is time constrain free shortcut to `ozo::begin_parallel_snapshot()` function.
+ * Its call is equal to `ozo::begin_parallel_snapshot(provider, workers, ozo::none, token)` call.
+ *
+ * @note The function does not particitate in ADL since could be implemented via functional object.
+ *
+ * @param provider --- `ConnectionProvider` to get the connections from.
+ * @param workers --- number of the worker transactions.
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-transaction-functions
+ */
+template <typename ConnectionProvider, typename CompletionToken>
+decltype(auto) begin_parallel_snapshot(ConnectionProvider&& provider, std::size_t workers, CompletionToken&& token);
+#else
+
+namespace detail {
+
+struct initiate_async_begin_parallel_snapshot {
+    template <typename Handler, typename P, typename Options, typename TimeConstraint>
+    constexpr void operator()(Handler&& h, P&& provider, std::size_t workers, Options&& options, TimeConstraint t) const {
+        impl::async_begin_parallel_snapshot(std::forward<P>(provider), workers, std::forward<Options>(options),
+            t, std::forward<Handler>(h));
+    }
+};
+
+template <typename Options>
+using snapshot_isolation_level = std::decay_t<decltype(get_option(std::declval<const Options&>(),
+    transaction_options::isolation_level, std::false_type{}))>;
+
+template <typename Options>
+using is_snapshot_import_level = std::disjunction<
+    std::is_same<snapshot_isolation_level<Options>, std::decay_t<decltype(isolation_level::repeatable_read)>>,
+    std::is_same<snapshot_isolation_level<Options>, std::decay_t<decltype(isolation_level::serializable)>>>;
+
+using parallel_snapshot_default_options = decltype(make_options(
+    transaction_options::isolation_level = isolation_level::repeatable_read,
+    transaction_options::mode = transaction_mode::read_only));
+
+} // namespace detail
+
+template <typename Initiator, typename Options = detail::parallel_snapshot_default_options>
+struct begin_parallel_snapshot_op : base_async_operation <begin_parallel_snapshot_op<Initiator, Options>, Initiator> {
+    using base = typename begin_parallel_snapshot_op::base;
+    Options options_;
+
+    constexpr explicit begin_parallel_snapshot_op(Initiator initiator = {}, Options options = {})
+    : base(initiator), options_(options) {}
+
+    template <typename P, typename TimeConstraint, typename CompletionToken>
+    decltype(auto) operator() (P&& provider, std::size_t workers, TimeConstraint t, CompletionToken&& token) const {
+        static_assert(ConnectionProvider<P>, "provider should be a ConnectionProvider");
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        using transaction_type = transaction<connection_type<P>, Options>;
+        return async_initiate<CompletionToken, void(error_code, std::vector<transaction_type>)>(
+            get_operation_initiator(*this), token, std::forward<P>(provider), workers, options_, t);
+    }
+
+    template <typename P, typename CompletionToken>
+    decltype(auto) operator() (P&& provider, std::size_t workers, CompletionToken&& token) const {
+        return (*this)(std::forward<P>(provider), workers, none, std::forward<CompletionToken>(token));
+    }
+
+    template <typename OtherOptions>
+    constexpr auto with_transaction_options(const OtherOptions& options) const {
+        static_assert(detail::is_snapshot_import_level<OtherOptions>::value,
+            "snapshot may be imported with repeatable read or serializable isolation level only");
+        return begin_parallel_snapshot_op<Initiator, OtherOptions>{get_operation_initiator(*this), options};
+    }
+
+    template <typename OtherInitiator>
+    constexpr auto rebind_initiator(const OtherInitiator& other) const {
+        return begin_parallel_snapshot_op<OtherInitiator, Options>{other, options_};
+    }
+};
+
+inline constexpr begin_parallel_snapshot_op<detail::initiate_async_begin_parallel_snapshot> begin_parallel_snapshot;
+#endif
+
+} // namespace ozo
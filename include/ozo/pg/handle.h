@@ -2,17 +2,41 @@
 
 #include <libpq-fe.h>
 #include <boost/hana/core/to.hpp>
+#include <atomic>
 #include <memory>
 
 namespace ozo::pg {
 
+namespace detail {
+
+/**
+* Hook which takes over the release of results, see `ozo::result_reclaimer`.
+*/
+struct result_release_hook {
+    virtual bool release(::PGresult* ptr) noexcept = 0;
+protected:
+    ~result_release_hook() = default;
+};
+
+inline std::atomic<result_release_hook*>& result_release() noexcept {
+    static std::atomic<result_release_hook*> hook {nullptr};
+    return hook;
+}
+
+} // namespace detail
+
 template <typename T>
 struct safe_handle;
 
 template<>
 struct safe_handle<::PGresult> {
     struct deleter {
-        void operator() (::PGresult *ptr) const noexcept { ::PQclear(ptr); }
+        void operator() (::PGresult *ptr) const noexcept {
+            if (const auto hook = detail::result_release().load(std::memory_order_acquire); hook && hook->release(ptr)) {
+                return;
+            }
+            ::PQclear(ptr);
+        }
     };
     using type = std::unique_ptr<::PGresult, deleter>;
 };
@@ -25,6 +49,30 @@ struct safe_handle<::PGconn> {
     using type = std::unique_ptr<::PGconn, deleter>;
 };
 
+template <>
+struct safe_handle<char> {
+    struct deleter {
+        void operator() (char *ptr) const noexcept { ::PQfreemem(ptr); }
+    };
+    using type = std::unique_ptr<char, deleter>;
+};
+
+template <>
+struct safe_handle<::PGnotify> {
+    struct deleter {
+        void operator() (::PGnotify *ptr) const noexcept { ::PQfreemem(ptr); }
+    };
+    using type = std::unique_ptr<::PGnotify, deleter>;
+};
+
+template <>
+struct safe_handle<::PGcancel> {
+    struct deleter {
+        void operator() (::PGcancel *ptr) const noexcept { ::PQfreeCancel(ptr); }
+    };
+    using type = std::unique_ptr<::PGcancel, deleter>;
+};
+
 template <typename T>
 using safe_handle_t = typename safe_handle<T>::type;
 
@@ -39,6 +87,12 @@ using result = pg::safe_handle_t<::PGresult>;
 
 using shared_result = std::shared_ptr<::PGresult>;
 
+using copy_data = safe_handle_t<char>;
+
+using notify = safe_handle_t<::PGnotify>;
+
+using shared_cancel = std::shared_ptr<::PGcancel>;
+
 } // namespace ozo::pg
 
 namespace boost::hana {
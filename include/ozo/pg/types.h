@@ -22,3 +22,4 @@
 #include <ozo/pg/types/timestamp.h>
 #include <ozo/pg/types/interval.h>
 #include <ozo/pg/types/ltree.h>
+#include <ozo/pg/types/numeric.h>
@@ -2,11 +2,33 @@
 
 #include <ozo/pg/definitions.h>
 #include <ozo/core/strong_typedef.h>
+#include <ozo/io/recv.h>
 
+#include <string_view>
 #include <vector>
 
 namespace ozo::pg {
 OZO_STRONG_TYPEDEF(std::vector<char>, bytea)
+
+/**
+ * Non-owning view of `bytea` data. It is sent as a query parameter without
+ * copying, see `ozo::is_borrowed_parameter`. Being received it points into the
+ * result memory, so the result should outlive it, see `ozo::borrowed_rows`.
+ */
+OZO_STRONG_TYPEDEF(std::string_view, bytea_view)
 }
 
+namespace ozo {
+
+template <>
+struct recv_impl<pg::bytea_view> {
+    template <typename OidMap>
+    static istream& apply(istream& in, size_type size, const OidMap& oid_map, pg::bytea_view& out) {
+        return recv_impl<std::string_view>::apply(in, size, oid_map, out.get());
+    }
+};
+
+} // namespace ozo
+
 OZO_PG_BIND_TYPE(ozo::pg::bytea, "bytea")
+OZO_PG_BIND_TYPE(ozo::pg::bytea_view, "bytea")
@@ -2,11 +2,60 @@
 
 #include <ozo/pg/definitions.h>
 #include <ozo/core/strong_typedef.h>
+#include <ozo/io/recv.h>
 
 #include <string>
+#include <string_view>
+#include <type_traits>
 
 namespace ozo::pg {
 OZO_STRONG_TYPEDEF(std::string, json)
-}
+
+/**
+ * Receiver of `json` value which feeds the document to a user parser as is,
+ * without the intermediate string, see `ozo::pg::jsonb_reader`.
+ *
+ * @tparam Parser --- callable with `std::string_view` argument.
+ */
+template <typename Parser>
+class json_reader {
+public:
+    json_reader() = default;
+
+    explicit json_reader(Parser parser) noexcept(std::is_nothrow_move_constructible_v<Parser>)
+        : parser_(std::move(parser)) {}
+
+    Parser& parser() & noexcept { return parser_;}
+
+    const Parser& parser() const & noexcept { return parser_;}
+
+    Parser parser() && noexcept(std::is_nothrow_move_constructible_v<Parser>) { return std::move(parser_);}
+
+private:
+    Parser parser_;
+};
+
+} // namespace ozo::pg
+
+namespace ozo {
+
+template <typename Parser>
+struct recv_impl<pg::json_reader<Parser>> {
+    template <typename OidMap>
+    static istream& apply(istream& in, size_type size, const OidMap&, pg::json_reader<Parser>& out) {
+        const auto data = detail::recv_view(in, size);
+        out.parser()(std::string_view(data, static_cast<std::size_t>(size)));
+        return in;
+    }
+};
+
+} // namespace ozo
+
+namespace ozo::definitions {
+
+template <typename Parser>
+struct type<pg::json_reader<Parser>> : pg::type_definition<decltype("json"_s)>{};
+
+} // namespace ozo::definitions
 
 OZO_PG_BIND_TYPE(ozo::pg::json, "json")
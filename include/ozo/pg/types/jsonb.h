@@ -5,6 +5,8 @@
 #include <ozo/io/recv.h>
 
 #include <string>
+#include <string_view>
+#include <type_traits>
 
 namespace ozo::pg {
 
@@ -31,6 +33,67 @@ private:
     std::string value;
 };
 
+/**
+ * Non-owning view of `jsonb` value. Being received it points into the result
+ * memory without copying, so the result should outlive it, see `ozo::borrowed_rows`.
+ * It may be used to forward JSON documents as is.
+ */
+class jsonb_view {
+    friend send_impl<jsonb_view>;
+    friend recv_impl<jsonb_view>;
+    friend size_of_impl<jsonb_view>;
+
+public:
+    constexpr jsonb_view() = default;
+
+    constexpr jsonb_view(std::string_view raw_string) noexcept
+        : value(raw_string) {}
+
+    constexpr std::string_view raw_string() const noexcept {
+        return value;
+    }
+
+private:
+    std::string_view value;
+};
+
+/**
+ * Receiver of `jsonb` value which feeds the document to a user parser as is,
+ * e.g. to a SAX parser, without the intermediate string. The parser is called
+ * with `std::string_view` of the document which points into the result memory,
+ * so a large document is parsed while it is still in the result and the view
+ * should not be kept after the call.
+ *
+ * @tparam Parser --- callable with `std::string_view` argument.
+ *
+ * ###Example
+ *
+ * @code
+struct parser {
+    void operator() (std::string_view document) { ... }
+};
+ozo::pg::jsonb_reader<parser> reader;
+ozo::recv(value, oid_map, reader);
+ * @endcode
+ */
+template <typename Parser>
+class jsonb_reader {
+public:
+    jsonb_reader() = default;
+
+    explicit jsonb_reader(Parser parser) noexcept(std::is_nothrow_move_constructible_v<Parser>)
+        : parser_(std::move(parser)) {}
+
+    Parser& parser() & noexcept { return parser_;}
+
+    const Parser& parser() const & noexcept { return parser_;}
+
+    Parser parser() && noexcept(std::is_nothrow_move_constructible_v<Parser>) { return std::move(parser_);}
+
+private:
+    Parser parser_;
+};
+
 } // namespace ozo::pg
 
 namespace ozo {
@@ -66,6 +129,59 @@ struct recv_impl<pg::jsonb> {
     }
 };
 
+template <>
+struct size_of_impl<pg::jsonb_view> {
+    static auto apply(const pg::jsonb_view& v) noexcept {
+        return std::size(v.value) + 1;
+    }
+};
+
+template <>
+struct send_impl<pg::jsonb_view> {
+    template <typename OidMap>
+    static ostream& apply(ostream& out, const OidMap&, const pg::jsonb_view& in) {
+        const std::int8_t version = 1;
+        write(out, version);
+        return write(out, in.value);
+    }
+};
+
+template <>
+struct recv_impl<pg::jsonb_view> {
+    template <typename OidMap>
+    static istream& apply(istream& in, size_type size, const OidMap& oid_map, pg::jsonb_view& out) {
+        if (size < 1) {
+            throw std::range_error("data size " + std::to_string(size) + " is too small to read jsonb");
+        }
+        std::int8_t version;
+        read(in, version);
+        return recv_impl<std::string_view>::apply(in, size - 1, oid_map, out.value);
+    }
+};
+
+template <typename Parser>
+struct recv_impl<pg::jsonb_reader<Parser>> {
+    template <typename OidMap>
+    static istream& apply(istream& in, size_type size, const OidMap&, pg::jsonb_reader<Parser>& out) {
+        if (size < 1) {
+            throw std::range_error("data size " + std::to_string(size) + " is too small to read jsonb");
+        }
+        std::int8_t version;
+        read(in, version);
+        const auto data = detail::recv_view(in, size - 1);
+        out.parser()(std::string_view(data, static_cast<std::size_t>(size - 1)));
+        return in;
+    }
+};
+
 } // namespace ozo
 
+namespace ozo::definitions {
+
+template <typename Parser>
+struct type<pg::jsonb_reader<Parser>> : pg::type_definition<decltype("jsonb"_s)>{};
+
+} // namespace ozo::definitions
+
 OZO_PG_BIND_TYPE(ozo::pg::jsonb, "jsonb")
+OZO_PG_BIND_TYPE(ozo::pg::jsonb_view, "jsonb")
@@ -0,0 +1,376 @@
+#pragma once
+
+#include <ozo/pg/definitions.h>
+#include <ozo/io/send.h>
+#include <ozo/io/recv.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace ozo::pg {
+
+#ifdef __SIZEOF_INT128__
+__extension__ typedef __int128 int128_t;
+__extension__ typedef unsigned __int128 uint128_t;
+#endif
+
+/**
+ * @brief Fixed point decimal number of `numeric` type
+ *
+ * The value is `unscaled() * 10^-scale()`, e.g. `numeric64{12345, 2}` is `123.45`.
+ * The number is received from the base-10000 binary representation of `numeric`
+ * directly, without text parsing and allocations. Values of up to 16 decimal
+ * digits are decoded with 64-bit arithmetic only, so `ozo::pg::numeric` costs
+ * 128-bit arithmetic for the large values only.
+ *
+ * A received number has the scale of the value, i.e. of the column for
+ * `numeric(precision, scale)` columns. `NaN`, infinities and values which do not
+ * fit into `Rep` with the scale can not be received, `std::range_error` is thrown.
+ *
+ * @tparam Rep --- signed integer type of the unscaled value, `std::int64_t` or `ozo::pg::int128_t`.
+ * @ingroup group-type_system-pg-types
+ */
+template <typename Rep>
+class basic_numeric {
+public:
+    using rep = Rep;
+
+    constexpr basic_numeric() noexcept = default;
+
+    constexpr basic_numeric(Rep unscaled, std::uint16_t scale = 0) noexcept
+    : unscaled_(unscaled), scale_(scale) {}
+
+    /**
+     * Value multiplied by `10^scale()`.
+     */
+    constexpr Rep unscaled() const noexcept { return unscaled_;}
+
+    /**
+     * Number of decimal digits after the point.
+     */
+    constexpr std::uint16_t scale() const noexcept { return scale_;}
+
+    double to_double() const noexcept {
+        return static_cast<double>(unscaled_) / std::pow(10.0, scale_);
+    }
+
+    /**
+     * Decimal representation of the value with `scale()` digits after the point, e.g. `-0.050`.
+     */
+    std::string to_string() const;
+
+    /**
+     * Compares representations, so numbers of the same value with different scales are not equal.
+     */
+    friend constexpr bool operator ==(const basic_numeric& lhs, const basic_numeric& rhs) noexcept {
+        return lhs.unscaled_ == rhs.unscaled_ && lhs.scale_ == rhs.scale_;
+    }
+
+    friend constexpr bool operator !=(const basic_numeric& lhs, const basic_numeric& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+private:
+    Rep unscaled_ = 0;
+    std::uint16_t scale_ = 0;
+};
+
+using numeric64 = basic_numeric<std::int64_t>;
+
+#ifdef __SIZEOF_INT128__
+using numeric = basic_numeric<int128_t>;
+#endif
+
+namespace detail {
+
+template <typename Rep>
+struct numeric_unsigned { using type = std::make_unsigned_t<Rep>; };
+
+#ifdef __SIZEOF_INT128__
+template <>
+struct numeric_unsigned<int128_t> { using type = uint128_t; };
+#endif
+
+template <typename Rep>
+using numeric_unsigned_t = typename numeric_unsigned<Rep>::type;
+
+constexpr std::uint16_t numeric_pos = 0x0000;
+constexpr std::uint16_t numeric_neg = 0x4000;
+constexpr std::int16_t numeric_nbase = 10000;
+constexpr std::int16_t numeric_dec_digits = 4;
+
+template <typename U>
+constexpr U numeric_max_abs(bool negative) noexcept {
+    return (U(~U(0)) >> 1) + (negative ? 1 : 0);
+}
+
+template <typename Rep>
+inline numeric_unsigned_t<Rep> numeric_abs(Rep v) noexcept {
+    using U = numeric_unsigned_t<Rep>;
+    return v < 0 ? U(0) - U(v) : U(v);
+}
+
+/**
+ * Binary representation of `numeric`: base-10000 digits from the most significant
+ * one, the weight is the base-10000 exponent of the first digit.
+ */
+struct numeric_digits {
+    // 39 decimal digits of 128-bit value and the fraction part alignment
+    std::array<std::int16_t, 12> digits {};
+    std::int16_t ndigits = 0;
+    std::int16_t weight = 0;
+    std::uint16_t sign = numeric_pos;
+    std::uint16_t dscale = 0;
+};
+
+template <typename Rep>
+inline numeric_digits make_numeric_digits(const basic_numeric<Rep>& in) noexcept {
+    using U = numeric_unsigned_t<Rep>;
+    numeric_digits out;
+    out.dscale = in.scale();
+    U v = numeric_abs(in.unscaled());
+    if (v == 0) {
+        return out;
+    }
+    out.sign = in.unscaled() < 0 ? numeric_neg : numeric_pos;
+
+    // Digits are collected from the least significant one, the first one is aligned
+    // to the base-10000 digits boundary of the fraction part.
+    std::array<std::int16_t, 12> reversed {};
+    std::size_t n = 0;
+    int exponent = -((in.scale() + numeric_dec_digits - 1) / numeric_dec_digits);
+    if (const int f = in.scale() % numeric_dec_digits) {
+        U d = 1;
+        int padding = 1;
+        for (int i = 0; i < f; ++i) {
+            d *= 10;
+        }
+        for (int i = f; i < numeric_dec_digits; ++i) {
+            padding *= 10;
+        }
+        reversed[n++] = static_cast<std::int16_t>(static_cast<int>(v % d) * padding);
+        v /= d;
+    }
+    while (v != 0) {
+        reversed[n++] = static_cast<std::int16_t>(v % numeric_nbase);
+        v /= numeric_nbase;
+    }
+
+    std::size_t first = 0;
+    while (reversed[first] == 0) {
+        ++first;
+        ++exponent;
+    }
+    out.ndigits = static_cast<std::int16_t>(n - first);
+    out.weight = static_cast<std::int16_t>(exponent + out.ndigits - 1);
+    std::reverse_copy(reversed.begin() + first, reversed.begin() + n, out.digits.begin());
+    return out;
+}
+
+[[noreturn]] inline void throw_numeric_overflow() {
+    throw std::range_error("numeric value does not fit into the representation type");
+}
+
+/**
+ * Decodes base-10000 digits read by `next_digit()` into the unscaled value of the scale.
+ */
+template <typename Rep, typename NextDigit>
+inline basic_numeric<Rep> make_numeric(std::int16_t ndigits, std::int16_t weight, std::uint16_t sign,
+        std::uint16_t dscale, NextDigit&& next_digit) {
+    using U = numeric_unsigned_t<Rep>;
+    static_assert(sizeof(U) >= sizeof(std::uint64_t), "Rep should be at least 64-bit integer");
+
+    const bool negative = sign == numeric_neg;
+    const U max = numeric_max_abs<U>(negative);
+    // Decimal exponent of the last digit relative to the scale
+    int exponent = numeric_dec_digits * (weight - ndigits + 1) + dscale;
+
+    const auto make = [&] (U v) {
+        if (v > max) {
+            throw_numeric_overflow();
+        }
+        return basic_numeric<Rep>(negative ? static_cast<Rep>(U(0) - v) : static_cast<Rep>(v), dscale);
+    };
+
+    // Up to 4 base-10000 digits fit into 64 bits, so most of the values are
+    // decoded without wide arithmetic
+    std::uint64_t v64 = 0;
+    std::int16_t i = 0;
+    for (; i < ndigits && i < 4; ++i) {
+        v64 = v64 * numeric_nbase + next_digit();
+    }
+    if (i == ndigits) {
+        for (; exponent > 0 && v64 <= std::uint64_t(~std::uint64_t(0)) / 10; --exponent) {
+            v64 *= 10;
+        }
+        for (; exponent < 0 && v64 != 0; ++exponent) {
+            v64 /= 10;
+        }
+        if (exponent <= 0) {
+            return make(v64);
+        }
+    }
+
+    U v = v64;
+    for (; i < ndigits; ++i) {
+        const auto digit = next_digit();
+        if (v > (max - digit) / numeric_nbase) {
+            throw_numeric_overflow();
+        }
+        v = v * numeric_nbase + digit;
+    }
+    for (; exponent > 0; --exponent) {
+        if (v > max / 10) {
+            throw_numeric_overflow();
+        }
+        v *= 10;
+    }
+    for (; exponent < 0 && v != 0; ++exponent) {
+        v /= 10;
+    }
+    return make(v);
+}
+
+} // namespace detail
+
+template <typename Rep>
+std::string basic_numeric<Rep>::to_string() const {
+    auto v = detail::numeric_abs(unscaled_);
+    std::string out;
+    for (std::size_t n = 0; v != 0 || n <= scale_; ++n) {
+        if (n == scale_ && n != 0) {
+            out.push_back('.');
+        }
+        out.push_back(static_cast<char>('0' + static_cast<int>(v % 10)));
+        v /= 10;
+    }
+    if (unscaled_ < 0) {
+        out.push_back('-');
+    }
+    std::reverse(out.begin(), out.end());
+    return out;
+}
+
+} // namespace ozo::pg
+
+namespace ozo {
+
+template <typename Rep>
+struct size_of_impl<pg::basic_numeric<Rep>> {
+    static auto apply(const pg::basic_numeric<Rep>& v) noexcept {
+        return 8 + 2 * pg::detail::make_numeric_digits(v).ndigits;
+    }
+};
+
+template <typename Rep>
+struct send_impl<pg::basic_numeric<Rep>> {
+    template <typename OidMap>
+    static ostream& apply(ostream& out, const OidMap&, const pg::basic_numeric<Rep>& in) {
+        const auto v = pg::detail::make_numeric_digits(in);
+        write(out, v.ndigits);
+        write(out, v.weight);
+        write(out, v.sign);
+        write(out, v.dscale);
+        for (std::int16_t i = 0; i < v.ndigits; ++i) {
+            write(out, v.digits[static_cast<std::size_t>(i)]);
+        }
+        return out;
+    }
+};
+
+template <typename Rep>
+struct recv_impl<pg::basic_numeric<Rep>> {
+    template <typename OidMap>
+    static istream& apply(istream& in, size_type size, const OidMap&, pg::basic_numeric<Rep>& out) {
+        if (size < 8) {
+            throw std::range_error("data size " + std::to_string(size) + " is too small to read numeric");
+        }
+        std::int16_t ndigits = 0;
+        std::int16_t weight = 0;
+        std::uint16_t sign = 0;
+        std::uint16_t dscale = 0;
+        auto header = in.unchecked(8);
+        read(header, ndigits);
+        read(header, weight);
+        read(header, sign);
+        read(header, dscale);
+        if (ndigits < 0 || size != 8 + 2 * ndigits) {
+            throw std::range_error("data size " + std::to_string(size)
+                + " does not match numeric digits count " + std::to_string(ndigits));
+        }
+        if (sign != pg::detail::numeric_pos && sign != pg::detail::numeric_neg) {
+            throw std::range_error("numeric NaN or infinity can not be received");
+        }
+        auto digits = in.unchecked(2 * ndigits);
+        out = pg::detail::make_numeric<Rep>(ndigits, weight, sign, dscale, [&] {
+            std::int16_t digit = 0;
+            read(digits, digit);
+            if (digit < 0 || digit >= pg::detail::numeric_nbase) {
+                throw std::range_error("numeric digit " + std::to_string(digit) + " is out of range");
+            }
+            return static_cast<std::uint16_t>(digit);
+        });
+        return in;
+    }
+};
+
+/**
+ * Parses the decimal text representation, e.g. `-123.450`, the scale is the count of the
+ * fraction digits as for the binary representation.
+ */
+template <typename Rep>
+struct recv_text_impl<pg::basic_numeric<Rep>> {
+    static void apply(std::string_view in, pg::basic_numeric<Rep>& out) {
+        using U = pg::detail::numeric_unsigned_t<Rep>;
+        if (in == "NaN" || in == "Infinity" || in == "-Infinity") {
+            throw std::range_error("numeric NaN or infinity can not be received");
+        }
+        auto i = in.begin();
+        const bool negative = i != in.end() && *i == '-';
+        if (negative) {
+            ++i;
+        }
+        const U max = pg::detail::numeric_max_abs<U>(negative);
+        U v = 0;
+        std::size_t digits = 0;
+        std::uint16_t scale = 0;
+        bool point = false;
+        for (; i != in.end(); ++i) {
+            if (*i == '.' && !point) {
+                point = true;
+                continue;
+            }
+            if (*i < '0' || *i > '9') {
+                detail::throw_bad_text_value(in, typeid(pg::basic_numeric<Rep>));
+            }
+            const auto digit = static_cast<unsigned>(*i - '0');
+            if (v > (max - digit) / 10) {
+                pg::detail::throw_numeric_overflow();
+            }
+            v = v * 10 + digit;
+            ++digits;
+            scale += point;
+        }
+        if (digits == 0) {
+            detail::throw_bad_text_value(in, typeid(pg::basic_numeric<Rep>));
+        }
+        out = pg::basic_numeric<Rep>(negative ? static_cast<Rep>(U(0) - v) : static_cast<Rep>(v), scale);
+    }
+};
+
+} // namespace ozo
+
+namespace ozo::definitions {
+
+template <typename Rep>
+struct type<pg::basic_numeric<Rep>> : pg::type_definition<decltype("numeric"_s)>{};
+
+template <typename Rep>
+struct array<pg::basic_numeric<Rep>> : pg::array_definition<decltype("numeric"_s)>{};
+
+} // namespace ozo::definitions
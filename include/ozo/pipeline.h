@@ -0,0 +1,127 @@
+#pragma once
+
+#include <ozo/impl/async_pipeline.h>
+
+#ifdef LIBPQ_HAS_PIPELINING
+
+namespace ozo {
+
+/**
+ * @brief Creates a pipeline step
+ *
+ * Binds a query with an output for its result to be used as a step of `ozo::pipeline()`.
+ * The output has the same semantics as for `ozo::request()`. If no output is given the
+ * query result is checked for errors only like `ozo::execute()` does.
+ *
+ * @param query --- query object to execute
+ * @param out --- output object like Iterator, Container, etc.
+ * @return pipeline step object
+ * @ingroup group-requests-functions
+ */
+template <typename BinaryQueryConvertible, typename Out = none_t>
+constexpr auto pipelined(BinaryQueryConvertible&& query, Out out = Out{}) {
+    static_assert(ozo::BinaryQueryConvertible<BinaryQueryConvertible>,
+        "query should be convertible to the binary_query");
+    return impl::pipeline_step<std::decay_t<BinaryQueryConvertible>, Out> {
+        std::forward<BinaryQueryConvertible>(query), std::move(out)
+    };
+}
+
+#ifdef OZO_DOCUMENTATION
+/**
+ * @brief Executes several queries in one round trip using libpq pipeline mode
+ *
+ * The function gets a connection from the provider, switches it into the pipeline mode, sends all
+ * the queries followed by a synchronization point and receives results of the queries in the order
+ * they were sent. Each result is delivered into the output of its own step. The whole pipeline
+ * is executed as a single implicit transaction: in case of an error the server skips the rest of
+ * the queries and the operation completes with the first error occurred.
+ *
+ * Requires libpq 14 or later.
+ *
+ * @note The function does not particitate in ADL since could be implemented via functional object.
+ *
+ * @param provider --- connection provider object
+ * @param steps --- `boost::hana::tuple` of steps made by `ozo::pipelined()`
+ * @param time_constraint --- request #TimeConstraint; this time constrain <b>includes</b> time for getting connection from provider.
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ *
+ * ###Example
+ *
+ * @code
+ozo::rows_of<std::int64_t> ids;
+ozo::rows_of<std::string> names;
+
+ozo::pipeline(conn_info[io],
+    hana::make_tuple(
+        ozo::pipelined("SELECT id FROM users"_SQL, ozo::into(ids)),
+        ozo::pipelined("SELECT name FROM groups"_SQL, ozo::into(names)),
+        ozo::pipelined("UPDATE counters SET value = value + 1"_SQL)
+    ),
+    500ms,
+    yield);
+ * @endcode
+ */
+template <typename ConnectionProvider, typename Steps, typename TimeConstraint, typename CompletionToken>
+decltype(auto) pipeline(ConnectionProvider&& provider, Steps&& steps, TimeConstraint time_constraint, CompletionToken&& token);
+
+/**
+ * @brief Executes several queries in one round trip using libpq pipeline mode
+ *
+ * This function is time constrain free shortcut to `ozo::pipeline()` function.
+ * Its call is equal to `ozo::pipeline(provider, steps, ozo::none, token)` call.
+ *
+ * @note The function does not particitate in ADL since could be implemented via functional object.
+ *
+ * @param provider --- connection provider object
+ * @param steps --- `boost::hana::tuple` of steps made by `ozo::pipelined()`
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ */
+template <typename ConnectionProvider, typename Steps, typename CompletionToken>
+decltype(auto) pipeline(ConnectionProvider&& provider, Steps&& steps, CompletionToken&& token);
+#else
+
+template <typename Initiator>
+struct pipeline_op : base_async_operation <pipeline_op<Initiator>, Initiator> {
+    using base = typename pipeline_op::base;
+    using base::base;
+
+    template <typename P, typename Steps, typename TimeConstraint, typename CompletionToken>
+    decltype(auto) operator() (P&& provider, Steps&& steps, TimeConstraint t, CompletionToken&& token) const {
+        static_assert(ConnectionProvider<P>, "provider should be a ConnectionProvider");
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        return async_initiate<CompletionToken, handler_signature<P>>(
+            get_operation_initiator(*this), token, std::forward<P>(provider), t, std::forward<Steps>(steps));
+    }
+
+    template <typename P, typename Steps, typename CompletionToken>
+    decltype(auto) operator() (P&& provider, Steps&& steps, CompletionToken&& token) const {
+        return (*this)(std::forward<P>(provider), std::forward<Steps>(steps), none,
+            std::forward<CompletionToken>(token));
+    }
+
+    template <typename OtherInitiator>
+    constexpr static auto rebind_initiator(const OtherInitiator& other) {
+        return pipeline_op<OtherInitiator>{other};
+    }
+};
+
+namespace detail {
+struct initiate_async_pipeline {
+    template <typename Handler, typename P, typename Steps, typename TimeConstraint>
+    constexpr void operator()(Handler&& h, P&& provider, TimeConstraint t, Steps&& steps) const {
+        impl::async_pipeline(std::forward<P>(provider), std::forward<Steps>(steps), t, std::forward<Handler>(h));
+    }
+};
+} // namespace detail
+
+constexpr pipeline_op<detail::initiate_async_pipeline> pipeline;
+#endif
+
+} // namespace ozo
+
+#endif
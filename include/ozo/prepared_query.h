@@ -0,0 +1,110 @@
+#pragma once
+
+#include <ozo/io/binary_query.h>
+#include <ozo/detail/statement_key.h>
+
+namespace ozo {
+
+namespace detail {
+
+template <typename Text>
+struct query_text_statement_key {
+    static constexpr const statement_key* value = nullptr;
+};
+
+template <char ...c>
+struct query_text_statement_key<hana::string<c...>> {
+    static constexpr char text[] = {c..., '\0'};
+    static constexpr std::uint64_t id = statement_hash({text, sizeof...(c)}, statement_text_seed);
+    static constexpr const statement_key* value = std::addressof(static_statement_key<id>::value);
+};
+
+/**
+* Key of the statement for a query with the text known at compile time, e.g. made via
+* `ozo::query_builder` or `ozo::make_query()` with `boost::hana::string`, `nullptr` otherwise.
+*/
+template <typename Query>
+constexpr const statement_key* get_statement_key() noexcept {
+    if constexpr (ozo::Query<Query>) {
+        using text_type = std::decay_t<decltype(get_query_text(std::declval<const Query&>()))>;
+        return query_text_statement_key<text_type>::value;
+    } else {
+        return nullptr;
+    }
+}
+
+} // namespace detail
+
+/**
+ * @brief Query to be executed as a server side prepared statement
+ *
+ * Wrapper for a #BinaryQueryConvertible object which marks the query to be
+ * executed via prepared statement. The statement prepared for the query text is
+ * stored in the cache of the connection (see `ozo::get_statement_cache()`), so the
+ * server parses and plans the query once per connection. The first execution of the
+ * query on a connection prepares the statement and executes it in a single round
+ * trip via libpq pipeline mode. Least recently used statements are evicted from the
+ * cache and deallocated on the server with the next prepare.
+ *
+ * Statements are prepared and executed via the protocol level messages, and deallocated via
+ * the Close message if libpq supports it, so the queries are compatible with connection poolers
+ * in the transaction pooling mode, e.g. PgBouncer with prepared statements support. If the server
+ * reports a cached statement does not exist, e.g. the pooler has switched the server connection,
+ * the cache is cleared and the request is repeated with the statement prepared again, unless the
+ * connection is within a transaction.
+ *
+ * If the query text is known at compile time, e.g. the query is made via `ozo::query_builder`,
+ * the statement identifier and name are derived from the text at compile time, so the statement
+ * is found in the cache by the integer identifier and its name is passed to libpq as is.
+ *
+ * Use `ozo::prepared()` to make an object of the type.
+ *
+ * @tparam Query --- #BinaryQueryConvertible query type
+ * @ingroup group-query-types
+ * @models{BinaryQueryConvertible}
+ */
+template <typename Query>
+struct prepared_query {
+    Query query;
+    const detail::statement_key* statement = detail::get_statement_key<Query>(); //!< key of the statement, if it is known at compile time
+};
+
+template <typename T>
+struct is_prepared_query : std::false_type {};
+
+template <typename Query>
+struct is_prepared_query<prepared_query<Query>> : std::true_type {};
+
+//! @cond
+template <typename T>
+inline constexpr auto PreparedQuery = is_prepared_query<std::decay_t<T>>::value;
+//! @endcond
+
+/**
+ * @brief Marks query to be executed as a server side prepared statement
+ *
+ * @param query --- #BinaryQueryConvertible query object
+ * @return `ozo::prepared_query` object
+ *
+ * ###Example
+ *
+ * @code
+ozo::request(conn_info[io], ozo::prepared("SELECT id FROM users WHERE name = "_SQL + name), ozo::into(ids), yield);
+ * @endcode
+ * @ingroup group-query-functions
+ */
+template <typename Query>
+constexpr auto prepared(Query&& query) {
+    static_assert(BinaryQueryConvertible<Query>, "query should be convertible to the binary_query");
+    return prepared_query<std::decay_t<Query>>{std::forward<Query>(query)};
+}
+
+template <typename Query>
+struct to_binary_query_impl<prepared_query<Query>> {
+    template <typename OidMap, typename Alloc>
+    static binary_query apply(const prepared_query<Query>& query, const OidMap& oid_map, const Alloc& allocator) {
+        return to_binary_query(query.query, oid_map, allocator);
+    }
+};
+
+} // namespace ozo
@@ -0,0 +1,499 @@
+#pragma once
+
+#include <ozo/error.h>
+#include <ozo/result.h>
+#include <ozo/io/binary_query.h>
+#include <ozo/io/istream.h>
+#include <ozo/io/ostream.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @defgroup group-protocol Wire protocol
+ * @ingroup group-core
+ * @brief Codec of the PostgreSQL frontend/backend protocol version 3.
+ *
+ * The codec is the base of a connection implementation which speaks the protocol over
+ * Asio without libpq. The frontend messages are encoded into a contiguous buffer, e.g.
+ * the output buffer of a socket, the parameters of `ozo::binary_query` are written as
+ * they are. The backend messages are split in place in the input buffer, and the rows
+ * of `DataRow` messages are received straight from it via the same `ozo::recv_impl`
+ * machinery as the libpq results, see `ozo::protocol::rows`.
+ *
+ *@code
+#include <ozo/protocol.h>
+ *@endcode
+ */
+
+namespace ozo::protocol {
+
+/**
+ * @brief Protocol version 3.0 code of the `StartupMessage`
+ * @ingroup group-protocol
+ */
+constexpr std::int32_t version = 196608;
+
+/**
+ * @brief Type of a backend message
+ * @ingroup group-protocol
+ */
+enum class backend_message : char {
+    authentication = 'R',
+    backend_key_data = 'K',
+    bind_complete = '2',
+    close_complete = '3',
+    command_complete = 'C',
+    data_row = 'D',
+    empty_query_response = 'I',
+    error_response = 'E',
+    no_data = 'n',
+    notice_response = 'N',
+    notification_response = 'A',
+    parameter_description = 't',
+    parameter_status = 'S',
+    parse_complete = '1',
+    portal_suspended = 's',
+    ready_for_query = 'Z',
+    row_description = 'T',
+};
+
+/**
+ * @brief Backend message in the input buffer
+ *
+ * The message refers to the buffer memory and is valid while the buffer is not modified.
+ *
+ * @ingroup group-protocol
+ */
+struct message {
+    backend_message type; //!< type of the message
+    const char* data = nullptr; //!< contents of the message after the length
+    std::size_t size = 0; //!< size of the contents
+};
+
+namespace detail {
+
+inline void write_cstring(ostream& out, std::string_view v) {
+    out.write(v.data(), static_cast<std::streamsize>(v.size()));
+    out.put('\0');
+}
+
+/**
+ * Writes the type and a placeholder for the length of a message, the length is
+ * patched by `end_message()` with the position returned.
+ */
+inline std::size_t begin_message(ostream& out, char type) {
+    out.put(type);
+    const auto pos = out.tellp();
+    write(out, std::int32_t(0));
+    return pos;
+}
+
+inline void end_message(ostream& out, std::size_t pos) {
+    out.patch(pos, static_cast<std::int32_t>(out.tellp() - pos));
+}
+
+inline std::string_view read_cstring(istream& in, const char* end) {
+    const auto begin = in.peek(0);
+    const auto last = std::find(begin, end, '\0');
+    if (last == end) {
+        throw system_error(error::unexpected_eof, "unterminated string in the protocol message");
+    }
+    in.skip(last - begin + 1);
+    return {begin, static_cast<std::size_t>(last - begin)};
+}
+
+} // namespace detail
+
+/**
+ * @brief Write `StartupMessage`
+ *
+ * @param out --- output stream.
+ * @param params --- range of the pairs of the parameter name and value, e.g. `{{"user", "postgres"}, {"database", "db"}}`.
+ * @ingroup group-protocol
+ */
+template <typename Params>
+inline void write_startup(ostream& out, const Params& params) {
+    const auto pos = out.tellp();
+    write(out, std::int32_t(0));
+    write(out, version);
+    for (const auto& [name, value] : params) {
+        detail::write_cstring(out, name);
+        detail::write_cstring(out, value);
+    }
+    out.put('\0');
+    out.patch(pos, static_cast<std::int32_t>(out.tellp() - pos));
+}
+
+inline void write_startup(ostream& out, std::initializer_list<std::pair<std::string_view, std::string_view>> params) {
+    write_startup<decltype(params)>(out, params);
+}
+
+/**
+ * @brief Write `PasswordMessage` with the cleartext or the hashed password
+ * @ingroup group-protocol
+ */
+inline void write_password(ostream& out, std::string_view password) {
+    const auto pos = detail::begin_message(out, 'p');
+    detail::write_cstring(out, password);
+    detail::end_message(out, pos);
+}
+
+/**
+ * @brief Write `Query` of the simple query protocol
+ * @ingroup group-protocol
+ */
+inline void write_query(ostream& out, std::string_view text) {
+    const auto pos = detail::begin_message(out, 'Q');
+    detail::write_cstring(out, text);
+    detail::end_message(out, pos);
+}
+
+/**
+ * @brief Write `Parse` of the query with the parameters types
+ *
+ * @param out --- output stream.
+ * @param statement --- name of the prepared statement, empty for the unnamed one.
+ * @param query --- binary representation of the query, see `ozo::to_binary_query()`.
+ * @ingroup group-protocol
+ */
+template <typename BinaryQuery>
+inline void write_parse(ostream& out, std::string_view statement, const BinaryQuery& query) {
+    const auto pos = detail::begin_message(out, 'P');
+    detail::write_cstring(out, statement);
+    detail::write_cstring(out, query.text());
+    const auto count = static_cast<std::int16_t>(query.params_count());
+    write(out, count);
+    for (std::int16_t i = 0; i < count; ++i) {
+        write(out, static_cast<std::int32_t>(query.types()[i]));
+    }
+    detail::end_message(out, pos);
+}
+
+/**
+ * @brief Write `Bind` of the query parameters to the portal
+ *
+ * The parameters are written in the binary format as they are built by `ozo::binary_query`,
+ * the result columns are requested in the binary format.
+ *
+ * @param out --- output stream.
+ * @param portal --- name of the portal, empty for the unnamed one.
+ * @param statement --- name of the prepared statement, empty for the unnamed one.
+ * @param query --- binary representation of the query.
+ * @ingroup group-protocol
+ */
+template <typename BinaryQuery>
+inline void write_bind(ostream& out, std::string_view portal, std::string_view statement, const BinaryQuery& query) {
+    const auto pos = detail::begin_message(out, 'B');
+    detail::write_cstring(out, portal);
+    detail::write_cstring(out, statement);
+    const auto count = static_cast<std::int16_t>(query.params_count());
+    write(out, std::int16_t(1));
+    write(out, std::int16_t(impl::result_format::binary));
+    write(out, count);
+    for (std::int16_t i = 0; i < count; ++i) {
+        if (!query.values()[i]) {
+            write(out, std::int32_t(-1));
+            continue;
+        }
+        write(out, static_cast<std::int32_t>(query.lengths()[i]));
+        out.write(query.values()[i], query.lengths()[i]);
+    }
+    write(out, std::int16_t(1));
+    write(out, std::int16_t(impl::result_format::binary));
+    detail::end_message(out, pos);
+}
+
+/**
+ * @brief Write `Describe` of the portal
+ * @ingroup group-protocol
+ */
+inline void write_describe_portal(ostream& out, std::string_view portal) {
+    const auto pos = detail::begin_message(out, 'D');
+    out.put('P');
+    detail::write_cstring(out, portal);
+    detail::end_message(out, pos);
+}
+
+/**
+ * @brief Write `Execute` of the portal
+ *
+ * @param out --- output stream.
+ * @param portal --- name of the portal, empty for the unnamed one.
+ * @param max_rows --- maximum number of rows to return, `0` for no limit. If the portal has
+ *                     more rows the execution is completed with `backend_message::portal_suspended`
+ *                     and the next rows are returned by the next `Execute` of the portal.
+ * @ingroup group-protocol
+ */
+inline void write_execute(ostream& out, std::string_view portal, std::int32_t max_rows = 0) {
+    const auto pos = detail::begin_message(out, 'E');
+    detail::write_cstring(out, portal);
+    write(out, max_rows);
+    detail::end_message(out, pos);
+}
+
+/**
+ * @brief Write `Sync`
+ * @ingroup group-protocol
+ */
+inline void write_sync(ostream& out) {
+    detail::end_message(out, detail::begin_message(out, 'S'));
+}
+
+/**
+ * @brief Write `Flush`
+ * @ingroup group-protocol
+ */
+inline void write_flush(ostream& out) {
+    detail::end_message(out, detail::begin_message(out, 'H'));
+}
+
+/**
+ * @brief Write `Terminate`
+ * @ingroup group-protocol
+ */
+inline void write_terminate(ostream& out) {
+    detail::end_message(out, detail::begin_message(out, 'X'));
+}
+
+/**
+ * @brief Get the next complete backend message from the input buffer
+ *
+ * @param first --- beginning of the unprocessed input, advanced past the message returned.
+ * @param last --- end of the received input.
+ * @return the message or `std::nullopt` if the buffer does not contain the complete message yet.
+ * @throws ozo::system_error with `ozo::error::bad_object_size` if the message length is malformed.
+ * @ingroup group-protocol
+ */
+inline std::optional<message> next_message(const char*& first, const char* last) {
+    constexpr std::size_t header_size = 1 + sizeof(std::int32_t);
+    if (static_cast<std::size_t>(last - first) < header_size) {
+        return std::nullopt;
+    }
+    istream in(first + 1, sizeof(std::int32_t));
+    std::int32_t length = 0;
+    read(in, length);
+    if (length < std::int32_t(sizeof(std::int32_t))) {
+        throw system_error(error::bad_object_size, "protocol message length " + std::to_string(length));
+    }
+    const auto size = static_cast<std::size_t>(length) - sizeof(std::int32_t);
+    if (static_cast<std::size_t>(last - first) < header_size + size) {
+        return std::nullopt;
+    }
+    message result {static_cast<backend_message>(*first), first + header_size, size};
+    first += header_size + size;
+    return result;
+}
+
+/**
+ * @brief Field of `RowDescription`
+ * @ingroup group-protocol
+ */
+struct field_description {
+    std::string name; //!< name of the field
+    oid_t table = null_oid; //!< oid of the table, if the field is a table column
+    std::int16_t column = 0; //!< attribute number of the table column
+    oid_t type = null_oid; //!< oid of the field type
+    std::int16_t type_size = 0; //!< size of the type, negative for the variable length types
+    std::int32_t type_modifier = 0; //!< type modifier
+    impl::result_format format = impl::result_format::text; //!< format of the field values
+};
+
+/**
+ * @brief Status of `ReadyForQuery`
+ * @ingroup group-protocol
+ */
+enum class transaction_state : char {
+    idle = 'I', //!< not in a transaction block
+    in_transaction = 'T', //!< in a transaction block
+    failed = 'E', //!< in a failed transaction block
+};
+
+/**
+ * @brief Get the transaction state of `ReadyForQuery`
+ * @ingroup group-protocol
+ */
+inline transaction_state parse_ready_for_query(const message& msg) {
+    if (msg.size != 1) {
+        throw system_error(error::bad_object_size, "ReadyForQuery size " + std::to_string(msg.size));
+    }
+    return static_cast<transaction_state>(msg.data[0]);
+}
+
+/**
+ * @brief Get the tag of `CommandComplete`, e.g. `"SELECT 42"`
+ * @ingroup group-protocol
+ */
+inline std::string_view parse_command_complete(const message& msg) {
+    istream in(msg.data, msg.size);
+    return detail::read_cstring(in, msg.data + msg.size);
+}
+
+/**
+ * @brief Get the field of `ErrorResponse` or `NoticeResponse`
+ *
+ * @param msg --- the message.
+ * @param code --- code of the field, e.g. `'C'` for the SQLSTATE and `'M'` for the message.
+ * @return the field value, empty if there is no such field.
+ * @ingroup group-protocol
+ */
+inline std::string_view parse_error_field(const message& msg, char code) {
+    istream in(msg.data, msg.size);
+    const auto end = msg.data + msg.size;
+    for (auto p = in.peek(1); p && *p != '\0'; p = in.peek(1)) {
+        in.skip(1);
+        const auto value = detail::read_cstring(in, end);
+        if (*p == code) {
+            return value;
+        }
+    }
+    return {};
+}
+
+/**
+ * @brief Rows of a query received via `DataRow` messages
+ *
+ * The object keeps `RowDescription` of the query and the boundaries of the values of
+ * each row in the input buffer, the values are not copied. `ozo::basic_result` over a
+ * pointer to the object models the result of the query, so the rows are received via
+ * `ozo::recv_result()` and `ozo::recv_row()` with the column plans of the libpq results,
+ * straight from the buffer. The buffer should not be modified while the rows are used.
+ *
+ * ###Example
+ *
+ * @code
+ozo::protocol::rows rows;
+while (auto msg = ozo::protocol::next_message(first, last)) {
+    switch (msg->type) {
+        case ozo::protocol::backend_message::row_description: rows.describe(*msg); break;
+        case ozo::protocol::backend_message::data_row: rows.add(*msg); break;
+        ...
+    }
+}
+std::vector<user> users;
+ozo::recv_result(ozo::basic_result<const ozo::protocol::rows*>(&rows), oid_map, std::back_inserter(users));
+ * @endcode
+ * @ingroup group-protocol
+ */
+class rows {
+public:
+    /**
+     * Set the description of the rows from `RowDescription`, the rows received are cleared.
+     */
+    void describe(const message& msg) {
+        istream in(msg.data, msg.size);
+        const auto end = msg.data + msg.size;
+        std::int16_t count = 0;
+        read(in, count);
+        fields_.clear();
+        values_.clear();
+        rows_count_ = 0;
+        fields_.resize(static_cast<std::size_t>(std::max<std::int16_t>(count, 0)));
+        for (auto& field : fields_) {
+            field.name = std::string(detail::read_cstring(in, end));
+            std::int16_t format = 0;
+            read(in, field.table);
+            read(in, field.column);
+            read(in, field.type);
+            read(in, field.type_size);
+            read(in, field.type_modifier);
+            read(in, format);
+            field.format = static_cast<impl::result_format>(format);
+        }
+    }
+
+    /**
+     * Add a row from `DataRow`, only the boundaries of its values are stored.
+     */
+    void add(const message& msg) {
+        istream in(msg.data, msg.size);
+        std::int16_t count = 0;
+        read(in, count);
+        if (static_cast<std::size_t>(count) != fields_.size()) {
+            throw system_error(error::bad_row_size, "DataRow size " + std::to_string(count)
+                + " does not match RowDescription size " + std::to_string(fields_.size()));
+        }
+        for (std::int16_t i = 0; i < count; ++i) {
+            std::int32_t length = 0;
+            read(in, length);
+            const auto data = in.peek(std::max(length, 0));
+            if (!data) {
+                throw system_error(error::unexpected_eof, "DataRow value is out of the message");
+            }
+            values_.push_back({length < 0 ? nullptr : data, std::max(length, 0)});
+            in.skip(std::max(length, 0));
+        }
+        ++rows_count_;
+    }
+
+    /**
+     * Clear the rows keeping the description, e.g. after the rows of a suspended portal are received.
+     */
+    void clear() noexcept {
+        values_.clear();
+        rows_count_ = 0;
+    }
+
+    const std::vector<field_description>& fields() const noexcept { return fields_;} //!< description of the rows
+    std::size_t size() const noexcept { return rows_count_;} //!< number of the rows
+
+    friend oid_t pq_field_type(const rows& r, int column) noexcept {
+        return r.fields_[static_cast<std::size_t>(column)].type;
+    }
+
+    friend impl::result_format pq_field_format(const rows& r, int column) noexcept {
+        return r.fields_[static_cast<std::size_t>(column)].format;
+    }
+
+    friend const char* pq_get_value(const rows& r, int row, int column) noexcept {
+        const auto data = r.value(row, column).data;
+        return data ? data : "";
+    }
+
+    friend std::size_t pq_get_length(const rows& r, int row, int column) noexcept {
+        return static_cast<std::size_t>(r.value(row, column).length);
+    }
+
+    friend bool pq_get_isnull(const rows& r, int row, int column) noexcept {
+        return r.value(row, column).data == nullptr;
+    }
+
+    friend const char* pq_field_name(const rows& r, int column) noexcept {
+        return r.fields_[static_cast<std::size_t>(column)].name.c_str();
+    }
+
+    friend int pq_field_number(const rows& r, const char* name) noexcept {
+        const auto i = std::find_if(r.fields_.begin(), r.fields_.end(),
+            [&] (const auto& field) { return field.name == name; });
+        return i == r.fields_.end() ? -1 : static_cast<int>(i - r.fields_.begin());
+    }
+
+    friend int pq_nfields(const rows& r) noexcept {
+        return static_cast<int>(r.fields_.size());
+    }
+
+    friend int pq_ntuples(const rows& r) noexcept {
+        return static_cast<int>(r.rows_count_);
+    }
+
+private:
+    struct value_view {
+        const char* data;
+        std::int32_t length;
+    };
+
+    const value_view& value(int row, int column) const noexcept {
+        return values_[static_cast<std::size_t>(row) * fields_.size() + static_cast<std::size_t>(column)];
+    }
+
+    std::vector<field_description> fields_;
+    std::vector<value_view> values_;
+    std::size_t rows_count_ = 0;
+};
+
+} // namespace ozo::protocol
@@ -4,6 +4,10 @@
 #include <ozo/core/concept.h>
 #include <ozo/type_traits.h>
 
+#include <memory>
+#include <string>
+#include <string_view>
+
 /**
  * @defgroup group-query Queries
  * @brief Database queries related concepts, types and functions.
@@ -59,6 +63,57 @@ struct to_const_char_impl<const char*> {
     }
 };
 
+/**
+ * @brief Immutable query text shared by reference counting
+ *
+ * A query text built at run time is a `std::string`, and each `ozo::binary_query`
+ * made of a query with such a text copies it. A text made once as `shared_query_text`
+ * is never copied: copies of the text, of the queries and of their binary
+ * representations share it and only increment the reference counter. The text of
+ * `ozo::query_repository` queries is a `std::string_view` into the repository
+ * storage, so it needs no sharing.
+ *
+ * ### Example
+ *
+ * @code
+const ozo::shared_query_text text(build_report_sql(columns));
+for (const auto& [from, to] : periods) {
+    ozo::request(conn_info[io], ozo::make_query(text, from, to), ozo::into(res), yield);
+}
+ * @endcode
+ *
+ * @ingroup group-query-types
+ */
+class shared_query_text {
+public:
+    explicit shared_query_text(std::string text)
+    : text_(std::make_shared<const std::string>(std::move(text))) {}
+
+    const char* data() const noexcept { return text_->data();}
+
+    std::size_t size() const noexcept { return text_->size();}
+
+    std::string_view view() const noexcept { return *text_;}
+
+    friend bool operator ==(const shared_query_text& lhs, const shared_query_text& rhs) noexcept {
+        return lhs.view() == rhs.view();
+    }
+
+    friend bool operator !=(const shared_query_text& lhs, const shared_query_text& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+private:
+    std::shared_ptr<const std::string> text_;
+};
+
+template <>
+struct to_const_char_impl<shared_query_text> {
+    static const char* apply(const shared_query_text& v) noexcept {
+        return v.data();
+    }
+};
+
 #ifdef OZO_DOCUMENTATION
 /**
  * @brief Convert QueryText to const char*
@@ -69,6 +124,7 @@ struct to_const_char_impl<const char*> {
  * * `const char*`,
  * * `std::string`,
  * * `std::string_view`,
+ * * `ozo::shared_query_text`,
  * * `boost::hana::string`.
  *
  * ### Customization point
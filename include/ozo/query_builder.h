@@ -167,6 +167,35 @@ constexpr auto operator +(query_element<LhsValueT, LhsTagT>&& lhs, RhsValueT&& r
     return make_query_builder(hana::make_tuple(std::move(lhs), make_query_param(std::forward<RhsValueT>(rhs))));
 }
 
+/**
+ * @brief Membership test against an array parameter
+ *
+ * Builds `ANY($n)` with the values as a single array parameter, so a membership test
+ * is expressed as `column = ANY($n)` instead of an `IN ($1, ..., $k)` list with a
+ * parameter per value. The text of the query does not depend on the number of the values,
+ * so all the list sizes share a single prepared statement and its plan.
+ *
+ * ###Example
+ *
+ * @code
+const std::vector<std::int64_t> ids {1, 2, 3};
+ozo::request(conn_info[io], "SELECT name FROM users WHERE id = "_SQL + ozo::any_of(std::cref(ids)), ozo::into(res), yield);
+ * @endcode
+ *
+ * @param values --- `Array` of the values, e.g. `std::vector` or its `std::reference_wrapper`.
+ * @return `query_builder` with the `ANY($n)` text.
+ * @ingroup group-query-functions
+ */
+template <class T>
+constexpr auto any_of(T&& values) {
+    using namespace hana::literals;
+    return make_query_builder(hana::make_tuple(
+        make_query_text("ANY("_s),
+        make_query_param(std::forward<T>(values)),
+        make_query_text(")"_s)
+    ));
+}
+
 template <class ...Ts>
 struct get_query_text_impl<query_builder<Ts...>> {
     static constexpr decltype(auto) apply(const query_builder<Ts...>& q) noexcept {
@@ -1,9 +1,10 @@
 #pragma once
 
 #include <ozo/query.h>
+#include <ozo/prepared_query.h>
+#include <ozo/detail/mapped_file.h>
 
 #include <boost/algorithm/string/trim.hpp>
-#include <boost/fusion/algorithm/iteration/for_each.hpp>
 #include <boost/hana/concat.hpp>
 #include <boost/hana/core/to.hpp>
 #include <boost/hana/for_each.hpp>
@@ -16,13 +17,19 @@
 #include <boost/range/numeric.hpp>
 #include <boost/spirit/home/x3.hpp>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <filesystem>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
 #include <string_view>
 #include <tuple>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 
 namespace ozo {
 
@@ -57,13 +64,48 @@ struct typed_query_name<T, hana::when_valid<typename T::name_type>> {
     using type = typename T::name_type;
 };
 
+template <typename T, typename = hana::when<true>>
+struct typed_query_text {
+    using type = void;
+};
+
+template <typename T>
+using typed_query_text_t = typename typed_query_text<T>::type;
+
+template <typename T>
+struct typed_query_text<T, hana::when_valid<decltype(T::text)>> {
+    using type = std::decay_t<decltype(T::text)>;
+};
+
+template <typename T>
+struct typed_query_text<T, hana::when_valid<typename T::text_type>> {
+    using type = typename T::text_type;
+};
+
 template <typename T>
 struct typed_query_traits {
     using name_type = typename typed_query_name<T>::type;
     using parameters_type = typename T::parameters_type;
     using result_type = typename typed_query_result<T>::type;
+    using text_type = typename typed_query_text<T>::type;
 };
 
+/**
+ * Is the text of the query embedded into the query type as `boost::hana::string`
+ * `text` member, e.g.:
+ * @code
+struct get_user {
+    static constexpr auto name = "get user"_s;
+    static constexpr auto text = "SELECT * FROM users WHERE id = :id"_s;
+    using parameters_type = get_user_parameters;
+};
+ * @endcode
+ * Such a query needs no definition in a query conf, its parameters are substituted
+ * and checked at compile time.
+ */
+template <typename T>
+constexpr bool has_static_query_text = !std::is_void_v<typed_query_text_t<T>>;
+
 template <typename Query>
 constexpr typed_query_name_t<Query> get_raw_query_name(const Query&) noexcept {
     static_assert(!std::is_void_v<typed_query_name_t<Query>>, "Query class has no name type");
@@ -97,64 +139,6 @@ struct query_line_text {
 
 using query_line = boost::variant<query_line_comment, query_line_text>;
 
-struct to_string_visitor {
-    std::string& result;
-
-    template <class ... T>
-    void operator ()(const boost::fusion::deque<T ...>& value) {
-        boost::fusion::for_each(value, [&] (const auto& v) { (*this)(v); });
-    }
-
-    template <class ... T>
-    void operator ()(const boost::variant<T ...>& value) {
-        boost::apply_visitor(*this, value);
-    }
-
-    void operator ()(const std::string& value) {
-        result += value;
-    }
-};
-
-namespace lines_parser {
-
-using x3::char_;
-using x3::eoi;
-using x3::eol;
-using x3::lexeme;
-using x3::string;
-
-inline const x3::rule<class end, std::string> end("end");
-inline const x3::rule<class line, query_line> line("line");
-inline const x3::rule<class conf, std::vector<query_line>> conf("conf");
-
-inline const auto on_end = [] (const auto& ctx) {
-    boost::apply_visitor([&] (const auto& v) { x3::_val(ctx) = v; }, x3::_attr(ctx));
-};
-
-inline const auto on_comment = [] (const auto& ctx) {
-    std::string value;
-    to_string_visitor visitor {value};
-    visitor(x3::_attr(ctx));
-    x3::_val(ctx) = query_line_comment {std::move(value)};
-};
-
-inline const auto on_text = [] (const auto& ctx) {
-    std::string value;
-    to_string_visitor visitor {value};
-    visitor(x3::_attr(ctx));
-    x3::_val(ctx) = query_line_text {std::move(value)};
-};
-
-inline const auto end_def = lexeme[string("\r\n") | string("\r") | string("\n")][on_end];
-inline const auto line_def = lexeme[string("--") >> *(char_ - eol) >> (end | eoi)][on_comment]
-    | lexeme[*(char_ - eol) >> end][on_text]
-    | (lexeme[+(char_ - eol)][on_text] >> eoi);
-inline const auto conf_def = *line >> eoi;
-
-BOOST_SPIRIT_DEFINE(end, line, conf)
-
-} // namespace lines_parser
-
 namespace header_parser {
 
 using x3::char_;
@@ -189,40 +173,60 @@ struct query_parameter_name {
 
 using query_text_element = boost::variant<query_text_part, query_parameter_name>;
 
-namespace text_parser {
+constexpr bool is_query_parameter_name_char(char c) noexcept {
+    return c == '_' || ('0' <= c && c <= '9') || ('A' <= c && c <= 'Z') || ('a' <= c && c <= 'z');
+}
 
-using x3::char_;
-using x3::eoi;
-using x3::lexeme;
-using x3::lit;
-using x3::string;
+namespace text_parser {
 
 struct text_value {
     std::vector<query_text_element> text;
 };
 
-inline const x3::rule<class text_part, std::string> text_part("text_part");
-inline const x3::rule<class parameter_name, std::string> parameter_name("parameter_name");
-inline const x3::rule<class text, text_value> text("text");
-
-inline const auto on_text_part = [] (const auto& ctx) {
-    to_string_visitor visitor {x3::_val(ctx)};
-    visitor(x3::_attr(ctx));
-};
-
-inline const auto on_text = [] (const auto& ctx) {
-    x3::_val(ctx).text.push_back(query_text_part {x3::_attr(ctx)});
-};
-
-inline const auto on_parameter_name = [] (const auto& ctx) {
-    x3::_val(ctx).text.push_back(query_parameter_name {x3::_attr(ctx)});
-};
-
-inline const auto text_part_def = +lexeme[string("::") | string(":=") | +(char_ - char_(':') - char_('\0'))][on_text_part];
-inline const auto parameter_name_def = lit(':') >> lexeme[+char_("_0-9A-Za-z")];
-inline const auto text_def = *(parameter_name[on_parameter_name] | text_part[on_text]) >> eoi;
-
-BOOST_SPIRIT_DEFINE(text_part, parameter_name, text)
+/**
+ * Splits a line of the query text into the text parts and the `:name` parameters.
+ * `::` and `:=` are kept as text, any other `:` which is not followed by a name is
+ * an error. `\0` characters are skipped.
+ *
+ * @return `false` if the line is not valid.
+ */
+inline bool parse(std::string_view line, text_value& result) {
+    std::string part;
+    const auto flush = [&] {
+        if (!part.empty()) {
+            result.text.push_back(query_text_part {std::move(part)});
+            part.clear();
+        }
+    };
+    for (std::size_t i = 0; i < line.size();) {
+        if (line[i] == '\0') {
+            ++i;
+            continue;
+        }
+        if (line[i] != ':') {
+            const auto stop = std::min(line.find_first_of(std::string_view(":\0", 2), i), line.size());
+            part.append(line.data() + i, stop - i);
+            i = stop;
+            continue;
+        }
+        const auto name = line.find_first_not_of('\0', i + 1);
+        if (name != std::string_view::npos && is_query_parameter_name_char(line[name])) {
+            flush();
+            i = name;
+            while (i < line.size() && is_query_parameter_name_char(line[i])) {
+                ++i;
+            }
+            result.text.push_back(query_parameter_name {std::string(line.substr(name, i - name))});
+        } else if (i + 1 < line.size() && (line[i + 1] == ':' || line[i + 1] == '=')) {
+            part.append(line.data() + i, 2);
+            i += 2;
+        } else {
+            return false;
+        }
+    }
+    flush();
+    return true;
+}
 
 } // namespace text_parser
 
@@ -266,7 +270,6 @@ public:
 
 private:
     state_type state = state_type::initial;
-    std::string text_value;
     std::vector<parsed_query> queries;
 
     void parse_header(const query_line_comment& comment) {
@@ -279,20 +282,39 @@ private:
 
     void parse_text(const query_line_text& text) {
         text_parser::text_value parsed_text;
-        if (!x3::phrase_parse(text.value.begin(), text.value.end(), text_parser::text, x3::lit('\0'), parsed_text)) {
+        if (!text_parser::parse(text.value, parsed_text)) {
             throw std::invalid_argument("Failed to parse query text: " + queries.back().name);
         }
         queries.back().text.insert(queries.back().text.end(), std::make_move_iterator(parsed_text.text.begin()),
                                    std::make_move_iterator(parsed_text.text.end()));
-        text_value.clear();
     }
 };
 
+/**
+ * Splits the query conf into lines, each one keeps its end of line. A line starting
+ * with `--` is a comment. `\0` characters before a line are skipped. Lines are split
+ * by a plain scan, since a grammar costs too much for a large query conf.
+ */
 template <class ForwardIteratorT>
-std::vector<query_line> parse_query_conf_lines(const ForwardIteratorT begin, const ForwardIteratorT end) {
+std::vector<query_line> parse_query_conf_lines(ForwardIteratorT begin, const ForwardIteratorT end) {
+    const auto is_end_char = [] (char c) { return c == '\r' || c == '\n'; };
     std::vector<query_line> result;
-    if (!x3::phrase_parse(begin, end, lines_parser::conf, x3::char_('\0'), result)) {
-        throw std::invalid_argument("Failed to parse query conf lines");
+    while (true) {
+        begin = std::find_if(begin, end, [] (char c) { return c != '\0'; });
+        if (begin == end) {
+            break;
+        }
+        auto next = std::find_if(begin, end, is_end_char);
+        if (next != end && *next++ == '\r' && next != end && *next == '\n') {
+            ++next;
+        }
+        std::string value(begin, next);
+        if (value.compare(0, 2, "--") == 0) {
+            result.emplace_back(query_line_comment {std::move(value)});
+        } else {
+            result.emplace_back(query_line_text {std::move(value)});
+        }
+        begin = next;
     }
     return result;
 }
@@ -340,8 +362,10 @@ inline std::unordered_set<std::string_view> check_for_duplicates(const std::vect
 template <class ... QueriesT>
 void check_for_undefined(const hana::tuple<QueriesT ...>& declarations, const std::unordered_set<std::string_view>& definitions) {
     hana::for_each(declarations, [&] (const auto& query) {
-        if (!definitions.count(get_query_name(query))) {
-            throw std::invalid_argument(hana::to<const char*>("Query is not defined in query conf: "_s + get_raw_query_name(query)));
+        if constexpr (!has_static_query_text<std::decay_t<decltype(query)>>) {
+            if (!definitions.count(get_query_name(query))) {
+                throw std::invalid_argument(hana::to<const char*>("Query is not defined in query conf: "_s + get_raw_query_name(query)));
+            }
         }
     });
 }
@@ -402,6 +426,168 @@ private:
     detail::query_description& query_description;
 };
 
+enum class static_query_text_status {
+    ok,
+    unknown_parameter,
+    invalid_colon,
+};
+
+constexpr bool is_query_text_space(char c) noexcept {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+template <std::size_t N>
+struct static_query_parameter_names {
+    std::array<std::string_view, N> names;
+
+    constexpr std::size_t find(std::string_view name) const noexcept {
+        for (std::size_t i = 0; i < N; ++i) {
+            if (names[i] == name) {
+                return i;
+            }
+        }
+        return std::string_view::npos;
+    }
+};
+
+template <std::size_t N>
+struct static_query_parameter_numbers {
+    constexpr std::size_t find(std::string_view name) const noexcept {
+        std::size_t number = 0;
+        for (const char c : name) {
+            if (c < '0' || c > '9') {
+                return std::string_view::npos;
+            }
+            number = number * 10 + static_cast<std::size_t>(c - '0');
+            if (number >= N) {
+                return std::string_view::npos;
+            }
+        }
+        return number;
+    }
+};
+
+template <class ParametersT>
+constexpr auto make_static_query_parameter_names() {
+    if constexpr (HasMembers<ParametersT>) {
+        return hana::unpack(hana::transform(hana::accessors<ParametersT>(), hana::first), [] (auto ... keys) {
+            return static_query_parameter_names<sizeof ... (keys)> {{
+                std::string_view(hana::to<const char*>(keys), hana::size(keys)) ...
+            }};
+        });
+    } else {
+        return static_query_parameter_numbers<std::tuple_size_v<ParametersT>> {};
+    }
+}
+
+struct static_query_text_size {
+    std::size_t size = 0;
+
+    constexpr void put(char) noexcept { ++size; }
+};
+
+template <std::size_t N>
+struct static_query_text_buffer {
+    std::array<char, N + 1> value {};
+    std::size_t size = 0;
+
+    constexpr void put(char c) noexcept { value[size++] = c; }
+};
+
+/**
+ * Compile-time counterpart of the query text parsing and `query_part_visitor`: writes
+ * the trimmed text with the named parameters replaced by libpq placeholders into the sink.
+ */
+template <class NamesT, class SinkT>
+constexpr static_query_text_status render_static_query_text(std::string_view text, const NamesT& names, SinkT& sink) {
+    std::size_t begin = 0;
+    std::size_t end = text.size();
+    while (begin < end && is_query_text_space(text[begin])) {
+        ++begin;
+    }
+    while (end > begin && is_query_text_space(text[end - 1])) {
+        --end;
+    }
+    for (std::size_t i = begin; i < end;) {
+        if (text[i] != ':') {
+            sink.put(text[i++]);
+            continue;
+        }
+        if (i + 1 < end && (text[i + 1] == ':' || text[i + 1] == '=')) {
+            sink.put(text[i]);
+            sink.put(text[i + 1]);
+            i += 2;
+            continue;
+        }
+        std::size_t name_end = i + 1;
+        while (name_end < end && is_query_parameter_name_char(text[name_end])) {
+            ++name_end;
+        }
+        if (name_end == i + 1) {
+            return static_query_text_status::invalid_colon;
+        }
+        const auto number = names.find(text.substr(i + 1, name_end - i - 1));
+        if (number == std::string_view::npos) {
+            return static_query_text_status::unknown_parameter;
+        }
+        std::array<char, 20> digits {};
+        std::size_t digits_count = 0;
+        for (auto v = number + 1; v > 0; v /= 10) {
+            digits[digits_count++] = static_cast<char>('0' + v % 10);
+        }
+        sink.put('$');
+        while (digits_count > 0) {
+            sink.put(digits[--digits_count]);
+        }
+        i = name_end;
+    }
+    return static_query_text_status::ok;
+}
+
+template <class QueryT>
+constexpr std::string_view get_static_query_source() noexcept {
+    using text_type = typed_query_text_t<QueryT>;
+    static_assert(HanaString<text_type>, "Query class text type should be boost::hana::string");
+    return std::string_view(hana::to<const char*>(text_type {}), hana::size(text_type {}));
+}
+
+template <class QueryT>
+constexpr auto measure_static_query_text() {
+    static_query_text_size sink;
+    const auto status = render_static_query_text(get_static_query_source<QueryT>(),
+        make_static_query_parameter_names<typename typed_query_traits<QueryT>::parameters_type>(), sink);
+    return std::make_pair(status, sink.size);
+}
+
+template <std::size_t N, class QueryT>
+constexpr auto make_static_query_text() {
+    static_query_text_buffer<N> sink;
+    render_static_query_text(get_static_query_source<QueryT>(),
+        make_static_query_parameter_names<typename typed_query_traits<QueryT>::parameters_type>(), sink);
+    return sink.value;
+}
+
+template <class QueryT>
+struct static_query_text {
+    static constexpr static_query_text_status status = measure_static_query_text<QueryT>().first;
+    static constexpr std::size_t size = measure_static_query_text<QueryT>().second;
+    static constexpr std::array<char, size + 1> value = make_static_query_text<size, QueryT>();
+};
+
+/**
+ * Text of the query with embedded text, see `ozo::has_static_query_text`. Fails to
+ * compile if the text refers a parameter which is not declared by the query.
+ */
+template <class QueryT>
+constexpr std::string_view get_static_query_text() noexcept {
+    using text = static_query_text<QueryT>;
+    static_assert(text::status != static_query_text_status::unknown_parameter,
+        "Query text has a parameter which is not found in the query parameters type");
+    static_assert(text::status != static_query_text_status::invalid_colon,
+        "Query text has ':' which is neither a parameter nor a part of '::' or ':='");
+    return std::string_view(text::value.data(), text::size);
+}
+
 template <class QueryT>
 query_description make_query_description(const QueryT& query, const parsed_query& parsed) {
     query_description result;
@@ -414,28 +600,57 @@ query_description make_query_description(const QueryT& query, const parsed_query
     return result;
 }
 
+/**
+ * Declared queries indexed by name, so a parsed query finds its declaration by
+ * a single lookup instead of comparing its name with the names of all of them.
+ */
 template <class ... QueriesT>
-ozo::detail::query_description make_query_description(const hana::tuple<QueriesT ...>& queries,
-                                                      const parsed_query& parsed) {
-    boost::optional<ozo::detail::query_description> opt_query_description;
-    hana::for_each(queries, [&] (const auto& query) {
-        if (get_query_name(query) == parsed.name) {
-            opt_query_description = make_query_description(query, parsed);
+class query_declarations {
+public:
+    query_declarations() : query_declarations(std::index_sequence_for<QueriesT ...>()) {}
+
+    ozo::detail::query_description make_description(const hana::tuple<QueriesT ...>& queries,
+                                                    const parsed_query& parsed) const {
+        const auto found = index.find(parsed.name);
+        if (found == index.end()) {
+            throw std::invalid_argument("Query is not declared: " + parsed.name);
         }
-    });
-    if (!opt_query_description) {
-        throw std::invalid_argument("Query is not declared: " + parsed.name);
+        return found->second(queries, parsed);
     }
-    return *opt_query_description;
+
+private:
+    using make_description_type = ozo::detail::query_description (*)(const hana::tuple<QueriesT ...>&,
+                                                                     const parsed_query&);
+
+    std::unordered_map<std::string_view, make_description_type> index;
+
+    template <std::size_t ... I>
+    explicit query_declarations(std::index_sequence<I ...>) {
+        index.reserve(sizeof ... (QueriesT));
+        (index.emplace(get_query_name(QueriesT {}), &make_declared_description<I>), ...);
+    }
+
+    template <std::size_t I>
+    static ozo::detail::query_description make_declared_description(const hana::tuple<QueriesT ...>& queries,
+                                                                    const parsed_query& parsed) {
+        return make_query_description(hana::at_c<I>(queries), parsed);
+    }
+};
+
+template <class ... QueriesT>
+ozo::detail::query_description make_query_description(const hana::tuple<QueriesT ...>& queries,
+                                                      const parsed_query& parsed) {
+    return query_declarations<QueriesT ...>().make_description(queries, parsed);
 }
 
 template <class ... QueriesT>
 std::vector<ozo::detail::query_description> make_query_descriptions(const hana::tuple<QueriesT ...>& queries,
         const std::vector<parsed_query>& parsed) {
+    const query_declarations<QueriesT ...> declarations;
     std::vector<ozo::detail::query_description> result;
     result.reserve(parsed.size());
     boost::transform(parsed, std::back_inserter(result),
-        [&] (const auto& v) { return make_query_description(queries, v); });
+        [&] (const auto& v) { return declarations.make_description(queries, v); });
     return result;
 }
 
@@ -456,24 +671,138 @@ inline std::shared_ptr<query_conf> make_query_conf(std::vector<ozo::detail::quer
     return result;
 }
 
+template <class ForwardIteratorT, class ... QueriesT>
+std::shared_ptr<query_conf> make_query_conf(ForwardIteratorT begin, ForwardIteratorT end,
+                                            const hana::tuple<QueriesT ...>& queries) {
+    check_for_duplicates(queries);
+    const auto parsed = parse_query_conf(begin, end);
+    check_for_undefined(queries, check_for_duplicates(parsed));
+    return make_query_conf(make_query_descriptions(queries, parsed));
+}
+
+/**
+ * Parses the query conf file in place from its memory mapping.
+ */
+template <class ... QueriesT>
+std::shared_ptr<query_conf> make_query_conf(const std::filesystem::path& path,
+                                            const hana::tuple<QueriesT ...>& queries) {
+    const mapped_file file(path);
+    const auto text = file.data();
+    return make_query_conf(text.begin(), text.end(), queries);
+}
+
+/**
+ * Query conf of a repository with the texts of the declared queries in the order
+ * of the declaration, so `make_query()` needs no hashing of the query name.
+ */
+template <std::size_t N>
+struct query_repository_snapshot {
+    std::shared_ptr<query_conf> conf;
+    std::array<std::string_view, N> slots;
+};
+
+/**
+ * Current snapshot of a repository. Readers load the snapshot with no lock and no
+ * reference counting, a reload publishes a new one. The published snapshots are
+ * never freed before the state, because the made queries refer their texts, and
+ * reloads are expected to be rare.
+ */
+template <std::size_t N>
+class query_repository_state {
+public:
+    using snapshot_type = query_repository_snapshot<N>;
+
+    const snapshot_type* load() const noexcept {
+        return current_.load(std::memory_order_acquire);
+    }
+
+    void store(snapshot_type snapshot) {
+        const std::lock_guard<std::mutex> lock(mutex_);
+        snapshots_.push_back(std::make_unique<const snapshot_type>(std::move(snapshot)));
+        current_.store(snapshots_.back().get(), std::memory_order_release);
+    }
+
+private:
+    std::atomic<const snapshot_type*> current_ {nullptr};
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<const snapshot_type>> snapshots_;
+};
+
+/**
+ * Key of the prepared statement for the typed query derived from the query name,
+ * the text of the query is checked by the statement cache since it may be reloaded.
+ */
+template <class QueryT>
+constexpr const statement_key* get_typed_statement_key() noexcept {
+    using name_type = typed_query_name_t<QueryT>;
+    constexpr auto id = statement_hash(std::string_view(hana::to<const char*>(name_type {}), hana::size(name_type {})),
+        statement_name_seed);
+    return std::addressof(static_statement_key<id>::value);
+}
+
 } // namespace detail
 
 template <class ... QueriesT>
 class query_repository {
 public:
-    query_repository() = default;
+    query_repository()
+        : state(std::make_shared<state_type>()) {}
 
     query_repository(std::shared_ptr<detail::query_conf> query_conf)
-        : query_conf(std::move(query_conf)) {}
+        : query_repository() {
+        reload(std::move(query_conf));
+    }
 
     bool is_initialized() const noexcept {
-        return query_conf != nullptr;
+        const auto snapshot = state->load();
+        return snapshot != nullptr && snapshot->conf != nullptr;
     }
 
     operator bool() const noexcept {
         return is_initialized();
     }
 
+    /**
+     * Replaces the query conf of the repository and of all its copies. Concurrent
+     * `make_query()` calls are not blocked and return queries either with the
+     * previous or with the new texts. The texts of the previous query conf remain
+     * valid until the last copy of the repository is destroyed, so the queries made
+     * before the reload may still be in flight.
+     *
+     * The prepared statements are cached by the query text, so the statements of the
+     * changed queries are not used anymore and are evicted from the cache.
+     */
+    void reload(std::shared_ptr<detail::query_conf> query_conf) {
+        snapshot_type snapshot {std::move(query_conf), {}};
+        if (snapshot.conf) {
+            std::size_t index = 0;
+            ((snapshot.slots[index++] = find_text<QueriesT>(*snapshot.conf)), ...);
+        }
+        state->store(std::move(snapshot));
+    }
+
+    /**
+     * Parses the query conf and replaces the query conf of the repository with it,
+     * see `reload(std::shared_ptr<detail::query_conf>)`. The repository is not changed
+     * if the query conf is not valid and the exception is thrown.
+     */
+    template <class ForwardIteratorT>
+    void reload(ForwardIteratorT begin, ForwardIteratorT end) {
+        reload(detail::make_query_conf(begin, end, hana::tuple<QueriesT ...>()));
+    }
+
+    template <class ForwardIteratorRangeT>
+    void reload(const ForwardIteratorRangeT& range) {
+        reload(std::begin(range), std::end(range));
+    }
+
+    /**
+     * Parses the query conf file and replaces the query conf of the repository with it.
+     */
+    void reload(const std::filesystem::path& path) {
+        reload(detail::make_query_conf(path, hana::tuple<QueriesT ...>()));
+    }
+
     template <class QueryT>
     auto make_query() const {
         return ozo::make_query(get_description<QueryT>());
@@ -521,22 +850,64 @@ public:
         }
     }
 
+    /**
+     * Makes the query to be executed as a server side prepared statement, see `ozo::prepared()`.
+     * The identifier and the name of the statement are derived from the query name at compile
+     * time, so the statement is found in the cache of the connection with no hashing of the text.
+     */
+    template <class QueryT, class ... ParametersT>
+    auto make_prepared_query(ParametersT&& ... parameters) const {
+        auto query = make_query<QueryT>(std::forward<ParametersT>(parameters) ...);
+        return prepared_query<decltype(query)> {std::move(query), detail::get_typed_statement_key<QueryT>()};
+    }
+
 private:
-    std::shared_ptr<detail::query_conf> query_conf;
+    using snapshot_type = detail::query_repository_snapshot<sizeof ... (QueriesT)>;
+    using state_type = detail::query_repository_state<sizeof ... (QueriesT)>;
+
+    // Shared by the copies, so a reload is seen by all of them.
+    std::shared_ptr<state_type> state;
 
     template <class QueryT>
-    decltype(auto) get_description() const {
-        return query_conf->queries.at(get_query_name(std::get<QueryT>(std::tuple<QueriesT ...>())));
+    static constexpr std::size_t slot_index() noexcept {
+        std::size_t result = sizeof ... (QueriesT);
+        std::size_t index = 0;
+        ((result = (result == sizeof ... (QueriesT) && std::is_same_v<QueryT, QueriesT>) ? index : result, ++index), ...);
+        return result;
+    }
+
+    template <class QueryT>
+    static std::string_view find_text(const detail::query_conf& query_conf) {
+        if constexpr (!has_static_query_text<QueryT>) {
+            const auto found = query_conf.queries.find(get_query_name(QueryT {}));
+            if (found != query_conf.queries.end()) {
+                return found->second;
+            }
+        }
+        return {};
+    }
+
+    template <class QueryT>
+    std::string_view get_description() const {
+        if constexpr (has_static_query_text<QueryT>) {
+            return detail::get_static_query_text<QueryT>();
+        } else {
+            static_assert(slot_index<QueryT>() < sizeof ... (QueriesT), "Query is not declared in the repository");
+            const auto snapshot = state->load();
+            const auto text = snapshot ? snapshot->slots[slot_index<QueryT>()] : std::string_view();
+            if (text.data() == nullptr) {
+                throw std::out_of_range(hana::to<const char*>("Query is not defined in query conf: "_s
+                    + get_raw_query_name(QueryT {})));
+            }
+            return text;
+        }
     }
 };
 
 template <class ForwardIteratorT, class ... QueriesT>
 auto make_query_repository(ForwardIteratorT begin, ForwardIteratorT end,
                            const hana::tuple<QueriesT ...>& queries = hana::tuple<QueriesT ...>()) {
-    detail::check_for_duplicates(queries);
-    const auto parsed = detail::parse_query_conf(begin, end);
-    detail::check_for_undefined(queries, detail::check_for_duplicates(parsed));
-    return query_repository<QueriesT ...>(detail::make_query_conf(detail::make_query_descriptions(queries, parsed)));
+    return query_repository<QueriesT ...>(detail::make_query_conf(begin, end, queries));
 }
 
 template <class ForwardIteratorRangeT, class ... QueriesT>
@@ -545,4 +916,14 @@ auto make_query_repository(const ForwardIteratorRangeT& range,
     return make_query_repository(std::begin(range), std::end(range), queries);
 }
 
+/**
+ * Makes the repository from the query conf file. The file is memory mapped and
+ * parsed in place, so a large query conf is not copied into a string first.
+ */
+template <class ... QueriesT>
+auto make_query_repository(const std::filesystem::path& path,
+                           const hana::tuple<QueriesT ...>& queries = hana::tuple<QueriesT ...>()) {
+    return query_repository<QueriesT ...>(detail::make_query_conf(path, queries));
+}
+
 } // namespace ozo
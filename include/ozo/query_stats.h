@@ -0,0 +1,310 @@
+#pragma once
+
+#include <ozo/asio.h>
+#include <ozo/connection_statistics.h>
+#include <ozo/error.h>
+#include <ozo/query_conf.h>
+#include <ozo/core/histogram.h>
+#include <ozo/time_traits.h>
+
+#include <boost/asio/associated_allocator.hpp>
+#include <boost/asio/associated_executor.hpp>
+#include <boost/asio/async_result.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @defgroup group-query-stats Query statistics
+ * @ingroup group-core
+ * @brief Client side latency of the queries aggregated by the query name.
+ *
+ * The server side statistics, e.g. `pg_stat_statements`, do not account the time a request
+ * spends on the client: waiting for a connection of the pool, sending the query and decoding
+ * the results. `ozo::query_stats` collects the number of requests, the number of failed ones
+ * and the latency histogram for each query of a `query_repository`, the latency is measured
+ * from the initiation of the operation to the completion handler invocation. The CPU time of
+ * the query serialization and the results decoding is collected too, see `ozo::request_cpu_time`.
+ *
+ *@code
+#include <ozo/query_stats.h>
+ *@endcode
+ */
+
+namespace ozo {
+
+/**
+ * @brief Statistics of a query
+ *
+ * An item of the `ozo::query_stats::snapshot()` result.
+ *
+ * @ingroup group-query-stats
+ */
+struct query_statistics {
+    std::string_view name; //!< name of the query, see `ozo::get_query_name()`
+    std::uint64_t requests = 0; //!< number of completed requests
+    std::uint64_t errors = 0; //!< number of requests completed with an error
+    latency_histogram latency {}; //!< requests latency distribution
+    time_traits::duration serialization_cpu {}; //!< total CPU time of the query serialization
+    time_traits::duration decoding_cpu {}; //!< total CPU time of the results decoding
+};
+
+namespace detail {
+
+/**
+ * Index of the current thread used to choose its bucket of the statistics.
+ * Threads get consecutive indexes in order of their first request.
+ */
+inline std::size_t this_thread_stats_index() noexcept {
+    static std::atomic<std::size_t> next {0};
+    static thread_local const std::size_t index = next.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+struct query_stats_counters {
+    std::atomic<std::uint64_t> requests {0};
+    std::atomic<std::uint64_t> errors {0};
+    atomic_latency_histogram latency;
+    std::atomic<time_traits::duration::rep> serialization_cpu {0};
+    std::atomic<time_traits::duration::rep> decoding_cpu {0};
+};
+
+template <std::size_t QueriesCount>
+struct alignas(64) query_stats_bucket {
+    std::array<query_stats_counters, QueriesCount> queries;
+};
+
+} // namespace detail
+
+/**
+ * @brief Aggregator of the client side statistics of the queries
+ *
+ * Each thread updates its own bucket of counters placed in separate cache lines, so
+ * the threads do not contend with each other and the update takes no locks. If there
+ * are more threads than buckets some of them share a bucket, which is still correct
+ * since the counters are atomic. The `snapshot()` sums up the buckets and may be
+ * called from any thread.
+ *
+ * Use `ozo::bind_query_stats()` to collect statistics of a request.
+ *
+ * @tparam QueriesT --- query types of the `query_repository`, each one should have a name.
+ * @ingroup group-query-stats
+ */
+template <class ... QueriesT>
+class query_stats {
+public:
+    static constexpr std::size_t queries_count = sizeof ... (QueriesT); //!< number of queries
+
+    /**
+     * @param buckets --- number of buckets, the number of threads running the requests is
+     *                    the best value. The number of hardware threads by default.
+     */
+    explicit query_stats(std::size_t buckets = std::thread::hardware_concurrency())
+    : buckets_(std::max<std::size_t>(buckets, 1)) {}
+
+    query_stats(const query_stats&) = delete;
+    query_stats& operator =(const query_stats&) = delete;
+
+    /**
+     * Account a completed request of the query.
+     *
+     * @tparam QueryT --- query type.
+     * @param latency --- time from the initiation of the request to its completion.
+     * @param failed --- `true` if the request completed with an error.
+     */
+    template <class QueryT>
+    void update(time_traits::duration latency, bool failed) noexcept {
+        static_assert(index_of<QueryT>() < queries_count, "Query is not declared in the statistics");
+        auto& counters = buckets_[detail::this_thread_stats_index() % buckets_.size()].queries[index_of<QueryT>()];
+        counters.requests.fetch_add(1, std::memory_order_relaxed);
+        if (failed) {
+            counters.errors.fetch_add(1, std::memory_order_relaxed);
+        }
+        counters.latency.add(latency);
+    }
+
+    /**
+     * Account the CPU time of a request of the query.
+     *
+     * @tparam QueryT --- query type.
+     * @param cpu_time --- CPU time of the request.
+     */
+    template <class QueryT>
+    void update(const request_cpu_time& cpu_time) noexcept {
+        static_assert(index_of<QueryT>() < queries_count, "Query is not declared in the statistics");
+        auto& counters = buckets_[detail::this_thread_stats_index() % buckets_.size()].queries[index_of<QueryT>()];
+        counters.serialization_cpu.fetch_add(cpu_time.serialization.count(), std::memory_order_relaxed);
+        counters.decoding_cpu.fetch_add(cpu_time.decoding.count(), std::memory_order_relaxed);
+    }
+
+    /**
+     * Get statistics of the query.
+     *
+     * @tparam QueryT --- query type.
+     */
+    template <class QueryT>
+    query_statistics get() const noexcept {
+        static_assert(index_of<QueryT>() < queries_count, "Query is not declared in the statistics");
+        return collect(index_of<QueryT>(), get_query_name(QueryT {}));
+    }
+
+    /**
+     * Get statistics of all the queries in order of the declaration.
+     */
+    std::array<query_statistics, queries_count> snapshot() const noexcept {
+        return snapshot(std::index_sequence_for<QueriesT ...>());
+    }
+
+private:
+    std::vector<detail::query_stats_bucket<queries_count>> buckets_;
+
+    template <class QueryT>
+    static constexpr std::size_t index_of() noexcept {
+        std::size_t result = queries_count;
+        std::size_t index = 0;
+        ((result = (result == queries_count && std::is_same_v<QueryT, QueriesT>) ? index : result, ++index), ...);
+        return result;
+    }
+
+    query_statistics collect(std::size_t i, std::string_view name) const noexcept {
+        query_statistics result {name};
+        for (const auto& bucket : buckets_) {
+            const auto& counters = bucket.queries[i];
+            result.requests += counters.requests.load(std::memory_order_relaxed);
+            result.errors += counters.errors.load(std::memory_order_relaxed);
+            result.latency += counters.latency.snapshot();
+            result.serialization_cpu += time_traits::duration(counters.serialization_cpu.load(std::memory_order_relaxed));
+            result.decoding_cpu += time_traits::duration(counters.decoding_cpu.load(std::memory_order_relaxed));
+        }
+        return result;
+    }
+
+    template <std::size_t ... I>
+    std::array<query_statistics, queries_count> snapshot(std::index_sequence<I ...>) const noexcept {
+        return {collect(I, get_query_name(QueriesT {})) ...};
+    }
+};
+
+/**
+ * @brief Completion token with the bound query statistics
+ *
+ * Use `ozo::bind_query_stats()` to make an object of the type.
+ *
+ * @tparam QueryT --- query type.
+ * @tparam Stats --- `ozo::query_stats` specialization.
+ * @tparam Token --- underlying completion token type.
+ * @ingroup group-query-stats
+ */
+template <class QueryT, typename Stats, typename Token>
+struct query_stats_token {
+    Token token_;
+    Stats* stats_;
+};
+
+/**
+ * @brief Completion handler which accounts the request in the query statistics
+ *
+ * Measures the time from its construction at the operation initiation to its
+ * invocation and forwards the calls, the associated executor and allocator of the
+ * underlying handler. The request operation reports its CPU time via the
+ * `request_cpu_time_observer()` of the handler.
+ *
+ * @tparam QueryT --- query type.
+ * @tparam Stats --- `ozo::query_stats` specialization.
+ * @tparam Handler --- underlying completion handler type.
+ * @ingroup group-query-stats
+ */
+template <class QueryT, typename Stats, typename Handler>
+struct query_stats_handler {
+    Handler handler_;
+    Stats* stats_;
+    time_traits::time_point start_ = time_traits::now();
+
+    template <typename Token>
+    query_stats_handler(query_stats_token<QueryT, Stats, Token>&& token)
+    : handler_(std::move(token.token_)), stats_(token.stats_) {}
+
+    template <typename Token>
+    query_stats_handler(query_stats_token<QueryT, Stats, Token>& token)
+    : handler_(token.token_), stats_(token.stats_) {}
+
+    template <typename ...Args>
+    void operator() (error_code ec, Args&& ...args) {
+        stats_->template update<QueryT>(time_traits::now() - start_, bool(ec));
+        handler_(std::move(ec), std::forward<Args>(args)...);
+    }
+
+    ozo::request_cpu_time_observer request_cpu_time_observer() const noexcept {
+        return {stats_, [] (void* stats, const request_cpu_time& v) noexcept {
+            static_cast<Stats*>(stats)->template update<QueryT>(v);
+        }};
+    }
+
+    using executor_type = asio::associated_executor_t<Handler>;
+
+    executor_type get_executor() const noexcept { return asio::get_associated_executor(handler_);}
+
+    using allocator_type = asio::associated_allocator_t<Handler>;
+
+    allocator_type get_allocator() const noexcept { return asio::get_associated_allocator(handler_);}
+};
+
+/**
+ * @brief Binds query statistics to a completion token
+ *
+ * The request initiated with the returned token is accounted in the statistics of the
+ * query when it completes.
+ *
+ * @tparam QueryT --- query type the request is made of.
+ * @param stats --- statistics of the queries, should outlive the operation.
+ * @param token --- completion token, e.g. a callback, `boost::asio::yield_context`
+ *                  or `boost::asio::use_future`.
+ * @return `ozo::query_stats_token` --- completion token with the bound statistics.
+ *
+ * ###Example
+ *
+ * @code
+ozo::query_stats<get_user, update_user> stats;
+const auto query = repository.make_query<get_user>(get_user::parameters_type {42});
+ozo::request(pool[io], query, ozo::into(res), ozo::bind_query_stats<get_user>(stats, yield));
+for (const auto& v : stats.snapshot()) {
+    std::cout << v.name << ": " << v.requests << " requests, p99 " << v.latency.quantile(0.99).count() << std::endl;
+}
+ * @endcode
+ * @ingroup group-query-stats
+ */
+template <class QueryT, typename Stats, typename Token>
+inline auto bind_query_stats(Stats& stats, Token&& token) {
+    return query_stats_token<QueryT, Stats, std::decay_t<Token>>{std::forward<Token>(token), std::addressof(stats)};
+}
+
+} // namespace ozo
+
+namespace boost::asio {
+
+template <class QueryT, typename Stats, typename Token, typename Signature>
+class async_result<ozo::query_stats_token<QueryT, Stats, Token>, Signature> {
+    using target_type = async_result<Token, Signature>;
+
+public:
+    using completion_handler_type = ozo::query_stats_handler<QueryT, Stats,
+        typename target_type::completion_handler_type>;
+    using return_type = typename target_type::return_type;
+
+    explicit async_result(completion_handler_type& h) : target_(h.handler_) {}
+
+    return_type get() { return target_.get();}
+
+private:
+    target_type target_;
+};
+
+} // namespace boost::asio
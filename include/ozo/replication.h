@@ -0,0 +1,119 @@
+#pragma once
+
+#include <ozo/impl/async_replication.h>
+
+namespace ozo {
+
+#ifdef OZO_DOCUMENTATION
+/**
+ * @brief Consumes a logical replication stream
+ *
+ * Executes `START_REPLICATION SLOT ... LOGICAL` for the slot of the configuration and receives
+ * the changes via the COPY BOTH protocol, e.g. for change data capture. The connection should be
+ * a replication one, i.e. made with the `replication=database` connection string parameter, and
+ * the slot should exist, e.g. created with `pg_create_logical_replication_slot()`.
+ *
+ * Each time new data is received all the available XLogData messages are passed to the message
+ * handler by batches of `replication_config::max_batch_size` messages at most. The handler is
+ * called with `const std::vector<ozo::xlog_data>&` argument. The messages are not copied: their
+ * data refers to the buffers received by libpq, which are released once the handler returns, so
+ * the handler should copy or decode the data it keeps. If the handler returns a value convertible
+ * to `bool`, the stream is stopped as soon as the handler returns `false` and the operation
+ * completes successfully. Otherwise the operation lasts until the server ends the stream, the
+ * time constraint expires, the connection is closed or an error occurs.
+ *
+ * The standby status update with the received and the flushed positions is sent when the server
+ * requests it and at least each `replication_config::status_interval` while the stream is active.
+ * The flushed position is the start of the last message of the last batch the handler has returned
+ * for, as `pg_recvlogical` reports, or the end of the log of a server keepalive when nothing is
+ * pending. If `replication_config::progress` is set the position confirmed via it is reported
+ * instead, so the server keeps the log which has not been processed yet.
+ *
+ * @param provider --- connection provider object of replication connections.
+ * @param config --- replication stream configuration.
+ * @param time_constraint --- operation #TimeConstraint; this time constrain <b>includes</b> time for getting connection from provider.
+ * @param message_handler --- callable with `void(const std::vector<ozo::xlog_data>&)` or `bool(const std::vector<ozo::xlog_data>&)` signature.
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ *
+ * ###Example
+ *
+ * @code
+ozo::connection_info<> conn_info("dbname=db replication=database");
+ozo::replication_config config;
+config.slot = "cdc";
+config.options = {{"proto_version", "1"}, {"publication_names", "cdc"}};
+ozo::start_replication(conn_info[io], config,
+    [&] (const std::vector<ozo::xlog_data>& batch) {
+        for (const auto& message : batch) {
+            decoder.decode(message.data);
+        }
+    },
+    yield);
+ * @endcode
+ */
+template <typename ConnectionProvider, typename TimeConstraint, typename MessageHandler, typename CompletionToken>
+decltype(auto) start_replication(ConnectionProvider&& provider, replication_config config, TimeConstraint time_constraint, MessageHandler&& message_handler, CompletionToken&& token);
+
+/**
+ * @brief Consumes a logical replication stream
+ *
+ * This function is time constrain free shortcut to `ozo::start_replication()` function.
+ * Its call is equal to `ozo::start_replication(provider, config, ozo::none, message_handler, token)` call.
+ *
+ * @param provider --- connection provider object of replication connections.
+ * @param config --- replication stream configuration.
+ * @param message_handler --- callable with `void(const std::vector<ozo::xlog_data>&)` or `bool(const std::vector<ozo::xlog_data>&)` signature.
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ */
+template <typename ConnectionProvider, typename MessageHandler, typename CompletionToken>
+decltype(auto) start_replication(ConnectionProvider&& provider, replication_config config, MessageHandler&& message_handler, CompletionToken&& token);
+#else
+
+template <typename Initiator>
+struct start_replication_op : base_async_operation <start_replication_op<Initiator>, Initiator> {
+    using base = typename start_replication_op::base;
+    using base::base;
+
+    template <typename P, typename TimeConstraint, typename MessageHandler, typename CompletionToken>
+    decltype(auto) operator() (P&& provider, replication_config config, TimeConstraint t,
+            MessageHandler&& message_handler, CompletionToken&& token) const {
+        static_assert(ConnectionProvider<P>, "provider should be a ConnectionProvider");
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        return async_initiate<CompletionToken, handler_signature<P>>(
+            get_operation_initiator(*this), token, std::forward<P>(provider), std::move(config), t,
+            std::forward<MessageHandler>(message_handler));
+    }
+
+    template <typename P, typename MessageHandler, typename CompletionToken>
+    decltype(auto) operator()(P&& provider, replication_config config, MessageHandler&& message_handler,
+            CompletionToken&& token) const {
+        return (*this)(std::forward<P>(provider), std::move(config), none,
+            std::forward<MessageHandler>(message_handler), std::forward<CompletionToken>(token));
+    }
+
+    template <typename OtherInitiator>
+    constexpr static auto rebind_initiator(const OtherInitiator& other) {
+        return start_replication_op<OtherInitiator>{other};
+    }
+};
+
+namespace detail {
+struct initiate_async_start_replication {
+    template <typename Handler, typename P, typename TimeConstraint, typename MessageHandler>
+    constexpr void operator()(Handler&& h, P&& p, replication_config config, TimeConstraint t,
+            MessageHandler&& message_handler) const {
+        impl::async_start_replication(std::forward<P>(p), std::move(config), t,
+            std::forward<MessageHandler>(message_handler), std::forward<Handler>(h));
+    }
+};
+} // namespace detail
+
+constexpr start_replication_op<detail::initiate_async_start_replication> start_replication;
+
+#endif
+
+} // namespace ozo
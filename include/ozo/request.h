@@ -1,15 +1,60 @@
 #pragma once
 
 #include <ozo/impl/async_request.h>
+#include <ozo/impl/parallel_result.h>
 
 namespace ozo {
+
+/**
+ * @brief Output for `ozo::request()` which receives a result by parallel partitions
+ *
+ * Creates an output which receives rows of a result into a random access container with
+ * `resize()` member function, e.g. `std::vector`, by partitions of `partition_size` rows
+ * on the given executor, e.g. of a `boost::asio::thread_pool`. So a large result does not
+ * block the connection's `io_context` while it is being received. The request completes
+ * once all the partitions have been received. Results with no more than `partition_size`
+ * rows are received in place. Received rows are appended to the container.
+ *
+ * @note The container must not be accessed until the request is complete. In case of
+ * a row processing error the operation completes with `ozo::error::bad_result_process`
+ * and the container contents is unspecified.
+ *
+ * @param rows --- container to receive rows into.
+ * @param executor --- executor to receive partitions on.
+ * @param partition_size --- number of rows in a partition, should be greater than 0.
+ * @return output object
+ * @ingroup group-requests-functions
+ *
+ * ###Example
+ *
+ * @code
+boost::asio::thread_pool pool;
+ozo::rows_of<std::int64_t, std::string> rows;
+ozo::request(conn_info[io], "SELECT id, name FROM users"_SQL,
+    ozo::parallel_into(rows, pool.get_executor(), 50000), yield);
+ * @endcode
+ */
+template <typename Container, typename Executor>
+inline auto parallel_into(Container& rows, const Executor& executor, std::size_t partition_size = 10000) {
+    return impl::parallel_out_handler<Container, Executor> {std::ref(rows), executor, partition_size};
+}
+
 #ifdef OZO_DOCUMENTATION
 /**
  * @brief Executes query and retrives a result from a database with time constraint
  *
  * The function sends request to a database and provides result via out parameter. The function can
  * be called as any of Boost.Asio asynchronous function with #CompletionToken. The request would be
- * cancelled if time constrain is reached while performing.
+ * cancelled if time constrain is reached while performing. With Boost 1.77 or newer the request is also
+ * cancelled via the cancellation slot associated with the completion handler, e.g. by
+ * `boost::asio::experimental::parallel_group` or awaitable operators, with `boost::asio::error::operation_aborted`:
+ * a request waiting for the result has IO on the connection cancelled without a timer. A request waiting
+ * for a connection of `ozo::connection_pool` is removed from the queue only if the pool admits requests
+ * via its own deadline queue, i.e. with `connection_pool_config::order_by_deadline`,
+ * `connection_pool_config::priority_classes` or `connection_pool_config::max_capacity`. The queue
+ * of the underlying resource pool, which is used otherwise, does not support cancellation, so such
+ * a request waits there until it gets a connection or the time constraint expires, and the cancellation
+ * emitted meanwhile is lost.
  *
  * @note The function does not participate in ADL since could be implemented via functional object.
  *
@@ -147,7 +147,7 @@ public:
         void decrement() noexcept { advance(-1); }
         void advance(int n) noexcept { v_.col += n; }
 
-        int distance_to(const const_iterator& z) noexcept { return z.col - v_.col; }
+        int distance_to(const const_iterator& z) const noexcept { return z.v_.col - v_.col; }
 
         coordinates v_ {nullptr, 0, 0};
 
@@ -301,7 +301,7 @@ public:
         void decrement() noexcept { advance(-1); }
         void advance(int n) noexcept { v_.row += n; }
 
-        int distance_to(const const_iterator& z) noexcept { return z.row - v_.row; }
+        int distance_to(const const_iterator& z) const noexcept { return z.v_.row - v_.row; }
 
         coordinates v_ {nullptr, 0, 0};
 
@@ -443,6 +443,67 @@ using shared_result = basic_result<pg::shared_result>;
  */
 using result = basic_result<pg::result>;
 
+/**
+ * @brief Rows which borrow data from the result they are received from
+ *
+ * The container keeps the `ozo::basic_result` alive together with the rows received
+ * from it, so the rows may contain view types which point into the result memory
+ * without copying, e.g. `std::string_view`, `ozo::pg::bytea_view` or `ozo::pg::jsonb_view`.
+ * The views stay valid while the container is alive, including after it is moved.
+ * Use `ozo::into()` to receive a result into the container.
+ *
+ * ### Example
+ *
+ * @code
+ozo::borrowed_rows<std::tuple<std::int64_t, ozo::pg::jsonb_view>> rows;
+ozo::request(conn_info[io], "SELECT id, doc FROM documents"_SQL, ozo::into(rows), yield);
+for (const auto& [id, doc] : rows) {
+    reply.write(doc.raw_string());
+}
+ * @endcode
+ *
+ * @tparam Row --- row type, may contain view types.
+ * @tparam T --- underlying native result handler type, in common case `ozo::pg::result`.
+ * @ingroup group-requests-types
+ */
+template <typename Row, typename T = pg::result>
+class borrowed_rows {
+public:
+    using result_type = basic_result<T>;
+    using container_type = std::vector<Row>;
+    using value_type = Row;
+    using const_iterator = typename container_type::const_iterator;
+    using iterator = const_iterator;
+
+    borrowed_rows() = default;
+
+    /**
+     * Replaces the content with the rows received from the result.
+     *
+     * @param res --- result the rows point into.
+     * @param rows --- rows received from the result.
+     */
+    void assign(result_type res, container_type rows) {
+        rows_ = std::move(rows);
+        result_ = std::move(res);
+    }
+
+    const_iterator begin() const noexcept { return rows_.begin(); }
+    const_iterator end() const noexcept { return rows_.end(); }
+    std::size_t size() const noexcept { return rows_.size(); }
+    [[nodiscard]] bool empty() const noexcept { return rows_.empty(); }
+    const Row& operator[] (std::size_t i) const noexcept { return rows_[i]; }
+
+    /**
+     * Get the result the rows point into.
+     */
+    const result_type& get_result() const noexcept { return result_; }
+
+private:
+    result_type result_;
+    container_type rows_;
+};
+
 template <typename T>
 auto make_result(T&& handle) {
     return ozo::basic_result<std::decay_t<T>>(std::forward<T>(handle));
@@ -0,0 +1,288 @@
+#pragma once
+
+#include <ozo/single_flight.h>
+#include <ozo/time_traits.h>
+
+#include <libpq-fe.h>
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace ozo {
+
+/**
+ * @brief Result cache configuration
+ * @ingroup group-requests-types
+ */
+struct result_cache_config {
+    std::size_t max_bytes = 64 * 1024 * 1024; //!< limit of the memory of the cached results
+    time_traits::duration ttl = std::chrono::seconds(60); //!< time a result is served from the cache for
+};
+
+/**
+ * @brief Result cache metrics
+ * @ingroup group-requests-types
+ */
+struct result_cache_metrics {
+    std::size_t entries = 0; //!< number of the cached results
+    std::size_t bytes = 0; //!< memory of the cached results
+    std::uint64_t hits = 0; //!< number of the requests served from the cache
+    std::uint64_t misses = 0; //!< number of the requests which have not found a result in the cache
+    std::uint64_t evictions = 0; //!< number of the results evicted to fit the memory limit
+};
+
+namespace detail {
+
+/**
+* LRU cache of the results by the query key. Each result expires after the TTL,
+* the least recently used results are evicted to fit the memory limit. A result
+* may be tagged to be invalidated with the other results of the tag.
+*/
+class result_cache_state {
+public:
+    explicit result_cache_state(const result_cache_config& config) : config_(config) {}
+
+    std::optional<shared_result> find(const std::string& key, time_traits::time_point now) {
+        const std::lock_guard lock(mutex_);
+        const auto i = index_.find(key);
+        if (i == index_.end()) {
+            ++metrics_.misses;
+            return std::nullopt;
+        }
+        if (i->second->expires <= now) {
+            erase(i->second);
+            ++metrics_.misses;
+            return std::nullopt;
+        }
+        entries_.splice(entries_.begin(), entries_, i->second);
+        ++metrics_.hits;
+        return i->second->result;
+    }
+
+    void insert(const std::string& key, std::string tag, shared_result result, time_traits::time_point now) {
+        const auto bytes = key.size() + result_size(result);
+        const std::lock_guard lock(mutex_);
+        if (const auto i = index_.find(key); i != index_.end()) {
+            erase(i->second);
+        }
+        if (bytes > config_.max_bytes) {
+            return;
+        }
+        while (metrics_.bytes + bytes > config_.max_bytes) {
+            erase(std::prev(entries_.end()));
+            ++metrics_.evictions;
+        }
+        entries_.push_front(entry{key, std::move(tag), std::move(result), now + config_.ttl, bytes});
+        index_.emplace(key, entries_.begin());
+        metrics_.bytes += bytes;
+        ++metrics_.entries;
+    }
+
+    void invalidate(std::string_view tag) {
+        const std::lock_guard lock(mutex_);
+        for (auto i = entries_.begin(); i != entries_.end();) {
+            const auto current = i++;
+            if (current->tag == tag) {
+                erase(current);
+            }
+        }
+    }
+
+    void clear() {
+        const std::lock_guard lock(mutex_);
+        index_.clear();
+        entries_.clear();
+        metrics_.bytes = 0;
+        metrics_.entries = 0;
+    }
+
+    result_cache_metrics metrics() const {
+        const std::lock_guard lock(mutex_);
+        return metrics_;
+    }
+
+private:
+    struct entry {
+        std::string key;
+        std::string tag;
+        shared_result result;
+        time_traits::time_point expires;
+        std::size_t bytes;
+    };
+
+    using iterator = std::list<entry>::iterator;
+
+    static std::size_t result_size(const shared_result& result) noexcept {
+        return result.valid() ? PQresultMemorySize(result.native_handle()) : 0;
+    }
+
+    void erase(iterator i) {
+        metrics_.bytes -= i->bytes;
+        --metrics_.entries;
+        index_.erase(i->key);
+        entries_.erase(i);
+    }
+
+    mutable std::mutex mutex_;
+    result_cache_config config_;
+    std::list<entry> entries_;
+    std::unordered_map<std::string, iterator> index_;
+    result_cache_metrics metrics_;
+};
+
+struct result_cache_handler {
+    std::shared_ptr<result_cache_state> cache_;
+    std::shared_ptr<single_flight_state> flights_;
+    std::string key_;
+    std::string tag_;
+    std::shared_ptr<result> result_;
+
+    template <typename Connection>
+    void operator() (error_code ec, Connection&&) {
+        shared_result res(pg::shared_result(result_->release()));
+        if (!ec) {
+            cache_->insert(key_, std::move(tag_), res, time_traits::now());
+        }
+        flights_->finish(key_, std::move(ec), std::move(res));
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief Client side cache of the request results
+ *
+ * Serves the results of the requests which are made often and return the same data, e.g.
+ * of reference data, from memory. A request is keyed by the query text and its serialized
+ * parameters. A result found in the cache is provided to the handler with no connection
+ * used; otherwise the query is executed, and its successful result is cached for the TTL.
+ * Concurrent requests of a key which is not cached execute the query once, see
+ * `ozo::single_flight`. The memory of the cached results is limited, the least recently
+ * used results are evicted to fit it.
+ *
+ * A result may be cached with a tag, e.g. the name of the table it depends on, to invalidate
+ * it before it expires with the rest of the results of the tag, e.g. on a notification.
+ *
+ * The raw result is provided as `ozo::shared_result`, which is shared by all the requests
+ * of the key, so it should not be modified; rows may be received from it with
+ * `ozo::recv_result()`. The key does not include the database, so use a cache per database.
+ *
+ * The object may be used from many threads simultaneously.
+ *
+ * ###Example
+ *
+ * @code
+ozo::result_cache cache(io);
+
+ozo::listen(listen_conn_info[io], std::vector<std::string> {"cache_invalidation"},
+    [&] (std::vector<ozo::notification> batch) {
+        for (const auto& v : batch) {
+            cache.invalidate(v.payload);
+        }
+    },
+    [] (ozo::error_code, auto) {});
+
+auto res = cache.request(pool[io], "countries", "SELECT code, name FROM countries"_SQL, 100ms, yield[ec]);
+ozo::rows_of<std::string, std::string> countries;
+ozo::recv_result(res, ozo::empty_oid_map{}, std::back_inserter(countries));
+ * @endcode
+ *
+ * @ingroup group-requests-types
+ */
+class result_cache {
+public:
+    /**
+     * @brief Construct a new result cache object
+     *
+     * @param io --- `io_context` to complete the requests on if the handler has no associated executor.
+     * @param config --- cache configuration.
+     */
+    explicit result_cache(io_context& io, const result_cache_config& config = {})
+    : io_(io), cache_(std::make_shared<detail::result_cache_state>(config)),
+      flights_(std::make_shared<detail::single_flight_state>()) {}
+
+    /**
+     * @brief Provides the cached result or executes the query and caches its result
+     *
+     * @param provider --- connection provider object, used on a cache miss only.
+     * @param tag --- tag to invalidate the result with.
+     * @param query --- query object to request from a database.
+     * @param t --- request #TimeConstraint; this time constrain <b>includes</b> time for getting connection from provider.
+     * @param token --- operation #CompletionToken with `void(ozo::error_code, ozo::shared_result)` signature.
+     * @return deduced from #CompletionToken.
+     */
+    template <typename P, typename Q, typename TimeConstraint, typename CompletionToken>
+    decltype(auto) request(P&& provider, std::string tag, Q&& query, TimeConstraint t, CompletionToken&& token) {
+        static_assert(ConnectionProvider<P>, "provider should be a ConnectionProvider");
+        static_assert(BinaryQueryConvertible<Q>, "query should be convertible to the binary_query");
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        return async_initiate<CompletionToken, void(error_code, shared_result)>(
+            [this] (auto&& handler, auto&& provider, std::string tag, auto&& query, TimeConstraint t) {
+                using handler_type = std::decay_t<decltype(handler)>;
+                using waiter_type = detail::single_flight_waiter_impl<handler_type, io_context::executor_type>;
+                using oid_map_type = detail::single_flight_oid_map<decltype(provider)>;
+
+                auto binary_query = to_binary_query(query, oid_map_type{});
+                auto key = detail::make_query_key(binary_query);
+                waiter_type waiter(std::forward<decltype(handler)>(handler), io_.get_executor());
+                if (auto cached = cache_->find(key, time_traits::now())) {
+                    return waiter.complete(error_code{}, *cached);
+                }
+                if (!flights_->join(key, std::make_unique<waiter_type>(std::move(waiter)))) {
+                    return;
+                }
+
+                auto res = std::make_shared<result>();
+                detail::result_cache_handler cache_handler{cache_, flights_, std::move(key), std::move(tag), res};
+                if constexpr (std::is_same_v<oid_map_type, empty_oid_map>) {
+                    ozo::request(std::forward<decltype(provider)>(provider), std::move(binary_query), t,
+                        std::ref(*res), std::move(cache_handler));
+                } else {
+                    ozo::request(std::forward<decltype(provider)>(provider), std::forward<decltype(query)>(query), t,
+                        std::ref(*res), std::move(cache_handler));
+                }
+            },
+            token, std::forward<P>(provider), std::move(tag), std::forward<Q>(query), t);
+    }
+
+    /**
+     * @brief Provides the cached result or executes the query and caches its result
+     *
+     * Shortcut to `request(provider, "", query, t, token)`, the result has no tag.
+     */
+    template <typename P, typename Q, typename TimeConstraint, typename CompletionToken>
+    decltype(auto) request(P&& provider, Q&& query, TimeConstraint t, CompletionToken&& token) {
+        return request(std::forward<P>(provider), std::string{}, std::forward<Q>(query), t,
+            std::forward<CompletionToken>(token));
+    }
+
+    /**
+     * Removes the results cached with the tag.
+     */
+    void invalidate(std::string_view tag) { cache_->invalidate(tag);}
+
+    /**
+     * Removes all the cached results.
+     */
+    void clear() { cache_->clear();}
+
+    /**
+     * Get snapshot of the cache counters.
+     *
+     * @return result_cache_metrics --- counters.
+     */
+    result_cache_metrics metrics() const { return cache_->metrics();}
+
+private:
+    io_context& io_;
+    std::shared_ptr<detail::result_cache_state> cache_;
+    std::shared_ptr<detail::single_flight_state> flights_;
+};
+
+} // namespace ozo
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <ozo/pg/handle.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace ozo {
+
+/**
+ * @brief Result reclaimer configuration
+ * @ingroup group-requests-types
+ */
+struct result_reclaimer_config {
+    std::size_t min_size = 1024 * 1024; //!< results which take less memory are freed in place
+    std::size_t queue_limit = 1024; //!< maximum number of results waiting for the reclaimer, the rest are freed in place
+};
+
+/**
+ * @brief Result reclaimer metrics
+ * @ingroup group-requests-types
+ */
+struct result_reclaimer_metrics {
+    std::size_t queued = 0; //!< number of results waiting for the reclaimer
+    std::uint64_t reclaimed = 0; //!< number of results freed by the reclaimer
+    std::uint64_t reclaimed_bytes = 0; //!< memory of the results freed by the reclaimer
+    std::uint64_t overflows = 0; //!< number of large results freed in place since the queue was full
+};
+
+/**
+ * @brief Frees large results on a background thread
+ *
+ * A result is freed via `PQclear()` wherever its last owner is destroyed, which is
+ * often the io thread right after the handler. Freeing a result of a hundred megabytes
+ * takes milliseconds, and the rest of the connections of the thread wait for that time.
+ * While the reclaimer exists the results which take at least the configured memory
+ * are handed over to its thread instead: the release pushes the result into a lock-free
+ * queue and returns, the thread frees the queued results. Smaller results are freed in
+ * place since handing them over costs more than freeing them. If the thread falls behind
+ * and the queue is full, the results are freed in place as well.
+ *
+ * The reclaimer applies to all the results of the process, so create at most one,
+ * before the io threads start, and destroy it after they stop, since a result may be
+ * released by them concurrently with the destruction. The queued results are freed
+ * by the destructor.
+ *
+ * ### Example
+ *
+ * @code
+int main() {
+    ozo::result_reclaimer reclaimer;
+    ozo::io_context io;
+    //...
+    io.run();
+}
+ * @endcode
+ *
+ * @ingroup group-requests-types
+ */
+class result_reclaimer : pg::detail::result_release_hook {
+public:
+    /**
+     * @brief Construct a new result reclaimer object, start its thread and install it
+     *
+     * @param config --- reclaimer configuration.
+     * @throws std::logic_error if another reclaimer is installed.
+     */
+    explicit result_reclaimer(const result_reclaimer_config& config = {}) : config_(config) {
+        pg::detail::result_release_hook* expected = nullptr;
+        if (!pg::detail::result_release().compare_exchange_strong(expected, this, std::memory_order_acq_rel)) {
+            throw std::logic_error("result_reclaimer: another reclaimer is installed");
+        }
+        thread_ = std::thread([this] { run(); });
+    }
+
+    result_reclaimer(const result_reclaimer&) = delete;
+    result_reclaimer& operator= (const result_reclaimer&) = delete;
+
+    ~result_reclaimer() {
+        pg::detail::result_release().store(nullptr, std::memory_order_release);
+        stopped_.store(true, std::memory_order_release);
+        wake_.notify_one();
+        thread_.join();
+        reclaim(head_.exchange(nullptr, std::memory_order_acquire));
+    }
+
+    /**
+     * Get the snapshot of the counters.
+     *
+     * @return result_reclaimer_metrics --- counters values.
+     */
+    result_reclaimer_metrics metrics() const noexcept {
+        result_reclaimer_metrics retval;
+        retval.queued = queued_.load(std::memory_order_relaxed);
+        retval.reclaimed = reclaimed_.load(std::memory_order_relaxed);
+        retval.reclaimed_bytes = reclaimed_bytes_.load(std::memory_order_relaxed);
+        retval.overflows = overflows_.load(std::memory_order_relaxed);
+        return retval;
+    }
+
+private:
+    struct node {
+        ::PGresult* result;
+        std::size_t size;
+        node* next;
+    };
+
+    bool release(::PGresult* ptr) noexcept override {
+        const auto size = PQresultMemorySize(ptr);
+        if (size < config_.min_size) {
+            return false;
+        }
+        if (queued_.fetch_add(1, std::memory_order_relaxed) >= config_.queue_limit) {
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            overflows_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        auto n = new (std::nothrow) node{ptr, size, head_.load(std::memory_order_relaxed)};
+        if (!n) {
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            return false;
+        }
+        while (!head_.compare_exchange_weak(n->next, n, std::memory_order_release, std::memory_order_relaxed));
+        if (!n->next) {
+            wake_.notify_one();
+        }
+        return true;
+    }
+
+    // The thread takes the whole list at once, so the producers only push to the head
+    // and there is no ABA problem. Since the producers do not lock the mutex a wake up
+    // may be missed, the thread checks the list periodically for that case.
+    void run() {
+        while (!stopped_.load(std::memory_order_acquire)) {
+            if (auto list = head_.exchange(nullptr, std::memory_order_acquire)) {
+                reclaim(list);
+                continue;
+            }
+            std::unique_lock lock(mutex_);
+            wake_.wait_for(lock, std::chrono::milliseconds(10), [&] {
+                return stopped_.load(std::memory_order_acquire) || head_.load(std::memory_order_relaxed);
+            });
+        }
+    }
+
+    void reclaim(node* list) noexcept {
+        while (list) {
+            const auto n = list;
+            list = n->next;
+            ::PQclear(n->result);
+            queued_.fetch_sub(1, std::memory_order_relaxed);
+            reclaimed_.fetch_add(1, std::memory_order_relaxed);
+            reclaimed_bytes_.fetch_add(n->size, std::memory_order_relaxed);
+            delete n;
+        }
+    }
+
+    result_reclaimer_config config_;
+    std::atomic<node*> head_ {nullptr};
+    std::atomic<bool> stopped_ {false};
+    std::atomic<std::size_t> queued_ {0};
+    std::atomic<std::uint64_t> reclaimed_ {0};
+    std::atomic<std::uint64_t> reclaimed_bytes_ {0};
+    std::atomic<std::uint64_t> overflows_ {0};
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::thread thread_;
+};
+
+} // namespace ozo
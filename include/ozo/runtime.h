@@ -0,0 +1,224 @@
+#pragma once
+
+#include <ozo/asio.h>
+#include <ozo/connection_pool.h>
+
+#include <boost/asio/executor_work_guard.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace ozo {
+
+/**
+ * @brief Runtime configuration
+ * @ingroup group-connection-types
+ */
+struct runtime_config {
+    std::size_t threads = 0; //!< number of IO threads, each with its own `io_context`; `std::thread::hardware_concurrency()` if zero
+    bool pin_threads = false; //!< pin the `i`-th thread to the CPU `first_cpu + i` (Linux only, best effort)
+    std::size_t first_cpu = 0; //!< CPU to pin the first thread to
+    connection_pool_config pool; //!< configuration of the pool; `connection_pool_config::shards` is replaced by the number of threads
+};
+
+namespace detail {
+
+struct runtime_thread {
+    const void* runtime = nullptr;
+    std::size_t index = 0;
+};
+
+inline runtime_thread& current_runtime_thread() noexcept {
+    thread_local runtime_thread v;
+    return v;
+}
+
+inline void pin_current_thread(std::size_t cpu) noexcept {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu % CPU_SETSIZE, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)cpu;
+#endif
+}
+
+} // namespace detail
+
+/**
+ * @brief Thread-per-core runtime
+ *
+ * Owns the IO threads, each of which runs its own `io_context` and is optionally pinned to a CPU
+ * core, and a `connection_pool` with a shard per thread created from a single `ConnectionSource`,
+ * e.g. `connection_info`. The `i`-th `io_context` is bound to the `i`-th shard, see `connection_pool::bind_shard()`,
+ * so a request from an IO thread takes a connection of its own core with no contention. If the shard of
+ * the core is exhausted, a free connection is taken from the nearest core which has one before the request
+ * is queued.
+ *
+ * The runtime models `ConnectionSource`: a request made via it from an IO thread of the runtime is served by the
+ * shard of the thread, and a request from another thread is spread between the threads in a round-robin manner.
+ * The threads are stopped and joined on destruction; the pool is destroyed before the `io_context` objects.
+ *
+ * ###Example
+ *
+ * @code
+ozo::runtime_config config;
+config.pin_threads = true;
+config.pool.capacity = 64;
+ozo::runtime runtime(ozo::connection_info(conn_str), config);
+
+asio::post(runtime.context(0), [&] {
+    ozo::request(runtime[runtime.current()], "SELECT 1"_SQL, 1s, ozo::into(rows), handler);
+});
+ * @endcode
+ *
+ * @tparam Source --- underlying `ConnectionSource` which is being used to create connections.
+ * @ingroup group-connection-types
+ * @models{ConnectionSource}
+ */
+template <typename Source>
+class runtime {
+public:
+    using pool_type = connection_pool<Source>;
+
+    /**
+     * Create the pool and start the IO threads.
+     *
+     * @param source --- `ConnectionSource` to create connections to a database.
+     * @param config --- runtime configuration.
+     */
+    runtime(Source source, const runtime_config& config = runtime_config{})
+    : contexts_(make_contexts(config.threads)),
+      pool_(std::move(source), pool_config(config.pool, contexts_.size())) {
+        for (std::size_t i = 0; i < contexts_.size(); ++i) {
+            pool_.bind_shard(*contexts_[i], i % pool_.shards());
+        }
+        work_.reserve(contexts_.size());
+        for (auto& io : contexts_) {
+            work_.emplace_back(asio::make_work_guard(*io));
+        }
+        threads_.reserve(contexts_.size());
+        for (std::size_t i = 0; i < contexts_.size(); ++i) {
+            threads_.emplace_back([this, i, pin = config.pin_threads, cpu = config.first_cpu + i] {
+                if (pin) {
+                    detail::pin_current_thread(cpu);
+                }
+                detail::current_runtime_thread() = {this, i};
+                contexts_[i]->run();
+            });
+        }
+    }
+
+    runtime(const runtime&) = delete;
+    runtime& operator =(const runtime&) = delete;
+
+    ~runtime() {
+        stop();
+        join();
+    }
+
+    /**
+     * Get the number of IO threads.
+     */
+    std::size_t size() const noexcept { return contexts_.size();}
+
+    /**
+     * Get `io_context` of the `i`-th IO thread.
+     */
+    io_context& context(std::size_t i) noexcept { return *contexts_[i];}
+
+    /**
+     * Get `io_context` of the calling IO thread of the runtime, or the next one in a
+     * round-robin manner for any other thread.
+     */
+    io_context& current() noexcept {
+        const auto& thread = detail::current_runtime_thread();
+        if (thread.runtime == this) {
+            return *contexts_[thread.index];
+        }
+        return *contexts_[next_.fetch_add(1, std::memory_order_relaxed) % contexts_.size()];
+    }
+
+    pool_type& pool() noexcept { return pool_;}
+    const pool_type& pool() const noexcept { return pool_;}
+
+    /**
+     * Get `ConnectionProvider` of the pool for the given `io_context`.
+     */
+    auto operator [](io_context& io) {
+        return pool_[io];
+    }
+
+    /**
+     * Get a connection from the shard of the given `io_context`, see `connection_pool::operator()`.
+     */
+    template <typename TimeConstraint, typename Handler>
+    void operator ()(io_context& io, TimeConstraint t, Handler&& handler) {
+        pool_(io, std::move(t), std::forward<Handler>(handler));
+    }
+
+    /**
+     * Let the IO threads return once their `io_context` objects run out of work.
+     */
+    void release() noexcept {
+        work_.clear();
+    }
+
+    /**
+     * Stop the `io_context` objects at once; the handlers which have not run are not called.
+     */
+    void stop() noexcept {
+        release();
+        for (auto& io : contexts_) {
+            io->stop();
+        }
+    }
+
+    /**
+     * Wait for the IO threads to return.
+     */
+    void join() {
+        for (auto& thread : threads_) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+    }
+
+private:
+    using work_guard = asio::executor_work_guard<io_context::executor_type>;
+
+    static std::vector<std::unique_ptr<io_context>> make_contexts(std::size_t threads) {
+        const auto n = threads ? threads : std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+        std::vector<std::unique_ptr<io_context>> result;
+        result.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            result.emplace_back(std::make_unique<io_context>(1));
+        }
+        return result;
+    }
+
+    static connection_pool_config pool_config(connection_pool_config config, std::size_t threads) {
+        config.shards = threads;
+        return config;
+    }
+
+    std::vector<std::unique_ptr<io_context>> contexts_;
+    pool_type pool_;
+    std::vector<work_guard> work_;
+    std::vector<std::thread> threads_;
+    std::atomic<std::size_t> next_ {0};
+};
+
+} // namespace ozo
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <ozo/impl/async_scatter.h>
+
+namespace ozo {
+
+/**
+ * @brief Output for `ozo::scatter()` which appends the shard results in the order of the shards
+ *
+ * @param rows --- container with `insert()` member function, e.g. `std::vector`, to append rows into.
+ * @return output object
+ * @ingroup group-requests-functions
+ */
+template <typename Container>
+inline auto gather_into(Container& rows) {
+    return impl::scatter_gather_out<Container> {std::ref(rows)};
+}
+
+/**
+ * @brief Output for `ozo::scatter()` which merges the ordered shard results
+ *
+ * Each shard result should be ordered by the comparator, e.g. with the `ORDER BY` clause,
+ * then the merged rows are ordered as well. The merge takes O(n log k) comparisons for
+ * n rows of k shards.
+ *
+ * @param rows --- container with `insert()` member function, e.g. `std::vector`, to append rows into.
+ * @param compare --- comparator of the rows which the shard results are ordered by.
+ * @return output object
+ * @ingroup group-requests-functions
+ */
+template <typename Container, typename Compare = std::less<>>
+inline auto merge_into(Container& rows, Compare compare = Compare{}) {
+    return impl::scatter_merge_out<Container, Compare> {std::ref(rows), std::move(compare)};
+}
+
+#ifdef OZO_DOCUMENTATION
+/**
+ * @brief Executes the query on a set of shards concurrently and gathers the results
+ *
+ * The function executes the same query via each of the connection providers concurrently,
+ * e.g. for the clusters of a sharded database. The query is converted into `ozo::binary_query`
+ * once and reused by all the shards unless the connections use custom types, which OIDs
+ * may differ between the shards. Each shard receives its rows into its own container, and
+ * once all of them are complete the rows are gathered into the output: appended in the order
+ * of the providers with `ozo::gather_into()`, or merged with `ozo::merge_into()` if the result
+ * of each shard is ordered.
+ *
+ * The time constraint is applied to each shard independently. The result is partial if some
+ * of the shards fail: the output receives the rows of the shards which succeeded, and the
+ * operation completes with `ozo::error::partial_result`. If all of the shards fail, the
+ * operation completes with the error of the first of them. In any case the handler receives
+ * the error of each shard in the order of the providers, so a caller may tell which of the
+ * shards have failed.
+ *
+ * The handler is called with `void(ozo::error_code, std::vector<ozo::error_code>)` signature
+ * via its associated executor.
+ *
+ * @note The function does not participate in ADL since could be implemented via functional object.
+ *
+ * @param providers --- range of connection provider objects, one per shard.
+ * @param query --- query object to request from each shard.
+ * @param time_constraint --- #TimeConstraint of each shard request; it <b>includes</b> time for getting connection from provider.
+ * @param out --- output made by `ozo::gather_into()` or `ozo::merge_into()`.
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ *
+ * ###Example
+ *
+ * @code
+std::vector<decltype(pool[io])> shards;
+for (auto& pool : pools) {
+    shards.push_back(pool[io]);
+}
+
+ozo::rows_of<std::int64_t, std::string> rows;
+const auto statuses = ozo::scatter(shards, "SELECT id, name FROM users ORDER BY id"_SQL, 500ms,
+    ozo::merge_into(rows, [] (const auto& lhs, const auto& rhs) { return std::get<0>(lhs) < std::get<0>(rhs);}),
+    yield[ec]);
+if (ec == ozo::error::partial_result) {
+    // rows of the shards which succeeded, see statuses for the failed ones
+}
+ * @endcode
+ */
+template <typename ConnectionProviders, typename BinaryQueryConvertible, typename TimeConstraint, typename Out, typename CompletionToken>
+decltype(auto) scatter(ConnectionProviders&& providers, BinaryQueryConvertible&& query, TimeConstraint time_constraint, Out out, CompletionToken&& token);
+
+/**
+ * @brief Executes the query on a set of shards concurrently and gathers the results
+ *
+ * This function is time constrain free shortcut to `ozo::scatter()` function.
+ * Its call is equal to `ozo::scatter(providers, query, ozo::none, out, token)` call.
+ *
+ * @note The function does not participate in ADL since could be implemented via functional object.
+ *
+ * @param providers --- range of connection provider objects, one per shard.
+ * @param query --- query object to request from each shard.
+ * @param out --- output made by `ozo::gather_into()` or `ozo::merge_into()`.
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ */
+template <typename ConnectionProviders, typename BinaryQueryConvertible, typename Out, typename CompletionToken>
+decltype(auto) scatter(ConnectionProviders&& providers, BinaryQueryConvertible&& query, Out out, CompletionToken&& token);
+#else
+
+template <typename Initiator>
+struct scatter_op : base_async_operation <scatter_op<Initiator>, Initiator> {
+    using base = typename scatter_op::base;
+    using base::base;
+
+    template <typename Providers, typename Q, typename TimeConstraint, typename Out, typename CompletionToken>
+    decltype(auto) operator() (Providers&& providers, Q&& query, TimeConstraint t,
+            Out out, CompletionToken&& token) const {
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        return async_initiate<CompletionToken, void(error_code, std::vector<error_code>)>(
+            get_operation_initiator(*this), token, std::forward<Providers>(providers), t,
+            std::forward<Q>(query), std::move(out));
+    }
+
+    template <typename Providers, typename Q, typename Out, typename CompletionToken>
+    decltype(auto) operator() (Providers&& providers, Q&& query, Out out, CompletionToken&& token) const {
+        return (*this)(std::forward<Providers>(providers), std::forward<Q>(query), none, std::move(out),
+            std::forward<CompletionToken>(token));
+    }
+
+    template <typename OtherInitiator>
+    constexpr static auto rebind_initiator(const OtherInitiator& other) {
+        return scatter_op<OtherInitiator>{other};
+    }
+};
+
+namespace detail {
+struct initiate_async_scatter {
+    template <typename Handler, typename Providers, typename TimeConstraint, typename Q, typename Out>
+    constexpr void operator()(Handler&& h, Providers&& providers, TimeConstraint t, Q&& q, Out out) const {
+        impl::async_scatter(std::forward<Providers>(providers), std::forward<Q>(q), t, std::move(out),
+            std::forward<Handler>(h));
+    }
+};
+} // namespace detail
+
+constexpr scatter_op<detail::initiate_async_scatter> scatter;
+#endif
+
+} // namespace ozo
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <ozo/connector.h>
+#include <ozo/connection.h>
+#include <ozo/asio.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ozo {
+
+/**
+ * @brief Shard of `ozo::shard_ring`
+ * @ingroup group-connection-types
+ *
+ * The name identifies the shard on the ring, so the keys stay with the shard while
+ * the ring is updated as long as the name is kept.
+ *
+ * @tparam Source --- type of the shard `ConnectionSource`, e.g. `ozo::connection_pool`.
+ */
+template <typename Source>
+struct shard_ring_node {
+    std::string name; //!< unique name of the shard
+    std::shared_ptr<Source> source; //!< connection source of the shard
+    std::size_t weight = 1; //!< relative share of the keys which the shard gets
+};
+
+namespace detail {
+
+inline std::uint64_t mix_shard_hash(std::uint64_t z) noexcept {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+/**
+* FNV-1a which does not depend on the standard library implementation, so
+* the keys map to the same shards across the processes.
+*/
+inline std::uint64_t shard_hash(std::string_view key) noexcept {
+    std::uint64_t hash = 0xcbf29ce484222325ull;
+    for (const unsigned char c : key) {
+        hash = (hash ^ c) * 0x100000001b3ull;
+    }
+    return mix_shard_hash(hash);
+}
+
+template <typename Key>
+inline std::uint64_t shard_hash(const Key& key) noexcept {
+    if constexpr (std::is_integral_v<Key> || std::is_enum_v<Key>) {
+        return mix_shard_hash(static_cast<std::uint64_t>(key));
+    } else if constexpr (std::is_convertible_v<const Key&, std::string_view>) {
+        return shard_hash(std::string_view(key));
+    } else {
+        return mix_shard_hash(static_cast<std::uint64_t>(std::hash<Key>{}(key)));
+    }
+}
+
+/**
+* Immutable state of the ring: the shards and their points sorted by hash.
+* A key belongs to the shard of the first point with the hash not less than
+* the key hash, the ring wraps around to the first point.
+*/
+template <typename Source>
+struct shard_ring_snapshot {
+    std::vector<shard_ring_node<Source>> shards;
+    std::vector<std::pair<std::uint64_t, std::size_t>> points;
+
+    shard_ring_snapshot(std::vector<shard_ring_node<Source>> nodes, std::size_t points_per_shard)
+    : shards(std::move(nodes)) {
+        if (shards.empty()) {
+            throw std::invalid_argument("shard_ring: shards should not be empty");
+        }
+        for (std::size_t i = 0; i < shards.size(); ++i) {
+            if (!shards[i].source) {
+                throw std::invalid_argument("shard_ring: shard source should not be null");
+            }
+            const auto count = points_per_shard * std::max<std::size_t>(shards[i].weight, 1);
+            for (std::size_t n = 0; n < count; ++n) {
+                points.emplace_back(shard_hash(shards[i].name + '#' + std::to_string(n)), i);
+            }
+        }
+        std::sort(points.begin(), points.end());
+    }
+
+    std::size_t find(std::uint64_t hash) const noexcept {
+        const auto point = std::lower_bound(points.begin(), points.end(), hash,
+            [] (const auto& p, std::uint64_t v) { return p.first < v; });
+        return point == points.end() ? points.front().second : point->second;
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief Connection source of the shard resolved by `ozo::shard_ring`
+ *
+ * Keeps the ring snapshot it has been resolved with, so the shard source outlives
+ * the ring updates while the object exists.
+ *
+ * @ingroup group-connection-types
+ * @models{ConnectionSource}
+ */
+template <typename Source>
+class shard_connection_source {
+    std::shared_ptr<const detail::shard_ring_snapshot<Source>> snapshot_;
+    std::size_t index_;
+
+public:
+    /**
+     * `Connection` implementation type according to `ConnectionSource` requirements.
+     */
+    using connection_type = typename connection_source_traits<Source>::connection_type;
+
+    shard_connection_source(std::shared_ptr<const detail::shard_ring_snapshot<Source>> snapshot, std::size_t index)
+    : snapshot_(std::move(snapshot)), index_(index) {}
+
+    /**
+     * @brief Provides a connection from the shard source
+     *
+     * @param io --- `io_context` for the connection IO.
+     * @param t --- #TimeConstraint for the operation.
+     * @param handler --- #Handler.
+     */
+    template <typename TimeConstraint, typename Handler>
+    void operator ()(io_context& io, TimeConstraint t, Handler&& handler) const {
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        (*snapshot_->shards[index_].source)(io, std::move(t), std::forward<Handler>(handler));
+    }
+
+    /**
+     * Name of the resolved shard.
+     */
+    const std::string& name() const noexcept { return snapshot_->shards[index_].name;}
+
+    auto operator [](io_context& io) const & {
+        return connection_provider(*this, io);
+    }
+
+    auto operator [](io_context& io) && {
+        return connection_provider(std::move(*this), io);
+    }
+};
+
+/**
+ * @brief Consistent hash ring of shard connection sources
+ *
+ * Routes a request to the shard of its key, e.g. a user id. Each shard is placed on the ring
+ * by a number of points proportional to its weight, and a key belongs to the shard of the next
+ * point after the key hash. So adding or removing a shard moves only the keys of the shards
+ * adjacent to its points, the rest of the keys keep their shards.
+ *
+ * The ring is an immutable snapshot which is replaced atomically by `update()`, so the
+ * resolution of a key takes no locks and is not blocked by the updates: it is a binary search
+ * over the snapshot points. The source resolved by `operator[]` keeps the snapshot, so the
+ * requests in flight and the resolved sources kept by a caller proceed with the shards they
+ * have been resolved to.
+ *
+ * Integral keys and keys convertible to `std::string_view` are hashed with a function which does
+ * not depend on the standard library, so the keys map to the same shards across the processes;
+ * other keys are hashed with `std::hash`.
+ *
+ * ###Example
+ *
+ * @code
+std::vector<ozo::shard_ring_node<pool_type>> shards;
+for (const auto& [name, conn_str] : clusters) {
+    shards.push_back({name, std::make_shared<pool_type>(
+        ozo::make_connection_pool(ozo::connection_info(conn_str), pool_config))});
+}
+ozo::shard_ring ring(std::move(shards));
+
+ozo::request(ring[user_id][io], query, 500ms, ozo::into(rows), yield[ec]);
+ * @endcode
+ *
+ * @tparam Source --- type of the shard `ConnectionSource`.
+ * @ingroup group-connection-types
+ */
+template <typename Source>
+class shard_ring {
+    static_assert(ConnectionSource<Source>, "Source should model ConnectionSource concept");
+
+    using snapshot_type = detail::shard_ring_snapshot<Source>;
+
+public:
+    using node_type = shard_ring_node<Source>;
+
+    /**
+     * @brief Construct a new shard ring object
+     *
+     * @param shards --- non empty sequence of the shards with unique names.
+     * @param points_per_shard --- number of the ring points of a shard with weight 1;
+     *                             more points give more even distribution of the keys.
+     */
+    explicit shard_ring(std::vector<node_type> shards, std::size_t points_per_shard = 128)
+    : points_per_shard_(std::max<std::size_t>(points_per_shard, 1)),
+      snapshot_(std::make_shared<const snapshot_type>(std::move(shards), points_per_shard_)) {}
+
+    /**
+     * @brief Replaces the shards of the ring
+     *
+     * The new ring is built aside and published atomically, the requests resolved
+     * before proceed with the previous ring.
+     *
+     * @param shards --- non empty sequence of the shards with unique names.
+     */
+    void update(std::vector<node_type> shards) {
+        std::atomic_store(&snapshot_, std::shared_ptr<const snapshot_type>(
+            std::make_shared<const snapshot_type>(std::move(shards), points_per_shard_)));
+    }
+
+    /**
+     * @brief Resolves the shard of the key
+     *
+     * @param key --- shard key.
+     * @return `ozo::shard_connection_source` of the shard.
+     */
+    template <typename Key>
+    shard_connection_source<Source> operator [](const Key& key) const {
+        auto snapshot = std::atomic_load(&snapshot_);
+        const auto index = snapshot->find(detail::shard_hash(key));
+        return {std::move(snapshot), index};
+    }
+
+    /**
+     * Number of the shards of the ring.
+     */
+    std::size_t size() const { return std::atomic_load(&snapshot_)->shards.size();}
+
+private:
+    std::size_t points_per_shard_;
+    std::shared_ptr<const snapshot_type> snapshot_;
+};
+
+template <typename Source>
+shard_ring(std::vector<shard_ring_node<Source>>) -> shard_ring<Source>;
+
+template <typename Source>
+shard_ring(std::vector<shard_ring_node<Source>>, std::size_t) -> shard_ring<Source>;
+
+} // namespace ozo
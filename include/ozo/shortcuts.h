@@ -3,6 +3,7 @@
 #include <tuple>
 #include <vector>
 #include <list>
+#include <optional>
 #include <ozo/result.h>
 
 namespace ozo {
@@ -62,6 +63,34 @@ ozo::request(conn_info[io], query, ozo::into(rows), boost::asio::use_future);
 template <typename ... Ts>
 using lrows_of = std::list<typed_row<Ts...>>;
 
+/**
+ * @ingroup group-requests-types
+ * @brief Shortcut for easy columnar result containers definition.
+ *
+ * This shortcut defines a tuple of `std::vector` containers, one for each column
+ * of a result. Such result is received column by column, see `ozo::recv_result()`.
+ * @note It is very important to keep a sequence of types according to fields in query statement (see the example below).
+ *
+ * ### Example
+ *
+@code{cpp}
+
+// Query statement
+const auto query =
+    "SELECT        id    ,   amount  FROM users_info WHERE amount>="_SQL + std::int64_t(25);
+//                ----       ======
+//                 V           V
+ozo::columns_of<std::int64_t, double> columns;
+//              ------------  ======
+
+ozo::request(conn_info[io], query, ozo::into(columns), boost::asio::use_future);
+const auto& ids = std::get<0>(columns);
+@endcode
+ * @tparam Ts --- types of columns in result
+ */
+template <typename ... Ts>
+using columns_of = std::tuple<std::vector<Ts>...>;
+
 /**
  * @ingroup group-requests-functions
  * @brief Shortcut for create result container back inserter.
@@ -106,4 +135,74 @@ ozo::request(conn_info[io], query, ozo::into(res), boost::asio::use_future);
 template <typename T>
 constexpr auto into(basic_result<T>& v) noexcept { return std::ref(v);}
 
+/**
+ * @ingroup group-requests-functions
+ * @brief Shortcut for create reference wrapper for `ozo::borrowed_rows`.
+ *
+ * This shortcut creates reference wrapper for `ozo::borrowed_rows` to receive rows
+ * which point into the result memory.
+ *
+ * ### Example
+ *
+@code{cpp}
+
+// Query statement
+const auto query = "SELECT id, payload FROM thumbnails WHERE id="_SQL + std::int64_t(25);
+
+ozo::borrowed_rows<std::tuple<std::int64_t, ozo::pg::bytea_view>> rows;
+
+ozo::request(conn_info[io], query, ozo::into(rows), boost::asio::use_future);
+@endcode
+ * @param v --- `ozo::borrowed_rows` object for rows.
+ */
+template <typename Row, typename T>
+constexpr auto into(borrowed_rows<Row, T>& v) noexcept { return std::ref(v);}
+
+/**
+ * @ingroup group-requests-functions
+ * @brief Shortcut for create reference wrapper for columns containers.
+ *
+ * This shortcut creates reference wrapper for a tuple of containers, e.g. `ozo::columns_of`,
+ * to receive a result into it column by column.
+ *
+ * ### Example
+ *
+@code{cpp}
+
+// Query statement
+const auto query = "SELECT id, amount FROM users_info WHERE amount>="_SQL + std::int64_t(25);
+
+ozo::columns_of<std::int64_t, double> columns;
+
+ozo::request(conn_info[io], query, ozo::into(columns), boost::asio::use_future);
+@endcode
+ * @param v --- tuple of containers for columns.
+ */
+template <typename ...Ts>
+constexpr auto into(std::tuple<Ts...>& v) noexcept { return std::ref(v);}
+
+/**
+ * @ingroup group-requests-functions
+ * @brief Shortcut for create reference wrapper for an optional row.
+ *
+ * This shortcut creates reference wrapper for `std::optional` of a row to receive a result
+ * of at most one row into it, e.g. a lookup by a primary key. The optional is empty if the
+ * result has no rows, the request fails with `ozo::error::too_many_rows` if it has more than one.
+ *
+ * ### Example
+ *
+@code{cpp}
+
+// Query statement
+const auto query = "SELECT id, name FROM users_info WHERE id="_SQL + std::int64_t(25);
+
+std::optional<std::tuple<std::int64_t, std::string>> user;
+
+ozo::request(conn_info[io], query, ozo::into(user), boost::asio::use_future);
+@endcode
+ * @param v --- optional row.
+ */
+template <typename Row>
+constexpr auto into(std::optional<Row>& v) noexcept { return std::ref(v);}
+
 } // namespace ozo
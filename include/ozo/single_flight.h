@@ -0,0 +1,225 @@
+#pragma once
+
+#include <ozo/request.h>
+#include <ozo/result.h>
+#include <ozo/detail/bind.h>
+#include <ozo/detail/query_key.h>
+
+#include <boost/asio/post.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ozo {
+
+/**
+ * @brief Single flight metrics
+ * @ingroup group-requests-types
+ */
+struct single_flight_metrics {
+    std::size_t in_flight = 0; //!< number of the distinct queries being executed
+    std::uint64_t executed = 0; //!< number of the queries sent to the database
+    std::uint64_t coalesced = 0; //!< number of the requests which joined a query being executed
+};
+
+namespace detail {
+
+struct single_flight_waiter {
+    virtual void complete(error_code ec, const shared_result& res) = 0;
+    virtual ~single_flight_waiter() = default;
+};
+
+template <typename Handler, typename Executor>
+struct single_flight_waiter_impl : single_flight_waiter {
+    Handler handler_;
+    Executor executor_;
+
+    single_flight_waiter_impl(Handler handler, const Executor& ex)
+    : handler_(std::move(handler)), executor_(ex) {}
+
+    void complete(error_code ec, const shared_result& res) override {
+        auto ex = asio::get_associated_executor(handler_, executor_);
+        asio::post(ex, detail::bind(std::move(handler_), std::move(ec), res));
+    }
+};
+
+/**
+* Requests being executed by the key of the query. The first request of a key
+* executes the query, the rest of requests wait for its result.
+*/
+class single_flight_state {
+public:
+    using waiter_ptr = std::unique_ptr<single_flight_waiter>;
+
+    /**
+     * Adds the waiter to the flight of the key. Returns `true` if the flight is new,
+     * so the caller should execute the query.
+     */
+    bool join(const std::string& key, waiter_ptr waiter) {
+        const std::lock_guard lock(mutex_);
+        auto [flight, inserted] = flights_.try_emplace(key);
+        flight->second.push_back(std::move(waiter));
+        ++(inserted ? metrics_.executed : metrics_.coalesced);
+        return inserted;
+    }
+
+    /**
+     * Completes all the waiters of the key with the same result. A request of the key
+     * made after that starts a new flight.
+     */
+    void finish(const std::string& key, error_code ec, shared_result res) {
+        std::vector<waiter_ptr> waiters;
+        {
+            const std::lock_guard lock(mutex_);
+            const auto flight = flights_.find(key);
+            waiters = std::move(flight->second);
+            flights_.erase(flight);
+        }
+        for (auto& waiter : waiters) {
+            waiter->complete(ec, res);
+        }
+    }
+
+    single_flight_metrics metrics() const {
+        const std::lock_guard lock(mutex_);
+        auto result = metrics_;
+        result.in_flight = flights_.size();
+        return result;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::vector<waiter_ptr>> flights_;
+    single_flight_metrics metrics_;
+};
+
+struct single_flight_handler {
+    std::shared_ptr<single_flight_state> state_;
+    std::string key_;
+    std::shared_ptr<result> result_;
+
+    template <typename Connection>
+    void operator() (error_code ec, Connection&&) {
+        state_->finish(key_, std::move(ec), shared_result(pg::shared_result(result_->release())));
+    }
+};
+
+/**
+* The oid map of the provider connection is known at compile time if it has no custom
+* types, then the query is converted once for both the key and the request.
+*/
+template <typename P>
+using single_flight_oid_map = std::decay_t<decltype(
+    unwrap_connection(std::declval<connection_type<P>&>()).oid_map())>;
+
+} // namespace detail
+
+/**
+ * @brief Coalesces identical concurrent requests into one
+ *
+ * When many coroutines request the same data at once, e.g. on a cache expiration, all
+ * of them would execute the same query. A request made via `single_flight` is keyed by
+ * the query text and its serialized parameters: the first request of a key executes the
+ * query, and the requests of the same key made while it is being executed do not go to the
+ * database but receive the same result. A request made after the result has been received
+ * executes the query again, so no result is cached.
+ *
+ * The result is provided as `ozo::shared_result`, which is shared by all the requests of
+ * the key, so it should not be modified; rows may be received from it with
+ * `ozo::recv_result()`. The connection is not provided to the handler, since only one of
+ * the requests has used one.
+ *
+ * The joined requests share the connection provider and the time constraint of the request
+ * which executes the query, and its error. Use the single flight for read only queries
+ * only, since a coalesced query is executed once for all the requests.
+ *
+ * The object may be used from many threads simultaneously.
+ *
+ * ###Example
+ *
+ * @code
+ozo::single_flight flight(io);
+
+flight.request(pool[io], "SELECT value FROM settings WHERE id = "_SQL + id, 100ms, yield[ec]);
+ * @endcode
+ *
+ * @ingroup group-requests-types
+ */
+class single_flight {
+public:
+    /**
+     * @brief Construct a new single flight object
+     *
+     * @param io --- `io_context` to complete the requests on if the handler has no associated executor.
+     */
+    explicit single_flight(io_context& io)
+    : io_(io), state_(std::make_shared<detail::single_flight_state>()) {}
+
+    /**
+     * @brief Executes the query or joins the identical query being executed
+     *
+     * @param provider --- connection provider object.
+     * @param query --- query object to request from a database.
+     * @param t --- request #TimeConstraint; this time constrain <b>includes</b> time for getting connection from provider.
+     * @param token --- operation #CompletionToken with `void(ozo::error_code, ozo::shared_result)` signature.
+     * @return deduced from #CompletionToken.
+     */
+    template <typename P, typename Q, typename TimeConstraint, typename CompletionToken>
+    decltype(auto) request(P&& provider, Q&& query, TimeConstraint t, CompletionToken&& token) {
+        static_assert(ConnectionProvider<P>, "provider should be a ConnectionProvider");
+        static_assert(BinaryQueryConvertible<Q>, "query should be convertible to the binary_query");
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        return async_initiate<CompletionToken, void(error_code, shared_result)>(
+            [this] (auto&& handler, auto&& provider, auto&& query, TimeConstraint t) {
+                using handler_type = std::decay_t<decltype(handler)>;
+                using waiter_type = detail::single_flight_waiter_impl<handler_type, io_context::executor_type>;
+                using oid_map_type = detail::single_flight_oid_map<decltype(provider)>;
+
+                auto binary_query = to_binary_query(query, oid_map_type{});
+                auto key = detail::make_query_key(binary_query);
+                auto waiter = std::make_unique<waiter_type>(std::forward<decltype(handler)>(handler), io_.get_executor());
+                if (!state_->join(key, std::move(waiter))) {
+                    return;
+                }
+
+                auto res = std::make_shared<result>();
+                detail::single_flight_handler flight_handler{state_, std::move(key), res};
+                if constexpr (std::is_same_v<oid_map_type, empty_oid_map>) {
+                    ozo::request(std::forward<decltype(provider)>(provider), std::move(binary_query), t,
+                        std::ref(*res), std::move(flight_handler));
+                } else {
+                    ozo::request(std::forward<decltype(provider)>(provider), std::forward<decltype(query)>(query), t,
+                        std::ref(*res), std::move(flight_handler));
+                }
+            },
+            token, std::forward<P>(provider), std::forward<Q>(query), t);
+    }
+
+    /**
+     * @brief Executes the query or joins the identical query being executed
+     *
+     * Time constraint free shortcut to `request(provider, query, ozo::none, token)`.
+     */
+    template <typename P, typename Q, typename CompletionToken>
+    decltype(auto) request(P&& provider, Q&& query, CompletionToken&& token) {
+        return request(std::forward<P>(provider), std::forward<Q>(query), none,
+            std::forward<CompletionToken>(token));
+    }
+
+    /**
+     * Get snapshot of the single flight counters.
+     *
+     * @return single_flight_metrics --- counters.
+     */
+    single_flight_metrics metrics() const { return state_->metrics();}
+
+private:
+    io_context& io_;
+    std::shared_ptr<detail::single_flight_state> state_;
+};
+
+} // namespace ozo
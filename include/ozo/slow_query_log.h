@@ -0,0 +1,179 @@
+#pragma once
+
+#include <ozo/connection_statistics.h>
+#include <ozo/detail/bounded_queue.h>
+#include <ozo/time_traits.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string_view>
+
+namespace ozo {
+
+/**
+ * @brief Record of a slow or sampled request
+ * @ingroup group-connection-types
+ *
+ * The record has fixed size, so it is captured without allocations. The query text is
+ * not kept by a request once it has been sent, so the record describes the query by the
+ * sizes of its parameters; the request may be matched to the query with the completion
+ * time and the host, e.g. against the application log.
+ */
+struct slow_query_record {
+    static constexpr std::size_t host_capacity = 64; //!< maximum length of the host stored
+
+    request_timeline timeline; //!< phases timestamps, the `host` member is empty, see `host()`
+    bool sampled = false; //!< `true` if the request has been captured by the sampling rather than the threshold
+    std::array<char, host_capacity> host_data {}; //!< host of the connection truncated to the `host_capacity`
+    std::size_t host_size = 0; //!< length of the host stored
+
+    /**
+     * Host of the connection the request has been made with.
+     */
+    std::string_view host() const noexcept { return {host_data.data(), host_size};}
+
+    /**
+     * Time from the initiation of the request to its completion.
+     */
+    time_traits::duration latency() const noexcept { return timeline.finished - timeline.requested;}
+};
+
+/**
+ * @brief Bounded lock-free queue of the slow query records
+ * @ingroup group-connection-types
+ *
+ * Many connections push records concurrently, and the application drains them from
+ * any thread with `pop()`. The slots are preallocated, a record pushed into the full
+ * ring is dropped and counted by `dropped()`.
+ */
+class slow_query_ring {
+public:
+    /**
+     * @param capacity --- number of the records, rounded up to a power of two, at least 2.
+     */
+    explicit slow_query_ring(std::size_t capacity)
+    : queue_(check_capacity(capacity)) {}
+
+    slow_query_ring(const slow_query_ring&) = delete;
+    slow_query_ring& operator =(const slow_query_ring&) = delete;
+
+    /**
+     * Push the record. Returns `false` and drops the record if the ring is full.
+     */
+    bool push(const slow_query_record& record) noexcept {
+        auto item = record;
+        if (!queue_.try_push(item)) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Pop the oldest record, `std::nullopt` if the ring is empty.
+     */
+    std::optional<slow_query_record> pop() noexcept { return queue_.try_pop();}
+
+    std::size_t capacity() const noexcept { return queue_.capacity();} //!< number of the records the ring holds
+    std::uint64_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed);} //!< number of the records dropped
+
+private:
+    static std::size_t check_capacity(std::size_t capacity) {
+        if (capacity == 0) {
+            throw std::invalid_argument("slow query ring capacity should be positive");
+        }
+        return capacity;
+    }
+
+    detail::bounded_queue<slow_query_record> queue_;
+    alignas(64) std::atomic<std::uint64_t> dropped_ {0};
+};
+
+/**
+ * @brief Slow query log configuration
+ * @ingroup group-connection-types
+ */
+struct slow_query_log_config {
+    time_traits::duration threshold = std::chrono::seconds(1); //!< latency of a request which is captured
+    std::size_t sample_every = 0; //!< capture a random one of each N requests regardless of the latency, 0 disables sampling
+};
+
+/**
+ * @brief Statistics model which captures the slow requests into a ring
+ *
+ * The model receives the `ozo::request_timeline` of each completed request and captures
+ * the request into the `ozo::slow_query_ring` if its latency reaches the threshold, or if
+ * it is chosen by the sampling, see `ozo::slow_query_log_config`. The latency of a request
+ * is measured from its initiation, so it includes the connection acquisition. A request
+ * which is not captured costs a comparison of the latency and a decrement of the sampling
+ * countdown; the capture copies a fixed size record into a preallocated slot.
+ *
+ * The ring is shared by the copies of the model, e.g. by the connections of a `connection_info`.
+ *
+ * ###Example
+ *
+ * @code
+const auto ring = std::make_shared<ozo::slow_query_ring>(1024);
+const auto conn_info = ozo::connection_info(conn_str, ozo::empty_oid_map{},
+    ozo::slow_query_log(ring, {std::chrono::milliseconds(100), 1000}));
+...
+while (const auto record = ring->pop()) {
+    log << record->host() << " " << record->latency().count() << " rows " << record->timeline.rows;
+}
+ * @endcode
+ *
+ * @ingroup group-connection-types
+ */
+class slow_query_log {
+public:
+    slow_query_log(std::shared_ptr<slow_query_ring> ring, const slow_query_log_config& config = {})
+    : ring_(std::move(ring)), config_(config) {
+        if (!ring_) {
+            throw std::invalid_argument("slow query log ring should not be null");
+        }
+        countdown_ = next_countdown();
+    }
+
+    void update(request_timeline_key_t, const request_timeline& v) noexcept {
+        bool sampled = false;
+        if (config_.sample_every != 0 && --countdown_ == 0) {
+            countdown_ = next_countdown();
+            sampled = true;
+        }
+        if (!sampled && v.finished - v.requested < config_.threshold) {
+            return;
+        }
+        slow_query_record record;
+        record.timeline = v;
+        record.timeline.host = {};
+        record.sampled = sampled;
+        record.host_size = std::min(v.host.size(), slow_query_record::host_capacity);
+        std::copy_n(v.host.data(), record.host_size, record.host_data.data());
+        ring_->push(record);
+    }
+
+    const std::shared_ptr<slow_query_ring>& ring() const noexcept { return ring_;} //!< ring of the records
+
+private:
+    std::shared_ptr<slow_query_ring> ring_;
+    slow_query_log_config config_;
+    std::size_t countdown_ = 0;
+
+    // Number of requests until the next sampled one, uniform in [1, 2N - 1] to have a 1-in-N rate on average.
+    std::size_t next_countdown() const {
+        if (config_.sample_every <= 1) {
+            return config_.sample_every;
+        }
+        static thread_local std::minstd_rand engine(std::random_device{}());
+        return std::uniform_int_distribution<std::size_t>(1, 2 * config_.sample_every - 1)(engine);
+    }
+};
+
+} // namespace ozo
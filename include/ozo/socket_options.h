@@ -0,0 +1,75 @@
+#pragma once
+
+#include <optional>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+namespace ozo {
+
+/**
+ * @brief Options of the connection socket
+ *
+ * The options are set on the socket of a connection right after it is made by libpq,
+ * an option which is not set keeps the system default. The options which are not
+ * supported by the socket or by the system, e.g. TCP ones for a Unix-domain socket,
+ * are skipped, so the same options may be used for any connection string.
+ *
+ * Note that libpq enables `TCP_NODELAY` and keepalives itself, and the keepalive
+ * probes may also be configured via `keepalives_idle`, `keepalives_interval` and
+ * `keepalives_count` connection string parameters.
+ *
+ * @ingroup group-connection-types
+ */
+struct socket_options {
+    std::optional<bool> no_delay; //!< `TCP_NODELAY`, disable the Nagle algorithm
+    std::optional<bool> quick_ack; //!< `TCP_QUICKACK`, send the acknowledgements immediately; the kernel may reset it later
+    std::optional<int> receive_buffer_size; //!< `SO_RCVBUF` in bytes, larger buffers improve throughput of bulk reads over links with long round trip
+    std::optional<int> send_buffer_size; //!< `SO_SNDBUF` in bytes
+    std::optional<bool> keep_alive; //!< `SO_KEEPALIVE`
+    std::optional<int> keep_alive_idle; //!< `TCP_KEEPIDLE`, idle seconds before the first keepalive probe
+    std::optional<int> keep_alive_interval; //!< `TCP_KEEPINTVL`, seconds between the keepalive probes
+    std::optional<int> keep_alive_count; //!< `TCP_KEEPCNT`, number of the unanswered probes to drop the connection after
+};
+
+namespace detail {
+
+inline void set_socket_option(int fd, int level, int name, int value) noexcept {
+    // Unsupported options are skipped, see ozo::socket_options
+    ::setsockopt(fd, level, name, &value, sizeof(value));
+}
+
+inline void set_socket_option(int fd, int level, int name, const std::optional<int>& value) noexcept {
+    if (value) {
+        set_socket_option(fd, level, name, *value);
+    }
+}
+
+inline void set_socket_option(int fd, int level, int name, const std::optional<bool>& value) noexcept {
+    if (value) {
+        set_socket_option(fd, level, name, *value ? 1 : 0);
+    }
+}
+
+inline void apply_socket_options(int fd, const socket_options& options) noexcept {
+    set_socket_option(fd, IPPROTO_TCP, TCP_NODELAY, options.no_delay);
+#ifdef TCP_QUICKACK
+    set_socket_option(fd, IPPROTO_TCP, TCP_QUICKACK, options.quick_ack);
+#endif
+    set_socket_option(fd, SOL_SOCKET, SO_RCVBUF, options.receive_buffer_size);
+    set_socket_option(fd, SOL_SOCKET, SO_SNDBUF, options.send_buffer_size);
+    set_socket_option(fd, SOL_SOCKET, SO_KEEPALIVE, options.keep_alive);
+#ifdef TCP_KEEPIDLE
+    set_socket_option(fd, IPPROTO_TCP, TCP_KEEPIDLE, options.keep_alive_idle);
+#endif
+#ifdef TCP_KEEPINTVL
+    set_socket_option(fd, IPPROTO_TCP, TCP_KEEPINTVL, options.keep_alive_interval);
+#endif
+#ifdef TCP_KEEPCNT
+    set_socket_option(fd, IPPROTO_TCP, TCP_KEEPCNT, options.keep_alive_count);
+#endif
+}
+
+} // namespace detail
+} // namespace ozo
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <libpq-fe.h>
+
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ozo {
+
+/**
+ * @brief SSL protection level of a connection, the `sslmode` connection string parameter
+ * @ingroup group-connection-types
+ */
+enum class ssl_mode {
+    disable, //!< no SSL
+    allow, //!< SSL only if the server rejects a plain connection
+    prefer, //!< SSL if the server supports it, the libpq default
+    require, //!< SSL without the server certificate verification
+    verify_ca, //!< SSL with the server certificate verified against the root certificate
+    verify_full, //!< SSL with the server certificate and host name verified
+};
+
+/**
+ * @brief SSL negotiation of a connection, the `sslnegotiation` connection string parameter
+ * @ingroup group-connection-types
+ */
+enum class ssl_negotiation {
+    postgres, //!< SSLRequest first and the SSL handshake after the server reply, the libpq default
+    direct, //!< SSL handshake right after the TCP connection is made, requires PostgreSQL 17 server
+};
+
+/**
+ * @brief SSL options of the connections
+ *
+ * The options are passed to libpq as the connection string parameters, an option which is
+ * not set keeps the value of the connection string or the libpq default.
+ *
+ * By default libpq sends SSLRequest and waits for the server reply before the SSL handshake,
+ * which costs a round trip on each connect. With `ssl_negotiation::direct` the handshake
+ * starts right after the TCP connection is made, the server recognizes the protocol via
+ * ALPN. It requires `ssl_mode::require` or a stronger mode, since a server which does not
+ * support SSL is not detected then, and PostgreSQL 17 server and libpq. With an older libpq
+ * the negotiation option is not passed, so SSLRequest is used. The saving is visible in
+ * the `ozo::connect_phase::ssl` phase of `ozo::connect_timeline`.
+ *
+ * @ingroup group-connection-types
+ */
+struct ssl_options {
+    std::optional<ssl_mode> mode; //!< `sslmode`
+    std::optional<ssl_negotiation> negotiation; //!< `sslnegotiation`, libpq 17 or newer
+    std::optional<std::string> root_cert; //!< `sslrootcert`, file of the root certificates to verify the server certificate
+    std::optional<std::string> cert; //!< `sslcert`, file of the client certificate
+    std::optional<std::string> key; //!< `sslkey`, file of the client certificate key
+    std::optional<bool> sni; //!< `sslsni`, send the host name via TLS SNI
+    std::optional<std::string> min_protocol_version; //!< `ssl_min_protocol_version`, e.g. `TLSv1.3`
+};
+
+namespace detail {
+
+constexpr const char* to_conninfo_value(ssl_mode v) noexcept {
+    switch (v) {
+        case ssl_mode::disable: return "disable";
+        case ssl_mode::allow: return "allow";
+        case ssl_mode::prefer: return "prefer";
+        case ssl_mode::require: return "require";
+        case ssl_mode::verify_ca: return "verify-ca";
+        case ssl_mode::verify_full: return "verify-full";
+    }
+    return "prefer";
+}
+
+constexpr const char* to_conninfo_value(ssl_negotiation v) noexcept {
+    switch (v) {
+        case ssl_negotiation::postgres: return "postgres";
+        case ssl_negotiation::direct: return "direct";
+    }
+    return "postgres";
+}
+
+/**
+* libpq 17 knows the `sslnegotiation` parameter, older versions fail the connect with
+* an unknown parameter.
+*/
+inline bool supports_ssl_negotiation(int libpq_version = PQlibVersion()) noexcept {
+    return libpq_version >= 170000;
+}
+
+/**
+* Throws `std::invalid_argument` for the options libpq rejects on each connect.
+*/
+inline void check_ssl_options(const ssl_options& options) {
+    if (options.negotiation == ssl_negotiation::direct
+            && (!options.mode || *options.mode < ssl_mode::require)) {
+        throw std::invalid_argument("ssl_options: direct SSL negotiation requires ssl_mode::require or stronger");
+    }
+}
+
+/**
+* Connection string parameters of the options.
+*/
+inline std::vector<std::pair<const char*, std::string>> get_ssl_parameters(const ssl_options& options,
+        int libpq_version = PQlibVersion()) {
+    std::vector<std::pair<const char*, std::string>> result;
+    if (options.mode) {
+        result.emplace_back("sslmode", to_conninfo_value(*options.mode));
+    }
+    if (options.negotiation && supports_ssl_negotiation(libpq_version)) {
+        result.emplace_back("sslnegotiation", to_conninfo_value(*options.negotiation));
+    }
+    if (options.root_cert) {
+        result.emplace_back("sslrootcert", *options.root_cert);
+    }
+    if (options.cert) {
+        result.emplace_back("sslcert", *options.cert);
+    }
+    if (options.key) {
+        result.emplace_back("sslkey", *options.key);
+    }
+    if (options.sni) {
+        result.emplace_back("sslsni", *options.sni ? "1" : "0");
+    }
+    if (options.min_protocol_version) {
+        result.emplace_back("ssl_min_protocol_version", *options.min_protocol_version);
+    }
+    return result;
+}
+
+} // namespace detail
+} // namespace ozo
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <ozo/error.h>
+
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+namespace ozo {
+
+/**
+ * @brief Fixed capacity container for result rows
+ * @ingroup group-requests-types
+ *
+ * Keeps up to `N` rows in an `std::array` with a count, so a lookup which returns at most
+ * `N` rows, e.g. a top-N query, receives its result without heap allocations for the
+ * container. A result with more rows than the free capacity is rejected before any row is
+ * received: the request completes with `ozo::error::too_many_rows` and the container is not
+ * changed. The same applies to other containers which declare a `static_capacity` member,
+ * e.g. `boost::container::static_vector`.
+ *
+ * The unused slots hold value-initialized rows, a removed row is reset to the value-initialized
+ * state, so the rows release their resources.
+ *
+ *@code
+#include <ozo/static_rows.h>
+ *@endcode
+ *
+ * ###Example
+ *
+ * @code
+ozo::static_rows<std::tuple<std::int64_t, double>, 5> top;
+ozo::request(conn_info[io], "SELECT id, score FROM scores ORDER BY score DESC LIMIT 5"_SQL, ozo::into(top), yield);
+ * @endcode
+ *
+ * @tparam Row --- type of a row.
+ * @tparam N --- capacity.
+ */
+template <typename Row, std::size_t N>
+class static_rows {
+    using storage_type = std::array<Row, N>;
+
+public:
+    using value_type = Row;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = Row&;
+    using const_reference = const Row&;
+    using iterator = typename storage_type::iterator;
+    using const_iterator = typename storage_type::const_iterator;
+
+    static constexpr size_type static_capacity = N;
+
+    size_type size() const noexcept { return size_;}
+    bool empty() const noexcept { return size_ == 0;}
+    static constexpr size_type capacity() noexcept { return N;}
+    static constexpr size_type max_size() noexcept { return N;}
+
+    iterator begin() noexcept { return rows_.begin();}
+    iterator end() noexcept { return rows_.begin() + size_;}
+    const_iterator begin() const noexcept { return rows_.begin();}
+    const_iterator end() const noexcept { return rows_.begin() + size_;}
+
+    Row* data() noexcept { return rows_.data();}
+    const Row* data() const noexcept { return rows_.data();}
+
+    Row& operator [](size_type i) noexcept { return rows_[i];}
+    const Row& operator [](size_type i) const noexcept { return rows_[i];}
+
+    Row& front() noexcept { return rows_.front();}
+    const Row& front() const noexcept { return rows_.front();}
+    Row& back() noexcept { return rows_[size_ - 1];}
+    const Row& back() const noexcept { return rows_[size_ - 1];}
+
+    /**
+     * Append a row.
+     *
+     * @throw ozo::system_error with `ozo::error::too_many_rows` if the container is full.
+     */
+    template <typename ...Args>
+    Row& emplace_back(Args&& ...args) {
+        if (size_ == N) {
+            throw system_error(error::too_many_rows, "static_rows capacity " + std::to_string(N) + " is exceeded");
+        }
+        auto& row = rows_[size_];
+        if constexpr (sizeof...(Args) != 0) {
+            row = Row(std::forward<Args>(args)...);
+        }
+        ++size_;
+        return row;
+    }
+
+    void push_back(const Row& row) { emplace_back(row);}
+    void push_back(Row&& row) { emplace_back(std::move(row));}
+
+    void pop_back() {
+        rows_[--size_] = Row{};
+    }
+
+    void clear() {
+        while (size_) {
+            pop_back();
+        }
+    }
+
+private:
+    storage_type rows_ {};
+    size_type size_ = 0;
+};
+
+/**
+ * @ingroup group-requests-types
+ * @brief Shortcut for a fixed capacity container of row tuples, see `ozo::static_rows`.
+ *
+ * @tparam N --- capacity.
+ * @tparam Ts --- types of columns in result.
+ */
+template <std::size_t N, typename ...Ts>
+using static_rows_of = static_rows<std::tuple<Ts...>, N>;
+
+} // namespace ozo
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <ozo/impl/async_stream_request.h>
+
+namespace ozo {
+
+/**
+ * @brief Streaming output which decodes rows into an output iterator
+ *
+ * Creates an output for `ozo::stream_request()` which decodes rows of each received
+ * result chunk into the iterator as soon as the chunk has been received.
+ * The iterator should model the same concepts as for `ozo::into()`. To keep memory
+ * usage bounded use `ozo::stream_chunks()` and consume rows of each chunk in place.
+ *
+ * @param out --- output iterator for rows
+ * @param rows_per_chunk --- maximum number of rows in a chunk; values greater than 1 require
+ *                           libpq 17 chunked rows mode, otherwise single row mode is used.
+ * @return streaming output object
+ * @ingroup group-requests-functions
+ */
+template <typename OutIterator>
+constexpr auto stream_into(OutIterator out, std::size_t rows_per_chunk = 1) {
+    return impl::stream_output {impl::stream_into_handler {std::move(out)}, rows_per_chunk};
+}
+
+/**
+ * @brief Streaming output which passes result chunks to a callback
+ *
+ * Creates an output for `ozo::stream_request()` which calls the callback with each
+ * received result chunk as `ozo::basic_result` object.
+ *
+ * @param callback --- callable with `void(ozo::basic_result<T>)` signature
+ * @param rows_per_chunk --- maximum number of rows in a chunk; values greater than 1 require
+ *                           libpq 17 chunked rows mode, otherwise single row mode is used.
+ * @return streaming output object
+ * @ingroup group-requests-functions
+ */
+template <typename Callback>
+constexpr auto stream_chunks(Callback callback, std::size_t rows_per_chunk = 1) {
+    return impl::stream_output {impl::stream_chunk_handler {std::move(callback)}, rows_per_chunk};
+}
+
+#ifdef OZO_DOCUMENTATION
+/**
+ * @brief Executes query and delivers the result by chunks
+ *
+ * This function is same as `ozo::request()` function except it does not wait for the
+ * whole result. The query is executed in the libpq single row mode (or chunked rows mode
+ * for libpq 17 and later), so the result is delivered to the output chunk by chunk as
+ * rows arrive. Only one chunk is kept in memory at a time and the first rows are available
+ * before the query has been completed.
+ *
+ * @note In case of chunk processing error the operation completes immediately and
+ * the rest of the result is not consumed, so the connection can not be reused.
+ *
+ * @param provider --- connection provider object
+ * @param query --- query object to request from a database
+ * @param time_constraint --- request #TimeConstraint; this time constrain <b>includes</b> time for getting connection from provider.
+ * @param out --- output made by `ozo::stream_into()` or `ozo::stream_chunks()`.
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ *
+ * ###Example
+ *
+ * @code
+std::size_t count = 0;
+ozo::stream_request(conn_info[io], "SELECT id FROM huge_table"_SQL, 1min,
+    ozo::stream_chunks([&] (auto chunk) { count += chunk.size(); }, 1000),
+    yield);
+ * @endcode
+ */
+template <typename ConnectionProvider, typename BinaryQueryConvertible, typename TimeConstraint, typename StreamOutput, typename CompletionToken>
+decltype(auto) stream_request(ConnectionProvider&& provider, BinaryQueryConvertible&& query, TimeConstraint time_constraint, StreamOutput out, CompletionToken&& token);
+
+/**
+ * @brief Executes query and delivers the result by chunks
+ *
+ * This function is time constrain free shortcut to `ozo::stream_request()` function.
+ * Its call is equal to `ozo::stream_request(provider, query, ozo::none, out, token)` call.
+ *
+ * @param provider --- connection provider object
+ * @param query --- query object to request from a database
+ * @param out --- output made by `ozo::stream_into()` or `ozo::stream_chunks()`.
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ */
+template <typename ConnectionProvider, typename BinaryQueryConvertible, typename StreamOutput, typename CompletionToken>
+decltype(auto) stream_request(ConnectionProvider&& provider, BinaryQueryConvertible&& query, StreamOutput out, CompletionToken&& token);
+#else
+
+template <typename Initiator>
+struct stream_request_op : base_async_operation <stream_request_op<Initiator>, Initiator> {
+    using base = typename stream_request_op::base;
+    using base::base;
+
+    template <typename P, typename Q, typename TimeConstraint, typename Out, typename CompletionToken>
+    decltype(auto) operator() (P&& provider, Q&& query, TimeConstraint t,
+            Out out, CompletionToken&& token) const {
+        static_assert(ConnectionProvider<P>, "provider should be a ConnectionProvider");
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        return async_initiate<CompletionToken, handler_signature<P>>(
+            get_operation_initiator(*this), token, std::forward<P>(provider), t, std::forward<Q>(query), std::move(out));
+    }
+
+    template <typename P, typename Q, typename Out, typename CompletionToken>
+    decltype(auto) operator()(P&& provider, Q&& query, Out out, CompletionToken&& token) const {
+        return (*this)(std::forward<P>(provider), std::forward<Q>(query), none, std::move(out),
+            std::forward<CompletionToken>(token));
+    }
+
+    template <typename OtherInitiator>
+    constexpr static auto rebind_initiator(const OtherInitiator& other) {
+        return stream_request_op<OtherInitiator>{other};
+    }
+};
+
+namespace detail {
+struct initiate_async_stream_request {
+    template <typename Handler, typename P, typename Q, typename TimeConstraint, typename Out>
+    constexpr void operator()(Handler&& h, P&& p, TimeConstraint t, Q&& q, Out out) const {
+        impl::async_stream_request(std::forward<P>(p), std::forward<Q>(q), t, std::move(out), std::forward<Handler>(h));
+    }
+};
+} // namespace detail
+
+constexpr stream_request_op<detail::initiate_async_stream_request> stream_request;
+
+#endif
+
+} // namespace ozo
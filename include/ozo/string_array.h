@@ -0,0 +1,274 @@
+#pragma once
+
+#include <ozo/io/array.h>
+#include <ozo/ext/std/string.h>
+
+#include <boost/iterator/iterator_facade.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace ozo {
+
+/**
+ * @brief Array of strings stored in a single buffer
+ *
+ * Keeps the bytes of all the elements contiguously in one buffer and the offset and the size of
+ * each of them in a separate vector, the elements are exposed as `std::string_view`. So a `text[]`
+ * value is received with a constant number of allocations instead of an allocation per element
+ * like `std::vector<std::string>`, and none at all if the array is received over an existing one
+ * with enough capacity, e.g. by `ozo::overwrite_rows`. Scanning the elements touches contiguous
+ * memory only.
+ *
+ * The storage is allocated by the `Allocator`, e.g. `ozo::arena_allocator` or a `std::pmr` one,
+ * so the arrays of all the rows of a container may share the same arena.
+ *
+ * The array is an `Array` model of `text` elements, NULL elements are supported: a NULL element
+ * is an empty view with the respective `is_null()` state. The views are valid until the array
+ * is modified or destroyed.
+ *
+ *@code
+#include <ozo/string_array.h>
+ *@endcode
+ *
+ * ###Example
+ *
+ * @code
+std::vector<std::tuple<std::int64_t, ozo::string_array<>>> rows;
+ozo::request(conn_info[io], "SELECT id, tags FROM documents"_SQL, ozo::into(rows), yield);
+for (const auto& [id, tags] : rows) {
+    if (std::find(tags.begin(), tags.end(), "urgent") != tags.end()) {
+        escalate(id);
+    }
+}
+ * @endcode
+ *
+ * @tparam Allocator --- allocator of the buffer, it is rebound for the elements index.
+ * @ingroup group-io-types
+ * @models{Array}
+ */
+template <typename Allocator = std::allocator<char>>
+class string_array {
+    struct element {
+        std::uint32_t offset;
+        std::int32_t size; // -1 for NULL
+    };
+
+    using allocator_traits = std::allocator_traits<Allocator>;
+
+public:
+    using value_type = std::string_view;
+    using reference = std::string_view;
+    using allocator_type = Allocator;
+    using size_type = std::size_t;
+    using buffer_type = std::vector<char, typename allocator_traits::template rebind_alloc<char>>;
+
+    class const_iterator : public boost::iterator_facade<
+        const_iterator,
+        std::string_view,
+        boost::random_access_traversal_tag,
+        std::string_view,
+        std::ptrdiff_t
+    > {
+    public:
+        const_iterator() = default;
+
+    private:
+        friend class string_array;
+        friend class boost::iterator_core_access;
+
+        const_iterator(const string_array* array, std::ptrdiff_t index) noexcept : array_(array), index_(index) {}
+
+        std::string_view dereference() const noexcept { return (*array_)[size_type(index_)];}
+        bool equal(const const_iterator& other) const noexcept { return index_ == other.index_;}
+        void increment() noexcept { ++index_;}
+        void decrement() noexcept { --index_;}
+        void advance(std::ptrdiff_t n) noexcept { index_ += n;}
+        std::ptrdiff_t distance_to(const const_iterator& other) const noexcept { return other.index_ - index_;}
+
+        const string_array* array_ = nullptr;
+        std::ptrdiff_t index_ = 0;
+    };
+
+    using iterator = const_iterator;
+
+    string_array() = default;
+
+    explicit string_array(const Allocator& allocator)
+    : buffer_(typename buffer_type::allocator_type(allocator)), elements_(typename elements_type::allocator_type(allocator)) {}
+
+    size_type size() const noexcept { return elements_.size();}
+    bool empty() const noexcept { return elements_.empty();}
+
+    const_iterator begin() const noexcept { return {this, 0};}
+    const_iterator end() const noexcept { return {this, std::ptrdiff_t(size())};}
+
+    /**
+     * Element view, empty for a NULL element.
+     */
+    std::string_view operator [](size_type i) const noexcept {
+        const auto& e = elements_[i];
+        return e.size < 0 ? std::string_view{} : std::string_view(buffer_.data() + e.offset, size_type(e.size));
+    }
+
+    bool is_null(size_type i) const noexcept { return elements_[i].size < 0;}
+
+    /**
+     * Buffer with the bytes of all the elements.
+     */
+    const buffer_type& buffer() const noexcept { return buffer_;}
+
+    /**
+     * Reserve the storage for `n` elements of `bytes` total size.
+     */
+    void reserve(size_type n, size_type bytes) {
+        elements_.reserve(n);
+        buffer_.reserve(bytes);
+    }
+
+    /**
+     * Remove the elements keeping the capacity.
+     */
+    void clear() noexcept {
+        elements_.clear();
+        buffer_.clear();
+    }
+
+    void push_back(std::string_view v) {
+        elements_.push_back(element{std::uint32_t(buffer_.size()), std::int32_t(v.size())});
+        buffer_.insert(buffer_.end(), v.begin(), v.end());
+    }
+
+    void push_null() {
+        elements_.push_back(element{std::uint32_t(buffer_.size()), -1});
+    }
+
+    friend bool operator ==(const string_array& lhs, const string_array& rhs) {
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+        for (size_type i = 0; i < lhs.size(); ++i) {
+            if (lhs.is_null(i) != rhs.is_null(i) || lhs[i] != rhs[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    friend bool operator !=(const string_array& lhs, const string_array& rhs) { return !(lhs == rhs);}
+
+private:
+    using elements_type = std::vector<element, typename allocator_traits::template rebind_alloc<element>>;
+
+    buffer_type buffer_;
+    elements_type elements_;
+};
+
+template <typename Allocator>
+struct is_array<string_array<Allocator>> : std::true_type {};
+
+} // namespace ozo
+
+namespace ozo::detail {
+
+template <typename Allocator>
+struct size_of_array_impl<string_array<Allocator>> {
+    static constexpr auto apply(const string_array<Allocator>& v) {
+        constexpr const auto header_size = hana::unpack(
+            hana::members(pg_array{}),
+            [] (const auto& ...x) { return (sizeof(x) + ... + 0); });
+
+        constexpr const auto dimension_header_size = hana::unpack(
+            hana::members(pg_array_dimension{}),
+            [] (const auto& ...x) { return (sizeof(x) + ... + 0); });
+
+        const auto data_size = v.size() * sizeof(size_type) + v.buffer().size();
+
+        return static_cast<size_type>(header_size + dimension_header_size + data_size);
+    }
+};
+
+template <typename Allocator>
+struct send_array_impl<string_array<Allocator>> {
+    template <typename OidMap>
+    static ostream& apply(ostream& out, const OidMap& oid_map, const string_array<Allocator>& in) {
+        write(out, pg_array {1, 0, type_oid<std::string_view>(oid_map)});
+        write(out, pg_array_dimension {size_type(in.size()), 0});
+        for (std::size_t i = 0; i < in.size(); ++i) {
+            if (in.is_null(i)) {
+                write(out, static_cast<size_type>(null_state_size));
+            } else {
+                send_data_frame(out, oid_map, in[i]);
+            }
+        }
+        return out;
+    }
+};
+
+/**
+ * The elements are copied into the buffer reserved for the whole array data, so
+ * receiving an array costs at most two allocations.
+ */
+template <typename Allocator>
+struct recv_array_impl<string_array<Allocator>> {
+    using out_type = string_array<Allocator>;
+
+    template <typename OidMap>
+    static istream& apply(istream& in, size_type size, const OidMap& oids, out_type& out) {
+        pg_array array_header;
+        pg_array_dimension dim_header;
+
+        read(in, array_header);
+
+        if (array_header.dimensions_count > 1) {
+            throw system_error(error::bad_array_dimension,
+                "multiply dimension count is not supported: "
+                 + std::to_string(array_header.dimensions_count));
+        }
+
+        if (!accepts_oid<std::string_view>(oids, array_header.elemtype)) {
+            throw system_error(error::oid_type_mismatch,
+                "unexpected oid " + std::to_string(array_header.elemtype)
+                + " for element type of " + boost::core::demangle(typeid(std::string_view).name()));
+        }
+
+        out.clear();
+
+        if (array_header.dimensions_count < 1) {
+            return in;
+        }
+
+        read(in, dim_header);
+
+        if (dim_header.size <= 0) {
+            return in;
+        }
+
+        const auto count = std::size_t(dim_header.size);
+        // The data size of the array is the upper bound of the elements size
+        out.reserve(count, std::size_t(std::max(size, size_type(0))));
+
+        for (std::size_t i = 0; i < count; ++i) {
+            size_type item_size = 0;
+            read(in, item_size);
+            if (item_size == null_state_size) {
+                out.push_null();
+                continue;
+            }
+            if (item_size < 0) {
+                throw system_error(error::bad_object_size, "negative size of an array element");
+            }
+            const auto data = in.peek(item_size);
+            if (!data) {
+                throw system_error(error::unexpected_eof);
+            }
+            out.push_back(std::string_view(data, std::size_t(item_size)));
+            in.skip(item_size);
+        }
+        return in;
+    }
+};
+
+} // namespace ozo::detail
@@ -3,8 +3,40 @@
 #include <ozo/core/concept.h>
 #include <chrono>
 
+#include <time.h>
+
 namespace ozo {
 
+/**
+ * @brief Coarse steady clock
+ * @ingroup group-core-types
+ *
+ * Clock with the `std::chrono::steady_clock` time points read via `CLOCK_MONOTONIC_COARSE`
+ * where it is available, e.g. on Linux. The coarse clock is read from the kernel data without
+ * the clocksource access, so it costs a few nanoseconds even on virtual machines with a slow
+ * clocksource, but its resolution is the scheduler tick of 1--4 ms, so the time it returns may
+ * lag behind `std::chrono::steady_clock::now()` by a tick. Falls back to `std::chrono::steady_clock`
+ * otherwise.
+ */
+struct coarse_steady_clock {
+    using duration = std::chrono::steady_clock::duration;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::steady_clock::time_point;
+    static constexpr bool is_steady = true;
+
+    static time_point now() noexcept {
+#ifdef CLOCK_MONOTONIC_COARSE
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+        return time_point{std::chrono::duration_cast<duration>(
+            std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec))};
+#else
+        return std::chrono::steady_clock::now();
+#endif
+    }
+};
+
 /**
  * @brief Time traits of the library
  * @ingroup group-core-types
@@ -12,13 +44,23 @@ namespace ozo {
 struct time_traits {
     using duration = std::chrono::steady_clock::duration; //!< Time duration type of the library
     using time_point = std::chrono::steady_clock::time_point; //!< Time point type of the library
+#ifdef OZO_COARSE_CLOCK
+    using clock = coarse_steady_clock; //!< Clock of the library
+#else
+    using clock = std::chrono::steady_clock; //!< Clock of the library
+#endif
     /**
      * Get current time
      *
+     * The time is read from `std::chrono::steady_clock` or, if `OZO_COARSE_CLOCK` is defined,
+     * e.g. by the `OZO_COARSE_CLOCK` CMake option, from `ozo::coarse_steady_clock`. The deadlines
+     * of the time constrained operations are calculated from it, so with the coarse clock they
+     * may come a scheduler tick earlier.
+     *
      * @return time_point --- current time
      */
-    static time_point now() noexcept(noexcept(std::chrono::steady_clock::now())) {
-        return std::chrono::steady_clock::now();
+    static time_point now() noexcept(noexcept(clock::now())) {
+        return clock::now();
     }
 };
 
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <ozo/asio.h>
+
+namespace ozo {
+
+/**
+ * @brief Enables the timer wheel for the operations deadlines of the `io_context`
+ *
+ * By default each time-constrained operation arms its own `steady_timer`, so every
+ * deadline is inserted into and removed from the timer queue of the `io_context`.
+ * With a lot of concurrent operations this becomes measurable. After the call the
+ * deadlines of the operations executed on the `io_context` are kept in a hashed timer
+ * wheel with the millisecond resolution, which is driven by a single `steady_timer`, so
+ * arming and disarming a deadline is O(1). A deadline expires not later than a
+ * millisecond after its time point.
+ *
+ * The function should be called before operations are started on the `io_context`,
+ * the subsequent calls have no effect.
+ *
+ * @param io --- `io_context` for the operations.
+ * @param slots_count --- number of the wheel slots, should be a power of two. The deadlines
+ *                        which are farther than the number of milliseconds are kept in the wheel
+ *                        for several rounds.
+ * @ingroup group-core-functions
+ *
+ * ###Example
+ *
+ * @code
+ozo::io_context io;
+ozo::use_timer_wheel(io);
+ozo::request(conn_info[io], "SELECT 1"_SQL, 100ms, ozo::into(rows), yield);
+ * @endcode
+ */
+inline void use_timer_wheel(io_context& io, std::size_t slots_count = detail::timer_wheel_service::default_slots_count) {
+    if (!asio::has_service<detail::timer_wheel_service>(io)) {
+        asio::make_service<detail::timer_wheel_service>(io, slots_count);
+    }
+}
+
+} // namespace ozo
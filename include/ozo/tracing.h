@@ -0,0 +1,129 @@
+#pragma once
+
+#include <ozo/connection_statistics.h>
+#include <ozo/time_traits.h>
+
+#include <cstddef>
+#include <string_view>
+#include <utility>
+
+/**
+ * @defgroup group-tracing Tracing
+ * @ingroup group-core
+ * @brief Spans of the connection establishment and the request phases.
+ *
+ * `ozo::tracing_statistics` is a Statistics model which turns `ozo::connect_timeline` and
+ * `ozo::request_timeline` of a connection into `ozo::trace_span` objects passed to a user
+ * defined tracer, e.g. an adapter which starts and ends an OpenTelemetry span with the given
+ * timestamps. The tracer is selected at compile time via the Statistics type of
+ * `ozo::connection_info`, so a connection with no tracer bound has neither virtual calls
+ * nor clock reads for the timelines.
+ *
+ *@code
+#include <ozo/tracing.h>
+ *@endcode
+ */
+
+namespace ozo {
+
+/**
+ * @brief Kind of a traced phase
+ * @ingroup group-tracing
+ */
+enum class trace_span_kind {
+    connect, //!< connection establishment, see `ozo::connect_timeline`
+    acquire, //!< connection acquisition for a request, including the connection establishment
+    send, //!< sending of the query
+    wait, //!< waiting for the result from the server
+    decode, //!< processing of the result and the completion of the request
+};
+
+/**
+ * @brief Span of a traced phase
+ * @ingroup group-tracing
+ */
+struct trace_span {
+    trace_span_kind kind; //!< phase of the span
+    time_traits::time_point start; //!< start of the phase
+    time_traits::time_point end; //!< end of the phase
+    bool failed = false; //!< `true` if the operation failed during the phase
+    std::string_view host; //!< host of the connection, valid during the tracer call only
+    std::size_t rows = 0; //!< number of rows received, for the `trace_span_kind::decode` span only
+};
+
+/**
+ * @brief Statistics model which emits the spans of the connection phases to a tracer
+ *
+ * A connect operation emits the `trace_span_kind::connect` span. A request emits the
+ * `trace_span_kind::acquire`, `trace_span_kind::send`, `trace_span_kind::wait` and
+ * `trace_span_kind::decode` spans; the phases which have not been reached due to an error are
+ * skipped and the last reached one is marked as failed. The spans of a request are emitted
+ * on its completion from the connection owner thread.
+ *
+ * The query name is not known to the request operation, so a tracer which needs it should
+ * take it from the context of the request, e.g. the active span of the caller.
+ *
+ * @tparam Tracer --- callable with `void(const ozo::trace_span&)` signature.
+ * @ingroup group-tracing
+ *
+ * ###Example
+ *
+ * @code
+struct otel_tracer {
+    void operator() (const ozo::trace_span& v) const {
+        auto span = tracer->StartSpan(name(v.kind), {{"db.host", v.host}}, start_options(v.start));
+        span->End(end_options(v.end));
+    }
+};
+
+const auto conn_info = ozo::connection_info(conn_str, ozo::empty_oid_map{},
+    ozo::make_tracing_statistics(otel_tracer{}));
+ * @endcode
+ */
+template <typename Tracer>
+class tracing_statistics {
+public:
+    tracing_statistics(Tracer tracer = Tracer{}) : tracer_(std::move(tracer)) {}
+
+    void update(connect_timeline_key_t, const connect_timeline& v) {
+        tracer_(trace_span{trace_span_kind::connect, v.started, v.finished, v.failed, v.host});
+    }
+
+    void update(request_timeline_key_t, const request_timeline& v) {
+        if (emit(trace_span_kind::acquire, v.requested, v.acquired, v)
+                && emit(trace_span_kind::send, v.acquired, v.sent, v)
+                && emit(trace_span_kind::wait, v.sent, v.received, v)) {
+            tracer_(trace_span{trace_span_kind::decode, v.received, v.finished, v.failed, v.host, v.rows});
+        }
+    }
+
+    const Tracer& tracer() const noexcept { return tracer_;}
+
+private:
+    Tracer tracer_;
+
+    // Emits the span of a reached phase, the one which has not been completed ends with the request.
+    bool emit(trace_span_kind kind, time_traits::time_point start, time_traits::time_point end,
+            const request_timeline& v) {
+        if (start == time_traits::time_point{}) {
+            return false;
+        }
+        const bool completed = end != time_traits::time_point{};
+        tracer_(trace_span{kind, start, completed ? end : v.finished, v.failed && !completed, v.host});
+        return completed;
+    }
+};
+
+/**
+ * @brief Creates `ozo::tracing_statistics` with the tracer
+ *
+ * @param tracer --- callable with `void(const ozo::trace_span&)` signature.
+ * @return `ozo::tracing_statistics` object.
+ * @ingroup group-tracing
+ */
+template <typename Tracer>
+inline auto make_tracing_statistics(Tracer&& tracer) {
+    return tracing_statistics<std::decay_t<Tracer>>{std::forward<Tracer>(tracer)};
+}
+
+} // namespace ozo
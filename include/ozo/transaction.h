@@ -255,6 +255,52 @@ public:
      */
     constexpr const options_type& options() const noexcept { return options_;}
 
+    /**
+     * Determine whether the BEGIN statement of the transaction has not been sent yet.
+     * It is the case for a transaction started with the `ozo::transaction_options::deferred_begin`
+     * option until the first request is made, see `ozo::begin()` for the details. The state is
+     * reported by the server, so it is the same for all the copies of the transaction object.
+     * The object may be used in noninitialized state for this call.
+     */
+    bool is_begin_pending() const noexcept {
+        if constexpr (detail::is_begin_lazy<options_type>::value) {
+            return begin_elided_ && is_idle();
+        } else if constexpr (detail::is_begin_deferred<options_type>::value) {
+            return is_idle();
+        } else {
+            return false;
+        }
+    }
+
+    /**
+     * Determine whether the next request of the transaction may be executed without the BEGIN
+     * statement. It is the case for a read only transaction started with the
+     * `ozo::transaction_options::lazy_begin` option until the first request is made, see
+     * `ozo::begin()` for the details. Unlike the pending state, the state is kept by the
+     * object, so it is not shared with the copies of the transaction object.
+     * The object may be used in noninitialized state for this call.
+     */
+    bool is_begin_elidable() const noexcept {
+        if constexpr (detail::is_begin_lazy<options_type>::value) {
+            return !begin_elided_ && is_idle();
+        } else {
+            return false;
+        }
+    }
+
+    /**
+     * Mark the request being executed as the one executed without the BEGIN statement,
+     * so the statement is sent with the next request of the transaction.
+     *
+     * Typically this function is used by the library within request execution.
+     */
+    void elide_begin() noexcept { begin_elided_ = true;}
+
+    /**
+     * Get the BEGIN statement of the transaction which is built from the transaction options.
+     */
+    constexpr auto begin_statement() const { return detail::begin_statement_builder::statement(options_);}
+
     /**
      * Get a reference to the lowest layer.
      *
@@ -272,9 +318,14 @@ public:
 private:
     bool is_null() const noexcept { return ozo::is_null(impl_); }
 
+    bool is_idle() const noexcept {
+        return !is_null() && PQtransactionStatus(native_handle()) == PQTRANS_IDLE;
+    }
+
     friend struct is_null_impl<transaction>;
     handle_type impl_;
     options_type options_;
+    bool begin_elided_ = false;
 };
 
 template <typename ...Ts>
@@ -319,6 +370,45 @@ ozo::begin.with_transaction_options(ozo::make_options(Options...));
  *
  * there `%Options` are available items of `ozo::transaction_options`.
  *
+ * @par Deferred BEGIN
+ *
+ * With the `ozo::transaction_options::deferred_begin` option the BEGIN statement is not sent
+ * by the function, it just provides the transaction object. The statement is sent in a
+ * pipeline together with the first `ozo::request()` or `ozo::execute()` of the transaction,
+ * so a short transaction takes one round trip less. Any other operation sends the pending
+ * BEGIN with a separate round trip first. Commit or rollback of a transaction with the BEGIN
+ * still pending completes immediately without a round trip. libpq 14 or later is required,
+ * otherwise the option is ignored and the BEGIN statement is sent by the function.
+ *
+ * @par Lazy BEGIN
+ *
+ * The `ozo::transaction_options::lazy_begin` option defers the BEGIN statement further for
+ * a read only transaction: the first `ozo::request()` or `ozo::execute()` of the transaction
+ * is executed without BEGIN and the statement is sent in a pipeline with the second one, so
+ * a transaction of a single statement takes neither BEGIN nor COMMIT. Any other operation
+ * sends the BEGIN first as with the deferred BEGIN. A single read only statement gives the
+ * same result within a transaction only if the statement takes the snapshot of its own, so
+ * the option behaves as `ozo::transaction_options::deferred_begin` unless the
+ * `ozo::transaction_mode::read_only` mode is set and the isolation level is not set or is
+ * `ozo::isolation_level::read_committed` or `ozo::isolation_level::read_uncommitted`.
+ * libpq 14 or later is required, otherwise the option is ignored.
+ *
+ * @code
+const auto options = ozo::make_options(
+    ozo::transaction_options::mode = ozo::transaction_mode::read_only,
+    ozo::transaction_options::lazy_begin = std::true_type{});
+auto transaction = ozo::begin.with_transaction_options(options)(conn_info[io], yield);
+transaction = ozo::request(std::move(transaction), "SELECT balance FROM accounts"_SQL, ozo::into(res), yield);
+auto conn = ozo::commit(std::move(transaction), yield);
+ * @endcode
+ *
+ * @code
+const auto options = ozo::make_options(ozo::transaction_options::deferred_begin = std::true_type{});
+auto transaction = ozo::begin.with_transaction_options(options)(conn_info[io], yield);
+transaction = ozo::execute(std::move(transaction), "UPDATE accounts SET balance = 0"_SQL, yield);
+auto conn = ozo::commit(std::move(transaction), yield);
+ * @endcode
+ *
  * @par Example
  *
  * For full example see [examples/transaction.cpp](examples/transaction.cpp).
@@ -362,7 +452,7 @@ struct begin_op : base_async_operation <begin_op<Initiator, Options>, Initiator>
         using namespace ozo::literals;
         return async_initiate<CompletionToken, handler_signature<transaction<connection_type<T>, Options>>>(
             get_operation_initiator(*this), token,
-            std::forward<T>(provider), options_, detail::begin_statement_builder::build(options_), t);
+            std::forward<T>(provider), options_, detail::begin_statement_builder::statement(options_), t);
     }
 
     template <typename T, typename CompletionToken>
@@ -590,3 +680,12 @@ constexpr auto get_transaction_deferrability(const transaction<Ts...>& transacti
 } // namespace ozo
 
 #include <ozo/impl/transaction.h>
+
+#ifdef OZO_EXTERN_TEMPLATES
+#include <ozo/connection_info.h>
+
+namespace ozo {
+extern template class transaction<connection_info<empty_oid_map, no_statistics>::connection_type,
+    decltype(make_options())>;
+} // namespace ozo
+#endif
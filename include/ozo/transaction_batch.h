@@ -0,0 +1,129 @@
+#pragma once
+
+#include <ozo/impl/async_transaction_batch.h>
+
+#ifdef LIBPQ_HAS_PIPELINING
+
+namespace ozo {
+
+#ifdef OZO_DOCUMENTATION
+/**
+ * @brief Executes queries in a transaction in one round trip
+ *
+ * The function gets a connection from the provider, switches it into the pipeline mode and
+ * sends BEGIN, all the queries and COMMIT back to back with the only synchronization point.
+ * So the whole transaction takes one round trip and the server holds its locks no longer
+ * than it takes to execute the statements. A failed statement aborts the rest of the
+ * transaction including COMMIT, in this case the transaction is rolled back and the operation
+ * completes with the error of the statement. Results of the queries are not received, instead
+ * an `ozo::batch_statement_result` with the error and the number of affected rows is written
+ * into the output for each query in the order they were sent. The queries which have not been
+ * executed due to a previous error get the `ozo::error::pipeline_aborted` error.
+ *
+ * Requires libpq 14 or later.
+ *
+ * @note The function does not particitate in ADL since could be implemented via functional object.
+ *
+ * @param provider --- connection provider object
+ * @param queries --- `boost::hana::tuple` of #BinaryQueryConvertible queries or a range of
+ * #BinaryQueryConvertible queries, e.g. `std::vector<ozo::binary_query>`
+ * @param out --- output iterator for `ozo::batch_statement_result` objects.
+ * @param time_constraint --- request #TimeConstraint; this time constrain <b>includes</b> time for getting connection from provider.
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ *
+ * @par Transaction options
+ *
+ * Transaction may be started with specialized options like isolation level, mode and so on
+ * the same way as with `ozo::begin()`:
+ *
+ * @code
+ozo::transaction_batch.with_transaction_options(ozo::make_options(Options...));
+ * @endcode
+ *
+ * there `%Options` are available items of `ozo::transaction_options`.
+ *
+ * @ingroup group-transaction-functions
+ *
+ * ###Example
+ *
+ * @code
+std::vector<ozo::batch_statement_result> results;
+auto conn = ozo::transaction_batch(conn_info[io], hana::make_tuple(
+    "UPDATE accounts SET balance = balance - 100 WHERE name = 'Alice'"_SQL,
+    "UPDATE accounts SET balance = balance + 100 WHERE name = 'Bob'"_SQL
+), std::back_inserter(results), 500ms, yield);
+ * @endcode
+ */
+template <typename ConnectionProvider, typename Queries, typename OutputIterator, typename TimeConstraint, typename CompletionToken>
+decltype(auto) transaction_batch(ConnectionProvider&& provider, Queries&& queries, OutputIterator out,
+        TimeConstraint time_constraint, CompletionToken&& token);
+
+/**
+ * @brief Executes queries in a transaction in one round trip
+ *
+ * This function is time constrain free shortcut to `ozo::transaction_batch()` function.
+ * Its call is equal to `ozo::transaction_batch(provider, queries, out, ozo::none, token)` call.
+ *
+ * @note The function does not particitate in ADL since could be implemented via functional object.
+ *
+ * @param provider --- connection provider object
+ * @param queries --- `boost::hana::tuple` or a range of #BinaryQueryConvertible queries
+ * @param out --- output iterator for `ozo::batch_statement_result` objects.
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-transaction-functions
+ */
+template <typename ConnectionProvider, typename Queries, typename OutputIterator, typename CompletionToken>
+decltype(auto) transaction_batch(ConnectionProvider&& provider, Queries&& queries, OutputIterator out, CompletionToken&& token);
+#else
+
+namespace detail {
+struct initiate_async_transaction_batch {
+    template <typename Handler, typename P, typename TimeConstraint, typename Options, typename Queries, typename Out>
+    constexpr void operator()(Handler&& h, P&& provider, TimeConstraint t, Options&& options, Queries&& queries, Out out) const {
+        impl::async_transaction_batch(std::forward<P>(provider), std::forward<Options>(options),
+            std::forward<Queries>(queries), std::move(out), t, std::forward<Handler>(h));
+    }
+};
+} // namespace detail
+
+template <typename Initiator, typename Options = decltype(make_options())>
+struct transaction_batch_op : base_async_operation <transaction_batch_op<Initiator, Options>, Initiator> {
+    using base = typename transaction_batch_op::base;
+    Options options_;
+
+    constexpr explicit transaction_batch_op(Initiator initiator = {}, Options options = {}) : base(initiator), options_(options) {}
+
+    template <typename P, typename Queries, typename Out, typename TimeConstraint, typename CompletionToken>
+    decltype(auto) operator() (P&& provider, Queries&& queries, Out out, TimeConstraint t, CompletionToken&& token) const {
+        static_assert(ConnectionProvider<P>, "provider should be a ConnectionProvider");
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        return async_initiate<CompletionToken, handler_signature<P>>(
+            get_operation_initiator(*this), token, std::forward<P>(provider), t, options_,
+            std::forward<Queries>(queries), std::move(out));
+    }
+
+    template <typename P, typename Queries, typename Out, typename CompletionToken>
+    decltype(auto) operator() (P&& provider, Queries&& queries, Out out, CompletionToken&& token) const {
+        return (*this)(std::forward<P>(provider), std::forward<Queries>(queries), std::move(out), none,
+            std::forward<CompletionToken>(token));
+    }
+
+    template <typename OtherOptions>
+    constexpr auto with_transaction_options(const OtherOptions& options) const {
+        return transaction_batch_op<Initiator, OtherOptions>{get_operation_initiator(*this), options};
+    }
+
+    template <typename OtherInitiator>
+    constexpr auto rebind_initiator(const OtherInitiator& other) const {
+        return transaction_batch_op<OtherInitiator, Options>{other, options_};
+    }
+};
+
+inline constexpr transaction_batch_op<detail::initiate_async_transaction_batch> transaction_batch;
+#endif
+
+} // namespace ozo
+
+#endif
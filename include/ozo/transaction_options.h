@@ -4,6 +4,7 @@
 #include <boost/hana/type.hpp>
 #include <ozo/core/none.h>
 #include <ozo/core/options.h>
+#include <libpq-fe.h>
 #include <type_traits>
 
 namespace ozo {
@@ -66,6 +67,50 @@ struct transaction_options {
     constexpr static option<class isolation_level_tag> isolation_level{}; //!< Transaction isolation level, see ozo::isolation_level
     constexpr static option<class mode_tag> mode{}; //!< Transaction mode, see ozo::transaction_mode
     constexpr static option<class deferrability_tag> deferrability{}; //!< Transaction deferrability, see ozo::deferrable_mode
+    constexpr static option<class deferred_begin_tag> deferred_begin{}; //!< Send BEGIN together with the first request of the transaction, `std::true_type` to enable, see ozo::begin
+    constexpr static option<class lazy_begin_tag> lazy_begin{}; //!< Execute the first request of a read only transaction without BEGIN, `std::true_type` to enable, see ozo::begin
 };
 
+namespace detail {
+
+// The deferred BEGIN is sent within a pipeline, so the option is ignored without pipeline mode support.
+#ifdef LIBPQ_HAS_PIPELINING
+template <typename Options, typename Option>
+using transaction_option_type = std::decay_t<decltype(get_option(std::declval<const Options&>(),
+    Option{}, std::false_type{}))>;
+
+template <typename Options>
+using is_lazy_begin_requested = transaction_option_type<Options, decltype(transaction_options::lazy_begin)>;
+
+template <typename Options>
+using is_begin_deferred = std::disjunction<
+    transaction_option_type<Options, decltype(transaction_options::deferred_begin)>,
+    is_lazy_begin_requested<Options>>;
+
+template <typename Level>
+using is_statement_snapshot_level = std::disjunction<
+    std::is_same<Level, std::false_type>,
+    std::is_same<Level, none_t>,
+    std::is_same<Level, std::decay_t<decltype(isolation_level::read_committed)>>,
+    std::is_same<Level, std::decay_t<decltype(isolation_level::read_uncommitted)>>>;
+
+// The first statement of a transaction may be executed without BEGIN only if it gives
+// the same result within the transaction, i.e. the transaction is read only and each its
+// statement takes a snapshot of its own. Otherwise the lazy BEGIN is deferred only.
+template <typename Options>
+using is_begin_lazy = std::conjunction<
+    is_lazy_begin_requested<Options>,
+    std::is_same<transaction_option_type<Options, decltype(transaction_options::mode)>,
+        std::decay_t<decltype(transaction_mode::read_only)>>,
+    is_statement_snapshot_level<transaction_option_type<Options, decltype(transaction_options::isolation_level)>>>;
+#else
+template <typename Options>
+using is_begin_deferred = std::false_type;
+
+template <typename Options>
+using is_begin_lazy = std::false_type;
+#endif
+
+} // namespace detail
+
 } // ozo
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <ozo/impl/async_transaction_retry.h>
+
+namespace ozo {
+
+#ifdef OZO_DOCUMENTATION
+/**
+ * @brief Runs a transaction and retries it on serialization conflicts
+ *
+ * Under the `ozo::isolation_level::serializable` or `ozo::isolation_level::repeatable_read` isolation level
+ * the server aborts some of the concurrent transactions with `ozo::sqlstate::serialization_failure`, and
+ * any transaction may be aborted with `ozo::sqlstate::deadlock_detected`. Such a transaction should be
+ * run again from the beginning. The function begins a transaction, runs the body in it and commits it.
+ * If the body or COMMIT fails with an error of the `ozo::errc::serialization_conflict` condition, the
+ * transaction is rolled back and the body runs again in a new transaction after a random delay, see
+ * `ozo::failover::exponential_backoff`. The delay takes no more than a half of the time left.
+ *
+ * The retry reuses the connection of the failed transaction if it is still healthy after the rollback,
+ * so a pooled connection is not returned to the pool and taken again. Otherwise the connection is taken
+ * from the provider.
+ *
+ * The body is called with the transaction, the deadline of the whole operation and a handler with
+ * `void(ozo::error_code, Transaction)` signature, which should be called with the transaction once
+ * the body has done. The body may be called several times, so it should be CopyConstructible and
+ * should not keep the results of a failed run.
+ *
+ * The operation completes with the connection after COMMIT, or with the last error and the connection
+ * after the rollback once the error is not a serialization conflict or the tries or the time are over.
+ *
+ * @note The function does not particitate in ADL since could be implemented via functional object.
+ *
+ * @param provider --- `ConnectionProvider` to get connection from.
+ * @param body --- transaction body.
+ * @param time_constraint --- operation `TimeConstraint` of all the tries including the delays.
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ *
+ * @par Options
+ *
+ * The transaction options and the retry policy may be specified the same way as with `ozo::begin()`:
+ *
+ * @code
+ozo::retry_transaction
+    .with_transaction_options(ozo::make_options(Options...))
+    .with_retry_policy(ozo::transaction_retry_policy{5});
+ * @endcode
+ *
+ * there `%Options` are available items of `ozo::transaction_options`.
+ *
+ * ###Example
+ *
+ * @code
+const auto options = ozo::make_options(ozo::transaction_options::isolation_level = ozo::isolation_level::serializable);
+auto conn = ozo::retry_transaction.with_transaction_options(options)(conn_info[io],
+    [&] (auto transaction, auto deadline, auto handler) {
+        ozo::execute(std::move(transaction), "UPDATE accounts SET balance = balance + 100"_SQL, deadline, std::move(handler));
+    }, 500ms, yield);
+ * @endcode
+ * @ingroup group-transaction-functions
+ */
+template <typename ConnectionProvider, typename Body, typename TimeConstraint, typename CompletionToken>
+decltype(auto) retry_transaction(ConnectionProvider&& provider, Body&& body, TimeConstraint time_constraint, CompletionToken&& token);
+
+/**
+ * @brief Runs a transaction and retries it on serialization conflicts
+ *
+ * This function is time constrain free shortcut to `ozo::retry_transaction()` function.
+ * Its call is equal to `ozo::retry_transaction(provider, body, ozo::none, token)` call.
+ *
+ * @note The function does not particitate in ADL since could be implemented via functional object.
+ *
+ * @param provider --- `ConnectionProvider` to get connection from.
+ * @param body --- transaction body.
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-transaction-functions
+ */
+template <typename ConnectionProvider, typename Body, typename CompletionToken>
+decltype(auto) retry_transaction(ConnectionProvider&& provider, Body&& body, CompletionToken&& token);
+#else
+
+namespace detail {
+struct initiate_async_transaction_retry {
+    template <typename Handler, typename P, typename Body, typename Options, typename TimeConstraint>
+    constexpr void operator()(Handler&& h, P&& provider, Body&& body, Options&& options, TimeConstraint t,
+            const transaction_retry_policy& policy) const {
+        impl::async_transaction_retry(std::forward<P>(provider), std::forward<Body>(body),
+            std::forward<Options>(options), t, policy, std::forward<Handler>(h));
+    }
+};
+} // namespace detail
+
+template <typename Initiator, typename Options = decltype(make_options())>
+struct retry_transaction_op : base_async_operation <retry_transaction_op<Initiator, Options>, Initiator> {
+    using base = typename retry_transaction_op::base;
+    Options options_;
+    transaction_retry_policy policy_;
+
+    constexpr explicit retry_transaction_op(Initiator initiator = {}, Options options = {},
+            transaction_retry_policy policy = {})
+    : base(initiator), options_(options), policy_(policy) {}
+
+    template <typename P, typename Body, typename TimeConstraint, typename CompletionToken>
+    decltype(auto) operator() (P&& provider, Body&& body, TimeConstraint t, CompletionToken&& token) const {
+        static_assert(ConnectionProvider<P>, "provider should be a ConnectionProvider");
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        return async_initiate<CompletionToken, handler_signature<P>>(
+            get_operation_initiator(*this), token, std::forward<P>(provider), std::forward<Body>(body),
+            options_, t, policy_);
+    }
+
+    template <typename P, typename Body, typename CompletionToken>
+    decltype(auto) operator() (P&& provider, Body&& body, CompletionToken&& token) const {
+        return (*this)(std::forward<P>(provider), std::forward<Body>(body), none,
+            std::forward<CompletionToken>(token));
+    }
+
+    template <typename OtherOptions>
+    constexpr auto with_transaction_options(const OtherOptions& options) const {
+        return retry_transaction_op<Initiator, OtherOptions>{get_operation_initiator(*this), options, policy_};
+    }
+
+    constexpr auto with_retry_policy(const transaction_retry_policy& policy) const {
+        return retry_transaction_op{get_operation_initiator(*this), options_, policy};
+    }
+
+    template <typename OtherInitiator>
+    constexpr auto rebind_initiator(const OtherInitiator& other) const {
+        return retry_transaction_op<OtherInitiator, Options>{other, options_, policy_};
+    }
+};
+
+inline constexpr retry_transaction_op<detail::initiate_async_transaction_retry> retry_transaction;
+#endif
+
+} // namespace ozo
@@ -110,7 +110,8 @@ struct is_array : std::false_type {};
  *
  * @par Concrete models
  *
- * @ref group-ext-std-vector, @ref group-ext-std-list, @ref group-ext-std-array
+ * @ref group-ext-std-vector, @ref group-ext-std-list, @ref group-ext-std-array,
+ * @ref group-ext-std-span, @ref group-ext-boost-iterator_range
  *
  * @par Example
  *
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <ozo/io/recv.h>
+
+#include <boost/iterator/iterator_facade.hpp>
+
+#include <functional>
+#include <memory>
+
+namespace ozo {
+
+/**
+ * @brief Typed view of a result which decodes rows on demand
+ *
+ * Unlike `ozo::recv_result()` which decodes all the rows of a result at once, the view
+ * decodes a row into the `Row` object only when it is accessed, so the rows skipped by
+ * a filter or after an early exit cost nothing. The plan of the columns is made once when
+ * the view is constructed: the columns of the row type are matched with the result columns
+ * and their oids are checked, so an access decodes the values only.
+ *
+ * The view is a random access range of `Row` values. It shares the result, so its copies
+ * are cheap and the result is kept alive while a copy exists. Each access decodes the row
+ * again, so keep the row if it is used more than once. Use `ozo::into()` to receive
+ * a request result into the view.
+ *
+ * ### Example
+ *
+ * @code
+ozo::typed_result<std::tuple<std::int64_t, std::string, ozo::pg::jsonb>> users;
+ozo::request(conn_info[io], "SELECT id, name, profile FROM users"_SQL, ozo::into(users), yield);
+const auto i = std::find_if(users.begin(), users.end(), [] (const auto& row) {
+    return std::get<1>(row) == "admin";
+});
+ * @endcode
+ *
+ * @tparam Row --- row type, same as for `ozo::recv_result()`.
+ * @tparam T --- underlying native result handler type, in common case `ozo::pg::result`.
+ * @tparam OidMap --- #OidMap of the connection the result is received with.
+ * @ingroup group-requests-types
+ */
+template <typename Row, typename T = pg::result, typename OidMap = empty_oid_map>
+class typed_result {
+    using plan_type = detail::column_plan<detail::columns_count<Row>()>;
+
+    struct state {
+        basic_result<T> result;
+        OidMap oid_map;
+        plan_type plan;
+    };
+
+public:
+    using result_type = basic_result<T>;
+    using value_type = Row;
+
+    class const_iterator : public boost::iterator_facade<
+        const_iterator,
+        Row,
+        boost::random_access_traversal_tag,
+        Row,
+        std::ptrdiff_t
+    > {
+    public:
+        const_iterator() = default;
+
+    private:
+        friend class typed_result;
+        friend class boost::iterator_core_access;
+
+        const_iterator(const state* s, std::ptrdiff_t index) noexcept : state_(s), index_(index) {}
+
+        Row dereference() const { return typed_result::decode(*state_, index_);}
+        bool equal(const const_iterator& other) const noexcept { return index_ == other.index_;}
+        void increment() noexcept { ++index_;}
+        void decrement() noexcept { --index_;}
+        void advance(std::ptrdiff_t n) noexcept { index_ += n;}
+        std::ptrdiff_t distance_to(const const_iterator& other) const noexcept { return other.index_ - index_;}
+
+        const state* state_ = nullptr;
+        std::ptrdiff_t index_ = 0;
+    };
+
+    using iterator = const_iterator;
+
+    typed_result() = default;
+
+    /**
+     * @brief Construct a new typed result view
+     *
+     * @param res --- result to view.
+     * @param oid_map --- #OidMap of the connection the result has been received with.
+     * @throws std::range_error if the result columns do not match the row type.
+     * @throws ozo::system_error with `ozo::error::oid_type_mismatch` if a column can not be received into the respective member.
+     */
+    explicit typed_result(result_type res, const OidMap& oid_map = OidMap{}) {
+        const auto plan = detail::make_column_plan<Row>(std::as_const(res), oid_map);
+        state_ = std::make_shared<const state>(state{std::move(res), oid_map, plan});
+    }
+
+    const_iterator begin() const noexcept { return {state_.get(), 0};}
+    const_iterator end() const noexcept { return {state_.get(), static_cast<std::ptrdiff_t>(size())};}
+
+    std::size_t size() const noexcept { return state_ ? std::size(state_->result) : 0;}
+    [[nodiscard]] bool empty() const noexcept { return size() == 0;}
+
+    /**
+     * Decodes the row of the index.
+     */
+    Row operator[] (std::size_t i) const { return decode(*state_, static_cast<std::ptrdiff_t>(i));}
+
+    /**
+     * Decodes the first row.
+     */
+    Row front() const { return (*this)[0];}
+
+    /**
+     * Get the viewed result.
+     */
+    const result_type& get_result() const noexcept { return state_->result;}
+
+private:
+    static Row decode(const state& s, std::ptrdiff_t index) {
+        Row row{};
+        detail::recv_row(s.result[static_cast<int>(index)], s.oid_map, row, s.plan);
+        return row;
+    }
+
+    std::shared_ptr<const state> state_;
+};
+
+/**
+ * @brief Make a typed view of a result
+ *
+ * @param res --- result to view.
+ * @param oid_map --- #OidMap of the connection the result has been received with.
+ * @return `ozo::typed_result` view.
+ * @ingroup group-requests-functions
+ */
+template <typename Row, typename T, typename OidMap = empty_oid_map>
+inline typed_result<Row, T, OidMap> make_typed_result(basic_result<T> res, const OidMap& oid_map = OidMap{}) {
+    return typed_result<Row, T, OidMap>(std::move(res), oid_map);
+}
+
+/**
+ * @ingroup group-requests-functions
+ * @brief Shortcut for create reference wrapper for `ozo::typed_result`.
+ *
+ * This shortcut creates reference wrapper for `ozo::typed_result` to receive a result
+ * into the view without decoding its rows.
+ *
+ * @param v --- `ozo::typed_result` view.
+ */
+template <typename Row, typename T, typename OidMap>
+constexpr auto into(typed_result<Row, T, OidMap>& v) noexcept { return std::ref(v);}
+
+/**
+ * @brief Receive a result into a typed view
+ * @ingroup group-io-functions
+ *
+ * The result is moved into the view, no row is decoded.
+ *
+ * @param in --- result to receive, it is moved into the view
+ * @param oid_map --- #OidMap to get oid for custom types from
+ * @param out --- view to receive into
+ * @return the view
+ */
+template <typename T, typename OidMap, typename Row>
+typed_result<Row, T, OidMap>& recv_result(basic_result<T>& in, const OidMap& oid_map, typed_result<Row, T, OidMap>& out) {
+    out = typed_result<Row, T, OidMap>(std::move(in), oid_map);
+    return out;
+}
+
+} // namespace ozo
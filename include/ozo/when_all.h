@@ -0,0 +1,127 @@
+#pragma once
+
+#include <ozo/impl/async_when_all.h>
+
+namespace ozo {
+
+/**
+ * @brief Creates a step of `ozo::when_all()`
+ *
+ * Binds a query with an output for its result. The output has the same semantics as for
+ * `ozo::request()`. If no output is given the query result is checked for errors only like
+ * `ozo::execute()` does.
+ *
+ * @param query --- query object to execute
+ * @param out --- output object like Iterator, Container, etc.
+ * @return step object
+ * @ingroup group-requests-functions
+ */
+template <typename BinaryQueryConvertible, typename Out = none_t>
+constexpr auto in_parallel(BinaryQueryConvertible&& query, Out out = Out{}) {
+    static_assert(ozo::BinaryQueryConvertible<BinaryQueryConvertible>,
+        "query should be convertible to the binary_query");
+    return impl::when_all_step<std::decay_t<BinaryQueryConvertible>, Out> {
+        std::forward<BinaryQueryConvertible>(query), std::move(out)
+    };
+}
+
+#ifdef OZO_DOCUMENTATION
+/**
+ * @brief Executes independent queries concurrently on separate connections
+ *
+ * The function requests a connection from the provider for each of the steps at once, e.g.
+ * from a connection pool, and executes the queries concurrently, so the operation takes as
+ * long as the slowest query instead of the sum of them. Unlike `ozo::pipeline()` the queries
+ * do not wait for each other on a single connection.
+ *
+ * The operation completes once all the steps have completed, since their outputs may be
+ * written until then: with no error if all of them have succeeded, or with the error of the
+ * step which has failed first. The connections are returned to the provider as soon as their
+ * steps complete. The handler is called with `void(ozo::error_code)` signature via its
+ * associated executor.
+ *
+ * @note The function does not participate in ADL since could be implemented via functional object.
+ *
+ * @param provider --- connection provider object, it is used for each of the steps.
+ * @param steps --- `boost::hana::tuple` of steps made by `ozo::in_parallel()`.
+ * @param time_constraint --- #TimeConstraint of each step; it <b>includes</b> time for getting connection from provider.
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ *
+ * ###Example
+ *
+ * @code
+ozo::rows_of<std::int64_t, std::string> user;
+ozo::rows_of<std::string> groups;
+ozo::rows_of<std::int64_t> counters;
+
+ozo::when_all(pool[io],
+    hana::make_tuple(
+        ozo::in_parallel("SELECT id, name FROM users WHERE id = "_SQL + id, ozo::into(user)),
+        ozo::in_parallel("SELECT name FROM groups WHERE user_id = "_SQL + id, ozo::into(groups)),
+        ozo::in_parallel("SELECT value FROM counters WHERE user_id = "_SQL + id, ozo::into(counters))
+    ),
+    500ms,
+    yield);
+ * @endcode
+ */
+template <typename ConnectionProvider, typename Steps, typename TimeConstraint, typename CompletionToken>
+decltype(auto) when_all(ConnectionProvider&& provider, Steps&& steps, TimeConstraint time_constraint, CompletionToken&& token);
+
+/**
+ * @brief Executes independent queries concurrently on separate connections
+ *
+ * This function is time constrain free shortcut to `ozo::when_all()` function.
+ * Its call is equal to `ozo::when_all(provider, steps, ozo::none, token)` call.
+ *
+ * @note The function does not participate in ADL since could be implemented via functional object.
+ *
+ * @param provider --- connection provider object, it is used for each of the steps.
+ * @param steps --- `boost::hana::tuple` of steps made by `ozo::in_parallel()`.
+ * @param token --- operation #CompletionToken.
+ * @return deduced from #CompletionToken.
+ * @ingroup group-requests-functions
+ */
+template <typename ConnectionProvider, typename Steps, typename CompletionToken>
+decltype(auto) when_all(ConnectionProvider&& provider, Steps&& steps, CompletionToken&& token);
+#else
+
+template <typename Initiator>
+struct when_all_op : base_async_operation <when_all_op<Initiator>, Initiator> {
+    using base = typename when_all_op::base;
+    using base::base;
+
+    template <typename P, typename Steps, typename TimeConstraint, typename CompletionToken>
+    decltype(auto) operator() (P&& provider, Steps&& steps, TimeConstraint t, CompletionToken&& token) const {
+        static_assert(ConnectionProvider<P>, "provider should be a ConnectionProvider");
+        static_assert(ozo::TimeConstraint<TimeConstraint>, "should model TimeConstraint concept");
+        return async_initiate<CompletionToken, void(error_code)>(
+            get_operation_initiator(*this), token, std::forward<P>(provider), t, std::forward<Steps>(steps));
+    }
+
+    template <typename P, typename Steps, typename CompletionToken>
+    decltype(auto) operator() (P&& provider, Steps&& steps, CompletionToken&& token) const {
+        return (*this)(std::forward<P>(provider), std::forward<Steps>(steps), none,
+            std::forward<CompletionToken>(token));
+    }
+
+    template <typename OtherInitiator>
+    constexpr static auto rebind_initiator(const OtherInitiator& other) {
+        return when_all_op<OtherInitiator>{other};
+    }
+};
+
+namespace detail {
+struct initiate_async_when_all {
+    template <typename Handler, typename P, typename TimeConstraint, typename Steps>
+    constexpr void operator()(Handler&& h, P&& provider, TimeConstraint t, Steps&& steps) const {
+        impl::async_when_all(std::forward<P>(provider), std::forward<Steps>(steps), t, std::forward<Handler>(h));
+    }
+};
+} // namespace detail
+
+constexpr when_all_op<detail::initiate_async_when_all> when_all;
+#endif
+
+} // namespace ozo
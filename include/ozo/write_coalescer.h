@@ -0,0 +1,255 @@
+#pragma once
+
+#include <ozo/execute.h>
+#include <ozo/query.h>
+#include <ozo/detail/bind.h>
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace ozo {
+
+/**
+ * @brief Write coalescer configuration
+ * @ingroup group-requests-types
+ */
+struct write_coalescer_config {
+    std::size_t max_rows = 1000; //!< number of rows which are flushed at once
+    time_traits::duration max_delay = std::chrono::milliseconds(1); //!< time a row waits for the rest of rows of its batch at most
+    time_traits::duration timeout = std::chrono::seconds(10); //!< time constraint of a flush including getting the connection
+};
+
+namespace detail {
+
+struct write_coalescer_waiter {
+    virtual void complete(error_code ec) = 0;
+    virtual ~write_coalescer_waiter() = default;
+};
+
+template <typename Handler, typename Executor>
+struct write_coalescer_waiter_impl : write_coalescer_waiter {
+    Handler handler_;
+    Executor executor_;
+
+    write_coalescer_waiter_impl(Handler handler, const Executor& ex)
+    : handler_(std::move(handler)), executor_(ex) {}
+
+    void complete(error_code ec) override {
+        auto ex = asio::get_associated_executor(handler_, executor_);
+        asio::post(ex, detail::bind(std::move(handler_), std::move(ec)));
+    }
+};
+
+/**
+* Rows of a batch stored by columns, so each column is sent as an array parameter.
+*/
+template <typename ...Columns>
+struct write_coalescer_batch {
+    std::tuple<std::vector<Columns>...> columns;
+    std::vector<std::unique_ptr<write_coalescer_waiter>> waiters;
+
+    std::size_t size() const noexcept { return waiters.size();}
+
+    void append(std::tuple<Columns...>&& row, std::unique_ptr<write_coalescer_waiter> waiter) {
+        std::apply([&] (auto& ...column) {
+            std::apply([&] (auto&& ...value) { (column.push_back(std::move(value)), ...); }, std::move(row));
+        }, columns);
+        waiters.push_back(std::move(waiter));
+    }
+
+    void complete(error_code ec) {
+        for (auto& waiter : waiters) {
+            waiter->complete(ec);
+        }
+    }
+};
+
+inline std::string make_coalesced_insert(std::string_view table, const std::vector<std::string>& columns) {
+    std::string text = "INSERT INTO ";
+    text += table;
+    text += " (";
+    std::string params;
+    for (std::size_t i = 0; i < columns.size(); ++i) {
+        if (i) {
+            text += ", ";
+            params += ", ";
+        }
+        text += columns[i];
+        params += '$' + std::to_string(i + 1);
+    }
+    text += ") SELECT * FROM unnest(";
+    text += params;
+    text += ')';
+    return text;
+}
+
+/**
+* Shared state of `ozo::write_coalescer`. The batch which is filled is flushed when
+* it reaches the maximum number of rows or when the delay of its first row expires.
+* The delay timer of a batch is not cancelled, it is ignored if the batch has been
+* flushed already.
+*/
+template <typename Source, typename ...Columns>
+class write_coalescer_state : public std::enable_shared_from_this<write_coalescer_state<Source, Columns...>> {
+public:
+    using batch_type = write_coalescer_batch<Columns...>;
+
+    write_coalescer_state(Source source, io_context& io, std::string text, const write_coalescer_config& config)
+    : source_(std::forward<Source>(source)), io_(io), text_(std::move(text)), config_(config) {}
+
+    io_context& get_io_context() const noexcept { return io_;}
+
+    void write(std::tuple<Columns...>&& row, std::unique_ptr<write_coalescer_waiter> waiter) {
+        std::unique_lock lock(mutex_);
+        current_.append(std::move(row), std::move(waiter));
+        if (current_.size() >= config_.max_rows) {
+            auto batch = take();
+            lock.unlock();
+            return flush(std::move(batch));
+        }
+        if (current_.size() == 1) {
+            const auto generation = generation_;
+            lock.unlock();
+            start_timer(generation);
+        }
+    }
+
+private:
+    batch_type take() {
+        ++generation_;
+        return std::exchange(current_, batch_type{});
+    }
+
+    void start_timer(std::uint64_t generation) {
+        auto timer = std::make_shared<asio::steady_timer>(io_, config_.max_delay);
+        timer->async_wait([self = this->shared_from_this(), timer, generation] (error_code ec) {
+            if (!ec) {
+                self->on_timer(generation);
+            }
+        });
+    }
+
+    void on_timer(std::uint64_t generation) {
+        std::unique_lock lock(mutex_);
+        if (generation != generation_ || current_.size() == 0) {
+            return;
+        }
+        auto batch = take();
+        lock.unlock();
+        flush(std::move(batch));
+    }
+
+    void flush(batch_type batch) {
+        auto flushed = std::make_shared<batch_type>(std::move(batch));
+        auto query = std::apply([&] (auto& ...column) {
+            return make_query(text_, std::move(column)...);
+        }, flushed->columns);
+        ozo::execute(connection_provider(source_, io_), std::move(query), config_.timeout,
+            [flushed] (error_code ec, auto) { flushed->complete(ec); });
+    }
+
+    std::mutex mutex_;
+    Source source_;
+    io_context& io_;
+    std::string text_;
+    write_coalescer_config config_;
+    batch_type current_;
+    std::uint64_t generation_ = 0;
+};
+
+} // namespace detail
+
+/**
+ * @brief Coalesces single row inserts into multi-row ones
+ *
+ * Many writers which insert one row each make a round trip and a transaction per row. The
+ * coalescer buffers the rows written to a table and flushes them with one statement:
+ *
+ * @code
+INSERT INTO table (column1, column2, ...) SELECT * FROM unnest($1, $2, ...)
+ * @endcode
+ *
+ * where each parameter is an array of the column values, so the rows are sent in the binary
+ * format with the existing array serialization. A batch is flushed when it reaches the maximum
+ * number of rows or when its first row has waited for the maximum delay. All the rows of a batch
+ * are inserted in one implicit transaction, so the handler of each write completes with the
+ * result of its batch once it is committed.
+ *
+ * The table and the column names are inserted into the statement as is, so they should be
+ * trusted and quoted if needed. The number of the column names should match the row type.
+ *
+ * The object may be used from many threads simultaneously.
+ *
+ * ###Example
+ *
+ * @code
+ozo::write_coalescer<decltype(pool)&, std::int64_t, std::string> events(pool, io,
+    "events", {"id", "payload"});
+
+events.write(std::make_tuple(id, payload), yield[ec]);
+ * @endcode
+ *
+ * @tparam Source --- type of the `ConnectionSource`; may be a reference type, e.g. for a pool.
+ * @tparam Columns --- types of the row columns.
+ * @ingroup group-requests-types
+ */
+template <typename Source, typename ...Columns>
+class write_coalescer {
+    static_assert(ConnectionSource<Source>, "Source should model ConnectionSource concept");
+    static_assert(sizeof...(Columns) > 0, "row should have columns");
+
+    using state_type = detail::write_coalescer_state<Source, Columns...>;
+
+public:
+    using row_type = std::tuple<Columns...>;
+
+    /**
+     * @brief Construct a new write coalescer object
+     *
+     * @param source --- connection source to flush the rows with.
+     * @param io --- `io_context` for the connections IO and the delay timers.
+     * @param table --- name of the table to insert the rows into.
+     * @param columns --- names of the columns in the order of the row type.
+     * @param config --- coalescer configuration.
+     */
+    write_coalescer(Source source, io_context& io, std::string_view table,
+            const std::vector<std::string>& columns, const write_coalescer_config& config = {})
+    : state_(std::make_shared<state_type>(std::forward<Source>(source), io,
+        detail::make_coalesced_insert(table, columns), config)) {
+        if (columns.size() != sizeof...(Columns)) {
+            throw std::invalid_argument("write_coalescer: number of columns should match the row type");
+        }
+    }
+
+    /**
+     * @brief Writes the row with the next batch
+     *
+     * @param row --- row to insert.
+     * @param token --- operation #CompletionToken with `void(ozo::error_code)` signature.
+     * @return deduced from #CompletionToken.
+     */
+    template <typename CompletionToken>
+    decltype(auto) write(row_type row, CompletionToken&& token) {
+        return async_initiate<CompletionToken, void(error_code)>(
+            [state = state_] (auto&& handler, row_type row) {
+                using handler_type = std::decay_t<decltype(handler)>;
+                using waiter_type = detail::write_coalescer_waiter_impl<handler_type, io_context::executor_type>;
+                state->write(std::move(row), std::make_unique<waiter_type>(
+                    std::forward<decltype(handler)>(handler), state->get_io_context().get_executor()));
+            },
+            token, std::move(row));
+    }
+
+private:
+    std::shared_ptr<state_type> state_;
+};
+
+} // namespace ozo
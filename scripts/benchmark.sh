@@ -40,6 +40,11 @@ run_ozo_benchmark_performance '--benchmark=use_connection_pool_mult_threads --qu
 run_ozo_benchmark_performance '--benchmark=use_connection_pool --query=simple --coroutines=1 --parse'
 run_ozo_benchmark_performance '--benchmark=use_connection_pool --query=complex --coroutines=1'
 run_ozo_benchmark_performance '--benchmark=use_connection_pool --query=complex --coroutines=1 --parse'
+run_ozo_benchmark_performance '--benchmark=decode_result_shape --duration=3'
+run_ozo_benchmark_performance '--benchmark=acquire_pooled_connection_mult_threads --coroutines=2 --threads=1 --connections=2'
+run_ozo_benchmark_performance '--benchmark=acquire_pooled_connection_mult_threads --coroutines=2 --threads=4 --connections=8'
+run_ozo_benchmark_performance '--benchmark=acquire_pooled_connection_mult_threads --coroutines=2 --threads=16 --connections=32'
+run_ozo_benchmark_performance '--benchmark=acquire_pooled_connection_mult_threads --coroutines=2 --threads=64 --connections=128'
 
 docker-compose stop ozo_postgres
 docker-compose rm -f ozo_postgres
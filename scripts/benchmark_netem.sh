@@ -0,0 +1,68 @@
+#!/bin/bash -ex
+
+# Runs the ozo_benchmark_performance scenario matrix against the postgres server with the network
+# latency and bandwidth limit injected via tc netem, see docker-compose.netem.yml. The matrix is
+# run once per delay of OZO_NETEM_DELAYS, each run writes json reports into OZO_BENCHMARK_OUTPUT.
+#
+# OZO_NETEM_DELAYS --- space separated one-way delays of the server replies, i.e. the added RTT.
+# OZO_NETEM_JITTER --- delay jitter.
+# OZO_NETEM_RATE --- bandwidth limit of the server replies in tc units, e.g. 100mbit, no limit if empty.
+
+COMPOSE="docker-compose -f docker-compose.yml -f docker-compose.netem.yml"
+
+if ! [[ "${OZO_NETEM_DELAYS}" ]]; then
+    OZO_NETEM_DELAYS="0ms 1ms 5ms 20ms"
+fi
+
+if ! [[ "${OZO_BENCHMARK_COMPILER}" ]]; then
+    OZO_BENCHMARK_COMPILER=clang
+fi
+
+if ! [[ "${OZO_BENCHMARK_BUILD_TYPE}" ]]; then
+    OZO_BENCHMARK_BUILD_TYPE=release
+fi
+
+if ! [[ "${OZO_BENCHMARK_OUTPUT}" ]]; then
+    OZO_BENCHMARK_OUTPUT=build/benchmark_netem
+fi
+
+if ! [[ "${OZO_BENCHMARK_DURATION}" ]]; then
+    OZO_BENCHMARK_DURATION=10
+fi
+
+SCENARIOS=(
+    '--benchmark=reuse_connection --query=simple'
+    '--benchmark=reuse_connection --query=complex --parse'
+    '--benchmark=use_connection_pool --query=simple --coroutines=1'
+    '--benchmark=use_connection_pool --query=simple --coroutines=8 --connections=8'
+    '--benchmark=use_connection_pool --query=simple --coroutines=64 --connections=8 --queue=64'
+    '--benchmark=use_connection_pool_mult_threads --query=simple --coroutines=8 --threads=4 --connections=16 --queue=0'
+    '--benchmark=decode_result_shape --rows 1 1000 --columns 4 --column_type int4 text mixed --text_size 16'
+)
+
+${COMPOSE} build ozo_netem ozo_build_with_pg_tests
+
+scripts/build.sh pg docker ${OZO_BENCHMARK_COMPILER} ${OZO_BENCHMARK_BUILD_TYPE}
+
+mkdir -p ${OZO_BENCHMARK_OUTPUT}
+
+for delay in ${OZO_NETEM_DELAYS}; do
+    OZO_NETEM_DELAY=${delay} ${COMPOSE} up -d --force-recreate ozo_netem
+    output="${OZO_BENCHMARK_OUTPUT}/netem_${delay}_${OZO_NETEM_RATE:-unlimited}.json"
+    rm -f "${output}"
+    for scenario in "${SCENARIOS[@]}"; do
+        ${COMPOSE} run \
+            --rm \
+            -T \
+            --user "$(id -u):$(id -g)" \
+            ozo_build_with_pg_tests \
+            bash \
+            -ec "/code/scripts/wait_postgres.sh >&2; \${BASE_BUILD_DIR}/${OZO_BENCHMARK_COMPILER}_${OZO_BENCHMARK_BUILD_TYPE}/benchmarks/ozo_benchmark_performance \
+                ${scenario} --duration=${OZO_BENCHMARK_DURATION} --format=json \
+                --conninfo=\"host=\${POSTGRES_HOST} user=\${POSTGRES_USER} dbname=\${POSTGRES_DB} password=\${POSTGRES_PASSWORD}\"" \
+            >> "${output}"
+    done
+done
+
+${COMPOSE} stop ozo_netem ozo_postgres
+${COMPOSE} rm -f ozo_netem ozo_postgres
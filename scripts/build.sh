@@ -39,6 +39,11 @@ build_clang() {
             CMAKE_CXX_FLAGS_RELWITHDEBINFO='-g -O2 -fno-omit-frame-pointer -fsanitize=thread'
             build
         ;;
+        boost_1_77)
+            CMAKE_BUILD_TYPE=Debug
+            use_boost_1_77
+            build
+        ;;
         conan)
             build_conan
         ;;
@@ -69,6 +74,11 @@ build_gcc() {
             OZO_COVERAGE=ON
             build
         ;;
+        boost_1_77)
+            CMAKE_BUILD_TYPE=Debug
+            use_boost_1_77
+            build
+        ;;
         conan)
             build_conan
         ;;
@@ -76,6 +86,12 @@ build_gcc() {
     esac
 }
 
+use_boost_1_77() {
+    OZO_BOOST_ROOT=/opt/boost_1_77_0
+    OZO_BOOST_LIBRARYDIR=/opt/boost_1_77_0/lib
+    OZO_Boost_NO_SYSTEM_PATHS=ON
+}
+
 build_docs() {
     doxygen
 }
@@ -92,8 +108,8 @@ usage() {
         Build with specified compiler or target
         compiler : gcc | clang
         target   :
-            - for gcc   : debug | release | test_external_project | coverage | conan
-            - for clang : debug | release | test_external_project | asan | ubsan | tsan | conan
+            - for gcc   : debug | release | test_external_project | coverage | boost_1_77 | conan
+            - for clang : debug | release | test_external_project | asan | ubsan | tsan | boost_1_77 | conan
         '$NAME' docker [all | docs | <compiler> <target>]
         Build inside Docker
         '$NAME' pg [docker] [all | <compiler> <target>]
@@ -106,6 +122,7 @@ build_all() {
     $0 gcc release
     $0 gcc coverage
     $0 gcc test_external_project
+    $0 gcc boost_1_77
     $0 gcc conan
     $0 clang debug
     $0 clang release
@@ -113,6 +130,7 @@ build_all() {
     $0 clang ubsan
     $0 clang tsan
     $0 clang test_external_project
+    $0 clang boost_1_77
     $0 clang conan
 }
 
@@ -147,6 +165,7 @@ build() {
         -DCMAKE_BUILD_TYPE=$CMAKE_BUILD_TYPE \
         -DOZO_BUILD_TESTS=ON \
         -DOZO_BUILD_EXAMPLES=ON \
+        -DOZO_BUILD_COMPILED=ON \
         -DOZO_BUILD_BENCHMARKS=ON \
         -DOZO_COVERAGE=$OZO_COVERAGE \
         -DOZO_BUILD_PG_TESTS=$OZO_BUILD_PG_TESTS \
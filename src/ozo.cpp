@@ -0,0 +1,25 @@
+/**
+* Explicit instantiations of the library templates for the common connection types:
+* `ozo::connection_info<>`, the connection pool over it and the transactions of their
+* connections. The headers declare them as `extern template` if `OZO_EXTERN_TEMPLATES`
+* is defined, e.g. by linking `ozo_compiled` library, so the translation units which
+* use the types do not instantiate them again.
+*/
+#include <ozo/connection_info.h>
+#include <ozo/connection_pool.h>
+#include <ozo/transaction.h>
+
+namespace ozo {
+
+template class connection<empty_oid_map, no_statistics>;
+template class connection_info<empty_oid_map, no_statistics>;
+template class connection_rep<empty_oid_map>;
+template class pooled_connection<yamail::resource_pool::handle<connection_rep<empty_oid_map>>,
+    io_context::executor_type, thread_safety<true>>;
+template class connection_pool<connection_info<empty_oid_map, no_statistics>, thread_safety<true>>;
+template class transaction<connection_info<empty_oid_map, no_statistics>::connection_type,
+    decltype(make_options())>;
+template class transaction<connection_pool<connection_info<empty_oid_map, no_statistics>>::connection_type,
+    decltype(make_options())>;
+
+} // namespace ozo
@@ -0,0 +1,149 @@
+#include <ozo/adaptive_limit.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <functional>
+
+namespace {
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+struct connection_mock {};
+
+using connection_ptr = std::shared_ptr<connection_mock>;
+using handler_type = std::function<void(ozo::error_code, connection_ptr)>;
+
+struct connection_source {
+    using connection_type = connection_ptr;
+
+    template <typename TimeConstraint, typename Handler>
+    void operator() (ozo::io_context&, TimeConstraint, Handler&& h) const {
+        handlers_->push_back(std::forward<Handler>(h));
+    }
+
+    std::vector<handler_type>* handlers_ = nullptr;
+};
+
+} // namespace
+
+namespace ozo {
+
+template <>
+struct is_connection<connection_mock> : std::true_type {};
+
+} // namespace ozo
+
+namespace {
+
+using ozo::detail::adaptive_limit_state;
+
+ozo::adaptive_limit_config make_config(std::size_t initial, std::size_t min, std::size_t max) {
+    ozo::adaptive_limit_config config;
+    config.initial_limit = initial;
+    config.min_limit = min;
+    config.max_limit = max;
+    config.latency_threshold = 1h;
+    config.backoff_ratio = 0.5;
+    return config;
+}
+
+TEST(adaptive_limit_state, should_reject_requests_beyond_limit) {
+    adaptive_limit_state state(make_config(2, 1, 10));
+    EXPECT_TRUE(state.try_acquire());
+    EXPECT_TRUE(state.try_acquire());
+    EXPECT_FALSE(state.try_acquire());
+    EXPECT_EQ(state.metrics().in_flight, 2u);
+    EXPECT_EQ(state.metrics().rejected, 1u);
+}
+
+TEST(adaptive_limit_state, should_increase_limit_by_one_per_limit_of_fast_requests) {
+    adaptive_limit_state state(make_config(2, 1, 10));
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_TRUE(state.try_acquire());
+        ASSERT_TRUE(state.try_acquire());
+        state.release(1ms);
+        state.release(1ms);
+    }
+    EXPECT_EQ(state.metrics().limit, 3u);
+}
+
+TEST(adaptive_limit_state, should_not_increase_limit_above_max) {
+    adaptive_limit_state state(make_config(2, 1, 2));
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(state.try_acquire());
+        state.release(1ms);
+    }
+    EXPECT_EQ(state.metrics().limit, 2u);
+}
+
+TEST(adaptive_limit_state, should_decrease_limit_by_backoff_ratio_on_slow_request_once_per_threshold) {
+    auto config = make_config(8, 1, 10);
+    config.latency_threshold = 1h;
+    adaptive_limit_state state(config);
+    ASSERT_TRUE(state.try_acquire());
+    ASSERT_TRUE(state.try_acquire());
+    state.release(2h);
+    state.release(2h);
+    EXPECT_EQ(state.metrics().limit, 4u);
+}
+
+TEST(adaptive_limit_state, should_not_decrease_limit_below_min) {
+    auto config = make_config(2, 2, 10);
+    config.latency_threshold = 0ms;
+    adaptive_limit_state state(config);
+    ASSERT_TRUE(state.try_acquire());
+    state.release(1ms);
+    EXPECT_EQ(state.metrics().limit, 2u);
+}
+
+struct adaptive_limit_connection_source : Test {
+    ozo::io_context io;
+    std::vector<handler_type> handlers;
+    std::vector<std::pair<ozo::error_code, connection_ptr>> results;
+
+    auto handler() {
+        return [this] (ozo::error_code ec, connection_ptr conn) { results.emplace_back(ec, std::move(conn)); };
+    }
+};
+
+TEST_F(adaptive_limit_connection_source, should_complete_request_beyond_limit_with_concurrency_limit_exceeded) {
+    auto source = ozo::make_adaptive_limit_connection_source(connection_source{&handlers}, make_config(1, 1, 10));
+    source(io, ozo::none, handler());
+    source(io, ozo::none, handler());
+    io.run();
+
+    EXPECT_EQ(handlers.size(), 1u);
+    ASSERT_EQ(results.size(), 1u);
+    EXPECT_EQ(results[0].first, ozo::error_code{ozo::error::concurrency_limit_exceeded});
+    EXPECT_EQ(results[0].second, nullptr);
+    EXPECT_EQ(source.metrics().rejected, 1u);
+}
+
+TEST_F(adaptive_limit_connection_source, should_hold_admission_until_connection_is_destroyed) {
+    auto source = ozo::make_adaptive_limit_connection_source(connection_source{&handlers}, make_config(1, 1, 10));
+    source(io, ozo::none, handler());
+    auto conn = std::make_shared<connection_mock>();
+    handlers.at(0)(ozo::error_code{}, conn);
+
+    ASSERT_EQ(results.size(), 1u);
+    EXPECT_EQ(results[0].second.get(), conn.get());
+    EXPECT_EQ(source.metrics().in_flight, 1u);
+
+    results.clear();
+    EXPECT_EQ(source.metrics().in_flight, 0u);
+    EXPECT_EQ(conn.use_count(), 1);
+}
+
+TEST_F(adaptive_limit_connection_source, should_release_admission_if_connection_request_failed) {
+    auto source = ozo::make_adaptive_limit_connection_source(connection_source{&handlers}, make_config(1, 1, 10));
+    source(io, ozo::none, handler());
+    handlers.at(0)(ozo::error_code{ozo::error::pq_connection_start_failed}, nullptr);
+
+    ASSERT_EQ(results.size(), 1u);
+    EXPECT_EQ(results[0].first, ozo::error_code{ozo::error::pq_connection_start_failed});
+    EXPECT_EQ(source.metrics().in_flight, 0u);
+}
+
+} // namespace
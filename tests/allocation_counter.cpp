@@ -0,0 +1,125 @@
+#include <ozo/allocation_counter.h>
+#include <ozo/arena.h>
+#include <ozo/impl/async_request.h>
+
+#include "connection_mock.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <boost/asio/use_future.hpp>
+
+#include <vector>
+
+namespace {
+
+using namespace testing;
+using namespace ozo::tests;
+
+using ozo::error_code;
+
+TEST(counting_allocator, should_count_allocations_and_deallocations) {
+    ozo::allocation_counter counter;
+    {
+        std::vector<int, ozo::counting_allocator<int>> v(ozo::counting_allocator<int>{counter});
+        v.reserve(10);
+        EXPECT_EQ(counter.allocations(), 1u);
+        EXPECT_EQ(counter.bytes(), 10 * sizeof(int));
+        EXPECT_EQ(counter.deallocations(), 0u);
+    }
+    EXPECT_EQ(counter.deallocations(), 1u);
+}
+
+TEST(counting_allocator, should_be_equal_to_rebound_allocator_of_the_same_counter) {
+    ozo::allocation_counter counter;
+    ozo::allocation_counter other;
+    const ozo::counting_allocator<char> allocator{counter};
+    const ozo::counting_allocator<int> rebound{allocator};
+    EXPECT_TRUE(allocator == rebound);
+    EXPECT_TRUE(allocator != ozo::counting_allocator<char>{other});
+}
+
+TEST(allocation_counter, reset_should_set_counters_to_zero) {
+    ozo::allocation_counter counter;
+    counter.on_allocate(42);
+    counter.on_deallocate();
+    counter.reset();
+    EXPECT_EQ(counter.allocations(), 0u);
+    EXPECT_EQ(counter.deallocations(), 0u);
+    EXPECT_EQ(counter.bytes(), 0u);
+}
+
+TEST(bind_allocation_counter, should_provide_counting_allocator_to_callback) {
+    ozo::allocation_counter counter;
+    bool called = false;
+    auto token = ozo::bind_allocation_counter(counter, [&] (error_code ec, int v) {
+        EXPECT_FALSE(ec);
+        EXPECT_EQ(v, 42);
+        called = true;
+    });
+    ozo::async_initiate<decltype(token), void(error_code, int)>(
+        [&] (auto handler) {
+            EXPECT_EQ(boost::asio::get_associated_allocator(handler).get_counter(), &counter);
+            handler(error_code{}, 42);
+        }, token);
+    EXPECT_TRUE(called);
+}
+
+TEST(bind_allocation_counter, should_return_result_of_underlying_completion_token) {
+    ozo::allocation_counter counter;
+    auto token = ozo::bind_allocation_counter(counter, boost::asio::use_future);
+    auto future = ozo::async_initiate<decltype(token), void(error_code, int)>(
+        [&] (auto handler) { handler(error_code{}, 42); }, token);
+    EXPECT_EQ(future.get(), 42);
+}
+
+TEST(bind_allocation_counter, should_count_allocations_of_underlying_token_allocator) {
+    ozo::allocation_counter counter;
+    ozo::arena arena;
+    auto token = ozo::bind_allocation_counter(counter, ozo::bind_arena(arena, [] (error_code, int) {}));
+    ozo::async_initiate<decltype(token), void(error_code, int)>(
+        [&] (auto handler) {
+            auto allocator = boost::asio::get_associated_allocator(handler);
+            auto p = std::allocator_traits<decltype(allocator)>::allocate(allocator, 64);
+            std::allocator_traits<decltype(allocator)>::deallocate(allocator, p, 64);
+            handler(error_code{}, 42);
+        }, token);
+    EXPECT_EQ(counter.allocations(), 1u);
+    EXPECT_GE(arena.allocated(), 64u);
+}
+
+struct request_allocations : Test {
+    StrictMock<connection_gmock> connection {};
+    StrictMock<PGconn_mock> native_handle {};
+    StrictMock<callback_gmock<connection_ptr<>>> callback {};
+    StrictMock<executor_mock> strand {};
+    io_context io;
+    execution_context cb_io;
+    connection_ptr<> conn = make_connection(connection, io, native_handle);
+};
+
+// The regression test for the allocations of the request path: if a change adds an allocation
+// to a SELECT 1 round trip, make sure it is needed and update the limit.
+TEST_F(request_allocations, select_1_round_trip_should_not_exceed_allocations_limit) {
+    constexpr std::size_t max_allocations = 3;
+
+    EXPECT_CALL(io.strand_service_, get_executor()).WillOnce(ReturnRef(strand));
+    EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+    EXPECT_CALL(native_handle, PQsetnonblocking(1)).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQsendQueryParams(_, _, _, _, _, _, _)).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQflush()).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(cb_io.executor_, dispatch(_)).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(callback, call(error_code {}, _)).WillOnce(Return());
+
+    ozo::allocation_counter counter;
+    ozo::impl::async_request_op{ozo::make_query("SELECT 1"), ozo::none, ozo::none,
+        ozo::counting_handler{wrap(callback), counter}}(error_code {}, conn);
+
+    EXPECT_GT(counter.allocations(), 0u);
+    EXPECT_LE(counter.allocations(), max_allocations);
+    EXPECT_EQ(counter.deallocations(), counter.allocations());
+}
+
+} // namespace
@@ -0,0 +1,139 @@
+#include <ozo/arena.h>
+#include <ozo/io/binary_query.h>
+#include <ozo/impl/async_request.h>
+
+#include "connection_mock.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <boost/asio/use_future.hpp>
+
+#include <array>
+#include <future>
+#include <vector>
+
+namespace {
+
+using namespace testing;
+
+TEST(arena, should_allocate_from_initial_buffer) {
+    alignas(std::max_align_t) std::array<char, 64> buffer;
+    ozo::arena arena(buffer.data(), buffer.size());
+    const auto p = static_cast<char*>(arena.allocate(16));
+    EXPECT_GE(p, buffer.data());
+    EXPECT_LT(p, buffer.data() + buffer.size());
+    EXPECT_EQ(arena.allocated(), 16u);
+}
+
+TEST(arena, should_return_aligned_memory) {
+    alignas(std::max_align_t) std::array<char, 64> buffer;
+    ozo::arena arena(buffer.data(), buffer.size());
+    arena.allocate(1, 1);
+    const auto p = arena.allocate(8, 8);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(p) % 8, 0u);
+}
+
+TEST(arena, should_allocate_from_heap_when_initial_buffer_is_exhausted) {
+    std::array<char, 16> buffer;
+    ozo::arena arena(buffer.data(), buffer.size(), 64);
+    arena.allocate(16, 1);
+    const auto p = static_cast<char*>(arena.allocate(32, 1));
+    EXPECT_TRUE(p < buffer.data() || p >= buffer.data() + buffer.size());
+    EXPECT_EQ(arena.allocated(), 48u);
+}
+
+TEST(arena, should_allocate_block_greater_than_block_size) {
+    ozo::arena arena(64);
+    const auto p = static_cast<char*>(arena.allocate(1024, 1));
+    std::fill(p, p + 1024, 'x');
+    EXPECT_EQ(arena.allocated(), 1024u);
+}
+
+TEST(arena, should_allocate_with_no_initial_buffer) {
+    ozo::arena arena;
+    EXPECT_NE(arena.allocate(16), nullptr);
+}
+
+TEST(arena, release_should_reuse_initial_buffer) {
+    alignas(std::max_align_t) std::array<char, 64> buffer;
+    ozo::arena arena(buffer.data(), buffer.size(), 64);
+    const auto first = arena.allocate(16);
+    arena.allocate(128);
+    arena.release();
+    EXPECT_EQ(arena.allocated(), 0u);
+    EXPECT_EQ(arena.allocate(16), first);
+}
+
+TEST(arena_allocator, should_allocate_container_data_from_arena) {
+    ozo::arena arena;
+    std::vector<int, ozo::arena_allocator<int>> v(ozo::arena_allocator<int>{arena});
+    v.assign({1, 2, 3});
+    EXPECT_THAT(v, ElementsAre(1, 2, 3));
+    EXPECT_GE(arena.allocated(), 3 * sizeof(int));
+}
+
+TEST(arena_allocator, should_be_equal_to_rebound_allocator_of_the_same_arena) {
+    ozo::arena arena;
+    ozo::arena arena2;
+    const ozo::arena_allocator<int> allocator{arena};
+    EXPECT_EQ(allocator, ozo::arena_allocator<char>(allocator));
+    EXPECT_NE(allocator, ozo::arena_allocator<char>(arena2));
+}
+
+template <typename Token>
+auto async_test_operation(int value, Token&& token) {
+    return ozo::async_initiate<Token, void(ozo::error_code, int)>(
+        [value] (auto handler, ozo::arena* expected) {
+            EXPECT_EQ(boost::asio::get_associated_allocator(handler).get_arena(), expected);
+            handler(ozo::error_code{}, value);
+        }, token, static_cast<ozo::arena*>(nullptr));
+}
+
+TEST(bind_arena, should_provide_arena_allocator_to_callback) {
+    ozo::arena arena;
+    bool called = false;
+    auto token = ozo::bind_arena(arena, [&] (ozo::error_code ec, int v) {
+        EXPECT_FALSE(ec);
+        EXPECT_EQ(v, 42);
+        called = true;
+    });
+    ozo::async_initiate<decltype(token), void(ozo::error_code, int)>(
+        [&] (auto handler) {
+            EXPECT_EQ(boost::asio::get_associated_allocator(handler).get_arena(), &arena);
+            handler(ozo::error_code{}, 42);
+        }, token);
+    EXPECT_TRUE(called);
+}
+
+TEST(bind_arena, should_return_result_of_underlying_completion_token) {
+    ozo::arena arena;
+    auto token = ozo::bind_arena(arena, boost::asio::use_future);
+    auto future = ozo::async_initiate<decltype(token), void(ozo::error_code, int)>(
+        [&] (auto handler) {
+            EXPECT_EQ(boost::asio::get_associated_allocator(handler).get_arena(), &arena);
+            handler(ozo::error_code{}, 42);
+        }, token);
+    EXPECT_EQ(future.get(), 42);
+}
+
+TEST(bind_arena, binary_query_should_be_allocated_from_arena) {
+    ozo::arena arena;
+    const auto query = ozo::to_binary_query(ozo::make_query("SELECT $1", std::string(256, 'x')),
+        ozo::empty_oid_map{}, ozo::arena_allocator<char>{arena});
+    EXPECT_GT(arena.allocated(), 256u);
+    EXPECT_EQ(query.lengths()[0], 256);
+}
+
+TEST(bind_arena, request_operation_context_should_be_allocated_from_arena) {
+    StrictMock<ozo::tests::connection_gmock> connection;
+    ozo::tests::io_context io;
+    ozo::tests::PGconn_mock handle;
+    ozo::arena arena;
+    auto conn = ozo::tests::make_connection(connection, io, handle);
+    auto handler = ozo::arena_handler{[] (ozo::error_code, decltype(conn)) {}, arena};
+    const auto ctx = ozo::impl::make_request_operation_context(conn, std::move(handler));
+    EXPECT_GE(arena.allocated(), sizeof(*ctx));
+}
+
+} // namespace
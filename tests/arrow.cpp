@@ -0,0 +1,195 @@
+#include "test_protocol.h"
+
+#include <ozo/arrow.h>
+#include <ozo/protocol.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+using namespace ozo::tests;
+
+struct arrow_export : Test {
+    std::vector<buffer> messages;
+    ozo::protocol::rows rows;
+    ArrowSchema schema {};
+    ArrowArray array {};
+
+    void describe(const std::vector<column>& columns) {
+        messages.push_back(row_description(columns));
+        rows.describe(parse(messages.back()));
+    }
+
+    void add(const std::vector<std::optional<buffer>>& values) {
+        messages.push_back(data_row(values));
+        rows.add(parse(messages.back()));
+    }
+
+    void export_rows() {
+        ozo::arrow::export_result(ozo::basic_result<const ozo::protocol::rows*>(&rows), &schema, &array);
+    }
+
+    template <typename T>
+    const T* values(int column) const {
+        return static_cast<const T*>(array.children[column]->buffers[1]);
+    }
+
+    bool valid(int column, int row) const {
+        const auto validity = static_cast<const std::uint8_t*>(array.children[column]->buffers[0]);
+        return !validity || (validity[row / 8] >> (row % 8)) & 1;
+    }
+
+    ~arrow_export() {
+        if (schema.release) {
+            schema.release(&schema);
+        }
+        if (array.release) {
+            array.release(&array);
+        }
+    }
+};
+
+TEST_F(arrow_export, should_export_struct_with_named_child_per_column) {
+    describe({{"id", 23}, {"name", 25}});
+    add({binary(std::int32_t(1)), text("a")});
+    export_rows();
+
+    EXPECT_EQ(std::string_view(schema.format), "+s");
+    ASSERT_EQ(schema.n_children, 2);
+    EXPECT_EQ(std::string_view(schema.children[0]->name), "id");
+    EXPECT_EQ(std::string_view(schema.children[0]->format), "i");
+    EXPECT_EQ(std::string_view(schema.children[1]->name), "name");
+    EXPECT_EQ(std::string_view(schema.children[1]->format), "u");
+    EXPECT_EQ(schema.children[1]->flags, ARROW_FLAG_NULLABLE);
+
+    EXPECT_EQ(array.length, 1);
+    EXPECT_EQ(array.n_buffers, 1);
+    ASSERT_EQ(array.n_children, 2);
+    EXPECT_EQ(array.children[0]->n_buffers, 2);
+    EXPECT_EQ(array.children[1]->n_buffers, 3);
+}
+
+TEST_F(arrow_export, should_convert_integers_to_native_byte_order) {
+    describe({{"a", 21}, {"b", 23}, {"c", 20}});
+    add({binary(std::int16_t(-2)), binary(std::int32_t(70000)), binary(std::int64_t(1) << 40)});
+    add({binary(std::int16_t(3)), binary(std::int32_t(-1)), binary(std::int64_t(-5))});
+    export_rows();
+
+    EXPECT_THAT(std::vector<std::int16_t>(values<std::int16_t>(0), values<std::int16_t>(0) + 2), ElementsAre(-2, 3));
+    EXPECT_THAT(std::vector<std::int32_t>(values<std::int32_t>(1), values<std::int32_t>(1) + 2), ElementsAre(70000, -1));
+    EXPECT_THAT(std::vector<std::int64_t>(values<std::int64_t>(2), values<std::int64_t>(2) + 2),
+        ElementsAre(std::int64_t(1) << 40, -5));
+}
+
+TEST_F(arrow_export, should_convert_floating_point_to_native_byte_order) {
+    describe({{"a", 700}, {"b", 701}});
+    add({binary(1.5f), binary(-2.25)});
+    export_rows();
+
+    EXPECT_EQ(values<float>(0)[0], 1.5f);
+    EXPECT_EQ(values<double>(1)[0], -2.25);
+}
+
+TEST_F(arrow_export, should_pack_booleans_into_bitmap) {
+    describe({{"a", 16}});
+    add({binary(true)});
+    add({binary(false)});
+    add({binary(true)});
+    export_rows();
+
+    EXPECT_EQ(values<std::uint8_t>(0)[0], 0b101);
+}
+
+TEST_F(arrow_export, should_export_nulls_into_validity_bitmap) {
+    describe({{"id", 23}, {"name", 25}});
+    add({binary(std::int32_t(1)), std::nullopt});
+    add({std::nullopt, text("b")});
+    export_rows();
+
+    EXPECT_EQ(array.children[0]->null_count, 1);
+    EXPECT_EQ(array.children[1]->null_count, 1);
+    EXPECT_TRUE(valid(0, 0));
+    EXPECT_FALSE(valid(0, 1));
+    EXPECT_FALSE(valid(1, 0));
+    EXPECT_TRUE(valid(1, 1));
+}
+
+TEST_F(arrow_export, should_omit_validity_bitmap_without_nulls) {
+    describe({{"id", 23}});
+    add({binary(std::int32_t(1))});
+    export_rows();
+
+    EXPECT_EQ(array.children[0]->null_count, 0);
+    EXPECT_EQ(array.children[0]->buffers[0], nullptr);
+}
+
+TEST_F(arrow_export, should_export_variable_length_values_with_offsets) {
+    describe({{"name", 25}});
+    add({text("ab")});
+    add({std::nullopt});
+    add({text("cde")});
+    export_rows();
+
+    const auto offsets = values<std::int32_t>(0);
+    EXPECT_THAT(std::vector<std::int32_t>(offsets, offsets + 4), ElementsAre(0, 2, 2, 5));
+    const auto data = static_cast<const char*>(array.children[0]->buffers[2]);
+    EXPECT_EQ(std::string_view(data, 5), "abcde");
+}
+
+TEST_F(arrow_export, should_shift_timestamp_and_date_to_unix_epoch) {
+    describe({{"ts", 1184}, {"d", 1082}});
+    add({binary(std::int64_t(1)), binary(std::int32_t(-1))});
+    export_rows();
+
+    EXPECT_EQ(std::string_view(schema.children[0]->format), "tsu:UTC");
+    EXPECT_EQ(values<std::int64_t>(0)[0], 946684800000001);
+    EXPECT_EQ(std::string_view(schema.children[1]->format), "tdD");
+    EXPECT_EQ(values<std::int32_t>(1)[0], 10956);
+}
+
+TEST_F(arrow_export, should_export_unknown_type_as_binary) {
+    describe({{"v", 1700}});
+    add({text("\x01\x02")});
+    export_rows();
+
+    EXPECT_EQ(std::string_view(schema.children[0]->format), "z");
+    EXPECT_EQ(array.children[0]->n_buffers, 3);
+}
+
+TEST_F(arrow_export, should_export_empty_result) {
+    describe({{"id", 23}, {"name", 25}});
+    export_rows();
+
+    EXPECT_EQ(array.length, 0);
+    EXPECT_EQ(array.children[0]->length, 0);
+    EXPECT_EQ(values<std::int32_t>(1)[0], 0);
+}
+
+TEST_F(arrow_export, should_throw_on_fixed_width_column_in_text_format) {
+    describe({{"id", 23, 0}});
+    add({text("1")});
+    EXPECT_THROW(export_rows(), ozo::system_error);
+    EXPECT_EQ(schema.release, nullptr);
+    EXPECT_EQ(array.release, nullptr);
+}
+
+TEST_F(arrow_export, should_throw_on_fixed_width_value_size_mismatch) {
+    describe({{"id", 20}});
+    add({binary(std::int32_t(1))});
+    EXPECT_THROW(export_rows(), ozo::system_error);
+}
+
+TEST_F(arrow_export, release_should_reset_callbacks) {
+    describe({{"id", 23}});
+    add({binary(std::int32_t(1))});
+    export_rows();
+
+    schema.release(&schema);
+    array.release(&array);
+    EXPECT_EQ(schema.release, nullptr);
+    EXPECT_EQ(array.release, nullptr);
+}
+
+} // namespace
@@ -0,0 +1,96 @@
+#include <ozo/batch_loader.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+
+using ozo::error_code;
+
+using row_type = std::tuple<std::int64_t, std::string>;
+
+struct load_result {
+    error_code ec;
+    std::optional<row_type> row;
+};
+
+struct waiter_mock : ozo::detail::batch_loader_waiter<row_type> {
+    std::vector<load_result>* results;
+
+    explicit waiter_mock(std::vector<load_result>& results) : results(&results) {}
+
+    void complete(error_code ec, std::optional<row_type> row) override {
+        results->push_back({ec, std::move(row)});
+    }
+};
+
+using batch_type = ozo::detail::batch_loader_batch<std::int64_t, row_type>;
+
+TEST(batch_loader_batch, should_store_distinct_keys_in_order_of_first_load) {
+    batch_type batch;
+    std::vector<load_result> results;
+    batch.append(3, std::make_unique<waiter_mock>(results));
+    batch.append(1, std::make_unique<waiter_mock>(results));
+    batch.append(3, std::make_unique<waiter_mock>(results));
+
+    EXPECT_EQ(batch.size(), 2u);
+    EXPECT_THAT(batch.keys, ElementsAre(3, 1));
+}
+
+TEST(batch_loader_batch, should_complete_each_waiter_with_row_of_its_key) {
+    batch_type batch;
+    std::vector<load_result> results;
+    batch.append(1, std::make_unique<waiter_mock>(results));
+    batch.append(2, std::make_unique<waiter_mock>(results));
+    batch.append(2, std::make_unique<waiter_mock>(results));
+
+    std::vector<row_type> rows {{2, "b"}, {1, "a"}};
+    batch.complete(rows);
+
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_EQ(results[0].row, row_type(2, "b"));
+    EXPECT_EQ(results[1].row, row_type(2, "b"));
+    EXPECT_EQ(results[2].row, row_type(1, "a"));
+    EXPECT_FALSE(results[0].ec);
+}
+
+TEST(batch_loader_batch, should_complete_waiter_of_missing_key_without_row) {
+    batch_type batch;
+    std::vector<load_result> results;
+    batch.append(1, std::make_unique<waiter_mock>(results));
+
+    std::vector<row_type> rows {{5, "x"}};
+    batch.complete(rows);
+
+    ASSERT_EQ(results.size(), 1u);
+    EXPECT_FALSE(results[0].ec);
+    EXPECT_EQ(results[0].row, std::nullopt);
+}
+
+TEST(batch_loader_batch, should_complete_all_waiters_with_error_of_query) {
+    batch_type batch;
+    std::vector<load_result> results;
+    batch.append(1, std::make_unique<waiter_mock>(results));
+    batch.append(2, std::make_unique<waiter_mock>(results));
+
+    batch.complete(error_code{ozo::error::pq_connection_start_failed});
+
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_EQ(results[0].ec, error_code{ozo::error::pq_connection_start_failed});
+    EXPECT_EQ(results[1].ec, error_code{ozo::error::pq_connection_start_failed});
+}
+
+TEST(batch_loader_batch, should_make_query_with_keys_as_single_array_parameter) {
+    batch_type batch;
+    std::vector<load_result> results;
+    batch.append(1, std::make_unique<waiter_mock>(results));
+    batch.append(2, std::make_unique<waiter_mock>(results));
+    const auto query = ozo::make_query("SELECT id, name FROM users WHERE id = ANY($1)", std::move(batch.keys));
+    const auto binary = ozo::to_binary_query(query, ozo::empty_oid_map{});
+    EXPECT_EQ(binary.params_count(), 1);
+    EXPECT_EQ(binary.types()[0], ozo::type_oid<std::vector<std::int64_t>>(ozo::empty_oid_map{}));
+}
+
+} // namespace
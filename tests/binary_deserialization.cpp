@@ -2,14 +2,22 @@
 
 #include <ozo/io/array.h>
 #include <ozo/io/recv.h>
+#include <ozo/md_array.h>
+#include <ozo/nullable_vector.h>
 #include <ozo/ext/std.h>
 #include <ozo/pg/types.h>
+#include <ozo/shortcuts.h>
+#include <ozo/static_rows.h>
+#include <ozo/string_array.h>
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <boost/container/static_vector.hpp>
 #include <boost/range/adaptor/transformed.hpp>
 
+#include <memory_resource>
+
 BOOST_FUSION_DEFINE_STRUCT((),
     fusion_adapted_test_result,
     (std::string, text)
@@ -25,6 +33,25 @@ struct hana_adapted_test_result {
 
 namespace {
 
+struct reserve_recording_container : std::vector<std::int32_t> {
+    std::vector<std::size_t> reserved;
+};
+
+} // namespace
+
+namespace ozo {
+
+template <>
+struct reserve_impl<reserve_recording_container> {
+    static void apply(reserve_recording_container& out, std::size_t n) {
+        out.reserved.push_back(n);
+    }
+};
+
+} // namespace ozo
+
+namespace {
+
 using namespace testing;
 using namespace ozo::tests;
 using namespace std::literals;
@@ -49,10 +76,35 @@ TEST_F(read, with_multi_byte_type_and_bad_ostream_should_throw) {
     );
 }
 
+TEST(istream_unchecked, should_read_values_of_checked_region_and_skip_it) {
+    const char bytes[] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07};
+    ozo::istream in(bytes, sizeof(bytes));
+    auto data = in.unchecked(6);
+    std::int32_t first = 0;
+    std::int16_t second = 0;
+    ozo::read(data, first);
+    ozo::read(data, second);
+    EXPECT_EQ(first, 0x01020304);
+    EXPECT_EQ(second, 0x0506);
+    char rest = 0;
+    ozo::read(in, rest);
+    EXPECT_EQ(rest, 0x07);
+}
+
+TEST(istream_unchecked, should_throw_if_stream_contains_less_bytes) {
+    const char bytes[] = {0x01, 0x02};
+    ozo::istream in(bytes, sizeof(bytes));
+    EXPECT_THROW(in.unchecked(4), ozo::system_error);
+}
+
 struct recv : Test {
     ozo::empty_oid_map oid_map{};
     StrictMock<pg_result_mock> mock{};
     ozo::value<pg_result_mock> value{{&mock, 0, 0}};
+
+    recv() {
+        EXPECT_CALL(mock, field_format(_)).WillRepeatedly(Return(ozo::impl::result_format::binary));
+    }
 };
 
 TEST_F(recv, should_throw_system_error_if_oid_does_not_match_the_type) {
@@ -155,6 +207,124 @@ TEST_F(recv, should_convert_TEXTOID_to_std_string) {
     EXPECT_EQ("test", got);
 }
 
+TEST_F(recv, should_convert_TEXTOID_to_std_string_view_pointing_to_the_value) {
+    const char* bytes = "test";
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(25));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    std::string_view got;
+    ozo::recv(value, oid_map, got);
+    EXPECT_EQ(got, "test");
+    EXPECT_EQ(got.data(), bytes);
+}
+
+TEST_F(recv, should_convert_empty_TEXTOID_to_empty_std_string_view) {
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(25));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(""));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(0));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    std::string_view got = "text";
+    ozo::recv(value, oid_map, got);
+    EXPECT_TRUE(got.empty());
+}
+
+TEST_F(recv, should_convert_BYTEAOID_to_pg_bytea_view_pointing_to_the_value) {
+    const char* bytes = "test";
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(17));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    ozo::pg::bytea_view got;
+    ozo::recv(value, oid_map, got);
+    EXPECT_EQ(got.get(), "test");
+    EXPECT_EQ(got.get().data(), bytes);
+}
+
+TEST_F(recv, should_convert_JSONBOID_to_pg_jsonb_view_pointing_to_the_value) {
+    const char bytes[] = "\x01{}";
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(3802));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(3));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    ozo::pg::jsonb_view got;
+    ozo::recv(value, oid_map, got);
+    EXPECT_EQ(got.raw_string(), "{}");
+    EXPECT_EQ(got.raw_string().data(), bytes + 1);
+}
+
+struct json_document_recorder {
+    std::vector<std::string_view> documents;
+
+    void operator() (std::string_view document) { documents.push_back(document); }
+};
+
+TEST_F(recv, should_feed_JSONBOID_document_to_pg_jsonb_reader_parser_without_copy) {
+    const char bytes[] = "\x01{}";
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(3802));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(3));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    ozo::pg::jsonb_reader<json_document_recorder> got;
+    ozo::recv(value, oid_map, got);
+    ASSERT_THAT(got.parser().documents, ElementsAre("{}"));
+    EXPECT_EQ(got.parser().documents[0].data(), bytes + 1);
+}
+
+TEST_F(recv, should_throw_for_empty_JSONBOID_with_pg_jsonb_reader) {
+    const char bytes[] = "";
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(3802));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(0));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    ozo::pg::jsonb_reader<json_document_recorder> got;
+    EXPECT_THROW(ozo::recv(value, oid_map, got), std::range_error);
+    EXPECT_THAT(got.parser().documents, IsEmpty());
+}
+
+TEST_F(recv, should_feed_JSONOID_document_to_pg_json_reader_parser_without_copy) {
+    const char bytes[] = "[1]";
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(114));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(3));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    ozo::pg::json_reader<json_document_recorder> got;
+    ozo::recv(value, oid_map, got);
+    ASSERT_THAT(got.parser().documents, ElementsAre("[1]"));
+    EXPECT_EQ(got.parser().documents[0].data(), bytes);
+}
+
+TEST_F(recv, should_convert_NUMERICOID_to_pg_numeric64) {
+    const char bytes[] = { 0, 2, 0, 0, 0, 0, 0, 2, 0, 123, 0x11, char(0x94) };
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(1700));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof(bytes)));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    ozo::pg::numeric64 got;
+    ozo::recv(value, oid_map, got);
+    EXPECT_EQ(got, ozo::pg::numeric64(12345, 2));
+    EXPECT_EQ(got.to_string(), "123.45");
+}
+
+TEST_F(recv, should_throw_for_NUMERICOID_NaN) {
+    const char bytes[] = { 0, 0, 0, 0, char(0xC0), 0, 0, 0 };
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(1700));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof(bytes)));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    ozo::pg::numeric64 got;
+    EXPECT_THROW(ozo::recv(value, oid_map, got), std::range_error);
+}
+
 TEST_F(recv, should_convert_TEXTOID_to_a_nullable_wrapped_std_string_unwrapping_that_nullable) {
     const char* bytes = "test";
     EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(25));
@@ -283,6 +453,22 @@ TEST_F(recv, should_throw_exception_on_TEXTARRAYOID_with_less_size_than_std_arra
     EXPECT_THROW(ozo::recv(value, oid_map, got), ozo::system_error);
 }
 
+TEST_F(recv, should_clear_std_vector_for_empty_INT4ARRAYOID) {
+    const char bytes[] = {
+        0x00, 0x00, 0x00, 0x00, // dimension count
+        0x00, 0x00, 0x00, 0x00, // data offset
+        0x00, 0x00, 0x00, 0x17, // Oid
+    };
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(1007));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof bytes));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    std::vector<std::int32_t> got {1, 2};
+    ozo::recv(value, oid_map, got);
+    EXPECT_TRUE(got.empty());
+}
+
 TEST_F(recv, should_throw_on_multidimential_arrays) {
     const char bytes[] = {
         0x00, 0x00, 0x00, 0x02, // dimension count
@@ -306,84 +492,185 @@ TEST_F(recv, should_throw_on_multidimential_arrays) {
     EXPECT_THROW(ozo::recv(value, oid_map, got), ozo::system_error);
 }
 
-TEST_F(recv, should_throw_on_inappropriate_element_oid) {
+TEST_F(recv, should_convert_two_dimensional_INT4ARRAYOID_to_md_array_of_int32) {
     const char bytes[] = {
-        0x00, 0x00, 0x00, 0x01, // dimension count
+        0x00, 0x00, 0x00, 0x02, // dimension count
         0x00, 0x00, 0x00, 0x00, // data offset
-        0x00, 0x00, 0x00, 0x01, // Oid
+        0x00, 0x00, 0x00, 0x17, // Oid
+        0x00, 0x00, 0x00, 0x02, // 1st dimension size
+        0x00, 0x00, 0x00, 0x01, // 1st dimension index
+        0x00, 0x00, 0x00, 0x03, // 2nd dimension size
+        0x00, 0x00, 0x00, 0x01, // 2nd dimension index
+        0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x01, // [0][0]
+        0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x02, // [0][1]
+        0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x03, // [0][2]
+        0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x04, // [1][0]
+        0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x05, // [1][1]
+        0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x06, // [1][2]
+    };
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(1007));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof bytes));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    ozo::md_array<std::int32_t> got;
+    ozo::recv(value, oid_map, got);
+    EXPECT_EQ(got.rank(), 2u);
+    EXPECT_EQ(got.extent(0), 2u);
+    EXPECT_EQ(got.extent(1), 3u);
+    EXPECT_THAT(got, ElementsAre(1, 2, 3, 4, 5, 6));
+    EXPECT_EQ(got(1, 2), 6);
+}
+
+TEST_F(recv, should_convert_empty_FLOAT8ARRAYOID_to_md_array_of_rank_0) {
+    const char bytes[] = {
+        0x00, 0x00, 0x00, 0x00, // dimension count
+        0x00, 0x00, 0x00, 0x00, // data offset
+        0x00, 0x00, 0x02, char(0xBD), // Oid
+    };
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(1022));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof bytes));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    ozo::md_array<double> got({2, 2});
+    ozo::recv(value, oid_map, got);
+    EXPECT_EQ(got.rank(), 0u);
+    EXPECT_TRUE(got.empty());
+}
+
+TEST_F(recv, should_throw_on_null_element_for_md_array_of_int32) {
+    const char bytes[] = {
+        0x00, 0x00, 0x00, 0x02, // dimension count
+        0x00, 0x00, 0x00, 0x01, // data offset
+        0x00, 0x00, 0x00, 0x17, // Oid
+        0x00, 0x00, 0x00, 0x01, // 1st dimension size
+        0x00, 0x00, 0x00, 0x01, // 1st dimension index
+        0x00, 0x00, 0x00, 0x02, // 2nd dimension size
+        0x00, 0x00, 0x00, 0x01, // 2nd dimension index
+        0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x01, // [0][0]
+        char(0xFF), char(0xFF), char(0xFF), char(0xFF), // [0][1] is null
+    };
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(1007));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof bytes));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    ozo::md_array<std::int32_t> got;
+    EXPECT_THROW(ozo::recv(value, oid_map, got), std::invalid_argument);
+}
+
+TEST_F(recv, should_convert_INT4ARRAYOID_with_nulls_to_nullable_vector_with_null_bitmap) {
+    const char bytes[] = {
+        0x00, 0x00, 0x00, 0x01, // dimension count
+        0x00, 0x00, 0x00, 0x01, // data offset
+        0x00, 0x00, 0x00, 0x17, // Oid
         0x00, 0x00, 0x00, 0x03, // dimension size
         0x00, 0x00, 0x00, 0x01, // dimension index
         0x00, 0x00, 0x00, 0x04, // 1st element size
-        't', 'e', 's', 't',     // 1st element
-        0x00, 0x00, 0x00, 0x03, // 2nd element size
-        'f', 'o', 'o',          // 2ndst element
-        0x00, 0x00, 0x00, 0x03, // 3rd element size
-        'b', 'a', 'r',          // 3rd element
+        0x00, 0x00, 0x00, 0x01, // 1st element
+        char(0xFF), char(0xFF), char(0xFF), char(0xFF), // 2nd element is null
+        0x00, 0x00, 0x00, 0x04, // 3rd element size
+        0x00, 0x00, 0x00, 0x03, // 3rd element
     };
-    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(1009));
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(1007));
     EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
     EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof bytes));
     EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
 
-    std::vector<std::string> got;
-    EXPECT_THROW(ozo::recv(value, oid_map, got), ozo::system_error);
+    ozo::nullable_vector<std::int32_t> got;
+    ozo::recv(value, oid_map, got);
+    EXPECT_THAT(got, ElementsAre(1, 0, 3));
+    EXPECT_FALSE(got.is_null(0));
+    EXPECT_TRUE(got.is_null(1));
+    EXPECT_FALSE(got.is_null(2));
+    EXPECT_EQ(got.null_count(), 1u);
 }
 
-TEST_F(recv, should_throw_on_null_element_for_non_nullable_out_element) {
+TEST_F(recv, should_convert_INT4ARRAYOID_without_nulls_to_nullable_vector_replacing_content) {
     const char bytes[] = {
         0x00, 0x00, 0x00, 0x01, // dimension count
         0x00, 0x00, 0x00, 0x00, // data offset
-        0x00, 0x00, 0x00, 0x19, // Oid
-        0x00, 0x00, 0x00, 0x03, // dimension size
+        0x00, 0x00, 0x00, 0x17, // Oid
+        0x00, 0x00, 0x00, 0x02, // dimension size
         0x00, 0x00, 0x00, 0x01, // dimension index
-        char(0xFF), char(0xFF), char(0xFF), char(0xFF), // 1st element size
-        0x00, 0x00, 0x00, 0x03, // 2nd element size
-        'f', 'o', 'o',          // 2ndst element
-        0x00, 0x00, 0x00, 0x03, // 3rd element size
-        'b', 'a', 'r',          // 3rd element
+        0x00, 0x00, 0x00, 0x04, // 1st element size
+        0x00, 0x00, 0x00, 0x01, // 1st element
+        0x00, 0x00, 0x00, 0x04, // 2nd element size
+        0x00, 0x00, 0x00, 0x02, // 2nd element
     };
-    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(1009));
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(1007));
     EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
     EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof bytes));
     EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
 
-    std::vector<std::string> got;
-    EXPECT_THROW(ozo::recv(value, oid_map, got), std::invalid_argument);
+    ozo::nullable_vector<std::int32_t> got;
+    got.push_null();
+    got.push_null();
+    got.push_null();
+    ozo::recv(value, oid_map, got);
+    EXPECT_THAT(got, ElementsAre(1, 2));
+    EXPECT_EQ(got.null_count(), 0u);
 }
 
-TEST_F(recv, should_throw_exception_when_size_of_integral_differs_from_given) {
-    const char bytes[] = { true };
-
-    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(16));
+TEST_F(recv, should_convert_TEXTARRAYOID_with_nulls_to_string_array_in_single_buffer) {
+    const char bytes[] = {
+        0x00, 0x00, 0x00, 0x01, // dimension count
+        0x00, 0x00, 0x00, 0x01, // data offset
+        0x00, 0x00, 0x00, 0x19, // Oid
+        0x00, 0x00, 0x00, 0x03, // dimension size
+        0x00, 0x00, 0x00, 0x01, // dimension index
+        0x00, 0x00, 0x00, 0x03, // 1st element size
+        'f', 'o', 'o',          // 1st element
+        char(0xFF), char(0xFF), char(0xFF), char(0xFF), // 2nd element is null
+        0x00, 0x00, 0x00, 0x02, // 3rd element size
+        'b', 'a',               // 3rd element
+    };
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(1009));
     EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
-    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof(bytes) + 1));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof bytes));
     EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
 
-    bool got = false;
-    EXPECT_THROW(ozo::recv(value, oid_map, got), ozo::system_error);
+    ozo::string_array<> got;
+    ozo::recv(value, oid_map, got);
+    EXPECT_THAT(got, ElementsAre("foo", "", "ba"));
+    EXPECT_FALSE(got.is_null(0));
+    EXPECT_TRUE(got.is_null(1));
+    EXPECT_FALSE(got.is_null(2));
+    EXPECT_EQ(std::string_view(got.buffer().data(), got.buffer().size()), "fooba");
 }
 
-TEST_F(recv, should_read_nothing_when_dimensions_count_is_zero) {
+TEST_F(recv, should_convert_TEXTARRAYOID_to_string_array_replacing_content_without_reallocation) {
     const char bytes[] = {
-        0x00, 0x00, 0x00, 0x00, // dimension count
+        0x00, 0x00, 0x00, 0x01, // dimension count
         0x00, 0x00, 0x00, 0x00, // data offset
         0x00, 0x00, 0x00, 0x19, // Oid
+        0x00, 0x00, 0x00, 0x02, // dimension size
+        0x00, 0x00, 0x00, 0x01, // dimension index
+        0x00, 0x00, 0x00, 0x01, // 1st element size
+        'a',                    // 1st element
+        0x00, 0x00, 0x00, 0x01, // 2nd element size
+        'b',                    // 2nd element
     };
     EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(1009));
     EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
     EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof bytes));
     EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
 
-    std::vector<std::string> got;
+    ozo::string_array<> got;
+    got.reserve(3, sizeof bytes);
+    got.push_back("previous");
+    const auto data = got.buffer().data();
     ozo::recv(value, oid_map, got);
-    EXPECT_THAT(got, ElementsAre());
+    EXPECT_THAT(got, ElementsAre("a", "b"));
+    EXPECT_EQ(got.buffer().data(), data);
 }
 
-TEST_F(recv, should_read_nothing_when_dimension_size_is_zero) {
+TEST_F(recv, should_throw_on_inappropriate_element_oid_for_string_array) {
     const char bytes[] = {
         0x00, 0x00, 0x00, 0x01, // dimension count
         0x00, 0x00, 0x00, 0x00, // data offset
-        0x00, 0x00, 0x00, 0x19, // Oid
+        0x00, 0x00, 0x00, 0x17, // Oid
         0x00, 0x00, 0x00, 0x00, // dimension size
         0x00, 0x00, 0x00, 0x01, // dimension index
     };
@@ -392,16 +679,15 @@ TEST_F(recv, should_read_nothing_when_dimension_size_is_zero) {
     EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof bytes));
     EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
 
-    std::vector<std::string> got;
-    ozo::recv(value, oid_map, got);
-    EXPECT_THAT(got, ElementsAre());
+    ozo::string_array<> got;
+    EXPECT_THROW(ozo::recv(value, oid_map, got), ozo::system_error);
 }
 
-TEST_F(recv, should_convert_TEXTARRAYOID_to_std_vector_of_std_unique_ptr_of_std_string) {
+TEST_F(recv, should_throw_on_inappropriate_element_oid) {
     const char bytes[] = {
         0x00, 0x00, 0x00, 0x01, // dimension count
         0x00, 0x00, 0x00, 0x00, // data offset
-        0x00, 0x00, 0x00, 0x19, // Oid
+        0x00, 0x00, 0x00, 0x01, // Oid
         0x00, 0x00, 0x00, 0x03, // dimension size
         0x00, 0x00, 0x00, 0x01, // dimension index
         0x00, 0x00, 0x00, 0x04, // 1st element size
@@ -416,16 +702,11 @@ TEST_F(recv, should_convert_TEXTARRAYOID_to_std_vector_of_std_unique_ptr_of_std_
     EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof bytes));
     EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
 
-    std::vector<std::unique_ptr<std::string>> got;
-    ozo::recv(value, oid_map, got);
-    EXPECT_THAT(got, ElementsAre(
-        Pointee("test"s),
-        Pointee("foo"s),
-        Pointee("bar"s)
-    ));
+    std::vector<std::string> got;
+    EXPECT_THROW(ozo::recv(value, oid_map, got), ozo::system_error);
 }
 
-TEST_F(recv, should_reset_nullable_on_null_element) {
+TEST_F(recv, should_throw_on_null_element_for_non_nullable_out_element) {
     const char bytes[] = {
         0x00, 0x00, 0x00, 0x01, // dimension count
         0x00, 0x00, 0x00, 0x00, // data offset
@@ -443,52 +724,386 @@ TEST_F(recv, should_reset_nullable_on_null_element) {
     EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof bytes));
     EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
 
-    std::vector<std::unique_ptr<std::string>> got;
-    ozo::recv(value, oid_map, got);
-    EXPECT_THAT(got, ElementsAre(
-        IsNull(),
-        Pointee("foo"s),
-        Pointee("bar"s)
-    ));
+    std::vector<std::string> got;
+    EXPECT_THROW(ozo::recv(value, oid_map, got), std::invalid_argument);
 }
 
-TEST_F(recv, should_convert_NAMEOID_to_pg_name) {
-    const char* bytes = "test";
-    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(19));
+TEST_F(recv, should_convert_INT4ARRAYOID_to_std_vector_of_int32) {
+    const char bytes[] = {
+        0x00, 0x00, 0x00, 0x01, // dimension count
+        0x00, 0x00, 0x00, 0x00, // data offset
+        0x00, 0x00, 0x00, 0x17, // Oid
+        0x00, 0x00, 0x00, 0x03, // dimension size
+        0x00, 0x00, 0x00, 0x01, // dimension index
+        0x00, 0x00, 0x00, 0x04, // 1st element size
+        0x00, 0x00, 0x00, 0x01, // 1st element
+        0x00, 0x00, 0x00, 0x04, // 2nd element size
+        0x00, 0x00, 0x01, 0x00, // 2nd element
+        0x00, 0x00, 0x00, 0x04, // 3rd element size
+        char(0xFF), char(0xFF), char(0xFF), char(0xFE), // 3rd element
+    };
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(1007));
     EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
-    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof bytes));
     EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
 
-    ozo::pg::name got;
+    std::vector<std::int32_t> got;
     ozo::recv(value, oid_map, got);
-    EXPECT_EQ("test", static_cast<const std::string&>(got));
+    EXPECT_THAT(got, ElementsAre(1, 256, -2));
 }
 
-struct recv_row : Test {
-    ozo::empty_oid_map oid_map{};
-    StrictMock<pg_result_mock> mock{};
-    ozo::row<pg_result_mock> row{{&mock, 0, 0}};
-};
-
-TEST_F(recv_row, should_throw_range_error_if_size_of_tuple_does_not_equal_to_row_size) {
-    std::tuple<int, std::string> out;
-    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+TEST_F(recv, should_convert_TIMESTAMPARRAYOID_to_std_vector_of_time_point) {
+    const char bytes[] = {
+        0x00, 0x00, 0x00, 0x01, // dimension count
+        0x00, 0x00, 0x00, 0x00, // data offset
+        0x00, 0x00, 0x04, 0x5A, // Oid
+        0x00, 0x00, 0x00, 0x03, // dimension size
+        0x00, 0x00, 0x00, 0x01, // dimension index
+        0x00, 0x00, 0x00, 0x08, // 1st element size
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 1st element
+        0x00, 0x00, 0x00, 0x08, // 2nd element size
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x0F, 0x42, 0x40, // 2nd element
+        0x00, 0x00, 0x00, 0x08, // 3rd element size
+        char(0xFF), char(0xFF), char(0xFF), char(0xFF), char(0xFF), char(0xFF), char(0xFF), char(0xFF), // 3rd element
+    };
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(1115));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof bytes));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
 
-    EXPECT_THROW(ozo::recv_row(row, oid_map, out), std::range_error);
+    std::vector<std::chrono::system_clock::time_point> got;
+    ozo::recv(value, oid_map, got);
+    EXPECT_THAT(got, ElementsAre(
+        ozo::detail::epoch,
+        ozo::detail::epoch + std::chrono::seconds(1),
+        ozo::detail::epoch - std::chrono::microseconds(1)
+    ));
 }
 
-TEST_F(recv_row, should_convert_INT4OID_and_TEXTOID_to_std_tuple_int32_t_std_string) {
-    const char int32_bytes[] = { 0x00, 0x00, 0x00, 0x07 };
-    const char* string_bytes = "test";
-
-    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(2));
+TEST_F(recv, should_throw_for_null_in_TIMESTAMPARRAYOID) {
+    const char bytes[] = {
+        0x00, 0x00, 0x00, 0x01, // dimension count
+        0x00, 0x00, 0x00, 0x01, // data offset
+        0x00, 0x00, 0x04, 0x5A, // Oid
+        0x00, 0x00, 0x00, 0x02, // dimension size
+        0x00, 0x00, 0x00, 0x01, // dimension index
+        0x00, 0x00, 0x00, 0x08, // 1st element size
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 1st element
+        char(0xFF), char(0xFF), char(0xFF), char(0xFF), // 2nd element is null
+    };
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(1115));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof bytes));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
 
-    EXPECT_CALL(mock, field_type(0)).WillRepeatedly(Return(23));
-    EXPECT_CALL(mock, get_value(_, 0)).WillRepeatedly(Return(int32_bytes));
-    EXPECT_CALL(mock, get_length(_, 0)).WillRepeatedly(Return(4));
-    EXPECT_CALL(mock, get_isnull(_, 0)).WillRepeatedly(Return(false));
+    std::vector<std::chrono::system_clock::time_point> got;
+    EXPECT_THROW(ozo::recv(value, oid_map, got), std::invalid_argument);
+}
 
-    EXPECT_CALL(mock, field_type(1)).WillRepeatedly(Return(25));
+TEST_F(recv, should_convert_INTERVALARRAYOID_to_std_vector_of_chrono_microseconds) {
+    const char bytes[] = {
+        0x00, 0x00, 0x00, 0x01, // dimension count
+        0x00, 0x00, 0x00, 0x00, // data offset
+        0x00, 0x00, 0x04, char(0xA2), // Oid
+        0x00, 0x00, 0x00, 0x02, // dimension size
+        0x00, 0x00, 0x00, 0x01, // dimension index
+        0x00, 0x00, 0x00, 0x10, // 1st element size
+        char(0x00), char(0x00), char(0x00), char(0x08), char(0x89), char(0xD2), char(0x82), char(0xD6), // microseconds
+        char(0x00), char(0x00), char(0x00), char(0x09), // days
+        char(0x00), char(0x00), char(0x00), char(0x5C), // months
+        0x00, 0x00, 0x00, 0x10, // 2nd element size
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x0F, 0x42, 0x40, // microseconds
+        0x00, 0x00, 0x00, 0x00, // days
+        0x00, 0x00, 0x00, 0x00, // months
+    };
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(1187));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof bytes));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    std::vector<std::chrono::microseconds> got;
+    ozo::recv(value, oid_map, got);
+    EXPECT_THAT(got, ElementsAre(std::chrono::microseconds(239278272013014LL), std::chrono::seconds(1)));
+}
+
+TEST_F(recv, should_convert_FLOAT8ARRAYOID_to_std_array_of_double) {
+    const char bytes[] = {
+        0x00, 0x00, 0x00, 0x01, // dimension count
+        0x00, 0x00, 0x00, 0x00, // data offset
+        0x00, 0x00, 0x02, char(0xBD), // Oid
+        0x00, 0x00, 0x00, 0x02, // dimension size
+        0x00, 0x00, 0x00, 0x01, // dimension index
+        0x00, 0x00, 0x00, 0x08, // 1st element size
+        0x40, 0x45, 0x10, char(0xA3), char(0xD7), 0x0A, 0x3D, 0x71, // 1st element
+        0x00, 0x00, 0x00, 0x08, // 2nd element size
+        char(0xBF), char(0xF0), 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 2nd element
+    };
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(1022));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof bytes));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    std::array<double, 2> got;
+    ozo::recv(value, oid_map, got);
+    EXPECT_THAT(got, ElementsAre(42.13, -1.0));
+}
+
+TEST_F(recv, should_throw_on_null_element_for_std_vector_of_int32) {
+    const char bytes[] = {
+        0x00, 0x00, 0x00, 0x01, // dimension count
+        0x00, 0x00, 0x00, 0x00, // data offset
+        0x00, 0x00, 0x00, 0x17, // Oid
+        0x00, 0x00, 0x00, 0x03, // dimension size
+        0x00, 0x00, 0x00, 0x01, // dimension index
+        0x00, 0x00, 0x00, 0x04, // 1st element size
+        0x00, 0x00, 0x00, 0x01, // 1st element
+        char(0xFF), char(0xFF), char(0xFF), char(0xFF), // 2nd element size
+        0x00, 0x00, 0x00, 0x04, // 3rd element size
+        0x00, 0x00, 0x00, 0x03, // 3rd element
+        0x00, 0x00, 0x00, 0x00, // trailing data
+    };
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(1007));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof bytes));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    std::vector<std::int32_t> got;
+    EXPECT_THROW(ozo::recv(value, oid_map, got), std::invalid_argument);
+}
+
+TEST_F(recv, should_throw_on_element_size_mismatch_for_std_vector_of_int32) {
+    const char bytes[] = {
+        0x00, 0x00, 0x00, 0x01, // dimension count
+        0x00, 0x00, 0x00, 0x00, // data offset
+        0x00, 0x00, 0x00, 0x17, // Oid
+        0x00, 0x00, 0x00, 0x02, // dimension size
+        0x00, 0x00, 0x00, 0x01, // dimension index
+        0x00, 0x00, 0x00, 0x04, // 1st element size
+        0x00, 0x00, 0x00, 0x01, // 1st element
+        0x00, 0x00, 0x00, 0x08, // 2nd element size
+        0x00, 0x00, 0x00, 0x00, // 2nd element
+    };
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(1007));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof bytes));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    std::vector<std::int32_t> got;
+    EXPECT_THROW(ozo::recv(value, oid_map, got), ozo::system_error);
+}
+
+TEST_F(recv, should_throw_on_truncated_std_vector_of_int32) {
+    const char bytes[] = {
+        0x00, 0x00, 0x00, 0x01, // dimension count
+        0x00, 0x00, 0x00, 0x00, // data offset
+        0x00, 0x00, 0x00, 0x17, // Oid
+        0x00, 0x00, 0x00, 0x02, // dimension size
+        0x00, 0x00, 0x00, 0x01, // dimension index
+        0x00, 0x00, 0x00, 0x04, // 1st element size
+        0x00, 0x00, 0x00, 0x01, // 1st element
+    };
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(1007));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof bytes));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    std::vector<std::int32_t> got;
+    EXPECT_THROW(ozo::recv(value, oid_map, got), ozo::system_error);
+}
+
+TEST_F(recv, should_throw_exception_when_size_of_integral_differs_from_given) {
+    const char bytes[] = { true };
+
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(16));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof(bytes) + 1));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    bool got = false;
+    EXPECT_THROW(ozo::recv(value, oid_map, got), ozo::system_error);
+}
+
+TEST_F(recv, should_read_nothing_when_dimensions_count_is_zero) {
+    const char bytes[] = {
+        0x00, 0x00, 0x00, 0x00, // dimension count
+        0x00, 0x00, 0x00, 0x00, // data offset
+        0x00, 0x00, 0x00, 0x19, // Oid
+    };
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(1009));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof bytes));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    std::vector<std::string> got;
+    ozo::recv(value, oid_map, got);
+    EXPECT_THAT(got, ElementsAre());
+}
+
+TEST_F(recv, should_read_nothing_when_dimension_size_is_zero) {
+    const char bytes[] = {
+        0x00, 0x00, 0x00, 0x01, // dimension count
+        0x00, 0x00, 0x00, 0x00, // data offset
+        0x00, 0x00, 0x00, 0x19, // Oid
+        0x00, 0x00, 0x00, 0x00, // dimension size
+        0x00, 0x00, 0x00, 0x01, // dimension index
+    };
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(1009));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof bytes));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    std::vector<std::string> got;
+    ozo::recv(value, oid_map, got);
+    EXPECT_THAT(got, ElementsAre());
+}
+
+TEST_F(recv, should_convert_TEXTARRAYOID_to_pmr_vector_of_pmr_string_with_memory_resource_of_vector) {
+    const char bytes[] = {
+        0x00, 0x00, 0x00, 0x01, // dimension count
+        0x00, 0x00, 0x00, 0x00, // data offset
+        0x00, 0x00, 0x00, 0x19, // Oid
+        0x00, 0x00, 0x00, 0x02, // dimension size
+        0x00, 0x00, 0x00, 0x01, // dimension index
+        0x00, 0x00, 0x00, 0x04, // 1st element size
+        't', 'e', 's', 't',     // 1st element
+        0x00, 0x00, 0x00, 0x03, // 2nd element size
+        'f', 'o', 'o',          // 2nd element
+    };
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(1009));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof bytes));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    std::pmr::monotonic_buffer_resource resource;
+    std::pmr::vector<std::pmr::string> got(&resource);
+    ozo::recv(value, oid_map, got);
+    EXPECT_THAT(got, ElementsAre("test", "foo"));
+    EXPECT_EQ(got[0].get_allocator().resource(), &resource);
+    EXPECT_EQ(got[1].get_allocator().resource(), &resource);
+}
+
+TEST_F(recv, should_convert_TEXTARRAYOID_to_pmr_vector_of_optional_pmr_string_with_memory_resource_of_vector) {
+    const char bytes[] = {
+        0x00, 0x00, 0x00, 0x01, // dimension count
+        0x00, 0x00, 0x00, 0x01, // data offset
+        0x00, 0x00, 0x00, 0x19, // Oid
+        0x00, 0x00, 0x00, 0x02, // dimension size
+        0x00, 0x00, 0x00, 0x01, // dimension index
+        char(0xFF), char(0xFF), char(0xFF), char(0xFF), // 1st element is null
+        0x00, 0x00, 0x00, 0x04, // 2nd element size
+        't', 'e', 's', 't',     // 2nd element
+    };
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(1009));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof bytes));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    std::pmr::monotonic_buffer_resource resource;
+    std::pmr::vector<std::optional<std::pmr::string>> got(&resource);
+    ozo::recv(value, oid_map, got);
+    ASSERT_EQ(got.size(), 2u);
+    EXPECT_FALSE(got[0]);
+    ASSERT_TRUE(got[1]);
+    EXPECT_EQ(*got[1], "test");
+    EXPECT_EQ(got[1]->get_allocator().resource(), &resource);
+}
+
+TEST_F(recv, should_convert_TEXTARRAYOID_to_std_vector_of_std_unique_ptr_of_std_string) {
+    const char bytes[] = {
+        0x00, 0x00, 0x00, 0x01, // dimension count
+        0x00, 0x00, 0x00, 0x00, // data offset
+        0x00, 0x00, 0x00, 0x19, // Oid
+        0x00, 0x00, 0x00, 0x03, // dimension size
+        0x00, 0x00, 0x00, 0x01, // dimension index
+        0x00, 0x00, 0x00, 0x04, // 1st element size
+        't', 'e', 's', 't',     // 1st element
+        0x00, 0x00, 0x00, 0x03, // 2nd element size
+        'f', 'o', 'o',          // 2ndst element
+        0x00, 0x00, 0x00, 0x03, // 3rd element size
+        'b', 'a', 'r',          // 3rd element
+    };
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(1009));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof bytes));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    std::vector<std::unique_ptr<std::string>> got;
+    ozo::recv(value, oid_map, got);
+    EXPECT_THAT(got, ElementsAre(
+        Pointee("test"s),
+        Pointee("foo"s),
+        Pointee("bar"s)
+    ));
+}
+
+TEST_F(recv, should_reset_nullable_on_null_element) {
+    const char bytes[] = {
+        0x00, 0x00, 0x00, 0x01, // dimension count
+        0x00, 0x00, 0x00, 0x00, // data offset
+        0x00, 0x00, 0x00, 0x19, // Oid
+        0x00, 0x00, 0x00, 0x03, // dimension size
+        0x00, 0x00, 0x00, 0x01, // dimension index
+        char(0xFF), char(0xFF), char(0xFF), char(0xFF), // 1st element size
+        0x00, 0x00, 0x00, 0x03, // 2nd element size
+        'f', 'o', 'o',          // 2ndst element
+        0x00, 0x00, 0x00, 0x03, // 3rd element size
+        'b', 'a', 'r',          // 3rd element
+    };
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(1009));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof bytes));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    std::vector<std::unique_ptr<std::string>> got;
+    ozo::recv(value, oid_map, got);
+    EXPECT_THAT(got, ElementsAre(
+        IsNull(),
+        Pointee("foo"s),
+        Pointee("bar"s)
+    ));
+}
+
+TEST_F(recv, should_convert_NAMEOID_to_pg_name) {
+    const char* bytes = "test";
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(19));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    ozo::pg::name got;
+    ozo::recv(value, oid_map, got);
+    EXPECT_EQ("test", static_cast<const std::string&>(got));
+}
+
+struct recv_row : Test {
+    ozo::empty_oid_map oid_map{};
+    StrictMock<pg_result_mock> mock{};
+    ozo::row<pg_result_mock> row{{&mock, 0, 0}};
+
+    recv_row() {
+        EXPECT_CALL(mock, field_format(_)).WillRepeatedly(Return(ozo::impl::result_format::binary));
+    }
+};
+
+TEST_F(recv_row, should_throw_range_error_if_size_of_tuple_does_not_equal_to_row_size) {
+    std::tuple<int, std::string> out;
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+
+    EXPECT_THROW(ozo::recv_row(row, oid_map, out), std::range_error);
+}
+
+TEST_F(recv_row, should_convert_INT4OID_and_TEXTOID_to_std_tuple_int32_t_std_string) {
+    const char int32_bytes[] = { 0x00, 0x00, 0x00, 0x07 };
+    const char* string_bytes = "test";
+
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(2));
+
+    EXPECT_CALL(mock, field_type(0)).WillRepeatedly(Return(23));
+    EXPECT_CALL(mock, get_value(_, 0)).WillRepeatedly(Return(int32_bytes));
+    EXPECT_CALL(mock, get_length(_, 0)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_isnull(_, 0)).WillRepeatedly(Return(false));
+
+    EXPECT_CALL(mock, field_type(1)).WillRepeatedly(Return(25));
     EXPECT_CALL(mock, get_value(_, 1)).WillRepeatedly(Return(string_bytes));
     EXPECT_CALL(mock, get_length(_, 1)).WillRepeatedly(Return(4));
     EXPECT_CALL(mock, get_isnull(_, 1)).WillRepeatedly(Return(false));
@@ -597,6 +1212,10 @@ struct recv_result : Test {
     ozo::empty_oid_map oid_map{};
     StrictMock<pg_result_mock> mock{};
     ozo::basic_result<pg_result_mock*> res{&mock};
+
+    recv_result() {
+        EXPECT_CALL(mock, field_format(_)).WillRepeatedly(Return(ozo::impl::result_format::binary));
+    }
 };
 
 TEST_F(recv_result, send_convert_INT4OID_and_TEXTOID_to_fusion_adapted_structures_vector_via_back_inserter) {
@@ -655,22 +1274,139 @@ TEST_F(recv_result, send_convert_INT4OID_and_TEXTOID_to_hana_adapted_structures_
     EXPECT_EQ(got[1].text, "test");
 }
 
-TEST_F(recv_result, send_convert_INT4OID_and_TEXTOID_to_fusion_adapted_structures_vector_via_iterator) {
+TEST_F(recv_result, should_find_columns_for_fusion_adapted_structure_once_per_result) {
     const char int32_bytes[] = { 0x00, 0x00, 0x00, 0x07 };
     const char* string_bytes = "test";
 
     EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(2));
-    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(2));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(3));
 
-    EXPECT_CALL(mock, field_number(Eq("digit"s))).WillRepeatedly(Return(0));
-    EXPECT_CALL(mock, field_type(0)).WillRepeatedly(Return(23));
-    EXPECT_CALL(mock, get_value(_, 0)).WillRepeatedly(Return(int32_bytes));
+    EXPECT_CALL(mock, field_number(Eq("digit"s))).WillOnce(Return(1));
+    EXPECT_CALL(mock, field_type(1)).WillRepeatedly(Return(23));
+    EXPECT_CALL(mock, get_value(_, 1)).WillRepeatedly(Return(int32_bytes));
+    EXPECT_CALL(mock, get_length(_, 1)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_isnull(_, 1)).WillRepeatedly(Return(false));
+
+    EXPECT_CALL(mock, field_number(Eq("text"s))).WillOnce(Return(0));
+    EXPECT_CALL(mock, field_type(0)).WillRepeatedly(Return(25));
+    EXPECT_CALL(mock, get_value(_, 0)).WillRepeatedly(Return(string_bytes));
     EXPECT_CALL(mock, get_length(_, 0)).WillRepeatedly(Return(4));
     EXPECT_CALL(mock, get_isnull(_, 0)).WillRepeatedly(Return(false));
 
-    EXPECT_CALL(mock, field_number(Eq("text"s))).WillRepeatedly(Return(1));
-    EXPECT_CALL(mock, field_type(1)).WillRepeatedly(Return(25));
-    EXPECT_CALL(mock, get_value(_, 1)).WillRepeatedly(Return(string_bytes));
+    std::vector<fusion_adapted_test_result> got;
+    ozo::recv_result(res, oid_map, std::back_inserter(got));
+    ASSERT_EQ(got.size(), 3u);
+    EXPECT_EQ(got[2].digit, 7);
+    EXPECT_EQ(got[2].text, "test");
+}
+
+TEST_F(recv_result, should_find_columns_for_hana_adapted_structure_once_per_result) {
+    const char int32_bytes[] = { 0x00, 0x00, 0x00, 0x07 };
+    const char* string_bytes = "test";
+
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(2));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(3));
+
+    EXPECT_CALL(mock, field_number(Eq("digit"s))).WillOnce(Return(1));
+    EXPECT_CALL(mock, field_type(1)).WillRepeatedly(Return(23));
+    EXPECT_CALL(mock, get_value(_, 1)).WillRepeatedly(Return(int32_bytes));
+    EXPECT_CALL(mock, get_length(_, 1)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_isnull(_, 1)).WillRepeatedly(Return(false));
+
+    EXPECT_CALL(mock, field_number(Eq("text"s))).WillOnce(Return(0));
+    EXPECT_CALL(mock, field_type(0)).WillRepeatedly(Return(25));
+    EXPECT_CALL(mock, get_value(_, 0)).WillRepeatedly(Return(string_bytes));
+    EXPECT_CALL(mock, get_length(_, 0)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_isnull(_, 0)).WillRepeatedly(Return(false));
+
+    std::vector<hana_adapted_test_result> got(3);
+    ozo::recv_result(res, oid_map, got.begin());
+    EXPECT_EQ(got[2].digit, 7);
+    EXPECT_EQ(got[2].text, "test");
+}
+
+TEST_F(recv_result, should_not_find_columns_for_result_with_cached_column_plan) {
+    const char int32_bytes[] = { 0x00, 0x00, 0x00, 0x07 };
+    const char* string_bytes = "test";
+
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(2));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(2));
+
+    EXPECT_CALL(mock, field_type(1)).WillRepeatedly(Return(23));
+    EXPECT_CALL(mock, get_value(_, 1)).WillRepeatedly(Return(int32_bytes));
+    EXPECT_CALL(mock, get_length(_, 1)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_isnull(_, 1)).WillRepeatedly(Return(false));
+
+    EXPECT_CALL(mock, field_type(0)).WillRepeatedly(Return(25));
+    EXPECT_CALL(mock, get_value(_, 0)).WillRepeatedly(Return(string_bytes));
+    EXPECT_CALL(mock, get_length(_, 0)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_isnull(_, 0)).WillRepeatedly(Return(false));
+
+    ozo::detail::column_plan_cache plans;
+    plans.emplace<fusion_adapted_test_result>(std::array<int, 2> {{0, 1}});
+
+    std::vector<fusion_adapted_test_result> got;
+    auto out = std::back_inserter(got);
+    std::string context;
+    EXPECT_FALSE(ozo::detail::try_recv_result_code(res, oid_map, out, context, &plans));
+    ASSERT_EQ(got.size(), 2u);
+    EXPECT_EQ(got[1].digit, 7);
+    EXPECT_EQ(got[1].text, "test");
+}
+
+TEST_F(recv_result, describe_result_should_add_column_plan_of_output_row_type) {
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(2));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(0));
+    EXPECT_CALL(mock, field_number(Eq("digit"s))).WillOnce(Return(1));
+    EXPECT_CALL(mock, field_type(1)).WillRepeatedly(Return(23));
+    EXPECT_CALL(mock, field_number(Eq("text"s))).WillOnce(Return(0));
+    EXPECT_CALL(mock, field_type(0)).WillRepeatedly(Return(25));
+
+    ozo::detail::column_plan_cache plans;
+    std::vector<hana_adapted_test_result> got;
+    ozo::detail::describe_result(res, oid_map, std::back_inserter(got), plans);
+
+    std::array<int, 2> plan;
+    ASSERT_TRUE(plans.find<hana_adapted_test_result>(plan));
+    EXPECT_THAT(plan, ElementsAre(0, 1));
+}
+
+TEST_F(recv_result, describe_result_should_not_add_column_plan_for_columns_mismatch) {
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(2));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(0));
+    EXPECT_CALL(mock, field_number(_)).WillRepeatedly(Return(-1));
+
+    ozo::detail::column_plan_cache plans;
+    std::vector<hana_adapted_test_result> got;
+    ozo::detail::describe_result(res, oid_map, std::back_inserter(got), plans);
+
+    EXPECT_TRUE(plans.empty());
+}
+
+TEST_F(recv_result, should_not_find_columns_for_empty_result) {
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(0));
+
+    std::vector<hana_adapted_test_result> got;
+    ozo::recv_result(res, oid_map, std::back_inserter(got));
+    EXPECT_TRUE(got.empty());
+}
+
+TEST_F(recv_result, send_convert_INT4OID_and_TEXTOID_to_fusion_adapted_structures_vector_via_iterator) {
+    const char int32_bytes[] = { 0x00, 0x00, 0x00, 0x07 };
+    const char* string_bytes = "test";
+
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(2));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(2));
+
+    EXPECT_CALL(mock, field_number(Eq("digit"s))).WillRepeatedly(Return(0));
+    EXPECT_CALL(mock, field_type(0)).WillRepeatedly(Return(23));
+    EXPECT_CALL(mock, get_value(_, 0)).WillRepeatedly(Return(int32_bytes));
+    EXPECT_CALL(mock, get_length(_, 0)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_isnull(_, 0)).WillRepeatedly(Return(false));
+
+    EXPECT_CALL(mock, field_number(Eq("text"s))).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, field_type(1)).WillRepeatedly(Return(25));
+    EXPECT_CALL(mock, get_value(_, 1)).WillRepeatedly(Return(string_bytes));
     EXPECT_CALL(mock, get_length(_, 1)).WillRepeatedly(Return(4));
     EXPECT_CALL(mock, get_isnull(_, 1)).WillRepeatedly(Return(false));
 
@@ -729,6 +1465,453 @@ TEST_F(recv_result, send_convert_INT4OID_to_vector_via_iterator) {
     EXPECT_THAT(got, ElementsAre(7, 7));
 }
 
+TEST_F(recv_result, should_check_columns_oids_once_per_result) {
+    const char int32_bytes[] = { 0x00, 0x00, 0x00, 0x07 };
+
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(3));
+
+    EXPECT_CALL(mock, field_type(0)).WillOnce(Return(23));
+    EXPECT_CALL(mock, get_value(_, 0)).WillRepeatedly(Return(int32_bytes));
+    EXPECT_CALL(mock, get_length(_, 0)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_isnull(_, 0)).WillRepeatedly(Return(false));
+
+    std::vector<std::tuple<std::int32_t>> got;
+    ozo::recv_result(res, oid_map, std::back_inserter(got));
+    EXPECT_THAT(got, ElementsAre(std::make_tuple(7), std::make_tuple(7), std::make_tuple(7)));
+}
+
+TEST_F(recv_result, should_throw_oid_type_mismatch_before_receiving_values) {
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(2));
+
+    EXPECT_CALL(mock, field_type(0)).WillRepeatedly(Return(25));
+
+    std::vector<std::int32_t> got;
+    try {
+        ozo::recv_result(res, oid_map, std::back_inserter(got));
+        FAIL() << "no exception thrown";
+    } catch (const ozo::system_error& e) {
+        EXPECT_EQ(e.code(), ozo::error::oid_type_mismatch);
+    }
+    EXPECT_TRUE(got.empty());
+}
+
+TEST_F(recv_result, should_throw_oid_type_mismatch_for_null_value_in_first_row) {
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(2));
+
+    EXPECT_CALL(mock, field_type(0)).WillRepeatedly(Return(25));
+    EXPECT_CALL(mock, get_isnull(_, 0)).WillRepeatedly(Return(true));
+
+    std::vector<std::optional<std::int32_t>> got;
+    EXPECT_THROW(ozo::recv_result(res, oid_map, std::back_inserter(got)), ozo::system_error);
+}
+
+TEST_F(recv_result, should_convert_rows_into_static_rows) {
+    const char int32_bytes[] = { 0x00, 0x00, 0x00, 0x07 };
+
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(2));
+
+    EXPECT_CALL(mock, field_type(0)).WillRepeatedly(Return(23));
+    EXPECT_CALL(mock, get_value(_, 0)).WillRepeatedly(Return(int32_bytes));
+    EXPECT_CALL(mock, get_length(_, 0)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_isnull(_, 0)).WillRepeatedly(Return(false));
+
+    ozo::static_rows_of<2, std::int32_t> got;
+    ozo::recv_result(res, oid_map, ozo::into(got));
+    ASSERT_EQ(got.size(), 2u);
+    EXPECT_EQ(std::get<0>(got[0]), 7);
+    EXPECT_EQ(std::get<0>(got[1]), 7);
+}
+
+TEST_F(recv_result, should_throw_too_many_rows_and_leave_static_rows_unchanged_if_rows_exceed_capacity) {
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(2));
+
+    EXPECT_CALL(mock, field_type(0)).WillRepeatedly(Return(23));
+
+    ozo::static_rows_of<2, std::int32_t> got;
+    got.emplace_back(std::make_tuple(42));
+    try {
+        ozo::recv_result(res, oid_map, ozo::into(got));
+        FAIL() << "exception is expected";
+    } catch (const ozo::system_error& e) {
+        EXPECT_EQ(e.code(), ozo::error::too_many_rows);
+    }
+    ASSERT_EQ(got.size(), 1u);
+    EXPECT_EQ(std::get<0>(got[0]), 42);
+}
+
+TEST_F(recv_result, should_throw_too_many_rows_if_rows_exceed_capacity_of_static_vector) {
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(3));
+
+    EXPECT_CALL(mock, field_type(0)).WillRepeatedly(Return(23));
+
+    boost::container::static_vector<std::tuple<std::int32_t>, 2> got;
+    EXPECT_THROW(ozo::recv_result(res, oid_map, ozo::into(got)), ozo::system_error);
+    EXPECT_TRUE(got.empty());
+}
+
+TEST_F(recv_result, should_convert_single_row_into_optional_row) {
+    const char int32_bytes[] = { 0x00, 0x00, 0x00, 0x07 };
+
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(1));
+
+    EXPECT_CALL(mock, field_type(0)).WillRepeatedly(Return(23));
+    EXPECT_CALL(mock, get_value(_, 0)).WillRepeatedly(Return(int32_bytes));
+    EXPECT_CALL(mock, get_length(_, 0)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_isnull(_, 0)).WillRepeatedly(Return(false));
+
+    std::optional<std::tuple<std::int32_t>> got;
+    ozo::recv_result(res, oid_map, ozo::into(got));
+    ASSERT_TRUE(got);
+    EXPECT_EQ(std::get<0>(*got), 7);
+}
+
+TEST_F(recv_result, should_reset_optional_row_for_empty_result) {
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(0));
+
+    std::optional<std::tuple<std::int32_t>> got {std::make_tuple(42)};
+    ozo::recv_result(res, oid_map, ozo::into(got));
+    EXPECT_FALSE(got);
+}
+
+TEST_F(recv_result, should_throw_too_many_rows_for_optional_row_if_result_has_more_than_one_row) {
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(2));
+
+    std::optional<std::tuple<std::int32_t>> got;
+    EXPECT_THROW(ozo::recv_result(res, oid_map, ozo::into(got)), ozo::system_error);
+    EXPECT_FALSE(got);
+}
+
+TEST_F(recv_result, should_receive_rows_over_existing_rows_reusing_their_storage_and_trim_tail) {
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(2));
+
+    EXPECT_CALL(mock, field_type(0)).WillRepeatedly(Return(25));
+    EXPECT_CALL(mock, get_value(_, 0)).WillRepeatedly(Return("test"));
+    EXPECT_CALL(mock, get_length(_, 0)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_isnull(_, 0)).WillRepeatedly(Return(false));
+
+    ozo::rows_of<std::string> got {{std::string(64, 'a')}, {std::string(64, 'b')}, {"c"}};
+    const auto data = std::get<0>(got[0]).data();
+    const auto rows_data = got.data();
+    auto out = ozo::overwrite(got);
+    ozo::recv_result(res, oid_map, out);
+    EXPECT_THAT(got, ElementsAre(std::make_tuple("test"), std::make_tuple("test")));
+    EXPECT_EQ(std::get<0>(got[0]).data(), data);
+    EXPECT_EQ(got.data(), rows_data);
+}
+
+TEST_F(recv_result, should_receive_rows_over_existing_rows_appending_new_rows) {
+    const char int32_bytes[] = { 0x00, 0x00, 0x00, 0x07 };
+
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(2));
+
+    EXPECT_CALL(mock, field_type(0)).WillRepeatedly(Return(23));
+    EXPECT_CALL(mock, get_value(_, 0)).WillRepeatedly(Return(int32_bytes));
+    EXPECT_CALL(mock, get_length(_, 0)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_isnull(_, 0)).WillRepeatedly(Return(false));
+
+    ozo::rows_of<std::int32_t> got {{1}};
+    auto out = ozo::overwrite(got);
+    ozo::recv_result(res, oid_map, out);
+    EXPECT_THAT(got, ElementsAre(std::make_tuple(7), std::make_tuple(7)));
+}
+
+TEST_F(recv_result, should_remove_rows_from_failed_one_when_receiving_over_existing_rows) {
+    const char int32_bytes[] = { 0x00, 0x00, 0x00, 0x07 };
+
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(2));
+
+    EXPECT_CALL(mock, field_type(0)).WillRepeatedly(Return(23));
+    EXPECT_CALL(mock, get_value(_, 0)).WillRepeatedly(Return(int32_bytes));
+    EXPECT_CALL(mock, get_length(_, 0)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_isnull(0, 0)).WillRepeatedly(Return(false));
+    EXPECT_CALL(mock, get_isnull(1, 0)).WillRepeatedly(Return(true));
+
+    ozo::rows_of<std::int32_t> got {{1}, {2}, {3}};
+    auto out = ozo::overwrite(got);
+    EXPECT_THROW(ozo::recv_result(res, oid_map, out), std::invalid_argument);
+    EXPECT_THAT(got, ElementsAre(std::make_tuple(7)));
+}
+
+TEST_F(recv_result, should_convert_columns_into_tuple_of_containers) {
+    const char int64_bytes[] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x07 };
+    const char* string_bytes = "test";
+
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(2));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(2));
+
+    EXPECT_CALL(mock, field_type(0)).WillOnce(Return(20));
+    EXPECT_CALL(mock, get_value(_, 0)).WillRepeatedly(Return(int64_bytes));
+    EXPECT_CALL(mock, get_length(_, 0)).WillRepeatedly(Return(8));
+    EXPECT_CALL(mock, get_isnull(_, 0)).WillRepeatedly(Return(false));
+
+    EXPECT_CALL(mock, field_type(1)).WillOnce(Return(25));
+    EXPECT_CALL(mock, get_value(_, 1)).WillRepeatedly(Return(string_bytes));
+    EXPECT_CALL(mock, get_length(_, 1)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_isnull(_, 1)).WillRepeatedly(Return(false));
+
+    std::tuple<std::vector<std::int64_t>, std::vector<std::string>> got;
+    ozo::recv_result(res, oid_map, got);
+    EXPECT_THAT(std::get<0>(got), ElementsAre(7, 7));
+    EXPECT_THAT(std::get<1>(got), ElementsAre("test", "test"));
+}
+
+TEST_F(recv_result, should_convert_text_column_into_pmr_vector_of_pmr_string_with_memory_resource_of_vector) {
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(2));
+
+    EXPECT_CALL(mock, field_type(0)).WillOnce(Return(25));
+    EXPECT_CALL(mock, get_value(_, 0)).WillRepeatedly(Return("test"));
+    EXPECT_CALL(mock, get_length(_, 0)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_isnull(_, 0)).WillRepeatedly(Return(false));
+
+    std::pmr::monotonic_buffer_resource resource;
+    std::tuple<std::pmr::vector<std::pmr::string>> got {std::pmr::vector<std::pmr::string>(&resource)};
+    ozo::recv_result(res, oid_map, got);
+    EXPECT_THAT(std::get<0>(got), ElementsAre("test", "test"));
+    EXPECT_EQ(std::get<0>(got)[0].get_allocator().resource(), &resource);
+    EXPECT_EQ(std::get<0>(got)[1].get_allocator().resource(), &resource);
+}
+
+TEST_F(recv_result, should_convert_timestamp_column_into_container_of_time_points) {
+    const char bytes[] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0F, 0x42, 0x40 };
+
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(2));
+
+    EXPECT_CALL(mock, field_type(0)).WillOnce(Return(1114));
+    EXPECT_CALL(mock, get_value(_, 0)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, 0)).WillRepeatedly(Return(8));
+    EXPECT_CALL(mock, get_isnull(_, 0)).WillRepeatedly(Return(false));
+
+    std::tuple<std::vector<std::chrono::system_clock::time_point>> got;
+    ozo::recv_result(res, oid_map, got);
+    const auto expected = ozo::detail::epoch + std::chrono::seconds(1);
+    EXPECT_THAT(std::get<0>(got), ElementsAre(expected, expected));
+}
+
+TEST_F(recv_result, should_append_columns_to_containers) {
+    const char float64_bytes[] = { 0x40, 0x09, 0x21, char(0xFB), 0x54, 0x44, 0x2D, 0x18 };
+
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(2));
+
+    EXPECT_CALL(mock, field_type(0)).WillOnce(Return(701));
+    EXPECT_CALL(mock, get_value(_, 0)).WillRepeatedly(Return(float64_bytes));
+    EXPECT_CALL(mock, get_length(_, 0)).WillRepeatedly(Return(8));
+    EXPECT_CALL(mock, get_isnull(_, 0)).WillRepeatedly(Return(false));
+
+    std::tuple<std::vector<double>> got {{1.0}};
+    ozo::recv_result(res, oid_map, got);
+    EXPECT_THAT(std::get<0>(got), ElementsAre(1.0, 3.14159265358979311599796346854, 3.14159265358979311599796346854));
+}
+
+TEST_F(recv_result, should_convert_nullable_column_into_container) {
+    const char int32_bytes[] = { 0x00, 0x00, 0x00, 0x07 };
+
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(2));
+
+    EXPECT_CALL(mock, field_type(0)).WillOnce(Return(23));
+    EXPECT_CALL(mock, get_value(_, 0)).WillRepeatedly(Return(int32_bytes));
+    EXPECT_CALL(mock, get_length(_, 0)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_isnull(0, 0)).WillRepeatedly(Return(true));
+    EXPECT_CALL(mock, get_isnull(1, 0)).WillRepeatedly(Return(false));
+
+    std::tuple<std::vector<std::optional<std::int32_t>>> got;
+    ozo::recv_result(res, oid_map, got);
+    EXPECT_THAT(std::get<0>(got), ElementsAre(std::nullopt, 7));
+}
+
+TEST_F(recv_result, should_convert_nullable_column_into_nullable_vector) {
+    const char int32_bytes[] = { 0x00, 0x00, 0x00, 0x07 };
+
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(3));
+
+    EXPECT_CALL(mock, field_type(0)).WillOnce(Return(23));
+    EXPECT_CALL(mock, get_value(_, 0)).WillRepeatedly(Return(int32_bytes));
+    EXPECT_CALL(mock, get_length(_, 0)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_isnull(0, 0)).WillRepeatedly(Return(false));
+    EXPECT_CALL(mock, get_isnull(1, 0)).WillRepeatedly(Return(true));
+    EXPECT_CALL(mock, get_isnull(2, 0)).WillRepeatedly(Return(false));
+
+    std::tuple<ozo::nullable_vector<std::int32_t>> got;
+    ozo::recv_result(res, oid_map, got);
+    EXPECT_THAT(std::get<0>(got), ElementsAre(7, 0, 7));
+    EXPECT_FALSE(std::get<0>(got).is_null(0));
+    EXPECT_TRUE(std::get<0>(got).is_null(1));
+    EXPECT_FALSE(std::get<0>(got).is_null(2));
+}
+
+TEST_F(recv_result, should_convert_nullable_text_column_into_nullable_vector) {
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(2));
+
+    EXPECT_CALL(mock, field_type(0)).WillOnce(Return(25));
+    EXPECT_CALL(mock, get_value(_, 0)).WillRepeatedly(Return("test"));
+    EXPECT_CALL(mock, get_length(_, 0)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_isnull(0, 0)).WillRepeatedly(Return(true));
+    EXPECT_CALL(mock, get_isnull(1, 0)).WillRepeatedly(Return(false));
+
+    std::tuple<ozo::nullable_vector<std::string>> got;
+    ozo::recv_result(res, oid_map, got);
+    EXPECT_THAT(std::get<0>(got), ElementsAre("", "test"));
+    EXPECT_TRUE(std::get<0>(got).is_null(0));
+    EXPECT_FALSE(std::get<0>(got).is_null(1));
+}
+
+TEST_F(recv_result, should_throw_for_null_in_fixed_size_column) {
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(1));
+
+    EXPECT_CALL(mock, field_type(0)).WillOnce(Return(23));
+    EXPECT_CALL(mock, get_isnull(_, 0)).WillRepeatedly(Return(true));
+
+    std::tuple<std::vector<std::int32_t>> got;
+    EXPECT_THROW(ozo::recv_result(res, oid_map, got), std::invalid_argument);
+}
+
+TEST_F(recv_result, should_throw_for_bad_size_in_fixed_size_column) {
+    const char int32_bytes[] = { 0x00, 0x00, 0x00, 0x07 };
+
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(1));
+
+    EXPECT_CALL(mock, field_type(0)).WillOnce(Return(20));
+    EXPECT_CALL(mock, get_value(_, 0)).WillRepeatedly(Return(int32_bytes));
+    EXPECT_CALL(mock, get_length(_, 0)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_isnull(_, 0)).WillRepeatedly(Return(false));
+
+    std::tuple<std::vector<std::int64_t>> got;
+    EXPECT_THROW(ozo::recv_result(res, oid_map, got), ozo::system_error);
+}
+
+TEST_F(recv_result, should_convert_columns_into_tuple_of_containers_via_reference_wrapper) {
+    const char int32_bytes[] = { 0x00, 0x00, 0x00, 0x07 };
+
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(1));
+
+    EXPECT_CALL(mock, field_type(0)).WillOnce(Return(23));
+    EXPECT_CALL(mock, get_value(_, 0)).WillRepeatedly(Return(int32_bytes));
+    EXPECT_CALL(mock, get_length(_, 0)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_isnull(_, 0)).WillRepeatedly(Return(false));
+
+    ozo::columns_of<std::int32_t> got;
+    ozo::recv_result(res, oid_map, ozo::into(got));
+    EXPECT_THAT(std::get<0>(got), ElementsAre(7));
+}
+
+TEST_F(recv_result, should_throw_range_error_if_columns_count_does_not_match_tuple_size) {
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(1));
+
+    std::tuple<std::vector<std::int64_t>, std::vector<std::int64_t>> got;
+    EXPECT_THROW(ozo::recv_result(res, oid_map, got), std::range_error);
+}
+
+TEST_F(recv_result, should_throw_oid_type_mismatch_for_column_of_wrong_type) {
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(1));
+
+    EXPECT_CALL(mock, field_type(0)).WillOnce(Return(25));
+
+    std::tuple<std::vector<std::int64_t>> got;
+    EXPECT_THROW(ozo::recv_result(res, oid_map, got), ozo::system_error);
+}
+
+TEST_F(recv_result, should_convert_rows_into_borrowed_rows_pointing_to_the_result) {
+    const char int32_bytes[] = { 0x00, 0x00, 0x00, 0x07 };
+    const char* string_bytes = "test";
+
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(2));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(2));
+
+    EXPECT_CALL(mock, field_type(0)).WillRepeatedly(Return(23));
+    EXPECT_CALL(mock, get_value(_, 0)).WillRepeatedly(Return(int32_bytes));
+    EXPECT_CALL(mock, get_length(_, 0)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_isnull(_, 0)).WillRepeatedly(Return(false));
+
+    EXPECT_CALL(mock, field_type(1)).WillRepeatedly(Return(25));
+    EXPECT_CALL(mock, get_value(_, 1)).WillRepeatedly(Return(string_bytes));
+    EXPECT_CALL(mock, get_length(_, 1)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_isnull(_, 1)).WillRepeatedly(Return(false));
+
+    ozo::borrowed_rows<std::tuple<std::int32_t, std::string_view>, pg_result_mock*> got;
+    ozo::recv_result(res, oid_map, ozo::into(got));
+    ASSERT_EQ(got.size(), 2u);
+    EXPECT_EQ(std::get<0>(got[1]), 7);
+    EXPECT_EQ(std::get<1>(got[1]), "test");
+    EXPECT_EQ(std::get<1>(got[1]).data(), string_bytes);
+    EXPECT_EQ(got.get_result().native_handle(), &mock);
+}
+
+TEST_F(recv_result, should_receive_empty_result_into_empty_borrowed_rows) {
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(0));
+
+    ozo::borrowed_rows<std::string_view, pg_result_mock*> got;
+    ozo::recv_result(res, oid_map, got);
+    EXPECT_TRUE(got.empty());
+}
+
+TEST_F(recv_result, should_reserve_result_size_in_container_for_back_inserter) {
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(3));
+    EXPECT_CALL(mock, field_type(0)).WillRepeatedly(Return(23));
+    const char int32_bytes[] = { 0x00, 0x00, 0x00, 0x07 };
+    EXPECT_CALL(mock, get_value(_, 0)).WillRepeatedly(Return(int32_bytes));
+    EXPECT_CALL(mock, get_length(_, 0)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_isnull(_, 0)).WillRepeatedly(Return(false));
+
+    reserve_recording_container got;
+    ozo::recv_result(res, oid_map, std::back_inserter(got));
+    EXPECT_THAT(got.reserved, ElementsAre(3u));
+    EXPECT_THAT(got, ElementsAre(7, 7, 7));
+}
+
+TEST_F(recv_result, should_grow_vector_capacity_at_least_twice_for_sequential_results) {
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, field_type(0)).WillRepeatedly(Return(23));
+    const char int32_bytes[] = { 0x00, 0x00, 0x00, 0x07 };
+    EXPECT_CALL(mock, get_value(_, 0)).WillRepeatedly(Return(int32_bytes));
+    EXPECT_CALL(mock, get_length(_, 0)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_isnull(_, 0)).WillRepeatedly(Return(false));
+
+    std::vector<std::int32_t> got;
+    got.reserve(4);
+    got.resize(4);
+    ozo::recv_result(res, oid_map, std::back_inserter(got));
+    EXPECT_EQ(got.size(), 5u);
+    EXPECT_GE(got.capacity(), 8u);
+}
+
+TEST_F(recv_result, should_not_append_row_to_container_for_back_inserter_when_it_can_not_be_received) {
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, field_type(0)).WillRepeatedly(Return(23));
+    const char int32_bytes[] = { 0x00, 0x00, 0x00, 0x07 };
+    EXPECT_CALL(mock, get_value(_, 0)).WillRepeatedly(Return(int32_bytes));
+    EXPECT_CALL(mock, get_length(_, 0)).WillRepeatedly(Return(2));
+    EXPECT_CALL(mock, get_isnull(_, 0)).WillRepeatedly(Return(false));
+
+    std::vector<std::int32_t> got;
+    EXPECT_THROW(ozo::recv_result(res, oid_map, std::back_inserter(got)), ozo::system_error);
+    EXPECT_TRUE(got.empty());
+}
+
 TEST_F(recv_result, send_returns_result_then_result_requested) {
     ozo::basic_result<pg_result_mock*> got;
     ozo::recv_result(res, oid_map, got);
@@ -736,6 +1919,152 @@ TEST_F(recv_result, send_returns_result_then_result_requested) {
     EXPECT_EQ(got.size(), 2u);
 }
 
+TEST_F(recv_result, try_recv_result_should_receive_rows_and_return_no_error) {
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(2));
+    EXPECT_CALL(mock, field_type(0)).WillRepeatedly(Return(23));
+    const char int32_bytes[] = { 0x00, 0x00, 0x00, 0x07 };
+    EXPECT_CALL(mock, get_value(_, 0)).WillRepeatedly(Return(int32_bytes));
+    EXPECT_CALL(mock, get_length(_, 0)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_isnull(_, 0)).WillRepeatedly(Return(false));
+
+    std::vector<std::int32_t> got;
+    auto out = std::back_inserter(got);
+    std::string context;
+    EXPECT_FALSE(ozo::try_recv_result(res, oid_map, out, context));
+    EXPECT_THAT(got, ElementsAre(7, 7));
+    EXPECT_TRUE(context.empty());
+}
+
+TEST_F(recv_result, try_recv_result_should_return_oid_type_mismatch) {
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(2));
+    EXPECT_CALL(mock, field_type(0)).WillRepeatedly(Return(25));
+
+    std::vector<std::int32_t> got;
+    auto out = std::back_inserter(got);
+    std::string context;
+    EXPECT_EQ(ozo::try_recv_result(res, oid_map, out, context), ozo::error::oid_type_mismatch);
+    EXPECT_THAT(context, HasSubstr("unexpected oid 25"));
+    EXPECT_TRUE(got.empty());
+}
+
+TEST_F(recv_result, try_recv_result_should_return_bad_object_size_and_remove_row) {
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, field_type(0)).WillRepeatedly(Return(23));
+    const char int32_bytes[] = { 0x00, 0x00, 0x00, 0x07 };
+    EXPECT_CALL(mock, get_value(_, 0)).WillRepeatedly(Return(int32_bytes));
+    EXPECT_CALL(mock, get_length(_, 0)).WillRepeatedly(Return(2));
+    EXPECT_CALL(mock, get_isnull(_, 0)).WillRepeatedly(Return(false));
+
+    std::vector<std::int32_t> got;
+    auto out = std::back_inserter(got);
+    std::string context;
+    EXPECT_EQ(ozo::try_recv_result(res, oid_map, out, context), ozo::error::bad_object_size);
+    EXPECT_TRUE(got.empty());
+}
+
+TEST_F(recv_result, try_recv_result_should_return_unexpected_null_for_not_nullable) {
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, field_type(0)).WillRepeatedly(Return(23));
+    EXPECT_CALL(mock, get_isnull(_, 0)).WillRepeatedly(Return(true));
+
+    std::vector<std::int32_t> got;
+    auto out = std::back_inserter(got);
+    std::string context;
+    EXPECT_EQ(ozo::try_recv_result(res, oid_map, out, context), ozo::error::unexpected_null);
+    EXPECT_THAT(context, HasSubstr("unexpected null"));
+}
+
+TEST_F(recv_result, try_recv_result_should_return_bad_row_size_for_row_size_mismatch) {
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(2));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(1));
+
+    std::vector<std::int32_t> got;
+    auto out = std::back_inserter(got);
+    std::string context;
+    EXPECT_EQ(ozo::try_recv_result(res, oid_map, out, context), ozo::error::bad_row_size);
+    EXPECT_EQ(ozo::error_condition(ozo::errc::type_mismatch), ozo::error::bad_row_size);
+}
+
+TEST_F(recv_result, try_recv_result_should_return_unexpected_null_for_fixed_size_column) {
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, field_type(0)).WillRepeatedly(Return(23));
+    EXPECT_CALL(mock, get_isnull(_, 0)).WillRepeatedly(Return(true));
+
+    std::tuple<std::vector<std::int32_t>> got;
+    std::string context;
+    EXPECT_EQ(ozo::try_recv_result(res, oid_map, got, context), ozo::error::unexpected_null);
+    EXPECT_TRUE(std::get<0>(got).empty());
+}
+
+TEST_F(recv_result, recv_result_should_throw_invalid_argument_for_unexpected_null) {
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, field_type(0)).WillRepeatedly(Return(23));
+    EXPECT_CALL(mock, get_isnull(_, 0)).WillRepeatedly(Return(true));
+
+    std::vector<std::int32_t> got;
+    EXPECT_THROW(ozo::recv_result(res, oid_map, std::back_inserter(got)), std::invalid_argument);
+}
+
+template <typename Numeric>
+Numeric numeric_round_trip(const Numeric& in) {
+    std::vector<char> buffer;
+    ozo::ostream os{buffer};
+    ozo::send(os, ozo::empty_oid_map{}, in);
+    EXPECT_EQ(std::size(buffer), static_cast<std::size_t>(ozo::size_of(in)));
+    ozo::istream is{buffer.data(), buffer.size()};
+    Numeric out;
+    ozo::recv(is, 1700, static_cast<ozo::size_type>(buffer.size()), ozo::empty_oid_map{}, out);
+    return out;
+}
+
+TEST(pg_numeric, should_keep_value_and_scale_through_send_and_recv) {
+    for (const auto& v : {
+            ozo::pg::numeric64{0, 0},
+            ozo::pg::numeric64{1, 0},
+            ozo::pg::numeric64{-1, 5},
+            ozo::pg::numeric64{10000, 0},
+            ozo::pg::numeric64{123456789, 3},
+            ozo::pg::numeric64{-5, 2},
+            ozo::pg::numeric64{5, 21},
+            ozo::pg::numeric64{std::numeric_limits<std::int64_t>::max(), 4},
+            ozo::pg::numeric64{std::numeric_limits<std::int64_t>::min(), 0}}) {
+        EXPECT_EQ(numeric_round_trip(v), v) << v.to_string();
+    }
+}
+
+TEST(pg_numeric, should_keep_128_bit_value_through_send_and_recv) {
+    const ozo::pg::int128_t big = ozo::pg::int128_t(1234567890123456789LL) * 1000000000000000000LL + 123456789;
+    for (const auto& v : {
+            ozo::pg::numeric{big, 0},
+            ozo::pg::numeric{-big, 7},
+            ozo::pg::numeric{42, 2}}) {
+        EXPECT_EQ(numeric_round_trip(v), v) << v.to_string();
+    }
+}
+
+TEST(pg_numeric, recv_should_throw_range_error_if_value_does_not_fit_into_representation) {
+    std::vector<char> buffer;
+    ozo::ostream os{buffer};
+    ozo::send(os, ozo::empty_oid_map{}, ozo::pg::numeric{ozo::pg::int128_t(1) << 100, 0});
+    ozo::istream is{buffer.data(), buffer.size()};
+    ozo::pg::numeric64 out;
+    EXPECT_THROW(ozo::recv(is, 1700, static_cast<ozo::size_type>(buffer.size()), ozo::empty_oid_map{}, out),
+        std::range_error);
+}
+
+TEST(pg_numeric, to_string_should_print_scale_digits) {
+    EXPECT_EQ(ozo::pg::numeric64(-5, 3).to_string(), "-0.005");
+    EXPECT_EQ(ozo::pg::numeric64(1200, 2).to_string(), "12.00");
+    EXPECT_EQ(ozo::pg::numeric64(0, 0).to_string(), "0");
+    EXPECT_DOUBLE_EQ(ozo::pg::numeric64(-12345, 2).to_double(), -123.45);
+}
+
 TEST_F(recv, should_convert_UUIDOID_to_uuid) {
     const char bytes[] = {
         0x12, 0x34, 0x56, 0x78,
@@ -796,6 +2125,18 @@ TEST_F(recv, should_convert_INTERVALOID_to_chrono_microseconds) {
     EXPECT_EQ(result, expected);
 }
 
+TEST_F(recv, should_throw_for_INTERVALOID_of_wrong_size) {
+    const char bytes[12] = {};
+
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(1186));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(12));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    std::chrono::microseconds result;
+    EXPECT_THROW(ozo::recv(value, oid_map, result), ozo::system_error);
+}
+
 struct to_duration : TestWithParam<std::tuple<ozo::detail::pg_interval, std::chrono::microseconds>> {
 };
 
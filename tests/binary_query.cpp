@@ -1,11 +1,21 @@
 #include <ozo/io/binary_query.h>
 #include <ozo/optional.h>
+#include <ozo/prepared_query.h>
+#include <ozo/query_builder.h>
 
 #include <iterator>
+#include <optional>
+#include <string_view>
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+namespace ozo::tests {
+OZO_STRONG_TYPEDEF(std::string, binary_query_custom_text)
+} // namespace ozo::tests
+
+OZO_PG_DEFINE_CUSTOM_TYPE(ozo::tests::binary_query_custom_text, "binary_query_custom_text")
+
 namespace {
 
 namespace hana = boost::hana;
@@ -41,6 +51,26 @@ TEST_F(binary_query_text, should_be_equal_to_input) {
     EXPECT_STREQ(query.text(), "query");
 }
 
+TEST_F(binary_query_text, of_shared_query_text_should_point_to_the_shared_text) {
+    const ozo::shared_query_text text(std::string("query"));
+    const auto query = ozo::to_binary_query(ozo::make_query(text), ozo::empty_oid_map{});
+    EXPECT_EQ(query.text(), text.data());
+}
+
+TEST_F(binary_query_text, of_shared_query_text_should_point_to_the_shared_text_for_typed_binary_query_copy) {
+    const ozo::shared_query_text text(std::string("query"));
+    const auto query = ozo::to_typed_binary_query(ozo::make_query(text, 42), ozo::empty_oid_map{});
+    const auto copy = query;
+    EXPECT_EQ(copy.text(), text.data());
+}
+
+TEST_F(binary_query_text, of_shared_query_text_should_keep_the_text_after_the_handle_is_destroyed) {
+    std::optional<ozo::shared_query_text> text(std::string("query"));
+    const auto query = ozo::to_binary_query(ozo::make_query(*text), ozo::empty_oid_map{});
+    text.reset();
+    EXPECT_STREQ(query.text(), "query");
+}
+
 struct binary_query_types : Test {};
 
 TEST_F(binary_query_types, for_param_should_be_equal_to_type_oid) {
@@ -73,6 +103,23 @@ TEST_F(binary_query_types, for_null_std_weak_ptr_should_be_equal_to_value_type_o
     EXPECT_EQ(query.types()[0], ozo::type_traits<std::int32_t>::oid());
 }
 
+TEST_F(binary_query_types, for_built_in_params_should_be_shared_by_queries_with_the_same_params_types) {
+    const auto query = ozo::to_typed_binary_query(ozo::make_query("", std::int16_t(), std::string()), ozo::empty_oid_map{});
+    const auto other = ozo::to_typed_binary_query(ozo::make_query("", std::int16_t(1), std::string("text")), ozo::empty_oid_map{});
+    EXPECT_EQ(query.types(), other.types());
+    EXPECT_EQ(query.types()[0], ozo::type_traits<std::int16_t>::oid());
+    EXPECT_EQ(query.types()[1], ozo::type_traits<std::string>::oid());
+}
+
+TEST_F(binary_query_types, for_custom_type_param_should_be_equal_to_oid_from_oid_map) {
+    auto oid_map = ozo::register_types<ozo::tests::binary_query_custom_text>();
+    ozo::set_type_oid<ozo::tests::binary_query_custom_text>(oid_map, 100500);
+    const auto query = ozo::to_typed_binary_query(
+        ozo::make_query("", std::int16_t(), ozo::tests::binary_query_custom_text("text")), oid_map);
+    EXPECT_EQ(query.types()[0], ozo::type_traits<std::int16_t>::oid());
+    EXPECT_EQ(query.types()[1], 100500u);
+}
+
 struct binary_query_formats : Test {};
 
 TEST_F(binary_query_formats, format_of_the_param_should_be_equal_to_1) {
@@ -80,6 +127,12 @@ TEST_F(binary_query_formats, format_of_the_param_should_be_equal_to_1) {
     EXPECT_EQ(query.formats()[0], 1);
 }
 
+TEST_F(binary_query_formats, should_be_shared_by_queries_with_the_same_params_count) {
+    const auto query = make_binary_query("", hana::make_tuple(std::int16_t()));
+    const auto other = make_binary_query("", hana::make_tuple(std::string()));
+    EXPECT_EQ(query.formats(), other.formats());
+}
+
 struct binary_query_lengths : Test {};
 
 TEST_F(binary_query_lengths, should_be_equal_to_parameter_binary_serialized_data_size) {
@@ -173,4 +226,290 @@ TEST_F(binary_query_values, for_std_reference_wrapper_value_should_be_equal_to_b
         ElementsAre('s', 't', 'r', 'i', 'n', 'g'));
 }
 
+struct binary_query_small_buffer : Test {};
+
+TEST_F(binary_query_small_buffer, with_parameters_greater_than_small_buffer_should_store_them) {
+    const std::string value(ozo::binary_query::small_buffer_size + 1, 'x');
+    const auto query = make_binary_query("", hana::make_tuple(42, value));
+    EXPECT_EQ(query.lengths()[1], static_cast<int>(value.size()));
+    EXPECT_EQ(std::string(query.values()[1], query.lengths()[1]), value);
+}
+
+struct binary_query_borrowed : Test {};
+
+TEST_F(binary_query_borrowed, std_string_view_and_bytea_view_should_be_borrowed) {
+    EXPECT_TRUE(ozo::BorrowedParameter<std::string_view>);
+    EXPECT_TRUE(ozo::BorrowedParameter<ozo::pg::bytea_view>);
+    EXPECT_TRUE(ozo::BorrowedParameter<std::optional<std::string_view>>);
+    EXPECT_FALSE(ozo::BorrowedParameter<std::string>);
+    EXPECT_FALSE(ozo::BorrowedParameter<ozo::pg::bytea>);
+}
+
+TEST_F(binary_query_borrowed, std_string_view_value_should_point_to_the_parameter_memory) {
+    const std::string value(ozo::binary_query::small_buffer_size * 2, 'x');
+    const auto query = make_binary_query("", hana::make_tuple(std::int32_t(1), std::string_view(value)));
+    EXPECT_EQ(query.types()[1], ozo::type_traits<std::string>::oid());
+    EXPECT_EQ(query.lengths()[1], static_cast<int>(value.size()));
+    EXPECT_EQ(query.values()[1], value.data());
+    EXPECT_THAT(std::vector<char>(query.values()[0], query.values()[0] + 4), ElementsAre(0, 0, 0, 1));
+}
+
+TEST_F(binary_query_borrowed, bytea_view_value_should_point_to_the_parameter_memory) {
+    const std::vector<char> value {'\0', 'a', '\xff'};
+    const auto query = make_binary_query("", hana::make_tuple(ozo::pg::bytea_view(std::string_view(value.data(), value.size()))));
+    EXPECT_EQ(query.types()[0], ozo::type_traits<ozo::pg::bytea>::oid());
+    EXPECT_EQ(query.lengths()[0], 3);
+    EXPECT_EQ(query.values()[0], value.data());
+}
+
+TEST_F(binary_query_borrowed, empty_optional_value_should_be_nullptr) {
+    const auto query = make_binary_query("", hana::make_tuple(std::optional<std::string_view>{}));
+    EXPECT_EQ(query.lengths()[0], 0);
+    EXPECT_EQ(query.values()[0], nullptr);
+}
+
+TEST_F(binary_query_borrowed, should_not_take_space_of_the_buffer) {
+    const std::string value(ozo::binary_query::small_buffer_size * 2, 'x');
+    const auto query = make_binary_query("", hana::make_tuple(std::string_view(value), std::string("text")));
+    EXPECT_EQ(query.values()[0], value.data());
+    EXPECT_EQ(std::string(query.values()[1], query.lengths()[1]), "text");
+}
+
+TEST_F(binary_query_borrowed, typed_binary_query_copy_should_point_to_the_parameter_memory) {
+    const std::string value("borrowed");
+    const auto query = ozo::to_typed_binary_query(
+        ozo::make_query("", std::string("text"), std::string_view(value)), ozo::empty_oid_map{});
+    const auto copy = query;
+    EXPECT_EQ(copy.values()[1], value.data());
+    EXPECT_NE(copy.values()[0], query.values()[0]);
+    EXPECT_EQ(std::string(copy.values()[0], copy.lengths()[0]), "text");
+}
+
+TEST_F(binary_query_borrowed, rebind_should_point_to_the_new_parameter_memory) {
+    const std::string value("first");
+    const std::string other("second");
+    auto query = make_binary_query("", hana::make_tuple(std::string_view(value)));
+    query.rebind(hana::make_tuple(std::string_view(other)), ozo::empty_oid_map{});
+    EXPECT_EQ(query.values()[0], other.data());
+    EXPECT_EQ(query.lengths()[0], static_cast<int>(other.size()));
+}
+
+struct binary_query_single_pass : Test {};
+
+TEST_F(binary_query_single_pass, array_of_composites_parameter_should_be_equal_to_its_binary_representation) {
+    const std::vector<std::tuple<std::string, std::optional<std::int32_t>>> value {{"a", 1}, {"bc", std::nullopt}, {"d", 2}};
+    const auto query = make_binary_query("", hana::make_tuple(std::int32_t(1), value, std::string("text")));
+    std::vector<char> expected;
+    ozo::ostream os{expected};
+    ozo::send(os, ozo::empty_oid_map{}, value);
+    EXPECT_EQ(query.lengths()[1], ozo::size_of(value));
+    EXPECT_EQ(std::vector<char>(query.values()[1], query.values()[1] + query.lengths()[1]), expected);
+    EXPECT_THAT(std::vector<char>(query.values()[0], query.values()[0] + 4), ElementsAre(0, 0, 0, 1));
+    EXPECT_EQ(std::string(query.values()[2], query.lengths()[2]), "text");
+}
+
+TEST_F(binary_query_single_pass, null_array_parameter_should_be_nullptr) {
+    const auto query = make_binary_query("", hana::make_tuple(std::optional<std::vector<std::int32_t>>{}));
+    EXPECT_EQ(query.lengths()[0], 0);
+    EXPECT_EQ(query.values()[0], nullptr);
+}
+
+TEST_F(binary_query_single_pass, rebind_should_reuse_buffer_which_fits_parameters) {
+    auto query = make_binary_query("", hana::make_tuple(std::vector<std::int32_t>{1, 2, 3}));
+    const auto values = query.values();
+    query.rebind(hana::make_tuple(std::vector<std::int32_t>{4}), ozo::empty_oid_map{});
+    EXPECT_EQ(query.values(), values);
+    EXPECT_EQ(query.lengths()[0], ozo::size_of(std::vector<std::int32_t>{4}));
+}
+
+TEST_F(binary_query_single_pass, typed_binary_query_copy_should_point_to_own_data) {
+    const auto query = ozo::to_typed_binary_query(
+        ozo::make_query("", std::vector<std::int32_t>{1, 2}), ozo::empty_oid_map{});
+    const auto copy = query;
+    EXPECT_NE(copy.values()[0], query.values()[0]);
+    EXPECT_EQ(std::vector<char>(copy.values()[0], copy.values()[0] + copy.lengths()[0]),
+        std::vector<char>(query.values()[0], query.values()[0] + query.lengths()[0]));
+}
+
+struct binary_query_assign : Test {};
+
+TEST_F(binary_query_assign, should_replace_text_and_parameters) {
+    auto query = make_binary_query("", hana::make_tuple(std::string("text")));
+    query.assign(std::string("query"), hana::make_tuple(std::string("other")), ozo::empty_oid_map{});
+    EXPECT_STREQ(query.text(), "query");
+    EXPECT_EQ(std::string(query.values()[0], query.lengths()[0]), "other");
+}
+
+TEST_F(binary_query_assign, with_same_types_should_reuse_data_in_place) {
+    auto query = make_binary_query("", hana::make_tuple(std::int32_t(1)));
+    const auto values = query.values();
+    query.assign("", hana::make_tuple(std::int32_t(2)), ozo::empty_oid_map{});
+    EXPECT_EQ(query.values(), values);
+    EXPECT_THAT(std::vector<char>(query.values()[0], query.values()[0] + 4), ElementsAre(0, 0, 0, 2));
+}
+
+TEST_F(binary_query_assign, with_large_parameters_should_store_them) {
+    auto query = make_binary_query("", hana::make_tuple(std::string("text")));
+    const std::string value(ozo::binary_query::small_buffer_size * 2, 'x');
+    query.assign("", hana::make_tuple(value), ozo::empty_oid_map{});
+    EXPECT_EQ(std::string(query.values()[0], query.lengths()[0]), value);
+    query.assign("", hana::make_tuple(std::string("text")), ozo::empty_oid_map{});
+    EXPECT_EQ(std::string(query.values()[0], query.lengths()[0]), "text");
+}
+
+TEST_F(binary_query_assign, with_different_types_should_rebuild_data) {
+    auto query = make_binary_query("", hana::make_tuple(std::int32_t(1)));
+    query.assign("", hana::make_tuple(std::int16_t(2), std::int16_t(3)), ozo::empty_oid_map{});
+    EXPECT_EQ(query.params_count(), 2);
+    EXPECT_THAT(std::vector<char>(query.values()[1], query.values()[1] + 2), ElementsAre(0, 3));
+}
+
+TEST_F(binary_query_assign, should_not_modify_shared_copy) {
+    auto query = make_binary_query("", hana::make_tuple(std::int32_t(1)));
+    const auto copy = query;
+    query.assign("", hana::make_tuple(std::int32_t(2)), ozo::empty_oid_map{});
+    EXPECT_THAT(std::vector<char>(copy.values()[0], copy.values()[0] + 4), ElementsAre(0, 0, 0, 1));
+    EXPECT_THAT(std::vector<char>(query.values()[0], query.values()[0] + 4), ElementsAre(0, 0, 0, 2));
+}
+
+struct binary_query_rebind : Test {};
+
+TEST_F(binary_query_rebind, should_replace_parameters_and_keep_text_and_types) {
+    auto query = make_binary_query("query", hana::make_tuple(std::int16_t(1), std::string("text")));
+    query.rebind(hana::make_tuple(std::int16_t(2), std::string("other")), ozo::empty_oid_map{});
+    EXPECT_STREQ(query.text(), "query");
+    EXPECT_EQ(query.types()[0], ozo::type_traits<std::int16_t>::oid());
+    EXPECT_EQ(query.types()[1], ozo::type_traits<std::string>::oid());
+    EXPECT_THAT(std::vector<char>(query.values()[0], query.values()[0] + 2), ElementsAre(0, 2));
+    EXPECT_EQ(std::string(query.values()[1], query.lengths()[1]), "other");
+}
+
+TEST_F(binary_query_rebind, should_reuse_data_in_place) {
+    auto query = make_binary_query("", hana::make_tuple(std::int32_t(1)));
+    const auto values = query.values();
+    query.rebind(hana::make_tuple(std::int32_t(2)), ozo::empty_oid_map{});
+    EXPECT_EQ(query.values(), values);
+    EXPECT_THAT(std::vector<char>(query.values()[0], query.values()[0] + 4), ElementsAre(0, 0, 0, 2));
+}
+
+TEST_F(binary_query_rebind, should_reuse_buffer_for_large_parameters_which_fit_it) {
+    auto query = make_binary_query("", hana::make_tuple(std::string(ozo::binary_query::small_buffer_size * 2, 'x')));
+    const auto value = query.values()[0];
+    const std::string other(ozo::binary_query::small_buffer_size + 1, 'y');
+    query.rebind(hana::make_tuple(other), ozo::empty_oid_map{});
+    EXPECT_EQ(query.values()[0], value);
+    EXPECT_EQ(std::string(query.values()[0], query.lengths()[0]), other);
+}
+
+TEST_F(binary_query_rebind, should_not_modify_shared_copy) {
+    auto query = make_binary_query("query", hana::make_tuple(std::int32_t(1)));
+    const auto copy = query;
+    query.rebind(hana::make_tuple(std::int32_t(2)), ozo::empty_oid_map{});
+    EXPECT_STREQ(query.text(), "query");
+    EXPECT_THAT(std::vector<char>(copy.values()[0], copy.values()[0] + 4), ElementsAre(0, 0, 0, 1));
+    EXPECT_THAT(std::vector<char>(query.values()[0], query.values()[0] + 4), ElementsAre(0, 0, 0, 2));
+}
+
+TEST_F(binary_query_rebind, with_parameters_of_different_type_should_throw) {
+    auto query = make_binary_query("", hana::make_tuple(std::int32_t(1)));
+    EXPECT_THROW(query.rebind(hana::make_tuple(std::int16_t(2)), ozo::empty_oid_map{}), std::invalid_argument);
+}
+
+TEST_F(binary_query_rebind, for_query_concept_should_accept_its_parameters_type) {
+    const auto source = ozo::make_query("query", std::int32_t(1));
+    auto query = ozo::to_binary_query(source, ozo::empty_oid_map{});
+    query.rebind(std::decay_t<decltype(ozo::get_query_params(source))>(std::int32_t(2)), ozo::empty_oid_map{});
+    EXPECT_THAT(std::vector<char>(query.values()[0], query.values()[0] + 4), ElementsAre(0, 0, 0, 2));
+}
+
+struct rebuild_binary_query : Test {};
+
+TEST_F(rebuild_binary_query, from_query_concept_should_reuse_data_in_place) {
+    auto query = ozo::to_binary_query(ozo::make_query("", std::int32_t(1)), ozo::empty_oid_map{});
+    const auto values = query.values();
+    ozo::rebuild_binary_query(query, ozo::make_query("", std::int32_t(2)), ozo::empty_oid_map{});
+    EXPECT_EQ(query.values(), values);
+    EXPECT_THAT(std::vector<char>(query.values()[0], query.values()[0] + 4), ElementsAre(0, 0, 0, 2));
+}
+
+TEST_F(rebuild_binary_query, from_binary_query_should_assign_it) {
+    auto query = make_binary_query("", hana::make_tuple(std::int32_t(1)));
+    const auto other = make_binary_query("other", hana::make_tuple());
+    ozo::rebuild_binary_query(query, other, ozo::empty_oid_map{});
+    EXPECT_STREQ(query.text(), "other");
+    EXPECT_EQ(query.params_count(), 0);
+}
+
+struct typed_binary_query : Test {};
+
+TEST_F(typed_binary_query, should_contain_text_and_parameters) {
+    const auto query = ozo::to_typed_binary_query(
+        ozo::make_query("query", std::int16_t(7), std::string("text")), ozo::empty_oid_map{});
+    EXPECT_STREQ(query.text(), "query");
+    EXPECT_EQ(query.params_count(), 2);
+    EXPECT_EQ(query.types()[0], ozo::type_traits<std::int16_t>::oid());
+    EXPECT_EQ(query.formats()[1], 1);
+    EXPECT_EQ(query.lengths()[1], 4);
+    EXPECT_EQ(std::string(query.values()[1], query.lengths()[1]), "text");
+}
+
+TEST_F(typed_binary_query, copy_should_point_to_own_data) {
+    auto query = ozo::to_typed_binary_query(ozo::make_query("", std::int32_t(1)), ozo::empty_oid_map{});
+    const auto copy = query;
+    query.assign("", hana::make_tuple(std::int32_t(2)), ozo::empty_oid_map{});
+    EXPECT_NE(copy.values()[0], query.values()[0]);
+    EXPECT_THAT(std::vector<char>(copy.values()[0], copy.values()[0] + 4), ElementsAre(0, 0, 0, 1));
+    EXPECT_THAT(std::vector<char>(query.values()[0], query.values()[0] + 4), ElementsAre(0, 0, 0, 2));
+}
+
+TEST_F(typed_binary_query, moved_should_point_to_own_data) {
+    auto query = ozo::to_typed_binary_query(ozo::make_query("", std::int32_t(1)), ozo::empty_oid_map{});
+    const auto moved = std::move(query);
+    EXPECT_THAT(std::vector<char>(moved.values()[0], moved.values()[0] + 4), ElementsAre(0, 0, 0, 1));
+}
+
+TEST_F(typed_binary_query, with_parameters_greater_than_small_buffer_should_store_them) {
+    const std::string value(ozo::detail::binary_query_small_buffer_size + 1, 'x');
+    auto query = ozo::to_typed_binary_query(ozo::make_query("", value), ozo::empty_oid_map{});
+    const auto copy = query;
+    EXPECT_EQ(std::string(copy.values()[0], copy.lengths()[0]), value);
+}
+
+TEST_F(typed_binary_query, rebind_should_replace_parameters_in_place) {
+    auto query = ozo::to_typed_binary_query(ozo::make_query("query", std::int32_t(1)), ozo::empty_oid_map{});
+    const auto values = query.values();
+    query.rebind(hana::make_tuple(std::int32_t(2)), ozo::empty_oid_map{});
+    EXPECT_STREQ(query.text(), "query");
+    EXPECT_EQ(query.types()[0], ozo::type_traits<std::int32_t>::oid());
+    EXPECT_EQ(query.values(), values);
+    EXPECT_THAT(std::vector<char>(query.values()[0], query.values()[0] + 4), ElementsAre(0, 0, 0, 2));
+}
+
+TEST_F(typed_binary_query, should_be_convertible_to_binary_query) {
+    const auto typed = ozo::to_typed_binary_query(ozo::make_query("query", std::int32_t(1)), ozo::empty_oid_map{});
+    const auto query = ozo::to_binary_query(typed, ozo::empty_oid_map{});
+    EXPECT_STREQ(query.text(), "query");
+    EXPECT_EQ(query.params_count(), 1);
+    EXPECT_THAT(std::vector<char>(query.values()[0], query.values()[0] + 4), ElementsAre(0, 0, 0, 1));
+}
+
+TEST(prepared, should_derive_statement_key_from_static_query_text) {
+    using namespace ozo::literals;
+    const auto query = ozo::prepared("SELECT "_SQL + 1);
+    ASSERT_NE(query.statement, nullptr);
+    EXPECT_EQ(query.statement, ozo::prepared("SELECT "_SQL + 2).statement);
+    EXPECT_NE(query.statement, ozo::prepared("SELECT 1"_SQL).statement);
+    EXPECT_EQ(std::string_view(query.statement->name).substr(0, 5), "ozo_s");
+    EXPECT_EQ(std::string_view(query.statement->name).size(), 21u);
+}
+
+TEST(prepared, should_have_no_statement_key_for_runtime_query_text) {
+    EXPECT_EQ(ozo::prepared(ozo::make_query("SELECT 1")).statement, nullptr);
+}
+
+TEST(make_statement_name, should_make_name_of_hex_digits_of_id) {
+    EXPECT_EQ(std::string_view(ozo::detail::make_statement_name(0x0123456789abcdefull).data()),
+        "ozo_s0123456789abcdef");
+}
+
 } // namespace
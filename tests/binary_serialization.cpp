@@ -1,11 +1,20 @@
 #include <ozo/io/send.h>
 #include <ozo/io/array.h>
+#include <ozo/io/composite.h>
+#include <ozo/md_array.h>
+#include <ozo/nullable_vector.h>
+#include <ozo/string_array.h>
 #include <ozo/ext/std.h>
+#include <ozo/ext/boost/iterator_range.h>
 #include <ozo/pg/types.h>
 
+#include <boost/container/small_vector.hpp>
+#include <boost/range/adaptor/transformed.hpp>
+
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <memory_resource>
 #include <string_view>
 
 namespace {
@@ -55,6 +64,22 @@ TEST_F(send, with_std_string_view_should_store_it_as_is) {
     EXPECT_THAT(buffer, ElementsAre('v', 'i', 'e', 'w'));
 }
 
+TEST_F(send, with_pmr_vector_of_pmr_string_should_store_text_array) {
+    std::pmr::monotonic_buffer_resource resource;
+    std::pmr::vector<std::pmr::string> in(&resource);
+    in.emplace_back("foo");
+    ozo::send(os, oid_map, in);
+    EXPECT_EQ(buffer, std::vector<char>({
+        0, 0, 0, 1,
+        0, 0, 0, 0,
+        0, 0, 0, 0x19,
+        0, 0, 0, 1,
+        0, 0, 0, 0,
+        0, 0, 0, 3,
+        'f', 'o', 'o',
+    }));
+}
+
 TEST_F(send, with_std_vector_of_float_should_store_with_one_dimension_array_header_and_values) {
     ozo::send(os, oid_map, std::vector<float>({42.13f}));
     EXPECT_EQ(buffer, std::vector<char>({
@@ -85,6 +110,191 @@ TEST_F(send, with_std_array_of_int_should_store_with_one_dimension_array_header_
     }));
 }
 
+TEST_F(send, with_md_array_of_int_should_store_with_header_of_each_dimension_and_values) {
+    ozo::md_array<int> in({2, 1});
+    in(0, 0) = 1;
+    in(1, 0) = 2;
+    ozo::send(os, oid_map, in);
+    EXPECT_EQ(buffer, std::vector<char>({
+        0, 0, 0, 2,
+        0, 0, 0, 0,
+        0, 0, 0, 0x17,
+        0, 0, 0, 2,
+        0, 0, 0, 0,
+        0, 0, 0, 1,
+        0, 0, 0, 0,
+        0, 0, 0, 4,
+        0, 0, 0, 0x1,
+        0, 0, 0, 4,
+        0, 0, 0, 0x2,
+    }));
+    EXPECT_EQ(ozo::size_of(in), std::int32_t(buffer.size()));
+}
+
+TEST_F(send, with_nullable_vector_of_int_should_store_null_frames_for_null_values) {
+    ozo::nullable_vector<int> in;
+    in.push_back(1);
+    in.push_back(std::optional<int>{});
+    in.push_back(std::optional<int>{3});
+    ozo::send(os, oid_map, in);
+    EXPECT_EQ(buffer, std::vector<char>({
+        0, 0, 0, 1,
+        0, 0, 0, 0,
+        0, 0, 0, 0x17,
+        0, 0, 0, 3,
+        0, 0, 0, 0,
+        0, 0, 0, 4,
+        0, 0, 0, 0x1,
+        '\xFF', '\xFF', '\xFF', '\xFF',
+        0, 0, 0, 4,
+        0, 0, 0, 0x3,
+    }));
+    EXPECT_EQ(ozo::size_of(in), std::int32_t(buffer.size()));
+}
+
+TEST_F(send, with_string_array_should_store_text_array_with_null_frames) {
+    ozo::string_array<> in;
+    in.push_back("ab");
+    in.push_null();
+    in.push_back("c");
+    ozo::send(os, oid_map, in);
+    EXPECT_EQ(buffer, std::vector<char>({
+        0, 0, 0, 1,
+        0, 0, 0, 0,
+        0, 0, 0, 0x19,
+        0, 0, 0, 3,
+        0, 0, 0, 0,
+        0, 0, 0, 2,
+        'a', 'b',
+        '\xFF', '\xFF', '\xFF', '\xFF',
+        0, 0, 0, 1,
+        'c',
+    }));
+    EXPECT_EQ(ozo::size_of(in), std::int32_t(buffer.size()));
+}
+
+TEST_F(send, with_iterator_range_of_pointers_should_store_with_one_dimension_array_header_and_values) {
+    const std::int32_t column[] = {1, 2, 3};
+    ozo::send(os, oid_map, boost::make_iterator_range(column, column + 2));
+    EXPECT_EQ(buffer, std::vector<char>({
+        0, 0, 0, 1,
+        0, 0, 0, 0,
+        0, 0, 0, 0x17,
+        0, 0, 0, 2,
+        0, 0, 0, 0,
+        0, 0, 0, 4,
+        0, 0, 0, 0x1,
+        0, 0, 0, 4,
+        0, 0, 0, 0x2,
+    }));
+}
+
+TEST_F(send, with_transformed_range_should_store_transformed_values) {
+    const std::list<std::int32_t> v {1, 2};
+    const auto range = ozo::as_array(v | boost::adaptors::transformed([] (auto x) { return std::int16_t(x * 3); }));
+    EXPECT_EQ(ozo::size_of(range), 32);
+    ozo::send(os, oid_map, range);
+    EXPECT_EQ(buffer, std::vector<char>({
+        0, 0, 0, 1,
+        0, 0, 0, 0,
+        0, 0, 0, 0x15,
+        0, 0, 0, 2,
+        0, 0, 0, 0,
+        0, 0, 0, 2,
+        0, 0x3,
+        0, 0, 0, 2,
+        0, 0x6,
+    }));
+}
+
+TEST_F(send, with_transformed_range_of_strings_should_store_values_with_their_sizes) {
+    const std::vector<std::string_view> v {"a", "bc"};
+    const auto range = ozo::as_array(v | boost::adaptors::transformed([] (auto x) { return std::string(x); }));
+    ozo::send(os, oid_map, range);
+    EXPECT_EQ(buffer, std::vector<char>({
+        0, 0, 0, 1,
+        0, 0, 0, 0,
+        0, 0, 0, 0x19,
+        0, 0, 0, 2,
+        0, 0, 0, 0,
+        0, 0, 0, 1,
+        'a',
+        0, 0, 0, 2,
+        'b', 'c',
+    }));
+}
+
+#ifdef __cpp_lib_span
+TEST_F(send, with_std_span_should_store_with_one_dimension_array_header_and_values) {
+    const std::vector<std::int32_t> v {1};
+    ozo::send(os, oid_map, std::span<const std::int32_t>(v));
+    EXPECT_EQ(buffer, std::vector<char>({
+        0, 0, 0, 1,
+        0, 0, 0, 0,
+        0, 0, 0, 0x17,
+        0, 0, 0, 1,
+        0, 0, 0, 0,
+        0, 0, 0, 4,
+        0, 0, 0, 0x1,
+    }));
+}
+#endif
+
+TEST_F(send, with_std_vector_of_int64_should_store_with_one_dimension_array_header_and_values) {
+    ozo::send(os, oid_map, std::vector<std::int64_t>({0x0102030405060708, -2}));
+    EXPECT_EQ(buffer, std::vector<char>({
+        0, 0, 0, 1,
+        0, 0, 0, 0,
+        0, 0, 0, 0x14,
+        0, 0, 0, 2,
+        0, 0, 0, 0,
+        0, 0, 0, 8,
+        0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+        0, 0, 0, 8,
+        char(0xFF), char(0xFF), char(0xFF), char(0xFF), char(0xFF), char(0xFF), char(0xFF), char(0xFE),
+    }));
+}
+
+TEST_F(send, with_std_vector_of_time_point_should_store_with_one_dimension_array_header_and_values) {
+    const std::vector<std::chrono::system_clock::time_point> v {
+        ozo::detail::epoch + std::chrono::seconds(1),
+        ozo::detail::epoch - std::chrono::microseconds(1),
+    };
+    ozo::send(os, oid_map, v);
+    EXPECT_EQ(buffer, std::vector<char>({
+        0x00, 0x00, 0x00, 0x01, // dimension count
+        0x00, 0x00, 0x00, 0x00, // data offset
+        0x00, 0x00, 0x04, 0x5A, // Oid
+        0x00, 0x00, 0x00, 0x02, // dimension size
+        0x00, 0x00, 0x00, 0x00, // dimension index
+        0x00, 0x00, 0x00, 0x08, // 1st element size
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x0F, 0x42, 0x40, // 1st element
+        0x00, 0x00, 0x00, 0x08, // 2nd element size
+        char(0xFF), char(0xFF), char(0xFF), char(0xFF), char(0xFF), char(0xFF), char(0xFF), char(0xFF), // 2nd element
+    }));
+}
+
+TEST(send_array, with_fixed_size_ostream_should_store_values) {
+    std::array<char, 32> buffer {};
+    ozo::ostream os{buffer.data(), buffer.size()};
+    ozo::send(os, ozo::empty_oid_map{}, std::vector<std::int16_t>({1, 2}));
+    EXPECT_EQ(buffer, (std::array<char, 32>({
+        0, 0, 0, 1,
+        0, 0, 0, 0,
+        0, 0, 0, 0x15,
+        0, 0, 0, 2,
+        0, 0, 0, 0,
+        0, 0, 0, 2, 0, 1,
+        0, 0, 0, 2, 0, 2,
+    })));
+}
+
+TEST(send_array, with_fixed_size_ostream_should_throw_on_overflow) {
+    std::array<char, 24> buffer {};
+    ozo::ostream os{buffer.data(), buffer.size()};
+    EXPECT_THROW(ozo::send(os, ozo::empty_oid_map{}, std::vector<std::int16_t>({1, 2})), std::length_error);
+}
+
 TEST_F(send, should_send_nothing_for_std_nullptr_t) {
     ozo::send(os, oid_map, nullptr);
     EXPECT_TRUE(buffer.empty());
@@ -113,6 +323,96 @@ TEST(send_impl, should_send_nothing_for_std_nullopt_t) {
     EXPECT_TRUE(buffer.empty());
 }
 
+TEST(ostream, over_fixed_size_region_should_store_data_into_the_region) {
+    std::array<char, 4> buffer {};
+    ozo::ostream os{buffer.data(), buffer.size()};
+    ozo::empty_oid_map oid_map;
+
+    ozo::send(os, oid_map, std::int32_t(0x01020304));
+    EXPECT_THAT(buffer, ElementsAre(0x01, 0x02, 0x03, 0x04));
+}
+
+TEST(ostream, over_fixed_size_region_should_throw_on_overflow) {
+    std::array<char, 2> buffer {};
+    ozo::ostream os{buffer.data(), buffer.size()};
+    ozo::empty_oid_map oid_map;
+
+    EXPECT_THROW(ozo::send(os, oid_map, std::int32_t(0)), std::length_error);
+}
+
+TEST(ostream, tellp_should_return_number_of_bytes_written_via_stream) {
+    std::vector<char> buffer {'x'};
+    ozo::ostream os{buffer};
+    ozo::write(os, std::int32_t(1));
+    ozo::write(os, char(2));
+    EXPECT_EQ(os.tellp(), 5u);
+}
+
+TEST(ostream, patch_should_overwrite_written_integral_in_big_endian_order) {
+    std::vector<char> buffer {'x'};
+    ozo::ostream os{buffer};
+    ozo::write(os, std::int32_t(0));
+    ozo::write(os, char(2));
+    os.patch(0, std::int32_t(0x01020304));
+    EXPECT_THAT(buffer, ElementsAre('x', 0x01, 0x02, 0x03, 0x04, 2));
+}
+
+TEST(ostream, patch_should_overwrite_written_integral_in_fixed_size_region) {
+    std::array<char, 6> buffer {};
+    ozo::ostream os{buffer.data(), buffer.size()};
+    ozo::write(os, char(1));
+    ozo::write(os, std::int32_t(0));
+    os.patch(1, std::int32_t(0x01020304));
+    EXPECT_THAT(buffer, ElementsAre(1, 0x01, 0x02, 0x03, 0x04, 0));
+}
+
+TEST(ostream, patch_should_throw_for_position_out_of_written_data) {
+    std::vector<char> buffer;
+    ozo::ostream os{buffer};
+    ozo::write(os, std::int16_t(0));
+    EXPECT_THROW(os.patch(0, std::int32_t(0)), std::out_of_range);
+}
+
+TEST(ostream, over_vector_with_custom_allocator_should_append_data_to_it) {
+    using allocator = std::pmr::polymorphic_allocator<char>;
+    std::pmr::vector<char> buffer {allocator{}};
+    ozo::ostream os{buffer};
+    ozo::write(os, std::int16_t(0x0102));
+    EXPECT_THAT(buffer, ElementsAre(0x01, 0x02));
+}
+
+TEST(ostream, over_small_vector_should_append_data_to_it) {
+    boost::container::small_vector<char, 8> buffer {'x'};
+    ozo::ostream os{buffer};
+    ozo::write(os, std::int16_t(0x0102));
+    EXPECT_THAT(buffer, ElementsAre('x', 0x01, 0x02));
+}
+
+TEST(ostream, unchecked_over_fixed_size_region_should_store_data_of_size_of_into_the_region) {
+    const std::tuple<std::string, std::int32_t> v {"abc", 0x01020304};
+    std::vector<char> buffer(static_cast<std::size_t>(ozo::size_of(v)));
+    ozo::ostream os{buffer.data(), buffer.size(), ozo::unchecked};
+    ozo::send(os, ozo::empty_oid_map{}, v);
+    EXPECT_EQ(os.tellp(), buffer.size());
+
+    std::vector<char> expected;
+    ozo::ostream checked{expected};
+    ozo::send(checked, ozo::empty_oid_map{}, v);
+    EXPECT_EQ(buffer, expected);
+}
+
+TEST(send_data_frame, should_back_patch_size_of_array_of_composites) {
+    std::vector<char> buffer;
+    ozo::ostream os{buffer};
+    const std::vector<std::tuple<std::string, std::int32_t>> v {{"a", 1}, {"bc", 2}};
+    ozo::send_data_frame(os, ozo::empty_oid_map{}, v);
+    EXPECT_EQ(buffer.size(), sizeof(ozo::size_type) + static_cast<std::size_t>(ozo::size_of(v)));
+    ozo::istream is{buffer.data(), buffer.size()};
+    ozo::size_type size = 0;
+    ozo::read(is, size);
+    EXPECT_EQ(size, ozo::size_of(v));
+}
+
 struct send_frame : Test {
     using buffer_t = std::vector<char>;
     buffer_t buffer;
@@ -152,6 +452,26 @@ TEST_F(send_frame, should_write_pg_name_as_string) {
     EXPECT_THAT(data_buffer(), ElementsAre('n', 'a', 'm', 'e'));
 }
 
+TEST_F(send, with_pg_numeric_should_store_base_10000_digits_aligned_to_scale) {
+    ozo::send(os, oid_map, ozo::pg::numeric64{12345, 2});
+    EXPECT_THAT(buffer, ElementsAre(0, 2, 0, 0, 0, 0, 0, 2, 0, 123, 0x11, 0x94));
+}
+
+TEST_F(send, with_negative_pg_numeric_should_store_negative_weight_and_sign) {
+    ozo::send(os, oid_map, ozo::pg::numeric64{-5, 2});
+    EXPECT_THAT(buffer, ElementsAre(0, 1, 0xFF, 0xFF, 0x40, 0, 0, 2, 0x01, 0xF4));
+}
+
+TEST_F(send, with_pg_numeric_should_strip_trailing_zero_digits) {
+    ozo::send(os, oid_map, ozo::pg::numeric64{10000, 0});
+    EXPECT_THAT(buffer, ElementsAre(0, 1, 0, 1, 0, 0, 0, 0, 0, 1));
+}
+
+TEST_F(send, with_zero_pg_numeric_should_store_no_digits) {
+    ozo::send(os, oid_map, ozo::pg::numeric64{0, 3});
+    EXPECT_THAT(buffer, ElementsAre(0, 0, 0, 0, 0, 0, 0, 3));
+}
+
 TEST_F(send, with_boost_uuid_should_store_it_as_is) {
     const boost::uuids::uuid uuid = {
         0x12, 0x34, 0x56, 0x78,
@@ -0,0 +1,111 @@
+#include <ozo/cancel_executor.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <future>
+
+namespace {
+
+using namespace testing;
+
+struct cancel_handle {
+    using executor_type = ozo::cancel_executor::executor_type;
+
+    executor_type executor_;
+    int backend_pid_ = 0;
+    std::atomic<int>* sent_ = nullptr;
+
+    executor_type get_executor() const { return executor_;}
+
+    int backend_pid() const { return backend_pid_;}
+
+    friend auto dispatch_cancel(cancel_handle self) {
+        ++*self.sent_;
+        return std::make_tuple(ozo::error_code{}, std::string{});
+    }
+};
+
+struct cancel_result {
+    std::promise<ozo::error_code> promise;
+
+    auto handler() {
+        return [this] (ozo::error_code ec, std::string) { promise.set_value(ec);};
+    }
+
+    ozo::error_code get() { return promise.get_future().get();}
+};
+
+struct cancel_executor : Test {
+    std::atomic<int> sent {0};
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+
+    void block(ozo::cancel_executor& executor) {
+        std::promise<void> started;
+        boost::asio::post(executor.get_executor(), [&started, released = released] {
+            started.set_value();
+            released.wait();
+        });
+        started.get_future().wait();
+    }
+
+    cancel_handle make_handle(ozo::cancel_executor& executor, int backend_pid) {
+        return cancel_handle{executor.get_executor(), backend_pid, std::addressof(sent)};
+    }
+};
+
+TEST_F(cancel_executor, should_send_one_cancel_for_queued_requests_of_the_same_backend) {
+    ozo::cancel_executor executor(1, 8);
+    block(executor);
+
+    cancel_result first, second, third;
+    ozo::impl::initiate_async_cancel{}(first.handler(), make_handle(executor, 42));
+    ozo::impl::initiate_async_cancel{}(second.handler(), make_handle(executor, 42));
+    ozo::impl::initiate_async_cancel{}(third.handler(), make_handle(executor, 13));
+
+    const auto metrics = executor.metrics();
+    EXPECT_EQ(metrics.queued, 2u);
+    EXPECT_EQ(metrics.coalesced, 1u);
+    EXPECT_EQ(metrics.rejected, 0u);
+
+    release.set_value();
+    EXPECT_FALSE(first.get());
+    EXPECT_FALSE(second.get());
+    EXPECT_FALSE(third.get());
+    EXPECT_EQ(sent.load(), 2);
+    EXPECT_EQ(executor.metrics().queued, 0u);
+}
+
+TEST_F(cancel_executor, should_complete_cancel_with_cancel_queue_full_if_queue_limit_is_reached) {
+    ozo::cancel_executor executor(1, 1);
+    block(executor);
+
+    cancel_result queued, rejected;
+    ozo::impl::initiate_async_cancel{}(queued.handler(), make_handle(executor, 1));
+    ozo::impl::initiate_async_cancel{}(rejected.handler(), make_handle(executor, 2));
+
+    EXPECT_EQ(rejected.get(), ozo::error_code{ozo::error::cancel_queue_full});
+    EXPECT_EQ(executor.metrics().rejected, 1u);
+
+    release.set_value();
+    EXPECT_FALSE(queued.get());
+    EXPECT_EQ(sent.load(), 1);
+}
+
+TEST_F(cancel_executor, should_not_coalesce_requests_with_unknown_backend) {
+    ozo::cancel_executor executor(1, 8);
+    block(executor);
+
+    cancel_result first, second;
+    ozo::impl::initiate_async_cancel{}(first.handler(), make_handle(executor, 0));
+    ozo::impl::initiate_async_cancel{}(second.handler(), make_handle(executor, 0));
+    EXPECT_EQ(executor.metrics().queued, 2u);
+
+    release.set_value();
+    EXPECT_FALSE(first.get());
+    EXPECT_FALSE(second.get());
+    EXPECT_EQ(sent.load(), 2);
+}
+
+} // namespace
@@ -0,0 +1,183 @@
+#include <ozo/circuit_breaker.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <functional>
+
+namespace {
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+struct connection_mock {};
+
+using connection_ptr = std::shared_ptr<connection_mock>;
+using handler_type = std::function<void(ozo::error_code, connection_ptr)>;
+
+struct connection_source {
+    using connection_type = connection_ptr;
+
+    template <typename TimeConstraint, typename Handler>
+    void operator() (ozo::io_context&, TimeConstraint, Handler&& h) const {
+        handlers_->push_back(std::forward<Handler>(h));
+    }
+
+    std::vector<handler_type>* handlers_ = nullptr;
+};
+
+} // namespace
+
+namespace ozo {
+
+template <>
+struct is_connection<connection_mock> : std::true_type {};
+
+} // namespace ozo
+
+namespace {
+
+using ozo::detail::circuit_breaker;
+using ozo::circuit_breaker_state;
+
+ozo::circuit_breaker_config make_config(std::size_t threshold, ozo::time_traits::duration cooldown, std::size_t probes = 1) {
+    ozo::circuit_breaker_config config;
+    config.failure_threshold = threshold;
+    config.cooldown = cooldown;
+    config.probes = probes;
+    return config;
+}
+
+const ozo::time_traits::time_point now {};
+const ozo::error_code connection_refused {boost::asio::error::connection_refused};
+
+TEST(circuit_breaker, should_open_after_threshold_of_consecutive_failures) {
+    circuit_breaker circuit(make_config(2, 1s));
+    ASSERT_EQ(circuit.try_acquire(now), false);
+    circuit.release(false, connection_refused, now);
+    EXPECT_EQ(circuit.metrics().state, circuit_breaker_state::closed);
+    ASSERT_EQ(circuit.try_acquire(now), false);
+    circuit.release(false, connection_refused, now);
+    EXPECT_EQ(circuit.metrics().state, circuit_breaker_state::open);
+    EXPECT_EQ(circuit.metrics().failures, 2u);
+}
+
+TEST(circuit_breaker, should_reset_failures_on_success) {
+    circuit_breaker circuit(make_config(2, 1s));
+    circuit.try_acquire(now);
+    circuit.release(false, connection_refused, now);
+    circuit.try_acquire(now);
+    circuit.release(false, ozo::error_code{}, now);
+    circuit.try_acquire(now);
+    circuit.release(false, connection_refused, now);
+    EXPECT_EQ(circuit.metrics().state, circuit_breaker_state::closed);
+    EXPECT_EQ(circuit.metrics().failures, 1u);
+}
+
+TEST(circuit_breaker, should_not_count_errors_which_are_not_connection_errors) {
+    circuit_breaker circuit(make_config(1, 1s));
+    circuit.try_acquire(now);
+    circuit.release(false, ozo::error::bad_object_size, now);
+    circuit.try_acquire(now);
+    circuit.release(false, boost::asio::error::operation_aborted, now);
+    EXPECT_EQ(circuit.metrics().state, circuit_breaker_state::closed);
+    EXPECT_EQ(circuit.metrics().failures, 0u);
+}
+
+TEST(circuit_breaker, should_reject_requests_while_open) {
+    circuit_breaker circuit(make_config(1, 1s));
+    circuit.try_acquire(now);
+    circuit.release(false, connection_refused, now);
+    EXPECT_EQ(circuit.try_acquire(now + 500ms), std::nullopt);
+    EXPECT_EQ(circuit.metrics().rejected, 1u);
+}
+
+TEST(circuit_breaker, should_admit_limited_number_of_probes_after_cooldown) {
+    circuit_breaker circuit(make_config(1, 1s, 2));
+    circuit.try_acquire(now);
+    circuit.release(false, connection_refused, now);
+    EXPECT_EQ(circuit.try_acquire(now + 1s), true);
+    EXPECT_EQ(circuit.metrics().state, circuit_breaker_state::half_open);
+    EXPECT_EQ(circuit.try_acquire(now + 1s), true);
+    EXPECT_EQ(circuit.try_acquire(now + 1s), std::nullopt);
+}
+
+TEST(circuit_breaker, should_close_on_successful_probe) {
+    circuit_breaker circuit(make_config(1, 1s));
+    circuit.try_acquire(now);
+    circuit.release(false, connection_refused, now);
+    ASSERT_EQ(circuit.try_acquire(now + 1s), true);
+    circuit.release(true, ozo::error_code{}, now + 1s);
+    EXPECT_EQ(circuit.metrics().state, circuit_breaker_state::closed);
+    EXPECT_EQ(circuit.try_acquire(now + 1s), false);
+}
+
+TEST(circuit_breaker, should_open_again_on_failed_probe) {
+    circuit_breaker circuit(make_config(1, 1s));
+    circuit.try_acquire(now);
+    circuit.release(false, connection_refused, now);
+    ASSERT_EQ(circuit.try_acquire(now + 1s), true);
+    circuit.release(true, connection_refused, now + 1s);
+    EXPECT_EQ(circuit.metrics().state, circuit_breaker_state::open);
+    EXPECT_EQ(circuit.try_acquire(now + 1500ms), std::nullopt);
+    EXPECT_EQ(circuit.try_acquire(now + 2s), true);
+}
+
+TEST(circuit_breaker, should_free_probe_on_error_which_is_not_connection_error) {
+    circuit_breaker circuit(make_config(1, 1s));
+    circuit.try_acquire(now);
+    circuit.release(false, connection_refused, now);
+    ASSERT_EQ(circuit.try_acquire(now + 1s), true);
+    circuit.release(true, boost::asio::error::operation_aborted, now + 1s);
+    EXPECT_EQ(circuit.metrics().state, circuit_breaker_state::half_open);
+    EXPECT_EQ(circuit.try_acquire(now + 1s), true);
+}
+
+TEST(circuit_breaker_open, should_match_connection_error_condition) {
+    EXPECT_EQ(ozo::error_code{ozo::error::circuit_breaker_open}, ozo::errc::connection_error);
+}
+
+struct circuit_breaker_connection_source : Test {
+    ozo::io_context io;
+    std::vector<handler_type> handlers;
+    std::vector<std::pair<ozo::error_code, connection_ptr>> results;
+
+    auto handler() {
+        return [this] (ozo::error_code ec, connection_ptr conn) { results.emplace_back(ec, std::move(conn)); };
+    }
+};
+
+TEST_F(circuit_breaker_connection_source, should_pass_request_to_underlying_source_and_track_result) {
+    auto source = ozo::make_circuit_breaker_connection_source(connection_source{&handlers}, make_config(1, 1h));
+    source(io, ozo::none, handler());
+    ASSERT_EQ(handlers.size(), 1u);
+    handlers[0](connection_refused, nullptr);
+
+    ASSERT_EQ(results.size(), 1u);
+    EXPECT_EQ(results[0].first, connection_refused);
+    EXPECT_EQ(source.metrics().state, circuit_breaker_state::open);
+}
+
+TEST_F(circuit_breaker_connection_source, should_complete_request_with_circuit_breaker_open_if_circuit_is_open) {
+    auto source = ozo::make_circuit_breaker_connection_source(connection_source{&handlers}, make_config(1, 1h));
+    source(io, ozo::none, handler());
+    handlers.at(0)(connection_refused, nullptr);
+    source(io, ozo::none, handler());
+    io.run();
+
+    EXPECT_EQ(handlers.size(), 1u);
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_EQ(results[1].first, ozo::error_code{ozo::error::circuit_breaker_open});
+    EXPECT_EQ(results[1].second, nullptr);
+    EXPECT_EQ(source.metrics().rejected, 1u);
+}
+
+TEST_F(circuit_breaker_connection_source, should_share_circuit_between_copies) {
+    auto source = ozo::make_circuit_breaker_connection_source(connection_source{&handlers}, make_config(1, 1h));
+    const auto copy = source;
+    source(io, ozo::none, handler());
+    handlers.at(0)(connection_refused, nullptr);
+    EXPECT_EQ(copy.metrics().state, circuit_breaker_state::open);
+}
+
+} // namespace
@@ -1,7 +1,10 @@
 #include "result_mock.h"
 #include <ozo/ext/std/tuple.h>
+#include <ozo/ext/std/vector.h>
 #include <ozo/ext/std/pair.h>
+#include <ozo/ext/std/optional.h>
 #include <ozo/ext/boost/tuple.h>
+#include <ozo/io/array.h>
 #include <ozo/io/composite.h>
 #include <ozo/pg/types/integer.h>
 #include <ozo/pg/types/text.h>
@@ -162,6 +165,62 @@ TEST_F(send_composite, should_store_boost_tuple_with_number_of_fields_and_fields
     }));
 }
 
+TEST_F(send_composite, should_store_nested_composite_frame_with_back_patched_size) {
+    const auto v = std::make_tuple(std::make_tuple(std::int16_t(7)));
+    ozo::send(os, oid_map, v);
+    EXPECT_EQ(buffer, std::vector<char>({
+        0x00, 0x00, 0x00, 0x01, // Number of members
+                                // ---- nested tuple frame ---
+        0x00, 0x00, 0x08, char(0xC9), //   Oid:  RECORDOID
+        0x00, 0x00, 0x00, 0x0E, //   size: 14
+        0x00, 0x00, 0x00, 0x01, //     Number of members
+        0x00, 0x00, 0x00, 0x15, //     Oid:  INT2OID
+        0x00, 0x00, 0x00, 0x02, //     size: 2
+        0x00, 0x07,             //     data: 7
+    }));
+    EXPECT_EQ(buffer.size(), static_cast<std::size_t>(ozo::size_of(v)));
+}
+
+TEST_F(send_composite, should_store_null_nested_composite_frame_with_null_size) {
+    const auto v = std::make_tuple(std::optional<std::tuple<std::int16_t>>{});
+    ozo::send(os, oid_map, v);
+    EXPECT_EQ(buffer, std::vector<char>({
+        0x00, 0x00, 0x00, 0x01, // Number of members
+                                // ---- nested tuple frame ---
+        0x00, 0x00, 0x08, char(0xC9), //   Oid:  RECORDOID
+        char(0xFF), char(0xFF), char(0xFF), char(0xFF), //   size: -1
+    }));
+}
+
+TEST_F(send_composite, should_store_array_of_composites_with_the_same_frames_as_single_values) {
+    using composite = std::tuple<fusion_test_struct, std::int16_t>;
+    ozo::set_type_oid<fusion_test_struct>(oid_map, 0x01020304);
+    const std::vector<composite> v {{fusion_test_struct{"a", 1}, 2}, {fusion_test_struct{"bc", 3}, 4}};
+    ozo::send(os, oid_map, v);
+
+    std::vector<char> expected;
+    ozo::ostream checked{expected};
+    ozo::write(checked, ozo::detail::pg_array {1, 0, ozo::type_oid<composite>(oid_map)});
+    ozo::write(checked, ozo::detail::pg_array_dimension {2, 0});
+    for (const auto& item : v) {
+        ozo::send_data_frame(checked, oid_map, item);
+    }
+    EXPECT_EQ(buffer, expected);
+}
+
+TEST(make_composite_send_header, should_return_fields_count_and_fields_oids_in_network_byte_order) {
+    auto oid_map = ozo::register_types<fusion_test_struct>();
+    ozo::set_type_oid<fusion_test_struct>(oid_map, 0x01020304);
+    const auto header = ozo::detail::make_composite_send_header<std::tuple<fusion_test_struct, std::int16_t>>(oid_map);
+    std::vector<char> buffer(sizeof(header));
+    std::memcpy(buffer.data(), &header, sizeof(header));
+    EXPECT_EQ(buffer, std::vector<char>({
+        0x00, 0x00, 0x00, 0x02, // Number of members
+        0x01, 0x02, 0x03, 0x04, // Oid:  fusion_test_struct
+        0x00, 0x00, 0x00, 0x15, // Oid:  INT2OID
+    }));
+}
+
 struct recv_composite : Test {
     StrictMock<ozo::tests::pg_result_mock>  mock{};
     ozo::value<ozo::tests::pg_result_mock>  value{{&mock, 0, 0}};
@@ -322,4 +381,96 @@ TEST_F(recv_composite, should_throw_exception_if_wrong_number_of_fields_are_rece
     EXPECT_THROW(ozo::recv(value, oid_map, got), ozo::system_error);
 }
 
+TEST_F(recv_composite, should_receive_array_of_std_tuple) {
+    const char bytes[] = {
+        0x00, 0x00, 0x00, 0x01, // dimension count
+        0x00, 0x00, 0x00, 0x00, // data offset
+        0x00, 0x00, 0x08, char(0xC9), // Oid: RECORDOID
+        0x00, 0x00, 0x00, 0x02, // dimension size
+        0x00, 0x00, 0x00, 0x01, // dimension index
+        0x00, 0x00, 0x00, 0x1C, // 1st element size
+        0x00, 0x00, 0x00, 0x02, // Number of members
+        0x00, 0x00, 0x00, 0x19, //   Oid:  TEXTOID
+        0x00, 0x00, 0x00, 0x04, //   size: 4
+        'T' , 'E' , 'S' , 'T' , //   data: "TEST"
+        0x00, 0x00, 0x00, 0x14, //   Oid:  INT8OID
+        0x00, 0x00, 0x00, 0x08, //   size: 8
+        0x00, 0x00, 0x00, 0x00, //   data: 00 00 00 00
+        0x00, 0x00, 0x00, 0x01, //         00 00 00 01
+        0x00, 0x00, 0x00, 0x19, // 2nd element size
+        0x00, 0x00, 0x00, 0x02, // Number of members
+        0x00, 0x00, 0x00, 0x19, //   Oid:  TEXTOID
+        0x00, 0x00, 0x00, 0x01, //   size: 1
+        'X' ,                   //   data: "X"
+        0x00, 0x00, 0x00, 0x14, //   Oid:  INT8OID
+        0x00, 0x00, 0x00, 0x08, //   size: 8
+        0x00, 0x00, 0x00, 0x00, //   data: 00 00 00 00
+        0x00, 0x00, 0x00, 0x02, //         00 00 00 02
+    };
+
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(0x08EF));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof(bytes)));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    std::vector<std::tuple<std::string, std::int64_t>> got;
+    ozo::recv(value, oid_map, got);
+    EXPECT_THAT(got, ElementsAre(std::make_tuple("TEST"s, 1), std::make_tuple("X"s, 2)));
+}
+
+TEST_F(recv_composite, should_throw_exception_if_field_oid_of_array_element_does_not_match_first_element) {
+    const char bytes[] = {
+        0x00, 0x00, 0x00, 0x01, // dimension count
+        0x00, 0x00, 0x00, 0x00, // data offset
+        0x00, 0x00, 0x08, char(0xC9), // Oid: RECORDOID
+        0x00, 0x00, 0x00, 0x02, // dimension size
+        0x00, 0x00, 0x00, 0x01, // dimension index
+        0x00, 0x00, 0x00, 0x1C, // 1st element size
+        0x00, 0x00, 0x00, 0x02, // Number of members
+        0x00, 0x00, 0x00, 0x19, //   Oid:  TEXTOID
+        0x00, 0x00, 0x00, 0x04, //   size: 4
+        'T' , 'E' , 'S' , 'T' , //   data: "TEST"
+        0x00, 0x00, 0x00, 0x14, //   Oid:  INT8OID
+        0x00, 0x00, 0x00, 0x08, //   size: 8
+        0x00, 0x00, 0x00, 0x00, //   data: 00 00 00 00
+        0x00, 0x00, 0x00, 0x01, //         00 00 00 01
+        0x00, 0x00, 0x00, 0x1C, // 2nd element size
+        0x00, 0x00, 0x00, 0x02, // Number of members
+        0x00, 0x00, 0x00, 0x19, //   Oid:  TEXTOID
+        0x00, 0x00, 0x00, 0x04, //   size: 4
+        'T' , 'E' , 'S' , 'T' , //   data: "TEST"
+        0x00, 0x00, 0x00, 0x17, //   Oid:  INT4OID
+        0x00, 0x00, 0x00, 0x08, //   size: 8
+        0x00, 0x00, 0x00, 0x00, //   data: 00 00 00 00
+        0x00, 0x00, 0x00, 0x01, //         00 00 00 01
+    };
+
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(0x08EF));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof(bytes)));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    std::vector<std::tuple<std::string, std::int64_t>> got;
+    EXPECT_THROW(ozo::recv(value, oid_map, got), ozo::system_error);
+}
+
+TEST_F(recv_composite, should_throw_exception_for_null_array_element) {
+    const char bytes[] = {
+        0x00, 0x00, 0x00, 0x01, // dimension count
+        0x00, 0x00, 0x00, 0x01, // data offset
+        0x00, 0x00, 0x08, char(0xC9), // Oid: RECORDOID
+        0x00, 0x00, 0x00, 0x01, // dimension size
+        0x00, 0x00, 0x00, 0x01, // dimension index
+        char(0xFF), char(0xFF), char(0xFF), char(0xFF), // 1st element is null
+    };
+
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(0x08EF));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(bytes));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(sizeof(bytes)));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+
+    std::vector<std::tuple<std::string, std::int64_t>> got;
+    EXPECT_THROW(ozo::recv(value, oid_map, got), std::invalid_argument);
+}
+
 } // namespace
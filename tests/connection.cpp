@@ -11,6 +11,8 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <unistd.h>
+
 namespace {
 
 namespace asio = boost::asio;
@@ -91,6 +93,12 @@ struct connection {
     explicit connection(io_context& io) : socket_(io), io_(&io) {}
 };
 
+struct thread_unsafe_connection : connection<> {
+    using thread_safety_type = ozo::thread_safety<false>;
+
+    using connection<>::connection;
+};
+
 } // namespace
 
 namespace ozo {
@@ -98,6 +106,9 @@ namespace ozo {
 template <typename OidMap>
 struct is_connection<::connection<OidMap>> : std::true_type {};
 
+template <>
+struct is_connection<::thread_unsafe_connection> : std::true_type {};
+
 } // namespace ozo
 
 namespace {
@@ -174,6 +185,28 @@ TEST(unwrap_connection, should_return_argument_reference_for_connection) {
     );
 }
 
+TEST(get_connection_thread_safety, should_be_thread_safe_by_default) {
+    EXPECT_TRUE(ozo::get_connection_thread_safety<connection<>>::type::value);
+}
+
+TEST(get_connection_thread_safety, should_be_defined_by_thread_safety_type_member) {
+    EXPECT_FALSE(ozo::get_connection_thread_safety<thread_unsafe_connection>::type::value);
+}
+
+TEST(make_connection_executor, should_return_strand_for_thread_safe_connection) {
+    io_context io;
+    StrictMock<executor_mock> strand;
+    auto conn = std::make_shared<connection<>>(io);
+    EXPECT_CALL(io.strand_service_, get_executor()).WillOnce(ReturnRef(strand));
+    ozo::detail::make_connection_executor(conn);
+}
+
+TEST(make_connection_executor, should_return_connection_executor_for_thread_unsafe_connection) {
+    io_context io;
+    auto conn = std::make_shared<thread_unsafe_connection>(io);
+    EXPECT_EQ(ozo::detail::make_connection_executor(conn), io.get_executor());
+}
+
 TEST(get_error_context, should_returns_reference_to_error_context) {
     io_context io;
     auto conn = std::make_shared<connection<>>(io);
@@ -337,4 +370,56 @@ TEST(get_password, should_return_empty_string_view_for_null_handle){
     EXPECT_TRUE(ozo::get_password(conn).empty());
 }
 
+struct apply_socket_options : Test {
+    template <typename T>
+    static T get_option(int fd, int level, int name) {
+        T value{};
+        socklen_t size = sizeof(value);
+        EXPECT_EQ(getsockopt(fd, level, name, &value, &size), 0);
+        return value;
+    }
+};
+
+TEST_F(apply_socket_options, should_set_given_options_on_tcp_socket) {
+    const int fd = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_NE(fd, -1);
+    ozo::socket_options options;
+    options.no_delay = true;
+    options.receive_buffer_size = 256 * 1024;
+    options.keep_alive = true;
+
+    ozo::detail::apply_socket_options(fd, options);
+
+    EXPECT_EQ(get_option<int>(fd, IPPROTO_TCP, TCP_NODELAY), 1);
+    EXPECT_GE(get_option<int>(fd, SOL_SOCKET, SO_RCVBUF), 256 * 1024);
+    EXPECT_EQ(get_option<int>(fd, SOL_SOCKET, SO_KEEPALIVE), 1);
+    close(fd);
+}
+
+TEST_F(apply_socket_options, should_keep_options_which_are_not_set) {
+    const int fd = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_NE(fd, -1);
+    const auto rcvbuf = get_option<int>(fd, SOL_SOCKET, SO_RCVBUF);
+
+    ozo::detail::apply_socket_options(fd, ozo::socket_options{});
+
+    EXPECT_EQ(get_option<int>(fd, IPPROTO_TCP, TCP_NODELAY), 0);
+    EXPECT_EQ(get_option<int>(fd, SOL_SOCKET, SO_RCVBUF), rcvbuf);
+    close(fd);
+}
+
+TEST_F(apply_socket_options, should_skip_tcp_options_on_unix_socket) {
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    ozo::socket_options options;
+    options.no_delay = true;
+    options.send_buffer_size = 64 * 1024;
+
+    ozo::detail::apply_socket_options(fds[0], options);
+
+    EXPECT_GE(get_option<int>(fds[0], SOL_SOCKET, SO_SNDBUF), 64 * 1024);
+    close(fds[0]);
+    close(fds[1]);
+}
+
 } //namespace
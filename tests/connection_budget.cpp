@@ -0,0 +1,103 @@
+#include <ozo/connection_budget.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+
+TEST(connection_budget, should_be_empty_by_default) {
+    const ozo::connection_budget budget;
+    EXPECT_FALSE(budget);
+    EXPECT_EQ(budget.limit(), 0u);
+    EXPECT_EQ(budget.join(10), nullptr);
+}
+
+TEST(connection_budget, should_throw_on_zero_limit) {
+    EXPECT_THROW(ozo::connection_budget(0), std::invalid_argument);
+}
+
+TEST(connection_budget, join_should_throw_if_guarantees_exceed_limit) {
+    const ozo::connection_budget budget(10);
+    const auto a = budget.join(6);
+    EXPECT_THROW(budget.join(5), std::invalid_argument);
+    EXPECT_EQ(budget.guaranteed(), 6u);
+}
+
+TEST(connection_budget, should_return_guarantee_when_member_is_destroyed) {
+    const ozo::connection_budget budget(10);
+    budget.join(6);
+    EXPECT_EQ(budget.guaranteed(), 0u);
+    EXPECT_NO_THROW(budget.join(10));
+}
+
+TEST(connection_budget, try_acquire_should_take_guaranteed_connections_without_borrowing) {
+    const ozo::connection_budget budget(3);
+    const auto a = budget.join(2);
+    const auto x = a->try_acquire();
+    const auto y = a->try_acquire();
+    EXPECT_TRUE(x);
+    EXPECT_TRUE(y);
+    EXPECT_EQ(budget.used(), 2u);
+    EXPECT_EQ(budget.borrowed(), 0u);
+    EXPECT_EQ(a->used(), 2u);
+}
+
+TEST(connection_budget, try_acquire_should_borrow_budget_not_reserved_by_guarantees) {
+    const ozo::connection_budget budget(4);
+    const auto a = budget.join(1);
+    const auto b = budget.join(2);
+    const auto x = a->try_acquire();
+    const auto y = a->try_acquire();
+    EXPECT_TRUE(y);
+    EXPECT_EQ(budget.borrowed(), 1u);
+    EXPECT_FALSE(a->try_acquire());
+    EXPECT_EQ(budget.rejected(), 1u);
+}
+
+TEST(connection_budget, try_acquire_should_keep_guarantee_of_idle_member) {
+    const ozo::connection_budget budget(2);
+    const auto a = budget.join(0);
+    const auto b = budget.join(1);
+    const auto x = a->try_acquire();
+    EXPECT_TRUE(x);
+    EXPECT_FALSE(a->try_acquire());
+    const auto y = b->try_acquire();
+    EXPECT_TRUE(y);
+    EXPECT_EQ(budget.used(), 2u);
+}
+
+TEST(connection_budget, release_should_return_borrowed_connection_first) {
+    const ozo::connection_budget budget(3);
+    const auto a = budget.join(1);
+    auto x = a->try_acquire();
+    auto y = a->try_acquire();
+    EXPECT_EQ(budget.borrowed(), 1u);
+    x.reset();
+    EXPECT_EQ(budget.borrowed(), 0u);
+    EXPECT_EQ(budget.used(), 1u);
+    y.reset();
+    EXPECT_EQ(budget.used(), 0u);
+    EXPECT_EQ(a->used(), 0u);
+}
+
+TEST(connection_budget, should_bound_total_connections_when_guarantee_joins_while_borrowed) {
+    const ozo::connection_budget budget(2);
+    const auto a = budget.join(0);
+    const auto x = a->try_acquire();
+    const auto y = a->try_acquire();
+    const auto b = budget.join(1);
+    EXPECT_FALSE(b->try_acquire());
+    EXPECT_EQ(budget.used(), 2u);
+}
+
+TEST(connection_budget, should_be_shared_by_copies) {
+    const ozo::connection_budget budget(2);
+    const auto copy = budget;
+    const auto a = copy.join(1);
+    const auto x = a->try_acquire();
+    EXPECT_EQ(budget.used(), 1u);
+}
+
+} // namespace
@@ -18,8 +18,154 @@ TEST(connection_info, should_return_error_and_bad_connect_for_invalid_connection
     io.run();
 }
 
+TEST(connection_info, should_return_error_for_race_of_unreachable_hosts) {
+    ozo::io_context io;
+    ozo::connection_info conn_info("host=127.0.0.1,127.0.0.1 port=1,2 dbname=test");
+    conn_info.race_hosts(std::chrono::milliseconds(1));
+
+    bool called = false;
+    ozo::get_connection(conn_info[io], std::chrono::seconds(10), [&](ozo::error_code ec, auto conn){
+        called = true;
+        EXPECT_TRUE(ec);
+        EXPECT_NE(ec, boost::asio::error::timed_out);
+        EXPECT_TRUE(ozo::connection_bad(conn));
+    });
+
+    io.run();
+    EXPECT_TRUE(called);
+}
+
+TEST(connection_info, should_return_error_for_resolved_unreachable_host) {
+    ozo::io_context io;
+    ozo::connection_info conn_info("host=localhost port=1 dbname=test");
+    conn_info.resolve_hosts();
+
+    bool called = false;
+    ozo::get_connection(conn_info[io], std::chrono::seconds(10), [&](ozo::error_code ec, auto conn){
+        called = true;
+        EXPECT_TRUE(ec);
+        EXPECT_NE(ec, boost::asio::error::timed_out);
+        EXPECT_TRUE(ozo::connection_bad(conn));
+    });
+
+    io.run();
+    EXPECT_TRUE(called);
+}
+
+TEST(split_hosts, should_return_connection_string_for_each_host) {
+    EXPECT_THAT(ozo::impl::split_hosts("host=a,b port=5432,6432 dbname=test"), testing::ElementsAre(
+        "dbname='test' host='a' port='5432'",
+        "dbname='test' host='b' port='6432'"
+    ));
+}
+
+TEST(split_hosts, should_use_single_port_for_all_hosts) {
+    EXPECT_THAT(ozo::impl::split_hosts("host=a,b port=5432"), testing::ElementsAre(
+        "host='a' port='5432'",
+        "host='b' port='5432'"
+    ));
+}
+
+TEST(split_hosts, should_escape_parameter_values) {
+    EXPECT_THAT(ozo::impl::split_hosts(R"(host=a,b password='it\'s')"), testing::ElementsAre(
+        R"(password='it\'s' host='a')",
+        R"(password='it\'s' host='b')"
+    ));
+}
+
+TEST(split_hosts, should_return_empty_vector_for_single_host) {
+    EXPECT_TRUE(ozo::impl::split_hosts("host=a port=5432").empty());
+}
+
+TEST(split_hosts, should_return_empty_vector_for_mismatched_ports_count) {
+    EXPECT_TRUE(ozo::impl::split_hosts("host=a,b,c port=1,2").empty());
+}
+
+TEST(split_hosts, should_return_empty_vector_for_invalid_connection_string) {
+    EXPECT_TRUE(ozo::impl::split_hosts("invalid connection info").empty());
+}
+
+TEST(make_conninfo, should_return_connection_string_of_parameters_with_escaped_values) {
+    const auto params = ozo::impl::parse_connection_params(R"(host=a password='it\'s')");
+    ASSERT_TRUE(params);
+    EXPECT_EQ(ozo::impl::make_conninfo(*params), R"(password='it\'s' host='a')");
+}
+
+TEST(get_ssl_parameters, should_return_parameters_of_set_options) {
+    ozo::ssl_options options;
+    options.mode = ozo::ssl_mode::verify_full;
+    options.negotiation = ozo::ssl_negotiation::direct;
+    options.root_cert = "/etc/ssl/root.crt";
+    options.sni = false;
+    EXPECT_THAT(ozo::detail::get_ssl_parameters(options, 170000), testing::ElementsAre(
+        testing::Pair(testing::StrEq("sslmode"), "verify-full"),
+        testing::Pair(testing::StrEq("sslnegotiation"), "direct"),
+        testing::Pair(testing::StrEq("sslrootcert"), "/etc/ssl/root.crt"),
+        testing::Pair(testing::StrEq("sslsni"), "0")
+    ));
+}
+
+TEST(get_ssl_parameters, should_skip_negotiation_for_libpq_older_than_17) {
+    ozo::ssl_options options;
+    options.mode = ozo::ssl_mode::require;
+    options.negotiation = ozo::ssl_negotiation::direct;
+    EXPECT_THAT(ozo::detail::get_ssl_parameters(options, 160004), testing::ElementsAre(
+        testing::Pair(testing::StrEq("sslmode"), "require")
+    ));
+}
+
+TEST(check_ssl_options, should_throw_for_direct_negotiation_with_mode_weaker_than_require) {
+    ozo::ssl_options options;
+    options.negotiation = ozo::ssl_negotiation::direct;
+    EXPECT_THROW(ozo::detail::check_ssl_options(options), std::invalid_argument);
+    options.mode = ozo::ssl_mode::prefer;
+    EXPECT_THROW(ozo::detail::check_ssl_options(options), std::invalid_argument);
+    options.mode = ozo::ssl_mode::require;
+    EXPECT_NO_THROW(ozo::detail::check_ssl_options(options));
+}
+
+TEST(connection_info, ssl_options_should_throw_for_invalid_options) {
+    ozo::connection_info conn_info("host=localhost");
+    ozo::ssl_options options;
+    options.negotiation = ozo::ssl_negotiation::direct;
+    EXPECT_THROW(conn_info.ssl_options(options), std::invalid_argument);
+}
+
+TEST(connection_info, should_return_error_for_unreachable_host_with_ssl_options) {
+    ozo::io_context io;
+    ozo::connection_info conn_info("host=127.0.0.1 port=1 dbname=test");
+    ozo::ssl_options options;
+    options.mode = ozo::ssl_mode::require;
+    options.negotiation = ozo::ssl_negotiation::direct;
+    conn_info.ssl_options(options);
+
+    bool called = false;
+    ozo::get_connection(conn_info[io], std::chrono::seconds(10), [&](ozo::error_code ec, auto conn){
+        called = true;
+        EXPECT_TRUE(ec);
+        EXPECT_NE(ec, boost::asio::error::timed_out);
+        EXPECT_THAT(ozo::error_message(conn), testing::Not(testing::HasSubstr("invalid connection option")));
+    });
+
+    io.run();
+    EXPECT_TRUE(called);
+}
+
 TEST(make_connection_info, should_not_throw) {
     EXPECT_NO_THROW(ozo::make_connection_info("conn info string"));
 }
 
+TEST(connection_info, import_state_should_accept_exported_state) {
+    ozo::connection_info source("host=localhost dbname=test");
+    const auto state = source.export_state();
+
+    ozo::connection_info conn_info("host=localhost dbname=test");
+    EXPECT_NO_THROW(conn_info.import_state(state));
+}
+
+TEST(connection_info, import_state_should_throw_on_malformed_state) {
+    ozo::connection_info conn_info("host=localhost dbname=test");
+    EXPECT_THROW(conn_info.import_state("garbage"), std::invalid_argument);
+}
+
 } // namespace
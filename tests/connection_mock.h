@@ -11,6 +11,14 @@ namespace ozo::tests {
 struct pg_result {
     ExecStatusType status;
     const char* error;
+    const char* cmd_tuples = "";
+    const char* error_message = "";
+};
+
+struct pg_notify {
+    const char* relname;
+    int be_pid;
+    const char* extra;
 };
 
 struct PGconn_mock {
@@ -25,6 +33,16 @@ struct PGconn_mock {
         ON_CALL(*this, PQconsumeInput()).WillByDefault(::testing::Return(0));
         ON_CALL(*this, PQconnectPoll()).WillByDefault(::testing::Return(PGRES_POLLING_FAILED));
         ON_CALL(*this, PQsendQueryParams(_, _, _, _, _, _, _)).WillByDefault(::testing::Return(0));
+        ON_CALL(*this, PQenterPipelineMode()).WillByDefault(::testing::Return(0));
+        ON_CALL(*this, PQexitPipelineMode()).WillByDefault(::testing::Return(0));
+        ON_CALL(*this, PQpipelineSync()).WillByDefault(::testing::Return(0));
+        ON_CALL(*this, PQsetSingleRowMode()).WillByDefault(::testing::Return(0));
+        ON_CALL(*this, PQsendPrepare(_, _, _, _)).WillByDefault(::testing::Return(0));
+        ON_CALL(*this, PQsendQueryPrepared(_, _, _, _, _, _)).WillByDefault(::testing::Return(0));
+        ON_CALL(*this, PQsendDescribePrepared(_)).WillByDefault(::testing::Return(0));
+        ON_CALL(*this, PQputCopyData(_, _)).WillByDefault(::testing::Return(-1));
+        ON_CALL(*this, PQputCopyEnd(_)).WillByDefault(::testing::Return(-1));
+        ON_CALL(*this, PQgetCopyData(_, _)).WillByDefault(::testing::Return(-2));
     };
 
     MOCK_METHOD0(PQsocket, int());
@@ -42,6 +60,11 @@ struct PGconn_mock {
         return mock(self).PQtransactionStatus();
     }
 
+    MOCK_METHOD1(PQparameterStatus, const char*(const char*));
+    friend const char* PQparameterStatus(PGconn_mock* self, const char* name) {
+        return mock(self).PQparameterStatus(name);
+    }
+
     MOCK_METHOD0(PQflush, int());
     friend int PQflush(PGconn_mock* self) {
         return mock(self).PQflush();
@@ -85,11 +108,103 @@ struct PGconn_mock {
         );
     }
 
+    MOCK_METHOD0(PQgetCancel, PGcancel*());
+    friend PGcancel* PQgetCancel(PGconn_mock* self) {
+        return mock(self).PQgetCancel();
+    }
+
+    MOCK_METHOD0(PQbackendPID, int());
+    friend int PQbackendPID(PGconn_mock* self) {
+        return mock(self).PQbackendPID();
+    }
+
+    MOCK_METHOD1(PQsendQuery, int(const char*));
+    friend int PQsendQuery(PGconn_mock* self, const char *command) {
+        return mock(self).PQsendQuery(command);
+    }
+
+    MOCK_METHOD4(PQsendPrepare, int(const char*, const char*, int, const Oid*));
+    friend int PQsendPrepare(PGconn_mock* self,
+                      const char *stmtName,
+                      const char *query,
+                      int nParams,
+                      const Oid *paramTypes) {
+        return mock(self).PQsendPrepare(stmtName, query, nParams, paramTypes);
+    }
+
+    MOCK_METHOD1(PQsendDescribePrepared, int(const char*));
+    friend int PQsendDescribePrepared(PGconn_mock* self, const char *stmtName) {
+        return mock(self).PQsendDescribePrepared(stmtName);
+    }
+
+#ifdef LIBPQ_HAS_CLOSE_PREPARED
+    MOCK_METHOD1(PQsendClosePrepared, int(const char*));
+    friend int PQsendClosePrepared(PGconn_mock* self, const char *stmtName) {
+        return mock(self).PQsendClosePrepared(stmtName);
+    }
+#endif
+
+    MOCK_METHOD6(PQsendQueryPrepared, int(
+                      const char*, int, const char* const*,
+                      const int*, const int*, int));
+    friend int PQsendQueryPrepared(PGconn_mock* self,
+                      const char *stmtName,
+                      int nParams,
+                      const char * const *paramValues,
+                      const int *paramLengths,
+                      const int *paramFormats,
+                      int resultFormat) {
+        return mock(self).PQsendQueryPrepared(
+            stmtName, nParams, paramValues,
+            paramLengths, paramFormats, resultFormat
+        );
+    }
+
     MOCK_METHOD0(PQgetResult, pg_result*());
     friend pg_result* PQgetResult(PGconn_mock* self) {
         return mock(self).PQgetResult();
     }
 
+    MOCK_METHOD0(PQnotifies, pg_notify*());
+    friend pg_notify* PQnotifies(PGconn_mock* self) {
+        return mock(self).PQnotifies();
+    }
+
+    MOCK_METHOD0(PQsetSingleRowMode, int());
+    friend int PQsetSingleRowMode(PGconn_mock* self) {
+        return mock(self).PQsetSingleRowMode();
+    }
+
+    MOCK_METHOD2(PQputCopyData, int(const char*, int));
+    friend int PQputCopyData(PGconn_mock* self, const char* buffer, int nbytes) {
+        return mock(self).PQputCopyData(buffer, nbytes);
+    }
+
+    MOCK_METHOD1(PQputCopyEnd, int(const char*));
+    friend int PQputCopyEnd(PGconn_mock* self, const char* errormsg) {
+        return mock(self).PQputCopyEnd(errormsg);
+    }
+
+    MOCK_METHOD2(PQgetCopyData, int(char**, int));
+    friend int PQgetCopyData(PGconn_mock* self, char** buffer, int async) {
+        return mock(self).PQgetCopyData(buffer, async);
+    }
+
+    MOCK_METHOD0(PQenterPipelineMode, int());
+    friend int PQenterPipelineMode(PGconn_mock* self) {
+        return mock(self).PQenterPipelineMode();
+    }
+
+    MOCK_METHOD0(PQexitPipelineMode, int());
+    friend int PQexitPipelineMode(PGconn_mock* self) {
+        return mock(self).PQexitPipelineMode();
+    }
+
+    MOCK_METHOD0(PQpipelineSync, int());
+    friend int PQpipelineSync(PGconn_mock* self) {
+        return mock(self).PQpipelineSync();
+    }
+
 private:
     static PGconn_mock& mock(PGconn_mock* self) { return self ? *self : null_mock();}
     static PGconn_mock& null_mock() {
@@ -107,6 +222,15 @@ private:
         ON_CALL(mock, PQconsumeInput()).WillByDefault(::testing::Return(0));
         ON_CALL(mock, PQconnectPoll()).WillByDefault(::testing::Return(PGRES_POLLING_FAILED));
         ON_CALL(mock, PQsendQueryParams(_, _, _, _, _, _, _)).WillByDefault(::testing::Return(0));
+        ON_CALL(mock, PQenterPipelineMode()).WillByDefault(::testing::Return(0));
+        ON_CALL(mock, PQexitPipelineMode()).WillByDefault(::testing::Return(0));
+        ON_CALL(mock, PQpipelineSync()).WillByDefault(::testing::Return(0));
+        ON_CALL(mock, PQsetSingleRowMode()).WillByDefault(::testing::Return(0));
+        ON_CALL(mock, PQsendPrepare(_, _, _, _)).WillByDefault(::testing::Return(0));
+        ON_CALL(mock, PQsendQueryPrepared(_, _, _, _, _, _)).WillByDefault(::testing::Return(0));
+        ON_CALL(mock, PQputCopyData(_, _)).WillByDefault(::testing::Return(-1));
+        ON_CALL(mock, PQputCopyEnd(_)).WillByDefault(::testing::Return(-1));
+        ON_CALL(mock, PQgetCopyData(_, _)).WillByDefault(::testing::Return(-2));
         return mock;
     }
 };
@@ -121,6 +245,7 @@ struct native_conn_handle {
     auto& operator * () const { assert_not_null(); return *mock_; }
     pointer operator -> () const { assert_not_null(); return mock_; }
     pointer get () const { assert_not_null(); return mock_; }
+    void reset () { mock_ = nullptr; }
     operator bool () const { return mock_ != nullptr; }
 
     void assert_not_null() const {
@@ -130,6 +255,15 @@ struct native_conn_handle {
     }
 };
 
+// The handle of a pooled connection, it is reset on close and may be queried
+// in the null state as `ozo::pg::conn` is.
+struct nullable_conn_handle : native_conn_handle {
+    using native_conn_handle::native_conn_handle;
+    nullable_conn_handle(native_conn_handle handle) : native_conn_handle(handle) {}
+
+    pointer get () const { return mock_; }
+};
+
 inline decltype(auto) PQresultStatus(const pg_result* res) noexcept {
     return res->status;
 }
@@ -138,6 +272,31 @@ inline const char* PQresultErrorField(const pg_result* res, int) noexcept {
     return res->error;
 }
 
+inline const char* PQcmdTuples(pg_result* res) noexcept {
+    return res->cmd_tuples;
+}
+
+inline const char* PQresultErrorMessage(const pg_result* res) noexcept {
+    return res->error_message;
+}
+
+// The result has no rows, it is received into an output as empty
+inline int pq_ntuples(const pg_result&) noexcept { return 0;}
+
+inline int pq_nfields(const pg_result&) noexcept { return 0;}
+
+inline int pq_field_number(const pg_result&, const char*) noexcept { return -1;}
+
+inline oid_t pq_field_type(const pg_result&, int) noexcept { return null_oid;}
+
+inline impl::result_format pq_field_format(const pg_result&, int) noexcept { return impl::result_format::binary;}
+
+inline const char* pq_get_value(const pg_result&, int, int) noexcept { return nullptr;}
+
+inline int pq_get_length(const pg_result&, int, int) noexcept { return 0;}
+
+inline bool pq_get_isnull(const pg_result&, int, int) noexcept { return true;}
+
 using ozo::empty_oid_map;
 
 struct cancel_handle_mock {
@@ -191,6 +350,11 @@ template<>
 struct safe_handle<ozo::tests::pg_result> {
     using type = ozo::tests::pg_result*;
 };
+
+template<>
+struct safe_handle<ozo::tests::pg_notify> {
+    using type = ozo::tests::pg_notify*;
+};
 } // namespace pg
 } // namespace ozo
 
@@ -211,6 +375,12 @@ struct connection {
     connection_mock* mock_ = nullptr;
     error_context_type error_context_;
     io_context* io_;
+    ozo::detail::statement_cache statement_cache_;
+    bool propagate_deadline_ = false;
+    bool lazy_oid_map_ = false;
+    std::shared_ptr<const std::vector<std::string>> session_setup_;
+    ozo::detail::session_settings session_settings_;
+    ozo::time_traits::duration busy_poll_ = ozo::time_traits::duration::zero();
 
     connection(handle_type handle, OidMap oid_map, connection_mock* mock, error_context_type error_context_type, io_context* io)
     : handle_(std::move(handle)), oid_map_(oid_map), mock_(mock), error_context_(error_context_type), io_(io) {}
@@ -223,6 +393,20 @@ struct connection {
 
     void set_error_context(error_context_type v = error_context_type{}) { error_context_ = std::move(v); }
 
+    ozo::detail::statement_cache& statement_cache() noexcept { return statement_cache_;}
+
+    bool propagate_deadline() const noexcept { return propagate_deadline_;}
+
+    bool lazy_oid_map() const noexcept { return lazy_oid_map_;}
+
+    const std::shared_ptr<const std::vector<std::string>>& session_setup() const noexcept { return session_setup_;}
+
+    ozo::detail::session_settings& session_settings() noexcept { return session_settings_;}
+
+    const ozo::detail::session_settings& session_settings() const noexcept { return session_settings_;}
+
+    ozo::time_traits::duration busy_poll() const noexcept { return busy_poll_;}
+
     oid_map_type& oid_map() noexcept { return oid_map_;}
 
     const oid_map_type& oid_map() const noexcept { return oid_map_;}
@@ -258,8 +442,8 @@ struct connection {
         return c.mock_->get_cancel_handle();
     }
 
-    template <typename Q, typename Out, typename Handler>
-    friend void async_request(std::shared_ptr<connection>&& provider, Q&&, const ozo::time_traits::duration&, Out&&, Handler&&) {
+    template <typename Q, typename TimeConstraint, typename Out, typename Handler>
+    friend void async_request(std::shared_ptr<connection>&& provider, Q&&, TimeConstraint, Out&&, Handler&&) {
         provider->mock_->async_request();
     }
 
@@ -268,6 +452,11 @@ struct connection {
         provider->mock_->async_execute();
     }
 
+    template <typename Q, typename TimeConstraint, typename Handler>
+    friend void async_execute(std::shared_ptr<connection>&& provider, Q&&, TimeConstraint, Handler&&) {
+        provider->mock_->async_execute();
+    }
+
     template <typename Handler>
     friend void request_oid_map(std::shared_ptr<connection>&& provider, Handler&&) {
         provider->mock_->request_oid_map();
@@ -27,12 +27,17 @@ struct pool_handle_mock {
         using error_context_type = std::string;
         using statistics_type = ozo::none_t;
 
-        native_conn_handle safe_handle_;
+        nullable_conn_handle safe_handle_;
         ozo::empty_oid_map oid_map_;
         error_context_type error_context_;
+        ozo::time_traits::time_point expires_at_ = ozo::time_traits::time_point::max();
+        std::size_t requests_ = 0;
+        bool recycle_requested_ = false;
+        ozo::time_traits::time_point memory_checked_at_ = {};
+        std::shared_ptr<void> budget_ {};
 
-        const native_conn_handle& safe_native_handle() const & {return safe_handle_;}
-        native_conn_handle& safe_native_handle() & {return safe_handle_;}
+        const nullable_conn_handle& safe_native_handle() const & {return safe_handle_;}
+        nullable_conn_handle& safe_native_handle() & {return safe_handle_;}
 
         const oid_map_type& oid_map() const & {return oid_map_;}
 
@@ -47,6 +52,27 @@ struct pool_handle_mock {
         void set_error_context(error_context_type v) {
             error_context_ = std::move(v);
         }
+        ozo::time_traits::time_point expires_at() const noexcept { return expires_at_;}
+        void set_expires_at(ozo::time_traits::time_point v) noexcept { expires_at_ = v;}
+        std::size_t requests() const noexcept { return requests_;}
+        void count_request() noexcept { ++requests_;}
+        bool recycle_requested() const noexcept { return recycle_requested_;}
+        void request_recycle() noexcept { recycle_requested_ = true;}
+        ozo::time_traits::time_point memory_checked_at() const noexcept { return memory_checked_at_;}
+        void set_memory_checked_at(ozo::time_traits::time_point v) noexcept { memory_checked_at_ = v;}
+        void hold_budget(std::shared_ptr<void> v) noexcept { budget_ = std::move(v);}
+        std::shared_ptr<void> release_budget() noexcept { return std::move(budget_);}
+        ozo::detail::statement_cache& statement_cache() noexcept {
+            static ozo::detail::statement_cache cache;
+            return cache;
+        }
+        ozo::detail::session_settings& session_settings() noexcept {
+            static ozo::detail::session_settings settings;
+            return settings;
+        }
+        ozo::pg::shared_cancel native_cancel_handle() const {
+            return {PQgetCancel(safe_handle_.get()), [] (PGcancel*) {}};
+        }
     };
 
     MOCK_CONST_METHOD0(empty, bool());
@@ -170,6 +196,27 @@ TEST_F(pooled_connection, should_call_handle_waste_on_destruction_if_handle_is_n
     }
 }
 
+TEST_F(pooled_connection, should_be_intrusively_counted_and_returned_by_last_copy_if_pool_is_not_thread_safe) {
+    EXPECT_CALL(handle_mock, value()).WillRepeatedly(ReturnRef(value));
+    EXPECT_CALL(handle_mock, empty()).WillRepeatedly(Return(false));
+    EXPECT_CALL(conn_handle, PQsocket()).WillOnce(Return(42));
+    EXPECT_CALL(io.stream_service_, create()).WillRepeatedly(ReturnRef(socket));
+    EXPECT_CALL(socket, assign(42));
+
+    auto conn = ozo::detail::create_pooled_connection<ozo::thread_safety<false>>(std::allocator<char>{},
+        io.get_executor(), connection_pool::handle{&handle_mock});
+    static_assert(std::is_same_v<decltype(conn), boost::intrusive_ptr<ozo::pooled_connection<
+        connection_pool::handle, executor, ozo::thread_safety<false>>>>);
+    auto copy = conn;
+    EXPECT_EQ(copy->use_count(), 2u);
+    conn.reset();
+
+    EXPECT_CALL(conn_handle, PQstatus()).WillOnce(Return(CONNECTION_BAD));
+    EXPECT_CALL(socket, release()).WillOnce(Return(42));
+    EXPECT_CALL(handle_mock, waste()).WillOnce(Return());
+    copy.reset();
+}
+
 namespace with_params {
 
 struct pooled_connection : ::pooled_connection,
@@ -235,6 +282,95 @@ TEST_F(pooled_connection, should_not_check_connection_status_and_call_waste_on_d
     }
 }
 
+struct pooled_connection_recovery : pooled_connection {
+    StrictMock<executor_mock> strand;
+    StrictMock<steady_timer_mock> timer;
+    std::function<void(ozo::error_code)> on_timer;
+    ozo::tests::pg_result result{PGRES_COMMAND_OK, nullptr};
+
+    void expect_recovery_start() {
+        EXPECT_CALL(handle_mock, value()).WillRepeatedly(ReturnRef(value));
+        EXPECT_CALL(handle_mock, empty()).WillRepeatedly(Return(false));
+        EXPECT_CALL(conn_handle, PQsocket()).WillRepeatedly(Return(42));
+        EXPECT_CALL(io.stream_service_, create()).WillRepeatedly(ReturnRef(socket));
+        EXPECT_CALL(socket, assign(42)).Times(2);
+        EXPECT_CALL(socket, release()).WillRepeatedly(Return(42));
+        EXPECT_CALL(io.strand_service_, get_executor()).WillOnce(ReturnRef(strand));
+        EXPECT_CALL(io.timer_service_, timer(An<boost::asio::steady_timer::time_point>())).WillOnce(ReturnRef(timer));
+        EXPECT_CALL(timer, async_wait(_)).WillOnce(SaveArg<0>(&on_timer));
+        EXPECT_CALL(strand, post(_)).WillRepeatedly(InvokeArgument<0>());
+    }
+};
+
+TEST_F(pooled_connection_recovery, should_rollback_transaction_and_return_connection_to_pool) {
+    expect_recovery_start();
+    EXPECT_CALL(conn_handle, PQstatus()).WillRepeatedly(Return(CONNECTION_OK));
+
+    std::function<void(ozo::error_code)> on_read;
+    {
+        InSequence s;
+        EXPECT_CALL(conn_handle, PQtransactionStatus()).Times(2).WillRepeatedly(Return(PQTRANS_INTRANS));
+        EXPECT_CALL(conn_handle, PQconsumeInput()).WillOnce(Return(1));
+        EXPECT_CALL(conn_handle, PQisBusy()).WillOnce(Return(0));
+        EXPECT_CALL(conn_handle, PQgetResult()).WillOnce(Return(nullptr));
+        EXPECT_CALL(conn_handle, PQtransactionStatus()).WillOnce(Return(PQTRANS_INTRANS));
+        EXPECT_CALL(conn_handle, PQsendQuery(StrEq("ROLLBACK"))).WillOnce(Return(1));
+        EXPECT_CALL(conn_handle, PQflush()).WillOnce(Return(0));
+        EXPECT_CALL(conn_handle, PQconsumeInput()).WillOnce(Return(1));
+        EXPECT_CALL(conn_handle, PQisBusy()).WillOnce(Return(1));
+        EXPECT_CALL(socket, async_read_some(_)).WillOnce(SaveArg<0>(&on_read));
+    }
+
+    {
+        impl p(io.get_executor(), connection_pool::handle{&handle_mock},
+            ozo::detail::pooled_connection_options{std::chrono::seconds(1)});
+    }
+
+    {
+        InSequence s;
+        EXPECT_CALL(conn_handle, PQconsumeInput()).WillOnce(Return(1));
+        EXPECT_CALL(conn_handle, PQisBusy()).WillOnce(Return(0));
+        EXPECT_CALL(conn_handle, PQgetResult()).WillOnce(Return(&result));
+        EXPECT_CALL(conn_handle, PQisBusy()).WillOnce(Return(0));
+        EXPECT_CALL(conn_handle, PQgetResult()).WillOnce(Return(nullptr));
+        EXPECT_CALL(conn_handle, PQtransactionStatus()).WillOnce(Return(PQTRANS_IDLE));
+        EXPECT_CALL(timer, cancel()).WillOnce(Return(1));
+        EXPECT_CALL(conn_handle, PQtransactionStatus()).WillOnce(Return(PQTRANS_IDLE));
+    }
+    on_read(ozo::error_code{});
+    on_timer(boost::asio::error::operation_aborted);
+}
+
+TEST_F(pooled_connection_recovery, should_close_connection_if_recovery_exceeds_timeout) {
+    expect_recovery_start();
+    EXPECT_CALL(conn_handle, PQstatus()).WillRepeatedly(Return(CONNECTION_OK));
+
+    std::function<void(ozo::error_code)> on_read;
+    {
+        InSequence s;
+        EXPECT_CALL(conn_handle, PQtransactionStatus()).Times(2).WillRepeatedly(Return(PQTRANS_ACTIVE));
+        EXPECT_CALL(conn_handle, PQgetCancel()).WillOnce(Return(nullptr));
+        EXPECT_CALL(conn_handle, PQconsumeInput()).WillOnce(Return(1));
+        EXPECT_CALL(conn_handle, PQisBusy()).WillOnce(Return(1));
+        EXPECT_CALL(socket, async_read_some(_)).WillOnce(SaveArg<0>(&on_read));
+    }
+
+    {
+        impl p(io.get_executor(), connection_pool::handle{&handle_mock},
+            ozo::detail::pooled_connection_options{std::chrono::seconds(1)});
+    }
+
+    {
+        InSequence s;
+        EXPECT_CALL(timer, cancel()).WillOnce(Return(0));
+        EXPECT_CALL(socket, cancel(_)).WillOnce(Return());
+        EXPECT_CALL(handle_mock, waste()).WillOnce(Return());
+    }
+    on_timer(ozo::error_code{});
+    on_read(boost::asio::error::operation_aborted);
+    EXPECT_EQ(value.safe_native_handle().get(), nullptr);
+}
+
 struct pooled_connection_wrapper : Test {
     using pooled_connection_ptr = std::shared_ptr<ozo::pooled_connection<ozo::tests::connection_pool::handle, ozo::tests::executor>>;
     StrictMock<connection_source_mock> provider_mock;
@@ -278,6 +414,25 @@ TEST_F(pooled_connection_wrapper, should_be_copyable_with_non_copyable_handler_f
     EXPECT_TRUE(std::is_copy_constructible_v<decltype(h)>);
 }
 
+#ifdef OZO_HAS_CANCELLATION_SLOT
+
+TEST_F(pooled_connection_wrapper, should_forward_cancellation_slot_of_handler_to_remove_request_from_deadline_queue) {
+    boost::asio::cancellation_signal signal;
+    auto h = ozo::detail::wrap_pooled_connection_handler(
+        io.get_executor(),
+        connection_source{&provider_mock},
+        ozo::none,
+        boost::asio::bind_cancellation_slot(signal.slot(), wrap(callback_mock))
+    );
+
+    auto slot = boost::asio::get_associated_cancellation_slot(h);
+    ASSERT_TRUE(slot.is_connected());
+    slot.assign([] (boost::asio::cancellation_type) {});
+    EXPECT_TRUE(signal.slot().has_handler());
+}
+
+#endif
+
 TEST_F(pooled_connection_wrapper, should_invoke_handler_with_error_if_error_is_passed) {
     auto h = wrap_pooled_connection_handler();
 
@@ -364,6 +519,48 @@ TEST_F(pooled_connection_wrapper, should_call_async_get_connection_and_invoke_ha
     h({}, connection_pool::handle{&handle_mock});
 }
 
+TEST_F(pooled_connection_wrapper, should_hold_budget_in_new_connection_if_handle_is_empty) {
+    const ozo::connection_budget budget(1);
+    const auto member = budget.join(0);
+    auto h = wrap_pooled_connection_handler();
+    h.budget_ = member.get();
+
+    bool handle_empty = true;
+    EXPECT_CALL(handle_mock, empty()).WillRepeatedly(Invoke([&]{ return handle_empty;}));
+    EXPECT_CALL(provider_mock, async_get_connection(_))
+        .WillOnce(InvokeArgument<0>(error_code{}, make_connection()));
+    EXPECT_CALL(handle_mock, reset(_)).WillOnce(Invoke([&](auto){ handle_empty = false;}));
+    EXPECT_CALL(io.stream_service_, create()).WillOnce(ReturnRef(stream));
+    EXPECT_CALL(native_handle, PQsocket()).WillOnce(Return(42));
+    EXPECT_CALL(stream, assign(42));
+    EXPECT_CALL(callback_mock, call(ozo::error_code{}, _)).WillOnce(Return());
+    EXPECT_CALL(stream, release());
+    EXPECT_CALL(native_handle, PQstatus()).WillOnce(Return(CONNECTION_OK));
+    EXPECT_CALL(native_handle, PQtransactionStatus()).WillOnce(Return(PQTRANS_IDLE));
+
+    h({}, connection_pool::handle{&handle_mock});
+
+    EXPECT_NE(rep.budget_, nullptr);
+    EXPECT_EQ(budget.used(), 1u);
+    rep.budget_.reset();
+    EXPECT_EQ(budget.used(), 0u);
+}
+
+TEST_F(pooled_connection_wrapper, should_invoke_handler_with_error_if_budget_is_exhausted_and_handle_is_empty) {
+    const ozo::connection_budget budget(1);
+    const auto member = budget.join(0);
+    const auto other = member->try_acquire();
+    auto h = wrap_pooled_connection_handler();
+    h.budget_ = member.get();
+
+    EXPECT_CALL(handle_mock, empty()).WillRepeatedly(Return(true));
+    EXPECT_CALL(callback_mock, call(ozo::error_code{ozo::error::connection_budget_exhausted}, _)).WillOnce(Return());
+
+    h({}, connection_pool::handle{&handle_mock});
+
+    EXPECT_EQ(budget.rejected(), 1u);
+}
+
 TEST_F(pooled_connection_wrapper, should_invoke_callback_with_error_and_provided_connection_if_async_get_connection_fails) {
     auto h = wrap_pooled_connection_handler();
 
@@ -410,4 +607,373 @@ TEST_F(pooled_connection_wrapper, should_invoke_callback_with_null_pointer_if_as
     h({}, connection_pool::handle{&handle_mock});
 }
 
+struct exhausted_pool_stub {
+    struct stats_type {
+        std::size_t wait_queue_size = 0;
+    };
+
+    stats_type stats() const { return {};}
+    std::size_t available() const { return 0;}
+    std::size_t size() const { return 1;}
+    std::size_t capacity() const { return 1;}
+};
+
+struct handoff_waiter_stub : ozo::detail::handoff_waiter<connection_pool::handle> {
+    bool requested = false;
+
+    using ozo::detail::handoff_waiter<connection_pool::handle>::handoff_waiter;
+
+    void wait() override {}
+    void complete(connection_pool::handle&&) override {}
+    void request() override { requested = true;}
+};
+
+struct pooled_connection_wrapper_with_idle_stack : pooled_connection_wrapper {
+    using idle_stack_type = ozo::detail::idle_stack_t<connection_pool::handle, ozo::thread_safety<true>>;
+
+    exhausted_pool_stub pool;
+    std::shared_ptr<idle_stack_type> stack = std::make_shared<idle_stack_type>(pool, std::chrono::seconds(10), 1);
+    std::shared_ptr<handoff_waiter_stub> waiter = std::make_shared<handoff_waiter_stub>(
+        ozo::time_traits::now() + std::chrono::seconds(10));
+
+    pooled_connection_wrapper_with_idle_stack() {
+        const auto [handle, waiting] = stack->pop_or_wait(ozo::time_traits::now(), waiter);
+        EXPECT_TRUE(waiting);
+    }
+};
+
+TEST_F(pooled_connection_wrapper_with_idle_stack, should_pass_waiting_requests_to_pool_if_connection_is_not_established) {
+    auto h = wrap_pooled_connection_handler();
+    h.idle_ = stack;
+
+    EXPECT_CALL(handle_mock, empty()).WillRepeatedly(Return(true));
+    EXPECT_CALL(provider_mock, async_get_connection(_)).WillOnce(InvokeArgument<0>(error::error, nullptr));
+    EXPECT_CALL(callback_mock, call(Eq(error::error), _)).WillOnce(Return());
+
+    h({}, connection_pool::handle{&handle_mock});
+
+    EXPECT_TRUE(waiter->requested);
+    EXPECT_EQ(stack->waiting(), 0u);
+}
+
+TEST_F(pooled_connection_wrapper_with_idle_stack, should_pass_waiting_requests_to_pool_if_budget_is_exhausted) {
+    const ozo::connection_budget budget(1);
+    const auto member = budget.join(0);
+    const auto other = member->try_acquire();
+    auto h = wrap_pooled_connection_handler();
+    h.budget_ = member.get();
+    h.idle_ = stack;
+
+    EXPECT_CALL(handle_mock, empty()).WillRepeatedly(Return(true));
+    EXPECT_CALL(callback_mock, call(ozo::error_code{ozo::error::connection_budget_exhausted}, _)).WillOnce(Return());
+
+    h({}, connection_pool::handle{&handle_mock});
+
+    EXPECT_TRUE(waiter->requested);
+}
+
+TEST_F(pooled_connection_wrapper, should_count_acquisition_and_waiting_request_for_counters) {
+    ozo::detail::connection_pool_counters counters;
+    auto h = ozo::detail::wrap_pooled_connection_handler(
+        io.get_executor(), connection_source{&provider_mock}, ozo::none, wrap(callback_mock), &counters);
+
+    EXPECT_EQ(counters.acquisitions, 1u);
+    EXPECT_EQ(counters.waiting, 1u);
+
+    EXPECT_CALL(callback_mock, call(error_code(error::error), _)).WillOnce(Return());
+    h(error::error, connection_pool::handle{});
+
+    EXPECT_EQ(counters.waiting, 0u);
+    EXPECT_EQ(counters.wait_time.snapshot().count(), 1u);
+}
+
+TEST_F(pooled_connection_wrapper, should_count_queue_overflow_for_request_queue_overflow_error) {
+    ozo::detail::connection_pool_counters counters;
+    auto h = ozo::detail::wrap_pooled_connection_handler(
+        io.get_executor(), connection_source{&provider_mock}, ozo::none, wrap(callback_mock), &counters);
+
+    EXPECT_CALL(callback_mock, call(_, _)).WillOnce(Return());
+    h(yamail::resource_pool::error::request_queue_overflow, connection_pool::handle{});
+
+    EXPECT_EQ(counters.queue_overflows, 1u);
+    EXPECT_EQ(counters.queue_timeouts, 0u);
+}
+
+TEST_F(pooled_connection_wrapper, should_count_queue_timeout_for_get_resource_timeout_error) {
+    ozo::detail::connection_pool_counters counters;
+    auto h = ozo::detail::wrap_pooled_connection_handler(
+        io.get_executor(), connection_source{&provider_mock}, ozo::none, wrap(callback_mock), &counters);
+
+    EXPECT_CALL(callback_mock, call(_, _)).WillOnce(Return());
+    h(yamail::resource_pool::error::get_resource_timeout, connection_pool::handle{});
+
+    EXPECT_EQ(counters.queue_timeouts, 1u);
+    EXPECT_EQ(counters.queue_overflows, 0u);
+}
+
+TEST_F(pooled_connection_wrapper, should_invoke_handler_with_get_resource_timeout_and_not_use_handle_if_deadline_has_expired) {
+    ozo::detail::connection_pool_counters counters;
+    auto h = ozo::detail::wrap_pooled_connection_handler(
+        io.get_executor(), connection_source{&provider_mock}, ozo::time_traits::now() - std::chrono::seconds(1),
+        wrap(callback_mock), &counters);
+
+    EXPECT_CALL(callback_mock, call(error_code(yamail::resource_pool::error::get_resource_timeout), _))
+        .WillOnce(Return());
+    h({}, connection_pool::handle{&handle_mock});
+
+    EXPECT_EQ(counters.queue_timeouts, 1u);
+    EXPECT_EQ(counters.reused, 0u);
+}
+
+TEST_F(pooled_connection_wrapper, should_count_reused_for_good_connection) {
+    ozo::detail::connection_pool_counters counters;
+    auto h = ozo::detail::wrap_pooled_connection_handler(
+        io.get_executor(), connection_source{&provider_mock}, ozo::none, wrap(callback_mock), &counters);
+
+    EXPECT_CALL(handle_mock, empty()).WillRepeatedly(Return(false));
+    EXPECT_CALL(io.stream_service_, create()).WillOnce(ReturnRef(stream));
+    EXPECT_CALL(stream, assign(42));
+    EXPECT_CALL(stream, release());
+    EXPECT_CALL(native_handle, PQsocket()).WillRepeatedly(Return(42));
+    EXPECT_CALL(native_handle, PQstatus()).WillRepeatedly(Return(CONNECTION_OK));
+    EXPECT_CALL(native_handle, PQtransactionStatus()).WillRepeatedly(Return(PQTRANS_IDLE));
+    EXPECT_CALL(callback_mock, call(_, _)).WillOnce(Return());
+
+    h({}, connection_pool::handle{&handle_mock});
+
+    EXPECT_EQ(counters.reused, 1u);
+    EXPECT_EQ(counters.created, 0u);
+    EXPECT_EQ(rep.requests_, 1u);
+}
+
+TEST_F(pooled_connection_wrapper, should_count_closed_bad_and_created_for_bad_connection) {
+    ozo::detail::connection_pool_counters counters;
+    auto h = ozo::detail::wrap_pooled_connection_handler(
+        io.get_executor(), connection_source{&provider_mock}, ozo::none, wrap(callback_mock), &counters);
+
+    EXPECT_CALL(handle_mock, empty()).WillRepeatedly(Return(false));
+    EXPECT_CALL(native_handle, PQstatus())
+        .WillOnce(Return(CONNECTION_BAD))
+        .WillRepeatedly(Return(CONNECTION_OK));
+    EXPECT_CALL(provider_mock, async_get_connection(_))
+        .WillOnce(InvokeArgument<0>(error_code{}, make_connection()));
+    EXPECT_CALL(handle_mock, reset(_));
+    EXPECT_CALL(io.stream_service_, create()).WillOnce(ReturnRef(stream));
+    EXPECT_CALL(native_handle, PQsocket()).WillOnce(Return(42));
+    EXPECT_CALL(stream, assign(42));
+    EXPECT_CALL(callback_mock, call(ozo::error_code{}, _)).WillOnce(Return());
+    EXPECT_CALL(stream, release());
+    EXPECT_CALL(native_handle, PQtransactionStatus()).WillOnce(Return(PQTRANS_IDLE));
+
+    h({}, connection_pool::handle{&handle_mock});
+
+    EXPECT_EQ(counters.closed_bad, 1u);
+    EXPECT_EQ(counters.created, 1u);
+    EXPECT_EQ(counters.reused, 0u);
+}
+
+TEST_F(pooled_connection_wrapper, should_replace_expired_connection_and_set_expiration_of_new_one) {
+    ozo::detail::connection_pool_counters counters;
+    const ozo::detail::connection_lifespan lifespan {std::chrono::hours(1)};
+    auto h = ozo::detail::wrap_pooled_connection_handler(
+        io.get_executor(), connection_source{&provider_mock}, ozo::none, wrap(callback_mock), &counters,
+        nullptr, &lifespan);
+    rep.expires_at_ = ozo::time_traits::now() - std::chrono::seconds(1);
+
+    EXPECT_CALL(handle_mock, empty()).WillRepeatedly(Return(false));
+    EXPECT_CALL(native_handle, PQstatus()).WillRepeatedly(Return(CONNECTION_OK));
+    EXPECT_CALL(provider_mock, async_get_connection(_))
+        .WillOnce(InvokeArgument<0>(error_code{}, make_connection()));
+    EXPECT_CALL(handle_mock, reset(_));
+    EXPECT_CALL(io.stream_service_, create()).WillOnce(ReturnRef(stream));
+    EXPECT_CALL(native_handle, PQsocket()).WillOnce(Return(42));
+    EXPECT_CALL(stream, assign(42));
+    EXPECT_CALL(callback_mock, call(ozo::error_code{}, _)).WillOnce(Return());
+    EXPECT_CALL(stream, release());
+    EXPECT_CALL(native_handle, PQtransactionStatus()).WillOnce(Return(PQTRANS_IDLE));
+
+    h({}, connection_pool::handle{&handle_mock});
+
+    EXPECT_EQ(counters.expired, 1u);
+    EXPECT_EQ(counters.created, 1u);
+    EXPECT_EQ(counters.reused, 0u);
+    EXPECT_GT(rep.expires_at_, ozo::time_traits::now() + std::chrono::minutes(59));
+}
+
+TEST_F(pooled_connection_wrapper, should_replace_expired_connection_with_its_budget_if_budget_is_exhausted) {
+    const ozo::connection_budget budget(1);
+    const auto member = budget.join(0);
+    rep.budget_ = member->try_acquire();
+    const ozo::detail::connection_lifespan lifespan {std::chrono::hours(1)};
+    auto h = ozo::detail::wrap_pooled_connection_handler(
+        io.get_executor(), connection_source{&provider_mock}, ozo::none, wrap(callback_mock), nullptr,
+        nullptr, &lifespan);
+    h.budget_ = member.get();
+    rep.expires_at_ = ozo::time_traits::now() - std::chrono::seconds(1);
+
+    EXPECT_CALL(handle_mock, empty()).WillRepeatedly(Return(false));
+    EXPECT_CALL(native_handle, PQstatus()).WillRepeatedly(Return(CONNECTION_OK));
+    EXPECT_CALL(provider_mock, async_get_connection(_))
+        .WillOnce(InvokeArgument<0>(error_code{}, make_connection()));
+    EXPECT_CALL(handle_mock, reset(_));
+    EXPECT_CALL(io.stream_service_, create()).WillOnce(ReturnRef(stream));
+    EXPECT_CALL(native_handle, PQsocket()).WillOnce(Return(42));
+    EXPECT_CALL(stream, assign(42));
+    EXPECT_CALL(callback_mock, call(ozo::error_code{}, _)).WillOnce(Return());
+    EXPECT_CALL(stream, release());
+    EXPECT_CALL(native_handle, PQtransactionStatus()).WillOnce(Return(PQTRANS_IDLE));
+
+    h({}, connection_pool::handle{&handle_mock});
+
+    EXPECT_NE(rep.budget_, nullptr);
+    EXPECT_EQ(budget.used(), 1u);
+    EXPECT_EQ(budget.rejected(), 0u);
+}
+
+TEST_F(pooled_connection_wrapper, should_recycle_connection_which_has_served_max_requests) {
+    ozo::detail::connection_pool_counters counters;
+    ozo::detail::connection_lifespan lifespan;
+    lifespan.max_requests = 3;
+    auto h = ozo::detail::wrap_pooled_connection_handler(
+        io.get_executor(), connection_source{&provider_mock}, ozo::none, wrap(callback_mock), &counters,
+        nullptr, &lifespan);
+    rep.requests_ = 3;
+
+    EXPECT_CALL(handle_mock, empty()).WillRepeatedly(Return(false));
+    EXPECT_CALL(native_handle, PQstatus()).WillRepeatedly(Return(CONNECTION_OK));
+    EXPECT_CALL(provider_mock, async_get_connection(_))
+        .WillOnce(InvokeArgument<0>(error_code{}, make_connection()));
+    EXPECT_CALL(handle_mock, reset(_)).WillOnce(Invoke([&] (auto&) { rep.requests_ = 0; }));
+    EXPECT_CALL(io.stream_service_, create()).WillOnce(ReturnRef(stream));
+    EXPECT_CALL(native_handle, PQsocket()).WillOnce(Return(42));
+    EXPECT_CALL(stream, assign(42));
+    EXPECT_CALL(callback_mock, call(ozo::error_code{}, _)).WillOnce(Return());
+    EXPECT_CALL(stream, release());
+    EXPECT_CALL(native_handle, PQtransactionStatus()).WillOnce(Return(PQTRANS_IDLE));
+
+    h({}, connection_pool::handle{&handle_mock});
+
+    EXPECT_EQ(counters.recycled, 1u);
+    EXPECT_EQ(counters.created, 1u);
+    EXPECT_EQ(counters.reused, 0u);
+    EXPECT_EQ(rep.requests_, 1u);
+}
+
+TEST_F(pooled_connection_wrapper, should_recycle_connection_requested_for_recycle) {
+    ozo::detail::connection_pool_counters counters;
+    const ozo::detail::connection_lifespan lifespan;
+    auto h = ozo::detail::wrap_pooled_connection_handler(
+        io.get_executor(), connection_source{&provider_mock}, ozo::none, wrap(callback_mock), &counters,
+        nullptr, &lifespan);
+    rep.recycle_requested_ = true;
+
+    EXPECT_CALL(handle_mock, empty()).WillRepeatedly(Return(false));
+    EXPECT_CALL(native_handle, PQstatus()).WillRepeatedly(Return(CONNECTION_OK));
+    EXPECT_CALL(provider_mock, async_get_connection(_))
+        .WillOnce(InvokeArgument<0>(error_code{}, make_connection()));
+    EXPECT_CALL(handle_mock, reset(_));
+    EXPECT_CALL(io.stream_service_, create()).WillOnce(ReturnRef(stream));
+    EXPECT_CALL(native_handle, PQsocket()).WillOnce(Return(42));
+    EXPECT_CALL(stream, assign(42));
+    EXPECT_CALL(callback_mock, call(ozo::error_code{}, _)).WillOnce(Return());
+    EXPECT_CALL(stream, release());
+    EXPECT_CALL(native_handle, PQtransactionStatus()).WillOnce(Return(PQTRANS_IDLE));
+
+    h({}, connection_pool::handle{&handle_mock});
+
+    EXPECT_EQ(counters.recycled, 1u);
+    EXPECT_EQ(counters.created, 1u);
+}
+
+TEST_F(pooled_connection_wrapper, should_count_connect_error_if_async_get_connection_fails) {
+    ozo::detail::connection_pool_counters counters;
+    auto h = ozo::detail::wrap_pooled_connection_handler(
+        io.get_executor(), connection_source{&provider_mock}, ozo::none, wrap(callback_mock), &counters);
+
+    EXPECT_CALL(handle_mock, empty()).WillRepeatedly(Return(true));
+    EXPECT_CALL(provider_mock, async_get_connection(_))
+        .WillOnce(InvokeArgument<0>(error::error, nullptr));
+    EXPECT_CALL(callback_mock, call(Eq(error::error), _)).WillOnce(Return());
+
+    h({}, connection_pool::handle{&handle_mock});
+
+    EXPECT_EQ(counters.connect_errors, 1u);
+    EXPECT_EQ(counters.created, 0u);
+}
+
+struct pool_warm_up_op : Test {
+    using connection_ptr = std::shared_ptr<int>;
+    StrictMock<callback_gmock<>> callback_mock;
+    std::vector<std::weak_ptr<int>> connections;
+
+    auto make_op(std::size_t count) {
+        auto handler = [this] (error_code ec) {
+            for (const auto& conn : connections) {
+                EXPECT_TRUE(conn.expired());
+            }
+            callback_mock.call(ec);
+        };
+        return ozo::detail::pool_warm_up_op<connection_ptr, decltype(handler)>{count, std::move(handler)};
+    }
+
+    auto make_connection() {
+        auto conn = std::make_shared<int>(42);
+        connections.push_back(conn);
+        return conn;
+    }
+};
+
+TEST_F(pool_warm_up_op, should_call_handler_after_all_connections_are_complete_and_released) {
+    const auto op = make_op(2);
+
+    op(error_code{}, make_connection());
+    EXPECT_CALL(callback_mock, call(error_code{})).WillOnce(Return());
+    op(error_code{}, make_connection());
+}
+
+TEST_F(pool_warm_up_op, should_call_handler_with_first_error) {
+    const auto op = make_op(3);
+
+    op(error_code{}, make_connection());
+    op(error::error, nullptr);
+    EXPECT_CALL(callback_mock, call(error_code{error::error})).WillOnce(Return());
+    op(error::another_error, nullptr);
+}
+
+TEST(connection_alive, should_return_false_for_null_handle) {
+    EXPECT_FALSE(ozo::detail::connection_alive(static_cast<PGconn_mock*>(nullptr)));
+}
+
+TEST(connection_alive, should_return_false_if_connection_status_is_bad) {
+    StrictMock<PGconn_mock> handle;
+    EXPECT_CALL(handle, PQstatus()).WillOnce(Return(CONNECTION_BAD));
+    EXPECT_FALSE(ozo::detail::connection_alive(&handle));
+}
+
+TEST(connection_alive, should_return_false_if_consume_input_fails) {
+    StrictMock<PGconn_mock> handle;
+    InSequence s;
+    EXPECT_CALL(handle, PQstatus()).WillOnce(Return(CONNECTION_OK));
+    EXPECT_CALL(handle, PQconsumeInput()).WillOnce(Return(0));
+    EXPECT_FALSE(ozo::detail::connection_alive(&handle));
+}
+
+TEST(connection_alive, should_return_false_if_connection_status_becomes_bad_after_consume_input) {
+    StrictMock<PGconn_mock> handle;
+    InSequence s;
+    EXPECT_CALL(handle, PQstatus()).WillOnce(Return(CONNECTION_OK));
+    EXPECT_CALL(handle, PQconsumeInput()).WillOnce(Return(1));
+    EXPECT_CALL(handle, PQstatus()).WillOnce(Return(CONNECTION_BAD));
+    EXPECT_FALSE(ozo::detail::connection_alive(&handle));
+}
+
+TEST(connection_alive, should_return_true_if_connection_status_is_ok_after_consume_input) {
+    StrictMock<PGconn_mock> handle;
+    InSequence s;
+    EXPECT_CALL(handle, PQstatus()).WillOnce(Return(CONNECTION_OK));
+    EXPECT_CALL(handle, PQconsumeInput()).WillOnce(Return(1));
+    EXPECT_CALL(handle, PQstatus()).WillOnce(Return(CONNECTION_OK));
+    EXPECT_TRUE(ozo::detail::connection_alive(&handle));
+}
+
 } // namespace
@@ -0,0 +1,397 @@
+#include <ozo/connection.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <vector>
+
+namespace {
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+TEST(connection_statistics, should_be_zero_by_default) {
+    const ozo::connection_statistics stats;
+    EXPECT_EQ(stats.requests(), 0u);
+    EXPECT_EQ(stats.errors(), 0u);
+    EXPECT_EQ(stats.bytes_sent(), 0u);
+    EXPECT_EQ(stats.bytes_received(), 0u);
+    EXPECT_EQ(stats.round_trips(), 0u);
+    EXPECT_EQ(stats.latency().count(), 0u);
+    EXPECT_EQ(stats.result_memory().count(), 0u);
+    EXPECT_EQ(stats.peak_result_memory(), 0u);
+}
+
+TEST(connection_statistics, update_should_account_request) {
+    ozo::connection_statistics stats;
+    stats.update(ozo::request_statistics_key, ozo::request_statistics{10, 100, 3us, false});
+    stats.update(ozo::request_statistics_key, ozo::request_statistics{5, 0, 1ms, true});
+    EXPECT_EQ(stats.requests(), 2u);
+    EXPECT_EQ(stats.errors(), 1u);
+    EXPECT_EQ(stats.bytes_sent(), 15u);
+    EXPECT_EQ(stats.bytes_received(), 100u);
+    EXPECT_EQ(stats.latency().buckets[ozo::latency_histogram::bucket(3us)], 1u);
+    EXPECT_EQ(stats.latency().buckets[ozo::latency_histogram::bucket(1ms)], 1u);
+}
+
+TEST(connection_statistics, update_should_account_result_memory_with_peak) {
+    ozo::connection_statistics stats;
+    stats.update(ozo::request_statistics_key, ozo::request_statistics{10, 100, 3us, false, 1, 4096});
+    stats.update(ozo::request_statistics_key, ozo::request_statistics{10, 100, 3us, false, 1, 1 << 20});
+    stats.update(ozo::request_statistics_key, ozo::request_statistics{10, 100, 3us, false, 1, 512});
+    EXPECT_EQ(stats.result_memory().count(), 3u);
+    EXPECT_EQ(stats.result_memory().buckets[ozo::size_histogram::bucket(4096)], 1u);
+    EXPECT_EQ(stats.result_memory().buckets[ozo::size_histogram::bucket(1 << 20)], 1u);
+    EXPECT_EQ(stats.peak_result_memory(), std::uint64_t(1) << 20);
+}
+
+TEST(connection_statistics, copy_should_copy_collected_statistics) {
+    ozo::connection_statistics stats;
+    stats.update(ozo::request_statistics_key, ozo::request_statistics{10, 100, 3us, true, 2});
+    const auto copy = stats;
+    EXPECT_EQ(copy.requests(), 1u);
+    EXPECT_EQ(copy.errors(), 1u);
+    EXPECT_EQ(copy.bytes_sent(), 10u);
+    EXPECT_EQ(copy.bytes_received(), 100u);
+    EXPECT_EQ(copy.round_trips(), 2u);
+    EXPECT_EQ(copy.latency().count(), 1u);
+    EXPECT_EQ(copy.result_memory().count(), 1u);
+}
+
+using statistics_connection = ozo::connection<ozo::empty_oid_map, ozo::connection_statistics>;
+using no_statistics_connection = ozo::connection<ozo::empty_oid_map, ozo::no_statistics>;
+
+TEST(collects_request_statistics, should_be_true_for_connection_with_connection_statistics) {
+    EXPECT_TRUE(ozo::detail::collects_request_statistics<statistics_connection>::value);
+}
+
+TEST(collects_request_statistics, should_be_false_for_connection_with_no_statistics) {
+    EXPECT_FALSE(ozo::detail::collects_request_statistics<no_statistics_connection>::value);
+}
+
+struct connection_stub {
+    ozo::connection_statistics statistics_;
+
+    const ozo::connection_statistics& statistics() const noexcept { return statistics_;}
+
+    void update_statistics(ozo::request_statistics_key_t key, const ozo::request_statistics& v) noexcept {
+        statistics_.update(key, v);
+    }
+};
+
+TEST(request_statistics_sample, commit_should_update_connection_statistics_with_sent_and_received_bytes) {
+    ozo::detail::request_statistics_sample<connection_stub> sample;
+    const int lengths[] = {4, 8};
+    sample.sent("SELECT $1, $2", lengths, 2);
+
+    const ozo::pg::result result {PQmakeEmptyPGresult(nullptr, PGRES_TUPLES_OK)};
+    PGresAttDesc attrs[2] {};
+    char name[] = "a";
+    attrs[0].name = name;
+    attrs[1].name = name;
+    ASSERT_TRUE(PQsetResultAttrs(result.get(), 2, attrs));
+    char value[] = "value";
+    ASSERT_TRUE(PQsetvalue(result.get(), 0, 0, value, 5));
+    ASSERT_TRUE(PQsetvalue(result.get(), 0, 1, value, 2));
+    ASSERT_TRUE(PQsetvalue(result.get(), 1, 0, value, 3));
+    ASSERT_TRUE(PQsetvalue(result.get(), 1, 1, nullptr, -1));
+    sample.received(result);
+
+    connection_stub conn;
+    sample.commit(conn, false);
+
+    EXPECT_EQ(conn.statistics().requests(), 1u);
+    EXPECT_EQ(conn.statistics().errors(), 0u);
+    EXPECT_EQ(conn.statistics().bytes_sent(), 25u);
+    EXPECT_EQ(conn.statistics().bytes_received(), 10u);
+    EXPECT_EQ(conn.statistics().latency().count(), 1u);
+    EXPECT_EQ(conn.statistics().peak_result_memory(), PQresultMemorySize(result.get()));
+}
+
+TEST(request_statistics_sample, commit_should_update_connection_statistics_with_round_trips) {
+    ozo::detail::request_statistics_sample<connection_stub> sample;
+    sample.waited();
+    sample.waited();
+    connection_stub conn;
+    sample.commit(conn, false);
+    sample.waited();
+    sample.commit(conn, false);
+    EXPECT_EQ(conn.statistics().round_trips(), 5u);
+}
+
+TEST(request_statistics_sample, commit_should_count_failed_request) {
+    ozo::detail::request_statistics_sample<connection_stub> sample;
+    connection_stub conn;
+    sample.commit(conn, true);
+    EXPECT_EQ(conn.statistics().errors(), 1u);
+}
+
+struct timeline_observer {
+    std::vector<ozo::request_timeline> timelines;
+
+    void update(ozo::request_timeline_key_t, const ozo::request_timeline& v) noexcept {
+        timelines.push_back(v);
+    }
+};
+
+struct timeline_connection_stub {
+    timeline_observer statistics_;
+
+    const timeline_observer& statistics() const noexcept { return statistics_;}
+
+    template <typename Key, typename Value>
+    auto update_statistics(const Key& key, const Value& v) noexcept
+            -> decltype(statistics_.update(key, v)) {
+        statistics_.update(key, v);
+    }
+};
+
+TEST(observes_request_timeline, should_be_true_for_connection_with_timeline_observer) {
+    EXPECT_TRUE(ozo::detail::observes_request_timeline<timeline_connection_stub>::value);
+    EXPECT_FALSE(ozo::detail::collects_request_statistics<timeline_connection_stub>::value);
+}
+
+TEST(observes_request_timeline, should_be_false_for_connection_with_connection_statistics) {
+    EXPECT_FALSE(ozo::detail::observes_request_timeline<statistics_connection>::value);
+}
+
+TEST(observes_request_timeline, should_be_false_for_connection_with_no_statistics) {
+    EXPECT_FALSE(ozo::detail::observes_request_timeline<no_statistics_connection>::value);
+}
+
+struct cpu_time_observer {
+    std::vector<ozo::request_cpu_time> values;
+
+    void update(ozo::request_cpu_time_key_t, const ozo::request_cpu_time& v) noexcept {
+        values.push_back(v);
+    }
+};
+
+struct cpu_time_connection_stub {
+    cpu_time_observer statistics_;
+
+    const cpu_time_observer& statistics() const noexcept { return statistics_;}
+
+    template <typename Key, typename Value>
+    auto update_statistics(const Key& key, const Value& v) noexcept
+            -> decltype(statistics_.update(key, v)) {
+        statistics_.update(key, v);
+    }
+};
+
+void spin_cpu() {
+    const auto start = ozo::detail::thread_cpu_time();
+    volatile std::size_t v = 0;
+    while (ozo::detail::thread_cpu_time() - start < std::chrono::microseconds(100)) {
+        v = v + 1;
+    }
+}
+
+TEST(observes_request_cpu_time, should_be_true_for_connection_with_cpu_time_observer_only) {
+    EXPECT_TRUE(ozo::detail::observes_request_cpu_time<cpu_time_connection_stub>::value);
+    EXPECT_FALSE(ozo::detail::observes_request_cpu_time<timeline_connection_stub>::value);
+    EXPECT_FALSE(ozo::detail::observes_request_cpu_time<no_statistics_connection>::value);
+}
+
+TEST(request_cpu_time_sample, commit_should_update_connection_with_measured_phases) {
+    ozo::detail::request_cpu_time_sample<cpu_time_connection_stub> sample;
+    {
+        const auto scope = sample.measure_serialization();
+        spin_cpu();
+    }
+    {
+        const auto scope = sample.measure_decoding();
+        spin_cpu();
+    }
+    cpu_time_connection_stub conn;
+    sample.commit(conn, true);
+
+    ASSERT_EQ(conn.statistics().values.size(), 1u);
+    const auto& v = conn.statistics().values.front();
+    EXPECT_GE(v.serialization, std::chrono::microseconds(100));
+    EXPECT_GE(v.decoding, std::chrono::microseconds(100));
+    EXPECT_TRUE(v.failed);
+}
+
+TEST(request_cpu_time_sample, should_not_measure_without_observer) {
+    ozo::detail::request_cpu_time_sample<timeline_connection_stub> sample;
+    {
+        const auto scope = sample.measure_decoding();
+        spin_cpu();
+    }
+    EXPECT_EQ(sample.cpu_time.decoding, ozo::time_traits::duration::zero());
+}
+
+TEST(request_cpu_time_sample, commit_should_call_observer_of_handler) {
+    ozo::detail::request_cpu_time_sample<timeline_connection_stub> sample;
+    std::vector<ozo::request_cpu_time> values;
+    sample.set_cpu_time_observer({&values, [] (void* target, const ozo::request_cpu_time& v) noexcept {
+        static_cast<std::vector<ozo::request_cpu_time>*>(target)->push_back(v);
+    }});
+    {
+        const auto scope = sample.measure_decoding();
+        spin_cpu();
+    }
+    timeline_connection_stub conn;
+    sample.commit(conn, false);
+
+    ASSERT_EQ(values.size(), 1u);
+    EXPECT_TRUE(conn.statistics().timelines.empty());
+    EXPECT_GE(values.front().decoding, std::chrono::microseconds(100));
+    EXPECT_EQ(values.front().serialization, ozo::time_traits::duration::zero());
+    EXPECT_FALSE(values.front().failed);
+}
+
+TEST(request_start_point, should_be_empty_for_connection_with_no_statistics) {
+    EXPECT_TRUE(std::is_empty_v<ozo::detail::request_start_point<no_statistics_connection>>);
+    EXPECT_TRUE(std::is_empty_v<ozo::detail::request_statistics_sample<no_statistics_connection>>);
+}
+
+TEST(request_statistics_sample, commit_should_update_connection_with_ordered_phases_timeline) {
+    const ozo::detail::request_start_point<timeline_connection_stub> start;
+    ozo::detail::request_statistics_sample<timeline_connection_stub> sample;
+    sample.requested(start);
+    sample.flushed();
+    sample.result_received();
+
+    timeline_connection_stub conn;
+    sample.commit(conn, false);
+
+    ASSERT_EQ(conn.statistics().timelines.size(), 1u);
+    const auto& v = conn.statistics().timelines.front();
+    EXPECT_EQ(v.requested, start.value);
+    EXPECT_LE(v.requested, v.acquired);
+    EXPECT_LE(v.acquired, v.sent);
+    EXPECT_LE(v.sent, v.received);
+    EXPECT_LE(v.received, v.finished);
+    EXPECT_FALSE(v.failed);
+}
+
+TEST(request_statistics_sample, commit_should_leave_unreached_phases_default_and_requested_as_acquired) {
+    ozo::detail::request_statistics_sample<timeline_connection_stub> sample;
+    sample.requested(ozo::none);
+
+    timeline_connection_stub conn;
+    sample.commit(conn, true);
+
+    ASSERT_EQ(conn.statistics().timelines.size(), 1u);
+    const auto& v = conn.statistics().timelines.front();
+    EXPECT_EQ(v.requested, v.acquired);
+    EXPECT_EQ(v.sent, ozo::time_traits::time_point{});
+    EXPECT_EQ(v.received, ozo::time_traits::time_point{});
+    EXPECT_LE(v.acquired, v.finished);
+    EXPECT_TRUE(v.failed);
+}
+
+TEST(request_statistics_sample, commit_should_update_connection_with_sizes_of_parameters) {
+    ozo::detail::request_statistics_sample<timeline_connection_stub> sample;
+    const int lengths[] = {4, 8};
+    sample.sent("SELECT $1, $2", lengths, 2);
+
+    timeline_connection_stub conn;
+    sample.commit(conn, false);
+
+    ASSERT_EQ(conn.statistics().timelines.size(), 1u);
+    EXPECT_EQ(conn.statistics().timelines.front().params, 2u);
+    EXPECT_EQ(conn.statistics().timelines.front().params_bytes, 12u);
+}
+
+TEST(request_statistics_sample, commit_should_update_connection_with_number_of_rows_received) {
+    ozo::detail::request_statistics_sample<timeline_connection_stub> sample;
+    const ozo::pg::result result {PQmakeEmptyPGresult(nullptr, PGRES_TUPLES_OK)};
+    PGresAttDesc attrs[1] {};
+    char name[] = "a";
+    attrs[0].name = name;
+    ASSERT_TRUE(PQsetResultAttrs(result.get(), 1, attrs));
+    char value[] = "value";
+    ASSERT_TRUE(PQsetvalue(result.get(), 0, 0, value, 5));
+    ASSERT_TRUE(PQsetvalue(result.get(), 1, 0, value, 5));
+    sample.received(result);
+    sample.received(result);
+
+    timeline_connection_stub conn;
+    sample.commit(conn, false);
+
+    ASSERT_EQ(conn.statistics().timelines.size(), 1u);
+    EXPECT_EQ(conn.statistics().timelines.front().rows, 4u);
+    EXPECT_EQ(conn.statistics().timelines.front().result_memory, PQresultMemorySize(result.get()));
+}
+
+struct connect_timeline_observer {
+    std::vector<ozo::connect_timeline> timelines;
+
+    void update(ozo::connect_timeline_key_t, const ozo::connect_timeline& v) noexcept {
+        timelines.push_back(v);
+    }
+};
+
+struct connect_timeline_connection_stub {
+    connect_timeline_observer statistics_;
+
+    const connect_timeline_observer& statistics() const noexcept { return statistics_;}
+
+    template <typename Key, typename Value>
+    auto update_statistics(const Key& key, const Value& v) noexcept
+            -> decltype(statistics_.update(key, v)) {
+        statistics_.update(key, v);
+    }
+};
+
+TEST(connect_timeline_sample, should_be_empty_for_connection_with_no_statistics) {
+    EXPECT_TRUE(std::is_empty_v<ozo::detail::connect_timeline_sample<no_statistics_connection>>);
+    EXPECT_FALSE(ozo::detail::observes_connect_timeline<timeline_connection_stub>::value);
+}
+
+TEST(connect_timeline_sample, commit_should_update_connection_with_connect_timeline) {
+    ozo::detail::connect_timeline_sample<connect_timeline_connection_stub> sample;
+    connect_timeline_connection_stub conn;
+    sample.commit(conn, true);
+
+    ASSERT_EQ(conn.statistics().timelines.size(), 1u);
+    const auto& v = conn.statistics().timelines.front();
+    EXPECT_EQ(v.started, sample.timeline.started);
+    EXPECT_LE(v.started, v.finished);
+    EXPECT_TRUE(v.failed);
+    EXPECT_TRUE(v.host.empty());
+}
+
+TEST(connect_timeline_sample, mark_should_account_time_since_previous_mark_to_the_phase) {
+    ozo::detail::connect_timeline_sample<connect_timeline_connection_stub> sample;
+    sample.mark(ozo::connect_phase::start);
+    const auto start = sample.last;
+    sample.mark(ozo::connect_phase::auth);
+    sample.mark(ozo::connect_phase::auth);
+    connect_timeline_connection_stub conn;
+    sample.commit(conn, false);
+
+    ASSERT_EQ(conn.statistics().timelines.size(), 1u);
+    const auto& v = conn.statistics().timelines.front();
+    EXPECT_EQ(v.phase(ozo::connect_phase::start), start - v.started);
+    EXPECT_EQ(v.phase(ozo::connect_phase::auth), sample.last - start);
+    EXPECT_EQ(v.phase(ozo::connect_phase::tcp), ozo::time_traits::duration::zero());
+    EXPECT_LE(sample.last, v.finished);
+}
+
+TEST(connect_timeline_sample, poll_finished_should_account_time_to_the_phase_by_default_tcp) {
+    ozo::detail::connect_timeline_sample<connect_timeline_connection_stub> sample;
+    connect_timeline_connection_stub conn;
+    sample.poll_started(conn);
+    sample.poll_finished();
+    sample.commit(conn, false);
+
+    ASSERT_EQ(conn.statistics().timelines.size(), 1u);
+    EXPECT_EQ(conn.statistics().timelines.front().phase(ozo::connect_phase::tcp), sample.last - sample.timeline.started);
+}
+
+TEST(get_connect_phase, should_map_connection_status_to_phase) {
+    using ozo::detail::get_connect_phase;
+    EXPECT_EQ(get_connect_phase(CONNECTION_STARTED), ozo::connect_phase::tcp);
+    EXPECT_EQ(get_connect_phase(CONNECTION_SSL_STARTUP), ozo::connect_phase::ssl);
+    EXPECT_EQ(get_connect_phase(CONNECTION_GSS_STARTUP), ozo::connect_phase::ssl);
+    EXPECT_EQ(get_connect_phase(CONNECTION_MADE), ozo::connect_phase::auth);
+    EXPECT_EQ(get_connect_phase(CONNECTION_AWAITING_RESPONSE), ozo::connect_phase::auth);
+    EXPECT_EQ(get_connect_phase(CONNECTION_AUTH_OK), ozo::connect_phase::startup);
+    EXPECT_EQ(get_connect_phase(CONNECTION_CONSUME), ozo::connect_phase::startup);
+}
+
+} // namespace
@@ -0,0 +1,197 @@
+#include <ozo/copy_loader.h>
+#include <ozo/ext/std/tuple.h>
+#include <ozo/pg/types/integer.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <optional>
+
+namespace {
+
+using namespace testing;
+
+using ozo::error_code;
+
+struct copy_in_channel : Test {
+    ozo::io_context io;
+    ozo::impl::copy_in_channel channel {64};
+    ozo::empty_oid_map oid_map;
+
+    auto make_waiter(std::optional<error_code>& out) {
+        return ozo::impl::make_copy_in_waiter([&out] (error_code ec) { out = ec;}, io.get_executor());
+    }
+
+    void write(std::int32_t v, std::optional<error_code>& out) {
+        channel.write(oid_map, std::make_tuple(v), make_waiter(out));
+    }
+
+    // Each row takes 10 bytes: fields count, field size and the value
+    void fill(std::optional<error_code>& out) {
+        for (std::int32_t i = 0; i < 5; ++i) {
+            out.reset();
+            write(i, out);
+            io.poll();
+            io.restart();
+        }
+    }
+};
+
+TEST_F(copy_in_channel, should_complete_write_at_once_while_pending_data_is_less_than_limit) {
+    std::optional<error_code> ec;
+    write(1, ec);
+    io.poll();
+    EXPECT_EQ(ec, error_code{});
+}
+
+TEST_F(copy_in_channel, should_not_fill_buffer_while_pending_data_is_less_than_limit) {
+    std::optional<error_code> ec;
+    write(1, ec);
+    EXPECT_FALSE(channel.fill_buffer(oid_map));
+    EXPECT_FALSE(channel.drained());
+}
+
+TEST_F(copy_in_channel, should_complete_write_only_after_pending_data_reached_limit_is_taken) {
+    std::optional<error_code> ec;
+    fill(ec);
+    EXPECT_FALSE(ec);
+
+    EXPECT_TRUE(channel.fill_buffer(oid_map));
+    io.poll();
+    EXPECT_EQ(ec, error_code{});
+    EXPECT_EQ(channel.buffer.size(), 19u + 5 * 10u);
+}
+
+TEST_F(copy_in_channel, should_complete_all_concurrent_writes_waiting_for_pending_data_to_be_taken) {
+    std::optional<error_code> first, second;
+    fill(first);
+    write(5, second);
+    io.poll();
+    io.restart();
+    EXPECT_FALSE(first);
+    EXPECT_FALSE(second);
+
+    EXPECT_TRUE(channel.fill_buffer(oid_map));
+    io.poll();
+    EXPECT_EQ(first, error_code{});
+    EXPECT_EQ(second, error_code{});
+}
+
+TEST_F(copy_in_channel, should_append_trailer_and_become_drained_after_close) {
+    std::optional<error_code> ec;
+    write(1, ec);
+    channel.close();
+
+    EXPECT_TRUE(channel.fill_buffer(oid_map));
+    EXPECT_EQ(channel.buffer.size(), 19u + 10u + 2u);
+    EXPECT_TRUE(channel.drained());
+    EXPECT_FALSE(channel.fill_buffer(oid_map));
+}
+
+TEST_F(copy_in_channel, should_complete_waiting_write_with_error_on_fail) {
+    std::optional<error_code> ec;
+    fill(ec);
+    channel.fail(ozo::error::pg_put_copy_data_failed);
+    io.poll();
+    EXPECT_EQ(ec, error_code{ozo::error::pg_put_copy_data_failed});
+}
+
+TEST_F(copy_in_channel, should_complete_write_with_error_after_fail) {
+    channel.fail(ozo::error::pg_put_copy_data_failed);
+    std::optional<error_code> ec;
+    write(1, ec);
+    io.poll();
+    EXPECT_EQ(ec, error_code{ozo::error::pg_put_copy_data_failed});
+}
+
+TEST_F(copy_in_channel, should_complete_write_with_operation_aborted_after_close) {
+    channel.close();
+    std::optional<error_code> ec;
+    write(1, ec);
+    io.poll();
+    EXPECT_EQ(ec, error_code{boost::asio::error::operation_aborted});
+}
+
+TEST_F(copy_in_channel, should_resume_waiting_consumer_once_pending_data_reached_limit) {
+    bool resumed = false;
+    channel.async_wait(boost::asio::bind_executor(io, [&] (error_code) { resumed = true;}));
+    io.poll();
+    io.restart();
+    EXPECT_FALSE(resumed);
+
+    std::optional<error_code> ec;
+    fill(ec);
+    EXPECT_TRUE(resumed);
+}
+
+TEST_F(copy_in_channel, should_resume_waiting_consumer_on_close) {
+    bool resumed = false;
+    channel.async_wait(boost::asio::bind_executor(io, [&] (error_code) { resumed = true;}));
+    channel.close();
+    io.poll();
+    EXPECT_TRUE(resumed);
+}
+
+struct copy_loader_state : Test {
+    ozo::io_context io;
+    ozo::detail::copy_loader_state state {io, 2, 64};
+    std::optional<error_code> ec;
+    std::vector<error_code> statuses;
+
+    auto make_waiter() {
+        auto handler = [this] (error_code e, std::vector<error_code> s) {
+            ec = e;
+            statuses = std::move(s);
+        };
+        using waiter_type = ozo::detail::copy_loader_waiter_impl<decltype(handler), ozo::io_context::executor_type>;
+        return std::make_unique<waiter_type>(std::move(handler), io.get_executor());
+    }
+};
+
+TEST_F(copy_loader_state, finish_should_close_channels) {
+    state.finish(make_waiter());
+    EXPECT_TRUE(state.channel(0)->fill_buffer(ozo::empty_oid_map{}));
+    EXPECT_TRUE(state.channel(1)->fill_buffer(ozo::empty_oid_map{}));
+}
+
+TEST_F(copy_loader_state, finish_should_complete_after_all_partitions_complete) {
+    state.finish(make_waiter());
+    state.complete(0, {});
+    io.poll();
+    io.restart();
+    EXPECT_FALSE(ec);
+
+    state.complete(1, {});
+    io.poll();
+    EXPECT_EQ(ec, error_code{});
+    EXPECT_THAT(statuses, ElementsAre(error_code{}, error_code{}));
+}
+
+TEST_F(copy_loader_state, finish_should_complete_at_once_if_all_partitions_are_complete) {
+    state.complete(0, ozo::error::pg_put_copy_data_failed);
+    state.complete(1, ozo::error::pg_flush_failed);
+    state.finish(make_waiter());
+    io.poll();
+    EXPECT_EQ(ec, error_code{ozo::error::pg_put_copy_data_failed});
+    EXPECT_THAT(statuses, ElementsAre(error_code{ozo::error::pg_put_copy_data_failed},
+        error_code{ozo::error::pg_flush_failed}));
+}
+
+TEST_F(copy_loader_state, finish_should_complete_with_partial_result_if_some_partitions_failed) {
+    state.complete(0, {});
+    state.complete(1, ozo::error::pg_flush_failed);
+    state.finish(make_waiter());
+    io.poll();
+    EXPECT_EQ(ec, error_code{ozo::error::partial_result});
+}
+
+TEST_F(copy_loader_state, failed_partition_should_complete_its_writes_with_error) {
+    state.complete(1, ozo::error::pg_flush_failed);
+    std::optional<error_code> write_ec;
+    state.channel(1)->write(ozo::empty_oid_map{}, std::make_tuple(std::int32_t(1)),
+        ozo::impl::make_copy_in_waiter([&] (error_code e) { write_ec = e;}, io.get_executor()));
+    io.poll();
+    EXPECT_EQ(write_ec, error_code{ozo::error::pg_flush_failed});
+}
+
+} // namespace
@@ -0,0 +1,35 @@
+#include <ozo/cursor.h>
+#include <ozo/query_builder.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+
+TEST(make_cursor_declare, should_prepend_declare_to_query_text) {
+    const auto query = ozo::impl::make_cursor_declare(ozo::make_query("SELECT id FROM users"));
+    EXPECT_EQ(std::string(ozo::to_const_char(ozo::get_text(query))),
+        "DECLARE ozo_cursor NO SCROLL CURSOR FOR SELECT id FROM users");
+}
+
+TEST(make_cursor_declare, should_keep_query_params) {
+    using namespace ozo::literals;
+    const auto query = ozo::impl::make_cursor_declare("SELECT id FROM users WHERE id > "_SQL + std::int64_t(42));
+    EXPECT_EQ(std::string(ozo::to_const_char(ozo::get_text(query))),
+        "DECLARE ozo_cursor NO SCROLL CURSOR FOR SELECT id FROM users WHERE id > $1");
+    EXPECT_EQ(boost::hana::at_c<0>(ozo::get_params(query)), 42);
+}
+
+TEST(make_cursor_fetch, should_fetch_page_rows_forward) {
+    const auto query = ozo::impl::make_cursor_fetch(1000);
+    EXPECT_EQ(std::string(ozo::to_const_char(ozo::get_text(query))), "FETCH FORWARD 1000 FROM ozo_cursor");
+}
+
+TEST(make_cursor_close, should_close_cursor) {
+    const auto query = ozo::impl::make_cursor_close();
+    EXPECT_EQ(std::string(ozo::to_const_char(ozo::get_text(query))), "CLOSE ozo_cursor");
+}
+
+} // namespace
@@ -56,4 +56,12 @@ TEST(expired, should_return_true_for_time_point_greater_than_deadline) {
     EXPECT_TRUE(ozo::expired(time_point{}, time_point{} + 1s));
 }
 
+TEST(coarse_steady_clock, should_share_epoch_with_steady_clock) {
+    const auto before = std::chrono::steady_clock::now();
+    const auto coarse = ozo::coarse_steady_clock::now();
+    const auto after = std::chrono::steady_clock::now();
+    EXPECT_LE(coarse, after);
+    EXPECT_LT(before - coarse, 1s);
+}
+
 } // namespace
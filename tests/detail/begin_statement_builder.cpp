@@ -197,4 +197,27 @@ TEST(begin_statement_builder, should_allow_integral_constants_for_deferrability)
               get_text(begin_statement_builder::build(make_options(transaction_options::deferrability = std::false_type{}))));
 }
 
+TEST(begin_statement_builder, should_ignore_deferred_begin_option) {
+    using namespace ozo;
+    using namespace ozo::detail;
+
+    EXPECT_EQ(get_text(begin_statement_builder::build(make_options(transaction_options::deferred_begin = std::true_type{},
+                                                                   transaction_options::mode = transaction_mode::read_only))),
+              get_text(begin_statement_builder::build(make_options(transaction_options::mode = transaction_mode::read_only))));
+}
+
+TEST(begin_statement_builder, should_provide_statement_with_compile_time_text) {
+    using namespace ozo;
+    using namespace ozo::detail;
+    using namespace hana::literals;
+
+    constexpr auto options = make_options(transaction_options::isolation_level = isolation_level::serializable,
+                                          transaction_options::mode = transaction_mode::read_only);
+    using statement = begin_statement_builder::statement_type<std::decay_t<decltype(options)>>;
+
+    static_assert(hana::is_a<hana::string_tag, decltype(get_text(statement{}))>);
+    EXPECT_EQ(get_text(begin_statement_builder::statement(options)),
+              "BEGIN ISOLATION LEVEL SERIALIZABLE READ ONLY"_s);
+}
+
 } // namespace
@@ -0,0 +1,81 @@
+#include <ozo/detail/bounded_queue.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <thread>
+#include <vector>
+
+namespace {
+
+using namespace testing;
+
+using ozo::detail::bounded_queue;
+
+TEST(bounded_queue, should_round_capacity_up_to_power_of_two) {
+    EXPECT_EQ(bounded_queue<int>(5).capacity(), 8u);
+    EXPECT_EQ(bounded_queue<int>(8).capacity(), 8u);
+    EXPECT_EQ(bounded_queue<int>(0).capacity(), 2u);
+}
+
+TEST(bounded_queue, try_pop_should_return_items_in_push_order) {
+    bounded_queue<int> queue(4);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_TRUE(queue.try_push(i));
+    }
+    EXPECT_EQ(queue.try_pop(), 0);
+    EXPECT_EQ(queue.try_pop(), 1);
+    EXPECT_EQ(queue.try_pop(), 2);
+    EXPECT_EQ(queue.try_pop(), std::nullopt);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(bounded_queue, try_push_should_return_false_and_keep_item_if_queue_is_full) {
+    bounded_queue<std::string> queue(2);
+    std::string item = "item";
+    EXPECT_TRUE(queue.try_push(item));
+    item = "item";
+    EXPECT_TRUE(queue.try_push(item));
+    item = "rejected";
+    EXPECT_FALSE(queue.try_push(item));
+    EXPECT_EQ(item, "rejected");
+}
+
+TEST(bounded_queue, should_reuse_cells_after_pop) {
+    bounded_queue<int> queue(2);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_TRUE(queue.try_push(i));
+        EXPECT_EQ(queue.try_pop(), i);
+    }
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(bounded_queue, should_pass_every_item_from_many_producers_to_consumer) {
+    bounded_queue<int> queue(64);
+    constexpr int producers = 4;
+    constexpr int items = 1000;
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < items; ++i) {
+                int item = i;
+                while (!queue.try_push(item)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    long long sum = 0;
+    for (int received = 0; received < producers * items;) {
+        if (const auto item = queue.try_pop()) {
+            sum += *item;
+            ++received;
+        }
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(sum, static_cast<long long>(producers) * items * (items - 1) / 2);
+}
+
+} // namespace
@@ -0,0 +1,91 @@
+#include <ozo/detail/connect_throttle.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+using namespace std::literals;
+
+using throttle = ozo::detail::connect_throttle<std::mutex>;
+
+struct connect_throttle : Test {
+    boost::asio::io_context io;
+    std::vector<ozo::error_code> results;
+
+    auto handler() {
+        return [this] (ozo::error_code ec) { results.push_back(ec); };
+    }
+};
+
+TEST_F(connect_throttle, should_be_disabled_with_zero_limit_and_backoff) {
+    EXPECT_FALSE(throttle(0, 0s, 0s).enabled());
+    EXPECT_TRUE(throttle(1, 0s, 0s).enabled());
+    EXPECT_TRUE(throttle(0, 1s, 0s).enabled());
+}
+
+TEST_F(connect_throttle, should_grant_attempts_up_to_limit) {
+    throttle t(2, 0s, 0s);
+    t.async_acquire(io.get_executor(), ozo::none, handler());
+    t.async_acquire(io.get_executor(), ozo::none, handler());
+    t.async_acquire(io.get_executor(), ozo::none, handler());
+    io.run();
+    io.restart();
+
+    EXPECT_THAT(results, ElementsAre(ozo::error_code{}, ozo::error_code{}));
+    EXPECT_EQ(t.active(), 2u);
+    EXPECT_EQ(t.waiting(), 1u);
+
+    t.release(true);
+    io.run();
+
+    EXPECT_THAT(results, ElementsAre(ozo::error_code{}, ozo::error_code{}, ozo::error_code{}));
+    EXPECT_EQ(t.active(), 2u);
+    EXPECT_EQ(t.waiting(), 0u);
+}
+
+TEST_F(connect_throttle, should_complete_waiting_request_with_timed_out_on_deadline) {
+    throttle t(1, 0s, 0s);
+    t.async_acquire(io.get_executor(), ozo::none, handler());
+    t.async_acquire(io.get_executor(), ozo::deadline(10ms), handler());
+    io.run();
+
+    EXPECT_THAT(results, ElementsAre(ozo::error_code{}, ozo::error_code{boost::asio::error::timed_out}));
+    EXPECT_EQ(t.waiting(), 0u);
+
+    t.release(true);
+    EXPECT_EQ(t.active(), 0u);
+}
+
+TEST_F(connect_throttle, should_delay_attempts_after_failure) {
+    throttle t(0, 50ms, 1s);
+    t.async_acquire(io.get_executor(), ozo::none, handler());
+    io.run();
+    io.restart();
+    t.release(false);
+
+    const auto start = ozo::time_traits::now();
+    t.async_acquire(io.get_executor(), ozo::none, handler());
+    io.run();
+
+    EXPECT_GE(ozo::time_traits::now() - start, 50ms);
+    EXPECT_THAT(results, ElementsAre(ozo::error_code{}, ozo::error_code{}));
+}
+
+TEST_F(connect_throttle, should_not_delay_attempts_after_success) {
+    throttle t(0, 1s, 1s);
+    t.async_acquire(io.get_executor(), ozo::none, handler());
+    io.run();
+    io.restart();
+    t.release(true);
+
+    const auto start = ozo::time_traits::now();
+    t.async_acquire(io.get_executor(), ozo::none, handler());
+    io.run();
+
+    EXPECT_LT(ozo::time_traits::now() - start, 1s);
+    EXPECT_THAT(results, ElementsAre(ozo::error_code{}, ozo::error_code{}));
+}
+
+} // namespace
@@ -0,0 +1,507 @@
+#include <ozo/detail/connection_pool.h>
+
+#include <boost/asio/io_context.hpp>
+
+#include <array>
+#include <set>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+
+struct pool_stats {
+    std::size_t size = 0;
+    std::size_t available = 0;
+    std::size_t used = 0;
+    std::size_t wait_queue_size = 0;
+};
+
+struct pool_stub {
+    std::size_t capacity_;
+    std::size_t queue_capacity_;
+    std::chrono::seconds idle_timeout_;
+    std::size_t size_ = 0;
+    std::size_t available_ = 0;
+    std::size_t waiting_ = 0;
+
+    pool_stub(std::size_t capacity, std::size_t queue_capacity, std::chrono::seconds idle_timeout)
+    : capacity_(capacity), queue_capacity_(queue_capacity), idle_timeout_(idle_timeout) {}
+
+    std::size_t capacity() const noexcept { return capacity_;}
+    std::size_t size() const noexcept { return size_;}
+    std::size_t available() const noexcept { return available_;}
+    pool_stats stats() const noexcept { return {size_, available_, size_ - available_, waiting_};}
+};
+
+using shards = ozo::detail::connection_pool_shards<pool_stub>;
+
+TEST(connection_pool_shards, should_split_capacity_and_queue_capacity_between_shards) {
+    shards pool(3, 10, 4, std::chrono::seconds(1));
+    ASSERT_EQ(pool.size(), 3u);
+    EXPECT_EQ(pool[0].capacity_, 4u);
+    EXPECT_EQ(pool[1].capacity_, 3u);
+    EXPECT_EQ(pool[2].capacity_, 3u);
+    EXPECT_EQ(pool[0].queue_capacity_, 2u);
+    EXPECT_EQ(pool[1].queue_capacity_, 1u);
+    EXPECT_EQ(pool[2].queue_capacity_, 1u);
+    EXPECT_EQ(pool[2].idle_timeout_, std::chrono::seconds(1));
+}
+
+TEST(connection_pool_shards, should_not_create_more_shards_than_capacity) {
+    shards pool(8, 2, 0, std::chrono::seconds(1));
+    EXPECT_EQ(pool.size(), 2u);
+}
+
+TEST(connection_pool_shards, should_create_single_shard_for_zero_shards) {
+    shards pool(0, 2, 0, std::chrono::seconds(1));
+    EXPECT_EQ(pool.size(), 1u);
+}
+
+TEST(connection_pool_shards, index_should_return_the_same_shard_for_the_same_io_context) {
+    shards pool(4, 4, 0, std::chrono::seconds(1));
+    boost::asio::io_context io;
+    EXPECT_EQ(pool.index(io), pool.index(io));
+}
+
+TEST(connection_pool_shards, index_should_return_distinct_shards_for_io_contexts_while_there_are_free_shards) {
+    shards pool(4, 4, 0, std::chrono::seconds(1));
+    std::array<boost::asio::io_context, 4> io;
+    std::set<std::size_t> indexes;
+    for (auto& v : io) {
+        indexes.insert(pool.index(v));
+    }
+    EXPECT_THAT(indexes, ElementsAre(0u, 1u, 2u, 3u));
+}
+
+TEST(connection_pool_shards, index_should_return_valid_shard_if_there_are_no_free_shards) {
+    shards pool(2, 2, 0, std::chrono::seconds(1));
+    std::array<boost::asio::io_context, 3> io;
+    for (auto& v : io) {
+        EXPECT_LT(pool.index(v), 2u);
+    }
+}
+
+TEST(connection_pool_shards, get_should_return_own_shard_if_it_has_room_for_connection) {
+    shards pool(2, 4, 0, std::chrono::seconds(1));
+    boost::asio::io_context io;
+    const auto own = pool.index(io);
+    pool[1 - own].available_ = 1;
+    pool[1 - own].size_ = 1;
+    EXPECT_EQ(std::addressof(pool.get(io)), std::addressof(pool[own]));
+}
+
+TEST(connection_pool_shards, get_should_return_shard_with_available_connection_if_own_shard_is_exhausted) {
+    shards pool(2, 4, 0, std::chrono::seconds(1));
+    boost::asio::io_context io;
+    const auto own = pool.index(io);
+    pool[own].size_ = 2;
+    pool[1 - own].size_ = 1;
+    pool[1 - own].available_ = 1;
+    EXPECT_EQ(std::addressof(pool.get(io)), std::addressof(pool[1 - own]));
+}
+
+TEST(connection_pool_shards, get_should_return_own_shard_if_all_shards_are_exhausted) {
+    shards pool(2, 4, 0, std::chrono::seconds(1));
+    boost::asio::io_context io;
+    const auto own = pool.index(io);
+    pool[own].size_ = 2;
+    pool[1 - own].size_ = 2;
+    EXPECT_EQ(std::addressof(pool.get(io)), std::addressof(pool[own]));
+}
+
+TEST(connection_pool_shards, bind_should_make_index_return_bound_shard) {
+    shards pool(4, 4, 0, std::chrono::seconds(1));
+    std::array<boost::asio::io_context, 4> io;
+    for (std::size_t i = 0; i < io.size(); ++i) {
+        EXPECT_TRUE(pool.bind(io[i], 3 - i));
+    }
+    for (std::size_t i = 0; i < io.size(); ++i) {
+        EXPECT_EQ(pool.index(io[i]), 3 - i);
+    }
+}
+
+TEST(connection_pool_shards, bind_should_fail_for_shard_bound_to_other_io_context) {
+    shards pool(2, 2, 0, std::chrono::seconds(1));
+    std::array<boost::asio::io_context, 2> io;
+    EXPECT_TRUE(pool.bind(io[0], 1));
+    EXPECT_TRUE(pool.bind(io[0], 1));
+    EXPECT_FALSE(pool.bind(io[1], 1));
+}
+
+TEST(connection_pool_shards, select_should_prefer_nearest_shard_with_available_connection) {
+    shards pool(5, 10, 0, std::chrono::seconds(1));
+    std::array<boost::asio::io_context, 5> io;
+    for (std::size_t i = 0; i < io.size(); ++i) {
+        pool.bind(io[i], i);
+    }
+    for (std::size_t i = 0; i < io.size(); ++i) {
+        pool[i].size_ = 2;
+    }
+    pool[2].available_ = 1;
+    pool[4].available_ = 1;
+    EXPECT_EQ(pool.select(io[0]), 4u);
+    EXPECT_EQ(pool.select(io[1]), 2u);
+    EXPECT_EQ(pool.select(io[3]), 4u);
+}
+
+TEST(connection_pool_shards, stats_should_return_sum_of_shards_stats) {
+    shards pool(2, 4, 0, std::chrono::seconds(1));
+    pool[0].size_ = 2;
+    pool[0].available_ = 1;
+    pool[1].size_ = 1;
+    const auto stats = pool.stats();
+    EXPECT_EQ(stats.size, 3u);
+    EXPECT_EQ(stats.available, 1u);
+    EXPECT_EQ(stats.used, 2u);
+}
+
+struct rep_stub {
+    std::size_t requests_ = 0;
+    bool recycle_requested_ = false;
+
+    std::size_t requests() const noexcept { return requests_;}
+    bool recycle_requested() const noexcept { return recycle_requested_;}
+};
+
+TEST(connection_lifespan, recycle_due_should_return_false_without_max_requests) {
+    const ozo::detail::connection_lifespan lifespan;
+    EXPECT_FALSE(lifespan.recycle_due(rep_stub{1000000}));
+}
+
+TEST(connection_lifespan, recycle_due_should_return_true_once_max_requests_are_served) {
+    ozo::detail::connection_lifespan lifespan;
+    lifespan.max_requests = 100;
+    EXPECT_FALSE(lifespan.recycle_due(rep_stub{99}));
+    EXPECT_TRUE(lifespan.recycle_due(rep_stub{100}));
+}
+
+TEST(connection_lifespan, recycle_due_should_return_true_for_requested_recycle) {
+    const ozo::detail::connection_lifespan lifespan;
+    EXPECT_TRUE(lifespan.recycle_due(rep_stub{0, true}));
+}
+
+TEST(connection_lifespan, recycle_ahead_due_should_return_true_after_nine_tenths_of_max_requests) {
+    ozo::detail::connection_lifespan lifespan;
+    lifespan.max_requests = 100;
+    EXPECT_FALSE(lifespan.recycle_ahead_due(rep_stub{89}));
+    EXPECT_TRUE(lifespan.recycle_ahead_due(rep_stub{90}));
+}
+
+TEST(connection_lifespan, memory_check_due_should_return_true_after_interval_if_threshold_is_set) {
+    ozo::detail::connection_lifespan lifespan;
+    const auto now = ozo::time_traits::now();
+    lifespan.memory_check_interval = std::chrono::minutes(1);
+    EXPECT_FALSE(lifespan.memory_check_due(now - std::chrono::hours(1), now));
+    lifespan.max_backend_memory = 1024;
+    EXPECT_FALSE(lifespan.memory_check_due(now - std::chrono::seconds(59), now));
+    EXPECT_TRUE(lifespan.memory_check_due(now - std::chrono::minutes(1), now));
+}
+
+TEST(connection_lifespan, expires_at_should_return_now_plus_lifespan_without_jitter) {
+    const ozo::detail::connection_lifespan lifespan {std::chrono::hours(1)};
+    const auto now = ozo::time_traits::now();
+    EXPECT_EQ(lifespan.expires_at(now), now + std::chrono::hours(1));
+}
+
+TEST(connection_lifespan, expires_at_should_reduce_lifespan_by_no_more_than_jitter) {
+    const ozo::detail::connection_lifespan lifespan {std::chrono::hours(1), std::chrono::minutes(10)};
+    const auto now = ozo::time_traits::now();
+    std::set<ozo::time_traits::time_point> values;
+    for (int i = 0; i < 100; ++i) {
+        const auto v = lifespan.expires_at(now);
+        EXPECT_LE(v, now + std::chrono::hours(1));
+        EXPECT_GE(v, now + std::chrono::minutes(50));
+        values.insert(v);
+    }
+    EXPECT_GT(values.size(), 1u);
+}
+
+TEST(connection_lifespan, expires_at_should_return_max_for_max_lifespan) {
+    const ozo::detail::connection_lifespan lifespan;
+    EXPECT_EQ(lifespan.expires_at(ozo::time_traits::now()), ozo::time_traits::time_point::max());
+}
+
+TEST(connection_lifespan, refresh_due_should_return_true_within_refresh_ahead_before_expiration) {
+    const ozo::detail::connection_lifespan lifespan {std::chrono::hours(1), {}, std::chrono::minutes(5)};
+    const auto now = ozo::time_traits::now();
+    EXPECT_FALSE(lifespan.refresh_due(now + std::chrono::minutes(6), now));
+    EXPECT_TRUE(lifespan.refresh_due(now + std::chrono::minutes(5), now));
+    EXPECT_FALSE(lifespan.refresh_due(ozo::time_traits::time_point::max(), now));
+}
+
+TEST(connection_lifespan, refresh_due_should_return_false_if_refresh_is_disabled) {
+    const ozo::detail::connection_lifespan lifespan {std::chrono::hours(1)};
+    const auto now = ozo::time_traits::now();
+    EXPECT_FALSE(lifespan.refresh_due(now, now));
+}
+
+struct registered_stream : Test {
+    boost::asio::io_context io;
+    std::array<int, 2> fds {-1, -1};
+
+    void SetUp() override { ASSERT_EQ(::pipe(fds.data()), 0);}
+
+    void TearDown() override {
+        for (auto fd : fds) {
+            ::close(fd);
+        }
+    }
+
+    static bool is_open(int fd) { return ::fcntl(fd, F_GETFD) != -1;}
+};
+
+TEST_F(registered_stream, take_should_return_stream_registered_with_the_same_context) {
+    ozo::detail::registered_stream stream;
+    stream.put(boost::asio::posix::stream_descriptor(io, fds[0]));
+    auto result = stream.take(io, fds[0]);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result->native_handle(), fds[0]);
+    EXPECT_TRUE(stream.empty());
+    result->release();
+}
+
+TEST_F(registered_stream, take_should_release_stream_registered_with_another_context) {
+    boost::asio::io_context other;
+    ozo::detail::registered_stream stream;
+    stream.put(boost::asio::posix::stream_descriptor(other, fds[0]));
+    EXPECT_FALSE(stream.take(io, fds[0]));
+    EXPECT_TRUE(stream.empty());
+    EXPECT_TRUE(is_open(fds[0]));
+}
+
+TEST_F(registered_stream, take_should_release_stream_of_another_descriptor) {
+    ozo::detail::registered_stream stream;
+    stream.put(boost::asio::posix::stream_descriptor(io, fds[0]));
+    EXPECT_FALSE(stream.take(io, fds[1]));
+    EXPECT_TRUE(is_open(fds[0]));
+}
+
+TEST_F(registered_stream, should_release_descriptor_on_destruction_without_closing) {
+    {
+        ozo::detail::registered_stream stream;
+        stream.put(boost::asio::posix::stream_descriptor(io, fds[0]));
+    }
+    EXPECT_TRUE(is_open(fds[0]));
+}
+
+TEST(capacity_adapter, next_should_grow_capacity_by_quarter_if_requests_are_waiting) {
+    const ozo::detail::capacity_adapter adapter {1, 100, std::chrono::milliseconds(5)};
+    EXPECT_EQ(adapter.next(8, std::chrono::milliseconds(0), 1, 8), 10u);
+    EXPECT_EQ(adapter.next(2, std::chrono::milliseconds(0), 1, 2), 3u);
+}
+
+TEST(capacity_adapter, next_should_grow_capacity_if_wait_time_exceeds_target) {
+    const ozo::detail::capacity_adapter adapter {1, 100, std::chrono::milliseconds(5)};
+    EXPECT_EQ(adapter.next(8, std::chrono::milliseconds(8), 0, 8), 10u);
+}
+
+TEST(capacity_adapter, next_should_shrink_capacity_by_one_if_less_than_half_is_used_at_peak) {
+    const ozo::detail::capacity_adapter adapter {1, 100, std::chrono::milliseconds(5)};
+    EXPECT_EQ(adapter.next(8, std::chrono::milliseconds(0), 0, 3), 7u);
+    EXPECT_EQ(adapter.next(8, std::chrono::milliseconds(0), 0, 4), 8u);
+}
+
+TEST(capacity_adapter, next_should_keep_capacity_within_bounds) {
+    const ozo::detail::capacity_adapter adapter {4, 10, std::chrono::milliseconds(5)};
+    EXPECT_EQ(adapter.next(9, std::chrono::milliseconds(0), 1, 9), 10u);
+    EXPECT_EQ(adapter.next(4, std::chrono::milliseconds(0), 0, 0), 4u);
+}
+
+struct handle_stub {
+    int id = 0;
+    std::vector<int>* wasted = nullptr;
+
+    bool empty() const noexcept { return id == 0;}
+    void waste() { wasted->push_back(id); id = 0;}
+};
+
+struct idle_stack : Test {
+    using stack_type = ozo::detail::idle_stack<handle_stub, std::mutex>;
+
+    pool_stub pool {1, 1, std::chrono::seconds(1)};
+    stack_type stack {pool, std::chrono::seconds(10)};
+    std::vector<int> wasted;
+    const ozo::time_traits::time_point now = ozo::time_traits::now();
+
+    handle_stub make_handle(int id) { return handle_stub {id, &wasted};}
+
+    handle_stub pop(ozo::time_traits::time_point at, bool* requested = nullptr) {
+        return stack.pop_or(at, [&] { if (requested) { *requested = true;} });
+    }
+};
+
+TEST_F(idle_stack, pop_or_should_return_most_recently_pushed_handle) {
+    auto first = make_handle(1);
+    auto second = make_handle(2);
+    ASSERT_TRUE(stack.push(first, now));
+    ASSERT_TRUE(stack.push(second, now));
+    EXPECT_EQ(pop(now).id, 2);
+    EXPECT_EQ(pop(now).id, 1);
+}
+
+TEST_F(idle_stack, pop_or_should_request_pool_and_return_empty_handle_if_stack_is_empty) {
+    bool requested = false;
+    EXPECT_TRUE(pop(now, &requested).empty());
+    EXPECT_TRUE(requested);
+}
+
+TEST_F(idle_stack, pop_or_should_not_request_pool_if_stack_has_handle) {
+    auto handle = make_handle(1);
+    stack.push(handle, now);
+    bool requested = false;
+    EXPECT_EQ(pop(now, &requested).id, 1);
+    EXPECT_FALSE(requested);
+}
+
+TEST_F(idle_stack, should_waste_handles_idle_for_idle_timeout) {
+    auto first = make_handle(1);
+    auto second = make_handle(2);
+    stack.push(first, now);
+    stack.push(second, now + std::chrono::seconds(5));
+    bool requested = false;
+    EXPECT_EQ(pop(now + std::chrono::seconds(10), &requested).id, 2);
+    EXPECT_THAT(wasted, ElementsAre(1));
+    EXPECT_FALSE(requested);
+}
+
+TEST_F(idle_stack, push_should_not_take_handle_if_pool_has_waiting_requests) {
+    pool.waiting_ = 1;
+    auto handle = make_handle(1);
+    EXPECT_FALSE(stack.push(handle, now));
+    EXPECT_EQ(handle.id, 1);
+    EXPECT_EQ(stack.size(), 0u);
+}
+
+TEST_F(idle_stack, push_should_not_take_handle_after_shutdown) {
+    auto first = make_handle(1);
+    stack.push(first, now);
+    stack.shutdown();
+    EXPECT_EQ(stack.size(), 0u);
+    auto second = make_handle(2);
+    EXPECT_FALSE(stack.push(second, now));
+    EXPECT_TRUE(wasted.empty());
+}
+
+TEST_F(idle_stack, flush_should_release_all_handles) {
+    auto first = make_handle(1);
+    auto second = make_handle(2);
+    stack.push(first, now);
+    stack.push(second, now);
+    stack.flush();
+    EXPECT_EQ(stack.size(), 0u);
+    EXPECT_TRUE(wasted.empty());
+}
+
+struct handoff_waiter_stub : ozo::detail::handoff_waiter<handle_stub> {
+    bool waiting = false;
+    bool requested = false;
+    int handed = 0;
+
+    using ozo::detail::handoff_waiter<handle_stub>::handoff_waiter;
+
+    void wait() override { waiting = true;}
+    void complete(handle_stub&& handle) override { handed = handle.id;}
+    void request() override { requested = true;}
+};
+
+struct idle_stack_handoff : idle_stack {
+    stack_type handoff_stack {pool, std::chrono::seconds(10), 2};
+
+    idle_stack_handoff() {
+        pool.size_ = 1;
+    }
+
+    std::shared_ptr<handoff_waiter_stub> make_waiter(ozo::time_traits::duration timeout) {
+        return std::make_shared<handoff_waiter_stub>(now + timeout);
+    }
+};
+
+TEST_F(idle_stack_handoff, pop_or_wait_should_keep_waiter_if_pool_is_exhausted) {
+    auto waiter = make_waiter(std::chrono::seconds(1));
+    const auto [handle, waiting] = handoff_stack.pop_or_wait(now, waiter);
+    EXPECT_TRUE(handle.empty());
+    EXPECT_TRUE(waiting);
+    EXPECT_TRUE(waiter->waiting);
+    EXPECT_FALSE(waiter->requested);
+    EXPECT_EQ(handoff_stack.waiting(), 1u);
+}
+
+TEST_F(idle_stack_handoff, pop_or_wait_should_request_pool_if_pool_has_room_for_connection) {
+    pool.size_ = 0;
+    auto waiter = make_waiter(std::chrono::seconds(1));
+    const auto [handle, waiting] = handoff_stack.pop_or_wait(now, waiter);
+    EXPECT_FALSE(waiting);
+    EXPECT_TRUE(waiter->requested);
+    EXPECT_EQ(handoff_stack.waiting(), 0u);
+}
+
+TEST_F(idle_stack_handoff, pop_or_wait_should_request_pool_if_waiters_limit_is_reached) {
+    handoff_stack.pop_or_wait(now, make_waiter(std::chrono::seconds(1)));
+    handoff_stack.pop_or_wait(now, make_waiter(std::chrono::seconds(1)));
+    auto waiter = make_waiter(std::chrono::seconds(1));
+    EXPECT_FALSE(handoff_stack.pop_or_wait(now, waiter).second);
+    EXPECT_TRUE(waiter->requested);
+}
+
+TEST_F(idle_stack_handoff, pop_or_wait_should_return_handle_from_stack) {
+    auto handle = make_handle(1);
+    handoff_stack.push(handle, now);
+    auto waiter = make_waiter(std::chrono::seconds(1));
+    const auto [result, waiting] = handoff_stack.pop_or_wait(now, waiter);
+    EXPECT_EQ(result.id, 1);
+    EXPECT_FALSE(waiting);
+    EXPECT_FALSE(waiter->requested);
+}
+
+TEST_F(idle_stack_handoff, push_should_hand_handle_to_waiter_with_earliest_deadline) {
+    auto late = make_waiter(std::chrono::seconds(2));
+    auto early = make_waiter(std::chrono::seconds(1));
+    handoff_stack.pop_or_wait(now, late);
+    handoff_stack.pop_or_wait(now, early);
+    auto handle = make_handle(1);
+    EXPECT_TRUE(handoff_stack.push(handle, now));
+    EXPECT_EQ(early->handed, 1);
+    EXPECT_EQ(late->handed, 0);
+    EXPECT_EQ(handoff_stack.size(), 0u);
+    EXPECT_EQ(handoff_stack.waiting(), 1u);
+}
+
+TEST_F(idle_stack_handoff, push_should_hand_handle_to_waiter_even_if_pool_has_waiting_requests) {
+    auto waiter = make_waiter(std::chrono::seconds(1));
+    handoff_stack.pop_or_wait(now, waiter);
+    pool.waiting_ = 1;
+    auto handle = make_handle(1);
+    EXPECT_TRUE(handoff_stack.push(handle, now));
+    EXPECT_EQ(waiter->handed, 1);
+}
+
+TEST_F(idle_stack_handoff, cancel_should_remove_waiting_waiter_only) {
+    auto waiter = make_waiter(std::chrono::seconds(1));
+    handoff_stack.pop_or_wait(now, waiter);
+    EXPECT_TRUE(handoff_stack.cancel(waiter.get()));
+    EXPECT_FALSE(handoff_stack.cancel(waiter.get()));
+    EXPECT_EQ(handoff_stack.waiting(), 0u);
+}
+
+TEST_F(idle_stack_handoff, wake_should_pass_waiters_to_pool) {
+    auto waiter = make_waiter(std::chrono::seconds(1));
+    handoff_stack.pop_or_wait(now, waiter);
+    handoff_stack.wake();
+    EXPECT_TRUE(waiter->requested);
+    EXPECT_EQ(handoff_stack.waiting(), 0u);
+}
+
+TEST_F(idle_stack_handoff, shutdown_should_pass_waiters_to_pool) {
+    auto waiter = make_waiter(std::chrono::seconds(1));
+    handoff_stack.pop_or_wait(now, waiter);
+    handoff_stack.shutdown();
+    EXPECT_TRUE(waiter->requested);
+}
+
+} // namespace
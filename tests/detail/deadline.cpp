@@ -60,4 +60,68 @@ TEST_F(io_deadline_handler, should_cancel_timer_and_call_handler_with_error_and_
     on_timer_expired(boost::asio::error::operation_aborted);
 }
 
+struct server_cancel_mock {
+    MOCK_METHOD1(call, bool(stream_mock&));
+};
+
+struct server_cancel {
+    server_cancel_mock* mock_ = nullptr;
+
+    bool operator() (stream_mock& stream) const { return mock_->call(stream);}
+};
+
+struct io_deadline_handler_with_server_cancel : io_deadline_handler {
+    StrictMock<server_cancel_mock> cancel;
+    std::function<void (ozo::error_code)> on_grace_expired;
+
+    using deadline_handler = ozo::detail::io_deadline_handler<stream_mock,
+        std::decay_t<decltype(ozo::tests::wrap(continuation))>, int, server_cancel>;
+
+    auto make_handler() {
+        using ozo::tests::wrap;
+        return deadline_handler{stream, time_point{}, wrap(continuation), server_cancel{&cancel}, 100ms};
+    }
+};
+
+TEST_F(io_deadline_handler_with_server_cancel, should_send_server_cancel_and_call_handler_with_timeout_error_and_result_on_completion_within_grace_period) {
+    auto handler = make_handler();
+    EXPECT_CALL(continuation_executor, post(_)).WillRepeatedly(InvokeArgument<0>());
+    EXPECT_CALL(cancel, call(Ref(stream))).WillOnce(Return(true));
+    EXPECT_CALL(io.timer_service_, timer(An<duration>())).WillOnce(ReturnRef(timer));
+    EXPECT_CALL(timer, async_wait(_)).WillOnce(SaveArg<0>(&on_grace_expired));
+    on_timer_expired(ozo::error_code{});
+
+    EXPECT_CALL(timer, cancel()).Times(2);
+    handler(ozo::tests::error::error, 42);
+
+    EXPECT_CALL(continuation, call(Eq(boost::asio::error::timed_out), 42));
+    on_grace_expired(boost::asio::error::operation_aborted);
+}
+
+TEST_F(io_deadline_handler_with_server_cancel, should_cancel_stream_io_on_grace_period_expired) {
+    auto handler = make_handler();
+    EXPECT_CALL(continuation_executor, post(_)).WillRepeatedly(InvokeArgument<0>());
+    EXPECT_CALL(cancel, call(Ref(stream))).WillOnce(Return(true));
+    EXPECT_CALL(io.timer_service_, timer(An<duration>())).WillOnce(ReturnRef(timer));
+    EXPECT_CALL(timer, async_wait(_)).WillOnce(SaveArg<0>(&on_grace_expired));
+    on_timer_expired(ozo::error_code{});
+
+    EXPECT_CALL(stream, cancel());
+    on_grace_expired(ozo::error_code{});
+
+    EXPECT_CALL(continuation, call(Eq(boost::asio::error::timed_out), 42));
+    handler(boost::asio::error::operation_aborted, 42);
+}
+
+TEST_F(io_deadline_handler_with_server_cancel, should_cancel_stream_io_if_server_cancel_fails) {
+    auto handler = make_handler();
+    InSequence s;
+    EXPECT_CALL(continuation_executor, post(_)).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(cancel, call(Ref(stream))).WillOnce(Return(false));
+    EXPECT_CALL(stream, cancel());
+    EXPECT_CALL(continuation, call(Eq(boost::asio::error::timed_out), 42));
+    on_timer_expired(ozo::error_code{});
+    handler(boost::asio::error::operation_aborted, 42);
+}
+
 } // namespace
@@ -0,0 +1,283 @@
+#include <ozo/detail/deadline_queue.h>
+#include <ozo/deadline.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+using namespace std::literals;
+
+using queue = ozo::detail::deadline_queue<std::mutex>;
+using slot_type = queue::slot_type;
+
+struct deadline_queue : Test {
+    boost::asio::io_context io;
+    std::vector<std::pair<int, ozo::error_code>> results;
+    std::vector<slot_type> slots;
+
+    auto handler(int id) {
+        return [this, id] (ozo::error_code ec, slot_type slot) {
+            results.emplace_back(id, ec);
+            if (!ec) {
+                slots.push_back(std::move(slot));
+            }
+        };
+    }
+};
+
+TEST_F(deadline_queue, should_admit_requests_up_to_limit) {
+    auto q = std::make_shared<queue>(2, 8);
+    q->async_acquire(io.get_executor(), ozo::none, handler(1));
+    q->async_acquire(io.get_executor(), ozo::none, handler(2));
+    q->async_acquire(io.get_executor(), ozo::none, handler(3));
+    io.run();
+
+    EXPECT_THAT(results, ElementsAre(Pair(1, ozo::error_code{}), Pair(2, ozo::error_code{})));
+    EXPECT_EQ(q->active(), 2u);
+    EXPECT_EQ(q->waiting(), 1u);
+    q->shutdown();
+}
+
+TEST_F(deadline_queue, should_admit_waiting_request_with_earliest_deadline_first) {
+    auto q = std::make_shared<queue>(1, 8);
+    q->async_acquire(io.get_executor(), ozo::none, handler(1));
+    q->async_acquire(io.get_executor(), ozo::none, handler(2));
+    q->async_acquire(io.get_executor(), ozo::deadline(1h), handler(3));
+    q->async_acquire(io.get_executor(), ozo::deadline(1min), handler(4));
+    io.poll();
+    io.restart();
+    ASSERT_EQ(slots.size(), 1u);
+
+    for (int i = 0; i < 3; ++i) {
+        slots.clear();
+        io.poll();
+        io.restart();
+    }
+
+    EXPECT_THAT(results, ElementsAre(Pair(1, ozo::error_code{}), Pair(4, ozo::error_code{}),
+        Pair(3, ozo::error_code{}), Pair(2, ozo::error_code{})));
+    EXPECT_EQ(q->waiting(), 0u);
+    slots.clear();
+    io.run();
+    EXPECT_EQ(q->active(), 0u);
+}
+
+TEST_F(deadline_queue, should_complete_waiting_request_with_get_resource_timeout_on_deadline) {
+    auto q = std::make_shared<queue>(1, 8);
+    q->async_acquire(io.get_executor(), ozo::none, handler(1));
+    q->async_acquire(io.get_executor(), ozo::deadline(10ms), handler(2));
+    io.run();
+
+    EXPECT_THAT(results, ElementsAre(Pair(1, ozo::error_code{}),
+        Pair(2, ozo::error_code{yamail::resource_pool::error::get_resource_timeout})));
+    EXPECT_EQ(q->waiting(), 0u);
+
+    slots.clear();
+    EXPECT_EQ(q->active(), 0u);
+}
+
+TEST_F(deadline_queue, should_not_admit_request_with_expired_deadline) {
+    auto q = std::make_shared<queue>(1, 8);
+    q->async_acquire(io.get_executor(), ozo::time_traits::now() - 1s, handler(1));
+    io.run();
+
+    EXPECT_THAT(results, ElementsAre(Pair(1, ozo::error_code{yamail::resource_pool::error::get_resource_timeout})));
+    EXPECT_EQ(q->active(), 0u);
+}
+
+TEST_F(deadline_queue, should_complete_request_with_request_queue_overflow_if_queue_is_full) {
+    auto q = std::make_shared<queue>(1, 1);
+    q->async_acquire(io.get_executor(), ozo::none, handler(1));
+    q->async_acquire(io.get_executor(), ozo::none, handler(2));
+    q->async_acquire(io.get_executor(), ozo::none, handler(3));
+    io.poll();
+
+    EXPECT_THAT(results, ElementsAre(Pair(1, ozo::error_code{}),
+        Pair(3, ozo::error_code{yamail::resource_pool::error::request_queue_overflow})));
+    q->shutdown();
+}
+
+TEST_F(deadline_queue, should_complete_waiting_requests_with_operation_aborted_on_shutdown) {
+    auto q = std::make_shared<queue>(1, 8);
+    q->async_acquire(io.get_executor(), ozo::none, handler(1));
+    q->async_acquire(io.get_executor(), ozo::none, handler(2));
+    q->shutdown();
+    io.run();
+
+    EXPECT_THAT(results, ElementsAre(Pair(1, ozo::error_code{}),
+        Pair(2, ozo::error_code{boost::asio::error::operation_aborted})));
+}
+
+TEST_F(deadline_queue, should_admit_waiting_request_of_higher_priority_first) {
+    auto q = std::make_shared<queue>(1, std::vector<ozo::detail::deadline_queue_class>{{8, 0}, {8, 0}});
+    q->async_acquire(io.get_executor(), ozo::none, handler(1), 1);
+    q->async_acquire(io.get_executor(), ozo::none, handler(2), 1);
+    q->async_acquire(io.get_executor(), ozo::none, handler(3), 0);
+    io.poll();
+    io.restart();
+
+    for (int i = 0; i < 2; ++i) {
+        slots.clear();
+        io.poll();
+        io.restart();
+    }
+
+    EXPECT_THAT(results, ElementsAre(Pair(1, ozo::error_code{}), Pair(3, ozo::error_code{}),
+        Pair(2, ozo::error_code{})));
+}
+
+TEST_F(deadline_queue, should_admit_request_to_reserved_room_of_its_class) {
+    auto q = std::make_shared<queue>(2, std::vector<ozo::detail::deadline_queue_class>{{8, 1}, {8, 0}});
+    q->async_acquire(io.get_executor(), ozo::none, handler(1), 1);
+    q->async_acquire(io.get_executor(), ozo::none, handler(2), 1);
+    q->async_acquire(io.get_executor(), ozo::none, handler(3), 0);
+    io.poll();
+
+    EXPECT_THAT(results, ElementsAre(Pair(1, ozo::error_code{}), Pair(3, ozo::error_code{})));
+    EXPECT_EQ(q->waiting(1), 1u);
+    EXPECT_EQ(q->active(0), 1u);
+    q->shutdown();
+}
+
+TEST_F(deadline_queue, should_limit_queue_of_each_class_separately) {
+    auto q = std::make_shared<queue>(1, std::vector<ozo::detail::deadline_queue_class>{{1, 0}, {1, 0}});
+    q->async_acquire(io.get_executor(), ozo::none, handler(1), 1);
+    q->async_acquire(io.get_executor(), ozo::none, handler(2), 1);
+    q->async_acquire(io.get_executor(), ozo::none, handler(3), 1);
+    q->async_acquire(io.get_executor(), ozo::none, handler(4), 0);
+    io.poll();
+
+    EXPECT_THAT(results, ElementsAre(Pair(1, ozo::error_code{}),
+        Pair(3, ozo::error_code{yamail::resource_pool::error::request_queue_overflow})));
+    EXPECT_EQ(q->waiting(0), 1u);
+    EXPECT_EQ(q->waiting(1), 1u);
+    q->shutdown();
+}
+
+TEST_F(deadline_queue, should_keep_arrival_order_if_ordering_by_deadline_is_disabled) {
+    auto q = std::make_shared<queue>(1, std::vector<ozo::detail::deadline_queue_class>{{8, 0}}, false);
+    q->async_acquire(io.get_executor(), ozo::none, handler(1));
+    q->async_acquire(io.get_executor(), ozo::deadline(1h), handler(2));
+    q->async_acquire(io.get_executor(), ozo::deadline(1min), handler(3));
+    io.poll();
+    io.restart();
+
+    for (int i = 0; i < 2; ++i) {
+        slots.clear();
+        io.poll();
+        io.restart();
+    }
+
+    EXPECT_THAT(results, ElementsAre(Pair(1, ozo::error_code{}), Pair(2, ozo::error_code{}),
+        Pair(3, ozo::error_code{})));
+    slots.clear();
+    io.run();
+}
+
+TEST_F(deadline_queue, set_limit_should_admit_waiting_requests_if_limit_grows) {
+    auto q = std::make_shared<queue>(1, 8);
+    q->async_acquire(io.get_executor(), ozo::none, handler(1));
+    q->async_acquire(io.get_executor(), ozo::none, handler(2));
+    q->async_acquire(io.get_executor(), ozo::none, handler(3));
+    io.poll();
+    io.restart();
+    ASSERT_EQ(q->waiting(), 2u);
+
+    q->set_limit(2);
+    io.poll();
+    io.restart();
+
+    EXPECT_EQ(q->limit(), 2u);
+    EXPECT_THAT(results, ElementsAre(Pair(1, ozo::error_code{}), Pair(2, ozo::error_code{})));
+    EXPECT_EQ(q->waiting(), 1u);
+    q->shutdown();
+    io.run();
+}
+
+TEST_F(deadline_queue, set_limit_should_not_admit_requests_beyond_reduced_limit) {
+    auto q = std::make_shared<queue>(2, 8);
+    q->async_acquire(io.get_executor(), ozo::none, handler(1));
+    q->async_acquire(io.get_executor(), ozo::none, handler(2));
+    io.poll();
+    io.restart();
+
+    q->set_limit(1);
+    q->async_acquire(io.get_executor(), ozo::none, handler(3));
+    slots.pop_back();
+    io.poll();
+    io.restart();
+
+    EXPECT_EQ(q->active(), 1u);
+    EXPECT_EQ(q->waiting(), 1u);
+    slots.clear();
+    io.run();
+    EXPECT_EQ(results.size(), 3u);
+}
+
+TEST_F(deadline_queue, take_peak_should_return_maximum_of_active_requests_since_previous_call) {
+    auto q = std::make_shared<queue>(4, 8);
+    q->async_acquire(io.get_executor(), ozo::none, handler(1));
+    q->async_acquire(io.get_executor(), ozo::none, handler(2));
+    q->async_acquire(io.get_executor(), ozo::none, handler(3));
+    io.run();
+    io.restart();
+    slots.pop_back();
+    slots.pop_back();
+
+    EXPECT_EQ(q->take_peak(), 3u);
+    EXPECT_EQ(q->take_peak(), 1u);
+    slots.clear();
+}
+
+#ifdef OZO_HAS_CANCELLATION_SLOT
+
+TEST_F(deadline_queue, should_remove_waiting_request_and_complete_it_with_operation_aborted_on_cancellation) {
+    boost::asio::cancellation_signal signal;
+    auto q = std::make_shared<queue>(1, 8);
+    q->async_acquire(io.get_executor(), ozo::none, handler(1));
+    q->async_acquire(io.get_executor(), ozo::none, boost::asio::bind_cancellation_slot(signal.slot(), handler(2)));
+    io.poll();
+    io.restart();
+    ASSERT_EQ(q->waiting(), 1u);
+
+    signal.emit(boost::asio::cancellation_type::terminal);
+    io.poll();
+    io.restart();
+
+    EXPECT_THAT(results, ElementsAre(Pair(1, ozo::error_code{}),
+        Pair(2, ozo::error_code{boost::asio::error::operation_aborted})));
+    EXPECT_EQ(q->waiting(), 0u);
+    EXPECT_FALSE(signal.slot().has_handler());
+
+    slots.clear();
+    EXPECT_EQ(q->active(), 0u);
+}
+
+TEST_F(deadline_queue, should_clear_cancellation_slot_of_waiting_request_on_admission) {
+    boost::asio::cancellation_signal signal;
+    auto q = std::make_shared<queue>(1, 8);
+    q->async_acquire(io.get_executor(), ozo::none, handler(1));
+    q->async_acquire(io.get_executor(), ozo::none, boost::asio::bind_cancellation_slot(signal.slot(), handler(2)));
+    io.poll();
+    io.restart();
+    ASSERT_TRUE(signal.slot().has_handler());
+
+    slots.clear();
+    io.poll();
+    io.restart();
+
+    EXPECT_THAT(results, ElementsAre(Pair(1, ozo::error_code{}), Pair(2, ozo::error_code{})));
+    EXPECT_FALSE(signal.slot().has_handler());
+
+    signal.emit(boost::asio::cancellation_type::terminal);
+    io.poll();
+    EXPECT_EQ(results.size(), 2u);
+    EXPECT_EQ(q->active(), 1u);
+    slots.clear();
+}
+
+#endif
+
+} // namespace
@@ -0,0 +1,62 @@
+#include <ozo/detail/dispatch.h>
+
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/io_context.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+
+namespace asio = boost::asio;
+
+TEST(dispatch_completion, should_invoke_handler_inline_when_running_in_its_executor) {
+    asio::io_context io;
+    bool called = false;
+    bool inline_called = false;
+    asio::post(io, [&] {
+        ozo::detail::dispatch_completion(asio::bind_executor(io, [&] { called = true;}));
+        inline_called = called;
+    });
+    io.run();
+    EXPECT_TRUE(called);
+    EXPECT_TRUE(inline_called);
+}
+
+TEST(dispatch_completion, should_post_handler_when_not_running_in_its_executor) {
+    asio::io_context io;
+    bool called = false;
+    ozo::detail::dispatch_completion(asio::bind_executor(io, [&] { called = true;}));
+    EXPECT_FALSE(called);
+    io.run();
+    EXPECT_TRUE(called);
+}
+
+struct recursive_completion {
+    asio::io_context& io;
+    std::size_t& count;
+    std::size_t& max_depth;
+    std::size_t limit;
+
+    void operator ()() const {
+        max_depth = std::max(max_depth, ozo::detail::completion_depth());
+        if (++count < limit) {
+            ozo::detail::dispatch_completion(asio::bind_executor(io, *this));
+        }
+    }
+};
+
+TEST(dispatch_completion, should_bound_depth_of_nested_inline_completions) {
+    asio::io_context io;
+    std::size_t count = 0;
+    std::size_t max_depth = 0;
+    asio::post(io, recursive_completion {io, count, max_depth, 1000});
+    io.run();
+    EXPECT_EQ(count, 1000u);
+    EXPECT_EQ(max_depth, ozo::detail::max_completion_depth);
+    EXPECT_EQ(ozo::detail::completion_depth(), 0u);
+}
+
+} // namespace
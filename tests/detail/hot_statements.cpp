@@ -0,0 +1,84 @@
+#include <ozo/detail/hot_statements.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+
+using ozo::detail::hot_statements;
+
+std::vector<std::string> texts(const hot_statements& statements) {
+    std::vector<std::string> result;
+    for (const auto& statement : statements.top()) {
+        result.push_back(statement->text);
+    }
+    return result;
+}
+
+TEST(hot_statements, top_should_return_empty_vector_for_no_statements) {
+    hot_statements statements(2);
+    EXPECT_TRUE(statements.top().empty());
+}
+
+TEST(hot_statements, prepared_should_return_same_usage_for_same_text) {
+    hot_statements statements(2);
+    const auto usage = statements.prepared("SELECT 1", nullptr, 0, nullptr);
+    EXPECT_EQ(statements.prepared("SELECT 1", nullptr, 0, nullptr), usage);
+    EXPECT_EQ(usage->load(), 2u);
+}
+
+TEST(hot_statements, prepared_should_keep_types_of_statement) {
+    hot_statements statements(2);
+    const ::Oid types[] = {23, 25};
+    statements.prepared("SELECT $1, $2", types, 2, nullptr);
+    ASSERT_EQ(statements.top().size(), 1u);
+    EXPECT_THAT(statements.top().front()->types, ElementsAre(23, 25));
+    EXPECT_FALSE(statements.top().front()->id);
+}
+
+TEST(hot_statements, top_should_return_count_most_used_statements_in_order) {
+    hot_statements statements(2);
+    statements.prepared("SELECT 1", nullptr, 0, nullptr);
+    *statements.prepared("SELECT 2", nullptr, 0, nullptr) += 10;
+    *statements.prepared("SELECT 3", nullptr, 0, nullptr) += 5;
+    EXPECT_THAT(texts(statements), ElementsAre("SELECT 2", "SELECT 3"));
+}
+
+TEST(hot_statements, prepared_should_replace_least_used_candidate_with_its_usage) {
+    hot_statements statements(1, 2);
+    *statements.prepared("SELECT 1", nullptr, 0, nullptr) += 10;
+    *statements.prepared("SELECT 2", nullptr, 0, nullptr) += 2;
+    const auto usage = statements.prepared("SELECT 3", nullptr, 0, nullptr);
+    EXPECT_EQ(usage->load(), 4u);
+    *usage += 10;
+    EXPECT_THAT(texts(statements), ElementsAre("SELECT 3"));
+}
+
+TEST(hot_statements, prepared_should_keep_identifier_of_statement_key) {
+    hot_statements statements(2);
+    const ozo::detail::statement_key key {42, "ozo_s000000000000002a"};
+    statements.prepared("SELECT 1", nullptr, 0, std::addressof(key));
+    ASSERT_EQ(statements.top().size(), 1u);
+    EXPECT_EQ(statements.top().front()->id, 42u);
+}
+
+TEST(hot_statements, restore_should_register_statement_with_usage) {
+    hot_statements statements(2);
+    statements.prepared("SELECT 1", nullptr, 0, nullptr);
+    statements.restore("SELECT 2", {23}, 42, 10);
+    EXPECT_THAT(texts(statements), ElementsAre("SELECT 2", "SELECT 1"));
+    EXPECT_EQ(statements.top().front()->id, 42u);
+    EXPECT_THAT(statements.top().front()->types, ElementsAre(23));
+}
+
+TEST(hot_statements, restore_should_not_change_usage_of_known_statement) {
+    hot_statements statements(2);
+    const auto usage = statements.prepared("SELECT 1", nullptr, 0, nullptr);
+    statements.restore("SELECT 1", {}, std::nullopt, 10);
+    EXPECT_EQ(usage->load(), 1u);
+    EXPECT_EQ(statements.candidates().size(), 1u);
+}
+
+} // namespace
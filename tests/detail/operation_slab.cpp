@@ -0,0 +1,93 @@
+#include <ozo/detail/operation_slab.h>
+#include <ozo/arena.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+
+using ozo::detail::operation_slab;
+using ozo::detail::slab_allocator;
+
+TEST(operation_slab, allocate_should_reuse_deallocated_block_of_the_same_size_class) {
+    operation_slab slab;
+    const auto block = slab.allocate(100);
+    slab.deallocate(block, 100);
+    EXPECT_EQ(slab.allocate(120), block);
+}
+
+TEST(operation_slab, allocate_should_not_reuse_deallocated_block_of_another_size_class) {
+    operation_slab slab;
+    const auto block = slab.allocate(100);
+    slab.deallocate(block, 100);
+    const auto other = slab.allocate(200);
+    EXPECT_NE(other, block);
+    slab.deallocate(other, 200);
+}
+
+TEST(operation_slab, allocate_should_not_reuse_block_greater_than_largest_size_class) {
+    operation_slab slab;
+    const auto size = operation_slab::granularity * operation_slab::classes_count + 1;
+    const auto block = slab.allocate(size);
+    slab.deallocate(block, size);
+    const auto other = slab.allocate(size);
+    slab.deallocate(other, size);
+    SUCCEED();
+}
+
+struct connection_with_slab {
+    std::shared_ptr<ozo::detail::operation_slab> slab_ = std::make_shared<ozo::detail::operation_slab>();
+    const std::shared_ptr<ozo::detail::operation_slab>& operation_slab() const noexcept { return slab_;}
+};
+
+struct connection_without_slab {};
+
+struct handler {
+    void operator() () const {}
+};
+
+struct arena_handler {
+    ozo::arena* arena_;
+    void operator() () const {}
+    using allocator_type = ozo::arena_allocator<char>;
+    allocator_type get_allocator() const noexcept { return allocator_type{*arena_};}
+};
+
+TEST(get_operation_allocator, should_return_slab_allocator_for_handler_with_default_allocator) {
+    connection_with_slab conn;
+    const auto allocator = ozo::detail::get_operation_allocator(conn, handler{});
+    EXPECT_EQ(allocator.slab(), conn.slab_);
+}
+
+TEST(get_operation_allocator, should_return_handler_allocator_for_connection_without_slab) {
+    connection_without_slab conn;
+    const auto allocator = ozo::detail::get_operation_allocator(conn, handler{});
+    EXPECT_EQ(allocator, std::allocator<char>{});
+}
+
+TEST(get_operation_allocator, should_return_handler_allocator_if_it_is_provided) {
+    connection_with_slab conn;
+    ozo::arena arena;
+    const auto allocator = ozo::detail::get_operation_allocator(conn, arena_handler{&arena});
+    EXPECT_EQ(allocator.get_arena(), &arena);
+}
+
+TEST(slab_allocator, allocate_shared_should_reuse_memory_of_previous_object) {
+    const auto slab = std::make_shared<operation_slab>();
+    const slab_allocator<char> allocator{slab};
+    const void* first = std::allocate_shared<std::array<char, 200>>(allocator).get();
+    const void* second = std::allocate_shared<std::array<char, 200>>(allocator).get();
+    EXPECT_EQ(first, second);
+}
+
+TEST(slab_allocator, should_keep_slab_alive) {
+    auto slab = std::make_shared<operation_slab>();
+    auto ptr = std::allocate_shared<int>(slab_allocator<char>{slab}, 42);
+    slab.reset();
+    ptr.reset();
+    SUCCEED();
+}
+
+} // namespace
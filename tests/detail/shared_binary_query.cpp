@@ -0,0 +1,88 @@
+#include <ozo/detail/shared_binary_query.h>
+#include <ozo/query_builder.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace ozo::tests {
+OZO_STRONG_TYPEDEF(std::string, shared_binary_query_custom_text)
+} // namespace ozo::tests
+
+OZO_PG_DEFINE_CUSTOM_TYPE(ozo::tests::shared_binary_query_custom_text, "shared_binary_query_custom_text")
+
+namespace {
+
+namespace hana = boost::hana;
+
+using namespace testing;
+using namespace ozo::literals;
+
+using ozo::detail::shared_binary_query;
+using ozo::tests::shared_binary_query_custom_text;
+
+TEST(shared_binary_query, should_model_query_concept) {
+    using query_type = decltype(ozo::make_query("SELECT $1", 42));
+    EXPECT_TRUE(ozo::Query<shared_binary_query<query_type>>);
+}
+
+TEST(shared_binary_query, should_provide_text_and_params_of_the_query) {
+    const shared_binary_query query(ozo::make_query("SELECT $1", 42), std::allocator<char>{});
+    EXPECT_EQ(std::string_view(ozo::get_query_text(query)), "SELECT $1");
+    EXPECT_EQ(ozo::get_query_params(query), hana::make_tuple(42));
+}
+
+TEST(shared_binary_query, to_binary_query_should_return_the_same_conversion_for_the_same_oid_map) {
+    const shared_binary_query query(ozo::make_query("SELECT $1", 42), std::allocator<char>{});
+    const auto first = ozo::to_binary_query(query, ozo::empty_oid_map{});
+    const auto second = ozo::to_binary_query(query, ozo::empty_oid_map{});
+    EXPECT_EQ(first.values(), second.values());
+}
+
+TEST(shared_binary_query, copy_should_share_conversion) {
+    const shared_binary_query query("SELECT "_SQL + 42, std::allocator<char>{});
+    const auto copy = query;
+    const auto first = ozo::to_binary_query(query, ozo::empty_oid_map{});
+    const auto second = ozo::to_binary_query(copy, ozo::empty_oid_map{});
+    EXPECT_EQ(first.values(), second.values());
+}
+
+TEST(shared_binary_query, to_binary_query_should_convert_query_for_each_oid_map_type) {
+    const shared_binary_query query(ozo::make_query("SELECT $1", 42), std::allocator<char>{});
+    const auto oid_map = ozo::register_types<shared_binary_query_custom_text>();
+    const auto first = ozo::to_binary_query(query, ozo::empty_oid_map{});
+    const auto second = ozo::to_binary_query(query, oid_map);
+    EXPECT_NE(first.values(), second.values());
+    EXPECT_EQ(ozo::to_binary_query(query, ozo::empty_oid_map{}).values(), first.values());
+    EXPECT_EQ(ozo::to_binary_query(query, oid_map).values(), second.values());
+}
+
+TEST(shared_binary_query, to_binary_query_should_convert_query_again_for_changed_oid_map) {
+    const shared_binary_query query(
+        ozo::make_query("SELECT $1", shared_binary_query_custom_text("text")), std::allocator<char>{});
+    auto oid_map = ozo::register_types<shared_binary_query_custom_text>();
+    const auto first = ozo::to_binary_query(query, oid_map);
+    ozo::set_type_oid<shared_binary_query_custom_text>(oid_map, 100500);
+    const auto second = ozo::to_binary_query(query, oid_map);
+    EXPECT_NE(first.values(), second.values());
+    EXPECT_EQ(second.types()[0], 100500u);
+}
+
+TEST(share_binary_query, should_wrap_query) {
+    const auto result = ozo::detail::share_binary_query(std::allocator<char>{}, ozo::make_query("SELECT 1"));
+    EXPECT_TRUE((std::is_same_v<std::decay_t<decltype(result)>,
+        shared_binary_query<decltype(ozo::make_query("SELECT 1"))>>));
+}
+
+TEST(share_binary_query, should_forward_other_argument) {
+    const int value = 42;
+    decltype(auto) result = ozo::detail::share_binary_query(std::allocator<char>{}, value);
+    EXPECT_EQ(std::addressof(result), std::addressof(value));
+}
+
+TEST(share_binary_query, should_not_wrap_prepared_query) {
+    const auto query = ozo::prepared(ozo::make_query("SELECT 1"));
+    decltype(auto) result = ozo::detail::share_binary_query(std::allocator<char>{}, query);
+    EXPECT_EQ(std::addressof(result), std::addressof(query));
+}
+
+} // namespace
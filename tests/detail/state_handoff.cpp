@@ -0,0 +1,114 @@
+#include <ozo/detail/state_handoff.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace ozo::tests {
+
+struct state_handoff_first_type {};
+struct state_handoff_second_type {};
+
+} // namespace ozo::tests
+
+OZO_PG_DEFINE_CUSTOM_TYPE(ozo::tests::state_handoff_first_type, "state_handoff_first_type")
+OZO_PG_DEFINE_CUSTOM_TYPE(ozo::tests::state_handoff_second_type, "state_handoff_second_type")
+
+namespace {
+
+using namespace testing;
+using namespace ozo::tests;
+
+using ozo::detail::hot_statements;
+using ozo::detail::oid_map_cache;
+using ozo::detail::state_reader;
+using ozo::detail::state_writer;
+
+using oid_map = ozo::oid_map_t<state_handoff_first_type, state_handoff_second_type>;
+
+oid_map make_oid_map(ozo::oid_t first, ozo::oid_t second) {
+    oid_map result;
+    ozo::set_type_oid<state_handoff_first_type>(result, first);
+    ozo::set_type_oid<state_handoff_second_type>(result, second);
+    return result;
+}
+
+TEST(state_reader, should_read_fields_written_by_state_writer) {
+    state_writer out;
+    out.field("a:b");
+    out.field({});
+    out.number(42);
+    const auto state = out.release();
+    EXPECT_EQ(state, "3:a:b0:2:42");
+
+    state_reader in(state);
+    EXPECT_EQ(in.field(), "a:b");
+    EXPECT_EQ(in.optional_number(), std::nullopt);
+    EXPECT_EQ(in.number(), 42u);
+    EXPECT_TRUE(in.empty());
+}
+
+TEST(state_reader, should_throw_on_truncated_field) {
+    state_reader in("5:abc");
+    EXPECT_THROW(in.field(), std::invalid_argument);
+}
+
+TEST(state_reader, should_throw_on_bad_number) {
+    state_reader in("2:4x");
+    EXPECT_THROW(in.number(), std::invalid_argument);
+}
+
+TEST(import_state, should_restore_exported_oid_maps_and_statements) {
+    oid_map_cache<oid_map> source_oid_maps;
+    source_oid_maps.insert("localhost:5432/db", make_oid_map(100, 200));
+    hot_statements source_statements(2);
+    const ::Oid types[] = {23};
+    *source_statements.prepared("SELECT $1", types, 1, nullptr) += 5;
+
+    const auto state = ozo::detail::export_state(source_oid_maps, std::addressof(source_statements));
+
+    oid_map_cache<oid_map> oid_maps;
+    hot_statements statements(2);
+    ozo::detail::import_state(state, oid_maps, std::addressof(statements));
+
+    const auto restored = oid_maps.find("localhost:5432/db");
+    ASSERT_TRUE(restored);
+    EXPECT_EQ(ozo::type_oid<state_handoff_first_type>(*restored), 100u);
+    EXPECT_EQ(ozo::type_oid<state_handoff_second_type>(*restored), 200u);
+    ASSERT_EQ(statements.top().size(), 1u);
+    EXPECT_EQ(statements.top().front()->text, "SELECT $1");
+    EXPECT_THAT(statements.top().front()->types, ElementsAre(23));
+    EXPECT_EQ(statements.top().front()->usage->load(), 6u);
+}
+
+TEST(import_state, should_skip_oid_map_with_unknown_types) {
+    oid_map_cache<ozo::oid_map_t<state_handoff_first_type>> source_oid_maps;
+    ozo::oid_map_t<state_handoff_first_type> source;
+    ozo::set_type_oid<state_handoff_first_type>(source, 100);
+    source_oid_maps.insert("localhost:5432/db", source);
+
+    oid_map_cache<oid_map> oid_maps;
+    ozo::detail::import_state(ozo::detail::export_state(source_oid_maps, nullptr), oid_maps, nullptr);
+    EXPECT_EQ(oid_maps.size(), 0u);
+}
+
+TEST(import_state, should_skip_statements_if_they_are_not_warmed_up) {
+    oid_map_cache<oid_map> source_oid_maps;
+    hot_statements source_statements(2);
+    source_statements.prepared("SELECT 1", nullptr, 0, nullptr);
+
+    oid_map_cache<oid_map> oid_maps;
+    EXPECT_NO_THROW(ozo::detail::import_state(
+        ozo::detail::export_state(source_oid_maps, std::addressof(source_statements)), oid_maps, nullptr));
+}
+
+TEST(import_state, should_throw_on_unsupported_format) {
+    oid_map_cache<oid_map> oid_maps;
+    EXPECT_THROW(ozo::detail::import_state("11:ozo-state-0", oid_maps, nullptr), std::invalid_argument);
+}
+
+TEST(import_state, should_throw_on_unknown_record) {
+    oid_map_cache<oid_map> oid_maps;
+    EXPECT_THROW(ozo::detail::import_state("11:ozo-state-16:cursor", oid_maps, nullptr), std::invalid_argument);
+}
+
+} // namespace
@@ -0,0 +1,201 @@
+#include <ozo/detail/statement_cache.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+
+using ozo::detail::statement_cache;
+using ozo::detail::column_plan_cache;
+
+TEST(statement_cache, find_should_return_nullptr_for_unknown_text) {
+    statement_cache cache;
+    EXPECT_EQ(cache.find("SELECT 1"), nullptr);
+}
+
+TEST(statement_cache, find_should_return_name_of_emplaced_statement) {
+    statement_cache cache;
+    cache.emplace("SELECT 1", "ozo_1");
+    ASSERT_NE(cache.find("SELECT 1"), nullptr);
+    EXPECT_EQ(*cache.find("SELECT 1"), "ozo_1");
+}
+
+TEST(statement_cache, make_name_should_return_unique_names) {
+    statement_cache cache;
+    EXPECT_NE(cache.make_name(), cache.make_name());
+}
+
+TEST(statement_cache, emplace_should_evict_least_recently_used_statement_if_full) {
+    statement_cache cache(2);
+    cache.emplace("SELECT 1", "ozo_1");
+    cache.emplace("SELECT 2", "ozo_2");
+    cache.find("SELECT 1");
+    cache.emplace("SELECT 3", "ozo_3");
+
+    EXPECT_EQ(cache.size(), 2u);
+    EXPECT_EQ(cache.find("SELECT 2"), nullptr);
+    EXPECT_NE(cache.find("SELECT 1"), nullptr);
+    EXPECT_NE(cache.find("SELECT 3"), nullptr);
+    EXPECT_THAT(cache.take_evicted(), ElementsAre("ozo_2"));
+}
+
+TEST(statement_cache, emplace_should_evict_new_statement_if_text_is_already_cached) {
+    statement_cache cache;
+    cache.emplace("SELECT 1", "ozo_1");
+    cache.emplace("SELECT 1", "ozo_2");
+
+    EXPECT_EQ(*cache.find("SELECT 1"), "ozo_1");
+    EXPECT_THAT(cache.take_evicted(), ElementsAre("ozo_2"));
+}
+
+TEST(statement_cache, emplace_should_evict_statement_immediately_if_capacity_is_zero) {
+    statement_cache cache(0);
+    cache.emplace("SELECT 1", "ozo_1");
+
+    EXPECT_TRUE(cache.empty());
+    EXPECT_THAT(cache.take_evicted(), ElementsAre("ozo_1"));
+}
+
+TEST(statement_cache, take_evicted_should_leave_no_evicted_statements) {
+    statement_cache cache(0);
+    cache.emplace("SELECT 1", "ozo_1");
+    cache.take_evicted();
+
+    EXPECT_THAT(cache.take_evicted(), IsEmpty());
+}
+
+TEST(statement_cache, erase_should_remove_statement) {
+    statement_cache cache;
+    cache.emplace("SELECT 1", "ozo_1");
+    cache.erase("SELECT 1");
+
+    EXPECT_EQ(cache.find("SELECT 1"), nullptr);
+    EXPECT_THAT(cache.take_evicted(), IsEmpty());
+}
+
+TEST(statement_cache, clear_should_remove_all_statements_and_evicted_ones) {
+    statement_cache cache(1);
+    cache.emplace("SELECT 1", "ozo_1");
+    cache.emplace("SELECT 2", "ozo_2");
+    cache.clear();
+
+    EXPECT_TRUE(cache.empty());
+    EXPECT_THAT(cache.take_evicted(), IsEmpty());
+}
+
+TEST(statement_cache, plans_should_return_nullptr_for_unknown_text) {
+    statement_cache cache;
+    EXPECT_EQ(cache.plans("SELECT 1"), nullptr);
+}
+
+TEST(statement_cache, plans_should_return_empty_plans_of_emplaced_statement) {
+    statement_cache cache;
+    cache.emplace("SELECT 1", "ozo_1");
+    ASSERT_NE(cache.plans("SELECT 1"), nullptr);
+    EXPECT_TRUE(cache.plans("SELECT 1")->empty());
+}
+
+TEST(statement_cache, plans_should_be_removed_with_statement) {
+    statement_cache cache;
+    cache.emplace("SELECT 1", "ozo_1");
+    cache.plans("SELECT 1")->emplace<int>(std::array<int, 1> {{0}});
+    cache.erase("SELECT 1");
+    cache.emplace("SELECT 1", "ozo_2");
+
+    EXPECT_TRUE(cache.plans("SELECT 1")->empty());
+}
+
+TEST(statement_cache, find_by_id_should_return_name_of_statement_emplaced_with_id) {
+    statement_cache cache;
+    cache.emplace(42, "SELECT 1", "ozo_s42");
+    ASSERT_NE(cache.find(42, "SELECT 1"), nullptr);
+    EXPECT_EQ(*cache.find(42, "SELECT 1"), "ozo_s42");
+    EXPECT_NE(cache.plans(42), nullptr);
+}
+
+TEST(statement_cache, find_by_text_should_return_statement_emplaced_with_id) {
+    statement_cache cache;
+    cache.emplace(42, "SELECT 1", "ozo_s42");
+    ASSERT_NE(cache.find("SELECT 1"), nullptr);
+    EXPECT_EQ(*cache.find("SELECT 1"), "ozo_s42");
+}
+
+TEST(statement_cache, emplace_with_id_should_attach_id_to_statement_of_same_text) {
+    statement_cache cache;
+    cache.emplace("SELECT 1", "ozo_1");
+    cache.emplace(42, "SELECT 1", "ozo_s42");
+
+    EXPECT_EQ(cache.size(), 1u);
+    ASSERT_NE(cache.find(42, "SELECT 1"), nullptr);
+    EXPECT_EQ(*cache.find(42, "SELECT 1"), "ozo_1");
+    EXPECT_THAT(cache.take_evicted(), ElementsAre("ozo_s42"));
+}
+
+TEST(statement_cache, find_by_id_should_evict_statement_of_other_text) {
+    statement_cache cache;
+    cache.emplace(42, "SELECT 1", "ozo_s42");
+
+    EXPECT_EQ(cache.find(42, "SELECT 2"), nullptr);
+    EXPECT_TRUE(cache.empty());
+    EXPECT_EQ(cache.find("SELECT 1"), nullptr);
+    EXPECT_THAT(cache.take_evicted(), ElementsAre("ozo_s42"));
+}
+
+TEST(statement_cache, emplace_should_evict_least_recently_used_statement_with_id) {
+    statement_cache cache(1);
+    cache.emplace(42, "SELECT 1", "ozo_s42");
+    cache.emplace("SELECT 2", "ozo_2");
+
+    EXPECT_EQ(cache.find(42, "SELECT 1"), nullptr);
+    EXPECT_EQ(cache.plans(42), nullptr);
+    EXPECT_THAT(cache.take_evicted(), ElementsAre("ozo_s42"));
+}
+
+TEST(statement_cache, erase_should_remove_statement_with_id) {
+    statement_cache cache;
+    cache.emplace(42, "SELECT 1", "ozo_s42");
+    cache.erase("SELECT 1");
+    EXPECT_EQ(cache.find(42, "SELECT 1"), nullptr);
+}
+
+TEST(column_plan_cache, find_should_return_false_for_unknown_row_type) {
+    column_plan_cache plans;
+    std::array<int, 2> plan;
+    EXPECT_FALSE(plans.find<int>(plan));
+}
+
+TEST(column_plan_cache, find_should_return_emplaced_plan_of_row_type) {
+    column_plan_cache plans;
+    plans.emplace<int>(std::array<int, 2> {{1, 0}});
+    plans.emplace<long>(std::array<int, 2> {{0, 1}});
+
+    std::array<int, 2> plan;
+    ASSERT_TRUE(plans.find<int>(plan));
+    EXPECT_THAT(plan, ElementsAre(1, 0));
+    ASSERT_TRUE(plans.find<long>(plan));
+    EXPECT_THAT(plan, ElementsAre(0, 1));
+}
+
+TEST(column_plan_cache, emplace_should_keep_first_plan_of_row_type) {
+    column_plan_cache plans;
+    plans.emplace<int>(std::array<int, 2> {{1, 0}});
+    plans.emplace<int>(std::array<int, 2> {{0, 1}});
+
+    EXPECT_EQ(plans.size(), 1u);
+    std::array<int, 2> plan;
+    ASSERT_TRUE(plans.find<int>(plan));
+    EXPECT_THAT(plan, ElementsAre(1, 0));
+}
+
+} // namespace
+
+TEST(statement_cache, find_should_count_usage_of_statement) {
+    statement_cache cache;
+    const auto usage = std::make_shared<ozo::detail::statement_usage>(0);
+    cache.emplace("SELECT 1", "ozo_1", usage);
+    cache.find("SELECT 1");
+    cache.find("SELECT 1");
+    EXPECT_EQ(usage->load(), 2u);
+}
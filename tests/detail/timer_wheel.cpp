@@ -0,0 +1,157 @@
+#include <ozo/timer_wheel.h>
+#include <ozo/error.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <boost/asio/io_context.hpp>
+
+#include <chrono>
+
+namespace {
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace asio = boost::asio;
+
+using ozo::detail::timer_wheel_service;
+using ozo::detail::wheel_timer;
+using clock = timer_wheel_service::clock;
+
+struct timer_wheel : Test {
+    asio::io_context io;
+};
+
+TEST_F(timer_wheel, wait_should_complete_not_earlier_than_expiry) {
+    auto& service = asio::make_service<timer_wheel_service>(io);
+    const auto expiry = clock::now() + 5ms;
+    wheel_timer timer(service, expiry);
+    std::optional<ozo::error_code> result;
+    clock::time_point completed;
+    timer.async_wait([&] (ozo::error_code ec) { result = ec; completed = clock::now(); });
+    io.run();
+    ASSERT_TRUE(result);
+    EXPECT_FALSE(*result);
+    EXPECT_GE(completed, expiry);
+    EXPECT_EQ(service.size(), 0u);
+}
+
+TEST_F(timer_wheel, wait_should_complete_for_expiry_in_the_past) {
+    auto& service = asio::make_service<timer_wheel_service>(io);
+    wheel_timer timer(service, clock::now() - 1s);
+    std::optional<ozo::error_code> result;
+    timer.async_wait([&] (ozo::error_code ec) { result = ec; });
+    io.run();
+    ASSERT_TRUE(result);
+    EXPECT_FALSE(*result);
+}
+
+TEST_F(timer_wheel, wait_should_complete_for_expiry_farther_than_wheel_round) {
+    auto& service = asio::make_service<timer_wheel_service>(io, 4);
+    const auto expiry = clock::now() + 10ms;
+    wheel_timer timer(service, expiry);
+    std::optional<ozo::error_code> result;
+    clock::time_point completed;
+    timer.async_wait([&] (ozo::error_code ec) { result = ec; completed = clock::now(); });
+    io.run();
+    ASSERT_TRUE(result);
+    EXPECT_FALSE(*result);
+    EXPECT_GE(completed, expiry);
+}
+
+TEST_F(timer_wheel, cancel_should_complete_wait_with_operation_aborted) {
+    auto& service = asio::make_service<timer_wheel_service>(io);
+    wheel_timer timer(service, clock::now() + 1h);
+    std::optional<ozo::error_code> result;
+    timer.async_wait([&] (ozo::error_code ec) { result = ec; });
+    EXPECT_EQ(timer.cancel(), 1u);
+    EXPECT_FALSE(result);
+    EXPECT_EQ(service.size(), 0u);
+    io.run();
+    ASSERT_TRUE(result);
+    EXPECT_EQ(*result, asio::error::operation_aborted);
+}
+
+TEST_F(timer_wheel, cancel_should_return_zero_for_completed_wait) {
+    auto& service = asio::make_service<timer_wheel_service>(io);
+    wheel_timer timer(service, clock::now());
+    timer.async_wait([&] (ozo::error_code) {});
+    io.run();
+    EXPECT_EQ(timer.cancel(), 0u);
+}
+
+TEST_F(timer_wheel, timer_destruction_should_cancel_wait) {
+    auto& service = asio::make_service<timer_wheel_service>(io);
+    std::optional<ozo::error_code> result;
+    {
+        wheel_timer timer(service, clock::now() + 1h);
+        timer.async_wait([&] (ozo::error_code ec) { result = ec; });
+    }
+    io.run();
+    ASSERT_TRUE(result);
+    EXPECT_EQ(*result, asio::error::operation_aborted);
+}
+
+TEST_F(timer_wheel, moved_timer_should_own_wait) {
+    auto& service = asio::make_service<timer_wheel_service>(io);
+    std::optional<ozo::error_code> result;
+    wheel_timer timer(service, clock::now() + 1h);
+    timer.async_wait([&] (ozo::error_code ec) { result = ec; });
+    auto other = std::move(timer);
+    EXPECT_EQ(timer.cancel(), 0u);
+    EXPECT_EQ(other.cancel(), 1u);
+}
+
+TEST_F(timer_wheel, waits_should_be_completed_in_expiry_order) {
+    auto& service = asio::make_service<timer_wheel_service>(io);
+    const auto now = clock::now();
+    std::vector<int> order;
+    wheel_timer second(service, now + 6ms);
+    wheel_timer first(service, now + 2ms);
+    second.async_wait([&] (ozo::error_code) { order.push_back(2); });
+    first.async_wait([&] (ozo::error_code) { order.push_back(1); });
+    io.run();
+    EXPECT_THAT(order, ElementsAre(1, 2));
+}
+
+TEST_F(timer_wheel, pending_waits_should_be_destroyed_on_io_context_destruction) {
+    auto io = std::make_unique<asio::io_context>();
+    auto& service = asio::make_service<timer_wheel_service>(*io);
+    auto flag = std::make_shared<int>();
+    {
+        auto timer = std::make_shared<wheel_timer>(service, clock::now() + 1h);
+        timer->async_wait([timer, flag] (ozo::error_code) {});
+    }
+    io.reset();
+    EXPECT_EQ(flag.use_count(), 1);
+}
+
+TEST(use_timer_wheel, should_make_get_operation_timer_use_timer_wheel) {
+    asio::io_context io;
+    ozo::use_timer_wheel(io);
+    auto timer = ozo::detail::get_operation_timer(io.get_executor(), 1h);
+    timer.async_wait([] (ozo::error_code) {});
+    EXPECT_EQ(asio::use_service<timer_wheel_service>(io).size(), 1u);
+    timer.cancel();
+    EXPECT_EQ(asio::use_service<timer_wheel_service>(io).size(), 0u);
+}
+
+TEST(use_timer_wheel, should_have_no_effect_on_second_call) {
+    asio::io_context io;
+    ozo::use_timer_wheel(io);
+    EXPECT_NO_THROW(ozo::use_timer_wheel(io));
+}
+
+TEST(get_operation_timer, should_use_steady_timer_without_timer_wheel) {
+    asio::io_context io;
+    auto timer = ozo::detail::get_operation_timer(io.get_executor(), 1ms);
+    std::optional<ozo::error_code> result;
+    timer.async_wait([&] (ozo::error_code ec) { result = ec; });
+    io.run();
+    EXPECT_FALSE(asio::has_service<timer_wheel_service>(io));
+    ASSERT_TRUE(result);
+    EXPECT_FALSE(*result);
+}
+
+} // namespace
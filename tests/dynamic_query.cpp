@@ -0,0 +1,99 @@
+#include <ozo/dynamic_query.h>
+
+#include <optional>
+#include <string_view>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+
+TEST(dynamic_query, should_number_placeholders_of_parameters) {
+    ozo::dynamic_query<> query;
+    query.append("SELECT ").param(std::int32_t(1)).append(" + ").param(std::int32_t(2));
+    EXPECT_STREQ(query.text(), "SELECT $1 + $2");
+    EXPECT_EQ(query.params_count(), 2);
+}
+
+TEST(dynamic_query, should_store_parameters_binary_representation) {
+    ozo::dynamic_query<> query;
+    query.append("SELECT ").param(std::int32_t(42)).append(", ").param(std::string("text"));
+    EXPECT_EQ(query.types()[0], ozo::type_traits<std::int32_t>::oid());
+    EXPECT_EQ(query.types()[1], ozo::type_traits<std::string>::oid());
+    EXPECT_THAT(query.formats()[0], 1);
+    EXPECT_THAT(query.formats()[1], 1);
+    EXPECT_EQ(query.lengths()[0], 4);
+    EXPECT_EQ(std::string_view(query.values()[0], 4), std::string_view("\x00\x00\x00\x2A", 4));
+    EXPECT_EQ(std::string_view(query.values()[1], std::size_t(query.lengths()[1])), "text");
+}
+
+TEST(dynamic_query, for_null_parameter_value_should_be_nullptr) {
+    ozo::dynamic_query<> query;
+    query.append("SELECT ").param(std::optional<std::int32_t>{});
+    EXPECT_EQ(query.types()[0], ozo::type_traits<std::int32_t>::oid());
+    EXPECT_EQ(query.lengths()[0], 0);
+    EXPECT_EQ(query.values()[0], nullptr);
+}
+
+TEST(dynamic_query, values_should_point_to_the_data_after_the_buffer_has_grown) {
+    ozo::dynamic_query<> query;
+    query.param(std::int64_t(7));
+    for (int i = 0; i < 100; ++i) {
+        query.append(", ").param(std::string(64, 'a'));
+    }
+    EXPECT_EQ(query.params_count(), 101);
+    EXPECT_EQ(std::string_view(query.values()[0], 8), std::string_view("\0\0\0\0\0\0\0\x07", 8));
+    EXPECT_EQ(std::string_view(query.values()[100], 64), std::string(64, 'a'));
+}
+
+TEST(dynamic_query, clear_should_keep_memory_and_restart_numbering) {
+    ozo::dynamic_query<> query;
+    query.append("SELECT ").param(std::int64_t(1)).append(", ").param(std::int64_t(2));
+    const auto text = query.text();
+    const auto values = query.values();
+    query.clear();
+    EXPECT_TRUE(query.empty());
+    query.append("SELECT ").param(std::int64_t(3));
+    EXPECT_STREQ(query.text(), "SELECT $1");
+    EXPECT_EQ(query.params_count(), 1);
+    EXPECT_EQ(query.text(), text);
+    EXPECT_EQ(query.values(), values);
+}
+
+TEST(dynamic_query, copy_should_point_to_own_data) {
+    ozo::dynamic_query<> query;
+    query.append("SELECT ").param(std::string("text"));
+    const auto copy = query;
+    query.clear();
+    query.append("SELECT ").param(std::string("other"));
+    EXPECT_NE(copy.values()[0], query.values()[0]);
+    EXPECT_EQ(std::string_view(copy.values()[0], std::size_t(copy.lengths()[0])), "text");
+}
+
+TEST(dynamic_query, to_binary_query_should_copy_text_and_parameters) {
+    ozo::dynamic_query<> query;
+    query.append("SELECT ").param(std::int32_t(42));
+    const auto result = ozo::to_binary_query(query, ozo::empty_oid_map{});
+    query.clear();
+    EXPECT_STREQ(result.text(), "SELECT $1");
+    EXPECT_EQ(result.params_count(), 1);
+    EXPECT_EQ(result.types()[0], ozo::type_traits<std::int32_t>::oid());
+    EXPECT_EQ(std::string_view(result.values()[0], 4), std::string_view("\x00\x00\x00\x2A", 4));
+}
+
+TEST(dynamic_query, release_should_move_data_into_binary_query) {
+    ozo::dynamic_query<> query;
+    query.append("SELECT ").param(std::string("text"));
+    const auto value = query.values()[0];
+    const auto result = std::move(query).release();
+    EXPECT_STREQ(result.text(), "SELECT $1");
+    EXPECT_EQ(result.values()[0], value);
+}
+
+TEST(dynamic_query, should_be_binary_query_convertible) {
+    EXPECT_TRUE(ozo::BinaryQueryConvertible<ozo::dynamic_query<>>);
+}
+
+} // namespace
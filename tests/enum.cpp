@@ -0,0 +1,151 @@
+#include "result_mock.h"
+
+#include <ozo/io/enum.h>
+#include <ozo/io/array.h>
+#include <ozo/ext/std/vector.h>
+#include <ozo/ext/std/optional.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace ozo::tests {
+
+enum class mood { sad, ok, happy };
+
+enum class sparse_enum : std::int16_t { low = -1000, high = 1000 };
+
+enum class custom_label_enum { first, second };
+
+} // namespace ozo::tests
+
+OZO_PG_DEFINE_ENUM(ozo::tests::mood, "mood", (sad)(ok)(happy))
+OZO_PG_DEFINE_ENUM(ozo::tests::sparse_enum, "sparse_enum", (low)(high))
+
+namespace ozo {
+template <>
+struct enum_labels<tests::custom_label_enum> {
+    static constexpr std::array<enum_label<tests::custom_label_enum>, 2> value {{
+        {tests::custom_label_enum::first, "first value"},
+        {tests::custom_label_enum::second, "second value"},
+    }};
+};
+} // namespace ozo
+
+OZO_PG_DEFINE_CUSTOM_TYPE(ozo::tests::custom_label_enum, "custom_label_enum")
+
+namespace {
+
+using namespace testing;
+using namespace ozo::tests;
+
+using buffer = std::vector<char>;
+
+template <typename T>
+buffer send(const T& v) {
+    auto oid_map = ozo::register_types<mood>();
+    ozo::set_type_oid<mood>(oid_map, 100500);
+    buffer result;
+    ozo::ostream os(result);
+    ozo::send(os, oid_map, v);
+    return result;
+}
+
+TEST(enum_label, should_be_found_by_perfect_hash_for_each_label) {
+    EXPECT_EQ(ozo::detail::get_enum_value<mood>("sad"), mood::sad);
+    EXPECT_EQ(ozo::detail::get_enum_value<mood>("ok"), mood::ok);
+    EXPECT_EQ(ozo::detail::get_enum_value<mood>("happy"), mood::happy);
+}
+
+TEST(enum_label, should_throw_bad_text_value_for_unknown_label) {
+    try {
+        ozo::detail::get_enum_value<mood>("angry");
+        FAIL() << "exception expected";
+    } catch (const ozo::system_error& e) {
+        EXPECT_EQ(e.code(), ozo::error::bad_text_value);
+    }
+}
+
+TEST(enum_label, should_not_match_label_prefix) {
+    EXPECT_THROW(ozo::detail::get_enum_value<mood>("ha"), ozo::system_error);
+    EXPECT_THROW(ozo::detail::get_enum_value<mood>(""), ozo::system_error);
+}
+
+TEST(enum_label, should_be_found_for_sparse_enum_values) {
+    EXPECT_FALSE(ozo::detail::enum_label_table<sparse_enum>::dense);
+    EXPECT_EQ(ozo::detail::get_enum_label(sparse_enum::low), "low");
+    EXPECT_EQ(ozo::detail::get_enum_label(sparse_enum::high), "high");
+    EXPECT_EQ(ozo::detail::get_enum_value<sparse_enum>("high"), sparse_enum::high);
+}
+
+TEST(enum_label, should_use_custom_labels) {
+    EXPECT_EQ(ozo::detail::get_enum_label(custom_label_enum::second), "second value");
+    EXPECT_EQ(ozo::detail::get_enum_value<custom_label_enum>("first value"), custom_label_enum::first);
+}
+
+TEST(enum_label, should_throw_invalid_argument_for_value_without_label) {
+    EXPECT_THROW(ozo::detail::get_enum_label(static_cast<mood>(7)), std::invalid_argument);
+    EXPECT_THROW(ozo::detail::get_enum_label(static_cast<sparse_enum>(0)), std::invalid_argument);
+}
+
+TEST(size_of, should_return_size_of_enum_label) {
+    EXPECT_EQ(ozo::size_of(mood::happy), 5);
+}
+
+TEST(send, should_write_enum_label) {
+    EXPECT_EQ(send(mood::ok), buffer({'o', 'k'}));
+}
+
+TEST(send, should_write_array_of_enum_with_element_oid_from_oid_map) {
+    EXPECT_EQ(send(std::vector<mood>{mood::sad}), buffer({
+        0, 0, 0, 1,
+        0, 0, 0, 0,
+        0, 0x01, char(0x88), char(0x94),
+        0, 0, 0, 1,
+        0, 0, 0, 0,
+        0, 0, 0, 3,
+        's', 'a', 'd',
+    }));
+}
+
+TEST(type_oid, should_return_oid_of_enum_from_oid_map) {
+    auto oid_map = ozo::register_types<mood>();
+    ozo::set_type_oid<mood>(oid_map, 100500);
+    EXPECT_EQ(ozo::type_oid<mood>(oid_map), 100500u);
+}
+
+struct recv_enum : Test {
+    decltype(ozo::register_types<mood>()) oid_map = ozo::register_types<mood>();
+    StrictMock<pg_result_mock> mock{};
+    ozo::value<pg_result_mock> value{{&mock, 0, 0}};
+
+    void expect_value(ozo::oid_t oid, ozo::impl::result_format format, std::string_view label) {
+        ozo::set_type_oid<mood>(oid_map, 100500);
+        EXPECT_CALL(mock, field_format(_)).WillRepeatedly(Return(format));
+        EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(oid));
+        EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(label.data()));
+        EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(label.size()));
+        EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+    }
+};
+
+TEST_F(recv_enum, should_read_enum_from_binary_label) {
+    expect_value(100500, ozo::impl::result_format::binary, "happy");
+    mood got = mood::sad;
+    ozo::recv(value, oid_map, got);
+    EXPECT_EQ(got, mood::happy);
+}
+
+TEST_F(recv_enum, should_read_enum_from_text_label) {
+    expect_value(100500, ozo::impl::result_format::text, "ok");
+    std::optional<mood> got;
+    ozo::recv(value, oid_map, got);
+    EXPECT_EQ(got, mood::ok);
+}
+
+TEST_F(recv_enum, should_throw_oid_type_mismatch_for_other_oid) {
+    expect_value(25, ozo::impl::result_format::binary, "ok");
+    mood got = mood::sad;
+    EXPECT_THROW(ozo::recv(value, oid_map, got), ozo::system_error);
+}
+
+} // namespace
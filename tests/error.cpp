@@ -38,4 +38,12 @@ TEST(protocol_error, should_match_to_mapped_errors_only) {
     EXPECT_NE(protocol_error, ozo::error::pq_socket_failed);
 }
 
+TEST(serialization_conflict, should_match_to_mapped_errors_only) {
+    const auto serialization_conflict = ozo::error_condition{ozo::errc::serialization_conflict};
+    EXPECT_EQ(serialization_conflict, ozo::sqlstate::make_error_code(ozo::sqlstate::serialization_failure));
+    EXPECT_EQ(serialization_conflict, ozo::sqlstate::make_error_code(ozo::sqlstate::deadlock_detected));
+    EXPECT_NE(serialization_conflict, ozo::sqlstate::make_error_code(ozo::sqlstate::unique_violation));
+    EXPECT_NE(serialization_conflict, ozo::error::pq_socket_failed);
+}
+
 }
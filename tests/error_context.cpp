@@ -0,0 +1,68 @@
+#include <ozo/error_context.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+using namespace std::literals;
+
+TEST(error_context, should_be_empty_by_default) {
+    EXPECT_TRUE(ozo::error_context{}.empty());
+    EXPECT_EQ(ozo::error_context{}, "");
+}
+
+TEST(error_context, should_reference_static_text) {
+    static constexpr std::string_view text = "error while get request result";
+    const auto context = ozo::error_context::static_text(text);
+    EXPECT_EQ(context.data(), text.data());
+    EXPECT_EQ(context, text);
+}
+
+TEST(error_context, should_copy_short_text_into_inline_buffer) {
+    const std::string text = "error while get request result";
+    const ozo::error_context context(text);
+    EXPECT_NE(context.data(), text.data());
+    EXPECT_GE(context.data(), reinterpret_cast<const char*>(&context));
+    EXPECT_LT(context.data(), reinterpret_cast<const char*>(&context + 1));
+    EXPECT_EQ(context, text);
+}
+
+TEST(error_context, should_copy_long_text_into_string) {
+    const std::string text(ozo::error_context::inline_capacity + 1, 'x');
+    const ozo::error_context context(text.c_str());
+    EXPECT_EQ(context.size(), text.size());
+    EXPECT_EQ(context, text);
+}
+
+TEST(error_context, should_move_string) {
+    std::string text(ozo::error_context::inline_capacity + 1, 'x');
+    const auto data = text.data();
+    const ozo::error_context context(std::move(text));
+    EXPECT_EQ(context.data(), data);
+}
+
+TEST(error_context, copy_should_point_to_own_inline_buffer) {
+    const ozo::error_context context("text");
+    const auto copy = context;
+    EXPECT_NE(copy.data(), context.data());
+    EXPECT_EQ(copy, "text");
+}
+
+TEST(error_context, assignment_should_replace_text) {
+    ozo::error_context context(std::string(ozo::error_context::inline_capacity + 1, 'x'));
+    context = "short";
+    EXPECT_EQ(context, "short");
+    context = ozo::error_context::static_text("static");
+    EXPECT_EQ(context, "static");
+}
+
+TEST(error_context, should_be_printed_as_text) {
+    std::ostringstream out;
+    out << ozo::error_context("text");
+    EXPECT_EQ(out.str(), "text");
+    EXPECT_EQ(std::string(ozo::error_context("text")), "text");
+}
+
+} // namespace
@@ -0,0 +1,63 @@
+#include <ozo/event_loop_monitor.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <thread>
+
+namespace {
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+TEST(event_loop_monitor, statistics_should_be_empty_for_new_monitor) {
+    const ozo::event_loop_monitor monitor;
+    const auto v = monitor.statistics();
+    EXPECT_EQ(v.lag.count(), 0u);
+    EXPECT_EQ(v.stalls, 0u);
+    EXPECT_EQ(v.slow_handlers, 0u);
+}
+
+TEST(event_loop_monitor, should_collect_lag_of_io_context_blocked_by_handler) {
+    ozo::io_context io;
+    ozo::event_loop_monitor monitor({1ms, 20ms});
+    monitor.watch(io);
+    boost::asio::post(io, [] { std::this_thread::sleep_for(30ms); });
+    boost::asio::steady_timer timer(io, 60ms);
+    timer.async_wait([&] (ozo::error_code) { monitor.stop(); });
+
+    io.run();
+
+    const auto v = monitor.statistics();
+    EXPECT_GT(v.lag.count(), 0u);
+    EXPECT_GE(v.stalls, 1u);
+    EXPECT_GE(v.lag.quantile(1.0), 20ms);
+}
+
+TEST(event_loop_monitor, wrap_should_count_and_report_slow_handler) {
+    std::vector<ozo::time_traits::duration> reported;
+    ozo::event_loop_monitor monitor({100ms, 1ms, [&] (auto v) { reported.push_back(v); }});
+    int calls = 0;
+    auto handler = monitor.wrap([&] (ozo::error_code, int v) {
+        calls += v;
+        std::this_thread::sleep_for(2ms);
+    });
+
+    handler(ozo::error_code {}, 1);
+
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(monitor.statistics().slow_handlers, 1u);
+    ASSERT_EQ(reported.size(), 1u);
+    EXPECT_GE(reported.front(), 1ms);
+}
+
+TEST(event_loop_monitor, wrap_should_not_count_fast_handler) {
+    ozo::event_loop_monitor monitor({100ms, 1s});
+    auto handler = monitor.wrap([] (ozo::error_code) {});
+
+    handler(ozo::error_code {});
+
+    EXPECT_EQ(monitor.statistics().slow_handlers, 0u);
+}
+
+} // namespace
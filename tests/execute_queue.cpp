@@ -0,0 +1,62 @@
+#include <ozo/execute_queue.h>
+#include <ozo/connection_info.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+
+using ozo::error_code;
+
+ozo::binary_query make_query() {
+    return ozo::to_binary_query(ozo::make_query("SELECT 1"), ozo::empty_oid_map{});
+}
+
+TEST(execute_queue, execute_should_drop_newest_query_if_queue_is_full) {
+    ozo::io_context io;
+    ozo::execute_queue queue(ozo::connection_info("conninfo"), io, {2, 1, 1, ozo::execute_queue_overflow::drop_newest});
+
+    EXPECT_TRUE(queue.execute(make_query()));
+    EXPECT_TRUE(queue.execute(make_query()));
+    EXPECT_FALSE(queue.execute(make_query()));
+    EXPECT_EQ(queue.size(), 2u);
+    EXPECT_EQ(queue.dropped(), 1u);
+}
+
+TEST(execute_queue, execute_should_drop_oldest_query_if_queue_is_full_and_policy_is_drop_oldest) {
+    ozo::io_context io;
+    ozo::execute_queue queue(ozo::connection_info("conninfo"), io, {2, 1, 1, ozo::execute_queue_overflow::drop_oldest});
+
+    EXPECT_TRUE(queue.execute(make_query()));
+    EXPECT_TRUE(queue.execute(make_query()));
+    EXPECT_TRUE(queue.execute(make_query()));
+    EXPECT_EQ(queue.size(), 2u);
+    EXPECT_EQ(queue.dropped(), 1u);
+}
+
+TEST(execute_queue, execute_should_drop_query_if_queue_is_closed) {
+    ozo::io_context io;
+    ozo::execute_queue queue(ozo::connection_info("conninfo"), io);
+
+    queue.close();
+
+    EXPECT_TRUE(queue.closed());
+    EXPECT_FALSE(queue.execute(make_query()));
+    EXPECT_EQ(queue.size(), 0u);
+    EXPECT_EQ(queue.dropped(), 1u);
+}
+
+TEST(execute_queue, flush_should_complete_if_queue_is_empty) {
+    ozo::io_context io;
+    ozo::execute_queue queue(ozo::connection_info("conninfo"), io);
+
+    std::optional<error_code> result;
+    queue.flush([&] (error_code ec) { result = ec; });
+    io.run();
+
+    EXPECT_EQ(result, error_code{});
+}
+
+} // namespace
@@ -0,0 +1,372 @@
+#include <ozo/failover/hedge.h>
+#include <ozo/failover/retry.h>
+
+#include "../connection_mock.h"
+#include "../test_error.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <deque>
+#include <functional>
+
+namespace {
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+using ozo::tests::connection_ptr;
+using connection_handler = std::function<void(ozo::error_code, connection_ptr<>)>;
+
+struct test_try {
+    connection_handler handler;
+    std::function<void(connection_handler)> get_connection;
+    connection_ptr<> conn;
+    ozo::error_code connect_ec;
+
+    void connect() {
+        get_connection([this] (ozo::error_code ec, connection_ptr<> c) {
+            connect_ec = ec;
+            conn = std::move(c);
+        });
+    }
+
+    void complete(ozo::error_code ec) { handler(ec, conn); }
+};
+
+struct test_operation {
+    std::deque<test_try>* tries = nullptr;
+
+    struct initiator_type {
+        std::deque<test_try>* tries = nullptr;
+
+        template <typename Handler, typename Provider, typename TimeConstraint>
+        void operator() (Handler&& h, Provider&& p, TimeConstraint t) const {
+            tries->push_back(test_try{
+                std::forward<Handler>(h),
+                [p = std::forward<Provider>(p), t] (connection_handler cb) {
+                    p.async_get_connection(t, std::move(cb));
+                },
+                nullptr,
+                ozo::error_code{}
+            });
+        }
+    };
+
+    initiator_type get_initiator() const { return {tries}; }
+};
+
+struct connections_provider {
+    using connection_type = connection_ptr<>;
+
+    std::deque<connection_type>* connections = nullptr;
+
+    template <typename TimeConstraint, typename Handler>
+    void async_get_connection(TimeConstraint, Handler&& h) const {
+        auto conn = std::move(connections->front());
+        connections->pop_front();
+        h(ozo::error_code{}, std::move(conn));
+    }
+};
+
+struct executor_connections_provider : connections_provider {
+    ozo::tests::io_context* io = nullptr;
+
+    auto get_executor() const { return io->get_executor();}
+};
+
+} // namespace
+
+namespace ozo::failover::detail {
+
+template <>
+struct hedged_arguments<test_operation> {
+    template <typename Context>
+    static auto apply(const std::shared_ptr<Context>&, std::size_t) {
+        return hana::make_tuple();
+    }
+};
+
+} // namespace ozo::failover::detail
+
+namespace {
+
+TEST(hedge_strategy, should_return_fixed_delay) {
+    const auto strategy = ozo::failover::hedge(ozo::failover::retry()*2).delay(10ms);
+    EXPECT_EQ(strategy.get_delay(), std::optional<ozo::time_traits::duration>(10ms));
+}
+
+TEST(hedge_strategy, should_return_nullopt_when_there_are_not_enough_samples_for_quantile_and_no_fixed_delay) {
+    const auto strategy = ozo::failover::hedge(ozo::failover::retry()*2).quantile(0.9);
+    EXPECT_EQ(strategy.get_delay(), std::nullopt);
+}
+
+TEST(hedge_strategy, should_return_fixed_delay_when_there_are_not_enough_samples_for_quantile) {
+    const auto strategy = ozo::failover::hedge(ozo::failover::retry()*2).delay(10ms).quantile(0.9);
+    for (int i = 0; i < 9; ++i) {
+        strategy.get(ozo::failover::hedge_options::latencies)->add(1ms);
+    }
+    EXPECT_EQ(strategy.get_delay(), std::optional<ozo::time_traits::duration>(10ms));
+}
+
+TEST(hedge_strategy, should_return_latency_quantile_when_there_are_enough_samples) {
+    const auto strategy = ozo::failover::hedge(ozo::failover::retry()*2).delay(10ms).quantile(0.9);
+    for (int i = 0; i < 10; ++i) {
+        strategy.get(ozo::failover::hedge_options::latencies)->add(1ms);
+    }
+    const auto delay = strategy.get_delay();
+    ASSERT_TRUE(delay);
+    EXPECT_EQ(*delay, strategy.latencies().quantile(0.9));
+    EXPECT_NE(*delay, 10ms);
+}
+
+TEST(hedge_strategy, should_share_latencies_between_copies) {
+    const auto strategy = ozo::failover::hedge(ozo::failover::retry()*2).delay(10ms);
+    const auto copy = strategy;
+    copy.get(ozo::failover::hedge_options::latencies)->add(1ms);
+    EXPECT_EQ(strategy.latencies().count(), 1u);
+}
+
+struct hedge : Test {
+    StrictMock<ozo::tests::connection_gmock> first_conn_mock;
+    StrictMock<ozo::tests::connection_gmock> second_conn_mock;
+    StrictMock<ozo::tests::steady_timer_mock> timer;
+    StrictMock<ozo::tests::callback_gmock<connection_ptr<>>> callback;
+    ozo::tests::PGconn_mock handle;
+    ozo::tests::io_context io;
+    std::function<void(ozo::error_code)> on_timer;
+    std::deque<test_try> tries;
+    std::deque<connection_ptr<>> connections {
+        ozo::tests::make_connection(first_conn_mock, io, handle),
+        ozo::tests::make_connection(second_conn_mock, io, handle),
+    };
+    connection_ptr<> first_conn = connections[0];
+    connection_ptr<> second_conn = connections[1];
+
+    hedge() {
+        EXPECT_CALL(io.executor_, post(_)).WillRepeatedly(InvokeArgument<0>());
+    }
+
+    template <typename Strategy, typename Provider>
+    void initiate(const Strategy& strategy, Provider provider) {
+        ozo::construct_initiator(strategy, test_operation{&tries})(
+            ozo::tests::wrap(callback, io.get_executor()), std::move(provider), 1s);
+    }
+
+    template <typename Strategy>
+    void initiate(const Strategy& strategy) {
+        initiate(strategy, connections_provider{&connections});
+    }
+
+    void expect_timer() {
+        EXPECT_CALL(io.timer_service_, timer(An<ozo::time_traits::time_point>())).WillOnce(ReturnRef(timer));
+        EXPECT_CALL(timer, async_wait(_)).WillOnce(SaveArg<0>(&on_timer));
+    }
+
+    auto make_strategy() const {
+        return ozo::failover::hedge(ozo::failover::retry(ozo::errc::connection_error)*3).delay(10ms);
+    }
+};
+
+TEST_F(hedge, should_complete_operation_with_the_first_try_completed_before_the_delay) {
+    const auto strategy = make_strategy();
+    initiate(strategy);
+    ASSERT_EQ(tries.size(), 1u);
+
+    expect_timer();
+    tries[0].connect();
+    EXPECT_FALSE(tries[0].connect_ec);
+
+    EXPECT_CALL(timer, cancel()).WillOnce(Return(1));
+    EXPECT_CALL(callback, call(ozo::error_code{}, first_conn));
+    tries[0].complete(ozo::error_code{});
+
+    EXPECT_EQ(tries.size(), 1u);
+    EXPECT_EQ(strategy.latencies().count(), 1u);
+}
+
+TEST_F(hedge, should_not_start_timer_when_operation_should_not_be_hedged) {
+    const auto strategy = ozo::failover::hedge(ozo::failover::retry(ozo::errc::connection_error)*3).quantile(0.9);
+    initiate(strategy);
+    tries[0].connect();
+
+    EXPECT_CALL(callback, call(ozo::error_code{}, first_conn));
+    tries[0].complete(ozo::error_code{});
+}
+
+TEST_F(hedge, should_initiate_next_try_when_the_delay_has_expired) {
+    initiate(make_strategy());
+    expect_timer();
+    tries[0].connect();
+
+    on_timer(ozo::error_code{});
+    EXPECT_EQ(tries.size(), 2u);
+}
+
+TEST_F(hedge, should_not_initiate_next_try_when_the_timer_is_cancelled) {
+    initiate(make_strategy());
+    expect_timer();
+    tries[0].connect();
+
+    on_timer(boost::asio::error::operation_aborted);
+    EXPECT_EQ(tries.size(), 1u);
+}
+
+TEST_F(hedge, should_complete_operation_with_the_hedged_try_and_cancel_the_first_one) {
+    initiate(make_strategy());
+    expect_timer();
+    tries[0].connect();
+    on_timer(ozo::error_code{});
+    ASSERT_EQ(tries.size(), 2u);
+    tries[1].connect();
+    EXPECT_EQ(tries[1].conn, second_conn);
+
+    EXPECT_CALL(timer, cancel()).WillOnce(Return(0));
+    EXPECT_CALL(first_conn_mock, cancel());
+    EXPECT_CALL(callback, call(ozo::error_code{}, second_conn));
+    tries[1].complete(ozo::error_code{});
+}
+
+TEST_F(hedge, should_cancel_the_first_try_on_the_executor_of_its_connection_and_keep_the_connection_until_then) {
+    ozo::tests::io_context first_io;
+    connections[0] = ozo::tests::make_connection(first_conn_mock, first_io, handle);
+    std::weak_ptr<ozo::tests::connection<>> first = connections[0];
+    first_conn.reset();
+
+    initiate(make_strategy());
+    EXPECT_CALL(first_io.timer_service_, timer(An<ozo::time_traits::time_point>())).WillOnce(ReturnRef(timer));
+    EXPECT_CALL(timer, async_wait(_)).WillOnce(SaveArg<0>(&on_timer));
+    tries[0].connect();
+    on_timer(ozo::error_code{});
+    tries[1].connect();
+
+    std::function<void()> cancel;
+    EXPECT_CALL(timer, cancel()).WillOnce(Return(0));
+    EXPECT_CALL(first_io.executor_, post(_)).WillOnce(SaveArg<0>(&cancel));
+    EXPECT_CALL(callback, call(ozo::error_code{}, second_conn));
+    tries[1].complete(ozo::error_code{});
+
+    tries[0].conn.reset();
+    EXPECT_FALSE(first.expired());
+
+    EXPECT_CALL(first_conn_mock, cancel());
+    cancel();
+}
+
+TEST_F(hedge, should_discard_the_cancelled_try_result) {
+    initiate(make_strategy());
+    expect_timer();
+    tries[0].connect();
+    on_timer(ozo::error_code{});
+    tries[1].connect();
+
+    EXPECT_CALL(timer, cancel()).WillOnce(Return(0));
+    EXPECT_CALL(first_conn_mock, cancel());
+    EXPECT_CALL(callback, call(ozo::error_code{}, second_conn));
+    tries[1].complete(ozo::error_code{});
+
+    EXPECT_CALL(first_conn_mock, close()).WillOnce(Return(ozo::error_code{}));
+    tries[0].complete(boost::asio::error::operation_aborted);
+}
+
+TEST_F(hedge, should_abort_try_which_has_got_connection_after_completion_of_the_operation) {
+    initiate(make_strategy());
+    expect_timer();
+    tries[0].connect();
+    on_timer(ozo::error_code{});
+
+    EXPECT_CALL(timer, cancel()).WillOnce(Return(0));
+    EXPECT_CALL(callback, call(ozo::error_code{}, first_conn));
+    tries[0].complete(ozo::error_code{});
+
+    tries[1].connect();
+    EXPECT_EQ(tries[1].connect_ec, boost::asio::error::operation_aborted);
+}
+
+TEST_F(hedge, should_initiate_next_try_immediately_on_error_of_the_only_try) {
+    initiate(make_strategy());
+    expect_timer();
+    tries[0].connect();
+
+    EXPECT_CALL(first_conn_mock, close()).WillOnce(Return(ozo::error_code{}));
+    tries[0].complete(boost::asio::error::connection_reset);
+    EXPECT_EQ(tries.size(), 2u);
+}
+
+TEST_F(hedge, should_wait_for_the_hedged_try_on_error_of_the_first_try) {
+    initiate(make_strategy());
+    expect_timer();
+    tries[0].connect();
+    on_timer(ozo::error_code{});
+    tries[1].connect();
+
+    EXPECT_CALL(first_conn_mock, close()).WillOnce(Return(ozo::error_code{}));
+    tries[0].complete(boost::asio::error::connection_reset);
+    EXPECT_EQ(tries.size(), 2u);
+
+    EXPECT_CALL(timer, cancel()).WillOnce(Return(0));
+    EXPECT_CALL(callback, call(ozo::error_code{}, second_conn));
+    tries[1].complete(ozo::error_code{});
+}
+
+TEST_F(hedge, should_complete_operation_with_error_when_there_are_no_tries_left) {
+    initiate(ozo::failover::hedge(ozo::failover::retry(ozo::errc::connection_error)*2).delay(10ms));
+    expect_timer();
+    tries[0].connect();
+    on_timer(ozo::error_code{});
+    tries[1].connect();
+
+    EXPECT_CALL(first_conn_mock, close()).WillOnce(Return(ozo::error_code{}));
+    tries[0].complete(boost::asio::error::connection_reset);
+
+    EXPECT_CALL(timer, cancel()).WillOnce(Return(0));
+    EXPECT_CALL(second_conn_mock, close()).WillOnce(Return(ozo::error_code{}));
+    EXPECT_CALL(callback, call(ozo::error_code{boost::asio::error::connection_reset}, second_conn));
+    tries[1].complete(boost::asio::error::connection_reset);
+}
+
+TEST_F(hedge, should_give_output_to_the_first_try_claimed_it) {
+    initiate(make_strategy());
+    expect_timer();
+    tries[0].connect();
+    on_timer(ozo::error_code{});
+    tries[1].connect();
+
+    using context_type = ozo::failover::detail::hedge_context<test_operation,
+        std::decay_t<decltype(ozo::tests::wrap(callback, io.get_executor()))>, connection_ptr<>>;
+    const auto& handler = *tries[1].handler.target<ozo::failover::detail::hedged_try_handler<context_type>>();
+
+    EXPECT_CALL(timer, cancel()).WillOnce(Return(0));
+    EXPECT_CALL(first_conn_mock, cancel());
+    EXPECT_TRUE(handler.ctx_->claim(2));
+    EXPECT_TRUE(handler.ctx_->claim(2));
+    EXPECT_FALSE(handler.ctx_->claim(1));
+
+    EXPECT_CALL(callback, call(ozo::error_code{}, second_conn));
+    tries[1].complete(ozo::error_code{});
+}
+
+TEST_F(hedge, should_start_timer_on_initiation_for_provider_with_executor) {
+    expect_timer();
+    initiate(make_strategy(), executor_connections_provider{{&connections}, &io});
+    ASSERT_EQ(tries.size(), 1u);
+}
+
+TEST_F(hedge, should_initiate_next_try_when_the_delay_has_expired_while_the_first_try_gets_connection) {
+    expect_timer();
+    initiate(make_strategy(), executor_connections_provider{{&connections}, &io});
+
+    on_timer(ozo::error_code{});
+    ASSERT_EQ(tries.size(), 2u);
+    tries[1].connect();
+    EXPECT_EQ(tries[1].conn, first_conn);
+
+    EXPECT_CALL(timer, cancel()).WillOnce(Return(0));
+    EXPECT_CALL(callback, call(ozo::error_code{}, first_conn));
+    tries[1].complete(ozo::error_code{});
+
+    tries[0].connect();
+    EXPECT_EQ(tries[0].connect_ec, boost::asio::error::operation_aborted);
+}
+
+} // namespace
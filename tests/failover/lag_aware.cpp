@@ -0,0 +1,195 @@
+#include <ozo/failover/lag_aware.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <functional>
+
+namespace {
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+struct connection_mock {};
+
+struct connection_source {
+    using connection_type = connection_mock*;
+
+    template <typename TimeConstraint, typename Handler>
+    void operator() (ozo::io_context&, TimeConstraint, Handler&&) const {
+        calls_->push_back(id_);
+    }
+
+    std::size_t id_ = 0;
+    std::vector<std::size_t>* calls_ = nullptr;
+};
+
+} // namespace
+
+namespace ozo {
+
+template <>
+struct is_connection<connection_mock*> : std::true_type {};
+
+template <>
+struct is_nullable<connection_mock*> : std::true_type {};
+
+} // namespace ozo
+
+namespace {
+
+using state_type = ozo::failover::detail::lag_aware_state<connection_source>;
+using monitor_type = ozo::failover::detail::replication_lag_monitor<connection_source>;
+
+std::vector<connection_source> make_sources(std::size_t n) {
+    std::vector<connection_source> result;
+    for (std::size_t i = 0; i != n; ++i) {
+        result.push_back(connection_source{i, nullptr});
+    }
+    return result;
+}
+
+TEST(lag_aware_state, should_treat_replicas_as_fresh_until_measured) {
+    const state_type state(make_sources(2), 1s);
+    EXPECT_TRUE(state.is_fresh(0));
+    EXPECT_TRUE(state.is_fresh(1));
+}
+
+TEST(lag_aware_state, should_treat_replica_with_lag_above_max_as_stale) {
+    state_type state(make_sources(2), 1s);
+    state.update(0, 2s);
+    state.update(1, 1s);
+    EXPECT_FALSE(state.is_fresh(0));
+    EXPECT_TRUE(state.is_fresh(1));
+}
+
+TEST(lag_aware_state, should_treat_replica_with_unknown_lag_as_stale) {
+    state_type state(make_sources(1), 1s);
+    state.update(0, std::nullopt);
+    EXPECT_FALSE(state.is_fresh(0));
+}
+
+TEST(lag_aware_state, choose_should_return_fresh_replicas_in_round_robin_order) {
+    state_type state(make_sources(3), 1s);
+    state.update(1, 2s);
+    EXPECT_EQ(state.choose(), 0u);
+    EXPECT_EQ(state.choose(), 2u);
+    EXPECT_EQ(state.choose(), 2u);
+    EXPECT_EQ(state.choose(), 0u);
+}
+
+TEST(lag_aware_state, choose_should_return_nullopt_if_all_replicas_are_stale) {
+    state_type state(make_sources(2), 1s);
+    state.update(0, 2s);
+    state.update(1, std::nullopt);
+    EXPECT_EQ(state.choose(), std::nullopt);
+}
+
+TEST(replication_lag_monitor, to_replication_lag_should_convert_microseconds_to_duration) {
+    const ozo::failover::detail::replication_lag_rows rows {{std::optional<std::int64_t>(1500), std::optional<std::int64_t>(42)}};
+    EXPECT_EQ(monitor_type::to_replication_lag(rows), std::optional<ozo::time_traits::duration>(1500us));
+}
+
+TEST(replication_lag_monitor, to_replication_lag_should_return_nullopt_for_null_lag) {
+    const ozo::failover::detail::replication_lag_rows rows {{std::optional<std::int64_t>(), std::optional<std::int64_t>(42)}};
+    EXPECT_EQ(monitor_type::to_replication_lag(rows), std::nullopt);
+}
+
+TEST(replication_lag_monitor, to_replication_lag_should_return_nullopt_for_no_rows) {
+    EXPECT_EQ(monitor_type::to_replication_lag({}), std::nullopt);
+}
+
+TEST(replication_lag_monitor, to_replay_lsn_should_return_replayed_position) {
+    const ozo::failover::detail::replication_lag_rows rows {{std::optional<std::int64_t>(1500), std::optional<std::int64_t>(42)}};
+    EXPECT_EQ(monitor_type::to_replay_lsn(rows), std::optional<ozo::failover::wal_lsn>(42));
+}
+
+TEST(replication_lag_monitor, to_replay_lsn_should_return_nullopt_for_no_rows) {
+    EXPECT_EQ(monitor_type::to_replay_lsn({}), std::nullopt);
+}
+
+TEST(lag_aware_state, should_keep_previous_replay_lsn_if_it_is_unknown) {
+    state_type state(make_sources(1), 1s);
+    state.update_replay_lsn(0, 42);
+    state.update_replay_lsn(0, std::nullopt);
+    EXPECT_TRUE(state.has_replayed(0, 42));
+    EXPECT_FALSE(state.has_replayed(0, 43));
+}
+
+TEST(lag_aware_state, choose_should_return_replicas_which_have_replayed_given_position) {
+    state_type state(make_sources(3), 1s);
+    state.update_replay_lsn(0, 100);
+    state.update_replay_lsn(1, 200);
+    state.update_replay_lsn(2, 200);
+    state.update(2, 2s);
+    EXPECT_EQ(state.choose(150), 1u);
+    EXPECT_EQ(state.choose(150), 1u);
+    EXPECT_EQ(state.choose(250), std::nullopt);
+}
+
+TEST(lag_aware_connection_source, should_throw_on_empty_sources) {
+    EXPECT_THROW(ozo::failover::lag_aware_connection_source<connection_source>({}), std::invalid_argument);
+}
+
+TEST(lag_aware_connection_source, should_request_connection_from_fresh_replica) {
+    ozo::io_context io;
+    std::vector<std::size_t> calls;
+    auto source = ozo::failover::make_lag_aware_connection_source({},
+        connection_source{0, &calls}, connection_source{1, &calls});
+    source(io, ozo::none, [] (ozo::error_code, connection_mock*) {});
+    source(io, ozo::none, [] (ozo::error_code, connection_mock*) {});
+    EXPECT_THAT(calls, ElementsAre(0u, 1u));
+}
+
+TEST(lag_aware_connection_source, should_not_request_connection_from_stale_replica) {
+    ozo::io_context io;
+    std::vector<std::size_t> calls;
+    auto source = ozo::failover::make_lag_aware_connection_source({},
+        connection_source{0, &calls}, connection_source{1, &calls});
+    source.set_lag(0, 2s);
+    source(io, ozo::none, [] (ozo::error_code, connection_mock*) {});
+    source(io, ozo::none, [] (ozo::error_code, connection_mock*) {});
+    EXPECT_THAT(calls, ElementsAre(1u, 1u));
+}
+
+TEST(lag_aware_connection_source, should_complete_request_with_replication_lag_exceeded_if_all_replicas_are_stale) {
+    ozo::io_context io;
+    std::vector<std::size_t> calls;
+    auto source = ozo::failover::make_lag_aware_connection_source({}, connection_source{0, &calls});
+    source.set_lag(0, std::nullopt);
+    ozo::error_code result;
+    source(io, ozo::none, [&] (ozo::error_code ec, connection_mock*) { result = ec; });
+    io.run();
+    EXPECT_TRUE(calls.empty());
+    EXPECT_EQ(result, ozo::error_code{ozo::error::replication_lag_exceeded});
+    EXPECT_EQ(result, ozo::errc::connection_error);
+}
+
+TEST(lag_aware_connection_source, caught_up_with_should_request_connection_from_replica_which_has_replayed_position) {
+    ozo::io_context io;
+    std::vector<std::size_t> calls;
+    auto source = ozo::failover::make_lag_aware_connection_source({},
+        connection_source{0, &calls}, connection_source{1, &calls});
+    source.set_replay_lsn(0, 100);
+    source.set_replay_lsn(1, 200);
+    const auto caught_up = source.caught_up_with(150);
+    caught_up(io, ozo::none, [] (ozo::error_code, connection_mock*) {});
+    caught_up(io, ozo::none, [] (ozo::error_code, connection_mock*) {});
+    source(io, ozo::none, [] (ozo::error_code, connection_mock*) {});
+    EXPECT_THAT(calls, ElementsAre(1u, 1u, 0u));
+    EXPECT_EQ(caught_up.replay_lsn(1), 200);
+}
+
+TEST(lag_aware_connection_source, caught_up_with_should_complete_request_with_replication_lag_exceeded_if_no_replica_has_replayed_position) {
+    ozo::io_context io;
+    std::vector<std::size_t> calls;
+    auto source = ozo::failover::make_lag_aware_connection_source({}, connection_source{0, &calls});
+    source.set_replay_lsn(0, 100);
+    ozo::error_code result;
+    source.caught_up_with(101)(io, ozo::none, [&] (ozo::error_code ec, connection_mock*) { result = ec; });
+    io.run();
+    EXPECT_TRUE(calls.empty());
+    EXPECT_EQ(result, ozo::error_code{ozo::error::replication_lag_exceeded});
+}
+
+} // namespace
@@ -0,0 +1,208 @@
+#include <ozo/failover/least_loaded.h>
+
+#include "../test_error.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <thread>
+
+namespace {
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+struct connection_mock {};
+
+using handler_type = std::function<void(ozo::error_code, connection_mock*)>;
+
+struct connection_source_mock {
+    MOCK_CONST_METHOD1(call, void(handler_type));
+};
+
+struct connection_source {
+    using connection_type = connection_mock*;
+
+    template <typename TimeConstraint, typename Handler>
+    void operator() (ozo::io_context&, TimeConstraint, Handler&& h) const {
+        mock_->call(std::forward<Handler>(h));
+    }
+
+    connection_source_mock* mock_ = nullptr;
+};
+
+} // namespace
+
+namespace ozo {
+
+template <>
+struct is_connection<connection_mock*> : std::true_type {};
+
+template <>
+struct is_nullable<connection_mock*> : std::true_type {};
+
+} // namespace ozo
+
+namespace {
+
+using ozo::failover::detail::host_load;
+
+TEST(host_load, should_have_no_outstanding_requests_and_zero_latency_by_default) {
+    const host_load load;
+    EXPECT_EQ(load.outstanding(), 0u);
+    EXPECT_EQ(load.latency(), ozo::time_traits::duration(0));
+}
+
+TEST(host_load, should_count_outstanding_requests) {
+    host_load load;
+    load.started();
+    load.started();
+    EXPECT_EQ(load.outstanding(), 2u);
+    load.finished(1ms);
+    EXPECT_EQ(load.outstanding(), 1u);
+}
+
+TEST(host_load, should_use_first_sample_as_latency) {
+    host_load load;
+    load.started();
+    load.finished(10ms);
+    EXPECT_EQ(load.latency(), 10ms);
+}
+
+TEST(host_load, should_move_latency_towards_new_sample_by_smoothing_factor) {
+    host_load load;
+    load.started();
+    load.finished(10ms);
+    load.started();
+    load.finished(20ms);
+    EXPECT_EQ(load.latency(), 12ms);
+}
+
+TEST(host_load, should_increase_score_with_outstanding_requests) {
+    host_load load;
+    load.started();
+    load.finished(10ms);
+    const auto idle = load.score();
+    load.started();
+    EXPECT_GT(load.score(), idle);
+}
+
+TEST(host_load, should_increase_score_with_latency) {
+    host_load fast;
+    fast.started();
+    fast.finished(1ms);
+    host_load slow;
+    slow.started();
+    slow.finished(100ms);
+    EXPECT_LT(fast.score(), slow.score());
+}
+
+struct least_loaded_connection_source : Test {
+    StrictMock<connection_source_mock> first;
+    StrictMock<connection_source_mock> second;
+    StrictMock<connection_source_mock> third;
+    ozo::io_context io;
+    connection_mock conn;
+
+    auto make_source(std::vector<connection_source> sources) {
+        return ozo::failover::least_loaded_connection_source<connection_source>{std::move(sources)};
+    }
+};
+
+TEST_F(least_loaded_connection_source, should_throw_on_empty_sources) {
+    EXPECT_THROW(make_source({}), std::invalid_argument);
+}
+
+TEST_F(least_loaded_connection_source, should_model_connection_source) {
+    EXPECT_TRUE(ozo::ConnectionSource<ozo::failover::least_loaded_connection_source<connection_source>>);
+}
+
+TEST_F(least_loaded_connection_source, should_request_connection_from_the_only_source) {
+    auto source = ozo::failover::make_least_loaded_connection_source(connection_source{&first});
+    handler_type handler;
+    EXPECT_CALL(first, call(_)).WillOnce(SaveArg<0>(&handler));
+    bool called = false;
+    source(io, ozo::none, [&](ozo::error_code ec, connection_mock* c) {
+        EXPECT_FALSE(ec);
+        EXPECT_EQ(c, &conn);
+        called = true;
+    });
+    EXPECT_EQ(source.outstanding(0), 1u);
+    handler(ozo::error_code{}, &conn);
+    EXPECT_TRUE(called);
+    EXPECT_EQ(source.outstanding(0), 0u);
+}
+
+TEST_F(least_loaded_connection_source, should_record_latency_on_error) {
+    auto source = ozo::failover::make_least_loaded_connection_source(connection_source{&first});
+    handler_type handler;
+    EXPECT_CALL(first, call(_)).WillOnce(SaveArg<0>(&handler));
+    ozo::error_code result;
+    source(io, ozo::none, [&](ozo::error_code ec, connection_mock*) { result = ec; });
+    handler(ozo::tests::error::error, nullptr);
+    EXPECT_EQ(result, ozo::tests::error::error);
+    EXPECT_EQ(source.outstanding(0), 0u);
+    EXPECT_GT(source.latency(0), ozo::time_traits::duration(0));
+}
+
+TEST_F(least_loaded_connection_source, should_request_connection_from_the_source_with_less_outstanding_requests) {
+    auto source = ozo::failover::make_least_loaded_connection_source(connection_source{&first}, connection_source{&second});
+    std::vector<handler_type> handlers;
+    EXPECT_CALL(first, call(_)).Times(AtMost(1)).WillRepeatedly(Invoke([&](auto h) { handlers.push_back(h); }));
+    EXPECT_CALL(second, call(_)).Times(AtMost(1)).WillRepeatedly(Invoke([&](auto h) { handlers.push_back(h); }));
+    source(io, ozo::none, [](ozo::error_code, connection_mock*) {});
+    source(io, ozo::none, [](ozo::error_code, connection_mock*) {});
+    EXPECT_EQ(source.outstanding(0), 1u);
+    EXPECT_EQ(source.outstanding(1), 1u);
+}
+
+TEST_F(least_loaded_connection_source, should_request_connection_from_the_source_with_less_latency) {
+    auto source = ozo::failover::make_least_loaded_connection_source(connection_source{&first}, connection_source{&second});
+    handler_type handler;
+    EXPECT_CALL(first, call(_)).WillRepeatedly(SaveArg<0>(&handler));
+    EXPECT_CALL(second, call(_)).WillRepeatedly(SaveArg<0>(&handler));
+    while (source.latency(0) == ozo::time_traits::duration(0) || source.latency(1) == ozo::time_traits::duration(0)) {
+        source(io, ozo::none, [](ozo::error_code, connection_mock*) {});
+        if (source.outstanding(0)) {
+            std::this_thread::sleep_for(10ms);
+        }
+        handler(ozo::error_code{}, &conn);
+    }
+    ASSERT_GT(source.latency(0), source.latency(1));
+
+    Mock::VerifyAndClearExpectations(&first);
+    Mock::VerifyAndClearExpectations(&second);
+    EXPECT_CALL(second, call(_)).WillOnce(SaveArg<0>(&handler));
+    source(io, ozo::none, [](ozo::error_code, connection_mock*) {});
+}
+
+TEST_F(least_loaded_connection_source, should_never_request_connection_from_the_most_loaded_of_three_sources) {
+    auto source = ozo::failover::make_least_loaded_connection_source(
+        connection_source{&first}, connection_source{&second}, connection_source{&third});
+    EXPECT_CALL(first, call(_)).WillRepeatedly(Return());
+    EXPECT_CALL(second, call(_)).WillRepeatedly(Return());
+    EXPECT_CALL(third, call(_)).WillRepeatedly(Return());
+    for (int i = 0; i < 30; ++i) {
+        const std::array<std::size_t, 3> before {source.outstanding(0), source.outstanding(1), source.outstanding(2)};
+        const auto busiest = std::max_element(before.begin(), before.end());
+        const bool unique = std::count(before.begin(), before.end(), *busiest) == 1;
+        source(io, ozo::none, [](ozo::error_code, connection_mock*) {});
+        if (unique) {
+            EXPECT_EQ(source.outstanding(std::distance(before.begin(), busiest)), *busiest);
+        }
+    }
+    EXPECT_EQ(source.outstanding(0) + source.outstanding(1) + source.outstanding(2), 30u);
+}
+
+TEST_F(least_loaded_connection_source, should_share_load_between_copies) {
+    auto source = ozo::failover::make_least_loaded_connection_source(connection_source{&first});
+    const auto copy = source;
+    EXPECT_CALL(first, call(_));
+    copy(io, ozo::none, [](ozo::error_code, connection_mock*) {});
+    EXPECT_EQ(source.outstanding(0), 1u);
+}
+
+} // namespace
@@ -1,6 +1,7 @@
 #include <ozo/failover/retry.h>
 
 #include "../test_error.h"
+#include "../test_asio.h"
 
 #include <boost/hana/equal.hpp>
 #include <boost/hana/not_equal.hpp>
@@ -240,6 +241,203 @@ TEST(basic_try__tries_remain, should_return_tries_remain_count) {
     EXPECT_EQ(basic_try.tries_remain(), 3);
 }
 
+TEST(basic_try__delay, should_return_zero_for_the_first_try) {
+    using op = ozo::failover::retry_options;
+    auto basic_try = ozo::failover::basic_try(
+        ozo::make_options(op::tries = 3, op::backoff = ozo::failover::exponential_backoff{10ms, 1s}),
+        ozo::failover::basic_context(fake_connection_provider{}, ozo::none));
+    EXPECT_EQ(basic_try.delay(), duration{0});
+}
+
+struct basic_try__backoff : Test {
+    using op = ozo::failover::retry_options;
+    static constexpr connection_mock* null_conn = nullptr;
+    const ozo::failover::exponential_backoff backoff {10ms, 1s};
+
+    template <typename TimeConstraint>
+    auto make_try(int n_tries, TimeConstraint t) const {
+        return ozo::failover::basic_try(
+            ozo::make_options(op::tries = n_tries, op::close_connection = false, op::backoff = backoff),
+            ozo::failover::basic_context(fake_connection_provider{}, ozo::deadline(t)));
+    }
+};
+
+TEST_F(basic_try__backoff, should_set_delay_of_the_next_try_no_more_than_backoff_cap) {
+    for (int i = 0; i < 100; ++i) {
+        auto first_try = make_try(4, ozo::none);
+        auto second_try = first_try.get_next_try(ozo::tests::error::error, null_conn);
+        ASSERT_TRUE(second_try);
+        EXPECT_LE(second_try->delay(), backoff.cap(0));
+        auto third_try = second_try->get_next_try(ozo::tests::error::error, null_conn);
+        ASSERT_TRUE(third_try);
+        EXPECT_LE(third_try->delay(), backoff.cap(1));
+    }
+}
+
+TEST_F(basic_try__backoff, should_limit_delay_by_half_of_the_next_try_time) {
+    for (int i = 0; i < 100; ++i) {
+        auto first_try = make_try(2, 10ms);
+        auto second_try = first_try.get_next_try(ozo::tests::error::error, null_conn);
+        ASSERT_TRUE(second_try);
+        EXPECT_LE(second_try->delay(), 5ms);
+    }
+}
+
+TEST_F(basic_try__backoff, should_pass_delay_to_connection_provider) {
+    auto first_try = make_try(3, ozo::none);
+    auto second_try = first_try.get_next_try(ozo::tests::error::error, null_conn);
+    ASSERT_TRUE(second_try);
+    const auto provider = second_try->get_context()[hana::size_c<0>];
+    EXPECT_EQ(provider.delay_, second_try->delay());
+}
+
+TEST(exponential_backoff, should_double_cap_with_each_retry_up_to_max) {
+    const ozo::failover::exponential_backoff backoff {10ms, 50ms};
+    EXPECT_EQ(backoff.cap(0), 10ms);
+    EXPECT_EQ(backoff.cap(1), 20ms);
+    EXPECT_EQ(backoff.cap(2), 40ms);
+    EXPECT_EQ(backoff.cap(3), 50ms);
+    EXPECT_EQ(backoff.cap(100), 50ms);
+}
+
+TEST(exponential_backoff, should_return_delay_in_range_from_zero_to_cap) {
+    const ozo::failover::exponential_backoff backoff {10ns, 1s};
+    EXPECT_EQ(backoff.delay(0, 0), duration{0});
+    EXPECT_EQ(backoff.delay(0, 10), 10ns);
+    EXPECT_EQ(backoff.delay(0, 11), duration{0});
+    EXPECT_EQ(backoff.delay(1, 20), 20ns);
+}
+
+TEST(exponential_backoff, should_return_zero_delay_for_zero_base) {
+    const ozo::failover::exponential_backoff backoff {duration{0}, 1s};
+    EXPECT_EQ(backoff.delay(5, 12345), duration{0});
+}
+
+struct basic_try__budget : Test {
+    using op = ozo::failover::retry_options;
+    static constexpr connection_mock* null_conn = nullptr;
+
+    auto make_try(const ozo::failover::retry_budget& budget) const {
+        return ozo::failover::basic_try(
+            ozo::make_options(op::tries = 3, op::close_connection = false, op::budget = budget),
+            ozo::failover::basic_context(fake_connection_provider{}, ozo::none));
+    }
+};
+
+TEST_F(basic_try__budget, should_return_next_try_and_withdraw_token) {
+    const ozo::failover::retry_budget budget {0.1, 2};
+    auto basic_try = make_try(budget);
+    EXPECT_TRUE(basic_try.get_next_try(ozo::tests::error::error, null_conn));
+    EXPECT_EQ(budget.tokens(), 1.0);
+}
+
+TEST_F(basic_try__budget, should_return_null_state_when_budget_is_exhausted) {
+    const ozo::failover::retry_budget budget {0.1, 1};
+    ASSERT_TRUE(budget.withdraw());
+    auto basic_try = make_try(budget);
+    EXPECT_FALSE(basic_try.get_next_try(ozo::tests::error::error, null_conn));
+}
+
+TEST(retry_budget, should_be_full_initially) {
+    const ozo::failover::retry_budget budget {0.1, 5};
+    EXPECT_EQ(budget.tokens(), 5.0);
+}
+
+TEST(retry_budget, should_not_allow_withdraw_when_there_is_no_token) {
+    const ozo::failover::retry_budget budget {0.5, 1};
+    EXPECT_TRUE(budget.withdraw());
+    EXPECT_FALSE(budget.withdraw());
+}
+
+TEST(retry_budget, should_allow_withdraw_after_enough_deposits) {
+    const ozo::failover::retry_budget budget {0.5, 1};
+    EXPECT_TRUE(budget.withdraw());
+    budget.deposit();
+    EXPECT_FALSE(budget.withdraw());
+    budget.deposit();
+    EXPECT_TRUE(budget.withdraw());
+}
+
+TEST(retry_budget, should_not_hold_more_tokens_than_reserve) {
+    const ozo::failover::retry_budget budget {0.5, 2};
+    budget.deposit();
+    EXPECT_EQ(budget.tokens(), 2.0);
+}
+
+TEST(retry_budget, should_share_tokens_between_copies) {
+    const ozo::failover::retry_budget budget {0.1, 1};
+    const auto copy = budget;
+    EXPECT_TRUE(copy.withdraw());
+    EXPECT_FALSE(budget.withdraw());
+}
+
+TEST(retry_budget, should_throw_on_invalid_arguments) {
+    EXPECT_THROW(ozo::failover::retry_budget(-0.1, 1), std::invalid_argument);
+    EXPECT_THROW(ozo::failover::retry_budget(1.1, 1), std::invalid_argument);
+    EXPECT_THROW(ozo::failover::retry_budget(0.1, 0), std::invalid_argument);
+}
+
+TEST(retry_strategy, should_deposit_budget_on_first_try) {
+    const ozo::failover::retry_budget budget {0.5, 1};
+    ASSERT_TRUE(budget.withdraw());
+    const auto strategy = ozo::failover::retry().budget(budget)*3;
+    strategy.get_first_try(0, std::allocator<char>{}, fake_connection_provider{}, ozo::none);
+    EXPECT_EQ(budget.tokens(), 0.5);
+}
+
+TEST(retry_strategy, should_share_binary_query_between_tries) {
+    fake_connection_provider provider;
+    connection_mock conn;
+    EXPECT_CALL(conn, close_connection()).WillRepeatedly(Return());
+    const auto strategy = ozo::failover::retry()*3;
+    auto first_try = strategy.get_first_try(0, std::allocator<char>{}, std::addressof(provider), ozo::none,
+        ozo::make_query("SELECT $1", 42));
+    const auto first = ozo::to_binary_query(first_try.get_context()[hana::size_c<2>], ozo::empty_oid_map{});
+    auto second_try = first_try.get_next_try(ozo::tests::error::error, std::addressof(conn));
+    ASSERT_TRUE(second_try);
+    const auto second = ozo::to_binary_query(second_try->get_context()[hana::size_c<2>], ozo::empty_oid_map{});
+    EXPECT_EQ(first.values(), second.values());
+}
+
+struct executor_provider {
+    using connection_type = connection_mock*;
+
+    ozo::tests::io_context* io_ = nullptr;
+    connection_mock* conn_ = nullptr;
+
+    auto get_executor() const { return io_->get_executor();}
+
+    template <typename TimeConstraint, typename Handler>
+    void async_get_connection(TimeConstraint, Handler&& h) const {
+        h(ozo::error_code{}, conn_);
+    }
+};
+
+struct async_get_connection_after : Test {
+    ozo::tests::io_context io;
+    StrictMock<ozo::tests::steady_timer_mock> timer;
+    StrictMock<ozo::tests::callback_gmock<connection_mock*>> callback;
+    connection_mock conn;
+};
+
+TEST_F(async_get_connection_after, should_get_connection_immediately_for_zero_delay) {
+    EXPECT_CALL(callback, call(ozo::error_code{}, &conn));
+    ozo::failover::detail::async_get_connection_after(executor_provider{&io, &conn}, duration{0}, ozo::none,
+        ozo::tests::wrap(callback, io.get_executor()));
+}
+
+TEST_F(async_get_connection_after, should_get_connection_after_delay) {
+    std::function<void(ozo::error_code)> on_timer;
+    EXPECT_CALL(io.timer_service_, timer(Matcher<duration>(5ms))).WillOnce(ReturnRef(timer));
+    EXPECT_CALL(timer, async_wait(_)).WillOnce(SaveArg<0>(&on_timer));
+    ozo::failover::detail::async_get_connection_after(executor_provider{&io, &conn}, 5ms, ozo::none,
+        ozo::tests::wrap(callback, io.get_executor()));
+
+    EXPECT_CALL(io.executor_, post(_)).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(callback, call(ozo::error_code{}, &conn));
+    on_timer(ozo::error_code{});
+}
+
 template <typename Sequence>
 static std::string to_string(const Sequence& v) {
     std::ostringstream s;
@@ -0,0 +1,116 @@
+#include <ozo/core/histogram.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+using ozo::latency_histogram;
+
+TEST(latency_histogram, bucket_should_return_zero_for_interval_less_than_microsecond) {
+    EXPECT_EQ(latency_histogram::bucket(0ns), 0u);
+    EXPECT_EQ(latency_histogram::bucket(999ns), 0u);
+}
+
+TEST(latency_histogram, bucket_should_return_index_of_power_of_two_microseconds_upper_bound) {
+    EXPECT_EQ(latency_histogram::bucket(1us), 1u);
+    EXPECT_EQ(latency_histogram::bucket(3us), 2u);
+    EXPECT_EQ(latency_histogram::bucket(4us), 3u);
+    EXPECT_EQ(latency_histogram::bucket(1ms), 10u);
+}
+
+TEST(latency_histogram, bucket_should_return_last_bucket_for_huge_interval) {
+    EXPECT_EQ(latency_histogram::bucket(24h), latency_histogram::buckets_count - 1);
+}
+
+TEST(latency_histogram, upper_bound_should_be_greater_than_intervals_of_bucket) {
+    EXPECT_EQ(latency_histogram::upper_bound(0), 1us);
+    EXPECT_EQ(latency_histogram::upper_bound(2), 4us);
+    EXPECT_EQ(latency_histogram::upper_bound(latency_histogram::buckets_count - 1), ozo::time_traits::duration::max());
+}
+
+TEST(latency_histogram, quantile_should_return_zero_for_empty_histogram) {
+    EXPECT_EQ(latency_histogram{}.quantile(0.5), ozo::time_traits::duration(0));
+}
+
+TEST(latency_histogram, quantile_should_return_upper_bound_of_bucket_with_quantile) {
+    latency_histogram h;
+    h.buckets[1] = 98;
+    h.buckets[10] = 2;
+    EXPECT_EQ(h.quantile(0), 2us);
+    EXPECT_EQ(h.quantile(0.5), 2us);
+    EXPECT_EQ(h.quantile(0.99), 1024us);
+    EXPECT_EQ(h.quantile(1), 1024us);
+}
+
+TEST(latency_histogram, operator_plus_assign_should_sum_buckets) {
+    latency_histogram a;
+    a.buckets[1] = 1;
+    latency_histogram b;
+    b.buckets[1] = 2;
+    b.buckets[3] = 1;
+    a += b;
+    EXPECT_EQ(a.buckets[1], 3u);
+    EXPECT_EQ(a.buckets[3], 1u);
+    EXPECT_EQ(a.count(), 4u);
+}
+
+TEST(latency_histogram, operator_minus_assign_should_subtract_buckets) {
+    latency_histogram a;
+    a.buckets[1] = 3;
+    a.buckets[3] = 1;
+    latency_histogram b;
+    b.buckets[1] = 2;
+    a -= b;
+    EXPECT_EQ(a.buckets[1], 1u);
+    EXPECT_EQ(a.buckets[3], 1u);
+    EXPECT_EQ(a.count(), 2u);
+}
+
+TEST(atomic_latency_histogram, snapshot_should_return_added_intervals) {
+    ozo::detail::atomic_latency_histogram h;
+    h.add(3us);
+    h.add(3us);
+    h.add(1ms);
+    const auto snapshot = h.snapshot();
+    EXPECT_EQ(snapshot.buckets[2], 2u);
+    EXPECT_EQ(snapshot.buckets[10], 1u);
+    EXPECT_EQ(snapshot.count(), 3u);
+}
+
+using ozo::size_histogram;
+
+TEST(size_histogram, bucket_should_return_index_of_power_of_two_bytes_upper_bound) {
+    EXPECT_EQ(size_histogram::bucket(0), 0u);
+    EXPECT_EQ(size_histogram::bucket(1), 1u);
+    EXPECT_EQ(size_histogram::bucket(3), 2u);
+    EXPECT_EQ(size_histogram::bucket(1024), 11u);
+}
+
+TEST(size_histogram, bucket_should_return_last_bucket_for_huge_size) {
+    EXPECT_EQ(size_histogram::bucket(std::numeric_limits<std::size_t>::max()), size_histogram::buckets_count - 1);
+}
+
+TEST(size_histogram, quantile_should_return_upper_bound_of_bucket_with_quantile) {
+    size_histogram h;
+    h.buckets[size_histogram::bucket(100)] = 9;
+    h.buckets[size_histogram::bucket(1 << 20)] = 1;
+    EXPECT_EQ(h.quantile(0.5), 128u);
+    EXPECT_EQ(h.quantile(1.0), std::size_t(1) << 21);
+    EXPECT_EQ(size_histogram{}.quantile(0.5), 0u);
+}
+
+TEST(atomic_size_histogram, snapshot_should_return_added_sizes) {
+    ozo::detail::atomic_size_histogram h;
+    h.add(100);
+    h.add(100);
+    h.add(1 << 20);
+    const auto snapshot = h.snapshot();
+    EXPECT_EQ(snapshot.count(), 3u);
+    EXPECT_EQ(snapshot.buckets[size_histogram::bucket(100)], 2u);
+}
+
+} // namespace
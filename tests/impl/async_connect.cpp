@@ -328,4 +328,87 @@ TEST_F(async_connect, should_request_oid_map_when_oid_map_is_not_empty) {
     ozo::impl::async_connect("conninfo", time_traits::duration(42), conn, wrap(callback));
 }
 
+#ifdef LIBPQ_HAS_PIPELINING
+
+TEST_F(async_connect, should_send_session_setup_statements_and_oid_map_request_in_one_pipeline) {
+    auto conn = make_connection(f.connection, f.io, f.native_handle, ozo::register_types<custom_type>());
+    conn->session_setup_ = std::make_shared<const std::vector<std::string>>(
+        std::vector<std::string>{"SET search_path TO app", "SET work_mem TO '64MB'"});
+    StrictMock<callback_gmock<decltype(conn)>> callback {};
+
+    execution_context cb_io;
+    EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+    EXPECT_CALL(f.io.strand_service_, get_executor()).WillRepeatedly(ReturnRef(f.strand));
+    EXPECT_CALL(f.io.timer_service_, timer(time_traits::duration(42))).WillRepeatedly(ReturnRef(f.timer));
+    EXPECT_CALL(f.timer, async_wait(_)).WillOnce(Return());
+
+    Sequence s;
+
+    EXPECT_CALL(f.connection, start_connection("conninfo")).InSequence(s).WillOnce(Return(std::addressof(f.handle)));
+    EXPECT_CALL(f.handle, PQstatus()).WillRepeatedly(Return(CONNECTION_OK));
+    EXPECT_CALL(f.connection, assign()).InSequence(s).WillOnce(Return(error_code{}));
+
+    EXPECT_CALL(f.connection, async_wait_write(_)).InSequence(s).WillOnce(InvokeArgument<0>(error_code{}));
+
+    EXPECT_CALL(f.strand, post(_)).InSequence(s).WillOnce(InvokeArgument<0>());
+
+    EXPECT_CALL(f.handle, PQconnectPoll()).InSequence(s).WillOnce(Return(PGRES_POLLING_OK));
+
+    EXPECT_CALL(f.handle, PQsetnonblocking(1)).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(f.handle, PQenterPipelineMode()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(f.handle, PQsendQueryParams(StrEq("SET search_path TO app"), 0, _, _, _, _, _))
+        .InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(f.handle, PQsendQueryParams(StrEq("SET work_mem TO '64MB'"), 0, _, _, _, _, _))
+        .InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(f.handle, PQsendQueryParams(HasSubstr("to_regtype"), 1, _, _, _, _, _))
+        .InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(f.handle, PQpipelineSync()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(f.handle, PQflush()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(f.handle, PQisBusy()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(f.connection, async_wait_read(_)).InSequence(s).WillOnce(Return());
+
+    ozo::impl::async_connect("conninfo", time_traits::duration(42), conn, wrap(callback));
+}
+
+TEST_F(async_connect, should_call_handler_with_error_when_session_setup_send_failed) {
+    auto conn = make_connection(f.connection, f.io, f.native_handle);
+    conn->session_setup_ = std::make_shared<const std::vector<std::string>>(
+        std::vector<std::string>{"SET search_path TO app"});
+    StrictMock<callback_gmock<decltype(conn)>> callback {};
+
+    execution_context cb_io;
+    EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+    EXPECT_CALL(f.io.strand_service_, get_executor()).WillRepeatedly(ReturnRef(f.strand));
+    EXPECT_CALL(f.io.timer_service_, timer(time_traits::duration(42))).WillRepeatedly(ReturnRef(f.timer));
+    std::function<void (error_code)> on_timer_expired;
+    EXPECT_CALL(f.timer, async_wait(_)).WillOnce(SaveArg<0>(&on_timer_expired));
+
+    Sequence s;
+
+    EXPECT_CALL(f.connection, start_connection("conninfo")).InSequence(s).WillOnce(Return(std::addressof(f.handle)));
+    EXPECT_CALL(f.handle, PQstatus()).WillRepeatedly(Return(CONNECTION_OK));
+    EXPECT_CALL(f.connection, assign()).InSequence(s).WillOnce(Return(error_code{}));
+
+    EXPECT_CALL(f.connection, async_wait_write(_)).InSequence(s).WillOnce(InvokeArgument<0>(error_code{}));
+
+    EXPECT_CALL(f.strand, post(_)).InSequence(s).WillOnce(InvokeArgument<0>());
+
+    EXPECT_CALL(f.handle, PQconnectPoll()).InSequence(s).WillOnce(Return(PGRES_POLLING_OK));
+
+    EXPECT_CALL(f.handle, PQsetnonblocking(1)).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(f.handle, PQenterPipelineMode()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(f.handle, PQsendQueryParams(_, _, _, _, _, _, _)).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(f.connection, cancel()).InSequence(s).WillOnce(Return());
+    EXPECT_CALL(f.strand, dispatch(_)).InSequence(s).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(f.timer, cancel()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(f.strand, post(_)).InSequence(s).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(cb_io.executor_, dispatch(_)).InSequence(s).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(callback, call(error_code{ozo::error::pg_send_query_params_failed}, conn)).InSequence(s).WillOnce(Return());
+
+    ozo::impl::async_connect("conninfo", time_traits::duration(42), conn, wrap(callback));
+    on_timer_expired(boost::asio::error::operation_aborted);
+}
+
+#endif
+
 } // namespace
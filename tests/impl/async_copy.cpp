@@ -0,0 +1,400 @@
+#include <connection_mock.h>
+#include <test_error.h>
+
+#include <ozo/copy.h>
+#include <ozo/ext/std/tuple.h>
+#include <ozo/pg/types/integer.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace ozo::tests {
+
+struct throwing_copy_value {};
+
+} // namespace ozo::tests
+
+OZO_PG_DEFINE_CUSTOM_TYPE(ozo::tests::throwing_copy_value, "throwing_copy_value")
+
+namespace ozo {
+
+template <>
+struct size_of_impl<tests::throwing_copy_value> {
+    static size_type apply(const tests::throwing_copy_value&) { return 4;}
+};
+
+template <>
+struct send_impl<tests::throwing_copy_value> {
+    template <typename OidMap>
+    static ostream& apply(ostream&, const OidMap&, const tests::throwing_copy_value&) {
+        throw std::length_error("throwing_copy_value is too long");
+    }
+};
+
+} // namespace ozo
+
+namespace {
+
+using namespace testing;
+using namespace ozo::tests;
+
+using callback_mock = callback_gmock<connection_ptr<>>;
+
+using ozo::error_code;
+
+struct fixture {
+    StrictMock<connection_gmock> connection{};
+    StrictMock<PGconn_mock> native_handle{};
+    StrictMock<callback_mock> callback{};
+    io_context io;
+    execution_context cb_io;
+    connection_ptr<> conn = make_connection(connection, io, native_handle);
+
+    auto make_operation_context() {
+        EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+        return ozo::impl::make_request_operation_context(conn, wrap(callback));
+    }
+
+    decltype(ozo::impl::make_request_operation_context(conn, wrap(callback))) ctx;
+
+    fixture() : ctx(make_operation_context()) {}
+};
+
+struct async_copy_in_data : Test {
+    fixture m;
+    std::vector<std::tuple<std::int32_t>> rows {{1}, {2}};
+    std::string data;
+    ozo::tests::pg_result copy_in {PGRES_COPY_IN, nullptr};
+    ozo::tests::pg_result command_ok {PGRES_COMMAND_OK, nullptr};
+    ozo::tests::pg_result fatal {PGRES_FATAL_ERROR, "42P01"};
+
+    auto append_data() {
+        return Invoke([&] (const char* buf, int size) { data.append(buf, size); return 1; });
+    }
+
+    static std::string expected_data() {
+        using namespace std::string_literals;
+        return "PGCOPY\n\377\r\n\0"s
+            + "\0\0\0\0"s + "\0\0\0\0"s         // flags, header extension area length
+            + "\0\1"s + "\0\0\0\4"s + "\0\0\0\1"s // row {1}
+            + "\0\1"s + "\0\0\0\4"s + "\0\0\0\2"s // row {2}
+            + "\377\377"s;                      // trailer
+    }
+};
+
+TEST_F(async_copy_in_data, should_send_rows_in_binary_format_and_copy_end_and_call_handler) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&copy_in));
+    EXPECT_CALL(m.native_handle, PQputCopyData(_, _)).WillOnce(append_data());
+    EXPECT_CALL(m.native_handle, PQputCopyEnd(nullptr)).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQflush()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&command_ok));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.callback, call(error_code{}, _)).WillOnce(Return());
+
+    ozo::impl::async_copy_in_data(m.ctx, rows);
+
+    EXPECT_EQ(data, expected_data());
+}
+
+TEST_F(async_copy_in_data, should_wait_for_write_and_put_data_again_if_it_has_not_been_queued) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&copy_in));
+    EXPECT_CALL(m.native_handle, PQputCopyData(_, _)).WillOnce(Return(0));
+    EXPECT_CALL(m.connection, async_wait_write(_)).WillOnce(InvokeArgument<0>(error_code{}));
+    EXPECT_CALL(m.cb_io.executor_, post(_)).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(m.native_handle, PQputCopyData(_, _)).WillOnce(append_data());
+    EXPECT_CALL(m.native_handle, PQputCopyEnd(nullptr)).WillOnce(Return(0));
+    EXPECT_CALL(m.connection, async_wait_write(_)).WillOnce(InvokeArgument<0>(error_code{}));
+    EXPECT_CALL(m.cb_io.executor_, post(_)).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(m.native_handle, PQputCopyEnd(nullptr)).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQflush()).WillOnce(Return(1));
+    EXPECT_CALL(m.connection, async_wait_write(_)).WillOnce(InvokeArgument<0>(error_code{}));
+    EXPECT_CALL(m.cb_io.executor_, post(_)).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(m.native_handle, PQflush()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&command_ok));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.callback, call(error_code{}, _)).WillOnce(Return());
+
+    ozo::impl::async_copy_in_data(m.ctx, rows);
+
+    EXPECT_EQ(data, expected_data());
+}
+
+TEST_F(async_copy_in_data, should_send_data_by_chunks_if_it_exceeds_buffer_size) {
+    const std::vector<std::tuple<std::int32_t>> many_rows(ozo::impl::copy_buffer_size / 10 + 1);
+    std::size_t chunks = 0;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillRepeatedly(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult())
+        .WillOnce(Return(&copy_in))
+        .WillOnce(Return(&command_ok))
+        .WillOnce(Return(nullptr));
+    EXPECT_CALL(m.native_handle, PQputCopyData(_, _)).WillRepeatedly(Invoke([&] (const char*, int size) {
+        EXPECT_LE(std::size_t(size), ozo::impl::copy_buffer_size + 10);
+        ++chunks;
+        return 1;
+    }));
+    EXPECT_CALL(m.native_handle, PQputCopyEnd(nullptr)).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQflush()).WillOnce(Return(0));
+    EXPECT_CALL(m.callback, call(error_code{}, _)).WillOnce(Return());
+
+    ozo::impl::async_copy_in_data(m.ctx, std::cref(many_rows));
+
+    EXPECT_EQ(chunks, 2u);
+}
+
+TEST_F(async_copy_in_data, should_call_handler_with_error_if_put_copy_data_failed) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&copy_in));
+    EXPECT_CALL(m.native_handle, PQputCopyData(_, _)).WillOnce(Return(-1));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::pg_put_copy_data_failed}, _)).WillOnce(Return());
+
+    ozo::impl::async_copy_in_data(m.ctx, rows);
+}
+
+TEST_F(async_copy_in_data, should_call_handler_with_error_if_put_copy_end_failed) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&copy_in));
+    EXPECT_CALL(m.native_handle, PQputCopyData(_, _)).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQputCopyEnd(nullptr)).WillOnce(Return(-1));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::pg_put_copy_end_failed}, _)).WillOnce(Return());
+
+    ozo::impl::async_copy_in_data(m.ctx, rows);
+}
+
+TEST_F(async_copy_in_data, should_call_handler_with_bad_result_process_if_row_serialization_throws) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&copy_in));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::bad_result_process}, _)).WillOnce(Return());
+
+    ozo::impl::async_copy_in_data(m.ctx, std::vector<std::tuple<ozo::tests::throwing_copy_value>>(1));
+
+    EXPECT_THAT(m.conn->get_error_context(), HasSubstr("throwing_copy_value is too long"));
+}
+
+TEST_F(async_copy_in_data, should_consume_results_and_call_handler_with_database_error_if_copy_failed) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&copy_in));
+    EXPECT_CALL(m.native_handle, PQputCopyData(_, _)).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQputCopyEnd(nullptr)).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQflush()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&fatal));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(ozo::sqlstate::make_error_code(ozo::sqlstate::undefined_table), _)).WillOnce(Return());
+
+    ozo::impl::async_copy_in_data(m.ctx, rows);
+}
+
+TEST_F(async_copy_in_data, should_not_send_data_and_call_handler_with_database_error_if_query_failed) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&fatal));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(ozo::sqlstate::make_error_code(ozo::sqlstate::undefined_table), _)).WillOnce(Return());
+
+    ozo::impl::async_copy_in_data(m.ctx, rows);
+}
+
+TEST_F(async_copy_in_data, should_call_handler_with_result_status_unexpected_if_query_is_not_copy) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&command_ok));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::result_status_unexpected}, _)).WillOnce(Return());
+
+    ozo::impl::async_copy_in_data(m.ctx, rows);
+}
+
+TEST_F(async_copy_in_data, should_send_rows_written_into_closed_channel_and_copy_end_and_call_handler) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&copy_in));
+    EXPECT_CALL(m.native_handle, PQputCopyData(_, _)).WillOnce(append_data());
+    EXPECT_CALL(m.native_handle, PQputCopyEnd(nullptr)).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQflush()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&command_ok));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.callback, call(error_code{}, _)).WillOnce(Return());
+
+    boost::asio::io_context producer_io;
+    auto channel = std::make_shared<ozo::impl::copy_in_channel>(ozo::impl::copy_buffer_size);
+    for (const auto& row : rows) {
+        channel->write(ozo::empty_oid_map{}, row,
+            ozo::impl::make_copy_in_waiter([] (error_code) {}, producer_io.get_executor()));
+    }
+    channel->close();
+
+    ozo::impl::async_copy_in_data(m.ctx, channel);
+
+    EXPECT_EQ(data, expected_data());
+}
+
+TEST_F(async_copy_in_data, should_exit_if_query_state_is_error) {
+    m.ctx->state = ozo::impl::query_state::error;
+    ozo::impl::async_copy_in_data(m.ctx, rows);
+}
+
+struct async_copy_out_data : Test {
+    fixture m;
+    std::vector<std::int32_t> rows;
+    ozo::tests::pg_result copy_out {PGRES_COPY_OUT, nullptr};
+    ozo::tests::pg_result command_ok {PGRES_COMMAND_OK, nullptr};
+    ozo::tests::pg_result fatal {PGRES_FATAL_ERROR, "42P01"};
+
+    static auto return_data(std::string data) {
+        return Invoke([data] (char** buffer, int) {
+            *buffer = static_cast<char*>(std::malloc(data.size()));
+            std::copy(data.begin(), data.end(), *buffer);
+            return int(data.size());
+        });
+    }
+
+    static std::string header_and_row(std::int32_t v) {
+        using namespace std::string_literals;
+        return "PGCOPY\n\377\r\n\0"s + "\0\0\0\0"s + "\0\0\0\0"s + row(v);
+    }
+
+    static std::string row(std::int32_t v) {
+        using namespace std::string_literals;
+        return "\0\1"s + "\0\0\0\4"s + "\0\0\0"s + char(v);
+    }
+
+    static std::string trailer() {
+        return "\377\377";
+    }
+};
+
+TEST_F(async_copy_out_data, should_receive_rows_as_they_arrive_and_call_handler) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&copy_out));
+    EXPECT_CALL(m.native_handle, PQgetCopyData(_, 1)).WillOnce(return_data(header_and_row(1)));
+    EXPECT_CALL(m.native_handle, PQgetCopyData(_, 1)).WillOnce(Return(0));
+    EXPECT_CALL(m.connection, async_wait_read(_)).WillOnce(InvokeArgument<0>(error_code{}));
+    EXPECT_CALL(m.cb_io.executor_, post(_)).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(m.native_handle, PQconsumeInput()).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQgetCopyData(_, 1)).WillOnce(return_data(row(2)));
+    EXPECT_CALL(m.native_handle, PQgetCopyData(_, 1)).WillOnce(return_data(trailer()));
+    EXPECT_CALL(m.native_handle, PQgetCopyData(_, 1)).WillOnce(Return(-1));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&command_ok));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.callback, call(error_code{}, _)).WillOnce(Return());
+
+    ozo::impl::async_copy_out_data(m.ctx, ozo::impl::copy_out_into_handler {std::back_inserter(rows)});
+
+    EXPECT_THAT(rows, ElementsAre(1, 2));
+}
+
+TEST_F(async_copy_out_data, should_pass_rows_to_callback_for_copy_rows_output) {
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillRepeatedly(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult())
+        .WillOnce(Return(&copy_out))
+        .WillOnce(Return(&command_ok))
+        .WillOnce(Return(nullptr));
+    EXPECT_CALL(m.native_handle, PQgetCopyData(_, 1))
+        .WillOnce(return_data(header_and_row(1)))
+        .WillOnce(return_data(row(2)))
+        .WillOnce(return_data(trailer()))
+        .WillOnce(Return(-1));
+    EXPECT_CALL(m.callback, call(error_code{}, _)).WillOnce(Return());
+
+    ozo::impl::async_copy_out_data(m.ctx, ozo::copy_rows<std::tuple<std::int32_t>>([&] (auto row) {
+        rows.push_back(std::get<0>(row));
+    }));
+
+    EXPECT_THAT(rows, ElementsAre(1, 2));
+}
+
+TEST_F(async_copy_out_data, should_call_handler_with_error_if_get_copy_data_failed) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&copy_out));
+    EXPECT_CALL(m.native_handle, PQgetCopyData(_, 1)).WillOnce(Return(-2));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::pg_get_copy_data_failed}, _)).WillOnce(Return());
+
+    ozo::impl::async_copy_out_data(m.ctx, ozo::impl::copy_out_into_handler {std::back_inserter(rows)});
+}
+
+TEST_F(async_copy_out_data, should_call_handler_with_bad_result_process_immediately_for_malformed_data) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&copy_out));
+    EXPECT_CALL(m.native_handle, PQgetCopyData(_, 1)).WillOnce(return_data(std::string(32, 'x')));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::bad_result_process}, _)).WillOnce(Return());
+
+    ozo::impl::async_copy_out_data(m.ctx, ozo::impl::copy_out_into_handler {std::back_inserter(rows)});
+
+    EXPECT_THAT(m.conn->get_error_context(), HasSubstr("COPY binary format signature not found"));
+}
+
+TEST_F(async_copy_out_data, should_consume_results_and_call_handler_with_database_error_if_copy_failed) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&copy_out));
+    EXPECT_CALL(m.native_handle, PQgetCopyData(_, 1)).WillOnce(Return(-1));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&fatal));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(ozo::sqlstate::make_error_code(ozo::sqlstate::undefined_table), _)).WillOnce(Return());
+
+    ozo::impl::async_copy_out_data(m.ctx, ozo::impl::copy_out_into_handler {std::back_inserter(rows)});
+}
+
+TEST_F(async_copy_out_data, should_call_handler_with_result_status_unexpected_if_query_is_not_copy) {
+    ozo::tests::pg_result tuples_ok {PGRES_TUPLES_OK, nullptr};
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&tuples_ok));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::result_status_unexpected}, _)).WillOnce(Return());
+
+    ozo::impl::async_copy_out_data(m.ctx, ozo::impl::copy_out_into_handler {std::back_inserter(rows)});
+}
+
+TEST_F(async_copy_out_data, should_exit_if_query_state_is_error) {
+    m.ctx->state = ozo::impl::query_state::error;
+    ozo::impl::async_copy_out_data(m.ctx, ozo::impl::copy_out_into_handler {std::back_inserter(rows)});
+}
+
+} // namespace
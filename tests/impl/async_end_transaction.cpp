@@ -24,6 +24,7 @@ struct async_end_transaction : Test {
     connection_ptr<> conn = make_connection(connection, io, handle);
     decltype(ozo::make_options()) options = ozo::make_options();
     time_traits::duration timeout {42};
+    execution_context cb_io;
 };
 
 TEST_F(async_end_transaction, should_call_async_execute) {
@@ -38,4 +39,55 @@ TEST_F(async_end_transaction, should_call_async_execute) {
     ozo::detail::async_end_transaction(std::move(transaction), empty_query {}, timeout, wrap(callback));
 }
 
+#ifdef LIBPQ_HAS_PIPELINING
+
+TEST_F(async_end_transaction, should_call_handler_without_async_execute_if_begin_is_pending) {
+    const auto deferred = ozo::make_options(ozo::transaction_options::deferred_begin = std::true_type{});
+    auto transaction = ozo::transaction(std::move(conn), deferred);
+
+    EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+
+    const InSequence s;
+
+    EXPECT_CALL(handle, PQtransactionStatus()).WillOnce(Return(PQTRANS_IDLE));
+    EXPECT_CALL(cb_io.executor_, dispatch(_)).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(callback, call(error_code {}, _)).WillOnce(Return());
+
+    ozo::detail::async_end_transaction(std::move(transaction), empty_query {}, timeout, wrap(callback));
+}
+
+TEST_F(async_end_transaction, should_call_async_execute_if_begin_has_been_sent) {
+    const auto deferred = ozo::make_options(ozo::transaction_options::deferred_begin = std::true_type{});
+    auto transaction = ozo::transaction(std::move(conn), deferred);
+
+    EXPECT_CALL(handle, PQstatus()).WillRepeatedly(Return(CONNECTION_OK));
+
+    const InSequence s;
+
+    EXPECT_CALL(handle, PQtransactionStatus()).WillOnce(Return(PQTRANS_INTRANS));
+    EXPECT_CALL(connection, async_execute()).WillOnce(Return());
+
+    ozo::detail::async_end_transaction(std::move(transaction), empty_query {}, timeout, wrap(callback));
+}
+
+TEST_F(async_end_transaction, should_call_handler_without_async_execute_if_begin_is_elided) {
+    const auto lazy = ozo::make_options(
+        ozo::transaction_options::mode = ozo::transaction_mode::read_only,
+        ozo::transaction_options::lazy_begin = std::true_type{});
+    auto transaction = ozo::transaction(std::move(conn), lazy);
+    transaction.elide_begin();
+
+    EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+
+    const InSequence s;
+
+    EXPECT_CALL(handle, PQtransactionStatus()).WillOnce(Return(PQTRANS_IDLE));
+    EXPECT_CALL(cb_io.executor_, dispatch(_)).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(callback, call(error_code {}, _)).WillOnce(Return());
+
+    ozo::detail::async_end_transaction(std::move(transaction), empty_query {}, timeout, wrap(callback));
+}
+
+#endif
+
 } // namespace
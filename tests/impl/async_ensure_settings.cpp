@@ -0,0 +1,191 @@
+#include <connection_mock.h>
+#include <test_error.h>
+
+#include <ozo/ensure_settings.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+using namespace ozo::tests;
+
+using callback_mock = callback_gmock<connection_ptr<>>;
+
+using ozo::error_code;
+
+struct fixture : Test {
+    StrictMock<connection_gmock> connection{};
+    StrictMock<PGconn_mock> native_handle{};
+    StrictMock<callback_mock> callback{};
+    io_context io;
+    connection_ptr<> conn = make_connection(connection, io, native_handle);
+};
+
+struct get_settings_changes : fixture {};
+
+TEST_F(get_settings_changes, should_return_parameters_not_reported_and_not_set_before) {
+    EXPECT_CALL(native_handle, PQparameterStatus(StrEq("work_mem"))).WillOnce(Return(nullptr));
+
+    const auto changes = ozo::impl::get_settings_changes(*conn, ozo::session_parameters{{"work_mem", "64MB"}});
+
+    EXPECT_THAT(changes.names, ElementsAre("work_mem"));
+    EXPECT_THAT(changes.values, ElementsAre("64MB"));
+}
+
+TEST_F(get_settings_changes, should_skip_parameter_reported_with_the_same_value) {
+    EXPECT_CALL(native_handle, PQparameterStatus(StrEq("application_name"))).WillOnce(Return("billing"));
+
+    const auto changes = ozo::impl::get_settings_changes(*conn, ozo::session_parameters{{"application_name", "billing"}});
+
+    EXPECT_THAT(changes.names, IsEmpty());
+}
+
+TEST_F(get_settings_changes, should_return_parameter_reported_with_other_value) {
+    EXPECT_CALL(native_handle, PQparameterStatus(StrEq("application_name"))).WillOnce(Return("psql"));
+
+    const auto changes = ozo::impl::get_settings_changes(*conn, ozo::session_parameters{{"application_name", "billing"}});
+
+    EXPECT_THAT(changes.names, ElementsAre("application_name"));
+    EXPECT_THAT(changes.values, ElementsAre("billing"));
+}
+
+TEST_F(get_settings_changes, should_lower_parameter_names) {
+    EXPECT_CALL(native_handle, PQparameterStatus(StrEq("timezone"))).WillOnce(Return(nullptr));
+
+    const auto changes = ozo::impl::get_settings_changes(*conn, ozo::session_parameters{{"TimeZone", "UTC"}});
+
+    EXPECT_THAT(changes.names, ElementsAre("timezone"));
+}
+
+TEST_F(get_settings_changes, should_skip_parameter_set_before_with_the_same_value) {
+    conn->session_settings().set("work_mem", "64MB", std::nullopt);
+    EXPECT_CALL(native_handle, PQparameterStatus(StrEq("work_mem"))).WillOnce(Return(nullptr));
+
+    const auto changes = ozo::impl::get_settings_changes(*conn, ozo::session_parameters{{"work_mem", "64MB"}});
+
+    EXPECT_THAT(changes.names, IsEmpty());
+}
+
+TEST_F(get_settings_changes, should_return_parameter_set_before_with_other_value) {
+    conn->session_settings().set("work_mem", "4MB", std::nullopt);
+    EXPECT_CALL(native_handle, PQparameterStatus(StrEq("work_mem"))).WillOnce(Return(nullptr));
+
+    const auto changes = ozo::impl::get_settings_changes(*conn, ozo::session_parameters{{"work_mem", "64MB"}});
+
+    EXPECT_THAT(changes.names, ElementsAre("work_mem"));
+}
+
+TEST_F(get_settings_changes, should_return_parameter_set_before_and_reported_changed_since) {
+    conn->session_settings().set("timezone", "utc", std::string("UTC"));
+    EXPECT_CALL(native_handle, PQparameterStatus(StrEq("timezone"))).WillOnce(Return("Europe/Moscow"));
+
+    const auto changes = ozo::impl::get_settings_changes(*conn, ozo::session_parameters{{"timezone", "utc"}});
+
+    EXPECT_THAT(changes.names, ElementsAre("timezone"));
+}
+
+TEST_F(get_settings_changes, should_skip_parameter_set_before_and_reported_not_changed_since) {
+    conn->session_settings().set("timezone", "utc", std::string("UTC"));
+    EXPECT_CALL(native_handle, PQparameterStatus(StrEq("timezone"))).WillOnce(Return("UTC"));
+
+    const auto changes = ozo::impl::get_settings_changes(*conn, ozo::session_parameters{{"timezone", "utc"}});
+
+    EXPECT_THAT(changes.names, IsEmpty());
+}
+
+struct async_ensure_settings_op : fixture {};
+
+TEST_F(async_ensure_settings_op, should_call_handler_without_request_when_nothing_changed) {
+    EXPECT_CALL(native_handle, PQparameterStatus(StrEq("application_name"))).WillOnce(Return("billing"));
+    EXPECT_CALL(callback, call(error_code{}, conn)).WillOnce(Return());
+
+    ozo::impl::async_ensure_settings_op<ozo::session_parameters, ozo::none_t, decltype(wrap(callback))> {
+        {{"application_name", "billing"}}, ozo::none, wrap(callback)
+    }(error_code{}, conn);
+}
+
+TEST_F(async_ensure_settings_op, should_request_when_parameter_changed) {
+    EXPECT_CALL(native_handle, PQparameterStatus(StrEq("work_mem"))).WillOnce(Return(nullptr));
+    EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(io.get_executor()));
+    EXPECT_CALL(connection, async_execute()).WillOnce(Return());
+
+    ozo::impl::async_ensure_settings_op<ozo::session_parameters, ozo::none_t, decltype(wrap(callback))> {
+        {{"work_mem", "64MB"}}, ozo::none, wrap(callback)
+    }(error_code{}, conn);
+}
+
+TEST_F(async_ensure_settings_op, should_call_handler_with_error_of_getting_connection) {
+    EXPECT_CALL(callback, call(error_code{error::error}, conn)).WillOnce(Return());
+
+    ozo::impl::async_ensure_settings_op<ozo::session_parameters, ozo::none_t, decltype(wrap(callback))> {
+        {{"work_mem", "64MB"}}, ozo::none, wrap(callback)
+    }(error::error, conn);
+}
+
+struct apply_settings_op : fixture {
+    auto make_op() {
+        EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(io.get_executor()));
+        return ozo::impl::apply_settings_op<decltype(wrap(callback))> {
+            *conn, ozo::impl::settings_changes{{"timezone", "work_mem"}, {"utc", "64MB"}}, wrap(callback)
+        };
+    }
+};
+
+TEST_F(apply_settings_op, should_store_parameters_set_out_of_transaction) {
+    auto op = make_op();
+    EXPECT_CALL(native_handle, PQtransactionStatus()).WillOnce(Return(PQTRANS_IDLE));
+    EXPECT_CALL(native_handle, PQparameterStatus(StrEq("timezone"))).WillOnce(Return("UTC"));
+    EXPECT_CALL(native_handle, PQparameterStatus(StrEq("work_mem"))).WillOnce(Return(nullptr));
+    EXPECT_CALL(callback, call(error_code{}, conn)).WillOnce(Return());
+
+    op(error_code{}, conn);
+
+    const auto timezone = conn->session_settings().find("timezone");
+    ASSERT_TRUE(timezone);
+    EXPECT_EQ(timezone->value, "utc");
+    EXPECT_EQ(timezone->reported, std::optional<std::string>("UTC"));
+    const auto work_mem = conn->session_settings().find("work_mem");
+    ASSERT_TRUE(work_mem);
+    EXPECT_EQ(work_mem->value, "64MB");
+    EXPECT_EQ(work_mem->reported, std::nullopt);
+}
+
+TEST_F(apply_settings_op, should_not_store_parameters_set_within_transaction) {
+    auto op = make_op();
+    EXPECT_CALL(native_handle, PQtransactionStatus()).WillOnce(Return(PQTRANS_INTRANS));
+    EXPECT_CALL(callback, call(error_code{}, conn)).WillOnce(Return());
+
+    op(error_code{}, conn);
+
+    EXPECT_TRUE(conn->session_settings().empty());
+}
+
+TEST_F(apply_settings_op, should_not_store_parameters_on_error) {
+    auto op = make_op();
+    EXPECT_CALL(callback, call(error_code{error::error}, conn)).WillOnce(Return());
+
+    op(error::error, conn);
+
+    EXPECT_TRUE(conn->session_settings().empty());
+}
+
+TEST(session_settings, should_replace_value_of_parameter_set_again) {
+    ozo::detail::session_settings settings;
+    settings.set("work_mem", "4MB", std::nullopt);
+    settings.set("work_mem", "64MB", std::nullopt);
+
+    EXPECT_EQ(settings.size(), 1u);
+    EXPECT_EQ(settings.find("work_mem")->value, "64MB");
+}
+
+TEST(session_settings, should_forget_parameters_on_clear) {
+    ozo::detail::session_settings settings;
+    settings.set("work_mem", "64MB", std::nullopt);
+    settings.clear();
+
+    EXPECT_EQ(settings.find("work_mem"), nullptr);
+}
+
+} // namespace
@@ -0,0 +1,194 @@
+#include <connection_mock.h>
+#include <test_error.h>
+
+#include <ozo/execute_batch.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#ifdef LIBPQ_HAS_PIPELINING
+
+namespace {
+
+namespace hana = boost::hana;
+
+using namespace testing;
+using namespace ozo::tests;
+
+using callback_mock = callback_gmock<connection_ptr<>>;
+
+using ozo::error_code;
+
+struct fixture {
+    StrictMock<connection_gmock> connection{};
+    StrictMock<PGconn_mock> native_handle{};
+    StrictMock<callback_mock> callback{};
+    io_context io;
+    execution_context cb_io;
+    connection_ptr<> conn = make_connection(connection, io, native_handle);
+
+    auto make_operation_context() {
+        EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+        return ozo::impl::make_request_operation_context(conn, wrap(callback));
+    }
+
+    decltype(ozo::impl::make_request_operation_context(conn, wrap(callback))) ctx;
+
+    fixture() : ctx(make_operation_context()) {}
+};
+
+const auto two_queries = hana::make_tuple(empty_query {}, empty_query {});
+
+struct async_send_batch : Test {
+    fixture m;
+};
+
+TEST_F(async_send_batch, should_enter_pipeline_mode_send_each_query_with_sync_and_flush) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQsetnonblocking(1)).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQenterPipelineMode()).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQsendQueryParams(_, _, _, _, _, _, _)).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQpipelineSync()).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQsendQueryParams(_, _, _, _, _, _, _)).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQpipelineSync()).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQflush()).WillOnce(Return(0));
+
+    ozo::impl::async_send_batch(m.ctx, two_queries);
+
+    EXPECT_EQ(m.ctx->state, ozo::impl::query_state::send_finish);
+}
+
+TEST_F(async_send_batch, should_send_runtime_range_of_queries) {
+    const InSequence s;
+    const std::vector<ozo::binary_query> queries(3, ozo::to_binary_query(empty_query {}, ozo::empty_oid_map{}));
+
+    EXPECT_CALL(m.native_handle, PQsetnonblocking(1)).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQenterPipelineMode()).WillOnce(Return(1));
+    for (std::size_t i = 0; i < queries.size(); ++i) {
+        EXPECT_CALL(m.native_handle, PQsendQueryParams(_, _, _, _, _, _, _)).WillOnce(Return(1));
+        EXPECT_CALL(m.native_handle, PQpipelineSync()).WillOnce(Return(1));
+    }
+    EXPECT_CALL(m.native_handle, PQflush()).WillOnce(Return(0));
+
+    ozo::impl::async_send_batch(m.ctx, queries);
+
+    EXPECT_EQ(ozo::impl::batch_size(queries), 3u);
+}
+
+TEST_F(async_send_batch, should_stop_sending_and_call_handler_with_error_if_send_query_params_failed) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQsetnonblocking(1)).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQenterPipelineMode()).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQsendQueryParams(_, _, _, _, _, _, _)).WillOnce(Return(0));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::pg_send_query_params_failed}, _)).WillOnce(Return());
+
+    ozo::impl::async_send_batch(m.ctx, two_queries);
+}
+
+TEST_F(async_send_batch, should_stop_sending_and_call_handler_with_error_if_pipeline_sync_failed) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQsetnonblocking(1)).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQenterPipelineMode()).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQsendQueryParams(_, _, _, _, _, _, _)).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQpipelineSync()).WillOnce(Return(0));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::pg_pipeline_sync_failed}, _)).WillOnce(Return());
+
+    ozo::impl::async_send_batch(m.ctx, two_queries);
+}
+
+struct async_get_batch_results : Test {
+    fixture m;
+    ozo::tests::pg_result inserted {PGRES_COMMAND_OK, nullptr, "3"};
+    ozo::tests::pg_result selected {PGRES_TUPLES_OK, nullptr, "7"};
+    ozo::tests::pg_result fatal {PGRES_FATAL_ERROR, "42P01", "", "relation does not exist"};
+    ozo::tests::pg_result sync {PGRES_PIPELINE_SYNC, nullptr};
+    std::vector<ozo::batch_statement_result> results;
+};
+
+TEST_F(async_get_batch_results, should_write_result_of_each_statement_up_to_last_sync_and_exit_pipeline_mode) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&inserted));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&sync));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(1));
+    EXPECT_CALL(m.connection, async_wait_read(_)).WillOnce(InvokeArgument<0>(error_code{}));
+    EXPECT_CALL(m.cb_io.executor_, post(_)).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(m.native_handle, PQconsumeInput()).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&selected));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&sync));
+    EXPECT_CALL(m.native_handle, PQexitPipelineMode()).WillOnce(Return(1));
+    EXPECT_CALL(m.callback, call(error_code{}, _)).WillOnce(Return());
+
+    ozo::impl::async_get_batch_results(m.ctx, std::back_inserter(results), 2);
+
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_FALSE(results[0].ec);
+    EXPECT_EQ(results[0].rows, 3u);
+    EXPECT_FALSE(results[1].ec);
+    EXPECT_EQ(results[1].rows, 7u);
+}
+
+TEST_F(async_get_batch_results, should_continue_after_failed_statement_and_call_handler_with_first_error) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&fatal));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&sync));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&inserted));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&sync));
+    EXPECT_CALL(m.native_handle, PQexitPipelineMode()).WillOnce(Return(1));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(ozo::sqlstate::make_error_code(ozo::sqlstate::undefined_table), _)).WillOnce(Return());
+
+    ozo::impl::async_get_batch_results(m.ctx, std::back_inserter(results), 2);
+
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_EQ(results[0].ec, ozo::sqlstate::undefined_table);
+    EXPECT_EQ(results[0].error_message, "relation does not exist");
+    EXPECT_EQ(results[0].rows, 0u);
+    EXPECT_FALSE(results[1].ec);
+    EXPECT_EQ(results[1].rows, 3u);
+    EXPECT_EQ(ozo::get_error_context(m.conn), "batch statement #0 failed: relation does not exist");
+}
+
+TEST_F(async_get_batch_results, should_call_handler_with_error_if_exit_pipeline_mode_failed) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&sync));
+    EXPECT_CALL(m.native_handle, PQexitPipelineMode()).WillOnce(Return(0));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::pg_exit_pipeline_mode_failed}, _)).WillOnce(Return());
+
+    ozo::impl::async_get_batch_results(m.ctx, std::back_inserter(results), 1);
+}
+
+TEST_F(async_get_batch_results, should_exit_if_query_state_is_error) {
+    m.ctx->state = ozo::impl::query_state::error;
+    ozo::impl::async_get_batch_results(m.ctx, std::back_inserter(results), 2);
+    EXPECT_TRUE(results.empty());
+}
+
+} // namespace
+
+#endif
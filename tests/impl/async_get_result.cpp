@@ -6,6 +6,9 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <sys/socket.h>
+#include <unistd.h>
+
 namespace {
 
 namespace asio = boost::asio;
@@ -130,6 +133,7 @@ INSTANTIATE_TEST_SUITE_P(
 
 struct process_mock {
     MOCK_CONST_METHOD0(call, void());
+    MOCK_CONST_METHOD0(call_with_error, error_code());
 };
 
 struct process_wrapper {
@@ -138,6 +142,12 @@ struct process_wrapper {
     void operator() (Ts&& ...) const { mock.call(); }
 };
 
+struct error_code_process_wrapper {
+    process_mock& mock;
+    template <typename ...Ts>
+    error_code operator() (Ts&& ...) const { return mock.call_with_error(); }
+};
+
 struct async_get_result : Test {
     fixture m;
     StrictMock<process_mock> process;
@@ -155,11 +165,39 @@ TEST_F(async_get_result, should_wait_for_read_and_consume_input_while_is_busy_re
     // Consume input
     EXPECT_CALL(m.native_handle, PQconsumeInput()).InSequence(s).WillOnce(Return(1));
 
-    // Wait for read while PQisBusy() which returns 1
+    // Wait for read while PQisBusy() which returns 1 and no data is on the socket
+    EXPECT_CALL(m.native_handle, PQisBusy()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQsocket()).InSequence(s).WillOnce(Return(-1));
+    EXPECT_CALL(m.connection, async_wait_read(_)).InSequence(s).WillOnce(Return());
+
+    ozo::impl::async_get_result(m.ctx, process_f);
+}
+
+TEST_F(async_get_result, should_consume_input_without_wait_for_read_while_data_is_on_socket) {
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    ASSERT_EQ(write(fds[1], "result", 6), 6);
+
+    Sequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(m.connection, async_wait_read(_)).InSequence(s).WillOnce(InvokeArgument<0>(error_code{}));
+    EXPECT_CALL(m.cb_io.executor_, post(_)).InSequence(s).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(m.native_handle, PQconsumeInput()).InSequence(s).WillOnce(Return(1));
+
+    // More data has been received meanwhile, so consume it at once
+    EXPECT_CALL(m.native_handle, PQisBusy()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQsocket()).InSequence(s).WillOnce(Return(fds[0]));
+    EXPECT_CALL(m.native_handle, PQconsumeInput()).InSequence(s).WillOnce(Return(1));
+
     EXPECT_CALL(m.native_handle, PQisBusy()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQsocket()).InSequence(s).WillOnce(Return(-1));
     EXPECT_CALL(m.connection, async_wait_read(_)).InSequence(s).WillOnce(Return());
 
     ozo::impl::async_get_result(m.ctx, process_f);
+
+    close(fds[0]);
+    close(fds[1]);
 }
 
 TEST_F(async_get_result, should_post_callback_with_error_if_consume_input_failed) {
@@ -183,6 +221,53 @@ TEST_F(async_get_result, should_post_callback_with_error_if_consume_input_failed
     ozo::impl::async_get_result(m.ctx, process_f);
 }
 
+TEST_F(async_get_result, bytes_available_should_return_size_of_data_received_on_socket) {
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    ASSERT_EQ(write(fds[1], "result", 6), 6);
+
+    EXPECT_CALL(m.native_handle, PQsocket()).WillOnce(Return(fds[0]));
+    EXPECT_EQ(ozo::impl::bytes_available(m.conn), 6u);
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST_F(async_get_result, bytes_available_should_return_zero_for_bad_socket) {
+    EXPECT_CALL(m.native_handle, PQsocket()).WillOnce(Return(-1));
+    EXPECT_EQ(ozo::impl::bytes_available(m.conn), 0u);
+}
+
+TEST_F(async_get_result, should_consume_input_without_wait_for_read_if_data_arrives_within_busy_poll) {
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+    ASSERT_EQ(write(fds[1], "result", 6), 6);
+    m.conn->busy_poll_ = std::chrono::milliseconds(100);
+
+    Sequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQsocket()).InSequence(s).WillOnce(Return(fds[0]));
+    EXPECT_CALL(m.native_handle, PQconsumeInput()).InSequence(s).WillOnce(Return(1));
+
+    // Nothing arrives after the data consumed, so wait for read
+    EXPECT_CALL(m.native_handle, PQisBusy()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQsocket()).InSequence(s).WillRepeatedly(Return(-1));
+    EXPECT_CALL(m.connection, async_wait_read(_)).InSequence(s).WillOnce(Return());
+
+    ozo::impl::async_get_result(m.ctx, process_f);
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST_F(async_get_result, should_wait_for_read_if_busy_poll_is_disabled) {
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(1));
+    EXPECT_CALL(m.connection, async_wait_read(_)).WillOnce(Return());
+
+    ozo::impl::async_get_result(m.ctx, process_f);
+}
+
 TEST_F(async_get_result, should_process_data_and_post_callback_if_result_is_empty) {
     Sequence s;
 
@@ -224,6 +309,30 @@ TEST_F(async_get_result, should_post_callback_with_error_and_consume_if_process_
     ozo::impl::async_get_result(m.ctx, process_f);
 }
 
+TEST_F(async_get_result, should_post_callback_with_bad_result_process_if_process_data_returns_error) {
+    Sequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    ozo::tests::pg_result result{PGRES_TUPLES_OK, nullptr};
+    EXPECT_CALL(m.native_handle, PQgetResult())
+        .InSequence(s)
+        .WillOnce(Return(&result));
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult())
+        .InSequence(s)
+        .WillOnce(Return(nullptr));
+
+    EXPECT_CALL(process, call_with_error()).InSequence(s)
+        .WillOnce(Return(error_code{ozo::error::oid_type_mismatch}));
+
+    EXPECT_CALL(m.connection, cancel()).InSequence(s).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::bad_result_process}, _))
+        .InSequence(s).WillOnce(Return());
+
+    ozo::impl::async_get_result(m.ctx, error_code_process_wrapper{process});
+}
+
 TEST_F(async_get_result, should_process_data_and_post_callback_and_consume_if_result_status_is_PGRES_TUPLES_OK) {
     Sequence s;
 
@@ -267,6 +376,53 @@ TEST_F(async_get_result, should_process_data_and_post_callback_if_result_status_
     ozo::impl::async_get_result(m.ctx, process_f);
 }
 
+struct async_process_wrapper {
+    using async_result_processor_tag = void;
+
+    std::function<void(ozo::error_code, std::string)>& continuation;
+
+    template <typename Result, typename Conn, typename Continuation>
+    void async_process(Result&&, Conn&, Continuation c) const {
+        continuation = std::move(c);
+    }
+};
+
+TEST_F(async_get_result, should_post_callback_after_async_processing_is_complete) {
+    Sequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    ozo::tests::pg_result result{PGRES_SINGLE_TUPLE, nullptr};
+    EXPECT_CALL(m.native_handle, PQgetResult()).InSequence(s).WillOnce(Return(&result));
+
+    std::function<void(ozo::error_code, std::string)> continuation;
+    ozo::impl::async_get_result(m.ctx, async_process_wrapper{continuation});
+    ASSERT_TRUE(continuation);
+
+    EXPECT_CALL(m.cb_io.executor_, post(_)).InSequence(s).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(m.callback, call(error_code{}, _)).InSequence(s).WillOnce(Return());
+
+    continuation(error_code{}, std::string{});
+}
+
+TEST_F(async_get_result, should_post_callback_with_error_and_context_if_async_processing_failed) {
+    Sequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    ozo::tests::pg_result result{PGRES_SINGLE_TUPLE, nullptr};
+    EXPECT_CALL(m.native_handle, PQgetResult()).InSequence(s).WillOnce(Return(&result));
+
+    std::function<void(ozo::error_code, std::string)> continuation;
+    ozo::impl::async_get_result(m.ctx, async_process_wrapper{continuation});
+    ASSERT_TRUE(continuation);
+
+    EXPECT_CALL(m.cb_io.executor_, post(_)).InSequence(s).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(m.connection, cancel()).InSequence(s).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::bad_result_process}, _)).InSequence(s).WillOnce(Return());
+
+    continuation(ozo::error::bad_result_process, "bad row");
+    EXPECT_EQ(m.conn->error_context_, "bad row");
+}
+
 TEST_F(async_get_result, should_process_data_and_post_callback_and_consume_result_if_result_status_is_PGRES_COMMAND_OK) {
     Sequence s;
 
@@ -0,0 +1,230 @@
+#include <connection_mock.h>
+#include <test_error.h>
+
+#include <ozo/listen.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+using namespace ozo::tests;
+
+using callback_mock = callback_gmock<connection_ptr<>>;
+
+using ozo::error_code;
+
+struct fixture {
+    StrictMock<connection_gmock> connection{};
+    StrictMock<PGconn_mock> native_handle{};
+    StrictMock<callback_mock> callback{};
+    io_context io;
+    execution_context cb_io;
+    connection_ptr<> conn = make_connection(connection, io, native_handle);
+
+    auto make_operation_context() {
+        EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+        return ozo::impl::make_request_operation_context(conn, wrap(callback));
+    }
+
+    decltype(ozo::impl::make_request_operation_context(conn, wrap(callback))) ctx;
+
+    fixture() : ctx(make_operation_context()) {}
+};
+
+TEST(make_listen_query, should_return_listen_statement_for_each_channel) {
+    const std::vector<std::string> channels {"foo", "Bar"};
+    EXPECT_EQ(ozo::impl::make_listen_query(channels), R"(LISTEN "foo";LISTEN "Bar";)");
+}
+
+TEST(make_listen_query, should_escape_quotes_in_channel_name) {
+    const std::vector<std::string> channels {R"(a"; DROP TABLE t; --)"};
+    EXPECT_EQ(ozo::impl::make_listen_query(channels), R"(LISTEN "a""; DROP TABLE t; --";)");
+}
+
+TEST(make_listen_query, should_return_empty_string_for_no_channels) {
+    EXPECT_EQ(ozo::impl::make_listen_query(std::vector<std::string>{}), "");
+}
+
+TEST(get_notifications, should_return_all_notifications_received_by_connection) {
+    StrictMock<connection_gmock> connection;
+    StrictMock<PGconn_mock> native_handle;
+    io_context io;
+    auto conn = make_connection(connection, io, native_handle);
+    pg_notify first {"foo", 42, "payload"};
+    pg_notify second {"bar", 13, nullptr};
+
+    const InSequence s;
+
+    EXPECT_CALL(native_handle, PQnotifies()).WillOnce(Return(&first));
+    EXPECT_CALL(native_handle, PQnotifies()).WillOnce(Return(&second));
+    EXPECT_CALL(native_handle, PQnotifies()).WillOnce(Return(nullptr));
+
+    const auto result = ozo::get_notifications(*conn);
+
+    ASSERT_EQ(result.size(), 2u);
+    EXPECT_EQ(result[0].channel, "foo");
+    EXPECT_EQ(result[0].payload, "payload");
+    EXPECT_EQ(result[0].backend_pid, 42);
+    EXPECT_EQ(result[1].channel, "bar");
+    EXPECT_EQ(result[1].payload, "");
+    EXPECT_EQ(result[1].backend_pid, 13);
+}
+
+struct async_send_listen_query : Test {
+    fixture m;
+};
+
+TEST_F(async_send_listen_query, should_send_query_and_flush) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQsetnonblocking(1)).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQsendQuery(StrEq(R"(LISTEN "foo";)"))).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQflush()).WillOnce(Return(0));
+
+    ozo::impl::async_send_listen_query(m.ctx, R"(LISTEN "foo";)");
+
+    EXPECT_EQ(m.ctx->state, ozo::impl::query_state::send_finish);
+}
+
+TEST_F(async_send_listen_query, should_call_handler_with_error_if_send_query_failed) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQsetnonblocking(1)).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQsendQuery(_)).WillOnce(Return(0));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::pg_send_query_failed}, _)).WillOnce(Return());
+
+    ozo::impl::async_send_listen_query(m.ctx, R"(LISTEN "foo";)");
+
+    EXPECT_EQ(m.ctx->state, ozo::impl::query_state::error);
+}
+
+struct notification_handler_mock {
+    MOCK_CONST_METHOD1(call, bool(std::vector<std::string>));
+};
+
+struct notification_handler {
+    notification_handler_mock& mock;
+
+    bool operator() (std::vector<ozo::notification> batch) const {
+        std::vector<std::string> channels;
+        for (const auto& v : batch) {
+            channels.push_back(v.channel);
+        }
+        return mock.call(std::move(channels));
+    }
+};
+
+struct async_listen_notifications : Test {
+    fixture m;
+    StrictMock<notification_handler_mock> handler;
+    ozo::tests::pg_result command_ok {PGRES_COMMAND_OK, nullptr};
+    ozo::tests::pg_result fatal {PGRES_FATAL_ERROR, "42P01"};
+    ozo::tests::pg_result tuples {PGRES_TUPLES_OK, nullptr};
+    pg_notify foo {"foo", 1, "a"};
+    pg_notify bar {"bar", 2, "b"};
+};
+
+TEST_F(async_listen_notifications, should_deliver_notifications_in_batches_until_handler_returns_false) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&command_ok));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.native_handle, PQnotifies()).WillOnce(Return(&foo));
+    EXPECT_CALL(m.native_handle, PQnotifies()).WillOnce(Return(nullptr));
+    EXPECT_CALL(handler, call(ElementsAre("foo"))).WillOnce(Return(true));
+    EXPECT_CALL(m.connection, async_wait_read(_)).WillOnce(InvokeArgument<0>(error_code{}));
+    EXPECT_CALL(m.cb_io.executor_, post(_)).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(m.native_handle, PQconsumeInput()).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQnotifies()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.connection, async_wait_read(_)).WillOnce(InvokeArgument<0>(error_code{}));
+    EXPECT_CALL(m.cb_io.executor_, post(_)).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(m.native_handle, PQconsumeInput()).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQnotifies()).WillOnce(Return(&foo));
+    EXPECT_CALL(m.native_handle, PQnotifies()).WillOnce(Return(&bar));
+    EXPECT_CALL(m.native_handle, PQnotifies()).WillOnce(Return(nullptr));
+    EXPECT_CALL(handler, call(ElementsAre("foo", "bar"))).WillOnce(Return(false));
+    EXPECT_CALL(m.callback, call(error_code{}, _)).WillOnce(Return());
+
+    ozo::impl::async_listen_notifications(m.ctx, notification_handler{handler});
+}
+
+TEST_F(async_listen_notifications, should_call_handler_with_database_error_of_listen_statement) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&fatal));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(ozo::sqlstate::make_error_code(ozo::sqlstate::undefined_table), _)).WillOnce(Return());
+
+    ozo::impl::async_listen_notifications(m.ctx, notification_handler{handler});
+}
+
+TEST_F(async_listen_notifications, should_call_handler_with_result_status_unexpected_for_unexpected_status) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&tuples));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::result_status_unexpected}, _)).WillOnce(Return());
+
+    ozo::impl::async_listen_notifications(m.ctx, notification_handler{handler});
+}
+
+TEST_F(async_listen_notifications, should_call_handler_with_error_if_consume_input_failed) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.native_handle, PQnotifies()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.connection, async_wait_read(_)).WillOnce(InvokeArgument<0>(error_code{}));
+    EXPECT_CALL(m.cb_io.executor_, post(_)).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(m.native_handle, PQconsumeInput()).WillOnce(Return(0));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::pg_consume_input_failed}, _)).WillOnce(Return());
+
+    ozo::impl::async_listen_notifications(m.ctx, notification_handler{handler});
+}
+
+TEST_F(async_listen_notifications, should_call_handler_with_operation_aborted_if_wait_is_cancelled) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.native_handle, PQnotifies()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.connection, async_wait_read(_)).WillOnce(InvokeArgument<0>(error_code{boost::asio::error::bad_descriptor}));
+    EXPECT_CALL(m.cb_io.executor_, post(_)).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{boost::asio::error::operation_aborted}, _)).WillOnce(Return());
+
+    ozo::impl::async_listen_notifications(m.ctx, notification_handler{handler});
+}
+
+TEST_F(async_listen_notifications, should_call_handler_with_bad_result_process_if_notification_handler_throws) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.native_handle, PQnotifies()).WillOnce(Return(&foo));
+    EXPECT_CALL(m.native_handle, PQnotifies()).WillOnce(Return(nullptr));
+    EXPECT_CALL(handler, call(_)).WillOnce(Throw(std::runtime_error("error")));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::bad_result_process}, _)).WillOnce(Return());
+
+    ozo::impl::async_listen_notifications(m.ctx, notification_handler{handler});
+
+    EXPECT_EQ(m.conn->get_error_context(), "error");
+}
+
+TEST_F(async_listen_notifications, should_exit_if_query_state_is_error) {
+    m.ctx->state = ozo::impl::query_state::error;
+    ozo::impl::async_listen_notifications(m.ctx, notification_handler{handler});
+}
+
+} // namespace
@@ -0,0 +1,146 @@
+#include <connection_mock.h>
+#include <test_error.h>
+
+#include <ozo/multi_request.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+namespace hana = boost::hana;
+
+using namespace testing;
+using namespace ozo::tests;
+
+using callback_mock = callback_gmock<connection_ptr<>>;
+
+using ozo::error_code;
+
+struct fixture {
+    StrictMock<connection_gmock> connection{};
+    StrictMock<PGconn_mock> native_handle{};
+    StrictMock<callback_mock> callback{};
+    io_context io;
+    execution_context cb_io;
+    connection_ptr<> conn = make_connection(connection, io, native_handle);
+
+    auto make_operation_context() {
+        EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+        return ozo::impl::make_request_operation_context(conn, wrap(callback));
+    }
+
+    decltype(ozo::impl::make_request_operation_context(conn, wrap(callback))) ctx;
+
+    fixture() : ctx(make_operation_context()) {}
+};
+
+struct async_send_query : Test {
+    fixture m;
+};
+
+TEST_F(async_send_query, should_send_query_text_and_flush) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQsetnonblocking(1)).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQsendQuery(StrEq("SELECT 1; SELECT 2"))).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQflush()).WillOnce(Return(0));
+
+    ozo::impl::async_send_query(m.ctx, std::string("SELECT 1; SELECT 2"));
+
+    EXPECT_EQ(m.ctx->state, ozo::impl::query_state::send_finish);
+}
+
+TEST_F(async_send_query, should_call_handler_with_error_if_send_query_failed) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQsetnonblocking(1)).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQsendQuery(_)).WillOnce(Return(0));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::pg_send_query_failed}, _)).WillOnce(Return());
+
+    ozo::impl::async_send_query(m.ctx, std::string("SELECT 1; SELECT 2"));
+
+    EXPECT_EQ(m.ctx->state, ozo::impl::query_state::error);
+}
+
+struct async_get_results : Test {
+    fixture m;
+    ozo::tests::pg_result ok {PGRES_COMMAND_OK, nullptr};
+    ozo::tests::pg_result fatal {PGRES_FATAL_ERROR, "42P01"};
+    ozo::tests::pg_result copy {PGRES_COPY_OUT, nullptr};
+};
+
+struct results_processor_mock {
+    MOCK_METHOD1(call, void(std::size_t));
+};
+
+struct results_processor {
+    results_processor_mock* mock;
+
+    template <typename Result, typename Connection>
+    void operator() (std::size_t index, Result&&, Connection&) {
+        mock->call(index);
+    }
+};
+
+TEST_F(async_get_results, should_process_results_of_all_statements_up_to_null_result) {
+    StrictMock<results_processor_mock> processor;
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&ok));
+    EXPECT_CALL(processor, call(0u)).WillOnce(Return());
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(1));
+    EXPECT_CALL(m.connection, async_wait_read(_)).WillOnce(InvokeArgument<0>(error_code{}));
+    EXPECT_CALL(m.cb_io.executor_, post(_)).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(m.native_handle, PQconsumeInput()).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&ok));
+    EXPECT_CALL(processor, call(1u)).WillOnce(Return());
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.callback, call(error_code{}, _)).WillOnce(Return());
+
+    ozo::impl::async_get_results(m.ctx, results_processor{&processor});
+}
+
+TEST_F(async_get_results, should_read_results_up_to_null_result_and_call_handler_with_error) {
+    StrictMock<results_processor_mock> processor;
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&fatal));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(ozo::sqlstate::make_error_code(ozo::sqlstate::undefined_table), _)).WillOnce(Return());
+
+    ozo::impl::async_get_results(m.ctx, results_processor{&processor});
+}
+
+TEST_F(async_get_results, should_call_handler_with_error_for_unexpected_result_status) {
+    StrictMock<results_processor_mock> processor;
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&copy));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::result_status_unexpected}, _)).WillOnce(Return());
+
+    ozo::impl::async_get_results(m.ctx, results_processor{&processor});
+}
+
+TEST_F(async_get_results, should_exit_if_query_state_is_error) {
+    StrictMock<results_processor_mock> processor;
+    m.ctx->state = ozo::impl::query_state::error;
+    ozo::impl::async_get_results(m.ctx, results_processor{&processor});
+}
+
+TEST(multi_request_results, should_ignore_results_beyond_outputs) {
+    ozo::impl::multi_request_results results{hana::make_tuple(ozo::none)};
+    const auto conn = std::make_shared<int>();
+    EXPECT_NO_THROW(results(1, nullptr, conn));
+}
+
+} // namespace
@@ -0,0 +1,170 @@
+#include <connection_mock.h>
+#include <test_error.h>
+
+#include <ozo/multiplexer.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#ifdef LIBPQ_HAS_PIPELINING
+
+namespace {
+
+using namespace testing;
+using namespace ozo::tests;
+
+using callback_mock = callback_gmock<connection_ptr<>>;
+
+using ozo::error_code;
+
+struct fixture {
+    StrictMock<connection_gmock> connection{};
+    StrictMock<PGconn_mock> native_handle{};
+    StrictMock<callback_mock> callback{};
+    io_context io;
+    execution_context cb_io;
+    connection_ptr<> conn = make_connection(connection, io, native_handle);
+
+    auto make_operation_context() {
+        EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+        return ozo::impl::make_request_operation_context(conn, wrap(callback));
+    }
+
+    decltype(ozo::impl::make_request_operation_context(conn, wrap(callback))) ctx;
+
+    fixture() : ctx(make_operation_context()) {}
+};
+
+struct request_mock : ozo::impl::multiplexed_request<connection_ptr<>> {
+    bool sent = true;
+    std::size_t processed = 0;
+    std::optional<error_code> completed;
+
+    bool send(connection_ptr<>& conn) override {
+        return sent && ozo::impl::send_query_params(conn,
+            ozo::to_binary_query(empty_query {}, ozo::empty_oid_map{}));
+    }
+
+    void process(result_type&&, connection_ptr<>&) override { ++processed;}
+
+    void complete(error_code ec) override { completed = ec;}
+};
+
+using batch_type = ozo::impl::multiplexed_batch<connection_ptr<>>;
+
+auto make_batch(std::size_t size) {
+    auto batch = std::make_shared<batch_type>();
+    for (std::size_t i = 0; i < size; ++i) {
+        batch->requests.push_back(std::make_shared<request_mock>());
+    }
+    return batch;
+}
+
+const request_mock& request(const std::shared_ptr<batch_type>& batch, std::size_t i) {
+    return static_cast<const request_mock&>(*batch->requests[i]);
+}
+
+struct async_send_multiplexed : Test {
+    fixture m;
+};
+
+TEST_F(async_send_multiplexed, should_enter_pipeline_mode_send_each_request_with_sync_and_flush) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQsetnonblocking(1)).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQenterPipelineMode()).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQsendQueryParams(_, _, _, _, _, _, _)).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQpipelineSync()).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQsendQueryParams(_, _, _, _, _, _, _)).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQpipelineSync()).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQflush()).WillOnce(Return(0));
+
+    ozo::impl::async_send_multiplexed(m.ctx, make_batch(2));
+
+    EXPECT_EQ(m.ctx->state, ozo::impl::query_state::send_finish);
+}
+
+TEST_F(async_send_multiplexed, should_stop_sending_and_call_handler_with_error_if_send_query_params_failed) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQsetnonblocking(1)).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQenterPipelineMode()).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQsendQueryParams(_, _, _, _, _, _, _)).WillOnce(Return(0));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::pg_send_query_params_failed}, _)).WillOnce(Return());
+
+    ozo::impl::async_send_multiplexed(m.ctx, make_batch(2));
+}
+
+struct async_get_multiplexed_results : Test {
+    fixture m;
+    ozo::tests::pg_result selected {PGRES_TUPLES_OK, nullptr, "7"};
+    ozo::tests::pg_result fatal {PGRES_FATAL_ERROR, "42P01", "", "relation does not exist"};
+    ozo::tests::pg_result sync {PGRES_PIPELINE_SYNC, nullptr};
+};
+
+TEST_F(async_get_multiplexed_results, should_complete_each_request_with_its_own_result_and_exit_pipeline_mode) {
+    const InSequence s;
+    auto batch = make_batch(2);
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&fatal));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&sync));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(1));
+    EXPECT_CALL(m.connection, async_wait_read(_)).WillOnce(InvokeArgument<0>(error_code{}));
+    EXPECT_CALL(m.cb_io.executor_, post(_)).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(m.native_handle, PQconsumeInput()).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&selected));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&sync));
+    EXPECT_CALL(m.native_handle, PQexitPipelineMode()).WillOnce(Return(1));
+    EXPECT_CALL(m.callback, call(error_code{}, _)).WillOnce(Return());
+
+    ozo::impl::async_get_multiplexed_results_op{m.ctx, batch}.perform();
+
+    EXPECT_EQ(request(batch, 0).completed, ozo::sqlstate::make_error_code(ozo::sqlstate::undefined_table));
+    EXPECT_EQ(request(batch, 0).processed, 0u);
+    EXPECT_EQ(request(batch, 1).completed, error_code{});
+    EXPECT_EQ(request(batch, 1).processed, 1u);
+    EXPECT_EQ(batch->completed, 2u);
+}
+
+TEST_F(async_get_multiplexed_results, should_leave_rest_of_requests_uncompleted_on_connection_error) {
+    const InSequence s;
+    auto batch = make_batch(2);
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&sync));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(1));
+    EXPECT_CALL(m.connection, async_wait_read(_)).WillOnce(InvokeArgument<0>(error_code{}));
+    EXPECT_CALL(m.cb_io.executor_, post(_)).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(m.native_handle, PQconsumeInput()).WillOnce(Return(0));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::pg_consume_input_failed}, _)).WillOnce(Return());
+
+    ozo::impl::async_get_multiplexed_results_op{m.ctx, batch}.perform();
+
+    EXPECT_EQ(request(batch, 0).completed, error_code{});
+    EXPECT_FALSE(request(batch, 1).completed);
+    EXPECT_EQ(batch->completed, 1u);
+
+    batch->complete_rest(ozo::error::pg_consume_input_failed);
+    EXPECT_EQ(request(batch, 1).completed, error_code{ozo::error::pg_consume_input_failed});
+}
+
+TEST_F(async_get_multiplexed_results, should_exit_if_query_state_is_error) {
+    auto batch = make_batch(1);
+    m.ctx->state = ozo::impl::query_state::error;
+    ozo::impl::async_get_multiplexed_results_op{m.ctx, batch}.perform();
+    EXPECT_FALSE(request(batch, 0).completed);
+}
+
+} // namespace
+
+#endif
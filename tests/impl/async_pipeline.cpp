@@ -0,0 +1,212 @@
+#include <connection_mock.h>
+#include <test_error.h>
+
+#include <ozo/pipeline.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#ifdef LIBPQ_HAS_PIPELINING
+
+namespace {
+
+namespace hana = boost::hana;
+
+using namespace testing;
+using namespace ozo::tests;
+
+using callback_mock = callback_gmock<connection_ptr<>>;
+
+using ozo::error_code;
+
+struct fixture {
+    StrictMock<connection_gmock> connection{};
+    StrictMock<PGconn_mock> native_handle{};
+    StrictMock<callback_mock> callback{};
+    io_context io;
+    execution_context cb_io;
+    connection_ptr<> conn = make_connection(connection, io, native_handle);
+
+    auto make_operation_context() {
+        EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+        return ozo::impl::make_request_operation_context(conn, wrap(callback));
+    }
+
+    decltype(ozo::impl::make_request_operation_context(conn, wrap(callback))) ctx;
+
+    fixture() : ctx(make_operation_context()) {}
+};
+
+const auto two_steps = hana::make_tuple(
+    ozo::pipelined(empty_query {}),
+    ozo::pipelined(empty_query {})
+);
+
+struct async_send_pipeline : Test {
+    fixture m;
+};
+
+TEST_F(async_send_pipeline, should_enter_pipeline_mode_send_all_queries_and_sync_and_flush) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQsetnonblocking(1)).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQenterPipelineMode()).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQsendQueryParams(_, _, _, _, _, _, _)).Times(2).WillRepeatedly(Return(1));
+    EXPECT_CALL(m.native_handle, PQpipelineSync()).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQflush()).WillOnce(Return(0));
+
+    ozo::impl::async_send_pipeline(m.ctx, two_steps);
+
+    EXPECT_EQ(m.ctx->state, ozo::impl::query_state::send_finish);
+}
+
+TEST_F(async_send_pipeline, should_call_handler_with_error_if_enter_pipeline_mode_failed) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQsetnonblocking(1)).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQenterPipelineMode()).WillOnce(Return(0));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::pg_enter_pipeline_mode_failed}, _)).WillOnce(Return());
+
+    ozo::impl::async_send_pipeline(m.ctx, two_steps);
+
+    EXPECT_EQ(m.ctx->state, ozo::impl::query_state::error);
+}
+
+TEST_F(async_send_pipeline, should_stop_sending_and_call_handler_with_error_if_send_query_params_failed) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQsetnonblocking(1)).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQenterPipelineMode()).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQsendQueryParams(_, _, _, _, _, _, _)).WillOnce(Return(0));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::pg_send_query_params_failed}, _)).WillOnce(Return());
+
+    ozo::impl::async_send_pipeline(m.ctx, two_steps);
+}
+
+TEST_F(async_send_pipeline, should_call_handler_with_error_if_pipeline_sync_failed) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQsetnonblocking(1)).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQenterPipelineMode()).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQsendQueryParams(_, _, _, _, _, _, _)).Times(2).WillRepeatedly(Return(1));
+    EXPECT_CALL(m.native_handle, PQpipelineSync()).WillOnce(Return(0));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::pg_pipeline_sync_failed}, _)).WillOnce(Return());
+
+    ozo::impl::async_send_pipeline(m.ctx, two_steps);
+}
+
+struct async_get_pipeline_results : Test {
+    fixture m;
+    ozo::tests::pg_result ok {PGRES_COMMAND_OK, nullptr};
+    ozo::tests::pg_result fatal {PGRES_FATAL_ERROR, "42P01"};
+    ozo::tests::pg_result aborted {PGRES_PIPELINE_ABORTED, nullptr};
+    ozo::tests::pg_result sync {PGRES_PIPELINE_SYNC, nullptr};
+};
+
+TEST_F(async_get_pipeline_results, should_read_results_of_all_steps_up_to_sync_and_exit_pipeline_mode) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&ok));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(1));
+    EXPECT_CALL(m.connection, async_wait_read(_)).WillOnce(InvokeArgument<0>(error_code{}));
+    EXPECT_CALL(m.cb_io.executor_, post(_)).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(m.native_handle, PQconsumeInput()).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&ok));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&sync));
+    EXPECT_CALL(m.native_handle, PQexitPipelineMode()).WillOnce(Return(1));
+    EXPECT_CALL(m.callback, call(error_code{}, _)).WillOnce(Return());
+
+    ozo::impl::async_get_pipeline_results(m.ctx, ozo::impl::pipeline_steps_results{two_steps});
+}
+
+TEST_F(async_get_pipeline_results, should_drain_aborted_steps_and_call_handler_with_first_error) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&fatal));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&aborted));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&sync));
+    EXPECT_CALL(m.native_handle, PQexitPipelineMode()).WillOnce(Return(1));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(ozo::sqlstate::make_error_code(ozo::sqlstate::undefined_table), _)).WillOnce(Return());
+
+    ozo::impl::async_get_pipeline_results(m.ctx, ozo::impl::pipeline_steps_results{two_steps});
+}
+
+struct optional_second_step_results {
+    std::size_t size() const noexcept { return 2;}
+    bool optional(std::size_t index) const noexcept { return index == 1;}
+    template <typename Result, typename Connection>
+    void operator() (std::size_t, Result&&, Connection&) {}
+};
+
+TEST_F(async_get_pipeline_results, should_ignore_error_of_optional_step) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&ok));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&fatal));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&sync));
+    EXPECT_CALL(m.native_handle, PQexitPipelineMode()).WillOnce(Return(1));
+    EXPECT_CALL(m.callback, call(error_code{}, _)).WillOnce(Return());
+
+    ozo::impl::async_get_pipeline_results(m.ctx, optional_second_step_results{});
+}
+
+TEST_F(async_get_pipeline_results, should_call_handler_with_error_if_no_sync_result_received) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::result_status_unexpected}, _)).WillOnce(Return());
+
+    ozo::impl::async_get_pipeline_results(m.ctx, ozo::impl::pipeline_steps_results{two_steps});
+}
+
+TEST_F(async_get_pipeline_results, should_call_handler_with_error_if_exit_pipeline_mode_failed) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&sync));
+    EXPECT_CALL(m.native_handle, PQexitPipelineMode()).WillOnce(Return(0));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::pg_exit_pipeline_mode_failed}, _)).WillOnce(Return());
+
+    ozo::impl::async_get_pipeline_results(m.ctx, ozo::impl::pipeline_steps_results{hana::make_tuple()});
+}
+
+TEST_F(async_get_pipeline_results, should_exit_if_query_state_is_error) {
+    m.ctx->state = ozo::impl::query_state::error;
+    ozo::impl::async_get_pipeline_results(m.ctx, ozo::impl::pipeline_steps_results{two_steps});
+}
+
+} // namespace
+
+#endif
@@ -0,0 +1,310 @@
+#include <connection_mock.h>
+#include <test_error.h>
+
+#include <ozo/replication.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+using namespace ozo::tests;
+using namespace std::string_literals;
+
+using callback_mock = callback_gmock<connection_ptr<>>;
+
+using ozo::error_code;
+
+struct fixture {
+    StrictMock<connection_gmock> connection{};
+    StrictMock<PGconn_mock> native_handle{};
+    StrictMock<callback_mock> callback{};
+    io_context io;
+    execution_context cb_io;
+    connection_ptr<> conn = make_connection(connection, io, native_handle);
+
+    auto make_operation_context() {
+        EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+        return ozo::impl::make_request_operation_context(conn, wrap(callback));
+    }
+
+    decltype(ozo::impl::make_request_operation_context(conn, wrap(callback))) ctx;
+
+    fixture() : ctx(make_operation_context()) {}
+};
+
+TEST(make_start_replication_query, should_return_command_with_slot_lsn_and_options) {
+    ozo::replication_config config;
+    config.slot = "cdc";
+    config.start_lsn = (ozo::replication_lsn(0x16) << 32) | 0xB374D848;
+    config.options = {{"proto_version", "1"}, {"publication_names", "pub"}};
+    EXPECT_EQ(ozo::impl::make_start_replication_query(config),
+        R"(START_REPLICATION SLOT "cdc" LOGICAL 16/B374D848 ("proto_version" '1', "publication_names" 'pub'))");
+}
+
+TEST(make_start_replication_query, should_return_command_without_options_for_no_options) {
+    ozo::replication_config config;
+    config.slot = "cdc";
+    EXPECT_EQ(ozo::impl::make_start_replication_query(config), R"(START_REPLICATION SLOT "cdc" LOGICAL 0/0)");
+}
+
+TEST(make_start_replication_query, should_escape_quotes_in_slot_and_options) {
+    ozo::replication_config config;
+    config.slot = R"(a"b)";
+    config.options = {{"x", "it's"}};
+    EXPECT_EQ(ozo::impl::make_start_replication_query(config),
+        R"(START_REPLICATION SLOT "a""b" LOGICAL 0/0 ("x" 'it''s'))");
+}
+
+std::string xlog_data(std::int8_t lsn, const std::string& payload) {
+    return "w"s + "\0\0\0\0\0\0\0"s + char(lsn) + "\0\0\0\0\0\0\0\x7f"s + "\0\0\0\0\0\0\0\1"s + payload;
+}
+
+std::string keepalive(std::int8_t lsn, bool reply) {
+    return "k"s + "\0\0\0\0\0\0\0"s + char(lsn) + "\0\0\0\0\0\0\0\1"s + char(reply);
+}
+
+TEST(decode_xlog_data, should_return_header_and_data_referring_to_message) {
+    const auto message = xlog_data(42, "payload");
+    const auto result = ozo::impl::decode_xlog_data(message.data(), message.size());
+    EXPECT_EQ(result.wal_start, 42u);
+    EXPECT_EQ(result.wal_end, 0x7fu);
+    EXPECT_EQ(result.send_time, 1);
+    EXPECT_EQ(result.data, "payload");
+    EXPECT_EQ(result.data.data(), message.data() + 25);
+}
+
+TEST(decode_xlog_data, should_throw_for_truncated_message) {
+    const auto message = "w\0\0\0"s;
+    EXPECT_THROW(ozo::impl::decode_xlog_data(message.data(), message.size()), ozo::system_error);
+}
+
+TEST(make_standby_status_update, should_make_message_with_positions_and_reply_flag) {
+    std::vector<char> buffer;
+    ozo::impl::make_standby_status_update(buffer, 42, 13, true);
+    ASSERT_EQ(buffer.size(), 34u);
+    EXPECT_EQ(buffer[0], 'r');
+    EXPECT_EQ(buffer[8], 42);
+    EXPECT_EQ(buffer[16], 13);
+    EXPECT_EQ(buffer[24], 13);
+    EXPECT_EQ(buffer[33], 1);
+}
+
+struct message_handler_mock {
+    MOCK_CONST_METHOD1(call, bool(std::vector<std::string>));
+};
+
+struct message_handler {
+    message_handler_mock& mock;
+
+    bool operator() (const std::vector<ozo::xlog_data>& batch) const {
+        std::vector<std::string> data;
+        for (const auto& v : batch) {
+            data.emplace_back(v.data);
+        }
+        return mock.call(std::move(data));
+    }
+};
+
+struct async_replication_stream : Test {
+    fixture m;
+    StrictMock<message_handler_mock> handler;
+    ozo::tests::pg_result copy_both {PGRES_COPY_BOTH, nullptr};
+    ozo::tests::pg_result command_ok {PGRES_COMMAND_OK, nullptr};
+    ozo::tests::pg_result fatal {PGRES_FATAL_ERROR, "42704"};
+    ozo::replication_config config;
+    std::string status;
+
+    async_replication_stream() {
+        config.status_interval = std::chrono::hours(1);
+    }
+
+    static auto return_data(std::string data) {
+        return Invoke([data] (char** buffer, int) {
+            *buffer = static_cast<char*>(std::malloc(data.size()));
+            std::copy(data.begin(), data.end(), *buffer);
+            return int(data.size());
+        });
+    }
+
+    auto save_status() {
+        return Invoke([&] (const char* buf, int size) { status.assign(buf, size); return 1; });
+    }
+};
+
+TEST_F(async_replication_stream, should_deliver_messages_in_batches_and_stop_when_handler_returns_false) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&copy_both));
+    EXPECT_CALL(m.native_handle, PQgetCopyData(_, 1)).WillOnce(return_data(xlog_data(1, "a")));
+    EXPECT_CALL(m.native_handle, PQgetCopyData(_, 1)).WillOnce(return_data(xlog_data(2, "b")));
+    EXPECT_CALL(m.native_handle, PQgetCopyData(_, 1)).WillOnce(Return(0));
+    EXPECT_CALL(handler, call(ElementsAre("a", "b"))).WillOnce(Return(true));
+    EXPECT_CALL(m.connection, async_wait_read(_)).WillOnce(InvokeArgument<0>(error_code{}));
+    EXPECT_CALL(m.cb_io.executor_, post(_)).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(m.native_handle, PQconsumeInput()).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQgetCopyData(_, 1)).WillOnce(return_data(xlog_data(3, "c")));
+    EXPECT_CALL(m.native_handle, PQgetCopyData(_, 1)).WillOnce(Return(0));
+    EXPECT_CALL(handler, call(ElementsAre("c"))).WillOnce(Return(false));
+    EXPECT_CALL(m.native_handle, PQputCopyEnd(nullptr)).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQflush()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetCopyData(_, 1)).WillOnce(return_data(xlog_data(4, "d")));
+    EXPECT_CALL(m.native_handle, PQgetCopyData(_, 1)).WillOnce(Return(-1));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&command_ok));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.callback, call(error_code{}, _)).WillOnce(Return());
+
+    ozo::impl::async_replication_stream(m.ctx, message_handler{handler}, config);
+}
+
+TEST_F(async_replication_stream, should_pass_no_more_than_max_batch_size_messages_at_once) {
+    config.max_batch_size = 1;
+
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&copy_both));
+    EXPECT_CALL(m.native_handle, PQgetCopyData(_, 1)).WillOnce(return_data(xlog_data(1, "a")));
+    EXPECT_CALL(handler, call(ElementsAre("a"))).WillOnce(Return(true));
+    EXPECT_CALL(m.native_handle, PQgetCopyData(_, 1)).WillOnce(return_data(xlog_data(2, "b")));
+    EXPECT_CALL(handler, call(ElementsAre("b"))).WillOnce(Return(true));
+    EXPECT_CALL(m.native_handle, PQgetCopyData(_, 1)).WillOnce(Return(-1));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.callback, call(error_code{}, _)).WillOnce(Return());
+
+    ozo::impl::async_replication_stream(m.ctx, message_handler{handler}, config);
+}
+
+TEST_F(async_replication_stream, should_send_status_update_with_delivered_position_on_keepalive_reply_request) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&copy_both));
+    EXPECT_CALL(m.native_handle, PQgetCopyData(_, 1)).WillOnce(return_data(xlog_data(5, "a")));
+    EXPECT_CALL(m.native_handle, PQgetCopyData(_, 1)).WillOnce(return_data(keepalive(9, true)));
+    EXPECT_CALL(m.native_handle, PQgetCopyData(_, 1)).WillOnce(Return(0));
+    EXPECT_CALL(handler, call(ElementsAre("a"))).WillOnce(Return(true));
+    EXPECT_CALL(m.native_handle, PQputCopyData(_, 34)).WillOnce(save_status());
+    EXPECT_CALL(m.native_handle, PQflush()).WillOnce(Return(0));
+    EXPECT_CALL(m.connection, async_wait_read(_)).WillOnce(InvokeArgument<0>(error_code{}));
+    EXPECT_CALL(m.cb_io.executor_, post(_)).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(m.native_handle, PQconsumeInput()).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQgetCopyData(_, 1)).WillOnce(Return(-1));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.callback, call(error_code{}, _)).WillOnce(Return());
+
+    ozo::impl::async_replication_stream(m.ctx, message_handler{handler}, config);
+
+    ASSERT_EQ(status.size(), 34u);
+    EXPECT_EQ(status[0], 'r');
+    EXPECT_EQ(status[8], 5);  // written
+    EXPECT_EQ(status[16], 5); // flushed
+    EXPECT_EQ(status[33], 1);
+}
+
+TEST_F(async_replication_stream, should_report_position_confirmed_via_progress_as_flushed) {
+    config.progress = std::make_shared<ozo::replication_progress>(3);
+
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&copy_both));
+    EXPECT_CALL(m.native_handle, PQgetCopyData(_, 1)).WillOnce(return_data(xlog_data(5, "a")));
+    EXPECT_CALL(m.native_handle, PQgetCopyData(_, 1)).WillOnce(return_data(keepalive(5, true)));
+    EXPECT_CALL(m.native_handle, PQgetCopyData(_, 1)).WillOnce(Return(0));
+    EXPECT_CALL(handler, call(ElementsAre("a"))).WillOnce(Return(true));
+    EXPECT_CALL(m.native_handle, PQputCopyData(_, 34)).WillOnce(save_status());
+    EXPECT_CALL(m.native_handle, PQflush()).WillOnce(Return(0));
+    EXPECT_CALL(m.connection, async_wait_read(_)).WillOnce(InvokeArgument<0>(error_code{}));
+    EXPECT_CALL(m.cb_io.executor_, post(_)).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(m.native_handle, PQconsumeInput()).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQgetCopyData(_, 1)).WillOnce(Return(-1));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.callback, call(error_code{}, _)).WillOnce(Return());
+
+    ozo::impl::async_replication_stream(m.ctx, message_handler{handler}, config);
+
+    ASSERT_EQ(status.size(), 34u);
+    EXPECT_EQ(status[8], 5);
+    EXPECT_EQ(status[16], 3);
+}
+
+TEST_F(async_replication_stream, should_call_handler_with_database_error_of_start_replication) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&fatal));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(ozo::sqlstate::make_error_code(ozo::sqlstate::undefined_object), _)).WillOnce(Return());
+
+    ozo::impl::async_replication_stream(m.ctx, message_handler{handler}, config);
+}
+
+TEST_F(async_replication_stream, should_call_handler_with_result_status_unexpected_for_copy_out_status) {
+    ozo::tests::pg_result copy_out {PGRES_COPY_OUT, nullptr};
+
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&copy_out));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::result_status_unexpected}, _)).WillOnce(Return());
+
+    ozo::impl::async_replication_stream(m.ctx, message_handler{handler}, config);
+}
+
+TEST_F(async_replication_stream, should_call_handler_with_bad_result_process_for_unexpected_message_type) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&copy_both));
+    EXPECT_CALL(m.native_handle, PQgetCopyData(_, 1)).WillOnce(return_data("x"));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::bad_result_process}, _)).WillOnce(Return());
+
+    ozo::impl::async_replication_stream(m.ctx, message_handler{handler}, config);
+}
+
+TEST_F(async_replication_stream, should_call_handler_with_bad_result_process_if_message_handler_throws) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&copy_both));
+    EXPECT_CALL(m.native_handle, PQgetCopyData(_, 1)).WillOnce(return_data(xlog_data(1, "a")));
+    EXPECT_CALL(m.native_handle, PQgetCopyData(_, 1)).WillOnce(Return(0));
+    EXPECT_CALL(handler, call(_)).WillOnce(Throw(std::runtime_error("error")));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::bad_result_process}, _)).WillOnce(Return());
+
+    ozo::impl::async_replication_stream(m.ctx, message_handler{handler}, config);
+
+    EXPECT_EQ(m.conn->get_error_context(), "error");
+}
+
+TEST_F(async_replication_stream, should_call_handler_with_error_if_get_copy_data_failed) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&copy_both));
+    EXPECT_CALL(m.native_handle, PQgetCopyData(_, 1)).WillOnce(Return(-2));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::pg_get_copy_data_failed}, _)).WillOnce(Return());
+
+    ozo::impl::async_replication_stream(m.ctx, message_handler{handler}, config);
+}
+
+TEST_F(async_replication_stream, should_exit_if_query_state_is_error) {
+    m.ctx->state = ozo::impl::query_state::error;
+    ozo::impl::async_replication_stream(m.ctx, message_handler{handler}, config);
+}
+
+} // namespace
@@ -3,10 +3,19 @@
 
 #include <ozo/impl/async_request.h>
 #include <ozo/time_traits.h>
+#include <ozo/transaction.h>
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+namespace ozo::tests {
+
+OZO_STRONG_TYPEDEF(std::string, custom_text)
+
+} // namespace ozo::tests
+
+OZO_PG_DEFINE_CUSTOM_TYPE(ozo::tests::custom_text, "custom_text")
+
 namespace {
 
 namespace hana = boost::hana;
@@ -116,4 +125,731 @@ TEST_F(async_request_op, should_cancel_connection_io_on_timeout) {
     ozo::impl::async_request_op{empty_query {}, timeout, ozo::none, wrap(callback)}(error_code {}, conn);
 }
 
+TEST_F(async_request_op, should_request_oids_of_pending_custom_types_instead_of_query) {
+    using oid_map_type = decltype(ozo::register_types<custom_text>());
+    auto lazy_conn = make_connection(connection, io, native_handle, oid_map_type{});
+    lazy_conn->lazy_oid_map_ = true;
+    StrictMock<callback_gmock<connection_ptr<oid_map_type>>> lazy_callback {};
+
+    EXPECT_CALL(connection, async_request()).WillOnce(Return());
+
+    ozo::impl::async_request_op{ozo::make_query("SELECT $1", custom_text{"text"}), ozo::none, ozo::none,
+        wrap(lazy_callback)}(error_code {}, lazy_conn);
+}
+
+TEST_F(async_request_op, should_send_query_without_oids_request_if_custom_types_are_resolved) {
+    using oid_map_type = decltype(ozo::register_types<custom_text>());
+    auto lazy_conn = make_connection(connection, io, native_handle, oid_map_type{});
+    lazy_conn->lazy_oid_map_ = true;
+    ozo::set_type_oid<custom_text>(lazy_conn->oid_map(), 42);
+    StrictMock<callback_gmock<connection_ptr<oid_map_type>>> lazy_callback {};
+
+    EXPECT_CALL(io.strand_service_, get_executor()).WillOnce(ReturnRef(strand));
+    EXPECT_CALL(lazy_callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+
+    Sequence s;
+
+    EXPECT_CALL(native_handle, PQsetnonblocking(1)).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQsendQueryParams(StrEq("SELECT $1"), 1, _, _, _, _, _)).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQflush()).InSequence(s).WillOnce(Return(0));
+
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(nullptr));
+
+    EXPECT_CALL(cb_io.executor_, dispatch(_)).InSequence(s).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(lazy_callback, call(error_code {}, _)).InSequence(s).WillOnce(Return());
+
+    ozo::impl::async_request_op{ozo::make_query("SELECT $1", custom_text{"text"}), ozo::none, ozo::none,
+        wrap(lazy_callback)}(error_code {}, lazy_conn);
+}
+
+#ifdef LIBPQ_HAS_PIPELINING
+
+TEST_F(async_request_op, should_prepare_and_execute_statement_in_pipeline_for_prepared_query_not_in_cache) {
+
+    EXPECT_CALL(io.strand_service_, get_executor()).WillOnce(ReturnRef(strand));
+    EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+
+    ozo::tests::pg_result ok {PGRES_COMMAND_OK, nullptr};
+    ozo::tests::pg_result sync {PGRES_PIPELINE_SYNC, nullptr};
+
+    Sequence s;
+
+    EXPECT_CALL(native_handle, PQsetnonblocking(1)).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQenterPipelineMode()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQsendPrepare(StrEq("ozo_1"), _, _, _)).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQsendQueryPrepared(StrEq("ozo_1"), _, _, _, _, _)).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQpipelineSync()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQflush()).InSequence(s).WillOnce(Return(0));
+
+    // Prepare result
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(&ok));
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(nullptr));
+
+    // Execute result
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(&ok));
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(nullptr));
+
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(&sync));
+    EXPECT_CALL(native_handle, PQexitPipelineMode()).InSequence(s).WillOnce(Return(1));
+
+    EXPECT_CALL(cb_io.executor_, dispatch(_)).InSequence(s).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(callback, call(error_code {}, _)).InSequence(s).WillOnce(Return());
+
+    ozo::impl::async_request_op{ozo::prepared(empty_query {}), ozo::none, ozo::none, wrap(callback)}(error_code {}, conn);
+
+    ASSERT_NE(conn->statement_cache().find(""), nullptr);
+    EXPECT_EQ(*conn->statement_cache().find(""), "ozo_1");
+}
+
+TEST_F(async_request_op, should_execute_cached_statement_for_prepared_query_in_cache) {
+
+    EXPECT_CALL(io.strand_service_, get_executor()).WillOnce(ReturnRef(strand));
+    EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+
+    conn->statement_cache().emplace("", "ozo_42");
+
+    Sequence s;
+
+    EXPECT_CALL(native_handle, PQsetnonblocking(1)).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQsendQueryPrepared(StrEq("ozo_42"), _, _, _, _, _)).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQflush()).InSequence(s).WillOnce(Return(0));
+
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(nullptr));
+
+    EXPECT_CALL(cb_io.executor_, dispatch(_)).InSequence(s).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(callback, call(error_code {}, _)).InSequence(s).WillOnce(Return());
+
+    ozo::impl::async_request_op{ozo::prepared(empty_query {}), ozo::none, ozo::none, wrap(callback)}(error_code {}, conn);
+}
+
+TEST_F(async_request_op, should_prepare_statement_again_and_repeat_request_if_cached_statement_is_lost_on_server) {
+
+    EXPECT_CALL(io.strand_service_, get_executor()).WillRepeatedly(ReturnRef(strand));
+    EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+
+    conn->statement_cache().emplace("", "ozo_42");
+
+    ozo::tests::pg_result lost {PGRES_FATAL_ERROR, "26000"};
+    ozo::tests::pg_result ok {PGRES_COMMAND_OK, nullptr};
+    ozo::tests::pg_result sync {PGRES_PIPELINE_SYNC, nullptr};
+
+    Sequence s;
+
+    EXPECT_CALL(native_handle, PQsetnonblocking(1)).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQsendQueryPrepared(StrEq("ozo_42"), _, _, _, _, _)).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQflush()).InSequence(s).WillOnce(Return(0));
+
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(&lost));
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(nullptr));
+    EXPECT_CALL(connection, cancel()).InSequence(s).WillOnce(Return());
+    EXPECT_CALL(cb_io.executor_, dispatch(_)).InSequence(s).WillOnce(InvokeArgument<0>());
+
+    EXPECT_CALL(connection, is_bad()).InSequence(s).WillOnce(Return(false));
+    EXPECT_CALL(native_handle, PQtransactionStatus()).InSequence(s).WillOnce(Return(PQTRANS_IDLE));
+
+    EXPECT_CALL(native_handle, PQsetnonblocking(1)).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQenterPipelineMode()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQsendPrepare(StrEq("ozo_1"), _, _, _)).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQsendQueryPrepared(StrEq("ozo_1"), _, _, _, _, _)).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQpipelineSync()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQflush()).InSequence(s).WillOnce(Return(0));
+
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+        EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(&ok));
+        EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+        EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(nullptr));
+    }
+
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(&sync));
+    EXPECT_CALL(native_handle, PQexitPipelineMode()).InSequence(s).WillOnce(Return(1));
+
+    EXPECT_CALL(cb_io.executor_, dispatch(_)).InSequence(s).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(callback, call(error_code {}, _)).InSequence(s).WillOnce(Return());
+
+    ozo::impl::async_request_op{ozo::prepared(empty_query {}), ozo::none, ozo::none, wrap(callback)}(error_code {}, conn);
+
+    ASSERT_NE(conn->statement_cache().find(""), nullptr);
+    EXPECT_EQ(*conn->statement_cache().find(""), "ozo_1");
+}
+
+TEST_F(async_request_op, should_not_repeat_request_if_statement_is_lost_within_transaction) {
+
+    EXPECT_CALL(io.strand_service_, get_executor()).WillOnce(ReturnRef(strand));
+    EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+
+    conn->statement_cache().emplace("", "ozo_42");
+
+    ozo::tests::pg_result lost {PGRES_FATAL_ERROR, "26000"};
+
+    Sequence s;
+
+    EXPECT_CALL(native_handle, PQsetnonblocking(1)).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQsendQueryPrepared(StrEq("ozo_42"), _, _, _, _, _)).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQflush()).InSequence(s).WillOnce(Return(0));
+
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(&lost));
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(nullptr));
+    EXPECT_CALL(connection, cancel()).InSequence(s).WillOnce(Return());
+    EXPECT_CALL(cb_io.executor_, dispatch(_)).InSequence(s).WillOnce(InvokeArgument<0>());
+
+    EXPECT_CALL(connection, is_bad()).InSequence(s).WillOnce(Return(false));
+    EXPECT_CALL(native_handle, PQtransactionStatus()).InSequence(s).WillOnce(Return(PQTRANS_INERROR));
+    EXPECT_CALL(callback, call(error_code {ozo::sqlstate::make_error_code(ozo::sqlstate::invalid_sql_statement_name)}, _))
+        .InSequence(s).WillOnce(Return());
+
+    ozo::impl::async_request_op{ozo::prepared(empty_query {}), ozo::none, ozo::none, wrap(callback)}(error_code {}, conn);
+}
+
+TEST_F(async_request_op, should_execute_statement_found_by_id_for_prepared_query_with_static_text) {
+    using namespace ozo::literals;
+
+    EXPECT_CALL(io.strand_service_, get_executor()).WillOnce(ReturnRef(strand));
+    EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+
+    const auto query = ozo::prepared("SELECT 1"_SQL);
+    ASSERT_NE(query.statement, nullptr);
+    conn->statement_cache().emplace(query.statement->id, "SELECT 1", query.statement->name);
+
+    Sequence s;
+
+    EXPECT_CALL(native_handle, PQsetnonblocking(1)).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQsendQueryPrepared(StrEq(query.statement->name), _, _, _, _, _)).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQflush()).InSequence(s).WillOnce(Return(0));
+
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(nullptr));
+
+    EXPECT_CALL(cb_io.executor_, dispatch(_)).InSequence(s).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(callback, call(error_code {}, _)).InSequence(s).WillOnce(Return());
+
+    ozo::impl::async_request_op{query, ozo::none, ozo::none, wrap(callback)}(error_code {}, conn);
+}
+
+struct column_plans_out_handler {
+    using column_plans_tag = void;
+
+    int* described;
+    const ozo::detail::column_plan_cache** executed_with;
+
+    template <typename Handle, typename Conn>
+    error_code operator() (Handle&&, Conn&, const ozo::detail::column_plan_cache* plans = nullptr) {
+        *executed_with = plans;
+        return {};
+    }
+
+    template <typename Handle, typename Conn>
+    void describe(Handle&&, Conn&, ozo::detail::column_plan_cache&) {
+        ++*described;
+    }
+};
+
+TEST_F(async_request_op, should_describe_prepared_statement_in_pipeline_for_out_handler_with_column_plans) {
+
+    EXPECT_CALL(io.strand_service_, get_executor()).WillOnce(ReturnRef(strand));
+    EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+
+    ozo::tests::pg_result ok {PGRES_COMMAND_OK, nullptr};
+    ozo::tests::pg_result sync {PGRES_PIPELINE_SYNC, nullptr};
+
+    Sequence s;
+
+    EXPECT_CALL(native_handle, PQsetnonblocking(1)).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQenterPipelineMode()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQsendPrepare(StrEq("ozo_1"), _, _, _)).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQsendDescribePrepared(StrEq("ozo_1"))).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQsendQueryPrepared(StrEq("ozo_1"), _, _, _, _, _)).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQpipelineSync()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQflush()).InSequence(s).WillOnce(Return(0));
+
+    // Prepare, describe and execute results
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+        EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(&ok));
+        EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+        EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(nullptr));
+    }
+
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(&sync));
+    EXPECT_CALL(native_handle, PQexitPipelineMode()).InSequence(s).WillOnce(Return(1));
+
+    EXPECT_CALL(cb_io.executor_, dispatch(_)).InSequence(s).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(callback, call(error_code {}, _)).InSequence(s).WillOnce(Return());
+
+    int described = 0;
+    const ozo::detail::column_plan_cache* executed_with = nullptr;
+    ozo::impl::async_request_op{ozo::prepared(empty_query {}), ozo::none,
+        column_plans_out_handler{&described, &executed_with}, wrap(callback)}(error_code {}, conn);
+
+    EXPECT_EQ(described, 1);
+    EXPECT_NE(executed_with, nullptr);
+    EXPECT_EQ(executed_with, conn->statement_cache().plans(""));
+}
+
+TEST_F(async_request_op, should_pass_column_plans_of_cached_statement_to_out_handler) {
+
+    EXPECT_CALL(io.strand_service_, get_executor()).WillOnce(ReturnRef(strand));
+    EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+
+    conn->statement_cache().emplace("", "ozo_42");
+
+    ozo::tests::pg_result ok {PGRES_COMMAND_OK, nullptr};
+
+    Sequence s;
+
+    EXPECT_CALL(native_handle, PQsetnonblocking(1)).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQsendQueryPrepared(StrEq("ozo_42"), _, _, _, _, _)).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQflush()).InSequence(s).WillOnce(Return(0));
+
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(&ok));
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(nullptr));
+
+    EXPECT_CALL(cb_io.executor_, dispatch(_)).InSequence(s).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(callback, call(error_code {}, _)).InSequence(s).WillOnce(Return());
+
+    int described = 0;
+    const ozo::detail::column_plan_cache* executed_with = nullptr;
+    ozo::impl::async_request_op{ozo::prepared(empty_query {}), ozo::none,
+        column_plans_out_handler{&described, &executed_with}, wrap(callback)}(error_code {}, conn);
+
+    EXPECT_EQ(described, 0);
+    EXPECT_NE(executed_with, nullptr);
+    EXPECT_EQ(executed_with, conn->statement_cache().plans(""));
+}
+
+TEST_F(async_request_op, should_deallocate_evicted_statements_before_prepare_and_call_handler_with_error_if_send_failed) {
+
+    EXPECT_CALL(io.strand_service_, get_executor()).WillOnce(ReturnRef(strand));
+    EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+
+    conn->statement_cache_ = ozo::detail::statement_cache(0);
+    conn->statement_cache().emplace("SELECT 1", "ozo_evicted");
+
+    Sequence s;
+
+    EXPECT_CALL(native_handle, PQsetnonblocking(1)).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQenterPipelineMode()).InSequence(s).WillOnce(Return(1));
+#ifdef LIBPQ_HAS_CLOSE_PREPARED
+    EXPECT_CALL(native_handle, PQsendClosePrepared(StrEq("ozo_evicted"))).InSequence(s).WillOnce(Return(1));
+#else
+    EXPECT_CALL(native_handle, PQsendQueryParams(StrEq("DEALLOCATE ozo_evicted"), 0, _, _, _, _, _))
+        .InSequence(s).WillOnce(Return(1));
+#endif
+    EXPECT_CALL(native_handle, PQsendPrepare(_, _, _, _)).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQsendQueryPrepared(_, _, _, _, _, _)).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(connection, cancel()).InSequence(s).WillOnce(Return());
+    EXPECT_CALL(cb_io.executor_, dispatch(_)).InSequence(s).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(callback, call(error_code {ozo::error::pg_send_query_prepared_failed}, _)).InSequence(s).WillOnce(Return());
+
+    ozo::impl::async_request_op{ozo::prepared(empty_query {}), ozo::none, ozo::none, wrap(callback)}(error_code {}, conn);
+
+    EXPECT_THAT(conn->statement_cache().take_evicted(), Contains("ozo_evicted"));
+}
+
+struct async_request_op_with_evicted_statement : async_request_op {
+    ozo::tests::pg_result ok {PGRES_COMMAND_OK, nullptr};
+    ozo::tests::pg_result fatal {PGRES_FATAL_ERROR, "42P01"};
+    ozo::tests::pg_result aborted {PGRES_PIPELINE_ABORTED, nullptr};
+    ozo::tests::pg_result sync {PGRES_PIPELINE_SYNC, nullptr};
+    Sequence s;
+
+    async_request_op_with_evicted_statement() {
+        EXPECT_CALL(io.strand_service_, get_executor()).WillOnce(ReturnRef(strand));
+        EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+
+        conn->statement_cache_ = ozo::detail::statement_cache(1);
+        conn->statement_cache().emplace("SELECT 1", "ozo_evicted");
+        conn->statement_cache().emplace("SELECT 2", "ozo_cached");
+
+        EXPECT_CALL(native_handle, PQsetnonblocking(1)).InSequence(s).WillOnce(Return(0));
+        EXPECT_CALL(native_handle, PQenterPipelineMode()).InSequence(s).WillOnce(Return(1));
+#ifdef LIBPQ_HAS_CLOSE_PREPARED
+        EXPECT_CALL(native_handle, PQsendClosePrepared(StrEq("ozo_evicted"))).InSequence(s).WillOnce(Return(1));
+#else
+        EXPECT_CALL(native_handle, PQsendQueryParams(StrEq("DEALLOCATE ozo_evicted"), 0, _, _, _, _, _))
+            .InSequence(s).WillOnce(Return(1));
+#endif
+        EXPECT_CALL(native_handle, PQsendPrepare(_, _, _, _)).InSequence(s).WillOnce(Return(1));
+        EXPECT_CALL(native_handle, PQsendQueryPrepared(_, _, _, _, _, _)).InSequence(s).WillOnce(Return(1));
+        EXPECT_CALL(native_handle, PQpipelineSync()).InSequence(s).WillOnce(Return(1));
+        EXPECT_CALL(native_handle, PQflush()).InSequence(s).WillOnce(Return(0));
+    }
+
+    void expect_result(ozo::tests::pg_result* result) {
+        EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+        EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(result));
+        EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+        EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(nullptr));
+    }
+
+    void expect_sync() {
+        EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+        EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(&sync));
+        EXPECT_CALL(native_handle, PQexitPipelineMode()).InSequence(s).WillOnce(Return(1));
+    }
+};
+
+TEST_F(async_request_op_with_evicted_statement, should_cache_prepared_statement_and_call_handler_if_deallocation_failed) {
+    expect_result(&fatal);
+    expect_result(&ok);
+    expect_result(&ok);
+    expect_sync();
+    EXPECT_CALL(cb_io.executor_, dispatch(_)).InSequence(s).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(callback, call(error_code {}, _)).InSequence(s).WillOnce(Return());
+
+    ozo::impl::async_request_op{ozo::prepared(empty_query {}), ozo::none, ozo::none, wrap(callback)}(error_code {}, conn);
+
+    EXPECT_NE(conn->statement_cache().find(""), nullptr);
+}
+
+TEST_F(async_request_op_with_evicted_statement, should_call_handler_with_deallocation_error_if_query_has_been_aborted_by_it) {
+    expect_result(&fatal);
+    expect_result(&aborted);
+    expect_result(&aborted);
+    expect_sync();
+    EXPECT_CALL(connection, cancel()).InSequence(s).WillOnce(Return());
+    EXPECT_CALL(cb_io.executor_, dispatch(_)).InSequence(s).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(callback, call(ozo::sqlstate::make_error_code(ozo::sqlstate::undefined_table), _)).InSequence(s).WillOnce(Return());
+
+    ozo::impl::async_request_op{ozo::prepared(empty_query {}), ozo::none, ozo::none, wrap(callback)}(error_code {}, conn);
+
+    EXPECT_EQ(conn->statement_cache().find(""), nullptr);
+}
+
+TEST_F(async_request_op, should_send_statement_timeout_and_query_in_pipeline_if_deadline_is_propagated) {
+
+    conn->propagate_deadline_ = true;
+
+    EXPECT_CALL(io.strand_service_, get_executor()).WillOnce(ReturnRef(strand));
+    EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+    EXPECT_CALL(io.timer_service_, timer(An<time_traits::time_point>())).WillRepeatedly(ReturnRef(timer));
+
+    ozo::tests::pg_result ok {PGRES_COMMAND_OK, nullptr};
+    ozo::tests::pg_result sync {PGRES_PIPELINE_SYNC, nullptr};
+
+    std::function<void (error_code)> on_timer_expired;
+
+    Sequence s;
+
+    EXPECT_CALL(timer, async_wait(_)).InSequence(s).WillOnce(SaveArg<0>(&on_timer_expired));
+    EXPECT_CALL(native_handle, PQtransactionStatus()).InSequence(s).WillOnce(Return(PQTRANS_IDLE));
+    EXPECT_CALL(native_handle, PQsetnonblocking(1)).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQenterPipelineMode()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQsendQueryParams(StrEq("SELECT set_config('statement_timeout', $1, true)"), 1, _, _, _, _, _))
+        .InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQsendQueryParams(StrEq(""), _, _, _, _, _, _)).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQpipelineSync()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQflush()).InSequence(s).WillOnce(Return(0));
+
+    // set_config result
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(&ok));
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(nullptr));
+
+    // Query result
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(&ok));
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(nullptr));
+
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(&sync));
+    EXPECT_CALL(native_handle, PQexitPipelineMode()).InSequence(s).WillOnce(Return(1));
+
+    EXPECT_CALL(timer, cancel()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(strand, post(_)).InSequence(s).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(cb_io.executor_, dispatch(_)).InSequence(s).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(callback, call(error_code {}, _)).InSequence(s).WillOnce(Return());
+
+    const auto deadline = time_traits::now() + std::chrono::hours(1);
+    ozo::impl::async_request_op{empty_query {}, deadline, ozo::none, wrap(callback)}(error_code {}, conn);
+    on_timer_expired(boost::asio::error::operation_aborted);
+}
+
+TEST_F(async_request_op, should_not_send_statement_timeout_if_connection_is_in_transaction) {
+
+    conn->propagate_deadline_ = true;
+
+    EXPECT_CALL(io.strand_service_, get_executor()).WillOnce(ReturnRef(strand));
+    EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+    EXPECT_CALL(io.timer_service_, timer(An<time_traits::time_point>())).WillRepeatedly(ReturnRef(timer));
+
+    std::function<void (error_code)> on_timer_expired;
+
+    Sequence s;
+
+    EXPECT_CALL(timer, async_wait(_)).InSequence(s).WillOnce(SaveArg<0>(&on_timer_expired));
+    EXPECT_CALL(native_handle, PQtransactionStatus()).InSequence(s).WillOnce(Return(PQTRANS_INTRANS));
+    EXPECT_CALL(native_handle, PQsetnonblocking(1)).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQsendQueryParams(StrEq(""), _, _, _, _, _, _)).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQflush()).InSequence(s).WillOnce(Return(0));
+
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(nullptr));
+
+    EXPECT_CALL(timer, cancel()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(strand, post(_)).InSequence(s).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(cb_io.executor_, dispatch(_)).InSequence(s).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(callback, call(error_code {}, _)).InSequence(s).WillOnce(Return());
+
+    const auto deadline = time_traits::now() + std::chrono::hours(1);
+    ozo::impl::async_request_op{empty_query {}, deadline, ozo::none, wrap(callback)}(error_code {}, conn);
+    on_timer_expired(boost::asio::error::operation_aborted);
+}
+
+struct async_out_processor {
+    using async_result_processor_tag = void;
+
+    bool* processed = nullptr;
+
+    template <typename Result, typename Connection, typename Continuation>
+    void async_process(Result&&, Connection&, Continuation) { *processed = true; }
+};
+
+TEST_F(async_request_op, should_not_send_statement_timeout_for_async_result_processor) {
+
+    conn->propagate_deadline_ = true;
+
+    EXPECT_CALL(io.strand_service_, get_executor()).WillOnce(ReturnRef(strand));
+    EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+    EXPECT_CALL(io.timer_service_, timer(An<time_traits::time_point>())).WillRepeatedly(ReturnRef(timer));
+
+    ozo::tests::pg_result ok {PGRES_TUPLES_OK, nullptr};
+
+    Sequence s;
+
+    EXPECT_CALL(timer, async_wait(_)).InSequence(s).WillOnce(Return());
+    EXPECT_CALL(native_handle, PQsetnonblocking(1)).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQsendQueryParams(StrEq(""), _, _, _, _, _, _)).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQflush()).InSequence(s).WillOnce(Return(0));
+
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(&ok));
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(nullptr));
+
+    bool processed = false;
+    const auto deadline = time_traits::now() + std::chrono::hours(1);
+    ozo::impl::async_request_op{empty_query {}, deadline, async_out_processor{&processed}, wrap(callback)}(error_code {}, conn);
+    EXPECT_TRUE(processed);
+}
+
+const auto deferred_begin_options = ozo::make_options(ozo::transaction_options::deferred_begin = std::true_type{});
+
+using deferred_transaction = ozo::transaction<connection_ptr<>, std::decay_t<decltype(deferred_begin_options)>>;
+
+struct async_request_op_in_transaction : async_request_op {
+    StrictMock<callback_gmock<deferred_transaction>> transaction_callback {};
+    deferred_transaction transaction {connection_ptr<>{conn}, deferred_begin_options};
+};
+
+TEST_F(async_request_op_in_transaction, should_send_pending_begin_and_query_in_pipeline_and_call_handler) {
+
+    EXPECT_CALL(io.strand_service_, get_executor()).WillOnce(ReturnRef(strand));
+    EXPECT_CALL(transaction_callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+
+    ozo::tests::pg_result ok {PGRES_COMMAND_OK, nullptr};
+    ozo::tests::pg_result sync {PGRES_PIPELINE_SYNC, nullptr};
+
+    Sequence s;
+
+    EXPECT_CALL(native_handle, PQtransactionStatus()).InSequence(s).WillOnce(Return(PQTRANS_IDLE));
+    EXPECT_CALL(native_handle, PQsetnonblocking(1)).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQenterPipelineMode()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQsendQueryParams(StrEq("BEGIN"), 0, _, _, _, _, _)).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQsendQueryParams(StrEq(""), _, _, _, _, _, _)).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQpipelineSync()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQflush()).InSequence(s).WillOnce(Return(0));
+
+    // BEGIN result
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(&ok));
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(nullptr));
+
+    // Query result
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(&ok));
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(nullptr));
+
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(&sync));
+    EXPECT_CALL(native_handle, PQexitPipelineMode()).InSequence(s).WillOnce(Return(1));
+
+    EXPECT_CALL(cb_io.executor_, dispatch(_)).InSequence(s).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(transaction_callback, call(error_code {}, _)).InSequence(s).WillOnce(Return());
+
+    ozo::impl::async_request_op{empty_query {}, ozo::none, ozo::none, wrap(transaction_callback)}(error_code {}, transaction);
+}
+
+TEST_F(async_request_op_in_transaction, should_send_query_only_if_begin_has_been_sent) {
+
+    EXPECT_CALL(io.strand_service_, get_executor()).WillOnce(ReturnRef(strand));
+    EXPECT_CALL(transaction_callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+
+    Sequence s;
+
+    EXPECT_CALL(native_handle, PQtransactionStatus()).InSequence(s).WillOnce(Return(PQTRANS_INTRANS));
+    EXPECT_CALL(native_handle, PQsetnonblocking(1)).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQsendQueryParams(StrEq(""), _, _, _, _, _, _)).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQflush()).InSequence(s).WillOnce(Return(0));
+
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(nullptr));
+
+    EXPECT_CALL(cb_io.executor_, dispatch(_)).InSequence(s).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(transaction_callback, call(error_code {}, _)).InSequence(s).WillOnce(Return());
+
+    ozo::impl::async_request_op{empty_query {}, ozo::none, ozo::none, wrap(transaction_callback)}(error_code {}, transaction);
+}
+
+const auto lazy_begin_options = ozo::make_options(
+    ozo::transaction_options::mode = ozo::transaction_mode::read_only,
+    ozo::transaction_options::lazy_begin = std::true_type{});
+
+using lazy_transaction = ozo::transaction<connection_ptr<>, std::decay_t<decltype(lazy_begin_options)>>;
+
+struct async_request_op_in_lazy_transaction : async_request_op {
+    StrictMock<callback_gmock<lazy_transaction>> transaction_callback {};
+    lazy_transaction transaction {connection_ptr<>{conn}, lazy_begin_options};
+};
+
+TEST_F(async_request_op_in_lazy_transaction, should_send_first_query_without_begin_and_call_handler_with_begin_elided) {
+
+    EXPECT_CALL(io.strand_service_, get_executor()).WillOnce(ReturnRef(strand));
+    EXPECT_CALL(transaction_callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+
+    Sequence s;
+
+    EXPECT_CALL(native_handle, PQtransactionStatus()).InSequence(s).WillOnce(Return(PQTRANS_IDLE));
+    EXPECT_CALL(native_handle, PQsetnonblocking(1)).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQsendQueryParams(StrEq(""), _, _, _, _, _, _)).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQflush()).InSequence(s).WillOnce(Return(0));
+
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(nullptr));
+
+    EXPECT_CALL(cb_io.executor_, dispatch(_)).InSequence(s).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(transaction_callback, call(error_code {}, _)).InSequence(s)
+        .WillOnce(Invoke([] (error_code, lazy_transaction t) { EXPECT_FALSE(t.is_begin_elidable()); }));
+
+    ozo::impl::async_request_op{empty_query {}, ozo::none, ozo::none, wrap(transaction_callback)}(error_code {}, transaction);
+}
+
+TEST_F(async_request_op_in_lazy_transaction, should_send_begin_and_second_query_in_pipeline) {
+
+    transaction.elide_begin();
+
+    EXPECT_CALL(io.strand_service_, get_executor()).WillOnce(ReturnRef(strand));
+    EXPECT_CALL(transaction_callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+
+    ozo::tests::pg_result ok {PGRES_COMMAND_OK, nullptr};
+    ozo::tests::pg_result sync {PGRES_PIPELINE_SYNC, nullptr};
+
+    Sequence s;
+
+    EXPECT_CALL(native_handle, PQtransactionStatus()).InSequence(s).WillOnce(Return(PQTRANS_IDLE));
+    EXPECT_CALL(native_handle, PQsetnonblocking(1)).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQenterPipelineMode()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQsendQueryParams(StrEq("BEGIN READ ONLY"), 0, _, _, _, _, _)).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQsendQueryParams(StrEq(""), _, _, _, _, _, _)).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQpipelineSync()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQflush()).InSequence(s).WillOnce(Return(0));
+
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(&ok));
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(nullptr));
+
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(&ok));
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(nullptr));
+
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(&sync));
+    EXPECT_CALL(native_handle, PQexitPipelineMode()).InSequence(s).WillOnce(Return(1));
+
+    EXPECT_CALL(cb_io.executor_, dispatch(_)).InSequence(s).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(transaction_callback, call(error_code {}, _)).InSequence(s).WillOnce(Return());
+
+    ozo::impl::async_request_op{empty_query {}, ozo::none, ozo::none, wrap(transaction_callback)}(error_code {}, transaction);
+}
+
+#endif
+
+#ifdef OZO_HAS_CANCELLATION_SLOT
+
+TEST_F(async_request_op, should_cancel_connection_io_if_cancellation_slot_of_handler_is_emitted_while_waiting_for_result) {
+    boost::asio::cancellation_signal signal;
+
+    EXPECT_CALL(io.strand_service_, get_executor()).WillOnce(ReturnRef(strand));
+    EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+
+    Sequence s;
+
+    // Send query params
+    EXPECT_CALL(native_handle, PQsetnonblocking(1)).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQsendQueryParams(_, _, _, _, _, _, _)).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQflush()).InSequence(s).WillOnce(Return(0));
+
+    // Wait for result
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(connection, async_wait_read(_)).InSequence(s).WillOnce(Return());
+
+    ozo::impl::async_request_op{empty_query {}, ozo::none, ozo::none,
+        boost::asio::bind_cancellation_slot(signal.slot(), wrap(callback))}(error_code {}, conn);
+    ASSERT_TRUE(signal.slot().has_handler());
+
+    EXPECT_CALL(connection, cancel()).InSequence(s).WillOnce(Return());
+    signal.emit(boost::asio::cancellation_type::terminal);
+}
+
+TEST_F(async_request_op, should_clear_cancellation_slot_of_handler_on_completion) {
+    boost::asio::cancellation_signal signal;
+
+    EXPECT_CALL(io.strand_service_, get_executor()).WillOnce(ReturnRef(strand));
+    EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+
+    Sequence s;
+
+    // Send query params
+    EXPECT_CALL(native_handle, PQsetnonblocking(1)).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQsendQueryParams(_, _, _, _, _, _, _)).InSequence(s).WillOnce(Return(1));
+    EXPECT_CALL(native_handle, PQflush()).InSequence(s).WillOnce(Return(0));
+
+    // Get result
+    EXPECT_CALL(native_handle, PQisBusy()).InSequence(s).WillOnce(Return(0));
+    EXPECT_CALL(native_handle, PQgetResult()).InSequence(s).WillOnce(Return(nullptr));
+
+    // Call client handler
+    EXPECT_CALL(cb_io.executor_, dispatch(_)).InSequence(s).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(callback, call(error_code {}, _)).InSequence(s).WillOnce(Return());
+
+    ozo::impl::async_request_op{empty_query {}, ozo::none, ozo::none,
+        boost::asio::bind_cancellation_slot(signal.slot(), wrap(callback))}(error_code {}, conn);
+
+    EXPECT_FALSE(signal.slot().has_handler());
+    signal.emit(boost::asio::cancellation_type::terminal);
+}
+
+#endif
+
 } // namespace
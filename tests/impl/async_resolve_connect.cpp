@@ -0,0 +1,92 @@
+#include <ozo/impl/async_resolve_connect.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+using namespace std::literals;
+
+using ozo::impl::connection_params;
+
+connection_params parse(const std::string& conninfo) {
+    auto result = ozo::impl::parse_connection_params(conninfo);
+    EXPECT_TRUE(result);
+    return result.value_or(connection_params{});
+}
+
+TEST(parse_connection_params, should_return_specified_parameters_only) {
+    const auto params = parse("host=db.example.com port=6432 dbname=test");
+    EXPECT_THAT(params.values(), UnorderedElementsAre(
+        Pair("host", "db.example.com"),
+        Pair("port", "6432"),
+        Pair("dbname", "test")
+    ));
+}
+
+TEST(parse_connection_params, should_parse_uri) {
+    const auto params = parse("postgresql://user@db.example.com:6432/test");
+    ASSERT_TRUE(params.find("host"));
+    EXPECT_EQ(*params.find("host"), "db.example.com");
+    ASSERT_TRUE(params.find("user"));
+    EXPECT_EQ(*params.find("user"), "user");
+}
+
+TEST(parse_connection_params, should_return_nullopt_for_invalid_connection_string) {
+    EXPECT_FALSE(ozo::impl::parse_connection_params("invalid connection info"));
+}
+
+TEST(connection_params, set_should_replace_value_of_specified_parameter) {
+    auto params = parse("host=a");
+    params.set("host", "b");
+    EXPECT_THAT(params.values(), ElementsAre(Pair("host", "b")));
+}
+
+TEST(get_resolvable_host, should_return_host_name) {
+    EXPECT_EQ(ozo::impl::get_resolvable_host(parse("host=db.example.com")), "db.example.com");
+}
+
+TEST(get_resolvable_host, should_return_nullopt_without_host) {
+    EXPECT_FALSE(ozo::impl::get_resolvable_host(parse("dbname=test")));
+}
+
+TEST(get_resolvable_host, should_return_nullopt_for_unix_socket_directory) {
+    EXPECT_FALSE(ozo::impl::get_resolvable_host(parse("host=/var/run/postgresql")));
+}
+
+TEST(get_resolvable_host, should_return_nullopt_for_multiple_hosts) {
+    EXPECT_FALSE(ozo::impl::get_resolvable_host(parse("host=a,b")));
+}
+
+TEST(get_resolvable_host, should_return_nullopt_if_hostaddr_is_specified) {
+    EXPECT_FALSE(ozo::impl::get_resolvable_host(parse("host=a hostaddr=127.0.0.1")));
+}
+
+TEST(apply_resolved_addresses, should_set_hostaddr_and_repeat_host_for_each_address) {
+    auto params = parse("host=db.example.com port=6432");
+    ozo::impl::apply_resolved_addresses(params, {"192.0.2.1", "2001:db8::1"});
+    EXPECT_THAT(params.values(), UnorderedElementsAre(
+        Pair("host", "db.example.com,db.example.com"),
+        Pair("hostaddr", "192.0.2.1,2001:db8::1"),
+        Pair("port", "6432")
+    ));
+}
+
+TEST(dns_cache, should_return_addresses_until_expiration) {
+    ozo::detail::dns_cache cache(10s);
+    const auto now = ozo::time_traits::now();
+    cache.insert("a", {"192.0.2.1"}, now);
+    EXPECT_THAT(cache.find("a", now + 9s), Optional(ElementsAre("192.0.2.1")));
+    EXPECT_FALSE(cache.find("a", now + 10s));
+    EXPECT_FALSE(cache.find("b", now));
+}
+
+TEST(dns_cache, clear_should_remove_all_addresses) {
+    ozo::detail::dns_cache cache(10s);
+    cache.insert("a", {"192.0.2.1"}, ozo::time_traits::now());
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0u);
+}
+
+} // namespace
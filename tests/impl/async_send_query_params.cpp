@@ -179,4 +179,22 @@ TEST_F(async_send_query_params_op, should_wait_for_write_in_strand) {
     ozo::impl::async_send_query_params_op(m.ctx, m.query)();
 }
 
+struct async_send_query_params : Test {
+    fixture m;
+};
+
+TEST_F(async_send_query_params, with_typed_binary_query_should_send_its_data) {
+    const InSequence s;
+
+    const auto query = ozo::to_typed_binary_query(ozo::make_query("query", std::int32_t(42)), ozo::empty_oid_map_c);
+
+    EXPECT_CALL(m.native_handle, PQsetnonblocking(1)).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQsendQueryParams(StrEq("query"), 1, _, _, _, _, _)).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQflush()).WillOnce(Return(0));
+
+    ozo::impl::async_send_query_params(m.ctx, query);
+
+    EXPECT_EQ(m.ctx->state, ozo::impl::query_state::send_finish);
+}
+
 } // namespace
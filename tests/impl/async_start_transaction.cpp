@@ -34,4 +34,19 @@ TEST_F(async_start_transaction, should_call_async_execute) {
     ozo::detail::async_start_transaction(conn, options, empty_query {}, timeout, wrap(callback));
 }
 
+#ifdef LIBPQ_HAS_PIPELINING
+
+TEST_F(async_start_transaction, should_not_call_async_execute_for_deferred_begin) {
+    const auto deferred = ozo::make_options(ozo::transaction_options::deferred_begin = std::true_type{});
+    StrictMock<callback_gmock<ozo::transaction<connection_ptr<>, std::decay_t<decltype(deferred)>>>> deferred_callback {};
+
+    EXPECT_CALL(deferred_callback, get_executor()).WillRepeatedly(Return(io.get_executor()));
+    EXPECT_CALL(io.executor_, dispatch(_)).Times(2).WillRepeatedly(InvokeArgument<0>());
+    EXPECT_CALL(deferred_callback, call(error_code {}, _)).WillOnce(Return());
+
+    ozo::detail::async_start_transaction(conn, deferred, empty_query {}, timeout, wrap(deferred_callback));
+}
+
+#endif
+
 } // namespace
@@ -0,0 +1,156 @@
+#include <connection_mock.h>
+#include <test_error.h>
+
+#include <ozo/stream_request.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+using namespace ozo::tests;
+
+using callback_mock = callback_gmock<connection_ptr<>>;
+
+using ozo::error_code;
+
+struct fixture {
+    StrictMock<connection_gmock> connection{};
+    StrictMock<PGconn_mock> native_handle{};
+    StrictMock<callback_mock> callback{};
+    io_context io;
+    execution_context cb_io;
+    connection_ptr<> conn = make_connection(connection, io, native_handle);
+    ozo::binary_query query = ozo::to_binary_query(empty_query {}, ozo::empty_oid_map_c);
+
+    auto make_operation_context() {
+        EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+        return ozo::impl::make_request_operation_context(conn, wrap(callback));
+    }
+
+    decltype(ozo::impl::make_request_operation_context(conn, wrap(callback))) ctx;
+
+    fixture() : ctx(make_operation_context()) {}
+};
+
+struct async_send_query_params_in_rows_mode : Test {
+    fixture m;
+};
+
+TEST_F(async_send_query_params_in_rows_mode, should_send_query_params_and_set_single_row_mode_and_flush) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQsetnonblocking(1)).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQsendQueryParams(_, _, _, _, _, _, _)).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQsetSingleRowMode()).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQflush()).WillOnce(Return(0));
+
+    ozo::impl::async_send_query_params_in_rows_mode(m.ctx, m.query, 1);
+
+    EXPECT_EQ(m.ctx->state, ozo::impl::query_state::send_finish);
+}
+
+TEST_F(async_send_query_params_in_rows_mode, should_call_handler_with_error_if_set_single_row_mode_failed) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQsetnonblocking(1)).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQsendQueryParams(_, _, _, _, _, _, _)).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQsetSingleRowMode()).WillOnce(Return(0));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::pg_set_single_row_mode_failed}, _)).WillOnce(Return());
+
+    ozo::impl::async_send_query_params_in_rows_mode(m.ctx, m.query, 1);
+
+    EXPECT_EQ(m.ctx->state, ozo::impl::query_state::error);
+}
+
+struct chunk_processor_mock {
+    MOCK_CONST_METHOD1(call, void(ExecStatusType));
+};
+
+struct chunk_processor {
+    chunk_processor_mock& mock;
+
+    template <typename Handle, typename Conn>
+    void operator() (Handle&& h, Conn&) const { mock.call(h->status); }
+};
+
+struct async_get_result_chunks : Test {
+    fixture m;
+    StrictMock<chunk_processor_mock> process;
+    ozo::tests::pg_result row {PGRES_SINGLE_TUPLE, nullptr};
+    ozo::tests::pg_result end {PGRES_TUPLES_OK, nullptr};
+    ozo::tests::pg_result fatal {PGRES_FATAL_ERROR, "42P01"};
+    ozo::tests::pg_result copy {PGRES_COPY_OUT, nullptr};
+};
+
+TEST_F(async_get_result_chunks, should_process_each_row_as_soon_as_it_received_and_call_handler) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&row));
+    EXPECT_CALL(process, call(PGRES_SINGLE_TUPLE)).WillOnce(Return());
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(1));
+    EXPECT_CALL(m.connection, async_wait_read(_)).WillOnce(InvokeArgument<0>(error_code{}));
+    EXPECT_CALL(m.cb_io.executor_, post(_)).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(m.native_handle, PQconsumeInput()).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&row));
+    EXPECT_CALL(process, call(PGRES_SINGLE_TUPLE)).WillOnce(Return());
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&end));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.callback, call(error_code{}, _)).WillOnce(Return());
+
+    ozo::impl::async_get_result_chunks(m.ctx, chunk_processor{process});
+}
+
+TEST_F(async_get_result_chunks, should_consume_results_and_call_handler_with_database_error) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&row));
+    EXPECT_CALL(process, call(PGRES_SINGLE_TUPLE)).WillOnce(Return());
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&fatal));
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(ozo::sqlstate::make_error_code(ozo::sqlstate::undefined_table), _)).WillOnce(Return());
+
+    ozo::impl::async_get_result_chunks(m.ctx, chunk_processor{process});
+}
+
+TEST_F(async_get_result_chunks, should_call_handler_with_bad_result_process_immediately_if_processing_throws) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&row));
+    EXPECT_CALL(process, call(PGRES_SINGLE_TUPLE)).WillOnce(Throw(std::runtime_error("error")));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::bad_result_process}, _)).WillOnce(Return());
+
+    ozo::impl::async_get_result_chunks(m.ctx, chunk_processor{process});
+
+    EXPECT_EQ(m.conn->get_error_context(), "error");
+}
+
+TEST_F(async_get_result_chunks, should_call_handler_with_result_status_unexpected_for_unexpected_status) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&copy));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::result_status_unexpected}, _)).WillOnce(Return());
+
+    ozo::impl::async_get_result_chunks(m.ctx, chunk_processor{process});
+}
+
+TEST_F(async_get_result_chunks, should_exit_if_query_state_is_error) {
+    m.ctx->state = ozo::impl::query_state::error;
+    ozo::impl::async_get_result_chunks(m.ctx, chunk_processor{process});
+}
+
+} // namespace
@@ -0,0 +1,251 @@
+#include <connection_mock.h>
+#include <test_error.h>
+
+#include <ozo/transaction_batch.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#ifdef LIBPQ_HAS_PIPELINING
+
+namespace {
+
+namespace hana = boost::hana;
+
+using namespace testing;
+using namespace ozo::tests;
+
+using callback_mock = callback_gmock<connection_ptr<>>;
+
+using ozo::error_code;
+using ozo::time_traits;
+
+struct fixture {
+    StrictMock<connection_gmock> connection{};
+    StrictMock<PGconn_mock> native_handle{};
+    StrictMock<callback_mock> callback{};
+    io_context io;
+    execution_context cb_io;
+    connection_ptr<> conn = make_connection(connection, io, native_handle);
+
+    auto make_operation_context() {
+        EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+        return ozo::impl::make_request_operation_context(conn, wrap(callback));
+    }
+
+    decltype(ozo::impl::make_request_operation_context(conn, wrap(callback))) ctx;
+
+    fixture() : ctx(make_operation_context()) {}
+};
+
+const auto two_queries = hana::make_tuple(empty_query {}, empty_query {});
+
+const auto begin = ozo::detail::begin_statement_builder::build(ozo::make_options());
+
+struct async_send_transaction_batch : Test {
+    fixture m;
+};
+
+TEST_F(async_send_transaction_batch, should_enter_pipeline_mode_send_begin_queries_commit_and_sync_and_flush) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQsetnonblocking(1)).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQenterPipelineMode()).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQsendQueryParams(StrEq("BEGIN"), _, _, _, _, _, _)).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQsendQueryParams(StrEq(""), _, _, _, _, _, _)).Times(2).WillRepeatedly(Return(1));
+    EXPECT_CALL(m.native_handle, PQsendQueryParams(StrEq("COMMIT"), _, _, _, _, _, _)).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQpipelineSync()).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQflush()).WillOnce(Return(0));
+
+    ozo::impl::async_send_transaction_batch(m.ctx, begin, two_queries);
+
+    EXPECT_EQ(m.ctx->state, ozo::impl::query_state::send_finish);
+}
+
+TEST_F(async_send_transaction_batch, should_send_begin_with_transaction_options) {
+    const InSequence s;
+    const auto options = ozo::make_options(ozo::transaction_options::mode = ozo::transaction_mode::read_only);
+    const std::vector<ozo::binary_query> queries(1, ozo::to_binary_query(empty_query {}, ozo::empty_oid_map{}));
+
+    EXPECT_CALL(m.native_handle, PQsetnonblocking(1)).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQenterPipelineMode()).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQsendQueryParams(StrEq("BEGIN READ ONLY"), _, _, _, _, _, _)).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQsendQueryParams(StrEq(""), _, _, _, _, _, _)).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQsendQueryParams(StrEq("COMMIT"), _, _, _, _, _, _)).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQpipelineSync()).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQflush()).WillOnce(Return(0));
+
+    ozo::impl::async_send_transaction_batch(m.ctx, ozo::detail::begin_statement_builder::build(options), queries);
+}
+
+TEST_F(async_send_transaction_batch, should_stop_sending_and_call_handler_with_error_if_send_query_params_failed) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQsetnonblocking(1)).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQenterPipelineMode()).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQsendQueryParams(StrEq("BEGIN"), _, _, _, _, _, _)).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQsendQueryParams(StrEq(""), _, _, _, _, _, _)).WillOnce(Return(0));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::pg_send_query_params_failed}, _)).WillOnce(Return());
+
+    ozo::impl::async_send_transaction_batch(m.ctx, begin, two_queries);
+}
+
+TEST_F(async_send_transaction_batch, should_call_handler_with_error_if_pipeline_sync_failed) {
+    const InSequence s;
+
+    EXPECT_CALL(m.native_handle, PQsetnonblocking(1)).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQenterPipelineMode()).WillOnce(Return(1));
+    EXPECT_CALL(m.native_handle, PQsendQueryParams(_, _, _, _, _, _, _)).Times(4).WillRepeatedly(Return(1));
+    EXPECT_CALL(m.native_handle, PQpipelineSync()).WillOnce(Return(0));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::pg_pipeline_sync_failed}, _)).WillOnce(Return());
+
+    ozo::impl::async_send_transaction_batch(m.ctx, begin, two_queries);
+}
+
+struct async_get_transaction_batch_results : Test {
+    fixture m;
+    ozo::tests::pg_result ok {PGRES_COMMAND_OK, nullptr};
+    ozo::tests::pg_result inserted {PGRES_COMMAND_OK, nullptr, "3"};
+    ozo::tests::pg_result selected {PGRES_TUPLES_OK, nullptr, "7"};
+    ozo::tests::pg_result fatal {PGRES_FATAL_ERROR, "42P01", "", "relation does not exist"};
+    ozo::tests::pg_result aborted {PGRES_PIPELINE_ABORTED, nullptr};
+    ozo::tests::pg_result sync {PGRES_PIPELINE_SYNC, nullptr};
+    std::vector<ozo::batch_statement_result> results;
+
+    void expect_result(ozo::tests::pg_result& result) {
+        EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+        EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&result));
+        EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+        EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    }
+
+    void expect_sync() {
+        EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+        EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(&sync));
+    }
+};
+
+TEST_F(async_get_transaction_batch_results, should_write_result_of_each_statement_except_begin_and_commit) {
+    const InSequence s;
+
+    expect_result(ok);
+    expect_result(inserted);
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(1));
+    EXPECT_CALL(m.connection, async_wait_read(_)).WillOnce(InvokeArgument<0>(error_code{}));
+    EXPECT_CALL(m.cb_io.executor_, post(_)).WillOnce(InvokeArgument<0>());
+    EXPECT_CALL(m.native_handle, PQconsumeInput()).WillOnce(Return(1));
+    expect_result(selected);
+    expect_result(ok);
+    expect_sync();
+    EXPECT_CALL(m.native_handle, PQexitPipelineMode()).WillOnce(Return(1));
+    EXPECT_CALL(m.callback, call(error_code{}, _)).WillOnce(Return());
+
+    ozo::impl::async_get_transaction_batch_results(m.ctx, std::back_inserter(results), 2);
+
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_FALSE(results[0].ec);
+    EXPECT_EQ(results[0].rows, 3u);
+    EXPECT_FALSE(results[1].ec);
+    EXPECT_EQ(results[1].rows, 7u);
+}
+
+TEST_F(async_get_transaction_batch_results, should_mark_statements_after_failed_one_as_aborted_and_call_handler_with_error) {
+    const InSequence s;
+
+    expect_result(ok);
+    expect_result(fatal);
+    expect_result(aborted);
+    expect_result(aborted);
+    expect_sync();
+    EXPECT_CALL(m.native_handle, PQexitPipelineMode()).WillOnce(Return(1));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(ozo::sqlstate::make_error_code(ozo::sqlstate::undefined_table), _)).WillOnce(Return());
+
+    ozo::impl::async_get_transaction_batch_results(m.ctx, std::back_inserter(results), 2);
+
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_EQ(results[0].ec, ozo::sqlstate::undefined_table);
+    EXPECT_EQ(results[0].error_message, "relation does not exist");
+    EXPECT_EQ(results[1].ec, ozo::error::pipeline_aborted);
+    EXPECT_EQ(ozo::get_error_context(m.conn), "transaction batch statement #0 failed: relation does not exist");
+}
+
+TEST_F(async_get_transaction_batch_results, should_call_handler_with_error_of_commit) {
+    const InSequence s;
+
+    expect_result(ok);
+    expect_result(inserted);
+    expect_result(fatal);
+    expect_sync();
+    EXPECT_CALL(m.native_handle, PQexitPipelineMode()).WillOnce(Return(1));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(ozo::sqlstate::make_error_code(ozo::sqlstate::undefined_table), _)).WillOnce(Return());
+
+    ozo::impl::async_get_transaction_batch_results(m.ctx, std::back_inserter(results), 1);
+
+    ASSERT_EQ(results.size(), 1u);
+    EXPECT_FALSE(results[0].ec);
+    EXPECT_EQ(ozo::get_error_context(m.conn), "COMMIT failed: relation does not exist");
+}
+
+TEST_F(async_get_transaction_batch_results, should_call_handler_with_error_if_no_sync_received) {
+    const InSequence s;
+
+    expect_result(ok);
+    expect_result(ok);
+    expect_result(ok);
+    EXPECT_CALL(m.native_handle, PQisBusy()).WillOnce(Return(0));
+    EXPECT_CALL(m.native_handle, PQgetResult()).WillOnce(Return(nullptr));
+    EXPECT_CALL(m.connection, cancel()).WillOnce(Return());
+    EXPECT_CALL(m.callback, call(error_code{ozo::error::result_status_unexpected}, _)).WillOnce(Return());
+
+    ozo::impl::async_get_transaction_batch_results(m.ctx, std::back_inserter(results), 1);
+}
+
+TEST_F(async_get_transaction_batch_results, should_exit_if_query_state_is_error) {
+    m.ctx->state = ozo::impl::query_state::error;
+    ozo::impl::async_get_transaction_batch_results(m.ctx, std::back_inserter(results), 2);
+    EXPECT_TRUE(results.empty());
+}
+
+struct rollback_on_error_handler : Test {
+    StrictMock<connection_gmock> connection{};
+    StrictMock<PGconn_mock> native_handle{};
+    StrictMock<callback_mock> callback{};
+    io_context io;
+    connection_ptr<> conn = make_connection(connection, io, native_handle);
+    ozo::impl::rollback_on_error_handler<decltype(wrap(callback)), time_traits::duration> handler {
+        wrap(callback), time_traits::duration{42}
+    };
+};
+
+TEST_F(rollback_on_error_handler, should_call_handler_if_no_error) {
+    EXPECT_CALL(callback, call(error_code{}, _)).WillOnce(Return());
+    handler(error_code{}, conn);
+}
+
+TEST_F(rollback_on_error_handler, should_call_handler_with_error_if_connection_is_not_in_transaction) {
+    EXPECT_CALL(connection, is_bad()).WillOnce(Return(false));
+    EXPECT_CALL(native_handle, PQtransactionStatus()).WillOnce(Return(PQTRANS_IDLE));
+    EXPECT_CALL(callback, call(error_code{ozo::error::pg_flush_failed}, _)).WillOnce(Return());
+    handler(ozo::error::pg_flush_failed, conn);
+}
+
+TEST_F(rollback_on_error_handler, should_call_handler_with_error_if_connection_is_bad) {
+    EXPECT_CALL(connection, is_bad()).WillOnce(Return(true));
+    EXPECT_CALL(callback, call(error_code{ozo::error::pg_flush_failed}, _)).WillOnce(Return());
+    handler(ozo::error::pg_flush_failed, conn);
+}
+
+TEST_F(rollback_on_error_handler, should_rollback_failed_transaction) {
+    EXPECT_CALL(connection, is_bad()).WillOnce(Return(false));
+    EXPECT_CALL(native_handle, PQtransactionStatus()).WillOnce(Return(PQTRANS_INERROR));
+    EXPECT_CALL(connection, async_execute()).WillOnce(Return());
+    handler(ozo::sqlstate::make_error_code(ozo::sqlstate::undefined_table), conn);
+}
+
+} // namespace
+
+#endif
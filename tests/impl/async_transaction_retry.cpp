@@ -0,0 +1,199 @@
+#include "connection_mock.h"
+#include "test_error.h"
+
+#include <ozo/core/options.h>
+#include <ozo/impl/async_transaction_retry.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+using namespace ozo::tests;
+using namespace std::chrono_literals;
+
+using ozo::error_code;
+using ozo::time_traits;
+
+struct provider_gmock {
+    MOCK_METHOD0(async_get_connection, void());
+};
+
+struct provider {
+    using connection_type = connection_ptr<>;
+
+    provider_gmock* mock_ = nullptr;
+    io_context* io_ = nullptr;
+
+    template <typename TimeConstraint, typename Handler>
+    void async_get_connection(TimeConstraint, Handler&&) const {
+        mock_->async_get_connection();
+    }
+
+    auto get_executor() const { return io_->get_executor();}
+};
+
+struct body {
+    template <typename Transaction, typename TimeConstraint, typename Handler>
+    void operator() (Transaction&&, TimeConstraint, Handler&&) const {}
+};
+
+using options_type = decltype(ozo::make_options());
+
+template <typename TimeConstraint>
+using op_type = ozo::impl::async_transaction_retry_op<provider, body, options_type, TimeConstraint,
+    callback_handler<callback_gmock<connection_ptr<>>>>;
+
+struct async_transaction_retry_op : Test {
+    StrictMock<connection_gmock> connection {};
+    StrictMock<PGconn_mock> handle;
+    StrictMock<provider_gmock> provider_mock;
+    StrictMock<callback_gmock<connection_ptr<>>> callback {};
+    StrictMock<steady_timer_mock> timer {};
+    StrictMock<executor_mock> strand {};
+    io_context io;
+    execution_context cb_io;
+    connection_ptr<> conn = make_connection(connection, io, handle);
+    ozo::transaction_retry_policy policy {3, {time_traits::duration::zero(), time_traits::duration::zero()}};
+    const error_code conflict = ozo::sqlstate::make_error_code(ozo::sqlstate::serialization_failure);
+
+    template <typename TimeConstraint = ozo::none_t>
+    auto make_op(TimeConstraint t = TimeConstraint{}, int retries = 0, error_code error = {}) {
+        return op_type<TimeConstraint>{provider{&provider_mock, &io}, body{}, ozo::make_options(), t, policy,
+            wrap(callback), retries, error};
+    }
+
+    async_transaction_retry_op() {
+        EXPECT_CALL(callback, get_executor()).WillRepeatedly(Return(cb_io.get_executor()));
+        EXPECT_CALL(cb_io.executor_, dispatch(_)).WillRepeatedly(InvokeArgument<0>());
+        EXPECT_CALL(io.executor_, dispatch(_)).WillRepeatedly(InvokeArgument<0>());
+        EXPECT_CALL(io.strand_service_, get_executor()).WillRepeatedly(ReturnRef(strand));
+    }
+
+    void expect_connection_healthy() {
+        EXPECT_CALL(connection, is_bad()).WillRepeatedly(Return(false));
+        EXPECT_CALL(handle, PQtransactionStatus()).WillRepeatedly(Return(PQTRANS_IDLE));
+    }
+};
+
+TEST_F(async_transaction_retry_op, should_retry_body_on_same_connection_if_it_is_healthy_after_rollback) {
+    expect_connection_healthy();
+
+    // BEGIN of the retry
+    EXPECT_CALL(connection, async_execute()).WillOnce(Return());
+
+    make_op(ozo::none, 0, conflict).on(op_type<ozo::none_t>::ended{}, error_code{}, conn);
+}
+
+TEST_F(async_transaction_retry_op, should_retry_body_on_new_connection_if_connection_is_bad_after_rollback) {
+    EXPECT_CALL(connection, is_bad()).WillRepeatedly(Return(true));
+
+    EXPECT_CALL(provider_mock, async_get_connection()).WillOnce(Return());
+
+    make_op(ozo::none, 0, conflict).on(op_type<ozo::none_t>::ended{}, error_code{}, conn);
+}
+
+TEST_F(async_transaction_retry_op, should_retry_body_on_new_connection_if_connection_is_in_transaction_after_rollback) {
+    EXPECT_CALL(connection, is_bad()).WillRepeatedly(Return(false));
+    EXPECT_CALL(handle, PQtransactionStatus()).WillRepeatedly(Return(PQTRANS_INERROR));
+
+    EXPECT_CALL(provider_mock, async_get_connection()).WillOnce(Return());
+
+    make_op(ozo::none, 0, conflict).on(op_type<ozo::none_t>::ended{}, error_code{}, conn);
+}
+
+TEST_F(async_transaction_retry_op, should_retry_body_on_new_connection_if_connection_is_null) {
+    EXPECT_CALL(provider_mock, async_get_connection()).WillOnce(Return());
+
+    make_op(ozo::none, 0, conflict).on(op_type<ozo::none_t>::ended{}, error_code{}, connection_ptr<>{});
+}
+
+TEST_F(async_transaction_retry_op, should_rollback_transaction_if_body_fails_on_good_connection) {
+    expect_connection_healthy();
+    auto transaction = ozo::transaction(std::move(conn), ozo::make_options());
+
+    const InSequence s;
+
+    EXPECT_CALL(handle, PQsetnonblocking(1)).WillOnce(Return(0));
+    EXPECT_CALL(handle, PQsendQueryParams(StrEq("ROLLBACK"), _, _, _, _, _, _)).WillOnce(Return(1));
+    EXPECT_CALL(handle, PQflush()).WillOnce(Return(0));
+    EXPECT_CALL(handle, PQisBusy()).WillOnce(Return(1));
+    EXPECT_CALL(connection, async_wait_read(_)).WillOnce(Return());
+
+    make_op().on(op_type<ozo::none_t>::body_done{}, conflict, std::move(transaction));
+}
+
+TEST_F(async_transaction_retry_op, should_not_rollback_transaction_and_retry_on_new_connection_if_body_fails_on_bad_connection) {
+    EXPECT_CALL(connection, is_bad()).WillRepeatedly(Return(true));
+    auto transaction = ozo::transaction(std::move(conn), ozo::make_options());
+
+    EXPECT_CALL(provider_mock, async_get_connection()).WillOnce(Return());
+
+    make_op().on(op_type<ozo::none_t>::body_done{}, conflict, std::move(transaction));
+}
+
+TEST_F(async_transaction_retry_op, should_retry_body_if_commit_fails_with_serialization_conflict) {
+    expect_connection_healthy();
+
+    // BEGIN of the retry
+    EXPECT_CALL(connection, async_execute()).WillOnce(Return());
+
+    make_op().on(op_type<ozo::none_t>::ended{}, conflict, conn);
+}
+
+TEST_F(async_transaction_retry_op, should_retry_body_for_deadlock) {
+    expect_connection_healthy();
+
+    // BEGIN of the retry
+    EXPECT_CALL(connection, async_execute()).WillOnce(Return());
+
+    make_op().on(op_type<ozo::none_t>::ended{}, ozo::sqlstate::make_error_code(ozo::sqlstate::deadlock_detected), conn);
+}
+
+TEST_F(async_transaction_retry_op, should_call_handler_with_error_if_error_is_not_serialization_conflict) {
+    EXPECT_CALL(callback, call(error_code{error::error}, conn)).WillOnce(Return());
+
+    make_op(ozo::none, 0, error::error).on(op_type<ozo::none_t>::ended{}, error_code{}, conn);
+}
+
+TEST_F(async_transaction_retry_op, should_call_handler_with_error_of_body_rather_than_error_of_rollback) {
+    EXPECT_CALL(callback, call(error_code{error::error}, conn)).WillOnce(Return());
+
+    make_op(ozo::none, 0, error::error).on(op_type<ozo::none_t>::ended{}, error_code{error::another_error}, conn);
+}
+
+TEST_F(async_transaction_retry_op, should_call_handler_with_serialization_conflict_if_tries_are_exhausted) {
+    EXPECT_CALL(callback, call(conflict, conn)).WillOnce(Return());
+
+    make_op(ozo::none, policy.tries - 1, conflict).on(op_type<ozo::none_t>::ended{}, error_code{}, conn);
+}
+
+TEST_F(async_transaction_retry_op, should_call_handler_with_serialization_conflict_if_deadline_has_expired) {
+    EXPECT_CALL(callback, call(conflict, conn)).WillOnce(Return());
+
+    const auto deadline = time_traits::now() - 1s;
+    make_op(deadline, 0, conflict).on(op_type<time_traits::time_point>::ended{}, error_code{}, conn);
+}
+
+TEST_F(async_transaction_retry_op, should_call_handler_without_error_if_transaction_is_committed) {
+    EXPECT_CALL(callback, call(error_code{}, conn)).WillOnce(Return());
+
+    make_op().on(op_type<ozo::none_t>::ended{}, error_code{}, conn);
+}
+
+TEST_F(async_transaction_retry_op, should_wait_for_delay_before_retry_no_longer_than_half_of_time_left) {
+    expect_connection_healthy();
+    policy.backoff = {1h, 1h};
+
+    EXPECT_CALL(io.timer_service_, timer(An<time_traits::duration>()))
+        .WillOnce(DoAll(WithArg<0>(Invoke([] (time_traits::duration delay) {
+            EXPECT_LE(delay, 500ms);
+        })), ReturnRef(timer)));
+    EXPECT_CALL(timer, async_wait(_)).WillOnce(Return());
+
+    const auto deadline = time_traits::now() + 1s;
+    make_op(deadline, 0, conflict).on(op_type<time_traits::time_point>::ended{}, error_code{}, conn);
+}
+
+} // namespace
@@ -105,4 +105,25 @@ TEST_F(initiate_async_cancel, should_post_cancel_op_with_time_constraint_into_ca
     initiate_async_cancel_(ozo::tests::wrap(callback), cancel_handle(cancel_handle_, handle_executor), io, ozo::time_traits::time_point{});
 }
 
+TEST_F(initiate_async_cancel, should_accept_io_context_wrapped_into_reference_wrapper) {
+    EXPECT_CALL(io.timer_service_, timer(An<ozo::time_traits::time_point>())).WillOnce(ReturnRef(timer));
+    EXPECT_CALL(io.strand_service_, get_executor()).WillOnce(ReturnRef(strand));
+    EXPECT_CALL(handle_executor, post(_));
+    EXPECT_CALL(timer, async_wait(_));
+    initiate_async_cancel_(ozo::tests::wrap(callback), cancel_handle(cancel_handle_, handle_executor), std::ref(io),
+        ozo::time_traits::time_point{});
+}
+
+#ifdef LIBPQ_HAS_ASYNC_CANCEL
+TEST(initiate_async_cancel_connect, should_post_handler_with_pq_cancel_failed_if_cancel_connection_object_is_not_created) {
+    ozo::io_context io;
+    std::optional<ozo::error_code> result;
+    ozo::impl::initiate_async_cancel_connect{}([&] (ozo::error_code ec, std::string) { result = ec; },
+        ozo::async_cancel_handle{nullptr}, io, ozo::none);
+    EXPECT_FALSE(result);
+    io.run();
+    EXPECT_EQ(result, ozo::error_code{ozo::error::pq_cancel_failed});
+}
+#endif
+
 }
@@ -0,0 +1,162 @@
+#include "test_asio.h"
+
+#include <ozo/impl/async_request.h>
+#include <ozo/ext/std/optional.h>
+#include <ozo/ext/std/vector.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace ozo::tests {
+
+struct custom_type1 {};
+struct custom_type2 {};
+
+struct custom_composite {
+    BOOST_HANA_DEFINE_STRUCT(custom_composite,
+        (custom_type2, member)
+    );
+};
+
+struct custom_row {
+    BOOST_HANA_DEFINE_STRUCT(custom_row,
+        (std::int32_t, id),
+        (custom_type1, value)
+    );
+};
+
+} // namespace ozo::tests
+
+OZO_PG_DEFINE_CUSTOM_TYPE(ozo::tests::custom_type1, "custom_type1")
+OZO_PG_DEFINE_CUSTOM_TYPE(ozo::tests::custom_type2, "custom_type2")
+OZO_PG_DEFINE_CUSTOM_TYPE(ozo::tests::custom_composite, "custom_composite")
+
+namespace {
+
+using namespace testing;
+using namespace ozo::tests;
+
+using oid_map_type = decltype(ozo::register_types<custom_type1, custom_type2, custom_composite>());
+
+TEST(get_pending_types, should_return_custom_types_of_query_parameters) {
+    oid_map_type oid_map;
+    const auto query = ozo::make_query("SELECT $1, $2", custom_type1{}, std::int32_t(42));
+    EXPECT_THAT(ozo::impl::get_pending_types(oid_map, query, ozo::none), ElementsAre("custom_type1"));
+}
+
+TEST(get_pending_types, should_skip_resolved_types) {
+    oid_map_type oid_map;
+    ozo::set_type_oid<custom_type1>(oid_map, 11);
+    const auto query = ozo::make_query("SELECT $1", custom_type1{});
+    EXPECT_THAT(ozo::impl::get_pending_types(oid_map, query, ozo::none), IsEmpty());
+}
+
+TEST(get_pending_types, should_return_type_once_for_several_parameters) {
+    oid_map_type oid_map;
+    const auto query = ozo::make_query("SELECT $1, $2", custom_type1{}, std::optional<custom_type1>{});
+    EXPECT_THAT(ozo::impl::get_pending_types(oid_map, query, ozo::none), ElementsAre("custom_type1"));
+}
+
+TEST(get_pending_types, should_return_array_element_type) {
+    oid_map_type oid_map;
+    const auto query = ozo::make_query("SELECT $1", std::vector<custom_type2>{});
+    EXPECT_THAT(ozo::impl::get_pending_types(oid_map, query, ozo::none), ElementsAre("custom_type2"));
+}
+
+TEST(get_pending_types, should_return_composite_and_its_members_types) {
+    oid_map_type oid_map;
+    const auto query = ozo::make_query("SELECT $1", custom_composite{});
+    EXPECT_THAT(ozo::impl::get_pending_types(oid_map, query, ozo::none),
+        ElementsAre("custom_composite", "custom_type2"));
+}
+
+TEST(get_pending_types, should_return_custom_types_of_prepared_query_parameters) {
+    oid_map_type oid_map;
+    const auto query = ozo::prepared(ozo::make_query("SELECT $1", custom_type2{}));
+    EXPECT_THAT(ozo::impl::get_pending_types(oid_map, query, ozo::none), ElementsAre("custom_type2"));
+}
+
+TEST(get_pending_types, should_return_custom_types_of_output_rows) {
+    oid_map_type oid_map;
+    std::vector<custom_row> rows;
+    const auto out = ozo::impl::make_request_out_handler(std::back_inserter(rows));
+    EXPECT_THAT(ozo::impl::get_pending_types(oid_map, ozo::make_query("SELECT 1"), out),
+        ElementsAre("custom_type1"));
+}
+
+TEST(get_pending_types, should_return_nothing_for_empty_oid_map) {
+    const auto query = ozo::make_query("SELECT $1", std::int32_t(42));
+    EXPECT_THAT(ozo::impl::get_pending_types(ozo::empty_oid_map{}, query, ozo::none), IsEmpty());
+}
+
+TEST(set_type_oids, should_set_oids_of_pending_types_only) {
+    oid_map_type oid_map;
+    ozo::impl::set_type_oids(oid_map, {"custom_type2", "custom_type1"}, {22, 11});
+    EXPECT_EQ(ozo::type_oid<custom_type1>(oid_map), 11u);
+    EXPECT_EQ(ozo::type_oid<custom_type2>(oid_map), 22u);
+    EXPECT_EQ(ozo::type_oid<custom_composite>(oid_map), ozo::null_oid);
+}
+
+TEST(set_type_oids, should_throw_on_pending_types_count_is_not_equal_to_oids_count) {
+    oid_map_type oid_map;
+    EXPECT_THROW(ozo::impl::set_type_oids(oid_map, {"custom_type1"}, {}), std::length_error);
+}
+
+TEST(set_type_oids, should_throw_on_null_oid) {
+    oid_map_type oid_map;
+    EXPECT_THROW(ozo::impl::set_type_oids(oid_map, {"custom_type1"}, {ozo::null_oid}), std::invalid_argument);
+}
+
+struct connection {
+    oid_map_type oid_map_;
+    std::string error_context_;
+    using error_context = std::string;
+
+    const error_context& get_error_context() const noexcept { return error_context_; }
+    void set_error_context(error_context v = error_context{}) { error_context_ = std::move(v); }
+
+    oid_map_type& oid_map() noexcept { return oid_map_; }
+    const oid_map_type& oid_map() const noexcept { return oid_map_; }
+};
+
+} // namespace
+
+namespace ozo {
+template <>
+struct is_connection<::connection> : std::true_type {};
+} // namespace ozo
+
+namespace {
+
+TEST(resolve_pending_types_op, should_set_oids_of_pending_types_and_call_handler) {
+    StrictMock<callback_gmock<connection>> cb_mock {};
+    connection conn;
+    auto operation = ozo::impl::resolve_pending_types_op{conn, {"custom_type1"}, wrap(cb_mock)};
+    operation.ctx_->oids_ = {11};
+
+    EXPECT_CALL(cb_mock, call(ozo::error_code {}, _)).WillOnce(Invoke([] (auto, auto conn) {
+        EXPECT_EQ(ozo::type_oid<custom_type1>(conn.oid_map()), 11u);
+        EXPECT_EQ(ozo::type_oid<custom_type2>(conn.oid_map()), ozo::null_oid);
+    }));
+    operation(ozo::error_code {}, std::move(conn));
+}
+
+TEST(resolve_pending_types_op, should_call_handler_with_oid_request_failed_error_when_oids_count_differs_from_pending_types_count) {
+    StrictMock<callback_gmock<connection>> cb_mock {};
+    connection conn;
+    auto operation = ozo::impl::resolve_pending_types_op{conn, {"custom_type1"}, wrap(cb_mock)};
+
+    EXPECT_CALL(cb_mock, call(ozo::error_code(ozo::error::oid_request_failed), _)).WillOnce(Return());
+    operation(ozo::error_code {}, std::move(conn));
+}
+
+TEST(resolve_pending_types_op, should_call_handler_with_error_of_request) {
+    StrictMock<callback_gmock<connection>> cb_mock {};
+    connection conn;
+    auto operation = ozo::impl::resolve_pending_types_op{conn, {"custom_type1"}, wrap(cb_mock)};
+
+    EXPECT_CALL(cb_mock, call(ozo::error_code(ozo::error::pg_send_query_params_failed), _)).WillOnce(Return());
+    operation(ozo::error::pg_send_query_params_failed, std::move(conn));
+}
+
+} // namespace
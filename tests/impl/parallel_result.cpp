@@ -0,0 +1,88 @@
+#include "result_mock.h"
+
+#include <ozo/impl/parallel_result.h>
+#include <ozo/ext/std.h>
+#include <ozo/pg/types.h>
+
+#include <boost/asio/io_context.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+using namespace ozo::tests;
+
+struct connection_stub {
+    ozo::empty_oid_map oid_map() const { return {}; }
+};
+
+struct continuation_mock {
+    MOCK_METHOD2(call, void(ozo::error_code, std::string));
+};
+
+struct parallel_out_handler : Test {
+    StrictMock<pg_result_mock> mock{};
+    StrictMock<continuation_mock> continuation{};
+    boost::asio::io_context pool;
+    connection_stub conn;
+    std::vector<std::int32_t> rows;
+    const char int32_bytes[4] = { 0x00, 0x00, 0x00, 0x07 };
+
+    auto make_handler(std::size_t partition_size) {
+        return ozo::impl::parallel_out_handler<std::vector<std::int32_t>, boost::asio::io_context::executor_type> {
+            std::ref(rows), pool.get_executor(), partition_size
+        };
+    }
+
+    auto make_continuation() {
+        return [this] (ozo::error_code ec, std::string context) { continuation.call(ec, std::move(context)); };
+    }
+
+    void expect_rows(int count) {
+        EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+        EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(count));
+        EXPECT_CALL(mock, field_format(_)).WillRepeatedly(Return(ozo::impl::result_format::binary));
+        EXPECT_CALL(mock, field_type(0)).WillRepeatedly(Return(23));
+        EXPECT_CALL(mock, get_value(_, 0)).WillRepeatedly(Return(int32_bytes));
+        EXPECT_CALL(mock, get_isnull(_, 0)).WillRepeatedly(Return(false));
+    }
+};
+
+TEST_F(parallel_out_handler, should_receive_result_in_place_if_it_fits_one_partition) {
+    expect_rows(3);
+    EXPECT_CALL(mock, get_length(_, 0)).WillRepeatedly(Return(4));
+    EXPECT_CALL(continuation, call(ozo::error_code{}, "")).WillOnce(Return());
+
+    make_handler(3).async_process(&mock, conn, make_continuation());
+
+    EXPECT_EQ(pool.poll(), 0u);
+    EXPECT_THAT(rows, ElementsAre(7, 7, 7));
+}
+
+TEST_F(parallel_out_handler, should_receive_result_by_partitions_on_executor) {
+    expect_rows(5);
+    EXPECT_CALL(mock, get_length(_, 0)).WillRepeatedly(Return(4));
+
+    rows.push_back(1);
+    make_handler(2).async_process(&mock, conn, make_continuation());
+    EXPECT_THAT(rows, ElementsAre(1, 0, 0, 0, 0, 0));
+
+    EXPECT_CALL(continuation, call(ozo::error_code{}, "")).WillOnce(Return());
+    EXPECT_EQ(pool.poll(), 3u);
+    EXPECT_THAT(rows, ElementsAre(1, 7, 7, 7, 7, 7));
+}
+
+TEST_F(parallel_out_handler, should_call_continuation_with_first_error_once_all_partitions_finished) {
+    expect_rows(4);
+    EXPECT_CALL(mock, get_length(_, 0)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_length(2, 0)).WillRepeatedly(Return(3));
+
+    make_handler(2).async_process(&mock, conn, make_continuation());
+
+    EXPECT_CALL(continuation, call(ozo::error_code{ozo::error::bad_result_process}, HasSubstr("data size 3"))).WillOnce(Return());
+    EXPECT_EQ(pool.poll(), 2u);
+}
+
+} // namespace
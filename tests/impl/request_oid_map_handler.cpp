@@ -30,6 +30,7 @@ template <typename OidMap = empty_oid_map>
 struct connection_wrapper {
     connection_mock& mock_;
     OidMap oid_map_;
+    bool lazy_oid_map_ = false;
 
     using oid_map_type = OidMap;
 
@@ -37,6 +38,10 @@ struct connection_wrapper {
         return oid_map_;
     }
 
+    bool lazy_oid_map() const {
+        return lazy_oid_map_;
+    }
+
     template <typename Handler>
     friend void request_oid_map(connection_wrapper c, Handler&&) {
         c.mock_.request_oid_map();
@@ -76,6 +81,16 @@ TEST_F(request_oid_map_handler, should_not_request_for_oid_when_oid_map_is_not_e
     ozo::impl::apply_oid_map_request<decltype(conn)>(wrap(callback))(error::error, std::move(conn));
 }
 
+TEST_F(request_oid_map_handler, should_not_request_for_oid_when_oids_are_resolved_on_first_use) {
+    auto conn = make_connection(ozo::register_types<custom_type>());
+    conn.lazy_oid_map_ = true;
+    auto callback = make_callback(conn);
+
+    EXPECT_CALL(callback, call(error_code{}, _)).WillOnce(Return());
+
+    ozo::impl::apply_oid_map_request<decltype(conn)>(wrap(callback))(error_code{}, std::move(conn));
+}
+
 TEST_F(request_oid_map_handler, should_not_request_for_oid_when_oid_map_is_empty) {
     auto conn = make_connection(ozo::register_types<>());
     auto callback = make_callback(conn);
@@ -85,4 +100,214 @@ TEST_F(request_oid_map_handler, should_not_request_for_oid_when_oid_map_is_empty
     ozo::impl::apply_oid_map_request<decltype(conn)>(wrap(callback))(error_code{}, std::move(conn));
 }
 
+struct server_connection_mock {
+    MOCK_METHOD0(request_oid_map, ozo::oid_t());
+};
+
+template <typename OidMap>
+struct server_connection_wrapper {
+    server_connection_mock* mock_;
+    OidMap oid_map_;
+    std::string host_ = "localhost";
+
+    using oid_map_type = OidMap;
+
+    OidMap& oid_map() { return oid_map_;}
+    const OidMap& oid_map() const { return oid_map_;}
+
+    friend std::string_view get_host(const server_connection_wrapper& c) { return c.host_;}
+    friend std::string_view get_port(const server_connection_wrapper&) { return "5432";}
+    friend std::string_view get_database(const server_connection_wrapper&) { return "db";}
+
+    template <typename Handler>
+    friend void request_oid_map(server_connection_wrapper c, Handler&& h) {
+        ozo::set_type_oid<custom_type>(c.oid_map_, c.mock_->request_oid_map());
+        h(error_code{}, std::move(c));
+    }
+};
+
+struct request_oid_map_handler_with_cache : Test {
+    StrictMock<server_connection_mock> connection{};
+    using oid_map_type = decltype(ozo::register_types<custom_type>());
+    using connection_type = server_connection_wrapper<oid_map_type>;
+    std::shared_ptr<ozo::detail::oid_map_cache<oid_map_type>> cache =
+        std::make_shared<ozo::detail::oid_map_cache<oid_map_type>>();
+    StrictMock<callback_gmock<connection_type>> callback{};
+
+    connection_type make_connection(std::string host = "localhost") {
+        return connection_type{&connection, oid_map_type{}, std::move(host)};
+    }
+};
+
+TEST_F(request_oid_map_handler_with_cache, should_request_for_oid_and_store_oid_map_into_cache) {
+    EXPECT_CALL(connection, request_oid_map()).WillOnce(Return(42));
+    EXPECT_CALL(callback, call(error_code{}, _)).WillOnce(Invoke([] (auto, auto conn) {
+        EXPECT_EQ(ozo::type_oid<custom_type>(conn.oid_map()), 42u);
+    }));
+
+    ozo::impl::apply_oid_map_request<connection_type>(wrap(callback), cache)(error_code{}, make_connection());
+
+    ASSERT_TRUE(cache->find("localhost:5432/db"));
+    EXPECT_EQ(ozo::type_oid<custom_type>(*cache->find("localhost:5432/db")), 42u);
+}
+
+TEST_F(request_oid_map_handler_with_cache, should_use_cached_oid_map_of_the_same_server_without_request) {
+    oid_map_type cached;
+    ozo::set_type_oid<custom_type>(cached, 42);
+    cache->insert("localhost:5432/db", cached);
+
+    EXPECT_CALL(callback, call(error_code{}, _)).WillOnce(Invoke([] (auto, auto conn) {
+        EXPECT_EQ(ozo::type_oid<custom_type>(conn.oid_map()), 42u);
+    }));
+
+    ozo::impl::apply_oid_map_request<connection_type>(wrap(callback), cache)(error_code{}, make_connection());
+}
+
+TEST_F(request_oid_map_handler_with_cache, should_request_for_oid_for_another_server) {
+    oid_map_type cached;
+    ozo::set_type_oid<custom_type>(cached, 42);
+    cache->insert("localhost:5432/db", cached);
+
+    EXPECT_CALL(connection, request_oid_map()).WillOnce(Return(13));
+    EXPECT_CALL(callback, call(error_code{}, _)).WillOnce(Invoke([] (auto, auto conn) {
+        EXPECT_EQ(ozo::type_oid<custom_type>(conn.oid_map()), 13u);
+    }));
+
+    ozo::impl::apply_oid_map_request<connection_type>(wrap(callback), cache)(error_code{}, make_connection("replica"));
+
+    EXPECT_EQ(cache->size(), 2u);
+}
+
+TEST_F(request_oid_map_handler_with_cache, should_request_for_oid_after_cache_cleared) {
+    oid_map_type cached;
+    ozo::set_type_oid<custom_type>(cached, 42);
+    cache->insert("localhost:5432/db", cached);
+    cache->clear();
+
+    EXPECT_CALL(connection, request_oid_map()).WillOnce(Return(13));
+    EXPECT_CALL(callback, call(error_code{}, _)).WillOnce(Return());
+
+    ozo::impl::apply_oid_map_request<connection_type>(wrap(callback), cache)(error_code{}, make_connection());
+}
+
+TEST_F(request_oid_map_handler_with_cache, should_not_use_cache_when_error_occured) {
+    EXPECT_CALL(callback, call(error_code{error::error}, _)).WillOnce(Return());
+
+    ozo::impl::apply_oid_map_request<connection_type>(wrap(callback), cache)(error::error, make_connection());
+
+    EXPECT_EQ(cache->size(), 0u);
+}
+
+#ifdef LIBPQ_HAS_PIPELINING
+
+struct session_connection_mock {
+    MOCK_METHOD0(request_oid_map, void());
+    MOCK_METHOD1(session_setup, void(bool));
+};
+
+template <typename OidMap = empty_oid_map>
+struct session_connection_wrapper {
+    session_connection_mock* mock_;
+    OidMap oid_map_;
+    std::shared_ptr<const std::vector<std::string>> session_setup_;
+    bool lazy_oid_map_ = false;
+
+    using oid_map_type = OidMap;
+
+    OidMap& oid_map() { return oid_map_;}
+
+    bool lazy_oid_map() const { return lazy_oid_map_;}
+
+    const std::shared_ptr<const std::vector<std::string>>& session_setup() const { return session_setup_;}
+
+    template <typename Handler>
+    friend void request_oid_map(session_connection_wrapper c, Handler&& h) {
+        c.mock_->request_oid_map();
+        h(error_code{}, std::move(c));
+    }
+
+    template <typename Handler>
+    friend void async_session_setup(session_connection_wrapper c, bool request_oids, Handler&& h) {
+        c.mock_->session_setup(request_oids);
+        h(error_code{}, std::move(c));
+    }
+};
+
+struct request_oid_map_handler_with_session_setup : Test {
+    StrictMock<session_connection_mock> connection{};
+    std::shared_ptr<const std::vector<std::string>> statements =
+        std::make_shared<const std::vector<std::string>>(std::vector<std::string>{"SET search_path TO app"});
+
+    template <typename OidMap>
+    auto make_connection(OidMap oid_map, std::shared_ptr<const std::vector<std::string>> setup) {
+        return session_connection_wrapper<OidMap>{&connection, oid_map, std::move(setup)};
+    }
+
+    template <typename Conn>
+    auto make_callback(Conn&&) {
+        return StrictMock<callback_gmock<std::decay_t<Conn>>> {};
+    }
+};
+
+TEST_F(request_oid_map_handler_with_session_setup, should_pipeline_session_setup_with_oid_request) {
+    auto conn = make_connection(ozo::register_types<custom_type>(), statements);
+    auto callback = make_callback(conn);
+
+    EXPECT_CALL(connection, session_setup(true)).WillOnce(Return());
+    EXPECT_CALL(callback, call(error_code{}, _)).WillOnce(Return());
+
+    ozo::impl::apply_oid_map_request<decltype(conn)>(wrap(callback))(error_code{}, std::move(conn));
+}
+
+TEST_F(request_oid_map_handler_with_session_setup, should_execute_session_setup_without_oid_request_when_oid_map_is_empty) {
+    auto conn = make_connection(ozo::register_types<>(), statements);
+    auto callback = make_callback(conn);
+
+    EXPECT_CALL(connection, session_setup(false)).WillOnce(Return());
+    EXPECT_CALL(callback, call(error_code{}, _)).WillOnce(Return());
+
+    ozo::impl::apply_oid_map_request<decltype(conn)>(wrap(callback))(error_code{}, std::move(conn));
+}
+
+TEST_F(request_oid_map_handler_with_session_setup, should_execute_session_setup_without_oid_request_when_oids_are_resolved_on_first_use) {
+    auto conn = make_connection(ozo::register_types<custom_type>(), statements);
+    conn.lazy_oid_map_ = true;
+    auto callback = make_callback(conn);
+
+    EXPECT_CALL(connection, session_setup(false)).WillOnce(Return());
+    EXPECT_CALL(callback, call(error_code{}, _)).WillOnce(Return());
+
+    ozo::impl::apply_oid_map_request<decltype(conn)>(wrap(callback))(error_code{}, std::move(conn));
+}
+
+TEST_F(request_oid_map_handler_with_session_setup, should_request_for_oid_only_when_there_are_no_session_setup_statements) {
+    auto conn = make_connection(ozo::register_types<custom_type>(), nullptr);
+    auto callback = make_callback(conn);
+
+    EXPECT_CALL(connection, request_oid_map()).WillOnce(Return());
+    EXPECT_CALL(callback, call(error_code{}, _)).WillOnce(Return());
+
+    ozo::impl::apply_oid_map_request<decltype(conn)>(wrap(callback))(error_code{}, std::move(conn));
+}
+
+TEST_F(request_oid_map_handler_with_session_setup, should_call_handler_when_there_is_nothing_to_request) {
+    auto conn = make_connection(ozo::register_types<>(), nullptr);
+    auto callback = make_callback(conn);
+
+    EXPECT_CALL(callback, call(error_code{}, _)).WillOnce(Return());
+
+    ozo::impl::apply_oid_map_request<decltype(conn)>(wrap(callback))(error_code{}, std::move(conn));
+}
+
+TEST_F(request_oid_map_handler_with_session_setup, should_not_execute_session_setup_when_error_occured) {
+    auto conn = make_connection(ozo::register_types<custom_type>(), statements);
+    auto callback = make_callback(conn);
+
+    EXPECT_CALL(callback, call(error_code{error::error}, _)).WillOnce(Return());
+
+    ozo::impl::apply_oid_map_request<decltype(conn)>(wrap(callback))(error::error, std::move(conn));
+}
+
+#endif
+
 } // namespace
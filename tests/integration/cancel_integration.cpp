@@ -1,5 +1,6 @@
 #include <ozo/connection_info.h>
 #include <ozo/cancel.h>
+#include <ozo/cancel_executor.h>
 #include <ozo/execute.h>
 #include <ozo/shortcuts.h>
 
@@ -51,6 +52,53 @@ TEST(cancel, should_cancel_operation) {
     io.run();
 }
 
+TEST(cancel, should_cancel_operation_via_cancel_executor) {
+    using namespace ozo::literals;
+    using namespace std::chrono_literals;
+
+    ozo::io_context io;
+    ozo::cancel_executor cancel_executor;
+    boost::asio::steady_timer timer(io);
+
+    boost::asio::spawn(io, [&io, &timer, &cancel_executor](auto yield){
+        const ozo::connection_info conn_info(OZO_PG_TEST_CONNINFO);
+        ozo::error_code ec;
+        auto conn = ozo::get_connection(conn_info[io], yield[ec]);
+        EXPECT_FALSE(ec);
+        boost::asio::spawn(yield, [&io, &timer, handle = get_cancel_handle(conn, cancel_executor.get_executor())](auto yield) mutable {
+            timer.expires_after(1s);
+            ozo::error_code ec;
+            timer.async_wait(yield[ec]);
+            if (!ec) {
+                auto guard = boost::asio::make_work_guard(io);
+                ozo::cancel(std::move(handle), io, 5s, yield[ec]);
+            }
+        });
+        ozo::execute(conn, "SELECT pg_sleep(1000000)"_SQL, yield[ec]);
+        EXPECT_EQ(ec, ozo::sqlstate::query_canceled);
+    });
+
+    io.run();
+}
+
+TEST(get_cancel_handle, should_reuse_native_handle_until_connection_is_closed) {
+    ozo::io_context io;
+
+    boost::asio::spawn(io, [&io](auto yield){
+        const ozo::connection_info conn_info(OZO_PG_TEST_CONNINFO);
+        ozo::error_code ec;
+        auto conn = ozo::get_connection(conn_info[io], yield[ec]);
+        ASSERT_REQUEST_OK(ec, conn);
+        const auto first = get_cancel_handle(conn);
+        ASSERT_NE(first.native_handle(), nullptr);
+        EXPECT_EQ(get_cancel_handle(conn).native_handle(), first.native_handle());
+        conn->close();
+        EXPECT_EQ(get_cancel_handle(conn).native_handle(), nullptr);
+    });
+
+    io.run();
+}
+
 TEST(cancel, should_stop_cancel_operation_on_zero_timeout) {
     using namespace ozo::literals;
     using namespace std::chrono_literals;
@@ -85,4 +133,36 @@ TEST(cancel, should_stop_cancel_operation_on_zero_timeout) {
     io.run();
 }
 
+#ifdef LIBPQ_HAS_ASYNC_CANCEL
+
+TEST(cancel, should_cancel_operation_with_async_cancel_handle) {
+    using namespace ozo::literals;
+    using namespace std::chrono_literals;
+
+    ozo::io_context io;
+    boost::asio::steady_timer timer(io);
+
+    boost::asio::spawn(io, [&io, &timer](auto yield){
+        const ozo::connection_info conn_info(OZO_PG_TEST_CONNINFO);
+        ozo::error_code ec;
+        auto conn = ozo::get_connection(conn_info[io], yield[ec]);
+        EXPECT_FALSE(ec);
+        boost::asio::spawn(yield, [&io, &timer, handle = ozo::get_async_cancel_handle(conn)](auto yield) mutable {
+            timer.expires_after(1s);
+            ozo::error_code ec;
+            timer.async_wait(yield[ec]);
+            if (!ec) {
+                const auto msg = ozo::cancel(std::move(handle), io, 5s, yield[ec]);
+                EXPECT_FALSE(ec) << ec.message() << "|" << msg;
+            }
+        });
+        ozo::execute(conn, "SELECT pg_sleep(1000000)"_SQL, yield[ec]);
+        EXPECT_EQ(ec, ozo::sqlstate::query_canceled);
+    });
+
+    io.run();
+}
+
+#endif
+
 } // namespace
@@ -1,6 +1,7 @@
 #include <ozo/connection_info.h>
 #include <ozo/query_builder.h>
 #include <ozo/execute.h>
+#include <ozo/execute_batch.h>
 
 #include <gtest/gtest.h>
 
@@ -23,4 +24,39 @@ TEST(execute, should_perform_operation_without_result) {
     io.run();
 }
 
+#ifdef LIBPQ_HAS_PIPELINING
+
+TEST(execute_batch, should_execute_independent_statements_and_report_each_result) {
+    using namespace ozo::literals;
+    namespace hana = boost::hana;
+
+    ozo::io_context io;
+    ozo::connection_info conn_info(OZO_PG_TEST_CONNINFO);
+    std::vector<ozo::batch_statement_result> results;
+
+    ozo::execute_batch(conn_info[io],
+        hana::make_tuple(
+            "SELECT * FROM generate_series(1, 3)"_SQL,
+            "SELECT * FROM nonexistent_table"_SQL,
+            "SELECT 1"_SQL
+        ),
+        std::back_inserter(results),
+        [&](ozo::error_code ec, auto conn) {
+            EXPECT_EQ(ec, ozo::sqlstate::undefined_table);
+            EXPECT_FALSE(ozo::connection_bad(conn));
+        });
+
+    io.run();
+
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_FALSE(results[0].ec);
+    EXPECT_EQ(results[0].rows, 3u);
+    EXPECT_EQ(results[1].ec, ozo::sqlstate::undefined_table);
+    EXPECT_FALSE(results[1].error_message.empty());
+    EXPECT_FALSE(results[2].ec);
+    EXPECT_EQ(results[2].rows, 1u);
+}
+
+#endif
+
 } // namespace
@@ -3,6 +3,7 @@
 #include <ozo/query_builder.h>
 #include <ozo/request.h>
 #include <ozo/execute.h>
+#include <ozo/multi_request.h>
 #include <ozo/shortcuts.h>
 #include <ozo/pg/types/jsonb.h>
 #include <ozo/pg/types/ltree.h>
@@ -631,4 +632,27 @@ TEST(request, should_send_and_receive_composite_with_ltree_field) {
     io.run();
 }
 
+TEST(request, multi_request_should_receive_result_of_each_statement) {
+    namespace asio = boost::asio;
+
+    ozo::io_context io;
+    const ozo::connection_info conn_info(OZO_PG_TEST_CONNINFO);
+
+    asio::spawn(io, [&] (asio::yield_context yield) {
+        ozo::error_code ec;
+        ozo::result first;
+        ozo::result second;
+        auto conn = ozo::multi_request(conn_info[io], std::string_view("SELECT 1; SELECT 'a', 'b'; SELECT 3"),
+            boost::hana::make_tuple(std::ref(first), std::ref(second)), yield[ec]);
+
+        ASSERT_REQUEST_OK(ec, conn);
+        ASSERT_EQ(first.size(), 1u);
+        EXPECT_EQ(std::string_view(first[0][0].data(), first[0][0].size()), "1");
+        ASSERT_EQ(second.size(), 1u);
+        EXPECT_EQ(std::string_view(second[0][1].data(), second[0][1].size()), "b");
+    });
+
+    io.run();
+}
+
 } // namespace
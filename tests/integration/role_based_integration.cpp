@@ -3,6 +3,7 @@
 #include <ozo/request.h>
 #include <ozo/shortcuts.h>
 #include <ozo/failover/role_based.h>
+#include <ozo/failover/lag_aware.h>
 
 #include <boost/asio/spawn.hpp>
 #include <boost/range/adaptor/transformed.hpp>
@@ -96,4 +97,51 @@ TEST(role_based, should_return_error_for_invalid_connection_info_of_all_roles) {
     io.run();
 }
 
+TEST(lag_aware, should_measure_no_lag_for_master_and_route_request_to_it) {
+    using namespace ozo::literals;
+
+    ozo::io_context io;
+    auto replicas = failover::make_lag_aware_connection_source({}, ozo::connection_info(OZO_PG_TEST_CONNINFO));
+    replicas.set_lag(0, std::nullopt);
+    replicas.start_monitoring(io);
+
+    std::vector<int> res;
+    ozo::error_code ec;
+    boost::asio::spawn(io, [&] (auto yield) {
+        while (!replicas.is_fresh(0)) {
+            boost::asio::post(io, yield);
+        }
+        ozo::request(replicas[io], "SELECT 1"_SQL, ozo::into(res), yield[ec]);
+        replicas.stop_monitoring();
+    });
+
+    io.run();
+    EXPECT_FALSE(ec);
+    EXPECT_THAT(res, ElementsAre(1));
+}
+
+TEST(lag_aware, should_fall_back_to_master_if_replicas_lag_behind) {
+    using namespace ozo::literals;
+
+    ozo::io_context io;
+    auto replicas = failover::make_lag_aware_connection_source({}, ozo::connection_info(OZO_PG_TEST_CONNINFO));
+    replicas.set_lag(0, std::chrono::hours(1));
+    auto conn_info = failover::make_role_based_connection_source(
+        failover::replica=replicas,
+        failover::master=ozo::connection_info(OZO_PG_TEST_CONNINFO)
+    );
+    StrictMock<callback_mock> callback;
+    auto roles = failover::role_based(failover::replica, failover::master)
+                        .set(op::on_fallback=std::cref(callback));
+
+    InSequence s;
+    EXPECT_CALL(callback, call(ozo::error_code{ozo::error::replication_lag_exceeded}));
+    EXPECT_CALL(callback, call(ozo::error_code{}));
+
+    std::vector<int> res;
+    ozo::request[roles](conn_info[io], "SELECT 1"_SQL, ozo::into(res), std::cref(callback));
+
+    io.run();
+}
+
 } // namespace
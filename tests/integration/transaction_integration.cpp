@@ -1,8 +1,13 @@
 #include <ozo/connection_info.h>
+#include <ozo/cursor.h>
+#include <ozo/execute.h>
 #include <ozo/query_builder.h>
 #include <ozo/result.h>
 #include <ozo/request.h>
+#include <ozo/shortcuts.h>
 #include <ozo/transaction.h>
+#include <ozo/transaction_batch.h>
+#include <ozo/transaction_retry.h>
 
 #include <boost/asio/spawn.hpp>
 
@@ -196,4 +201,241 @@ TEST(transaction_integration, transaction_deferrability_options_should_not_gener
     io.run();
 }
 
+#ifdef LIBPQ_HAS_PIPELINING
+
+TEST(transaction_integration, create_schema_in_transaction_with_deferred_begin_and_rollback_then_table_should_not_exist) {
+    using namespace ozo::literals;
+
+    ozo::io_context io;
+    ozo::connection_info conn_info(OZO_PG_TEST_CONNINFO);
+
+    asio::spawn(io, [&] (asio::yield_context yield) {
+        const auto options = ozo::make_options(ozo::transaction_options::deferred_begin = std::true_type{});
+        ozo::error_code ec;
+        auto transaction = ozo::begin.with_transaction_options(options)(conn_info[io], yield[ec]);
+        ASSERT_FALSE(ec);
+        EXPECT_TRUE(transaction.is_begin_pending());
+        transaction = ozo::execute(std::move(transaction), "CREATE SCHEMA ozo_test_deferred;"_SQL, yield[ec]);
+        ASSERT_FALSE(ec);
+        EXPECT_FALSE(transaction.is_begin_pending());
+        EXPECT_EQ(ozo::get_transaction_status(transaction), ozo::transaction_status::transaction);
+        auto connection = ozo::rollback(std::move(transaction), yield[ec]);
+        ASSERT_FALSE(ec);
+        ozo::result result;
+        ozo::request(connection, "DROP SCHEMA ozo_test_deferred;"_SQL, std::ref(result), yield[ec]);
+        EXPECT_EQ(ec, ozo::error_condition(ozo::sqlstate::invalid_schema_name));
+    });
+
+    io.run();
+}
+
+TEST(transaction_integration, commit_of_transaction_with_deferred_begin_pending_should_not_fail) {
+    ozo::io_context io;
+    ozo::connection_info conn_info(OZO_PG_TEST_CONNINFO);
+
+    asio::spawn(io, [&] (asio::yield_context yield) {
+        const auto options = ozo::make_options(ozo::transaction_options::deferred_begin = std::true_type{});
+        ozo::error_code ec;
+        auto transaction = ozo::begin.with_transaction_options(options)(conn_info[io], yield[ec]);
+        ASSERT_FALSE(ec);
+        auto connection = ozo::commit(std::move(transaction), yield[ec]);
+        EXPECT_FALSE(ec);
+        EXPECT_EQ(ozo::get_transaction_status(connection), ozo::transaction_status::idle);
+    });
+
+    io.run();
+}
+
+TEST(transaction_integration, lazy_read_only_transaction_should_execute_first_request_without_begin) {
+    using namespace ozo::literals;
+
+    ozo::io_context io;
+    ozo::connection_info conn_info(OZO_PG_TEST_CONNINFO);
+
+    asio::spawn(io, [&] (asio::yield_context yield) {
+        const auto options = ozo::make_options(
+            ozo::transaction_options::mode = ozo::transaction_mode::read_only,
+            ozo::transaction_options::lazy_begin = std::true_type{});
+        ozo::error_code ec;
+        auto transaction = ozo::begin.with_transaction_options(options)(conn_info[io], yield[ec]);
+        ASSERT_FALSE(ec);
+        ozo::rows_of<std::int32_t> rows;
+        transaction = ozo::request(std::move(transaction), "SELECT 1"_SQL, ozo::into(rows), yield[ec]);
+        ASSERT_FALSE(ec);
+        EXPECT_EQ(ozo::get_transaction_status(transaction), ozo::transaction_status::idle);
+        transaction = ozo::request(std::move(transaction), "SELECT 2"_SQL, ozo::into(rows), yield[ec]);
+        ASSERT_FALSE(ec);
+        EXPECT_EQ(ozo::get_transaction_status(transaction), ozo::transaction_status::transaction);
+        auto connection = ozo::commit(std::move(transaction), yield[ec]);
+        EXPECT_FALSE(ec);
+        EXPECT_EQ(rows.size(), 2u);
+        EXPECT_EQ(ozo::get_transaction_status(connection), ozo::transaction_status::idle);
+    });
+
+    io.run();
+}
+
+TEST(transaction_integration, transaction_batch_should_commit_all_statements) {
+    using namespace ozo::literals;
+
+    ozo::io_context io;
+    ozo::connection_info conn_info(OZO_PG_TEST_CONNINFO);
+
+    asio::spawn(io, [&] (asio::yield_context yield) {
+        std::vector<ozo::batch_statement_result> results;
+        ozo::error_code ec;
+        auto connection = ozo::transaction_batch(conn_info[io], boost::hana::make_tuple(
+            "CREATE SCHEMA ozo_test_batch;"_SQL,
+            "CREATE TABLE ozo_test_batch.t (v integer);"_SQL,
+            "INSERT INTO ozo_test_batch.t VALUES (1), (2);"_SQL
+        ), std::back_inserter(results), yield[ec]);
+        ASSERT_FALSE(ec) << ec.message() << " | " << ozo::get_error_context(connection);
+        ASSERT_EQ(results.size(), 3u);
+        EXPECT_EQ(results[2].rows, 2u);
+        EXPECT_EQ(ozo::get_transaction_status(connection), ozo::transaction_status::idle);
+        ozo::result result;
+        ozo::request(connection, "DROP SCHEMA ozo_test_batch CASCADE;"_SQL, std::ref(result), yield[ec]);
+        EXPECT_FALSE(ec);
+    });
+
+    io.run();
+}
+
+TEST(transaction_integration, transaction_batch_should_rollback_on_error) {
+    using namespace ozo::literals;
+
+    ozo::io_context io;
+    ozo::connection_info conn_info(OZO_PG_TEST_CONNINFO);
+
+    asio::spawn(io, [&] (asio::yield_context yield) {
+        std::vector<ozo::batch_statement_result> results;
+        ozo::error_code ec;
+        auto connection = ozo::transaction_batch(conn_info[io], boost::hana::make_tuple(
+            "CREATE SCHEMA ozo_test_batch;"_SQL,
+            "SELECT * FROM ozo_test_batch.nonexistent;"_SQL,
+            "SELECT 1;"_SQL
+        ), std::back_inserter(results), yield[ec]);
+        EXPECT_EQ(ec, ozo::error_condition(ozo::sqlstate::undefined_table));
+        ASSERT_EQ(results.size(), 3u);
+        EXPECT_FALSE(results[0].ec);
+        EXPECT_EQ(results[1].ec, ozo::error_condition(ozo::sqlstate::undefined_table));
+        EXPECT_EQ(results[2].ec, ozo::error::pipeline_aborted);
+        EXPECT_EQ(ozo::get_transaction_status(connection), ozo::transaction_status::idle);
+        ozo::result result;
+        ozo::request(connection, "DROP SCHEMA ozo_test_batch;"_SQL, std::ref(result), yield[ec]);
+        EXPECT_EQ(ec, ozo::error_condition(ozo::sqlstate::invalid_schema_name));
+    });
+
+    io.run();
+}
+
+#endif
+
+TEST(transaction_integration, cursor_should_fetch_all_rows_by_pages) {
+    using namespace ozo::literals;
+
+    ozo::io_context io;
+    ozo::connection_info conn_info(OZO_PG_TEST_CONNINFO);
+
+    asio::spawn(io, [&] (asio::yield_context yield) {
+        auto transaction = ozo::begin(conn_info[io], yield);
+        std::vector<std::size_t> pages;
+        ozo::rows_of<std::int32_t> rows;
+        transaction = ozo::cursor(std::move(transaction),
+            "SELECT generate_series(1, "_SQL + std::int32_t(25) + ")"_SQL, 10,
+            [&] (ozo::result page) {
+                pages.push_back(page.size());
+                ozo::recv_result(page, ozo::empty_oid_map{}, std::back_inserter(rows));
+            },
+            yield);
+        EXPECT_THAT(pages, ElementsAre(10u, 10u, 5u));
+        ASSERT_EQ(rows.size(), 25u);
+        EXPECT_EQ(std::get<0>(rows.front()), 1);
+        EXPECT_EQ(std::get<0>(rows.back()), 25);
+        auto connection = ozo::commit(std::move(transaction), yield);
+        EXPECT_EQ(ozo::get_transaction_status(connection), ozo::transaction_status::idle);
+    });
+
+    io.run();
+}
+
+TEST(transaction_integration, retry_transaction_should_rerun_body_on_serialization_failure_on_the_same_connection) {
+    using namespace ozo::literals;
+
+    ozo::io_context io;
+    ozo::connection_info conn_info(OZO_PG_TEST_CONNINFO);
+
+    asio::spawn(io, [&] (asio::yield_context yield) {
+        int runs = 0;
+        std::vector<int> pids;
+        const auto options = ozo::make_options(ozo::transaction_options::isolation_level = ozo::isolation_level::serializable);
+        ozo::error_code ec;
+        auto connection = ozo::retry_transaction.with_transaction_options(options)(conn_info[io],
+            [&] (auto transaction, auto deadline, auto handler) {
+                pids.push_back(PQbackendPID(ozo::get_native_handle(transaction)));
+                if (++runs < 3) {
+                    return ozo::execute(std::move(transaction),
+                        "DO $$ BEGIN RAISE EXCEPTION USING ERRCODE = 'serialization_failure'; END $$"_SQL,
+                        deadline, std::move(handler));
+                }
+                ozo::execute(std::move(transaction), "SELECT 1"_SQL, deadline, std::move(handler));
+            },
+            std::chrono::seconds(10), yield[ec]);
+        EXPECT_FALSE(ec) << ec.message();
+        EXPECT_EQ(runs, 3);
+        ASSERT_EQ(pids.size(), 3u);
+        EXPECT_THAT(pids, Each(Eq(pids.front())));
+        EXPECT_EQ(ozo::get_transaction_status(connection), ozo::transaction_status::idle);
+    });
+
+    io.run();
+}
+
+TEST(transaction_integration, retry_transaction_should_not_rerun_body_on_other_errors) {
+    using namespace ozo::literals;
+
+    ozo::io_context io;
+    ozo::connection_info conn_info(OZO_PG_TEST_CONNINFO);
+
+    asio::spawn(io, [&] (asio::yield_context yield) {
+        int runs = 0;
+        ozo::error_code ec;
+        auto connection = ozo::retry_transaction(conn_info[io],
+            [&] (auto transaction, auto deadline, auto handler) {
+                ++runs;
+                ozo::execute(std::move(transaction), "SELECT 1/0"_SQL, deadline, std::move(handler));
+            },
+            std::chrono::seconds(10), yield[ec]);
+        EXPECT_EQ(ec, ozo::sqlstate::division_by_zero);
+        EXPECT_EQ(runs, 1);
+        EXPECT_EQ(ozo::get_transaction_status(connection), ozo::transaction_status::idle);
+    });
+
+    io.run();
+}
+
+TEST(transaction_integration, retry_transaction_should_complete_with_last_error_when_tries_are_over) {
+    using namespace ozo::literals;
+
+    ozo::io_context io;
+    ozo::connection_info conn_info(OZO_PG_TEST_CONNINFO);
+
+    asio::spawn(io, [&] (asio::yield_context yield) {
+        int runs = 0;
+        ozo::error_code ec;
+        ozo::retry_transaction.with_retry_policy({2})(conn_info[io],
+            [&] (auto transaction, auto deadline, auto handler) {
+                ++runs;
+                ozo::execute(std::move(transaction),
+                    "DO $$ BEGIN RAISE EXCEPTION USING ERRCODE = 'deadlock_detected'; END $$"_SQL,
+                    deadline, std::move(handler));
+            },
+            std::chrono::seconds(10), yield[ec]);
+        EXPECT_EQ(ec, ozo::errc::serialization_conflict);
+        EXPECT_EQ(runs, 2);
+    });
+
+    io.run();
+}
+
 } // namespace
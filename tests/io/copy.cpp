@@ -0,0 +1,133 @@
+#include <ozo/io/copy.h>
+#include <ozo/ext/std/tuple.h>
+#include <ozo/ext/std/optional.h>
+#include <ozo/pg/types/integer.h>
+#include <ozo/pg/types/text.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace ::testing;
+using namespace std::string_literals;
+
+struct send_copy : Test {
+    std::vector<char> buffer;
+    ozo::ostream os{buffer};
+    ozo::empty_oid_map oid_map;
+};
+
+TEST_F(send_copy, send_copy_header_should_store_signature_flags_and_extension_size) {
+    ozo::send_copy_header(os);
+    EXPECT_EQ(buffer, std::vector<char>({
+        'P', 'G', 'C', 'O', 'P', 'Y', '\n', '\377', '\r', '\n', '\0', // signature
+        0x00, 0x00, 0x00, 0x00, // flags
+        0x00, 0x00, 0x00, 0x00, // header extension area length
+    }));
+}
+
+TEST_F(send_copy, send_copy_row_should_store_number_of_fields_and_fields_data_frames) {
+    ozo::send_copy_row(os, oid_map, std::make_tuple("TEST"s, std::int64_t(0x0001020304050607)));
+    EXPECT_EQ(buffer, std::vector<char>({
+        0x00, 0x02,             // Number of fields
+                                // ---- string frame ---
+        0x00, 0x00, 0x00, 0x04, //   size: 4
+        'T' , 'E' , 'S' , 'T' , //   data: "TEST"
+                                // ---- number frame ---
+        0x00, 0x00, 0x00, 0x08, //   size: 8
+        0x00, 0x01, 0x02, 0x03, //   data: 00 01 02 03
+        0x04, 0x05, 0x06, 0x07, //         04 05 06 07
+    }));
+}
+
+TEST_F(send_copy, send_copy_row_should_store_null_field_as_frame_with_null_state_size) {
+    ozo::send_copy_row(os, oid_map, std::make_tuple(std::optional<std::int32_t>{}));
+    EXPECT_EQ(buffer, std::vector<char>({
+        0x00, 0x01,             // Number of fields
+        char(0xFF), char(0xFF), char(0xFF), char(0xFF), // size: -1
+    }));
+}
+
+TEST_F(send_copy, send_copy_trailer_should_store_minus_one_as_number_of_fields) {
+    ozo::send_copy_trailer(os);
+    EXPECT_EQ(buffer, std::vector<char>({char(0xFF), char(0xFF)}));
+}
+
+struct recv_copy : Test {
+    ozo::empty_oid_map oid_map;
+
+    static ozo::istream make_istream(const std::vector<char>& data) {
+        return ozo::istream(data.data(), data.size());
+    }
+};
+
+TEST_F(recv_copy, recv_copy_header_should_verify_signature_and_return_header_size) {
+    const std::vector<char> data({
+        'P', 'G', 'C', 'O', 'P', 'Y', '\n', '\377', '\r', '\n', '\0', // signature
+        0x00, 0x00, 0x00, 0x00, // flags
+        0x00, 0x00, 0x00, 0x02, // header extension area length
+        0x00, 0x00,             // header extension area
+    });
+    auto in = make_istream(data);
+    EXPECT_EQ(ozo::recv_copy_header(in), data.size());
+}
+
+TEST_F(recv_copy, recv_copy_header_should_throw_for_bad_signature) {
+    const std::vector<char> data({
+        'P', 'G', 'C', 'O', 'P', 'Y', '\n', '\377', '\r', '\n', '\1',
+        0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00,
+    });
+    auto in = make_istream(data);
+    EXPECT_THROW(ozo::recv_copy_header(in), ozo::system_error);
+}
+
+TEST_F(recv_copy, recv_copy_header_should_throw_for_truncated_header) {
+    const std::vector<char> data({'P', 'G', 'C', 'O', 'P', 'Y'});
+    auto in = make_istream(data);
+    EXPECT_THROW(ozo::recv_copy_header(in), ozo::system_error);
+}
+
+TEST_F(recv_copy, recv_copy_row_should_receive_fields_into_tuple) {
+    const std::vector<char> data({
+        0x00, 0x00, 0x00, 0x04, 'T' , 'E' , 'S' , 'T' ,
+        0x00, 0x00, 0x00, 0x08, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+    });
+    auto in = make_istream(data);
+    std::tuple<std::string, std::int64_t> out;
+    ozo::recv_copy_row(in, 2, oid_map, out);
+    EXPECT_EQ(out, std::make_tuple("TEST"s, std::int64_t(0x0001020304050607)));
+}
+
+TEST_F(recv_copy, recv_copy_row_should_receive_single_field_into_object) {
+    const std::vector<char> data({0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x07});
+    auto in = make_istream(data);
+    std::int32_t out = 0;
+    ozo::recv_copy_row(in, 1, oid_map, out);
+    EXPECT_EQ(out, 7);
+}
+
+TEST_F(recv_copy, recv_copy_row_should_receive_null_field_into_nullable) {
+    const std::vector<char> data({char(0xFF), char(0xFF), char(0xFF), char(0xFF)});
+    auto in = make_istream(data);
+    std::optional<std::int32_t> out = 7;
+    ozo::recv_copy_row(in, 1, oid_map, out);
+    EXPECT_FALSE(out.has_value());
+}
+
+TEST_F(recv_copy, recv_copy_row_should_throw_if_fields_count_does_not_match_row) {
+    const std::vector<char> data({0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x07});
+    auto in = make_istream(data);
+    std::tuple<std::int32_t, std::int32_t> out;
+    EXPECT_THROW(ozo::recv_copy_row(in, 1, oid_map, out), ozo::system_error);
+}
+
+TEST_F(recv_copy, recv_copy_row_should_throw_for_truncated_tuple) {
+    const std::vector<char> data({0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x07});
+    auto in = make_istream(data);
+    std::int64_t out = 0;
+    EXPECT_THROW(ozo::recv_copy_row(in, 1, oid_map, out), ozo::system_error);
+}
+
+} // namespace
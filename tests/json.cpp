@@ -0,0 +1,148 @@
+#include "test_protocol.h"
+
+#include <ozo/json.h>
+#include <ozo/protocol.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+using namespace ozo::tests;
+
+buffer numeric(std::int16_t weight, std::uint16_t sign, std::int16_t dscale, const std::vector<std::int16_t>& digits) {
+    buffer result;
+    ozo::ostream out(result);
+    ozo::write(out, static_cast<std::int16_t>(digits.size()));
+    ozo::write(out, weight);
+    ozo::write(out, sign);
+    ozo::write(out, dscale);
+    for (auto v : digits) {
+        ozo::write(out, v);
+    }
+    return result;
+}
+
+struct json_writer : Test {
+    std::vector<buffer> messages;
+    ozo::protocol::rows rows;
+    std::string out;
+
+    void describe(const std::vector<column>& columns) {
+        messages.push_back(row_description(columns));
+        rows.describe(parse(messages.back()));
+    }
+
+    void add(const std::vector<std::optional<buffer>>& values) {
+        messages.push_back(data_row(values));
+        rows.add(parse(messages.back()));
+    }
+
+    ozo::basic_result<const ozo::protocol::rows*> result() const {
+        return ozo::basic_result<const ozo::protocol::rows*>(&rows);
+    }
+
+    const std::string& write(ozo::json::row_format format = ozo::json::row_format::object) {
+        ozo::json::write_result(result(), out, format);
+        return out;
+    }
+};
+
+TEST_F(json_writer, should_write_rows_as_objects_keyed_by_column_names) {
+    describe({{"id", 23}, {"name", 25}});
+    add({binary(std::int32_t(1)), text("a")});
+    add({binary(std::int32_t(2)), std::nullopt});
+    EXPECT_EQ(write(), R"([{"id":1,"name":"a"},{"id":2,"name":null}])");
+}
+
+TEST_F(json_writer, should_write_rows_as_arrays) {
+    describe({{"id", 23}, {"name", 25}});
+    add({binary(std::int32_t(1)), text("a")});
+    EXPECT_EQ(write(ozo::json::row_format::array), R"([[1,"a"]])");
+}
+
+TEST_F(json_writer, should_write_empty_array_for_no_rows) {
+    describe({{"id", 23}});
+    EXPECT_EQ(write(), "[]");
+}
+
+TEST_F(json_writer, should_escape_column_names_and_strings) {
+    describe({{"a\"b", 25}});
+    add({text("long text with \"quotes\"\tand\\slash\x01")});
+    EXPECT_EQ(write(), R"([{"a\"b":"long text with \"quotes\"\tand\\slash\u0001"}])");
+}
+
+TEST_F(json_writer, should_write_integers_floats_and_booleans) {
+    describe({{"a", 21}, {"b", 20}, {"c", 26}, {"d", 701}, {"e", 700}, {"f", 16}});
+    add({binary(std::int16_t(-2)), binary(std::int64_t(1) << 40), binary(std::uint32_t(4000000000u)),
+        binary(-2.25), binary(std::numeric_limits<float>::quiet_NaN()), binary(true)});
+    EXPECT_EQ(write(ozo::json::row_format::array), R"([[-2,1099511627776,4000000000,-2.25,"NaN",true]])");
+}
+
+TEST_F(json_writer, should_write_numeric_as_number) {
+    describe({{"a", 1700}, {"b", 1700}, {"c", 1700}, {"d", 1700}});
+    add({numeric(1, 0x4000, 2, {12, 3456, 7800}), numeric(-1, 0, 5, {1200}), numeric(0, 0, 0, {}),
+        numeric(0, 0xC000, 0, {})});
+    EXPECT_EQ(write(ozo::json::row_format::array), R"([[-123456.78,0.12000,0,"NaN"]])");
+}
+
+TEST_F(json_writer, should_write_dates_and_timestamps_in_iso_format) {
+    describe({{"a", 1082}, {"b", 1114}, {"c", 1184}, {"d", 1114}});
+    add({binary(std::int32_t(-1)), binary(std::int64_t(86400) * 1000000 + 3723500000),
+        binary(std::int64_t(-1)), binary(std::numeric_limits<std::int64_t>::max())});
+    EXPECT_EQ(write(ozo::json::row_format::array),
+        R"([["1999-12-31","2000-01-02T01:02:03.5","1999-12-31T23:59:59.999999+00:00","infinity"]])");
+}
+
+TEST_F(json_writer, should_write_uuid_json_and_unknown_types) {
+    describe({{"a", 2950}, {"b", 114}, {"c", 3802}, {"d", 17}});
+    buffer uuid(16);
+    for (std::size_t i = 0; i < uuid.size(); ++i) {
+        uuid[i] = char(i * 17);
+    }
+    buffer jsonb = text("[1]");
+    jsonb.insert(jsonb.begin(), 1);
+    add({uuid, text(R"({"k":1})"), jsonb, buffer{char(1), char(0xFF)}});
+    EXPECT_EQ(write(ozo::json::row_format::array),
+        R"([["00112233-4455-6677-8899-aabbccddeeff",{"k":1},[1],"\\x01ff"]])");
+}
+
+TEST_F(json_writer, should_write_values_in_text_format) {
+    describe({{"a", 23, 0}, {"b", 16, 0}, {"c", 701, 0}, {"d", 1082, 0}});
+    add({text("42"), text("f"), text("NaN"), text("2024-01-02")});
+    EXPECT_EQ(write(ozo::json::row_format::array), R"([[42,false,"NaN","2024-01-02"]])");
+}
+
+TEST_F(json_writer, should_throw_on_fixed_width_value_of_unexpected_size) {
+    describe({{"a", 23}});
+    add({binary(std::int16_t(1))});
+    EXPECT_THROW(write(), ozo::system_error);
+}
+
+TEST_F(json_writer, should_append_chunks_into_single_array) {
+    describe({{"id", 23}});
+    add({binary(std::int32_t(1))});
+    ozo::json::writer writer(out);
+    writer.write(result());
+    writer.write(result());
+    writer.finish();
+    EXPECT_EQ(out, R"([{"id":1},{"id":1}])");
+    EXPECT_EQ(writer.rows(), 2u);
+}
+
+TEST(json_needs_escape, should_detect_control_quote_and_backslash_bytes_only) {
+    const auto word = [] (const char (&v)[9]) {
+        std::uint64_t result;
+        std::memcpy(&result, v, sizeof(result));
+        return result;
+    };
+    EXPECT_FALSE(ozo::json::detail::needs_escape(word("abcdefgh")));
+    EXPECT_FALSE(ozo::json::detail::needs_escape(word(" ~!#\x7f\x80\xff\x20")));
+    EXPECT_TRUE(ozo::json::detail::needs_escape(word("abc\"efgh")));
+    EXPECT_TRUE(ozo::json::detail::needs_escape(word("abcdefg\\")));
+    EXPECT_TRUE(ozo::json::detail::needs_escape(word("\nbcdefgh")));
+    EXPECT_TRUE(ozo::json::detail::needs_escape(word("abcd\x1f" "fgh")));
+}
+
+} // namespace
@@ -0,0 +1,34 @@
+#include <ozo/large_object.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+
+TEST(make_lo_get, should_get_chunk_at_offset) {
+    const auto query = ozo::impl::make_lo_get(ozo::pg::oid(100500), 4096, 1024);
+    EXPECT_EQ(std::string(ozo::to_const_char(ozo::get_text(query))), "SELECT lo_get($1, $2, $3)");
+    EXPECT_EQ(boost::hana::at_c<0>(ozo::get_params(query)), 100500u);
+    EXPECT_EQ(boost::hana::at_c<1>(ozo::get_params(query)), 4096);
+    EXPECT_EQ(boost::hana::at_c<2>(ozo::get_params(query)), 1024);
+}
+
+TEST(make_lo_put, should_put_chunk_at_offset_as_bytea) {
+    const std::string chunk = "chunk";
+    const auto query = ozo::impl::make_lo_put(ozo::pg::oid(100500), 4096, chunk);
+    EXPECT_EQ(std::string(ozo::to_const_char(ozo::get_text(query))), "SELECT lo_put($1, $2, $3)");
+    EXPECT_EQ(boost::hana::at_c<1>(ozo::get_params(query)), 4096);
+    const ozo::pg::bytea_view& data = boost::hana::at_c<2>(ozo::get_params(query));
+    EXPECT_EQ(data.get().data(), chunk.data());
+    EXPECT_EQ(data.get().size(), chunk.size());
+}
+
+TEST(large_object_chunk_size, should_be_clamped_to_int32_range) {
+    EXPECT_EQ(ozo::impl::large_object_chunk_size(0), 1u);
+    EXPECT_EQ(ozo::impl::large_object_chunk_size(std::size_t(1) << 40),
+        std::size_t(std::numeric_limits<std::int32_t>::max()));
+}
+
+} // namespace
@@ -0,0 +1,186 @@
+#include <ozo/light_future.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace {
+
+using namespace testing;
+
+namespace asio = boost::asio;
+
+template <typename ...Args, typename CompletionToken>
+auto async_complete(asio::io_context& io, ozo::error_code ec, CompletionToken&& token, Args ...args) {
+    return asio::async_initiate<CompletionToken, void(ozo::error_code, Args...)>(
+        [&io, ec] (auto handler, auto ...args) {
+            asio::post(io, [handler = std::move(handler), ec, args...] () mutable {
+                handler(ec, args...);
+            });
+        },
+        token, args...);
+}
+
+TEST(light_future, should_return_value_of_operation) {
+    asio::io_context io;
+    auto future = async_complete(io, {}, ozo::use_light_future, 42);
+    EXPECT_FALSE(future.is_ready());
+    io.run();
+    EXPECT_TRUE(future.is_ready());
+    EXPECT_EQ(future.get(), 42);
+    EXPECT_FALSE(future.valid());
+}
+
+TEST(light_future, should_complete_operation_without_value) {
+    asio::io_context io;
+    ozo::light_future<void> future = async_complete(io, {}, ozo::use_light_future);
+    io.run();
+    EXPECT_NO_THROW(future.get());
+}
+
+TEST(light_future, should_return_tuple_for_operation_with_many_values) {
+    asio::io_context io;
+    auto future = async_complete(io, {}, ozo::use_light_future, 1, std::string("one"));
+    io.run();
+    EXPECT_EQ(future.get(), std::make_tuple(1, std::string("one")));
+}
+
+TEST(light_future, get_should_throw_system_error_for_operation_error) {
+    asio::io_context io;
+    auto future = async_complete(io, asio::error::timed_out, ozo::use_light_future, 42);
+    io.run();
+    try {
+        future.get();
+        FAIL() << "exception was not thrown";
+    } catch (const boost::system::system_error& e) {
+        EXPECT_EQ(e.code(), asio::error::timed_out);
+    }
+}
+
+TEST(light_future, get_with_error_code_should_return_value_and_error) {
+    asio::io_context io;
+    auto future = async_complete(io, asio::error::timed_out, ozo::use_light_future, 42);
+    io.run();
+    ozo::error_code ec;
+    EXPECT_EQ(future.get(ec), 42);
+    EXPECT_EQ(ec, asio::error::timed_out);
+}
+
+TEST(light_future, should_complete_with_operation_aborted_when_handler_is_destroyed) {
+    ozo::light_future<int> future;
+    {
+        asio::io_context io;
+        future = async_complete(io, {}, ozo::use_light_future, 42);
+    }
+    ozo::error_code ec;
+    future.get(ec);
+    EXPECT_EQ(ec, asio::error::operation_aborted);
+}
+
+TEST(light_future, get_should_wait_for_operation_completed_on_other_thread) {
+    asio::io_context io;
+    auto future = async_complete(io, {}, ozo::use_light_future, 42);
+    std::thread thread([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        io.run();
+    });
+    EXPECT_EQ(future.get(), 42);
+    thread.join();
+}
+
+TEST(light_future, wait_for_should_return_false_on_timeout) {
+    asio::io_context io;
+    auto future = async_complete(io, {}, ozo::use_light_future, 42);
+    EXPECT_FALSE(future.wait_for(std::chrono::milliseconds(1)));
+    io.run();
+    EXPECT_TRUE(future.wait_for(std::chrono::milliseconds(1)));
+}
+
+TEST(light_future, then_should_call_continuation_on_completion) {
+    asio::io_context io;
+    auto future = async_complete(io, {}, ozo::use_light_future, 42)
+        .then([] (ozo::light_future<int> f) { return std::to_string(f.get()); });
+    EXPECT_FALSE(future.is_ready());
+    io.run();
+    EXPECT_TRUE(future.is_ready());
+    EXPECT_EQ(future.get(), "42");
+}
+
+TEST(light_future, then_should_call_continuation_at_once_for_ready_future) {
+    asio::io_context io;
+    auto future = async_complete(io, {}, ozo::use_light_future, 42);
+    io.run();
+    bool called = false;
+    auto next = future.then([&] (ozo::light_future<int> f) { called = true; return f.get() + 1; });
+    EXPECT_FALSE(future.valid());
+    EXPECT_TRUE(called);
+    EXPECT_EQ(next.get(), 43);
+}
+
+TEST(light_future, then_should_unwrap_future_returned_by_continuation) {
+    asio::io_context io;
+    auto future = async_complete(io, {}, ozo::use_light_future, 42)
+        .then([&] (ozo::light_future<int> f) {
+            return async_complete(io, {}, ozo::use_light_future, f.get() * 2);
+        })
+        .then([] (ozo::light_future<int> f) { return f.get() + 1; });
+    io.run();
+    EXPECT_EQ(future.get(), 85);
+}
+
+struct counted {
+    static inline int live = 0;
+
+    counted() { ++live;}
+    counted(const counted&) { ++live;}
+    counted(counted&&) noexcept { ++live;}
+    counted& operator =(const counted&) = default;
+    counted& operator =(counted&&) noexcept = default;
+    ~counted() { --live;}
+};
+
+TEST(light_future, then_should_free_states_of_unwrapped_futures) {
+    {
+        asio::io_context io;
+        auto future = async_complete(io, {}, ozo::use_light_future, counted{});
+        for (int i = 0; i < 10; ++i) {
+            future = std::move(future).then([&] (ozo::light_future<counted> f) {
+                return async_complete(io, {}, ozo::use_light_future, f.get());
+            });
+        }
+        io.run();
+        future.get();
+    }
+    EXPECT_EQ(counted::live, 0);
+}
+
+TEST(light_future, then_should_propagate_exception_of_continuation) {
+    asio::io_context io;
+    auto future = async_complete(io, asio::error::timed_out, ozo::use_light_future, 42)
+        .then([] (ozo::light_future<int> f) { f.get(); });
+    io.run();
+    EXPECT_THROW(future.get(), boost::system::system_error);
+}
+
+TEST(light_future, then_should_accept_move_only_continuation) {
+    asio::io_context io;
+    auto value = std::make_unique<int>(1);
+    auto future = async_complete(io, {}, ozo::use_light_future, 42)
+        .then([value = std::move(value)] (ozo::light_future<int> f) { return f.get() + *value; });
+    io.run();
+    EXPECT_EQ(future.get(), 43);
+}
+
+TEST(light_future, get_should_throw_future_error_for_invalid_future) {
+    ozo::light_future<int> future;
+    EXPECT_THROW(future.get(), std::future_error);
+}
+
+} // namespace
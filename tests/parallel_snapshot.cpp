@@ -0,0 +1,40 @@
+#include <ozo/parallel_snapshot.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+
+TEST(is_valid_snapshot_id, should_return_true_for_snapshot_id) {
+    EXPECT_TRUE(ozo::impl::is_valid_snapshot_id("00000003-0000001B-1"));
+    EXPECT_TRUE(ozo::impl::is_valid_snapshot_id("0000000a-0000001b-1"));
+}
+
+TEST(is_valid_snapshot_id, should_return_false_for_empty_string) {
+    EXPECT_FALSE(ozo::impl::is_valid_snapshot_id(""));
+}
+
+TEST(is_valid_snapshot_id, should_return_false_for_string_with_quote) {
+    EXPECT_FALSE(ozo::impl::is_valid_snapshot_id("00000003-0000001B-1'; DROP TABLE t; --"));
+}
+
+TEST(is_snapshot_import_level, should_be_true_for_default_options) {
+    EXPECT_TRUE(ozo::detail::is_snapshot_import_level<ozo::detail::parallel_snapshot_default_options>::value);
+}
+
+TEST(is_snapshot_import_level, should_be_true_for_serializable_isolation_level) {
+    using options = decltype(ozo::make_options(
+        ozo::transaction_options::isolation_level = ozo::isolation_level::serializable));
+    EXPECT_TRUE(ozo::detail::is_snapshot_import_level<options>::value);
+}
+
+TEST(is_snapshot_import_level, should_be_false_for_read_committed_or_missing_isolation_level) {
+    using read_committed = decltype(ozo::make_options(
+        ozo::transaction_options::isolation_level = ozo::isolation_level::read_committed));
+    EXPECT_FALSE(ozo::detail::is_snapshot_import_level<read_committed>::value);
+    EXPECT_FALSE(ozo::detail::is_snapshot_import_level<decltype(ozo::make_options())>::value);
+}
+
+} // namespace
@@ -0,0 +1,187 @@
+#include "test_protocol.h"
+
+#include <ozo/protocol.h>
+#include <ozo/query_builder.h>
+#include <ozo/optional.h>
+
+#include <boost/hana/adapt_struct.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace ozo::tests {
+
+struct protocol_row {
+    std::string name;
+    std::int32_t id;
+};
+
+} // namespace ozo::tests
+
+BOOST_HANA_ADAPT_STRUCT(ozo::tests::protocol_row, name, id);
+
+namespace {
+
+namespace hana = boost::hana;
+
+using namespace testing;
+using namespace ozo::literals;
+using namespace std::string_view_literals;
+using namespace ozo::tests;
+
+buffer row_description() {
+    return ozo::tests::row_description({
+        {"id", ozo::type_oid<std::int32_t>(ozo::empty_oid_map{})},
+        {"name", ozo::type_oid<std::string>(ozo::empty_oid_map{})},
+    });
+}
+
+buffer data_row(std::int32_t id, std::optional<std::string_view> name) {
+    return ozo::tests::data_row({binary(id), name ? std::optional(text(*name)) : std::nullopt});
+}
+
+TEST(write_query, should_write_query_message_with_length_and_null_terminated_text) {
+    buffer out;
+    ozo::ostream s(out);
+    ozo::protocol::write_query(s, "SELECT 1");
+    EXPECT_EQ(view(out), "Q\0\0\0\x0dSELECT 1\0"sv);
+}
+
+TEST(write_startup, should_write_version_and_parameters) {
+    buffer out;
+    ozo::ostream s(out);
+    ozo::protocol::write_startup(s, {{"user", "u"}});
+    EXPECT_EQ(view(out), "\0\0\0\x10\0\x03\0\0user\0u\0\0"sv);
+}
+
+TEST(write_execute, should_write_portal_and_row_limit) {
+    buffer out;
+    ozo::ostream s(out);
+    ozo::protocol::write_execute(s, "", 100);
+    ozo::protocol::write_sync(s);
+    EXPECT_EQ(view(out), "E\0\0\0\x09\0\0\0\0\x64S\0\0\0\x04"sv);
+}
+
+TEST(write_parse, should_write_query_text_and_parameters_types) {
+    const auto query = ozo::to_binary_query("SELECT "_SQL + std::int32_t(7), ozo::empty_oid_map{});
+    buffer out;
+    ozo::ostream s(out);
+    ozo::protocol::write_parse(s, "s1", query);
+    EXPECT_EQ(view(out), "P\0\0\0\x17s1\0SELECT $1\0\0\x01\0\0\0\x17"sv);
+}
+
+TEST(write_bind, should_write_binary_parameters_and_binary_result_format) {
+    const auto query = ozo::to_binary_query("SELECT "_SQL + std::int32_t(7) + ", "_SQL + std::optional<std::int32_t>{},
+        ozo::empty_oid_map{});
+    buffer out;
+    ozo::ostream s(out);
+    ozo::protocol::write_bind(s, "", "s1", query);
+    EXPECT_EQ(view(out), "B\0\0\0\x1e\0s1\0\0\x01\0\x01\0\x02\0\0\0\x04\0\0\0\x07\xff\xff\xff\xff\0\x01\0\x01"sv);
+}
+
+TEST(next_message, should_return_nullopt_for_incomplete_message) {
+    const auto msg = message('C', {'S', 'E', 'L', '\0'});
+    for (std::size_t size = 0; size < msg.size(); ++size) {
+        const char* first = msg.data();
+        EXPECT_FALSE(ozo::protocol::next_message(first, msg.data() + size));
+        EXPECT_EQ(first, msg.data());
+    }
+}
+
+TEST(next_message, should_return_messages_in_order_and_advance_input) {
+    auto input = message('1', {});
+    const auto complete = message('C', {'S', 'E', 'L', 'E', 'C', 'T', ' ', '1', '\0'});
+    input.insert(input.end(), complete.begin(), complete.end());
+
+    const char* first = input.data();
+    const auto last = input.data() + input.size();
+    const auto parse_complete = ozo::protocol::next_message(first, last);
+    ASSERT_TRUE(parse_complete);
+    EXPECT_EQ(parse_complete->type, ozo::protocol::backend_message::parse_complete);
+    EXPECT_EQ(parse_complete->size, 0u);
+    const auto command = ozo::protocol::next_message(first, last);
+    ASSERT_TRUE(command);
+    EXPECT_EQ(command->type, ozo::protocol::backend_message::command_complete);
+    EXPECT_EQ(ozo::protocol::parse_command_complete(*command), "SELECT 1");
+    EXPECT_EQ(first, last);
+}
+
+TEST(next_message, should_throw_on_malformed_length) {
+    const buffer input {'Z', 0, 0, 0, 1};
+    const char* first = input.data();
+    EXPECT_THROW(ozo::protocol::next_message(first, input.data() + input.size()), ozo::system_error);
+}
+
+TEST(parse_ready_for_query, should_return_transaction_state) {
+    EXPECT_EQ(ozo::protocol::parse_ready_for_query(parse(message('Z', {'T'}))),
+        ozo::protocol::transaction_state::in_transaction);
+}
+
+TEST(parse_error_field, should_return_field_by_code) {
+    const auto input = message('E', {'S', 'E', 'R', 'R', 'O', 'R', '\0', 'C', '4', '2', 'P', '0', '1', '\0', '\0'});
+    const auto msg = parse(input);
+    EXPECT_EQ(ozo::protocol::parse_error_field(msg, 'C'), "42P01");
+    EXPECT_EQ(ozo::protocol::parse_error_field(msg, 'S'), "ERROR");
+    EXPECT_EQ(ozo::protocol::parse_error_field(msg, 'M'), "");
+}
+
+TEST(rows, describe_should_parse_row_description) {
+    ozo::protocol::rows rows;
+    rows.describe(parse(row_description()));
+    ASSERT_EQ(rows.fields().size(), 2u);
+    EXPECT_EQ(rows.fields()[0].name, "id");
+    EXPECT_EQ(rows.fields()[0].type, ozo::type_oid<std::int32_t>(ozo::empty_oid_map{}));
+    EXPECT_EQ(rows.fields()[1].name, "name");
+    EXPECT_EQ(rows.fields()[1].format, ozo::impl::result_format::binary);
+    EXPECT_EQ(rows.size(), 0u);
+}
+
+TEST(rows, should_be_received_into_tuples_straight_from_data_rows) {
+    const auto description = row_description();
+    const auto first = data_row(1, "a");
+    const auto second = data_row(2, std::nullopt);
+    ozo::protocol::rows rows;
+    rows.describe(parse(description));
+    rows.add(parse(first));
+    rows.add(parse(second));
+
+    std::vector<std::tuple<std::int32_t, std::optional<std::string>>> out;
+    ozo::recv_result(ozo::basic_result<const ozo::protocol::rows*>(&rows), ozo::empty_oid_map{}, std::back_inserter(out));
+
+    ASSERT_EQ(out.size(), 2u);
+    EXPECT_EQ(out[0], std::make_tuple(1, std::optional<std::string>("a")));
+    EXPECT_EQ(out[1], std::make_tuple(2, std::optional<std::string>()));
+}
+
+TEST(rows, should_be_received_into_structures_by_column_names) {
+    const auto description = row_description();
+    const auto row = data_row(42, "name");
+    ozo::protocol::rows rows;
+    rows.describe(parse(description));
+    rows.add(parse(row));
+
+    std::vector<ozo::tests::protocol_row> out;
+    ozo::recv_result(ozo::basic_result<const ozo::protocol::rows*>(&rows), ozo::empty_oid_map{}, std::back_inserter(out));
+
+    ASSERT_EQ(out.size(), 1u);
+    EXPECT_EQ(out[0].id, 42);
+    EXPECT_EQ(out[0].name, "name");
+}
+
+TEST(rows, add_should_throw_on_row_size_mismatch) {
+    ozo::protocol::rows rows;
+    EXPECT_THROW(rows.add(parse(data_row(1, "a"))), ozo::system_error);
+}
+
+TEST(rows, clear_should_keep_description) {
+    const auto description = row_description();
+    const auto row = data_row(1, "a");
+    ozo::protocol::rows rows;
+    rows.describe(parse(description));
+    rows.add(parse(row));
+    rows.clear();
+    EXPECT_EQ(rows.size(), 0u);
+    EXPECT_EQ(rows.fields().size(), 2u);
+}
+
+} // namespace
@@ -76,6 +76,26 @@ TEST(query_builder_params, with_text_and_not_null_pointer_param_elements_returns
     EXPECT_EQ(*params[hana::size_c<0>], std::int32_t(42));
 }
 
+TEST(query_builder_any_of, should_put_values_into_single_array_parameter) {
+    using namespace ozo::literals;
+    using namespace hana::literals;
+    const std::vector<std::int64_t> ids {1, 2, 3};
+    const auto query = "SELECT 1 WHERE id = "_SQL + ozo::any_of(std::cref(ids));
+    EXPECT_EQ(query.text(), "SELECT 1 WHERE id = ANY($1)"_s);
+    const auto params = query.params();
+    EXPECT_EQ(decltype(hana::size(params))::value, 1u);
+    EXPECT_EQ(&params[hana::size_c<0>].get(), &ids);
+}
+
+TEST(query_builder_any_of, should_produce_same_text_for_any_number_of_values) {
+    using namespace ozo::literals;
+    using namespace hana::literals;
+    const auto lhs = "SELECT 1 WHERE id = "_SQL + ozo::any_of(std::vector<std::int64_t> {1}) + " AND x = "_SQL + 1;
+    const auto rhs = "SELECT 1 WHERE id = "_SQL + ozo::any_of(std::vector<std::int64_t> {1, 2, 3}) + " AND x = "_SQL + 1;
+    EXPECT_EQ(lhs.text(), "SELECT 1 WHERE id = ANY($1) AND x = $2"_s);
+    EXPECT_EQ(lhs.text(), rhs.text());
+}
+
 } // namespace
 
 namespace ozo::tests {
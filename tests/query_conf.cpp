@@ -5,6 +5,9 @@
 #include <boost/hana/string.hpp>
 #include <boost/hana/tuple.hpp>
 
+#include <filesystem>
+#include <fstream>
+#include <optional>
 #include <string_view>
 #include <cstring>
 
@@ -157,6 +160,42 @@ struct require_copy_struct_query {
     using parameters_type = require_copy_struct;
 };
 
+struct static_query_without_parameters {
+    static constexpr auto name = "static query without parameters"_s;
+    static constexpr auto text = "  SELECT 1\n"_s;
+    using parameters_type = std::tuple<>;
+};
+
+struct static_query_with_tuple_parameters {
+    static constexpr auto name = "static query with tuple parameters"_s;
+    static constexpr auto text = "SELECT :1::text || :0::integer, x := 1"_s;
+    using parameters_type = std::tuple<std::int32_t, std::string_view>;
+};
+
+struct static_query_with_struct_parameters {
+    static constexpr auto name = "static query with struct parameters"_s;
+    static constexpr auto text = "SELECT :number::text || :string::text"_s;
+    using parameters_type = struct_parameters;
+};
+
+struct static_query_with_unknown_parameter {
+    static constexpr auto name = "static query with unknown parameter"_s;
+    static constexpr auto text = "SELECT :number, :unknown"_s;
+    using parameters_type = struct_parameters;
+};
+
+struct static_query_with_out_of_range_parameter {
+    static constexpr auto name = "static query with out of range parameter"_s;
+    static constexpr auto text = "SELECT :1"_s;
+    using parameters_type = std::tuple<std::int32_t>;
+};
+
+struct static_query_with_invalid_colon {
+    static constexpr auto name = "static query with invalid colon"_s;
+    static constexpr auto text = "SELECT : 1"_s;
+    using parameters_type = std::tuple<>;
+};
+
 } // namespace tests
 } // namespace ozo
 
@@ -348,6 +387,37 @@ TEST(parse_query_conf, should_support_assignment_operator) {
     );
 }
 
+TEST(parse_query_conf, should_keep_crlf_line_ends_in_text) {
+    EXPECT_THAT(
+        ozo::detail::parse_query_conf(
+            "-- name: query with one parameter\r\n"
+            "SELECT\r\n"
+            ":a\r\n"
+        ),
+        ElementsAre(parsed_query {"query with one parameter", {qtp {"SELECT\r\n"}, qpn {"a"}, qtp {"\r\n"}}})
+    );
+}
+
+TEST(parse_query_conf, should_throw_for_colon_not_followed_by_parameter_name) {
+    EXPECT_THROW(
+        ozo::detail::parse_query_conf(
+            "-- name: query with one parameter\n"
+            "SELECT : 1"
+        ),
+        std::invalid_argument
+    );
+}
+
+TEST(parse_query_conf, should_return_text_with_colon_at_the_end_of_double_colon) {
+    EXPECT_THAT(
+        ozo::detail::parse_query_conf(
+            "-- name: query with one parameter\n"
+            "SELECT :a:::b"
+        ),
+        ElementsAre(parsed_query {"query with one parameter", {qtp {"SELECT "}, qpn {"a"}, qtp {"::"}, qpn {"b"}}})
+    );
+}
+
 TEST(check_for_duplicates, should_not_throw_for_empty_queries) {
     EXPECT_NO_THROW(ozo::detail::check_for_duplicates(hana::tuple<>()));
 }
@@ -525,6 +595,15 @@ TEST(make_query_description, should_thow_for_parsed_query_name_not_present_in_qu
     EXPECT_THROW(ozo::detail::make_query_description(queries, parsed), std::invalid_argument);
 }
 
+TEST(make_query_descriptions, should_thow_for_parsed_query_name_not_present_in_queries) {
+    const hana::tuple<query_with_struct_parameters, query_with_one_parameter> queries;
+    const std::vector<parsed_query> parsed({
+        parsed_query {"query with one parameter", {qtp {"SELECT "}, qpn {"0"}}},
+        parsed_query {"foo", {}},
+    });
+    EXPECT_THROW(ozo::detail::make_query_descriptions(queries, parsed), std::invalid_argument);
+}
+
 
 using qtp = query_text_part;
 using qpn = query_parameter_name;
@@ -766,4 +845,222 @@ TEST(query_repository_make_query, should_copy_struct_parameters_passed_by_const_
     repository.make_query<require_copy_struct_query>(parameters);
 }
 
+TEST(has_static_query_text, should_return_true_for_query_with_text) {
+    EXPECT_TRUE(ozo::has_static_query_text<static_query_without_parameters>);
+}
+
+TEST(has_static_query_text, should_return_false_for_query_without_text) {
+    EXPECT_FALSE(ozo::has_static_query_text<query_without_parameters>);
+}
+
+TEST(get_static_query_text, should_return_trimmed_text) {
+    static_assert(get_static_query_text<static_query_without_parameters>() == "SELECT 1");
+    EXPECT_EQ(get_static_query_text<static_query_without_parameters>(), "SELECT 1");
+}
+
+TEST(get_static_query_text, should_replace_numeric_parameters_with_placeholders_and_keep_casts) {
+    EXPECT_EQ(get_static_query_text<static_query_with_tuple_parameters>(), "SELECT $2::text || $1::integer, x := 1");
+}
+
+TEST(get_static_query_text, should_replace_named_parameters_with_placeholders_according_to_name) {
+    EXPECT_EQ(get_static_query_text<static_query_with_struct_parameters>(), "SELECT $2::text || $1::text");
+}
+
+TEST(static_query_text, should_have_unknown_parameter_status_for_undeclared_parameter_name) {
+    EXPECT_EQ(static_query_text<static_query_with_unknown_parameter>::status,
+        static_query_text_status::unknown_parameter);
+}
+
+TEST(static_query_text, should_have_unknown_parameter_status_for_greater_than_maximum_numeric_parameter) {
+    EXPECT_EQ(static_query_text<static_query_with_out_of_range_parameter>::status,
+        static_query_text_status::unknown_parameter);
+}
+
+TEST(static_query_text, should_have_invalid_colon_status_for_colon_not_followed_by_parameter_name) {
+    EXPECT_EQ(static_query_text<static_query_with_invalid_colon>::status,
+        static_query_text_status::invalid_colon);
+}
+
+TEST(check_for_undefined, should_not_throw_for_query_with_static_text_missing_in_definitions) {
+    EXPECT_NO_THROW(check_for_undefined(hana::tuple<static_query_without_parameters>(), {}));
+}
+
+TEST(query_repository_make_query, should_return_query_with_static_text_for_empty_query_conf) {
+    const auto repository = ozo::make_query_repository(
+        std::string_view(),
+        hana::tuple<static_query_with_struct_parameters>()
+    );
+    EXPECT_EQ(
+        repository.make_query<static_query_with_struct_parameters>(struct_parameters {"42", 13}),
+        ozo::make_query("SELECT $2::text || $1::text", std::string_view("42"), 13)
+    );
+}
+
+TEST(query_repository_make_query, should_return_queries_with_static_and_conf_text) {
+    const auto repository = ozo::make_query_repository(
+        "-- name: query with one parameter\n"
+        "SELECT :0::integer",
+        hana::tuple<static_query_with_tuple_parameters, query_with_one_parameter>()
+    );
+    EXPECT_EQ(
+        repository.make_query<static_query_with_tuple_parameters>(42, std::string_view("42")),
+        ozo::make_query("SELECT $2::text || $1::integer, x := 1", 42, std::string_view("42"))
+    );
+    EXPECT_EQ(
+        repository.make_query<query_with_one_parameter>(42),
+        ozo::make_query("SELECT $1::integer", 42)
+    );
+}
+
+TEST(query_repository_make_query, should_throw_for_query_not_defined_in_query_conf) {
+    const ozo::query_repository<query_without_parameters, query_with_one_parameter> repository(
+        make_query_conf({query_description {"query without parameters", "SELECT 1"}})
+    );
+    EXPECT_EQ(repository.make_query<query_without_parameters>(), ozo::make_query("SELECT 1"));
+    EXPECT_THROW(repository.make_query<query_with_one_parameter>(42), std::out_of_range);
+}
+
+TEST(query_repository_make_query, should_throw_for_not_initialized_repository) {
+    const ozo::query_repository<query_without_parameters> repository;
+    EXPECT_THROW(repository.make_query<query_without_parameters>(), std::out_of_range);
+}
+
+TEST(query_repository_make_query, should_return_query_from_copy_of_repository) {
+    std::optional<ozo::query_repository<query_without_parameters>> repository;
+    repository.emplace(ozo::make_query_repository(
+        "-- name: query without parameters\n"
+        "SELECT 1",
+        hana::tuple<query_without_parameters>()
+    ));
+    const auto copy = *repository;
+    repository.reset();
+    EXPECT_EQ(copy.make_query<query_without_parameters>(), ozo::make_query("SELECT 1"));
+}
+
+TEST(query_repository_reload, should_replace_query_text) {
+    auto repository = ozo::make_query_repository(
+        "-- name: query without parameters\n"
+        "SELECT 1",
+        hana::tuple<query_without_parameters>()
+    );
+    repository.reload(std::string_view(
+        "-- name: query without parameters\n"
+        "SELECT 2"
+    ));
+    EXPECT_EQ(repository.make_query<query_without_parameters>(), ozo::make_query("SELECT 2"));
+}
+
+TEST(query_repository_reload, should_replace_query_text_for_copies_of_repository) {
+    auto repository = ozo::make_query_repository(
+        "-- name: query without parameters\n"
+        "SELECT 1",
+        hana::tuple<query_without_parameters>()
+    );
+    const auto copy = repository;
+    repository.reload(std::string_view(
+        "-- name: query without parameters\n"
+        "SELECT 2"
+    ));
+    EXPECT_EQ(copy.make_query<query_without_parameters>(), ozo::make_query("SELECT 2"));
+}
+
+TEST(query_repository_reload, should_keep_text_of_query_made_before_reload) {
+    auto repository = ozo::make_query_repository(
+        "-- name: query without parameters\n"
+        "SELECT 1",
+        hana::tuple<query_without_parameters>()
+    );
+    const auto query = repository.make_query<query_without_parameters>();
+    repository.reload(std::string_view(
+        "-- name: query without parameters\n"
+        "SELECT 2"
+    ));
+    EXPECT_EQ(query, ozo::make_query("SELECT 1"));
+}
+
+TEST(query_repository_reload, should_initialize_default_constructed_repository) {
+    ozo::query_repository<query_without_parameters> repository;
+    repository.reload(make_query_conf({query_description {"query without parameters", "SELECT 1"}}));
+    EXPECT_TRUE(repository.is_initialized());
+    EXPECT_EQ(repository.make_query<query_without_parameters>(), ozo::make_query("SELECT 1"));
+}
+
+TEST(query_repository_reload, should_throw_and_keep_query_conf_for_undefined_query) {
+    auto repository = ozo::make_query_repository(
+        "-- name: query without parameters\n"
+        "SELECT 1",
+        hana::tuple<query_without_parameters>()
+    );
+    EXPECT_THROW(repository.reload(std::string_view("-- name: other query\nSELECT 2")), std::exception);
+    EXPECT_EQ(repository.make_query<query_without_parameters>(), ozo::make_query("SELECT 1"));
+}
+
+TEST(query_repository_reload, should_throw_on_make_query_after_reload_with_query_removed) {
+    ozo::query_repository<query_without_parameters, query_with_one_parameter> repository(make_query_conf({
+        query_description {"query without parameters", "SELECT 1"},
+        query_description {"query with one parameter", "SELECT $1::integer"},
+    }));
+    repository.reload(make_query_conf({query_description {"query without parameters", "SELECT 1"}}));
+    EXPECT_THROW(repository.make_query<query_with_one_parameter>(42), std::out_of_range);
+}
+
+struct query_conf_file {
+    std::filesystem::path path;
+
+    query_conf_file(std::string_view name, std::string_view content)
+            : path(std::filesystem::temp_directory_path() / name) {
+        std::ofstream(path, std::ios::binary) << content;
+    }
+
+    ~query_conf_file() {
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+};
+
+TEST(make_query_repository, should_return_query_repository_for_query_conf_file) {
+    const query_conf_file file("ozo_query_conf_test.sql",
+        "-- name: query with one parameter\n"
+        "SELECT :0::integer");
+    const auto repository = ozo::make_query_repository(file.path, hana::tuple<query_with_one_parameter>());
+    EXPECT_EQ(repository.make_query<query_with_one_parameter>(42), ozo::make_query("SELECT $1::integer", 42));
+}
+
+TEST(make_query_repository, should_return_query_repository_for_empty_query_conf_file) {
+    const query_conf_file file("ozo_empty_query_conf_test.sql", "");
+    EXPECT_TRUE(ozo::make_query_repository(file.path).is_initialized());
+}
+
+TEST(make_query_repository, should_throw_for_missing_query_conf_file) {
+    EXPECT_THROW(ozo::make_query_repository(std::filesystem::path("/nonexistent/ozo_query_conf.sql")), std::exception);
+}
+
+TEST(query_repository_reload, should_replace_query_text_by_query_conf_file) {
+    auto repository = ozo::make_query_repository(
+        "-- name: query without parameters\n"
+        "SELECT 1",
+        hana::tuple<query_without_parameters>()
+    );
+    const query_conf_file file("ozo_reload_query_conf_test.sql",
+        "-- name: query without parameters\n"
+        "SELECT 2");
+    repository.reload(file.path);
+    EXPECT_EQ(repository.make_query<query_without_parameters>(), ozo::make_query("SELECT 2"));
+}
+
+TEST(query_repository_make_prepared_query, should_return_prepared_query_with_statement_key_of_query_name) {
+    const auto repository = ozo::make_query_repository(
+        "-- name: query with one parameter\n"
+        "SELECT :0::integer\n"
+        "-- name: query without parameters\n"
+        "SELECT 1",
+        hana::tuple<query_with_one_parameter, query_without_parameters>()
+    );
+    const auto query = repository.make_prepared_query<query_with_one_parameter>(42);
+    EXPECT_EQ(query.query, ozo::make_query("SELECT $1::integer", 42));
+    ASSERT_NE(query.statement, nullptr);
+    EXPECT_EQ(query.statement, repository.make_prepared_query<query_with_one_parameter>(7).statement);
+    EXPECT_NE(query.statement, repository.make_prepared_query<query_without_parameters>().statement);
+}
+
 } // namespace
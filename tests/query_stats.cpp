@@ -0,0 +1,121 @@
+#include <ozo/query_stats.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <boost/asio/use_future.hpp>
+
+#include <thread>
+
+namespace {
+
+using namespace testing;
+using namespace std::chrono_literals;
+using namespace boost::hana::literals;
+
+using ozo::error_code;
+
+struct get_user {
+    static constexpr auto name = "get user"_s;
+    using parameters_type = std::tuple<>;
+};
+
+struct update_user {
+    static constexpr auto name = "update user"_s;
+    using parameters_type = std::tuple<>;
+};
+
+using query_stats = ozo::query_stats<get_user, update_user>;
+
+TEST(query_stats, snapshot_should_return_zero_statistics_of_each_query_by_default) {
+    const query_stats stats(2);
+    const auto snapshot = stats.snapshot();
+    ASSERT_EQ(snapshot.size(), 2u);
+    EXPECT_EQ(snapshot[0].name, "get user");
+    EXPECT_EQ(snapshot[1].name, "update user");
+    EXPECT_EQ(snapshot[0].requests, 0u);
+    EXPECT_EQ(snapshot[1].latency.count(), 0u);
+}
+
+TEST(query_stats, update_should_account_request_of_query) {
+    query_stats stats(2);
+    stats.update<get_user>(3us, false);
+    stats.update<get_user>(1ms, true);
+    const auto v = stats.get<get_user>();
+    EXPECT_EQ(v.name, "get user");
+    EXPECT_EQ(v.requests, 2u);
+    EXPECT_EQ(v.errors, 1u);
+    EXPECT_EQ(v.latency.buckets[ozo::latency_histogram::bucket(3us)], 1u);
+    EXPECT_EQ(v.latency.buckets[ozo::latency_histogram::bucket(1ms)], 1u);
+    EXPECT_EQ(stats.get<update_user>().requests, 0u);
+}
+
+TEST(query_stats, snapshot_should_sum_up_requests_of_all_threads) {
+    query_stats stats(2);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 3; ++i) {
+        threads.emplace_back([&] {
+            for (int j = 0; j < 100; ++j) {
+                stats.update<update_user>(1us, false);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(stats.snapshot()[1].requests, 300u);
+    EXPECT_EQ(stats.snapshot()[1].latency.count(), 300u);
+}
+
+TEST(query_stats, update_should_sum_up_cpu_time_of_query) {
+    query_stats stats(2);
+    stats.update<get_user>(ozo::request_cpu_time{3us, 5us, false});
+    stats.update<get_user>(ozo::request_cpu_time{1us, 2us, true});
+    const auto v = stats.get<get_user>();
+    EXPECT_EQ(v.serialization_cpu, 4us);
+    EXPECT_EQ(v.decoding_cpu, 7us);
+    EXPECT_EQ(v.requests, 0u);
+    EXPECT_EQ(stats.get<update_user>().decoding_cpu, ozo::time_traits::duration::zero());
+}
+
+TEST(bind_query_stats, should_account_completed_request_and_call_handler) {
+    query_stats stats(1);
+    bool called = false;
+    auto token = ozo::bind_query_stats<update_user>(stats, [&] (error_code ec, int v) {
+        EXPECT_EQ(ec, boost::asio::error::timed_out);
+        EXPECT_EQ(v, 42);
+        called = true;
+    });
+    ozo::async_initiate<decltype(token), void(error_code, int)>(
+        [&] (auto handler) { handler(error_code{boost::asio::error::timed_out}, 42); }, token);
+    EXPECT_TRUE(called);
+    EXPECT_EQ(stats.get<update_user>().requests, 1u);
+    EXPECT_EQ(stats.get<update_user>().errors, 1u);
+    EXPECT_EQ(stats.get<get_user>().requests, 0u);
+}
+
+TEST(bind_query_stats, should_return_result_of_underlying_completion_token) {
+    query_stats stats(1);
+    auto token = ozo::bind_query_stats<get_user>(stats, boost::asio::use_future);
+    auto future = ozo::async_initiate<decltype(token), void(error_code, int)>(
+        [&] (auto handler) { handler(error_code{}, 42); }, token);
+    EXPECT_EQ(future.get(), 42);
+    EXPECT_EQ(stats.get<get_user>().requests, 1u);
+    EXPECT_EQ(stats.get<get_user>().errors, 0u);
+}
+
+TEST(bind_query_stats, handler_should_supply_cpu_time_observer_of_query) {
+    query_stats stats(1);
+    auto token = ozo::bind_query_stats<update_user>(stats, [] (error_code, int) {});
+    ozo::async_initiate<decltype(token), void(error_code, int)>(
+        [&] (auto handler) {
+            const auto observer = ozo::detail::get_request_cpu_time_observer(handler);
+            ASSERT_TRUE(observer);
+            observer.update(observer.target, ozo::request_cpu_time{1us, 2us, false});
+            handler(error_code{}, 42);
+        }, token);
+    EXPECT_EQ(stats.get<update_user>().serialization_cpu, 1us);
+    EXPECT_EQ(stats.get<update_user>().decoding_cpu, 2us);
+}
+
+} // namespace
@@ -181,6 +181,10 @@ TEST_F(row, at_from_name_should_throw_std_out_of_range_if_column_name_not_found)
     EXPECT_THROW(r.at("FOO").data(), std::out_of_range);
 }
 
+TEST_F(row, iterators_difference_should_be_equal_to_columns_distance) {
+    EXPECT_EQ((r.begin() + 3) - r.begin(), 3);
+}
+
 struct basic_result : Test {
     StrictMock<pg_result_mock> mock{};
     ozo::basic_result<pg_result_mock*> result{&mock};
@@ -224,6 +228,10 @@ TEST_F(basic_result, begin_should_return_iterator_on_start_column) {
     result.begin()->begin()->data();
 }
 
+TEST_F(basic_result, iterators_difference_should_be_equal_to_rows_distance) {
+    EXPECT_EQ((result.begin() + 3) - result.begin(), 3);
+}
+
 TEST_F(basic_result, operator_sqbr_should_return_value_proxy_with_row_equal_to_argument) {
     EXPECT_CALL(mock, get_value(42, _)).WillOnce(Return(nullptr));
     result[42][0].data();
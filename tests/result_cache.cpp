@@ -0,0 +1,95 @@
+#include <ozo/result_cache.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+ozo::shared_result make_result() {
+    return ozo::shared_result(ozo::pg::shared_result(PQmakeEmptyPGresult(nullptr, PGRES_TUPLES_OK), PQclear));
+}
+
+ozo::result_cache_config make_config(std::size_t max_bytes, ozo::time_traits::duration ttl = 1min) {
+    ozo::result_cache_config config;
+    config.max_bytes = max_bytes;
+    config.ttl = ttl;
+    return config;
+}
+
+const auto now = ozo::time_traits::time_point{} + 1h;
+
+TEST(result_cache_state, should_return_inserted_result_until_it_expires) {
+    ozo::detail::result_cache_state cache(make_config(1 << 20, 10s));
+    const auto result = make_result();
+    cache.insert("key", "", result, now);
+
+    const auto found = cache.find("key", now + 9s);
+    ASSERT_TRUE(found);
+    EXPECT_EQ(found->native_handle(), result.native_handle());
+    EXPECT_FALSE(cache.find("key", now + 10s));
+
+    const auto metrics = cache.metrics();
+    EXPECT_EQ(metrics.hits, 1u);
+    EXPECT_EQ(metrics.misses, 1u);
+    EXPECT_EQ(metrics.entries, 0u);
+    EXPECT_EQ(metrics.bytes, 0u);
+}
+
+TEST(result_cache_state, should_evict_least_recently_used_results_to_fit_memory_limit) {
+    const auto entry_size = 3 + PQresultMemorySize(make_result().native_handle());
+    ozo::detail::result_cache_state cache(make_config(2 * entry_size));
+    cache.insert("one", "", make_result(), now);
+    cache.insert("two", "", make_result(), now);
+    EXPECT_TRUE(cache.find("one", now));
+
+    cache.insert("six", "", make_result(), now);
+
+    EXPECT_TRUE(cache.find("one", now));
+    EXPECT_FALSE(cache.find("two", now));
+    EXPECT_TRUE(cache.find("six", now));
+    EXPECT_EQ(cache.metrics().evictions, 1u);
+    EXPECT_EQ(cache.metrics().bytes, 2 * entry_size);
+}
+
+TEST(result_cache_state, should_not_cache_result_larger_than_memory_limit) {
+    ozo::detail::result_cache_state cache(make_config(1));
+    cache.insert("key", "", make_result(), now);
+    EXPECT_FALSE(cache.find("key", now));
+    EXPECT_EQ(cache.metrics().entries, 0u);
+}
+
+TEST(result_cache_state, should_replace_result_of_the_same_key) {
+    ozo::detail::result_cache_state cache(make_config(1 << 20));
+    cache.insert("key", "", make_result(), now);
+    const auto result = make_result();
+    cache.insert("key", "", result, now);
+    EXPECT_EQ(cache.find("key", now)->native_handle(), result.native_handle());
+    EXPECT_EQ(cache.metrics().entries, 1u);
+}
+
+TEST(result_cache_state, should_invalidate_results_of_tag_only) {
+    ozo::detail::result_cache_state cache(make_config(1 << 20));
+    cache.insert("one", "users", make_result(), now);
+    cache.insert("two", "countries", make_result(), now);
+    cache.insert("six", "users", make_result(), now);
+
+    cache.invalidate("users");
+
+    EXPECT_FALSE(cache.find("one", now));
+    EXPECT_TRUE(cache.find("two", now));
+    EXPECT_FALSE(cache.find("six", now));
+    EXPECT_EQ(cache.metrics().entries, 1u);
+}
+
+TEST(result_cache_state, should_remove_all_results_on_clear) {
+    ozo::detail::result_cache_state cache(make_config(1 << 20));
+    cache.insert("one", "", make_result(), now);
+    cache.clear();
+    EXPECT_FALSE(cache.find("one", now));
+    EXPECT_EQ(cache.metrics().bytes, 0u);
+}
+
+} // namespace
@@ -15,6 +15,7 @@ struct pg_result_mock {
     MOCK_CONST_METHOD2(get_value, const char*(int row, int column));
     MOCK_CONST_METHOD2(get_length, std::size_t(int row, int column));
     MOCK_CONST_METHOD2(get_isnull, bool(int row, int column));
+    MOCK_CONST_METHOD1(field_name, const char*(int column));
     MOCK_CONST_METHOD1(field_number, int(const char* name));
     MOCK_CONST_METHOD0(nfields, int());
     MOCK_CONST_METHOD0(ntuples, int());
@@ -39,6 +40,10 @@ struct pg_result_mock {
         return m.get_isnull(row, column);
     }
 
+    friend const char* pq_field_name(const pg_result_mock& m, int column) {
+        return m.field_name(column);
+    }
+
     friend int pq_field_number(const pg_result_mock& m, const char* name) {
         return m.field_number(name);
     }
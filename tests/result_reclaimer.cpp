@@ -0,0 +1,75 @@
+#include <ozo/result_reclaimer.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <chrono>
+#include <optional>
+#include <thread>
+
+namespace {
+
+using namespace testing;
+
+ozo::pg::result make_result() {
+    return ozo::pg::result(PQmakeEmptyPGresult(nullptr, PGRES_TUPLES_OK));
+}
+
+template <typename Predicate>
+bool wait_for(Predicate predicate) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!predicate()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+TEST(result_reclaimer, should_free_large_result_on_its_thread) {
+    ozo::result_reclaimer reclaimer({0, 16});
+    auto res = make_result();
+    const auto size = PQresultMemorySize(res.get());
+    res.reset();
+    EXPECT_TRUE(wait_for([&] { return reclaimer.metrics().reclaimed == 1;}));
+    EXPECT_EQ(reclaimer.metrics().reclaimed_bytes, size);
+    EXPECT_EQ(reclaimer.metrics().queued, 0u);
+}
+
+TEST(result_reclaimer, should_free_shared_result_on_its_thread) {
+    ozo::result_reclaimer reclaimer({0, 16});
+    ozo::pg::shared_result res = boost::hana::to<ozo::pg::shared_result>(make_result());
+    res.reset();
+    EXPECT_TRUE(wait_for([&] { return reclaimer.metrics().reclaimed == 1;}));
+}
+
+TEST(result_reclaimer, should_free_small_result_in_place) {
+    ozo::result_reclaimer reclaimer({std::size_t(1) << 30, 16});
+    make_result().reset();
+    EXPECT_EQ(reclaimer.metrics().queued, 0u);
+    EXPECT_EQ(reclaimer.metrics().reclaimed, 0u);
+}
+
+TEST(result_reclaimer, should_free_result_in_place_if_queue_is_full) {
+    ozo::result_reclaimer reclaimer({0, 0});
+    make_result().reset();
+    EXPECT_EQ(reclaimer.metrics().overflows, 1u);
+    EXPECT_EQ(reclaimer.metrics().reclaimed, 0u);
+}
+
+TEST(result_reclaimer, should_free_queued_results_on_destruction) {
+    std::optional<ozo::result_reclaimer> reclaimer(std::in_place, ozo::result_reclaimer_config{0, 1024});
+    for (int i = 0; i < 100; ++i) {
+        make_result().reset();
+    }
+    reclaimer.reset();
+    EXPECT_EQ(ozo::pg::detail::result_release().load(), nullptr);
+}
+
+TEST(result_reclaimer, should_throw_if_another_reclaimer_is_installed) {
+    ozo::result_reclaimer reclaimer;
+    EXPECT_THROW(ozo::result_reclaimer{}, std::logic_error);
+}
+
+} // namespace
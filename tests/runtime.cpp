@@ -0,0 +1,61 @@
+#include <ozo/runtime.h>
+
+#include <boost/asio/post.hpp>
+
+#include <future>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+
+ozo::runtime_config make_config(std::size_t threads) {
+    ozo::runtime_config config;
+    config.threads = threads;
+    config.pool.capacity = 4;
+    return config;
+}
+
+TEST(runtime, should_create_io_context_and_pool_shard_per_thread) {
+    ozo::runtime runtime(ozo::connection_info(""), make_config(2));
+    EXPECT_EQ(runtime.size(), 2u);
+    EXPECT_NE(std::addressof(runtime.context(0)), std::addressof(runtime.context(1)));
+    EXPECT_EQ(runtime.pool().shards(), 2u);
+}
+
+TEST(runtime, should_create_thread_per_hardware_thread_by_default) {
+    ozo::runtime_config config;
+    config.pool.capacity = 1024;
+    ozo::runtime runtime(ozo::connection_info(""), config);
+    EXPECT_EQ(runtime.size(), std::max<std::size_t>(std::thread::hardware_concurrency(), 1));
+}
+
+TEST(runtime, current_should_return_io_context_of_calling_io_thread) {
+    ozo::runtime runtime(ozo::connection_info(""), make_config(2));
+    for (std::size_t i = 0; i < runtime.size(); ++i) {
+        std::promise<ozo::io_context*> current;
+        boost::asio::post(runtime.context(i), [&] { current.set_value(std::addressof(runtime.current())); });
+        EXPECT_EQ(current.get_future().get(), std::addressof(runtime.context(i)));
+    }
+}
+
+TEST(runtime, current_should_spread_other_threads_between_io_contexts) {
+    ozo::runtime runtime(ozo::connection_info(""), make_config(2));
+    const auto first = std::addressof(runtime.current());
+    const auto second = std::addressof(runtime.current());
+    EXPECT_NE(first, second);
+    EXPECT_EQ(std::addressof(runtime.current()), first);
+}
+
+TEST(runtime, should_pin_threads_when_requested) {
+    auto config = make_config(2);
+    config.pin_threads = true;
+    ozo::runtime runtime(ozo::connection_info(""), config);
+    std::promise<void> done;
+    boost::asio::post(runtime.context(1), [&] { done.set_value(); });
+    EXPECT_EQ(done.get_future().wait_for(std::chrono::seconds(10)), std::future_status::ready);
+}
+
+} // namespace
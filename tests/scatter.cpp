@@ -0,0 +1,121 @@
+#include <connection_mock.h>
+
+#include <ozo/scatter.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <optional>
+
+namespace {
+
+using namespace testing;
+using namespace ozo::tests;
+
+using ozo::error_code;
+
+using rows_type = std::vector<int>;
+
+struct scatter_result {
+    std::optional<error_code> ec;
+    std::vector<error_code> statuses;
+
+    auto handler() {
+        return [this] (error_code e, std::vector<error_code> s) {
+            ec = e;
+            statuses = std::move(s);
+        };
+    }
+};
+
+template <typename Out>
+auto make_state(Out out, std::size_t shards, scatter_result& result) {
+    using state_type = ozo::impl::scatter_state<Out, decltype(result.handler())>;
+    return std::make_shared<state_type>(std::move(out), shards, result.handler());
+}
+
+TEST(scatter_state, should_complete_once_all_shards_completed_and_gather_rows_in_shards_order) {
+    rows_type rows;
+    scatter_result result;
+    auto state = make_state(ozo::gather_into(rows), 3, result);
+
+    state->part(0) = {1, 2};
+    state->part(2) = {5};
+    state->part(1) = {3, 4};
+
+    state->complete(2, error_code{});
+    state->complete(0, error_code{});
+    EXPECT_FALSE(result.ec);
+    state->complete(1, error_code{});
+
+    ASSERT_TRUE(result.ec);
+    EXPECT_FALSE(*result.ec);
+    EXPECT_THAT(result.statuses, ElementsAre(error_code{}, error_code{}, error_code{}));
+    EXPECT_THAT(rows, ElementsAre(1, 2, 3, 4, 5));
+}
+
+TEST(scatter_state, should_merge_ordered_shard_results) {
+    rows_type rows {0};
+    scatter_result result;
+    auto state = make_state(ozo::merge_into(rows), 3, result);
+
+    state->part(0) = {1, 4, 7};
+    state->part(1) = {2, 5};
+    state->part(2) = {3, 6, 8, 9};
+
+    for (std::size_t i = 0; i < 3; ++i) {
+        state->complete(i, error_code{});
+    }
+
+    EXPECT_THAT(rows, ElementsAre(0, 1, 2, 3, 4, 5, 6, 7, 8, 9));
+}
+
+TEST(scatter_state, should_merge_with_custom_comparator) {
+    rows_type rows;
+    scatter_result result;
+    auto state = make_state(ozo::merge_into(rows, std::greater<>{}), 2, result);
+
+    state->part(0) = {9, 3};
+    state->part(1) = {8, 7, 1};
+
+    state->complete(0, error_code{});
+    state->complete(1, error_code{});
+
+    EXPECT_THAT(rows, ElementsAre(9, 8, 7, 3, 1));
+}
+
+TEST(scatter_state, should_complete_with_partial_result_and_rows_of_succeeded_shards_if_some_shards_failed) {
+    rows_type rows;
+    scatter_result result;
+    auto state = make_state(ozo::gather_into(rows), 2, result);
+
+    state->part(1) = {1, 2};
+    state->complete(0, error_code{ozo::error::pq_connection_start_failed});
+    state->complete(1, error_code{});
+
+    EXPECT_EQ(result.ec, error_code{ozo::error::partial_result});
+    EXPECT_THAT(result.statuses, ElementsAre(error_code{ozo::error::pq_connection_start_failed}, error_code{}));
+    EXPECT_THAT(rows, ElementsAre(1, 2));
+}
+
+TEST(scatter_state, should_complete_with_first_shard_error_if_all_shards_failed) {
+    rows_type rows;
+    scatter_result result;
+    auto state = make_state(ozo::gather_into(rows), 2, result);
+
+    state->complete(1, error_code{boost::asio::error::timed_out});
+    state->complete(0, error_code{ozo::error::pq_connection_start_failed});
+
+    EXPECT_EQ(result.ec, error_code{ozo::error::pq_connection_start_failed});
+    EXPECT_TRUE(rows.empty());
+}
+
+TEST(make_scatter_query, should_convert_query_once_if_connection_uses_no_custom_types) {
+    using provider = connection_ptr<>;
+    const auto query = ozo::make_query("SELECT $1", 42);
+    const auto result = ozo::impl::make_scatter_query<provider>(query, std::allocator<char>{});
+    EXPECT_TRUE((std::is_same_v<std::decay_t<decltype(result)>, ozo::binary_query>));
+    EXPECT_EQ(result.params_count(), 1);
+}
+
+} // namespace
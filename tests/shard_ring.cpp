@@ -0,0 +1,125 @@
+#include <ozo/shard_ring.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <map>
+
+namespace {
+
+using namespace testing;
+
+struct connection_mock {};
+
+using connection_ptr = std::shared_ptr<connection_mock>;
+
+struct connection_source {
+    using connection_type = connection_ptr;
+
+    template <typename TimeConstraint, typename Handler>
+    void operator() (ozo::io_context&, TimeConstraint, Handler&& h) const {
+        ++*requests_;
+        h(ozo::error_code{}, connection_ptr{});
+    }
+
+    std::shared_ptr<int> requests_ = std::make_shared<int>(0);
+};
+
+} // namespace
+
+namespace ozo {
+
+template <>
+struct is_connection<connection_mock> : std::true_type {};
+
+} // namespace ozo
+
+namespace {
+
+using node_type = ozo::shard_ring_node<connection_source>;
+
+std::vector<node_type> make_shards(std::initializer_list<const char*> names) {
+    std::vector<node_type> result;
+    for (const auto name : names) {
+        result.push_back({name, std::make_shared<connection_source>()});
+    }
+    return result;
+}
+
+std::map<std::string, std::string> resolve(const ozo::shard_ring<connection_source>& ring, int keys) {
+    std::map<std::string, std::string> result;
+    for (int i = 0; i < keys; ++i) {
+        const auto key = "user" + std::to_string(i);
+        result[key] = ring[key].name();
+    }
+    return result;
+}
+
+TEST(shard_ring, should_throw_on_empty_shards) {
+    EXPECT_THROW(ozo::shard_ring<connection_source>({}), std::invalid_argument);
+}
+
+TEST(shard_ring, should_resolve_the_same_key_to_the_same_shard) {
+    ozo::shard_ring ring(make_shards({"a", "b", "c"}));
+    EXPECT_EQ(ring[42].name(), ring[42].name());
+    EXPECT_EQ(ring[std::string("key")].name(), ring["key"].name());
+}
+
+TEST(shard_ring, should_spread_keys_across_all_shards) {
+    ozo::shard_ring ring(make_shards({"a", "b", "c", "d"}));
+    std::map<std::string, int> counts;
+    for (int i = 0; i < 4000; ++i) {
+        ++counts[ring[i].name()];
+    }
+    ASSERT_EQ(counts.size(), 4u);
+    for (const auto& [name, count] : counts) {
+        EXPECT_GT(count, 500) << name;
+    }
+}
+
+TEST(shard_ring, should_move_only_keys_of_removed_shard_on_update) {
+    ozo::shard_ring ring(make_shards({"a", "b", "c"}));
+    const auto before = resolve(ring, 1000);
+
+    ring.update(make_shards({"a", "c"}));
+    const auto after = resolve(ring, 1000);
+
+    EXPECT_EQ(ring.size(), 2u);
+    for (const auto& [key, shard] : before) {
+        if (shard != "b") {
+            EXPECT_EQ(after.at(key), shard) << key;
+        } else {
+            EXPECT_NE(after.at(key), "b") << key;
+        }
+    }
+}
+
+TEST(shard_ring, should_request_connection_from_resolved_shard_source) {
+    auto shards = make_shards({"a", "b"});
+    const auto a = shards[0].source;
+    const auto b = shards[1].source;
+    ozo::shard_ring ring(std::move(shards));
+    ozo::io_context io;
+
+    auto source = ring[7];
+    auto& resolved = source.name() == "a" ? *a : *b;
+    source(io, ozo::none, [] (ozo::error_code, connection_ptr) {});
+
+    EXPECT_EQ(*resolved.requests_, 1);
+    EXPECT_EQ(*a->requests_ + *b->requests_, 1);
+}
+
+TEST(shard_ring, should_keep_resolved_source_valid_after_update) {
+    ozo::shard_ring ring(make_shards({"a"}));
+    auto source = ring["key"];
+    ring.update(make_shards({"b"}));
+    ozo::io_context io;
+
+    EXPECT_EQ(source.name(), "a");
+    EXPECT_EQ(ring["key"].name(), "b");
+    bool called = false;
+    source(io, ozo::none, [&] (ozo::error_code ec, connection_ptr) { called = !ec;});
+    EXPECT_TRUE(called);
+}
+
+} // namespace
@@ -0,0 +1,84 @@
+#include <ozo/single_flight.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <optional>
+
+namespace {
+
+using namespace testing;
+
+using ozo::error_code;
+
+struct waiter_result {
+    std::optional<error_code> ec;
+    ozo::shared_result result;
+};
+
+struct single_flight_state : Test {
+    ozo::io_context io;
+    ozo::detail::single_flight_state state;
+
+    auto make_waiter(waiter_result& out) {
+        auto handler = [&out] (error_code ec, ozo::shared_result res) {
+            out.ec = ec;
+            out.result = std::move(res);
+        };
+        using waiter_type = ozo::detail::single_flight_waiter_impl<decltype(handler), ozo::io_context::executor_type>;
+        return std::make_unique<waiter_type>(std::move(handler), io.get_executor());
+    }
+};
+
+TEST_F(single_flight_state, should_start_flight_for_first_request_of_key_only) {
+    waiter_result first, second, other;
+    EXPECT_TRUE(state.join("key", make_waiter(first)));
+    EXPECT_FALSE(state.join("key", make_waiter(second)));
+    EXPECT_TRUE(state.join("other", make_waiter(other)));
+
+    const auto metrics = state.metrics();
+    EXPECT_EQ(metrics.in_flight, 2u);
+    EXPECT_EQ(metrics.executed, 2u);
+    EXPECT_EQ(metrics.coalesced, 1u);
+}
+
+TEST_F(single_flight_state, should_complete_all_waiters_of_key_with_the_same_result_via_executor) {
+    waiter_result first, second, other;
+    state.join("key", make_waiter(first));
+    state.join("key", make_waiter(second));
+    state.join("other", make_waiter(other));
+
+    state.finish("key", ozo::error::bad_result_process, ozo::shared_result{});
+    EXPECT_FALSE(first.ec);
+
+    io.run();
+    EXPECT_EQ(first.ec, error_code{ozo::error::bad_result_process});
+    EXPECT_EQ(second.ec, error_code{ozo::error::bad_result_process});
+    EXPECT_FALSE(other.ec);
+    EXPECT_EQ(state.metrics().in_flight, 1u);
+}
+
+TEST_F(single_flight_state, should_start_new_flight_after_finish) {
+    waiter_result first, second;
+    state.join("key", make_waiter(first));
+    state.finish("key", error_code{}, ozo::shared_result{});
+    EXPECT_TRUE(state.join("key", make_waiter(second)));
+}
+
+TEST(make_query_key, should_be_equal_for_equal_text_and_params) {
+    using namespace ozo::literals;
+    const auto lhs = ozo::to_binary_query("SELECT "_SQL + std::int64_t(1) + ", "_SQL + std::string("a"), ozo::empty_oid_map{});
+    const auto rhs = ozo::to_binary_query("SELECT "_SQL + std::int64_t(1) + ", "_SQL + std::string("a"), ozo::empty_oid_map{});
+    EXPECT_EQ(ozo::detail::make_query_key(lhs), ozo::detail::make_query_key(rhs));
+}
+
+TEST(make_query_key, should_differ_for_different_params) {
+    using namespace ozo::literals;
+    const auto lhs = ozo::to_binary_query("SELECT "_SQL + std::int64_t(1), ozo::empty_oid_map{});
+    const auto rhs = ozo::to_binary_query("SELECT "_SQL + std::int64_t(2), ozo::empty_oid_map{});
+    const auto text = ozo::to_binary_query("SELECT $1"_SQL, ozo::empty_oid_map{});
+    EXPECT_NE(ozo::detail::make_query_key(lhs), ozo::detail::make_query_key(rhs));
+    EXPECT_NE(ozo::detail::make_query_key(lhs), ozo::detail::make_query_key(text));
+}
+
+} // namespace
@@ -0,0 +1,131 @@
+#include <ozo/slow_query_log.h>
+#include <ozo/connection.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <thread>
+
+namespace {
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+const ozo::time_traits::time_point t0 = ozo::time_traits::now();
+
+ozo::slow_query_record make_record(std::size_t rows) {
+    ozo::slow_query_record result;
+    result.timeline.rows = rows;
+    return result;
+}
+
+ozo::request_timeline make_timeline(ozo::time_traits::duration latency, std::string_view host = "host") {
+    ozo::request_timeline result {t0, t0, t0, t0, t0 + latency, false, 3, host, 2, 16};
+    return result;
+}
+
+TEST(slow_query_ring, should_round_up_capacity_to_power_of_two) {
+    EXPECT_EQ(ozo::slow_query_ring(5).capacity(), 8u);
+    EXPECT_EQ(ozo::slow_query_ring(1).capacity(), 2u);
+}
+
+TEST(slow_query_ring, should_throw_on_zero_capacity) {
+    EXPECT_THROW(ozo::slow_query_ring(0), std::invalid_argument);
+}
+
+TEST(slow_query_ring, pop_should_return_pushed_records_in_order) {
+    ozo::slow_query_ring ring(4);
+    EXPECT_TRUE(ring.push(make_record(1)));
+    EXPECT_TRUE(ring.push(make_record(2)));
+    EXPECT_EQ(ring.pop()->timeline.rows, 1u);
+    EXPECT_EQ(ring.pop()->timeline.rows, 2u);
+    EXPECT_EQ(ring.pop(), std::nullopt);
+}
+
+TEST(slow_query_ring, push_should_drop_record_if_ring_is_full) {
+    ozo::slow_query_ring ring(2);
+    EXPECT_TRUE(ring.push(make_record(1)));
+    EXPECT_TRUE(ring.push(make_record(2)));
+    EXPECT_FALSE(ring.push(make_record(3)));
+    EXPECT_EQ(ring.dropped(), 1u);
+    EXPECT_EQ(ring.pop()->timeline.rows, 1u);
+    EXPECT_TRUE(ring.push(make_record(4)));
+    EXPECT_EQ(ring.pop()->timeline.rows, 2u);
+    EXPECT_EQ(ring.pop()->timeline.rows, 4u);
+}
+
+TEST(slow_query_ring, should_pass_records_pushed_concurrently) {
+    ozo::slow_query_ring ring(1024);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&] {
+            for (int j = 0; j < 100; ++j) {
+                ring.push(make_record(1));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    std::size_t popped = 0;
+    while (ring.pop()) {
+        ++popped;
+    }
+    EXPECT_EQ(popped, 400u);
+    EXPECT_EQ(ring.dropped(), 0u);
+}
+
+TEST(slow_query_log, should_capture_request_with_latency_above_threshold) {
+    const auto ring = std::make_shared<ozo::slow_query_ring>(4);
+    ozo::slow_query_log log(ring, {10ms, 0});
+    log.update(ozo::request_timeline_key, make_timeline(1ms));
+    log.update(ozo::request_timeline_key, make_timeline(20ms));
+    const auto record = ring->pop();
+    ASSERT_TRUE(record);
+    EXPECT_EQ(record->latency(), 20ms);
+    EXPECT_EQ(record->host(), "host");
+    EXPECT_TRUE(record->timeline.host.empty());
+    EXPECT_EQ(record->timeline.rows, 3u);
+    EXPECT_EQ(record->timeline.params, 2u);
+    EXPECT_EQ(record->timeline.params_bytes, 16u);
+    EXPECT_FALSE(record->sampled);
+    EXPECT_EQ(ring->pop(), std::nullopt);
+}
+
+TEST(slow_query_log, should_truncate_long_host) {
+    const auto ring = std::make_shared<ozo::slow_query_ring>(4);
+    ozo::slow_query_log log(ring, {10ms, 0});
+    const std::string host(100, 'h');
+    log.update(ozo::request_timeline_key, make_timeline(20ms, host));
+    EXPECT_EQ(ring->pop()->host(), std::string(ozo::slow_query_record::host_capacity, 'h'));
+}
+
+TEST(slow_query_log, should_capture_each_request_with_sample_every_one) {
+    const auto ring = std::make_shared<ozo::slow_query_ring>(4);
+    ozo::slow_query_log log(ring, {10ms, 1});
+    log.update(ozo::request_timeline_key, make_timeline(1ms));
+    log.update(ozo::request_timeline_key, make_timeline(1ms));
+    EXPECT_TRUE(ring->pop()->sampled);
+    EXPECT_TRUE(ring->pop()->sampled);
+}
+
+TEST(slow_query_log, should_sample_one_of_n_requests_on_average) {
+    const auto ring = std::make_shared<ozo::slow_query_ring>(1024);
+    ozo::slow_query_log log(ring, {1h, 10});
+    for (int i = 0; i < 1000; ++i) {
+        log.update(ozo::request_timeline_key, make_timeline(1ms));
+    }
+    std::size_t sampled = 0;
+    while (ring->pop()) {
+        ++sampled;
+    }
+    EXPECT_GT(sampled, 50u);
+    EXPECT_LT(sampled, 200u);
+}
+
+TEST(slow_query_log, should_be_observed_by_connection) {
+    using connection = ozo::connection<ozo::empty_oid_map, ozo::slow_query_log>;
+    EXPECT_TRUE(ozo::detail::observes_request_timeline<connection>::value);
+}
+
+} // namespace
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <ozo/protocol.h>
+
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <string_view>
+#include <vector>
+
+/**
+ * Builders of the PostgreSQL frontend/backend protocol messages for the tests
+ * of the code which decodes rows straight from the wire.
+ */
+namespace ozo::tests {
+
+using buffer = std::vector<char>;
+
+struct column {
+    std::string_view name;
+    ozo::oid_t type;
+    std::int16_t format = 1;
+};
+
+inline std::string_view view(const buffer& v) {
+    return {v.data(), v.size()};
+}
+
+inline buffer message(char type, const buffer& body) {
+    buffer result;
+    ozo::ostream out(result);
+    out.put(type);
+    ozo::write(out, static_cast<std::int32_t>(body.size() + 4));
+    out.write(body.data(), static_cast<std::streamsize>(body.size()));
+    return result;
+}
+
+inline buffer row_description(const std::vector<column>& columns) {
+    buffer body;
+    ozo::ostream out(body);
+    ozo::write(out, static_cast<std::int16_t>(columns.size()));
+    for (const auto& v : columns) {
+        out.write(v.name.data(), static_cast<std::streamsize>(v.name.size()));
+        out.put('\0');
+        ozo::write(out, ozo::oid_t(0));
+        ozo::write(out, std::int16_t(0));
+        ozo::write(out, v.type);
+        ozo::write(out, std::int16_t(-1));
+        ozo::write(out, std::int32_t(-1));
+        ozo::write(out, v.format);
+    }
+    return message('T', body);
+}
+
+inline buffer data_row(const std::vector<std::optional<buffer>>& values) {
+    buffer body;
+    ozo::ostream out(body);
+    ozo::write(out, static_cast<std::int16_t>(values.size()));
+    for (const auto& v : values) {
+        if (v) {
+            ozo::write(out, static_cast<std::int32_t>(v->size()));
+            out.write(v->data(), static_cast<std::streamsize>(v->size()));
+        } else {
+            ozo::write(out, std::int32_t(-1));
+        }
+    }
+    return message('D', body);
+}
+
+template <typename T>
+inline buffer binary(T v) {
+    buffer result;
+    ozo::ostream out(result);
+    ozo::write(out, v);
+    return result;
+}
+
+inline buffer text(std::string_view v) {
+    return buffer(v.begin(), v.end());
+}
+
+/**
+ * Parses the only message of the buffer.
+ */
+inline ozo::protocol::message parse(const buffer& v) {
+    const char* first = v.data();
+    const auto result = ozo::protocol::next_message(first, v.data() + v.size());
+    EXPECT_TRUE(result);
+    EXPECT_EQ(first, v.data() + v.size());
+    return *result;
+}
+
+} // namespace ozo::tests
@@ -0,0 +1,216 @@
+#include "result_mock.h"
+
+#include <ozo/io/recv.h>
+#include <ozo/ext/std.h>
+#include <ozo/ext/boost/uuid.h>
+#include <ozo/pg/types.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+using namespace ozo::tests;
+using namespace std::literals;
+
+struct recv_text : Test {
+    ozo::empty_oid_map oid_map{};
+    StrictMock<pg_result_mock> mock{};
+    ozo::value<pg_result_mock> value{{&mock, 0, 0}};
+
+    recv_text() {
+        EXPECT_CALL(mock, field_format(_)).WillRepeatedly(Return(ozo::impl::result_format::text));
+    }
+
+    void expect_value(ozo::oid_t oid, std::string_view text) {
+        EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(oid));
+        EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(text.data()));
+        EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(text.size()));
+        EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(false));
+    }
+
+    template <typename T>
+    T recv() {
+        T out {};
+        ozo::recv(value, oid_map, out);
+        return out;
+    }
+};
+
+TEST_F(recv_text, should_parse_INT2OID_to_int16_t) {
+    expect_value(21, "-12");
+    EXPECT_EQ(recv<std::int16_t>(), -12);
+}
+
+TEST_F(recv_text, should_parse_INT4OID_to_int32_t) {
+    expect_value(23, "2147483647");
+    EXPECT_EQ(recv<std::int32_t>(), 2147483647);
+}
+
+TEST_F(recv_text, should_parse_INT8OID_to_int64_t) {
+    expect_value(20, "-9223372036854775808");
+    EXPECT_EQ(recv<std::int64_t>(), std::numeric_limits<std::int64_t>::min());
+}
+
+TEST_F(recv_text, should_throw_bad_text_value_for_out_of_range_integer) {
+    expect_value(21, "40000");
+    try {
+        recv<std::int16_t>();
+        FAIL() << "exception expected";
+    } catch (const ozo::system_error& e) {
+        EXPECT_EQ(e.code(), ozo::error::bad_text_value);
+    }
+}
+
+TEST_F(recv_text, should_throw_bad_text_value_for_trailing_characters) {
+    expect_value(23, "12a");
+    EXPECT_THROW(recv<std::int32_t>(), ozo::system_error);
+}
+
+TEST_F(recv_text, should_parse_FLOAT4OID_to_float) {
+    expect_value(700, "42.13");
+    EXPECT_EQ(recv<float>(), 42.13f);
+}
+
+TEST_F(recv_text, should_parse_FLOAT8OID_infinity_to_double) {
+    expect_value(701, "-Infinity");
+    EXPECT_EQ(recv<double>(), -std::numeric_limits<double>::infinity());
+}
+
+TEST_F(recv_text, should_parse_FLOAT8OID_nan_to_double) {
+    expect_value(701, "NaN");
+    EXPECT_TRUE(std::isnan(recv<double>()));
+}
+
+TEST_F(recv_text, should_parse_BOOLOID_to_bool) {
+    expect_value(16, "t");
+    EXPECT_TRUE(recv<bool>());
+}
+
+TEST_F(recv_text, should_throw_bad_text_value_for_invalid_bool) {
+    expect_value(16, "true");
+    EXPECT_THROW(recv<bool>(), ozo::system_error);
+}
+
+TEST_F(recv_text, should_parse_TIMESTAMPOID_to_time_point) {
+    expect_value(1114, "2000-01-01 00:00:01.5");
+    EXPECT_EQ(recv<std::chrono::system_clock::time_point>(),
+        ozo::detail::epoch + std::chrono::milliseconds(1500));
+}
+
+TEST_F(recv_text, should_parse_TIMESTAMPOID_before_unix_epoch_to_time_point) {
+    expect_value(1114, "1969-12-31 23:59:59");
+    EXPECT_EQ(recv<std::chrono::system_clock::time_point>(),
+        std::chrono::system_clock::time_point{} - std::chrono::seconds(1));
+}
+
+TEST_F(recv_text, should_apply_time_zone_offset_of_timestamp) {
+    expect_value(1114, "2024-02-29 13:45:00.000001+05:30");
+    EXPECT_EQ(recv<std::chrono::system_clock::time_point>(),
+        std::chrono::system_clock::time_point{} + std::chrono::seconds(1709214300 - 5 * 3600 - 30 * 60)
+            + std::chrono::microseconds(1));
+}
+
+TEST_F(recv_text, should_throw_bad_text_value_for_infinite_timestamp) {
+    expect_value(1114, "infinity");
+    EXPECT_THROW(recv<std::chrono::system_clock::time_point>(), ozo::system_error);
+}
+
+TEST_F(recv_text, should_parse_UUIDOID_to_uuid) {
+    expect_value(2950, "a0eebc99-9c0b-4ef8-bb6d-6bb9bd380a11");
+    const auto got = recv<boost::uuids::uuid>();
+    EXPECT_THAT(got.data, ElementsAre(0xa0, 0xee, 0xbc, 0x99, 0x9c, 0x0b, 0x4e, 0xf8,
+        0xbb, 0x6d, 0x6b, 0xb9, 0xbd, 0x38, 0x0a, 0x11));
+}
+
+TEST_F(recv_text, should_throw_bad_text_value_for_malformed_uuid) {
+    expect_value(2950, "a0eebc999c0b-4ef8-bb6d-6bb9bd380a11");
+    EXPECT_THROW(recv<boost::uuids::uuid>(), ozo::system_error);
+}
+
+TEST_F(recv_text, should_parse_NUMERICOID_to_pg_numeric64_with_scale_of_fraction_digits) {
+    expect_value(1700, "-123.450");
+    EXPECT_EQ(recv<ozo::pg::numeric64>(), ozo::pg::numeric64(-123450, 3));
+}
+
+TEST_F(recv_text, should_throw_range_error_for_NUMERICOID_NaN) {
+    expect_value(1700, "NaN");
+    EXPECT_THROW(recv<ozo::pg::numeric64>(), std::range_error);
+}
+
+TEST_F(recv_text, should_throw_range_error_for_NUMERICOID_overflow) {
+    expect_value(1700, "99999999999999999999");
+    EXPECT_THROW(recv<ozo::pg::numeric64>(), std::range_error);
+}
+
+TEST_F(recv_text, should_receive_TEXTOID_as_is) {
+    expect_value(25, "text");
+    EXPECT_EQ(recv<std::string>(), "text");
+}
+
+TEST_F(recv_text, should_throw_oid_type_mismatch_for_text_value) {
+    expect_value(25, "1");
+    EXPECT_THROW(recv<std::int32_t>(), ozo::system_error);
+}
+
+TEST_F(recv_text, should_set_nullable_to_null_for_a_null_value) {
+    EXPECT_CALL(mock, field_type(_)).WillRepeatedly(Return(23));
+    EXPECT_CALL(mock, get_value(_, _)).WillRepeatedly(Return(""));
+    EXPECT_CALL(mock, get_length(_, _)).WillRepeatedly(Return(0));
+    EXPECT_CALL(mock, get_isnull(_, _)).WillRepeatedly(Return(true));
+    std::optional<std::int32_t> out = 1;
+    ozo::recv(value, oid_map, out);
+    EXPECT_FALSE(out);
+}
+
+struct recv_text_result : Test {
+    ozo::empty_oid_map oid_map{};
+    StrictMock<pg_result_mock> mock{};
+    ozo::basic_result<pg_result_mock*> res{&mock};
+};
+
+TEST_F(recv_text_result, should_parse_rows_with_text_and_binary_columns) {
+    const char int32_bytes[] = { 0x00, 0x00, 0x00, 0x07 };
+    const std::string_view text = "-5";
+
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(2));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(1));
+
+    EXPECT_CALL(mock, field_format(0)).WillRepeatedly(Return(ozo::impl::result_format::binary));
+    EXPECT_CALL(mock, field_type(0)).WillRepeatedly(Return(23));
+    EXPECT_CALL(mock, get_value(_, 0)).WillRepeatedly(Return(int32_bytes));
+    EXPECT_CALL(mock, get_length(_, 0)).WillRepeatedly(Return(4));
+    EXPECT_CALL(mock, get_isnull(_, 0)).WillRepeatedly(Return(false));
+
+    EXPECT_CALL(mock, field_format(1)).WillRepeatedly(Return(ozo::impl::result_format::text));
+    EXPECT_CALL(mock, field_type(1)).WillRepeatedly(Return(20));
+    EXPECT_CALL(mock, get_value(_, 1)).WillRepeatedly(Return(text.data()));
+    EXPECT_CALL(mock, get_length(_, 1)).WillRepeatedly(Return(text.size()));
+    EXPECT_CALL(mock, get_isnull(_, 1)).WillRepeatedly(Return(false));
+
+    std::vector<std::tuple<std::int32_t, std::int64_t>> got;
+    ozo::recv_result(res, oid_map, std::back_inserter(got));
+    EXPECT_THAT(got, ElementsAre(std::make_tuple(7, -5)));
+}
+
+TEST_F(recv_text_result, should_parse_text_column_into_fixed_size_column_container) {
+    const std::string_view first = "1";
+    const std::string_view second = "22";
+
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(2));
+    EXPECT_CALL(mock, field_format(0)).WillRepeatedly(Return(ozo::impl::result_format::text));
+    EXPECT_CALL(mock, field_type(0)).WillRepeatedly(Return(23));
+    EXPECT_CALL(mock, get_value(0, 0)).WillRepeatedly(Return(first.data()));
+    EXPECT_CALL(mock, get_length(0, 0)).WillRepeatedly(Return(first.size()));
+    EXPECT_CALL(mock, get_value(1, 0)).WillRepeatedly(Return(second.data()));
+    EXPECT_CALL(mock, get_length(1, 0)).WillRepeatedly(Return(second.size()));
+    EXPECT_CALL(mock, get_isnull(_, 0)).WillRepeatedly(Return(false));
+
+    std::tuple<std::vector<std::int32_t>> got;
+    ozo::recv_result(res, oid_map, got);
+    EXPECT_THAT(std::get<0>(got), ElementsAre(1, 22));
+}
+
+} // namespace
@@ -0,0 +1,81 @@
+#include <ozo/tracing.h>
+#include <ozo/connection.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <memory>
+#include <vector>
+
+namespace {
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+struct tracer_stub {
+    std::shared_ptr<std::vector<ozo::trace_span>> spans = std::make_shared<std::vector<ozo::trace_span>>();
+
+    void operator() (const ozo::trace_span& v) const {
+        spans->push_back(v);
+    }
+};
+
+const ozo::time_traits::time_point t0 = ozo::time_traits::now();
+
+TEST(tracing_statistics, should_emit_connect_span) {
+    tracer_stub tracer;
+    auto stats = ozo::make_tracing_statistics(tracer);
+    stats.update(ozo::connect_timeline_key, ozo::connect_timeline{t0, t0 + 1ms, false, "host"});
+    ASSERT_EQ(tracer.spans->size(), 1u);
+    const auto& v = tracer.spans->front();
+    EXPECT_EQ(v.kind, ozo::trace_span_kind::connect);
+    EXPECT_EQ(v.start, t0);
+    EXPECT_EQ(v.end, t0 + 1ms);
+    EXPECT_FALSE(v.failed);
+    EXPECT_EQ(v.host, "host");
+}
+
+TEST(tracing_statistics, should_emit_span_of_each_request_phase) {
+    tracer_stub tracer;
+    auto stats = ozo::make_tracing_statistics(tracer);
+    ozo::request_timeline timeline {t0, t0 + 1ms, t0 + 2ms, t0 + 3ms, t0 + 4ms, false, 10, "host"};
+    stats.update(ozo::request_timeline_key, timeline);
+    ASSERT_EQ(tracer.spans->size(), 4u);
+    const auto& spans = *tracer.spans;
+    EXPECT_EQ(spans[0].kind, ozo::trace_span_kind::acquire);
+    EXPECT_EQ(spans[0].start, t0);
+    EXPECT_EQ(spans[0].end, t0 + 1ms);
+    EXPECT_EQ(spans[1].kind, ozo::trace_span_kind::send);
+    EXPECT_EQ(spans[1].end, t0 + 2ms);
+    EXPECT_EQ(spans[2].kind, ozo::trace_span_kind::wait);
+    EXPECT_EQ(spans[2].end, t0 + 3ms);
+    EXPECT_EQ(spans[3].kind, ozo::trace_span_kind::decode);
+    EXPECT_EQ(spans[3].start, t0 + 3ms);
+    EXPECT_EQ(spans[3].end, t0 + 4ms);
+    EXPECT_EQ(spans[3].rows, 10u);
+    EXPECT_EQ(spans[3].host, "host");
+    EXPECT_FALSE(spans[3].failed);
+}
+
+TEST(tracing_statistics, should_end_request_with_failed_span_of_unreached_phase) {
+    tracer_stub tracer;
+    auto stats = ozo::make_tracing_statistics(tracer);
+    ozo::request_timeline timeline {t0, t0 + 1ms, {}, {}, t0 + 4ms, true};
+    stats.update(ozo::request_timeline_key, timeline);
+    ASSERT_EQ(tracer.spans->size(), 2u);
+    const auto& spans = *tracer.spans;
+    EXPECT_EQ(spans[0].kind, ozo::trace_span_kind::acquire);
+    EXPECT_FALSE(spans[0].failed);
+    EXPECT_EQ(spans[1].kind, ozo::trace_span_kind::send);
+    EXPECT_EQ(spans[1].end, t0 + 4ms);
+    EXPECT_TRUE(spans[1].failed);
+}
+
+TEST(tracing_statistics, should_be_observed_by_connection) {
+    using connection = ozo::connection<ozo::empty_oid_map, ozo::tracing_statistics<tracer_stub>>;
+    EXPECT_TRUE(ozo::detail::observes_request_timeline<connection>::value);
+    EXPECT_TRUE(ozo::detail::observes_connect_timeline<connection>::value);
+    EXPECT_FALSE(ozo::detail::collects_request_statistics<connection>::value);
+}
+
+} // namespace
@@ -132,4 +132,84 @@ TEST_F(transaction, cancel__should_call_underlying_connection_cancel) {
     t.cancel();
 }
 
+TEST_F(transaction, is_begin_pending__should_return_false_for_transaction_without_deferred_begin) {
+    ozo::transaction<connection_t, options_t> t(std::move(conn), options);
+    EXPECT_FALSE(t.is_begin_pending());
+}
+
+#ifdef LIBPQ_HAS_PIPELINING
+
+TEST_F(transaction, is_begin_pending__should_return_true_for_transaction_with_deferred_begin_while_connection_is_idle) {
+    const auto deferred = ozo::make_options(ozo::transaction_options::deferred_begin = std::true_type{});
+    ozo::transaction t(std::move(conn), deferred);
+    EXPECT_CALL(native_handle, PQtransactionStatus()).WillOnce(Return(PQTRANS_IDLE));
+    EXPECT_TRUE(t.is_begin_pending());
+    EXPECT_CALL(native_handle, PQtransactionStatus()).WillOnce(Return(PQTRANS_INTRANS));
+    EXPECT_FALSE(t.is_begin_pending());
+}
+
+TEST_F(transaction, is_begin_pending__should_return_false_for_transaction_in_null_state) {
+    const auto deferred = ozo::make_options(ozo::transaction_options::deferred_begin = std::true_type{});
+    ozo::transaction<connection_t, std::decay_t<decltype(deferred)>> t;
+    EXPECT_FALSE(t.is_begin_pending());
+}
+
+const auto lazy_begin_options = ozo::make_options(
+    ozo::transaction_options::mode = ozo::transaction_mode::read_only,
+    ozo::transaction_options::lazy_begin = std::true_type{});
+
+TEST_F(transaction, is_begin_elidable__should_return_true_for_transaction_with_lazy_begin_until_begin_is_elided) {
+    ozo::transaction t(std::move(conn), lazy_begin_options);
+    EXPECT_CALL(native_handle, PQtransactionStatus()).WillRepeatedly(Return(PQTRANS_IDLE));
+    EXPECT_TRUE(t.is_begin_elidable());
+    EXPECT_FALSE(t.is_begin_pending());
+    t.elide_begin();
+    EXPECT_FALSE(t.is_begin_elidable());
+    EXPECT_TRUE(t.is_begin_pending());
+}
+
+TEST_F(transaction, is_begin_elidable__should_return_false_for_transaction_with_lazy_begin_in_progress) {
+    ozo::transaction t(std::move(conn), lazy_begin_options);
+    EXPECT_CALL(native_handle, PQtransactionStatus()).WillRepeatedly(Return(PQTRANS_INTRANS));
+    EXPECT_FALSE(t.is_begin_elidable());
+    EXPECT_FALSE(t.is_begin_pending());
+}
+
+TEST_F(transaction, is_begin_elidable__should_return_false_for_transaction_with_deferred_begin) {
+    const auto deferred = ozo::make_options(ozo::transaction_options::deferred_begin = std::true_type{});
+    ozo::transaction t(std::move(conn), deferred);
+    EXPECT_FALSE(t.is_begin_elidable());
+}
+
+TEST_F(transaction, is_begin_elidable__should_return_false_for_lazy_begin_of_read_write_transaction) {
+    const auto read_write = ozo::make_options(ozo::transaction_options::lazy_begin = std::true_type{});
+    ozo::transaction t(std::move(conn), read_write);
+    EXPECT_FALSE(t.is_begin_elidable());
+    EXPECT_CALL(native_handle, PQtransactionStatus()).WillOnce(Return(PQTRANS_IDLE));
+    EXPECT_TRUE(t.is_begin_pending());
+}
+
+TEST_F(transaction, is_begin_elidable__should_return_false_for_lazy_begin_with_snapshot_isolation_level) {
+    const auto repeatable_read = ozo::make_options(
+        ozo::transaction_options::mode = ozo::transaction_mode::read_only,
+        ozo::transaction_options::isolation_level = ozo::isolation_level::repeatable_read,
+        ozo::transaction_options::lazy_begin = std::true_type{});
+    ozo::transaction t(std::move(conn), repeatable_read);
+    EXPECT_FALSE(t.is_begin_elidable());
+    EXPECT_CALL(native_handle, PQtransactionStatus()).WillOnce(Return(PQTRANS_IDLE));
+    EXPECT_TRUE(t.is_begin_pending());
+}
+
+TEST_F(transaction, is_begin_elidable__should_return_true_for_lazy_begin_with_read_committed_isolation_level) {
+    const auto read_committed = ozo::make_options(
+        ozo::transaction_options::mode = ozo::transaction_mode::read_only,
+        ozo::transaction_options::isolation_level = ozo::isolation_level::read_committed,
+        ozo::transaction_options::lazy_begin = std::true_type{});
+    ozo::transaction t(std::move(conn), read_committed);
+    EXPECT_CALL(native_handle, PQtransactionStatus()).WillOnce(Return(PQTRANS_IDLE));
+    EXPECT_TRUE(t.is_begin_elidable());
+}
+
+#endif
+
 }
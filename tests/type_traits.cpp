@@ -5,6 +5,7 @@
 #include <ozo/core/recursive.h>
 
 #include <boost/make_shared.hpp>
+#include <boost/smart_ptr/intrusive_ref_counter.hpp>
 #include <boost/fusion/adapted/std_tuple.hpp>
 #include <boost/fusion/adapted/struct/define_struct.hpp>
 #include <boost/fusion/include/define_struct.hpp>
@@ -216,6 +217,13 @@ TEST(init_nullable, should_allocate_boost_shared_ptr) {
     EXPECT_TRUE(ptr);
 }
 
+TEST(init_nullable, should_allocate_boost_intrusive_ptr) {
+    struct counted : boost::intrusive_ref_counter<counted, boost::thread_unsafe_counter> {};
+    boost::intrusive_ptr<counted> ptr{};
+    ozo::init_nullable(ptr);
+    EXPECT_TRUE(ptr);
+}
+
 TEST(reset_nullable, should_reset_nullable) {
     StrictMock<nullable_mock> mock{};
     EXPECT_CALL(mock, reset()).WillOnce(Return());
@@ -0,0 +1,105 @@
+#include "result_mock.h"
+
+#include <ozo/typed_result.h>
+#include <ozo/ext/std.h>
+#include <ozo/pg/types.h>
+#include <ozo/shortcuts.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <algorithm>
+
+namespace {
+
+using namespace testing;
+using namespace std::string_literals;
+using ozo::tests::pg_result_mock;
+
+using row_type = std::tuple<std::int32_t, std::string>;
+
+struct typed_result : Test {
+    ozo::empty_oid_map oid_map{};
+    StrictMock<pg_result_mock> mock{};
+    ozo::basic_result<pg_result_mock*> res{&mock};
+    const char first[4] = { 0x00, 0x00, 0x00, 0x07 };
+    const char second[4] = { 0x00, 0x00, 0x00, 0x2a };
+
+    void expect_two_rows() {
+        EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(2));
+        EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(2));
+        EXPECT_CALL(mock, field_format(_)).WillRepeatedly(Return(ozo::impl::result_format::binary));
+        EXPECT_CALL(mock, field_type(0)).WillRepeatedly(Return(23));
+        EXPECT_CALL(mock, field_type(1)).WillRepeatedly(Return(25));
+    }
+
+    void expect_row(int row, const char* digit, const char* text) {
+        EXPECT_CALL(mock, get_value(row, 0)).WillRepeatedly(Return(digit));
+        EXPECT_CALL(mock, get_length(row, 0)).WillRepeatedly(Return(4));
+        EXPECT_CALL(mock, get_isnull(row, 0)).WillRepeatedly(Return(false));
+        EXPECT_CALL(mock, get_value(row, 1)).WillRepeatedly(Return(text));
+        EXPECT_CALL(mock, get_length(row, 1)).WillRepeatedly(Return(std::strlen(text)));
+        EXPECT_CALL(mock, get_isnull(row, 1)).WillRepeatedly(Return(false));
+    }
+};
+
+TEST_F(typed_result, should_decode_row_by_index) {
+    expect_two_rows();
+    expect_row(1, second, "second");
+
+    const auto rows = ozo::make_typed_result<row_type>(std::move(res), oid_map);
+    ASSERT_EQ(rows.size(), 2u);
+    EXPECT_EQ(rows[1], row_type(42, "second"));
+}
+
+TEST_F(typed_result, should_not_decode_rows_which_are_not_accessed) {
+    expect_two_rows();
+    expect_row(0, first, "first");
+    EXPECT_CALL(mock, get_value(1, _)).Times(0);
+
+    const auto rows = ozo::make_typed_result<row_type>(std::move(res), oid_map);
+    EXPECT_EQ(rows.front(), row_type(7, "first"));
+}
+
+TEST_F(typed_result, should_iterate_over_rows_as_random_access_range) {
+    expect_two_rows();
+    expect_row(0, first, "first");
+    expect_row(1, second, "second");
+
+    const auto rows = ozo::make_typed_result<row_type>(std::move(res), oid_map);
+    EXPECT_EQ(rows.end() - rows.begin(), 2);
+    EXPECT_EQ(*(rows.begin() + 1), row_type(42, "second"));
+    const auto i = std::find_if(rows.begin(), rows.end(), [] (const auto& row) {
+        return std::get<1>(row) == "second";
+    });
+    EXPECT_EQ(i - rows.begin(), 1);
+}
+
+TEST_F(typed_result, should_share_result_between_copies) {
+    expect_two_rows();
+
+    const auto rows = ozo::make_typed_result<row_type>(std::move(res), oid_map);
+    const auto copy = rows;
+    EXPECT_EQ(&copy.get_result(), &rows.get_result());
+    EXPECT_EQ(copy.get_result().native_handle(), &mock);
+}
+
+TEST_F(typed_result, should_throw_on_construction_if_columns_do_not_match_row) {
+    EXPECT_CALL(mock, nfields()).WillRepeatedly(Return(1));
+    EXPECT_CALL(mock, ntuples()).WillRepeatedly(Return(1));
+
+    EXPECT_THROW(ozo::make_typed_result<row_type>(std::move(res), oid_map), std::range_error);
+}
+
+TEST_F(typed_result, should_be_received_from_result_via_into) {
+    expect_two_rows();
+    expect_row(0, first, "first");
+
+    ozo::typed_result<row_type, pg_result_mock*> rows;
+    EXPECT_TRUE(rows.empty());
+    ozo::recv_result(res, oid_map, ozo::into(rows));
+    ASSERT_EQ(rows.size(), 2u);
+    EXPECT_EQ(rows[0], row_type(7, "first"));
+}
+
+} // namespace
@@ -0,0 +1,58 @@
+#include <ozo/when_all.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <optional>
+
+namespace {
+
+using namespace testing;
+
+using ozo::error_code;
+
+struct when_all_state : Test {
+    std::optional<error_code> result;
+    int calls = 0;
+
+    auto make_state(std::size_t steps) {
+        auto handler = [this] (error_code ec) {
+            result = ec;
+            ++calls;
+        };
+        return std::make_shared<ozo::impl::when_all_state<decltype(handler)>>(steps, std::move(handler));
+    }
+};
+
+TEST_F(when_all_state, should_call_handler_once_all_steps_completed) {
+    auto state = make_state(3);
+    state->complete(error_code{});
+    state->complete(error_code{});
+    EXPECT_FALSE(result);
+    state->complete(error_code{});
+    EXPECT_EQ(result, error_code{});
+    EXPECT_EQ(calls, 1);
+}
+
+TEST_F(when_all_state, should_call_handler_with_first_error_after_all_steps_completed) {
+    auto state = make_state(3);
+    state->complete(error_code{});
+    state->complete(ozo::error::pq_connection_start_failed);
+    EXPECT_FALSE(result);
+    state->complete(boost::asio::error::timed_out);
+    EXPECT_EQ(result, error_code{ozo::error::pq_connection_start_failed});
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(in_parallel, should_bind_query_and_output) {
+    std::vector<int> out;
+    const auto step = ozo::in_parallel(ozo::make_query("SELECT 1"), std::back_inserter(out));
+    EXPECT_EQ(std::string(ozo::get_text(step.query)), "SELECT 1");
+}
+
+TEST(in_parallel, should_use_none_output_by_default) {
+    const auto step = ozo::in_parallel(ozo::make_query("SELECT 1"));
+    EXPECT_TRUE(ozo::IsNone<decltype(step.out)>);
+}
+
+} // namespace
@@ -0,0 +1,61 @@
+#include <ozo/write_coalescer.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace {
+
+using namespace testing;
+
+using ozo::error_code;
+
+TEST(make_coalesced_insert, should_make_insert_from_unnest_of_column_arrays) {
+    EXPECT_EQ(ozo::detail::make_coalesced_insert("events", {"id", "payload", "created"}),
+        "INSERT INTO events (id, payload, created) SELECT * FROM unnest($1, $2, $3)");
+}
+
+struct waiter_mock : ozo::detail::write_coalescer_waiter {
+    std::vector<error_code>* results;
+
+    explicit waiter_mock(std::vector<error_code>& results) : results(&results) {}
+
+    void complete(error_code ec) override { results->push_back(ec);}
+};
+
+TEST(write_coalescer_batch, should_store_rows_by_columns) {
+    ozo::detail::write_coalescer_batch<std::int64_t, std::string> batch;
+    std::vector<error_code> results;
+    batch.append(std::make_tuple(std::int64_t(1), std::string("a")), std::make_unique<waiter_mock>(results));
+    batch.append(std::make_tuple(std::int64_t(2), std::string("b")), std::make_unique<waiter_mock>(results));
+
+    EXPECT_EQ(batch.size(), 2u);
+    EXPECT_THAT(std::get<0>(batch.columns), ElementsAre(1, 2));
+    EXPECT_THAT(std::get<1>(batch.columns), ElementsAre("a", "b"));
+}
+
+TEST(write_coalescer_batch, should_complete_all_writers_with_batch_result) {
+    ozo::detail::write_coalescer_batch<std::int64_t> batch;
+    std::vector<error_code> results;
+    batch.append(std::make_tuple(std::int64_t(1)), std::make_unique<waiter_mock>(results));
+    batch.append(std::make_tuple(std::int64_t(2)), std::make_unique<waiter_mock>(results));
+
+    batch.complete(ozo::error::pq_connection_start_failed);
+
+    EXPECT_THAT(results, ElementsAre(error_code{ozo::error::pq_connection_start_failed},
+        error_code{ozo::error::pq_connection_start_failed}));
+}
+
+TEST(write_coalescer_batch, should_make_query_with_array_parameter_per_column) {
+    ozo::detail::write_coalescer_batch<std::int64_t, std::string> batch;
+    std::vector<error_code> results;
+    batch.append(std::make_tuple(std::int64_t(1), std::string("a")), std::make_unique<waiter_mock>(results));
+    const auto query = std::apply([] (auto& ...column) {
+        return ozo::make_query("SELECT * FROM unnest($1, $2)", std::move(column)...);
+    }, batch.columns);
+    const auto binary = ozo::to_binary_query(query, ozo::empty_oid_map{});
+    EXPECT_EQ(binary.params_count(), 2);
+    EXPECT_EQ(binary.types()[0], ozo::type_oid<std::vector<std::int64_t>>(ozo::empty_oid_map{}));
+    EXPECT_EQ(binary.types()[1], ozo::type_oid<std::vector<std::string>>(ozo::empty_oid_map{}));
+}
+
+} // namespace